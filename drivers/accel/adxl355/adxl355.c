@@ -41,9 +41,11 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdlib.h>
+#include <string.h>
 #include <errno.h>
 #include "adxl355.h"
 #include "no_os_delay.h"
+#include "no_os_conv.h"
 
 /******************************************************************************/
 /************************ Variable Declarations ******************************/
@@ -61,6 +63,7 @@ static const uint8_t adxl355_part_id[] = {
 /******************************************************************************/
 static uint32_t adxl355_accel_array_conv(struct adxl355_dev *dev,
 		uint8_t *raw_array);
+static int32_t adxl355_accel_scale(struct adxl355_dev *dev);
 static int64_t adxl355_accel_conv(struct adxl355_dev *dev, uint32_t raw_accel);
 static int64_t adxl355_temp_conv(struct adxl355_dev *dev, uint16_t raw_temp);
 
@@ -710,8 +713,10 @@ int adxl355_set_fifo_samples(struct adxl355_dev *dev, uint8_t reg_value)
 	ret = adxl355_write_device_data(dev, ADXL355_ADDR(ADXL355_FIFO_SAMPLES),
 					GET_ADXL355_TRANSF_LEN(ADXL355_FIFO_SAMPLES), &reg_value);
 
-	if (!ret)
+	if (!ret) {
 		dev->fifo_samples = reg_value;
+		dev->fifo_set_len = 0;
+	}
 
 	return ret;
 }
@@ -758,6 +763,68 @@ int adxl355_get_raw_fifo_data(struct adxl355_dev *dev, uint8_t *fifo_entries,
 	return ret;
 }
 
+/***************************************************************************//**
+ * @brief Reads the FIFO in streaming mode, when the FIFO full interrupt
+ *        signals that the watermark set with adxl355_set_fifo_samples() was
+ *        reached. The watermark entries are read in a single burst, without
+ *        reading FIFO_ENTRIES first.
+ *        Sets are aligned on the x-axis marker. A set that is cut by the end
+ *        of the burst is completed by the next call, and entries read out of
+ *        order, after an overrun, are dropped.
+ *
+ * @param dev     - The device structure.
+ * @param raw_x   - Raw x-axis data, room for fifo_samples / 3 sets.
+ * @param raw_y   - Raw y-axis data, room for fifo_samples / 3 sets.
+ * @param raw_z   - Raw z-axis data, room for fifo_samples / 3 sets.
+ * @param nb_sets - Number of complete sets returned.
+ *
+ * @return ret    - Result of the reading procedure.
+*******************************************************************************/
+int adxl355_get_raw_fifo_stream(struct adxl355_dev *dev, uint32_t *raw_x,
+				uint32_t *raw_y, uint32_t *raw_z,
+				uint8_t *nb_sets)
+{
+	uint8_t *entry;
+	uint16_t idx;
+	int ret;
+
+	if (!dev->fifo_samples)
+		return -EINVAL;
+
+	*nb_sets = 0;
+
+	ret = adxl355_read_device_data(dev, ADXL355_ADDR(ADXL355_FIFO_DATA),
+				       dev->fifo_samples * 3, dev->comm_buff);
+	if (ret)
+		return ret;
+
+	for (idx = 0; idx < dev->fifo_samples * 3; idx += 3) {
+		entry = &dev->comm_buff[idx];
+
+		// The FIFO was empty, the remaining entries are not valid
+		if (entry[2] & NO_OS_BIT(1))
+			break;
+
+		// A set starts with the x-axis entry
+		if (entry[2] & NO_OS_BIT(0))
+			dev->fifo_set_len = 0;
+		else if (!dev->fifo_set_len)
+			continue;
+
+		memcpy(&dev->fifo_set[dev->fifo_set_len * 3], entry, 3);
+		if (++dev->fifo_set_len < 3)
+			continue;
+
+		raw_x[*nb_sets] = adxl355_accel_array_conv(dev, dev->fifo_set);
+		raw_y[*nb_sets] = adxl355_accel_array_conv(dev, dev->fifo_set + 3);
+		raw_z[*nb_sets] = adxl355_accel_array_conv(dev, dev->fifo_set + 6);
+		(*nb_sets)++;
+		dev->fifo_set_len = 0;
+	}
+
+	return 0;
+}
+
 /***************************************************************************//**
  * @brief Reads fifo data and returns the values converted in m/s^2.
  *
@@ -774,6 +841,8 @@ int adxl355_get_fifo_data(struct adxl355_dev *dev, uint8_t *fifo_entries,
 			  struct adxl355_frac_repr *y,
 			  struct adxl355_frac_repr *z)
 {
+	struct no_os_conv conv;
+	int32_t val;
 	int ret;
 	uint32_t raw_x[32];
 	uint32_t raw_y[32];
@@ -784,13 +853,22 @@ int adxl355_get_fifo_data(struct adxl355_dev *dev, uint8_t *fifo_entries,
 		return ret;
 
 	if (*fifo_entries > 0) {
+		/* Divide by the precomputed reciprocal of the scale divisor */
+		ret = no_os_conv_init(&conv, 0, adxl355_accel_scale(dev),
+				      ADXL355_ACC_SCALE_FACTOR_DIV);
+		if (ret)
+			return ret;
+
 		for (uint8_t idx = 0; idx < *fifo_entries/3; idx++) {
-			x[idx].integer = no_os_div_s64_rem(adxl355_accel_conv(dev, raw_x[idx]),
-							   ADXL355_ACC_SCALE_FACTOR_DIV, &(x[idx].fractional));
-			y[idx].integer = no_os_div_s64_rem(adxl355_accel_conv(dev, raw_y[idx]),
-							   ADXL355_ACC_SCALE_FACTOR_DIV, &(y[idx].fractional));
-			z[idx].integer = no_os_div_s64_rem(adxl355_accel_conv(dev, raw_z[idx]),
-							   ADXL355_ACC_SCALE_FACTOR_DIV, &(z[idx].fractional));
+			val = no_os_sign_extend32(raw_x[idx], 19);
+			x[idx].integer = no_os_conv_frac(&conv, val,
+							 &x[idx].fractional);
+			val = no_os_sign_extend32(raw_y[idx], 19);
+			y[idx].integer = no_os_conv_frac(&conv, val,
+							 &y[idx].fractional);
+			val = no_os_sign_extend32(raw_z[idx], 19);
+			z[idx].integer = no_os_conv_frac(&conv, val,
+							 &z[idx].fractional);
 		}
 	}
 
@@ -925,6 +1003,29 @@ static uint32_t adxl355_accel_array_conv(struct adxl355_dev *dev,
 	return (raw_accel >> 4);
 }
 
+/***************************************************************************//**
+ * @brief Gets the acceleration scale factor for the selected range, to be
+ *        divided by ADXL355_ACC_SCALE_FACTOR_DIV.
+ *
+ * @param dev - The device structure.
+ *
+ * @return ret - Scale factor.
+*******************************************************************************/
+static int32_t adxl355_accel_scale(struct adxl355_dev *dev)
+{
+	switch (dev->dev_type) {
+	case ID_ADXL355:
+		return ADXL355_ACC_SCALE_FACTOR_MUL *
+		       adxl355_scale_mul[dev->range];
+	case ID_ADXL357:
+	case ID_ADXL359:
+		return ADXL359_ACC_SCALE_FACTOR_MUL *
+		       adxl355_scale_mul[dev->range];
+	default:
+		return 0;
+	}
+}
+
 /***************************************************************************//**
  * @brief Converts raw acceleration value to m/s^2 value.
  *
@@ -947,17 +1048,7 @@ static int64_t adxl355_accel_conv(struct adxl355_dev *dev,
 		accel_data = raw_accel;
 
 	// Apply scale factor based on the selected range
-	switch (dev->dev_type) {
-	case ID_ADXL355:
-		return ((int64_t)(accel_data * ADXL355_ACC_SCALE_FACTOR_MUL *
-				  adxl355_scale_mul[dev->range]));
-	case ID_ADXL357:
-	case ID_ADXL359:
-		return ((int64_t)(accel_data * ADXL359_ACC_SCALE_FACTOR_MUL *
-				  adxl355_scale_mul[dev->range]));
-	default:
-		return 0;
-	}
+	return (int64_t)accel_data * adxl355_accel_scale(dev);
 }
 
 /***************************************************************************//**
@@ -311,6 +311,9 @@ struct adxl355_dev {
 	uint16_t y_offset;
 	uint16_t z_offset;
 	uint8_t fifo_samples;
+	/** Entries of the FIFO set not completed by the last stream read */
+	uint8_t fifo_set[9];
+	uint8_t fifo_set_len;
 	union adxl355_act_en_flags act_en;
 	uint8_t act_cnt;
 	uint16_t act_thr;
@@ -383,6 +386,11 @@ int adxl355_set_fifo_samples(struct adxl355_dev *dev, uint8_t reg_value);
 int adxl355_get_raw_fifo_data(struct adxl355_dev *dev, uint8_t *fifo_entries,
 			      uint32_t *raw_x, uint32_t *raw_y, uint32_t *raw_z);
 
+/*! Reads the FIFO watermark in one burst and returns the complete sets. */
+int adxl355_get_raw_fifo_stream(struct adxl355_dev *dev, uint32_t *raw_x,
+				uint32_t *raw_y, uint32_t *raw_z,
+				uint8_t *nb_sets);
+
 /*! Reads fifo data and returns the values converted in g. */
 int adxl355_get_fifo_data(struct adxl355_dev *dev, uint8_t *fifo_entries,
 			  struct adxl355_frac_repr *x, struct adxl355_frac_repr *y,
@@ -986,6 +986,47 @@ static int adxl355_iio_update_channels(void* dev, uint32_t mask)
 	return 0;
 }
 
+/***************************************************************************//**
+ * @brief Handles the FIFO full trigger: reads the FIFO watermark in one burst
+ *        and writes all the sets to the buffer.
+ *
+ * @param dev_data  - The iio device data structure.
+ *
+ * @return ret - Result of the handling procedure.
+*******************************************************************************/
+static int32_t adxl355_fifo_trigger_handler(struct iio_device_data *dev_data)
+{
+	struct adxl355_iio_dev *iio_adxl355 = dev_data->dev;
+	uint32_t mask = dev_data->buffer->active_mask;
+	uint32_t raw_x[32], raw_y[32], raw_z[32];
+	int32_t data_buff[3];
+	uint8_t nb_sets;
+	uint8_t set;
+	uint8_t i;
+	int ret;
+
+	ret = adxl355_get_raw_fifo_stream(iio_adxl355->adxl355_dev, raw_x,
+					  raw_y, raw_z, &nb_sets);
+	if (ret)
+		return ret;
+
+	for (set = 0; set < nb_sets; set++) {
+		i = 0;
+		if (mask & NO_OS_BIT(0))
+			data_buff[i++] = no_os_sign_extend32(raw_x[set], 19);
+		if (mask & NO_OS_BIT(1))
+			data_buff[i++] = no_os_sign_extend32(raw_y[set], 19);
+		if (mask & NO_OS_BIT(2))
+			data_buff[i++] = no_os_sign_extend32(raw_z[set], 19);
+
+		ret = iio_buffer_push_scan(dev_data->buffer, data_buff);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
 /***************************************************************************//**
  * @brief Handles trigger: reads one data-set and writes it to the buffer.
  *
@@ -1013,6 +1054,9 @@ static int32_t adxl355_trigger_handler(struct iio_device_data *dev_data)
 
 	adxl355 = iio_adxl355->adxl355_dev;
 
+	if (iio_adxl355->fifo_watermark)
+		return adxl355_fifo_trigger_handler(dev_data);
+
 	adxl355_get_raw_xyz(adxl355, &x, &y, &z);
 
 	if (dev_data->buffer->active_mask & NO_OS_BIT(0)) {
@@ -1031,6 +1075,38 @@ static int32_t adxl355_trigger_handler(struct iio_device_data *dev_data)
 	return iio_buffer_push_scan(dev_data->buffer, &data_buff[0]);
 }
 
+/***************************************************************************//**
+ * @brief Sets the FIFO watermark and maps the FIFO full interrupt on INT1, for
+ *        the trigger handler to stream the FIFO.
+ *
+ * @param desc      - The iio device structure.
+ * @param watermark - Number of x, y, z sets.
+ *
+ * @return ret      - Result of the configuration procedure.
+*******************************************************************************/
+static int adxl355_iio_setup_fifo(struct adxl355_iio_dev *desc,
+				  uint8_t watermark)
+{
+	union adxl355_int_mask int_conf = { .value = 0 };
+	int ret;
+
+	if (watermark > ADXL355_MAX_FIFO_SAMPLES_VAL / 3)
+		return -EINVAL;
+
+	ret = adxl355_set_fifo_samples(desc->adxl355_dev, watermark * 3);
+	if (ret)
+		return ret;
+
+	int_conf.fields.FULL_EN1 = 1;
+	ret = adxl355_config_int_pins(desc->adxl355_dev, int_conf);
+	if (ret)
+		return ret;
+
+	desc->fifo_watermark = watermark;
+
+	return 0;
+}
+
 /***************************************************************************//**
  * @brief Initializes the ADXL355 IIO driver
  *
@@ -1074,6 +1150,12 @@ int adxl355_iio_init(struct adxl355_iio_dev **iio_dev,
 	if (ret)
 		goto error_config;
 
+	if (init_param->fifo_watermark) {
+		ret = adxl355_iio_setup_fifo(desc, init_param->fifo_watermark);
+		if (ret)
+			goto error_config;
+	}
+
 	*iio_dev = desc;
 
 	return 0;
@@ -59,10 +59,15 @@ struct adxl355_iio_dev {
 	int adxl355_hpf_3db_table[7][2];
 	uint32_t active_channels;
 	uint8_t no_of_active_channels;
+	uint8_t fifo_watermark;
 };
 
 struct adxl355_iio_dev_init_param {
 	struct adxl355_init_param *adxl355_dev_init;
+	/** Number of x, y, z sets, up to 32, raising the FIFO full interrupt on
+	 *  INT1. The trigger handler then streams the FIFO to the buffer. If 0,
+	 *  the trigger handler reads one set from the data registers. */
+	uint8_t fifo_watermark;
 };
 
 /******************************************************************************/
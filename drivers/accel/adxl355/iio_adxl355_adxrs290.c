@@ -0,0 +1,393 @@
+/***************************************************************************//**
+ *   @file   iio_adxl355_adxrs290.c
+ *   @brief  Implementation of the IIO ADXL355 and ADXRS290 IMU Driver.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include "no_os_error.h"
+#include "no_os_util.h"
+#include "no_os_delay.h"
+#include "iio_trigger.h"
+#include "iio_adxl355_adxrs290.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+/* Scan indexes of the channels */
+#define IMU_ACCEL_X	0
+#define IMU_ACCEL_Y	1
+#define IMU_ACCEL_Z	2
+#define IMU_ANGLVEL_X	3
+#define IMU_ANGLVEL_Y	4
+#define IMU_TIMESTAMP	5
+#define IMU_NB_CH	6
+
+#define IMU_ACCEL_MASK	NO_OS_GENMASK(IMU_ACCEL_Z, IMU_ACCEL_X)
+#define IMU_ANGLVEL_MASK	NO_OS_GENMASK(IMU_ANGLVEL_Y, IMU_ANGLVEL_X)
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+static int imu_iio_read_raw(void *dev, char *buf, uint32_t len,
+			    const struct iio_ch_info *channel, intptr_t priv);
+static int imu_iio_read_scale(void *dev, char *buf, uint32_t len,
+			      const struct iio_ch_info *channel, intptr_t priv);
+static int imu_iio_update_channels(void *dev, uint32_t mask);
+static int32_t imu_iio_trigger_handler(struct iio_device_data *dev_data);
+
+/******************************************************************************/
+/************************ Variable Declarations ******************************/
+/******************************************************************************/
+struct iio_trigger adxl355_adxrs290_iio_trig_desc = {
+	.is_synchronous = true,
+	.enable = iio_trig_enable,
+	.disable = iio_trig_disable
+};
+
+static struct iio_attribute imu_iio_attrs[] = {
+	{
+		.name = "raw",
+		.show = imu_iio_read_raw,
+	},
+	{
+		.name   = "scale",
+		.shared = IIO_SHARED_BY_TYPE,
+		.show   = imu_iio_read_scale,
+	},
+	END_ATTRIBUTES_ARRAY
+};
+
+static struct scan_type imu_iio_accel_scan_type = {
+	.sign = 's',
+	.realbits = 20,
+	.storagebits = 32,
+	.shift = 0,
+	.is_big_endian = false
+};
+
+static struct scan_type imu_iio_anglvel_scan_type = {
+	.sign = 's',
+	.realbits = 16,
+	.storagebits = 16,
+	.shift = 0,
+	.is_big_endian = false
+};
+
+/* address is the axis in the data of the sensor */
+#define IMU_CHANNEL(_type, _index, _axis, _addr, _scan_type) { \
+	.ch_type = _type,                                      \
+	.channel = _index,                                     \
+	.address = _addr,                                      \
+	.modified = true,                                      \
+	.channel2 = IIO_MOD_##_axis,                           \
+	.scan_type = _scan_type,                               \
+	.scan_index = _index,                                  \
+	.attributes = imu_iio_attrs,                           \
+	.ch_out = false                                        \
+}
+
+static struct iio_channel imu_iio_channels[] = {
+	IMU_CHANNEL(IIO_ACCEL, IMU_ACCEL_X, X, 0, &imu_iio_accel_scan_type),
+	IMU_CHANNEL(IIO_ACCEL, IMU_ACCEL_Y, Y, 1, &imu_iio_accel_scan_type),
+	IMU_CHANNEL(IIO_ACCEL, IMU_ACCEL_Z, Z, 2, &imu_iio_accel_scan_type),
+	IMU_CHANNEL(IIO_ANGL_VEL, IMU_ANGLVEL_X, X, ADXRS290_CHANNEL_X,
+		    &imu_iio_anglvel_scan_type),
+	IMU_CHANNEL(IIO_ANGL_VEL, IMU_ANGLVEL_Y, Y, ADXRS290_CHANNEL_Y,
+		    &imu_iio_anglvel_scan_type),
+	IIO_CHAN_SOFT_TIMESTAMP(IMU_TIMESTAMP),
+};
+
+static struct iio_device imu_iio_dev = {
+	.num_ch = NO_OS_ARRAY_SIZE(imu_iio_channels),
+	.channels = imu_iio_channels,
+	.pre_enable = (int32_t (*)())imu_iio_update_channels,
+	.trigger_handler = (int32_t (*)())imu_iio_trigger_handler,
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+/***************************************************************************//**
+ * @brief Handles the read request for raw attribute.
+ *
+ * @param dev     - The iio device structure.
+ * @param buf     - Command buffer to be filled with requested data.
+ * @param len     - Length of the received command buffer in bytes.
+ * @param channel - Command channel info.
+ * @param priv    - Command attribute id.
+ *
+ * @return ret    - Result of the reading procedure.
+ *                  In case of success, the size of the read data is returned.
+*******************************************************************************/
+static int imu_iio_read_raw(void *dev, char *buf, uint32_t len,
+			    const struct iio_ch_info *channel, intptr_t priv)
+{
+	struct adxl355_adxrs290_iio_dev *imu = dev;
+	uint32_t raw[3];
+	int16_t rate;
+	int32_t val;
+	int ret;
+
+	if (!imu)
+		return -EINVAL;
+
+	switch (channel->type) {
+	case IIO_ACCEL:
+		ret = adxl355_get_raw_xyz(imu->adxl355_dev, &raw[0], &raw[1],
+					  &raw[2]);
+		if (ret)
+			return ret;
+		val = no_os_sign_extend32(raw[channel->address], 19);
+		break;
+	case IIO_ANGL_VEL:
+		ret = adxrs290_get_rate_data(imu->adxrs290_dev,
+					     channel->address, &rate);
+		if (ret)
+			return ret;
+		val = rate;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return iio_format_value(buf, len, IIO_VAL_INT, 1, &val);
+}
+
+/***************************************************************************//**
+ * @brief Handles the read request for scale attribute.
+ *
+ * @param dev     - The iio device structure.
+ * @param buf     - Command buffer to be filled with requested data.
+ * @param len     - Length of the received command buffer in bytes.
+ * @param channel - Command channel info.
+ * @param priv    - Command attribute id.
+ *
+ * @return ret    - Result of the reading procedure.
+ *                  In case of success, the size of the read data is returned.
+*******************************************************************************/
+static int imu_iio_read_scale(void *dev, char *buf, uint32_t len,
+			      const struct iio_ch_info *channel, intptr_t priv)
+{
+	struct adxl355_adxrs290_iio_dev *imu = dev;
+	int32_t vals[2] = {0};
+
+	if (!imu)
+		return -EINVAL;
+
+	switch (channel->type) {
+	case IIO_ACCEL:
+		switch (imu->adxl355_dev->dev_type) {
+		case ID_ADXL355:
+			vals[1] = 38245;
+			break;
+		case ID_ADXL357:
+		case ID_ADXL359:
+			vals[1] = 191229;
+			break;
+		default:
+			return -EINVAL;
+		}
+		return iio_format_value(buf, len, IIO_VAL_INT_PLUS_NANO, 2,
+					vals);
+	case IIO_ANGL_VEL:
+		// 1 LSB = 0.005 degrees/sec = 0.000087266 rad/sec
+		vals[1] = 87266;
+		return iio_format_value(buf, len, IIO_VAL_INT_PLUS_NANO, 2,
+					vals);
+	default:
+		return -EINVAL;
+	}
+}
+
+/***************************************************************************//**
+ * @brief Updates the channels used by the trigger handler. The gyroscope
+ *        burst read returns the two axes, the unused one is dropped when the
+ *        scan is packed.
+ *
+ * @param dev  - The iio device structure.
+ * @param mask - Mask of the active channels.
+ *
+ * @return ret - Result of the updating procedure.
+*******************************************************************************/
+static int imu_iio_update_channels(void *dev, uint32_t mask)
+{
+	struct adxl355_adxrs290_iio_dev *imu = dev;
+
+	if (!imu)
+		return -EINVAL;
+
+	imu->active_channels = mask;
+
+	return adxrs290_set_active_channels(imu->adxrs290_dev,
+					    NO_OS_BIT(ADXRS290_CHANNEL_X) |
+					    NO_OS_BIT(ADXRS290_CHANNEL_Y));
+}
+
+/***************************************************************************//**
+ * @brief Handles the data ready trigger: reads both sensors back to back and
+ *        writes one scan, stamped with the time of the interrupt.
+ *
+ * @param dev_data - The iio device data structure.
+ *
+ * @return ret - Result of the handling procedure.
+*******************************************************************************/
+static int32_t imu_iio_trigger_handler(struct iio_device_data *dev_data)
+{
+	struct adxl355_adxrs290_iio_dev *imu;
+	int64_t samples[IMU_NB_CH] = {0};
+	int64_t scan[IMU_NB_CH];
+	uint32_t x, y, z;
+	int16_t rate[2];
+	uint8_t ch_cnt;
+	int64_t ts;
+	int ret;
+
+	if (!dev_data)
+		return -EINVAL;
+
+	/* Taken first, the closest to the data ready edge */
+	ts = no_os_time_ns();
+
+	imu = dev_data->dev;
+
+	if (imu->active_channels & IMU_ACCEL_MASK) {
+		ret = adxl355_get_raw_xyz(imu->adxl355_dev, &x, &y, &z);
+		if (ret)
+			return ret;
+
+		samples[IMU_ACCEL_X] = no_os_sign_extend32(x, 19);
+		samples[IMU_ACCEL_Y] = no_os_sign_extend32(y, 19);
+		samples[IMU_ACCEL_Z] = no_os_sign_extend32(z, 19);
+	}
+
+	if (imu->active_channels & IMU_ANGLVEL_MASK) {
+		ret = adxrs290_get_burst_data(imu->adxrs290_dev, rate, &ch_cnt);
+		if (ret)
+			return ret;
+
+		samples[IMU_ANGLVEL_X] = rate[0];
+		samples[IMU_ANGLVEL_Y] = rate[1];
+	}
+
+	samples[IMU_TIMESTAMP] = ts;
+
+	/* The storage bytes are the first ones of each sample */
+	iio_buffer_pack_scan(dev_data->buffer, scan, samples,
+			     sizeof(samples[0]));
+
+	return iio_buffer_push_scan(dev_data->buffer, scan);
+}
+
+/***************************************************************************//**
+ * @brief Initializes both sensors and the IIO device reading them together.
+ *
+ * @param iio_dev    - The iio device structure.
+ * @param param      - The structure that contains the device initial
+ *                      parameters.
+ *
+ * @return ret       - Result of the initialization procedure.
+*******************************************************************************/
+int adxl355_adxrs290_iio_init(struct adxl355_adxrs290_iio_dev **iio_dev,
+			      struct adxl355_adxrs290_iio_init_param *param)
+{
+	struct adxl355_adxrs290_iio_dev *desc;
+	int ret;
+
+	if (!iio_dev || !param || !param->adxl355_dev_init ||
+	    !param->adxrs290_dev_init)
+		return -EINVAL;
+
+	desc = (struct adxl355_adxrs290_iio_dev *)calloc(1, sizeof(*desc));
+	if (!desc)
+		return -ENOMEM;
+
+	desc->iio_dev = &imu_iio_dev;
+
+	ret = adxl355_init(&desc->adxl355_dev, *(param->adxl355_dev_init));
+	if (ret)
+		goto error_adxl355_init;
+
+	ret = adxl355_soft_reset(desc->adxl355_dev);
+	if (ret)
+		goto error_adxrs290_init;
+
+	ret = adxl355_set_op_mode(desc->adxl355_dev,
+				  ADXL355_MEAS_TEMP_OFF_DRDY_ON);
+	if (ret)
+		goto error_adxrs290_init;
+
+	ret = adxrs290_init(&desc->adxrs290_dev, param->adxrs290_dev_init);
+	if (ret)
+		goto error_adxrs290_init;
+
+	*iio_dev = desc;
+
+	return 0;
+
+error_adxrs290_init:
+	adxl355_remove(desc->adxl355_dev);
+error_adxl355_init:
+	free(desc);
+	return ret;
+}
+
+/***************************************************************************//**
+ * @brief Free the resources allocated by adxl355_adxrs290_iio_init().
+ *
+ * @param desc - The IIO device structure.
+ *
+ * @return ret - Result of the remove procedure.
+*******************************************************************************/
+int adxl355_adxrs290_iio_remove(struct adxl355_adxrs290_iio_dev *desc)
+{
+	int ret;
+
+	ret = adxrs290_remove(desc->adxrs290_dev);
+	if (ret)
+		return ret;
+
+	ret = adxl355_remove(desc->adxl355_dev);
+	if (ret)
+		return ret;
+
+	free(desc);
+
+	return 0;
+}
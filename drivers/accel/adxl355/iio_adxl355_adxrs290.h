@@ -0,0 +1,93 @@
+/***************************************************************************//**
+ *   @file   iio_adxl355_adxrs290.h
+ *   @brief  Header file of the IIO ADXL355 and ADXRS290 IMU Driver.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef IIO_ADXL355_ADXRS290_H
+#define IIO_ADXL355_ADXRS290_H
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include "iio.h"
+#include "adxl355.h"
+#include "adxrs290.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+/*
+ * Synchronous trigger for the ADXL355 data ready interrupt, both sensors are
+ * read by the trigger handler of the device.
+ */
+extern struct iio_trigger adxl355_adxrs290_iio_trig_desc;
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+/**
+ * @struct adxl355_adxrs290_iio_dev
+ * @brief Accelerometer and gyroscope seen as a single IIO device. A scan
+ * holds the acceleration, the angular velocity and the time both were read.
+ */
+struct adxl355_adxrs290_iio_dev {
+	/** Accelerometer, its data ready signal clocks the scans */
+	struct adxl355_dev *adxl355_dev;
+	/** Gyroscope, read right after the accelerometer */
+	struct adxrs290_dev *adxrs290_dev;
+	/** IIO device descriptor */
+	struct iio_device *iio_dev;
+	/** Channels enabled in the buffer */
+	uint32_t active_channels;
+};
+
+/**
+ * @struct adxl355_adxrs290_iio_init_param
+ * @brief Initialization parameters of the two sensors.
+ */
+struct adxl355_adxrs290_iio_init_param {
+	struct adxl355_init_param *adxl355_dev_init;
+	struct adxrs290_init_param *adxrs290_dev_init;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+int adxl355_adxrs290_iio_init(struct adxl355_adxrs290_iio_dev **iio_dev,
+			      struct adxl355_adxrs290_iio_init_param *param);
+
+int adxl355_adxrs290_iio_remove(struct adxl355_adxrs290_iio_dev *desc);
+
+#endif /** IIO_ADXL355_ADXRS290_H */
@@ -41,6 +41,7 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdlib.h>
+#include <string.h>
 #include "adxl367.h"
 #include "no_os_delay.h"
 #include "no_os_util.h"
@@ -303,20 +304,20 @@ int adxl367_get_register_value(struct adxl367_dev *dev,
 }
 
 /***************************************************************************//**
- * @brief Performs a burst read of FIFO buffer.
+ * @brief Performs a burst read of FIFO buffer. The data is left in place,
+ * 	after the command byte, instead of being moved to the buffer start.
  *
- * @param dev        - The device structure.
- * @param read_data  - The read values are stored in this buffer.
- * @param bytes_nb	 - Number of bytes to be read in burst.
+ * @param dev      - The device structure.
+ * @param bytes_nb - Number of bytes to be read in burst.
+ * @param data     - Pointer to the first read byte, in dev->fifo_buffer.
  *
  * @return 0 in case of success, negative error code otherwise.
 *******************************************************************************/
 static int adxl367_get_fifo_value(struct adxl367_dev *dev,
-				  uint8_t* read_data,
-				  uint16_t  bytes_nb)
+				  uint16_t bytes_nb,
+				  const uint8_t **data)
 {
 	int ret;
-	uint16_t index;
 
 	if (dev->comm_type == ADXL367_SPI_COMM) {
 		dev->fifo_buffer[0] = ADXL367_READ_FIFO;
@@ -334,12 +335,75 @@ static int adxl367_get_fifo_value(struct adxl367_dev *dev,
 			return ret;
 	}
 
-	for (index = 0; index < bytes_nb; index++)
-		dev->fifo_buffer[index] = dev->fifo_buffer[index + 1];
+	*data = &dev->fifo_buffer[1];
 
 	return 0;
 }
 
+/***************************************************************************//**
+ * @brief Gets the number of bytes taken by FIFO entries in a read mode.
+ *
+ * @param mode    - FIFO read mode.
+ * @param entries - Number of entries.
+ *
+ * @return the number of bytes.
+*******************************************************************************/
+static uint16_t adxl367_fifo_bytes(enum adxl367_fifo_read_mode mode,
+				   uint16_t entries)
+{
+	switch (mode) {
+	case ADXL367_8B:
+		return entries;
+	case ADXL367_12B:
+		// Two entries packed in three bytes
+		return (entries * 3 + 1) / 2;
+	default:
+		return entries * 2;
+	}
+}
+
+/***************************************************************************//**
+ * @brief Decodes FIFO entries to signed values in 14-bit units, whatever the
+ * 	read mode, so the 8 and 12-bit modes share the scales of the 14-bit
+ * 	one. The read mode is dispatched once, the loops have no branches.
+ *
+ * @param mode  - FIFO read mode.
+ * @param buf   - Burst read data.
+ * @param first - Index, in the burst, of the first entry to decode.
+ * @param n     - Number of entries to decode.
+ * @param out   - Decoded values.
+*******************************************************************************/
+static void adxl367_fifo_decode(enum adxl367_fifo_read_mode mode,
+				const uint8_t *buf, uint16_t first,
+				uint16_t n, int16_t *out)
+{
+	const uint8_t *b;
+	uint16_t i, v;
+
+	switch (mode) {
+	case ADXL367_8B:
+		for (i = 0; i < n; i++)
+			out[i] = (int16_t)(buf[first + i] << 8) >> 2;
+		break;
+	case ADXL367_12B:
+		for (i = first; i < first + n; i++) {
+			b = &buf[i * 3 / 2];
+			v = (b[0] << 8) | b[1];
+			// Odd entries start at the low nibble of a byte
+			v = (uint16_t)(v << ((i & 1) << 2)) & 0xFFF0;
+			*out++ = (int16_t)v >> 2;
+		}
+		break;
+	default:
+		// ID in the upper 2 bits, 12-bit data is left aligned
+		for (i = first; i < first + n; i++) {
+			v = (buf[i * 2] << 8) | buf[i * 2 + 1];
+			*out++ = (int16_t)(v << 2) >> 2;
+		}
+		break;
+	}
+}
+
 /***************************************************************************//**
  * @brief Performs a masked write to a register.
  *
@@ -849,8 +913,15 @@ int adxl367_set_fifo_sample_sets_nb(struct adxl367_dev *dev,
 		return ret;
 
 	// write last 8 bits to ADXL367_REG_FIFO_SAMPLES
-	return adxl367_set_register_value(dev, sets_nb & 0xFF,
-					  ADXL367_REG_FIFO_SAMPLES);
+	ret = adxl367_set_register_value(dev, sets_nb & 0xFF,
+					 ADXL367_REG_FIFO_SAMPLES);
+	if (ret)
+		return ret;
+
+	dev->fifo_sets_nb = sets_nb;
+	dev->fifo_set_len = 0;
+
+	return 0;
 }
 
 /***************************************************************************//**
@@ -944,6 +1015,7 @@ int adxl367_set_fifo_format(struct adxl367_dev *dev,
 		return ret;
 
 	dev->fifo_format = format;
+	dev->fifo_set_len = 0;
 
 	switch (dev->fifo_format) {
 	case ADXL367_FIFO_FORMAT_XYZ:
@@ -1022,10 +1094,40 @@ int adxl367_fifo_setup(struct adxl367_dev *dev,
 	return adxl367_set_fifo_read_mode(dev, ADXL367_14B_CHID);
 }
 
+/***************************************************************************//**
+ * @brief Gets the channel ID expected at a position of a FIFO sample set.
+ *
+ * @param format - FIFO format.
+ * @param idx    - Position in the set.
+ *
+ * @return the channel ID.
+*******************************************************************************/
+static uint8_t adxl367_fifo_set_id(enum adxl367_fifo_format format,
+				   uint8_t idx)
+{
+	switch (format) {
+	case ADXL367_FIFO_FORMAT_XYZ:
+	case ADXL367_FIFO_FORMAT_XYZT:
+	case ADXL367_FIFO_FORMAT_XYZA:
+		return idx < 3 ? idx : ADXL367_FIFO_TEMP_ADC_ID;
+	case ADXL367_FIFO_FORMAT_Y:
+	case ADXL367_FIFO_FORMAT_YT:
+	case ADXL367_FIFO_FORMAT_YA:
+		return idx ? ADXL367_FIFO_TEMP_ADC_ID : ADXL367_FIFO_Y_ID;
+	case ADXL367_FIFO_FORMAT_Z:
+	case ADXL367_FIFO_FORMAT_ZT:
+	case ADXL367_FIFO_FORMAT_ZA:
+		return idx ? ADXL367_FIFO_TEMP_ADC_ID : ADXL367_FIFO_Z_ID;
+	default:
+		return idx ? ADXL367_FIFO_TEMP_ADC_ID : ADXL367_FIFO_X_ID;
+	}
+}
+
 /***************************************************************************//**
  * @brief Reads all available raw values from FIFO. If, after setting FIFO mode,
  * 		any of x, y, z, temp or adc aren't selected, assign NULL pointer.
- * 		Uses ADXL367_14B_CHID read mode as default.
+ * 		Uses ADXL367_14B_CHID read mode as default. In the read modes
+ * 		without channel ID, the FIFO must start with a complete set.
  *
  * @param dev       - The device structure.
  * @param x  	    - X axis raw data buffer. If not used, assign NULL.
@@ -1040,9 +1142,12 @@ int adxl367_fifo_setup(struct adxl367_dev *dev,
 int adxl367_read_raw_fifo(struct adxl367_dev *dev, int16_t *x, int16_t *y,
 			  int16_t *z, int16_t *temp_adc, uint16_t *entries)
 {
-	int ret;
+	int16_t *dst[4] = {x, y, z, temp_adc};
+	const uint8_t *buf;
 	uint16_t i, stored_entr = 0;
+	int16_t val;
 	uint8_t id;
+	int ret;
 
 	ret = adxl367_get_nb_of_fifo_entries(dev, &stored_entr);
 	if (ret)
@@ -1050,62 +1155,163 @@ int adxl367_read_raw_fifo(struct adxl367_dev *dev, int16_t *x, int16_t *y,
 
 	*entries = stored_entr;
 
-	ret = adxl367_get_fifo_value(dev, dev->fifo_buffer, stored_entr * 2);
+	ret = adxl367_get_fifo_value(dev,
+				     adxl367_fifo_bytes(dev->fifo_read_mode,
+						     stored_entr), &buf);
 	if (ret)
 		return -1;
 
-	// MSB = 6 data bits + 2 bits for CH ID
-	for (i = 0; i < (stored_entr * 2); i += 2 ) {
-		id = dev->fifo_buffer[i] >> 6;
-
-		switch (id) {
-		case (ADXL367_FIFO_X_ID) :
-			if (x == NULL)
-				return -1;
-			*x = ((dev->fifo_buffer[i] & 0x3F) << 8) + dev->fifo_buffer[i+1];
-			//extend sign
-			if (*x & NO_OS_BIT(13))
-				*x |= NO_OS_GENMASK(15, 14);
-			x++;
-			break;
-
-		case (ADXL367_FIFO_Y_ID) :
-			if (y == NULL)
-				return -1;
-			*y = ((dev->fifo_buffer[i] & 0x3F) << 8) + dev->fifo_buffer[i+1];
-			//extend sign
-			if (*y & NO_OS_BIT(13))
-				*y |= NO_OS_GENMASK(15, 14);
-			y++;
-			break;
-
-		case (ADXL367_FIFO_Z_ID) :
-			if (z == NULL)
-				return -1;
-			*z = ((dev->fifo_buffer[i] & 0x3F) << 8) + dev->fifo_buffer[i+1];
-			//extend sign
-			if (*z & NO_OS_BIT(13))
-				*z |= NO_OS_GENMASK(15, 14);
-			z++;
-			break;
-
-		case (ADXL367_FIFO_TEMP_ADC_ID) :
-			if (temp_adc == NULL)
-				return -1;
-			*temp_adc = (int16_t)((dev->fifo_buffer[i] & 0x3F) << 8) + dev->fifo_buffer[i
-					+1];
-			//extend sign
-			if (*temp_adc & NO_OS_BIT(13))
-				*temp_adc |= NO_OS_GENMASK(15, 14);
-			temp_adc++;
-			break;
+	for (i = 0; i < stored_entr; i++) {
+		if (dev->fifo_read_mode == ADXL367_14B_CHID ||
+		    dev->fifo_read_mode == ADXL367_12B_CHID)
+			id = buf[i * 2] >> 6;
+		else
+			id = adxl367_fifo_set_id(dev->fifo_format,
+						 i % samples_per_set);
 
-		default :
+		if (!dst[id]) {
 			pr_err("%s: FIFO read invalid channel ID.\n", __func__);
 			return -1;
 		}
 
+		adxl367_fifo_decode(dev->fifo_read_mode, buf, i, 1, &val);
+		*dst[id]++ = val;
+	}
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Checks the channel IDs of FIFO entries against the ones expected by
+ * 	the FIFO format, the comparisons are accumulated without branches.
+ *
+ * @param dev - The device structure.
+ * @param buf - Burst read data.
+ * @param n   - Number of entries.
+ * @param pos - Position, in the set, of the first entry.
+ *
+ * @return true if all the IDs match.
+*******************************************************************************/
+static bool adxl367_fifo_ids_match(struct adxl367_dev *dev, const uint8_t *buf,
+				   uint16_t n, uint8_t pos)
+{
+	uint8_t ids[4];
+	uint8_t diff = 0;
+	uint16_t i;
+
+	for (i = 0; i < samples_per_set; i++)
+		ids[i] = adxl367_fifo_set_id(dev->fifo_format, i);
+
+	for (i = 0; i < n; i++) {
+		diff |= (buf[i * 2] >> 6) ^ ids[pos];
+		pos = (pos + 1 == samples_per_set) ? 0 : pos + 1;
+	}
+
+	return !diff;
+}
+
+/***************************************************************************//**
+ * @brief Aligns the FIFO entries to the sets entry by entry, using the channel
+ * 	IDs. Entries read out of order, after an overrun, are dropped.
+ *
+ * @param dev     - The device structure.
+ * @param buf     - Burst read data.
+ * @param entries - Number of entries in buf.
+ * @param data    - Buffer for the complete sets.
+ * @param sets_nb - Number of complete sets stored in data.
+*******************************************************************************/
+static void adxl367_fifo_resync(struct adxl367_dev *dev, const uint8_t *buf,
+				uint16_t entries, int16_t *data,
+				uint16_t *sets_nb)
+{
+	uint8_t expected;
+	uint16_t i;
+	uint8_t id;
+
+	for (i = 0; i < entries; i++) {
+		id = buf[i * 2] >> 6;
+		expected = adxl367_fifo_set_id(dev->fifo_format,
+					       dev->fifo_set_len);
+		if (id != expected) {
+			// Out of order entry, keep it only if it starts a set
+			dev->fifo_set_len = 0;
+			if (id != adxl367_fifo_set_id(dev->fifo_format, 0))
+				continue;
+		}
+
+		adxl367_fifo_decode(dev->fifo_read_mode, buf, i, 1,
+				    &dev->fifo_set[dev->fifo_set_len++]);
+		if (dev->fifo_set_len < samples_per_set)
+			continue;
+
+		memcpy(&data[*sets_nb * samples_per_set], dev->fifo_set,
+		       samples_per_set * sizeof(*data));
+		(*sets_nb)++;
+		dev->fifo_set_len = 0;
+	}
+}
+
+/***************************************************************************//**
+ * @brief Reads the FIFO in streaming mode, when the FIFO watermark interrupt
+ * 	signals that the number of sets given to
+ * 	adxl367_set_fifo_sample_sets_nb() is stored. The watermark entries
+ * 	are read in a single burst, without reading the number of FIFO
+ * 	entries first, and decoded straight to data. Works in all the read
+ * 	modes, the values are in 14-bit units. A set that is cut by the end
+ * 	of the burst is completed by the next call.
+ * 	In the modes with channel ID, the IDs of the burst are checked at
+ * 	once. On a mismatch, after an overrun, the sets are aligned entry by
+ * 	entry and the entries read out of order are dropped.
+ *
+ * @param dev     - The device structure.
+ * @param data    - Buffer for the sets, with the values of a set stored in
+ * 			the order of the FIFO format.
+ * @param sets_nb - Number of complete sets stored in data.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+int adxl367_read_raw_fifo_stream(struct adxl367_dev *dev, int16_t *data,
+				 uint16_t *sets_nb)
+{
+	enum adxl367_fifo_read_mode mode = dev->fifo_read_mode;
+	const uint8_t *buf;
+	uint16_t entries;
+	uint16_t head;
+	uint8_t carry;
+	int ret;
+
+	if (!dev->fifo_sets_nb)
+		return -1;
+
+	*sets_nb = 0;
+	entries = no_os_min(dev->fifo_sets_nb * samples_per_set, 512);
+
+	ret = adxl367_get_fifo_value(dev, adxl367_fifo_bytes(mode, entries),
+				     &buf);
+	if (ret)
+		return ret;
+
+	carry = dev->fifo_set_len;
+	if ((mode == ADXL367_14B_CHID || mode == ADXL367_12B_CHID) &&
+	    !adxl367_fifo_ids_match(dev, buf, entries, carry)) {
+		adxl367_fifo_resync(dev, buf, entries, data, sets_nb);
+		return 0;
+	}
+
+	// Entries of the complete sets, including the ones carried over
+	head = (carry + entries) / samples_per_set * samples_per_set;
+	if (head) {
+		memcpy(data, dev->fifo_set, carry * sizeof(*data));
+		adxl367_fifo_decode(mode, buf, 0, head - carry, &data[carry]);
+		dev->fifo_set_len = carry + entries - head;
+		adxl367_fifo_decode(mode, buf, head - carry, dev->fifo_set_len,
+				    dev->fifo_set);
+	} else {
+		adxl367_fifo_decode(mode, buf, 0, entries,
+				    &dev->fifo_set[carry]);
+		dev->fifo_set_len += entries;
 	}
+	*sets_nb = head / samples_per_set;
 
 	return 0;
 }
@@ -1213,7 +1419,8 @@ int adxl367_int_map(struct adxl367_dev *dev, struct adxl367_int_map *map,
 		  map->data_ready;
 
 	return adxl367_set_register_value(dev, reg_val,
-					  pin == 1 ? ADXL367_REG_INTMAP1_LWR : ADXL367_REG_INTMAP1_LWR);
+					  pin == 1 ? ADXL367_REG_INTMAP1_LWR :
+					  ADXL367_REG_INTMAP2_LWR);
 }
 
 /***************************************************************************//**
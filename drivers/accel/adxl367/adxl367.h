@@ -445,6 +445,11 @@ struct adxl367_dev {
 	enum adxl367_fifo_read_mode 	fifo_read_mode;
 	/** FIFO Buffer 513 * 2 + 1 cmd byte */
 	uint8_t 			fifo_buffer[1027];
+	/** FIFO watermark, in sample sets */
+	uint16_t			fifo_sets_nb;
+	/** Entries of the set not completed by the last stream read */
+	int16_t				fifo_set[4];
+	uint8_t				fifo_set_len;
 	uint16_t 			x_offset;
 	uint16_t 			y_offset;
 	uint16_t 			z_offset;
@@ -573,6 +578,10 @@ int adxl367_fifo_setup(struct adxl367_dev *dev,
 int adxl367_read_raw_fifo(struct adxl367_dev *dev, int16_t *x, int16_t *y,
 			  int16_t *z, int16_t *temp_adc, uint16_t *entries);
 
+/* Reads the FIFO watermark in one burst and returns the complete sets. */
+int adxl367_read_raw_fifo_stream(struct adxl367_dev *dev, int16_t *data,
+				 uint16_t *sets_nb);
+
 /* Reads converted values from FIFO. */
 int adxl367_read_converted_fifo(struct adxl367_dev *dev,
 				struct adxl367_fractional_val *x, struct adxl367_fractional_val *y,
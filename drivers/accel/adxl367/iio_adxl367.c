@@ -714,6 +714,97 @@ static int adxl367_iio_read_samples(void* dev, int* buff, uint32_t samples)
 	return samples;
 }
 
+/***************************************************************************//**
+ * @brief Handles trigger: writes the sets stored in the FIFO to the buffer in
+ * 		  FIFO mode, one set read from the data registers otherwise.
+ *
+ * @param dev_data  - The iio device data structure.
+ *
+ * @return ret - Result of the handling procedure.
+*******************************************************************************/
+static int32_t adxl367_trigger_handler(struct iio_device_data *dev_data)
+{
+	struct adxl367_iio_dev *iio_adxl367;
+	struct adxl367_dev *adxl367;
+	int16_t set[4];
+	uint16_t sets_nb;
+	uint16_t i;
+	int ret;
+
+	if (!dev_data)
+		return -EINVAL;
+
+	iio_adxl367 = (struct adxl367_iio_dev *)dev_data->dev;
+
+	if (!iio_adxl367->adxl367_dev)
+		return -EINVAL;
+
+	adxl367 = iio_adxl367->adxl367_dev;
+
+	if (!iio_adxl367->fifo_watermark) {
+		ret = adxl367_get_raw_xyz(adxl367, &set[0], &set[1], &set[2]);
+		if (ret)
+			return ret;
+
+		if (dev_data->buffer->active_mask & NO_OS_BIT(3)) {
+			ret = adxl367_read_raw_temp(adxl367, &set[3]);
+			if (ret)
+				return ret;
+		}
+
+		return iio_buffer_push_samples(dev_data->buffer, set,
+					       sizeof(*set));
+	}
+
+	ret = adxl367_read_raw_fifo_stream(adxl367, iio_adxl367->fifo_data,
+					   &sets_nb);
+	if (ret)
+		return ret;
+
+	for (i = 0; i < sets_nb; i++) {
+		ret = iio_buffer_push_samples(dev_data->buffer,
+					      &iio_adxl367->fifo_data[i * 4],
+					      sizeof(int16_t));
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Streams x, y, z and temperature through the FIFO and maps the FIFO
+ * 		  watermark interrupt on INT1.
+ *
+ * @param desc      - The iio device structure.
+ * @param watermark - Number of sets.
+ *
+ * @return ret      - Result of the configuration procedure.
+*******************************************************************************/
+static int adxl367_iio_setup_fifo(struct adxl367_iio_dev *desc,
+				  uint8_t watermark)
+{
+	struct adxl367_int_map int_map = { 0 };
+	int ret;
+
+	if (watermark > NO_OS_ARRAY_SIZE(desc->fifo_data) / 4)
+		return -EINVAL;
+
+	ret = adxl367_fifo_setup(desc->adxl367_dev, ADXL367_STREAM_MODE,
+				 ADXL367_FIFO_FORMAT_XYZT, watermark);
+	if (ret)
+		return ret;
+
+	int_map.fifo_watermark = 1;
+	ret = adxl367_int_map(desc->adxl367_dev, &int_map, 1);
+	if (ret)
+		return ret;
+
+	desc->fifo_watermark = watermark;
+
+	return 0;
+}
+
 /***************************************************************************//**
  * @brief Initializes the ADXL367 IIO driver
  *
@@ -750,6 +841,12 @@ int adxl367_iio_init(struct adxl367_iio_dev **iio_dev,
 	if (ret)
 		goto error_config;
 
+	if (init_param->fifo_watermark) {
+		ret = adxl367_iio_setup_fifo(desc, init_param->fifo_watermark);
+		if (ret)
+			goto error_config;
+	}
+
 	// Enter measure mode
 	ret = adxl367_set_power_mode(desc->adxl367_dev, ADXL367_OP_MEASURE);
 	if (ret)
@@ -893,6 +990,7 @@ static struct iio_device adxl367_iio_dev = {
 	.channels = adxl367_channels,
 	.pre_enable = (int32_t (*)())adxl367_iio_update_channels,
 	.read_dev = (int32_t (*)())adxl367_iio_read_samples,
+	.trigger_handler = (int32_t (*)())adxl367_trigger_handler,
 	.debug_reg_read = (int32_t (*)())adxl367_iio_read_reg,
 	.debug_reg_write = (int32_t (*)())adxl367_iio_write_reg
 };
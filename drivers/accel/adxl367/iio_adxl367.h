@@ -44,6 +44,11 @@
 /******************************************************************************/
 #include "iio.h"
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+extern struct iio_trigger adxl367_iio_trig_desc;
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -52,10 +57,18 @@ struct adxl367_iio_dev {
 	struct iio_device *iio_dev;
 	uint32_t active_channels;
 	uint8_t no_of_active_channels;
+	uint8_t fifo_watermark;
+	/** Sets read from the FIFO by the trigger handler */
+	int16_t fifo_data[512];
 };
 
 struct adxl367_iio_init_param {
 	struct adxl367_init_param *adxl367_initial_param;
+	/** Number of x, y, z, temperature sets, up to 128, raising the
+	 *  FIFO watermark interrupt on INT1. The trigger handler then streams
+	 *  the FIFO to the buffer. If 0, the trigger handler reads one set
+	 *  from the data registers. */
+	uint8_t fifo_watermark;
 };
 
 /******************************************************************************/
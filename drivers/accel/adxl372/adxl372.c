@@ -529,6 +529,7 @@ int32_t adxl372_configure_fifo(struct adxl372_dev *dev,
 	dev->fifo_config.fifo_format = format;
 	dev->fifo_config.fifo_mode = mode;
 	dev->fifo_config.fifo_samples = fifo_samples;
+	dev->fifo_set_len = 0;
 
 	return ret;
 }
@@ -619,6 +620,84 @@ int32_t adxl372_get_fifo_xyz_data(struct adxl372_dev *dev,
 	return ret;
 }
 
+/**
+ * Get the axes stored in FIFO.
+ * @param format - FIFO format.
+ * @return mask of the axes, bit 0 for x, bit 1 for y and bit 2 for z.
+ */
+static uint8_t adxl372_fifo_axes(enum adxl372_fifo_format format)
+{
+	if (format == ADXL372_XYZ_FIFO || format == ADXL372_XYZ_PEAK_FIFO)
+		return 0x7;
+
+	return format;
+}
+
+/**
+ * Get the FIFO data in streaming mode, when the FIFO_FULL interrupt signals
+ * that the configured FIFO samples are stored. The samples are read in a
+ * single burst, without reading the number of FIFO entries first, leaving one
+ * sample set in the FIFO.
+ * Sets are aligned on the series start bit. A set that is cut by the end of
+ * the burst is completed by the next call, and samples read out of order are
+ * dropped. The axes not stored in FIFO are returned as 0.
+ * @param dev - The device structure.
+ * @param samples - pointer to an array of type adxl372_xyz_accel_data
+ *		    where the sets will be stored. Room for fifo_samples sets
+ *		    is always enough.
+ * @param nb_sets - pointer which will store the number of sets.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t adxl372_get_fifo_stream(struct adxl372_dev *dev,
+				struct adxl372_xyz_accel_data *samples,
+				uint16_t *nb_sets)
+{
+	uint8_t buf[1024];
+	uint8_t axes, set_size, i, j;
+	uint16_t *axis[3];
+	uint16_t cnt, idx;
+	int32_t ret;
+
+	axes = adxl372_fifo_axes(dev->fifo_config.fifo_format);
+	set_size = (axes & 1) + ((axes >> 1) & 1) + ((axes >> 2) & 1);
+
+	if (dev->fifo_config.fifo_mode == ADXL372_FIFO_BYPASSED ||
+	    dev->fifo_config.fifo_samples < 2 * set_size)
+		return -1;
+
+	*nb_sets = 0;
+	cnt = (dev->fifo_config.fifo_samples / set_size - 1) * set_size;
+
+	ret = adxl372_read_reg_multiple(dev, ADXL372_FIFO_DATA, buf, cnt * 2);
+	if (ret < 0)
+		return ret;
+
+	for (idx = 0; idx < cnt * 2; idx += 2) {
+		/* The first sample of a set has the series start bit set */
+		if (buf[idx + 1] & 0x1)
+			dev->fifo_set_len = 0;
+		else if (!dev->fifo_set_len)
+			continue;
+
+		dev->fifo_set[dev->fifo_set_len++] = (buf[idx] << 4) |
+						     (buf[idx + 1] >> 4);
+		if (dev->fifo_set_len < set_size)
+			continue;
+
+		axis[0] = &samples->x;
+		axis[1] = &samples->y;
+		axis[2] = &samples->z;
+		for (i = 0, j = 0; i < 3; i++)
+			*axis[i] = (axes & (1 << i)) ? dev->fifo_set[j++] : 0;
+
+		dev->fifo_set_len = 0;
+		samples++;
+		(*nb_sets)++;
+	}
+
+	return 0;
+}
+
 /**
  * Retrieve the highest magnitude (x, y, z) sample recorded since the last
  * read of the MAXPEAK registers
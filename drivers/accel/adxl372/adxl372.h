@@ -383,6 +383,9 @@ struct adxl372_dev {
 	enum adxl372_act_proc_mode	act_proc_mode;
 	enum adxl372_instant_on_th_mode	th_mode;
 	struct adxl372_fifo_config	fifo_config;
+	/* Samples of the set not completed by the last stream read */
+	uint16_t			fifo_set[3];
+	uint8_t				fifo_set_len;
 	enum adxl372_comm_type		comm_type;
 };
 
@@ -477,6 +480,9 @@ int32_t adxl372_configure_fifo(struct adxl372_dev *dev,
 int32_t adxl372_get_fifo_xyz_data(struct adxl372_dev *dev,
 				  struct adxl372_xyz_accel_data *fifo_data,
 				  uint16_t cnt);
+int32_t adxl372_get_fifo_stream(struct adxl372_dev *dev,
+				struct adxl372_xyz_accel_data *samples,
+				uint16_t *nb_sets);
 int32_t adxl372_service_fifo_ev(struct adxl372_dev *dev,
 				struct adxl372_xyz_accel_data *fifo_data,
 				uint16_t *fifo_entries);
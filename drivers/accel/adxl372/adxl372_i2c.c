@@ -105,10 +105,10 @@ int32_t adxl372_i2c_reg_read_multiple(struct adxl372_dev *dev,
 				      uint8_t *reg_data,
 				      uint16_t count)
 {
-	uint8_t buf[512];
+	uint8_t buf[1024];
 	int32_t ret;
 
-	if (count > 512)
+	if (count > 1024)
 		return -1;
 
 	buf[0] = reg_addr;
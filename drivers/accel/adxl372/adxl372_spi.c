@@ -102,10 +102,10 @@ int32_t adxl372_spi_reg_read_multiple(struct adxl372_dev *dev,
 				      uint8_t *reg_data,
 				      uint16_t count)
 {
-	uint8_t buf[513];
+	uint8_t buf[1025];
 	int32_t ret;
 
-	if (count > 512)
+	if (count > 1024)
 		return -1;
 
 	buf[0] = ADXL372_REG_READ(reg_addr);
@@ -177,6 +177,137 @@ int32_t ad5592r_multi_read_adc(struct ad5592r_dev *dev, uint16_t chans,
 	return 0;
 }
 
+/**
+ * Read ADC channels in repeat mode. The sequence is started once, then the
+ * results are clocked out by chained transfers of AD5592R_BURST_MSGS frames,
+ * so that the SPI controller can send them back to back (with DMA where
+ * supported) instead of one call per result.
+ *
+ * @param dev - The device structure.
+ * @param chans - The ADC channels to be converted
+ * @param values - nb_scans * number of channels results, in scan order
+ * @param nb_scans - Number of conversions of each channel
+ * @return 0 in case of success, negative error code otherwise
+ */
+int32_t ad5592r_burst_read_adc(struct ad5592r_dev *dev, uint16_t chans,
+			       uint16_t *values, uint32_t nb_scans)
+{
+	struct no_os_spi_msg msgs[AD5592R_BURST_MSGS] = {0};
+	uint32_t nb_values;
+	uint32_t done;
+	uint32_t n;
+	uint32_t i;
+	int32_t ret;
+	int32_t ret2;
+
+	if (!dev || !chans || !values)
+		return -1;
+
+	nb_values = no_os_hweight16(chans) * nb_scans;
+
+	dev->spi_msg = swab16((uint16_t)(AD5592R_REG_ADC_SEQ << 11) |
+			      AD5592R_REG_ADC_SEQ_REP | chans);
+
+	ret = no_os_spi_write_and_read(dev->spi, (uint8_t *)&dev->spi_msg,
+				       sizeof(dev->spi_msg));
+	if (ret < 0)
+		return ret;
+
+	/*
+	 * Invalid data:
+	 * See Figure 40. Single-Channel ADC Conversion Sequence
+	 */
+	ret = ad5592r_spi_wnop_r16(dev, &dev->spi_msg);
+	if (ret < 0)
+		goto stop;
+
+	/* NOPs, each result being framed by SYNC */
+	for (i = 0; i < AD5592R_BURST_MSGS; i++) {
+		msgs[i].bytes_number = sizeof(*values);
+		msgs[i].cs_change = 1;
+	}
+
+	for (done = 0; done < nb_values; done += n) {
+		n = no_os_min(nb_values - done, (uint32_t)AD5592R_BURST_MSGS);
+		for (i = 0; i < n; i++)
+			msgs[i].rx_buff = (uint8_t *)&values[done + i];
+
+		ret = no_os_spi_transfer(dev->spi, msgs, n);
+		if (ret < 0)
+			goto stop;
+	}
+
+	for (i = 0; i < nb_values; i++)
+		values[i] = swab16(values[i]);
+
+stop:
+	/* Ends the repetition, the result of this frame is dropped */
+	dev->spi_msg = swab16((uint16_t)(AD5592R_REG_ADC_SEQ << 11));
+	ret2 = no_os_spi_write_and_read(dev->spi, (uint8_t *)&dev->spi_msg,
+					sizeof(dev->spi_msg));
+
+	return ret < 0 ? ret : ret2;
+}
+
+/**
+ * Write several DAC channels, updating their outputs together. The values
+ * are latched in the input registers, then a single LDAC register write
+ * moves them to the DAC registers. All the frames go in one transfer.
+ *
+ * @param dev - The device structure.
+ * @param chans - The DAC channels to be written
+ * @param values - DAC values, one for each channel of chans in increasing
+ * channel order
+ * @return 0 in case of success, negative error code otherwise
+ */
+int32_t ad5592r_multi_write_dac(struct ad5592r_dev *dev, uint8_t chans,
+				const uint16_t *values)
+{
+	struct no_os_spi_msg msgs[NO_OS_ARRAY_SIZE(dev->cached_dac) + 3] = {0};
+	uint16_t frames[NO_OS_ARRAY_SIZE(msgs)];
+	uint16_t frame;
+	uint32_t n = 0;
+	uint32_t i;
+	uint8_t ch;
+	int32_t ret;
+
+	if (!dev || !chans || !values)
+		return -1;
+
+	frames[n++] = swab16((uint16_t)(AD5592R_REG_LDAC << 11) |
+			     AD5592R_REG_LDAC_INPUT_REG_ONLY);
+
+	for (ch = 0, i = 0; ch < NO_OS_ARRAY_SIZE(dev->cached_dac); ch++) {
+		if (!(chans & NO_OS_BIT(ch)))
+			continue;
+
+		frame = NO_OS_BIT(15) | (uint16_t)(ch << 12) | values[i++];
+		frames[n++] = swab16(frame);
+	}
+
+	frames[n++] = swab16((uint16_t)(AD5592R_REG_LDAC << 11) |
+			     AD5592R_REG_LDAC_INPUT_REG_OUT);
+	/* Back to the configured mode for the single channel writes */
+	frames[n++] = swab16((uint16_t)(AD5592R_REG_LDAC << 11) |
+			     dev->ldac_mode);
+
+	for (i = 0; i < n; i++) {
+		msgs[i].tx_buff = (uint8_t *)&frames[i];
+		msgs[i].bytes_number = sizeof(frames[i]);
+		msgs[i].cs_change = 1;
+	}
+
+	ret = no_os_spi_transfer(dev->spi, msgs, n);
+	if (ret < 0)
+		return ret;
+
+	for (ch = 0, i = 0; ch < NO_OS_ARRAY_SIZE(dev->cached_dac); ch++)
+		if (chans & NO_OS_BIT(ch))
+			dev->cached_dac[ch] = values[i++];
+
+	return 0;
+}
+
 /**
  * Write register.
  *
@@ -45,6 +45,9 @@
 #define AD5592R_GPIO_READBACK_EN	NO_OS_BIT(10)
 #define AD5592R_LDAC_READBACK_EN	NO_OS_BIT(6)
 
+/* Frames sent by each no_os_spi_transfer of a burst */
+#define AD5592R_BURST_MSGS		16
+
 #define swab16(x) \
 	((((x) & 0x00ff) << 8) | \
 	 (((x) & 0xff00) >> 8))
@@ -55,6 +58,10 @@ int32_t ad5592r_read_adc(struct ad5592r_dev *dev, uint8_t chan,
 			 uint16_t *value);
 int32_t ad5592r_multi_read_adc(struct ad5592r_dev *dev,
 			       uint16_t chans, uint16_t *value);
+int32_t ad5592r_burst_read_adc(struct ad5592r_dev *dev, uint16_t chans,
+			       uint16_t *values, uint32_t nb_scans);
+int32_t ad5592r_multi_write_dac(struct ad5592r_dev *dev, uint8_t chans,
+				const uint16_t *values);
 int32_t ad5592r_reg_write(struct ad5592r_dev *dev, uint8_t reg,
 			  uint16_t value);
 int32_t ad5592r_reg_read(struct ad5592r_dev *dev, uint8_t reg,
@@ -49,14 +49,12 @@
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
 /******************************************************************************/
-#define AD74413R_FRAME_SIZE 		4
-#define AD74413R_CRC_POLYNOMIAL 	0x7
+#define AD74413R_REG_BIT(addr)		((uint64_t)1 << (addr))
 #define AD74413R_DIN_DEBOUNCE_LEN 	NO_OS_BIT(5)
 
 /******************************************************************************/
 /************************ Variable Declarations ******************************/
 /******************************************************************************/
-NO_OS_DECLARE_CRC8_TABLE(_crc_table);
 
 static const unsigned int ad74413r_debounce_map[AD74413R_DIN_DEBOUNCE_LEN] = {
 	0,     13,    18,    24,    32,    42,    56,    75,
@@ -159,7 +157,70 @@ static void ad74413r_format_reg_write(uint8_t reg, uint16_t val, uint8_t *buff)
 {
 	buff[0] = reg;
 	no_os_put_unaligned_be16(val, &buff[1]);
-	buff[3] = no_os_crc8(_crc_table, buff, 3, 0);
+	buff[3] = no_os_crc8(no_os_crc8_table_07, buff, 3, 0);
+}
+
+/**
+ * @brief Check if a register may be held in the register cache. Only the
+ * configuration registers are, the status, result, and command ones are
+ * always accessed on the device.
+ * @param addr - The register's address.
+ * @return true if the register is cacheable.
+ */
+static bool ad74413r_reg_is_cacheable(uint32_t addr)
+{
+	if (addr >= AD74413R_CH_FUNC_SETUP(0) && addr < AD74413R_DAC_ACTIVE(0))
+		return true;
+
+	switch (addr) {
+	case AD74413R_DIN_THRESH:
+	case AD74413R_DIAG_ASSIGN:
+	case AD74413R_ALERT_MASK:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/**
+ * @brief Update the register cache after a register was written.
+ * @param desc - The device structure.
+ * @param addr - The register's address.
+ * @param val - The register's value.
+ */
+static void ad74413r_reg_cache_store(struct ad74413r_desc *desc, uint32_t addr,
+				     uint16_t val)
+{
+	uint32_t ch;
+
+	if (!desc->reg_cache)
+		return;
+
+	if (addr == AD74413R_CMD_KEY) {
+		/* A reset restores the default values */
+		if (val == AD74413R_CMD_KEY_RESET_2)
+			desc->reg_cache_valid = 0;
+		return;
+	}
+
+	if (!ad74413r_reg_is_cacheable(addr))
+		return;
+
+	/*
+	 * Changing the function of a channel also changes its other
+	 * settings, which have to be read from the device again.
+	 */
+	if (addr <= AD74413R_CH_FUNC_SETUP(AD74413R_CH_D)) {
+		ch = addr - AD74413R_CH_FUNC_SETUP(0);
+		desc->reg_cache_valid &=
+			~(AD74413R_REG_BIT(AD74413R_ADC_CONFIG(ch)) |
+			  AD74413R_REG_BIT(AD74413R_DIN_CONFIG(ch)) |
+			  AD74413R_REG_BIT(AD74413R_OUTPUT_CONFIG(ch)) |
+			  AD74413R_REG_BIT(AD74413R_DAC_CODE(ch)));
+	}
+
+	desc->reg_cache_val[addr] = val;
+	desc->reg_cache_valid |= AD74413R_REG_BIT(addr);
 }
 
 /**
@@ -197,10 +258,23 @@ int ad74413r_reg_read_raw(struct ad74413r_desc *desc, uint32_t addr,
  */
 int ad74413r_reg_write(struct ad74413r_desc *desc, uint32_t addr, uint16_t val)
 {
+	int ret;
+
+	if (desc->reg_cache && ad74413r_reg_is_cacheable(addr) &&
+	    (desc->reg_cache_valid & AD74413R_REG_BIT(addr)) &&
+	    desc->reg_cache_val[addr] == val)
+		return 0;
+
 	ad74413r_format_reg_write(addr, val, desc->comm_buff);
 
-	return no_os_spi_write_and_read(desc->comm_desc, desc->comm_buff,
-					AD74413R_FRAME_SIZE);
+	ret = no_os_spi_write_and_read(desc->comm_desc, desc->comm_buff,
+				       AD74413R_FRAME_SIZE);
+	if (ret)
+		return ret;
+
+	ad74413r_reg_cache_store(desc, addr, val);
+
+	return 0;
 }
 
 /**
@@ -215,16 +289,27 @@ int ad74413r_reg_read(struct ad74413r_desc *desc, uint32_t addr, uint16_t *val)
 	int ret;
 	uint8_t expected_crc;
 
+	if (desc->reg_cache && ad74413r_reg_is_cacheable(addr) &&
+	    (desc->reg_cache_valid & AD74413R_REG_BIT(addr))) {
+		*val = desc->reg_cache_val[addr];
+		return 0;
+	}
+
 	ret = ad74413r_reg_read_raw(desc, addr, desc->comm_buff);
 	if (ret)
 		return ret;
 
-	expected_crc = no_os_crc8(_crc_table, desc->comm_buff, 3, 0);
+	expected_crc = no_os_crc8(no_os_crc8_table_07, desc->comm_buff, 3, 0);
 	if (expected_crc != desc->comm_buff[3])
 		return -EINVAL;
 
 	*val = no_os_get_unaligned_be16(&desc->comm_buff[1]);
 
+	if (desc->reg_cache && ad74413r_reg_is_cacheable(addr)) {
+		desc->reg_cache_val[addr] = *val;
+		desc->reg_cache_valid |= AD74413R_REG_BIT(addr);
+	}
+
 	return 0;
 }
 
@@ -538,6 +623,118 @@ int ad74413r_set_adc_conv_seq(struct ad74413r_desc *desc,
 	return 0;
 }
 
+/**
+ * @brief Start continuous conversions, sequencing the ADC and the diagnostic
+ * channels selected, with a single ADC_CONV_CTRL write. The ADC_RDY pin
+ * pulses at the end of each sequence.
+ * @param desc - The device structure.
+ * @param ch_mask - ADC channels to convert, bit x for channel x.
+ * @param diag_mask - Diagnostic channels to convert, bit x for channel x.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int ad74413r_set_adc_conv_cont(struct ad74413r_desc *desc, uint8_t ch_mask,
+			       uint8_t diag_mask)
+{
+	uint16_t val;
+	uint32_t i;
+	int ret;
+
+	val = no_os_field_prep(AD74413R_CONV_SEQ_MASK, AD74413R_START_CONT);
+	for (i = 0; i < AD74413R_N_CHANNELS; i++) {
+		if (ch_mask & NO_OS_BIT(i))
+			val |= AD74413R_CH_EN_MASK(i);
+		if (diag_mask & NO_OS_BIT(i))
+			val |= AD74413R_DIAG_EN_MASK(i);
+	}
+
+	ret = ad74413r_reg_update(desc, AD74413R_ADC_CONV_CTRL,
+				  AD74413R_CONV_CTRL_SEQ_MASK, val);
+	if (ret)
+		return ret;
+
+	/* The ADC powers up on the CONV_SEQ write */
+	no_os_udelay(100);
+
+	return 0;
+}
+
+/**
+ * @brief Read the raw frames of the result registers, starting with
+ * ADC_RESULT(0), in one SPI transfer. The auto readback mode increments the
+ * readback address on each frame, so the address is only selected once
+ * instead of once per register.
+ * @param desc - The device structure.
+ * @param frames - nb raw frames of AD74413R_FRAME_SIZE bytes, the ADC
+ * results come first and the diagnostic results next.
+ * @param nb - The number of registers to read, up to AD74413R_N_RESULTS.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int ad74413r_get_adc_results_raw(struct ad74413r_desc *desc, uint8_t *frames,
+				 uint32_t nb)
+{
+	struct no_os_spi_msg msgs[AD74413R_N_RESULTS + 1] = {0};
+	uint8_t select[AD74413R_FRAME_SIZE];
+	uint32_t i;
+
+	if (!nb || nb > AD74413R_N_RESULTS)
+		return -EINVAL;
+
+	ad74413r_format_reg_write(AD74413R_READ_SELECT,
+				  AD74413R_AUTO_RD_EN_MASK |
+				  AD74413R_ADC_RESULT(0), select);
+	msgs[0].tx_buff = select;
+	msgs[0].bytes_number = AD74413R_FRAME_SIZE;
+	msgs[0].cs_change = 1;
+
+	/* An all zero frame is a NOP, with a valid CRC */
+	for (i = 0; i < nb; i++) {
+		msgs[i + 1].rx_buff = &frames[i * AD74413R_FRAME_SIZE];
+		msgs[i + 1].bytes_number = AD74413R_FRAME_SIZE;
+		msgs[i + 1].cs_change = 1;
+	}
+
+	return no_os_spi_transfer(desc->comm_desc, msgs, nb + 1);
+}
+
+/**
+ * @brief Read the results of all the ADC and diagnostic channels with a
+ * single burst, checking the CRC of each frame.
+ * @param desc - The device structure.
+ * @param adc - AD74413R_N_CHANNELS ADC results, may be NULL.
+ * @param diag - AD74413R_N_CHANNELS diagnostic results, may be NULL.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int ad74413r_get_adc_results(struct ad74413r_desc *desc, uint16_t *adc,
+			     uint16_t *diag)
+{
+	uint8_t frames[AD74413R_N_RESULTS * AD74413R_FRAME_SIZE];
+	uint32_t nb = diag ? AD74413R_N_RESULTS : AD74413R_N_CHANNELS;
+	uint8_t *frame;
+	uint16_t val;
+	uint32_t i;
+	int ret;
+
+	ret = ad74413r_get_adc_results_raw(desc, frames, nb);
+	if (ret)
+		return ret;
+
+	for (i = 0; i < nb; i++) {
+		frame = &frames[i * AD74413R_FRAME_SIZE];
+		if (no_os_crc8(no_os_crc8_table_07, frame, 3, 0) != frame[3])
+			return -EINVAL;
+
+		val = no_os_get_unaligned_be16(&frame[1]);
+		if (i < AD74413R_N_CHANNELS) {
+			if (adc)
+				adc[i] = val;
+		} else {
+			diag[i - AD74413R_N_CHANNELS] = val;
+		}
+	}
+
+	return 0;
+}
+
 /**
  * @brief Get a single ADC raw value for a specific channel, then power down the ADC.
  * @param desc - The device structure.
@@ -1013,7 +1210,7 @@ int ad74413r_init(struct ad74413r_desc **desc,
 	if (ret)
 		goto err;
 
-	no_os_crc8_populate_msb(_crc_table, AD74413R_CRC_POLYNOMIAL);
+	descriptor->reg_cache = init_param->reg_cache;
 
 	ret = ad74413r_reset(descriptor);
 	if (ret)
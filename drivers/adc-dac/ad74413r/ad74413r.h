@@ -45,6 +45,9 @@
 
 #define AD74413R_N_CHANNELS             4
 
+/** Size of a SPI frame: address, 16 bit value and CRC */
+#define AD74413R_FRAME_SIZE 		4
+
 #define AD74413R_CH_A                   0
 #define AD74413R_CH_B                   1
 #define AD74413R_CH_C                   2
@@ -84,6 +87,9 @@
 #define AD74413R_SILICON_REV                    0x46
 #define AD74413R_ALERT_STATUS_RESET             NO_OS_GENMASK(15, 0)
 
+/** Registers up to this address may be held in the register cache */
+#define AD74413R_REG_CACHE_SIZE			(AD74413R_ALERT_MASK + 1)
+
 /** Software reset sequence */
 #define AD74413R_CMD_KEY_RESET_1                0x15FA
 #define AD74413R_CMD_KEY_RESET_2                0xAF51
@@ -95,8 +101,11 @@
 #define AD74413R_CMD_KEY_DAC_CLEAR		0x73D1
 
 #define AD74413R_SPI_RD_RET_INFO_MASK		NO_OS_BIT(8)
+#define AD74413R_AUTO_RD_EN_MASK		NO_OS_BIT(9)
 #define AD74413R_ERR_CLR_MASK			NO_OS_GENMASK(15, 0)
 #define AD74413R_SPI_CRC_ERR_MASK		NO_OS_BIT(13)
+#define AD74413R_VI_ERR_MASK(x)			NO_OS_BIT(x)
+#define AD74413R_HI_TEMP_ERR_MASK		NO_OS_BIT(4)
 #define AD74413R_CH_FUNC_SETUP_MASK             NO_OS_GENMASK(3, 0)
 #define AD74413R_ADC_RANGE_MASK                 NO_OS_GENMASK(7, 5)
 #define AD74413R_ADC_REJECTION_MASK             NO_OS_GENMASK(4, 3)
@@ -137,6 +146,13 @@
 #define AD74413R_CONV_SEQ_MASK                  NO_OS_GENMASK(9, 8)
 #define AD74413R_DIAG_EN_MASK(x)		(NO_OS_BIT(x) << 4)
 #define AD74413R_CH_EN_MASK(x)                  NO_OS_BIT(x)
+#define AD74413R_CONV_CTRL_SEQ_MASK		NO_OS_GENMASK(9, 0)
+
+/**
+ * The ADC_RESULTx and DIAG_RESULTx registers are contiguous, they are read
+ * with a single burst in auto readback mode.
+ */
+#define AD74413R_N_RESULTS			(2 * AD74413R_N_CHANNELS)
 
 /** DIAG_ASSIGN register */
 #define AD74413R_DIAG_ASSIGN_MASK(x)		(NO_OS_GENMASK(3, 0) << (x))
@@ -292,6 +308,12 @@ enum ad74413r_adc_sample {
 struct ad74413r_init_param {
 	enum ad74413r_chip_id chip_id;
 	struct no_os_spi_init_param comm_param;
+	/**
+	 * Keep a copy of the configuration registers, so that reading them
+	 * doesn't use the bus and writing the value they already hold is
+	 * skipped.
+	 */
+	bool reg_cache;
 };
 
 /**
@@ -346,6 +368,10 @@ struct ad74413r_desc {
 	struct no_os_spi_desc *comm_desc;
 	uint8_t comm_buff[4];
 	struct ad74413r_channel_config channel_configs[AD74413R_N_CHANNELS];
+	bool reg_cache;
+	/** Bitmask of the registers having a valid value in reg_cache_val */
+	uint64_t reg_cache_valid;
+	uint16_t reg_cache_val[AD74413R_REG_CACHE_SIZE];
 };
 
 /** Converts a millivolt value in the corresponding DAC 13 bit code */
@@ -416,6 +442,15 @@ int ad74413r_set_adc_rate(struct ad74413r_desc *, uint32_t,
 /** Start or stop ADC conversions */
 int ad74413r_set_adc_conv_seq(struct ad74413r_desc *, enum ad74413r_conv_seq);
 
+/** Start continuous conversions on a set of ADC and diagnostic channels */
+int ad74413r_set_adc_conv_cont(struct ad74413r_desc *, uint8_t, uint8_t);
+
+/** Burst read the raw frames of the first result registers */
+int ad74413r_get_adc_results_raw(struct ad74413r_desc *, uint8_t *, uint32_t);
+
+/** Burst read all the ADC and diagnostic results */
+int ad74413r_get_adc_results(struct ad74413r_desc *, uint16_t *, uint16_t *);
+
 /** Get a single ADC raw value for a specific channel, then power down the ADC */
 int ad74413r_get_adc_single(struct ad74413r_desc *, uint32_t, uint16_t *);
 
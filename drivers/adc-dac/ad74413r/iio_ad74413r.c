@@ -589,11 +589,29 @@ static int ad74413r_iio_setup_channels(struct ad74413r_iio_desc *iio_desc)
 static int ad74413r_iio_update_channels(void *dev, uint32_t mask)
 {
 	struct ad74413r_iio_desc *iio_desc = dev;
+	uint16_t conv_ctrl;
+	uint8_t diag_mask;
+	int ret;
 
 	iio_desc->active_channels = mask;
 	iio_desc->no_of_active_channels = no_os_hweight8(mask);
 
-	return ad74413r_set_adc_conv_seq(iio_desc->ad74413r_desc, AD74413R_START_CONT);
+	/* The enabled diagnostics stay in the conversion sequence */
+	ret = ad74413r_reg_read(iio_desc->ad74413r_desc, AD74413R_ADC_CONV_CTRL,
+				&conv_ctrl);
+	if (ret)
+		return ret;
+	diag_mask = no_os_field_get(AD74413R_DIAG_EN_MASK(0) |
+				    AD74413R_DIAG_EN_MASK(1) |
+				    AD74413R_DIAG_EN_MASK(2) |
+				    AD74413R_DIAG_EN_MASK(3), conv_ctrl);
+
+	/* The results of the channels are read in one burst */
+	iio_desc->nb_results = diag_mask ? AD74413R_N_RESULTS :
+			       no_os_find_last_set_bit(mask) + 1;
+
+	return ad74413r_set_adc_conv_cont(iio_desc->ad74413r_desc, mask,
+					  diag_mask);
 }
 
 /**
@@ -608,6 +626,33 @@ static int ad74413r_iio_buffer_disable(void *dev)
 					 AD74413R_STOP_PWR_DOWN);
 }
 
+/**
+ * @brief Read the raw frames of the enabled channels with a single burst of
+ * the result registers.
+ * @param iio_desc - The iio descriptor.
+ * @param scan - The raw frames of the enabled channels, in channel order.
+ * @return The number of frames in case of success, an error code otherwise.
+ */
+static int ad74413r_iio_read_scan(struct ad74413r_iio_desc *iio_desc,
+				  uint32_t *scan)
+{
+	uint32_t frames[AD74413R_N_RESULTS];
+	uint32_t i, j = 0;
+	int ret;
+
+	ret = ad74413r_get_adc_results_raw(iio_desc->ad74413r_desc,
+					   (uint8_t *)frames,
+					   iio_desc->nb_results);
+	if (ret)
+		return ret;
+
+	for (i = 0; i < AD74413R_N_CHANNELS; i++)
+		if (iio_desc->active_channels & NO_OS_BIT(i))
+			scan[j++] = frames[i];
+
+	return j;
+}
+
 /**
  * @brief Read a number of samples from each enabled channel.
  * @param dev - The iio device structure.
@@ -619,53 +664,142 @@ static int ad74413r_iio_read_samples(void *dev, uint32_t *buf, uint32_t samples)
 {
 	int ret;
 	uint32_t j = 0;
-	uint32_t val;
-	uint32_t i, chan_i;
+	uint32_t i;
 
 	for (i = 0; i < samples; i++) {
-		for (chan_i = 0; chan_i < AD74413R_N_CHANNELS; chan_i++) {
-			if (((struct ad74413r_iio_desc *)dev)->active_channels & NO_OS_BIT(chan_i)) {
-				ret = ad74413r_reg_read_raw(((struct ad74413r_iio_desc *)dev)->ad74413r_desc,
-							    AD74413R_ADC_RESULT(chan_i),
-							    (uint8_t *)&val);
-				if (ret)
-					return ret;
-				buf[j++] = val;
-			}
-		}
+		ret = ad74413r_iio_read_scan(dev, &buf[j]);
+		if (ret < 0)
+			return ret;
+		j += ret;
 	}
 
 	return samples;
 }
 
 /**
- * @brief Read a sample for each enabled channel.
+ * @brief Read a sample for each enabled channel. Triggered by the ADC_RDY
+ * pin, the scan then holds the results of the last conversion sequence.
  * @param dev_data - The iio device data structure.
  * @return 0 in case of success, an error code otherwise.
  */
 static int ad74413r_iio_trigger_handler(struct iio_device_data *dev_data)
 {
 	int ret;
+	uint32_t buff[AD74413R_N_CHANNELS];
+
+	ret = ad74413r_iio_read_scan(dev_data->dev, buff);
+	if (ret < 0)
+		return ret;
+
+	return iio_buffer_push_scan(dev_data->buffer, buff);
+}
+
+/**
+ * @brief Post an IIO event for each alert of the ALERT_STATUS register.
+ * @param ctx - The iio descriptor.
+ */
+static void ad74413r_iio_alert_handler(void *ctx)
+{
+	struct ad74413r_iio_desc *desc = ctx;
+	enum ad74413r_op_mode function;
+	enum iio_chan_type type;
+	uint16_t status;
 	uint32_t i;
-	uint32_t val;
-	uint32_t buff[4];
-	struct ad74413r_iio_desc *iio_desc;
-	struct ad74413r_desc *desc;
 
-	iio_desc = dev_data->dev;
-	desc = iio_desc->ad74413r_desc;
+	/* The alerts are cleared by writing them back */
+	if (ad74413r_reg_read(desc->ad74413r_desc, AD74413R_ALERT_STATUS,
+			      &status))
+		return;
+	if (ad74413r_reg_write(desc->ad74413r_desc, AD74413R_ALERT_STATUS,
+			       status))
+		return;
 
+	/* Short circuit of an output or open circuit of a current loop */
 	for (i = 0; i < AD74413R_N_CHANNELS; i++) {
-		if (iio_desc->active_channels & NO_OS_BIT(i)) {
-			ret = ad74413r_reg_read_raw(desc, AD74413R_ADC_RESULT(i),
-						    (uint8_t *)&val);
-			if (ret)
-				return ret;
-			buff[i] = val;
-		}
+		if (!(status & AD74413R_VI_ERR_MASK(i)))
+			continue;
+
+		function = desc->ad74413r_desc->channel_configs[i].function;
+		type = function == AD74413R_CURRENT_OUT ? IIO_CURRENT :
+		       IIO_VOLTAGE;
+		iio_push_event(desc->events,
+			       IIO_UNMOD_EVENT_CODE(type, i, IIO_EV_TYPE_THRESH,
+						    IIO_EV_DIR_EITHER), 0);
 	}
 
-	return iio_buffer_push_scan(dev_data->buffer, buff);
+	if (status & AD74413R_HI_TEMP_ERR_MASK)
+		iio_push_event(desc->events,
+			       IIO_UNMOD_EVENT_CODE(IIO_TEMP, 0,
+						    IIO_EV_TYPE_THRESH,
+						    IIO_EV_DIR_RISING), 0);
+}
+
+/**
+ * @brief Deliver the alerts as IIO events, from the ALERT interrupt.
+ * @param desc - The iio descriptor.
+ * @return 0 in case of success, an error code otherwise.
+ */
+static int ad74413r_iio_alert_setup(struct ad74413r_iio_desc *desc)
+{
+	int ret;
+
+	ret = iio_event_queue_init(&desc->events, AD74413R_IIO_EVENTS);
+	if (ret)
+		return ret;
+
+	desc->alert_irq_cb = (struct no_os_callback_desc) {
+		.callback = ad74413r_iio_alert_handler,
+		.ctx = desc,
+		.event = NO_OS_EVT_GPIO,
+		.peripheral = NO_OS_GPIO_IRQ
+	};
+
+	ret = no_os_irq_register_callback(desc->alert_irq_ctrl,
+					  desc->alert_irq_num,
+					  &desc->alert_irq_cb);
+	if (ret)
+		goto error_queue;
+
+	/* ALERT is active low */
+	ret = no_os_irq_trigger_level_set(desc->alert_irq_ctrl,
+					  desc->alert_irq_num,
+					  NO_OS_IRQ_EDGE_FALLING);
+	if (ret)
+		goto error_irq;
+
+	ret = no_os_irq_enable(desc->alert_irq_ctrl, desc->alert_irq_num);
+	if (ret)
+		goto error_irq;
+
+	desc->iio_dev->events = desc->events;
+
+	return 0;
+
+error_irq:
+	no_os_irq_unregister_callback(desc->alert_irq_ctrl, desc->alert_irq_num,
+				      &desc->alert_irq_cb);
+error_queue:
+	iio_event_queue_remove(desc->events);
+	desc->events = NULL;
+
+	return ret;
+}
+
+/**
+ * @brief Release the ALERT interrupt and the event queue.
+ * @param desc - The iio descriptor.
+ */
+static void ad74413r_iio_alert_remove(struct ad74413r_iio_desc *desc)
+{
+	if (!desc->events)
+		return;
+
+	no_os_irq_disable(desc->alert_irq_ctrl, desc->alert_irq_num);
+	no_os_irq_unregister_callback(desc->alert_irq_ctrl, desc->alert_irq_num,
+				      &desc->alert_irq_cb);
+	desc->iio_dev->events = NULL;
+	iio_event_queue_remove(desc->events);
+	desc->events = NULL;
 }
 
 /**
@@ -722,6 +856,14 @@ int ad74413r_iio_init(struct ad74413r_iio_desc **iio_desc,
 	if (ret)
 		goto err;
 
+	if (init_param->alert_irq_ctrl) {
+		descriptor->alert_irq_ctrl = init_param->alert_irq_ctrl;
+		descriptor->alert_irq_num = init_param->alert_irq_num;
+		ret = ad74413r_iio_alert_setup(descriptor);
+		if (ret)
+			goto err;
+	}
+
 	*iio_desc = descriptor;
 
 	return 0;
@@ -741,6 +883,8 @@ int ad74413r_iio_remove(struct ad74413r_iio_desc *desc)
 {
 	int ret;
 
+	ad74413r_iio_alert_remove(desc);
+
 	ret = ad74413r_remove(desc->ad74413r_desc);
 	if (ret)
 		return ret;
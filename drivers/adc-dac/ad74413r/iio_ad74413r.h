@@ -43,8 +43,15 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include "iio.h"
+#include "no_os_irq.h"
 #include "ad74413r.h"
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+/** Alerts that can wait in the event queue for the IIO clients */
+#define AD74413R_IIO_EVENTS	16
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -56,6 +63,13 @@ struct ad74413r_iio_desc {
 	struct iio_device *iio_dev;
 	uint32_t active_channels;
 	uint8_t no_of_active_channels;
+	/** Result registers read by each burst, from ADC_RESULT(0) */
+	uint32_t nb_results;
+	/** Alerts posted by the ALERT interrupt, NULL without interrupt */
+	struct iio_event_queue *events;
+	struct no_os_irq_ctrl_desc *alert_irq_ctrl;
+	uint32_t alert_irq_num;
+	struct no_os_callback_desc alert_irq_cb;
 };
 
 /**
@@ -64,6 +78,13 @@ struct ad74413r_iio_desc {
 struct ad74413r_iio_desc_init_param {
 	struct ad74413r_init_param *ad74413r_init_param;
 	struct ad74413r_channel_config channel_configs[AD74413R_N_CHANNELS];
+	/**
+	 * Optional. Controller of the interrupt of the ALERT pin. The alerts
+	 * are then delivered as IIO events instead of being polled.
+	 */
+	struct no_os_irq_ctrl_desc *alert_irq_ctrl;
+	/** Interrupt number of the ALERT pin */
+	uint32_t alert_irq_num;
 };
 
 /**
@@ -218,6 +218,86 @@ int32_t ad463x_set_drive_strength(struct ad463x_dev *dev, uint8_t mode)
 					   AD463X_DRIVER_STRENGTH_MASK, mode);
 }
 
+/**
+ * @brief Compute the capture data width for a lane mode.
+ *        Each SDO lane carries capture_data_width bits of a sample, the
+ *        lanes are deserialized by the HDL.
+ * @param dev - The device structure.
+ * @param lane_mode - The lane mode.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad463x_calc_capture_width(struct ad463x_dev *dev,
+		uint8_t lane_mode)
+{
+	uint8_t sample_width;
+
+	if (dev->output_mode > AD463X_16_DIFF_8_COM)
+		sample_width = 32;
+	else
+		sample_width = 24;
+
+	switch (lane_mode) {
+	case AD463X_ONE_LANE_PER_CH:
+		dev->capture_data_width = sample_width;
+		break;
+
+	case AD463X_TWO_LANES_PER_CH:
+		dev->capture_data_width = sample_width / 2;
+		break;
+
+	case AD463X_FOUR_LANES_PER_CH:
+		dev->capture_data_width = sample_width / 4;
+		break;
+
+	case AD463X_SHARED_TWO_CH:
+		dev->capture_data_width = sample_width * 2;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	if (dev->data_rate == AD463X_DDR_MODE)
+		dev->capture_data_width /= 2;
+
+	dev->read_bytes_no = dev->capture_data_width / 8;
+
+	return 0;
+}
+
+/**
+ * @brief Set the lane mode, the number of SDO lanes used per channel.
+ *        Using more lanes lowers the SCK rate needed for a sample rate, the
+ *        HDL must be built with as many SDI lanes. Must be called in
+ *        register configuration mode, before ad463x_exit_reg_cfg_mode().
+ * @param dev - The device structure.
+ * @param lane_mode - The lane mode: AD463X_ONE_LANE_PER_CH,
+ *		      AD463X_TWO_LANES_PER_CH, AD463X_FOUR_LANES_PER_CH or
+ *		      AD463X_SHARED_TWO_CH.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad463x_set_lane_mode(struct ad463x_dev *dev, uint8_t lane_mode)
+{
+	uint8_t width = dev->capture_data_width;
+	uint8_t bytes_no = dev->read_bytes_no;
+	int32_t ret;
+
+	ret = ad463x_calc_capture_width(dev, lane_mode);
+	if (ret != 0)
+		return ret;
+
+	ret = ad463x_spi_reg_write_masked(dev, AD463X_REG_MODES,
+					  AD463X_LANE_MODE_MSK, lane_mode);
+	if (ret != 0) {
+		dev->capture_data_width = width;
+		dev->read_bytes_no = bytes_no;
+		return ret;
+	}
+
+	dev->lane_mode = lane_mode;
+
+	return 0;
+}
+
 /**
  * @brief Exit register configuration mode.
  * @param dev - The device structure.
@@ -379,6 +459,74 @@ int32_t ad463x_read_data(struct ad463x_dev *dev,
 	return ret;
 }
 
+/**
+ * @brief Read from device continuously.
+ *        The SPI engine offload and its DMAC fill a ring of nb_segments
+ *        segments starting at buf, until
+ *        ad463x_read_data_continuous_stop is called.
+ * @param [in] dev - ad463x_dev device handler.
+ * @param [out] buf - ring buffer, of nb_segments * segment_samples samples.
+ * @param [in] segment_samples - number of samples in a segment.
+ * @param [in] nb_segments - number of segments in the ring. At least 2.
+ * @param [in] segment_done - called from the DMAC interrupt with the address
+ *			      and size in bytes of each filled segment. The
+ *			      segment must be consumed, after invalidating its
+ *			      data cache, before the ring wraps around.
+ * @param [in] ctx - parameter passed to segment_done.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad463x_read_data_continuous(struct ad463x_dev *dev,
+				    uint32_t *buf,
+				    uint32_t segment_samples,
+				    uint32_t nb_segments,
+				    void (*segment_done)(void *ctx,
+						    uint32_t addr,
+						    uint32_t size),
+				    void *ctx)
+{
+	int32_t ret;
+	uint32_t commands_data[1] = {0};
+	struct spi_engine_offload_message msg;
+	uint32_t spi_eng_msg_cmds[3] = {
+		CS_LOW,
+		READ(dev->read_bytes_no),
+		CS_HIGH
+	};
+
+	ret = spi_engine_offload_init(dev->spi_desc, dev->offload_init_param);
+	if (ret != 0)
+		return ret;
+
+	msg.commands = spi_eng_msg_cmds;
+	msg.no_commands = NO_OS_ARRAY_SIZE(spi_eng_msg_cmds);
+	msg.rx_addr = (uint32_t)buf;
+	msg.commands_data = commands_data;
+
+	ret = spi_engine_offload_stream_start(dev->spi_desc, msg,
+					      segment_samples, nb_segments,
+					      segment_done, ctx);
+	if (ret != 0)
+		return ret;
+
+	return no_os_pwm_enable(dev->trigger_pwm_desc);
+}
+
+/**
+ * @brief Stop reading started with ad463x_read_data_continuous.
+ * @param [in] dev - ad463x_dev device handler.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad463x_read_data_continuous_stop(struct ad463x_dev *dev)
+{
+	int32_t ret;
+
+	ret = no_os_pwm_disable(dev->trigger_pwm_desc);
+	if (ret != 0)
+		return ret;
+
+	return spi_engine_offload_stream_stop(dev->spi_desc);
+}
+
 /**
  * @brief Initialize the device.
  * @param [out] device - The device structure.
@@ -392,7 +540,6 @@ int32_t ad463x_init(struct ad463x_dev **device,
 	struct ad463x_dev *dev;
 	int32_t ret;
 	uint8_t data = 0;
-	uint8_t sample_width;
 
 	if (!init_param || !device)
 		return -1;
@@ -440,36 +587,9 @@ int32_t ad463x_init(struct ad463x_dev **device,
 	dev->device_id = init_param->device_id;
 	dev->dcache_invalidate_range = init_param->dcache_invalidate_range;
 
-	if (dev->output_mode > AD463X_16_DIFF_8_COM)
-		sample_width = 32;
-	else
-		sample_width = 24;
-
-	switch (dev->lane_mode) {
-	case AD463X_ONE_LANE_PER_CH:
-		dev->capture_data_width = sample_width;
-		break;
-
-	case AD463X_TWO_LANES_PER_CH:
-		dev->capture_data_width = sample_width / 2;
-		break;
-
-	case AD463X_FOUR_LANES_PER_CH:
-		dev->capture_data_width = sample_width / 4;
-		break;
-
-	case AD463X_SHARED_TWO_CH:
-		dev->capture_data_width = sample_width * 2;
-		break;
-	default:
+	ret = ad463x_calc_capture_width(dev, dev->lane_mode);
+	if (ret != 0)
 		goto error_spi;
-		break;
-	}
-
-	if (dev->data_rate == AD463X_DDR_MODE)
-		dev->capture_data_width /= 2;
-
-	dev->read_bytes_no = dev->capture_data_width / 8;
 
 	ret = spi_engine_set_transfer_width(dev->spi_desc, dev->reg_data_width);
 	if (ret != 0)
@@ -279,6 +279,9 @@ int32_t ad463x_set_avg_frame_len(struct ad463x_dev *dev, uint8_t mode);
 /** Set drive strength */
 int32_t ad463x_set_drive_strength(struct ad463x_dev *dev, uint8_t mode);
 
+/** Set lane mode */
+int32_t ad463x_set_lane_mode(struct ad463x_dev *dev, uint8_t lane_mode);
+
 /** Exit register configuration mode */
 int32_t ad463x_exit_reg_cfg_mode(struct ad463x_dev *dev);
 
@@ -295,6 +298,19 @@ int32_t ad463x_read_data(struct ad463x_dev *dev,
 			 uint32_t *buf,
 			 uint16_t samples);
 
+/** Read data continuously, into a ring of segments */
+int32_t ad463x_read_data_continuous(struct ad463x_dev *dev,
+				    uint32_t *buf,
+				    uint32_t segment_samples,
+				    uint32_t nb_segments,
+				    void (*segment_done)(void *ctx,
+						    uint32_t addr,
+						    uint32_t size),
+				    void *ctx);
+
+/** Stop reading started with ad463x_read_data_continuous */
+int32_t ad463x_read_data_continuous_stop(struct ad463x_dev *dev);
+
 /** Device initialization */
 int32_t ad463x_init(struct ad463x_dev **device,
 		    struct ad463x_init_param *init_param);
@@ -44,6 +44,7 @@
 
 #include "ad463x.h"
 #include "iio_ad463x.h"
+#include "iio.h"
 #include "no_os_error.h"
 
 /******************************************************************************/
@@ -112,6 +113,71 @@ static int32_t _iio_ad463x_read_dev(struct iio_ad463x *desc, uint32_t *buff,
 	return nb_samples;
 }
 
+/* Push the scans of a segment filled by the DMAC, in interrupt context. */
+static void _iio_ad463x_segment_done(void *ctx, uint32_t addr, uint32_t size)
+{
+	struct iio_ad463x *desc = ctx;
+	uint32_t *data = (uint32_t *)addr;
+	uint32_t num_ch = desc->iio_dev_desc.num_ch;
+	uint32_t scan[2];
+	uint32_t i, j, ch;
+
+	if (desc->ad463x_desc->dcache_invalidate_range)
+		desc->ad463x_desc->dcache_invalidate_range(addr, size);
+
+	/* The DMAC writes one word per channel for each conversion */
+	for (i = 0; i + num_ch <= size / sizeof(*data); i += num_ch) {
+		for (ch = 0, j = 0; ch < num_ch; ch++)
+			if (desc->mask & NO_OS_BIT(ch))
+				scan[j++] = data[i + ch];
+
+		if (iio_buffer_push_scan(desc->buffer, scan))
+			return;
+	}
+}
+
+static int32_t _iio_ad463x_submit(struct iio_device_data *dev_data)
+{
+	struct iio_ad463x *desc = dev_data->dev;
+	int32_t ret;
+
+	/* Once started, the stream fills the buffer on its own */
+	if (desc->streaming)
+		return 0;
+
+	desc->buffer = dev_data->buffer;
+	ret = ad463x_read_data_continuous(desc->ad463x_desc, desc->ring,
+					  IIO_AD463X_SEGMENT_SCANS *
+					  desc->iio_dev_desc.num_ch,
+					  IIO_AD463X_NB_SEGMENTS,
+					  _iio_ad463x_segment_done, desc);
+	if (ret)
+		return ret;
+
+	desc->streaming = true;
+
+	return 0;
+}
+
+static int32_t _iio_ad463x_post_disable(struct iio_ad463x *desc)
+{
+	int32_t ret;
+
+	if (!desc)
+		return -EINVAL;
+
+	if (!desc->streaming)
+		return 0;
+
+	ret = ad463x_read_data_continuous_stop(desc->ad463x_desc);
+	if (ret)
+		return ret;
+
+	desc->streaming = false;
+
+	return 0;
+}
+
 /**
  * @brief Init for reading/writing and parameterization of a
  * ad463x device.
@@ -129,7 +195,25 @@ int32_t iio_ad463x_init(struct iio_ad463x **desc,
 		return -1;
 
 	iio_ad463x->ad463x_desc = dev;
-	iio_ad463x->iio_dev_desc = ad463x_iio_desc;
+
+	/*
+	 * Stream continuously when the offload RX DMAC interrupt can be used,
+	 * so that conversions are not lost between buffer refills.
+	 */
+	if (dev->offload_init_param &&
+	    dev->offload_init_param->irq_option == IRQ_ENABLED) {
+		iio_ad463x->iio_dev_desc = ad463x_iio_stream_desc;
+		iio_ad463x->ring = calloc(IIO_AD463X_SEGMENT_SCANS *
+					  IIO_AD463X_NB_SEGMENTS *
+					  ad463x_iio_stream_desc.num_ch,
+					  sizeof(*iio_ad463x->ring));
+		if (!iio_ad463x->ring) {
+			free(iio_ad463x);
+			return -1;
+		}
+	} else {
+		iio_ad463x->iio_dev_desc = ad463x_iio_desc;
+	}
 
 	*desc = iio_ad463x;
 
@@ -146,6 +230,8 @@ int32_t iio_ad463x_remove(struct iio_ad463x *desc)
 	if (!desc)
 		return -1;
 
+	_iio_ad463x_post_disable(desc);
+	free(desc->ring);
 	free(desc);
 
 	return 0;
@@ -158,4 +244,13 @@ struct iio_device ad463x_iio_desc = {
 	.read_dev = (int32_t (*)())_iio_ad463x_read_dev
 };
 
+struct iio_device ad463x_iio_stream_desc = {
+	.channels = iio_adc_channels,
+	.num_ch = 2,
+	.lock_free_buffer = true,
+	.pre_enable = (int32_t (*)())_iio_ad463x_prepare_transfer,
+	.post_disable = (int32_t (*)())_iio_ad463x_post_disable,
+	.submit = _iio_ad463x_submit
+};
+
 #endif /* IIO_SUPPORT */
@@ -53,9 +53,20 @@
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
 
+/* Scans of a segment of the streaming ring */
+#define IIO_AD463X_SEGMENT_SCANS	1024
+/* Segments of the streaming ring */
+#define IIO_AD463X_NB_SEGMENTS		4
+
 struct iio_ad463x {
 	/* Mask of active ch */
 	uint32_t mask;
+	/* Ring filled by the DMAC when streaming, NULL otherwise */
+	uint32_t *ring;
+	/* IIO buffer the streamed scans are pushed into */
+	struct iio_buffer *buffer;
+	/* Set while the stream is running */
+	bool streaming;
 	/** iio device descriptor */
 	struct iio_device iio_dev_desc;
 	/** Device Descriptor */
@@ -63,6 +74,7 @@ struct iio_ad463x {
 };
 
 extern struct iio_device ad463x_iio_desc;
+extern struct iio_device ad463x_iio_stream_desc;
 
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
@@ -537,6 +537,7 @@ int32_t ad469x_std_sequence_ch(struct ad469x_dev *dev, uint16_t ch_mask)
 		return ret;
 
 	dev->num_slots = no_os_hweight16(ch_mask);
+	dev->std_seq_ch = ch_mask;
 
 	return ret;
 }
@@ -804,6 +805,308 @@ int32_t ad469x_read_data(struct ad469x_dev *dev,
 	return ret;
 }
 
+#if !defined(USE_STANDARD_SPI)
+/**
+ * @brief Start the offload streaming, sending cmd on each conversion.
+ * @param [in] dev - ad469x_dev device handler.
+ * @param [in] cmd - Command sent during each sample readout.
+ * @param [out] buf - ring buffer, of nb_segments * segment_samples samples.
+ * @param [in] segment_samples - number of samples in a segment.
+ * @param [in] nb_segments - number of segments in the ring.
+ * @param [in] segment_done - called for each filled segment.
+ * @param [in] ctx - parameter passed to segment_done.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad469x_stream_start(struct ad469x_dev *dev,
+				   uint32_t cmd,
+				   uint32_t *buf,
+				   uint32_t segment_samples,
+				   uint32_t nb_segments,
+				   void (*segment_done)(void *ctx,
+						   uint32_t addr,
+						   uint32_t size),
+				   void *ctx)
+{
+	int32_t ret;
+	uint32_t commands_data[1];
+	struct spi_engine_offload_message msg;
+	uint32_t spi_eng_msg_cmds[3] = {
+		CS_LOW,
+		WRITE_READ(1),
+		CS_HIGH
+	};
+
+	commands_data[0] = cmd << 8;
+
+	ret = spi_engine_offload_init(dev->spi_desc, dev->offload_init_param);
+	if (ret != 0)
+		return ret;
+
+	msg.commands = spi_eng_msg_cmds;
+	msg.no_commands = NO_OS_ARRAY_SIZE(spi_eng_msg_cmds);
+	msg.rx_addr = (uint32_t)buf;
+	msg.commands_data = commands_data;
+
+	ret = spi_engine_offload_stream_start(dev->spi_desc, msg,
+					      segment_samples * 2,
+					      nb_segments, segment_done, ctx);
+	if (ret != 0)
+		return ret;
+
+	return no_os_pwm_enable(dev->trigger_pwm_desc);
+}
+#endif
+
+/**
+ * @brief Read from device continuously.
+ *        The SPI engine offload and its DMAC fill a ring of nb_segments
+ *        segments starting at buf, until
+ *        ad469x_read_data_continuous_stop is called.
+ * @param [in] dev - ad469x_dev device handler.
+ * @param [in] channel - ad469x selected channel.
+ * @param [out] buf - ring buffer, of nb_segments * segment_samples samples.
+ * @param [in] segment_samples - number of samples in a segment.
+ * @param [in] nb_segments - number of segments in the ring. At least 2.
+ * @param [in] segment_done - called from the DMAC interrupt with the address
+ *			      and size in bytes of each filled segment. The
+ *			      segment must be consumed, after invalidating its
+ *			      data cache, before the ring wraps around.
+ * @param [in] ctx - parameter passed to segment_done.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad469x_read_data_continuous(struct ad469x_dev *dev,
+				    uint8_t channel,
+				    uint32_t *buf,
+				    uint32_t segment_samples,
+				    uint32_t nb_segments,
+				    void (*segment_done)(void *ctx,
+						    uint32_t addr,
+						    uint32_t size),
+				    void *ctx)
+{
+#if !defined(USE_STANDARD_SPI)
+	uint32_t cmd;
+
+	if (channel < AD469x_CHANNEL_NO)
+		cmd = AD469x_CMD_CONFIG_CH_SEL(channel);
+	else if (channel == AD469x_CHANNEL_TEMP)
+		cmd = AD469x_CMD_SEL_TEMP_SNSOR_CH;
+	else
+		return -EINVAL;
+
+	return ad469x_stream_start(dev, cmd, buf, segment_samples, nb_segments,
+				   segment_done, ctx);
+#else
+	return -ENOSYS;
+#endif
+}
+
+/**
+ * @brief Get the channel converted in each slot of the active sequence.
+ * @param [in] dev - ad469x_dev device handler.
+ * @param [out] map - Channel of each slot, AD469x_CHANNEL_TEMP for the
+ *		      temperature slot. AD469x_SLOTS_NO + 1 entries.
+ * @return Number of slots of the sequence, negative error code if no
+ *	   sequencer is active.
+ */
+static int32_t ad469x_seq_get_map(struct ad469x_dev *dev, uint8_t *map)
+{
+	uint8_t ch, n = 0;
+
+	switch (dev->ch_sequence) {
+	case AD469x_standard_seq:
+		/* The standard sequencer converts in channel order */
+		for (ch = 0; ch < AD469x_CHANNEL_NO; ch++)
+			if (dev->std_seq_ch & NO_OS_BIT(ch))
+				map[n++] = ch;
+		break;
+	case AD469x_advanced_seq:
+		for (n = 0; n < dev->num_slots; n++)
+			map[n] = dev->ch_slots[n];
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	if (dev->temp_enabled)
+		map[n++] = AD469x_CHANNEL_TEMP;
+
+	if (!n)
+		return -EINVAL;
+
+	return n;
+}
+
+/**
+ * @brief Get the conversion result of a sample read in sequencer mode.
+ * @param [in] dev - ad469x_dev device handler.
+ * @param [in] ch - Channel of the sample.
+ * @param [in] sample - Sample data, as read.
+ * @return The conversion result.
+ */
+static uint32_t ad469x_seq_sample(struct ad469x_dev *dev, uint8_t ch,
+				  uint32_t sample)
+{
+	if (dev->ch_sequence != AD469x_advanced_seq ||
+	    ch == AD469x_CHANNEL_TEMP)
+		return sample;
+
+	return sample >> (dev->capture_data_width -
+			  dev->adv_seq_osr_resol[ch]);
+}
+
+/**
+ * @brief Read from device continuously, with the channel sequencer activated.
+ *        The sequencer selects the channel of each conversion, so the
+ *        sequence runs back to back, at the PWM rate, until
+ *        ad469x_read_data_continuous_stop is called. Use ad469x_seq_demux or
+ *        ad469x_seq_get_scans on the filled segments.
+ * @param [in] dev - ad469x_dev device handler.
+ * @param [out] buf - ring buffer, of nb_segments * segment_scans sequences.
+ * @param [in] segment_scans - number of whole sequences in a segment.
+ * @param [in] nb_segments - number of segments in the ring. At least 2.
+ * @param [in] segment_done - called from the DMAC interrupt with the address
+ *			      and size in bytes of each filled segment, as for
+ *			      ad469x_read_data_continuous.
+ * @param [in] ctx - parameter passed to segment_done.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad469x_seq_read_data_continuous(struct ad469x_dev *dev,
+					uint32_t *buf,
+					uint32_t segment_scans,
+					uint32_t nb_segments,
+					void (*segment_done)(void *ctx,
+							uint32_t addr,
+							uint32_t size),
+					void *ctx)
+{
+#if !defined(USE_STANDARD_SPI)
+	uint8_t map[AD469x_SLOTS_NO + 1];
+	int32_t n;
+
+	n = ad469x_seq_get_map(dev, map);
+	if (n < 0)
+		return n;
+
+	/* No command, the sequencer moves to the next slot by itself */
+	return ad469x_stream_start(dev, 0, buf, segment_scans * n, nb_segments,
+				   segment_done, ctx);
+#else
+	return -ENOSYS;
+#endif
+}
+
+/**
+ * @brief De-interleave sequences read in sequencer mode into per channel
+ *	  arrays.
+ * @param [in] dev - ad469x_dev device handler.
+ * @param [in] buf - nb_scans sequences, as read.
+ * @param [in] nb_scans - Number of sequences in buf.
+ * @param [out] ch_buf - Array for each channel, indexed by channel number,
+ *			 AD469x_CHANNEL_TEMP for the temperature. The samples
+ *			 of a channel assigned to several slots follow each
+ *			 other. NULL entries are skipped.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad469x_seq_demux(struct ad469x_dev *dev,
+			 uint32_t *buf,
+			 uint32_t nb_scans,
+			 uint32_t *ch_buf[AD469x_CHANNEL_TEMP + 1])
+{
+	uint32_t cnt[AD469x_CHANNEL_TEMP + 1] = { 0 };
+	uint8_t map[AD469x_SLOTS_NO + 1];
+	uint32_t i;
+	int32_t j, n;
+	uint8_t ch;
+
+	n = ad469x_seq_get_map(dev, map);
+	if (n < 0)
+		return n;
+
+	for (i = 0; i < nb_scans; i++) {
+		for (j = 0; j < n; j++) {
+			ch = map[j];
+			if (ch_buf[ch])
+				ch_buf[ch][cnt[ch]++] =
+					ad469x_seq_sample(dev, ch, buf[j]);
+		}
+		buf += n;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Reorder sequences read in sequencer mode into scans, with one sample
+ *	  per active channel in channel order and the temperature last, which
+ *	  is the IIO buffer layout. Each channel must be assigned to one slot
+ *	  at most.
+ * @param [in] dev - ad469x_dev device handler.
+ * @param [in] buf - nb_scans sequences, as read.
+ * @param [in] nb_scans - Number of sequences in buf.
+ * @param [out] scans - nb_scans scans. Can be buf.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad469x_seq_get_scans(struct ad469x_dev *dev,
+			     uint32_t *buf,
+			     uint32_t nb_scans,
+			     uint32_t *scans)
+{
+	uint8_t pos[AD469x_CHANNEL_TEMP + 1];
+	uint32_t scan[AD469x_CHANNEL_TEMP + 1];
+	uint8_t map[AD469x_SLOTS_NO + 1];
+	uint32_t active = 0;
+	uint32_t i;
+	int32_t j, n;
+	uint8_t ch, k = 0;
+
+	n = ad469x_seq_get_map(dev, map);
+	if (n < 0)
+		return n;
+
+	for (j = 0; j < n; j++) {
+		if (active & NO_OS_BIT(map[j]))
+			return -EINVAL;
+		active |= NO_OS_BIT(map[j]);
+	}
+
+	/* Position of each channel in the scan */
+	for (ch = 0; ch <= AD469x_CHANNEL_TEMP; ch++)
+		if (active & NO_OS_BIT(ch))
+			pos[ch] = k++;
+
+	for (i = 0; i < nb_scans; i++) {
+		for (j = 0; j < n; j++)
+			scan[pos[map[j]]] = ad469x_seq_sample(dev, map[j],
+							      buf[j]);
+		memcpy(scans, scan, n * sizeof(*scan));
+		buf += n;
+		scans += n;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Stop reading started with ad469x_read_data_continuous.
+ * @param [in] dev - ad469x_dev device handler.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad469x_read_data_continuous_stop(struct ad469x_dev *dev)
+{
+#if !defined(USE_STANDARD_SPI)
+	int32_t ret;
+
+	ret = no_os_pwm_disable(dev->trigger_pwm_desc);
+	if (ret != 0)
+		return ret;
+
+	return spi_engine_offload_stream_stop(dev->spi_desc);
+#else
+	return -ENOSYS;
+#endif
+}
+
 /**
  * @brief Resets the ad469x device
  * @param [in] dev - ad469x_dev device handler.
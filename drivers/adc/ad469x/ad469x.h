@@ -323,6 +323,8 @@ struct ad469x_dev {
 	bool temp_enabled;
 	/** Number of active channel slots, for advanced sequencer */
 	uint8_t num_slots;
+	/** Channels enabled for standard sequencer */
+	uint16_t std_seq_ch;
 };
 
 /******************************************************************************/
@@ -356,11 +358,47 @@ int32_t ad469x_read_data(struct ad469x_dev *dev,
 			 uint32_t *buf,
 			 uint16_t samples);
 
+/* Read data from device continuously, into a ring of segments */
+int32_t ad469x_read_data_continuous(struct ad469x_dev *dev,
+				    uint8_t channel,
+				    uint32_t *buf,
+				    uint32_t segment_samples,
+				    uint32_t nb_segments,
+				    void (*segment_done)(void *ctx,
+						    uint32_t addr,
+						    uint32_t size),
+				    void *ctx);
+
+/* Stop reading started with ad469x_read_data_continuous */
+int32_t ad469x_read_data_continuous_stop(struct ad469x_dev *dev);
+
 /* Read from device when converter has the channel sequencer activated */
 int32_t ad469x_seq_read_data(struct ad469x_dev *dev,
 			     uint32_t *buf,
 			     uint16_t samples);
 
+/* Read continuously when converter has the channel sequencer activated */
+int32_t ad469x_seq_read_data_continuous(struct ad469x_dev *dev,
+					uint32_t *buf,
+					uint32_t segment_scans,
+					uint32_t nb_segments,
+					void (*segment_done)(void *ctx,
+							uint32_t addr,
+							uint32_t size),
+					void *ctx);
+
+/* De-interleave sequences read in sequencer mode into per channel arrays */
+int32_t ad469x_seq_demux(struct ad469x_dev *dev,
+			 uint32_t *buf,
+			 uint32_t nb_scans,
+			 uint32_t *ch_buf[AD469x_CHANNEL_TEMP + 1]);
+
+/* Reorder sequences read in sequencer mode into scans in channel order */
+int32_t ad469x_seq_get_scans(struct ad469x_dev *dev,
+			     uint32_t *buf,
+			     uint32_t nb_scans,
+			     uint32_t *scans);
+
 /* Set channel sequence */
 int32_t ad469x_set_channel_sequence(struct ad469x_dev *dev,
 				    enum ad469x_channel_sequencing seq);
@@ -45,6 +45,9 @@
 #include <stdbool.h>
 #include "ad7124.h"
 #include "no_os_delay.h"
+#include "no_os_error.h"
+#include "no_os_sched.h"
+#include "no_os_sd_odr.h"
 
 /* Error codes */
 #define INVALID_VAL -1 /* Invalid argument */
@@ -201,6 +204,9 @@ int32_t ad7124_read_register(struct ad7124_dev *dev,
 {
 	int32_t ret;
 
+	if (dev->cont_read)
+		return INVALID_VAL;
+
 	if (p_reg->addr != AD7124_ERR_REG && dev->check_ready) {
 		ret = ad7124_wait_for_spi_ready(dev,
 						dev->spi_rdy_poll_cnt);
@@ -250,6 +256,9 @@ int32_t ad7124_write_register(struct ad7124_dev *dev,
 {
 	int32_t ret;
 
+	if (dev->cont_read)
+		return INVALID_VAL;
+
 	if (dev->check_ready) {
 		ret = ad7124_wait_for_spi_ready(dev,
 						dev->spi_rdy_poll_cnt);
@@ -408,6 +417,10 @@ int32_t ad7124_wait_for_conv_ready(struct ad7124_dev *dev,
 		/* Check the RDY bit in the Status Register */
 		ready = (regs[AD7124_Status].value &
 			 AD7124_STATUS_REG_RDY) == 0;
+
+		/* Let the other scheduler works run between the polls */
+		if (!ready)
+			no_os_sched_yield();
 	}
 
 	return timeout ? 0 : TIMEOUT;
@@ -462,6 +475,139 @@ int32_t ad7124_get_read_chan_id(struct ad7124_dev *dev, uint32_t *status)
 	return ret;
 }
 
+/***************************************************************************//**
+ * @brief Writes the user settings, from AD7124_ADC_Control up to last, to the
+ *        device.
+ *
+ * @param dev  - The handler of the instance of the driver.
+ * @param last - First register that is not written.
+ *
+ * @return Returns 0 for success or negative error code.
+*******************************************************************************/
+static int32_t ad7124_write_settings(struct ad7124_dev *dev,
+				     enum ad7124_registers last)
+{
+	enum ad7124_registers reg_nr;
+	int32_t ret = 0;
+
+	for (reg_nr = AD7124_Status; reg_nr < last; reg_nr++) {
+		if (dev->regs[reg_nr].rw == AD7124_RW) {
+			ret = ad7124_write_register(dev, dev->regs[reg_nr]);
+			if (ret < 0)
+				return ret;
+		}
+
+		/* Get CRC State and device SPI interface settings */
+		if (reg_nr == AD7124_Error_En) {
+			ad7124_update_crcsetting(dev);
+			ad7124_update_dev_spi_settings(dev);
+		}
+	}
+
+	return ret;
+}
+
+/***************************************************************************//**
+ * @brief Enters or leaves the continuous read mode. In continuous read mode
+ *        the conversion results, with the status appended, are clocked out
+ *        without a command, saving the status polling and the command byte.
+ *        The device accepts no register access until the mode is left.
+ *        The mode is left with an interface reset, since the exit command is
+ *        only accepted while DOUT/RDY is low. The user settings, including
+ *        the offset and gain registers read back on entry, are then written
+ *        again. CRC is not supported in continuous read mode.
+ *
+ * @param dev    - The handler of the instance of the driver.
+ * @param enable - true to enter the mode, false to leave it.
+ *
+ * @return Returns 0 for success or negative error code.
+*******************************************************************************/
+int32_t ad7124_set_cont_read(struct ad7124_dev *dev, bool enable)
+{
+	struct ad7124_st_reg *regs, *ctrl;
+	enum ad7124_registers reg_nr;
+	int32_t ret;
+
+	if (!dev)
+		return INVALID_VAL;
+
+	if (dev->cont_read == enable)
+		return 0;
+
+	regs = dev->regs;
+	ctrl = &regs[AD7124_ADC_Control];
+
+	if (!enable) {
+		ctrl->value &= ~AD7124_ADC_CTRL_REG_CONT_READ;
+		dev->cont_read = false;
+
+		ret = ad7124_reset(dev);
+		if (ret < 0)
+			return ret;
+
+		return ad7124_write_settings(dev, AD7124_REG_NO);
+	}
+
+	if (dev->use_crc != AD7124_DISABLE_CRC)
+		return INVALID_VAL;
+
+	/* Keep the calibration results to restore them on exit */
+	for (reg_nr = AD7124_Offset_0; reg_nr < AD7124_REG_NO; reg_nr++) {
+		ret = ad7124_read_register(dev, &regs[reg_nr]);
+		if (ret < 0)
+			return ret;
+	}
+
+	ctrl->value |= AD7124_ADC_CTRL_REG_CONT_READ |
+		       AD7124_ADC_CTRL_REG_DATA_STATUS;
+	ret = ad7124_write_register(dev, *ctrl);
+	if (ret < 0) {
+		ctrl->value &= ~AD7124_ADC_CTRL_REG_CONT_READ;
+		return ret;
+	}
+
+	dev->cont_read = true;
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Reads a conversion result and its channel in continuous read mode.
+ *        To be called on the DOUT/RDY falling edge. The SPI transfer toggles
+ *        DOUT/RDY as well, such edges are detected with the RDY bit of the
+ *        appended status.
+ *
+ * @param dev    - The handler of the instance of the driver.
+ * @param p_data - Pointer to store the conversion result.
+ * @param ch     - Pointer to store the channel of the conversion.
+ *
+ * @return Returns 0 for success, -EAGAIN if no new result was available or
+ *         negative error code.
+*******************************************************************************/
+int32_t ad7124_read_cont_data(struct ad7124_dev *dev, int32_t *p_data,
+			      uint8_t *ch)
+{
+	uint8_t buf[4] = {0, 0, 0, 0};
+	int32_t ret;
+
+	if (!dev || !dev->cont_read)
+		return INVALID_VAL;
+
+	ret = no_os_spi_write_and_read(dev->spi_desc, buf, sizeof(buf));
+	if (ret < 0)
+		return ret;
+
+	dev->regs[AD7124_Status].value = buf[3];
+	if (buf[3] & AD7124_STATUS_REG_RDY)
+		return -EAGAIN;
+
+	*p_data = (buf[0] << 16) | (buf[1] << 8) | buf[2];
+	*ch = AD7124_STATUS_REG_CH_ACTIVE(buf[3]);
+	dev->regs[AD7124_Data].value = *p_data;
+
+	return 0;
+}
+
 /***************************************************************************//**
  * @brief Computes the CRC checksum for a data buffer.
  *
@@ -552,7 +698,6 @@ int32_t ad7124_setup(struct ad7124_dev **device,
 		     struct ad7124_init_param *init_param)
 {
 	int32_t ret;
-	enum ad7124_registers reg_nr;
 	struct ad7124_dev *dev;
 
 	dev = (struct ad7124_dev *)malloc(sizeof(*dev));
@@ -561,6 +706,7 @@ int32_t ad7124_setup(struct ad7124_dev **device,
 
 	dev->regs = init_param->regs;
 	dev->spi_rdy_poll_cnt = init_param->spi_rdy_poll_cnt;
+	dev->cont_read = false;
 
 	/* Initialize the SPI communication. */
 	ret = no_os_spi_init(&dev->spi_desc, init_param->spi_init);
@@ -576,20 +722,7 @@ int32_t ad7124_setup(struct ad7124_dev **device,
 	dev->check_ready = 1;
 
 	/* Initialize registers AD7124_ADC_Control through AD7124_Filter_7. */
-	for(reg_nr = AD7124_Status; (reg_nr < AD7124_Offset_0) && !(ret < 0);
-	    reg_nr++) {
-		if (dev->regs[reg_nr].rw == AD7124_RW) {
-			ret = ad7124_write_register(dev, dev->regs[reg_nr]);
-			if (ret < 0)
-				break;
-		}
-
-		/* Get CRC State and device SPI interface settings */
-		if (reg_nr == AD7124_Error_En) {
-			ad7124_update_crcsetting(dev);
-			ad7124_update_dev_spi_settings(dev);
-		}
-	}
+	ret = ad7124_write_settings(dev, AD7124_Offset_0);
 
 	*device = dev;
 
@@ -597,39 +730,45 @@ int32_t ad7124_setup(struct ad7124_dev **device,
 }
 
 /**
- * @brief Get the AD7124 reference clock.
+ * @brief Get the AD7124 reference clock in Hz.
  * @param [in] dev - Pointer to the application handler.
  * @param [out] f_clk - Pointer to the clock frequency container.
  * @return 0 in case of success, error code otherwise.
  */
-int32_t ad7124_fclk_get(struct ad7124_dev *dev, float *f_clk)
+int32_t ad7124_fclk_get_hz(struct ad7124_dev *dev, uint32_t *f_clk)
 {
+	/* Modulator clock of the low, mid and full power modes */
+	static const uint32_t f_clk_hz[] = { 76800, 153600, 614400, 614400 };
 	int32_t ret;
-	const float	f_clk_fp = 614400,
-			f_clk_mp = 153600,
-			f_clk_lp = 76800;
 	uint32_t reg_temp;
 
 	ret = ad7124_read_register2(dev, AD7124_ADC_Control, &reg_temp);
 	if (ret != 0)
 		return ret;
 
-	switch ((reg_temp & AD7124_ADC_CTRL_REG_POWER_MODE(3)) >> 6) {
-	case 0:
-		*f_clk = f_clk_lp;
-		break;
-	case 1:
-		*f_clk = f_clk_mp;
-		break;
-	case 2:
-	case 3:
-		*f_clk = f_clk_fp;
-		break;
-	default:
+	*f_clk = f_clk_hz[(reg_temp & AD7124_ADC_CTRL_REG_POWER_MODE(3)) >> 6];
+
+	return 0;
+}
+
+/**
+ * @brief Get the AD7124 reference clock.
+ * @param [in] dev - Pointer to the application handler.
+ * @param [out] f_clk - Pointer to the clock frequency container.
+ * @return 0 in case of success, error code otherwise.
+ */
+int32_t ad7124_fclk_get(struct ad7124_dev *dev, float *f_clk)
+{
+	uint32_t f_clk_hz;
+	int32_t ret;
+
+	ret = ad7124_fclk_get_hz(dev, &f_clk_hz);
+	if (ret != 0)
 		return ret;
-	}
 
-	return ret;
+	*f_clk = f_clk_hz;
+
+	return 0;
 }
 
 /**
@@ -684,20 +823,24 @@ int32_t ad7124_fltcoff_get(struct ad7124_dev *dev, int16_t ch_no,
 }
 
 /**
- * @brief Calculate ODR of the device.
+ * @brief Calculate ODR of the device, without floating point.
  * @param [in] dev - Pointer to the application handler.
  * @param [in] ch_no - Channel number.
- * @return Output data rate in case of success, negative
- *         error code otherwise.
+ * @param [out] odr_mhz - Output data rate in mHz.
+ * @return 0 in case of success, error code otherwise.
  */
-float ad7124_get_odr(struct ad7124_dev *dev, int16_t ch_no)
+int32_t ad7124_get_odr_mhz(struct ad7124_dev *dev, int16_t ch_no,
+			   uint32_t *odr_mhz)
 {
-	float f_clk;
+	/* Rates of the post filters of the sinc3 filter, by POST_FILTER */
+	static const uint32_t post_filter_mhz[] = {
+		0, 0, 27270, 25000, 0, 20000, 16700, 0
+	};
+	uint32_t f_clk, reg_temp;
 	uint16_t fs_value, flt_coff;
 	int32_t ret;
-	uint32_t reg_temp;
 
-	ret = ad7124_fclk_get(dev, &f_clk);
+	ret = ad7124_fclk_get_hz(dev, &f_clk);
 	if (ret != 0)
 		return ret;
 
@@ -710,43 +853,54 @@ float ad7124_get_odr(struct ad7124_dev *dev, int16_t ch_no)
 
 	if ((reg_temp & AD7124_FILT_REG_FILTER(7)) ==
 	    AD7124_FILT_REG_FILTER(7)) {
-		switch ((reg_temp & AD7124_FILT_REG_POST_FILTER(7)) >> 17) {
-		case 2:
-			return 27.27;
-		case 3:
-			return 25;
-		case 5:
-			return 20;
-		case 6:
-			return 16.7;
-		default:
-			return -1;
-		}
+		reg_temp &= AD7124_FILT_REG_POST_FILTER(7);
+		*odr_mhz = post_filter_mhz[reg_temp >> 17];
+		return *odr_mhz ? 0 : -EINVAL;
 	}
 
 	ret = ad7124_fltcoff_get(dev, ch_no, &flt_coff);
 	if (ret != 0)
 		return ret;
 
-	return (f_clk / (float)(flt_coff * fs_value));
+	*odr_mhz = no_os_sd_odr_div(f_clk, flt_coff, fs_value);
+
+	return 0;
 }
 
 /**
- * @brief Set ODR of the device.
+ * @brief Calculate ODR of the device.
  * @param [in] dev - Pointer to the application handler.
- * @param [in] odr - New ODR of the device.
+ * @param [in] ch_no - Channel number.
+ * @return Output data rate in case of success, negative
+ *         error code otherwise.
+ */
+float ad7124_get_odr(struct ad7124_dev *dev, int16_t ch_no)
+{
+	uint32_t odr_mhz;
+	int32_t ret;
+
+	ret = ad7124_get_odr_mhz(dev, ch_no, &odr_mhz);
+	if (ret != 0)
+		return ret == -EINVAL ? -1 : ret;
+
+	return odr_mhz / 1000.0f;
+}
+
+/**
+ * @brief Set ODR of the device, the closest one the FS divider can give.
+ * @param [in] dev - Pointer to the application handler.
+ * @param [in] odr_mhz - New ODR of the device in mHz.
  * @param [in] ch_no - Channel number.
  * @return 0 in case of success, error code otherwise.
  */
-int32_t ad7124_set_odr(struct ad7124_dev *dev, float odr,
-		       int16_t ch_no)
+int32_t ad7124_set_odr_mhz(struct ad7124_dev *dev, uint32_t odr_mhz,
+			   int16_t ch_no)
 {
-	float f_clk;
-	uint16_t flt_coff, fs_value;
+	uint32_t f_clk, fs_value, reg_temp;
+	uint16_t flt_coff;
 	int32_t ret;
-	uint32_t reg_temp;
 
-	ret = ad7124_fclk_get(dev, &f_clk);
+	ret = ad7124_fclk_get_hz(dev, &f_clk);
 	if (ret != 0)
 		return ret;
 
@@ -754,11 +908,10 @@ int32_t ad7124_set_odr(struct ad7124_dev *dev, float odr,
 	if (ret != 0)
 		return ret;
 
-	fs_value = (uint16_t)(f_clk / (flt_coff * odr));
-	if (fs_value == 0)
-		fs_value = 1;
-	if (fs_value > 2047)
-		fs_value = 2047;
+	ret = no_os_sd_odr_div_plan(f_clk, flt_coff, 1, 2047, odr_mhz,
+				    &fs_value);
+	if (ret != 0)
+		return ret;
 
 	ret = ad7124_read_register2(dev, (AD7124_Filter_0 + ch_no),
 				    &reg_temp);
@@ -767,12 +920,24 @@ int32_t ad7124_set_odr(struct ad7124_dev *dev, float odr,
 	reg_temp &= ~AD7124_FILT_REG_FS(0x7FF);
 	reg_temp |= AD7124_FILT_REG_FS(fs_value);
 
-	ret = ad7124_write_register2(dev, (AD7124_Filter_0 + ch_no),
-				     reg_temp);
-	if (ret != 0)
-		return ret;
+	return ad7124_write_register2(dev, (AD7124_Filter_0 + ch_no),
+				      reg_temp);
+}
 
-	return ret;
+/**
+ * @brief Set ODR of the device.
+ * @param [in] dev - Pointer to the application handler.
+ * @param [in] odr - New ODR of the device.
+ * @param [in] ch_no - Channel number.
+ * @return 0 in case of success, error code otherwise.
+ */
+int32_t ad7124_set_odr(struct ad7124_dev *dev, float odr,
+		       int16_t ch_no)
+{
+	if (odr <= 0)
+		return -EINVAL;
+
+	return ad7124_set_odr_mhz(dev, (uint32_t)(odr * 1000), ch_no);
 }
 
 /***************************************************************************//**
@@ -45,6 +45,7 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdint.h>
+#include <stdbool.h>
 #include "no_os_spi.h"
 #include "no_os_delay.h"
 
@@ -342,6 +343,8 @@ enum ad7124_registers {
  * @spi_rdy_poll_cnt: Number of times the driver should read the Error register
  *                    to check if the device is ready to accept user requests,
  *                    before a timeout error will be issued.
+ * @cont_read: Set while the device is in continuous read mode, where only the
+ *             conversion results can be read.
  */
 struct ad7124_dev {
 	/* SPI */
@@ -351,6 +354,7 @@ struct ad7124_dev {
 	int16_t use_crc;
 	int16_t check_ready;
 	int16_t spi_rdy_poll_cnt;
+	bool cont_read;
 };
 
 struct ad7124_init_param {
@@ -418,6 +422,13 @@ int32_t ad7124_read_data(struct ad7124_dev *dev,
 /*! Get the ID of the channel of the latest conversion. */
 int32_t ad7124_get_read_chan_id(struct ad7124_dev *dev, uint32_t *status);
 
+/*! Enters or leaves the continuous read mode. */
+int32_t ad7124_set_cont_read(struct ad7124_dev *dev, bool enable);
+
+/*! Reads a conversion result and its channel in continuous read mode. */
+int32_t ad7124_read_cont_data(struct ad7124_dev *dev, int32_t *p_data,
+			      uint8_t *ch);
+
 /*! Computes the CRC checksum for a data buffer. */
 uint8_t ad7124_compute_crc8(uint8_t* p_buf,
 			    uint8_t buf_size);
@@ -428,6 +439,9 @@ void ad7124_update_crcsetting(struct ad7124_dev *dev);
 /*! Updates the device SPI interface settings. */
 void ad7124_update_dev_spi_settings(struct ad7124_dev *dev);
 
+/*! Get the AD7124 reference clock in Hz. */
+int32_t ad7124_fclk_get_hz(struct ad7124_dev *dev, uint32_t *f_clk);
+
 /*! Get the AD7124 reference clock. */
 int32_t ad7124_fclk_get(struct ad7124_dev *dev, float *f_clk);
 
@@ -438,10 +452,18 @@ int32_t ad7124_fltcoff_get(struct ad7124_dev *dev, int16_t ch_no,
 /*! Calculate ODR of the device. */
 float ad7124_get_odr(struct ad7124_dev *dev, int16_t ch_no);
 
+/*! Calculate ODR of the device in mHz. */
+int32_t ad7124_get_odr_mhz(struct ad7124_dev *dev, int16_t ch_no,
+			   uint32_t *odr_mhz);
+
 /*! Set ODR of the device. */
 int32_t ad7124_set_odr(struct ad7124_dev *dev, float odr,
 		       int16_t ch_no);
 
+/*! Set ODR of the device in mHz. */
+int32_t ad7124_set_odr_mhz(struct ad7124_dev *dev, uint32_t odr_mhz,
+			   int16_t ch_no);
+
 /*! Initializes the AD7124. */
 int32_t ad7124_setup(struct ad7124_dev **device,
 		     struct ad7124_init_param *init_param);
@@ -50,6 +50,7 @@
 #include "iio_ad7124.h"
 #include "no_os_util.h"
 #include "ad7124.h"
+#include "no_os_sd_odr.h"
 
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
@@ -148,6 +149,10 @@ static struct iio_channel ad7124_channels[] = {
 	AD7124_IIO_CHANN_DEF("ch7", 14, 15)
 };
 
+/* Conversions of the scan being assembled in continuous read mode */
+static int32_t ad7124_iio_scan[NO_OS_ARRAY_SIZE(ad7124_channels)];
+static uint32_t ad7124_iio_scan_filled;
+
 /**
  * @brief Get cofiguration option of channel.
  * @param desc - Device driver descriptor.
@@ -295,7 +300,10 @@ static int ad7124_iio_read_filter_3db(void *device, char *buf, uint32_t len,
 	if (ret != 0)
 		return ret;
 
-	odr = (uint32_t)ad7124_get_odr(desc, config_opt);
+	ret = ad7124_get_odr_mhz(desc, config_opt, &odr);
+	if (ret != 0)
+		return ret;
+	odr /= 1000;
 	ret = ad7124_read_register2(desc,
 				    (AD7124_FILT0_REG + config_opt),
 				    &reg_temp);
@@ -367,7 +375,10 @@ static int ad7124_iio_write_filter_3db(void *device, char *buf, uint32_t len,
 	if (ret != 0)
 		return ret;
 
-	ret = ad7124_set_odr(desc, (float)new_odr, config_opt);
+	if (!new_odr)
+		return -EINVAL;
+
+	ret = ad7124_set_odr_mhz(desc, NO_OS_SD_ODR_MHZ(new_odr), config_opt);
 	if (ret != 0)
 		return ret;
 
@@ -395,7 +406,10 @@ static int ad7124_iio_read_odr_chan(void *device, char *buf, uint32_t len,
 	if (ret != 0)
 		return ret;
 
-	odr = (uint32_t)ad7124_get_odr(desc, config_opt);
+	ret = ad7124_get_odr_mhz(desc, config_opt, &odr);
+	if (ret != 0)
+		return ret;
+	odr /= 1000;
 
 	return snprintf(buf, len, "%"PRId32"", odr);
 }
@@ -423,7 +437,10 @@ static int ad7124_iio_change_odr_chan(void *device, char *buf, uint32_t len,
 
 	sscanf(buf, "%ld", &new_odr);
 
-	ret = ad7124_set_odr(desc, (float)new_odr, config_opt);
+	if (!new_odr)
+		return -EINVAL;
+
+	ret = ad7124_set_odr_mhz(desc, NO_OS_SD_ODR_MHZ(new_odr), config_opt);
 	if (ret != 0)
 		return ret;
 
@@ -705,6 +722,82 @@ static int32_t iio_ad7124_read_samples(void *dev, int32_t *buff,
 	return nb_samples;
 }
 
+/**
+ * @brief Enable the active channels and enter continuous read mode.
+ * @param [in] dev - Device descriptor.
+ * @param [in] mask - Mask of the active channels.
+ * @return 0 in case of success, error code otherwise.
+ */
+static int32_t iio_ad7124_cont_pre_enable(void *dev, uint32_t mask)
+{
+	int32_t ret;
+
+	ret = iio_ad7124_update_active_channels(dev, mask);
+	if (ret != 0)
+		return ret;
+
+	ad7124_iio_scan_filled = 0;
+
+	return ad7124_set_cont_read(dev, true);
+}
+
+/**
+ * @brief Leave continuous read mode and close the active channels.
+ * @param [in] dev - Device descriptor.
+ * @return 0 in case of success, error code otherwise.
+ */
+static int32_t iio_ad7124_cont_post_disable(void *dev)
+{
+	int32_t ret;
+
+	ret = ad7124_set_cont_read(dev, false);
+	if (ret != 0)
+		return ret;
+
+	return iio_ad7124_close_channels(dev);
+}
+
+/**
+ * @brief Handle the DOUT/RDY trigger: read the conversion and write the scan to
+ * the buffer once a conversion of every active channel is read.
+ * @param [in] dev_data - IIO device data.
+ * @return 0 in case of success, error code otherwise.
+ */
+static int32_t iio_ad7124_trigger_handler(struct iio_device_data *dev_data)
+{
+	uint32_t mask = dev_data->buffer->active_mask;
+	int32_t data[NO_OS_ARRAY_SIZE(ad7124_channels)];
+	int32_t value;
+	uint32_t i, j;
+	uint8_t ch;
+	int32_t ret;
+
+	ret = ad7124_read_cont_data(dev_data->dev, &value, &ch);
+	if (ret == -EAGAIN)
+		return 0;
+	if (ret != 0)
+		return ret;
+
+	if (ch >= NO_OS_ARRAY_SIZE(ad7124_channels) || !(mask & NO_OS_BIT(ch)))
+		return 0;
+
+	/* The sequencer restarts from the first active channel */
+	if (ch == no_os_find_first_set_bit(mask))
+		ad7124_iio_scan_filled = 0;
+
+	ad7124_iio_scan[ch] = value;
+	ad7124_iio_scan_filled |= NO_OS_BIT(ch);
+	if (ad7124_iio_scan_filled != mask)
+		return 0;
+
+	for (i = 0, j = 0; i < NO_OS_ARRAY_SIZE(ad7124_channels); i++)
+		if (mask & NO_OS_BIT(i))
+			data[j++] = ad7124_iio_scan[i];
+	ad7124_iio_scan_filled = 0;
+
+	return iio_buffer_push_scan(dev_data->buffer, data);
+}
+
 struct iio_device iio_ad7124_device = {
 	.num_ch = NO_OS_ARRAY_SIZE(ad7124_channels),
 	.channels = ad7124_channels,
@@ -718,3 +811,16 @@ struct iio_device iio_ad7124_device = {
 	.debug_reg_write = (int32_t (*)())ad7124_write_register2
 };
 
+/* Conversions are read in continuous read mode, on the DOUT/RDY trigger */
+struct iio_device iio_ad7124_cont_device = {
+	.num_ch = NO_OS_ARRAY_SIZE(ad7124_channels),
+	.channels = ad7124_channels,
+	.attributes = NULL,
+	.debug_attributes = NULL,
+	.buffer_attributes = NULL,
+	.pre_enable = iio_ad7124_cont_pre_enable,
+	.post_disable = iio_ad7124_cont_post_disable,
+	.trigger_handler = iio_ad7124_trigger_handler,
+	.debug_reg_read = (int32_t (*)())ad7124_read_register2,
+	.debug_reg_write = (int32_t (*)())ad7124_write_register2
+};
@@ -82,6 +82,21 @@ struct ad713x_iio {
 	uint32_t mask;
 	/** Invalidate the Data cache for the given address range */
 	void (*dcache_invalidate_range)(uint32_t address, uint32_t bytes_count);
+	/** TDM descriptor, when streaming from the TDM interface */
+	struct no_os_tdm_desc *tdm_desc;
+	/** Channel of each slot of the TDM frame */
+	const uint8_t *tdm_slot_map;
+	/** Number of slots in a TDM frame */
+	uint8_t tdm_slots;
+	/** Circular buffer of 2 * AD713X_IIO_TDM_FRAMES frames */
+	uint32_t *tdm_buff;
+	/** Halves filled by the DMA and halves pushed to the IIO buffer */
+	volatile uint32_t tdm_head;
+	uint32_t tdm_tail;
+	/** Frames of the tdm_tail half already pushed */
+	uint32_t tdm_pos;
+	/** Halves overwritten before being pushed */
+	uint32_t tdm_overruns;
 };
 
 /******************************************************************************/
@@ -491,6 +506,126 @@ static int32_t ad713x_iio_read_dev(struct ad713x_iio *desc, uint32_t *buff,
 	return nb_samples;
 }
 
+/**
+ * @brief TDM callback, from interrupt context, of a filled half of the
+ * circular buffer.
+ * @param ctx - The AD713x IIO handler.
+ * @param data - The filled half.
+ * @param nb_samples - Number of samples in data.
+ */
+static void ad713x_iio_tdm_half(void *ctx, void *data, uint32_t nb_samples)
+{
+	struct ad713x_iio *desc = ctx;
+
+	desc->tdm_head++;
+}
+
+/**
+ * @brief Start the TDM circular read, kept running while the buffer is
+ * enabled so that no frame is lost between the submits.
+ * @param desc - The AD713x IIO handler.
+ * @param mask - Active channels mask.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad713x_iio_tdm_start(struct ad713x_iio *desc, uint32_t mask)
+{
+	if (!desc || !desc->tdm_desc)
+		return -EINVAL;
+
+	desc->mask = mask;
+	desc->tdm_head = 0;
+	desc->tdm_tail = 0;
+	desc->tdm_pos = 0;
+	desc->tdm_overruns = 0;
+
+	return no_os_tdm_read_start(desc->tdm_desc, desc->tdm_buff,
+				    2 * AD713X_IIO_TDM_FRAMES * desc->tdm_slots,
+				    ad713x_iio_tdm_half, desc);
+}
+
+/**
+ * @brief Stop the TDM circular read.
+ * @param desc - The AD713x IIO handler.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad713x_iio_tdm_stop(struct ad713x_iio *desc)
+{
+	if (!desc || !desc->tdm_desc)
+		return -EINVAL;
+
+	return no_os_tdm_stop(desc->tdm_desc);
+}
+
+/**
+ * @brief Fill the IIO buffer with the frames received on the TDM interface,
+ * the halves of the circular buffer being pushed as the DMA fills them.
+ * @param dev_data - IIO device data.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad713x_iio_tdm_submit(struct iio_device_data *dev_data)
+{
+	struct ad713x_iio *desc = dev_data->dev;
+	struct iio_buffer *buffer = dev_data->buffer;
+	uint32_t nb_scans = buffer->size / buffer->bytes_per_scan;
+	uint8_t samples[AD713X_CH_MAX][sizeof(uint32_t)] = {0};
+	uint32_t head, nb_frames, i, slot;
+	const uint32_t *frame;
+	uint8_t ch;
+	int32_t ret;
+
+	while (nb_scans) {
+		head = desc->tdm_head;
+		if (head == desc->tdm_tail)
+			continue;
+
+		/* The DMA is writing the half after head - 1 */
+		if (head - desc->tdm_tail > 1) {
+			desc->tdm_overruns += head - desc->tdm_tail - 1;
+			desc->tdm_tail = head - 1;
+			desc->tdm_pos = 0;
+		}
+
+		i = desc->tdm_tail % 2 * AD713X_IIO_TDM_FRAMES + desc->tdm_pos;
+		frame = desc->tdm_buff + i * desc->tdm_slots;
+		nb_frames = no_os_min(nb_scans,
+				      AD713X_IIO_TDM_FRAMES - desc->tdm_pos);
+		for (i = 0; i < nb_frames; i++) {
+			for (slot = 0; slot < desc->tdm_slots; slot++) {
+				ch = desc->tdm_slot_map[slot];
+				if (ch < AD713X_CH_MAX)
+					no_os_put_unaligned_be32(frame[slot],
+								 samples[ch]);
+			}
+			ret = iio_buffer_push_samples(buffer, samples,
+						      sizeof(samples[0]));
+			if (ret)
+				return ret;
+
+			frame += desc->tdm_slots;
+		}
+
+		/* The rest of a partly pushed half goes to the next submit */
+		desc->tdm_pos += nb_frames;
+		if (desc->tdm_pos == AD713X_IIO_TDM_FRAMES) {
+			desc->tdm_pos = 0;
+			desc->tdm_tail++;
+		}
+		nb_scans -= nb_frames;
+	}
+
+	return 0;
+}
+
+static int ad713x_iio_show_tdm_overruns(void *device, char *buf, uint32_t len,
+					const struct iio_ch_info *channel,
+					intptr_t priv)
+{
+	struct ad713x_iio *desc = device;
+
+	return iio_format_value(buf, len, IIO_VAL_INT, 1,
+				(int32_t *)&desc->tdm_overruns);
+}
+
 /**
  * @brief Allocate memory for AD713x IIO handler.
  * @param desc - Pointer to the IIO device structure.
@@ -520,6 +655,23 @@ int iio_ad713x_init(struct ad713x_iio **desc,
 	device->vref_micro = param->vref_micro;
 	device->dcache_invalidate_range = param->dcache_invalidate_range;
 
+	if (param->tdm_desc) {
+		if (!param->tdm_slot_map || !param->tdm_slots) {
+			ret = -EINVAL;
+			goto dev_err;
+		}
+
+		device->tdm_desc = param->tdm_desc;
+		device->tdm_slot_map = param->tdm_slot_map;
+		device->tdm_slots = param->tdm_slots;
+		device->tdm_buff = calloc(2 * AD713X_IIO_TDM_FRAMES *
+					  param->tdm_slots, sizeof(uint32_t));
+		if (!device->tdm_buff) {
+			ret = -ENOMEM;
+			goto dev_err;
+		}
+	}
+
 	for (i = 0; i < 7; i++) {
 		ret = ad713x_spi_reg_read(device->drv_dev,
 					  AD713X_REG_ODR_VAL_INT_LSB + i, &reg_data);
@@ -542,6 +694,7 @@ int iio_ad713x_init(struct ad713x_iio **desc,
 
 	return 0;
 dev_err:
+	free(device->tdm_buff);
 	free(device);
 
 	return ret;
@@ -557,6 +710,7 @@ int iio_ad713x_remove(struct ad713x_iio *desc)
 	if (!desc)
 		return -EINVAL;
 
+	free(desc->tdm_buff);
 	free(desc);
 
 	return 0;
@@ -577,4 +731,24 @@ struct iio_device ad713x_iio_desc = {
 	.debug_reg_write = (int32_t (*)()) ad713x_spi_reg_write
 };
 
+static struct iio_attribute ad713x_iio_tdm_debug_attributes[] = {
+	{
+		.name = "tdm_overruns",
+		.show = ad713x_iio_show_tdm_overruns,
+	},
+	END_ATTRIBUTES_ARRAY
+};
+
+struct iio_device ad713x_iio_tdm_desc = {
+	.num_ch = NO_OS_ARRAY_SIZE(ad713x_channels),
+	.channels = ad713x_channels,
+	.attributes = channel_attributes,
+	.debug_attributes = ad713x_iio_tdm_debug_attributes,
+	.pre_enable = (int32_t (*)())ad713x_iio_tdm_start,
+	.post_disable = (int32_t (*)())ad713x_iio_tdm_stop,
+	.submit = ad713x_iio_tdm_submit,
+	.debug_reg_read = (int32_t (*)()) ad713x_spi_reg_read,
+	.debug_reg_write = (int32_t (*)()) ad713x_spi_reg_write
+};
+
 #endif /* IIO_SUPPORT */
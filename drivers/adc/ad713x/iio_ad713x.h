@@ -47,6 +47,16 @@
 
 #include "iio_types.h"
 #include "no_os_spi.h"
+#include "no_os_tdm.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Frames in each half of the TDM circular buffer */
+#define AD713X_IIO_TDM_FRAMES		64
+/* Slot not carrying a channel of the device */
+#define AD713X_IIO_TDM_NO_CH		0xFF
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -71,9 +81,20 @@ struct ad713x_iio_init_param {
 	struct no_os_spi_desc *spi_eng_desc;
 	/** Invalidate the Data cache for the given address range */
 	void (*dcache_invalidate_range)(uint32_t address, uint32_t bytes_count);
+	/**
+	 * TDM descriptor, for ad713x_iio_tdm_desc. The slots are 32 bits wide,
+	 * the 24 bits of the sample first.
+	 */
+	struct no_os_tdm_desc *tdm_desc;
+	/** Channel of each slot of the TDM frame, or AD713X_IIO_TDM_NO_CH */
+	const uint8_t *tdm_slot_map;
+	/** Number of slots in a TDM frame */
+	uint8_t tdm_slots;
 };
 
 extern struct iio_device ad713x_iio_desc;
+/* Data streamed from the TDM interface instead of the SPI Engine */
+extern struct iio_device ad713x_iio_tdm_desc;
 
 /** Allocate memory for AD713x IIO handler. */
 int iio_ad713x_init(struct ad713x_iio **desc,
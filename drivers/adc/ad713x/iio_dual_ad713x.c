@@ -60,11 +60,15 @@
 
 #define BITS_PER_SAMPLE 32
 
+/*
+ * The 24-bit conversion result arrives in bits [30:7] of each 32-bit word
+ * shifted in by the SPI Engine, the words are handed to the client as read.
+ */
 static struct scan_type adc_scan_type = {
-	.sign = 'u',
-	.realbits = BITS_PER_SAMPLE,
+	.sign = 's',
+	.realbits = 24,
 	.storagebits = BITS_PER_SAMPLE,
-	.shift = 0,
+	.shift = 7,
 	.is_big_endian = false
 };
 
@@ -108,42 +112,127 @@ static int32_t _iio_ad713x_prepare_transfer(struct iio_ad713x *desc,
 static int32_t _iio_ad713x_read_dev(struct iio_ad713x *desc, uint32_t *buff,
 				    uint32_t nb_samples)
 {
-	struct spi_engine_offload_message *msg;
+	struct spi_engine_offload_message msg;
 	uint32_t bytes;
-	uint32_t data;
 	int32_t  ret;
 	uint8_t  ch;
 	uint32_t i;
 	uint32_t j;
 	uint32_t *rx;
+	bool all_ch;
 
 	if (!desc)
 		return -1;
 
+	/*
+	 * The offload message reads one word of the frame on each trigger. With
+	 * all the channels enabled the frames are the scans, so the DMA stores
+	 * them straight into the buffer. Otherwise they are read in the message
+	 * buffer and only the enabled channels are copied.
+	 */
 	bytes = nb_samples * desc->iio_dev_desc.num_ch *
 		(BITS_PER_SAMPLE / 8);
-	msg = desc->spi_engine_offload_message;
-	ret = spi_engine_offload_transfer(desc->spi_eng_desc, *msg, bytes);
+	all_ch = desc->mask == NO_OS_GENMASK(desc->iio_dev_desc.num_ch - 1, 0);
+	msg = *desc->spi_engine_offload_message;
+	if (all_ch)
+		msg.rx_addr = (uint32_t)buff;
+
+	/*
+	 * With the ODR generator held while the DMA is armed, the first edge
+	 * after enabling it samples both parts and starts the capture.
+	 */
+	if (desc->odr_pwm) {
+		ret = no_os_pwm_disable(desc->odr_pwm);
+		if (ret)
+			return ret;
+	}
+
+	ret = spi_engine_offload_transfer_start(desc->spi_eng_desc, msg,
+						nb_samples *
+						desc->iio_dev_desc.num_ch);
+	if (ret < 0)
+		return ret;
+
+	if (desc->odr_pwm) {
+		ret = no_os_pwm_enable(desc->odr_pwm);
+		if (ret)
+			return ret;
+	}
+
+	ret = spi_engine_offload_transfer_wait(desc->spi_eng_desc);
 	if (ret < 0)
 		return ret;
 
 	if (desc->dcache_invalidate_range)
-		desc->dcache_invalidate_range(msg->rx_addr, bytes);
+		desc->dcache_invalidate_range(msg.rx_addr, bytes);
+
+	desc->capture_seq++;
+	desc->capture_synced = desc->odr_pwm != NULL;
+
+	if (all_ch)
+		return nb_samples;
 
-	rx = (uint32_t *)desc->spi_engine_offload_message->rx_addr;
-	for (i = 0, j = 0; i < nb_samples; i++)
+	rx = (uint32_t *)msg.rx_addr;
+	for (i = 0, j = 0; i < nb_samples; i++) {
 		for (ch = 0; ch < desc->iio_dev_desc.num_ch; ch++)
-			if (desc->mask & NO_OS_BIT(ch)) {
-				data = rx[i * desc->iio_dev_desc.num_ch + ch];
-				data <<= 1;
-				data &= 0xffffff00;
-				data >>= 8;
-				buff[j++] = data;
-			}
+			if (desc->mask & NO_OS_BIT(ch))
+				buff[j++] = rx[ch];
+		rx += desc->iio_dev_desc.num_ch;
+	}
 
 	return nb_samples;
 }
 
+/**
+ * @brief Show the number of captures done since init.
+ * @param device - Descriptor.
+ * @param buf - Where the value is written.
+ * @param len - Size of buf.
+ * @param channel - Unused.
+ * @param priv - Unused.
+ * @return Number of bytes written to buf.
+ */
+static int iio_dual_ad713x_show_capture_seq(void *device, char *buf,
+		uint32_t len,
+		const struct iio_ch_info *channel,
+		intptr_t priv)
+{
+	struct iio_ad713x *desc = device;
+
+	return snprintf(buf, len, "%"PRIu32"", desc->capture_seq);
+}
+
+/**
+ * @brief Show if the last capture was started on a common ODR edge.
+ * @param device - Descriptor.
+ * @param buf - Where the value is written.
+ * @param len - Size of buf.
+ * @param channel - Unused.
+ * @param priv - Unused.
+ * @return Number of bytes written to buf.
+ */
+static int iio_dual_ad713x_show_capture_synced(void *device, char *buf,
+		uint32_t len,
+		const struct iio_ch_info *channel,
+		intptr_t priv)
+{
+	struct iio_ad713x *desc = device;
+
+	return snprintf(buf, len, "%d", desc->capture_synced);
+}
+
+static struct iio_attribute iio_dual_ad713x_attrs[] = {
+	{
+		.name = "capture_seq",
+		.show = iio_dual_ad713x_show_capture_seq,
+	},
+	{
+		.name = "capture_synced",
+		.show = iio_dual_ad713x_show_capture_synced,
+	},
+	END_ATTRIBUTES_ARRAY
+};
+
 /**
  * @brief Get iio device descriptor.
  * @param desc - Descriptor.
@@ -174,10 +263,12 @@ int32_t iio_dual_ad713x_init(struct iio_ad713x **desc,
 	iio_ad713x->spi_eng_desc = param->spi_eng_desc;
 	iio_ad713x->spi_engine_offload_message = param->spi_engine_offload_message;
 	iio_ad713x->dcache_invalidate_range = param->dcache_invalidate_range;
+	iio_ad713x->odr_pwm = param->odr_pwm;
 
 	iio_ad713x->iio_dev_desc = (struct iio_device) {
 		.num_ch = param->num_channels,
 		.channels = iio_adc_channels,
+		.attributes = iio_dual_ad713x_attrs,
 		.pre_enable = (int32_t (*)())_iio_ad713x_prepare_transfer,
 		.read_dev = (int32_t (*)())_iio_ad713x_read_dev
 	};
@@ -49,6 +49,7 @@
 #include "ad713x.h"
 #include "iio_types.h"
 #include "no_os_spi.h"
+#include "no_os_pwm.h"
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -69,6 +70,8 @@ struct iio_ad713x_init_par {
 	struct spi_engine_offload_message *spi_engine_offload_message;
 	/** Invalidate the Data cache for the given address range */
 	void (*dcache_invalidate_range)(uint32_t address, uint32_t bytes_count);
+	/** ODR generator triggering both parts, optional */
+	struct no_os_pwm_desc *odr_pwm;
 };
 
 struct iio_ad713x {
@@ -82,6 +85,12 @@ struct iio_ad713x {
 	struct spi_engine_offload_message *spi_engine_offload_message;
 	/** Invalidate the Data cache for the given address range */
 	void (*dcache_invalidate_range)(uint32_t address, uint32_t bytes_count);
+	/** ODR generator, held while a capture is armed */
+	struct no_os_pwm_desc *odr_pwm;
+	/** Number of captures done */
+	uint32_t capture_seq;
+	/** Last capture started on a common ODR edge of both parts */
+	bool capture_synced;
 };
 
 /******************************************************************************/
@@ -47,6 +47,8 @@
 #include <stdlib.h>
 #include "ad717x.h"
 #include "no_os_error.h"
+#include "no_os_irq.h"
+#include "no_os_sd_odr.h"
 
 /* Error codes */
 #define INVALID_VAL -1 /* Invalid argument */
@@ -377,6 +379,195 @@ int ad717x_single_read(ad717x_dev* device,  uint8_t id, int32_t *adc_raw_data)
 	return ad717x_set_channel_status(device, id, false);
 }
 
+/***************************************************************************//**
+ * @brief Read the data register with the status appended, as configured by
+ *	  ad717x_stream_start(). Unlike AD717X_ReadRegister(), it works for
+ *	  the 4 data bytes of the AD7177-2 followed by the status.
+ * @param device - AD717x Device Descriptor
+ * @param channel - Channel of the sample
+ * @param code - Conversion result
+ * @return Returns 0 for success or negative error code in case of failure.
+******************************************************************************/
+static int ad717x_read_data_status(ad717x_dev *device, uint8_t *channel,
+				   uint32_t *code)
+{
+	uint8_t buffer[8] = {0};
+	ad717x_st_reg *data_reg;
+	uint8_t check8 = 0;
+	uint8_t len;
+	uint8_t i;
+	int ret;
+
+	data_reg = AD717X_GetReg(device, AD717X_DATA_REG);
+	if (!data_reg)
+		return -EINVAL;
+
+	/* Command, data bytes, status and the optional checksum */
+	len = data_reg->size + 1;
+	if (device->useCRC != AD717X_DISABLE)
+		len++;
+
+	buffer[0] = AD717X_COMM_REG_WEN | AD717X_COMM_REG_RD |
+		    AD717X_COMM_REG_RA(AD717X_DATA_REG);
+	ret = no_os_spi_write_and_read(device->spi_desc, buffer, len);
+	if (ret)
+		return ret;
+
+	/* The checksum covers the command byte as well */
+	buffer[0] = AD717X_COMM_REG_WEN | AD717X_COMM_REG_RD |
+		    AD717X_COMM_REG_RA(AD717X_DATA_REG);
+	if (device->useCRC == AD717X_USE_CRC)
+		check8 = AD717X_ComputeCRC8(buffer, len);
+	else if (device->useCRC == AD717X_USE_XOR)
+		check8 = AD717X_ComputeXOR8(buffer, len);
+	if (check8)
+		return -EBADMSG;
+
+	*code = 0;
+	for (i = 1; i < data_reg->size; i++)
+		*code = (*code << 8) | buffer[i];
+	*channel = AD717X_STATUS_REG_CH(buffer[data_reg->size]);
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief RDY falling edge handler, reads the new sample and passes it on.
+ * @param ctx - AD717x Device Descriptor
+******************************************************************************/
+static void ad717x_rdy_handler(void *ctx)
+{
+	ad717x_dev *device = ctx;
+	uint32_t code;
+	uint8_t channel;
+	int ret;
+
+	/* DOUT/RDY toggles while the data is shifted out */
+	ret = no_os_irq_disable(device->irq_ctrl, device->rdy_irq_num);
+	if (ret)
+		return;
+
+	ret = ad717x_read_data_status(device, &channel, &code);
+	if (!ret && device->sample_cb)
+		device->sample_cb(device->sample_ctx, channel, code);
+	else if (ret)
+		device->stream_errors++;
+
+	no_os_irq_enable(device->irq_ctrl, device->rdy_irq_num);
+}
+
+/***************************************************************************//**
+ * @brief Start continuous conversion of the enabled channels. The sequencer of
+ *	  the part goes through them in order and the status, carrying the
+ *	  channel, is appended to each result so that no register has to be
+ *	  read between the samples. Each result is read on the RDY falling
+ *	  edge and passed to cb, from interrupt context.
+ * @param device - AD717x Device Descriptor, initialized with an irq_ctrl
+ * @param cb - Called with each sample
+ * @param ctx - Passed to cb
+ * @return Returns 0 for success or negative error code in case of failure.
+******************************************************************************/
+int ad717x_stream_start(ad717x_dev *device, ad717x_sample_cb cb, void *ctx)
+{
+	ad717x_st_reg *ifmode_reg;
+	int ret;
+
+	if (!device || !cb || !device->irq_ctrl)
+		return -EINVAL;
+
+	ifmode_reg = AD717X_GetReg(device, AD717X_IFMODE_REG);
+	if (!ifmode_reg)
+		return -EINVAL;
+
+	/* Append the status register to the data register */
+	ifmode_reg->value |= AD717X_IFMODE_REG_DATA_STAT;
+	ret = AD717X_WriteRegister(device, AD717X_IFMODE_REG);
+	if (ret)
+		return ret;
+
+	ret = AD717X_ComputeDataregSize(device);
+	if (ret)
+		return ret;
+
+	device->sample_cb = cb;
+	device->sample_ctx = ctx;
+	device->stream_errors = 0;
+	device->irq_cb = (struct no_os_callback_desc) {
+		.callback = ad717x_rdy_handler,
+		.ctx = device,
+		.event = NO_OS_EVT_GPIO,
+		.peripheral = NO_OS_GPIO_IRQ
+	};
+
+	ret = no_os_irq_register_callback(device->irq_ctrl, device->rdy_irq_num,
+					  &device->irq_cb);
+	if (ret)
+		return ret;
+
+	ret = no_os_irq_trigger_level_set(device->irq_ctrl, device->rdy_irq_num,
+					  NO_OS_IRQ_EDGE_FALLING);
+	if (ret)
+		goto error_irq;
+
+	ret = ad717x_set_adc_mode(device, CONTINUOUS);
+	if (ret)
+		goto error_irq;
+
+	ret = no_os_irq_enable(device->irq_ctrl, device->rdy_irq_num);
+	if (ret)
+		goto error_irq;
+
+	return 0;
+
+error_irq:
+	no_os_irq_unregister_callback(device->irq_ctrl, device->rdy_irq_num,
+				      &device->irq_cb);
+
+	return ret;
+}
+
+/***************************************************************************//**
+ * @brief Stop the conversions started by ad717x_stream_start(), the part is
+ *	  left in standby.
+ * @param device - AD717x Device Descriptor
+ * @return Returns 0 for success or negative error code in case of failure.
+******************************************************************************/
+int ad717x_stream_stop(ad717x_dev *device)
+{
+	ad717x_st_reg *ifmode_reg;
+	int ret;
+
+	if (!device || !device->irq_ctrl)
+		return -EINVAL;
+
+	ret = no_os_irq_disable(device->irq_ctrl, device->rdy_irq_num);
+	if (ret)
+		return ret;
+
+	ret = no_os_irq_unregister_callback(device->irq_ctrl,
+					    device->rdy_irq_num,
+					    &device->irq_cb);
+	if (ret)
+		return ret;
+
+	device->sample_cb = NULL;
+
+	ret = ad717x_set_adc_mode(device, STANDBY);
+	if (ret)
+		return ret;
+
+	ifmode_reg = AD717X_GetReg(device, AD717X_IFMODE_REG);
+	if (!ifmode_reg)
+		return -EINVAL;
+
+	ifmode_reg->value &= ~AD717X_IFMODE_REG_DATA_STAT;
+	ret = AD717X_WriteRegister(device, AD717X_IFMODE_REG);
+	if (ret)
+		return ret;
+
+	return AD717X_ComputeDataregSize(device);
+}
+
 /***************************************************************************//**
 * @brief  Searches through the list of registers of the driver instance and
 *         retrieves a pointer to the register that matches the given address.
@@ -772,6 +963,109 @@ int32_t ad717x_configure_device_odr(ad717x_dev *dev,
 	return 0;
 }
 
+/**
+ * @brief Get the sinc5 + sinc1 output data rates of the device, by ODR code
+ * @param dev - The AD717x Device descriptor
+ * @return Table of AD717X_ODR_NB_CODES rates in mHz, NULL if not known
+ */
+static const uint32_t *ad717x_odr_table(ad717x_dev *dev)
+{
+	/* Parts with a 31.25 kSPS maximum rate */
+	static const uint32_t odr_31k_mhz[AD717X_ODR_NB_CODES] = {
+		31250000, 31250000, 31250000, 31250000, 31250000, 31250000,
+		15625000, 10417000, 5208000, 2597000, 1007000, 503800, 381000,
+		200300, 100200, 59520, 49680, 20010, 16630, 10000, 5000, 2500,
+		1250
+	};
+	/* Parts with a 250 kSPS maximum rate */
+	static const uint32_t odr_250k_mhz[AD717X_ODR_NB_CODES] = {
+		250000000, 125000000, 62500000, 50000000, 31250000, 25000000,
+		15625000, 10000000, 5000000, 2500000, 1000000, 500000, 397500,
+		200000, 100000, 59920, 49960, 20000, 16660, 10000, 5000, 2500,
+		1250
+	};
+
+	switch (dev->active_device) {
+	case ID_AD4111:
+	case ID_AD4112:
+	case ID_AD4114:
+	case ID_AD4115:
+	case ID_AD4116:
+	case ID_AD7172_2:
+	case ID_AD7172_4:
+	case ID_AD7173_8:
+		return odr_31k_mhz;
+	case ID_AD7175_2:
+	case ID_AD7175_8:
+	case ID_AD7176_2:
+		return odr_250k_mhz;
+	default:
+		return NULL;
+	}
+}
+
+/**
+ * @brief Configure the ODR code closest to a rate, without floating point
+ * @param dev - The AD717x Device descriptor
+ * @param filtcon_id - Filter Configuration Register ID (Number)
+ * @param odr_mhz - Rate of the sinc5 + sinc1 filter in mHz
+ * @return 0 in case of success, negative error code otherwise
+ */
+int32_t ad717x_set_odr_mhz(ad717x_dev *dev, uint8_t filtcon_id,
+			   uint32_t odr_mhz)
+{
+	const uint32_t *table;
+	uint32_t code;
+	int32_t ret;
+
+	if (!dev)
+		return -EINVAL;
+
+	table = ad717x_odr_table(dev);
+	if (!table)
+		return -ENOTSUP;
+
+	ret = no_os_sd_odr_table_find(table, AD717X_ODR_NB_CODES, odr_mhz,
+				      &code);
+	if (ret)
+		return ret;
+
+	return ad717x_configure_device_odr(dev, filtcon_id, code);
+}
+
+/**
+ * @brief Get the rate of the configured ODR code
+ * @param dev - The AD717x Device descriptor
+ * @param filtcon_id - Filter Configuration Register ID (Number)
+ * @param odr_mhz - Rate of the sinc5 + sinc1 filter in mHz
+ * @return 0 in case of success, negative error code otherwise
+ */
+int32_t ad717x_get_odr_mhz(ad717x_dev *dev, uint8_t filtcon_id,
+			   uint32_t *odr_mhz)
+{
+	ad717x_st_reg *filtcon_reg;
+	const uint32_t *table;
+	uint32_t code;
+
+	if (!dev || !odr_mhz)
+		return -EINVAL;
+
+	table = ad717x_odr_table(dev);
+	if (!table)
+		return -ENOTSUP;
+
+	filtcon_reg = AD717X_GetReg(dev, AD717X_FILTCON0_REG + filtcon_id);
+	if (!filtcon_reg)
+		return -EINVAL;
+
+	code = filtcon_reg->value & AD717x_ODR_MSK;
+	if (code >= AD717X_ODR_NB_CODES)
+		return -EINVAL;
+	*odr_mhz = table[code];
+
+	return 0;
+}
+
 /***************************************************************************//**
 * @brief Initializes the AD717X.
 *
@@ -796,6 +1090,9 @@ int32_t AD717X_Init(ad717x_dev **device,
 
 	dev->regs = init_param.regs;
 	dev->num_regs = init_param.num_regs;
+	dev->irq_ctrl = init_param.irq_ctrl;
+	dev->rdy_irq_num = init_param.rdy_irq_num;
+	dev->sample_cb = NULL;
 
 	/* Initialize the SPI communication. */
 	ret = no_os_spi_init(&dev->spi_desc, &init_param.spi_init);
@@ -48,6 +48,7 @@
 /******************************************************************************/
 #include <stdint.h>
 #include "no_os_spi.h"
+#include "no_os_irq.h"
 #include "no_os_util.h"
 #include <stdbool.h>
 
@@ -248,6 +249,14 @@ typedef enum {
 	AD717X_USE_XOR,
 } ad717x_crc_mode;
 
+/*
+ * Called from interrupt context with each sample of the continuous sequencer.
+ * @ctx: Context given to ad717x_stream_start().
+ * @channel: Channel of the sample, read from the status appended to the data.
+ * @code: Conversion result.
+ */
+typedef void (*ad717x_sample_cb)(void *ctx, uint8_t channel, uint32_t code);
+
 /*! AD717X register info */
 typedef struct {
 	int32_t addr;
@@ -286,6 +295,18 @@ typedef struct {
 	struct ad717x_filtcon filter_configuration[AD717x_MAX_SETUPS];
 	/* ADC Mode */
 	enum ad717x_mode mode;
+	/* IRQ controller of the RDY falling edge, needed for streaming */
+	struct no_os_irq_ctrl_desc *irq_ctrl;
+	/* IRQ number of the RDY signal */
+	uint32_t rdy_irq_num;
+	/* Callback registered for the RDY interrupt */
+	struct no_os_callback_desc irq_cb;
+	/* Called with each sample while streaming */
+	ad717x_sample_cb sample_cb;
+	/* Context of sample_cb */
+	void *sample_ctx;
+	/* Samples dropped while streaming because of a wrong checksum */
+	uint32_t stream_errors;
 } ad717x_dev;
 
 typedef struct {
@@ -312,6 +333,10 @@ typedef struct {
 	struct ad717x_filtcon filter_configuration[AD717x_MAX_SETUPS];
 	/* ADC Mode */
 	enum ad717x_mode mode;
+	/* IRQ controller of the RDY falling edge, optional */
+	struct no_os_irq_ctrl_desc *irq_ctrl;
+	/* IRQ number of the RDY signal */
+	uint32_t rdy_irq_num;
 } ad717x_init_param;
 
 /*****************************************************************************/
@@ -525,6 +550,8 @@ typedef struct {
 #define AD717X_ADCMODE_REG_MODE_MSK   		NO_OS_GENMASK(6,4)
 #define AD717X_SETUP_CONF_REG_REF_SEL_MSK	NO_OS_GENMASK(5,4)
 #define AD717x_ODR_MSK				NO_OS_GENMASK(4,0)
+/* Number of codes of the ODR bitfield with a rate, see enum ad717x_odr */
+#define AD717X_ODR_NB_CODES			23
 
 /*****************************************************************************/
 /************************ Functions Declarations *****************************/
@@ -605,8 +632,22 @@ int ad717x_enable_buffers(ad717x_dev* device, bool inbuf_en,
 int ad717x_single_read(ad717x_dev* device, uint8_t id,
 		       int32_t *adc_raw_data);
 
+/* Start converting the enabled channels in sequence, on the RDY interrupt */
+int ad717x_stream_start(ad717x_dev *device, ad717x_sample_cb cb, void *ctx);
+
+/* Stop the conversions started by ad717x_stream_start() */
+int ad717x_stream_stop(ad717x_dev *device);
+
 /* Configure device ODR */
 int32_t ad717x_configure_device_odr(ad717x_dev *dev, uint8_t filtcon_id,
 				    uint8_t odr_sel);
 
+/* Configure the ODR code closest to a rate in mHz */
+int32_t ad717x_set_odr_mhz(ad717x_dev *dev, uint8_t filtcon_id,
+			   uint32_t odr_mhz);
+
+/* Get the rate in mHz of the configured ODR code */
+int32_t ad717x_get_odr_mhz(ad717x_dev *dev, uint8_t filtcon_id,
+			   uint32_t *odr_mhz);
+
 #endif /* __AD717X_H__ */
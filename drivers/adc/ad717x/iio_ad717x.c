@@ -0,0 +1,413 @@
+/***************************************************************************//**
+ *   @file   iio_ad717x.c
+ *   @brief  Implementation of the AD717x IIO driver.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "ad717x.h"
+#include "iio_ad717x.h"
+#include "no_os_util.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+/**
+ * @brief Handles the read request for raw attribute, with a single
+ * conversion.
+ * @param dev     - The iio device structure.
+ * @param buf     - Command buffer to be filled with requested data.
+ * @param len     - Length of the received command buffer in bytes.
+ * @param channel - Command channel info.
+ * @param priv    - Command attribute id.
+ * @return The size of the read data in case of success, negative error code
+ * otherwise.
+ */
+static int ad717x_iio_read_raw(void *dev, char *buf, uint32_t len,
+			       const struct iio_ch_info *channel, intptr_t priv)
+{
+	struct ad717x_iio_dev *desc = dev;
+	int32_t val;
+	int ret;
+
+	/* The sequencer is in use by the buffer */
+	if (desc->ad717x_dev->sample_cb)
+		return -EBUSY;
+
+	ret = ad717x_single_read(desc->ad717x_dev, channel->ch_num, &val);
+	if (ret)
+		return ret;
+
+	return iio_format_value(buf, len, IIO_VAL_INT, 1, &val);
+}
+
+/**
+ * @brief Handles the read request for the stream counters.
+ * @param dev     - The iio device structure.
+ * @param buf     - Command buffer to be filled with requested data.
+ * @param len     - Length of the received command buffer in bytes.
+ * @param channel - Command channel info.
+ * @param priv    - Offset of the counter in struct ad717x_iio_dev, -1 for the
+ *                  checksum errors counted by the driver.
+ * @return The size of the read data in case of success, negative error code
+ * otherwise.
+ */
+static int ad717x_iio_read_counter(void *dev, char *buf, uint32_t len,
+				   const struct iio_ch_info *channel,
+				   intptr_t priv)
+{
+	struct ad717x_iio_dev *desc = dev;
+	int32_t val;
+
+	if (priv < 0)
+		val = desc->ad717x_dev->stream_errors;
+	else
+		val = *(uint32_t *)((uint8_t *)desc + priv);
+
+	return iio_format_value(buf, len, IIO_VAL_INT, 1, &val);
+}
+
+/**
+ * @brief Sample callback of the driver, from interrupt context.
+ * @param ctx     - The iio device structure.
+ * @param channel - Channel of the sample.
+ * @param code    - Conversion result.
+ */
+static void ad717x_iio_sample(void *ctx, uint8_t channel, uint32_t code)
+{
+	struct ad717x_iio_dev *desc = ctx;
+	uint32_t i;
+
+	if (desc->head - desc->tail == AD717X_IIO_RING_SIZE) {
+		desc->overruns++;
+		return;
+	}
+
+	i = desc->head % AD717X_IIO_RING_SIZE;
+	desc->ring_ch[i] = channel;
+	desc->ring_code[i] = code;
+	desc->head++;
+}
+
+/**
+ * @brief Enable the buffer channels in the sequencer and start converting.
+ * @param dev  - The iio device structure.
+ * @param mask - Channels enabled in the buffer.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad717x_iio_pre_enable(void *dev, uint32_t mask)
+{
+	struct ad717x_iio_dev *desc = dev;
+	uint8_t ch;
+	int ret;
+
+	for (ch = 0; ch < desc->iio_dev.num_ch; ch++) {
+		ret = ad717x_set_channel_status(desc->ad717x_dev, ch,
+						mask & NO_OS_BIT(ch));
+		if (ret)
+			return ret;
+	}
+
+	desc->mask = mask;
+	desc->head = 0;
+	desc->tail = 0;
+	desc->overruns = 0;
+	desc->resyncs = 0;
+
+	return ad717x_stream_start(desc->ad717x_dev, ad717x_iio_sample, desc);
+}
+
+/**
+ * @brief Stop converting and disable the buffer channels.
+ * @param dev - The iio device structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad717x_iio_post_disable(void *dev)
+{
+	struct ad717x_iio_dev *desc = dev;
+	uint8_t ch;
+	int ret;
+
+	ret = ad717x_stream_stop(desc->ad717x_dev);
+	if (ret)
+		return ret;
+
+	for (ch = 0; ch < desc->iio_dev.num_ch; ch++) {
+		if (!(desc->mask & NO_OS_BIT(ch)))
+			continue;
+
+		ret = ad717x_set_channel_status(desc->ad717x_dev, ch, false);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Fill the IIO buffer with the samples of the sequencer. A scan is
+ * pushed once a result was read for each enabled channel, in order. The
+ * channel read from the status tells when a sample was lost, the scan is then
+ * restarted from the first channel.
+ * @param dev_data - IIO device data.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad717x_iio_submit(struct iio_device_data *dev_data)
+{
+	struct ad717x_iio_dev *desc = dev_data->dev;
+	struct iio_buffer *buffer = dev_data->buffer;
+	uint32_t nb_scans = buffer->size / buffer->bytes_per_scan;
+	uint32_t scan[AD717x_MAX_CHANNELS];
+	uint8_t first, last, next, pos;
+	uint8_t ch;
+	uint32_t i;
+	int ret;
+
+	if (!desc->mask)
+		return -EINVAL;
+
+	first = no_os_find_first_set_bit(desc->mask);
+	last = no_os_find_last_set_bit(desc->mask);
+	next = first;
+	pos = 0;
+
+	while (nb_scans) {
+		if (desc->tail == desc->head)
+			continue;
+
+		i = desc->tail % AD717X_IIO_RING_SIZE;
+		ch = desc->ring_ch[i];
+		scan[pos] = desc->ring_code[i];
+		desc->tail++;
+
+		if (ch != next) {
+			desc->resyncs++;
+			next = first;
+			pos = 0;
+			if (ch != first)
+				continue;
+			scan[0] = desc->ring_code[i];
+		}
+
+		pos++;
+		if (ch != last) {
+			do {
+				next++;
+			} while (!(desc->mask & NO_OS_BIT(next)));
+			continue;
+		}
+
+		ret = iio_buffer_push_scan(buffer, scan);
+		if (ret)
+			return ret;
+
+		next = first;
+		pos = 0;
+		nb_scans--;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Read a register of the device.
+ * @param dev     - The iio device structure.
+ * @param reg     - Register address.
+ * @param readval - Register value.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad717x_iio_reg_read(void *dev, uint32_t reg, uint32_t *readval)
+{
+	struct ad717x_iio_dev *desc = dev;
+	ad717x_st_reg *preg;
+	int32_t ret;
+
+	preg = AD717X_GetReg(desc->ad717x_dev, reg);
+	if (!preg)
+		return -EINVAL;
+
+	ret = AD717X_ReadRegister(desc->ad717x_dev, reg);
+	if (ret)
+		return ret;
+
+	*readval = preg->value;
+
+	return 0;
+}
+
+/**
+ * @brief Write a register of the device.
+ * @param dev      - The iio device structure.
+ * @param reg      - Register address.
+ * @param writeval - Register value.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad717x_iio_reg_write(void *dev, uint32_t reg, uint32_t writeval)
+{
+	struct ad717x_iio_dev *desc = dev;
+	ad717x_st_reg *preg;
+
+	preg = AD717X_GetReg(desc->ad717x_dev, reg);
+	if (!preg)
+		return -EINVAL;
+
+	preg->value = writeval;
+
+	return AD717X_WriteRegister(desc->ad717x_dev, reg);
+}
+
+static struct iio_attribute ad717x_iio_ch_attrs[] = {
+	{
+		.name = "raw",
+		.show = ad717x_iio_read_raw,
+	},
+	END_ATTRIBUTES_ARRAY,
+};
+
+static struct iio_attribute ad717x_iio_debug_attrs[] = {
+	{
+		.name = "stream_overruns",
+		.show = ad717x_iio_read_counter,
+		.priv = offsetof(struct ad717x_iio_dev, overruns),
+	},
+	{
+		.name = "stream_resyncs",
+		.show = ad717x_iio_read_counter,
+		.priv = offsetof(struct ad717x_iio_dev, resyncs),
+	},
+	{
+		.name = "stream_errors",
+		.show = ad717x_iio_read_counter,
+		.priv = -1,
+	},
+	END_ATTRIBUTES_ARRAY,
+};
+
+/**
+ * @brief Initializes the AD717x iio driver.
+ * @param iio_dev    - The iio device structure.
+ * @param init_param - The structure that contains the device initial
+ *                     parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int ad717x_iio_init(struct ad717x_iio_dev **iio_dev,
+		    struct ad717x_iio_init_param *init_param)
+{
+	struct ad717x_iio_dev *desc;
+	ad717x_st_reg *preg;
+	uint8_t bytes;
+	uint8_t ch;
+	int ret;
+
+	if (!init_param || !init_param->ad717x_init ||
+	    !init_param->ad717x_init->irq_ctrl)
+		return -EINVAL;
+
+	desc = (struct ad717x_iio_dev *)calloc(1, sizeof(*desc));
+	if (!desc)
+		return -ENOMEM;
+
+	ret = AD717X_Init(&desc->ad717x_dev, *init_param->ad717x_init);
+	if (ret)
+		goto error_desc;
+
+	/* Result width, without the status appended while streaming */
+	preg = AD717X_GetReg(desc->ad717x_dev, AD717X_DATA_REG);
+	bytes = preg->size;
+	preg = AD717X_GetReg(desc->ad717x_dev, AD717X_IFMODE_REG);
+	if (preg->value & AD717X_IFMODE_REG_DATA_STAT)
+		bytes--;
+
+	desc->scan_type = (struct scan_type) {
+		.sign = 'u',
+		.realbits = bytes * 8,
+		.storagebits = 32,
+		.is_big_endian = false,
+	};
+
+	for (ch = 0; ch < desc->ad717x_dev->num_channels; ch++)
+		desc->channels[ch] = (struct iio_channel) {
+			.ch_type = IIO_VOLTAGE,
+			.channel = ch,
+			.scan_index = ch,
+			.indexed = true,
+			.scan_type = &desc->scan_type,
+			.attributes = ad717x_iio_ch_attrs,
+		};
+
+	desc->iio_dev = (struct iio_device) {
+		.num_ch = desc->ad717x_dev->num_channels,
+		.channels = desc->channels,
+		.debug_attributes = ad717x_iio_debug_attrs,
+		.pre_enable = ad717x_iio_pre_enable,
+		.post_disable = ad717x_iio_post_disable,
+		.submit = ad717x_iio_submit,
+		.debug_reg_read = ad717x_iio_reg_read,
+		.debug_reg_write = ad717x_iio_reg_write,
+	};
+
+	*iio_dev = desc;
+
+	return 0;
+
+error_desc:
+	free(desc);
+
+	return ret;
+}
+
+/**
+ * @brief Free the resources allocated by ad717x_iio_init().
+ * @param desc - The IIO device structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int ad717x_iio_remove(struct ad717x_iio_dev *desc)
+{
+	int ret;
+
+	ret = AD717X_remove(desc->ad717x_dev);
+	if (ret)
+		return ret;
+
+	free(desc);
+
+	return 0;
+}
@@ -0,0 +1,91 @@
+/***************************************************************************//**
+ *   @file   iio_ad717x.h
+ *   @brief  Header file of the AD717x IIO driver.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef __IIO_AD717X_H__
+#define __IIO_AD717X_H__
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include "iio.h"
+#include "ad717x.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+/* Samples kept between the RDY interrupt and the IIO buffer, power of 2 */
+#define AD717X_IIO_RING_SIZE	64
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+struct ad717x_iio_dev {
+	/** AD717x device descriptor */
+	ad717x_dev		*ad717x_dev;
+	/** IIO device descriptor */
+	struct iio_device	iio_dev;
+	/** IIO channels, one for each channel of the sequencer */
+	struct iio_channel	channels[AD717x_MAX_CHANNELS];
+	/** Format of the conversion results */
+	struct scan_type	scan_type;
+	/** Channels enabled in the buffer */
+	uint32_t		mask;
+	/** Channel and result of the samples read on RDY */
+	uint8_t			ring_ch[AD717X_IIO_RING_SIZE];
+	uint32_t		ring_code[AD717X_IIO_RING_SIZE];
+	/** Samples written by the interrupt and taken by submit */
+	volatile uint32_t	head;
+	volatile uint32_t	tail;
+	/** Samples dropped because the ring was full */
+	uint32_t		overruns;
+	/** Scans restarted because a sample of the sequence was missing */
+	uint32_t		resyncs;
+};
+
+struct ad717x_iio_init_param {
+	/** AD717x device initialization data, irq_ctrl being needed */
+	ad717x_init_param	*ad717x_init;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+int ad717x_iio_init(struct ad717x_iio_dev **iio_dev,
+		    struct ad717x_iio_init_param *init_param);
+int ad717x_iio_remove(struct ad717x_iio_dev *desc);
+
+#endif /* __IIO_AD717X_H__ */
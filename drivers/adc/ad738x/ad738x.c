@@ -326,6 +326,72 @@ int32_t ad738x_read_data(struct ad738x_dev *dev,
 	return 0;
 }
 
+/**
+ * @brief Read from device continuously.
+ *        The SPI engine offload and its DMAC fill a ring of nb_segments
+ *        segments starting at buf, until
+ *        ad738x_read_data_continuous_stop is called.
+ * @param dev - ad738x_dev device handler.
+ * @param buf - ring buffer, of nb_segments * segment_samples samples.
+ * @param segment_samples - number of samples in a segment.
+ * @param nb_segments - number of segments in the ring. At least 2.
+ * @param segment_done - called from the DMAC interrupt with the address and
+ *			 size in bytes of each filled segment. The segment must
+ *			 be consumed, after invalidating its data cache, before
+ *			 the ring wraps around.
+ * @param ctx - parameter passed to segment_done.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad738x_read_data_continuous(struct ad738x_dev *dev,
+				    uint32_t *buf,
+				    uint32_t segment_samples,
+				    uint32_t nb_segments,
+				    void (*segment_done)(void *ctx,
+						    uint32_t addr,
+						    uint32_t size),
+				    void *ctx)
+{
+#if !defined(USE_STANDARD_SPI)
+	int32_t ret;
+	uint32_t commands_data[2] = {0, 0};
+	struct spi_engine_offload_message msg;
+	uint32_t spi_eng_msg_cmds[3] = {
+		CS_LOW,
+		WRITE_READ(2),
+		CS_HIGH,
+	};
+
+	ret = spi_engine_offload_init(dev->spi_desc, dev->offload_init_param);
+	if (ret != 0)
+		return ret;
+
+	msg.commands_data = commands_data;
+	msg.commands = spi_eng_msg_cmds;
+	msg.no_commands = NO_OS_ARRAY_SIZE(spi_eng_msg_cmds);
+	msg.rx_addr = (uint32_t)buf;
+
+	return spi_engine_offload_stream_start(dev->spi_desc, msg,
+					       segment_samples, nb_segments,
+					       segment_done, ctx);
+#else
+	return -ENOSYS;
+#endif
+}
+
+/**
+ * @brief Stop reading started with ad738x_read_data_continuous.
+ * @param dev - ad738x_dev device handler.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad738x_read_data_continuous_stop(struct ad738x_dev *dev)
+{
+#if !defined(USE_STANDARD_SPI)
+	return spi_engine_offload_stream_stop(dev->spi_desc);
+#else
+	return -ENOSYS;
+#endif
+}
+
 
 /**
  * Initialize the device.
@@ -226,4 +226,15 @@ int32_t ad738x_reference_sel(struct ad738x_dev *dev,
 int32_t ad738x_read_data(struct ad738x_dev *dev,
 			 uint32_t *buf,
 			 uint16_t samples);
+/** Read data from device continuously, into a ring of segments. */
+int32_t ad738x_read_data_continuous(struct ad738x_dev *dev,
+				    uint32_t *buf,
+				    uint32_t segment_samples,
+				    uint32_t nb_segments,
+				    void (*segment_done)(void *ctx,
+						    uint32_t addr,
+						    uint32_t size),
+				    void *ctx);
+/** Stop reading started with ad738x_read_data_continuous. */
+int32_t ad738x_read_data_continuous_stop(struct ad738x_dev *dev);
 #endif /* SRC_AD738X_H_ */
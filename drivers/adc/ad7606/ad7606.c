@@ -50,6 +50,8 @@
 #include "no_os_error.h"
 #include "no_os_util.h"
 #include "no_os_crc.h"
+#include "no_os_unpack.h"
+#include "spi_engine.h"
 
 struct ad7606_chip_info {
 	uint8_t num_channels;
@@ -64,7 +66,6 @@ struct ad7606_chip_info {
 	uint32_t sw_range_table_sz;
 };
 
-NO_OS_DECLARE_CRC8_TABLE(ad7606_crc8);
 NO_OS_DECLARE_CRC16_TABLE(ad7606_crc16);
 
 static const struct ad7606_range ad7606_range_table[] = {
@@ -241,7 +242,7 @@ int32_t ad7606_spi_reg_read(struct ad7606_dev *dev,
 	buf[0] = AD7606_RD_FLAG_MSK(reg_addr);
 	buf[1] = 0x00;
 	if (dev->digital_diag_enable.int_crc_err_en) {
-		crc = no_os_crc8(ad7606_crc8, buf, 2, 0);
+		crc = no_os_crc8(no_os_crc8_table_07, buf, 2, 0);
 		buf[2] = crc;
 		sz += 1;
 	}
@@ -254,7 +255,7 @@ int32_t ad7606_spi_reg_read(struct ad7606_dev *dev,
 	buf[0] = AD7606_RD_FLAG_MSK(reg_addr);
 	buf[1] = 0x00;
 	if (dev->digital_diag_enable.int_crc_err_en) {
-		crc = no_os_crc8(ad7606_crc8, buf, 2, 0);
+		crc = no_os_crc8(no_os_crc8_table_07, buf, 2, 0);
 		buf[2] = crc;
 	}
 	ret = no_os_spi_write_and_read(dev->spi_desc, buf, sz);
@@ -262,7 +263,7 @@ int32_t ad7606_spi_reg_read(struct ad7606_dev *dev,
 		return ret;
 
 	if (dev->digital_diag_enable.int_crc_err_en) {
-		crc = no_os_crc8(ad7606_crc8, buf, 2, 0);
+		crc = no_os_crc8(no_os_crc8_table_07, buf, 2, 0);
 		if (crc != buf[2])
 			return -EBADMSG;
 	}
@@ -310,7 +311,7 @@ int32_t ad7606_spi_reg_write(struct ad7606_dev *dev,
 	buf[0] = AD7606_WR_FLAG_MSK(reg_addr);
 	buf[1] = reg_data;
 	if (dev->digital_diag_enable.int_crc_err_en) {
-		crc = no_os_crc8(ad7606_crc8, buf, 2, 0);
+		crc = no_os_crc8(no_os_crc8_table_07, buf, 2, 0);
 		buf[2] = crc;
 		sz += 1;
 	}
@@ -354,52 +355,6 @@ int32_t ad7606_spi_write_mask(struct ad7606_dev *dev,
 	return ad7606_spi_reg_write(dev, addr, reg_data);
 }
 
-/* Internal function to copy the content of a buffer in 18-bit chunks to a 32-bit buffer by
- * extending the chunks to 32-bit size. */
-static int32_t cpy18b32b(uint8_t *psrc, uint32_t srcsz, uint32_t *pdst)
-{
-	unsigned int i, j;
-
-	if (srcsz % 9)
-		return -EINVAL;
-
-	for(i = 0; i < srcsz; i += 9) {
-		j = 4 * (i / 9);
-		pdst[j+0] = ((uint32_t)(psrc[i+0] & 0xff) << 10) | ((uint32_t)psrc[i+1] << 2)
-			    | ((uint32_t)psrc[i+2] >> 6);
-		pdst[j+1] = ((uint32_t)(psrc[i+2] & 0x3f) << 12) | ((uint32_t)psrc[i+3] << 4)
-			    | ((uint32_t)psrc[i+4] >> 4);
-		pdst[j+2] = ((uint32_t)(psrc[i+4] & 0x0f) << 14) | ((uint32_t)psrc[i+5] << 6)
-			    | ((uint32_t)psrc[i+6] >> 2);
-		pdst[j+3] = ((uint32_t)(psrc[i+6] & 0x03) << 16) | ((uint32_t)psrc[i+7] << 8)
-			    | ((uint32_t)psrc[i+8] >> 0);
-	}
-	return 0;
-}
-
-/* Internal function to copy the content of a buffer in 26-bit chunks to a 32-bit buffer by
- * extending the chunks to 32-bit size. */
-static int32_t cpy26b32b(uint8_t *psrc, uint32_t srcsz, uint32_t *pdst)
-{
-	unsigned int i, j;
-
-	if (srcsz % 13)
-		return -EINVAL;
-
-	for(i = 0; i < srcsz; i += 13) {
-		j = 4 * (i / 13);
-		pdst[j+0] = ((uint32_t)(psrc[i+0] & 0xff) << 18) | ((uint32_t)psrc[i+1] << 10)
-			    | ((uint32_t)psrc[i+2] << 2) | ((uint32_t)psrc[i+3] >> 6);
-		pdst[j+1] = ((uint32_t)(psrc[i+3] & 0x3f) << 20) | ((uint32_t)psrc[i+4] << 12)
-			    | ((uint32_t)psrc[i+5] << 4) | ((uint32_t)psrc[i+6] >> 4);
-		pdst[j+2] = ((uint32_t)(psrc[i+6] & 0x0f) << 22) | ((uint32_t)psrc[i+7] << 14)
-			    | ((uint32_t)psrc[i+8] << 6) | ((uint32_t)psrc[i+9] >> 2);
-		pdst[j+3] = ((uint32_t)(psrc[i+9] & 0x03) << 24) | ((uint32_t)psrc[i+10] << 16)
-			    | ((uint32_t)psrc[i+11] << 8) | ((uint32_t)psrc[i+12] >> 0);
-	}
-	return 0;
-}
-
 /***************************************************************************//**
  * @brief Toggle the CONVST pin to start a conversion.
  *
@@ -436,31 +391,10 @@ int32_t ad7606_convst(struct ad7606_dev *dev)
 	return no_os_gpio_set_value(dev->gpio_convst, 1);
 }
 
-/***************************************************************************//**
- * @brief Read conversion data.
- *
- * This function performs CRC16 computation and checking if enabled in the device.
- * If the status is enabled in device settings, each sample of data will contain
- * status information in the lowest 8 bits.
- *
- * The output buffer provided by the user should be as wide as to be able to
- * contain 1 sample from each channel since this function reads conversion data
- * across all channels.
- *
- * @param dev        - The device structure.
- * @param data       - Pointer to location of buffer where to store the data.
- *
- * @return ret - return code.
- *         Example: -EIO - SPI communication error.
- *                  -EBADMSG - CRC computation mismatch.
- *                  -ENOTSUP - Device bits per sample not supported.
- *                  0 - No errors encountered.
-*******************************************************************************/
-int32_t ad7606_spi_data_read(struct ad7606_dev *dev, uint32_t *data)
+/* Internal function to get the number of bytes of a conversion data frame. */
+static uint32_t ad7606_frame_size(struct ad7606_dev *dev)
 {
 	uint32_t sz;
-	int32_t ret, i;
-	uint16_t crc, icrc;
 	uint8_t bits = ad7606_chip_info_tbl[dev->device_id].bits;
 	uint8_t sbits = dev->config.status_header ? 8 : 0;
 	uint8_t nchannels = ad7606_chip_info_tbl[dev->device_id].num_channels;
@@ -481,40 +415,35 @@ int32_t ad7606_spi_data_read(struct ad7606_dev *dev, uint32_t *data)
 		sz += 2;
 	}
 
-	memset(dev->data, 0, sz);
-	ret = no_os_spi_write_and_read(dev->spi_desc, dev->data, sz);
-	if (ret < 0)
-		return ret;
+	return sz;
+}
+
+/* Internal function to check and unpack a conversion data frame. */
+static int32_t ad7606_frame_unpack(struct ad7606_dev *dev, uint8_t *frame,
+				   uint32_t *data)
+{
+	int32_t ret;
+	uint16_t crc, icrc;
+	uint32_t sz = ad7606_frame_size(dev);
+	uint8_t bits = ad7606_chip_info_tbl[dev->device_id].bits;
+	uint8_t sbits = dev->config.status_header ? 8 : 0;
+	uint8_t nchannels = ad7606_chip_info_tbl[dev->device_id].num_channels;
 
 	if (dev->digital_diag_enable.int_crc_err_en) {
 		sz -= 2;
-		crc = no_os_crc16(ad7606_crc16, dev->data, sz, 0);
-		icrc = ((uint16_t)dev->data[sz] << 8) |
-		       dev->data[sz+1];
+		crc = no_os_crc16(ad7606_crc16, frame, sz, 0);
+		icrc = ((uint16_t)frame[sz] << 8) |
+		       frame[sz+1];
 		if (icrc != crc)
 			return -EBADMSG;
 	}
 
 	switch(bits) {
 	case 18:
-		if (dev->config.status_header)
-			ret = cpy26b32b(dev->data, sz, data);
-		else
-			ret = cpy18b32b(dev->data, sz, data);
-		if (ret < 0)
-			return ret;
-		break;
 	case 16:
-		for(i = 0; i < nchannels; i++) {
-			if (dev->config.status_header) {
-				data[i] = (uint32_t)dev->data[i*3] << 16;
-				data[i] |= (uint32_t)dev->data[i*3+1] << 8;
-				data[i] |= (uint32_t)dev->data[i*3+2];
-			} else {
-				data[i] = (uint32_t)dev->data[i*2] << 8;
-				data[i] |= (uint32_t)dev->data[i*2+1];
-			}
-		}
+		/* The status, if enabled, is unpacked as the low bits of a sample */
+		ret = no_os_unpack_be(frame, nchannels, bits + sbits, false,
+				      (int32_t *)data);
 		break;
 	default:
 		ret = -ENOTSUP;
@@ -524,6 +453,39 @@ int32_t ad7606_spi_data_read(struct ad7606_dev *dev, uint32_t *data)
 	return ret;
 }
 
+/***************************************************************************//**
+ * @brief Read conversion data.
+ *
+ * This function performs CRC16 computation and checking if enabled in the device.
+ * If the status is enabled in device settings, each sample of data will contain
+ * status information in the lowest 8 bits.
+ *
+ * The output buffer provided by the user should be as wide as to be able to
+ * contain 1 sample from each channel since this function reads conversion data
+ * across all channels.
+ *
+ * @param dev        - The device structure.
+ * @param data       - Pointer to location of buffer where to store the data.
+ *
+ * @return ret - return code.
+ *         Example: -EIO - SPI communication error.
+ *                  -EBADMSG - CRC computation mismatch.
+ *                  -ENOTSUP - Device bits per sample not supported.
+ *                  0 - No errors encountered.
+*******************************************************************************/
+int32_t ad7606_spi_data_read(struct ad7606_dev *dev, uint32_t *data)
+{
+	uint32_t sz = ad7606_frame_size(dev);
+	int32_t ret;
+
+	memset(dev->data, 0, sz);
+	ret = no_os_spi_write_and_read(dev->spi_desc, dev->data, sz);
+	if (ret < 0)
+		return ret;
+
+	return ad7606_frame_unpack(dev, dev->data, data);
+}
+
 /***************************************************************************//**
  * @brief Blocking conversion start and data read.
  *
@@ -573,6 +535,230 @@ int32_t ad7606_read(struct ad7606_dev *dev, uint32_t * data)
 	return ad7606_spi_data_read(dev, data);
 }
 
+/***************************************************************************//**
+ * @brief Get the number of bytes of a captured scan.
+ *
+ * A scan is the conversion data frame of all channels, as read over SPI,
+ * including the status and CRC bytes if they are enabled.
+ *
+ * @param dev        - The device structure.
+ *
+ * @return The size of a scan in bytes.
+*******************************************************************************/
+uint32_t ad7606_capture_scan_size(struct ad7606_dev *dev)
+{
+	return ad7606_frame_size(dev);
+}
+
+/* Internal function to prepare the SPI Engine offload for a capture. */
+static int32_t ad7606_capture_prepare(struct ad7606_dev *dev, uint8_t *buf,
+				      uint32_t *cmds,
+				      struct spi_engine_offload_message *msg)
+{
+	int32_t ret;
+
+	if (!dev->offload_init_param || !dev->trigger_pwm_desc)
+		return -ENOTSUP;
+
+	if (dev->reg_mode) {
+		/* Enter ADC reading mode by writing at address zero. */
+		ret = ad7606_spi_reg_write(dev, 0, 0);
+		if (ret < 0)
+			return ret;
+
+		dev->reg_mode = false;
+	}
+
+	/* One engine word per byte, the scans are stored as read over SPI. */
+	ret = spi_engine_set_transfer_width(dev->spi_desc, 8);
+	if (ret < 0)
+		return ret;
+
+	ret = spi_engine_offload_init(dev->spi_desc, dev->offload_init_param);
+	if (ret < 0)
+		return ret;
+
+	cmds[0] = CS_LOW;
+	cmds[1] = READ(ad7606_frame_size(dev));
+	cmds[2] = CS_HIGH;
+
+	msg->commands = cmds;
+	msg->no_commands = 3;
+	msg->commands_data = NULL;
+	msg->tx_addr = 0;
+	msg->rx_addr = (uint32_t)buf;
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Blocking capture of consecutive scans.
+ *
+ * CONVST is generated by the PWM, at the rate it was initialized with, and
+ * each BUSY falling edge triggers the SPI Engine offload to read one scan into
+ * buf, without CPU intervention. Use ad7606_capture_unpack() to get the
+ * samples.
+ *
+ * @param dev        - The device structure.
+ * @param buf        - Buffer of nb_scans * ad7606_capture_scan_size() bytes.
+ * @param nb_scans   - Number of scans to capture.
+ *
+ * @return ret - return code.
+ *         Example: -ENOTSUP - Offload or CONVST PWM not initialized.
+ *                  -EIO - SPI communication error.
+ *                  0 - No errors encountered.
+*******************************************************************************/
+int32_t ad7606_capture(struct ad7606_dev *dev, uint8_t *buf, uint32_t nb_scans)
+{
+	struct spi_engine_offload_message msg;
+	uint32_t cmds[3];
+	int32_t ret;
+
+	ret = ad7606_capture_prepare(dev, buf, cmds, &msg);
+	if (ret < 0)
+		return ret;
+
+	ret = no_os_pwm_enable(dev->trigger_pwm_desc);
+	if (ret < 0)
+		return ret;
+
+	ret = spi_engine_offload_transfer(dev->spi_desc, msg, nb_scans);
+
+	no_os_pwm_disable(dev->trigger_pwm_desc);
+
+	if (ret < 0)
+		return ret;
+
+	if (dev->dcache_invalidate_range)
+		dev->dcache_invalidate_range(msg.rx_addr,
+					     nb_scans * ad7606_frame_size(dev));
+
+	return 0;
+}
+
+/* Internal function called from the DMAC interrupt for each filled segment. */
+static void ad7606_capture_segment_done(void *ctx, uint32_t addr,
+					uint32_t size)
+{
+	struct ad7606_dev *dev = ctx;
+
+	if (dev->dcache_invalidate_range)
+		dev->dcache_invalidate_range(addr, size);
+
+	dev->capture_cb(dev->capture_ctx, (uint8_t *)addr,
+			size / dev->capture_scan_size);
+}
+
+/***************************************************************************//**
+ * @brief Start a continuous capture.
+ *
+ * Same as ad7606_capture(), but the scans are streamed without stopping into
+ * a ring of nb_segments segments of segment_scans scans, starting at buf.
+ * capture_cb is called from the DMAC interrupt for each filled segment, for
+ * example to push the scans into an IIO buffer, and must be done with the
+ * segment before the ring wraps around to it. The offload RX DMAC must be
+ * initialized with IRQ_ENABLED.
+ *
+ * @param dev           - The device structure.
+ * @param buf           - Buffer of segment_scans * nb_segments scans.
+ * @param segment_scans - Number of scans of a segment.
+ * @param nb_segments   - Number of segments of the ring. At least 2.
+ * @param capture_cb    - Callback called with each filled segment.
+ * @param ctx           - Parameter passed to capture_cb.
+ *
+ * @return ret - return code.
+ *         Example: -ENOTSUP - Offload or CONVST PWM not initialized.
+ *                  -EINVAL - Invalid parameters.
+ *                  0 - No errors encountered.
+*******************************************************************************/
+int32_t ad7606_capture_start(struct ad7606_dev *dev, uint8_t *buf,
+			     uint32_t segment_scans, uint32_t nb_segments,
+			     void (*capture_cb)(void *ctx, uint8_t *buf,
+					     uint32_t nb_scans),
+			     void *ctx)
+{
+	struct spi_engine_offload_message msg;
+	uint32_t cmds[3];
+	int32_t ret;
+
+	if (!capture_cb || !segment_scans || nb_segments < 2)
+		return -EINVAL;
+
+	ret = ad7606_capture_prepare(dev, buf, cmds, &msg);
+	if (ret < 0)
+		return ret;
+
+	dev->capture_cb = capture_cb;
+	dev->capture_ctx = ctx;
+	dev->capture_scan_size = ad7606_frame_size(dev);
+
+	ret = spi_engine_offload_stream_start(dev->spi_desc, msg, segment_scans,
+					      nb_segments,
+					      ad7606_capture_segment_done, dev);
+	if (ret < 0)
+		return ret;
+
+	/* Start converting once the offload waits for the BUSY edges */
+	ret = no_os_pwm_enable(dev->trigger_pwm_desc);
+	if (ret < 0)
+		spi_engine_offload_stream_stop(dev->spi_desc);
+
+	return ret;
+}
+
+/***************************************************************************//**
+ * @brief Stop the capture started by ad7606_capture_start().
+ *
+ * @param dev        - The device structure.
+ *
+ * @return ret - return code.
+ *         Example: -ENOTSUP - Offload or CONVST PWM not initialized.
+ *                  0 - No errors encountered.
+*******************************************************************************/
+int32_t ad7606_capture_stop(struct ad7606_dev *dev)
+{
+	int32_t ret;
+
+	if (!dev->offload_init_param || !dev->trigger_pwm_desc)
+		return -ENOTSUP;
+
+	ret = no_os_pwm_disable(dev->trigger_pwm_desc);
+	if (ret < 0)
+		return ret;
+
+	return spi_engine_offload_stream_stop(dev->spi_desc);
+}
+
+/***************************************************************************//**
+ * @brief Check and unpack captured scans.
+ *
+ * @param dev        - The device structure.
+ * @param buf        - Captured scans.
+ * @param nb_scans   - Number of scans in buf.
+ * @param data       - Buffer of nb_scans * number of channels samples.
+ *
+ * @return ret - return code.
+ *         Example: -EBADMSG - CRC computation mismatch.
+ *                  -ENOTSUP - Device bits per sample not supported.
+ *                  0 - No errors encountered.
+*******************************************************************************/
+int32_t ad7606_capture_unpack(struct ad7606_dev *dev, uint8_t *buf,
+			      uint32_t nb_scans, uint32_t *data)
+{
+	uint32_t sz = ad7606_frame_size(dev);
+	uint32_t i;
+	int32_t ret;
+
+	for (i = 0; i < nb_scans; i++) {
+		ret = ad7606_frame_unpack(dev, buf + i * sz,
+					  data + i * dev->num_channels);
+		if (ret < 0)
+			return ret;
+	}
+
+	return 0;
+}
+
 /* Internal function to reset device settings to default state after chip reset. */
 static inline void ad7606_reset_settings(struct ad7606_dev *dev)
 {
@@ -1113,7 +1299,6 @@ int32_t ad7606_init(struct ad7606_dev **device,
 	uint8_t reg, id;
 	int32_t i, ret;
 
-	no_os_crc8_populate_msb(ad7606_crc8, 0x7);
 	no_os_crc16_populate_msb(ad7606_crc16, 0x755b);
 
 	dev = (struct ad7606_dev *)calloc(1, sizeof(*dev));
@@ -1213,6 +1398,21 @@ int32_t ad7606_init(struct ad7606_dev **device,
 	if (ad7606_chip_info_tbl[dev->device_id].has_oversampling)
 		ad7606_set_oversampling(dev, init_param->oversampling);
 
+	dev->offload_init_param = init_param->offload_init_param;
+	dev->dcache_invalidate_range = init_param->dcache_invalidate_range;
+
+	if (init_param->trigger_pwm_init) {
+		ret = no_os_pwm_init(&dev->trigger_pwm_desc,
+				     init_param->trigger_pwm_init);
+		if (ret < 0)
+			goto error;
+
+		/* CONVST is only generated during captures */
+		ret = no_os_pwm_disable(dev->trigger_pwm_desc);
+		if (ret < 0)
+			goto error;
+	}
+
 	*device = dev;
 
 	printf("ad7606 successfully initialized\n");
@@ -1247,6 +1447,9 @@ int32_t ad7606_remove(struct ad7606_dev *dev)
 	no_os_gpio_remove(dev->gpio_os2);
 	no_os_gpio_remove(dev->gpio_par_ser);
 
+	if (dev->trigger_pwm_desc)
+		no_os_pwm_remove(dev->trigger_pwm_desc);
+
 	ret = no_os_spi_remove(dev->spi_desc);
 
 	free(dev);
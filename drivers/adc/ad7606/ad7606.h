@@ -47,6 +47,7 @@
 #include <stdbool.h>
 #include "no_os_delay.h"
 #include "no_os_gpio.h"
+#include "no_os_pwm.h"
 #include "no_os_spi.h"
 #include "no_os_util.h"
 
@@ -315,6 +316,18 @@ struct ad7606_dev {
 	struct ad7606_range range_ch[AD7606_MAX_CHANNELS];
 	/** Data buffer (used internally by the SPI communication functions) */
 	uint8_t data[28];
+	/** SPI Engine offload initialization parameters, used by captures */
+	struct spi_engine_offload_init_param *offload_init_param;
+	/** CONVST PWM descriptor, used by captures */
+	struct no_os_pwm_desc *trigger_pwm_desc;
+	/** Invalidate the data cache over the captured data */
+	void (*dcache_invalidate_range)(uint32_t address, uint32_t bytes_count);
+	/** Callback of the running capture, called for each filled segment */
+	void (*capture_cb)(void *ctx, uint8_t *buf, uint32_t nb_scans);
+	/** Parameter passed to capture_cb */
+	void *capture_ctx;
+	/** Size in bytes of a scan of the running capture */
+	uint32_t capture_scan_size;
 };
 
 /**
@@ -360,6 +373,13 @@ struct ad7606_init_param {
 	uint8_t gain_ch[AD7606_MAX_CHANNELS];
 	/** Channel operating range */
 	struct ad7606_range range_ch[AD7606_MAX_CHANNELS];
+	/** SPI Engine offload initialization parameters. Optional, needed by
+	 *  captures. The offload must be triggered by the BUSY falling edge. */
+	struct spi_engine_offload_init_param *offload_init_param;
+	/** PWM generating CONVST. Optional, needed by captures. */
+	struct no_os_pwm_init_param *trigger_pwm_init;
+	/** Invalidate the data cache over the captured data. Optional. */
+	void (*dcache_invalidate_range)(uint32_t address, uint32_t bytes_count);
 };
 
 int32_t ad7606_spi_reg_read(struct ad7606_dev *dev,
@@ -377,6 +397,16 @@ int32_t ad7606_spi_data_read(struct ad7606_dev *dev,
 int32_t ad7606_read(struct ad7606_dev *dev,
 		    uint32_t *data);
 int32_t ad7606_convst(struct ad7606_dev *dev);
+uint32_t ad7606_capture_scan_size(struct ad7606_dev *dev);
+int32_t ad7606_capture(struct ad7606_dev *dev, uint8_t *buf, uint32_t nb_scans);
+int32_t ad7606_capture_start(struct ad7606_dev *dev, uint8_t *buf,
+			     uint32_t segment_scans, uint32_t nb_segments,
+			     void (*capture_cb)(void *ctx, uint8_t *buf,
+					     uint32_t nb_scans),
+			     void *ctx);
+int32_t ad7606_capture_stop(struct ad7606_dev *dev);
+int32_t ad7606_capture_unpack(struct ad7606_dev *dev, uint8_t *buf,
+			      uint32_t nb_scans, uint32_t *data);
 int32_t ad7606_reset(struct ad7606_dev *dev);
 int32_t ad7606_set_oversampling(struct ad7606_dev *dev,
 				struct ad7606_oversampling oversampling);
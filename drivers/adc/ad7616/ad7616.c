@@ -51,6 +51,7 @@
 #include "no_os_error.h"
 #include "no_os_delay.h"
 #include "no_os_axi_io.h"
+#include "no_os_util.h"
 
 /**
  * Read from device.
@@ -477,6 +478,258 @@ int32_t ad7616_read_data_parallel(struct ad7616_dev *dev,
 	return 0;
 }
 
+/**
+ * Load the sequencer stack and enable the burst sequencer mode.
+ * Each CONVST then converts the whole stack, pair after pair, and the pairs
+ * are read back to back before the next conversion.
+ * @param dev - The device structure.
+ * @param pairs - The channel pairs, in conversion order.
+ * @param nb_pairs - Number of pairs. 1 to AD7616_SEQ_STACK_SIZE.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad7616_set_sequencer(struct ad7616_dev *dev,
+			     const struct ad7616_seq_pair *pairs,
+			     uint8_t nb_pairs)
+{
+	uint16_t entry;
+	int32_t ret;
+	uint8_t i;
+
+	if (dev->mode != AD7616_SW)
+		return -ENOTSUP;
+
+	if (!pairs || !nb_pairs || nb_pairs > AD7616_SEQ_STACK_SIZE)
+		return -EINVAL;
+
+	for (i = 0; i < nb_pairs; i++)
+		if (pairs[i].va > AD7616_VA7 || pairs[i].vb > AD7616_VA7)
+			return -EINVAL;
+
+	for (i = 0; i < nb_pairs; i++) {
+		entry = AD7616_ASEL(pairs[i].va) | AD7616_BSEL(pairs[i].vb);
+		/* The sequence restarts after the entry with SSREN set */
+		if (i == nb_pairs - 1)
+			entry |= AD7616_SSREN;
+		ret = ad7616_write(dev, AD7616_REG_SEQUENCER_STACK(i), entry);
+		if (ret != 0)
+			return ret;
+		dev->seq[i] = pairs[i];
+	}
+	dev->seq_len = nb_pairs;
+
+	return ad7616_write_mask(dev, AD7616_REG_CONFIG,
+				 AD7616_BURSTEN | AD7616_SEQEN,
+				 AD7616_BURSTEN | AD7616_SEQEN);
+}
+
+/**
+ * Disable the burst sequencer mode, a CONVST converts the pair selected by
+ * the channel register again.
+ * @param dev - The device structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad7616_clear_sequencer(struct ad7616_dev *dev)
+{
+	dev->seq_len = 0;
+
+	return ad7616_write_mask(dev, AD7616_REG_CONFIG,
+				 AD7616_BURSTEN | AD7616_SEQEN, 0);
+}
+
+/**
+ * Get the position of a channel in the scans of ch_mask.
+ * @param ch_mask - Channels of the scans.
+ * @param ch - The channel.
+ * @return the slot of ch, 0xFF if it is not part of the scans.
+ */
+static uint8_t ad7616_scan_slot(uint16_t ch_mask, uint8_t ch)
+{
+	if (!(ch_mask & NO_OS_BIT(ch)))
+		return 0xFF;
+
+	return no_os_hweight16(ch_mask & (NO_OS_BIT(ch) - 1));
+}
+
+/**
+ * Forward a filled segment to the capture callback.
+ * @param ctx - The device structure.
+ * @param addr - Address of the segment.
+ * @param size - Size of the segment, in bytes.
+ */
+static void ad7616_segment_done(void *ctx, uint32_t addr, uint32_t size)
+{
+	struct ad7616_dev *dev = ctx;
+
+	if (dev->dcache_invalidate_range)
+		dev->dcache_invalidate_range(addr, size);
+
+	dev->capture_cb(dev->capture_ctx, (const uint32_t *)addr,
+			size / (dev->seq_len * sizeof(uint32_t)));
+}
+
+/**
+ * Start a continuous capture of the sequence set by ad7616_set_sequencer().
+ * The sequences are streamed without stopping into a ring of nb_segments
+ * segments of segment_seqs sequences, starting at buf. Each sequence is one
+ * word per stack entry, holding the A result in the upper and the B result in
+ * the lower half. capture_cb is called from the DMAC interrupt with each
+ * filled segment, typically to de-interleave it with ad7616_seq_demux() and
+ * push the scans into an IIO buffer, and must be done with it before the ring
+ * wraps around. The RX DMAC (offload DMAC for the serial interface, par_dmac
+ * for the parallel one) must be initialized with IRQ_ENABLED.
+ * The conversion rate is the one of the UP_CONV_RATE core register.
+ * @param dev - The device structure.
+ * @param buf - Buffer of segment_seqs * nb_segments sequences.
+ * @param segment_seqs - Number of sequences of a segment.
+ * @param nb_segments - Number of segments of the ring. At least 2.
+ * @param ch_mask - Channels of the scans built by ad7616_seq_demux(), bit 0
+ * 		    for VA0 to bit 15 for VB7.
+ * @param capture_cb - Callback called with each filled segment.
+ * @param ctx - Parameter passed to capture_cb.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad7616_capture_start(struct ad7616_dev *dev, uint32_t *buf,
+			     uint32_t segment_seqs, uint32_t nb_segments,
+			     uint16_t ch_mask,
+			     void (*capture_cb)(void *ctx, const uint32_t *buf,
+					     uint32_t nb_seqs),
+			     void *ctx)
+{
+	uint32_t commands_data[1] = {0x00};
+	struct spi_engine_offload_message msg;
+	uint32_t spi_eng_msg_cmds[3];
+	uint16_t seq_mask = 0;
+	int32_t ret;
+	uint8_t i;
+
+	if (!dev->seq_len)
+		return -ENOTSUP;
+
+	if (!buf || !capture_cb || !segment_seqs || nb_segments < 2)
+		return -EINVAL;
+
+	for (i = 0; i < dev->seq_len; i++)
+		seq_mask |= NO_OS_BIT(dev->seq[i].va) |
+			    NO_OS_BIT(dev->seq[i].vb + AD7616_VB0);
+
+	/* A scan can only hold channels of the sequence */
+	if (!ch_mask || (ch_mask & ~seq_mask))
+		return -EINVAL;
+
+	/* Scan slot of the results of each stack entry, computed once here so
+	 * the demux only copies. Unselected channels are skipped and a channel
+	 * converted more than once keeps its last result. */
+	for (i = 0; i < dev->seq_len; i++) {
+		dev->seq_a_slot[i] = ad7616_scan_slot(ch_mask, dev->seq[i].va);
+		dev->seq_b_slot[i] = ad7616_scan_slot(ch_mask, dev->seq[i].vb +
+						      AD7616_VB0);
+	}
+	dev->capture_scan_ch = no_os_hweight16(ch_mask);
+
+	dev->capture_cb = capture_cb;
+	dev->capture_ctx = ctx;
+
+	if (dev->interface == AD7616_PARALLEL) {
+		if (!dev->par_dmac)
+			return -ENOTSUP;
+
+		/* Read the whole stack after each conversion */
+		no_os_axi_io_write(dev->core_baseaddr,
+				   AD7616_REG_UP_BURST_LENGTH,
+				   dev->seq_len * 2);
+
+		ret = axi_dmac_stream_start(dev->par_dmac, (uintptr_t)buf,
+					    segment_seqs * dev->seq_len *
+					    sizeof(uint32_t), nb_segments,
+					    ad7616_segment_done, dev);
+		if (ret != 0)
+			return ret;
+	} else {
+		spi_eng_msg_cmds[0] = CS_LOW;
+		spi_eng_msg_cmds[1] = READ(2 * dev->seq_len);
+		spi_eng_msg_cmds[2] = CS_HIGH;
+
+		dev->spi_desc->mode = NO_OS_SPI_MODE_3;
+		spi_engine_set_speed(dev->spi_desc,
+				     dev->spi_desc->max_speed_hz);
+
+		ret = spi_engine_offload_init(dev->spi_desc,
+					      dev->offload_init_param);
+		if (ret != 0)
+			return ret;
+
+		msg.commands_data = commands_data;
+		msg.commands = spi_eng_msg_cmds;
+		msg.no_commands = NO_OS_ARRAY_SIZE(spi_eng_msg_cmds);
+		msg.rx_addr = (uint32_t)buf;
+
+		ret = spi_engine_offload_stream_start(dev->spi_desc, msg,
+						      segment_seqs, nb_segments,
+						      ad7616_segment_done, dev);
+		if (ret != 0)
+			return ret;
+	}
+
+	/* Start converting once the DMAC is ready to receive */
+	no_os_axi_io_write(dev->core_baseaddr, AD7616_REG_UP_CTRL,
+			   AD7616_CTRL_RESETN | AD7616_CTRL_CNVST_EN);
+
+	return 0;
+}
+
+/**
+ * Stop the capture started by ad7616_capture_start().
+ * @param dev - The device structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad7616_capture_stop(struct ad7616_dev *dev)
+{
+	no_os_axi_io_write(dev->core_baseaddr, AD7616_REG_UP_CTRL,
+			   AD7616_CTRL_RESETN);
+
+	if (dev->interface == AD7616_PARALLEL) {
+		if (!dev->par_dmac)
+			return -ENOTSUP;
+		axi_dmac_stream_stop(dev->par_dmac);
+
+		return 0;
+	}
+
+	spi_engine_offload_stream_stop(dev->spi_desc);
+
+	/* Back to the register access speed */
+	spi_engine_set_speed(dev->spi_desc, dev->reg_access_speed);
+
+	return 0;
+}
+
+/**
+ * De-interleave sequences captured by ad7616_capture_start() into scans of
+ * the channels of its ch_mask, in channel order (VA0 to VB7), as an IIO
+ * buffer expects them.
+ * @param dev - The device structure.
+ * @param buf - The captured sequences.
+ * @param nb_seqs - Number of sequences.
+ * @param scans - nb_seqs scans of one sample per enabled channel. May not
+ * 		  overlap buf.
+ */
+void ad7616_seq_demux(struct ad7616_dev *dev, const uint32_t *buf,
+		      uint32_t nb_seqs, uint16_t *scans)
+{
+	uint32_t s;
+	uint8_t i;
+
+	for (s = 0; s < nb_seqs; s++) {
+		for (i = 0; i < dev->seq_len; i++, buf++) {
+			if (dev->seq_a_slot[i] != 0xFF)
+				scans[dev->seq_a_slot[i]] = *buf >> 16;
+			if (dev->seq_b_slot[i] != 0xFF)
+				scans[dev->seq_b_slot[i]] = *buf & 0xFFFF;
+		}
+		scans += dev->capture_scan_ch;
+	}
+}
+
 /**
  * Initialize the AXI_AD7616 IP core device.
  * @param dev - The device structure.
@@ -529,6 +782,8 @@ int32_t ad7616_setup(struct ad7616_dev **device,
 	dev->offload_init_param = init_param->offload_init_param;
 	dev->reg_access_speed = init_param->reg_access_speed;
 	dev->dcache_invalidate_range = init_param->dcache_invalidate_range;
+	dev->par_dmac = init_param->par_dmac;
+	dev->seq_len = 0;
 
 	ad7616_core_setup(dev);
 
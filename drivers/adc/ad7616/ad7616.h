@@ -41,6 +41,7 @@
 #define AD7616_H_
 
 #include "no_os_gpio.h"
+#include "axi_dmac.h"
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -90,6 +91,9 @@
 #define AD7616_STATUS_B(x)				(((x) & 0xF) << 8)
 #define AD7616_STATUS_CRC(x)			(((x) & 0xFF) << 0)
 
+/* Number of entries of the sequencer stack */
+#define AD7616_SEQ_STACK_SIZE			32
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -139,6 +143,17 @@ enum ad7616_osr {
 	AD7616_OSR_128,
 };
 
+/**
+ * @struct ad7616_seq_pair
+ * @brief Entry of the sequencer stack, the two channels converted together.
+ */
+struct ad7616_seq_pair {
+	/** Input of the A side, 0 for VA0 to 7 for VA7 */
+	uint8_t va;
+	/** Input of the B side, 0 for VB0 to 7 for VB7 */
+	uint8_t vb;
+};
+
 struct ad7616_dev {
 	/* SPI */
 	struct no_os_spi_desc		*spi_desc;
@@ -160,6 +175,17 @@ struct ad7616_dev {
 	enum ad7616_range		vb[8];
 	enum ad7616_osr			osr;
 	void (*dcache_invalidate_range)(uint32_t address, uint32_t bytes_count);
+	/* Parallel interface DMAC, for ad7616_capture_start() */
+	struct axi_dmac			*par_dmac;
+	/* Sequencer */
+	struct ad7616_seq_pair	seq[AD7616_SEQ_STACK_SIZE];
+	uint8_t				seq_len;
+	/* Capture */
+	uint8_t		seq_a_slot[AD7616_SEQ_STACK_SIZE];
+	uint8_t		seq_b_slot[AD7616_SEQ_STACK_SIZE];
+	uint8_t				capture_scan_ch;
+	void (*capture_cb)(void *ctx, const uint32_t *buf, uint32_t nb_seqs);
+	void				*capture_ctx;
 };
 
 struct ad7616_init_param {
@@ -182,6 +208,9 @@ struct ad7616_init_param {
 	enum ad7616_range		vb[8];
 	enum ad7616_osr			osr;
 	void (*dcache_invalidate_range)(uint32_t address, uint32_t bytes_count);
+	/* DMAC of the parallel interface, initialized with IRQ_ENABLED and its
+	 * interrupt registered. Only needed by ad7616_capture_start(). */
+	struct axi_dmac			*par_dmac;
 };
 
 /******************************************************************************/
@@ -241,6 +270,24 @@ int32_t ad7616_read_data_serial(struct ad7616_dev *dev,
 int32_t ad7616_read_data_parallel(struct ad7616_dev *dev,
 				  uint32_t *buf,
 				  uint32_t samples);
+/* Load the sequencer stack and enable the burst sequencer mode. */
+int32_t ad7616_set_sequencer(struct ad7616_dev *dev,
+			     const struct ad7616_seq_pair *pairs,
+			     uint8_t nb_pairs);
+/* Disable the burst sequencer mode. */
+int32_t ad7616_clear_sequencer(struct ad7616_dev *dev);
+/* Stream the sequences continuously into a ring of segments. */
+int32_t ad7616_capture_start(struct ad7616_dev *dev, uint32_t *buf,
+			     uint32_t segment_seqs, uint32_t nb_segments,
+			     uint16_t ch_mask,
+			     void (*capture_cb)(void *ctx, const uint32_t *buf,
+					     uint32_t nb_seqs),
+			     void *ctx);
+/* Stop the capture started by ad7616_capture_start(). */
+int32_t ad7616_capture_stop(struct ad7616_dev *dev);
+/* De-interleave captured sequences into scans of the enabled channels. */
+void ad7616_seq_demux(struct ad7616_dev *dev, const uint32_t *buf,
+		      uint32_t nb_seqs, uint16_t *scans);
 /* Initialize the core. */
 int32_t ad7616_core_setup(struct ad7616_dev *dev);
 /* Initialize the device. */
@@ -47,6 +47,9 @@
 #include "ad77681.h"
 #include "no_os_error.h"
 #include "no_os_delay.h"
+#include "no_os_crc8.h"
+#include "no_os_sd_odr.h"
+#include "no_os_util.h"
 
 /******************************************************************************/
 /************************** Functions Implementation **************************/
@@ -62,21 +65,8 @@ uint8_t ad77681_compute_crc8(uint8_t *data,
 			     uint8_t data_size,
 			     uint8_t init_val)
 {
-	uint8_t i;
-	uint8_t crc = init_val;
-
-	while (data_size) {
-		for (i = 0x80; i != 0; i >>= 1) {
-			if (((crc & 0x80) != 0) != ((*data & i) != 0)) {
-				crc <<= 1;
-				crc ^= AD77681_CRC8_POLY;
-			} else
-				crc <<= 1;
-		}
-		data++;
-		data_size--;
-	}
-	return crc;
+	/* AD77681_CRC8_POLY is 0x07, use the precomputed table */
+	return no_os_crc8(no_os_crc8_table_07, data, data_size, init_val);
 }
 
 /**
@@ -427,33 +417,48 @@ int32_t ad77681_data_to_voltage(struct ad77681_dev *dev,
 }
 
 /**
- * Update ADCs sample rate depending on MCLK, MCLK_DIV and filter settings
+ * Get the MCLK divider ratio
  * @param dev - The device structure.
+ * @param mclk_div - Returned divider ratio.
  * @return 0 in case of success, negative error code otherwise.
  */
-int32_t ad77681_update_sample_rate(struct ad77681_dev *dev)
+static int32_t ad77681_mclk_div_get(struct ad77681_dev *dev,
+				    uint32_t *mclk_div)
 {
-	uint8_t mclk_div;
-	uint16_t osr;
-
-	/* Finding out MCLK divider */
 	switch (dev->mclk_div) {
 	case AD77681_MCLK_DIV_16:
-		mclk_div = 16;
+		*mclk_div = 16;
 		break;
 	case AD77681_MCLK_DIV_8:
-		mclk_div = 8;
+		*mclk_div = 8;
 		break;
 	case AD77681_MCLK_DIV_4:
-		mclk_div = 4;
+		*mclk_div = 4;
 		break;
 	case AD77681_MCLK_DIV_2:
-		mclk_div = 2;
+		*mclk_div = 2;
 		break;
 	default:
 		return -1;
 	}
 
+	return 0;
+}
+
+/**
+ * Update ADCs sample rate depending on MCLK, MCLK_DIV and filter settings
+ * @param dev - The device structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad77681_update_sample_rate(struct ad77681_dev *dev)
+{
+	uint32_t mclk_div;
+	uint16_t osr;
+
+	/* Finding out MCLK divider */
+	if (ad77681_mclk_div_get(dev, &mclk_div))
+		return -1;
+
 	/* Finding out decimation ratio */
 	switch (dev->filter) {
 	case (AD77681_SINC5 | AD77681_FIR):
@@ -498,58 +503,64 @@ int32_t ad77681_update_sample_rate(struct ad77681_dev *dev)
 		return -1;
 	}
 
-	/* Sample rate to Hz */
-	dev->sample_rate = (dev->mclk / (osr*mclk_div)) * 1000;
+	/* Sample rate to Hz, MCLK is in kHz */
+	dev->sample_rate = no_os_sd_odr_div((uint32_t)dev->mclk * 1000,
+					    mclk_div, osr) / 1000;
 
 	return 0;
 }
 
 /**
- * Get SINC3 filter oversampling ratio register value based on user's inserted
- * output data rate ODR
+ * Get SINC3 filter oversampling ratio register value closest to an output
+ * data rate, without floating point
  * @param dev - The device structure.
  * @param sinc3_dec_reg - Returned closest value of SINC3 register
- * @param sinc3_odr - Desired output data rage
+ * @param odr_mhz - Desired output data rate in mHz
  * @return 0 in case of success, negative error code otherwise.
  */
-int32_t ad77681_SINC3_ODR(struct ad77681_dev *dev,
-			  uint16_t *sinc3_dec_reg,
-			  float sinc3_odr)
+int32_t ad77681_sinc3_odr_mhz(struct ad77681_dev *dev,
+			      uint16_t *sinc3_dec_reg,
+			      uint32_t odr_mhz)
 {
-	uint8_t mclk_div;
-	float	odr;
+	uint32_t mclk_div, mclk_hz, osr;
 
-	if (sinc3_odr < 0)
+	if (ad77681_mclk_div_get(dev, &mclk_div))
 		return -1;
 
-	switch (dev->mclk_div) {
-	case AD77681_MCLK_DIV_16:
-		mclk_div = 16;
-		break;
-	case AD77681_MCLK_DIV_8:
-		mclk_div = 8;
-		break;
-	case AD77681_MCLK_DIV_4:
-		mclk_div = 4;
-		break;
-	case AD77681_MCLK_DIV_2:
-		mclk_div = 2;
-		break;
-	default:
+	/* ODR = MCLK / (MCLK_DIV * 32 * (SINC3_DEC_RATE + 1)) */
+	mclk_hz = (uint32_t)dev->mclk * 1000;
+	/* Sinc3 oversamplig register has 13 bits, biggest value = 8192 */
+	if (odr_mhz < no_os_sd_odr_div(mclk_hz, 32 * mclk_div, 8193))
 		return -1;
-	}
 
-	odr = ((float)(dev->mclk * 1000.0) / (sinc3_odr * (float)(32 * mclk_div))) - 1;
-
-	/* Sinc3 oversamplig register has 13 bits, biggest value = 8192 */
-	if (odr < 8193)
-		*sinc3_dec_reg = (uint16_t)(odr);
-	else
+	if (no_os_sd_odr_div_plan(mclk_hz, 32 * mclk_div, 1, 8193, odr_mhz,
+				  &osr))
 		return -1;
 
+	*sinc3_dec_reg = osr - 1;
+
 	return 0;
 }
 
+/**
+ * Get SINC3 filter oversampling ratio register value based on user's inserted
+ * output data rate ODR
+ * @param dev - The device structure.
+ * @param sinc3_dec_reg - Returned closest value of SINC3 register
+ * @param sinc3_odr - Desired output data rage
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad77681_SINC3_ODR(struct ad77681_dev *dev,
+			  uint16_t *sinc3_dec_reg,
+			  float sinc3_odr)
+{
+	if (sinc3_odr <= 0)
+		return -1;
+
+	return ad77681_sinc3_odr_mhz(dev, sinc3_dec_reg,
+				     (uint32_t)(sinc3_odr * 1000));
+}
+
 /**
  * Set the power consumption mode of the ADC core.
  * @param dev - The device structure.
@@ -1136,28 +1147,171 @@ int32_t ad77681_apply_gain(struct ad77681_dev *dev,
 }
 
 /**
- * Upload sequence for Programmamble FIR filter
+ * Convert the programmable FIR coefficients to the COEFF_DATA write frames.
+ * Done once per filter, the result can be kept and uploaded any number of
+ * times with ad77681_fir_upload().
+ * @param fir - The converted coefficients.
+ * @param coeffs - Coefficients scaled by 2^22, in the range of a 24-bit signed
+ *		   value.
+ * @param num_coeffs - Count of active filter coeffs, at most 56. Zeros are
+ *		       padded before the coefficients when there are less.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad77681_fir_coeffs_pack(struct ad77681_fir_coeffs *fir,
+				const int32_t *coeffs,
+				uint8_t num_coeffs)
+{
+	uint8_t pad, i;
+	int32_t coeff;
+
+	if (!fir || (!coeffs && num_coeffs) ||
+	    num_coeffs > AD77681_FIR_NB_COEFFS)
+		return -EINVAL;
+
+	pad = AD77681_FIR_NB_COEFFS - num_coeffs;
+	for (i = 0; i < AD77681_FIR_NB_COEFFS; i++) {
+		coeff = (i < pad) ? 0 : coeffs[i - pad];
+		if (coeff < -(1 << 23) || coeff >= (1 << 23))
+			return -EINVAL;
+
+		fir->data[i][0] = AD77681_REG_WRITE(AD77681_REG_COEFF_DATA);
+		fir->data[i][1] = (coeff & 0xFF0000) >> 16;
+		fir->data[i][2] = (coeff & 0x00FF00) >> 8;
+		fir->data[i][3] = (coeff & 0x0000FF);
+		/* Only sent when the CRC is enabled on the interface */
+		fir->data[i][4] = ad77681_compute_crc8(fir->data[i], 4,
+						       INITIAL_CRC);
+	}
+
+	return 0;
+}
+
+/**
+ * Convert floating point programmable FIR coefficients to the COEFF_DATA
+ * write frames.
+ * @param fir - The converted coefficients.
+ * @param coeffs - Pointer to the desired filter coefficients array.
+ * @param num_coeffs - Count of active filter coeffs, at most 56.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad77681_fir_coeffs_from_float(struct ad77681_fir_coeffs *fir,
+				      const float *coeffs,
+				      uint8_t num_coeffs)
+{
+	int32_t scaled[AD77681_FIR_NB_COEFFS];
+	/* Scaling factor for all coefficients 2^22 */
+	const float coeff_scale_factor = (1 << 22);
+	uint8_t i;
+
+	if (!coeffs || num_coeffs > AD77681_FIR_NB_COEFFS)
+		return -EINVAL;
+
+	for (i = 0; i < num_coeffs; i++)
+		scaled[i] = (int32_t)(coeffs[i] * coeff_scale_factor);
+
+	return ad77681_fir_coeffs_pack(fir, scaled, num_coeffs);
+}
+
+/**
+ * Write the coefficient frames, AD77681_FIR_BURST coefficients per SPI
+ * transfer. Each coefficient takes a COEFF_CONTROL and a COEFF_DATA frame,
+ * the chip select is toggled and Twait is waited between all the frames by
+ * the SPI interface, through the cs_change_delay of the messages.
  * @param dev - The device structure.
- * @param coeffs - Pointer to the desired filter coefficients array to be written
- * @param num_coeffs - Count of active filter coeffs
+ * @param fir - The converted coefficients.
+ * @param twait - Wait time in uS between the accesses to the coefficients.
  * @return 0 in case of success, negative error code otherwise.
  */
-int32_t ad77681_programmable_filter(struct ad77681_dev *dev,
-				    const float *coeffs,
-				    uint8_t num_coeffs)
+static int32_t ad77681_fir_write_coeffs(struct ad77681_dev *dev,
+					const struct ad77681_fir_coeffs *fir,
+					uint32_t twait)
+{
+	struct no_os_spi_msg msgs[2 * AD77681_FIR_BURST] = { 0 };
+	uint8_t ctrl[AD77681_FIR_BURST][3];
+	uint8_t data[AD77681_FIR_BURST][5];
+	uint8_t crc_len = (dev->crc_sel == AD77681_NO_CRC) ? 0 : 1;
+	uint8_t i, j, n;
+	int32_t ret;
+
+	for (i = 0; i < AD77681_FIR_NB_COEFFS; i += n) {
+		n = no_os_min(AD77681_FIR_BURST, AD77681_FIR_NB_COEFFS - i);
+		for (j = 0; j < n; j++) {
+			/* Coefficient address, with write and access enabled */
+			ctrl[j][0] =
+				AD77681_REG_WRITE(AD77681_REG_COEFF_CONTROL);
+			ctrl[j][1] = AD77681_COEF_CONTROL_COEFFACCESSEN_MSK |
+				     AD77681_COEF_CONTROL_COEFFWRITEEN_MSK |
+				     (i + j);
+			ctrl[j][2] = ad77681_compute_crc8(ctrl[j], 2,
+							  INITIAL_CRC);
+			/* The frames may be overwritten by the received data */
+			memcpy(data[j], fir->data[i + j], sizeof(data[j]));
+
+			msgs[2 * j].tx_buff = ctrl[j];
+			msgs[2 * j].rx_buff = ctrl[j];
+			msgs[2 * j].bytes_number = 2 + crc_len;
+			msgs[2 * j + 1].tx_buff = data[j];
+			msgs[2 * j + 1].rx_buff = data[j];
+			msgs[2 * j + 1].bytes_number = 4 + crc_len;
+		}
+		for (j = 0; j < 2 * n; j++) {
+			msgs[j].cs_change = 1;
+			msgs[j].cs_change_delay = twait;
+		}
+
+		ret = no_os_spi_transfer(dev->spi_desc, msgs, 2 * n);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+/**
+ * Upload sequence for Programmamble FIR filter, with coefficients converted
+ * by ad77681_fir_coeffs_pack() or ad77681_fir_coeffs_from_float().
+ * With verify set, the SPI and the coefficient RAM CRC errors are checked
+ * once, after the upload, instead of reading the coefficients back. Each frame
+ * carries its CRC when the CRC is enabled on the interface, see
+ * ad77681_set_crc_sel().
+ * @param dev - The device structure.
+ * @param fir - The converted coefficients.
+ * @param verify - Check the diagnostic status after the upload.
+ * @return 0 in case of success, -EIO in case the device reported an error
+ *	   during the upload, negative error code otherwise.
+ */
+int32_t ad77681_fir_upload(struct ad77681_dev *dev,
+			   const struct ad77681_fir_coeffs *fir,
+			   bool verify)
 {
-	uint8_t coeffs_buf[4], coeffs_index, check_back = 0, i, address;
+	uint8_t coeffs_buf[4], check_back = 0, spi_status[3], dig_status[3];
 	uint32_t twait;
-	int32_t twos_complement, ret;
-	const uint8_t coeff_reg_length = 56;
+	int32_t ret;
 
 	/* Specific keys in the upload sequence */
 	const uint8_t key1 = 0xAC, key2 = 0x45, key3 = 0x55;
-	/* Scaling factor for all coefficients 2^22 */
-	const float coeff_scale_factor = (1 << 22);
+
+	if (!dev || !fir || !dev->mclk)
+		return -EINVAL;
+
 	/* Wait time in uS necessary to access the COEFF_CONTROL and */
 	/* COEFF_DATA registers. Twait = 512/MCLK */
-	twait = (uint32_t)(((512.0) / ((float)(dev->mclk))) * 1000.0) + 1;
+	twait = 512000 / dev->mclk + 1;
+
+	if (verify) {
+		/* Enable the coefficient RAM CRC check and clear the errors */
+		ret = ad77681_spi_write_mask(dev, AD77681_REG_DIG_DIAG_ENABLE,
+					     AD77681_DIG_DIAG_ERR_RAM_CRC_MSK,
+					     AD77681_DIG_DIAG_ERR_RAM_CRC(1));
+		if (ret < 0)
+			return ret;
+
+		ret = ad77681_spi_reg_write(dev, AD77681_REG_SPI_DIAG_STATUS,
+					    AD77681_SPI_CRC_ERROR_CLR(1) |
+					    AD77681_SPI_WRITE_ERROR_CLR(1));
+		if (ret < 0)
+			return ret;
+	}
 
 	/* Set Filter to FIR */
 	ret = ad77681_spi_write_mask(dev,
@@ -1199,57 +1353,10 @@ int32_t ad77681_programmable_filter(struct ad77681_dev *dev,
 	if ((ret < 0) || (check_back != 1))
 		return -1;
 
-	/* Set the initial adress to 0 and enable the  write and coefficient access bits */
-	address = AD77681_COEF_CONTROL_COEFFACCESSEN_MSK
-		  | AD77681_COEF_CONTROL_COEFFWRITEEN_MSK;
-
-	/* The COEFF_DATA register has to be filled with 56 coeffs.*/
-	/* In case the number of active filter coefficient is less */
-	/* than 56, zeros will be padded before the desired coeff. */
-	for (i = 0; i < coeff_reg_length; i++) {
-		/* Set the coeff address */
-		ret = ad77681_spi_reg_write(dev,
-					    AD77681_REG_COEFF_CONTROL,
-					    address);
-
-		/* Check return value before proceeding */
-		if (ret < 0)
-			return ret;
-
-		/* Wait for Twait uSeconds*/
-		no_os_udelay(twait);
-
-		/* Padding of zeros before the desired coef in case the coef count in less than 56 */
-		if((num_coeffs + i) < coeff_reg_length) {
-			/* wirte zeroes to COEFF_DATA, in case of less coeffs than 56*/
-			coeffs_buf[0] = AD77681_REG_WRITE(AD77681_REG_COEFF_DATA);
-			coeffs_buf[1] = 0;
-			coeffs_buf[2] = 0;
-			coeffs_buf[3] = 0;
-		} else {/* Writting of desired filter coefficients */
-			/* Computes the index of coefficients to be uploaded */
-			coeffs_index = (num_coeffs + i) - coeff_reg_length;
-			/* Scaling the coefficient value and converting it to 2's complement */
-			twos_complement = (int32_t)(coeffs[coeffs_index] * coeff_scale_factor);
-
-			/* Write coefficients to COEFF_DATA */
-			coeffs_buf[0] = AD77681_REG_WRITE(AD77681_REG_COEFF_DATA);
-			coeffs_buf[1] = (twos_complement & 0xFF0000) >> 16;
-			coeffs_buf[2] = (twos_complement & 0x00FF00) >> 8;
-			coeffs_buf[3] = (twos_complement & 0x0000FF);
-		}
-
-		ret = no_os_spi_write_and_read(dev->spi_desc, coeffs_buf, 4);
-
-		/* Check return value before proceeding */
-		if (ret < 0)
-			return ret;
-
-		/* Increment the address*/
-		address++;
-		/* Wait for Twait uSeconds*/
-		no_os_udelay(twait);
-	}
+	/* Write the 56 coeffs, the last frame is followed by Twait */
+	ret = ad77681_fir_write_coeffs(dev, fir, twait);
+	if (ret)
+		return ret;
 
 	/* Disable coefficient write */
 	ret = ad77681_spi_write_mask(dev,
@@ -1296,10 +1403,52 @@ int32_t ad77681_programmable_filter(struct ad77681_dev *dev,
 	if (ret < 0)
 		return ret;
 
+	if (verify) {
+		ret = ad77681_spi_reg_read(dev, AD77681_REG_SPI_DIAG_STATUS,
+					   spi_status);
+		if (ret < 0)
+			return ret;
+
+		ret = ad77681_spi_reg_read(dev, AD77681_REG_DIG_DIAG_STATUS,
+					   dig_status);
+		if (ret < 0)
+			return ret;
+
+		/* The value read is in the second byte of the frame */
+		if ((spi_status[1] & (AD77681_SPI_CRC_ERROR_MSK |
+				      AD77681_SPI_WRITE_ERROR_MSK)) ||
+		    (dig_status[1] & AD77681_DIG_RAM_CRC_ERROR_MSK))
+			return -EIO;
+	}
+
 	/* Send synchronization pulse */
 	ad77681_initiate_sync(dev);
 
-	return ret;
+	return 0;
+}
+
+/**
+ * Upload sequence for Programmamble FIR filter
+ * Converts the coefficients on each call, keep the result of
+ * ad77681_fir_coeffs_from_float() and use ad77681_fir_upload() to swap
+ * filters without the conversion.
+ * @param dev - The device structure.
+ * @param coeffs - Pointer to the desired filter coefficients array to be written
+ * @param num_coeffs - Count of active filter coeffs
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad77681_programmable_filter(struct ad77681_dev *dev,
+				    const float *coeffs,
+				    uint8_t num_coeffs)
+{
+	struct ad77681_fir_coeffs fir;
+	int32_t ret;
+
+	ret = ad77681_fir_coeffs_from_float(&fir, coeffs, num_coeffs);
+	if (ret)
+		return ret;
+
+	return ad77681_fir_upload(dev, &fir, false);
 }
 
 /**
@@ -342,6 +342,11 @@
 /* Half scale of the AD7768-1 = 2^23 = 8388608 */
 #define AD7768_HALF_SCALE						(1 << (AD7768_N_BITS - 1))
 
+/* Number of coefficients of the programmable FIR filter */
+#define AD77681_FIR_NB_COEFFS					56
+/* Coefficients written per SPI transfer during the FIR upload */
+#define AD77681_FIR_BURST						8
+
 #define ENABLE		1
 #define DISABLE		0
 
@@ -525,6 +530,16 @@ struct ad77681_status_registers {
 	bool							fuse_crc_error;
 };
 
+/**
+ * @struct ad77681_fir_coeffs
+ * @brief Programmable FIR coefficients, converted to the COEFF_DATA write
+ * frames for the upload.
+ */
+struct ad77681_fir_coeffs {
+	/* Command, 24-bit coefficient and CRC-8 of the frame */
+	uint8_t data[AD77681_FIR_NB_COEFFS][5];
+};
+
 struct ad77681_dev {
 	/* SPI */
 	struct no_os_spi_desc			*spi_desc;
@@ -618,6 +633,15 @@ int32_t ad77681_set_convlen(struct ad77681_dev *dev,
 			    enum ad77681_conv_len conv_len);
 int32_t ad77681_soft_reset(struct ad77681_dev *dev);
 int32_t ad77681_initiate_sync(struct ad77681_dev *dev);
+int32_t ad77681_fir_coeffs_pack(struct ad77681_fir_coeffs *fir,
+				const int32_t *coeffs,
+				uint8_t num_coeffs);
+int32_t ad77681_fir_coeffs_from_float(struct ad77681_fir_coeffs *fir,
+				      const float *coeffs,
+				      uint8_t num_coeffs);
+int32_t ad77681_fir_upload(struct ad77681_dev *dev,
+			   const struct ad77681_fir_coeffs *fir,
+			   bool verify);
 int32_t ad77681_programmable_filter(struct ad77681_dev *dev,
 				    const float *coeffs,
 				    uint8_t num_coeffs);
@@ -676,6 +700,9 @@ int32_t ad77681_update_sample_rate(struct ad77681_dev *dev);
 int32_t ad77681_SINC3_ODR(struct ad77681_dev *dev,
 			  uint16_t *sinc3_dec_reg,
 			  float sinc3_odr);
+int32_t ad77681_sinc3_odr_mhz(struct ad77681_dev *dev,
+			      uint16_t *sinc3_dec_reg,
+			      uint32_t odr_mhz);
 int32_t ad77681_status(struct ad77681_dev *dev,
 		       struct ad77681_status_registers *status);
 #endif /* SRC_AD77681_H_ */
@@ -109,6 +109,11 @@
 
 #define AD7768_RESOLUTION					24
 
+/* Header byte of the data interface, sent before each 24-bit result */
+#define AD7768_HDR_ERROR_FLAG				(1 << 7)
+#define AD7768_HDR_CH_ID(x)				(((x) >> 4) & 0x7)
+#define AD7768_HDR_RESET_DETECTED			(1 << 3)
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -0,0 +1,396 @@
+/***************************************************************************//**
+ *   @file   iio_ad7768.c
+ *   @brief  Implementation of the AD7768 IIO driver.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stddef.h>
+#include <stdlib.h>
+#include <errno.h>
+#include "ad7768.h"
+#include "iio_ad7768.h"
+#include "no_os_util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+/* DOUT words of a frame, one per channel */
+#define AD7768_IIO_FRAME_WORDS		AD7768_CH_NO
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+/**
+ * @brief Handles the read request for the stream counters.
+ * @param dev     - The iio device structure.
+ * @param buf     - Command buffer to be filled with requested data.
+ * @param len     - Length of the received command buffer in bytes.
+ * @param channel - Command channel info.
+ * @param priv    - Offset of the counter in struct ad7768_iio_dev.
+ * @return The size of the read data in case of success, negative error code
+ * otherwise.
+ */
+static int ad7768_iio_read_counter(void *dev, char *buf, uint32_t len,
+				   const struct iio_ch_info *channel,
+				   intptr_t priv)
+{
+	int32_t val = *(uint32_t *)((uint8_t *)dev + priv);
+
+	return iio_format_value(buf, len, IIO_VAL_INT, 1, &val);
+}
+
+/**
+ * @brief TDM callback, from interrupt context, of a filled half of the ring.
+ * The platform driver already invalidated its data cache.
+ * @param ctx        - The iio device structure.
+ * @param data       - The filled half.
+ * @param nb_samples - Number of samples in data.
+ */
+static void ad7768_iio_tdm_half(void *ctx, void *data, uint32_t nb_samples)
+{
+	struct ad7768_iio_dev *desc = ctx;
+
+	desc->head++;
+}
+
+/**
+ * @brief DMAC callback, from interrupt context, of a filled segment.
+ * @param ctx  - The iio device structure.
+ * @param addr - Address of the segment.
+ * @param size - Size of the segment, in bytes.
+ */
+static void ad7768_iio_segment_done(void *ctx, uint32_t addr, uint32_t size)
+{
+	struct ad7768_iio_dev *desc = ctx;
+
+	if (desc->dcache_invalidate_range)
+		desc->dcache_invalidate_range(addr, size);
+
+	desc->head++;
+}
+
+/**
+ * @brief Start receiving the frames, kept running while the buffer is
+ * enabled so that there is no gap between the submits.
+ * @param dev  - The iio device structure.
+ * @param mask - Channels enabled in the buffer.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad7768_iio_pre_enable(void *dev, uint32_t mask)
+{
+	struct ad7768_iio_dev *desc = dev;
+
+	if (!mask)
+		return -EINVAL;
+
+	desc->mask = mask;
+	desc->head = 0;
+	desc->tail = 0;
+	desc->pos = 0;
+	desc->overruns = 0;
+	desc->header_errors = 0;
+	desc->adc_errors = 0;
+
+	if (desc->tdm_desc)
+		return no_os_tdm_read_start(desc->tdm_desc, desc->ring,
+					    desc->nb_segments *
+					    desc->segment_frames *
+					    AD7768_IIO_FRAME_WORDS,
+					    ad7768_iio_tdm_half, desc);
+
+	return axi_dmac_stream_start(desc->rx_dmac, (uintptr_t)desc->ring,
+				     desc->segment_frames *
+				     AD7768_IIO_FRAME_WORDS * sizeof(uint32_t),
+				     desc->nb_segments,
+				     ad7768_iio_segment_done, desc);
+}
+
+/**
+ * @brief Stop receiving the frames.
+ * @param dev - The iio device structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad7768_iio_post_disable(void *dev)
+{
+	struct ad7768_iio_dev *desc = dev;
+
+	desc->mask = 0;
+
+	if (desc->tdm_desc)
+		return no_os_tdm_stop(desc->tdm_desc);
+
+	axi_dmac_stream_stop(desc->rx_dmac);
+
+	return 0;
+}
+
+/**
+ * @brief Check the headers of a frame and extract the results of the
+ * enabled channels.
+ * @param desc  - The iio device structure.
+ * @param frame - The DOUT words of the 8 channels.
+ * @param scan  - The results of the enabled channels, in channel order.
+ * @return true if the frame is valid, false if a channel ID is wrong, as
+ * after a slip of the frame alignment.
+ */
+static bool ad7768_iio_frame_to_scan(struct ad7768_iio_dev *desc,
+				     const uint32_t *frame, uint32_t *scan)
+{
+	uint32_t errors = 0;
+	uint8_t ch, hdr;
+
+	for (ch = 0; ch < AD7768_IIO_FRAME_WORDS; ch++) {
+		hdr = frame[ch] >> 24;
+		if (AD7768_HDR_CH_ID(hdr) != ch)
+			return false;
+
+		errors |= hdr & AD7768_HDR_ERROR_FLAG;
+		if (desc->mask & NO_OS_BIT(ch))
+			*scan++ = frame[ch] & NO_OS_GENMASK(23, 0);
+	}
+
+	if (errors)
+		desc->adc_errors++;
+
+	return true;
+}
+
+/**
+ * @brief Fill the IIO buffer with the received frames, the segments of the
+ * ring being pushed as the DMA fills them.
+ * @param dev_data - IIO device data.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad7768_iio_submit(struct iio_device_data *dev_data)
+{
+	struct ad7768_iio_dev *desc = dev_data->dev;
+	struct iio_buffer *buffer = dev_data->buffer;
+	uint32_t nb_scans = buffer->size / buffer->bytes_per_scan;
+	uint32_t scan[AD7768_CH_NO];
+	const uint32_t *frame;
+	uint32_t head, i;
+	int32_t ret;
+
+	while (nb_scans) {
+		head = desc->head;
+		if (head == desc->tail)
+			continue;
+
+		/* The DMA is writing the segment after head - 1 */
+		if (head - desc->tail > 1) {
+			desc->overruns += head - desc->tail - 1;
+			desc->tail = head - 1;
+			desc->pos = 0;
+		}
+
+		i = desc->tail % desc->nb_segments * desc->segment_frames +
+		    desc->pos;
+		frame = desc->ring + i * AD7768_IIO_FRAME_WORDS;
+		while (nb_scans && desc->pos < desc->segment_frames) {
+			desc->pos++;
+			if (ad7768_iio_frame_to_scan(desc, frame, scan)) {
+				ret = iio_buffer_push_scan(buffer, scan);
+				if (ret)
+					return ret;
+				nb_scans--;
+			} else {
+				desc->header_errors++;
+			}
+			frame += AD7768_IIO_FRAME_WORDS;
+		}
+
+		/* The rest of a partly pushed segment is for the next submit */
+		if (desc->pos == desc->segment_frames) {
+			desc->pos = 0;
+			desc->tail++;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Read a register of the device.
+ * @param dev     - The iio device structure.
+ * @param reg     - Register address.
+ * @param readval - Register value.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad7768_iio_reg_read(void *dev, uint32_t reg, uint32_t *readval)
+{
+	struct ad7768_iio_dev *desc = dev;
+	uint8_t data;
+	int32_t ret;
+
+	ret = ad7768_spi_read(desc->ad7768_dev, reg, &data);
+	if (ret)
+		return ret;
+
+	*readval = data;
+
+	return 0;
+}
+
+/**
+ * @brief Write a register of the device.
+ * @param dev      - The iio device structure.
+ * @param reg      - Register address.
+ * @param writeval - Register value.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad7768_iio_reg_write(void *dev, uint32_t reg, uint32_t writeval)
+{
+	struct ad7768_iio_dev *desc = dev;
+
+	return ad7768_spi_write(desc->ad7768_dev, reg, writeval);
+}
+
+static struct iio_attribute ad7768_iio_debug_attrs[] = {
+	{
+		.name = "stream_overruns",
+		.show = ad7768_iio_read_counter,
+		.priv = offsetof(struct ad7768_iio_dev, overruns),
+	},
+	{
+		.name = "stream_header_errors",
+		.show = ad7768_iio_read_counter,
+		.priv = offsetof(struct ad7768_iio_dev, header_errors),
+	},
+	{
+		.name = "stream_adc_errors",
+		.show = ad7768_iio_read_counter,
+		.priv = offsetof(struct ad7768_iio_dev, adc_errors),
+	},
+	END_ATTRIBUTES_ARRAY,
+};
+
+static struct scan_type ad7768_iio_scan_type = {
+	.sign = 's',
+	.realbits = AD7768_RESOLUTION,
+	.storagebits = 32,
+	.is_big_endian = false,
+};
+
+#define AD7768_IIO_CHANNEL(_idx) { \
+	.ch_type = IIO_VOLTAGE, \
+	.channel = _idx, \
+	.scan_index = _idx, \
+	.indexed = true, \
+	.scan_type = &ad7768_iio_scan_type, \
+}
+
+static struct iio_channel ad7768_iio_channels[] = {
+	AD7768_IIO_CHANNEL(0),
+	AD7768_IIO_CHANNEL(1),
+	AD7768_IIO_CHANNEL(2),
+	AD7768_IIO_CHANNEL(3),
+	AD7768_IIO_CHANNEL(4),
+	AD7768_IIO_CHANNEL(5),
+	AD7768_IIO_CHANNEL(6),
+	AD7768_IIO_CHANNEL(7),
+};
+
+/**
+ * @brief Initializes the AD7768 iio driver.
+ * @param iio_dev    - The iio device structure.
+ * @param init_param - The structure that contains the device initial
+ *                     parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int ad7768_iio_init(struct ad7768_iio_dev **iio_dev,
+		    struct ad7768_iio_init_param *init_param)
+{
+	struct ad7768_iio_dev *desc;
+
+	if (!init_param || !init_param->ad7768_dev ||
+	    !init_param->segment_frames)
+		return -EINVAL;
+
+	if (!init_param->tdm_desc == !init_param->rx_dmac)
+		return -EINVAL;
+
+	desc = (struct ad7768_iio_dev *)calloc(1, sizeof(*desc));
+	if (!desc)
+		return -ENOMEM;
+
+	desc->ad7768_dev = init_param->ad7768_dev;
+	desc->tdm_desc = init_param->tdm_desc;
+	desc->rx_dmac = init_param->rx_dmac;
+	desc->dcache_invalidate_range = init_param->dcache_invalidate_range;
+	desc->segment_frames = init_param->segment_frames;
+	/* The TDM circular read reports the halves of its buffer */
+	desc->nb_segments = desc->tdm_desc ? 2 : AD7768_IIO_DMAC_SEGMENTS;
+
+	desc->ring = calloc(desc->nb_segments * desc->segment_frames *
+			    AD7768_IIO_FRAME_WORDS, sizeof(uint32_t));
+	if (!desc->ring) {
+		free(desc);
+		return -ENOMEM;
+	}
+
+	desc->iio_dev = (struct iio_device) {
+		.num_ch = NO_OS_ARRAY_SIZE(ad7768_iio_channels),
+		.channels = ad7768_iio_channels,
+		.debug_attributes = ad7768_iio_debug_attrs,
+		.pre_enable = ad7768_iio_pre_enable,
+		.post_disable = ad7768_iio_post_disable,
+		.submit = ad7768_iio_submit,
+		.debug_reg_read = ad7768_iio_reg_read,
+		.debug_reg_write = ad7768_iio_reg_write,
+	};
+
+	*iio_dev = desc;
+
+	return 0;
+}
+
+/**
+ * @brief Free the resources allocated by ad7768_iio_init().
+ * @param desc - The IIO device structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int ad7768_iio_remove(struct ad7768_iio_dev *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	free(desc->ring);
+	free(desc);
+
+	return 0;
+}
@@ -0,0 +1,121 @@
+/***************************************************************************//**
+ *   @file   iio_ad7768.h
+ *   @brief  Header file of the AD7768 IIO driver.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef __IIO_AD7768_H__
+#define __IIO_AD7768_H__
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include "iio.h"
+#include "ad7768.h"
+#include "no_os_tdm.h"
+#include "axi_dmac.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+/* Segments of the ring filled by the AXI DMAC */
+#define AD7768_IIO_DMAC_SEGMENTS	4
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+/**
+ * @struct ad7768_iio_dev
+ * @brief AD7768 IIO device. A frame is the 32-bit DOUT word (header byte and
+ * 24-bit result) of each of the 8 channels, in channel order. The frames are
+ * received continuously into a ring of segments, from the TDM interface
+ * (DOUT0 carrying all the channels, 8 slots of 32 bits) or from the AXI DMAC
+ * of the FPGA data capture core, and de-interleaved into scans by submit.
+ */
+struct ad7768_iio_dev {
+	/** AD7768 device descriptor */
+	ad7768_dev		*ad7768_dev;
+	/** IIO device descriptor */
+	struct iio_device	iio_dev;
+	/** TDM descriptor, NULL when capturing through the AXI DMAC */
+	struct no_os_tdm_desc	*tdm_desc;
+	/** RX DMAC, initialized with IRQ_ENABLED, when there is no tdm_desc */
+	struct axi_dmac		*rx_dmac;
+	/** Invalidate the data cache for the given address range */
+	void (*dcache_invalidate_range)(uint32_t address, uint32_t bytes_count);
+	/** Ring of nb_segments * segment_frames frames */
+	uint32_t		*ring;
+	uint32_t		segment_frames;
+	uint32_t		nb_segments;
+	/** Segments filled by the DMA and segments pushed to the IIO buffer */
+	volatile uint32_t	head;
+	uint32_t		tail;
+	/** Frames of the tail segment already pushed */
+	uint32_t		pos;
+	/** Channels enabled in the buffer */
+	uint32_t		mask;
+	/** Segments overwritten before being pushed */
+	uint32_t		overruns;
+	/** Frames dropped because a header had the wrong channel ID */
+	uint32_t		header_errors;
+	/** Frames with the error flag of a header set */
+	uint32_t		adc_errors;
+};
+
+/**
+ * @struct ad7768_iio_init_param
+ * @brief AD7768 IIO initialization parameters. One of tdm_desc and rx_dmac
+ * is needed.
+ */
+struct ad7768_iio_init_param {
+	/** AD7768 device descriptor, from ad7768_setup() */
+	ad7768_dev		*ad7768_dev;
+	/** TDM descriptor, 8 slots of 32 bits per frame */
+	struct no_os_tdm_desc	*tdm_desc;
+	/** RX DMAC of the FPGA data capture core */
+	struct axi_dmac		*rx_dmac;
+	/** Invalidate the data cache for the given address range, AXI only */
+	void (*dcache_invalidate_range)(uint32_t address, uint32_t bytes_count);
+	/** Frames of a ring segment, a whole number of cache lines */
+	uint32_t		segment_frames;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+int ad7768_iio_init(struct ad7768_iio_dev **iio_dev,
+		    struct ad7768_iio_init_param *init_param);
+int ad7768_iio_remove(struct ad7768_iio_dev *desc);
+
+#endif /* __IIO_AD7768_H__ */
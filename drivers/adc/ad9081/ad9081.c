@@ -1109,7 +1109,14 @@ int32_t ad9081_init(struct ad9081_phy **dev,
 		goto error_3;
 	}
 
+	/* Write the bitfields of a register set back to back only once */
+	ret = adi_ad9081_hal_bf_coalesce_set(&phy->ad9081, 1);
+	if (ret < 0)
+		goto error_3;
+
 	ret = ad9081_setup(phy);
+	if (adi_ad9081_hal_bf_coalesce_set(&phy->ad9081, 0) < 0 && !ret)
+		ret = -1;
 	if (ret < 0) {
 		printf("%s: ad9081_setup failed (%"PRId32")\n", __func__, ret);
 		goto error_3;
@@ -1151,3 +1158,174 @@ int32_t ad9081_remove(struct ad9081_phy *dev)
 
 	return ret;
 }
+
+/**
+ * Get the number of profiles of a fast frequency hopping path.
+ * @param path - The hopping path.
+ * @return the number of profiles, 0 for an invalid path.
+ */
+static uint8_t ad9081_ffh_nb_profiles(enum ad9081_ffh_path path)
+{
+	switch (path) {
+	case AD9081_FFH_RX_COARSE:
+	case AD9081_FFH_RX_FINE:
+		return AD9081_FFH_RX_PROFILES;
+	case AD9081_FFH_TX_MAIN:
+		return AD9081_FFH_TX_PROFILES;
+	default:
+		return 0;
+	}
+}
+
+/**
+ * Load the NCO shift of a fast frequency hopping profile, without changing the
+ * profile in use. The frequency tuning word is computed and written here, so
+ * that hopping afterwards only selects the profile.
+ * @param phy - The device structure.
+ * @param path - The hopping path.
+ * @param mask - Coarse DDCs, fine DDCs or DACs mask, depending on path.
+ * @param profile - NCO channel of the DDCs (0 ~ 15) or hopping frequency
+ * 		    index of the DACs (0 ~ 31, 0 being the main NCO
+ * 		    frequency).
+ * @param shift_hz - NCO shift in Hz.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9081_ffh_profile_set(struct ad9081_phy *phy,
+			       enum ad9081_ffh_path path, uint8_t mask,
+			       uint8_t profile, int64_t shift_hz)
+{
+	uint64_t ftw;
+	int32_t ret;
+
+	if (!phy || profile >= ad9081_ffh_nb_profiles(path))
+		return -EINVAL;
+
+	switch (path) {
+	case AD9081_FFH_RX_COARSE:
+		ret = adi_ad9081_adc_ddc_coarse_nco_channel_update_index_set(
+			      &phy->ad9081, mask, profile);
+		if (ret != 0)
+			return ret;
+		ret = adi_ad9081_adc_ddc_coarse_nco_set(&phy->ad9081, mask,
+							shift_hz);
+		break;
+	case AD9081_FFH_RX_FINE:
+		ret = adi_ad9081_adc_ddc_fine_nco_channel_update_index_set(
+			      &phy->ad9081, mask, profile);
+		if (ret != 0)
+			return ret;
+		ret = adi_ad9081_adc_ddc_fine_nco_set(&phy->ad9081, mask,
+						      shift_hz);
+		break;
+	default:
+		if (!profile) {
+			ret = adi_ad9081_dac_duc_nco_set(&phy->ad9081, mask,
+							 AD9081_DAC_CH_NONE,
+							 shift_hz);
+			break;
+		}
+		ret = adi_ad9081_hal_calc_tx_nco_ftw32(&phy->ad9081,
+						       phy->dac_frequency_hz,
+						       shift_hz, &ftw);
+		if (ret != 0)
+			return ret;
+		ret = adi_ad9081_dac_duc_main_nco_hopf_ftw_set(&phy->ad9081,
+				mask, profile, (uint32_t)ftw);
+		break;
+	}
+	if (ret != 0)
+		return ret;
+
+	phy->ffh[path].shift[profile] = shift_hz;
+
+	return 0;
+}
+
+/**
+ * Hop to a profile loaded with ad9081_ffh_profile_set(). This is a single
+ * register write per DDC or for all the DACs.
+ * @param phy - The device structure.
+ * @param path - The hopping path.
+ * @param mask - Coarse DDCs, fine DDCs or DACs mask, depending on path.
+ * @param profile - The profile to use.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9081_ffh_hop(struct ad9081_phy *phy, enum ad9081_ffh_path path,
+		       uint8_t mask, uint8_t profile)
+{
+	int32_t ret;
+
+	if (!phy || profile >= ad9081_ffh_nb_profiles(path))
+		return -EINVAL;
+
+	switch (path) {
+	case AD9081_FFH_RX_COARSE:
+		ret = adi_ad9081_adc_ddc_coarse_nco_channel_selection_set(
+			      &phy->ad9081, mask, profile);
+		break;
+	case AD9081_FFH_RX_FINE:
+		ret = adi_ad9081_adc_ddc_fine_nco_channel_selection_set(
+			      &phy->ad9081, mask, profile);
+		break;
+	default:
+		ret = adi_ad9081_dac_duc_main_nco_hopf_select_set(&phy->ad9081,
+				mask, profile);
+		break;
+	}
+	if (ret != 0)
+		return ret;
+
+	phy->ffh[path].current = profile;
+
+	return 0;
+}
+
+/**
+ * Select the profile from the GPIOs instead of the register map, for hops
+ * that do not wait for a SPI transfer.
+ * @param phy - The device structure.
+ * @param path - The hopping path.
+ * @param mask - Coarse or fine DDCs mask, unused for the DACs.
+ * @param mode - For the DDCs, the profile pins mode as described by
+ * 		 adi_ad9081_adc_ddc_coarse_nco_channel_select_via_gpio_set(),
+ * 		 0 going back to the register map. For the DACs, 0 or 1 to
+ * 		 disable or enable the selection from the GPIOs.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9081_ffh_gpio_ctrl(struct ad9081_phy *phy,
+			     enum ad9081_ffh_path path, uint8_t mask,
+			     uint8_t mode)
+{
+	if (!phy)
+		return -EINVAL;
+
+	switch (path) {
+	case AD9081_FFH_RX_COARSE:
+		return adi_ad9081_adc_ddc_coarse_nco_channel_select_via_gpio_set(
+			       &phy->ad9081, mask, mode);
+	case AD9081_FFH_RX_FINE:
+		return adi_ad9081_adc_ddc_fine_nco_channel_select_via_gpio_set(
+			       &phy->ad9081, mask, mode);
+	case AD9081_FFH_TX_MAIN:
+		return adi_ad9081_dac_duc_main_nco_hopf_gpio_as_hop_en_set(
+			       &phy->ad9081, !!mode);
+	default:
+		return -EINVAL;
+	}
+}
+
+/**
+ * Map the RX FFH profile selection signals to GPIOs.
+ * @param phy - The device structure.
+ * @param map - Source of the ffh0 ~ ffh5 signals, as described by
+ * 		adi_ad9081_adc_ddc_ffh_sel_to_gpio_mapping_set().
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9081_ffh_gpio_map(struct ad9081_phy *phy, uint8_t map[6])
+{
+	if (!phy || !map)
+		return -EINVAL;
+
+	return adi_ad9081_adc_ddc_ffh_sel_to_gpio_mapping_set(&phy->ad9081,
+			map);
+}
@@ -54,6 +54,27 @@
 /******************************************************************************/
 #define MAX_NUM_MAIN_DATAPATHS	4
 #define MAX_NUM_CHANNELIZER	8
+/* NCO channels of the coarse and fine DDCs available for hopping */
+#define AD9081_FFH_RX_PROFILES	16
+/* Hopping frequency tuning words of the DAC main NCOs */
+#define AD9081_FFH_TX_PROFILES	32
+
+enum ad9081_ffh_path {
+	AD9081_FFH_RX_COARSE,
+	AD9081_FFH_RX_FINE,
+	AD9081_FFH_TX_MAIN,
+	AD9081_FFH_NUM_PATHS
+};
+
+/* Profile table of a fast frequency hopping path */
+struct ad9081_ffh_table {
+	/* Shift loaded in each profile, in Hz */
+	int64_t		shift[AD9081_FFH_TX_PROFILES];
+	/* Profile in use */
+	uint8_t		current;
+	/* Profile addressed by the IIO frequency attribute */
+	uint8_t		index;
+};
 
 struct ad9081_jesd_link {
 	bool is_jrx;
@@ -107,6 +128,8 @@ struct ad9081_phy {
 	uint8_t		rx_fddc_dcm[MAX_NUM_CHANNELIZER];
 	uint8_t 	rx_fddc_c2r[MAX_NUM_CHANNELIZER];
 	uint8_t 	rx_fddc_select;
+	/* Fast frequency hopping */
+	struct ad9081_ffh_table	ffh[AD9081_FFH_NUM_PATHS];
 };
 
 struct link_init_param {
@@ -179,4 +202,17 @@ int32_t ad9081_init(struct ad9081_phy **device,
 int32_t ad9081_remove(struct ad9081_phy *device);
 /* Work function. */
 void ad9081_work_func(struct ad9081_phy *phy);
+/* Load the NCO shift of a fast frequency hopping profile. */
+int32_t ad9081_ffh_profile_set(struct ad9081_phy *phy,
+			       enum ad9081_ffh_path path, uint8_t mask,
+			       uint8_t profile, int64_t shift_hz);
+/* Hop to a preloaded profile. */
+int32_t ad9081_ffh_hop(struct ad9081_phy *phy, enum ad9081_ffh_path path,
+		       uint8_t mask, uint8_t profile);
+/* Select the profile from the GPIOs instead of the register map. */
+int32_t ad9081_ffh_gpio_ctrl(struct ad9081_phy *phy,
+			     enum ad9081_ffh_path path, uint8_t mask,
+			     uint8_t mode);
+/* Map the RX FFH profile selection signals to GPIOs. */
+int32_t ad9081_ffh_gpio_map(struct ad9081_phy *phy, uint8_t map[6]);
 #endif
@@ -839,6 +839,14 @@ typedef struct {
 		tx_en_pin_ctrl; /*!< Function pointer to hal tx_enable pin control function */
 	adi_reset_pin_ctrl_t
 		reset_pin_ctrl; /*!< Function pointer to hal reset# pin control function */
+
+	uint8_t page_valid; /*!< page[] matches the device paging registers */
+	uint8_t page[3]; /*!< Shadow of the 0x3D21 ~ 0x3D23 paging registers */
+	uint8_t bf_coalesce; /*!< Combine the bf_set of the same register */
+	uint8_t bf_pending; /*!< bf_data is not written to bf_reg yet */
+	uint16_t bf_reg; /*!< Register of the pending combined write */
+	uint8_t bf_data; /*!< Value of the pending combined write */
+	uint8_t bf_bits; /*!< Bits set by the bitfields combined in bf_data */
 } adi_ad9081_hal_t;
 
 /*!
@@ -15,10 +15,22 @@
 /*============= I N C L U D E S ============*/
 #include "adi_ad9081_hal.h"
 
+/*============= D E F I N E S ==============*/
+#define AD9081_HAL_PAGE_REG 0x3D21
+
 /*============= C O D E ====================*/
+static int32_t adi_ad9081_hal_reg_read(adi_ad9081_device_t *device,
+				       uint32_t reg, uint8_t *data);
+static int32_t adi_ad9081_hal_reg_write(adi_ad9081_device_t *device,
+					uint32_t reg, uint32_t data);
+static int32_t adi_ad9081_hal_bf_combine(adi_ad9081_device_t *device,
+					 uint32_t reg, uint8_t offset,
+					 uint8_t width, uint64_t value);
+
 int32_t adi_ad9081_hal_hw_open(adi_ad9081_device_t *device)
 {
 	AD9081_NULL_POINTER_RETURN(device);
+	device->hal_info.page_valid = 0;
 	if (device->hal_info.hw_open != NULL) {
 		if (API_CMS_ERROR_OK !=
 		    device->hal_info.hw_open(device->hal_info.user_data))
@@ -42,8 +54,13 @@ int32_t adi_ad9081_hal_hw_close(adi_ad9081_device_t *device)
 
 int32_t adi_ad9081_hal_delay_us(adi_ad9081_device_t *device, uint32_t us)
 {
+	int32_t err;
 	AD9081_NULL_POINTER_RETURN(device);
 	AD9081_NULL_POINTER_RETURN(device->hal_info.delay_us);
+
+	/* the combined bitfields must reach the device before waiting */
+	err = adi_ad9081_hal_bf_flush(device);
+	AD9081_ERROR_RETURN(err);
 	if (API_CMS_ERROR_OK !=
 	    device->hal_info.delay_us(device->hal_info.user_data, us)) {
 		return API_CMS_ERROR_DELAY_US;
@@ -55,8 +72,13 @@ int32_t adi_ad9081_hal_delay_us(adi_ad9081_device_t *device, uint32_t us)
 int32_t adi_ad9081_hal_reset_pin_ctrl(adi_ad9081_device_t *device,
 				      uint8_t enable)
 {
+	int32_t err;
 	AD9081_NULL_POINTER_RETURN(device);
 	AD9081_NULL_POINTER_RETURN(device->hal_info.reset_pin_ctrl);
+
+	err = adi_ad9081_hal_bf_flush(device);
+	AD9081_ERROR_RETURN(err);
+	device->hal_info.page_valid = 0;
 	if (API_CMS_ERROR_OK != device->hal_info.reset_pin_ctrl(
 					device->hal_info.user_data, enable)) {
 		return API_CMS_ERROR_RESET_PIN_CTRL;
@@ -171,6 +193,11 @@ int32_t adi_ad9081_hal_bf_set(adi_ad9081_device_t *device, uint32_t reg,
 	AD9081_INVALID_PARAM_RETURN(width > 64);
 	AD9081_INVALID_PARAM_RETURN(width < 1);
 
+	if (device->hal_info.bf_coalesce && (reg < 0x4000) &&
+	    ((offset + width) <= 8))
+		return adi_ad9081_hal_bf_combine(device, reg, offset, width,
+						 value);
+
 	if (reg < 0x4000) {
 		for (reg_offset = 0; reg_offset < reg_bytes; reg_offset++) {
 			if ((offset + width) <= 8) { /* last 8bits */
@@ -236,9 +263,47 @@ int32_t adi_ad9081_hal_bf_set(adi_ad9081_device_t *device, uint32_t reg,
 	return API_CMS_ERROR_OK;
 }
 
-int32_t adi_ad9081_hal_reg_get(adi_ad9081_device_t *device, uint32_t reg,
-			       uint8_t *data)
+/*
+ * Write the paging registers of the extended space, skipping the ones already
+ * holding the page of reg.
+ */
+static int32_t adi_ad9081_hal_page_set(adi_ad9081_device_t *device,
+				       uint32_t reg)
 {
+	uint8_t in_data[3] = { 0 }, out_data[3] = { 0 };
+	uint8_t page[3], i;
+
+	page[0] = (reg >> 8) & 0xC0;
+	page[1] = (reg >> 16) & 0xFF;
+	page[2] = (reg >> 24) & 0xFF;
+
+	for (i = 0; i < 3; i++) {
+		if (device->hal_info.page_valid &&
+		    (device->hal_info.page[i] == page[i]))
+			continue;
+		in_data[0] = (AD9081_HAL_PAGE_REG + i) >> 8;
+		in_data[1] = (AD9081_HAL_PAGE_REG + i) & 0xFF;
+		in_data[2] = page[i];
+		device->hal_info.page[i] = page[i];
+		if (API_CMS_ERROR_OK !=
+		    device->hal_info.spi_xfer(device->hal_info.user_data,
+					      in_data, out_data, 0x3)) {
+			device->hal_info.page_valid = 0;
+			return API_CMS_ERROR_SPI_XFER;
+		}
+		if (API_CMS_ERROR_OK !=
+		    AD9081_LOG_SPIW(AD9081_HAL_PAGE_REG + i, in_data[2]))
+			return API_CMS_ERROR_LOG_WRITE;
+	}
+	device->hal_info.page_valid = 1;
+
+	return API_CMS_ERROR_OK;
+}
+
+static int32_t adi_ad9081_hal_reg_read(adi_ad9081_device_t *device,
+				       uint32_t reg, uint8_t *data)
+{
+	int32_t err;
 	uint8_t in_data[6] = { 0 }, out_data[6] = { 0 };
 	AD9081_NULL_POINTER_RETURN(device);
 	AD9081_NULL_POINTER_RETURN(device->hal_info.spi_xfer);
@@ -257,33 +322,8 @@ int32_t adi_ad9081_hal_reg_get(adi_ad9081_device_t *device, uint32_t reg,
 				    out_data[2]))
 			return API_CMS_ERROR_LOG_WRITE;
 	} else { /* access extended 32-bit data space */
-		in_data[0] = 0x3D;
-		in_data[1] = 0x21;
-		in_data[2] = (reg >> 8) & 0xC0;
-		if (API_CMS_ERROR_OK !=
-		    device->hal_info.spi_xfer(device->hal_info.user_data,
-					      in_data, out_data, 0x3))
-			return API_CMS_ERROR_SPI_XFER;
-		if (API_CMS_ERROR_OK != AD9081_LOG_SPIW(0x3d21, in_data[2]))
-			return API_CMS_ERROR_LOG_WRITE;
-		in_data[0] = 0x3D;
-		in_data[1] = 0x22;
-		in_data[2] = (reg >> 16) & 0xFF;
-		if (API_CMS_ERROR_OK !=
-		    device->hal_info.spi_xfer(device->hal_info.user_data,
-					      in_data, out_data, 0x3))
-			return API_CMS_ERROR_SPI_XFER;
-		if (API_CMS_ERROR_OK != AD9081_LOG_SPIW(0x3d22, in_data[2]))
-			return API_CMS_ERROR_LOG_WRITE;
-		in_data[0] = 0x3D;
-		in_data[1] = 0x23;
-		in_data[2] = (reg >> 24) & 0xFF;
-		if (API_CMS_ERROR_OK !=
-		    device->hal_info.spi_xfer(device->hal_info.user_data,
-					      in_data, out_data, 0x3))
-			return API_CMS_ERROR_SPI_XFER;
-		if (API_CMS_ERROR_OK != AD9081_LOG_SPIW(0x3d23, in_data[2]))
-			return API_CMS_ERROR_LOG_WRITE;
+		err = adi_ad9081_hal_page_set(device, reg);
+		AD9081_ERROR_RETURN(err);
 		if (((reg >= 0x4F00000) && (reg <= 0x4FFFFFF)) ||
 		    ((reg >= 0x6001000) && (reg <= 0x60010FF))) {
 			/* 32-bit address, 8-bit data */
@@ -332,14 +372,19 @@ int32_t adi_ad9081_hal_reg_get(adi_ad9081_device_t *device, uint32_t reg,
 	return API_CMS_ERROR_OK;
 }
 
-int32_t adi_ad9081_hal_reg_set(adi_ad9081_device_t *device, uint32_t reg,
-			       uint32_t data)
+static int32_t adi_ad9081_hal_reg_write(adi_ad9081_device_t *device,
+					uint32_t reg, uint32_t data)
 {
+	int32_t err;
 	uint8_t in_data[6] = { 0 }, out_data[6] = { 0 };
 	AD9081_NULL_POINTER_RETURN(device);
 	AD9081_NULL_POINTER_RETURN(device->hal_info.spi_xfer);
 
 	if (reg < 0x4000) {
+		/* direct writes to the paging registers or a soft reset */
+		if ((reg == 0x0000) || ((reg >= AD9081_HAL_PAGE_REG) &&
+					(reg <= AD9081_HAL_PAGE_REG + 2)))
+			device->hal_info.page_valid = 0;
 		in_data[0] = (reg >> 8) & 0x3F;
 		in_data[1] = (reg >> 0) & 0xFF;
 		in_data[2] = (uint8_t)(data & 0xFF);
@@ -351,33 +396,8 @@ int32_t adi_ad9081_hal_reg_set(adi_ad9081_device_t *device, uint32_t reg,
 		    AD9081_LOG_SPIW(reg & 0x3fff, in_data[2]))
 			return API_CMS_ERROR_LOG_WRITE;
 	} else { /* access extended 32-bit data space */
-		in_data[0] = 0x3D;
-		in_data[1] = 0x21;
-		in_data[2] = (reg >> 8) & 0xC0;
-		if (API_CMS_ERROR_OK !=
-		    device->hal_info.spi_xfer(device->hal_info.user_data,
-					      in_data, out_data, 0x3))
-			return API_CMS_ERROR_SPI_XFER;
-		if (API_CMS_ERROR_OK != AD9081_LOG_SPIW(0x3d21, in_data[2]))
-			return API_CMS_ERROR_LOG_WRITE;
-		in_data[0] = 0x3D;
-		in_data[1] = 0x22;
-		in_data[2] = (reg >> 16) & 0xFF;
-		if (API_CMS_ERROR_OK !=
-		    device->hal_info.spi_xfer(device->hal_info.user_data,
-					      in_data, out_data, 0x3))
-			return API_CMS_ERROR_SPI_XFER;
-		if (API_CMS_ERROR_OK != AD9081_LOG_SPIW(0x3d22, in_data[2]))
-			return API_CMS_ERROR_LOG_WRITE;
-		in_data[0] = 0x3D;
-		in_data[1] = 0x23;
-		in_data[2] = (reg >> 24) & 0xFF;
-		if (API_CMS_ERROR_OK !=
-		    device->hal_info.spi_xfer(device->hal_info.user_data,
-					      in_data, out_data, 0x3))
-			return API_CMS_ERROR_SPI_XFER;
-		if (API_CMS_ERROR_OK != AD9081_LOG_SPIW(0x3d23, in_data[2]))
-			return API_CMS_ERROR_LOG_WRITE;
+		err = adi_ad9081_hal_page_set(device, reg);
+		AD9081_ERROR_RETURN(err);
 		if (((reg >= 0x4F00000) && (reg <= 0x4FFFFFF)) ||
 		    ((reg >= 0x6001000) && (reg <= 0x60010FF))) {
 			/* 32-bit address, 8-bit data */
@@ -424,6 +444,98 @@ int32_t adi_ad9081_hal_reg_set(adi_ad9081_device_t *device, uint32_t reg,
 	return API_CMS_ERROR_OK;
 }
 
+int32_t adi_ad9081_hal_reg_get(adi_ad9081_device_t *device, uint32_t reg,
+			       uint8_t *data)
+{
+	int32_t err;
+	AD9081_NULL_POINTER_RETURN(device);
+
+	err = adi_ad9081_hal_bf_flush(device);
+	AD9081_ERROR_RETURN(err);
+
+	return adi_ad9081_hal_reg_read(device, reg, data);
+}
+
+int32_t adi_ad9081_hal_reg_set(adi_ad9081_device_t *device, uint32_t reg,
+			       uint32_t data)
+{
+	int32_t err;
+	AD9081_NULL_POINTER_RETURN(device);
+
+	err = adi_ad9081_hal_bf_flush(device);
+	AD9081_ERROR_RETURN(err);
+
+	return adi_ad9081_hal_reg_write(device, reg, data);
+}
+
+int32_t adi_ad9081_hal_bf_flush(adi_ad9081_device_t *device)
+{
+	AD9081_NULL_POINTER_RETURN(device);
+
+	if (!device->hal_info.bf_pending)
+		return API_CMS_ERROR_OK;
+
+	device->hal_info.bf_pending = 0;
+
+	return adi_ad9081_hal_reg_write(device, device->hal_info.bf_reg,
+					device->hal_info.bf_data);
+}
+
+int32_t adi_ad9081_hal_bf_coalesce_set(adi_ad9081_device_t *device,
+				       uint8_t enable)
+{
+	AD9081_NULL_POINTER_RETURN(device);
+#if AD9081_USE_SPI_BURST_MODE > 0
+	if (enable)
+		return API_CMS_ERROR_NOT_SUPPORTED;
+#endif
+	device->hal_info.bf_coalesce = enable;
+	if (!enable)
+		return adi_ad9081_hal_bf_flush(device);
+
+	return API_CMS_ERROR_OK;
+}
+
+/*
+ * Merge a bitfield of an 8-bit register in the pending write. The register is
+ * only read when its value is not known already from the pending write.
+ */
+static int32_t adi_ad9081_hal_bf_combine(adi_ad9081_device_t *device,
+					 uint32_t reg, uint8_t offset,
+					 uint8_t width, uint64_t value)
+{
+	int32_t err;
+	uint8_t mask = (uint8_t)(((1 << width) - 1) << offset);
+	uint8_t data8 = 0;
+
+	if (device->hal_info.bf_pending && (device->hal_info.bf_reg == reg)) {
+		data8 = device->hal_info.bf_data;
+		if (!(device->hal_info.bf_bits & mask)) {
+			device->hal_info.bf_data =
+				(data8 & ~mask) | ((value << offset) & mask);
+			device->hal_info.bf_bits |= mask;
+			return API_CMS_ERROR_OK;
+		}
+		/* the bitfield is written again, keep both writes */
+		err = adi_ad9081_hal_bf_flush(device);
+		AD9081_ERROR_RETURN(err);
+	} else {
+		err = adi_ad9081_hal_bf_flush(device);
+		AD9081_ERROR_RETURN(err);
+		if (mask != 0xFF) {
+			err = adi_ad9081_hal_reg_read(device, reg, &data8);
+			AD9081_ERROR_RETURN(err);
+		}
+	}
+
+	device->hal_info.bf_reg = reg;
+	device->hal_info.bf_data = (data8 & ~mask) | ((value << offset) & mask);
+	device->hal_info.bf_bits = mask;
+	device->hal_info.bf_pending = 1;
+
+	return API_CMS_ERROR_OK;
+}
+
 int32_t adi_ad9081_hal_cbusjrx_reg_get(adi_ad9081_device_t *device,
 				       uint32_t reg, uint8_t *data,
 				       uint8_t lane)
@@ -74,6 +74,32 @@ int32_t adi_ad9081_hal_bf_get(adi_ad9081_device_t *device, uint32_t reg,
 int32_t adi_ad9081_hal_bf_set(adi_ad9081_device_t *device, uint32_t reg,
 			      uint32_t info, uint64_t value);
 
+/**
+ * \brief Combine the consecutive bf_set of the same 8-bit register
+ *
+ * While enabled, bitfields written back to back to the same register are
+ * merged and written once, before the next access to another register or the
+ * next delay. A bitfield overlapping one already pending starts a new write, so
+ * each bit still sees all its values in order. Not supported together with
+ * AD9081_USE_SPI_BURST_MODE, which bypasses the HAL.
+ *
+ * \param[in]  device            Pointer to the device structure
+ * \param[in]  enable            0 to write the pending value and disable, 1 to
+ *                               enable
+ *
+ * \returns API_CMS_ERROR_OK is returned upon success. Otherwise, a failure code.
+ */
+int32_t adi_ad9081_hal_bf_coalesce_set(adi_ad9081_device_t *device,
+				       uint8_t enable);
+/**
+ * \brief Write the pending combined bitfields, if any
+ *
+ * \param[in]  device            Pointer to the device structure
+ *
+ * \returns API_CMS_ERROR_OK is returned upon success. Otherwise, a failure code.
+ */
+int32_t adi_ad9081_hal_bf_flush(adi_ad9081_device_t *device);
+
 int32_t adi_ad9081_hal_2bf_get(adi_ad9081_device_t *device, uint32_t reg,
 			       uint32_t info0, uint8_t *value0, uint32_t info1,
 			       uint8_t *value1, uint8_t value_size_bytes);
@@ -0,0 +1,242 @@
+/***************************************************************************//**
+ *   @file   iio_ad9081.c
+ *   @brief  Implementation of iio_ad9081.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifdef IIO_SUPPORT
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include "no_os_error.h"
+#include "ad9081.h"
+#include "iio_ad9081.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Index, frequency and profile attributes of a hopping path */
+#define AD9081_FFH_ATTRS(_prefix, _path) \
+	{ \
+		.name = _prefix "_index", \
+		.priv = _path, \
+		.show = get_ffh_index, \
+		.store = set_ffh_index \
+	}, \
+	{ \
+		.name = _prefix "_frequency", \
+		.priv = _path, \
+		.show = get_ffh_frequency, \
+		.store = set_ffh_frequency \
+	}, \
+	{ \
+		.name = _prefix "_profile", \
+		.priv = _path, \
+		.show = get_ffh_profile, \
+		.store = set_ffh_profile \
+	}
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Get the mask of the enabled DDCs or of all the DACs of a path.
+ * @param phy - The device structure.
+ * @param path - The hopping path.
+ * @return the mask.
+ */
+static uint8_t ad9081_iio_ffh_mask(struct ad9081_phy *phy,
+				   enum ad9081_ffh_path path)
+{
+	switch (path) {
+	case AD9081_FFH_RX_COARSE:
+		return phy->rx_cddc_select;
+	case AD9081_FFH_RX_FINE:
+		return phy->rx_fddc_select;
+	default:
+		return AD9081_DAC_ALL;
+	}
+}
+
+/**
+ * @brief Read the profile addressed by the frequency attribute.
+ * @param device - The device structure.
+ * @param buf - Where value is stored.
+ * @param len - Maximum length of value to be stored in buf.
+ * @param channel - Channel properties.
+ * @param priv - The hopping path.
+ * @return Length of chars written in buf, or negative value on failure.
+ */
+static int get_ffh_index(void *device, char *buf, uint32_t len,
+			 const struct iio_ch_info *channel, intptr_t priv)
+{
+	struct ad9081_phy *phy = device;
+
+	return snprintf(buf, len, "%"PRIu8, phy->ffh[priv].index);
+}
+
+/**
+ * @brief Set the profile addressed by the frequency attribute.
+ * @param device - The device structure.
+ * @param buf - Value to be written.
+ * @param len - Length of the data in buf.
+ * @param channel - Channel properties.
+ * @param priv - The hopping path.
+ * @return Number of bytes written, or negative value on failure.
+ */
+static int set_ffh_index(void *device, char *buf, uint32_t len,
+			 const struct iio_ch_info *channel, intptr_t priv)
+{
+	struct ad9081_phy *phy = device;
+	uint32_t max = priv == AD9081_FFH_TX_MAIN ? AD9081_FFH_TX_PROFILES :
+		       AD9081_FFH_RX_PROFILES;
+	unsigned long val = strtoul(buf, NULL, 0);
+
+	if (val >= max)
+		return -EINVAL;
+
+	phy->ffh[priv].index = val;
+
+	return len;
+}
+
+/**
+ * @brief Read the shift loaded in the addressed profile.
+ * @param device - The device structure.
+ * @param buf - Where value is stored.
+ * @param len - Maximum length of value to be stored in buf.
+ * @param channel - Channel properties.
+ * @param priv - The hopping path.
+ * @return Length of chars written in buf, or negative value on failure.
+ */
+static int get_ffh_frequency(void *device, char *buf, uint32_t len,
+			     const struct iio_ch_info *channel, intptr_t priv)
+{
+	struct ad9081_phy *phy = device;
+	struct ad9081_ffh_table *table = &phy->ffh[priv];
+
+	return snprintf(buf, len, "%"PRIi64, table->shift[table->index]);
+}
+
+/**
+ * @brief Load a shift in the addressed profile, without hopping to it.
+ * @param device - The device structure.
+ * @param buf - Value to be written.
+ * @param len - Length of the data in buf.
+ * @param channel - Channel properties.
+ * @param priv - The hopping path.
+ * @return Number of bytes written, or negative value on failure.
+ */
+static int set_ffh_frequency(void *device, char *buf, uint32_t len,
+			     const struct iio_ch_info *channel, intptr_t priv)
+{
+	struct ad9081_phy *phy = device;
+	int32_t ret;
+
+	ret = ad9081_ffh_profile_set(phy, priv, ad9081_iio_ffh_mask(phy, priv),
+				     phy->ffh[priv].index,
+				     strtoll(buf, NULL, 0));
+	if (ret)
+		return ret;
+
+	return len;
+}
+
+/**
+ * @brief Read the profile in use.
+ * @param device - The device structure.
+ * @param buf - Where value is stored.
+ * @param len - Maximum length of value to be stored in buf.
+ * @param channel - Channel properties.
+ * @param priv - The hopping path.
+ * @return Length of chars written in buf, or negative value on failure.
+ */
+static int get_ffh_profile(void *device, char *buf, uint32_t len,
+			   const struct iio_ch_info *channel, intptr_t priv)
+{
+	struct ad9081_phy *phy = device;
+
+	return snprintf(buf, len, "%"PRIu8, phy->ffh[priv].current);
+}
+
+/**
+ * @brief Hop to a preloaded profile.
+ * @param device - The device structure.
+ * @param buf - Value to be written.
+ * @param len - Length of the data in buf.
+ * @param channel - Channel properties.
+ * @param priv - The hopping path.
+ * @return Number of bytes written, or negative value on failure.
+ */
+static int set_ffh_profile(void *device, char *buf, uint32_t len,
+			   const struct iio_ch_info *channel, intptr_t priv)
+{
+	struct ad9081_phy *phy = device;
+	unsigned long val = strtoul(buf, NULL, 0);
+	int32_t ret;
+
+	if (val > UINT8_MAX)
+		return -EINVAL;
+
+	ret = ad9081_ffh_hop(phy, priv, ad9081_iio_ffh_mask(phy, priv), val);
+	if (ret)
+		return ret;
+
+	return len;
+}
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+static struct iio_attribute ad9081_iio_attributes[] = {
+	AD9081_FFH_ATTRS("ffh_rx_coarse", AD9081_FFH_RX_COARSE),
+	AD9081_FFH_ATTRS("ffh_rx_fine", AD9081_FFH_RX_FINE),
+	AD9081_FFH_ATTRS("ffh_tx_main", AD9081_FFH_TX_MAIN),
+	END_ATTRIBUTES_ARRAY
+};
+
+struct iio_device ad9081_iio_descriptor = {
+	.attributes = ad9081_iio_attributes,
+};
+
+#endif /* IIO_SUPPORT */
@@ -386,7 +386,14 @@ int32_t ad9083_init(struct ad9083_phy **device,
 		goto error_4;
 	}
 
+	/* Write the bitfields of a register set back to back only once */
+	ret = adi_ad9083_hal_bf_coalesce_set(&phy->adi_ad9083, 1);
+	if (ret != 0)
+		goto error_4;
+
 	ret = ad9083_setup(phy, init_param->uc);
+	if (adi_ad9083_hal_bf_coalesce_set(&phy->adi_ad9083, 0) != 0 && !ret)
+		ret = -1;
 	if (ret != 0) {
 		printf("%s: ad9083_setup failed (%"PRId32")\n", __func__, ret);
 		goto error_4;
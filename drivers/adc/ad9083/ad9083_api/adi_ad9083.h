@@ -341,6 +341,12 @@ typedef struct {
     adi_log_write_t           log_write;             /*!< Function Pointer to HAL log write function */
     adi_tx_en_pin_ctrl_t      tx_en_pin_ctrl;        /*!< Function Pointer to HAL TX_ENABLE Pin Control function */
     adi_reset_pin_ctrl_t      reset_pin_ctrl;        /*!< Function Pointer to HAL RESETB Pin Control Function */
+
+    uint8_t                   bf_coalesce;           /*!< Combine the bf_set of the same register */
+    uint8_t                   bf_pending;            /*!< bf_data is not written to bf_reg yet */
+    uint16_t                  bf_reg;                /*!< Register of the pending combined write */
+    uint8_t                   bf_data;               /*!< Value of the pending combined write */
+    uint8_t                   bf_bits;               /*!< Bits set by the bitfields combined in bf_data */
 }adi_ad9083_hal_t;
 
 /*!
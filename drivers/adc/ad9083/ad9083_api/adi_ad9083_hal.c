@@ -17,6 +17,9 @@
 #include "adi_ad9083_hal.h"
 
 /*============= C O D E ====================*/
+static int32_t adi_ad9083_hal_reg_write(adi_ad9083_device_t *device,
+                                        uint32_t reg, uint8_t data);
+
 int32_t adi_ad9083_hal_hw_open(adi_ad9083_device_t *device) {
   AD9083_NULL_POINTER_RETURN(device);
   AD9083_NULL_POINTER_RETURN(device->hal_info.hw_open);
@@ -38,8 +41,12 @@ int32_t adi_ad9083_hal_hw_close(adi_ad9083_device_t *device) {
 }
 
 int32_t adi_ad9083_hal_delay_us(adi_ad9083_device_t *device, uint32_t us) {
+  int32_t err;
   AD9083_NULL_POINTER_RETURN(device);
   AD9083_NULL_POINTER_RETURN(device->hal_info.delay_us);
+  /* the combined bitfields must reach the device before waiting */
+  err = adi_ad9083_hal_bf_flush(device);
+  AD9083_ERROR_RETURN(err);
   if (API_CMS_ERROR_OK !=
       device->hal_info.delay_us(device->hal_info.user_data, us)) {
     return API_CMS_ERROR_DELAY_US;
@@ -49,8 +56,11 @@ int32_t adi_ad9083_hal_delay_us(adi_ad9083_device_t *device, uint32_t us) {
 
 int32_t adi_ad9083_hal_reset_pin_ctrl(adi_ad9083_device_t *device,
                                       uint8_t enable) {
+  int32_t err;
   AD9083_NULL_POINTER_RETURN(device);
   AD9083_NULL_POINTER_RETURN(device->hal_info.reset_pin_ctrl);
+  err = adi_ad9083_hal_bf_flush(device);
+  AD9083_ERROR_RETURN(err);
   if (API_CMS_ERROR_OK !=
       device->hal_info.reset_pin_ctrl(device->hal_info.user_data, enable)) {
     return API_CMS_ERROR_RESET_PIN_CTRL;
@@ -134,6 +144,33 @@ int32_t adi_ad9083_hal_bf_set(adi_ad9083_device_t *device, uint32_t reg,
   AD9083_INVALID_PARAM_RETURN(width > 64);
   AD9083_INVALID_PARAM_RETURN(width < 1);
 
+  if (device->hal_info.bf_coalesce && (reg < 0x1000) &&
+      ((offset + width) <= 8)) {
+    mask = ((1 << width) - 1) << offset;
+    if (device->hal_info.bf_pending && (device->hal_info.bf_reg == reg)) {
+      data8 = device->hal_info.bf_data;
+      if (!(device->hal_info.bf_bits & mask)) {
+        device->hal_info.bf_data = (data8 & ~mask) | ((value << offset) & mask);
+        device->hal_info.bf_bits |= mask;
+        return API_CMS_ERROR_OK;
+      }
+      /* the bitfield is written again, keep both writes */
+      err = adi_ad9083_hal_bf_flush(device);
+      AD9083_ERROR_RETURN(err);
+    } else if (mask != 0xFF) {
+      err = adi_ad9083_hal_reg_get(device, reg, &data8);
+      AD9083_ERROR_RETURN(err);
+    } else {
+      err = adi_ad9083_hal_bf_flush(device);
+      AD9083_ERROR_RETURN(err);
+    }
+    device->hal_info.bf_reg = reg;
+    device->hal_info.bf_data = (data8 & ~mask) | ((value << offset) & mask);
+    device->hal_info.bf_bits = mask;
+    device->hal_info.bf_pending = 1;
+    return API_CMS_ERROR_OK;
+  }
+
   if (reg < 0x1000) {
     for (reg_offset = 0; reg_offset < reg_bytes; reg_offset++) {
       if ((offset + width) <= 8) { /* last 8bits */
@@ -166,12 +203,16 @@ int32_t adi_ad9083_hal_bf_set(adi_ad9083_device_t *device, uint32_t reg,
 
 int32_t adi_ad9083_hal_reg_get(adi_ad9083_device_t *device, uint32_t reg,
                                uint8_t *data) {
+  int32_t err;
   uint8_t in_data[SPI_IN_OUT_BUFF_SZ] = {0};
   uint8_t out_data[SPI_IN_OUT_BUFF_SZ] = {0};
   AD9083_NULL_POINTER_RETURN(device);
   AD9083_NULL_POINTER_RETURN(device->hal_info.spi_xfer);
   AD9083_NULL_POINTER_RETURN(data);
 
+  err = adi_ad9083_hal_bf_flush(device);
+  AD9083_ERROR_RETURN(err);
+
   if (reg < 0x1000) {
     in_data[0] = (((reg >> 8) | 0x80) & 0xFF);
     in_data[1] = (reg & 0xFF);
@@ -187,6 +228,40 @@ int32_t adi_ad9083_hal_reg_get(adi_ad9083_device_t *device, uint32_t reg,
 
 int32_t adi_ad9083_hal_reg_set(adi_ad9083_device_t *device, uint32_t reg,
                                uint8_t data) {
+  int32_t err;
+  AD9083_NULL_POINTER_RETURN(device);
+
+  err = adi_ad9083_hal_bf_flush(device);
+  AD9083_ERROR_RETURN(err);
+
+  return adi_ad9083_hal_reg_write(device, reg, data);
+}
+
+int32_t adi_ad9083_hal_bf_flush(adi_ad9083_device_t *device) {
+  AD9083_NULL_POINTER_RETURN(device);
+
+  if (!device->hal_info.bf_pending)
+    return API_CMS_ERROR_OK;
+
+  device->hal_info.bf_pending = 0;
+
+  return adi_ad9083_hal_reg_write(device, device->hal_info.bf_reg,
+                                  device->hal_info.bf_data);
+}
+
+int32_t adi_ad9083_hal_bf_coalesce_set(adi_ad9083_device_t *device,
+                                       uint8_t enable) {
+  AD9083_NULL_POINTER_RETURN(device);
+
+  device->hal_info.bf_coalesce = enable;
+  if (!enable)
+    return adi_ad9083_hal_bf_flush(device);
+
+  return API_CMS_ERROR_OK;
+}
+
+static int32_t adi_ad9083_hal_reg_write(adi_ad9083_device_t *device,
+                                        uint32_t reg, uint8_t data) {
   uint8_t in_data[SPI_IN_OUT_BUFF_SZ] = {0};
   uint8_t out_data[SPI_IN_OUT_BUFF_SZ] = {0};
   AD9083_NULL_POINTER_RETURN(device);
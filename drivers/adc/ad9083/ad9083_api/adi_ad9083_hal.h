@@ -43,6 +43,11 @@ int32_t adi_ad9083_hal_bf_get(adi_ad9083_device_t *device, uint32_t reg,
                               uint8_t value_size_bytes);
 int32_t adi_ad9083_hal_bf_set(adi_ad9083_device_t *device, uint32_t reg,
                               uint32_t info, uint64_t value);
+/* Combine the consecutive bf_set of the same register, 0 flushes and stops. */
+int32_t adi_ad9083_hal_bf_coalesce_set(adi_ad9083_device_t *device,
+                                       uint8_t enable);
+/* Write the pending combined bitfields, if any. */
+int32_t adi_ad9083_hal_bf_flush(adi_ad9083_device_t *device);
 
 int32_t adi_ad9083_hal_reg_get(adi_ad9083_device_t *device, uint32_t reg,
                                uint8_t *data);
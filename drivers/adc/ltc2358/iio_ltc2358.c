@@ -0,0 +1,365 @@
+/***************************************************************************//**
+ *   @file   iio_ltc2358.c
+ *   @brief  Implementation of the LTC2358 IIO driver.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include "ltc2358.h"
+#include "iio_ltc2358.h"
+#include "errno.h"
+#include "no_os_util.h"
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+/* Full scale range of each SoftSpan in mV, for the internal 4.096V reference */
+static const int32_t ltc2358_span_range_mv[] = {
+	[LTC2358_SPAN_DISABLED] = 0,
+	[LTC2358_SPAN_0V_5V12] = 5120,
+	[LTC2358_SPAN_BIP_5V] = 10000,
+	[LTC2358_SPAN_BIP_5V12] = 10240,
+	[LTC2358_SPAN_0V_10V] = 10000,
+	[LTC2358_SPAN_0V_10V24] = 10240,
+	[LTC2358_SPAN_BIP_10V] = 20000,
+	[LTC2358_SPAN_BIP_10V24] = 20480,
+};
+
+/* Trigger of the timer setting the conversion rate, one frame per event */
+struct iio_trigger ltc2358_iio_trig_desc = {
+	.is_synchronous = true,
+	.enable = iio_trig_enable,
+	.disable = iio_trig_disable
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+/**
+ * @brief Handles the read request for raw attribute.
+ * @param dev     - The iio device structure.
+ * @param buf     - Command buffer to be filled with requested data.
+ * @param len     - Length of the received command buffer in bytes.
+ * @param channel - Command channel info.
+ * @param priv    - Command attribute id.
+ * @return ret    - Result of the reading procedure. In case of success, the
+ * 		    size of the read data is returned.
+ */
+static int ltc2358_iio_read_raw(void *dev, char *buf, uint32_t len,
+				const struct iio_ch_info *channel,
+				intptr_t priv)
+{
+	struct ltc2358_iio_dev *iio_ltc2358 = dev;
+	struct ltc2358_frame frame;
+	int32_t ret;
+
+	if (!iio_ltc2358 || !iio_ltc2358->ltc2358_dev)
+		return -EINVAL;
+
+	ret = ltc2358_read_frame(iio_ltc2358->ltc2358_dev, &frame);
+	if (ret)
+		return ret;
+
+	if (!(frame.valid_mask & NO_OS_BIT(channel->ch_num)))
+		return -ENODATA;
+
+	return iio_format_value(buf, len, IIO_VAL_INT, 1,
+				&frame.data[channel->ch_num]);
+}
+
+/**
+ * @brief Handles the read request for scale attribute, in mV per LSB of the
+ * 	  SoftSpan of the channel.
+ * @param dev     - The iio device structure.
+ * @param buf     - Command buffer to be filled with requested data.
+ * @param len     - Length of the received command buffer in bytes.
+ * @param channel - Command channel info.
+ * @param priv    - Command attribute id.
+ * @return ret    - Result of the reading procedure. In case of success, the
+ * 		    size of the read data is returned.
+ */
+static int ltc2358_iio_read_scale(void *dev, char *buf, uint32_t len,
+				  const struct iio_ch_info *channel,
+				  intptr_t priv)
+{
+	struct ltc2358_iio_dev *iio_ltc2358 = dev;
+	enum ltc2358_softspan span;
+	int32_t vals[2];
+	int32_t ret;
+
+	if (!iio_ltc2358 || !iio_ltc2358->ltc2358_dev)
+		return -EINVAL;
+
+	ret = ltc2358_get_softspan(iio_ltc2358->ltc2358_dev, channel->ch_num,
+				   &span);
+	if (ret)
+		return ret;
+
+	vals[0] = ltc2358_span_range_mv[span];
+	vals[1] = LTC2358_RESULT_BITS;
+
+	return iio_format_value(buf, len, IIO_VAL_FRACTIONAL_LOG2, 2, vals);
+}
+
+/**
+ * @brief Handles the read request for softspan attribute.
+ * @param dev     - The iio device structure.
+ * @param buf     - Command buffer to be filled with requested data.
+ * @param len     - Length of the received command buffer in bytes.
+ * @param channel - Command channel info.
+ * @param priv    - Command attribute id.
+ * @return ret    - Result of the reading procedure. In case of success, the
+ * 		    size of the read data is returned.
+ */
+static int ltc2358_iio_read_softspan(void *dev, char *buf, uint32_t len,
+				     const struct iio_ch_info *channel,
+				     intptr_t priv)
+{
+	struct ltc2358_iio_dev *iio_ltc2358 = dev;
+	enum ltc2358_softspan span;
+	int32_t val;
+	int32_t ret;
+
+	if (!iio_ltc2358 || !iio_ltc2358->ltc2358_dev)
+		return -EINVAL;
+
+	ret = ltc2358_get_softspan(iio_ltc2358->ltc2358_dev, channel->ch_num,
+				   &span);
+	if (ret)
+		return ret;
+
+	val = span;
+
+	return iio_format_value(buf, len, IIO_VAL_INT, 1, &val);
+}
+
+/**
+ * @brief Handles the write request for softspan attribute.
+ * @param dev     - The iio device structure.
+ * @param buf     - Command buffer with the SoftSpan code, 0 to 7.
+ * @param len     - Length of the received command buffer in bytes.
+ * @param channel - Command channel info.
+ * @param priv    - Command attribute id.
+ * @return ret    - Result of the writing procedure. In case of success, the
+ * 		    size of the written data is returned.
+ */
+static int ltc2358_iio_write_softspan(void *dev, char *buf, uint32_t len,
+				      const struct iio_ch_info *channel,
+				      intptr_t priv)
+{
+	struct ltc2358_iio_dev *iio_ltc2358 = dev;
+	int32_t val;
+	int32_t ret;
+
+	if (!iio_ltc2358 || !iio_ltc2358->ltc2358_dev)
+		return -EINVAL;
+
+	ret = iio_parse_value(buf, IIO_VAL_INT, &val, NULL);
+	if (ret)
+		return ret;
+
+	if (val < LTC2358_SPAN_DISABLED || val > LTC2358_SPAN_BIP_10V24)
+		return -EINVAL;
+
+	ret = ltc2358_set_softspan(iio_ltc2358->ltc2358_dev, channel->ch_num,
+				   val);
+	if (ret)
+		return ret;
+
+	return len;
+}
+
+/**
+ * @brief Handles the read request for softspan_available attribute.
+ * @param dev     - The iio device structure.
+ * @param buf     - Command buffer to be filled with requested data.
+ * @param len     - Length of the received command buffer in bytes.
+ * @param channel - Command channel info.
+ * @param priv    - Command attribute id.
+ * @return ret    - Result of the reading procedure. In case of success, the
+ * 		    size of the read data is returned.
+ */
+static int ltc2358_iio_read_softspan_avail(void *dev, char *buf, uint32_t len,
+		const struct iio_ch_info *channel,
+		intptr_t priv)
+{
+	return snprintf(buf, len, "0 1 2 3 4 5 6 7");
+}
+
+/**
+ * @brief Handles trigger: converts all the channels and writes the results of
+ * 	  the active ones to the buffer, from a single frame transfer.
+ * @param dev_data - The iio device data structure.
+ * @return ret     - Result of the handling procedure.
+ */
+static int32_t ltc2358_trigger_handler(struct iio_device_data *dev_data)
+{
+	struct ltc2358_iio_dev *iio_ltc2358;
+	struct ltc2358_frame frame;
+	int32_t ret;
+
+	if (!dev_data)
+		return -EINVAL;
+
+	iio_ltc2358 = (struct ltc2358_iio_dev *)dev_data->dev;
+	if (!iio_ltc2358->ltc2358_dev)
+		return -EINVAL;
+
+	ret = ltc2358_read_frame(iio_ltc2358->ltc2358_dev, &frame);
+	if (ret)
+		return ret;
+
+	return iio_buffer_push_samples(dev_data->buffer, frame.data,
+				       sizeof(*frame.data));
+}
+
+static struct iio_attribute ltc2358_iio_voltage_attrs[] = {
+	{
+		.name = "raw",
+		.show = ltc2358_iio_read_raw,
+	},
+	{
+		.name = "scale",
+		.show = ltc2358_iio_read_scale,
+	},
+	{
+		.name = "softspan",
+		.show = ltc2358_iio_read_softspan,
+		.store = ltc2358_iio_write_softspan,
+	},
+	{
+		.name = "softspan_available",
+		.shared = IIO_SHARED_BY_TYPE,
+		.show = ltc2358_iio_read_softspan_avail,
+	},
+	END_ATTRIBUTES_ARRAY,
+};
+
+/* 18-bit results, straight binary in the unipolar spans, fit in 19 bits */
+static struct scan_type ltc2358_iio_voltage_scan_type = {
+	.sign = 's',
+	.realbits = LTC2358_RESULT_BITS + 1,
+	.storagebits = 32,
+	.shift = 0,
+	.is_big_endian = false,
+};
+
+#define LTC2358_VOLTAGE_CHANNEL(index) {			\
+	.ch_type = IIO_VOLTAGE,					\
+	.channel = index,					\
+	.indexed = 1,						\
+	.scan_index = index,					\
+	.scan_type = &ltc2358_iio_voltage_scan_type,		\
+	.attributes = ltc2358_iio_voltage_attrs,		\
+	.ch_out = false,					\
+}
+
+static struct iio_channel ltc2358_channels[] = {
+	LTC2358_VOLTAGE_CHANNEL(0),
+	LTC2358_VOLTAGE_CHANNEL(1),
+	LTC2358_VOLTAGE_CHANNEL(2),
+	LTC2358_VOLTAGE_CHANNEL(3),
+	LTC2358_VOLTAGE_CHANNEL(4),
+	LTC2358_VOLTAGE_CHANNEL(5),
+	LTC2358_VOLTAGE_CHANNEL(6),
+	LTC2358_VOLTAGE_CHANNEL(7),
+};
+
+static struct iio_device ltc2358_iio_dev = {
+	.num_ch = NO_OS_ARRAY_SIZE(ltc2358_channels),
+	.channels = ltc2358_channels,
+	.trigger_handler = (int32_t (*)())ltc2358_trigger_handler,
+};
+
+/**
+ * @brief Initializes the LTC2358 IIO driver.
+ * @param iio_dev    - The iio device structure.
+ * @param init_param - The structure that contains the device initial
+ * 		       parameters.
+ * @return ret       - Result of the initialization procedure.
+ */
+int ltc2358_iio_init(struct ltc2358_iio_dev **iio_dev,
+		     struct ltc2358_iio_dev_init_param *init_param)
+{
+	struct ltc2358_iio_dev *desc;
+	int ret;
+
+	if (!init_param || !init_param->ltc2358_dev_init)
+		return -EINVAL;
+
+	desc = (struct ltc2358_iio_dev *)calloc(1, sizeof(*desc));
+	if (!desc)
+		return -ENOMEM;
+
+	desc->iio_dev = &ltc2358_iio_dev;
+
+	ret = ltc2358_init(&desc->ltc2358_dev, init_param->ltc2358_dev_init);
+	if (ret)
+		goto error;
+
+	*iio_dev = desc;
+
+	return 0;
+
+error:
+	free(desc);
+
+	return ret;
+}
+
+/**
+ * @brief Free the resources allocated by ltc2358_iio_init().
+ * @param desc - The IIO device structure.
+ * @return ret - Result of the remove procedure.
+ */
+int ltc2358_iio_remove(struct ltc2358_iio_dev *desc)
+{
+	int ret;
+
+	if (!desc)
+		return -ENODEV;
+
+	ret = ltc2358_remove(desc->ltc2358_dev);
+	if (ret)
+		return ret;
+
+	free(desc);
+
+	return 0;
+}
@@ -42,7 +42,9 @@
 /******************************************************************************/
 
 #include <stdlib.h>
+#include <string.h>
 #include "ltc2358.h"
+#include "no_os_delay.h"
 #include "errno.h"
 
 /******************************************************************************/
@@ -90,7 +92,148 @@ static int32_t ltc2358_write_and_read(struct ltc2358_dev *dev,
 }
 
 /**
- * @brief Read single channel data.
+ * @brief Set the SoftSpan of a channel. The configuration word is sent with the
+ * next frame read, so the span applies from the conversion after it.
+ * @param dev - Device handler.
+ * @param channel - Channel number (0-7).
+ * @param span - SoftSpan of the channel, LTC2358_SPAN_DISABLED to skip it.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ltc2358_set_softspan(struct ltc2358_dev *dev, uint8_t channel,
+			     enum ltc2358_softspan span)
+{
+	if (!dev || channel >= LTC2358_NUM_CHANNELS ||
+	    span > LTC2358_SPAN_BIP_10V24)
+		return -EINVAL;
+
+	dev->config_word &= ~(LTC2358_SOFTSPAN_MSK <<
+			      (channel * LTC2358_BYTES_PER_CH));
+	ltc2358_create_config_word(channel, span, &dev->config_word);
+	no_os_put_unaligned_be24(dev->config_word, dev->tx_buff);
+
+	return 0;
+}
+
+/**
+ * @brief Get the SoftSpan of a channel, as configured for the next conversions.
+ * @param dev - Device handler.
+ * @param channel - Channel number (0-7).
+ * @param span - SoftSpan of the channel.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ltc2358_get_softspan(struct ltc2358_dev *dev, uint8_t channel,
+			     enum ltc2358_softspan *span)
+{
+	if (!dev || !span || channel >= LTC2358_NUM_CHANNELS)
+		return -EINVAL;
+
+	*span = (dev->config_word >> (channel * LTC2358_BYTES_PER_CH)) &
+		LTC2358_SOFTSPAN_MSK;
+
+	return 0;
+}
+
+/**
+ * @brief Decode the 8 channel words of a frame. Each word carries its channel
+ * ID and SoftSpan code, so the results are placed by channel and sign extended
+ * according to the span they were converted with. Words of disabled channels
+ * are ignored.
+ * @param data_array - 24 bytes of data from 8 channels.
+ * @param frame - Decoded results.
+ */
+void ltc2358_decode_frame(uint8_t data_array[24], struct ltc2358_frame *frame)
+{
+	uint32_t word;
+	uint32_t result;
+	uint8_t span;
+	uint8_t ch;
+	uint8_t i;
+
+	memset(frame, 0, sizeof(*frame));
+
+	for (i = 0; i < LTC2358_NUM_CHANNELS; i++) {
+		word = no_os_get_unaligned_be24(data_array);
+		data_array += LTC2358_BYTES_PER_CH;
+		span = no_os_field_get(LTC2358_SOFTSPAN_MSK, word);
+		if (span == LTC2358_SPAN_DISABLED)
+			continue;
+
+		ch = no_os_field_get(LTC2358_CHID_MSK, word);
+		result = no_os_field_get(LTC2358_RESULT_MSK, word);
+		/* Bit 1 of the SoftSpan code is set for the bipolar spans */
+		if (span & NO_OS_BIT(1))
+			frame->data[ch] = no_os_sign_extend32(result,
+					  LTC2358_RESULT_BITS - 1);
+		else
+			frame->data[ch] = result;
+		frame->softspan[ch] = span;
+		frame->valid_mask |= NO_OS_BIT(ch);
+	}
+}
+
+/**
+ * @brief Start a conversion, if the CNV GPIO is used, wait for its end and read
+ * the results of the 8 channels in a single 24 bytes transfer. The SoftSpan
+ * configuration word is sent in the same transfer.
+ * @param dev - Device handler.
+ * @param frame - Decoded results of the conversion.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ltc2358_read_frame(struct ltc2358_dev *dev,
+			   struct ltc2358_frame *frame)
+{
+	struct no_os_spi_msg msg;
+	uint32_t timeout;
+	uint8_t busy;
+	int32_t ret;
+
+	if (!dev || !frame)
+		return -EINVAL;
+
+	if (dev->gpio_cnv) {
+		ret = no_os_gpio_set_value(dev->gpio_cnv, NO_OS_GPIO_HIGH);
+		if (ret)
+			return ret;
+
+		ret = no_os_gpio_set_value(dev->gpio_cnv, NO_OS_GPIO_LOW);
+		if (ret)
+			return ret;
+	}
+
+	if (dev->gpio_busy) {
+		for (timeout = LTC2358_BUSY_TIMEOUT; timeout; timeout--) {
+			ret = no_os_gpio_get_value(dev->gpio_busy, &busy);
+			if (ret)
+				return ret;
+			if (busy == NO_OS_GPIO_LOW)
+				break;
+			no_os_udelay(1);
+		}
+		if (!timeout)
+			return -ETIMEDOUT;
+	} else {
+		no_os_udelay(LTC2358_CONV_TIME_US);
+	}
+
+	msg = (struct no_os_spi_msg) {
+		.tx_buff = dev->tx_buff,
+		.rx_buff = dev->rx_buff,
+		.bytes_number = LTC2358_FRAME_BYTES,
+		.cs_change = 1,
+	};
+
+	ret = no_os_spi_transfer(dev->spi_desc, &msg, 1);
+	if (ret)
+		return ret;
+
+	ltc2358_decode_frame(dev->rx_buff, frame);
+
+	return 0;
+}
+
+/**
+ * @brief Read single channel data. Each call transfers the whole frame, use
+ * ltc2358_read_frame() to get all the channels of a conversion.
  * @param dev - Device handler.
  * @param config_word - 24-bit config word created.
  * @param data_array - 24 bytes of data from 8 channels.
@@ -134,13 +277,44 @@ int32_t ltc2358_init(struct ltc2358_dev **device,
 	if (ret)
 		goto error;
 
+	ret = no_os_gpio_get_optional(&dev->gpio_cnv, init_param->gpio_cnv);
+	if (ret)
+		goto error_spi;
+
+	if (dev->gpio_cnv) {
+		ret = no_os_gpio_direction_output(dev->gpio_cnv,
+						  NO_OS_GPIO_LOW);
+		if (ret)
+			goto error_cnv;
+	}
+
+	ret = no_os_gpio_get_optional(&dev->gpio_busy, init_param->gpio_busy);
+	if (ret)
+		goto error_cnv;
+
+	if (dev->gpio_busy) {
+		ret = no_os_gpio_direction_input(dev->gpio_busy);
+		if (ret)
+			goto error_busy;
+	}
+
+	dev->config_word = init_param->config_word;
+	no_os_put_unaligned_be24(dev->config_word, dev->tx_buff);
+
 	*device = dev;
 
-	return ret;
+	return 0;
+
+error_busy:
+	no_os_gpio_remove(dev->gpio_busy);
+error_cnv:
+	no_os_gpio_remove(dev->gpio_cnv);
+error_spi:
+	no_os_spi_remove(dev->spi_desc);
 error:
 	free(dev);
 
-	return 0;
+	return ret;
 }
 
 /**
@@ -159,6 +333,9 @@ int32_t ltc2358_remove(struct ltc2358_dev *dev)
 	if (ret)
 		return ret;
 
+	no_os_gpio_remove(dev->gpio_cnv);
+	no_os_gpio_remove(dev->gpio_busy);
+
 	free(dev);
 
 	return 0;
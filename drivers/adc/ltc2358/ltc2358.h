@@ -46,6 +46,7 @@
 
 #include <stdint.h>
 #include "no_os_spi.h"
+#include "no_os_gpio.h"
 #include "no_os_util.h"
 
 /******************************************************************************/
@@ -54,11 +55,59 @@
 
 #define LTC2358_BYTES_PER_CH    3
 #define LTC2358_CHANNEL_MSK     NO_OS_GENMASK(2, 0)
+#define LTC2358_NUM_CHANNELS    8
+#define LTC2358_FRAME_BYTES     (LTC2358_NUM_CHANNELS * LTC2358_BYTES_PER_CH)
+#define LTC2358_RESULT_BITS     18
+
+/* Fields of the 24-bit word output for each channel */
+#define LTC2358_RESULT_MSK      NO_OS_GENMASK(23, 6)
+#define LTC2358_CHID_MSK        NO_OS_GENMASK(5, 3)
+#define LTC2358_SOFTSPAN_MSK    NO_OS_GENMASK(2, 0)
+
+/* A conversion fits in the sample period at the 200 ksps throughput */
+#define LTC2358_CONV_TIME_US    5
+#define LTC2358_BUSY_TIMEOUT    1000
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
 
+/**
+ * @enum ltc2358_softspan
+ * @brief SoftSpan input ranges, for the internal 4.096V reference.
+ */
+enum ltc2358_softspan {
+	LTC2358_SPAN_DISABLED,
+	/* 0V to 5.12V */
+	LTC2358_SPAN_0V_5V12,
+	/* +/- 5V */
+	LTC2358_SPAN_BIP_5V,
+	/* +/- 5.12V */
+	LTC2358_SPAN_BIP_5V12,
+	/* 0V to 10V */
+	LTC2358_SPAN_0V_10V,
+	/* 0V to 10.24V */
+	LTC2358_SPAN_0V_10V24,
+	/* +/- 10V */
+	LTC2358_SPAN_BIP_10V,
+	/* +/- 10.24V */
+	LTC2358_SPAN_BIP_10V24,
+};
+
+/**
+ * @struct ltc2358_frame
+ * @brief Results of the 8 channels for one conversion.
+ */
+struct ltc2358_frame {
+	/* Result of each channel by channel number, sign extended in the
+	 * bipolar spans and straight binary in the unipolar ones */
+	int32_t data[LTC2358_NUM_CHANNELS];
+	/* SoftSpan the result of each channel was converted with */
+	uint8_t softspan[LTC2358_NUM_CHANNELS];
+	/* Channels with a result in the frame */
+	uint8_t valid_mask;
+};
+
 /**
  * @struct ltc2358_init_param
  * @brief Structure holding the parameters for ltc2358 initialization.
@@ -66,6 +115,12 @@
 struct ltc2358_init_param {
 	/* SPI Initialization structure. */
 	struct no_os_spi_init_param *spi_init;
+	/* CNV GPIO, NULL when CNV is driven by a timer output. */
+	struct no_os_gpio_init_param *gpio_cnv;
+	/* BUSY GPIO, NULL to wait LTC2358_CONV_TIME_US instead. */
+	struct no_os_gpio_init_param *gpio_busy;
+	/* SoftSpan configuration word, see ltc2358_create_config_word(). */
+	uint32_t config_word;
 };
 
 /**
@@ -75,6 +130,15 @@ struct ltc2358_init_param {
 struct ltc2358_dev {
 	/* SPI handler */
 	struct no_os_spi_desc *spi_desc;
+	/* CNV GPIO handler */
+	struct no_os_gpio_desc *gpio_cnv;
+	/* BUSY GPIO handler */
+	struct no_os_gpio_desc *gpio_busy;
+	/* SoftSpan configuration word sent with each frame */
+	uint32_t config_word;
+	/* Transmit and receive buffers of the frame transfer */
+	uint8_t tx_buff[LTC2358_FRAME_BYTES];
+	uint8_t rx_buff[LTC2358_FRAME_BYTES];
 };
 
 /******************************************************************************/
@@ -89,6 +153,22 @@ void ltc2358_create_config_word(uint8_t channel, uint8_t config_number,
 int32_t ltc2358_channel_data(struct ltc2358_dev *dev, uint32_t config_word,
 			     uint8_t data_array[24], uint8_t channel, uint32_t *readval);
 
+/* Set the SoftSpan of a channel, used from the next conversion. */
+int32_t ltc2358_set_softspan(struct ltc2358_dev *dev, uint8_t channel,
+			     enum ltc2358_softspan span);
+
+/* Get the SoftSpan of a channel. */
+int32_t ltc2358_get_softspan(struct ltc2358_dev *dev, uint8_t channel,
+			     enum ltc2358_softspan *span);
+
+/* Decode the 8 channel words of a frame. */
+void ltc2358_decode_frame(uint8_t data_array[24],
+			  struct ltc2358_frame *frame);
+
+/* Convert and read the results of all channels in one transfer. */
+int32_t ltc2358_read_frame(struct ltc2358_dev *dev,
+			   struct ltc2358_frame *frame);
+
 /* Initializes the LTC2358. */
 int32_t ltc2358_init(struct ltc2358_dev **device,
 		     struct ltc2358_init_param *init_param);
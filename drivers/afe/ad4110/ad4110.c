@@ -48,6 +48,7 @@
 #include "no_os_util.h"
 #include "no_os_error.h"
 #include "no_os_irq.h"
+#include "no_os_crc8.h"
 #include "no_os_print_log.h"
 #include <string.h>
 
@@ -65,21 +66,8 @@
 uint8_t ad4110_compute_crc8(uint8_t *data,
 			    uint8_t data_size)
 {
-	uint8_t i;
-	uint8_t crc = 0;
-
-	while (data_size) {
-		for (i = 0x80; i != 0; i >>= 1) {
-			if (((crc & 0x80) != 0) != ((*data & i) != 0)) {
-				crc <<= 1;
-				crc ^= AD4110_CRC8_POLY;
-			} else
-				crc <<= 1;
-		}
-		data++;
-		data_size--;
-	}
-	return crc;
+	/* AD4110_CRC8_POLY, no final XOR */
+	return no_os_crc8(no_os_crc8_table_07, data, data_size, 0);
 }
 
 /***************************************************************************//**
@@ -94,15 +82,11 @@ uint8_t ad4110_compute_xor(uint8_t *data,
 			   uint8_t data_size)
 {
 	uint8_t crc = 0;
-	uint8_t buf[3];
-
 	uint8_t i;
 
-	for (i = 0; i < data_size; i++) {
-		buf[i] = *data;
-		crc ^= buf[i];
-		data++;
-	}
+	for (i = 0; i < data_size; i++)
+		crc ^= data[i];
+
 	return crc;
 }
 
@@ -618,6 +602,65 @@ int32_t ad4110_spi_int_data_reg_read(struct ad4110_dev *dev,
 	return 0;
 }
 
+/***************************************************************************//**
+ * SPI internal DATA register read, with the status appended, for streaming.
+ * Done in a single transfer and without logging, so that it can be called
+ * from the data ready interrupt.
+ *
+ * @param dev    - The device structure, with data_stat enabled.
+ * @param data   - The conversion result.
+ * @param status - The ADC status, carrying the channel of the result.
+ *
+ * @return 0 in case of success, -EBADMSG for a wrong checksum, negative error
+ *	   code otherwise.
+*******************************************************************************/
+int32_t ad4110_spi_int_data_status_read(struct ad4110_dev *dev,
+					uint32_t *data,
+					uint8_t *status)
+{
+	uint8_t buf[6] = {0};
+	uint8_t data_size;
+	uint8_t buf_size;
+	uint8_t crc;
+	uint8_t i;
+	int32_t ret;
+
+	if (dev->data_stat != AD4110_ENABLE)
+		return -EINVAL;
+
+	/* Command byte, 2 or 3 data bytes and the status */
+	data_size = ad4110_get_data_size(dev, A4110_ADC, AD4110_REG_DATA);
+	buf_size = data_size;
+	if (dev->adc_crc_en != AD4110_ADC_CRC_DISABLE)
+		buf_size++;
+
+	buf[0] = (A4110_ADC << 7) |
+		 AD4110_CMD_READ_COM_REG(AD4110_REG_DATA) |
+		 ((dev->addr << 4) & AD4110_DEV_ADDR_MASK);
+
+	ret = no_os_spi_write_and_read(dev->spi_dev, buf, buf_size);
+	if (ret)
+		return ret;
+
+	if (dev->adc_crc_en != AD4110_ADC_CRC_DISABLE) {
+		buf[0] = (A4110_ADC << 7) |
+			 AD4110_CMD_READ_COM_REG(AD4110_REG_DATA);
+		if (dev->adc_crc_en == AD4110_ADC_CRC_CRC)
+			crc = ad4110_compute_crc8(buf, data_size);
+		else
+			crc = ad4110_compute_xor(buf, data_size);
+		if (crc != buf[data_size])
+			return -EBADMSG;
+	}
+
+	*data = 0;
+	for (i = 1; i < data_size - 1; i++)
+		*data = (*data << 8) | buf[i];
+	*status = buf[data_size - 1];
+
+	return 0;
+}
+
 /***************************************************************************//**
  * SPI internal register read from device.
  *
@@ -141,6 +141,7 @@
 
 /* ADC status register */
 #define AD4110_REG_ADC_STATUS_RDY			(1 << 7)
+#define AD4110_REG_ADC_STATUS_CH(x)			((x) & 0x3)
 
 /* ADC_MODE Register */
 #define AD4110_REG_ADC_MODE_MSK			0x70
@@ -422,10 +423,18 @@ int32_t ad4110_continuous_read(struct ad4110_dev *dev, uint32_t *buffer,
 int32_t ad4110_spi_int_data_reg_read(struct ad4110_dev *dev,
 				     uint32_t *reg_data);
 
+/* SPI internal DATA register and appended status read from device. */
+int32_t ad4110_spi_int_data_status_read(struct ad4110_dev *dev,
+					uint32_t *data,
+					uint8_t *status);
+
 /* Initialize the device. */
 int32_t ad4110_setup(struct ad4110_dev **device,
 		     struct ad4110_init_param init_param);
 
+/* Free the resources allocated by ad4110_setup(). */
+int32_t ad4110_remove(struct ad4110_dev *dev);
+
 /* Enable/Disable channel */
 int ad4110_set_channel_status(struct ad4110_dev *dev, uint8_t chan_id,
 			      bool status);
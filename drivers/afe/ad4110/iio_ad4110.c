@@ -0,0 +1,398 @@
+/***************************************************************************//**
+ *   @file   iio_ad4110.c
+ *   @brief  Implementation of the AD4110 IIO driver.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stddef.h>
+#include <stdlib.h>
+#include <errno.h>
+#include "ad4110.h"
+#include "iio_ad4110.h"
+#include "no_os_util.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+/**
+ * @brief Handles the read request for raw attribute, with a single
+ * conversion of the channel.
+ * @param dev     - The iio device structure.
+ * @param buf     - Command buffer to be filled with requested data.
+ * @param len     - Length of the received command buffer in bytes.
+ * @param channel - Command channel info.
+ * @param priv    - Command attribute id.
+ * @return The size of the read data in case of success, negative error code
+ * otherwise.
+ */
+static int ad4110_iio_read_raw(void *dev, char *buf, uint32_t len,
+			       const struct iio_ch_info *channel, intptr_t priv)
+{
+	struct ad4110_iio_dev *desc = dev;
+	uint32_t data;
+	int32_t val;
+	int ret;
+
+	/* The sequencer is in use by the buffer */
+	if (desc->mask)
+		return -EBUSY;
+
+	ret = ad4110_spi_int_reg_write_msk(desc->ad4110_dev, A4110_ADC,
+					   AD4110_REG_ADC_CONFIG,
+					   NO_OS_BIT(channel->ch_num),
+					   AD4110_REG_ADC_CONFIG_CHAN_EN_MSK);
+	if (ret)
+		return ret;
+
+	ret = ad4110_do_single_read(desc->ad4110_dev, &data);
+	if (ret)
+		return ret;
+
+	/* Drop the appended status */
+	if (desc->ad4110_dev->data_stat == AD4110_ENABLE)
+		data >>= 8;
+	val = data;
+
+	return iio_format_value(buf, len, IIO_VAL_INT, 1, &val);
+}
+
+/**
+ * @brief Handles the read request for the stream counters.
+ * @param dev     - The iio device structure.
+ * @param buf     - Command buffer to be filled with requested data.
+ * @param len     - Length of the received command buffer in bytes.
+ * @param channel - Command channel info.
+ * @param priv    - Offset of the counter in struct ad4110_iio_dev.
+ * @return The size of the read data in case of success, negative error code
+ * otherwise.
+ */
+static int ad4110_iio_read_counter(void *dev, char *buf, uint32_t len,
+				   const struct iio_ch_info *channel,
+				   intptr_t priv)
+{
+	int32_t val = *(uint32_t *)((uint8_t *)dev + priv);
+
+	return iio_format_value(buf, len, IIO_VAL_INT, 1, &val);
+}
+
+/**
+ * @brief Enable the buffer channels in the sequencer, append the status to
+ * the data and start the continuous conversion.
+ * @param dev  - The iio device structure.
+ * @param mask - Channels enabled in the buffer.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad4110_iio_pre_enable(void *dev, uint32_t mask)
+{
+	struct ad4110_iio_dev *desc = dev;
+	struct ad4110_dev *ad4110 = desc->ad4110_dev;
+	int32_t ret;
+
+	if (!mask)
+		return -EINVAL;
+
+	ret = ad4110_spi_int_reg_write_msk(ad4110, A4110_ADC,
+					   AD4110_REG_ADC_CONFIG, mask,
+					   AD4110_REG_ADC_CONFIG_CHAN_EN_MSK);
+	if (ret)
+		return ret;
+
+	ret = ad4110_spi_int_reg_write_msk(ad4110, A4110_ADC,
+					   AD4110_REG_ADC_INTERFACE,
+					   AD4110_DATA_STAT_EN,
+					   AD4110_REG_ADC_INTERFACE_DS_MSK);
+	if (ret)
+		return ret;
+
+	desc->data_stat = ad4110->data_stat;
+	ad4110->data_stat = AD4110_ENABLE;
+	desc->next = no_os_find_first_set_bit(mask);
+	desc->pos = 0;
+	desc->crc_errors = 0;
+	desc->resyncs = 0;
+	desc->mask = mask;
+
+	ret = ad4110_set_adc_mode(ad4110, AD4110_CONTINOUS_CONV_MODE);
+	if (ret)
+		return ret;
+
+	return no_os_irq_enable(ad4110->irq_desc, ad4110->nready_pin);
+}
+
+/**
+ * @brief Stop the conversions and restore the data_stat setting.
+ * @param dev - The iio device structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad4110_iio_post_disable(void *dev)
+{
+	struct ad4110_iio_dev *desc = dev;
+	struct ad4110_dev *ad4110 = desc->ad4110_dev;
+	int32_t ret;
+
+	ret = no_os_irq_disable(ad4110->irq_desc, ad4110->nready_pin);
+	if (ret)
+		return ret;
+
+	desc->mask = 0;
+
+	ret = ad4110_set_adc_mode(ad4110, AD4110_STANDBY_MODE);
+	if (ret)
+		return ret;
+
+	ad4110->data_stat = desc->data_stat;
+	if (desc->data_stat == AD4110_ENABLE)
+		return 0;
+
+	return ad4110_spi_int_reg_write_msk(ad4110, A4110_ADC,
+					    AD4110_REG_ADC_INTERFACE, 0,
+					    AD4110_REG_ADC_INTERFACE_DS_MSK);
+}
+
+/**
+ * @brief Read the new result on data ready. The channel in the appended
+ * status places it in the scan, pushed once all the enabled channels were
+ * read. A missing result restarts the scan from the first channel.
+ * @param dev_data - IIO device data.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad4110_iio_trigger_handler(struct iio_device_data *dev_data)
+{
+	struct ad4110_iio_dev *desc = dev_data->dev;
+	struct ad4110_dev *ad4110 = desc->ad4110_dev;
+	uint8_t status;
+	uint32_t data;
+	uint8_t first;
+	uint8_t ch;
+	int32_t ret;
+
+	/* nREADY is shared with DOUT, which toggles during the read */
+	ret = no_os_irq_disable(ad4110->irq_desc, ad4110->nready_pin);
+	if (ret)
+		return ret;
+
+	ret = ad4110_spi_int_data_status_read(ad4110, &data, &status);
+	if (ret == -EBADMSG) {
+		desc->crc_errors++;
+		goto out;
+	}
+	if (ret)
+		goto out;
+
+	first = no_os_find_first_set_bit(desc->mask);
+	ch = AD4110_REG_ADC_STATUS_CH(status);
+	if (ch != desc->next) {
+		desc->resyncs++;
+		desc->next = first;
+		desc->pos = 0;
+		if (ch != first)
+			goto out;
+	}
+
+	desc->scan[desc->pos++] = data;
+	if (ch != no_os_find_last_set_bit(desc->mask)) {
+		do {
+			desc->next++;
+		} while (!(desc->mask & NO_OS_BIT(desc->next)));
+		goto out;
+	}
+
+	desc->next = first;
+	desc->pos = 0;
+	ret = iio_buffer_push_scan(dev_data->buffer, desc->scan);
+
+out:
+	no_os_irq_enable(ad4110->irq_desc, ad4110->nready_pin);
+
+	return ret;
+}
+
+/**
+ * @brief Read a register of the ADC register map.
+ * @param dev     - The iio device structure.
+ * @param reg     - Register address.
+ * @param readval - Register value.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad4110_iio_reg_read(void *dev, uint32_t reg, uint32_t *readval)
+{
+	struct ad4110_iio_dev *desc = dev;
+
+	return ad4110_spi_int_reg_read(desc->ad4110_dev, A4110_ADC, reg,
+				       readval);
+}
+
+/**
+ * @brief Write a register of the ADC register map.
+ * @param dev      - The iio device structure.
+ * @param reg      - Register address.
+ * @param writeval - Register value.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad4110_iio_reg_write(void *dev, uint32_t reg, uint32_t writeval)
+{
+	struct ad4110_iio_dev *desc = dev;
+
+	return ad4110_spi_int_reg_write(desc->ad4110_dev, A4110_ADC, reg,
+					writeval);
+}
+
+static struct iio_attribute ad4110_iio_ch_attrs[] = {
+	{
+		.name = "raw",
+		.show = ad4110_iio_read_raw,
+	},
+	END_ATTRIBUTES_ARRAY,
+};
+
+static struct iio_attribute ad4110_iio_debug_attrs[] = {
+	{
+		.name = "stream_crc_errors",
+		.show = ad4110_iio_read_counter,
+		.priv = offsetof(struct ad4110_iio_dev, crc_errors),
+	},
+	{
+		.name = "stream_resyncs",
+		.show = ad4110_iio_read_counter,
+		.priv = offsetof(struct ad4110_iio_dev, resyncs),
+	},
+	END_ATTRIBUTES_ARRAY,
+};
+
+static struct scan_type ad4110_iio_scan_type_wl24 = {
+	.sign = 'u',
+	.realbits = 24,
+	.storagebits = 32,
+	.is_big_endian = false,
+};
+
+static struct scan_type ad4110_iio_scan_type_wl16 = {
+	.sign = 'u',
+	.realbits = 16,
+	.storagebits = 32,
+	.is_big_endian = false,
+};
+
+#define AD4110_IIO_CHANNEL(_idx, _scan_type) { \
+	.ch_type = IIO_VOLTAGE, \
+	.channel = _idx, \
+	.scan_index = _idx, \
+	.indexed = true, \
+	.scan_type = _scan_type, \
+	.attributes = ad4110_iio_ch_attrs, \
+}
+
+static struct iio_channel ad4110_iio_channels_wl24[] = {
+	AD4110_IIO_CHANNEL(0, &ad4110_iio_scan_type_wl24),
+	AD4110_IIO_CHANNEL(1, &ad4110_iio_scan_type_wl24),
+	AD4110_IIO_CHANNEL(2, &ad4110_iio_scan_type_wl24),
+	AD4110_IIO_CHANNEL(3, &ad4110_iio_scan_type_wl24),
+};
+
+static struct iio_channel ad4110_iio_channels_wl16[] = {
+	AD4110_IIO_CHANNEL(0, &ad4110_iio_scan_type_wl16),
+	AD4110_IIO_CHANNEL(1, &ad4110_iio_scan_type_wl16),
+	AD4110_IIO_CHANNEL(2, &ad4110_iio_scan_type_wl16),
+	AD4110_IIO_CHANNEL(3, &ad4110_iio_scan_type_wl16),
+};
+
+/**
+ * @brief Initializes the AD4110 iio driver.
+ * @param iio_dev    - The iio device structure.
+ * @param init_param - The structure that contains the device initial
+ *                     parameters, irq_desc and nready_pin being needed.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int ad4110_iio_init(struct ad4110_iio_dev **iio_dev,
+		    struct ad4110_iio_init_param *init_param)
+{
+	struct ad4110_iio_dev *desc;
+	int ret;
+
+	if (!init_param || !init_param->ad4110_init ||
+	    !init_param->ad4110_init->irq_desc)
+		return -EINVAL;
+
+	desc = (struct ad4110_iio_dev *)calloc(1, sizeof(*desc));
+	if (!desc)
+		return -ENOMEM;
+
+	ret = ad4110_setup(&desc->ad4110_dev, *init_param->ad4110_init);
+	if (ret)
+		goto error_desc;
+
+	desc->iio_dev = (struct iio_device) {
+		.num_ch = AD4110_IIO_CHANNELS,
+		.channels = ad4110_iio_channels_wl24,
+		.debug_attributes = ad4110_iio_debug_attrs,
+		.pre_enable = ad4110_iio_pre_enable,
+		.post_disable = ad4110_iio_post_disable,
+		.trigger_handler = ad4110_iio_trigger_handler,
+		.debug_reg_read = ad4110_iio_reg_read,
+		.debug_reg_write = ad4110_iio_reg_write,
+	};
+	if (desc->ad4110_dev->data_length == AD4110_DATA_WL16)
+		desc->iio_dev.channels = ad4110_iio_channels_wl16;
+
+	*iio_dev = desc;
+
+	return 0;
+
+error_desc:
+	free(desc);
+
+	return ret;
+}
+
+/**
+ * @brief Free the resources allocated by ad4110_iio_init().
+ * @param desc - The IIO device structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int ad4110_iio_remove(struct ad4110_iio_dev *desc)
+{
+	int ret;
+
+	ret = ad4110_remove(desc->ad4110_dev);
+	if (ret)
+		return ret;
+
+	free(desc);
+
+	return 0;
+}
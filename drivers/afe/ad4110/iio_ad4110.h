@@ -0,0 +1,94 @@
+/***************************************************************************//**
+ *   @file   iio_ad4110.h
+ *   @brief  Header file of the AD4110 IIO driver.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef __IIO_AD4110_H__
+#define __IIO_AD4110_H__
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include "iio.h"
+#include "ad4110.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+/* Channels of the ADC sequencer */
+#define AD4110_IIO_CHANNELS	4
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+/**
+ * @struct ad4110_iio_dev
+ * @brief AD4110 IIO device. The buffer is filled by trigger_handler, to be
+ * called on each data ready edge: bind the device to a synchronous
+ * iio_hw_trig on the nREADY pin, NO_OS_IRQ_LEVEL_LOW.
+ */
+struct ad4110_iio_dev {
+	/** AD4110 device descriptor */
+	struct ad4110_dev	*ad4110_dev;
+	/** IIO device descriptor */
+	struct iio_device	iio_dev;
+	/** Channels enabled in the buffer */
+	uint32_t		mask;
+	/** Scan being assembled from the results of the sequencer */
+	uint32_t		scan[AD4110_IIO_CHANNELS];
+	/** Position in scan and channel expected next */
+	uint8_t			pos;
+	uint8_t			next;
+	/** data_stat setting restored when the buffer is disabled */
+	enum ad4110_state	data_stat;
+	/** Results dropped because of a wrong checksum */
+	uint32_t		crc_errors;
+	/** Scans restarted because a result of the sequence was missing */
+	uint32_t		resyncs;
+};
+
+struct ad4110_iio_init_param {
+	/** AD4110 device initialization data */
+	struct ad4110_init_param	*ad4110_init;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+int ad4110_iio_init(struct ad4110_iio_dev **iio_dev,
+		    struct ad4110_iio_init_param *init_param);
+int ad4110_iio_remove(struct ad4110_iio_dev *desc);
+
+#endif /* __IIO_AD4110_H__ */
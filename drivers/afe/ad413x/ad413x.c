@@ -50,7 +50,6 @@
 #include "no_os_crc8.h"
 #include "no_os_spi.h"
 
-NO_OS_DECLARE_CRC8_TABLE(ad413x_crc8);
 uint32_t timeout = 0xFFFFFF;
 
 /******************************************************************************/
@@ -699,8 +698,11 @@ int32_t ad413x_reg_write(struct ad413x_dev *dev,
 		return -EINVAL;
 	}
 
-	if (dev->spi_crc_en)
-		buf[data_size] = no_os_crc8(ad413x_crc8, buf, ++data_size, 0);
+	if (dev->spi_crc_en) {
+		data_size++;
+		buf[data_size] = no_os_crc8(no_os_crc8_table_07, buf,
+					    data_size, 0);
+	}
 
 	return no_os_spi_write_and_read(dev->spi_dev, buf, data_size + 1);
 }
@@ -739,7 +741,7 @@ int32_t ad413x_reg_read(struct ad413x_dev *dev,
 
 	if (dev->spi_crc_en) {
 		buf[0] = AD413X_CMD_RD_COM_REG(reg_addr);
-		crc = no_os_crc8(ad413x_crc8, buf, data_size, 0);
+		crc = no_os_crc8(no_os_crc8_table_07, buf, data_size, 0);
 		if (buf[data_size] != crc)
 			return -EBADMSG;
 		data_size--;
@@ -942,8 +944,6 @@ int32_t ad413x_init(struct ad413x_dev **device,
 	int32_t ret;
 	int32_t i;
 
-	no_os_crc8_populate_msb(ad413x_crc8, AD413X_CRC8_POLY);
-
 	dev = (struct ad413x_dev *)malloc(sizeof(*dev));
 	if (!dev)
 		return -1;
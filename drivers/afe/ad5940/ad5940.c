@@ -45,6 +45,7 @@
 #include "no_os_delay.h"
 #include "no_os_spi.h"
 #include "no_os_gpio.h"
+#include "no_os_util.h"
 #include "ad5940.h"
 
 static int AD5940_Initialize(struct ad5940_dev *dev);
@@ -200,6 +201,7 @@ int ad5940_remove(struct ad5940_dev *dev)
 	no_os_gpio_remove(dev->reset_gpio);
 	no_os_spi_remove(dev->spi);
 	dev->spi = NULL;
+	free(dev->fifo_buf);
 	free(dev);
 
 	return 0;
@@ -648,30 +650,34 @@ static int AD5940_SPIReadReg(struct no_os_spi_desc *spi, uint16_t RegAddr,
 	return 0;
 }
 
-static int AD5940_FIFORd_Fast(struct no_os_spi_desc *spi, uint32_t *pBuffer,
+static int AD5940_FIFORd_Fast(struct ad5940_dev *dev, uint32_t *pBuffer,
 			      uint32_t uiReadCount)
 {
 	int ret;
-	static uint32_t iobuf_alloc_sz = 0;
 	uint32_t iobuf_sz = 7 + uiReadCount * sizeof(uiReadCount);
-	static uint8_t *iobuf;
-	uint8_t *buf;
+	uint8_t setaddr[] = {SPICMD_SETADDR, 0, 0, 0, 0, (uint16_t)REG_AFE_DATAFIFORD >> 8, (uint8_t)REG_AFE_DATAFIFORD};
+	struct no_os_spi_msg msgs[2] = {
+		{
+			.tx_buff = setaddr,
+			.rx_buff = setaddr,
+			.bytes_number = sizeof(setaddr),
+			.cs_change = 1,
+		},
+	};
+	uint8_t *iobuf;
 	uint32_t i = 0;
 	uint32_t s = 0;
 
-	if (!iobuf_alloc_sz) {
-		iobuf = malloc(iobuf_sz);
+	/* Keep the buffer between calls, it only grows up to the watermark */
+	if (dev->fifo_buf_size < iobuf_sz) {
+		iobuf = realloc(dev->fifo_buf, iobuf_sz);
 		if (!iobuf)
 			return -ENOMEM;
-	}
-
-	if (iobuf_alloc_sz < iobuf_sz) {
-		buf = realloc(iobuf, iobuf_sz);
-		if (!buf)
-			return -ENOMEM;
 
-		iobuf = buf;
+		dev->fifo_buf = iobuf;
+		dev->fifo_buf_size = iobuf_sz;
 	}
+	iobuf = dev->fifo_buf;
 
 	// zero-out everything, needed for bytes 1 through 6 (dummy bytes).
 	memset(iobuf, 0, iobuf_sz);
@@ -680,7 +686,12 @@ static int AD5940_FIFORd_Fast(struct no_os_spi_desc *spi, uint32_t *pBuffer,
 	// set the MOSI output during last two samples to 0x44444444 for each.
 	memset(&iobuf[iobuf_sz - 8], 0x44, 8);
 
-	ret = no_os_spi_write_and_read(spi, iobuf, iobuf_sz);
+	/* Address setup and the whole FIFO read in a single SPI transfer */
+	msgs[1].tx_buff = iobuf;
+	msgs[1].rx_buff = iobuf;
+	msgs[1].bytes_number = iobuf_sz;
+	msgs[1].cs_change = 1;
+	ret = no_os_spi_transfer(dev->spi, msgs, NO_OS_ARRAY_SIZE(msgs));
 	if (ret)
 		return ret;
 
@@ -701,7 +712,7 @@ static int AD5940_FIFORd_Fast(struct no_os_spi_desc *spi, uint32_t *pBuffer,
 int ad5940_FIFORd(struct ad5940_dev *dev, uint32_t *pBuffer,
 		  uint32_t uiReadCount)
 {
-	int ret;
+	int ret = 0;
 	if (!dev)
 		return -EINVAL;
 
@@ -713,12 +724,7 @@ int ad5940_FIFORd(struct ad5940_dev *dev, uint32_t *pBuffer,
 				break;
 		}
 	} else {
-		uint8_t iobuf[] = {SPICMD_SETADDR, 0, 0, 0, 0, (uint16_t)REG_AFE_DATAFIFORD >> 8, (uint8_t)REG_AFE_DATAFIFORD};
-		ret = no_os_spi_write_and_read(dev->spi, iobuf, sizeof(iobuf));
-		if (ret)
-			return ret;
-
-		ret = AD5940_FIFORd_Fast(dev->spi, pBuffer, uiReadCount);
+		ret = AD5940_FIFORd_Fast(dev, pBuffer, uiReadCount);
 	}
 
 	return ret;
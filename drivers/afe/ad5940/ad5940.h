@@ -3978,6 +3978,9 @@ struct ad5940_dev {
 	struct no_os_gpio_desc *reset_gpio;
 	struct no_os_gpio_desc *gp0_gpio;
 	struct SeqGen SeqGenDB;
+	/* Transfer buffer of ad5940_FIFORd(), grown to the largest read */
+	uint8_t *fifo_buf;
+	uint32_t fifo_buf_size;
 };
 
 /**
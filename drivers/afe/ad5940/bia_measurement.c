@@ -38,8 +38,24 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *******************************************************************************/
 #include <errno.h>
+#include <stddef.h>
 #include "bia_measurement.h"
 
+#define BIA_SEQ_CACHE_FNV_OFFSET	2166136261u
+#define BIA_SEQ_CACHE_FNV_PRIME		16777619u
+
+/* Init and measurement sequences generated for one configuration */
+struct bia_seq_cache_entry {
+	uint32_t hash;        /* Hash of the configuration, 0 if the entry is empty */
+	uint32_t stamp;       /* Last use, the oldest entry is replaced */
+	uint32_t InitSeqLen;  /* The measurement sequence follows the init one */
+	uint32_t MeasureSeqLen;
+	uint32_t SeqCmd[BIA_SEQ_CACHE_WORDS];
+};
+
+static struct bia_seq_cache_entry bia_seq_cache[BIA_SEQ_CACHE_SIZE];
+static uint32_t bia_seq_cache_clock;
+
 /* Initial AD5940 settings */
 AppBiaCfg_Type AppBiaCfg = {
 	.SeqStartAddr = 0,
@@ -535,12 +551,109 @@ static int AppBiaRtiaCal(struct ad5940_dev *dev)
 	return 0;
 }
 
+/* Hash the parameters the sequences are generated from (FNV-1a) */
+static uint32_t AppBiaCfgHash(void)
+{
+	AppBiaCfg_Type cfg;
+	const uint8_t *p = (const uint8_t *)&cfg;
+	uint32_t hash = BIA_SEQ_CACHE_FNV_OFFSET;
+	size_t i;
+
+	/* Only the user parameters, without the flags that request the update */
+	memcpy(&cfg, &AppBiaCfg, sizeof(cfg));
+	cfg.bParamsChanged = false;
+	cfg.ReDoRtiaCal = false;
+	cfg.SweepCfg.SweepIndex = 0;
+
+	for (i = 0; i < offsetof(AppBiaCfg_Type, SweepCurrFreq); i++) {
+		hash ^= p[i];
+		hash *= BIA_SEQ_CACHE_FNV_PRIME;
+	}
+
+	/* 0 marks the empty entries */
+	return hash ? hash : 1;
+}
+
+/* Write the cached sequences of hash to the sequencer SRAM, -ENOENT if there are none */
+static int AppBiaSeqCacheLoad(struct ad5940_dev *dev, uint32_t hash)
+{
+	struct bia_seq_cache_entry *entry = NULL;
+	int ret;
+	uint32_t i;
+
+	for (i = 0; i < BIA_SEQ_CACHE_SIZE; i++) {
+		if (bia_seq_cache[i].hash == hash) {
+			entry = &bia_seq_cache[i];
+			break;
+		}
+	}
+	if (!entry)
+		return -ENOENT;
+
+	entry->stamp = ++bia_seq_cache_clock;
+
+	AppBiaCfg.InitSeqInfo.SeqId = SEQID_1;
+	AppBiaCfg.InitSeqInfo.SeqRamAddr = AppBiaCfg.SeqStartAddr;
+	AppBiaCfg.InitSeqInfo.pSeqCmd = entry->SeqCmd;
+	AppBiaCfg.InitSeqInfo.SeqLen = entry->InitSeqLen;
+	ret = ad5940_SEQCmdWrite(dev, AppBiaCfg.InitSeqInfo.SeqRamAddr,
+				 AppBiaCfg.InitSeqInfo.pSeqCmd, AppBiaCfg.InitSeqInfo.SeqLen);
+	if (ret < 0)
+		return ret;
+
+	AppBiaCfg.MeasureSeqInfo.SeqId = SEQID_0;
+	AppBiaCfg.MeasureSeqInfo.SeqRamAddr = AppBiaCfg.InitSeqInfo.SeqRamAddr +
+					      AppBiaCfg.InitSeqInfo.SeqLen;
+	AppBiaCfg.MeasureSeqInfo.pSeqCmd = entry->SeqCmd + entry->InitSeqLen;
+	AppBiaCfg.MeasureSeqInfo.SeqLen = entry->MeasureSeqLen;
+
+	return ad5940_SEQCmdWrite(dev, AppBiaCfg.MeasureSeqInfo.SeqRamAddr,
+				  AppBiaCfg.MeasureSeqInfo.pSeqCmd, AppBiaCfg.MeasureSeqInfo.SeqLen);
+}
+
+/* Get the entry replaced by the sequences of a new configuration */
+static struct bia_seq_cache_entry *AppBiaSeqCacheEntry(void)
+{
+	struct bia_seq_cache_entry *entry = &bia_seq_cache[0];
+	uint32_t i;
+
+	for (i = 1; i < BIA_SEQ_CACHE_SIZE; i++)
+		if (bia_seq_cache[i].stamp < entry->stamp)
+			entry = &bia_seq_cache[i];
+
+	entry->hash = 0;
+	entry->stamp = ++bia_seq_cache_clock;
+	entry->InitSeqLen = 0;
+	entry->MeasureSeqLen = 0;
+
+	return entry;
+}
+
+/* Copy a generated sequence to the cache entry, the entry stays empty if it does not fit */
+static bool AppBiaSeqCacheSave(struct bia_seq_cache_entry *entry,
+			       const SEQInfo_Type *pSeqInfo, uint32_t *pLen)
+{
+	uint32_t offset = entry->InitSeqLen + entry->MeasureSeqLen;
+
+	if (pSeqInfo->SeqLen > BIA_SEQ_CACHE_WORDS - offset)
+		return false;
+
+	memcpy(&entry->SeqCmd[offset], pSeqInfo->pSeqCmd,
+	       pSeqInfo->SeqLen * sizeof(entry->SeqCmd[0]));
+	*pLen = pSeqInfo->SeqLen;
+
+	return true;
+}
+
 /* This function provide application initialize.   */
 int AppBiaInit(struct ad5940_dev *dev, uint32_t *pBuffer, uint32_t BufferSize)
 {
 	int ret;
 	SEQCfg_Type seq_cfg;
 	FIFOCfg_Type fifo_cfg;
+	struct bia_seq_cache_entry *entry;
+	uint32_t hash;
+	bool cached;
 
 	ret = ad5940_WakeUp(dev, 10);
 	if (ret < 0)
@@ -595,6 +708,15 @@ int AppBiaInit(struct ad5940_dev *dev, uint32_t *pBuffer, uint32_t BufferSize)
 	/* Initialize sequencer generator */
 	if ((AppBiaCfg.BiaInited == false) ||
 	    (AppBiaCfg.bParamsChanged == true)) {
+		/* Sequences of a recently used configuration are reloaded as they are */
+		hash = AppBiaCfgHash();
+		ret = AppBiaSeqCacheLoad(dev, hash);
+		if (ret != -ENOENT) {
+			if (ret < 0)
+				return ret;
+			goto seq_ready;
+		}
+
 		if (pBuffer == 0)
 			return -EINVAL;
 		if (BufferSize == 0)
@@ -603,18 +725,27 @@ int AppBiaInit(struct ad5940_dev *dev, uint32_t *pBuffer, uint32_t BufferSize)
 		if (ret < 0)
 			return ret;
 
+		entry = AppBiaSeqCacheEntry();
+
 		/* Generate initialize sequence */
 		ret = AppBiaSeqCfgGen(
 			      dev); /* Application initialization sequence using either MCU or sequencer */
 		if (ret < 0)
 			return ret;
+		/* Both sequences are built in pBuffer, save this one before it is overwritten */
+		cached = AppBiaSeqCacheSave(entry, &AppBiaCfg.InitSeqInfo, &entry->InitSeqLen);
 
 		/* Generate measurement sequence */
 		ret = AppBiaSeqMeasureGen(dev, AppBiaCfg.bImpedanceReadMode);
 		if (ret < 0)
 			return ret;
+		if (cached && AppBiaSeqCacheSave(entry, &AppBiaCfg.MeasureSeqInfo,
+						 &entry->MeasureSeqLen))
+			entry->hash = hash;
 	}
 
+seq_ready:
+
 	/* Initialization sequencer  */
 	AppBiaCfg.InitSeqInfo.WriteSRAM = false;
 	ret = ad5940_SEQInfoCfg(dev,&AppBiaCfg.InitSeqInfo);
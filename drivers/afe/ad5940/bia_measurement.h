@@ -48,6 +48,15 @@
 
 #define MAXSWEEP_POINTS 100 /* Need to know how much buffer is needed to save RTIA calibration result */
 
+/* Number of generated sequence pairs kept, to switch between configurations without regenerating them */
+#ifndef BIA_SEQ_CACHE_SIZE
+#define BIA_SEQ_CACHE_SIZE 4
+#endif
+/* Sequencer commands stored per cached pair, init and measurement sequences together */
+#ifndef BIA_SEQ_CACHE_WORDS
+#define BIA_SEQ_CACHE_WORDS 128
+#endif
+
 /*
   Note: this example will use SEQID_0 as measurment sequence, and use SEQID_1 as init sequence.
   SEQID_3 is used for calibration.
@@ -294,6 +294,7 @@ int32_t ad5940_iio_init(struct ad5940_iio_dev **iio_dev,
 {
 	int32_t ret;
 	struct ad5940_iio_dev *desc;
+	struct iio_channel *channels;
 	AppBiaCfg_Type *pBiaCfg;
 	uint16_t ch;
 
@@ -306,17 +307,17 @@ int32_t ad5940_iio_init(struct ad5940_iio_dev **iio_dev,
 
 	desc->iio = &ad5940_iio_device;
 
-	desc->iio->channels = (struct iio_channel *)calloc(1,
-			      sizeof(struct iio_channel));
-	if (!desc->iio->channels)
+	channels = (struct iio_channel *)calloc(1, sizeof(struct iio_channel));
+	if (!channels)
 		goto error_1;
+	desc->iio->channels = channels;
 	desc->iio->num_ch = 1;
 
 	ch = 0;
-	desc->iio->channels[ch].name = "bia";
-	desc->iio->channels[ch].ch_type = IIO_VOLTAGE;
-	desc->iio->channels[ch].indexed = true;
-	desc->iio->channels[ch].attributes = ad5940_channel_attributes;
+	channels[ch].name = "bia";
+	channels[ch].ch_type = IIO_VOLTAGE;
+	channels[ch].indexed = true;
+	channels[ch].attributes = ad5940_channel_attributes;
 
 	ret = ad5940_init(&desc->ad5940, init_param->ad5940_init);
 	if (ret)
@@ -353,7 +354,7 @@ int32_t ad5940_iio_init(struct ad5940_iio_dev **iio_dev,
 
 	return 0;
 error_2:
-	free(desc->iio->channels);
+	free((void *)desc->iio->channels);
 error_1:
 	free(desc);
 
@@ -368,7 +369,7 @@ int32_t ad5940_iio_remove(struct ad5940_iio_dev *desc)
 	if (ret != 0)
 		return ret;
 
-	free(desc->iio->channels);
+	free((void *)desc->iio->channels);
 	free(desc);
 
 	return 0;
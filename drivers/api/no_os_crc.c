@@ -0,0 +1,217 @@
+/***************************************************************************//**
+ *   @file   no_os_crc.c
+ *   @brief  Implementation of the CRC engine API.
+********************************************************************************
+* Copyright 2023(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include "no_os_error.h"
+#include "no_os_alloc.h"
+#include "no_os_crc.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+/**
+ * @brief Initialize a CRC engine.
+ * @param [out] desc - Pointer to the reference of the CRC engine handler.
+ * @param [in] param - Initialization structure.
+ * @return 0 in case of success, negative error code otherwise
+ */
+int32_t no_os_crc_init(struct no_os_crc_desc **desc,
+		       const struct no_os_crc_init_param *param)
+{
+	int32_t ret;
+
+	if (!desc || !param || !param->platform_ops)
+		return -EINVAL;
+
+	if (!param->platform_ops->init)
+		return -ENOSYS;
+
+	ret = param->platform_ops->init(desc, param);
+	if (ret)
+		return ret;
+
+	(*desc)->width = param->width;
+	(*desc)->polynomial = param->polynomial;
+	(*desc)->platform_ops = param->platform_ops;
+
+	return 0;
+}
+
+/**
+ * @brief Compute the CRC over a buffer of data.
+ * @param [in] desc - Pointer to the CRC engine handler.
+ * @param [in] data - Pointer to the data buffer.
+ * @param [in] len - Number of bytes to compute the CRC over.
+ * @param [in] init - Initial value, a previous result to cascade calls.
+ * @param [out] crc - Computed CRC value.
+ * @return 0 in case of success, negative error code otherwise
+ */
+int32_t no_os_crc_compute(struct no_os_crc_desc *desc, const uint8_t *data,
+			  size_t len, uint32_t init, uint32_t *crc)
+{
+	if (!desc || !desc->platform_ops || (!data && len) || !crc)
+		return -EINVAL;
+
+	if (!desc->platform_ops->compute)
+		return -ENOSYS;
+
+	return desc->platform_ops->compute(desc, data, len, init, crc);
+}
+
+/**
+ * @brief Free the resources allocated by no_os_crc_init().
+ * @param [in] desc - Pointer to the CRC engine handler.
+ * @return 0 in case of success, negative error code otherwise
+ */
+int32_t no_os_crc_remove(struct no_os_crc_desc *desc)
+{
+	if (!desc || !desc->platform_ops)
+		return -EINVAL;
+
+	if (!desc->platform_ops->remove)
+		return -ENOSYS;
+
+	return desc->platform_ops->remove(desc);
+}
+
+/**
+ * @brief Initialize the software CRC engine, populating its slicing tables.
+ * @param [out] desc - Pointer to the reference of the CRC engine handler.
+ * @param [in] param - Initialization structure.
+ * @return 0 in case of success, negative error code otherwise
+ */
+static int32_t no_os_crc_sw_init(struct no_os_crc_desc **desc,
+				 const struct no_os_crc_init_param *param)
+{
+	struct no_os_crc_desc *d;
+	size_t entry_size;
+
+	switch (param->width) {
+	case 8:
+		entry_size = sizeof(uint8_t);
+		break;
+	case 16:
+		entry_size = sizeof(uint16_t);
+		break;
+	case 24:
+		entry_size = sizeof(uint32_t);
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	d = no_os_calloc(1, sizeof(*d));
+	if (!d)
+		return -ENOMEM;
+
+	d->extra = no_os_calloc(NO_OS_CRC_SLICES * 256, entry_size);
+	if (!d->extra) {
+		no_os_free(d);
+		return -ENOMEM;
+	}
+
+	switch (param->width) {
+	case 8:
+		no_os_crc8_populate_slice_msb(d->extra, param->polynomial);
+		break;
+	case 16:
+		no_os_crc16_populate_slice_msb(d->extra, param->polynomial);
+		break;
+	default:
+		no_os_crc24_populate_slice_msb(d->extra, param->polynomial);
+		break;
+	}
+
+	*desc = d;
+
+	return 0;
+}
+
+/**
+ * @brief Compute the CRC in software.
+ * @param [in] desc - Pointer to the CRC engine handler.
+ * @param [in] data - Pointer to the data buffer.
+ * @param [in] len - Number of bytes to compute the CRC over.
+ * @param [in] init - Initial value.
+ * @param [out] crc - Computed CRC value.
+ * @return 0 in case of success, negative error code otherwise
+ */
+static int32_t no_os_crc_sw_compute(struct no_os_crc_desc *desc,
+				    const uint8_t *data, size_t len,
+				    uint32_t init, uint32_t *crc)
+{
+	switch (desc->width) {
+	case 8:
+		*crc = no_os_crc8_slice8(desc->extra, data, len, init);
+		break;
+	case 16:
+		*crc = no_os_crc16_slice8(desc->extra, data, len, init);
+		break;
+	case 24:
+		*crc = no_os_crc24_slice8(desc->extra, data, len, init);
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Free the resources of the software CRC engine.
+ * @param [in] desc - Pointer to the CRC engine handler.
+ * @return 0 in case of success, negative error code otherwise
+ */
+static int32_t no_os_crc_sw_remove(struct no_os_crc_desc *desc)
+{
+	no_os_free(desc->extra);
+	no_os_free(desc);
+
+	return 0;
+}
+
+/**
+ * @brief Software CRC engine platform ops structure
+ */
+const struct no_os_crc_platform_ops no_os_crc_sw_ops = {
+	.init = &no_os_crc_sw_init,
+	.compute = &no_os_crc_sw_compute,
+	.remove = &no_os_crc_sw_remove
+};
@@ -0,0 +1,416 @@
+/***************************************************************************//**
+ *   @file   no_os_dma.c
+ *   @brief  Implementation of the platform independent DMA API.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include "no_os_error.h"
+#include "no_os_alloc.h"
+#include "no_os_delay.h"
+#include "no_os_dma.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Longest wait of no_os_dma_memcpy for the end of the copy */
+#define NO_OS_DMA_MEMCPY_TIMEOUT_US	1000000
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+/**
+ * @brief Initialize a DMA controller. All the channels are free.
+ * @param [out] desc - Pointer to the reference of the DMA controller handler.
+ * @param [in] param - Initialization structure.
+ * @return 0 in case of success, negative error code otherwise
+ */
+int32_t no_os_dma_init(struct no_os_dma_desc **desc,
+		       const struct no_os_dma_init_param *param)
+{
+	struct no_os_dma_desc *d;
+	uint32_t i;
+	int32_t ret;
+
+	if (!desc || !param || !param->platform_ops || !param->num_ch)
+		return -EINVAL;
+
+	if (!param->platform_ops->init)
+		return -ENOSYS;
+
+	d = no_os_calloc(1, sizeof(*d));
+	if (!d)
+		return -ENOMEM;
+
+	d->channels = no_os_calloc(param->num_ch, sizeof(*d->channels));
+	if (!d->channels) {
+		ret = -ENOMEM;
+		goto free_desc;
+	}
+
+	d->device_id = param->device_id;
+	d->num_ch = param->num_ch;
+	d->platform_ops = param->platform_ops;
+	for (i = 0; i < d->num_ch; i++) {
+		d->channels[i].desc = d;
+		d->channels[i].id = i;
+	}
+
+	ret = param->platform_ops->init(d, param);
+	if (ret)
+		goto free_channels;
+
+	*desc = d;
+
+	return 0;
+
+free_channels:
+	no_os_free(d->channels);
+free_desc:
+	no_os_free(d);
+
+	return ret;
+}
+
+/**
+ * @brief Free the resources allocated by no_os_dma_init(). The transfers
+ * still running are aborted.
+ * @param [in] desc - Pointer to the DMA controller handler.
+ * @return 0 in case of success, negative error code otherwise
+ */
+int32_t no_os_dma_remove(struct no_os_dma_desc *desc)
+{
+	uint32_t i;
+	int32_t ret;
+
+	if (!desc || !desc->platform_ops)
+		return -EINVAL;
+
+	for (i = 0; i < desc->num_ch; i++)
+		if (desc->channels[i].acquired)
+			no_os_dma_release_ch(&desc->channels[i]);
+
+	if (desc->platform_ops->remove) {
+		ret = desc->platform_ops->remove(desc);
+		if (ret)
+			return ret;
+	}
+
+	no_os_free(desc->channels);
+	no_os_free(desc);
+
+	return 0;
+}
+
+/**
+ * @brief Get a free channel of the controller.
+ * @param [in] desc - Pointer to the DMA controller handler.
+ * @param [out] ch - The channel.
+ * @return 0 in case of success, -EBUSY if all the channels are acquired,
+ * negative error code otherwise
+ */
+int32_t no_os_dma_acquire_ch(struct no_os_dma_desc *desc,
+			     struct no_os_dma_ch **ch)
+{
+	struct no_os_dma_ch *c;
+	uint32_t i;
+	int32_t ret;
+
+	if (!desc || !ch)
+		return -EINVAL;
+
+	for (i = 0; i < desc->num_ch; i++) {
+		c = &desc->channels[i];
+		if (c->acquired)
+			continue;
+
+		if (desc->platform_ops->ch_acquire) {
+			ret = desc->platform_ops->ch_acquire(c);
+			if (ret)
+				return ret;
+		}
+
+		c->acquired = true;
+		c->busy = false;
+		c->xfer = NULL;
+		*ch = c;
+
+		return 0;
+	}
+
+	return -EBUSY;
+}
+
+/**
+ * @brief Give a channel back to the controller, aborting its transfer.
+ * @param [in] ch - The channel.
+ * @return 0 in case of success, negative error code otherwise
+ */
+int32_t no_os_dma_release_ch(struct no_os_dma_ch *ch)
+{
+	int32_t ret;
+
+	if (!ch || !ch->acquired)
+		return -EINVAL;
+
+	if (ch->busy)
+		no_os_dma_xfer_abort(ch);
+
+	if (ch->desc->platform_ops->ch_release) {
+		ret = ch->desc->platform_ops->ch_release(ch);
+		if (ret)
+			return ret;
+	}
+
+	ch->xfer = NULL;
+	ch->acquired = false;
+
+	return 0;
+}
+
+/**
+ * @brief Program a transfer on a channel, to be started with
+ * no_os_dma_xfer_start(). The channel must not be busy.
+ * @param [in] ch - The channel.
+ * @param [in] xfer - The transfer, used until it is done.
+ * @return 0 in case of success, negative error code otherwise
+ */
+int32_t no_os_dma_config_xfer(struct no_os_dma_ch *ch,
+			      struct no_os_dma_xfer *xfer)
+{
+	int32_t ret;
+
+	if (!ch || !ch->acquired || !xfer || !xfer->length)
+		return -EINVAL;
+
+	/* The peripheral side may be a stream without address */
+	if ((!xfer->src && xfer->xfer_type != NO_OS_DMA_DEV_TO_MEM) ||
+	    (!xfer->dst && xfer->xfer_type != NO_OS_DMA_MEM_TO_DEV))
+		return -EINVAL;
+
+	if (xfer->width != 0 && xfer->width != 1 && xfer->width != 2 &&
+	    xfer->width != 4)
+		return -EINVAL;
+
+	if (xfer->width && xfer->length % xfer->width)
+		return -EINVAL;
+
+	if (ch->busy)
+		return -EBUSY;
+
+	if (!ch->desc->platform_ops->config_xfer)
+		return -ENOSYS;
+
+	ch->xfer = xfer;
+	ret = ch->desc->platform_ops->config_xfer(ch);
+	if (ret)
+		ch->xfer = NULL;
+
+	return ret;
+}
+
+/**
+ * @brief Start the transfer programmed on a channel.
+ * @param [in] ch - The channel.
+ * @return 0 in case of success, negative error code otherwise
+ */
+int32_t no_os_dma_xfer_start(struct no_os_dma_ch *ch)
+{
+	int32_t ret;
+
+	if (!ch || !ch->acquired || !ch->xfer)
+		return -EINVAL;
+
+	if (ch->busy)
+		return -EBUSY;
+
+	if (!ch->desc->platform_ops->xfer_start)
+		return -ENOSYS;
+
+	ch->xfer->status = 0;
+	ch->busy = true;
+	ret = ch->desc->platform_ops->xfer_start(ch);
+	if (ret)
+		ch->busy = false;
+
+	return ret;
+}
+
+/**
+ * @brief Stop the transfer of a channel, cyclic or not. The completion
+ * callback is not called.
+ * @param [in] ch - The channel.
+ * @return 0 in case of success, negative error code otherwise
+ */
+int32_t no_os_dma_xfer_abort(struct no_os_dma_ch *ch)
+{
+	int32_t ret;
+
+	if (!ch || !ch->acquired)
+		return -EINVAL;
+
+	if (!ch->busy)
+		return 0;
+
+	if (!ch->desc->platform_ops->xfer_abort)
+		return -ENOSYS;
+
+	ret = ch->desc->platform_ops->xfer_abort(ch);
+	if (ret)
+		return ret;
+
+	ch->busy = false;
+
+	return 0;
+}
+
+/**
+ * @brief Check if the transfer of a channel is done. A cyclic transfer is
+ * done only once aborted.
+ * @param [in] ch - The channel.
+ * @return true if no transfer is running on the channel.
+ */
+bool no_os_dma_is_completed(struct no_os_dma_ch *ch)
+{
+	if (!ch)
+		return true;
+
+	if (ch->busy && ch->desc->platform_ops->xfer_poll)
+		ch->desc->platform_ops->xfer_poll(ch);
+
+	return !ch->busy;
+}
+
+/**
+ * @brief Copy memory with a free channel of the controller, waiting for the
+ * end of the copy. The caches are synced for both buffers.
+ * @param [in] desc - Pointer to the DMA controller handler.
+ * @param [in] dst - Destination.
+ * @param [in] src - Source.
+ * @param [in] len - Number of bytes.
+ * @return 0 in case of success, -ETIMEDOUT if the copy did not end, the
+ * error reported by the platform driver if the copy failed, negative error
+ * code otherwise
+ */
+int32_t no_os_dma_memcpy(struct no_os_dma_desc *desc, void *dst,
+			 const void *src, uint32_t len)
+{
+	struct no_os_dma_xfer xfer = {
+		.src = (void *)src,
+		.dst = dst,
+		.length = len,
+		.xfer_type = NO_OS_DMA_MEM_TO_MEM,
+	};
+	uint32_t timeout = NO_OS_DMA_MEMCPY_TIMEOUT_US;
+	struct no_os_dma_ch *ch;
+	int32_t ret;
+
+	if (!desc || !dst || !src || !len)
+		return -EINVAL;
+
+	ret = no_os_dma_acquire_ch(desc, &ch);
+	if (ret)
+		return ret;
+
+	ret = no_os_dma_config_xfer(ch, &xfer);
+	if (ret)
+		goto release;
+
+	no_os_dma_sync_for_device(xfer.src, len, NO_OS_DMA_TO_DEVICE);
+	no_os_dma_sync_for_device(dst, len, NO_OS_DMA_FROM_DEVICE);
+	ret = no_os_dma_xfer_start(ch);
+	if (ret)
+		goto release;
+
+	while (!no_os_dma_is_completed(ch)) {
+		if (!timeout--) {
+			ret = -ETIMEDOUT;
+			goto release;
+		}
+		no_os_udelay(1);
+	}
+
+	ret = xfer.status;
+	no_os_dma_sync_for_cpu(dst, len, NO_OS_DMA_FROM_DEVICE);
+release:
+	no_os_dma_release_ch(ch);
+
+	return ret;
+}
+
+/**
+ * @brief Notify the end of the transfer of a channel. Called by the platform
+ * drivers from their interrupt handler. A cyclic transfer keeps running.
+ * @param [in] ch - The channel.
+ */
+void no_os_dma_xfer_done(struct no_os_dma_ch *ch)
+{
+	struct no_os_dma_xfer *xfer;
+
+	if (!ch || !ch->busy || !ch->xfer)
+		return;
+
+	xfer = ch->xfer;
+	if (!xfer->cyclic)
+		ch->busy = false;
+
+	if (xfer->xfer_complete_cb)
+		xfer->xfer_complete_cb(xfer, xfer->ctx);
+}
+
+/**
+ * @brief Notify the failure of the transfer of a channel. Called by the
+ * platform drivers from their interrupt handler. The transfer ends, cyclic
+ * or not, and the completion callback is called with xfer->status set.
+ * @param [in] ch - The channel.
+ * @param [in] err - Negative error code of the failure.
+ */
+void no_os_dma_xfer_error(struct no_os_dma_ch *ch, int32_t err)
+{
+	struct no_os_dma_xfer *xfer;
+
+	if (!ch || !ch->busy || !ch->xfer)
+		return;
+
+	xfer = ch->xfer;
+	xfer->status = err;
+	ch->busy = false;
+
+	if (xfer->xfer_complete_cb)
+		xfer->xfer_complete_cb(xfer, xfer->ctx);
+}
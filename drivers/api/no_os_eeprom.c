@@ -123,3 +123,20 @@ int32_t no_os_eeprom_read(struct no_os_eeprom_desc *desc, uint32_t address,
 
 	return desc->platform_ops->read(desc, address, data, bytes);
 }
+
+/**
+ * @brief Commit the writes held back by the EEPROM driver, for example in a
+ * write-back cache. Drivers writing through have nothing to do.
+ * @param desc - EEPROM descriptor
+ * @return 0 in case of success, negative error code otherwise
+ */
+int32_t no_os_eeprom_flush(struct no_os_eeprom_desc *desc)
+{
+	if (!desc || !desc->platform_ops)
+		return -EINVAL;
+
+	if (!desc->platform_ops->flush)
+		return 0;
+
+	return desc->platform_ops->flush(desc);
+}
@@ -200,8 +200,13 @@ int32_t no_os_gpio_get_direction(struct no_os_gpio_desc *desc,
  *                         NO_OS_GPIO_LOW
  * @return 0 in case of success, -1 otherwise.
  */
+#ifdef NO_OS_STATIC_OPS
+int32_t no_os_gpio_set_value_ops(struct no_os_gpio_desc *desc,
+				 uint8_t value)
+#else
 int32_t no_os_gpio_set_value(struct no_os_gpio_desc *desc,
 			     uint8_t value)
+#endif
 {
 	if (desc) {
 		if (!desc->platform_ops)
@@ -224,8 +229,13 @@ int32_t no_os_gpio_set_value(struct no_os_gpio_desc *desc,
  *                         NO_OS_GPIO_LOW
  * @return 0 in case of success, -1 otherwise.
  */
+#ifdef NO_OS_STATIC_OPS
+int32_t no_os_gpio_get_value_ops(struct no_os_gpio_desc *desc,
+				 uint8_t *value)
+#else
 int32_t no_os_gpio_get_value(struct no_os_gpio_desc *desc,
 			     uint8_t *value)
+#endif
 {
 	if (desc) {
 		if (!desc->platform_ops)
@@ -239,3 +249,58 @@ int32_t no_os_gpio_get_value(struct no_os_gpio_desc *desc,
 
 	return 0;
 }
+
+/**
+ * @brief Set the values of several GPIOs of the same port with a single
+ * register write, without skew between the pins.
+ * @param desc - The GPIO descriptor of the first pin of the group.
+ * @param mask - Pins to be set, bit n being the pin desc->number + n. The pins
+ *               must belong to the port of desc.
+ * @param values - The values, in the same order as mask.
+ * @return 0 in case of success, -EINVAL if the pins are not in the port of
+ * desc, -ENOSYS if the platform doesn't support it.
+ */
+int32_t no_os_gpio_set_multiple(struct no_os_gpio_desc *desc, uint32_t mask,
+				uint32_t values)
+{
+	if (desc) {
+		if (!desc->platform_ops)
+			return -EINVAL;
+
+		if (!desc->platform_ops->gpio_ops_set_multiple)
+			return -ENOSYS;
+
+		return desc->platform_ops->gpio_ops_set_multiple(desc, mask,
+				values);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Get the values of several GPIOs of the same port with a single
+ * register read.
+ * @param desc - The GPIO descriptor of the first pin of the group.
+ * @param mask - Pins to be read, bit n being the pin desc->number + n. The pins
+ *               must belong to the port of desc.
+ * @param values - The values, in the same order as mask. Pins not in mask read
+ *                 as 0.
+ * @return 0 in case of success, -EINVAL if the pins are not in the port of
+ * desc, -ENOSYS if the platform doesn't support it.
+ */
+int32_t no_os_gpio_get_multiple(struct no_os_gpio_desc *desc, uint32_t mask,
+				uint32_t *values)
+{
+	if (desc) {
+		if (!desc->platform_ops || !values)
+			return -EINVAL;
+
+		if (!desc->platform_ops->gpio_ops_get_multiple)
+			return -ENOSYS;
+
+		return desc->platform_ops->gpio_ops_get_multiple(desc, mask,
+				values);
+	}
+
+	return 0;
+}
@@ -133,3 +133,85 @@ int32_t no_os_i2c_read(struct no_os_i2c_desc *desc,
 	return desc->platform_ops->i2c_ops_read(desc, data, bytes_number,
 						stop_bit);
 }
+
+/**
+ * @brief Send multiple messages to/from a slave device. The messages are
+ * separated by repeated starts and a stop condition is generated after the
+ * last one. Platforms without a native transfer do it with separate read and
+ * write calls.
+ * @param desc - The I2C descriptor.
+ * @param msgs - Array of messages.
+ * @param len - Number of messages in the array.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_i2c_transfer(struct no_os_i2c_desc *desc,
+			   struct no_os_i2c_msg *msgs,
+			   uint32_t len)
+{
+	uint8_t stop_bit;
+	int32_t ret;
+	uint32_t i;
+
+	if (!desc || !desc->platform_ops || !msgs)
+		return -EINVAL;
+
+	if (desc->platform_ops->i2c_ops_transfer) {
+		ret = desc->platform_ops->i2c_ops_transfer(desc, msgs, len);
+		if (ret != -ENOSYS)
+			return ret;
+	}
+
+	for (i = 0; i < len; i++) {
+		stop_bit = (i == len - 1);
+		if (msgs[i].read)
+			ret = no_os_i2c_read(desc, msgs[i].data,
+					     msgs[i].bytes_number, stop_bit);
+		else
+			ret = no_os_i2c_write(desc, msgs[i].data,
+					      msgs[i].bytes_number, stop_bit);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Start sending messages to/from a slave device, without waiting for
+ * them. The messages and their buffers must be valid until callback is called.
+ * On platforms without asynchronous support the messages are sent with
+ * no_os_i2c_transfer() and callback is called before returning.
+ * @param desc - The I2C descriptor.
+ * @param msgs - Array of messages.
+ * @param len - Number of messages in the array.
+ * @param callback - Called, possibly from interrupt context, when the transfer
+ * 		     is done. It is only called if 0 is returned.
+ * @param ctx - Parameter passed to callback.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_i2c_transfer_async(struct no_os_i2c_desc *desc,
+				 struct no_os_i2c_msg *msgs,
+				 uint32_t len,
+				 no_os_i2c_callback callback,
+				 void *ctx)
+{
+	int32_t ret;
+
+	if (!desc || !desc->platform_ops || !msgs || !callback)
+		return -EINVAL;
+
+	if (desc->platform_ops->i2c_ops_transfer_async) {
+		ret = desc->platform_ops->i2c_ops_transfer_async(desc, msgs,
+				len, callback, ctx);
+		if (ret != -ENOSYS)
+			return ret;
+	}
+
+	ret = no_os_i2c_transfer(desc, msgs, len);
+	if (ret)
+		return ret;
+
+	callback(ctx, 0);
+
+	return 0;
+}
@@ -38,9 +38,65 @@
 *******************************************************************************/
 
 #include <inttypes.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <string.h>
 #include "no_os_spi.h"
 #include <stdlib.h>
 #include "no_os_error.h"
+#include "no_os_alloc.h"
+#include "no_os_trace.h"
+#include "no_os_hot.h"
+#include "no_os_sched.h"
+
+/**
+ * @struct no_os_spi_bus_xfer
+ * @brief Transaction queued on a shared SPI bus
+ */
+struct no_os_spi_bus_xfer {
+	/**
+	 * Position in the queue the slot is ready for. Equal to the enqueue
+	 * position when free and to the enqueue position + 1 when filled.
+	 */
+	atomic_uint		seq;
+	struct no_os_spi_desc	*desc;
+	struct no_os_spi_msg	*msgs;
+	uint32_t		len;
+	no_os_spi_callback	callback;
+	void			*ctx;
+};
+
+/**
+ * @struct no_os_spi_bus_desc
+ * @brief Shared SPI bus. Transactions are added to a bounded lock-free queue
+ * by any context. The context that finds the bus idle becomes its owner and
+ * sends everything queued, including what is added meanwhile by interrupts.
+ * An interrupt finding the bus idle thus sends the transactions queued by the
+ * threads too, from interrupt context.
+ */
+struct no_os_spi_bus_desc {
+	struct no_os_spi_bus_xfer	*queue;
+	/** Number of slots, power of 2 */
+	uint32_t			size;
+	/** Next position to be filled */
+	atomic_uint			head;
+	/** Next position to be sent. Only changed by the owner */
+	atomic_uint			tail;
+	/** Set while a context owns the bus */
+	atomic_flag			busy;
+	/** Scratch array for merged transactions */
+	struct no_os_spi_msg		*batch;
+	uint32_t			batch_size;
+};
+
+/**
+ * @struct no_os_spi_bus_wait
+ * @brief Completion of a blocking transaction on a shared bus
+ */
+struct no_os_spi_bus_wait {
+	volatile bool		done;
+	volatile int32_t	ret;
+};
 
 /**
  * @brief Initialize the SPI communication peripheral.
@@ -65,6 +121,7 @@ int32_t no_os_spi_init(struct no_os_spi_desc **desc,
 
 	(*desc)->platform_ops = param->platform_ops;
 	(*desc)->parent = param->parent;
+	(*desc)->bus = param->bus;
 
 	return 0;
 }
@@ -85,6 +142,318 @@ int32_t no_os_spi_remove(struct no_os_spi_desc *desc)
 	return desc->platform_ops->remove(desc);
 }
 
+/**
+ * @brief Send the spi messages with the platform driver.
+ * @param desc - The SPI descriptor.
+ * @param msgs - Array of messages.
+ * @param len - Number of messages in the array.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t no_os_spi_platform_transfer(struct no_os_spi_desc *desc,
+		struct no_os_spi_msg *msgs,
+		uint32_t len)
+{
+	int32_t  ret;
+	uint32_t i;
+
+	if (desc->platform_ops->transfer)
+		return desc->platform_ops->transfer(desc, msgs, len);
+
+	if (!desc->platform_ops->write_and_read)
+		return -ENOSYS;
+
+	for (i = 0; i < len; i++) {
+		if (msgs[i].rx_buff != msgs[i].tx_buff || !msgs[i].tx_buff)
+			return -EINVAL;
+		ret = desc->platform_ops->write_and_read(desc, msgs[i].rx_buff,
+				msgs[i].bytes_number);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Check if the slot at a queue position holds a transaction.
+ * @param bus - The shared bus.
+ * @param pos - Queue position.
+ * @return true if the slot is filled.
+ */
+static bool no_os_spi_bus_ready(struct no_os_spi_bus_desc *bus, uint32_t pos)
+{
+	struct no_os_spi_bus_xfer *slot = &bus->queue[pos & (bus->size - 1)];
+
+	return atomic_load_explicit(&slot->seq, memory_order_acquire) ==
+	       pos + 1;
+}
+
+/**
+ * @brief Send the transaction at the tail of the queue, merged with the
+ * following ones if they are for the same device and also ready.
+ * @param bus - The shared bus. Must be owned by the caller.
+ * @return false if the queue was empty, true otherwise.
+ */
+static bool no_os_spi_bus_process(struct no_os_spi_bus_desc *bus)
+{
+	struct no_os_spi_bus_xfer	*slot;
+	struct no_os_spi_desc		*desc;
+	no_os_spi_callback		callback;
+	uint32_t			mask = bus->size - 1;
+	uint32_t			tail;
+	uint32_t			n = 1;
+	uint32_t			nmsgs;
+	uint32_t			i;
+	int32_t				ret;
+	void				*ctx;
+
+	tail = atomic_load_explicit(&bus->tail, memory_order_relaxed);
+	if (!no_os_spi_bus_ready(bus, tail))
+		return false;
+
+	slot = &bus->queue[tail & mask];
+	desc = slot->desc;
+	nmsgs = slot->len;
+
+	while (n < bus->size && no_os_spi_bus_ready(bus, tail + n)) {
+		slot = &bus->queue[(tail + n) & mask];
+		if (slot->desc != desc || nmsgs + slot->len > bus->batch_size)
+			break;
+		nmsgs += slot->len;
+		n++;
+	}
+
+	if (n == 1) {
+		slot = &bus->queue[tail & mask];
+		ret = no_os_spi_platform_transfer(desc, slot->msgs, slot->len);
+	} else {
+		nmsgs = 0;
+		for (i = 0; i < n; i++) {
+			slot = &bus->queue[(tail + i) & mask];
+			if (!slot->len)
+				continue;
+			memcpy(&bus->batch[nmsgs], slot->msgs,
+			       slot->len * sizeof(*slot->msgs));
+			nmsgs += slot->len;
+			/* Keep CS released between the merged transactions */
+			bus->batch[nmsgs - 1].cs_change = 1;
+		}
+		ret = no_os_spi_platform_transfer(desc, bus->batch, nmsgs);
+	}
+
+	atomic_store_explicit(&bus->tail, tail + n, memory_order_relaxed);
+
+	for (i = 0; i < n; i++) {
+		slot = &bus->queue[(tail + i) & mask];
+		callback = slot->callback;
+		ctx = slot->ctx;
+		atomic_store_explicit(&slot->seq, tail + i + bus->size,
+				      memory_order_release);
+		callback(ctx, ret);
+	}
+
+	return true;
+}
+
+/**
+ * @brief Send the queued transactions if no other context is doing it.
+ * @param bus - The shared bus.
+ */
+static void no_os_spi_bus_run(struct no_os_spi_bus_desc *bus)
+{
+	uint32_t tail;
+
+	do {
+		if (atomic_flag_test_and_set_explicit(&bus->busy,
+						      memory_order_acquire))
+			return;
+
+		while (no_os_spi_bus_process(bus))
+			;
+
+		atomic_flag_clear_explicit(&bus->busy, memory_order_release);
+
+		/* Catch transactions queued after the last check */
+		tail = atomic_load_explicit(&bus->tail, memory_order_relaxed);
+	} while (no_os_spi_bus_ready(bus, tail));
+}
+
+/**
+ * @brief Add a transaction to the queue of a shared bus and start sending
+ * the queue if the bus is idle.
+ * @param desc - The SPI descriptor. Must be attached to a bus.
+ * @param msgs - Array of messages.
+ * @param len - Number of messages in the array.
+ * @param callback - Called when the transaction is done.
+ * @param ctx - Parameter passed to callback.
+ * @return 0 in case of success, -EBUSY if the queue is full.
+ */
+static int32_t no_os_spi_bus_submit(struct no_os_spi_desc *desc,
+				    struct no_os_spi_msg *msgs,
+				    uint32_t len,
+				    no_os_spi_callback callback,
+				    void *ctx)
+{
+	struct no_os_spi_bus_desc	*bus = desc->bus;
+	struct no_os_spi_bus_xfer	*slot;
+	unsigned int			pos;
+	unsigned int			seq;
+
+	pos = atomic_load_explicit(&bus->head, memory_order_relaxed);
+	while (true) {
+		slot = &bus->queue[pos & (bus->size - 1)];
+		seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+		if (seq == pos) {
+			if (atomic_compare_exchange_weak_explicit(&bus->head,
+					&pos, pos + 1, memory_order_relaxed,
+					memory_order_relaxed))
+				break;
+		} else if ((int32_t)(seq - pos) < 0) {
+			/* Full, the slot still holds the previous lap */
+			return -EBUSY;
+		} else {
+			pos = atomic_load_explicit(&bus->head,
+						   memory_order_relaxed);
+		}
+	}
+
+	slot->desc = desc;
+	slot->msgs = msgs;
+	slot->len = len;
+	slot->callback = callback;
+	slot->ctx = ctx;
+	atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+
+	no_os_spi_bus_run(bus);
+
+	return 0;
+}
+
+/**
+ * @brief Completion callback of blocking transactions on a shared bus.
+ * @param ctx - The no_os_spi_bus_wait structure of the transaction.
+ * @param ret - Result of the transaction.
+ */
+static void no_os_spi_bus_wake(void *ctx, int32_t ret)
+{
+	struct no_os_spi_bus_wait *wait = ctx;
+
+	wait->ret = ret;
+	wait->done = true;
+}
+
+/**
+ * @brief Called while a blocking transaction waits for the bus owned by
+ * another context. The default runs the scheduler works, if any. With a
+ * preemptive RTOS, override it to block the task for a while (e.g.
+ * vTaskDelay(1)), so that a lower priority owner gets to finish its transfer.
+ */
+void __attribute__((weak)) no_os_spi_bus_yield(void)
+{
+	no_os_sched_yield();
+}
+
+/**
+ * @brief Send a transaction on a shared bus and wait for it to be done.
+ * The waiter takes the bus over as soon as it is released, and otherwise
+ * yields with no_os_spi_bus_yield() so the owner can progress.
+ * Must not be called from interrupt context, where the bus may be owned by
+ * the interrupted code; no_os_spi_transfer_async() is to be used there.
+ * @param desc - The SPI descriptor. Must be attached to a bus.
+ * @param msgs - Array of messages.
+ * @param len - Number of messages in the array.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t no_os_spi_bus_transfer(struct no_os_spi_desc *desc,
+				      struct no_os_spi_msg *msgs,
+				      uint32_t len)
+{
+	struct no_os_spi_bus_wait wait = {
+		.done = false,
+	};
+	int32_t ret;
+
+	ret = no_os_spi_bus_submit(desc, msgs, len, no_os_spi_bus_wake,
+				   &wait);
+	if (ret)
+		return ret;
+
+	while (!wait.done) {
+		no_os_spi_bus_run(desc->bus);
+		if (!wait.done)
+			no_os_spi_bus_yield();
+	}
+
+	return wait.ret;
+}
+
+/**
+ * @brief Initialize a shared SPI bus.
+ * The descriptors using the bus get it in no_os_spi_init_param.bus.
+ * @param bus - The shared bus.
+ * @param param - The structure that contains the bus parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_spi_bus_init(struct no_os_spi_bus_desc **bus,
+			   const struct no_os_spi_bus_init_param *param)
+{
+	struct no_os_spi_bus_desc *b;
+	uint32_t i;
+
+	if (!bus || !param || !param->queue_size ||
+	    (param->queue_size & (param->queue_size - 1)))
+		return -EINVAL;
+
+	b = no_os_calloc(1, sizeof(*b));
+	if (!b)
+		return -ENOMEM;
+
+	b->queue = no_os_calloc(param->queue_size, sizeof(*b->queue));
+	if (!b->queue)
+		goto error;
+
+	if (param->batch_size) {
+		b->batch = no_os_calloc(param->batch_size, sizeof(*b->batch));
+		if (!b->batch)
+			goto error;
+	}
+
+	for (i = 0; i < param->queue_size; i++)
+		atomic_init(&b->queue[i].seq, i);
+	atomic_init(&b->head, 0);
+	atomic_init(&b->tail, 0);
+	atomic_flag_clear(&b->busy);
+	b->size = param->queue_size;
+	b->batch_size = param->batch_size;
+
+	*bus = b;
+
+	return 0;
+error:
+	no_os_free(b->queue);
+	no_os_free(b);
+
+	return -ENOMEM;
+}
+
+/**
+ * @brief Free the resources allocated by no_os_spi_bus_init().
+ * The queue must be empty and the descriptors using the bus removed.
+ * @param bus - The shared bus.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_spi_bus_remove(struct no_os_spi_bus_desc *bus)
+{
+	if (!bus)
+		return -EINVAL;
+
+	no_os_free(bus->batch);
+	no_os_free(bus->queue);
+	no_os_free(bus);
+
+	return 0;
+}
+
 /**
  * @brief Write and read data to/from SPI.
  * @param desc - The SPI descriptor.
@@ -92,13 +461,29 @@ int32_t no_os_spi_remove(struct no_os_spi_desc *desc)
  * @param bytes_number - Number of bytes to write/read.
  * @return 0 in case of success, -1 otherwise.
  */
-int32_t no_os_spi_write_and_read(struct no_os_spi_desc *desc,
-				 uint8_t *data,
-				 uint16_t bytes_number)
+#ifdef NO_OS_STATIC_OPS
+int32_t no_os_spi_write_and_read_ops(struct no_os_spi_desc *desc,
+				     uint8_t *data,
+				     uint16_t bytes_number)
+#else
+NO_OS_HOT int32_t no_os_spi_write_and_read(struct no_os_spi_desc *desc,
+					   uint8_t *data,
+					   uint16_t bytes_number)
+#endif
 {
+	struct no_os_spi_msg msg = {
+		.tx_buff = data,
+		.rx_buff = data,
+		.bytes_number = bytes_number,
+		.cs_change = 1,
+	};
+
 	if (!desc || !desc->platform_ops)
 		return -EINVAL;
 
+	if (desc->bus)
+		return no_os_spi_bus_transfer(desc, &msg, 1);
+
 	if (!desc->platform_ops->write_and_read)
 		return -ENOSYS;
 
@@ -116,23 +501,64 @@ int32_t no_os_spi_transfer(struct no_os_spi_desc *desc,
 			   struct no_os_spi_msg *msgs,
 			   uint32_t len)
 {
-	int32_t  ret;
-	uint32_t i;
+	int32_t ret;
 
 	if (!desc || !desc->platform_ops)
 		return -EINVAL;
 
-	if (desc->platform_ops->transfer)
-		return desc->platform_ops->transfer(desc, msgs, len);
+	NO_OS_TRACE_ENTER(NO_OS_TRACE_SPI_TRANSFER);
+	if (desc->bus)
+		ret = no_os_spi_bus_transfer(desc, msgs, len);
+	else
+		ret = no_os_spi_platform_transfer(desc, msgs, len);
+	NO_OS_TRACE_EXIT(NO_OS_TRACE_SPI_TRANSFER);
 
-	for (i = 0; i < len; i++) {
-		if (msgs[i].rx_buff != msgs[i].tx_buff || !msgs[i].tx_buff)
-			return -EINVAL;
-		ret = no_os_spi_write_and_read(desc, msgs[i].rx_buff,
-					       msgs[i].bytes_number);
-		if (NO_OS_IS_ERR_VALUE(ret))
+	return ret;
+}
+
+/**
+ * @brief Start sending the spi messages, without waiting for them.
+ * The messages and their buffers must be valid until callback is called. On
+ * platforms without asynchronous support the messages are sent with
+ * no_os_spi_transfer() and callback is called before returning.
+ * On a shared bus the messages are queued and callback is called by the
+ * context sending them, so this is safe to use from interrupts. An interrupt
+ * finding the bus idle sends the whole queue before returning, including the
+ * transactions of the threads: size the queue for that interrupt latency.
+ * @param desc - The SPI descriptor.
+ * @param msgs - Array of messages.
+ * @param len - Number of messages in the array.
+ * @param callback - Called, possibly from interrupt context, when the transfer
+ * 		     is done. It is only called if 0 is returned.
+ * @param ctx - Parameter passed to callback.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_spi_transfer_async(struct no_os_spi_desc *desc,
+				 struct no_os_spi_msg *msgs,
+				 uint32_t len,
+				 no_os_spi_callback callback,
+				 void *ctx)
+{
+	int32_t ret;
+
+	if (!desc || !desc->platform_ops || !msgs || !callback)
+		return -EINVAL;
+
+	if (desc->bus)
+		return no_os_spi_bus_submit(desc, msgs, len, callback, ctx);
+
+	if (desc->platform_ops->transfer_async) {
+		ret = desc->platform_ops->transfer_async(desc, msgs, len,
+				callback, ctx);
+		if (ret != -ENOSYS)
 			return ret;
 	}
 
+	ret = no_os_spi_transfer(desc, msgs, len);
+	if (ret)
+		return ret;
+
+	callback(ctx, 0);
+
 	return 0;
 }
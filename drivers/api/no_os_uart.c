@@ -40,7 +40,10 @@
 #include <inttypes.h>
 #include "no_os_uart.h"
 #include <stdlib.h>
+#include <string.h>
 #include "no_os_error.h"
+#include "no_os_alloc.h"
+#include "no_os_util.h"
 
 /**
  * @brief Initialize the UART communication peripheral.
@@ -186,3 +189,133 @@ void __attribute__((weak)) no_os_uart_stdio(struct no_os_uart_desc *desc)
 	/* This can optionally be implemented under drivers/platform.
 	 * It does nothing if unimplemented. */
 }
+
+/**
+ * @brief Allocate the buffers of the DMA reception. To be called by the
+ * platform drivers, before starting the DMA in circular mode on rx_dma_buf.
+ * @param desc - The UART descriptor.
+ * @param param - The structure that contains the UART parameters.
+ * @return 0 in case of success, error code otherwise.
+ */
+int32_t no_os_uart_dma_rx_init(struct no_os_uart_desc *desc,
+			       struct no_os_uart_init_param *param)
+{
+	uint32_t buff_size;
+	int32_t ret;
+
+	if (!desc || !param)
+		return -EINVAL;
+
+	desc->rx_dma_size = param->rx_dma_size ? param->rx_dma_size :
+			    NO_OS_UART_RX_DMA_SIZE;
+	buff_size = param->rx_buff_size ? param->rx_buff_size :
+		    NO_OS_UART_RX_BUFF_SIZE;
+
+	desc->rx_dma_buf = no_os_calloc(desc->rx_dma_size, 1);
+	if (!desc->rx_dma_buf)
+		return -ENOMEM;
+
+	/* Written from the interrupt handler, read from the main loop */
+	ret = no_os_cb_spsc_init(&desc->rx_cb, buff_size);
+	if (ret) {
+		no_os_free(desc->rx_dma_buf);
+		desc->rx_dma_buf = NULL;
+		return ret;
+	}
+	desc->rx_dma_pos = 0;
+	desc->rx_dropped = 0;
+
+	return 0;
+}
+
+/**
+ * @brief Free the buffers of the DMA reception. The DMA must be stopped.
+ * @param desc - The UART descriptor.
+ */
+void no_os_uart_dma_rx_remove(struct no_os_uart_desc *desc)
+{
+	if (!desc || !desc->rx_cb)
+		return;
+
+	no_os_cb_remove(desc->rx_cb);
+	desc->rx_cb = NULL;
+	no_os_free(desc->rx_dma_buf);
+	desc->rx_dma_buf = NULL;
+}
+
+/**
+ * @brief Move the bytes written by the DMA to the software buffer. To be
+ * called by the platform drivers on line idle and on half and full DMA buffer.
+ * The bytes not fitting in the software buffer are dropped and counted.
+ * @param desc - The UART descriptor.
+ * @param pos - Offset in rx_dma_buf after the last byte written by the DMA,
+ * rx_dma_size when the DMA reached the end of the buffer.
+ */
+void no_os_uart_dma_rx_update(struct no_os_uart_desc *desc, uint32_t pos)
+{
+	struct no_os_cb_regions regions;
+	uint32_t start, len, free, n, chunk, i;
+	int8_t *dst;
+
+	if (!desc || !desc->rx_cb || pos > desc->rx_dma_size)
+		return;
+
+	start = desc->rx_dma_pos;
+	if (pos >= start)
+		len = pos - start;
+	else
+		len = desc->rx_dma_size - start + pos;
+	desc->rx_dma_pos = pos % desc->rx_dma_size;
+	if (!len)
+		return;
+
+	no_os_cb_peek_write(desc->rx_cb, len, &regions);
+	free = regions.len[0] + regions.len[1];
+	desc->rx_dropped += len - free;
+
+	/* Both the DMA buffer and the software buffer may wrap */
+	for (i = 0; i < 2; i++) {
+		dst = regions.buf[i];
+		n = regions.len[i];
+		while (n) {
+			chunk = no_os_min(n, desc->rx_dma_size - start);
+			memcpy(dst, desc->rx_dma_buf + start, chunk);
+			dst += chunk;
+			n -= chunk;
+			start = (start + chunk) % desc->rx_dma_size;
+		}
+	}
+
+	no_os_cb_commit_write(desc->rx_cb, free);
+}
+
+/**
+ * @brief Read the bytes received by DMA. Non blocking.
+ * @param desc - The UART descriptor.
+ * @param data - The buffer with the received data.
+ * @param bytes_number - Maximum number of bytes to read.
+ * @return number of bytes read, -EAGAIN if nothing was received.
+ */
+int32_t no_os_uart_dma_rx_read(struct no_os_uart_desc *desc, uint8_t *data,
+			       uint32_t bytes_number)
+{
+	uint32_t size;
+	int32_t ret;
+
+	if (!desc || !desc->rx_cb || !data)
+		return -EINVAL;
+
+	ret = no_os_cb_size(desc->rx_cb, &size);
+	if (ret)
+		return ret;
+
+	size = no_os_min(size, bytes_number);
+	if (!size)
+		return -EAGAIN;
+
+	ret = no_os_cb_read(desc->rx_cb, data, size);
+	if (ret)
+		return ret;
+
+	return size;
+}
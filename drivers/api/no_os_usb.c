@@ -0,0 +1,193 @@
+/***************************************************************************//**
+ *   @file   no_os_usb.c
+ *   @brief  Implementation of the USB device bulk pipes.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include "no_os_error.h"
+#include "no_os_usb.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+/**
+ * @brief Initialize the USB device. The pipes are closed until the host
+ * opens them.
+ * @param [out] desc - Pointer to the reference of the USB device handler.
+ * @param [in] param - Initialization structure.
+ * @return 0 in case of success, negative error code otherwise
+ */
+int32_t no_os_usb_init(struct no_os_usb_desc **desc,
+		       const struct no_os_usb_init_param *param)
+{
+	uint32_t i;
+	int32_t ret;
+
+	if (!desc || !param || !param->platform_ops)
+		return -EINVAL;
+
+	if (!param->nb_pipes || param->nb_pipes > NO_OS_USB_MAX_PIPES)
+		return -EINVAL;
+
+	if (!param->platform_ops->init)
+		return -ENOSYS;
+
+	ret = param->platform_ops->init(desc, param);
+	if (ret)
+		return ret;
+
+	(*desc)->device_id = param->device_id;
+	(*desc)->nb_pipes = param->nb_pipes;
+	(*desc)->platform_ops = param->platform_ops;
+	for (i = 0; i < param->nb_pipes; i++) {
+		(*desc)->pipes[i].desc = *desc;
+		(*desc)->pipes[i].id = i;
+		(*desc)->pipes[i].open = false;
+		(*desc)->pipes[i].session = 0;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Free the resources allocated by no_os_usb_init().
+ * @param [in] desc - Pointer to the USB device handler.
+ * @return 0 in case of success, negative error code otherwise
+ */
+int32_t no_os_usb_remove(struct no_os_usb_desc *desc)
+{
+	if (!desc || !desc->platform_ops)
+		return -EINVAL;
+
+	if (!desc->platform_ops->remove)
+		return -ENOSYS;
+
+	return desc->platform_ops->remove(desc);
+}
+
+/**
+ * @brief Read the data received on a pipe, without waiting.
+ * @param [in] pipe - Pipe of the USB device.
+ * @param [out] data - Where to store the data.
+ * @param [in] len - Maximum number of bytes to read.
+ * @return Number of bytes read, -EAGAIN if none, -ENOTCONN if the pipe is
+ * closed, negative error code otherwise
+ */
+int32_t no_os_usb_read(struct no_os_usb_pipe *pipe, uint8_t *data,
+		       uint32_t len)
+{
+	struct no_os_usb_desc *desc;
+
+	if (!pipe || !pipe->desc || !data)
+		return -EINVAL;
+
+	if (!pipe->open)
+		return -ENOTCONN;
+
+	desc = pipe->desc;
+	if (!desc->platform_ops->read)
+		return -ENOSYS;
+
+	return desc->platform_ops->read(desc, pipe->id, data, len);
+}
+
+/**
+ * @brief Send data on a pipe, without waiting.
+ * @param [in] pipe - Pipe of the USB device.
+ * @param [in] data - Data to be sent.
+ * @param [in] len - Number of bytes to send.
+ * @return Number of bytes queued, -EAGAIN if none could be, -ENOTCONN if the
+ * pipe is closed, negative error code otherwise
+ */
+int32_t no_os_usb_write(struct no_os_usb_pipe *pipe, const uint8_t *data,
+			uint32_t len)
+{
+	struct no_os_usb_desc *desc;
+
+	if (!pipe || !pipe->desc || (!data && len))
+		return -EINVAL;
+
+	if (!pipe->open)
+		return -ENOTCONN;
+
+	desc = pipe->desc;
+	if (!desc->platform_ops->write)
+		return -ENOSYS;
+
+	return desc->platform_ops->write(desc, pipe->id, data, len);
+}
+
+/**
+ * @brief Handle a vendor request of the libiio USB backend. Called by the
+ * platform driver, possibly from its interrupt handler.
+ * @param [in] desc - Pointer to the USB device handler.
+ * @param [in] cmd - Request.
+ * @param [in] pipe - wValue of the request, ignored by
+ * NO_OS_USB_CMD_RESET_PIPES.
+ * @return 0 in case of success, -EINVAL for an unknown request or pipe, which
+ * the driver answers with a STALL.
+ */
+int32_t no_os_usb_pipe_ctrl(struct no_os_usb_desc *desc,
+			    enum no_os_usb_pipe_cmd cmd, uint32_t pipe)
+{
+	uint32_t i;
+
+	if (!desc)
+		return -EINVAL;
+
+	if (cmd == NO_OS_USB_CMD_RESET_PIPES) {
+		for (i = 0; i < desc->nb_pipes; i++)
+			desc->pipes[i].open = false;
+		return 0;
+	}
+
+	if (pipe >= desc->nb_pipes)
+		return -EINVAL;
+
+	switch (cmd) {
+	case NO_OS_USB_CMD_OPEN_PIPE:
+		desc->pipes[pipe].session++;
+		desc->pipes[pipe].open = true;
+		return 0;
+	case NO_OS_USB_CMD_CLOSE_PIPE:
+		desc->pipes[pipe].open = false;
+		return 0;
+	default:
+		return -EINVAL;
+	}
+}
@@ -293,6 +293,166 @@ int32_t axi_adc_delay_calibrate(struct axi_adc *adc,
 	return 0;
 }
 
+/**
+ * @brief Check that the PN sequence is received without errors, returning as
+ * soon as an error is seen. The channels must already monitor the sequence.
+ * @param adc - The device structure.
+ * @param settle_ms - Time for the PN monitor to resync.
+ * @param check_ms - Time the sequence must be received without errors.
+ * @return 0 if no error was seen, -1 otherwise.
+ */
+static int32_t axi_adc_pn_check(struct axi_adc *adc, uint32_t settle_ms,
+				uint32_t check_ms)
+{
+	uint32_t reg_data;
+	uint32_t ms;
+	uint8_t ch;
+
+	no_os_mdelay(settle_ms);
+	for (ch = 0; ch < adc->num_channels; ch++)
+		axi_adc_write(adc, AXI_ADC_REG_CHAN_STATUS(ch), 0xff);
+
+	for (ms = 0; ms < check_ms; ms++) {
+		no_os_mdelay(1);
+		for (ch = 0; ch < adc->num_channels; ch++) {
+			axi_adc_read(adc, AXI_ADC_REG_CHAN_STATUS(ch),
+				     &reg_data);
+			if (reg_data)
+				return -1;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Set a delay tap and check the PN sequence.
+ * @param adc - The device structure.
+ * @param no_of_lanes - The AXI ADC number of lanes.
+ * @param tap - Delay tap.
+ * @param cal - Calibration parameters.
+ * @return true if the tap is inside the eye.
+ */
+static bool axi_adc_delay_tap_ok(struct axi_adc *adc, uint32_t no_of_lanes,
+				 uint16_t tap,
+				 const struct axi_adc_delay_cal *cal)
+{
+	uint32_t i;
+
+	for (i = 0; i < no_of_lanes; i++)
+		axi_adc_idelay_set(adc, i, tap);
+
+	return !axi_adc_pn_check(adc, cal->settle_ms, cal->check_ms);
+}
+
+/**
+ * @brief Calibrate Delay using specific PN sequence, faster than
+ * axi_adc_delay_calibrate(). A cached eye center found in the same conditions
+ * is only verified, with its neighbor taps. Otherwise every coarse_step-th tap
+ * is checked and the edges of the widest eye found are refined tap by tap.
+ * The PN checks stop at the first error, so the taps outside of the eye cost
+ * little time.
+ * @param adc - The device structure.
+ * @param no_of_lanes - The AXI ADC number of lanes.
+ * @param sel - PN sequence.
+ * @param cal - Parameters and cache, NULL for the defaults without cache.
+ * @return Returns 0 in case of success or negative error code otherwise.
+ */
+int32_t axi_adc_delay_calibrate_fast(struct axi_adc *adc,
+				     uint32_t no_of_lanes,
+				     enum axi_adc_pn_sel sel,
+				     struct axi_adc_delay_cal *cal)
+{
+	struct axi_adc_delay_cal def = {0};
+	int16_t best_lo = -1, best_hi = -1;
+	int16_t lo = -1;
+	uint32_t reg_data;
+	uint16_t center;
+	uint16_t tap;
+	uint8_t step;
+	uint8_t ch;
+	int32_t ret;
+
+	if (!adc || !no_of_lanes)
+		return -EINVAL;
+
+	/* Same pcore version check as axi_adc_delay_set, done only once */
+	ret = axi_adc_delay_set(adc, no_of_lanes, 0);
+	if (ret)
+		return ret;
+
+	if (!cal)
+		cal = &def;
+	if (!cal->settle_ms)
+		cal->settle_ms = AXI_ADC_DELAY_CAL_SETTLE_MS;
+	if (!cal->check_ms)
+		cal->check_ms = AXI_ADC_DELAY_CAL_CHECK_MS;
+	step = cal->coarse_step ? cal->coarse_step :
+	       AXI_ADC_DELAY_CAL_COARSE_STEP;
+
+	for (ch = 0; ch < adc->num_channels; ch++) {
+		axi_adc_read(adc, AXI_ADC_REG_CHAN_CNTRL(ch), &reg_data);
+		reg_data |= AXI_ADC_ENABLE;
+		axi_adc_write(adc, AXI_ADC_REG_CHAN_CNTRL(ch), reg_data);
+		axi_adc_set_pnsel(adc, ch, sel);
+	}
+
+	center = cal->cache.center;
+	if (cal->cache.valid && cal->cache.key == cal->key &&
+	    center > 0 && center < AXI_ADC_DELAY_TAPS - 1 &&
+	    axi_adc_delay_tap_ok(adc, no_of_lanes, center - 1, cal) &&
+	    axi_adc_delay_tap_ok(adc, no_of_lanes, center + 1, cal) &&
+	    axi_adc_delay_tap_ok(adc, no_of_lanes, center, cal))
+		return 0;
+
+	/* Widest run of good coarse taps */
+	for (tap = 0; tap < AXI_ADC_DELAY_TAPS; tap += step) {
+		if (axi_adc_delay_tap_ok(adc, no_of_lanes, tap, cal)) {
+			if (lo < 0)
+				lo = tap;
+			if (best_lo < 0 || tap - lo > best_hi - best_lo) {
+				best_lo = lo;
+				best_hi = tap;
+			}
+		} else {
+			lo = -1;
+		}
+	}
+
+	/* An eye narrower than step may fall between two coarse taps */
+	for (tap = 0; best_lo < 0 && step > 1 && tap < AXI_ADC_DELAY_TAPS;
+	     tap++) {
+		if (tap % step &&
+		    axi_adc_delay_tap_ok(adc, no_of_lanes, tap, cal))
+			best_lo = best_hi = tap;
+	}
+
+	if (best_lo < 0) {
+		printf("%s FAILED.\n", __func__);
+		axi_adc_delay_set(adc, no_of_lanes, 0);
+		cal->cache.valid = false;
+		return -1;
+	}
+
+	/* Refine the edges, between the last bad and the first good taps */
+	while (best_lo > 0 &&
+	       axi_adc_delay_tap_ok(adc, no_of_lanes, best_lo - 1, cal))
+		best_lo--;
+	while (best_hi < AXI_ADC_DELAY_TAPS - 1 &&
+	       axi_adc_delay_tap_ok(adc, no_of_lanes, best_hi + 1, cal))
+		best_hi++;
+
+	center = (best_lo + best_hi) / 2;
+	printf("adc_delay: setting zero error delay (%d)\n\r", center);
+	axi_adc_delay_set(adc, no_of_lanes, center);
+
+	cal->cache.valid = true;
+	cal->cache.key = cal->key;
+	cal->cache.center = center;
+
+	return 0;
+}
+
 /**
  * @brief Calibrate phase for specific AXI ADC channel.
  * @param adc - The device structure.
@@ -43,6 +43,7 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdint.h>
+#include <stdbool.h>
 #include "no_os_util.h"
 
 /******************************************************************************/
@@ -114,6 +115,14 @@
 
 #define AXI_ADC_REG_DELAY(l)		(0x0800 + (l) * 0x4)
 
+/* Number of taps of the interface delay primitives */
+#define AXI_ADC_DELAY_TAPS		32
+
+/* Defaults of axi_adc_delay_calibrate_fast() */
+#define AXI_ADC_DELAY_CAL_SETTLE_MS	1
+#define AXI_ADC_DELAY_CAL_CHECK_MS	10
+#define AXI_ADC_DELAY_CAL_COARSE_STEP	4
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -161,6 +170,41 @@ enum axi_adc_pn_sel {
 	AXI_ADC_PN_END = 12,
 };
 
+/**
+ * @struct axi_adc_delay_cache
+ * @brief Eye center found by a previous calibration, to be kept by the
+ * application in non-volatile memory.
+ */
+struct axi_adc_delay_cache {
+	/** Set if center is valid */
+	bool valid;
+	/** Key of the conditions in which center was found */
+	uint32_t key;
+	/** Delay tap in the center of the eye */
+	uint16_t center;
+};
+
+/**
+ * @struct axi_adc_delay_cal
+ * @brief Parameters of axi_adc_delay_calibrate_fast().
+ */
+struct axi_adc_delay_cal {
+	/** Time for the PN monitor to resync after a tap change, 0: default */
+	uint32_t settle_ms;
+	/** Time a tap must run without PN errors, 0 for default */
+	uint32_t check_ms;
+	/** Distance between the taps of the coarse search, 0 for default */
+	uint8_t coarse_step;
+	/**
+	 * Identifies the board and the temperature range, for example the
+	 * serial number combined with the temperature in 10 degree steps.
+	 * The cache is only verified when it was filled with the same key.
+	 */
+	uint32_t key;
+	/** Input and output. Updated with the result of the calibration */
+	struct axi_adc_delay_cache cache;
+};
+
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
 /******************************************************************************/
@@ -206,6 +250,11 @@ int32_t axi_adc_delay_set(struct axi_adc *adc,
 int32_t axi_adc_delay_calibrate(struct axi_adc *core,
 				uint32_t no_of_lanes,
 				enum axi_adc_pn_sel sel);
+/** Calibrate Delay with a coarse then fine search and early exit checks */
+int32_t axi_adc_delay_calibrate_fast(struct axi_adc *adc,
+				     uint32_t no_of_lanes,
+				     enum axi_adc_pn_sel sel,
+				     struct axi_adc_delay_cal *cal);
 /** Calibrate phase for specific AXI ADC channel */
 int32_t axi_adc_set_calib_phase(struct axi_adc *adc,
 				uint32_t chan,
@@ -52,6 +52,9 @@
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
 /******************************************************************************/
+/* Words written at once in the DDR buffer when loading a waveform */
+#define AXI_DAC_BUF_CHUNK_WORDS			256
+
 #define AXI_DAC_REG_RSTN				0x40
 #define AXI_DAC_MMCM_RSTN				NO_OS_BIT(1)
 #define AXI_DAC_RSTN					NO_OS_BIT(0)
@@ -550,6 +553,85 @@ int32_t axi_dac_dds_get_scale(struct axi_dac *dac,
 	return 0;
 }
 
+/**
+ * @brief AXI DAC Convert a set of DDS tones to register values.
+ * The conversion is done ahead of axi_dac_dds_tones_commit(), using the
+ * frequency factor computed by axi_dac_init_finish() instead of a 64 bit
+ * division by the clock for each tone.
+ * @param dac - The device structure.
+ * @param tones - Tones of DDS channels 0 to nb_tones - 1, with the same
+ * 		  numbering as in axi_dac_dds_set_frequency().
+ * @param nb_tones - Number of tones, at most 2 * num_channels.
+ * @param regs - The register values, nb_tones elements.
+ * @return Returns 0 in case of success or negative error code otherwise.
+ */
+int32_t axi_dac_dds_tones_prepare(struct axi_dac *dac,
+				  const struct axi_dac_dds_tone *tones,
+				  uint32_t nb_tones,
+				  struct axi_dac_dds_tone_regs *regs)
+{
+	uint64_t incr, phase;
+	uint32_t scale, i;
+
+	if (!dac || !tones || !regs || nb_tones > 2 * dac->num_channels)
+		return -EINVAL;
+
+	if (!dac->dds_incr_factor)
+		return -EINVAL;
+
+	for (i = 0; i < nb_tones; i++) {
+		/* The factor is rounded up, the result is at most 1 too big */
+		incr = (tones[i].freq_hz * dac->dds_incr_factor) >> 32;
+		if (incr && incr * dac->clock_hz > tones[i].freq_hz * 0xFFFFULL)
+			incr--;
+
+		phase = (uint64_t)tones[i].phase * 0x10000ULL + (360000 / 2);
+		phase = phase / 360000;
+
+		scale = tones[i].scale_micro_units;
+		if (tones[i].scale_micro_units < 0)
+			scale = tones[i].scale_micro_units * -1;
+		scale = no_os_min(scale, 1999000);
+		scale = (uint32_t)(((uint64_t)scale * 0x4000) / 1000000);
+		if (tones[i].scale_micro_units < 0)
+			scale |= 0x8000;
+
+		regs[i].init_incr = AXI_DAC_DDS_INIT(phase) |
+				    AXI_DAC_DDS_INCR(incr) | 1;
+		regs[i].scale = AXI_DAC_DDS_SCALE(scale);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief AXI DAC Write a set of prepared DDS tones. All the channels switch to
+ * the new tones at the same time, when the single sync is issued.
+ * @param dac - The device structure.
+ * @param regs - Register values from axi_dac_dds_tones_prepare().
+ * @param nb_tones - Number of tones.
+ * @return Returns 0 in case of success or negative error code otherwise.
+ */
+int32_t axi_dac_dds_tones_commit(struct axi_dac *dac,
+				 const struct axi_dac_dds_tone_regs *regs,
+				 uint32_t nb_tones)
+{
+	uint32_t i;
+
+	if (!dac || !regs || nb_tones > 2 * dac->num_channels)
+		return -EINVAL;
+
+	axi_dac_write(dac, AXI_DAC_REG_SYNC_CONTROL, 0);
+	for (i = 0; i < nb_tones; i++) {
+		axi_dac_write(dac, AXI_DAC_REG_DDS_INIT_INCR(i),
+			      regs[i].init_incr);
+		axi_dac_write(dac, AXI_DAC_REG_DDS_SCALE(i), regs[i].scale);
+	}
+	axi_dac_write(dac, AXI_DAC_REG_SYNC_CONTROL, AXI_DAC_SYNC);
+
+	return 0;
+}
+
 /**
  * @brief AXI DAC Convert to signed magnitude format.
  * @param val - integer part
@@ -826,17 +908,29 @@ int32_t axi_dac_set_buff(struct axi_dac *dac,
 			 uint16_t *buff,
 			 uint32_t buff_size)
 {
-	uint32_t index;
-	uint32_t data_i;
-	uint32_t data_q;
-
-	for(index = 0; index < buff_size; index += 2) {
-		data_i = (buff[index]);
-		data_q = (buff[index + 1] << 16);
+	uint32_t chunk[AXI_DAC_BUF_CHUNK_WORDS];
+	uint32_t nb_words = buff_size / 2;
+	uint32_t index, nb, i;
+	int32_t ret;
 
-		no_os_axi_io_write(address, index * 2, data_i | data_q);
+	/* Pack the I/Q pairs in words, a chunk at a time */
+	for (index = 0; index < nb_words; index += nb) {
+		nb = no_os_min(nb_words - index, AXI_DAC_BUF_CHUNK_WORDS);
+		for (i = 0; i < nb; i++)
+			chunk[i] = buff[2 * (index + i)] |
+				   ((uint32_t)buff[2 * (index + i) + 1] << 16);
+
+		ret = no_os_axi_io_write_buf(address, index * sizeof(uint32_t),
+					     chunk, nb);
+		if (ret)
+			return ret;
 	}
 
+	/* Last I sample without its Q sample */
+	if (buff_size % 2)
+		return no_os_axi_io_write(address, nb_words * sizeof(uint32_t),
+					  buff[buff_size - 1]);
+
 	return 0;
 }
 
@@ -853,18 +947,33 @@ int32_t axi_dac_load_custom_data(struct axi_dac *dac,
 				 uint32_t custom_tx_count,
 				 uint32_t address)
 {
-	uint32_t index, index_mem = 0;
+	uint32_t chunk[AXI_DAC_BUF_CHUNK_WORDS];
+	uint32_t index, nb, i, max;
 	uint8_t chan;
 	uint8_t num_tx_channels = dac->num_channels / 2;
+	int32_t ret;
 
-	for(index = 0; index < custom_tx_count; index++) {
-		/* Send the same data on all the channels */
-		for (chan = 0; chan < num_tx_channels; chan++) {
-
-			no_os_axi_io_write(address, index_mem * sizeof(uint32_t),
-					   custom_data_iq[index]);
-
-			index_mem++;
+	if (num_tx_channels == 1) {
+		ret = no_os_axi_io_write_buf(address, 0, custom_data_iq,
+					     custom_tx_count);
+		if (ret)
+			return ret;
+	} else if (num_tx_channels) {
+		/* Send the same data on all the channels, a chunk at a time */
+		max = AXI_DAC_BUF_CHUNK_WORDS / num_tx_channels;
+		for (index = 0; index < custom_tx_count; index += nb) {
+			nb = no_os_min(custom_tx_count - index, max);
+			for (i = 0; i < nb; i++)
+				for (chan = 0; chan < num_tx_channels; chan++)
+					chunk[i * num_tx_channels + chan] =
+						custom_data_iq[index + i];
+
+			ret = no_os_axi_io_write_buf(address, index *
+						     num_tx_channels *
+						     sizeof(uint32_t), chunk,
+						     nb * num_tx_channels);
+			if (ret)
+				return ret;
 		}
 	}
 
@@ -923,6 +1032,9 @@ int32_t axi_dac_init_finish(struct axi_dac *dac)
 	axi_dac_read(dac, AXI_DAC_REG_CLK_RATIO, &ratio);
 	dac->clock_hz = freq * ratio;
 	dac->clock_hz = (dac->clock_hz * 390625) >> 8;
+	if (dac->clock_hz)
+		dac->dds_incr_factor = NO_OS_DIV_ROUND_UP(0xFFFFULL << 32,
+				       dac->clock_hz);
 
 	printf("%s: Successfully initialized (%"PRIu64" Hz)\n",
 	       dac->name, dac->clock_hz);
@@ -60,6 +60,8 @@ struct axi_dac {
 	uint8_t	num_channels;
 	/** AXI DAC Clock */
 	uint64_t clock_hz;
+	/** 0xFFFF / clock_hz in Q32, used to convert the tone frequencies */
+	uint64_t dds_incr_factor;
 	/** DAC channels manual configuration */
 	struct axi_dac_channel *channels;
 };
@@ -100,6 +102,31 @@ struct axi_dac_channel {
 	enum axi_dac_data_sel sel;      // set to one of the enumerated type above.
 };
 
+/**
+ * @struct axi_dac_dds_tone
+ * @brief Settings of a DDS tone, in the units of axi_dac_dds_set_frequency(),
+ * axi_dac_dds_set_phase() and axi_dac_dds_set_scale().
+ */
+struct axi_dac_dds_tone {
+	/** Frequency in Hz */
+	uint32_t freq_hz;
+	/** Phase in milli degrees (90*1000 for 90 degrees) */
+	uint32_t phase;
+	/** Scale in micro units (1*1000*1000 is 1.0) */
+	int32_t scale_micro_units;
+};
+
+/**
+ * @struct axi_dac_dds_tone_regs
+ * @brief Register values of a DDS tone, see axi_dac_dds_tones_prepare().
+ */
+struct axi_dac_dds_tone_regs {
+	/** Value of the DDS_INIT_INCR register */
+	uint32_t init_incr;
+	/** Value of the DDS_SCALE register */
+	uint32_t scale;
+};
+
 extern const uint16_t sine_lut[128];
 
 extern const uint32_t sine_lut_iq[1024];
@@ -141,6 +168,15 @@ int32_t axi_dac_dds_set_scale(struct axi_dac *dac,
 int32_t axi_dac_dds_get_scale(struct axi_dac *dac,
 			      uint32_t chan,
 			      int32_t *scale_micro_units);
+/** Convert a set of DDS tones to register values */
+int32_t axi_dac_dds_tones_prepare(struct axi_dac *dac,
+				  const struct axi_dac_dds_tone *tones,
+				  uint32_t nb_tones,
+				  struct axi_dac_dds_tone_regs *regs);
+/** Write a set of prepared DDS tones and apply them together */
+int32_t axi_dac_dds_tones_commit(struct axi_dac *dac,
+				 const struct axi_dac_dds_tone_regs *regs,
+				 uint32_t nb_tones);
 /** AXI DAC Set Buffer */
 int32_t axi_dac_set_buff(struct axi_dac *dac,
 			 uint32_t address,
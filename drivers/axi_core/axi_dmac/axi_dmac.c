@@ -46,9 +46,150 @@
 #include <stdint.h>
 #include "no_os_axi_io.h"
 #include "no_os_error.h"
+#include "no_os_alloc.h"
 #include "no_os_delay.h"
+#include "no_os_trace.h"
+#include "no_os_hot.h"
 #include "axi_dmac.h"
 
+/* The scatter-gather descriptors are allocated with no_os_dma_alloc */
+#if NO_OS_DMA_ALIGN < AXI_DMAC_HW_DESC_ALIGN
+#error "NO_OS_DMA_ALIGN is smaller than AXI_DMAC_HW_DESC_ALIGN"
+#endif
+
+/*******************************************************************************
+ * @brief Mark the current transfer as done and notify the user, if a
+ *			completion callback was registered.
+ *
+ * @param dmac - DMAC instance.
+ *
+ * @return None.
+*******************************************************************************/
+NO_OS_HOT static void axi_dmac_transfer_done(struct axi_dmac *dmac)
+{
+	void (*done_cb)(void *ctx) = dmac->done_cb;
+
+	dmac->transfer.transfer_done = true;
+	if (done_cb) {
+		/* Called only once for each transfer */
+		dmac->done_cb = NULL;
+		done_cb(dmac->done_ctx);
+	}
+}
+
+/*******************************************************************************
+ * @brief Submit sub-transfers from the descriptor queue until the hardware
+ *			submit queue is full or there is nothing left to submit.
+ *
+ * @param dmac - DMAC instance.
+ *
+ * @return None.
+*******************************************************************************/
+NO_OS_HOT static void axi_dmac_queue_submit(struct axi_dmac *dmac)
+{
+	struct axi_dma_transfer *xfer;
+	struct axi_dmac_queued *q;
+	uint32_t reg_val, chunk, id;
+
+	while (dmac->queue_idx < dmac->queue_len &&
+	       dmac->queued_cnt < AXI_DMAC_MAX_QUEUED) {
+		axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_SUBMIT, &reg_val);
+		if (reg_val & AXI_DMAC_QUEUE_FULL)
+			break;
+
+		xfer = &dmac->queue[dmac->queue_idx];
+		chunk = xfer->size - dmac->queue_offset;
+		if (chunk - 1 > dmac->max_length)
+			chunk = dmac->max_length + 1;
+
+		if (dmac->direction != DMA_MEM_TO_DEV) {
+			axi_dmac_write(dmac, AXI_DMAC_REG_DEST_ADDRESS,
+				       xfer->dest_addr + dmac->queue_offset);
+			axi_dmac_write(dmac, AXI_DMAC_REG_DEST_STRIDE, 0x0);
+		}
+		if (dmac->direction != DMA_DEV_TO_MEM) {
+			axi_dmac_write(dmac, AXI_DMAC_REG_SRC_ADDRESS,
+				       xfer->src_addr + dmac->queue_offset);
+			axi_dmac_write(dmac, AXI_DMAC_REG_SRC_STRIDE, 0x0);
+		}
+		axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH, chunk - 1);
+		axi_dmac_write(dmac, AXI_DMAC_REG_Y_LENGTH, 0x0);
+
+		/* Remember the ID in order to match it in TRANSFER_DONE. */
+		axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_ID, &id);
+		q = &dmac->queued[(dmac->queued_head + dmac->queued_cnt) %
+					       AXI_DMAC_MAX_QUEUED];
+		q->id = id;
+
+		dmac->queue_offset += chunk;
+		q->last = dmac->queue_offset == xfer->size;
+		if (q->last) {
+			dmac->queue_offset = 0;
+			dmac->queue_idx++;
+			/* Streams restart from the first segment. */
+			if (dmac->stream_cb && dmac->queue_idx == dmac->queue_len)
+				dmac->queue_idx = 0;
+		}
+		dmac->queued_cnt++;
+
+		axi_dmac_write(dmac, AXI_DMAC_REG_TRANSFER_SUBMIT,
+			       AXI_DMAC_TRANSFER_SUBMIT);
+	}
+}
+
+/*******************************************************************************
+ * @brief Retire the completed sub-transfers of the descriptor queue and refill
+ *			the hardware submit queue. Called from the ISR on EOT or while
+ *			polling when IRQ is not used.
+ *
+ * @param dmac - DMAC instance.
+ *
+ * @return None.
+*******************************************************************************/
+NO_OS_HOT static void axi_dmac_queue_service(struct axi_dmac *dmac)
+{
+	struct axi_dma_transfer *xfer;
+	struct axi_dmac_queued *q;
+	uint32_t done, i;
+
+	axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_DONE, &done);
+
+	/* Transfers complete in the order they were submitted. */
+	while (dmac->queued_cnt) {
+		q = &dmac->queued[dmac->queued_head];
+		if (!(done & NO_OS_BIT(q->id)))
+			break;
+
+		dmac->queued_head = (dmac->queued_head + 1) % AXI_DMAC_MAX_QUEUED;
+		dmac->queued_cnt--;
+		if (!q->last)
+			continue;
+
+		if (dmac->stream_cb) {
+			xfer = &dmac->queue[dmac->queue_done];
+			if (++dmac->queue_done == dmac->queue_len)
+				dmac->queue_done = 0;
+			dmac->stream_cb(dmac->stream_ctx, xfer->dest_addr,
+					xfer->size);
+		} else if (dmac->hw_desc) {
+			/* The whole descriptor chain was a single transfer. */
+			for (i = 0; i < dmac->queue_len; i++)
+				dmac->queue[i].transfer_done = true;
+			dmac->queue_done = dmac->queue_len;
+		} else {
+			dmac->queue[dmac->queue_done++].transfer_done = true;
+		}
+	}
+
+	if (!dmac->stream_cb && dmac->queue_done == dmac->queue_len) {
+		axi_dmac_transfer_done(dmac);
+		return;
+	}
+
+	if (!dmac->hw_desc)
+		axi_dmac_queue_submit(dmac);
+}
+
 /*******************************************************************************
  * @brief ISR for dev to mem DMA transfer. It computes the next transfer params,
  *			if any, and sets the transfer structure fields accordingly.
@@ -57,16 +198,24 @@
  *
  * @return None.
 *******************************************************************************/
-void axi_dmac_dev_to_mem_isr(void *instance)
+NO_OS_HOT void axi_dmac_dev_to_mem_isr(void *instance)
 {
 	struct axi_dmac *dmac = (struct axi_dmac *)instance;
 	uint32_t burst_size;
 	uint32_t reg_val;
 
+	NO_OS_TRACE_ENTER(NO_OS_TRACE_AXI_DMAC_ISR);
 	/* Get interrupt sources and clear interrupts. */
 	axi_dmac_read(dmac, AXI_DMAC_REG_IRQ_PENDING, &reg_val);
 	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_PENDING, reg_val);
 
+	if (dmac->queue) {
+		if (reg_val & AXI_DMAC_IRQ_EOT)
+			axi_dmac_queue_service(dmac);
+		NO_OS_TRACE_EXIT(NO_OS_TRACE_AXI_DMAC_ISR);
+		return;
+	}
+
 	if (reg_val & AXI_DMAC_IRQ_SOT) {
 		if (dmac->remaining_size) {
 			/* See if remaining size is bigger than max transfer size and
@@ -94,10 +243,11 @@ void axi_dmac_dev_to_mem_isr(void *instance)
 	}
 	if (reg_val & AXI_DMAC_IRQ_EOT) {
 		if (!dmac->remaining_size) {
-			dmac->transfer.transfer_done = true;
+			axi_dmac_transfer_done(dmac);
 			dmac->next_dest_addr = 0;
 		}
 	}
+	NO_OS_TRACE_EXIT(NO_OS_TRACE_AXI_DMAC_ISR);
 }
 
 /*******************************************************************************
@@ -108,16 +258,24 @@ void axi_dmac_dev_to_mem_isr(void *instance)
  *
  * @return None.
 *******************************************************************************/
-void axi_dmac_mem_to_dev_isr(void *instance)
+NO_OS_HOT void axi_dmac_mem_to_dev_isr(void *instance)
 {
 	struct axi_dmac *dmac = (struct axi_dmac *)instance;
 	uint32_t burst_size;
 	uint32_t reg_val;
 
+	NO_OS_TRACE_ENTER(NO_OS_TRACE_AXI_DMAC_ISR);
 	/* Get interrupt sources and clear interrupts. */
 	axi_dmac_read(dmac, AXI_DMAC_REG_IRQ_PENDING, &reg_val);
 	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_PENDING, reg_val);
 
+	if (dmac->queue) {
+		if (reg_val & AXI_DMAC_IRQ_EOT)
+			axi_dmac_queue_service(dmac);
+		NO_OS_TRACE_EXIT(NO_OS_TRACE_AXI_DMAC_ISR);
+		return;
+	}
+
 	if (reg_val & AXI_DMAC_IRQ_SOT) {
 		if ((dmac->transfer.cyclic == CYCLIC) &&
 		    (dmac->next_src_addr >= (dmac->init_addr + dmac->transfer.size - 1))) {
@@ -151,10 +309,12 @@ void axi_dmac_mem_to_dev_isr(void *instance)
 	}
 	if (reg_val & AXI_DMAC_IRQ_EOT) {
 		if ((!dmac->remaining_size) && (dmac->transfer.cyclic != CYCLIC)) {
-			dmac->transfer.transfer_done = true;
+			/* The callback may start the next transfer */
 			dmac->next_src_addr = 0;
+			axi_dmac_transfer_done(dmac);
 		}
 	}
+	NO_OS_TRACE_EXIT(NO_OS_TRACE_AXI_DMAC_ISR);
 }
 
 /*******************************************************************************
@@ -165,16 +325,24 @@ void axi_dmac_mem_to_dev_isr(void *instance)
  *
  * @return None.
 *******************************************************************************/
-void axi_dmac_mem_to_mem_isr(void *instance)
+NO_OS_HOT void axi_dmac_mem_to_mem_isr(void *instance)
 {
 	struct axi_dmac *dmac = (struct axi_dmac *)instance;
 	uint32_t burst_size;
 	uint32_t reg_val;
 
+	NO_OS_TRACE_ENTER(NO_OS_TRACE_AXI_DMAC_ISR);
 	/* Get interrupt sources and clear interrupts. */
 	axi_dmac_read(dmac, AXI_DMAC_REG_IRQ_PENDING, &reg_val);
 	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_PENDING, reg_val);
 
+	if (dmac->queue) {
+		if (reg_val & AXI_DMAC_IRQ_EOT)
+			axi_dmac_queue_service(dmac);
+		NO_OS_TRACE_EXIT(NO_OS_TRACE_AXI_DMAC_ISR);
+		return;
+	}
+
 	if (reg_val & AXI_DMAC_IRQ_SOT) {
 		if (dmac->remaining_size) {
 			/** See if remaining size is bigger than max transfer size and
@@ -211,12 +379,13 @@ void axi_dmac_mem_to_mem_isr(void *instance)
 	if (reg_val & AXI_DMAC_IRQ_EOT) {
 		if (!dmac->remaining_size) {
 			if(dmac->next_src_addr > (dmac->init_addr + dmac->transfer.size)) {
-				dmac->transfer.transfer_done = true;
+				axi_dmac_transfer_done(dmac);
 				dmac->next_src_addr = 0;
 				dmac->next_dest_addr = 0;
 			}
 		}
 	}
+	NO_OS_TRACE_EXIT(NO_OS_TRACE_AXI_DMAC_ISR);
 }
 
 /*******************************************************************************
@@ -228,9 +397,9 @@ void axi_dmac_mem_to_mem_isr(void *instance)
  *
  * @return 0 - success.
 *******************************************************************************/
-int32_t axi_dmac_read(struct axi_dmac *dmac,
-		      uint32_t reg_addr,
-		      uint32_t *reg_data)
+NO_OS_HOT int32_t axi_dmac_read(struct axi_dmac *dmac,
+				uint32_t reg_addr,
+				uint32_t *reg_data)
 {
 	no_os_axi_io_read(dmac->base, reg_addr, reg_data);
 
@@ -246,9 +415,9 @@ int32_t axi_dmac_read(struct axi_dmac *dmac,
  *
  * @return 0 - success.
 *******************************************************************************/
-int32_t axi_dmac_write(struct axi_dmac *dmac,
-		       uint32_t reg_addr,
-		       uint32_t reg_data)
+NO_OS_HOT int32_t axi_dmac_write(struct axi_dmac *dmac,
+				 uint32_t reg_addr,
+				 uint32_t reg_data)
 {
 	no_os_axi_io_write(dmac->base, reg_addr, reg_data);
 
@@ -297,6 +466,11 @@ static int32_t axi_dmac_detect_caps(struct axi_dmac *dmac)
 	/* Restore initial value for AXI_DMAC_REG_FLAGS register */
 	axi_dmac_write(dmac, AXI_DMAC_REG_FLAGS, initial_reg_val);
 
+	/* Check if hardware scatter-gather descriptors are supported */
+	axi_dmac_write(dmac, AXI_DMAC_REG_SG_ADDRESS, 0xffffffff);
+	axi_dmac_read(dmac, AXI_DMAC_REG_SG_ADDRESS, &reg_val);
+	dmac->hw_sg = reg_val != 0;
+
 	/* Get maximum burst size and set value. */
 	axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH, dmac->max_length);
 	axi_dmac_read(dmac, AXI_DMAC_REG_X_LENGTH, &dmac->max_length);
@@ -340,6 +514,7 @@ int32_t axi_dmac_init(struct axi_dmac **dmac_core,
 	dmac->name = init->name;
 	dmac->base = init->base;
 	dmac->irq_option = init->irq_option;
+	dmac->dcache_flush_range = init->dcache_flush_range;
 
 	*dmac_core = dmac;
 
@@ -362,6 +537,8 @@ int32_t axi_dmac_remove(struct axi_dmac *dmac)
 	if (!dmac)
 		return -1;
 
+	axi_dmac_stream_stop(dmac);
+	no_os_dma_free(dmac->hw_desc);
 	free(dmac);
 
 	return 0;
@@ -383,6 +560,10 @@ int32_t axi_dmac_transfer_start(struct axi_dmac *dmac,
 	if (dma_transfer->size == 0)
 		return 0; /* Nothing to do. */
 
+	/* Leave descriptor queue mode, if previously used. */
+	dmac->queue = NULL;
+	dmac->transfer.transfer_done = false;
+
 	/* Set current transfer parameters. */
 	dmac->transfer.size = dma_transfer->size;
 	dmac->transfer.cyclic = dma_transfer->cyclic;
@@ -424,9 +605,10 @@ int32_t axi_dmac_transfer_start(struct axi_dmac *dmac,
 		}
 	}
 
-	/* Enable DMA if not already enabled. */
+	/* Enable DMA if not already enabled (or enabled in HWDESC mode). */
 	axi_dmac_read(dmac, AXI_DMAC_REG_CTRL, &reg_val);
-	if (!(reg_val & AXI_DMAC_CTRL_ENABLE)) {
+	if ((reg_val & (AXI_DMAC_CTRL_ENABLE | AXI_DMAC_CTRL_HWDESC)) !=
+	    AXI_DMAC_CTRL_ENABLE) {
 		axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, 0x0);
 		axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, AXI_DMAC_CTRL_ENABLE);
 		axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_MASK, 0x0);
@@ -495,6 +677,400 @@ int32_t axi_dmac_transfer_start(struct axi_dmac *dmac,
 	return 0;
 }
 
+/*******************************************************************************
+ * @brief Start a DMA transfer and return without waiting for it.
+ *
+ * done is called from the DMA interrupt when the transfer completes. When IRQ
+ * is not used, completion is detected by axi_dmac_transfer_poll() which also
+ * calls done.
+ *
+ * @param dmac - DMAC istance.
+ * @param dma_transfer - Structure containing transfer details.
+ * @param done - Optional completion callback.
+ * @param ctx - Parameter to be passed to done.
+ *
+ * @return 0 for success, -1 in case of failure.
+*******************************************************************************/
+int32_t axi_dmac_transfer_start_async(struct axi_dmac *dmac,
+				      struct axi_dma_transfer *dma_transfer,
+				      void (*done)(void *ctx), void *ctx)
+{
+	int32_t ret;
+
+	dmac->done_ctx = ctx;
+	dmac->done_cb = done;
+	ret = axi_dmac_transfer_start(dmac, dma_transfer);
+	if (ret)
+		dmac->done_cb = NULL;
+
+	return ret;
+}
+
+/*******************************************************************************
+ * @brief Check, without blocking, if the current transfer is completed.
+ *
+ * @param dmac - DMAC istance.
+ *
+ * @return 0 if the transfer is completed, -EAGAIN if still in progress.
+*******************************************************************************/
+int32_t axi_dmac_transfer_poll(struct axi_dmac *dmac)
+{
+	uint32_t reg_val;
+
+	if (!dmac)
+		return -EINVAL;
+
+	if (dmac->queue) {
+		if (dmac->irq_option == IRQ_DISABLED)
+			axi_dmac_queue_service(dmac);
+
+		return dmac->transfer.transfer_done ? 0 : -EAGAIN;
+	}
+
+	if (dmac->irq_option == IRQ_DISABLED && !dmac->transfer.transfer_done) {
+		axi_dmac_read(dmac, AXI_DMAC_REG_IRQ_PENDING, &reg_val);
+		if (reg_val != (AXI_DMAC_IRQ_SOT | AXI_DMAC_IRQ_EOT))
+			return -EAGAIN;
+
+		axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_PENDING, reg_val);
+		axi_dmac_transfer_done(dmac);
+	}
+
+	return dmac->transfer.transfer_done ? 0 : -EAGAIN;
+}
+
+/*******************************************************************************
+ * @brief Initialize the descriptor queue state and enable the DMAC in the
+ *			needed mode.
+ *
+ * @param dmac - DMAC istance.
+ * @param transfers - Array of transfers.
+ * @param nb_transfers - Number of elements in transfers.
+ * @param hw_sg - Enable hardware descriptors mode.
+ *
+ * @return None
+*******************************************************************************/
+static void axi_dmac_queue_setup(struct axi_dmac *dmac,
+				 struct axi_dma_transfer *transfers,
+				 uint32_t nb_transfers, bool hw_sg)
+{
+	uint32_t reg_val, ctrl;
+
+	dmac->queue = transfers;
+	dmac->queue_len = nb_transfers;
+	dmac->queue_idx = 0;
+	dmac->queue_offset = 0;
+	dmac->queue_done = 0;
+	dmac->queued_head = 0;
+	dmac->queued_cnt = 0;
+	dmac->transfer.transfer_done = false;
+
+	/* Make sure the previous transfers are not repeated. */
+	axi_dmac_read(dmac, AXI_DMAC_REG_FLAGS, &reg_val);
+	axi_dmac_write(dmac, AXI_DMAC_REG_FLAGS, reg_val & ~DMA_CYCLIC);
+
+	ctrl = AXI_DMAC_CTRL_ENABLE;
+	if (hw_sg)
+		ctrl |= AXI_DMAC_CTRL_HWDESC;
+
+	axi_dmac_read(dmac, AXI_DMAC_REG_CTRL, &reg_val);
+	if (reg_val != ctrl) {
+		axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, 0x0);
+		axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, ctrl);
+		axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_MASK, 0x0);
+	}
+}
+
+/*******************************************************************************
+ * @brief Build the hardware descriptor chain for the queued transfers and
+ *			submit it as a single transfer.
+ *
+ * @param dmac - DMAC istance.
+ *
+ * @return 0 for success, negative error code otherwise.
+*******************************************************************************/
+static int32_t axi_dmac_hw_sg_start(struct axi_dmac *dmac)
+{
+	struct axi_dmac_hw_desc *desc;
+	uint32_t i, nb_desc, offset, chunk, id;
+
+	/* Each transfer is split in chunks of at most max_length + 1 bytes. */
+	nb_desc = 0;
+	for (i = 0; i < dmac->queue_len; i++)
+		nb_desc += (dmac->queue[i].size - 1) / ((uint64_t)dmac->max_length + 1)
+			   + 1;
+
+	no_os_dma_free(dmac->hw_desc);
+	dmac->hw_desc = no_os_dma_alloc(nb_desc * sizeof(*desc));
+	if (!dmac->hw_desc) {
+		dmac->queue = NULL;
+		return -ENOMEM;
+	}
+
+	desc = dmac->hw_desc;
+	for (i = 0; i < dmac->queue_len; i++) {
+		offset = 0;
+		while (offset < dmac->queue[i].size) {
+			chunk = dmac->queue[i].size - offset;
+			if (chunk - 1 > dmac->max_length)
+				chunk = dmac->max_length + 1;
+
+			desc->dest_addr = dmac->queue[i].dest_addr + offset;
+			desc->src_addr = dmac->queue[i].src_addr + offset;
+			desc->x_len = chunk - 1;
+			desc->next_sg_addr = (uintptr_t)(desc + 1);
+			offset += chunk;
+			desc++;
+		}
+	}
+	desc--;
+	desc->next_sg_addr = 0;
+	desc->flags = AXI_DMAC_HW_FLAG_LAST | AXI_DMAC_HW_FLAG_IRQ;
+
+	if (dmac->dcache_flush_range)
+		dmac->dcache_flush_range((uintptr_t)dmac->hw_desc,
+					 nb_desc * sizeof(*desc));
+	else
+		no_os_dma_sync_for_device(dmac->hw_desc,
+					  nb_desc * sizeof(*desc),
+					  NO_OS_DMA_TO_DEVICE);
+
+	axi_dmac_write(dmac, AXI_DMAC_REG_SG_ADDRESS, (uintptr_t)dmac->hw_desc);
+	axi_dmac_write(dmac, AXI_DMAC_REG_SG_ADDRESS_HIGH, 0x0);
+
+	axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_ID, &id);
+	dmac->queued[dmac->queued_head].id = id;
+	dmac->queued[dmac->queued_head].last = true;
+	dmac->queued_cnt = 1;
+	dmac->queue_idx = dmac->queue_len;
+
+	axi_dmac_write(dmac, AXI_DMAC_REG_TRANSFER_SUBMIT,
+		       AXI_DMAC_TRANSFER_SUBMIT);
+
+	return 0;
+}
+
+/*******************************************************************************
+ * @brief Start a list of DMA transfers.
+ *
+ * The transfers are executed in order, without software intervention between
+ * them. When the core supports hardware scatter-gather the whole list is
+ * described by descriptors in memory, otherwise the hardware submit queue is
+ * kept full from the EOT interrupt (or from
+ * axi_dmac_transfer_wait_completion() when IRQ is not used).
+ * The transfer_done flag of each element is set when it completes. The list
+ * must remain valid until all transfers are done.
+ *
+ * @param dmac - DMAC istance.
+ * @param transfers - Array of transfers. Cyclic transfers are not supported.
+ * @param nb_transfers - Number of elements in transfers.
+ *
+ * @return 0 for success, negative error code otherwise.
+*******************************************************************************/
+int32_t axi_dmac_transfer_queue(struct axi_dmac *dmac,
+				struct axi_dma_transfer *transfers,
+				uint32_t nb_transfers)
+{
+	uint32_t i;
+
+	if (!dmac || !transfers || !nb_transfers)
+		return -EINVAL;
+
+	if (dmac->direction == INVALID_DIR)
+		return -EINVAL;
+
+	for (i = 0; i < nb_transfers; i++) {
+		if (!transfers[i].size || transfers[i].cyclic == CYCLIC)
+			return -EINVAL;
+		transfers[i].transfer_done = false;
+	}
+
+	dmac->stream_cb = NULL;
+	axi_dmac_queue_setup(dmac, transfers, nb_transfers, dmac->hw_sg);
+
+	if (dmac->hw_sg)
+		return axi_dmac_hw_sg_start(dmac);
+
+	no_os_dma_free(dmac->hw_desc);
+	dmac->hw_desc = NULL;
+	axi_dmac_queue_submit(dmac);
+
+	return 0;
+}
+
+/*******************************************************************************
+ * @brief Start continuous DEV_TO_MEM streaming into a ring of segments.
+ *
+ * The memory starting at addr is split in nb_segments segments of
+ * segment_size bytes. The DMAC fills them in order and restarts from the
+ * first one after the last, without stopping. segment_done is called from the
+ * EOT interrupt each time a segment is filled, and the data in it must be
+ * consumed before the DMAC wraps around to it again (nb_segments - 1
+ * segments later). Requires IRQ_ENABLED.
+ *
+ * @param dmac - DMAC istance.
+ * @param addr - Start address of the ring.
+ * @param segment_size - Size in bytes of a segment.
+ * @param nb_segments - Number of segments. At least 2.
+ * @param segment_done - Callback called with the address and size of the
+ *			filled segment.
+ * @param ctx - Parameter to be passed to segment_done.
+ *
+ * @return 0 for success, negative error code otherwise.
+*******************************************************************************/
+int32_t axi_dmac_stream_start(struct axi_dmac *dmac, uint32_t addr,
+			      uint32_t segment_size, uint32_t nb_segments,
+			      void (*segment_done)(void *ctx, uint32_t addr,
+					      uint32_t size),
+			      void *ctx)
+{
+	struct axi_dma_transfer *segs;
+	uint32_t i;
+
+	if (!dmac || !segment_size || nb_segments < 2 || !segment_done)
+		return -EINVAL;
+
+	if (dmac->direction != DMA_DEV_TO_MEM ||
+	    dmac->irq_option != IRQ_ENABLED)
+		return -EINVAL;
+
+	axi_dmac_stream_stop(dmac);
+
+	segs = (struct axi_dma_transfer *)calloc(nb_segments, sizeof(*segs));
+	if (!segs)
+		return -ENOMEM;
+
+	for (i = 0; i < nb_segments; i++) {
+		segs[i].size = segment_size;
+		segs[i].cyclic = NO;
+		segs[i].dest_addr = addr + i * segment_size;
+	}
+
+	no_os_dma_free(dmac->hw_desc);
+	dmac->hw_desc = NULL;
+	dmac->stream_segs = segs;
+	dmac->stream_ctx = ctx;
+	dmac->stream_cb = segment_done;
+	axi_dmac_queue_setup(dmac, segs, nb_segments, false);
+	axi_dmac_queue_submit(dmac);
+
+	return 0;
+}
+
+/*******************************************************************************
+ * @brief Stop a stream started with axi_dmac_stream_start().
+ *
+ * @param dmac - DMAC istance.
+ *
+ * @return None
+*******************************************************************************/
+void axi_dmac_stream_stop(struct axi_dmac *dmac)
+{
+	if (!dmac || !dmac->stream_cb)
+		return;
+
+	axi_dmac_transfer_stop(dmac);
+	dmac->stream_cb = NULL;
+	dmac->queue = NULL;
+	free(dmac->stream_segs);
+	dmac->stream_segs = NULL;
+}
+
+/*******************************************************************************
+ * @brief Check if a cyclic transfer queued by axi_dmac_cyclic_switch() is still
+ *			waiting for the running one to reach its end.
+ *
+ * @param dmac - DMAC instance.
+ *
+ * @return true while the running transfer was not replaced.
+*******************************************************************************/
+bool axi_dmac_cyclic_pending(struct axi_dmac *dmac)
+{
+	uint32_t done;
+
+	if (!dmac || !dmac->cyclic_switching)
+		return false;
+
+	axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_DONE, &done);
+	if (!(done & NO_OS_BIT(dmac->cyclic_id)))
+		return true;
+
+	dmac->cyclic_id = dmac->cyclic_next_id;
+	dmac->cyclic_switching = false;
+
+	return false;
+}
+
+/*******************************************************************************
+ * @brief Start a hardware cyclic MEM_TO_DEV transfer or replace the running
+ *			one without stopping the DMAC.
+ *
+ * Cyclic transfers are submitted with DMA_LAST, so the DMAC finishes the
+ * current pass over the buffer and then continues with the transfer waiting
+ * in its queue. The output switches from the last sample of the old buffer to
+ * the first sample of the new one, with no gap. The memory of the old buffer
+ * can be reused once axi_dmac_cyclic_pending() returns false.
+ *
+ * @param dmac - DMAC instance.
+ * @param dma_transfer - Cyclic transfer, of at most max_length + 1 bytes.
+ *
+ * @return 0 for success, -EBUSY if a previous switch is still pending,
+ *			negative error code otherwise.
+*******************************************************************************/
+int32_t axi_dmac_cyclic_switch(struct axi_dmac *dmac,
+			       struct axi_dma_transfer *dma_transfer)
+{
+	uint32_t reg_val, id;
+
+	if (!dmac || !dma_transfer || !dma_transfer->size ||
+	    dma_transfer->cyclic != CYCLIC)
+		return -EINVAL;
+
+	if (dmac->direction != DMA_MEM_TO_DEV || !dmac->hw_cyclic ||
+	    dma_transfer->size - 1 > dmac->max_length)
+		return -ENOTSUP;
+
+	if (axi_dmac_cyclic_pending(dmac))
+		return -EBUSY;
+
+	axi_dmac_read(dmac, AXI_DMAC_REG_CTRL, &reg_val);
+	if (dmac->queue || dmac->transfer.cyclic != CYCLIC ||
+	    (reg_val & (AXI_DMAC_CTRL_ENABLE | AXI_DMAC_CTRL_HWDESC)) !=
+	    AXI_DMAC_CTRL_ENABLE) {
+		/* Nothing is playing, start from a clean state */
+		axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, AXI_DMAC_CTRL_DISABLE);
+		axi_dmac_write(dmac, AXI_DMAC_REG_FLAGS, DMA_CYCLIC | DMA_LAST);
+		axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_ID, &dmac->cyclic_id);
+
+		return axi_dmac_transfer_start(dmac, dma_transfer);
+	}
+
+	axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_SUBMIT, &reg_val);
+	if (reg_val & AXI_DMAC_QUEUE_FULL)
+		return -EBUSY;
+
+	axi_dmac_write(dmac, AXI_DMAC_REG_FLAGS, DMA_CYCLIC | DMA_LAST);
+	axi_dmac_write(dmac, AXI_DMAC_REG_SRC_ADDRESS, dma_transfer->src_addr);
+	axi_dmac_write(dmac, AXI_DMAC_REG_SRC_STRIDE, 0x0);
+	axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH, dma_transfer->size - 1);
+	axi_dmac_write(dmac, AXI_DMAC_REG_Y_LENGTH, 0x0);
+	axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_ID, &id);
+
+	/* Same state as after axi_dmac_transfer_start(), for the ISR */
+	dmac->transfer.size = dma_transfer->size;
+	dmac->transfer.src_addr = dma_transfer->src_addr;
+	dmac->init_addr = dma_transfer->src_addr;
+	dmac->next_src_addr = dma_transfer->src_addr + dma_transfer->size;
+	dmac->remaining_size = 0;
+	dmac->cyclic_next_id = id;
+	dmac->cyclic_switching = true;
+
+	axi_dmac_write(dmac, AXI_DMAC_REG_TRANSFER_SUBMIT,
+		       AXI_DMAC_TRANSFER_SUBMIT);
+
+	return 0;
+}
+
 /*******************************************************************************
  * @brief Wait for DMA transfer to be completed.
  *
@@ -509,6 +1085,23 @@ int32_t axi_dmac_transfer_wait_completion(struct axi_dmac *dmac,
 	uint32_t timeout = 0;
 	uint32_t reg_val = 0;
 
+	if (dmac->queue) {
+		while (dmac->queue_done != dmac->queue_len) {
+			if (dmac->irq_option == IRQ_DISABLED)
+				axi_dmac_queue_service(dmac);
+			if (dmac->queue_done == dmac->queue_len)
+				break;
+			timeout++;
+			no_os_mdelay(1);
+			if (timeout == timeout_ms) {
+				printf("Error transferring data using DMA.\n");
+				return -1;
+			}
+		}
+
+		return 0;
+	}
+
 	if (dmac->irq_option == IRQ_ENABLED) {
 		while (!dmac->transfer.transfer_done) {
 			timeout++;
@@ -545,3 +1138,236 @@ void axi_dmac_transfer_stop(struct axi_dmac *dmac)
 {
 	axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, AXI_DMAC_CTRL_DISABLE);
 }
+
+#ifdef NO_OS_AMP
+/*******************************************************************************
+ * @brief Stream segment callback of axi_dmac_amp_step(), reporting the filled
+ *			segment to the application core.
+ *
+ * @param ctx - AMP link.
+ * @param addr - Address of the filled segment.
+ * @param size - Size of the filled segment.
+ *
+ * @return None.
+*******************************************************************************/
+static void axi_dmac_amp_segment_done(void *ctx, uint32_t addr, uint32_t size)
+{
+	struct no_os_amp_msg msg = {
+		.cmd = NO_OS_AMP_CMD_BLOCK,
+		.addr = addr,
+		.size = size,
+		.count = 1,
+	};
+
+	no_os_amp_respond(ctx, &msg);
+}
+
+/*******************************************************************************
+ * @brief Serve the requests of the application core, on the core owning the
+ *			DMAC in an AMP system.
+ *
+ * A START request streams into the blocks it describes, as
+ * axi_dmac_stream_start() does, and each filled block is reported from the EOT
+ * interrupt. A STOP request stops the stream and is acknowledged once no more
+ * blocks can be reported, so the responses always have a single producer. To
+ * be called in the main loop of the core owning the DMAC.
+ *
+ * @param dmac - DMAC istance, with IRQ enabled.
+ * @param link - Link to the application core.
+ *
+ * @return 0 for success, negative error code otherwise.
+*******************************************************************************/
+int32_t axi_dmac_amp_step(struct axi_dmac *dmac, struct no_os_amp_link *link)
+{
+	struct no_os_amp_msg msg;
+	int32_t ret;
+
+	if (!dmac || !link)
+		return -EINVAL;
+
+	while (!no_os_amp_get_request(link, &msg)) {
+		switch (msg.cmd) {
+		case NO_OS_AMP_CMD_START:
+			ret = axi_dmac_stream_start(dmac, msg.addr, msg.size,
+						    msg.count,
+						    axi_dmac_amp_segment_done,
+						    link);
+			break;
+		case NO_OS_AMP_CMD_STOP:
+			axi_dmac_stream_stop(dmac);
+			ret = 0;
+			break;
+		default:
+			ret = -EINVAL;
+			break;
+		}
+
+		if (ret) {
+			msg.cmd = NO_OS_AMP_CMD_ERROR;
+			msg.count = (uint32_t)ret;
+		} else if (msg.cmd == NO_OS_AMP_CMD_STOP) {
+			msg.cmd = NO_OS_AMP_CMD_STOPPED;
+		} else {
+			continue;
+		}
+
+		no_os_amp_respond(link, &msg);
+	}
+
+	return 0;
+}
+#endif
+
+/*******************************************************************************
+ * @brief Completion callback of the no_os_dma transfers.
+ *
+ * @param ctx - no_os_dma channel.
+ *
+ * @return None.
+*******************************************************************************/
+static void axi_dmac_dma_done(void *ctx)
+{
+	no_os_dma_xfer_done(ctx);
+}
+
+/*******************************************************************************
+ * @brief Initialize a no_os_dma controller of one AXI DMAC, its only channel.
+ *
+ * @param desc - no_os_dma controller.
+ * @param param - Initialization parameters, extra being an axi_dmac_init.
+ *
+ * @return 0 for success, negative error code otherwise.
+*******************************************************************************/
+static int32_t axi_dmac_dma_init(struct no_os_dma_desc *desc,
+				 const struct no_os_dma_init_param *param)
+{
+	struct axi_dmac *dmac;
+	int32_t ret;
+
+	if (!param->extra || param->num_ch != 1)
+		return -EINVAL;
+
+	desc->channels[0].extra = calloc(1, sizeof(struct axi_dma_transfer));
+	if (!desc->channels[0].extra)
+		return -ENOMEM;
+
+	ret = axi_dmac_init(&dmac, param->extra);
+	if (ret) {
+		free(desc->channels[0].extra);
+		return ret;
+	}
+
+	desc->extra = dmac;
+
+	return 0;
+}
+
+/*******************************************************************************
+ * @brief Free the resources of a no_os_dma controller of an AXI DMAC.
+ *
+ * @param desc - no_os_dma controller.
+ *
+ * @return 0 for success, negative error code otherwise.
+*******************************************************************************/
+static int32_t axi_dmac_dma_remove(struct no_os_dma_desc *desc)
+{
+	free(desc->channels[0].extra);
+
+	return axi_dmac_remove(desc->extra);
+}
+
+/*******************************************************************************
+ * @brief Program a no_os_dma transfer. The direction is fixed by the HDL
+ * configuration of the core and the stream side has no address.
+ *
+ * @param ch - no_os_dma channel.
+ *
+ * @return 0 for success, negative error code otherwise.
+*******************************************************************************/
+static int32_t axi_dmac_dma_config_xfer(struct no_os_dma_ch *ch)
+{
+	static const enum dma_direction dirs[] = {
+		[NO_OS_DMA_MEM_TO_MEM] = DMA_MEM_TO_MEM,
+		[NO_OS_DMA_MEM_TO_DEV] = DMA_MEM_TO_DEV,
+		[NO_OS_DMA_DEV_TO_MEM] = DMA_DEV_TO_MEM,
+	};
+	struct axi_dmac *dmac = ch->desc->extra;
+	struct axi_dma_transfer *transfer = ch->extra;
+	struct no_os_dma_xfer *xfer = ch->xfer;
+
+	if (dirs[xfer->xfer_type] != dmac->direction)
+		return -EINVAL;
+
+	if (xfer->cyclic && !dmac->hw_cyclic)
+		return -ENOTSUP;
+
+	transfer->size = xfer->length;
+	transfer->cyclic = xfer->cyclic ? CYCLIC : NO;
+	transfer->src_addr = xfer->xfer_type == NO_OS_DMA_DEV_TO_MEM ? 0 :
+			     (uintptr_t)xfer->src;
+	transfer->dest_addr = xfer->xfer_type == NO_OS_DMA_MEM_TO_DEV ? 0 :
+			      (uintptr_t)xfer->dst;
+
+	return 0;
+}
+
+/*******************************************************************************
+ * @brief Start a no_os_dma transfer. The end of a cyclic transfer is not
+ * reported, the core only interrupts once it is stopped.
+ *
+ * @param ch - no_os_dma channel.
+ *
+ * @return 0 for success, negative error code otherwise.
+*******************************************************************************/
+static int32_t axi_dmac_dma_xfer_start(struct no_os_dma_ch *ch)
+{
+	struct axi_dma_transfer *transfer = ch->extra;
+
+	transfer->transfer_done = false;
+	if (transfer->cyclic == CYCLIC)
+		return axi_dmac_transfer_start(ch->desc->extra, transfer);
+
+	return axi_dmac_transfer_start_async(ch->desc->extra, transfer,
+					     axi_dmac_dma_done, ch);
+}
+
+/*******************************************************************************
+ * @brief Stop a no_os_dma transfer.
+ *
+ * @param ch - no_os_dma channel.
+ *
+ * @return 0 for success.
+*******************************************************************************/
+static int32_t axi_dmac_dma_xfer_abort(struct no_os_dma_ch *ch)
+{
+	struct axi_dmac *dmac = ch->desc->extra;
+
+	dmac->done_cb = NULL;
+	axi_dmac_transfer_stop(dmac);
+
+	return 0;
+}
+
+/*******************************************************************************
+ * @brief Check the end of a no_os_dma transfer of a core used without IRQ.
+ *
+ * @param ch - no_os_dma channel.
+ *
+ * @return None.
+*******************************************************************************/
+static void axi_dmac_dma_xfer_poll(struct no_os_dma_ch *ch)
+{
+	axi_dmac_transfer_poll(ch->desc->extra);
+}
+
+/**
+ * @brief no_os_dma platform ops of the AXI DMAC
+ */
+const struct no_os_dma_platform_ops axi_dmac_dma_ops = {
+	.init = axi_dmac_dma_init,
+	.remove = axi_dmac_dma_remove,
+	.config_xfer = axi_dmac_dma_config_xfer,
+	.xfer_start = axi_dmac_dma_xfer_start,
+	.xfer_abort = axi_dmac_dma_xfer_abort,
+	.xfer_poll = axi_dmac_dma_xfer_poll,
+};
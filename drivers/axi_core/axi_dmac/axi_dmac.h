@@ -44,6 +44,10 @@
 /******************************************************************************/
 #include <stdint.h>
 #include "no_os_util.h"
+#include "no_os_dma.h"
+#ifdef NO_OS_AMP
+#include "no_os_amp.h"
+#endif
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -62,6 +66,7 @@
 #define AXI_DMAC_CTRL_ENABLE		NO_OS_BIT(0)
 #define AXI_DMAC_CTRL_DISABLE		0u
 #define AXI_DMAC_CTRL_PAUSE			NO_OS_BIT(1)
+#define AXI_DMAC_CTRL_HWDESC		NO_OS_BIT(2)
 
 #define AXI_DMAC_REG_TRANSFER_ID		0x404
 #define AXI_DMAC_REG_TRANSFER_SUBMIT	0x408
@@ -75,6 +80,15 @@
 #define AXI_DMAC_REG_DEST_STRIDE		0x420
 #define AXI_DMAC_REG_SRC_STRIDE			0x424
 #define AXI_DMAC_REG_TRANSFER_DONE		0x428
+#define AXI_DMAC_REG_SG_ADDRESS			0x47c
+#define AXI_DMAC_REG_SG_ADDRESS_HIGH	0x4bc
+
+#define AXI_DMAC_HW_FLAG_LAST			NO_OS_BIT(0)
+#define AXI_DMAC_HW_FLAG_IRQ			NO_OS_BIT(1)
+#define AXI_DMAC_HW_DESC_ALIGN			64
+
+/* Maximum number of sub-transfers tracked in the hardware submit queue */
+#define AXI_DMAC_MAX_QUEUED				8
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -111,12 +125,36 @@ struct axi_dma_transfer {
 	uint32_t dest_addr;
 };
 
+/* Hardware scatter-gather descriptor, as read by the DMAC from memory */
+struct axi_dmac_hw_desc {
+	uint32_t flags;
+	uint32_t id;
+	uint64_t dest_addr;
+	uint64_t src_addr;
+	uint64_t next_sg_addr;
+	uint32_t y_len;
+	uint32_t x_len;
+	uint32_t src_stride;
+	uint32_t dst_stride;
+	uint64_t pad[2];
+};
+
+/* Sub-transfer submitted to the hardware queue */
+struct axi_dmac_queued {
+	/* Transfer ID read from AXI_DMAC_REG_TRANSFER_ID when submitted */
+	uint32_t id;
+	/* Set if it is the last sub-transfer of a descriptor */
+	bool last;
+};
+
 struct axi_dmac {
 	const char *name;
 	uint32_t base;
 	enum use_irq irq_option;
 	enum dma_direction direction;
 	bool hw_cyclic;
+	/* Set if the core supports hardware scatter-gather descriptors */
+	bool hw_sg;
 	uint32_t max_length;
 	volatile struct axi_dma_transfer transfer;
 	//Current sub-transfer properties
@@ -124,12 +162,46 @@ struct axi_dmac {
 	uint32_t remaining_size;
 	uint32_t next_src_addr;
 	uint32_t next_dest_addr;
+	/* Descriptor list given to axi_dmac_transfer_queue() */
+	struct axi_dma_transfer *queue;
+	uint32_t queue_len;
+	/* Descriptor and offset of the next sub-transfer to be submitted */
+	uint32_t queue_idx;
+	uint32_t queue_offset;
+	/* Number of completed descriptors */
+	volatile uint32_t queue_done;
+	/* Sub-transfers in the hardware queue, in submit order */
+	struct axi_dmac_queued queued[AXI_DMAC_MAX_QUEUED];
+	uint32_t queued_head;
+	uint32_t queued_cnt;
+	/* Scatter-gather hardware descriptors, from no_os_dma_alloc */
+	struct axi_dmac_hw_desc *hw_desc;
+	/* Completion callback, see axi_dmac_transfer_start_async() */
+	void (*done_cb)(void *ctx);
+	void *done_ctx;
+	/* Stream segments and callback, see axi_dmac_stream_start() */
+	struct axi_dma_transfer *stream_segs;
+	void (*stream_cb)(void *ctx, uint32_t addr, uint32_t size);
+	void *stream_ctx;
+	/*
+	 * Called to make the hardware descriptors visible to the DMAC, instead
+	 * of no_os_dma_sync_for_device
+	 */
+	void (*dcache_flush_range)(uint32_t address, uint32_t bytes_count);
+	/* ID of the running cyclic transfer, see axi_dmac_cyclic_switch() */
+	uint32_t cyclic_id;
+	/* ID of the cyclic transfer queued to replace it */
+	uint32_t cyclic_next_id;
+	/* Set until the queued cyclic transfer replaced the running one */
+	bool cyclic_switching;
 };
 
 struct axi_dmac_init {
 	const char *name;
 	uint32_t base;
 	enum use_irq irq_option;
+	/* Optional. Used to flush hardware scatter-gather descriptors */
+	void (*dcache_flush_range)(uint32_t address, uint32_t bytes_count);
 };
 
 /******************************************************************************/
@@ -149,8 +221,30 @@ int32_t axi_dmac_init(struct axi_dmac **adc_core,
 int32_t axi_dmac_remove(struct axi_dmac *dmac);
 int32_t axi_dmac_transfer_start(struct axi_dmac *dmac,
 				struct axi_dma_transfer *dma_transfer);
+int32_t axi_dmac_transfer_start_async(struct axi_dmac *dmac,
+				      struct axi_dma_transfer *dma_transfer,
+				      void (*done)(void *ctx), void *ctx);
+int32_t axi_dmac_transfer_poll(struct axi_dmac *dmac);
+int32_t axi_dmac_transfer_queue(struct axi_dmac *dmac,
+				struct axi_dma_transfer *transfers,
+				uint32_t nb_transfers);
+int32_t axi_dmac_stream_start(struct axi_dmac *dmac, uint32_t addr,
+			      uint32_t segment_size, uint32_t nb_segments,
+			      void (*segment_done)(void *ctx, uint32_t addr,
+					      uint32_t size),
+			      void *ctx);
+void axi_dmac_stream_stop(struct axi_dmac *dmac);
+int32_t axi_dmac_cyclic_switch(struct axi_dmac *dmac,
+			       struct axi_dma_transfer *dma_transfer);
+bool axi_dmac_cyclic_pending(struct axi_dmac *dmac);
 int32_t axi_dmac_transfer_wait_completion(struct axi_dmac *dmac,
 		uint32_t timeout_ms);
 void axi_dmac_transfer_stop(struct axi_dmac *dmac);
+#ifdef NO_OS_AMP
+int32_t axi_dmac_amp_step(struct axi_dmac *dmac, struct no_os_amp_link *link);
+#endif
+
+/* no_os_dma ops, a controller being one core and init_param.extra its init */
+extern const struct no_os_dma_platform_ops axi_dmac_dma_ops;
 
 #endif
@@ -99,6 +99,40 @@
 #define MMCM_REG_FILTER1			0x4e
 #define MMCM_REG_FILTER2			0x4f
 
+enum axi_clkgen_drp_idx {
+	AXI_CLKGEN_DRP_CLKOUT0_1,
+	AXI_CLKGEN_DRP_CLKOUT0_2,
+	AXI_CLKGEN_DRP_CLKOUT1_1,
+	AXI_CLKGEN_DRP_CLKOUT1_2,
+	AXI_CLKGEN_DRP_CLK_DIV,
+	AXI_CLKGEN_DRP_CLK_FB1,
+	AXI_CLKGEN_DRP_CLK_FB2,
+	AXI_CLKGEN_DRP_LOCK1,
+	AXI_CLKGEN_DRP_LOCK2,
+	AXI_CLKGEN_DRP_LOCK3,
+	AXI_CLKGEN_DRP_FILTER1,
+	AXI_CLKGEN_DRP_FILTER2,
+};
+
+/* Address and bits written by set_rate of each entry of the DRP shadow */
+static const struct {
+	uint32_t reg;
+	uint32_t mask;
+} axi_clkgen_drp_regs[AXI_CLKGEN_DRP_SHADOW_SIZE] = {
+	[AXI_CLKGEN_DRP_CLKOUT0_1] = { MMCM_REG_CLKOUT0_1, 0xefff },
+	[AXI_CLKGEN_DRP_CLKOUT0_2] = { MMCM_REG_CLKOUT0_2, 0x03ff },
+	[AXI_CLKGEN_DRP_CLKOUT1_1] = { MMCM_REG_CLKOUT1_1, 0xefff },
+	[AXI_CLKGEN_DRP_CLKOUT1_2] = { MMCM_REG_CLKOUT1_2, 0x03ff },
+	[AXI_CLKGEN_DRP_CLK_DIV] = { MMCM_REG_CLK_DIV, 0x3fff },
+	[AXI_CLKGEN_DRP_CLK_FB1] = { MMCM_REG_CLK_FB1, 0xefff },
+	[AXI_CLKGEN_DRP_CLK_FB2] = { MMCM_REG_CLK_FB2, 0x03ff },
+	[AXI_CLKGEN_DRP_LOCK1] = { MMCM_REG_LOCK1, 0x3ff },
+	[AXI_CLKGEN_DRP_LOCK2] = { MMCM_REG_LOCK2, 0x7fff },
+	[AXI_CLKGEN_DRP_LOCK3] = { MMCM_REG_LOCK3, 0x7fff },
+	[AXI_CLKGEN_DRP_FILTER1] = { MMCM_REG_FILTER1, 0x9900 },
+	[AXI_CLKGEN_DRP_FILTER2] = { MMCM_REG_FILTER2, 0x9900 },
+};
+
 static const uint32_t axi_clkgen_filter_table[] = {
 	0x01001990, 0x01001190, 0x01009890, 0x01001890,
 	0x01008890, 0x01009090, 0x01009090, 0x01009090,
@@ -181,9 +215,9 @@ int32_t axi_clkgen_read(struct axi_clkgen *clkgen,
 /**
  * @brief axi_clkgen_mmcm_read
  */
-static void axi_clkgen_mmcm_read(struct axi_clkgen *clkgen,
-				 uint32_t reg,
-				 uint32_t *val)
+static int32_t axi_clkgen_mmcm_read(struct axi_clkgen *clkgen,
+				    uint32_t reg,
+				    uint32_t *val)
 {
 	uint32_t timeout = 1000000;
 	uint32_t reg_val;
@@ -193,7 +227,7 @@ static void axi_clkgen_mmcm_read(struct axi_clkgen *clkgen,
 	} while ((reg_val & AXI_CLKGEN_DRP_STATUS_BUSY) && --timeout);
 
 	if (timeout == 0) {
-		return;
+		return -ETIMEDOUT;
 	}
 
 	reg_val = AXI_CLKGEN_DRP_CNTRL_SEL |
@@ -205,19 +239,46 @@ static void axi_clkgen_mmcm_read(struct axi_clkgen *clkgen,
 	} while ((*val & AXI_CLKGEN_DRP_STATUS_BUSY) && --timeout);
 
 	if (timeout == 0) {
-		return;
+		return -ETIMEDOUT;
 	}
 
 	*val &= 0xffff;
+
+	return 0;
+}
+
+/**
+ * @brief axi_clkgen_drp_get - Value of an MMCM register of the shadow, read
+ * from the core the first time.
+ */
+static int32_t axi_clkgen_drp_get(struct axi_clkgen *clkgen,
+				  enum axi_clkgen_drp_idx idx,
+				  uint32_t *val)
+{
+	int32_t ret;
+
+	if (clkgen->drp_shadow_valid & NO_OS_BIT(idx)) {
+		*val = clkgen->drp_shadow[idx];
+		return 0;
+	}
+
+	ret = axi_clkgen_mmcm_read(clkgen, axi_clkgen_drp_regs[idx].reg, val);
+	if (ret)
+		return ret;
+
+	clkgen->drp_shadow[idx] = *val;
+	clkgen->drp_shadow_valid |= NO_OS_BIT(idx);
+
+	return 0;
 }
 
 /**
  * @brief axi_clkgen_mmcm_write
  */
-void axi_clkgen_mmcm_write(struct axi_clkgen *clkgen,
-			   uint32_t reg,
-			   uint32_t val,
-			   uint32_t mask)
+int32_t axi_clkgen_mmcm_write(struct axi_clkgen *clkgen,
+			      uint32_t reg,
+			      uint32_t val,
+			      uint32_t mask)
 {
 	uint32_t timeout = 1000000;
 	uint32_t reg_val;
@@ -227,7 +288,7 @@ void axi_clkgen_mmcm_write(struct axi_clkgen *clkgen,
 	} while ((reg_val & AXI_CLKGEN_DRP_STATUS_BUSY) && --timeout);
 
 	if (timeout == 0) {
-		return;
+		return -ETIMEDOUT;
 	}
 
 	if (mask != 0xffff) {
@@ -240,6 +301,8 @@ void axi_clkgen_mmcm_write(struct axi_clkgen *clkgen,
 	reg_val |= AXI_CLKGEN_DRP_CNTRL_SEL | (reg << 16) | (val & mask);
 
 	axi_clkgen_write(clkgen, AXI_CLKGEN_REG_DRP_CNTRL, reg_val);
+
+	return 0;
 }
 
 /**
@@ -380,6 +443,44 @@ void axi_clkgen_calc_params(struct axi_clkgen *axi_clkgen,
 	}
 }
 
+/**
+ * @brief axi_clkgen_get_params - Dividers for a rate, from the cache of the
+ * last rates or from axi_clkgen_calc_params().
+ */
+static void axi_clkgen_get_params(struct axi_clkgen *clkgen,
+				  uint32_t rate,
+				  uint32_t *d,
+				  uint32_t *m,
+				  uint32_t *dout)
+{
+	struct axi_clkgen_params *params;
+	uint32_t i;
+
+	for (i = 0; i < AXI_CLKGEN_PARAMS_CACHE_SIZE; i++) {
+		params = &clkgen->params_cache[i];
+		if (params->rate == rate &&
+		    params->parent_rate == clkgen->parent_rate) {
+			*d = params->d;
+			*m = params->m;
+			*dout = params->dout;
+			return;
+		}
+	}
+
+	axi_clkgen_calc_params(clkgen, clkgen->parent_rate, rate, d, m, dout);
+	if (*d == 0 || *m == 0 || *dout == 0)
+		return;
+
+	params = &clkgen->params_cache[clkgen->params_next];
+	params->parent_rate = clkgen->parent_rate;
+	params->rate = rate;
+	params->d = *d;
+	params->m = *m;
+	params->dout = *dout;
+	clkgen->params_next = (clkgen->params_next + 1) %
+			      AXI_CLKGEN_PARAMS_CACHE_SIZE;
+}
+
 /**
  * @brief axi_clkgen_calc_clk_params
  */
@@ -413,11 +514,14 @@ static void axi_clkgen_mmcm_enable(struct axi_clkgen *clkgen,
 }
 
 /**
- * @brief axi_clkgen_set_rate
+ * @brief axi_clkgen_set_rate - Only the MMCM registers whose content changes
+ * are written, the MMCM is left running when none does.
  */
 int32_t axi_clkgen_set_rate(struct axi_clkgen *clkgen,
 			    uint32_t rate)
 {
+	uint32_t vals[AXI_CLKGEN_DRP_SHADOW_SIZE];
+	uint32_t changed = 0;
 	uint32_t d		 = 0;
 	uint32_t m		 = 0;
 	uint32_t dout	 = 0;
@@ -428,11 +532,14 @@ int32_t axi_clkgen_set_rate(struct axi_clkgen *clkgen,
 	uint32_t filter  = 0;
 	uint32_t lock	 = 0;
 	uint32_t reg_val;
+	uint32_t mask;
+	uint32_t i;
+	int32_t ret;
 
 	if (clkgen->parent_rate == 0 || rate == 0)
 		return 0;
 
-	axi_clkgen_calc_params(clkgen, clkgen->parent_rate, rate, &d, &m, &dout);
+	axi_clkgen_get_params(clkgen, rate, &d, &m, &dout);
 
 	if (d == 0 || dout == 0 || m == 0)
 		return 0;
@@ -440,35 +547,61 @@ int32_t axi_clkgen_set_rate(struct axi_clkgen *clkgen,
 	filter = axi_clkgen_lookup_filter(m - 1);
 	lock = axi_clkgen_lookup_lock(m - 1);
 
-	axi_clkgen_mmcm_enable(clkgen, 0);
-
 	axi_clkgen_calc_clk_params(dout, &low, &high, &edge, &nocount);
-	axi_clkgen_mmcm_write(clkgen, MMCM_REG_CLKOUT0_1, (high << 6) | low, 0xefff);
-	axi_clkgen_mmcm_write(clkgen, MMCM_REG_CLKOUT0_2, (edge << 7) | (nocount << 6),
-			      0x03ff);
+	vals[AXI_CLKGEN_DRP_CLKOUT0_1] = (high << 6) | low;
+	vals[AXI_CLKGEN_DRP_CLKOUT0_2] = (edge << 7) | (nocount << 6);
 
 	dout *= 4;
 	axi_clkgen_calc_clk_params(dout, &low, &high, &edge, &nocount);
-	axi_clkgen_mmcm_write(clkgen, MMCM_REG_CLKOUT1_1, (high << 6) | low, 0xefff);
-	axi_clkgen_mmcm_write(clkgen, MMCM_REG_CLKOUT1_2, (edge << 7) | (nocount << 6),
-			      0x03ff);
+	vals[AXI_CLKGEN_DRP_CLKOUT1_1] = (high << 6) | low;
+	vals[AXI_CLKGEN_DRP_CLKOUT1_2] = (edge << 7) | (nocount << 6);
 
 	axi_clkgen_calc_clk_params(d, &low, &high, &edge, &nocount);
-	axi_clkgen_mmcm_write(clkgen, MMCM_REG_CLK_DIV,
-			      (edge << 13) | (nocount << 12) | (high << 6) | low, 0x3fff);
+	vals[AXI_CLKGEN_DRP_CLK_DIV] = (edge << 13) | (nocount << 12) |
+				       (high << 6) | low;
 
 	axi_clkgen_calc_clk_params(m, &low, &high, &edge, &nocount);
-	axi_clkgen_mmcm_write(clkgen, MMCM_REG_CLK_FB1, (high << 6) | low, 0xefff);
-	axi_clkgen_mmcm_write(clkgen, MMCM_REG_CLK_FB2, (edge << 7) | (nocount << 6),
-			      0x03ff);
-
-	axi_clkgen_mmcm_write(clkgen, MMCM_REG_LOCK1, lock & 0x3ff, 0x3ff);
-	axi_clkgen_mmcm_write(clkgen, MMCM_REG_LOCK2,
-			      (((lock >> 16) & 0x1f) << 10) | 0x1, 0x7fff);
-	axi_clkgen_mmcm_write(clkgen, MMCM_REG_LOCK3,
-			      (((lock >> 24) & 0x1f) << 10) | 0x3e9, 0x7fff);
-	axi_clkgen_mmcm_write(clkgen, MMCM_REG_FILTER1, filter >> 16, 0x9900);
-	axi_clkgen_mmcm_write(clkgen, MMCM_REG_FILTER2, filter, 0x9900);
+	vals[AXI_CLKGEN_DRP_CLK_FB1] = (high << 6) | low;
+	vals[AXI_CLKGEN_DRP_CLK_FB2] = (edge << 7) | (nocount << 6);
+
+	vals[AXI_CLKGEN_DRP_LOCK1] = lock & 0x3ff;
+	vals[AXI_CLKGEN_DRP_LOCK2] = (((lock >> 16) & 0x1f) << 10) | 0x1;
+	vals[AXI_CLKGEN_DRP_LOCK3] = (((lock >> 24) & 0x1f) << 10) | 0x3e9;
+	vals[AXI_CLKGEN_DRP_FILTER1] = filter >> 16;
+	vals[AXI_CLKGEN_DRP_FILTER2] = filter;
+
+	/* Merge with the bits not touched and find the registers to write */
+	for (i = 0; i < AXI_CLKGEN_DRP_SHADOW_SIZE; i++) {
+		ret = axi_clkgen_drp_get(clkgen, i, &reg_val);
+		if (ret)
+			return ret;
+
+		mask = axi_clkgen_drp_regs[i].mask;
+		vals[i] = (reg_val & ~mask) | (vals[i] & mask);
+		if (vals[i] != reg_val)
+			changed |= NO_OS_BIT(i);
+	}
+
+	if (!changed) {
+		axi_clkgen_read(clkgen, AXI_CLKGEN_REG_STATUS, &reg_val);
+		if (reg_val & AXI_CLKGEN_STATUS)
+			return 0;
+	}
+
+	axi_clkgen_mmcm_enable(clkgen, 0);
+
+	for (i = 0; i < AXI_CLKGEN_DRP_SHADOW_SIZE; i++) {
+		if (!(changed & NO_OS_BIT(i)))
+			continue;
+
+		ret = axi_clkgen_mmcm_write(clkgen, axi_clkgen_drp_regs[i].reg,
+					    vals[i], 0xffff);
+		if (ret) {
+			clkgen->drp_shadow_valid = 0;
+			return ret;
+		}
+		clkgen->drp_shadow[i] = vals[i];
+	}
 
 	axi_clkgen_mmcm_enable(clkgen, 1);
 
@@ -492,14 +625,15 @@ int32_t axi_clkgen_set_rate(struct axi_clkgen *clkgen,
 int32_t axi_clkgen_get_rate(struct axi_clkgen *clkgen, uint32_t *rate)
 {
 	uint32_t d, m, dout;
-	uint32_t reg;
+	uint32_t reg = 0;
 	uint64_t tmp;
 
-	axi_clkgen_mmcm_read(clkgen, MMCM_REG_CLKOUT0_1, &reg);
+
+	axi_clkgen_drp_get(clkgen, AXI_CLKGEN_DRP_CLKOUT0_1, &reg);
 	dout = (reg & 0x3f) + ((reg >> 6) & 0x3f);
-	axi_clkgen_mmcm_read(clkgen, MMCM_REG_CLK_DIV, &reg);
+	axi_clkgen_drp_get(clkgen, AXI_CLKGEN_DRP_CLK_DIV, &reg);
 	d = (reg & 0x3f) + ((reg >> 6) & 0x3f);
-	axi_clkgen_mmcm_read(clkgen, MMCM_REG_CLK_FB1, &reg);
+	axi_clkgen_drp_get(clkgen, AXI_CLKGEN_DRP_CLK_FB1, &reg);
 	m = (reg & 0x3f) + ((reg >> 6) & 0x3f);
 
 	if (d == 0 || dout == 0) {
@@ -526,7 +660,7 @@ int32_t axi_clkgen_init(struct axi_clkgen **clk,
 {
 	struct axi_clkgen *clkgen;
 
-	clkgen = (struct axi_clkgen *)malloc(sizeof(*clkgen));
+	clkgen = (struct axi_clkgen *)calloc(1, sizeof(*clkgen));
 	if (!clkgen)
 		return -1;
 
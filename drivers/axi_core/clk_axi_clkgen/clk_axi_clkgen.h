@@ -44,13 +44,38 @@
 /******************************************************************************/
 #include <stdint.h>
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+#define AXI_CLKGEN_PARAMS_CACHE_SIZE	4
+/* MMCM registers programmed by axi_clkgen_set_rate() */
+#define AXI_CLKGEN_DRP_SHADOW_SIZE	12
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
+struct axi_clkgen_params {
+	/* Rates the dividers were computed for, 0 for an unused entry */
+	uint32_t	parent_rate;
+	uint32_t	rate;
+	/* Input divider, feedback multiplier and output divider */
+	uint32_t	d;
+	uint32_t	m;
+	uint32_t	dout;
+};
+
 struct axi_clkgen {
 	const char	*name;
 	uint32_t	base;
 	uint32_t	parent_rate;
+	/* Dividers of the last rates, skipping the search when reused */
+	struct axi_clkgen_params params_cache[AXI_CLKGEN_PARAMS_CACHE_SIZE];
+	/* Entry replaced by the next search */
+	uint32_t	params_next;
+	/* Content of the MMCM registers, only the changed ones are written */
+	uint16_t	drp_shadow[AXI_CLKGEN_DRP_SHADOW_SIZE];
+	/* Bit n set when drp_shadow[n] is known */
+	uint32_t	drp_shadow_valid;
 };
 
 struct axi_clkgen_init {
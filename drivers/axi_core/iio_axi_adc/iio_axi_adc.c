@@ -46,7 +46,10 @@
 #include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "no_os_error.h"
+#include "no_os_delay.h"
+#include "no_os_alloc.h"
 #include "iio.h"
 #include "iio_axi_adc.h"
 
@@ -56,6 +59,27 @@
 
 #define STORAGE_BITS 16
 
+/* Time given to the DMA core to acknowledge a stop request */
+#define IIO_AXI_ADC_AMP_STOP_MS	100
+
+/* Attributes of the triggered capture, the priv of iio_window_attributes */
+enum iio_axi_adc_window_attr {
+	IIO_AXI_ADC_PRETRIGGER_SAMPLES,
+	IIO_AXI_ADC_TRIGGER_MODE,
+	IIO_AXI_ADC_TRIGGER_CHANNEL,
+	IIO_AXI_ADC_TRIGGER_THRESHOLD,
+	IIO_AXI_ADC_WINDOWS_LOST,
+};
+
+static const char * const iio_axi_adc_trigger_names[] = {
+	[IIO_AXI_ADC_TRIG_EXTERNAL] = "external",
+	[IIO_AXI_ADC_TRIG_RISING] = "rising",
+	[IIO_AXI_ADC_TRIG_FALLING] = "falling",
+};
+
+#define IIO_AXI_ADC_NB_TRIGGERS \
+	NO_OS_ARRAY_SIZE(iio_axi_adc_trigger_names)
+
 /**
  * @brief get_cf_calibphase().
  * @param device - Physical instance of a iio_axi_adc_desc device.
@@ -310,6 +334,7 @@ static struct iio_attribute iio_voltage_attributes[] = {
 		.name = "calibscale",
 		.show = get_calibscale,
 		.store = set_calibscale,
+		.cache_ms = IIO_ATTR_CACHE_UNTIL_WRITE,
 	},
 	{
 		.name = "samples_pps",
@@ -320,6 +345,144 @@ static struct iio_attribute iio_voltage_attributes[] = {
 		.name = "sampling_frequency",
 		.show = get_sampling_frequency,
 		.store = set_sampling_frequency,
+		/* The clock may be changed through the transceiver device */
+		.cache_ms = 1000,
+	},
+	END_ATTRIBUTES_ARRAY
+};
+
+/**
+ * @brief Show a setting of the triggered capture.
+ * @param device - Physical instance of a iio_axi_adc_desc device.
+ * @param buf - Where value is stored.
+ * @param len - Maximum length of value to be stored in buf.
+ * @param channel - Channel properties.
+ * @param priv - Setting, from enum iio_axi_adc_window_attr.
+ * @return Length of chars written in buf, or negative value on failure.
+ */
+static int get_window_attr(void *device, char *buf, uint32_t len,
+			   const struct iio_ch_info *channel, intptr_t priv)
+{
+	struct iio_axi_adc_desc *iio_adc = (struct iio_axi_adc_desc *)device;
+	struct iio_axi_adc_window *w = &iio_adc->window;
+	uint32_t i;
+	int n = 0;
+
+	switch (priv) {
+	case IIO_AXI_ADC_PRETRIGGER_SAMPLES:
+		return snprintf(buf, len, "%"PRIu32"", w->pretrigger_samples);
+	case IIO_AXI_ADC_TRIGGER_MODE:
+		return snprintf(buf, len, "%s",
+				iio_axi_adc_trigger_names[w->trigger]);
+	case IIO_AXI_ADC_TRIGGER_CHANNEL:
+		return snprintf(buf, len, "%"PRIu32"", w->threshold_ch);
+	case IIO_AXI_ADC_TRIGGER_THRESHOLD:
+		return snprintf(buf, len, "%"PRIi16"", w->threshold);
+	case IIO_AXI_ADC_WINDOWS_LOST:
+		return snprintf(buf, len, "%"PRIu32"", w->lost);
+	default:
+		/* trigger_mode_available */
+		for (i = 0; i < IIO_AXI_ADC_NB_TRIGGERS; i++)
+			n += snprintf(buf + n, len - n, "%s%s", i ? " " : "",
+				      iio_axi_adc_trigger_names[i]);
+		return n;
+	}
+}
+
+/**
+ * @brief Store a setting of the triggered capture, used from the next time
+ * the capture is armed.
+ * @param device - Physical instance of a iio_axi_adc_desc device.
+ * @param buf - Value to be written to attribute.
+ * @param len - Length of the data in "buf".
+ * @param channel - Channel properties.
+ * @param priv - Setting, from enum iio_axi_adc_window_attr.
+ * @return Number of bytes written to device, or negative value on failure.
+ */
+static int set_window_attr(void *device, char *buf, uint32_t len,
+			   const struct iio_ch_info *channel, intptr_t priv)
+{
+	struct iio_axi_adc_desc *iio_adc = (struct iio_axi_adc_desc *)device;
+	struct iio_axi_adc_window *w = &iio_adc->window;
+	int32_t val = no_os_str_to_int32(buf);
+	uint32_t i;
+
+	switch (priv) {
+	case IIO_AXI_ADC_PRETRIGGER_SAMPLES:
+		if (val < 0)
+			return -EINVAL;
+		w->pretrigger_samples = val;
+		break;
+	case IIO_AXI_ADC_TRIGGER_MODE:
+		for (i = 0; i < IIO_AXI_ADC_NB_TRIGGERS; i++)
+			if (!strncmp(buf, iio_axi_adc_trigger_names[i],
+				     strlen(iio_axi_adc_trigger_names[i])))
+				break;
+		if (i == IIO_AXI_ADC_NB_TRIGGERS)
+			return -EINVAL;
+		w->trigger = i;
+		break;
+	case IIO_AXI_ADC_TRIGGER_CHANNEL:
+		if (val < 0 || val >= iio_adc->adc->num_channels)
+			return -EINVAL;
+		w->threshold_ch = val;
+		break;
+	case IIO_AXI_ADC_TRIGGER_THRESHOLD:
+		if (val < INT16_MIN || val > INT16_MAX)
+			return -EINVAL;
+		w->threshold = val;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return len;
+}
+
+/**
+ * List containing the device attributes of the triggered capture.
+ */
+static struct iio_attribute iio_window_attributes[] = {
+	{
+		.name = "pretrigger_samples",
+		.show = get_window_attr,
+		.store = set_window_attr,
+		.priv = IIO_AXI_ADC_PRETRIGGER_SAMPLES,
+	},
+	{
+		.name = "trigger_mode",
+		.show = get_window_attr,
+		.store = set_window_attr,
+		.priv = IIO_AXI_ADC_TRIGGER_MODE,
+	},
+	{
+		.name = "trigger_mode_available",
+		.show = get_window_attr,
+		.priv = -1,
+	},
+	{
+		.name = "trigger_channel",
+		.show = get_window_attr,
+		.store = set_window_attr,
+		.priv = IIO_AXI_ADC_TRIGGER_CHANNEL,
+	},
+	{
+		.name = "trigger_threshold",
+		.show = get_window_attr,
+		.store = set_window_attr,
+		.priv = IIO_AXI_ADC_TRIGGER_THRESHOLD,
+	},
+	END_ATTRIBUTES_ARRAY
+};
+
+/**
+ * List containing the debug attributes of the triggered capture.
+ */
+static struct iio_attribute iio_window_debug_attributes[] = {
+	{
+		.name = "windows_lost",
+		.show = get_window_attr,
+		.priv = IIO_AXI_ADC_WINDOWS_LOST,
 	},
 	END_ATTRIBUTES_ARRAY
 };
@@ -339,6 +502,24 @@ int32_t iio_axi_adc_prepare_transfer(void *dev, uint32_t mask)
 	return axi_adc_update_active_channels(iio_adc->adc, mask);
 }
 
+/**
+ * @brief Hand data written by the DMA over to the CPU, with the
+ * dcache_invalidate_range of the user if there is one.
+ * @param iio_adc - Instance of the iio_axi_adc
+ * @param addr - Start of the data
+ * @param size - Size of the data
+ * @return None.
+ */
+static void iio_axi_adc_sync_for_cpu(struct iio_axi_adc_desc *iio_adc,
+				     uintptr_t addr, uint32_t size)
+{
+	if (iio_adc->dcache_invalidate_range)
+		iio_adc->dcache_invalidate_range(addr, size);
+	else
+		no_os_dma_sync_for_cpu((void *)addr, size,
+				       NO_OS_DMA_FROM_DEVICE);
+}
+
 /**
  * @brief Update active channels
  * @param dev - Instance of the iio_axi_adc
@@ -355,6 +536,9 @@ int32_t	iio_axi_adc_read_dev(void *dev, void *buff, uint32_t nb_samples)
 		return -1;
 
 	iio_adc = (struct iio_axi_adc_desc *)dev;
+	if (!iio_adc->dmac)
+		return -ENOSYS;
+
 	bytes = nb_samples * no_os_hweight32(iio_adc->mask) * (STORAGE_BITS / 8);
 
 	struct axi_dma_transfer transfer = {
@@ -369,6 +553,7 @@ int32_t	iio_axi_adc_read_dev(void *dev, void *buff, uint32_t nb_samples)
 		// Address of data destination
 		.dest_addr = (uintptr_t)buff
 	};
+	no_os_dma_sync_for_device(buff, bytes, NO_OS_DMA_FROM_DEVICE);
 	ret = axi_dmac_transfer_start(iio_adc->dmac, &transfer);
 	if (ret < 0)
 		return ret;
@@ -377,8 +562,523 @@ int32_t	iio_axi_adc_read_dev(void *dev, void *buff, uint32_t nb_samples)
 	if(ret)
 		return ret;
 
-	if (iio_adc->dcache_invalidate_range)
-		iio_adc->dcache_invalidate_range((uintptr_t)buff, bytes);
+	iio_axi_adc_sync_for_cpu(iio_adc, (uintptr_t)buff, bytes);
+
+	return 0;
+}
+
+/**
+ * @brief Called from the DMA interrupt when a buffer block was filled.
+ * @param ctx - Instance of the iio_axi_adc
+ * @param addr - Address of the filled block
+ * @param size - Size of the filled block
+ * @return None.
+ */
+static void iio_axi_adc_block_filled(void *ctx, uint32_t addr, uint32_t size)
+{
+	struct iio_axi_adc_desc *iio_adc = ctx;
+	struct no_os_circular_buffer *cb = iio_adc->stream_buffer->buf;
+	struct no_os_cb_regions regions;
+
+	iio_axi_adc_sync_for_cpu(iio_adc, addr, size);
+
+	/*
+	 * The DMA fills the blocks in the same order as the buffer expects.
+	 * A block filled while the reader still holds the whole buffer is
+	 * dropped, and so are the next ones until the DMA is back at the
+	 * write position of the buffer.
+	 */
+	if (no_os_cb_peek_write(cb, size, &regions))
+		return;
+
+	if (regions.buf[0] == (int8_t *)(uintptr_t)addr &&
+	    regions.len[0] == size)
+		no_os_cb_commit_write(cb, size);
+}
+
+/*
+ * Time given to a refill DMA transfer, as for the blocking refills. It is
+ * counted in polls, each one waiting IIO_AXI_ADC_DMA_POLL_US, as not all
+ * the platforms have a wall clock.
+ */
+#define IIO_AXI_ADC_DMA_TIMEOUT_MS	500
+#define IIO_AXI_ADC_DMA_POLL_US		100
+#define IIO_AXI_ADC_DMA_POLLS \
+	(IIO_AXI_ADC_DMA_TIMEOUT_MS * 1000 / IIO_AXI_ADC_DMA_POLL_US)
+
+/**
+ * @brief Start a DMA transfer in the next buffer block and return -EAGAIN
+ * until it is done, so the caller is not blocked during the capture.
+ * @param iio_adc - Instance of the iio_axi_adc
+ * @param buffer - Buffer to be filled
+ * @return 0 when the block is filled, -EAGAIN if the transfer is in progress,
+ * -ETIMEDOUT if it did not end in IIO_AXI_ADC_DMA_TIMEOUT_MS or negative value
+ * in case of error.
+ */
+static int32_t iio_axi_adc_refill_async(struct iio_axi_adc_desc *iio_adc,
+					struct iio_buffer *buffer)
+{
+	void *buff;
+	int32_t ret;
+
+	if (!iio_adc->dma_pending) {
+		ret = iio_buffer_get_block(buffer, &buff);
+		if (ret)
+			return ret;
+
+		struct axi_dma_transfer transfer = {
+			.size = buffer->size,
+			.transfer_done = 0,
+			.cyclic = NO,
+			.src_addr = 0,
+			.dest_addr = (uintptr_t)buff
+		};
+		no_os_dma_sync_for_device(buff, buffer->size,
+					  NO_OS_DMA_FROM_DEVICE);
+		ret = axi_dmac_transfer_start(iio_adc->dmac, &transfer);
+		if (ret < 0)
+			return ret;
+
+		iio_adc->dma_block = (uintptr_t)buff;
+		iio_adc->dma_polls = IIO_AXI_ADC_DMA_POLLS;
+		iio_adc->dma_pending = true;
+	}
+
+	ret = axi_dmac_transfer_poll(iio_adc->dmac);
+	if (ret == -EAGAIN) {
+		if (!iio_adc->dma_polls--) {
+			axi_dmac_transfer_stop(iio_adc->dmac);
+			iio_adc->dma_pending = false;
+			return -ETIMEDOUT;
+		}
+		no_os_udelay(IIO_AXI_ADC_DMA_POLL_US);
+
+		return -EAGAIN;
+	}
+	if (ret)
+		return ret;
+
+	iio_adc->dma_pending = false;
+	iio_axi_adc_sync_for_cpu(iio_adc, iio_adc->dma_block, buffer->size);
+
+	return iio_buffer_block_done(buffer);
+}
+
+/**
+ * @brief Look for the threshold crossing in a filled segment.
+ * @param w - Triggered capture
+ * @param addr - Address of the segment
+ * @param size - Size of the segment
+ * @param off - Offset in the segment of the scan crossing the threshold
+ * @return true if the threshold was crossed.
+ */
+static bool iio_axi_adc_window_find(struct iio_axi_adc_window *w,
+				    uint32_t addr, uint32_t size, uint32_t *off)
+{
+	int16_t sample;
+	bool hit;
+	uint32_t i;
+
+	for (i = w->threshold_pos; i < size; i += w->scan_bytes) {
+		sample = *(int16_t *)(uintptr_t)(addr + i);
+		if (w->trigger == IIO_AXI_ADC_TRIG_RISING)
+			hit = w->last_sample < w->threshold &&
+			      sample >= w->threshold;
+		else
+			hit = w->last_sample > w->threshold &&
+			      sample <= w->threshold;
+		w->last_sample = sample;
+		if (hit) {
+			*off = i - w->threshold_pos;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * @brief Called from the DMA interrupt when a segment of the ring of the
+ * triggered capture was filled.
+ * @param ctx - Instance of the iio_axi_adc
+ * @param addr - Address of the filled segment
+ * @param size - Size of the filled segment
+ * @return None.
+ */
+static void iio_axi_adc_window_segment(void *ctx, uint32_t addr,
+				       uint32_t size)
+{
+	struct iio_axi_adc_desc *iio_adc = ctx;
+	struct iio_axi_adc_window *w = &iio_adc->window;
+	uint32_t seg_pos = w->write_pos;
+	bool history;
+	uint32_t off;
+
+	/* The history must reach pre_bytes before the start of the segment */
+	history = w->history >= w->pre_bytes;
+	w->history = no_os_min(w->history + size, w->ring_size);
+	w->write_pos += size;
+	if (w->write_pos == w->ring_size)
+		w->write_pos = 0;
+
+	switch (w->state) {
+	case IIO_AXI_ADC_WINDOW_ARMED:
+		if (w->trigger == IIO_AXI_ADC_TRIG_EXTERNAL) {
+			if (!w->trig_request)
+				return;
+			/* This segment was being filled when it fired */
+			w->trig_request = false;
+			off = 0;
+		} else {
+			iio_axi_adc_sync_for_cpu(iio_adc, addr, size);
+			if (!iio_axi_adc_window_find(w, addr, size, &off))
+				return;
+		}
+		if (!history)
+			return;
+
+		w->trig_pos = seg_pos + off;
+		w->post_done = size - off;
+		w->state = IIO_AXI_ADC_WINDOW_TRIGGERED;
+		break;
+	case IIO_AXI_ADC_WINDOW_TRIGGERED:
+		w->post_done += size;
+		break;
+	case IIO_AXI_ADC_WINDOW_DONE:
+		w->late_segs++;
+		return;
+	default:
+		return;
+	}
+
+	if (w->post_done >= w->post_bytes) {
+		w->late_segs = 0;
+		w->state = IIO_AXI_ADC_WINDOW_DONE;
+	}
+}
+
+/**
+ * @brief Start streaming into the ring and wait for the trigger.
+ * @param iio_adc - Instance of the iio_axi_adc
+ * @param buffer - Buffer to be filled, a block is a window
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int32_t iio_axi_adc_window_arm(struct iio_axi_adc_desc *iio_adc,
+				      struct iio_buffer *buffer)
+{
+	struct iio_axi_adc_window *w = &iio_adc->window;
+	uint32_t window = buffer->size;
+	uint32_t ch_mask;
+	int32_t ret;
+
+	w->scan_bytes = no_os_hweight32(iio_adc->mask) * (STORAGE_BITS / 8);
+	if (!w->scan_bytes || window % w->scan_bytes ||
+	    w->seg_size % w->scan_bytes)
+		return -EINVAL;
+
+	/* Room for the DMA to go on while the window waits to be copied */
+	if (window + (AXI_DMAC_MAX_QUEUED + 1) * w->seg_size > w->ring_size)
+		return -EINVAL;
+
+	if (w->trigger != IIO_AXI_ADC_TRIG_EXTERNAL) {
+		ch_mask = NO_OS_BIT(w->threshold_ch);
+		if (!(iio_adc->mask & ch_mask))
+			return -EINVAL;
+		/* Channels before the threshold one in a scan */
+		ch_mask = iio_adc->mask & (ch_mask - 1);
+		w->threshold_pos = no_os_hweight32(ch_mask) *
+				   (STORAGE_BITS / 8);
+	}
+
+	w->pre_bytes = no_os_min(w->pretrigger_samples * w->scan_bytes, window);
+	w->post_bytes = window - w->pre_bytes;
+	w->write_pos = 0;
+	w->history = 0;
+	w->late_segs = 0;
+	w->trig_request = false;
+	w->last_sample = w->threshold;
+	w->state = IIO_AXI_ADC_WINDOW_ARMED;
+
+	no_os_dma_sync_for_device((void *)w->ring, w->ring_size,
+				  NO_OS_DMA_FROM_DEVICE);
+	ret = axi_dmac_stream_start(iio_adc->dmac, w->ring, w->seg_size,
+				    w->ring_size / w->seg_size,
+				    iio_axi_adc_window_segment, iio_adc);
+	if (ret)
+		w->state = IIO_AXI_ADC_WINDOW_IDLE;
+
+	return ret;
+}
+
+/**
+ * @brief Copy the window from the ring, once the DMA was stopped.
+ * @param iio_adc - Instance of the iio_axi_adc
+ * @param dst - Buffer block
+ * @return None.
+ */
+static void iio_axi_adc_window_copy(struct iio_axi_adc_desc *iio_adc,
+				    uint8_t *dst)
+{
+	struct iio_axi_adc_window *w = &iio_adc->window;
+	uint32_t len = w->pre_bytes + w->post_bytes;
+	uint32_t start;
+	uint32_t chunk;
+
+	start = (w->trig_pos + w->ring_size - w->pre_bytes) % w->ring_size;
+	chunk = no_os_min(len, w->ring_size - start);
+
+	iio_axi_adc_sync_for_cpu(iio_adc, w->ring + start, chunk);
+	memcpy(dst, (void *)(w->ring + start), chunk);
+
+	if (chunk == len)
+		return;
+
+	iio_axi_adc_sync_for_cpu(iio_adc, w->ring, len - chunk);
+	memcpy(dst + chunk, (void *)w->ring, len - chunk);
+}
+
+/**
+ * @brief Refill the buffer with a triggered window. The capture is armed on
+ * the first refill and again after each window, so the history is captured
+ * while the host processes the previous one.
+ * @param iio_adc - Instance of the iio_axi_adc
+ * @param buffer - Buffer to be filled
+ * @return 0 when a block is filled, -EAGAIN if the window is not complete
+ * or negative value in case of error.
+ */
+static int32_t iio_axi_adc_window_submit(struct iio_axi_adc_desc *iio_adc,
+		struct iio_buffer *buffer)
+{
+	struct iio_axi_adc_window *w = &iio_adc->window;
+	bool lost;
+	void *block;
+	int32_t ret;
+
+	if (w->state == IIO_AXI_ADC_WINDOW_IDLE) {
+		ret = iio_axi_adc_window_arm(iio_adc, buffer);
+		return ret ? ret : -EAGAIN;
+	}
+
+	if (w->state != IIO_AXI_ADC_WINDOW_DONE)
+		return -EAGAIN;
+
+	axi_dmac_stream_stop(iio_adc->dmac);
+	w->state = IIO_AXI_ADC_WINDOW_IDLE;
+
+	/* The DMA ran up to AXI_DMAC_MAX_QUEUED segments ahead of late_segs */
+	lost = (w->late_segs + AXI_DMAC_MAX_QUEUED + 1) * w->seg_size +
+	       buffer->size > w->ring_size;
+	if (lost) {
+		w->lost++;
+	} else {
+		ret = iio_buffer_get_block(buffer, &block);
+		if (ret)
+			return ret;
+
+		iio_axi_adc_window_copy(iio_adc, block);
+		ret = iio_buffer_block_done(buffer);
+		if (ret)
+			return ret;
+	}
+
+	ret = iio_axi_adc_window_arm(iio_adc, buffer);
+	if (ret)
+		return ret;
+
+	return lost ? -EAGAIN : 0;
+}
+
+/**
+ * @brief Fire the trigger of the triggered capture. The trigger position is
+ * the start of the DMA segment being filled, and a trigger coming before the
+ * pre-trigger history was captured is dropped.
+ * @param desc - Instance of the iio_axi_adc
+ * @return None.
+ */
+void iio_axi_adc_window_trigger(struct iio_axi_adc_desc *desc)
+{
+	if (desc->window.state == IIO_AXI_ADC_WINDOW_ARMED)
+		desc->window.trig_request = true;
+}
+
+/**
+ * @brief Trigger GPIO interrupt handler.
+ * @param ctx - Instance of the iio_axi_adc
+ * @return None.
+ */
+static void iio_axi_adc_window_irq(void *ctx)
+{
+	iio_axi_adc_window_trigger(ctx);
+}
+
+#ifdef NO_OS_AMP
+/**
+ * @brief Refill the buffer with the blocks reported by the DMA core, after
+ * asking it to stream into the buffer on the first refill.
+ * @param iio_adc - Instance of the iio_axi_adc
+ * @param buffer - Buffer to be filled
+ * @return 0 in case of success, -EAGAIN if the data is not ready yet or
+ * negative value otherwise.
+ */
+static int32_t iio_axi_adc_amp_submit(struct iio_axi_adc_desc *iio_adc,
+				      struct iio_buffer *buffer)
+{
+	struct no_os_amp_msg msg;
+	uint32_t nb_blocks;
+	uint32_t size;
+	int32_t ret;
+
+	if (!iio_adc->stream_buffer) {
+		nb_blocks = buffer->buf->size / buffer->size;
+		if (nb_blocks < 2 || buffer->buf->size % buffer->size)
+			return -EINVAL;
+
+		msg.cmd = NO_OS_AMP_CMD_START;
+		msg.addr = (uintptr_t)buffer->buf->buff;
+		msg.size = buffer->size;
+		msg.count = nb_blocks;
+		ret = no_os_amp_request(iio_adc->amp, &msg);
+		if (ret)
+			return ret;
+
+		iio_adc->stream_buffer = buffer;
+	}
+
+	while (!no_os_amp_get_response(iio_adc->amp, &msg)) {
+		if (msg.cmd == NO_OS_AMP_CMD_ERROR) {
+			iio_adc->stream_buffer = NULL;
+			return (int32_t)msg.count;
+		}
+
+		if (msg.cmd == NO_OS_AMP_CMD_BLOCK)
+			iio_axi_adc_block_filled(iio_adc, msg.addr, msg.size);
+	}
+
+	ret = no_os_cb_size(buffer->buf, &size);
+	if (ret)
+		return ret;
+
+	return size >= buffer->size ? 0 : -EAGAIN;
+}
+
+/**
+ * @brief Ask the DMA core to stop streaming and wait for it, dropping the
+ * blocks reported meanwhile, so they are not taken by the next capture.
+ * @param iio_adc - Instance of the iio_axi_adc
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int32_t iio_axi_adc_amp_stop(struct iio_axi_adc_desc *iio_adc)
+{
+	struct no_os_amp_msg msg = { .cmd = NO_OS_AMP_CMD_STOP };
+	uint32_t elapsed = 0;
+	int32_t ret;
+
+	iio_adc->stream_buffer = NULL;
+
+	ret = no_os_amp_request(iio_adc->amp, &msg);
+	if (ret)
+		return ret;
+
+	while (elapsed < IIO_AXI_ADC_AMP_STOP_MS) {
+		ret = no_os_amp_get_response(iio_adc->amp, &msg);
+		if (ret == -EAGAIN) {
+			no_os_mdelay(1);
+			elapsed++;
+		} else if (ret) {
+			return ret;
+		} else if (msg.cmd == NO_OS_AMP_CMD_STOPPED) {
+			return 0;
+		}
+	}
+
+	return -ETIMEDOUT;
+}
+#endif
+
+/**
+ * @brief Refill the buffer. In continuous mode the DMA stream is started on
+ * the first refill and after that it waits for a block to be filled.
+ * @param dev_data - Device data containing the instance and the buffer
+ * @return 0 in case of success, -EAGAIN if the data is not ready yet or
+ * negative value otherwise.
+ */
+static int32_t iio_axi_adc_submit(struct iio_device_data *dev_data)
+{
+	struct iio_axi_adc_desc *iio_adc;
+	struct iio_buffer *buffer;
+	uint32_t nb_blocks;
+	uint32_t size;
+	int32_t ret;
+
+	if (!dev_data)
+		return -EINVAL;
+
+	iio_adc = dev_data->dev;
+	buffer = dev_data->buffer;
+
+#ifdef NO_OS_AMP
+	if (iio_adc->amp)
+		return iio_axi_adc_amp_submit(iio_adc, buffer);
+#endif
+
+	if (iio_adc->window.ring)
+		return iio_axi_adc_window_submit(iio_adc, buffer);
+
+	if (!iio_adc->continuous)
+		return iio_axi_adc_refill_async(iio_adc, buffer);
+
+	if (!iio_adc->stream_buffer) {
+		/* The lock-free buffer needs a power of 2 size */
+		nb_blocks = buffer->buf->size / buffer->size;
+		if (nb_blocks < 2 || buffer->buf->size % buffer->size ||
+		    (nb_blocks & (nb_blocks - 1)))
+			return -EINVAL;
+
+		iio_adc->stream_buffer = buffer;
+		no_os_dma_sync_for_device(buffer->buf->buff, buffer->buf->size,
+					  NO_OS_DMA_FROM_DEVICE);
+		ret = axi_dmac_stream_start(iio_adc->dmac,
+					    (uintptr_t)buffer->buf->buff,
+					    buffer->size, nb_blocks,
+					    iio_axi_adc_block_filled, iio_adc);
+		if (ret) {
+			iio_adc->stream_buffer = NULL;
+			return ret;
+		}
+	}
+
+	ret = no_os_cb_size(buffer->buf, &size);
+	if (ret)
+		return ret;
+
+	return size >= buffer->size ? 0 : -EAGAIN;
+}
+
+/**
+ * @brief Stop the DMA stream or the pending transfer.
+ * @param dev - Instance of the iio_axi_adc
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int32_t iio_axi_adc_post_disable(void *dev)
+{
+	struct iio_axi_adc_desc *iio_adc = dev;
+
+#ifdef NO_OS_AMP
+	if (iio_adc->amp) {
+		if (!iio_adc->stream_buffer)
+			return 0;
+
+		return iio_axi_adc_amp_stop(iio_adc);
+	}
+#endif
+
+	if (iio_adc->dma_pending) {
+		axi_dmac_transfer_stop(iio_adc->dmac);
+		iio_adc->dma_pending = false;
+	}
+	axi_dmac_stream_stop(iio_adc->dmac);
+	iio_adc->stream_buffer = NULL;
+	iio_adc->window.state = IIO_AXI_ADC_WINDOW_IDLE;
 
 	return 0;
 }
@@ -395,7 +1095,7 @@ static int iio_axi_adc_delete_device_descriptor(
 		return -1;
 
 	if (desc->dev_descriptor.channels)
-		free(desc->dev_descriptor.channels);
+		free((void *)desc->dev_descriptor.channels);
 
 	if (desc->ch_names)
 		free(desc->ch_names);
@@ -428,15 +1128,16 @@ static int32_t iio_axi_adc_create_device_descriptor(
 		.ch_out = false,
 		.indexed = true,
 	};
+	struct iio_channel *channels;
 	int32_t i;
 	int32_t ret;
 
 	iio_device->num_ch = desc->adc->num_channels;
 	iio_device->attributes = NULL; /* no device attribute */
-	iio_device->channels = calloc(iio_device->num_ch,
-				      sizeof(struct iio_channel));
-	if (!iio_device->channels)
+	channels = calloc(iio_device->num_ch, sizeof(struct iio_channel));
+	if (!channels)
 		goto error;
+	iio_device->channels = channels;
 
 	desc->ch_names = calloc(iio_device->num_ch, sizeof(*desc->ch_names));
 	if (!desc->ch_names)
@@ -444,16 +1145,25 @@ static int32_t iio_axi_adc_create_device_descriptor(
 
 	for (i = 0; i < iio_device->num_ch; i++) {
 		default_channel.channel = i;
-		iio_device->channels[i] = default_channel;
-		iio_device->channels[i].name = desc->ch_names[i];
-		iio_device->channels[i].scan_index = i;
+		channels[i] = default_channel;
+		channels[i].name = desc->ch_names[i];
+		channels[i].scan_index = i;
 		ret = sprintf(desc->ch_names[i], "voltage%"PRIi32"", i);
 		if (ret < 0)
 			goto error;
 	}
 
+	if (desc->window.ring) {
+		iio_device->attributes = iio_window_attributes;
+		iio_device->debug_attributes = iio_window_debug_attributes;
+	}
+
+	/* In continuous mode the buffer is filled from the DMA interrupt */
+	iio_device->lock_free_buffer = desc->continuous;
 	iio_device->pre_enable = iio_axi_adc_prepare_transfer;
 	iio_device->read_dev = iio_axi_adc_read_dev;
+	iio_device->submit = iio_axi_adc_submit;
+	iio_device->post_disable = iio_axi_adc_post_disable;
 
 	return 0;
 error:
@@ -462,6 +1172,44 @@ error:
 	return -1;
 }
 
+/**
+ * @brief Register the trigger GPIO interrupt of the triggered capture.
+ * @param desc - Descriptor.
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int32_t iio_axi_adc_window_irq_setup(struct iio_axi_adc_desc *desc)
+{
+	struct iio_axi_adc_window *w = &desc->window;
+	int32_t ret;
+
+	w->irq_cb = (struct no_os_callback_desc) {
+		.callback = iio_axi_adc_window_irq,
+		.ctx = desc,
+		.event = NO_OS_EVT_GPIO,
+		.peripheral = NO_OS_GPIO_IRQ,
+	};
+
+	ret = no_os_irq_register_callback(w->irq_ctrl, w->irq_num, &w->irq_cb);
+	if (ret)
+		return ret;
+
+	ret = no_os_irq_trigger_level_set(w->irq_ctrl, w->irq_num,
+					  NO_OS_IRQ_EDGE_RISING);
+	if (ret)
+		goto error_irq;
+
+	ret = no_os_irq_enable(w->irq_ctrl, w->irq_num);
+	if (ret)
+		goto error_irq;
+
+	return 0;
+
+error_irq:
+	no_os_irq_unregister_callback(w->irq_ctrl, w->irq_num, &w->irq_cb);
+
+	return ret;
+}
+
 /**
  * @brief Get device descriptor.
  * @param desc - axi iio axi adc descriptor.
@@ -491,9 +1239,22 @@ int32_t iio_axi_adc_init(struct iio_axi_adc_desc **desc,
 	if (!init)
 		return -1;
 
-	if (!init->rx_adc || !init->rx_dmac)
+	if (!init->rx_adc)
 		return -1;
 
+#ifdef NO_OS_AMP
+	if (!init->rx_dmac && !init->amp)
+		return -1;
+#else
+	if (!init->rx_dmac)
+		return -1;
+#endif
+
+	if (init->window_ring &&
+	    (init->continuous || !init->rx_dmac || !init->window_segment_size ||
+	     init->window_ring_size % init->window_segment_size))
+		return -EINVAL;
+
 	iio_axi_adc_inst = (struct iio_axi_adc_desc *)calloc(1,
 			   sizeof(struct iio_axi_adc_desc));
 	if (!iio_axi_adc_inst)
@@ -503,6 +1264,15 @@ int32_t iio_axi_adc_init(struct iio_axi_adc_desc **desc,
 	iio_axi_adc_inst->dmac = init->rx_dmac;
 	iio_axi_adc_inst->dcache_invalidate_range = init->dcache_invalidate_range;
 	iio_axi_adc_inst->get_sampling_frequency = init->get_sampling_frequency;
+	iio_axi_adc_inst->continuous = init->continuous;
+	iio_axi_adc_inst->window.ring = init->window_ring;
+	iio_axi_adc_inst->window.ring_size = init->window_ring_size;
+	iio_axi_adc_inst->window.seg_size = init->window_segment_size;
+	iio_axi_adc_inst->window.irq_ctrl = init->trig_irq_ctrl;
+	iio_axi_adc_inst->window.irq_num = init->trig_irq_num;
+#ifdef NO_OS_AMP
+	iio_axi_adc_inst->amp = init->amp;
+#endif
 
 	status = iio_axi_adc_create_device_descriptor(iio_axi_adc_inst,
 			&iio_axi_adc_inst->dev_descriptor);
@@ -511,6 +1281,15 @@ int32_t iio_axi_adc_init(struct iio_axi_adc_desc **desc,
 		return status;
 	}
 
+	if (init->window_ring && init->trig_irq_ctrl) {
+		status = iio_axi_adc_window_irq_setup(iio_axi_adc_inst);
+		if (status) {
+			iio_axi_adc_delete_device_descriptor(iio_axi_adc_inst);
+			free(iio_axi_adc_inst);
+			return status;
+		}
+	}
+
 	*desc = iio_axi_adc_inst;
 
 	return 0;
@@ -528,6 +1307,13 @@ int32_t iio_axi_adc_remove(struct iio_axi_adc_desc *desc)
 	if (!desc)
 		return -1;
 
+	if (desc->window.ring && desc->window.irq_ctrl) {
+		no_os_irq_disable(desc->window.irq_ctrl, desc->window.irq_num);
+		no_os_irq_unregister_callback(desc->window.irq_ctrl,
+					      desc->window.irq_num,
+					      &desc->window.irq_cb);
+	}
+
 	status = iio_axi_adc_delete_device_descriptor(desc);
 	if (status < 0)
 		return status;
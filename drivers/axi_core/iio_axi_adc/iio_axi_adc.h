@@ -47,11 +47,92 @@
 #include "iio_types.h"
 #include "axi_adc_core.h"
 #include "axi_dmac.h"
+#include "no_os_irq.h"
+#ifdef NO_OS_AMP
+#include "no_os_amp.h"
+#endif
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
 
+/**
+ * @enum iio_axi_adc_trigger
+ * @brief Event ending the pre-trigger history of a triggered capture.
+ */
+enum iio_axi_adc_trigger {
+	/** iio_axi_adc_window_trigger() call or trigger GPIO edge */
+	IIO_AXI_ADC_TRIG_EXTERNAL,
+	/** Sample of the threshold channel rising to the threshold */
+	IIO_AXI_ADC_TRIG_RISING,
+	/** Sample of the threshold channel falling to the threshold */
+	IIO_AXI_ADC_TRIG_FALLING,
+};
+
+/**
+ * @enum iio_axi_adc_window_state
+ * @brief State of a triggered capture.
+ */
+enum iio_axi_adc_window_state {
+	IIO_AXI_ADC_WINDOW_IDLE,
+	/** Streaming into the ring, waiting for the trigger */
+	IIO_AXI_ADC_WINDOW_ARMED,
+	/** Waiting for the post-trigger samples */
+	IIO_AXI_ADC_WINDOW_TRIGGERED,
+	/** The window is in the ring, to be copied by the next refill */
+	IIO_AXI_ADC_WINDOW_DONE,
+};
+
+/**
+ * @struct iio_axi_adc_window
+ * @brief Triggered capture. The DMA streams into a ring continuously and,
+ * once the trigger fired, a buffer block worth of samples around the trigger
+ * is copied from the ring to the IIO buffer. Positions are ring offsets.
+ */
+struct iio_axi_adc_window {
+	/** Ring address, 0 when the triggered capture is not used */
+	uintptr_t ring;
+	/** Ring size in bytes, a multiple of seg_size */
+	uint32_t ring_size;
+	/** Size of the DMA segments, the resolution of an external trigger */
+	uint32_t seg_size;
+	/** Optional GPIO trigger interrupt */
+	struct no_os_irq_ctrl_desc *irq_ctrl;
+	uint32_t irq_num;
+	struct no_os_callback_desc irq_cb;
+	/** Samples of the window taken before the trigger */
+	uint32_t pretrigger_samples;
+	/** Trigger source */
+	enum iio_axi_adc_trigger trigger;
+	/** Threshold channel and level, in raw codes */
+	uint32_t threshold_ch;
+	int16_t threshold;
+	/** Bytes of a scan and position of the threshold channel in it */
+	uint32_t scan_bytes;
+	uint32_t threshold_pos;
+	/** Bytes of the window before and after the trigger */
+	uint32_t pre_bytes;
+	uint32_t post_bytes;
+	/** Capture state, updated from the DMA interrupt */
+	volatile enum iio_axi_adc_window_state state;
+	/** Set by an external trigger, taken by the next filled segment */
+	volatile bool trig_request;
+	/** Start of the next segment to be filled */
+	uint32_t write_pos;
+	/** Bytes written since the capture was armed, up to ring_size */
+	uint32_t history;
+	/** First sample after the trigger */
+	uint32_t trig_pos;
+	/** Bytes written since the trigger */
+	uint32_t post_done;
+	/** Segments filled after the window was complete */
+	volatile uint32_t late_segs;
+	/** Last sample of the threshold channel, for the crossing detection */
+	int16_t last_sample;
+	/** Windows overwritten by the DMA before being copied */
+	uint32_t lost;
+};
+
 /**
  * @struct iio_axi_adc_desc
  * @brief iio_axi_adc_descriptor
@@ -63,11 +144,27 @@ struct iio_axi_adc_desc {
 	uint32_t mask;
 	/** dma device */
 	struct axi_dmac *dmac;
-	/** Invalidate cache memory function pointer */
+	/** Invalidate cache memory function pointer, see the init param */
 	void (*dcache_invalidate_range)(uint32_t address, uint32_t bytes_count);
 	/** Custom implementation for get sampling frequency */
 	int (*get_sampling_frequency)(struct axi_adc *dev, uint32_t chan,
 				      uint64_t *sampling_freq_hz);
+	/** Keep the DMA running between buffer refills */
+	bool continuous;
+	/** Set while a DMA transfer started by a refill is in progress */
+	bool dma_pending;
+	/** Address of the block being filled by the pending DMA transfer */
+	uintptr_t dma_block;
+	/** Number of polls left to the pending DMA transfer */
+	uint32_t dma_polls;
+	/** Buffer filled by the DMA stream when continuous is set */
+	struct iio_buffer *stream_buffer;
+	/** Triggered capture */
+	struct iio_axi_adc_window window;
+#ifdef NO_OS_AMP
+	/** Link to the core owning the DMA, if the DMA is not used locally */
+	struct no_os_amp_link *amp;
+#endif
 	/** iio device descriptor */
 	struct iio_device dev_descriptor;
 	/** Channel names */
@@ -83,11 +180,44 @@ struct iio_axi_adc_init_param {
 	struct axi_adc *rx_adc;
 	/** Receive DMA device */
 	struct axi_dmac *rx_dmac;
-	/** Invalidate the Data cache for the given address range */
+	/**
+	 * Invalidate the Data cache for the given address range. Optional,
+	 * no_os_dma_sync_for_cpu is used if not set.
+	 */
 	void (*dcache_invalidate_range)(uint32_t address, uint32_t bytes_count);
 	/** Custom sampling frequency getter */
 	int (*get_sampling_frequency)(struct axi_adc *dev, uint32_t chan,
 				      uint64_t *sampling_freq_hz);
+	/**
+	 * Capture continuously into the IIO buffer blocks using the DMAC
+	 * streaming mode, so no samples are lost between refills.
+	 * Requires a DMAC with IRQ enabled and a power of 2 number of
+	 * buffer blocks, at least 2, of a power of 2 size.
+	 */
+	bool continuous;
+	/**
+	 * Optional. Memory for the ring of the triggered capture, in which the
+	 * DMA streams continuously. Each refill then returns a buffer block
+	 * taken around the trigger. Requires a DMAC with IRQ enabled and a
+	 * ring larger than a block by AXI_DMAC_MAX_QUEUED + 1 segments.
+	 */
+	uintptr_t window_ring;
+	/** Size in bytes of the ring */
+	uint32_t window_ring_size;
+	/** Size in bytes of the DMA segments of the ring */
+	uint32_t window_segment_size;
+	/** Optional. Controller of the GPIO interrupt used as trigger */
+	struct no_os_irq_ctrl_desc *trig_irq_ctrl;
+	/** GPIO interrupt used as trigger */
+	uint32_t trig_irq_num;
+#ifdef NO_OS_AMP
+	/**
+	 * Optional. The DMA is run by the other core of an AMP system, with
+	 * axi_dmac_amp_step, and the buffer blocks are streamed as in
+	 * continuous mode. rx_dmac is not used and may be NULL.
+	 */
+	struct no_os_amp_link *amp;
+#endif
 };
 
 /******************************************************************************/
@@ -102,6 +232,9 @@ int32_t iio_axi_adc_init(struct iio_axi_adc_desc **desc,
 void iio_axi_adc_get_dev_descriptor(struct iio_axi_adc_desc *desc,
 				    struct iio_device **dev_descriptor);
 
+/* Fire the trigger of a triggered capture. Can be called from interrupts. */
+void iio_axi_adc_window_trigger(struct iio_axi_adc_desc *desc);
+
 /* Free the resources allocated by iio_axi_adc_init(). */
 int32_t iio_axi_adc_remove(struct iio_axi_adc_desc *desc);
 
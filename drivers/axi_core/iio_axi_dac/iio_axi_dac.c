@@ -47,6 +47,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "no_os_error.h"
+#include "no_os_delay.h"
+#include "no_os_alloc.h"
 #include "iio.h"
 #include "iio_axi_dac.h"
 
@@ -55,6 +57,8 @@
 /******************************************************************************/
 
 #define STORAGE_BITS 16
+/* Maximum time to wait for the previous waveform switch to take place */
+#define IIO_AXI_DAC_SWITCH_TIMEOUT_MS	1000
 
 /**
  * @brief get_dds_calibscale().
@@ -488,6 +492,65 @@ int32_t iio_axi_dac_prepare_transfer(void *dev, uint32_t mask)
 	return 0;
 }
 
+/**
+ * @brief Hand data written by the CPU over to the DMA, with the
+ * dcache_flush_range of the user if there is one.
+ * @param iio_dac - Instance of the iio_axi_dac
+ * @param addr - Start of the data
+ * @param size - Size of the data
+ * @return None.
+ */
+static void iio_axi_dac_sync_for_device(struct iio_axi_dac_desc *iio_dac,
+					uintptr_t addr, uint32_t size)
+{
+	if (iio_dac->dcache_flush_range)
+		iio_dac->dcache_flush_range(addr, size);
+	else
+		no_os_dma_sync_for_device((void *)addr, size,
+					  NO_OS_DMA_TO_DEVICE);
+}
+
+/**
+ * @brief Play a new waveform from the idle buffer of the pair, once the
+ * previous switch took place.
+ * @param iio_dac - Instance of the iio_axi_dac
+ * @param buff - Buffer where to read samples
+ * @param bytes - Number of bytes
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int32_t iio_axi_dac_switch_data(struct iio_axi_dac_desc *iio_dac,
+				       void *buff, uint32_t bytes)
+{
+	struct axi_dma_transfer transfer = {0};
+	uint8_t *next = iio_dac->cyclic_buf[iio_dac->cyclic_idx];
+	uint32_t timeout = IIO_AXI_DAC_SWITCH_TIMEOUT_MS;
+	int32_t ret;
+
+	if (bytes > iio_dac->cyclic_buf_size)
+		return -ENOMEM;
+
+	/* The idle buffer may still be played until the last switch is done */
+	while (axi_dmac_cyclic_pending(iio_dac->dmac)) {
+		if (!timeout--)
+			return -ETIMEDOUT;
+		no_os_mdelay(1);
+	}
+
+	memcpy(next, buff, bytes);
+	iio_axi_dac_sync_for_device(iio_dac, (uintptr_t)next, bytes);
+
+	transfer.size = bytes;
+	transfer.cyclic = CYCLIC;
+	transfer.src_addr = (uintptr_t)next;
+	ret = axi_dmac_cyclic_switch(iio_dac->dmac, &transfer);
+	if (ret)
+		return ret;
+
+	iio_dac->cyclic_idx ^= 1;
+
+	return 0;
+}
+
 /**
  * @brief Update active channels
  * @param dev - Instance of the iio_axi_dac
@@ -506,8 +569,10 @@ int32_t iio_axi_dac_write_data(void *dev, void *buff, uint32_t nb_samples)
 	iio_dac = (struct iio_axi_dac_desc *)dev;
 	bytes = nb_samples * no_os_hweight32(iio_dac->mask) * (STORAGE_BITS / 8);
 
-	if(iio_dac->dcache_flush_range)
-		iio_dac->dcache_flush_range((uintptr_t)buff, bytes);
+	if (iio_dac->cyclic_buf[0] && iio_dac->cyclic_buf[1])
+		return iio_axi_dac_switch_data(iio_dac, buff, bytes);
+
+	iio_axi_dac_sync_for_device(iio_dac, (uintptr_t)buff, bytes);
 
 	struct axi_dma_transfer transfer = {
 		// Number of bytes to writen/read
@@ -525,6 +590,142 @@ int32_t iio_axi_dac_write_data(void *dev, void *buff, uint32_t nb_samples)
 	return axi_dmac_transfer_start(iio_dac->dmac, &transfer);
 }
 
+static void iio_axi_dac_block_sent(void *ctx);
+
+/**
+ * @brief Start sending the next block of the stream, if it was written.
+ * @param iio_dac - Instance of the iio_axi_dac
+ * @return 0 in case of success, -EAGAIN if there is no full block to send or
+ * negative value otherwise.
+ */
+static int32_t iio_axi_dac_stream_next(struct iio_axi_dac_desc *iio_dac)
+{
+	struct iio_buffer *buffer = iio_dac->stream_buffer;
+	void *buff;
+	uint32_t size;
+	int32_t ret;
+
+	/* iio_buffer_get_block() must only be called for a complete block */
+	ret = no_os_cb_size(buffer->buf, &size);
+	if (ret)
+		return ret;
+	if (size < buffer->size)
+		return -EAGAIN;
+
+	ret = iio_buffer_get_block(buffer, &buff);
+	if (ret)
+		return ret;
+
+	iio_axi_dac_sync_for_device(iio_dac, (uintptr_t)buff, buffer->size);
+
+	struct axi_dma_transfer transfer = {
+		.size = buffer->size,
+		.transfer_done = 0,
+		.cyclic = NO,
+		.src_addr = (uintptr_t)buff,
+		.dest_addr = 0
+	};
+	iio_dac->dma_pending = true;
+	ret = axi_dmac_transfer_start_async(iio_dac->dmac, &transfer,
+					    iio_axi_dac_block_sent, iio_dac);
+	if (ret) {
+		iio_dac->dma_pending = false;
+		iio_buffer_block_done(buffer);
+	}
+
+	return ret;
+}
+
+/**
+ * @brief Called from the DMA interrupt when a block of the stream was sent.
+ * @param ctx - Instance of the iio_axi_dac
+ * @return None.
+ */
+static void iio_axi_dac_block_sent(void *ctx)
+{
+	struct iio_axi_dac_desc *iio_dac = ctx;
+
+	iio_buffer_block_done(iio_dac->stream_buffer);
+	if (!iio_axi_dac_stream_next(iio_dac))
+		return;
+
+	/* The host didn't write the next block in time */
+	iio_dac->dma_pending = false;
+	iio_buffer_underrun(iio_dac->stream_buffer);
+}
+
+/**
+ * @brief Send the written block. In streaming mode the blocks are sent one
+ * after the other from the DMA interrupt and this only restarts the stream
+ * when it ran out of data.
+ * @param dev_data - Device data containing the instance and the buffer
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int32_t iio_axi_dac_submit(struct iio_device_data *dev_data)
+{
+	struct iio_axi_dac_desc *iio_dac;
+	struct iio_buffer *buffer;
+	uint32_t nb_scans;
+	void *buff;
+	int32_t ret;
+
+	if (!dev_data)
+		return -EINVAL;
+
+	iio_dac = dev_data->dev;
+	buffer = dev_data->buffer;
+
+	if (buffer->cyclic_info.is_cyclic) {
+		ret = iio_buffer_get_block(buffer, &buff);
+		if (ret)
+			/* Already playing the waveform, nothing new to send */
+			return 0;
+
+		nb_scans = buffer->size / buffer->bytes_per_scan;
+		ret = iio_axi_dac_write_data(iio_dac, buff, nb_scans);
+		if (ret)
+			return ret;
+
+		return iio_buffer_block_done(buffer);
+	}
+
+	if (!iio_dac->stream_buffer) {
+		if (buffer->nb_blocks < 2)
+			return -EINVAL;
+
+		iio_dac->stream_buffer = buffer;
+	}
+
+	/* Without IRQ the completion of the block is detected here */
+	if (iio_dac->dma_pending)
+		axi_dmac_transfer_poll(iio_dac->dmac);
+
+	if (iio_dac->dma_pending)
+		return 0;
+
+	ret = iio_axi_dac_stream_next(iio_dac);
+
+	return ret == -EAGAIN ? 0 : ret;
+}
+
+/**
+ * @brief Stop the DMA stream.
+ * @param dev - Instance of the iio_axi_dac
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int32_t iio_axi_dac_post_disable(void *dev)
+{
+	struct iio_axi_dac_desc *iio_dac = dev;
+
+	if (iio_dac->dma_pending) {
+		axi_dmac_transfer_stop(iio_dac->dmac);
+		iio_dac->dma_pending = false;
+	}
+	iio_dac->stream_buffer = NULL;
+
+	return 0;
+}
+
 enum ch_type {
 	CH_VOLTGE,
 	CH_ALTVOLTGE,
@@ -542,7 +743,7 @@ static int iio_axi_dac_delete_device_descriptor(
 		return -1;
 
 	if (desc->dev_descriptor.channels)
-		free(desc->dev_descriptor.channels);
+		free((void *)desc->dev_descriptor.channels);
 
 	if (desc->ch_names)
 		free(desc->ch_names);
@@ -584,6 +785,7 @@ static int32_t iio_axi_dac_create_device_descriptor(
 		.indexed = true,
 	};
 
+	struct iio_channel *channels;
 	int32_t i, j, altvoltage_ch, voltage_ch_no, altvoltage_ch_no;
 	int32_t ret;
 	char ch;
@@ -592,10 +794,10 @@ static int32_t iio_axi_dac_create_device_descriptor(
 	altvoltage_ch_no = desc->dac->num_channels * 2;
 	iio_device->num_ch = voltage_ch_no + altvoltage_ch_no;
 	iio_device->attributes = NULL; /* no device attribute */
-	iio_device->channels = calloc(iio_device->num_ch,
-				      sizeof(struct iio_channel));
-	if (!iio_device->channels)
+	channels = calloc(iio_device->num_ch, sizeof(struct iio_channel));
+	if (!channels)
 		goto error;
+	iio_device->channels = channels;
 
 	desc->ch_names = calloc(iio_device->num_ch, sizeof(*desc->ch_names));
 	if (!desc->ch_names)
@@ -603,9 +805,9 @@ static int32_t iio_axi_dac_create_device_descriptor(
 
 	for (i = 0; i < voltage_ch_no; i++) {
 		default_voltage_channel.channel = i;
-		iio_device->channels[i] = default_voltage_channel;
-		iio_device->channels[i].scan_index = i;
-		iio_device->channels[i].name = desc->ch_names[i];
+		channels[i] = default_voltage_channel;
+		channels[i].scan_index = i;
+		channels[i].name = desc->ch_names[i];
 		ret = sprintf(desc->ch_names[i], "voltage%"PRIi32"", i);
 		if (ret < 0)
 			goto error;
@@ -614,9 +816,9 @@ static int32_t iio_axi_dac_create_device_descriptor(
 	for (i = voltage_ch_no; i < voltage_ch_no + altvoltage_ch_no; i++) {
 		altvoltage_ch = i - voltage_ch_no;
 		default_altvoltage_channel.channel = altvoltage_ch;
-		iio_device->channels[i] = default_altvoltage_channel;
-		iio_device->channels[i].scan_index = altvoltage_ch;
-		iio_device->channels[i].name = desc->ch_names[i];
+		channels[i] = default_altvoltage_channel;
+		channels[i].scan_index = altvoltage_ch;
+		channels[i].name = desc->ch_names[i];
 
 		ch = 'Q';
 		if (altvoltage_ch % 4 == 0 || altvoltage_ch % 4 == 1)
@@ -629,6 +831,10 @@ static int32_t iio_axi_dac_create_device_descriptor(
 	}
 	iio_device->pre_enable = iio_axi_dac_prepare_transfer;
 	iio_device->write_dev = iio_axi_dac_write_data;
+	if (desc->streaming) {
+		iio_device->submit = iio_axi_dac_submit;
+		iio_device->post_disable = iio_axi_dac_post_disable;
+	}
 
 	return 0;
 
@@ -651,6 +857,30 @@ void iio_axi_dac_get_dev_descriptor(struct iio_axi_dac_desc *desc,
 	*dev_descriptor = &desc->dev_descriptor;
 }
 
+/**
+ * @brief Play a waveform computed on the device, for example with
+ * no_os_dds_generate_interleaved(), without a host connected.
+ * @param desc - Descriptor.
+ * @param mask - Channels present in the buffer, they are switched to DMA.
+ * @param buff - Interleaved samples of the channels in mask.
+ * @param nb_samples - Number of samples per channel.
+ * @return 0 in case of success or negative value otherwise.
+ */
+int32_t iio_axi_dac_load_waveform(struct iio_axi_dac_desc *desc, uint32_t mask,
+				  void *buff, uint32_t nb_samples)
+{
+	int32_t ret;
+
+	if (!desc || !mask || !buff || !nb_samples)
+		return -EINVAL;
+
+	ret = iio_axi_dac_prepare_transfer(desc, mask);
+	if (ret)
+		return ret;
+
+	return iio_axi_dac_write_data(desc, buff, nb_samples);
+}
+
 /**
  * @brief Registers a iio_axi_dac_desc for reading/writing and parameterization
  * of axi_dac device.
@@ -678,6 +908,10 @@ int32_t iio_axi_dac_init(struct iio_axi_dac_desc **desc,
 	iio_axi_dac_inst->dac = init->tx_dac;
 	iio_axi_dac_inst->dmac = init->tx_dmac;
 	iio_axi_dac_inst->dcache_flush_range = init->dcache_flush_range;
+	iio_axi_dac_inst->cyclic_buf[0] = init->cyclic_buf[0];
+	iio_axi_dac_inst->cyclic_buf[1] = init->cyclic_buf[1];
+	iio_axi_dac_inst->cyclic_buf_size = init->cyclic_buf_size;
+	iio_axi_dac_inst->streaming = init->streaming;
 
 	status = iio_axi_dac_create_device_descriptor(iio_axi_dac_inst,
 			&iio_axi_dac_inst->dev_descriptor);
@@ -68,6 +68,18 @@ struct iio_axi_dac_desc {
 	struct iio_device dev_descriptor;
 	/** Channel names */
 	char (*ch_names)[20];
+	/** Buffers played alternately, see iio_axi_dac_init_param */
+	uint8_t *cyclic_buf[2];
+	/** Size in bytes of each of cyclic_buf */
+	uint32_t cyclic_buf_size;
+	/** Index of the buffer to be filled by the next write */
+	uint8_t cyclic_idx;
+	/** Play the non cyclic buffers block by block, as they are written */
+	bool streaming;
+	/** Set while the DMA sends a block of stream_buffer */
+	volatile bool dma_pending;
+	/** Buffer consumed by the DMA when streaming is set */
+	struct iio_buffer *stream_buffer;
 };
 
 /**
@@ -79,8 +91,27 @@ struct iio_axi_dac_init_param {
 	struct axi_dac *tx_dac;
 	/** Transmit DMA device */
 	struct axi_dmac *tx_dmac;
-	/** Function pointer to flush the data cache for the given address range */
+	/**
+	 * Function pointer to flush the data cache for the given address
+	 * range. Optional, no_os_dma_sync_for_device is used if not set.
+	 */
 	void (*dcache_flush_range)(uint32_t address, uint32_t bytes_count);
+	/**
+	 * Optional pair of DMA capable buffers. When set, each write is copied
+	 * to the buffer not being played and the DMAC switches to it at the end
+	 * of the current waveform, without stopping the output. Requires the
+	 * DMAC to support hardware cyclic transfers.
+	 */
+	uint8_t *cyclic_buf[2];
+	/** Size in bytes of each of cyclic_buf */
+	uint32_t cyclic_buf_size;
+	/**
+	 * Send the non cyclic buffers written by the host as a continuous
+	 * stream. The host fills a ring of buffer blocks while the DMAC sends
+	 * them, and the times the ring ran empty are counted as underruns.
+	 * Requires at least 2 buffer blocks.
+	 */
+	bool streaming;
 };
 
 /******************************************************************************/
@@ -93,6 +124,9 @@ int32_t iio_axi_dac_init(struct iio_axi_dac_desc **desc,
 /** Get device descriptor. */
 void iio_axi_dac_get_dev_descriptor(struct iio_axi_dac_desc *desc,
 				    struct iio_device **dev_descriptor);
+/* Play a waveform generated on the device on the channels in mask. */
+int32_t iio_axi_dac_load_waveform(struct iio_axi_dac_desc *desc, uint32_t mask,
+				  void *buff, uint32_t nb_samples);
 /* Free the resources allocated by iio_axi_dac_init(). */
 int32_t iio_axi_dac_remove(struct iio_axi_dac_desc *desc);
 
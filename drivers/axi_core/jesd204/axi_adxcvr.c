@@ -444,6 +444,39 @@ int adxcvr_clk_set_rate(struct adxcvr *xcvr,
 	return 0;
 }
 
+/**
+ * @brief AXI ADXCVR equalizer selection, for all the lanes of the core.
+ * @param xcvr - The device structure.
+ * @param lpm - true for LPM, false for DFE.
+ * @return Returns 0 in case of success or negative error code otherwise.
+ */
+int adxcvr_set_lpm_dfe_mode(struct adxcvr *xcvr, bool lpm)
+{
+	uint32_t control;
+	uint32_t i;
+	int ret;
+
+	if (xcvr->tx_enable)
+		return -EINVAL;
+
+	adxcvr_read(xcvr, ADXCVR_REG_CONTROL, &control);
+	if (lpm)
+		control |= ADXCVR_LPM_DFE_N;
+	else
+		control &= ~ADXCVR_LPM_DFE_N;
+	adxcvr_write(xcvr, ADXCVR_REG_CONTROL, control);
+
+	for (i = 0; i < xcvr->num_lanes; i++) {
+		ret = xilinx_xcvr_configure_lpm_dfe_mode(&xcvr->xlx_xcvr,
+				ADXCVR_DRP_PORT_CHANNEL(i), lpm);
+		if (ret)
+			return ret;
+	}
+	xcvr->lpm_enable = lpm;
+
+	return 0;
+}
+
 /**
  * @brief AXI ADXCVR Status Read
  * @param xcvr - The device structure.
@@ -136,6 +136,8 @@ int adxcvr_drp_write(struct adxcvr *xcvr,
 		     unsigned int drp_port,
 		     unsigned int reg,
 		     unsigned int val);
+/** AXI ADXCVR LPM or DFE equalizer selection */
+int adxcvr_set_lpm_dfe_mode(struct adxcvr *xcvr, bool lpm);
 /** AXI ADXCVRS Status Read */
 int32_t adxcvr_status_error(struct adxcvr *xcvr);
 /** AXI ADXCVR Clock Enable */
@@ -439,17 +439,15 @@ int32_t axi_jesd204_rx_laneinfo_read(struct axi_jesd204_rx *jesd, uint32_t lane)
 }
 
 /**
- * @brief Check JESD204 RX Lane Status.
+ * @brief Check if a JESD204 RX lane lost synchronization, without logging.
  * @param jesd - The device structure.
  * @param lane - Lane ID.
- * @return Returns 0 in case of success or positive value otherwise.
+ * @return true if the lane is desynced.
  */
-bool axi_jesd204_rx_check_lane_status(struct axi_jesd204_rx *jesd,
-				      uint32_t lane)
+static bool axi_jesd204_rx_lane_desynced(struct axi_jesd204_rx *jesd,
+		uint32_t lane)
 {
 	uint32_t status;
-	uint32_t errors;
-	char error_str[sizeof(" (4294967295 errors)")];
 
 	axi_jesd204_rx_read(jesd, JESD204_RX_REG_LANE_STATUS(lane), &status);
 
@@ -464,6 +462,24 @@ bool axi_jesd204_rx_check_lane_status(struct axi_jesd204_rx *jesd,
 			return false;
 	}
 
+	return true;
+}
+
+/**
+ * @brief Check JESD204 RX Lane Status.
+ * @param jesd - The device structure.
+ * @param lane - Lane ID.
+ * @return Returns 0 in case of success or positive value otherwise.
+ */
+bool axi_jesd204_rx_check_lane_status(struct axi_jesd204_rx *jesd,
+				      uint32_t lane)
+{
+	uint32_t errors;
+	char error_str[sizeof(" (4294967295 errors)")];
+
+	if (!axi_jesd204_rx_lane_desynced(jesd, lane))
+		return false;
+
 	if (PCORE_VERSION_MINOR(jesd->version) >= 2) {
 		axi_jesd204_rx_read(jesd, JESD204_RX_REG_LANE_ERRORS(lane), &errors);
 		snprintf(error_str, sizeof(error_str), " (%"PRIu32" errors)", errors);
@@ -506,6 +522,91 @@ int32_t axi_jesd204_rx_watchdog(struct axi_jesd204_rx *jesd)
 	return 0;
 }
 
+/**
+ * @brief Sample the JESD204 RX link and lane error counters, and restart the
+ * link when it is failing. Meant to be called periodically, for example from
+ * the main loop. Unlike axi_jesd204_rx_watchdog() it does not log and only
+ * restarts the failing link.
+ * @param jesd - The device structure.
+ * @param topology - JESD204 topology of the link, NULL if the JESD FSM is not
+ * used. The link is then restarted by toggling its disable bit.
+ * @param link_idx - Index of the link in the topology.
+ * @return Returns 0 in case of success or negative error code otherwise.
+ */
+int32_t axi_jesd204_rx_monitor(struct axi_jesd204_rx *jesd,
+			       struct jesd204_topology *topology,
+			       unsigned int link_idx)
+{
+	struct axi_jesd204_rx_stats *stats = &jesd->stats;
+	uint32_t link_disabled;
+	uint32_t link_status;
+	uint32_t new_errors = 0;
+	uint32_t num_lanes;
+	uint32_t errors;
+	uint32_t bin;
+	bool restart = false;
+	uint32_t i;
+	int32_t ret;
+
+	ret = axi_jesd204_rx_read(jesd, JESD204_RX_REG_LINK_STATE,
+				  &link_disabled);
+	if (ret)
+		return ret;
+	if (link_disabled)
+		return 0;
+
+	stats->samples++;
+	num_lanes = no_os_min(jesd->num_lanes, AXI_JESD204_RX_MAX_LANES);
+
+	if (PCORE_VERSION_MINOR(jesd->version) >= 2) {
+		for (i = 0; i < num_lanes; i++) {
+			axi_jesd204_rx_read(jesd, JESD204_RX_REG_LANE_ERRORS(i),
+					    &errors);
+			/* The counters are cleared when the link restarts */
+			if (errors >= stats->lane_errors[i])
+				new_errors += errors - stats->lane_errors[i];
+			else
+				new_errors += errors;
+			stats->lane_errors[i] = errors;
+		}
+	}
+
+	bin = new_errors ? no_os_find_last_set_bit(new_errors) + 1 : 0;
+	stats->error_hist[no_os_min(bin, AXI_JESD204_RX_HIST_BINS - 1)]++;
+
+	axi_jesd204_rx_read(jesd, JESD204_RX_REG_LINK_STATUS, &link_status);
+	if ((link_status & 0x3) == 3) {
+		stats->down_samples = 0;
+		for (i = 0; i < num_lanes && !restart; i++)
+			restart = axi_jesd204_rx_lane_desynced(jesd, i);
+	} else {
+		/* The link goes through the sync states after a restart */
+		stats->down_samples++;
+		restart = stats->down_samples >= AXI_JESD204_RX_MONITOR_DOWN_MAX;
+	}
+
+	if (!restart)
+		return 0;
+
+	stats->failures++;
+	stats->down_samples = 0;
+
+	if (topology) {
+		jesd204_fsm_stop(topology, link_idx);
+		ret = jesd204_fsm_start(topology, link_idx);
+	} else {
+		axi_jesd204_rx_write(jesd, JESD204_RX_REG_LINK_DISABLE, 0x1);
+		ret = axi_jesd204_rx_write(jesd, JESD204_RX_REG_LINK_DISABLE,
+					   0x0);
+	}
+	if (ret)
+		return ret;
+
+	stats->recoveries++;
+
+	return 0;
+}
+
 /**
  * @brief Apply the JESD204 RX configuration.
  * @param jesd - The device structure.
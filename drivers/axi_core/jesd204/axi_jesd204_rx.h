@@ -46,6 +46,14 @@
 #include <stdbool.h>
 #include "jesd204.h"
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+#define AXI_JESD204_RX_MAX_LANES	32
+#define AXI_JESD204_RX_HIST_BINS	8
+/* Samples out of the DATA state before axi_jesd204_rx_monitor() restarts */
+#define AXI_JESD204_RX_MONITOR_DOWN_MAX	3
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -55,6 +63,28 @@ struct jesd204_rx_config {
 	uint8_t subclass_version;
 };
 
+/**
+ * @struct axi_jesd204_rx_stats
+ * @brief Link statistics gathered by axi_jesd204_rx_monitor().
+ */
+struct axi_jesd204_rx_stats {
+	/** Number of samples of the enabled link */
+	uint32_t samples;
+	/** Link failures detected, link down or lane desynced */
+	uint32_t failures;
+	/** Link restarts done by the monitor */
+	uint32_t recoveries;
+	/** Consecutive samples out of the DATA state */
+	uint32_t down_samples;
+	/** Last value of the error counter of each lane */
+	uint32_t lane_errors[AXI_JESD204_RX_MAX_LANES];
+	/**
+	 * Samples by number of new lane errors: bin 0 for no error, bin n for
+	 * [2^(n-1), 2^n) errors, the last bin takes all the bigger counts.
+	 */
+	uint32_t error_hist[AXI_JESD204_RX_HIST_BINS];
+};
+
 /**
  * @struct jesd204_rx
  * @brief JESD204B/C Receive Peripheral Device Structure.
@@ -82,6 +112,8 @@ struct axi_jesd204_rx {
 	enum jesd204_encoder encoder;
 
 	struct jesd204_dev *jdev;
+	/** Statistics of axi_jesd204_rx_monitor() */
+	struct axi_jesd204_rx_stats stats;
 };
 
 /**
@@ -119,6 +151,10 @@ int32_t axi_jesd204_rx_laneinfo_read(struct axi_jesd204_rx *jesd,
 				     uint32_t lane);
 /** JESD204 RX Watchdog */
 int32_t axi_jesd204_rx_watchdog(struct axi_jesd204_rx *jesd);
+/** JESD204 RX periodic link monitor */
+int32_t axi_jesd204_rx_monitor(struct axi_jesd204_rx *jesd,
+			       struct jesd204_topology *topology,
+			       unsigned int link_idx);
 /** Device initialization */
 int32_t axi_jesd204_rx_init(struct axi_jesd204_rx **jesd204,
 			    const struct jesd204_rx_init *init);
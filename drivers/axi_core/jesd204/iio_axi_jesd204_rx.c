@@ -0,0 +1,199 @@
+/***************************************************************************//**
+ *   @file   iio_axi_jesd204_rx.c
+ *   @brief  IIO interface of the JESD204 RX link monitor.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <inttypes.h>
+#include "no_os_error.h"
+#include "no_os_util.h"
+#include "axi_jesd204_rx.h"
+#include "iio_axi_jesd204_rx.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+enum iio_axi_jesd204_rx_attr {
+	IIO_AXI_JESD204_RX_SAMPLES,
+	IIO_AXI_JESD204_RX_FAILURES,
+	IIO_AXI_JESD204_RX_RECOVERIES,
+	IIO_AXI_JESD204_RX_LANE_ERRORS,
+	IIO_AXI_JESD204_RX_ERROR_HIST,
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Print a list of counters separated by spaces.
+ * @param buf - Where value is stored.
+ * @param len - Maximum length of value to be stored in buf.
+ * @param val - The counters.
+ * @param nb - Number of counters.
+ * @return Length of chars written in buf, or negative value on failure.
+ */
+static int iio_axi_jesd204_rx_print_list(char *buf, uint32_t len,
+		const uint32_t *val, uint32_t nb)
+{
+	uint32_t i;
+	int pos = 0;
+	int ret;
+
+	for (i = 0; i < nb; i++) {
+		ret = snprintf(buf + pos, len - pos, i ? " %"PRIu32 : "%"PRIu32,
+			       val[i]);
+		if (ret < 0 || (uint32_t)ret >= len - pos)
+			return -EINVAL;
+		pos += ret;
+	}
+
+	return pos;
+}
+
+/**
+ * @brief Show a statistic of the link monitor.
+ * @param device - The struct axi_jesd204_rx of the link.
+ * @param buf - Where value is stored.
+ * @param len - Maximum length of value to be stored in buf.
+ * @param channel - Channel properties.
+ * @param priv - Selected statistic.
+ * @return Length of chars written in buf, or negative value on failure.
+ */
+static int iio_axi_jesd204_rx_show(void *device, char *buf, uint32_t len,
+				   const struct iio_ch_info *channel,
+				   intptr_t priv)
+{
+	struct axi_jesd204_rx *jesd = device;
+	struct axi_jesd204_rx_stats *stats;
+	uint32_t num_lanes;
+
+	if (!jesd)
+		return -EINVAL;
+
+	stats = &jesd->stats;
+	num_lanes = no_os_min(jesd->num_lanes, AXI_JESD204_RX_MAX_LANES);
+	switch (priv) {
+	case IIO_AXI_JESD204_RX_SAMPLES:
+		return snprintf(buf, len, "%"PRIu32, stats->samples);
+	case IIO_AXI_JESD204_RX_FAILURES:
+		return snprintf(buf, len, "%"PRIu32, stats->failures);
+	case IIO_AXI_JESD204_RX_RECOVERIES:
+		return snprintf(buf, len, "%"PRIu32, stats->recoveries);
+	case IIO_AXI_JESD204_RX_LANE_ERRORS:
+		return iio_axi_jesd204_rx_print_list(buf, len,
+						     stats->lane_errors,
+						     num_lanes);
+	case IIO_AXI_JESD204_RX_ERROR_HIST:
+		return iio_axi_jesd204_rx_print_list(buf, len,
+						     stats->error_hist,
+						     AXI_JESD204_RX_HIST_BINS);
+	default:
+		return -EINVAL;
+	}
+}
+
+/**
+ * @brief Clear the statistics of the link monitor, on any written value.
+ * @param device - The struct axi_jesd204_rx of the link.
+ * @param buf - Value to be written.
+ * @param len - Length of the data in buf.
+ * @param channel - Channel properties.
+ * @param priv - Selected statistic.
+ * @return Length of chars consumed from buf, or negative value on failure.
+ */
+static int iio_axi_jesd204_rx_clear(void *device, char *buf, uint32_t len,
+				    const struct iio_ch_info *channel,
+				    intptr_t priv)
+{
+	struct axi_jesd204_rx *jesd = device;
+	struct axi_jesd204_rx_stats *stats;
+	uint32_t i;
+
+	if (!jesd)
+		return -EINVAL;
+
+	/* Lane counters are kept, the next sample is relative to them */
+	stats = &jesd->stats;
+	stats->samples = 0;
+	stats->failures = 0;
+	stats->recoveries = 0;
+	for (i = 0; i < AXI_JESD204_RX_HIST_BINS; i++)
+		stats->error_hist[i] = 0;
+
+	return len;
+}
+
+static struct iio_attribute iio_axi_jesd204_rx_attributes[] = {
+	{
+		.name = "monitor_samples",
+		.priv = IIO_AXI_JESD204_RX_SAMPLES,
+		.show = iio_axi_jesd204_rx_show,
+		.store = iio_axi_jesd204_rx_clear,
+	},
+	{
+		.name = "monitor_failures",
+		.priv = IIO_AXI_JESD204_RX_FAILURES,
+		.show = iio_axi_jesd204_rx_show,
+	},
+	{
+		.name = "monitor_recoveries",
+		.priv = IIO_AXI_JESD204_RX_RECOVERIES,
+		.show = iio_axi_jesd204_rx_show,
+	},
+	{
+		.name = "lane_errors",
+		.priv = IIO_AXI_JESD204_RX_LANE_ERRORS,
+		.show = iio_axi_jesd204_rx_show,
+	},
+	{
+		.name = "lane_errors_histogram",
+		.priv = IIO_AXI_JESD204_RX_ERROR_HIST,
+		.show = iio_axi_jesd204_rx_show,
+	},
+	END_ATTRIBUTES_ARRAY,
+};
+
+struct iio_device const iio_axi_jesd204_rx_device = {
+	.num_ch = 0,
+	.channels = NULL,
+	.attributes = iio_axi_jesd204_rx_attributes,
+};
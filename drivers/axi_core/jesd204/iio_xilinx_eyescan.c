@@ -0,0 +1,239 @@
+/***************************************************************************//**
+ *   @file   iio_xilinx_eyescan.c
+ *   @brief  IIO interface of the Xilinx transceiver eye scan.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include "no_os_error.h"
+#include "no_os_util.h"
+#include "iio.h"
+#include "xilinx_eyescan.h"
+#include "iio_xilinx_eyescan.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+enum iio_xilinx_eyescan_attr {
+	IIO_XILINX_EYESCAN_LANE,
+	IIO_XILINX_EYESCAN_POINTS,
+	IIO_XILINX_EYESCAN_SIZE,
+	IIO_XILINX_EYESCAN_MAP,
+	IIO_XILINX_EYESCAN_MARGIN,
+	IIO_XILINX_EYESCAN_EQUALIZER,
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Print the map, one row per line, two hex digits per point.
+ * @param es - The eye scan descriptor.
+ * @param buf - Where value is stored.
+ * @param len - Maximum length of value to be stored in buf.
+ * @return Length of chars written in buf, or negative value on failure.
+ */
+static int iio_xilinx_eyescan_print_map(struct xilinx_eyescan *es, char *buf,
+					uint32_t len)
+{
+	static const char hex[] = "0123456789abcdef";
+	uint32_t pos = 0;
+	uint32_t row;
+	uint32_t col;
+	uint8_t val;
+
+	if (len < es->nb_rows * (2 * es->nb_cols + 1) + 1)
+		return -ENOBUFS;
+
+	for (row = 0; row < es->nb_rows; row++) {
+		for (col = 0; col < es->nb_cols; col++) {
+			val = es->map[row * es->nb_cols + col];
+			buf[pos++] = hex[val >> 4];
+			buf[pos++] = hex[val & 0xf];
+		}
+		buf[pos++] = '\n';
+	}
+	buf[pos] = '\0';
+
+	return pos;
+}
+
+/**
+ * @brief Show an eye scan attribute.
+ * @param device - The struct xilinx_eyescan of the transceiver.
+ * @param buf - Where value is stored.
+ * @param len - Maximum length of value to be stored in buf.
+ * @param channel - Channel properties.
+ * @param priv - Selected attribute.
+ * @return Length of chars written in buf, or negative value on failure.
+ */
+static int iio_xilinx_eyescan_show(void *device, char *buf, uint32_t len,
+				   const struct iio_ch_info *channel,
+				   intptr_t priv)
+{
+	struct xilinx_eyescan *es = device;
+	uint32_t h_mui;
+	uint32_t v_codes;
+	int ret;
+
+	if (!es)
+		return -EINVAL;
+
+	switch (priv) {
+	case IIO_XILINX_EYESCAN_LANE:
+		return snprintf(buf, len, "%"PRIu32, es->lane);
+	case IIO_XILINX_EYESCAN_POINTS:
+		return snprintf(buf, len, "%"PRIu32" %"PRIu32, es->measured,
+				es->skipped);
+	case IIO_XILINX_EYESCAN_SIZE:
+		return snprintf(buf, len, "%"PRIu32" %"PRIu32" %"PRIu32
+				" %"PRIu32" %"PRIu32, es->nb_cols, es->nb_rows,
+				es->h_step, es->v_step, es->target_ber);
+	case IIO_XILINX_EYESCAN_MAP:
+		return iio_xilinx_eyescan_print_map(es, buf, len);
+	case IIO_XILINX_EYESCAN_MARGIN:
+		ret = xilinx_eyescan_margin(es, &h_mui, &v_codes);
+		if (ret)
+			return ret;
+
+		return snprintf(buf, len, "%"PRIu32" %"PRIu32, h_mui, v_codes);
+	case IIO_XILINX_EYESCAN_EQUALIZER:
+		return snprintf(buf, len, "%s",
+				es->xcvr->lpm_enable ? "lpm" : "dfe");
+	default:
+		return -EINVAL;
+	}
+}
+
+/**
+ * @brief Store an eye scan attribute. Writing the lane scans it, writing
+ * "auto" to the equalizer scans the lane with DFE and LPM and keeps the best.
+ * @param device - The struct xilinx_eyescan of the transceiver.
+ * @param buf - Value to be written.
+ * @param len - Length of the data in buf.
+ * @param channel - Channel properties.
+ * @param priv - Selected attribute.
+ * @return Length of chars consumed from buf, or negative value on failure.
+ */
+static int iio_xilinx_eyescan_store(void *device, char *buf, uint32_t len,
+				    const struct iio_ch_info *channel,
+				    intptr_t priv)
+{
+	struct xilinx_eyescan *es = device;
+	uint32_t best;
+	int32_t val;
+	int ret;
+
+	if (!es)
+		return -EINVAL;
+
+	switch (priv) {
+	case IIO_XILINX_EYESCAN_LANE:
+		ret = iio_parse_value(buf, IIO_VAL_INT, &val, NULL);
+		if (ret)
+			return ret;
+		if (val < 0)
+			return -EINVAL;
+
+		ret = xilinx_eyescan_run(es, val);
+		break;
+	case IIO_XILINX_EYESCAN_EQUALIZER:
+		if (!strncmp(buf, "auto", 4))
+			ret = xilinx_eyescan_tune(es, es->lane, 2,
+						  xilinx_eyescan_apply_lpm_dfe,
+						  es, &best);
+		else if (!strncmp(buf, "lpm", 3))
+			ret = xilinx_eyescan_apply_lpm_dfe(es, es->lane, 1);
+		else if (!strncmp(buf, "dfe", 3))
+			ret = xilinx_eyescan_apply_lpm_dfe(es, es->lane, 0);
+		else
+			ret = -EINVAL;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return ret ? ret : (int)len;
+}
+
+static struct iio_attribute iio_xilinx_eyescan_attributes[] = {
+	{
+		.name = "eyescan_lane",
+		.priv = IIO_XILINX_EYESCAN_LANE,
+		.show = iio_xilinx_eyescan_show,
+		.store = iio_xilinx_eyescan_store,
+	},
+	{
+		.name = "eyescan_points",
+		.priv = IIO_XILINX_EYESCAN_POINTS,
+		.show = iio_xilinx_eyescan_show,
+	},
+	{
+		.name = "eyescan_size",
+		.priv = IIO_XILINX_EYESCAN_SIZE,
+		.show = iio_xilinx_eyescan_show,
+	},
+	{
+		.name = "eyescan_map",
+		.priv = IIO_XILINX_EYESCAN_MAP,
+		.show = iio_xilinx_eyescan_show,
+	},
+	{
+		.name = "eyescan_margin",
+		.priv = IIO_XILINX_EYESCAN_MARGIN,
+		.show = iio_xilinx_eyescan_show,
+	},
+	{
+		.name = "equalizer",
+		.priv = IIO_XILINX_EYESCAN_EQUALIZER,
+		.show = iio_xilinx_eyescan_show,
+		.store = iio_xilinx_eyescan_store,
+	},
+	END_ATTRIBUTES_ARRAY,
+};
+
+struct iio_device const iio_xilinx_eyescan_device = {
+	.num_ch = 0,
+	.channels = NULL,
+	.attributes = iio_xilinx_eyescan_attributes,
+};
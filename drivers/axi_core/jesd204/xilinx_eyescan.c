@@ -0,0 +1,769 @@
+/***************************************************************************//**
+ *   @file   xilinx_eyescan.c
+ *   @brief  Statistical eye scan of the Xilinx transceiver lanes.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <string.h>
+#include <inttypes.h>
+#include "no_os_alloc.h"
+#include "no_os_delay.h"
+#include "no_os_error.h"
+#include "no_os_util.h"
+#include "no_os_print_log.h"
+#include "xilinx_transceiver.h"
+#include "xilinx_eyescan.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+#define XILINX_EYESCAN_DRP_PORT(lane)	(0x100 + (lane))
+
+/* Fields of the register at regs->control */
+#define XILINX_EYESCAN_EN		NO_OS_BIT(8)
+#define XILINX_EYESCAN_ERRDET_EN	NO_OS_BIT(9)
+#define XILINX_EYESCAN_CONTROL_MASK	NO_OS_GENMASK(15, 10)
+/* ES_CONTROL[0], starts a measurement */
+#define XILINX_EYESCAN_RUN		NO_OS_BIT(10)
+/* ES_CONTROL_STATUS[0] */
+#define XILINX_EYESCAN_DONE		NO_OS_BIT(0)
+
+#define XILINX_EYESCAN_PRESCALE_MASK	0x1f
+#define XILINX_EYESCAN_MAX_PRESCALE	31
+/* Each step checks 8 times more bits than the previous one */
+#define XILINX_EYESCAN_PRESCALE_STEP	3
+#define XILINX_EYESCAN_MAX_CODE		127
+#define XILINX_EYESCAN_MAX_COUNT	0xffff
+/* ES_QUAL_MASK and ES_SDATA_MASK are 5 registers of 16 bits */
+#define XILINX_EYESCAN_MASK_REGS	5
+#define XILINX_EYESCAN_MASK_BITS	80
+#define XILINX_EYESCAN_POLL_US		10
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+/**
+ * @struct xilinx_eyescan_regs
+ * @brief DRP layout of the eye scan of a transceiver type.
+ */
+struct xilinx_eyescan_regs {
+	uint32_t control;
+	uint32_t prescale;
+	uint32_t prescale_shift;
+	uint32_t horz;
+	uint32_t horz_mask;
+	uint32_t (*horz_val)(int32_t h);
+	uint32_t vert;
+	uint32_t vert_mask;
+	uint32_t (*vert_val)(int32_t v, uint32_t ut);
+	/* First of the XILINX_EYESCAN_MASK_REGS registers */
+	uint32_t qual_mask;
+	uint32_t sdata_mask;
+	uint32_t error_count;
+	uint32_t sample_count;
+	uint32_t status;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+/* ES_HORZ_OFFSET[11:0], two's complement */
+static uint32_t xilinx_eyescan_gtx2_horz(int32_t h)
+{
+	return (uint32_t)h & 0xfff;
+}
+
+/* ES_VERT_OFFSET[8:0], UT sign, sign and magnitude */
+static uint32_t xilinx_eyescan_gtx2_vert(int32_t v, uint32_t ut)
+{
+	if (v < 0)
+		return (ut << 8) | NO_OS_BIT(7) | (uint32_t)-v;
+
+	return (ut << 8) | (uint32_t)v;
+}
+
+/* ES_HORZ_OFFSET[15:4], bit 11 of the offset is the phase unification */
+static uint32_t xilinx_eyescan_gth34_horz(int32_t h)
+{
+	return (((uint32_t)h & 0x7ff) | (h < 0 ? NO_OS_BIT(11) : 0)) << 4;
+}
+
+/* RX_EYESCAN_VS_NEG_DIR[10], _UT_SIGN[9] and _CODE[8:2] */
+static uint32_t xilinx_eyescan_gth34_vert(int32_t v, uint32_t ut)
+{
+	if (v < 0)
+		return NO_OS_BIT(10) | (ut << 9) | ((uint32_t)-v << 2);
+
+	return (ut << 9) | ((uint32_t)v << 2);
+}
+
+static const struct xilinx_eyescan_regs xilinx_eyescan_gtx2_regs = {
+	.control = 0x3d,
+	.prescale = 0x3b,
+	.prescale_shift = 11,
+	.horz = 0x3c,
+	.horz_mask = 0x0fff,
+	.horz_val = xilinx_eyescan_gtx2_horz,
+	.vert = 0x3b,
+	.vert_mask = 0x01ff,
+	.vert_val = xilinx_eyescan_gtx2_vert,
+	.qual_mask = 0x31,
+	.sdata_mask = 0x36,
+	.error_count = 0x14f,
+	.sample_count = 0x150,
+	.status = 0x151,
+};
+
+static const struct xilinx_eyescan_regs xilinx_eyescan_gth34_regs = {
+	.control = 0x3c,
+	.prescale = 0x3c,
+	.prescale_shift = 0,
+	.horz = 0x4f,
+	.horz_mask = 0xfff0,
+	.horz_val = xilinx_eyescan_gth34_horz,
+	.vert = 0x97,
+	.vert_mask = 0x07fc,
+	.vert_val = xilinx_eyescan_gth34_vert,
+	.qual_mask = 0x44,
+	.sdata_mask = 0x49,
+	.error_count = 0x251,
+	.sample_count = 0x252,
+	.status = 0x253,
+};
+
+/**
+ * @brief Fixed point base 2 logarithm.
+ * @param x - Value, not 0.
+ * @return log2(x) with 8 fractional bits.
+ */
+static uint32_t xilinx_eyescan_log2_q8(uint64_t x)
+{
+	uint32_t ilog = 0;
+	uint32_t frac = 0;
+	uint64_t y;
+	int i;
+
+	while (x >> (ilog + 1))
+		ilog++;
+
+	/* x / 2^ilog in [1, 2) with 31 fractional bits, squared for each bit */
+	y = ilog > 31 ? x >> (ilog - 31) : x << (31 - ilog);
+	for (i = 0; i < 8; i++) {
+		y = (y * y) >> 31;
+		frac <<= 1;
+		if (y >> 32) {
+			y >>= 1;
+			frac |= 1;
+		}
+	}
+
+	return (ilog << 8) | frac;
+}
+
+/**
+ * @brief Map value of a point.
+ * @param errors - Errors counted at the point.
+ * @param bits - Bits checked at the point.
+ * @return -log10(BER) in 1/16 decades, the bound given by bits if there are
+ * no errors.
+ */
+static uint8_t xilinx_eyescan_ber_q4(uint32_t errors, uint64_t bits)
+{
+	uint32_t l2_bits;
+	uint32_t l2_errors;
+
+	if (!bits)
+		return 0;
+
+	l2_bits = xilinx_eyescan_log2_q8(bits);
+	l2_errors = xilinx_eyescan_log2_q8(errors ? errors : 1);
+	if (l2_errors >= l2_bits)
+		return 0;
+
+	/* log10(x) = log2(x) * 77 / 256 */
+	return no_os_min((l2_bits - l2_errors) * 77 >> 12, 255);
+}
+
+/**
+ * @brief Read a register written for each point into the shadows.
+ * @param es - The eye scan descriptor.
+ * @param port - DRP port of the lane.
+ * @param reg - DRP address.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int xilinx_eyescan_shadow(struct xilinx_eyescan *es, uint32_t port,
+				 uint32_t reg)
+{
+	uint32_t i;
+
+	for (i = 0; i < es->nb_shadow; i++)
+		if (es->shadow_reg[i] == reg)
+			return 0;
+
+	if (es->nb_shadow == NO_OS_ARRAY_SIZE(es->shadow_reg))
+		return -ENOSPC;
+
+	es->shadow_reg[es->nb_shadow] = reg;
+
+	return adxcvr_drp_read(es->xcvr, port, reg,
+			       &es->shadow_val[es->nb_shadow++]);
+}
+
+/**
+ * @brief Update a field of a shadowed register, writing it only if the value
+ * changes. These writes are not read back.
+ * @param es - The eye scan descriptor.
+ * @param port - DRP port of the lane.
+ * @param reg - DRP address.
+ * @param mask - Mask of the field.
+ * @param val - Value of the field, in place.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int xilinx_eyescan_write(struct xilinx_eyescan *es, uint32_t port,
+				uint32_t reg, uint32_t mask, uint32_t val)
+{
+	uint32_t i;
+	int ret;
+
+	for (i = 0; i < es->nb_shadow; i++)
+		if (es->shadow_reg[i] == reg)
+			break;
+	if (i == es->nb_shadow)
+		return -EINVAL;
+
+	val = (es->shadow_val[i] & ~mask) | (val & mask);
+	if (val == es->shadow_val[i])
+		return 0;
+
+	ret = adxcvr_drp_write(es->xcvr, port, reg, val);
+	if (ret)
+		return ret;
+	es->shadow_val[i] = val;
+
+	return 0;
+}
+
+/**
+ * @brief Enable the eye scan of a lane in statistical mode. All the bits of
+ * the data path are compared, the qualifier is not used.
+ * @param es - The eye scan descriptor.
+ * @param port - DRP port of the lane.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int xilinx_eyescan_setup(struct xilinx_eyescan *es, uint32_t port)
+{
+	struct xilinx_xcvr_drp_field fields[1 + 2 * XILINX_EYESCAN_MASK_REGS];
+	const struct xilinx_eyescan_regs *regs = es->regs;
+	struct xilinx_xcvr_drp_field *field;
+	uint32_t out_div;
+	uint32_t mask;
+	uint32_t bit;
+	uint32_t i;
+	uint32_t j;
+	int ret;
+
+	ret = xilinx_xcvr_read_out_div(&es->xcvr->xlx_xcvr, port, &out_div,
+				       NULL);
+	if (ret)
+		return ret;
+	es->ui_codes = 64 * out_div;
+
+	fields[0].reg = regs->control;
+	fields[0].mask = XILINX_EYESCAN_CONTROL_MASK | XILINX_EYESCAN_EN |
+			 XILINX_EYESCAN_ERRDET_EN;
+	fields[0].val = XILINX_EYESCAN_EN | XILINX_EYESCAN_ERRDET_EN;
+	field = &fields[1];
+	for (i = 0; i < XILINX_EYESCAN_MASK_REGS; i++, field++) {
+		field->reg = regs->qual_mask + i;
+		field->mask = 0xffff;
+		field->val = 0xffff;
+	}
+	for (i = 0; i < XILINX_EYESCAN_MASK_REGS; i++, field++) {
+		/* Only the data_width most significant bits are unmasked */
+		mask = 0;
+		for (j = 0; j < 16; j++) {
+			bit = i * 16 + j;
+			if (bit < XILINX_EYESCAN_MASK_BITS - es->data_width)
+				mask |= NO_OS_BIT(j);
+		}
+		field->reg = regs->sdata_mask + i;
+		field->mask = 0xffff;
+		field->val = mask;
+	}
+
+	ret = xilinx_xcvr_drp_update_fields(&es->xcvr->xlx_xcvr, port, fields,
+					    NO_OS_ARRAY_SIZE(fields));
+	if (ret)
+		return ret;
+
+	es->nb_shadow = 0;
+	ret = xilinx_eyescan_shadow(es, port, regs->control);
+	if (ret)
+		return ret;
+	ret = xilinx_eyescan_shadow(es, port, regs->prescale);
+	if (ret)
+		return ret;
+	ret = xilinx_eyescan_shadow(es, port, regs->horz);
+	if (ret)
+		return ret;
+
+	return xilinx_eyescan_shadow(es, port, regs->vert);
+}
+
+/**
+ * @brief Run one measurement at the offsets already set.
+ * @param es - The eye scan descriptor.
+ * @param port - DRP port of the lane.
+ * @param prescale - ES_PRESCALE, the sample count is in units of
+ * 2^(1 + prescale) data words.
+ * @param errors - Error count.
+ * @param samples - Sample count.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int xilinx_eyescan_measure(struct xilinx_eyescan *es, uint32_t port,
+				  uint32_t prescale, uint32_t *errors,
+				  uint32_t *samples)
+{
+	const struct xilinx_eyescan_regs *regs = es->regs;
+	uint64_t timeout_us;
+	uint32_t status;
+	uint32_t us;
+	int ret;
+
+	ret = xilinx_eyescan_write(es, port, regs->prescale,
+				   XILINX_EYESCAN_PRESCALE_MASK <<
+				   regs->prescale_shift,
+				   prescale << regs->prescale_shift);
+	if (ret)
+		return ret;
+
+	ret = xilinx_eyescan_write(es, port, regs->control,
+				   XILINX_EYESCAN_RUN, XILINX_EYESCAN_RUN);
+	if (ret)
+		return ret;
+
+	/* Twice the time of a full sample count, lane_rate_khz is bits/ms */
+	timeout_us = ((uint64_t)XILINX_EYESCAN_MAX_COUNT * es->data_width) <<
+		     (1 + prescale);
+	timeout_us = no_os_div_u64(timeout_us * 2000,
+				   no_os_max(es->xcvr->lane_rate_khz, 1));
+	timeout_us += 1000;
+
+	for (us = 0;; us += XILINX_EYESCAN_POLL_US) {
+		ret = adxcvr_drp_read(es->xcvr, port, regs->status, &status);
+		if (ret)
+			goto stop;
+		if (status & XILINX_EYESCAN_DONE)
+			break;
+		if (us >= timeout_us) {
+			ret = -ETIMEDOUT;
+			goto stop;
+		}
+		no_os_udelay(XILINX_EYESCAN_POLL_US);
+	}
+
+	ret = adxcvr_drp_read(es->xcvr, port, regs->error_count, errors);
+	if (ret)
+		goto stop;
+	ret = adxcvr_drp_read(es->xcvr, port, regs->sample_count, samples);
+stop:
+	/* Back to the WAIT state, the next run restarts the counters */
+	if (xilinx_eyescan_write(es, port, regs->control, XILINX_EYESCAN_RUN,
+				 0))
+		return -EIO;
+
+	return ret;
+}
+
+/**
+ * @brief Measure the BER at an offset. The measurement is repeated with more
+ * bits until min_errors errors are seen or prescale_max is reached, so the
+ * points where the eye is closed take a single short measurement.
+ * @param es - The eye scan descriptor.
+ * @param port - DRP port of the lane.
+ * @param h - Horizontal offset.
+ * @param v - Vertical offset.
+ * @param val - Map value of the point.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int xilinx_eyescan_point(struct xilinx_eyescan *es, uint32_t port,
+				int32_t h, int32_t v, uint8_t *val)
+{
+	const struct xilinx_eyescan_regs *regs = es->regs;
+	uint32_t prescale = 0;
+	uint32_t errors;
+	uint32_t samples;
+	uint32_t err;
+	uint32_t nb_ut;
+	uint32_t ut;
+	uint64_t bits;
+	int ret;
+
+	ret = xilinx_eyescan_write(es, port, regs->horz, regs->horz_mask,
+				   regs->horz_val(h));
+	if (ret)
+		return ret;
+
+	/* With DFE both signs of the unrolled tap are measured */
+	nb_ut = es->xcvr->lpm_enable ? 1 : 2;
+	while (true) {
+		errors = 0;
+		bits = 0;
+		for (ut = 0; ut < nb_ut; ut++) {
+			ret = xilinx_eyescan_write(es, port, regs->vert,
+						   regs->vert_mask,
+						   regs->vert_val(v, ut));
+			if (ret)
+				return ret;
+
+			ret = xilinx_eyescan_measure(es, port, prescale, &err,
+						     &samples);
+			if (ret)
+				return ret;
+
+			errors += err;
+			bits += ((uint64_t)samples * es->data_width) <<
+				(1 + prescale);
+		}
+
+		if (errors >= es->min_errors || prescale >= es->prescale_max)
+			break;
+		prescale = no_os_min(prescale + XILINX_EYESCAN_PRESCALE_STEP,
+				     es->prescale_max);
+	}
+
+	*val = xilinx_eyescan_ber_q4(errors, bits);
+	es->measured++;
+
+	return 0;
+}
+
+/**
+ * @brief Scan a row of the map from the sampling point outwards. Once a point
+ * is closed the points farther from the middle are set to its value.
+ * @param es - The eye scan descriptor.
+ * @param port - DRP port of the lane.
+ * @param v - Vertical offset of the row.
+ * @param row - Map values of the row.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int xilinx_eyescan_row(struct xilinx_eyescan *es, uint32_t port,
+			      int32_t v, uint8_t *row)
+{
+	int32_t step = es->h_step * es->ui_codes / 64;
+	int32_t nb = es->nb_cols;
+	int32_t mid = nb / 2;
+	int32_t col;
+	int32_t dir;
+	int ret;
+
+	for (dir = -1; dir <= 1; dir += 2) {
+		for (col = dir < 0 ? mid : mid + 1; col >= 0 && col < nb;
+		     col += dir) {
+			ret = xilinx_eyescan_point(es, port, (col - mid) * step,
+						   v, &row[col]);
+			if (ret)
+				return ret;
+			if (row[col] < XILINX_EYESCAN_CLOSED)
+				break;
+		}
+
+		for (col += dir; col >= 0 && col < nb; col += dir) {
+			row[col] = row[col - dir];
+			es->skipped++;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Initialize the eye scan of a transceiver.
+ * @param es - The eye scan descriptor.
+ * @param init - Initialization parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int xilinx_eyescan_init(struct xilinx_eyescan **es,
+			const struct xilinx_eyescan_init *init)
+{
+	struct xilinx_eyescan *d;
+
+	if (!es || !init || !init->xcvr)
+		return -EINVAL;
+
+	d = (struct xilinx_eyescan *)no_os_calloc(1, sizeof(*d));
+	if (!d)
+		return -ENOMEM;
+
+	switch (init->xcvr->xlx_xcvr.type) {
+	case XILINX_XCVR_TYPE_S7_GTX2:
+		d->regs = &xilinx_eyescan_gtx2_regs;
+		break;
+	case XILINX_XCVR_TYPE_US_GTH3:
+	case XILINX_XCVR_TYPE_US_GTH4:
+	case XILINX_XCVR_TYPE_US_GTY4:
+		d->regs = &xilinx_eyescan_gth34_regs;
+		break;
+	default:
+		goto error;
+	}
+
+	d->xcvr = init->xcvr;
+	d->h_step = init->h_step ? init->h_step : 4;
+	d->v_step = init->v_step ? init->v_step : 8;
+	d->prescale_max = init->prescale_max ? init->prescale_max : 8;
+	d->min_errors = init->min_errors ? init->min_errors : 4;
+	d->target_ber = init->target_ber ? init->target_ber : 6;
+	d->data_width = init->data_width;
+	if (!d->data_width)
+		d->data_width = d->xcvr->xlx_xcvr.encoding == ENC_66B64B ?
+				64 : 40;
+	if (d->h_step > 32 || d->v_step > XILINX_EYESCAN_MAX_CODE ||
+	    d->prescale_max > XILINX_EYESCAN_MAX_PRESCALE ||
+	    d->data_width > XILINX_EYESCAN_MASK_BITS)
+		goto error;
+
+	/* Offsets up to half a UI and to the largest vertical code */
+	d->nb_cols = 2 * (32 / d->h_step) + 1;
+	d->nb_rows = 2 * (XILINX_EYESCAN_MAX_CODE / d->v_step) + 1;
+	d->map = (uint8_t *)no_os_calloc(d->nb_cols * d->nb_rows,
+					 sizeof(*d->map));
+	if (!d->map)
+		goto error;
+
+	*es = d;
+
+	return 0;
+error:
+	no_os_free(d);
+
+	return -EINVAL;
+}
+
+/**
+ * @brief Scan the eye of a lane, from the middle outwards. Rows past a row
+ * closed at the sampling point are not measured.
+ * @param es - The eye scan descriptor.
+ * @param lane - Lane of the transceiver.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int xilinx_eyescan_run(struct xilinx_eyescan *es, uint32_t lane)
+{
+	uint32_t port;
+	uint8_t *map;
+	int32_t step;
+	int32_t nb;
+	int32_t mid;
+	int32_t row;
+	int32_t dir;
+	int ret;
+
+	if (!es || lane >= es->xcvr->num_lanes)
+		return -EINVAL;
+
+	port = XILINX_EYESCAN_DRP_PORT(lane);
+	map = es->map;
+	step = es->v_step;
+	nb = es->nb_rows;
+	mid = nb / 2;
+	es->lane = lane;
+	es->measured = 0;
+	es->skipped = 0;
+
+	ret = xilinx_eyescan_setup(es, port);
+	if (ret)
+		goto error;
+
+	for (dir = -1; dir <= 1; dir += 2) {
+		for (row = dir < 0 ? mid : mid + 1; row >= 0 && row < nb;
+		     row += dir) {
+			ret = xilinx_eyescan_row(es, port, (mid - row) * step,
+						 &map[row * es->nb_cols]);
+			if (ret)
+				goto error;
+			if (map[row * es->nb_cols + es->nb_cols / 2] <
+			    XILINX_EYESCAN_CLOSED)
+				break;
+		}
+
+		for (row += dir; row >= 0 && row < nb; row += dir) {
+			memset(&map[row * es->nb_cols],
+			       map[(row - dir) * es->nb_cols + es->nb_cols / 2],
+			       es->nb_cols);
+			es->skipped += es->nb_cols;
+		}
+	}
+
+	return 0;
+error:
+	pr_err("%s: eye scan of lane %"PRIu32" failed: %d\n", es->xcvr->name,
+	       lane, ret);
+
+	return ret;
+}
+
+/**
+ * @brief Get the eye opening of the last scan, where the BER stays under
+ * 10^-target_ber around the sampling point.
+ * @param es - The eye scan descriptor.
+ * @param h_mui - Horizontal opening in 1/1000 UI.
+ * @param v_codes - Vertical opening in vertical offset codes.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int xilinx_eyescan_margin(struct xilinx_eyescan *es, uint32_t *h_mui,
+			  uint32_t *v_codes)
+{
+	uint32_t threshold;
+	uint32_t mid_col;
+	uint32_t mid_row;
+	uint32_t open;
+	uint32_t i;
+
+	if (!es || !h_mui || !v_codes)
+		return -EINVAL;
+
+	threshold = no_os_min(es->target_ber * 16, 255);
+	mid_col = es->nb_cols / 2;
+	mid_row = es->nb_rows / 2;
+
+	open = 0;
+	for (i = mid_col; i < es->nb_cols &&
+	     es->map[mid_row * es->nb_cols + i] >= threshold; i++)
+		open++;
+	for (i = mid_col; i-- > 0 &&
+	     es->map[mid_row * es->nb_cols + i] >= threshold;)
+		open++;
+	*h_mui = open * es->h_step * 1000 / 64;
+
+	open = 0;
+	for (i = mid_row; i < es->nb_rows &&
+	     es->map[i * es->nb_cols + mid_col] >= threshold; i++)
+		open++;
+	for (i = mid_row; i-- > 0 &&
+	     es->map[i * es->nb_cols + mid_col] >= threshold;)
+		open++;
+	*v_codes = open * es->v_step;
+
+	return 0;
+}
+
+/**
+ * @brief Scan a lane with each equalizer setting and apply the one with the
+ * largest eye area. The map holds the scan of the last setting.
+ * @param es - The eye scan descriptor.
+ * @param lane - Lane of the transceiver.
+ * @param nb_settings - Number of settings.
+ * @param apply - Applies a setting.
+ * @param ctx - Passed to apply.
+ * @param best - Selected setting.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int xilinx_eyescan_tune(struct xilinx_eyescan *es, uint32_t lane,
+			uint32_t nb_settings, xilinx_eyescan_apply apply,
+			void *ctx, uint32_t *best)
+{
+	uint64_t best_area = 0;
+	uint64_t area;
+	uint32_t h_mui;
+	uint32_t v_codes;
+	uint32_t i;
+	int ret;
+
+	if (!es || !nb_settings || !apply || !best)
+		return -EINVAL;
+
+	*best = 0;
+	for (i = 0; i < nb_settings; i++) {
+		ret = apply(ctx, lane, i);
+		if (ret)
+			return ret;
+
+		ret = xilinx_eyescan_run(es, lane);
+		if (ret)
+			return ret;
+
+		ret = xilinx_eyescan_margin(es, &h_mui, &v_codes);
+		if (ret)
+			return ret;
+
+		area = (uint64_t)h_mui * v_codes;
+		if (area > best_area) {
+			best_area = area;
+			*best = i;
+		}
+	}
+
+	if (*best == nb_settings - 1)
+		return 0;
+
+	return apply(ctx, lane, *best);
+}
+
+/**
+ * @brief Equalizer settings for xilinx_eyescan_tune(), 0 for DFE and 1 for
+ * LPM. The mode is set for all the lanes of the transceiver.
+ * @param ctx - The eye scan descriptor.
+ * @param lane - Lane of the transceiver, unused.
+ * @param idx - Setting.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int xilinx_eyescan_apply_lpm_dfe(void *ctx, uint32_t lane, uint32_t idx)
+{
+	struct xilinx_eyescan *es = ctx;
+
+	if (!es || idx > 1)
+		return -EINVAL;
+
+	return adxcvr_set_lpm_dfe_mode(es->xcvr, idx == 1);
+}
+
+/**
+ * @brief Free the resources allocated by xilinx_eyescan_init().
+ * @param es - The eye scan descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int xilinx_eyescan_remove(struct xilinx_eyescan *es)
+{
+	if (!es)
+		return -EINVAL;
+
+	no_os_free(es->map);
+	no_os_free(es);
+
+	return 0;
+}
@@ -0,0 +1,136 @@
+/***************************************************************************//**
+ *   @file   xilinx_eyescan.h
+ *   @brief  Statistical eye scan of the Xilinx transceiver lanes.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef XILINX_EYESCAN_H_
+#define XILINX_EYESCAN_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "axi_adxcvr.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+/* Map values under it are closed points, a BER over 10^-0.5 (about 0.3) */
+#define XILINX_EYESCAN_CLOSED		8
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+/**
+ * @struct xilinx_eyescan_init
+ * @brief Eye scan initialization structure.
+ */
+struct xilinx_eyescan_init {
+	/** Transceiver of the lanes */
+	struct adxcvr *xcvr;
+	/** Horizontal offset between two columns, in 1/64 UI, 0 for 4 */
+	uint32_t h_step;
+	/** Vertical offset between two rows, in codes, 0 for 8 */
+	uint32_t v_step;
+	/** Largest ES_PRESCALE a point is measured with, 0 for 8 */
+	uint32_t prescale_max;
+	/** Errors ending the measurement of a point, 0 for 4 */
+	uint32_t min_errors;
+	/** Width of the RX data path in bits, 0 to derive it from encoding */
+	uint32_t data_width;
+	/** -log10 of the BER the margins are measured at, 0 for 6 */
+	uint32_t target_ber;
+};
+
+/**
+ * @struct xilinx_eyescan
+ * @brief Eye scan descriptor, holding the map of the last scanned lane.
+ */
+struct xilinx_eyescan {
+	struct adxcvr *xcvr;
+	const struct xilinx_eyescan_regs *regs;
+	uint32_t h_step;
+	uint32_t v_step;
+	uint32_t prescale_max;
+	uint32_t min_errors;
+	uint32_t data_width;
+	uint32_t target_ber;
+	/** Lane of the map */
+	uint32_t lane;
+	/** Horizontal offsets of 1 UI, 64 times RXOUT_DIV */
+	uint32_t ui_codes;
+	/** Columns of the map, the middle one is the sampling point */
+	uint32_t nb_cols;
+	/** Rows of the map, from the highest vertical offset to the lowest */
+	uint32_t nb_rows;
+	/**
+	 * -log10(BER) of each point in 1/16 decades, row by row. Points
+	 * without errors hold the bound given by the number of bits checked.
+	 */
+	uint8_t *map;
+	/** Points measured and points set from a closed neighbour */
+	uint32_t measured;
+	uint32_t skipped;
+	/** Last values of the DRP registers written for each point */
+	uint32_t shadow_reg[4];
+	uint32_t shadow_val[4];
+	uint32_t nb_shadow;
+};
+
+/** Apply equalizer setting idx to lane, see xilinx_eyescan_tune(). */
+typedef int (*xilinx_eyescan_apply)(void *ctx, uint32_t lane, uint32_t idx);
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+/** Initialize the eye scan of a transceiver. */
+int xilinx_eyescan_init(struct xilinx_eyescan **es,
+			const struct xilinx_eyescan_init *init);
+/** Scan the eye of a lane into es->map. */
+int xilinx_eyescan_run(struct xilinx_eyescan *es, uint32_t lane);
+/** Get the eye opening of the last scan at the target BER. */
+int xilinx_eyescan_margin(struct xilinx_eyescan *es, uint32_t *h_mui,
+			  uint32_t *v_codes);
+/** Scan a lane for each equalizer setting and keep the widest eye. */
+int xilinx_eyescan_tune(struct xilinx_eyescan *es, uint32_t lane,
+			uint32_t nb_settings, xilinx_eyescan_apply apply,
+			void *ctx, uint32_t *best);
+/** Equalizer settings of xilinx_eyescan_tune(): 0 for DFE, 1 for LPM. */
+int xilinx_eyescan_apply_lpm_dfe(void *ctx, uint32_t lane, uint32_t idx);
+/** Free the resources allocated by xilinx_eyescan_init(). */
+int xilinx_eyescan_remove(struct xilinx_eyescan *es);
+
+#endif
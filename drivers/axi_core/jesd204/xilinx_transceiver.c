@@ -211,11 +211,63 @@ int xilinx_xcvr_drp_update(struct xilinx_xcvr *xcvr, uint32_t drp_port,
 	if (ret < 0)
 		return ret;
 
+	/* The field already holds val, skip the write and its read back */
+	if ((read_val & mask) == (val & mask))
+		return 0;
+
 	val |= read_val & ~mask;
 
 	return xilinx_xcvr_drp_write(xcvr, drp_port, reg, val);
 }
 
+/*******************************************************************************
+ * @brief Update a batch of DRP register fields.
+ *
+ * Consecutive fields of the same register are merged, so each register is
+ * read and written once. Registers already holding the values are not
+ * written and the writes are not read back, unlike xilinx_xcvr_drp_write().
+ *
+ * @param xcvr - The device structure.
+ * @param drp_port - DRP where data is updated.
+ * @param fields - The fields, sorted by register.
+ * @param nb - Number of fields.
+ *
+ * @return ret - Result of the writing operation (0 - success, negative
+ *               value for failure).
+ *******************************************************************************/
+int xilinx_xcvr_drp_update_fields(struct xilinx_xcvr *xcvr, uint32_t drp_port,
+				  const struct xilinx_xcvr_drp_field *fields,
+				  uint32_t nb)
+{
+	uint32_t read_val;
+	uint32_t val;
+	uint32_t i;
+	uint32_t j;
+	int ret;
+
+	for (i = 0; i < nb; i = j) {
+		ret = xilinx_xcvr_drp_read(xcvr, drp_port, fields[i].reg,
+					   &read_val);
+		if (ret < 0)
+			return ret;
+
+		val = read_val;
+		for (j = i; j < nb && fields[j].reg == fields[i].reg; j++)
+			val = (val & ~fields[j].mask) |
+			      (fields[j].val & fields[j].mask);
+
+		if (val == read_val)
+			continue;
+
+		ret = adxcvr_drp_write(xcvr->ad_xcvr, drp_port, fields[i].reg,
+				       val);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
 
 /*******************************************************************************
  * @brief Configure Clock Data Recovery for GTH3 transceiver type.
@@ -542,10 +594,10 @@ static int xilinx_xcvr_get_cpll_vco_ranges(struct xilinx_xcvr *xcvr,
  * @return ret - Result of the operation (0 - success, negative value
  *               for failure).
 *******************************************************************************/
-int xilinx_xcvr_calc_cpll_config(struct xilinx_xcvr *xcvr,
-				 uint32_t refclk_khz,
-				 uint32_t lane_rate_khz,
-				 struct xilinx_xcvr_cpll_config *conf, uint32_t *out_div)
+static int xilinx_xcvr_search_cpll_config(struct xilinx_xcvr *xcvr,
+		uint32_t refclk_khz,
+		uint32_t lane_rate_khz,
+		struct xilinx_xcvr_cpll_config *conf, uint32_t *out_div)
 {
 	uint32_t n1, n2, d, m;
 	uint32_t vco_freq;
@@ -671,9 +723,10 @@ static int xilinx_xcvr_get_qpll_vco_ranges(struct xilinx_xcvr *xcvr,
  * @return ret - Result of the operation (0 - success, negative value
  *               for failure).
 *******************************************************************************/
-int xilinx_xcvr_calc_qpll_config(struct xilinx_xcvr *xcvr, uint32_t sys_clk_sel,
-				 uint32_t refclk_khz, uint32_t lane_rate_khz,
-				 struct xilinx_xcvr_qpll_config *conf, uint32_t *out_div)
+static int xilinx_xcvr_search_qpll_config(struct xilinx_xcvr *xcvr,
+		uint32_t sys_clk_sel,
+		uint32_t refclk_khz, uint32_t lane_rate_khz,
+		struct xilinx_xcvr_qpll_config *conf, uint32_t *out_div)
 {
 	uint32_t n, d, m;
 	uint32_t vco_freq;
@@ -789,6 +842,151 @@ int xilinx_xcvr_calc_qpll_config(struct xilinx_xcvr *xcvr, uint32_t sys_clk_sel,
 	return -EINVAL;
 }
 
+/*******************************************************************************
+ * @brief Look for a PLL configuration in the cache.
+ *
+ * @param xcvr - The device structure.
+ * @param sys_clk_sel - ADXCVR_SYS_CLK_CPLL, or the QPLL selection.
+ * @param refclk_khz - Reference clock (kHz).
+ * @param lane_rate_khz - Lane rate (kHz).
+ *
+ * @return The cache entry, NULL if the configuration is not cached.
+*******************************************************************************/
+static struct xilinx_xcvr_pll_cache *xilinx_xcvr_pll_cache_find(
+	struct xilinx_xcvr *xcvr, uint32_t sys_clk_sel, uint32_t refclk_khz,
+	uint32_t lane_rate_khz)
+{
+	struct xilinx_xcvr_pll_cache *entry;
+	uint32_t i;
+
+	for (i = 0; i < XILINX_XCVR_PLL_CACHE_SIZE; i++) {
+		entry = &xcvr->pll_cache[i];
+		if (entry->lane_rate_khz == lane_rate_khz &&
+		    entry->refclk_khz == refclk_khz &&
+		    entry->sys_clk_sel == sys_clk_sel)
+			return entry;
+	}
+
+	return NULL;
+}
+
+/*******************************************************************************
+ * @brief Get the cache entry to store a new PLL configuration, replacing the
+ *        oldest one.
+ *
+ * @param xcvr - The device structure.
+ * @param sys_clk_sel - ADXCVR_SYS_CLK_CPLL, or the QPLL selection.
+ * @param refclk_khz - Reference clock (kHz).
+ * @param lane_rate_khz - Lane rate (kHz).
+ *
+ * @return The cache entry, with its key set.
+*******************************************************************************/
+static struct xilinx_xcvr_pll_cache *xilinx_xcvr_pll_cache_new(
+	struct xilinx_xcvr *xcvr, uint32_t sys_clk_sel, uint32_t refclk_khz,
+	uint32_t lane_rate_khz)
+{
+	struct xilinx_xcvr_pll_cache *entry;
+
+	entry = &xcvr->pll_cache[xcvr->pll_cache_next];
+	xcvr->pll_cache_next = (xcvr->pll_cache_next + 1) %
+			       XILINX_XCVR_PLL_CACHE_SIZE;
+
+	entry->refclk_khz = refclk_khz;
+	entry->lane_rate_khz = lane_rate_khz;
+	entry->sys_clk_sel = sys_clk_sel;
+
+	return entry;
+}
+
+/*******************************************************************************
+ * @brief Calculate CPLL configuration.
+ *
+ * @param xcvr - The device structure.
+ * @param refclk_khz - Reference clock (kHz).
+ * @param lane_rate_khz - Line rate (kHz).
+ * @param conf - CPLL configuration values.
+ * @param out_div - Output clock divider.
+ *
+ * @return ret - Result of the operation (0 - success, negative value
+ *               for failure).
+*******************************************************************************/
+int xilinx_xcvr_calc_cpll_config(struct xilinx_xcvr *xcvr,
+				 uint32_t refclk_khz,
+				 uint32_t lane_rate_khz,
+				 struct xilinx_xcvr_cpll_config *conf, uint32_t *out_div)
+{
+	struct xilinx_xcvr_pll_cache *entry;
+	struct xilinx_xcvr_cpll_config cpll;
+	uint32_t d;
+	int ret;
+
+	entry = xilinx_xcvr_pll_cache_find(xcvr, ADXCVR_SYS_CLK_CPLL,
+					   refclk_khz, lane_rate_khz);
+	if (!entry) {
+		ret = xilinx_xcvr_search_cpll_config(xcvr, refclk_khz,
+						     lane_rate_khz, &cpll, &d);
+		if (ret)
+			return ret;
+
+		entry = xilinx_xcvr_pll_cache_new(xcvr, ADXCVR_SYS_CLK_CPLL,
+						  refclk_khz, lane_rate_khz);
+		entry->cpll = cpll;
+		entry->out_div = d;
+	}
+
+	if (conf)
+		*conf = entry->cpll;
+	if (out_div)
+		*out_div = entry->out_div;
+
+	return 0;
+}
+
+/*******************************************************************************
+ * @brief Calculate QPLL configuration.
+ *
+ * @param xcvr - The device structure.
+ * @param sys_clk_sel - QPLL0 (3) / QPLL1 (2) selection.
+ * @param refclk_khz - Reference clock (kHz).
+ * @param lane_rate_khz - Line rate (kHz).
+ * @param conf - QPLL configuration values.
+ * @param out_div - Output clock divider.
+ *
+ * @return ret - Result of the operation (0 - success, negative value
+ *               for failure).
+*******************************************************************************/
+int xilinx_xcvr_calc_qpll_config(struct xilinx_xcvr *xcvr, uint32_t sys_clk_sel,
+				 uint32_t refclk_khz, uint32_t lane_rate_khz,
+				 struct xilinx_xcvr_qpll_config *conf, uint32_t *out_div)
+{
+	struct xilinx_xcvr_pll_cache *entry;
+	struct xilinx_xcvr_qpll_config qpll;
+	uint32_t d;
+	int ret;
+
+	entry = xilinx_xcvr_pll_cache_find(xcvr, sys_clk_sel, refclk_khz,
+					   lane_rate_khz);
+	if (!entry) {
+		ret = xilinx_xcvr_search_qpll_config(xcvr, sys_clk_sel,
+						     refclk_khz, lane_rate_khz,
+						     &qpll, &d);
+		if (ret)
+			return ret;
+
+		entry = xilinx_xcvr_pll_cache_new(xcvr, sys_clk_sel, refclk_khz,
+						  lane_rate_khz);
+		entry->qpll = qpll;
+		entry->out_div = d;
+	}
+
+	if (conf)
+		*conf = entry->qpll;
+	if (out_div)
+		*out_div = entry->out_div;
+
+	return 0;
+}
+
 /*******************************************************************************
  * @brief Read CPLL configuration for GTH transceiver.
  *
@@ -1536,9 +1734,9 @@ static int xilinx_xcvr_gtx2_read_out_div(struct xilinx_xcvr *xcvr,
 		return ret;
 
 	if (rx_out_div)
-		*rx_out_div = 1 << ((ret >> OUT_DIV_RX_OFFSET) & 7);
+		*rx_out_div = 1 << ((val >> OUT_DIV_RX_OFFSET) & 7);
 	if (tx_out_div)
-		*tx_out_div = 1 << ((ret >> OUT_DIV_TX_OFFSET) & 7);
+		*tx_out_div = 1 << ((val >> OUT_DIV_TX_OFFSET) & 7);
 
 	return 0;
 }
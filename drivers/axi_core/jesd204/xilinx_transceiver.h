@@ -165,6 +165,44 @@ enum axi_fpga_dev_pack {
 	AXI_FPGA_DEV_FA,
 };
 
+/**
+ * @struct xilinx_xcvr_cpll_config
+ * @brief Structure holding CPLL configuration.
+ */
+struct xilinx_xcvr_cpll_config {
+	uint32_t refclk_div;
+	uint32_t fb_div_N1;
+	uint32_t fb_div_N2;
+};
+
+/**
+ * @struct xilinx_xcvr_qpll_config
+ * @brief Structure holding QPLL configuration.
+ */
+struct xilinx_xcvr_qpll_config {
+	uint32_t refclk_div;
+	uint32_t fb_div;
+	uint32_t band;
+	uint32_t qty4_full_rate;
+};
+
+#define XILINX_XCVR_PLL_CACHE_SIZE	4
+
+/**
+ * @struct xilinx_xcvr_pll_cache
+ * @brief PLL configuration found for a lane rate.
+ */
+struct xilinx_xcvr_pll_cache {
+	uint32_t refclk_khz;
+	/* 0 if the entry is unused */
+	uint32_t lane_rate_khz;
+	/* ADXCVR_SYS_CLK_CPLL (0) for the CPLL */
+	uint32_t sys_clk_sel;
+	struct xilinx_xcvr_cpll_config cpll;
+	struct xilinx_xcvr_qpll_config qpll;
+	uint32_t out_div;
+};
+
 /**
  * @struct xilinx_xcvr
  * @brief xilinx_xcvr parameters structure.
@@ -186,6 +224,20 @@ struct xilinx_xcvr {
 	uint32_t vco0_max; // kHz
 	uint32_t vco1_min; // kHz
 	uint32_t vco1_max; // kHz
+
+	// Last PLL configurations found, round_rate and set_rate repeat them
+	struct xilinx_xcvr_pll_cache pll_cache[XILINX_XCVR_PLL_CACHE_SIZE];
+	uint32_t pll_cache_next;
+};
+
+/**
+ * @struct xilinx_xcvr_drp_field
+ * @brief Field of a DRP register, updated by xilinx_xcvr_drp_update_fields().
+ */
+struct xilinx_xcvr_drp_field {
+	uint32_t reg;
+	uint32_t mask;
+	uint32_t val;
 };
 
 struct xilinx_xcvr_drp_ops {
@@ -248,27 +300,6 @@ struct clk_ops {
 			unsigned long parent_rate);
 };
 
-/**
- * @struct xilinx_xcvr_cpll_config
- * @brief Structure holding CPLL configuration.
- */
-struct xilinx_xcvr_cpll_config {
-	uint32_t refclk_div;
-	uint32_t fb_div_N1;
-	uint32_t fb_div_N2;
-};
-
-/**
- * @struct xilinx_xcvr_qpll_config
- * @brief Structure holding QPLL configuration.
- */
-struct xilinx_xcvr_qpll_config {
-	uint32_t refclk_div;
-	uint32_t fb_div;
-	uint32_t band;
-	uint32_t qty4_full_rate;
-};
-
 /* Encoding */
 #define ENC_8B10B		810
 #define ENC_66B64B		6664
@@ -277,6 +308,10 @@ struct xilinx_xcvr_qpll_config {
 /************************ Functions Declarations ******************************/
 /******************************************************************************/
 
+/** Update a batch of DRP register fields, one access per register. */
+int xilinx_xcvr_drp_update_fields(struct xilinx_xcvr *xcvr, uint32_t drp_port,
+				  const struct xilinx_xcvr_drp_field *fields,
+				  uint32_t nb);
 /** Configure the Clock Data Recovery circuit. */
 int xilinx_xcvr_configure_cdr(struct xilinx_xcvr *xcvr,
 			      uint32_t drp_port, uint32_t lane_rate, uint32_t out_div,
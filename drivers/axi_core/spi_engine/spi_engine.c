@@ -55,6 +55,7 @@ significant delays */
 #include "axi_dmac.h"
 #include "no_os_axi_io.h"
 #include "no_os_error.h"
+#include "no_os_alloc.h"
 #include "spi_engine.h"
 
 /**
@@ -747,6 +748,298 @@ int32_t spi_engine_write_and_read(struct no_os_spi_desc *desc,
 	return ret;
 }
 
+/**
+ * @brief Get the engine SLEEP command matching a delay
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @param delay_us The delay in microseconds
+ * @return uint32_t The SLEEP command, with the prescaler limited to 0xFF
+ */
+static uint32_t spi_engine_program_sleep(struct no_os_spi_desc *desc,
+		uint32_t delay_us)
+{
+	struct spi_engine_desc	*eng_desc;
+	uint32_t		sleep_div;
+
+	eng_desc = desc->extra;
+
+	/* Same computation as spi_get_sleep_div(), without the underflow */
+	sleep_div = (desc->max_speed_hz / 1000000 * delay_us) /
+		    ((eng_desc->clk_div + 1) * 2);
+	if (sleep_div)
+		sleep_div--;
+
+	return SPI_ENGINE_CMD_SLEEP(no_os_min(sleep_div, 0xFFu));
+}
+
+/**
+ * @brief Get the transfer direction of a message
+ *
+ * @param msg The message
+ * @return uint8_t SPI_ENGINE_INSTRUCTION_TRANSFER_W, _R or _RW. Messages
+ * 	without any buffer are written with 0x00
+ */
+static uint8_t spi_engine_program_dir(struct no_os_spi_msg *msg)
+{
+	uint8_t dir = 0;
+
+	if (msg->tx_buff)
+		dir |= SPI_ENGINE_INSTRUCTION_TRANSFER_W;
+	if (msg->rx_buff)
+		dir |= SPI_ENGINE_INSTRUCTION_TRANSFER_R;
+
+	return dir ? dir : SPI_ENGINE_INSTRUCTION_TRANSFER_W;
+}
+
+/**
+ * @brief Add a command to a program being built
+ *
+ * @param cmds Program commands. If NULL, the command is only counted
+ * @param n Number of commands in the program, incremented
+ * @param cmd Command to be added
+ */
+static void spi_engine_program_add(uint32_t *cmds, uint32_t *n, uint32_t cmd)
+{
+	if (cmds)
+		cmds[*n] = cmd;
+	(*n)++;
+}
+
+/**
+ * @brief Build the engine commands of a sequence of messages
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @param msgs Array of messages
+ * @param no_msgs Number of messages
+ * @param cmds Where to write the commands. If NULL, they are only counted
+ * @return uint32_t Number of commands
+ */
+static uint32_t spi_engine_program_build(struct no_os_spi_desc *desc,
+		struct no_os_spi_msg *msgs,
+		uint32_t no_msgs,
+		uint32_t *cmds)
+{
+	struct spi_engine_desc	*eng_desc;
+	struct no_os_spi_msg	*msg;
+	uint32_t		word_len;
+	uint32_t		words;
+	uint32_t		chunk;
+	uint32_t		delay;
+	uint32_t		cmd;
+	uint32_t		n = 0;
+	uint32_t		i;
+	uint8_t			cs_mask;
+	uint8_t			dir;
+	bool			cs_low = false;
+	bool			last;
+
+	eng_desc = desc->extra;
+	cs_mask = 0xFF ^ NO_OS_BIT(desc->chip_select);
+	word_len = spi_get_word_lenght(eng_desc);
+
+	cmd = SPI_ENGINE_CMD_CONFIG(SPI_ENGINE_CMD_REG_CLK_DIV,
+				    eng_desc->clk_div);
+	spi_engine_program_add(cmds, &n, cmd);
+	cmd = SPI_ENGINE_CMD_CONFIG(SPI_ENGINE_CMD_DATA_TRANSFER_LEN,
+				    eng_desc->data_width);
+	spi_engine_program_add(cmds, &n, cmd);
+	cmd = SPI_ENGINE_CMD_CONFIG(SPI_ENGINE_CMD_REG_CONFIG, desc->mode);
+	spi_engine_program_add(cmds, &n, cmd);
+
+	for (i = 0; i < no_msgs; i++) {
+		msg = &msgs[i];
+		last = (i == no_msgs - 1);
+
+		if (!cs_low) {
+			cmd = SPI_ENGINE_CMD_ASSERT(eng_desc->cs_delay,
+						    cs_mask);
+			spi_engine_program_add(cmds, &n, cmd);
+			if (msg->cs_delay_first) {
+				delay = msg->cs_delay_first;
+				cmd = spi_engine_program_sleep(desc, delay);
+				spi_engine_program_add(cmds, &n, cmd);
+			}
+			cs_low = true;
+		}
+
+		/* Transfer commands hold at most 256 words, zero based */
+		words = NO_OS_DIV_ROUND_UP(msg->bytes_number, word_len);
+		dir = spi_engine_program_dir(msg);
+		while (words) {
+			chunk = no_os_min(words, 256u);
+			cmd = SPI_ENGINE_CMD_TRANSFER(dir, chunk - 1);
+			spi_engine_program_add(cmds, &n, cmd);
+			words -= chunk;
+		}
+
+		if (!msg->cs_change && !last)
+			continue;
+
+		if (msg->cs_delay_last) {
+			delay = msg->cs_delay_last;
+			cmd = spi_engine_program_sleep(desc, delay);
+			spi_engine_program_add(cmds, &n, cmd);
+		}
+		cmd = SPI_ENGINE_CMD_ASSERT(eng_desc->cs_delay, 0xFF);
+		spi_engine_program_add(cmds, &n, cmd);
+		if (msg->cs_change_delay && !last) {
+			delay = msg->cs_change_delay;
+			cmd = spi_engine_program_sleep(desc, delay);
+			spi_engine_program_add(cmds, &n, cmd);
+		}
+		cs_low = false;
+	}
+
+	/* The id is set when the program is run */
+	spi_engine_program_add(cmds, &n, SPI_ENGINE_CMD_SYNC(0));
+
+	return n;
+}
+
+/**
+ * @brief Compile a sequence of SPI messages into an engine command program
+ *
+ * The commands are built once, in a single allocation, and reused by each
+ * spi_engine_program_run() call. The messages array and its buffers must be
+ * valid until the program is removed. The content of the buffers can change
+ * between runs, but not the messages themselves. The clock divider, data width
+ * and SPI mode are the ones set when compiling.
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @param msgs Array of messages
+ * @param no_msgs Number of messages
+ * @param prog The compiled program
+ * @return int32_t - 0 if the program was compiled
+ *		   - negative error code otherwise
+ */
+int32_t spi_engine_program_compile(struct no_os_spi_desc *desc,
+				   struct no_os_spi_msg *msgs,
+				   uint32_t no_msgs,
+				   struct spi_engine_program **prog)
+{
+	struct spi_engine_program	*p;
+	struct spi_engine_desc		*eng_desc;
+	uint32_t			no_cmds;
+
+	if (!desc || !msgs || !no_msgs || !prog)
+		return -EINVAL;
+
+	eng_desc = desc->extra;
+
+	no_cmds = spi_engine_program_build(desc, msgs, no_msgs, NULL);
+
+	p = calloc(1, sizeof(*p) + no_cmds * sizeof(*p->cmds));
+	if (!p)
+		return -ENOMEM;
+
+	p->cmds = (uint32_t *)(p + 1);
+	p->no_cmds = spi_engine_program_build(desc, msgs, no_msgs, p->cmds);
+	p->msgs = msgs;
+	p->no_msgs = no_msgs;
+	p->data_width = eng_desc->data_width;
+	*prog = p;
+
+	return 0;
+}
+
+/**
+ * @brief Run a program compiled by spi_engine_program_compile()
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @param prog The program
+ * @return int32_t - 0 if the transfer finished
+ *		   - negative error code otherwise
+ */
+int32_t spi_engine_program_run(struct no_os_spi_desc *desc,
+			       struct spi_engine_program *prog)
+{
+	struct spi_engine_desc	*eng_desc;
+	struct no_os_spi_msg	*msg;
+	uint32_t		word_len;
+	uint32_t		sync_id;
+	uint32_t		data;
+	uint32_t		shift;
+	uint32_t		i;
+	uint32_t		j;
+	uint8_t			dir;
+
+	if (!desc || !prog)
+		return -EINVAL;
+
+	eng_desc = desc->extra;
+	word_len = prog->data_width / 8;
+
+	/* Same as spi_engine_write_and_read(), the FIFO mode is used */
+	eng_desc->offload_config = OFFLOAD_DISABLED;
+	spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_CTRL(0), 0);
+
+	for (i = 0; i < prog->no_cmds - 1; i++)
+		spi_engine_write(eng_desc, SPI_ENGINE_REG_CMD_FIFO,
+				 prog->cmds[i]);
+	spi_engine_write(eng_desc, SPI_ENGINE_REG_CMD_FIFO,
+			 SPI_ENGINE_CMD_SYNC(_sync_id));
+
+	/* Pack the bytes of each message into engine WORDS */
+	for (i = 0; i < prog->no_msgs; i++) {
+		msg = &prog->msgs[i];
+		dir = spi_engine_program_dir(msg);
+		if (!(dir & SPI_ENGINE_INSTRUCTION_TRANSFER_W))
+			continue;
+
+		data = 0;
+		for (j = 0; j < msg->bytes_number; j++) {
+			shift = prog->data_width - (j % word_len + 1) * 8;
+			if (msg->tx_buff)
+				data |= (uint32_t)msg->tx_buff[j] << shift;
+			if (j % word_len == word_len - 1 ||
+			    j == msg->bytes_number - 1) {
+				spi_engine_write(eng_desc,
+						 SPI_ENGINE_REG_SDO_DATA_FIFO,
+						 data);
+				data = 0;
+			}
+		}
+	}
+
+	/* Wait for the end sync signal */
+	do {
+		spi_engine_read(eng_desc, SPI_ENGINE_REG_SYNC_ID, &sync_id);
+	} while (sync_id != _sync_id);
+	_sync_id++;
+
+	/* Unpack the received WORDS */
+	for (i = 0; i < prog->no_msgs; i++) {
+		msg = &prog->msgs[i];
+		dir = spi_engine_program_dir(msg);
+		if (!(dir & SPI_ENGINE_INSTRUCTION_TRANSFER_R))
+			continue;
+
+		for (j = 0; j < msg->bytes_number; j++) {
+			if (j % word_len == 0)
+				spi_engine_read(eng_desc,
+						SPI_ENGINE_REG_SDI_DATA_FIFO,
+						&data);
+			shift = prog->data_width - (j % word_len + 1) * 8;
+			msg->rx_buff[j] = data >> shift;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Free the resources allocated by spi_engine_program_compile()
+ *
+ * @param prog The program
+ * @return int32_t This function allways returns 0
+ */
+int32_t spi_engine_program_remove(struct spi_engine_program *prog)
+{
+	free(prog);
+
+	return 0;
+}
+
 /**
  * @brief Initialize the SPI engine's offload module
  *
@@ -758,11 +1051,12 @@ int32_t spi_engine_offload_init(struct no_os_spi_desc *desc,
 				const struct spi_engine_offload_init_param *param)
 {
 	struct spi_engine_desc	*eng_desc;
-	struct axi_dmac_init	dmac_init;
+	struct axi_dmac_init	dmac_init = { 0 };
 
 	eng_desc = desc->extra;
 
 	eng_desc->offload_config = param->offload_config;
+	dmac_init.irq_option = param->irq_option;
 
 	if(!(param->dma_flags)) {
 		eng_desc->cyclic = CYCLIC;
@@ -793,21 +1087,19 @@ int32_t spi_engine_offload_init(struct no_os_spi_desc *desc,
 }
 
 /**
- * @brief Initiate a SPI transfer in offload mode
+ * @brief Load the commands of an offload message in the offload module
  *
  * @param desc Decriptor containing SPI interface parameters
  * @param msg Offload message that get's to be transferred
- * @param no_samples Number of time the messages will be transferred
- * @return int32_t This function allways returns 0
+ * @return int32_t - 0 if the commands were loaded
+ *		   - -1 if offload is disabled or the memory allocation failed
  */
-int32_t spi_engine_offload_transfer(struct no_os_spi_desc *desc,
-				    struct spi_engine_offload_message msg,
-				    uint32_t no_samples)
+static int32_t spi_engine_offload_load(struct no_os_spi_desc *desc,
+				       struct spi_engine_offload_message *msg)
 {
 	struct spi_engine_msg	transfer;
 	struct spi_engine_desc	*eng_desc;
 	uint32_t 		i;
-	uint8_t 		word_length;
 
 	eng_desc = desc->extra;
 
@@ -827,18 +1119,49 @@ int32_t spi_engine_offload_transfer(struct no_os_spi_desc *desc,
 	if (!transfer.cmds)
 		return -1;
 
-	transfer.tx_buf = msg.commands_data;
+	transfer.tx_buf = msg->commands_data;
 
 	/* Load the commands into the message */
 	transfer.cmds->next = NULL;
-	transfer.cmds->cmd = msg.commands[0];
+	transfer.cmds->cmd = msg->commands[0];
 	i = 1;
-	while(i < msg.no_commands) {
-		spi_engine_queue_add_cmd(&transfer.cmds, msg.commands[i++]);
+	while(i < msg->no_commands) {
+		spi_engine_queue_add_cmd(&transfer.cmds, msg->commands[i++]);
 
 	}
 
 	spi_engine_transfer_message(desc, &transfer);
+	spi_engine_queue_free(&transfer.cmds);
+
+	return 0;
+}
+
+/**
+ * @brief Start a SPI transfer in offload mode, without waiting for it
+ *
+ * The message is run on each offload trigger. The trigger source, e.g. a
+ * PWM, may be started once this returns so that the first transfer happens on
+ * a known edge. spi_engine_offload_transfer_wait() waits for the end.
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @param msg Offload message that get's to be transferred
+ * @param no_samples Number of time the messages will be transferred
+ * @return int32_t - 0 if the transfer was started
+ *		   - negative error code otherwise
+ */
+int32_t spi_engine_offload_transfer_start(struct no_os_spi_desc *desc,
+		struct spi_engine_offload_message msg,
+		uint32_t no_samples)
+{
+	struct spi_engine_desc	*eng_desc;
+	uint8_t 		word_length;
+	int32_t			ret;
+
+	eng_desc = desc->extra;
+
+	ret = spi_engine_offload_load(desc, &msg);
+	if (ret)
+		return ret;
 
 	/* Start transfer */
 	spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_CTRL(0), 0x0001);
@@ -857,6 +1180,9 @@ int32_t spi_engine_offload_transfer(struct no_os_spi_desc *desc,
 			// Address of data destination
 			.dest_addr = 0
 		};
+		no_os_dma_sync_for_device((void *)(uintptr_t)msg.tx_addr,
+					  tx_transfer.size,
+					  NO_OS_DMA_TO_DEVICE);
 		axi_dmac_transfer_start(eng_desc->offload_tx_dma, &tx_transfer);
 	}
 
@@ -873,13 +1199,146 @@ int32_t spi_engine_offload_transfer(struct no_os_spi_desc *desc,
 			// Address of data destination
 			.dest_addr = (uintptr_t)msg.rx_addr
 		};
+		eng_desc->offload_rx_addr = msg.rx_addr;
+		eng_desc->offload_rx_size = rx_transfer.size;
+		no_os_dma_sync_for_device((void *)(uintptr_t)msg.rx_addr,
+					  rx_transfer.size,
+					  NO_OS_DMA_FROM_DEVICE);
 		axi_dmac_transfer_start(eng_desc->offload_rx_dma, &rx_transfer);
-		axi_dmac_transfer_wait_completion(eng_desc->offload_rx_dma, 500);
 	}
 
+	return 0;
+}
+
+/**
+ * @brief Wait for the transfer started by spi_engine_offload_transfer_start()
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @return int32_t - 0 if the received data is available
+ *		   - negative error code otherwise
+ */
+int32_t spi_engine_offload_transfer_wait(struct no_os_spi_desc *desc)
+{
+	struct spi_engine_desc	*eng_desc;
+	int32_t			ret;
+
+	eng_desc = desc->extra;
+
+	if(!(eng_desc->offload_config & OFFLOAD_RX_EN))
+		return 0;
+
+	ret = axi_dmac_transfer_wait_completion(eng_desc->offload_rx_dma, 500);
+	if (ret)
+		return ret;
+
+	no_os_dma_sync_for_cpu((void *)(uintptr_t)eng_desc->offload_rx_addr,
+			       eng_desc->offload_rx_size,
+			       NO_OS_DMA_FROM_DEVICE);
+
+	return 0;
+}
+
+/**
+ * @brief Initiate a SPI transfer in offload mode
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @param msg Offload message that get's to be transferred
+ * @param no_samples Number of time the messages will be transferred
+ * @return int32_t This function allways returns 0
+ */
+int32_t spi_engine_offload_transfer(struct no_os_spi_desc *desc,
+				    struct spi_engine_offload_message msg,
+				    uint32_t no_samples)
+{
+	int32_t			ret;
+
+	ret = spi_engine_offload_transfer_start(desc, msg, no_samples);
+	if (ret)
+		return ret;
+
+	spi_engine_offload_transfer_wait(desc);
+
 	usleep(1000);
 
-	spi_engine_queue_free(&transfer.cmds);
+	return 0;
+}
+
+/**
+ * @brief Start continuous transfers in offload mode
+ *
+ * The offload module runs the message on each trigger, without stopping, and
+ * the RX DMAC streams the received data into a ring of nb_segments segments
+ * starting at msg.rx_addr, each one holding segment_samples runs of the
+ * message. segment_done is called from the DMAC interrupt for each filled
+ * segment, which must be consumed (after invalidating its data cache, if any)
+ * before the DMAC wraps around to it. The RX DMAC must be initialized with
+ * IRQ_ENABLED and its interrupt handler registered.
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @param msg Offload message that get's to be transferred
+ * @param segment_samples Number of times the message is transferred to fill a
+ * 	segment
+ * @param nb_segments Number of segments in the ring. At least 2.
+ * @param segment_done Callback called with the address and size of each
+ * 	filled segment
+ * @param ctx Parameter passed to segment_done
+ * @return int32_t - 0 if the stream was started
+ *		   - negative error code otherwise
+ */
+int32_t spi_engine_offload_stream_start(struct no_os_spi_desc *desc,
+					struct spi_engine_offload_message msg,
+					uint32_t segment_samples,
+					uint32_t nb_segments,
+					void (*segment_done)(void *ctx,
+							uint32_t addr,
+							uint32_t size),
+					void *ctx)
+{
+	struct spi_engine_desc	*eng_desc;
+	uint32_t		segment_size;
+	int32_t			ret;
+
+	eng_desc = desc->extra;
+
+	if (!(eng_desc->offload_config & OFFLOAD_RX_EN))
+		return -EINVAL;
+
+	ret = spi_engine_offload_load(desc, &msg);
+	if (ret)
+		return ret;
+
+	segment_size = spi_get_word_lenght(eng_desc) *
+		       eng_desc->offload_tx_len * segment_samples;
+	no_os_dma_sync_for_device((void *)(uintptr_t)msg.rx_addr,
+				  segment_size * nb_segments,
+				  NO_OS_DMA_FROM_DEVICE);
+	ret = axi_dmac_stream_start(eng_desc->offload_rx_dma, msg.rx_addr,
+				    segment_size, nb_segments, segment_done,
+				    ctx);
+	if (ret)
+		return ret;
+
+	/* Start transfers after the DMAC is ready to receive the data */
+	spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_CTRL(0), 0x0001);
+
+	return 0;
+}
+
+/**
+ * @brief Stop the transfers started by spi_engine_offload_stream_start()
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @return int32_t This function allways returns 0
+ */
+int32_t spi_engine_offload_stream_stop(struct no_os_spi_desc *desc)
+{
+	struct spi_engine_desc	*eng_desc;
+
+	eng_desc = desc->extra;
+
+	spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_CTRL(0), 0);
+	if (eng_desc->offload_config & OFFLOAD_RX_EN)
+		axi_dmac_stream_stop(eng_desc->offload_rx_dma);
 
 	return 0;
 }
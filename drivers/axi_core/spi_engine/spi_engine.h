@@ -121,6 +121,9 @@ struct spi_engine_desc {
 	uint8_t			offload_tx_len;
 	/** Number of words that the module has to receive */
 	uint8_t			offload_rx_len;
+	/** Buffer of the RX DMA transfer, synced for the CPU once done */
+	uint32_t		offload_rx_addr;
+	uint32_t		offload_rx_size;
 	/** Base address where the HDL core is situated */
 	uint32_t		spi_engine_baseaddr;
 	/** Base address where the RX DMAC core is situated */
@@ -151,6 +154,8 @@ struct spi_engine_offload_init_param {
 	uint32_t	*dma_flags;
 	/** Offload's module transfer direction : TX, RX or both */
 	uint8_t		offload_config;
+	/** DMAC interrupt usage. Must be IRQ_ENABLED for streaming */
+	enum use_irq	irq_option;
 };
 
 /**
@@ -173,6 +178,24 @@ struct spi_engine_offload_message {
 	uint32_t rx_addr;
 };
 
+/**
+ * @struct spi_engine_program
+ * @brief  Engine commands compiled from a sequence of SPI messages, that can be
+ * run any number of times without being rebuilt
+ */
+struct spi_engine_program {
+	/** Engine commands. The last one is the end of transfer SYNC */
+	uint32_t		*cmds;
+	/** Number of engine commands */
+	uint32_t		no_cmds;
+	/** Messages the program was compiled from */
+	struct no_os_spi_msg	*msgs;
+	/** Number of messages */
+	uint32_t		no_msgs;
+	/** Data width ( in bits ) the program was compiled for */
+	uint8_t			data_width;
+};
+
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
 /******************************************************************************/
@@ -212,6 +235,40 @@ int32_t spi_engine_offload_transfer(struct no_os_spi_desc *desc,
 				    struct spi_engine_offload_message msg,
 				    uint32_t no_samples);
 
+/* Start a transfer using the offload module, without waiting for it */
+int32_t spi_engine_offload_transfer_start(struct no_os_spi_desc *desc,
+		struct spi_engine_offload_message msg,
+		uint32_t no_samples);
+
+/* Wait for the transfer started by spi_engine_offload_transfer_start() */
+int32_t spi_engine_offload_transfer_wait(struct no_os_spi_desc *desc);
+
+/* Start continuous offload transfers, streamed by the RX DMAC into a ring */
+int32_t spi_engine_offload_stream_start(struct no_os_spi_desc *desc,
+					struct spi_engine_offload_message msg,
+					uint32_t segment_samples,
+					uint32_t nb_segments,
+					void (*segment_done)(void *ctx,
+							uint32_t addr,
+							uint32_t size),
+					void *ctx);
+
+/* Stop the transfers started by spi_engine_offload_stream_start() */
+int32_t spi_engine_offload_stream_stop(struct no_os_spi_desc *desc);
+
+/* Compile a sequence of SPI messages into an engine command program */
+int32_t spi_engine_program_compile(struct no_os_spi_desc *desc,
+				   struct no_os_spi_msg *msgs,
+				   uint32_t no_msgs,
+				   struct spi_engine_program **prog);
+
+/* Run a program compiled by spi_engine_program_compile() */
+int32_t spi_engine_program_run(struct no_os_spi_desc *desc,
+			       struct spi_engine_program *prog);
+
+/* Free the resources allocated by spi_engine_program_compile() */
+int32_t spi_engine_program_remove(struct spi_engine_program *prog);
+
 /* Set SPI transfer width */
 int32_t spi_engine_set_transfer_width(struct no_os_spi_desc *desc,
 				      uint8_t data_wdith);
@@ -81,7 +81,6 @@ enum ad3552r_spi_attributes {
 #define AD3552R_CRC_ENABLE_VALUE			(NO_OS_BIT(6) | NO_OS_BIT(1))
 #define AD3552R_CRC_DISABLE_VALUE			(NO_OS_BIT(1) | NO_OS_BIT(0))
 #define AD3552R_EXTERNAL_VREF_MASK			NO_OS_BIT(1)
-#define AD3552R_CRC_POLY				0x07
 #define AD3552R_CRC_SEED				0xA5
 #define AD3552R_SECONDARY_REGION_ADDR			0x28
 #define AD3552R_DEFAULT_CONFIG_B_VALUE			0x8
@@ -99,6 +98,15 @@ enum ad3552r_spi_attributes {
 
 #define AD3552R_GAIN_SCALE				1000
 
+/* Number of scans sent in a single SPI transfer by the streaming functions */
+#ifndef AD3552R_STREAM_CHUNK_SCANS
+#define AD3552R_STREAM_CHUNK_SCANS			64
+#endif
+/* Codes of all the channels and the software LDAC register, for each scan */
+#define AD3552R_STREAM_SCAN_MAX_LEN (AD3552R_NUM_CH * AD3552R_MAX_REG_SIZE + 1)
+#define AD3552R_STREAM_BUFF_SIZE	\
+	(AD3552R_STREAM_CHUNK_SCANS * AD3552R_STREAM_SCAN_MAX_LEN)
+
 #ifdef AD3552R_DEBUG
 #define _CHECK_STATUS(_status, reg, new_reg, bit_name, clr_err)  do {\
 	if (reg & AD3552R_MASK_ ## bit_name) {\
@@ -362,8 +370,8 @@ static int32_t _ad3552r_transfer_with_crc(struct ad3552r_desc *desc,
 		if (i > 0)
 			crc_init = addr;
 		else
-			crc_init = no_os_crc8(desc->crc_table, &instr, 1,
-					      AD3552R_CRC_SEED);
+			crc_init = no_os_crc8(no_os_crc8_table_07, &instr,
+					      1, AD3552R_CRC_SEED);
 
 		if (data->is_read && i > 0) {
 			/* CRC is not needed for continuous read transaction */
@@ -377,8 +385,8 @@ static int32_t _ad3552r_transfer_with_crc(struct ad3552r_desc *desc,
 				++msg.bytes_number;
 			}
 			memcpy(pbuf, data->data + i, reg_len);
-			pbuf[reg_len] = no_os_crc8(desc->crc_table, pbuf, reg_len,
-						   crc_init);
+			pbuf[reg_len] = no_os_crc8(no_os_crc8_table_07, pbuf,
+						   reg_len, crc_init);
 		}
 
 		/* Send message */
@@ -395,7 +403,8 @@ static int32_t _ad3552r_transfer_with_crc(struct ad3552r_desc *desc,
 			/* Save received data */
 			memcpy(data->data + i, pbuf, reg_len);
 			if (pbuf[reg_len] !=
-			    no_os_crc8(desc->crc_table, pbuf, reg_len, crc_init))
+			    no_os_crc8(no_os_crc8_table_07, pbuf, reg_len,
+				       crc_init))
 				return -EBADMSG;
 		} else {
 			if (in[reg_len + (i == 0)] != out[reg_len + (i == 0)])
@@ -1081,8 +1090,6 @@ int32_t ad3552r_init(struct ad3552r_desc **desc,
 	if (NO_OS_IS_ERR_VALUE(err))
 		goto err;
 
-	no_os_crc8_populate_msb(ldesc->crc_table, AD3552R_CRC_POLY);
-
 	err = no_os_gpio_get_optional(&ldesc->reset,
 				      param->reset_gpio_param_optional);
 	if (NO_OS_IS_ERR_VALUE(err))
@@ -1310,6 +1317,100 @@ int32_t ad3552r_write_samples(struct ad3552r_desc *desc, uint16_t *data,
 	return 0;
 }
 
+/* Store a code as expected by a code register. Return the register length */
+static uint8_t _ad3552r_pack_code(uint8_t *buf, uint16_t code, uint8_t is_fast)
+{
+	no_os_put_unaligned_be16(code, buf);
+	if (is_fast) {
+		buf[1] &= 0xF0;
+		return AD3552R_STORAGE_BITS_FAST_MODE / 8;
+	}
+	buf[2] = 0;
+
+	return AD3552R_STORAGE_BITS_PREC_MODE / 8;
+}
+
+/*
+ * Use the stream mode of the device with the address looping on the code
+ * registers of a scan, so many scans are sent in a single SPI transfer.
+ * With AD3552R_WRITE_INPUT_REGS_AND_TRIGGER_LDAC the software LDAC register,
+ * which follows the input register of channel 0, is part of the loop.
+ *
+ * samples: nb of samples per channel
+ * ch_mask: mask of channels to enable. Data of channel 0 comes first
+ */
+int32_t ad3552r_write_samples_stream(struct ad3552r_desc *desc, uint16_t *data,
+				     uint32_t samples, uint32_t ch_mask,
+				     enum ad3552r_write_mode mode)
+{
+	struct ad3552_transfer_config cfg;
+	struct ad3552_transfer_data msg = {0};
+	uint8_t buff[AD3552R_STREAM_BUFF_SIZE];
+	uint32_t i, j, n, len;
+	uint8_t ch, is_fast, ldac;
+	int32_t err, ret;
+
+	if (!desc || !data || !ch_mask || ch_mask > AD3552R_MASK_ALL_CH)
+		return -EINVAL;
+
+	if (ch_mask == AD3552R_MASK_ALL_CH &&
+	    desc->ch_data[0].fast_en != desc->ch_data[1].fast_en)
+		/* Unhandled case */
+		return -EINVAL;
+
+	ldac = (mode == AD3552R_WRITE_INPUT_REGS_AND_TRIGGER_LDAC);
+	if (ldac && ch_mask == NO_OS_BIT(1))
+		/* LDAC register can't be reached from channel 1 alone */
+		return ad3552r_write_samples(desc, data, samples, ch_mask,
+					     mode);
+
+	/* Descending addresses, the loop begins with the highest channel */
+	ch = (ch_mask & NO_OS_BIT(1)) ? 1 : 0;
+	is_fast = desc->ch_data[ch].fast_en;
+
+	cfg = desc->spi_cfg;
+	cfg.addr_asc = 0;
+	cfg.single_instr = 0;
+	cfg.stream_length_keep_value = 1;
+	cfg.stream_mode_length = no_os_hweight8(ch_mask) *
+				 REG_DATA_LEN(is_fast) + ldac;
+
+	msg.addr = _get_code_reg_addr(ch, mode == AD3552R_WRITE_DAC_REGS,
+				      is_fast);
+	msg.data = buff;
+	msg.spi_cfg = &cfg;
+
+	err = 0;
+	for (i = 0; i < samples && !err; i += n) {
+		n = no_os_min(samples - i, AD3552R_STREAM_CHUNK_SCANS);
+		len = 0;
+		for (j = i; j < i + n; j++) {
+			if (ch_mask == AD3552R_MASK_ALL_CH) {
+				len += _ad3552r_pack_code(buff + len,
+							  data[2 * j + 1],
+							  is_fast);
+				len += _ad3552r_pack_code(buff + len,
+							  data[2 * j], is_fast);
+			} else {
+				len += _ad3552r_pack_code(buff + len, data[j],
+							  is_fast);
+			}
+			if (ldac)
+				buff[len++] = ch_mask;
+		}
+
+		msg.len = len;
+		err = ad3552r_transfer(desc, &msg);
+	}
+
+	/* Single register accesses must not loop */
+	cfg.stream_length_keep_value = 0;
+	cfg.stream_mode_length = 0;
+	ret = _update_spi_cfg(desc, &cfg);
+
+	return err ? err : ret;
+}
+
 #ifdef AD3552R_DEBUG
 
 int32_t ad3552r_get_status(struct ad3552r_desc *desc, uint32_t *status,
@@ -383,7 +383,6 @@ struct ad3552r_desc {
 	struct no_os_gpio_desc *ldac;
 	struct no_os_gpio_desc *reset;
 	struct ad3552r_ch_data ch_data[AD3552R_NUM_CH];
-	uint8_t crc_table[NO_OS_CRC8_TABLE_SIZE];
 	uint8_t chip_id;
 	uint8_t crc_en : 1;
 };
@@ -487,4 +486,10 @@ int32_t ad3552r_write_samples(struct ad3552r_desc *desc, uint16_t *data,
 			      uint32_t samples, uint32_t ch_mask,
 			      enum ad3552r_write_mode mode);
 
+/* Send the samples as a stream of scans, many scans in one SPI transfer.
+ * The output is updated at the rate the SPI clock delivers the scans. */
+int32_t ad3552r_write_samples_stream(struct ad3552r_desc *desc, uint16_t *data,
+				     uint32_t samples, uint32_t ch_mask,
+				     enum ad3552r_write_mode mode);
+
 #endif /* _AD3552R_H_ */
@@ -216,6 +216,7 @@ static int32_t iio_ad3552r_prep_wr(struct iio_ad3552r_desc *iio_dac,
 static int32_t iio_ad3552r_wr_dev(struct iio_ad3552r_desc *iio_dac,
 				  uint16_t *buff, uint32_t nb_samples)
 {
+	enum ad3552r_write_mode mode;
 	int32_t i;
 
 	static int c = 0;
@@ -224,9 +225,11 @@ static int32_t iio_ad3552r_wr_dev(struct iio_ad3552r_desc *iio_dac,
 	for (i = 0; i < nb_samples * no_os_hweight32(iio_dac->mask); ++i)
 		buff[i] = no_os_get_unaligned_be16((uint8_t *)&buff[i]);
 
-	return ad3552r_write_samples(iio_dac->dac, buff, nb_samples,
-				     iio_dac->mask,
-				     AD3552R_WRITE_INPUT_REGS_AND_TRIGGER_LDAC);
+	/* Many scans per SPI transfer, LDAC is part of each scan */
+	mode = AD3552R_WRITE_INPUT_REGS_AND_TRIGGER_LDAC;
+
+	return ad3552r_write_samples_stream(iio_dac->dac, buff, nb_samples,
+					    iio_dac->mask, mode);
 }
 
 
@@ -762,3 +762,53 @@ int32_t ad5686_gain_mode(struct ad5686_dev *dev, uint8_t value)
 					    AD5683_CTRL_GM(value));
 	return -1;
 }
+
+/**************************************************************************//**
+ * @brief Write the input register of a channel, dac_seq write_input
+ *        operation.
+ *
+ * @param dev  - The device structure.
+ * @param ch   - The chosen channel, lower than the number of channels the
+ *               sequencer was initialized with.
+ * @param code - Desired value to be written in register.
+ *
+ * @return 0.
+******************************************************************************/
+int32_t ad5686_dac_seq_write(void *dev, uint8_t ch, uint16_t code)
+{
+	ad5686_write_register(dev, ch, code);
+
+	return 0;
+}
+
+/**************************************************************************//**
+ * @brief Update the selected channels, dac_seq update operation. With an LDAC
+ *        GPIO all of them are updated by a single pulse, LDAC is left high so
+ *        the next input writes are held. Drive it high before loading the
+ *        first frame. Without it, the channels are updated one by one.
+ *
+ * @param dev  - The device structure.
+ * @param mask - The selected channels.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+******************************************************************************/
+int32_t ad5686_dac_seq_update(void *dev, uint32_t mask)
+{
+	struct ad5686_dev *ad5686 = dev;
+	int32_t ret;
+	uint8_t ch;
+
+	if (ad5686->gpio_ldac) {
+		ret = no_os_gpio_set_value(ad5686->gpio_ldac, NO_OS_GPIO_LOW);
+		if (ret)
+			return ret;
+
+		return no_os_gpio_set_value(ad5686->gpio_ldac, NO_OS_GPIO_HIGH);
+	}
+
+	for (ch = 0; ch <= AD5686_CH_15; ch++)
+		if (mask & (1 << ch))
+			ad5686_update_register(ad5686, ch);
+
+	return 0;
+}
@@ -274,3 +274,9 @@ void ad5686_read_back_en(struct ad5686_dev *dev,
 
 /* Set Gain mode */
 int32_t ad5686_gain_mode(struct ad5686_dev *dev, uint8_t value);
+
+/* Write the input register of a channel, dac_seq write_input operation */
+int32_t ad5686_dac_seq_write(void *dev, uint8_t ch, uint16_t code);
+
+/* Update the selected channels, dac_seq update operation */
+int32_t ad5686_dac_seq_update(void *dev, uint32_t mask);
@@ -53,16 +53,16 @@
 #include "stdlib.h"
 
 /**
- * Compute CRC8 checksum.
+ * Continue a CRC8 checksum over more data.
+ * @param crc - The checksum of the previous data, 0 at the start.
  * @param data - The data buffer.
  * @param data_size - The size of the data buffer.
  * @return CRC8 checksum.
  */
-static uint8_t ad5758_compute_crc8(uint8_t *data,
-				   uint8_t data_size)
+static uint8_t ad5758_crc8_update(uint8_t crc, const uint8_t *data,
+				  uint8_t data_size)
 {
 	uint8_t i;
-	uint8_t crc = 0;
 
 	while (data_size) {
 		for (i = 0x80; i != 0; i >>= 1) {
@@ -80,6 +80,39 @@ static uint8_t ad5758_compute_crc8(uint8_t *data,
 	return crc;
 }
 
+/**
+ * Compute CRC8 checksum.
+ * @param data - The data buffer.
+ * @param data_size - The size of the data buffer.
+ * @return CRC8 checksum.
+ */
+static uint8_t ad5758_compute_crc8(uint8_t *data,
+				   uint8_t data_size)
+{
+	return ad5758_crc8_update(0, data, data_size);
+}
+
+/**
+ * Build a register write frame. The checksum of DAC_INPUT frames starts
+ * from the precomputed one of their constant first byte.
+ * @param dev - The device structure.
+ * @param reg_addr - The register address.
+ * @param reg_data - The register data.
+ * @param buf - The 4 bytes frame.
+ */
+static void ad5758_build_frame(struct ad5758_dev *dev, uint8_t reg_addr,
+			       uint16_t reg_data, uint8_t *buf)
+{
+	buf[0] = AD5758_REG_WRITE_ADDR(dev->dev_addr, reg_addr);
+	buf[1] = (reg_data >> 8);
+	buf[2] = (reg_data & 0xFF);
+
+	if (reg_addr == AD5758_REG_DAC_INPUT)
+		buf[3] = ad5758_crc8_update(dev->dac_input_crc, &buf[1], 2);
+	else
+		buf[3] = ad5758_compute_crc8(buf, 3);
+}
+
 /**
  * Read from device.
  * @param dev - The device structure.
@@ -94,7 +127,8 @@ int32_t ad5758_spi_reg_read(struct ad5758_dev *dev,
 	uint8_t buf[4];
 	int32_t ret;
 
-	buf[0] = AD5758_REG_WRITE(AD5758_REG_TWO_STAGE_READBACK_SELECT);
+	buf[0] = AD5758_REG_WRITE_ADDR(dev->dev_addr,
+				       AD5758_REG_TWO_STAGE_READBACK_SELECT);
 	buf[1] = 0x00;
 	buf[2] = reg_addr;
 
@@ -107,7 +141,7 @@ int32_t ad5758_spi_reg_read(struct ad5758_dev *dev,
 	if (ret < 0)
 		goto spi_err;
 
-	buf[0] = AD5758_REG_WRITE(AD5758_REG_NOP);
+	buf[0] = AD5758_REG_WRITE_ADDR(dev->dev_addr, AD5758_REG_NOP);
 	buf[1] = 0x00;
 	buf[2] = 0x00;
 
@@ -149,10 +183,7 @@ int32_t ad5758_spi_reg_write(struct ad5758_dev *dev,
 {
 	uint8_t buf[4];
 
-	buf[0] = AD5758_REG_WRITE(reg_addr);
-	buf[1] = (reg_data >> 8);
-	buf[2] = (reg_data & 0xFF);
-	buf[3] = ad5758_compute_crc8(buf, 3);
+	ad5758_build_frame(dev, reg_addr, reg_data, buf);
 
 	return no_os_spi_write_and_read(dev->spi_desc, buf, 4);
 }
@@ -249,6 +280,10 @@ int32_t ad5758_soft_reset(struct ad5758_dev *dev)
 	/* Wait 100 us */
 	no_os_udelay(100);
 
+	dev->dac_code_valid = false;
+	dev->dcdc_config1_valid = false;
+	dev->dcdc_busy = false;
+
 	return 0;
 
 error:
@@ -318,6 +353,8 @@ int32_t ad5758_set_dc_dc_conv_mode(struct ad5758_dev *dev,
 		ad5758_spi_reg_read(dev, AD5758_REG_DCDC_CONFIG2, &reg_data);
 	} while (reg_data & AD5758_DCDC_CONFIG2_BUSY_3WI_MSK);
 	dev->dc_dc_mode = mode;
+	dev->dcdc_config1_valid = false;
+	dev->dcdc_busy = false;
 
 	return 0;
 
@@ -500,6 +537,163 @@ int32_t ad5758_dac_input_write(struct ad5758_dev *dev, uint16_t code)
 		return -1;
 	}
 
+	dev->dac_code = code;
+	dev->dac_code_valid = true;
+
+	return 0;
+}
+
+/**
+ * Wait until the previous DCDC_CONFIG1 write went through the 3-wire
+ * interface. Polled only when a write is pending, so that the fast path
+ * does not read back the status after each dc-to-dc adjustment.
+ * @param dev - The device structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad5758_dcdc_wait_3wi(struct ad5758_dev *dev)
+{
+	uint16_t reg_data;
+	int32_t ret;
+
+	while (dev->dcdc_busy) {
+		ret = ad5758_spi_reg_read(dev, AD5758_REG_DCDC_CONFIG2,
+					  &reg_data);
+		if (ret < 0)
+			return ret;
+
+		dev->dcdc_busy = !!(reg_data &
+				    AD5758_DCDC_CONFIG2_BUSY_3WI_MSK);
+	}
+
+	return 0;
+}
+
+/**
+ * Update the output with the least SPI traffic. Only the DAC_INPUT register
+ * is written, unless the code is the one already written, and the
+ * dc-to-dc output voltage is adjusted from the cached DCDC_CONFIG1 register,
+ * in the same transfer, without read-modify-write.
+ * @param dev - The device structure.
+ * @param code - DAC input data of 16 bits
+ * @param vprog - DCDC_VPROG value, in PPC current mode only. Negative not to
+ * change it.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad5758_fast_set_output(struct ad5758_dev *dev, uint16_t code,
+			       int8_t vprog)
+{
+	struct no_os_spi_msg msgs[2] = {0};
+	uint8_t frames[2][4];
+	uint16_t config1 = 0;
+	uint32_t n = 0;
+	uint32_t i;
+	int32_t ret;
+
+	if (!dev)
+		return -EINVAL;
+
+	if (vprog >= 0) {
+		if (dev->dc_dc_mode != PPC_CURRENT_MODE)
+			return -EINVAL;
+
+		if (!dev->dcdc_config1_valid) {
+			ret = ad5758_spi_reg_read(dev, AD5758_REG_DCDC_CONFIG1,
+						  &dev->dcdc_config1);
+			if (ret < 0)
+				goto error;
+			dev->dcdc_config1_valid = true;
+		}
+
+		config1 = (dev->dcdc_config1 &
+			   ~AD5758_DCDC_CONFIG1_DCDC_VPROG_MSK) |
+			  AD5758_DCDC_CONFIG1_DCDC_VPROG_MODE(vprog);
+		if (config1 != dev->dcdc_config1) {
+			ret = ad5758_dcdc_wait_3wi(dev);
+			if (ret < 0)
+				goto error;
+			ad5758_build_frame(dev, AD5758_REG_DCDC_CONFIG1,
+					   config1, frames[n++]);
+		}
+	}
+
+	if (!dev->dac_code_valid || code != dev->dac_code)
+		ad5758_build_frame(dev, AD5758_REG_DAC_INPUT, code,
+				   frames[n++]);
+
+	if (!n)
+		return 0;
+
+	for (i = 0; i < n; i++) {
+		msgs[i].tx_buff = frames[i];
+		msgs[i].bytes_number = sizeof(frames[i]);
+		msgs[i].cs_change = 1;
+	}
+
+	ret = no_os_spi_transfer(dev->spi_desc, msgs, n);
+	if (ret < 0)
+		goto error;
+
+	if (vprog >= 0 && config1 != dev->dcdc_config1) {
+		dev->dcdc_config1 = config1;
+		dev->dcdc_busy = true;
+	}
+	dev->dac_code = code;
+	dev->dac_code_valid = true;
+
+	return 0;
+
+error:
+	pr_err("%s: Failed with code: %"PRIi32".\n", __func__, ret);
+	return -1;
+}
+
+/**
+ * Update the outputs of devices sharing the SPI bus and chip select, told
+ * apart by their AD1 and AD0 pins, in a single transfer. Devices whose code
+ * did not change are skipped.
+ * @param devs - The device structures, using the SPI descriptor of the first.
+ * @param codes - DAC input data of 16 bits, one per device.
+ * @param nb_devs - Number of devices, up to AD5758_MAX_ADDR_DEVS.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad5758_fast_set_outputs(struct ad5758_dev **devs,
+				const uint16_t *codes, uint8_t nb_devs)
+{
+	struct no_os_spi_msg msgs[AD5758_MAX_ADDR_DEVS] = {0};
+	uint8_t frames[AD5758_MAX_ADDR_DEVS][4];
+	uint32_t n = 0;
+	uint32_t i;
+	int32_t ret;
+
+	if (!devs || !codes || !nb_devs || nb_devs > AD5758_MAX_ADDR_DEVS)
+		return -EINVAL;
+
+	for (i = 0; i < nb_devs; i++) {
+		if (devs[i]->dac_code_valid && codes[i] == devs[i]->dac_code)
+			continue;
+
+		ad5758_build_frame(devs[i], AD5758_REG_DAC_INPUT, codes[i],
+				   frames[n]);
+		msgs[n].tx_buff = frames[n];
+		msgs[n].bytes_number = sizeof(frames[n]);
+		msgs[n].cs_change = 1;
+		n++;
+	}
+
+	if (!n)
+		return 0;
+
+	ret = no_os_spi_transfer(devs[0]->spi_desc, msgs, n);
+	if (ret < 0) {
+		pr_err("%s: Failed with code: %"PRIi32".\n", __func__, ret);
+		return -1;
+	}
+
+	for (i = 0; i < nb_devs; i++) {
+		devs[i]->dac_code = codes[i];
+		devs[i]->dac_code_valid = true;
+	}
+
 	return 0;
 }
 
@@ -773,13 +967,17 @@ int32_t ad5758_init(struct ad5758_dev **device,
 		    struct ad5758_init_param *init_param)
 {
 	struct ad5758_dev *dev;
+	uint8_t frame;
 	int32_t ret;
 
-	dev = (struct ad5758_dev *)malloc(sizeof(*dev));
+	dev = (struct ad5758_dev *)calloc(1, sizeof(*dev));
 	if (!dev)
 		return -ENOMEM;
 
 	dev->crc_en = true;
+	dev->dev_addr = init_param->dev_addr;
+	frame = AD5758_REG_WRITE_ADDR(dev->dev_addr, AD5758_REG_DAC_INPUT);
+	dev->dac_input_crc = ad5758_compute_crc8(&frame, 1);
 
 	/* Initialize the SPI communication */
 	ret = no_os_spi_init(&dev->spi_desc, &init_param->spi_init);
@@ -39,6 +39,7 @@
 #ifndef AD5758_H_
 #define AD5758_H_
 
+#include <stdbool.h>
 #include "no_os_gpio.h"
 #include "no_os_spi.h"
 
@@ -263,6 +264,12 @@
 #define AD5758_STATUS_DIG_DIAG_STATUS_MSK		NO_OS_BIT(20)
 
 #define AD5758_REG_WRITE(x) 		((0x80) | (x & 0x1F))
+/* Frame header for the device at address addr (AD1, AD0 pins). The slip bit
+ * is the inverse of the bit following it. */
+#define AD5758_REG_WRITE_ADDR(addr, x)	((((~(addr) >> 1) & 0x1) << 7) | \
+					 (((addr) & 0x3) << 5) | ((x) & 0x1F))
+/* Devices sharing the SPI bus and chip select, one per address */
+#define AD5758_MAX_ADDR_DEVS		4
 #define AD5758_CRC8_POLY		0x07 // x^8 + x^2 + x^1 + x^0
 
 /*****************************************************************************/
@@ -388,6 +395,18 @@ struct ad5758_dev {
 	enum ad5758_dc_dc_ilimt dc_dc_ilimit;
 	enum ad5758_output_range output_range;
 	enum ad5758_slew_rate_clk slew_rate_clk;
+	/* Address set by the AD1 and AD0 pins */
+	uint8_t dev_addr;
+	/* CRC8 of the first byte of the DAC_INPUT write frame */
+	uint8_t dac_input_crc;
+	/* Last code written to the DAC_INPUT register */
+	uint16_t dac_code;
+	bool dac_code_valid;
+	/* Cached DCDC_CONFIG1 register */
+	uint16_t dcdc_config1;
+	bool dcdc_config1_valid;
+	/* Set by a DCDC_CONFIG1 write until BUSY_3WI is seen cleared */
+	bool dcdc_busy;
 };
 
 struct ad5758_init_param {
@@ -404,6 +423,8 @@ struct ad5758_init_param {
 	enum ad5758_dc_dc_ilimt dc_dc_ilimit;
 	enum ad5758_output_range output_range;
 	enum ad5758_slew_rate_clk slew_rate_clk;
+	/* Address set by the AD1 and AD0 pins */
+	uint8_t dev_addr;
 };
 
 /******************************************************************************/
@@ -425,6 +446,10 @@ int32_t ad5758_slew_rate_config(struct ad5758_dev *dev,
 				enum ad5758_slew_rate_clk clk,
 				uint8_t enable);
 int32_t ad5758_dac_input_write(struct ad5758_dev *dev, uint16_t code);
+int32_t ad5758_fast_set_output(struct ad5758_dev *dev, uint16_t code,
+			       int8_t vprog);
+int32_t ad5758_fast_set_outputs(struct ad5758_dev **devs,
+				const uint16_t *codes, uint8_t nb_devs);
 int32_t ad5758_dac_output_en(struct ad5758_dev *dev, uint8_t enable);
 int32_t ad5758_clear_dig_diag_flag(struct ad5758_dev *dev,
 				   enum ad5758_dig_diag_flags flag);
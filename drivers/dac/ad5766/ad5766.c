@@ -281,6 +281,33 @@ int32_t ad5766_set_dac_reg_all(struct ad5766_dev *dev,
 				    data);
 }
 
+/**
+ * Write the input register of a channel, dac_seq write_input operation.
+ * @param dev - The device structure.
+ * @param ch - The selected channel.
+ * @param code - The register data.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad5766_dac_seq_write(void *dev, uint8_t ch, uint16_t code)
+{
+	if (ch > AD5766_DAC_15)
+		return -EINVAL;
+
+	return ad5766_set_in_reg(dev, ch, code);
+}
+
+/**
+ * Update the selected channels with one software LDAC command, dac_seq update
+ * operation.
+ * @param dev - The device structure.
+ * @param mask - The selected channels.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad5766_dac_seq_update(void *dev, uint32_t mask)
+{
+	return ad5766_set_sw_ldac(dev, mask & 0xFFFF);
+}
+
 /**
  * Initialize the device.
  * @param device - The device structure.
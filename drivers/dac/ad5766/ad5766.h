@@ -209,6 +209,10 @@ int32_t ad5766_set_dac_reg(struct ad5766_dev *dev,
 /* Set the DAC register for all channels. */
 int32_t ad5766_set_dac_reg_all(struct ad5766_dev *dev,
 			       uint16_t data);
+/* Write the input register of a channel, dac_seq write_input operation. */
+int32_t ad5766_dac_seq_write(void *dev, uint8_t ch, uint16_t code);
+/* Update the selected channels with one software LDAC, dac_seq operation. */
+int32_t ad5766_dac_seq_update(void *dev, uint32_t mask);
 /* Initialize the device. */
 int32_t ad5766_init(struct ad5766_dev **device,
 		    struct ad5766_init_param init_param);
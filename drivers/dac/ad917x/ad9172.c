@@ -46,6 +46,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "ad9172.h"
+#include "ad917x_reg.h"
 #include <inttypes.h>
 
 /**
@@ -288,6 +289,269 @@ static int32_t ad9172_spi_xfer(void *user_data, uint8_t *wbuf,
 	return ret;
 }
 
+/**
+ * Compute a 48 bit frequency tuning word in integer NCO mode.
+ * @param freq_hz - Frequency, negative values tune below DC.
+ * @param rate_hz - Rate at which the NCO runs.
+ * @return The tuning word, two's complement for negative frequencies.
+ */
+static uint64_t ad9172_nco_calc_ftw(int64_t freq_hz, uint64_t rate_hz)
+{
+	uint64_t f = freq_hz < 0 ? -(uint64_t)freq_hz : (uint64_t)freq_hz;
+	uint64_t rem, hi, lo, ftw;
+
+	/* f * 2^48 / rate, in two steps to stay inside 64 bits */
+	hi = no_os_div64_u64_rem(f << 24, rate_hz, &rem);
+	lo = no_os_div64_u64_rem(rem << 24, rate_hz, &rem);
+	ftw = (hi << 24) + lo;
+
+	if (freq_hz < 0)
+		ftw = -ftw;
+
+	return ftw & ADI_MAXUINT48;
+}
+
+/**
+ * Add a register write to a batch of SPI messages.
+ * @param msgs - The messages of the batch.
+ * @param frames - Storage of the 3 byte write frames, one per message.
+ * @param n - The number of messages in the batch, incremented.
+ * @param addr - The register address.
+ * @param data - The register value.
+ */
+static void ad9172_nco_hop_add(struct no_os_spi_msg *msgs,
+			       uint8_t (*frames)[3], uint32_t *n,
+			       uint16_t addr, uint8_t data)
+{
+	frames[*n][0] = (addr >> 8) & 0x7F;
+	frames[*n][1] = addr & 0xFF;
+	frames[*n][2] = data;
+	msgs[*n].tx_buff = frames[*n];
+	msgs[*n].bytes_number = 3;
+	msgs[*n].cs_change = 1;
+	(*n)++;
+}
+
+/**
+ * Enable the NCOs used for hopping, in integer mode, with the modulus off.
+ * Done once, the hops then only write the tuning words.
+ * @param device - The device structure.
+ * @param dacs - Main NCOs to enable, AD917X_DAC0 and/or AD917X_DAC1.
+ * @param channels - Channel NCOs to enable, AD917X_CH_0 to AD917X_CH_5.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9172_nco_hop_setup(ad9172_dev *device, uint8_t dacs,
+			     uint8_t channels)
+{
+	struct ad9172_state *st;
+	uint8_t page;
+	int32_t ret;
+
+	if (!device)
+		return -EINVAL;
+
+	st = device->st;
+	ret = ad917x_nco_enable(&st->dac_h, dacs, channels);
+	if (ret)
+		return -EIO;
+
+	if (dacs) {
+		page = AD917X_CHANNEL_PAGE_0;
+		if (dacs & AD917X_DAC0)
+			page |= AD917X_MAINDAC_PAGE_0;
+		if (dacs & AD917X_DAC1)
+			page |= AD917X_MAINDAC_PAGE_1;
+		ret = ad917x_register_write(&st->dac_h, AD917X_SPI_PAGEINDX_REG,
+					    page);
+		if (ret)
+			return -EIO;
+		ret = ad917x_register_write(&st->dac_h,
+					    AD917X_DDSM_DATAPATH_CFG_REG,
+					    AD917X_DDSM_MODE(0) |
+					    AD917X_DDSM_NCO_EN);
+		if (ret)
+			return -EIO;
+	}
+
+	if (channels) {
+		ret = ad917x_register_write(&st->dac_h, AD917X_SPI_PAGEINDX_REG,
+					    channels & 0x3F);
+		if (ret)
+			return -EIO;
+		ret = ad917x_register_write(&st->dac_h,
+					    AD917X_DDSC_DATAPATH_CFG_REG,
+					    AD917X_DDSC_NCO_EN);
+		if (ret)
+			return -EIO;
+	}
+
+	st->nco_main_enable = dacs;
+	st->nco_channel_enable = channels;
+
+	return 0;
+}
+
+/**
+ * Compute the tuning words of a hop, the SPI bus is not accessed so the
+ * hops can be prepared ahead, e.g. for a frequency table.
+ * The channel NCOs run at the DAC rate divided by the main interpolation.
+ * @param device - The device structure.
+ * @param hop - The hop, dacs, channels and trigger are set by the caller.
+ * @param main_hz - Main NCO frequency, in -fdac/2 to fdac/2.
+ * @param channel_hz - Channel NCO frequency, in -fch/2 to fch/2.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9172_nco_hop_prepare(ad9172_dev *device,
+			       struct ad9172_nco_hop *hop,
+			       int64_t main_hz, int64_t channel_hz)
+{
+	struct ad9172_state *st;
+	uint64_t dac_hz, ch_hz;
+
+	if (!device || !hop)
+		return -EINVAL;
+
+	st = device->st;
+	dac_hz = st->dac_h.dac_freq_hz;
+	if (!dac_hz || !st->dac_interpolation)
+		return -EINVAL;
+	ch_hz = NO_OS_DIV_U64(dac_hz, st->dac_interpolation);
+
+	if (hop->dacs) {
+		if (main_hz < -(int64_t)(dac_hz / 2) ||
+		    main_hz >= (int64_t)(dac_hz / 2))
+			return -EINVAL;
+		hop->main_ftw = ad9172_nco_calc_ftw(main_hz, dac_hz);
+		hop->main_hz = main_hz;
+	}
+
+	if (hop->channels) {
+		if (channel_hz < -(int64_t)(ch_hz / 2) ||
+		    channel_hz >= (int64_t)(ch_hz / 2))
+			return -EINVAL;
+		hop->channel_ftw = ad9172_nco_calc_ftw(channel_hz, ch_hz);
+		hop->channel_hz = channel_hz;
+	}
+
+	return 0;
+}
+
+/**
+ * Write the tuning words of a hop, in a single SPI transfer, without
+ * applying them. For SYSREF triggered hops the load is also armed, the
+ * NCOs switch on the next SYSREF edge. The page register is left pointing
+ * to the NCOs of the hop, ad9172_nco_hop_trigger() relies on it.
+ * The JESD link is not touched.
+ * @param device - The device structure.
+ * @param hop - The hop, from ad9172_nco_hop_prepare().
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9172_nco_hop_stage(ad9172_dev *device,
+			     const struct ad9172_nco_hop *hop)
+{
+	struct no_os_spi_msg msgs[AD9172_NCO_HOP_MAX_WRITES] = {0};
+	uint8_t frames[AD9172_NCO_HOP_MAX_WRITES][3];
+	uint8_t page = hop ? hop->channels & 0x3F : 0;
+	uint32_t n = 0;
+	uint8_t i;
+
+	if (!device || !hop || !(hop->dacs || hop->channels))
+		return -EINVAL;
+
+	if (hop->dacs & AD917X_DAC0)
+		page |= AD917X_MAINDAC_PAGE_0;
+	if (hop->dacs & AD917X_DAC1)
+		page |= AD917X_MAINDAC_PAGE_1;
+	ad9172_nco_hop_add(msgs, frames, &n, AD917X_SPI_PAGEINDX_REG, page);
+
+	if (hop->dacs) {
+		ad9172_nco_hop_add(msgs, frames, &n,
+				   AD917X_DDSM_FTW_UPDATE_REG, 0);
+		for (i = 0; i < 6; i++)
+			ad9172_nco_hop_add(msgs, frames, &n,
+					   AD917X_DDSM_FTW0_REG + i,
+					   hop->main_ftw >> (8 * i));
+		if (hop->trigger == AD9172_NCO_HOP_SYSREF)
+			ad9172_nco_hop_add(msgs, frames, &n,
+					   AD917X_DDSM_FTW_UPDATE_REG,
+					   AD917X_DDSM_FTW_LOAD_SYSREF |
+					   AD917X_DDSM_FTW_LOAD_REQ);
+	}
+
+	if (hop->channels) {
+		ad9172_nco_hop_add(msgs, frames, &n,
+				   AD917X_DDSC_FTW_UPDATE_REG, 0);
+		for (i = 0; i < 6; i++)
+			ad9172_nco_hop_add(msgs, frames, &n,
+					   AD917X_DDSC_FTW0_REG + i,
+					   hop->channel_ftw >> (8 * i));
+		if (hop->trigger == AD9172_NCO_HOP_SYSREF)
+			ad9172_nco_hop_add(msgs, frames, &n,
+					   AD917X_DDSC_FTW_UPDATE_REG,
+					   AD917X_DDSC_FTW_LOAD_SYSREF |
+					   AD917X_DDSC_FTW_LOAD_REQ);
+	}
+
+	return no_os_spi_transfer(device->spi_desc, msgs, n);
+}
+
+/**
+ * Apply a staged hop: one FTW update write per NCO type, sent in a single
+ * SPI transfer. Nothing is written for SYSREF triggered hops.
+ * @param device - The device structure.
+ * @param hop - The hop, staged by ad9172_nco_hop_stage().
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9172_nco_hop_trigger(ad9172_dev *device,
+			       const struct ad9172_nco_hop *hop)
+{
+	struct no_os_spi_msg msgs[2] = {0};
+	uint8_t frames[2][3];
+	uint32_t n = 0;
+	int32_t ret;
+
+	if (!device || !hop)
+		return -EINVAL;
+
+	if (hop->trigger == AD9172_NCO_HOP_SPI) {
+		if (hop->dacs)
+			ad9172_nco_hop_add(msgs, frames, &n,
+					   AD917X_DDSM_FTW_UPDATE_REG,
+					   AD917X_DDSM_FTW_LOAD_REQ);
+		if (hop->channels)
+			ad9172_nco_hop_add(msgs, frames, &n,
+					   AD917X_DDSC_FTW_UPDATE_REG,
+					   AD917X_DDSC_FTW_LOAD_REQ);
+		ret = no_os_spi_transfer(device->spi_desc, msgs, n);
+		if (ret)
+			return ret;
+	}
+
+	if (hop->dacs)
+		device->st->nco_main_hz = hop->main_hz;
+	if (hop->channels)
+		device->st->nco_channel_hz = hop->channel_hz;
+
+	return 0;
+}
+
+/**
+ * Retune the NCOs: stage the hop and apply it.
+ * @param device - The device structure.
+ * @param hop - The hop, from ad9172_nco_hop_prepare().
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9172_nco_hop(ad9172_dev *device, const struct ad9172_nco_hop *hop)
+{
+	int32_t ret;
+
+	ret = ad9172_nco_hop_stage(device, hop);
+	if (ret)
+		return ret;
+
+	return ad9172_nco_hop_trigger(device, hop);
+}
+
 /**
  * Initialize the device.
  * @param device - The device structure.
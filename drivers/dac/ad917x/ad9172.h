@@ -44,6 +44,40 @@
 #include "no_os_gpio.h"
 #include "no_os_spi.h"
 
+/* Number of NCO hop profiles selectable through IIO */
+#define AD9172_NCO_HOP_PROFILES		8
+
+/* Register writes in the longest hop: page, 2 x (update, 6 x FTW, arm) */
+#define AD9172_NCO_HOP_MAX_WRITES	17
+
+enum ad9172_nco_hop_trigger {
+	/* The new FTW is loaded by the FTW update register write */
+	AD9172_NCO_HOP_SPI,
+	/*
+	 * The new FTW is armed when staged and loaded on the next SYSREF
+	 * rising edge, pulsed by a GPIO or by the clock chip.
+	 */
+	AD9172_NCO_HOP_SYSREF,
+};
+
+/**
+ * @struct ad9172_nco_hop
+ * @brief Precomputed NCO frequency hop, filled by ad9172_nco_hop_prepare().
+ */
+struct ad9172_nco_hop {
+	/* Main NCOs to retune, AD917X_DAC0 and/or AD917X_DAC1, 0 for none */
+	uint8_t dacs;
+	/* Channel NCOs to retune, AD917X_CH_0 to AD917X_CH_5, 0 for none */
+	uint8_t channels;
+	/* 48 bit frequency tuning words */
+	uint64_t main_ftw;
+	uint64_t channel_ftw;
+	/* Requested frequencies, for readback */
+	int64_t main_hz;
+	int64_t channel_hz;
+	enum ad9172_nco_hop_trigger trigger;
+};
+
 typedef struct ad9172_dev {
 	/* SPI */
 	struct no_os_spi_desc		*spi_desc;
@@ -80,6 +114,12 @@ struct ad9172_state {
 	signal_coupling_t sysref_coupling;
 	uint8_t nco_main_enable;
 	uint8_t nco_channel_enable;
+	/* Current NCO frequencies set by a hop */
+	int64_t nco_main_hz;
+	int64_t nco_channel_hz;
+	/* Profiles selected by the nco_hop_profile IIO attribute */
+	struct ad9172_nco_hop nco_hop[AD9172_NCO_HOP_PROFILES];
+	uint8_t nco_hop_profile;
 };
 
 typedef struct ad9172_init_param {
@@ -103,4 +143,19 @@ typedef struct ad9172_init_param {
 int32_t ad9172_init(ad9172_dev **device,
 		    ad9172_init_param *init_param);
 int32_t ad9172_remove(ad9172_dev *device);
+/* Enable the NCOs used for hopping, in integer mode. */
+int32_t ad9172_nco_hop_setup(ad9172_dev *device, uint8_t dacs,
+			     uint8_t channels);
+/* Compute the tuning words of a hop, no SPI access. */
+int32_t ad9172_nco_hop_prepare(ad9172_dev *device,
+			       struct ad9172_nco_hop *hop,
+			       int64_t main_hz, int64_t channel_hz);
+/* Write the tuning words of a hop without applying them. */
+int32_t ad9172_nco_hop_stage(ad9172_dev *device,
+			     const struct ad9172_nco_hop *hop);
+/* Apply a staged hop with a single FTW update transfer. */
+int32_t ad9172_nco_hop_trigger(ad9172_dev *device,
+			       const struct ad9172_nco_hop *hop);
+/* Stage and apply a hop. */
+int32_t ad9172_nco_hop(ad9172_dev *device, const struct ad9172_nco_hop *hop);
 #endif // __AD9172_H__
@@ -0,0 +1,231 @@
+/***************************************************************************//**
+ *   @file   iio_ad9172.c
+ *   @brief  Implementation of AD9172 IIO driver.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include "iio_ad9172.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+enum ad9172_iio_nco {
+	AD9172_IIO_MAIN_NCO,
+	AD9172_IIO_CHANNEL_NCO,
+};
+
+/**
+ * @brief Read a register, for the debug attributes.
+ * @param dev - The device structure.
+ * @param reg - The register address.
+ * @param readval - The register value.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad9172_iio_reg_read(void *dev, uint32_t reg, uint32_t *readval)
+{
+	ad9172_dev *ad9172 = dev;
+	uint8_t val;
+
+	if (ad917x_register_read(&ad9172->st->dac_h, reg, &val))
+		return -EIO;
+
+	*readval = val;
+
+	return 0;
+}
+
+/**
+ * @brief Write a register, for the debug attributes.
+ * @param dev - The device structure.
+ * @param reg - The register address.
+ * @param writeval - The register value.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad9172_iio_reg_write(void *dev, uint32_t reg, uint32_t writeval)
+{
+	ad9172_dev *ad9172 = dev;
+
+	if (ad917x_register_write(&ad9172->st->dac_h, reg, writeval))
+		return -EIO;
+
+	return 0;
+}
+
+/**
+ * @brief Show the frequency of the main or of the channel NCOs.
+ * @param device - The device structure.
+ * @param buf - Output buffer.
+ * @param len - Length of the output buffer.
+ * @param channel - Not used, device attribute.
+ * @param priv - AD9172_IIO_MAIN_NCO or AD9172_IIO_CHANNEL_NCO.
+ * @return Number of bytes printed in the output buffer.
+ */
+static int ad9172_iio_get_nco(void *device, char *buf, uint32_t len,
+			      const struct iio_ch_info *channel,
+			      intptr_t priv)
+{
+	ad9172_dev *dev = device;
+	int64_t freq;
+
+	if (priv == AD9172_IIO_MAIN_NCO)
+		freq = dev->st->nco_main_hz;
+	else
+		freq = dev->st->nco_channel_hz;
+
+	return snprintf(buf, len, "%"PRIi64, freq);
+}
+
+/**
+ * @brief Retune the main or the channel NCOs enabled by
+ * ad9172_nco_hop_setup(), without touching the JESD link.
+ * @param device - The device structure.
+ * @param buf - Frequency in Hz.
+ * @param len - Length of the input buffer.
+ * @param channel - Not used, device attribute.
+ * @param priv - AD9172_IIO_MAIN_NCO or AD9172_IIO_CHANNEL_NCO.
+ * @return len in case of success, negative error code otherwise.
+ */
+static int ad9172_iio_set_nco(void *device, char *buf, uint32_t len,
+			      const struct iio_ch_info *channel,
+			      intptr_t priv)
+{
+	ad9172_dev *dev = device;
+	struct ad9172_nco_hop hop = {0};
+	int64_t freq;
+	int32_t ret;
+
+	freq = strtoll(buf, NULL, 0);
+	if (priv == AD9172_IIO_MAIN_NCO)
+		hop.dacs = dev->st->nco_main_enable;
+	else
+		hop.channels = dev->st->nco_channel_enable;
+	if (!hop.dacs && !hop.channels)
+		return -EINVAL;
+
+	ret = ad9172_nco_hop_prepare(dev, &hop, freq, freq);
+	if (ret)
+		return ret;
+
+	ret = ad9172_nco_hop(dev, &hop);
+	if (ret)
+		return ret;
+
+	return len;
+}
+
+/**
+ * @brief Show the last selected hop profile.
+ * @param device - The device structure.
+ * @param buf - Output buffer.
+ * @param len - Length of the output buffer.
+ * @param channel - Not used, device attribute.
+ * @param priv - Not used.
+ * @return Number of bytes printed in the output buffer.
+ */
+static int ad9172_iio_get_hop_profile(void *device, char *buf, uint32_t len,
+				      const struct iio_ch_info *channel,
+				      intptr_t priv)
+{
+	ad9172_dev *dev = device;
+
+	return snprintf(buf, len, "%"PRIu8, dev->st->nco_hop_profile);
+}
+
+/**
+ * @brief Hop to one of the profiles of ad9172_state.nco_hop, precomputed
+ * by the application with ad9172_nco_hop_prepare().
+ * @param device - The device structure.
+ * @param buf - Profile index.
+ * @param len - Length of the input buffer.
+ * @param channel - Not used, device attribute.
+ * @param priv - Not used.
+ * @return len in case of success, negative error code otherwise.
+ */
+static int ad9172_iio_set_hop_profile(void *device, char *buf, uint32_t len,
+				      const struct iio_ch_info *channel,
+				      intptr_t priv)
+{
+	ad9172_dev *dev = device;
+	uint32_t profile;
+	int32_t ret;
+
+	profile = strtoul(buf, NULL, 0);
+	if (profile >= AD9172_NCO_HOP_PROFILES)
+		return -EINVAL;
+
+	ret = ad9172_nco_hop(dev, &dev->st->nco_hop[profile]);
+	if (ret)
+		return ret;
+
+	dev->st->nco_hop_profile = profile;
+
+	return len;
+}
+
+static struct iio_attribute ad9172_iio_attributes[] = {
+	{
+		.name = "main_nco_frequency",
+		.priv = AD9172_IIO_MAIN_NCO,
+		.show = ad9172_iio_get_nco,
+		.store = ad9172_iio_set_nco,
+	},
+	{
+		.name = "channel_nco_frequency",
+		.priv = AD9172_IIO_CHANNEL_NCO,
+		.show = ad9172_iio_get_nco,
+		.store = ad9172_iio_set_nco,
+	},
+	{
+		.name = "nco_hop_profile",
+		.show = ad9172_iio_get_hop_profile,
+		.store = ad9172_iio_set_hop_profile,
+	},
+	END_ATTRIBUTES_ARRAY
+};
+
+struct iio_device ad9172_iio_descriptor = {
+	.attributes = ad9172_iio_attributes,
+	.debug_reg_read = ad9172_iio_reg_read,
+	.debug_reg_write = ad9172_iio_reg_write,
+};
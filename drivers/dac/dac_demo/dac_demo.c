@@ -69,6 +69,16 @@ int32_t dac_demo_init(struct dac_demo_desc **desc,
 	adesc->loopback_buffers = param->loopback_buffers;
 	adesc->loopback_buffer_len = param->loopback_buffer_len;
 
+	if (param->dds && param->loopback_buffers) {
+		uint32_t nb_dds = no_os_min(param->dds_nb_ch, TOTAL_DAC_CHANNELS);
+
+		for (uint32_t i = 0; i < nb_dds; i++)
+			no_os_dds_generate(&param->dds[i],
+					   (uint16_t *)param->loopback_buffers +
+					   i * param->loopback_buffer_len,
+					   param->loopback_buffer_len, 1);
+	}
+
 	for(int i = 0; i < TOTAL_DAC_CHANNELS; i++)
 		adesc->dac_ch_attr[i] = param->dev_ch_attr[i];
 	adesc->dac_global_attr = param->dev_global_attr;
@@ -46,6 +46,7 @@
 
 #include <stdint.h>
 #include "iio_types.h"
+#include "no_os_dds.h"
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -89,6 +90,14 @@ struct dac_demo_init_param {
 	uint32_t loopback_buffer_len;
 	/** Buffer for adc/dac communication*/
 	uint16_t **loopback_buffers;
+	/**
+	 * Optional. Generators filling the loopback buffers of the first
+	 * dds_nb_ch channels at init, so the adc_demo has a waveform to read
+	 * before any is written by the host.
+	 */
+	struct no_os_dds *dds;
+	/** Number of generators in dds */
+	uint32_t dds_nb_ch;
 };
 
 enum iio_dac_demo_attributes {
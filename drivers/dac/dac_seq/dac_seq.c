@@ -0,0 +1,355 @@
+/***************************************************************************//**
+ *   @file   dac_seq.c
+ *   @brief  Implementation of the timer paced multi-channel DAC sequencer.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "dac_seq.h"
+#include "no_os_alloc.h"
+#include "no_os_error.h"
+#include "no_os_util.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Check that mask only selects channels of the device.
+ * @param desc - DAC sequencer descriptor.
+ * @param mask - Channel mask.
+ * @return true if mask is valid, false otherwise.
+ */
+static bool dac_seq_mask_valid(struct dac_seq_desc *desc, uint32_t mask)
+{
+	if (!mask)
+		return false;
+
+	if (desc->nb_channels == DAC_SEQ_MAX_CHANNELS)
+		return true;
+
+	return !(mask >> desc->nb_channels);
+}
+
+/**
+ * @brief Timer interrupt handler. The frame loaded on the previous period is
+ * updated first, so the outputs change at the start of every period no matter
+ * how long the SPI writes of the next frame take.
+ * @param ctx - DAC sequencer descriptor.
+ */
+static void dac_seq_irq_handler(void *ctx)
+{
+	struct dac_seq_desc *desc = ctx;
+
+	if (!desc->running)
+		return;
+
+	if (desc->loaded) {
+		if (dac_seq_update(desc, desc->mask))
+			desc->nb_errors++;
+		desc->loaded = false;
+	}
+
+	if (desc->frame_idx == desc->nb_frames) {
+		if (!desc->cyclic) {
+			no_os_timer_stop(desc->timer);
+			desc->running = false;
+			return;
+		}
+		desc->frame_idx = 0;
+	}
+
+	if (dac_seq_load_frame(desc, desc->mask, desc->table +
+			       desc->frame_idx * desc->frame_len))
+		desc->nb_errors++;
+	else
+		desc->loaded = true;
+	desc->frame_idx++;
+}
+
+/**
+ * @brief Initialize the DAC sequencer.
+ * @param desc - The DAC sequencer descriptor.
+ * @param init_param - The structure that contains the initial parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t dac_seq_init(struct dac_seq_desc **desc,
+		     struct dac_seq_init_param *init_param)
+{
+	struct dac_seq_desc *dac_seq;
+	int32_t ret;
+
+	if (!desc || !init_param || !init_param->dev || !init_param->ops ||
+	    !init_param->ops->write_input || !init_param->ops->update ||
+	    !init_param->nb_channels ||
+	    init_param->nb_channels > DAC_SEQ_MAX_CHANNELS)
+		return -EINVAL;
+
+	if (init_param->timer && !init_param->timer->ticks_count)
+		return -EINVAL;
+
+	dac_seq = no_os_calloc(1, sizeof(*dac_seq));
+	if (!dac_seq)
+		return -ENOMEM;
+
+	dac_seq->dev = init_param->dev;
+	dac_seq->ops = init_param->ops;
+	dac_seq->nb_channels = init_param->nb_channels;
+	dac_seq->timer = init_param->timer;
+
+	if (dac_seq->timer) {
+		dac_seq->irq_ctrl = init_param->irq_ctrl;
+		dac_seq->irq_id = init_param->irq_id;
+		dac_seq->rate_hz = dac_seq->timer->freq_hz /
+				   dac_seq->timer->ticks_count;
+
+		if (init_param->rate_hz) {
+			ret = dac_seq_set_rate(dac_seq, init_param->rate_hz);
+			if (ret)
+				goto error;
+		}
+
+		dac_seq->irq_cb.callback = dac_seq_irq_handler;
+		dac_seq->irq_cb.ctx = dac_seq;
+		dac_seq->irq_cb.event = init_param->irq_event;
+		dac_seq->irq_cb.peripheral = init_param->irq_peripheral;
+		dac_seq->irq_cb.handle = init_param->irq_handle;
+
+		ret = no_os_irq_register_callback(dac_seq->irq_ctrl,
+						  dac_seq->irq_id,
+						  &dac_seq->irq_cb);
+		if (ret)
+			goto error;
+	}
+
+	*desc = dac_seq;
+
+	return 0;
+error:
+	no_os_free(dac_seq);
+
+	return ret;
+}
+
+/**
+ * @brief Write a frame in the input registers, the outputs keep their values
+ * until the next dac_seq_update().
+ * @param desc - The DAC sequencer descriptor.
+ * @param mask - Channels written.
+ * @param codes - One code for each channel in mask, lowest channel first.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t dac_seq_load_frame(struct dac_seq_desc *desc, uint32_t mask,
+			   const uint16_t *codes)
+{
+	uint32_t ch;
+	int32_t ret;
+
+	if (!desc || !codes || !dac_seq_mask_valid(desc, mask))
+		return -EINVAL;
+
+	for (ch = 0; ch < desc->nb_channels; ch++) {
+		if (!(mask & NO_OS_BIT(ch)))
+			continue;
+
+		ret = desc->ops->write_input(desc->dev, ch, *codes++);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Update the outputs of the channels in mask with the content of their
+ * input registers, using a single LDAC pulse or command.
+ * @param desc - The DAC sequencer descriptor.
+ * @param mask - Channels updated.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t dac_seq_update(struct dac_seq_desc *desc, uint32_t mask)
+{
+	if (!desc || !dac_seq_mask_valid(desc, mask))
+		return -EINVAL;
+
+	return desc->ops->update(desc->dev, mask);
+}
+
+/**
+ * @brief Start playing a table of frames, one frame per timer period. The
+ * first frame is loaded here and reaches the outputs on the first period.
+ * @param desc - The DAC sequencer descriptor.
+ * @param table - nb_frames frames of one code for each channel in mask. It
+ *		  must stay valid until the sequencer is stopped.
+ * @param nb_frames - Number of frames in table.
+ * @param mask - Channels played.
+ * @param cyclic - Restart from the first frame after the last one.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t dac_seq_start(struct dac_seq_desc *desc, const uint16_t *table,
+		      uint32_t nb_frames, uint32_t mask, bool cyclic)
+{
+	int32_t ret;
+
+	if (!desc || !table || !nb_frames || !dac_seq_mask_valid(desc, mask))
+		return -EINVAL;
+
+	if (!desc->timer)
+		return -ENOTSUP;
+
+	if (desc->running)
+		return -EBUSY;
+
+	desc->table = table;
+	desc->nb_frames = nb_frames;
+	desc->frame_len = no_os_hweight32(mask);
+	desc->mask = mask;
+	desc->cyclic = cyclic;
+	desc->nb_errors = 0;
+
+	ret = dac_seq_load_frame(desc, mask, table);
+	if (ret)
+		return ret;
+
+	desc->frame_idx = 1;
+	desc->loaded = true;
+	desc->running = true;
+
+	ret = no_os_irq_enable(desc->irq_ctrl, desc->irq_id);
+	if (ret)
+		goto error;
+
+	ret = no_os_timer_start(desc->timer);
+	if (ret)
+		goto error;
+
+	return 0;
+error:
+	desc->running = false;
+
+	return ret;
+}
+
+/**
+ * @brief Stop playing the table of frames. The outputs keep the last frame
+ * updated.
+ * @param desc - The DAC sequencer descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t dac_seq_stop(struct dac_seq_desc *desc)
+{
+	int32_t ret;
+
+	if (!desc)
+		return -EINVAL;
+
+	if (!desc->timer)
+		return -ENOTSUP;
+
+	ret = no_os_timer_stop(desc->timer);
+	if (ret)
+		return ret;
+
+	desc->running = false;
+	desc->loaded = false;
+
+	return no_os_irq_disable(desc->irq_ctrl, desc->irq_id);
+}
+
+/**
+ * @brief Set the frame rate, by changing the clock of the timer.
+ * @param desc - The DAC sequencer descriptor.
+ * @param rate_hz - Frames per second.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t dac_seq_set_rate(struct dac_seq_desc *desc, uint32_t rate_hz)
+{
+	uint64_t clk;
+	int32_t ret;
+
+	if (!desc || !rate_hz)
+		return -EINVAL;
+
+	if (!desc->timer)
+		return -ENOTSUP;
+
+	/* The timer interrupts every ticks_count ticks of its clock */
+	clk = (uint64_t)rate_hz * desc->timer->ticks_count;
+	if (clk > UINT32_MAX)
+		return -EINVAL;
+
+	ret = no_os_timer_count_clk_set(desc->timer, clk);
+	if (ret)
+		return ret;
+
+	desc->rate_hz = rate_hz;
+
+	return 0;
+}
+
+/**
+ * @brief Free the resources allocated by dac_seq_init(). The timer and the
+ * DAC device are owned by the caller and are not removed.
+ * @param desc - The DAC sequencer descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t dac_seq_remove(struct dac_seq_desc *desc)
+{
+	int32_t ret;
+
+	if (!desc)
+		return -EINVAL;
+
+	if (desc->timer) {
+		if (desc->running) {
+			ret = dac_seq_stop(desc);
+			if (ret)
+				return ret;
+		}
+
+		ret = no_os_irq_unregister_callback(desc->irq_ctrl,
+						    desc->irq_id,
+						    &desc->irq_cb);
+		if (ret)
+			return ret;
+	}
+
+	no_os_free(desc);
+
+	return 0;
+}
@@ -0,0 +1,169 @@
+/***************************************************************************//**
+ *   @file   dac_seq.h
+ *   @brief  Header file of the timer paced multi-channel DAC sequencer.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef _DAC_SEQ_H_
+#define _DAC_SEQ_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "no_os_timer.h"
+#include "no_os_irq.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define DAC_SEQ_MAX_CHANNELS	32
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct dac_seq_ops
+ * @brief Device specific operations used by the sequencer. The codes of a
+ * frame are written with write_input, then a single update call makes all of
+ * them visible on the outputs at the same time.
+ */
+struct dac_seq_ops {
+	/** Write code in the input register of channel ch, outputs unchanged */
+	int32_t (*write_input)(void *dev, uint8_t ch, uint16_t code);
+	/** Move the input registers of the channels in mask to the outputs */
+	int32_t (*update)(void *dev, uint32_t mask);
+};
+
+/**
+ * @struct dac_seq_init_param
+ * @brief DAC sequencer initialization structure
+ */
+struct dac_seq_init_param {
+	/** Initialized DAC device, passed to the ops */
+	void *dev;
+	/** Device specific operations */
+	const struct dac_seq_ops *ops;
+	/** Number of channels of the device */
+	uint8_t nb_channels;
+	/** Initialized timer pacing the frames, NULL when paced externally */
+	struct no_os_timer_desc *timer;
+	/** Interrupt descriptor of the timer */
+	struct no_os_irq_ctrl_desc *irq_ctrl;
+	/** Interrupt id of the timer */
+	uint32_t irq_id;
+	/** Platform specific event of the timer interrupt */
+	enum no_os_irq_event irq_event;
+	/** Interrupt source peripheral */
+	enum no_os_irq_peripheral irq_peripheral;
+	/** Platform specific handle of the timer */
+	void *irq_handle;
+	/** Frame rate in Hz, 0 to keep the timer period */
+	uint32_t rate_hz;
+};
+
+/**
+ * @struct dac_seq_desc
+ * @brief DAC sequencer descriptor
+ */
+struct dac_seq_desc {
+	/** DAC device */
+	void *dev;
+	/** Device specific operations */
+	const struct dac_seq_ops *ops;
+	/** Number of channels of the device */
+	uint8_t nb_channels;
+	/** Timer pacing the frames */
+	struct no_os_timer_desc *timer;
+	/** Interrupt descriptor of the timer */
+	struct no_os_irq_ctrl_desc *irq_ctrl;
+	/** Interrupt id of the timer */
+	uint32_t irq_id;
+	/** Timer callback, kept to be unregistered */
+	struct no_os_callback_desc irq_cb;
+	/** Frame rate in Hz */
+	uint32_t rate_hz;
+	/** Frames played by the timer, codes of the channels in mask each */
+	const uint16_t *table;
+	/** Number of frames in table */
+	uint32_t nb_frames;
+	/** Next frame of table to be loaded */
+	uint32_t frame_idx;
+	/** Number of codes in a frame */
+	uint32_t frame_len;
+	/** Channels played */
+	uint32_t mask;
+	/** Restart from the first frame after the last one */
+	bool cyclic;
+	/** Set while the timer plays table */
+	volatile bool running;
+	/** Set when a frame was loaded and is waiting for its update */
+	volatile bool loaded;
+	/** Frames which could not be written in time or failed */
+	volatile uint32_t nb_errors;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Initialize the DAC sequencer. */
+int32_t dac_seq_init(struct dac_seq_desc **desc,
+		     struct dac_seq_init_param *init_param);
+
+/* Write a frame in the input registers of the channels in mask. */
+int32_t dac_seq_load_frame(struct dac_seq_desc *desc, uint32_t mask,
+			   const uint16_t *codes);
+
+/* Update the outputs of the channels in mask with one device operation. */
+int32_t dac_seq_update(struct dac_seq_desc *desc, uint32_t mask);
+
+/* Start playing a table of frames from the timer interrupt. */
+int32_t dac_seq_start(struct dac_seq_desc *desc, const uint16_t *table,
+		      uint32_t nb_frames, uint32_t mask, bool cyclic);
+
+/* Stop playing the table of frames. */
+int32_t dac_seq_stop(struct dac_seq_desc *desc);
+
+/* Set the frame rate. */
+int32_t dac_seq_set_rate(struct dac_seq_desc *desc, uint32_t rate_hz);
+
+/* Free the resources allocated by dac_seq_init(). */
+int32_t dac_seq_remove(struct dac_seq_desc *desc);
+
+#endif // _DAC_SEQ_H_
@@ -0,0 +1,195 @@
+/***************************************************************************//**
+ *   @file   iio_dac_seq.c
+ *   @brief  Implementation of the IIO output buffer of the DAC sequencer.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "iio_dac_seq.h"
+#include "iio.h"
+#include "no_os_alloc.h"
+#include "no_os_error.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define IIO_DAC_SEQ_CH(_idx)  (struct iio_channel){\
+	.ch_type = IIO_VOLTAGE,\
+	.ch_out = true,\
+	.indexed = true,\
+	.channel = _idx,\
+	.scan_index = _idx,\
+	.scan_type = &iio_dac_seq_scan_type}
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+static struct scan_type iio_dac_seq_scan_type = {
+	.sign = 'u',
+	.realbits = 16,
+	.storagebits = 16,
+	.shift = 0,
+	.is_big_endian = false
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Store the channels enabled in the buffer.
+ * @param iio_seq - IIO DAC sequencer descriptor.
+ * @param mask - Enabled channels.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t iio_dac_seq_pre_enable(struct iio_dac_seq_desc *iio_seq,
+				      uint32_t mask)
+{
+	if (!iio_seq || !mask)
+		return -EINVAL;
+
+	iio_seq->mask = mask;
+	iio_seq->loaded = false;
+
+	return 0;
+}
+
+/**
+ * @brief Update the outputs with the scan loaded on the previous trigger, then
+ * load the next scan of the buffer. Doing the update first keeps the interval
+ * between updates equal to the trigger period.
+ * @param dev_data - IIO device data.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t iio_dac_seq_trigger_handler(struct iio_device_data *dev_data)
+{
+	uint16_t codes[DAC_SEQ_MAX_CHANNELS];
+	struct iio_dac_seq_desc *iio_seq;
+	int32_t ret;
+
+	if (!dev_data)
+		return -EINVAL;
+
+	iio_seq = dev_data->dev;
+
+	if (iio_seq->loaded) {
+		iio_seq->loaded = false;
+		ret = dac_seq_update(iio_seq->seq, iio_seq->mask);
+		if (ret)
+			return ret;
+	}
+
+	ret = iio_buffer_pop_scan(dev_data->buffer, codes);
+	if (ret) {
+		/* No scan written by the host yet, the outputs are held */
+		iio_buffer_underrun(dev_data->buffer);
+		return 0;
+	}
+
+	ret = dac_seq_load_frame(iio_seq->seq, iio_seq->mask, codes);
+	if (ret)
+		return ret;
+
+	iio_seq->loaded = true;
+
+	return 0;
+}
+
+/**
+ * @brief Initialize the IIO output buffer of a DAC sequencer.
+ * @param iio_seq - IIO DAC sequencer descriptor.
+ * @param seq - Initialized DAC sequencer.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t iio_dac_seq_init(struct iio_dac_seq_desc **iio_seq,
+			 struct dac_seq_desc *seq)
+{
+	struct iio_dac_seq_desc *desc;
+	uint32_t i;
+
+	if (!iio_seq || !seq)
+		return -EINVAL;
+
+	desc = no_os_calloc(1, sizeof(*desc));
+	if (!desc)
+		return -ENOMEM;
+
+	desc->seq = seq;
+	for (i = 0; i < seq->nb_channels; i++)
+		desc->channels[i] = IIO_DAC_SEQ_CH(i);
+
+	desc->iio_desc.num_ch = seq->nb_channels;
+	desc->iio_desc.channels = desc->channels;
+	desc->iio_desc.pre_enable = (int32_t (*)())iio_dac_seq_pre_enable;
+	desc->iio_desc.trigger_handler = iio_dac_seq_trigger_handler;
+
+	*iio_seq = desc;
+
+	return 0;
+}
+
+/**
+ * @brief Free the resources allocated by iio_dac_seq_init().
+ * @param iio_seq - IIO DAC sequencer descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t iio_dac_seq_remove(struct iio_dac_seq_desc *iio_seq)
+{
+	if (!iio_seq)
+		return -EINVAL;
+
+	no_os_free(iio_seq);
+
+	return 0;
+}
+
+/**
+ * @brief Get the IIO device of the sequencer.
+ * @param iio_seq - IIO DAC sequencer descriptor.
+ * @param desc - Where to store the IIO device.
+ */
+void iio_dac_seq_get_descriptor(struct iio_dac_seq_desc *iio_seq,
+				struct iio_device **desc)
+{
+	if (!iio_seq || !desc)
+		return;
+
+	*desc = &iio_seq->iio_desc;
+}
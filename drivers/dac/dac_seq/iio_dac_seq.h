@@ -0,0 +1,86 @@
+/***************************************************************************//**
+ *   @file   iio_dac_seq.h
+ *   @brief  Header file of the IIO output buffer of the DAC sequencer.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef IIO_DAC_SEQ_H
+#define IIO_DAC_SEQ_H
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "dac_seq.h"
+#include "iio_types.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct iio_dac_seq_desc
+ * @brief IIO output buffer of a DAC sequencer. Paced by an IIO trigger, for
+ * example iio_timer_trig, each trigger updates the outputs with the frame
+ * loaded on the previous one and loads the next scan of the buffer.
+ */
+struct iio_dac_seq_desc {
+	/** Channels of the device */
+	struct iio_channel channels[DAC_SEQ_MAX_CHANNELS];
+	/** IIO device */
+	struct iio_device iio_desc;
+	/** DAC sequencer, owned by the caller */
+	struct dac_seq_desc *seq;
+	/** Channels enabled in the buffer */
+	uint32_t mask;
+	/** Set when a scan was loaded and is waiting for its update */
+	bool loaded;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Initialize the IIO output buffer of an initialized DAC sequencer. */
+int32_t iio_dac_seq_init(struct iio_dac_seq_desc **iio_seq,
+			 struct dac_seq_desc *seq);
+
+/* Free the resources allocated by iio_dac_seq_init(). */
+int32_t iio_dac_seq_remove(struct iio_dac_seq_desc *iio_seq);
+
+/* Get the IIO device of the sequencer. */
+void iio_dac_seq_get_descriptor(struct iio_dac_seq_desc *iio_seq,
+				struct iio_device **desc);
+
+#endif /* IIO_DAC_SEQ_H */
@@ -408,6 +408,45 @@ int32_t ltc268x_set_voltage(struct ltc268x_dev *dev, uint8_t channel,
 				  dev->dev_id), code);
 }
 
+/**
+ * @brief Write the code register of a channel without updating its output,
+ * dac_seq write_input operation.
+ * @param dev - The device structure.
+ * @param ch - The selected channel.
+ * @param code - The DAC code.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ltc268x_dac_seq_write(void *dev, uint8_t ch, uint16_t code)
+{
+	struct ltc268x_dev *ltc268x = dev;
+	int32_t ret;
+
+	if (ch >= ltc268x->num_channels)
+		return -EINVAL;
+
+	ret = _ltc268x_spi_write(ltc268x, LTC268X_CMD_CH_CODE(ch,
+				 ltc268x->dev_id), code);
+	if (ret)
+		return ret;
+
+	ltc268x->dac_code[ch] = code;
+
+	return 0;
+}
+
+/**
+ * @brief Update the outputs of all the channels with one command, dac_seq
+ * update operation. The channels not written since the last update keep
+ * their value.
+ * @param dev - The device structure.
+ * @param mask - The selected channels.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ltc268x_dac_seq_update(void *dev, uint32_t mask)
+{
+	return _ltc268x_spi_write(dev, LTC268X_CMD_UPDATE_ALL, 0);
+}
+
 /**
  * Initialize the device.
  * @param device - The device structure.
@@ -187,6 +187,8 @@ int32_t ltc268x_software_reset(struct ltc268x_dev *dev);
 int32_t ltc268x_set_voltage(struct ltc268x_dev *dev, uint8_t channel,
 			    float voltage);
 int32_t ltc268x_software_toggle(struct ltc268x_dev *dev, uint8_t channel);
+int32_t ltc268x_dac_seq_write(void *dev, uint8_t ch, uint16_t code);
+int32_t ltc268x_dac_seq_update(void *dev, uint32_t mask);
 int32_t ltc268x_init(struct ltc268x_dev **device,
 		     struct ltc268x_init_param init_param);
 int32_t ltc268x_remove(struct ltc268x_dev *dev);
@@ -235,3 +235,21 @@ int32_t display_print_char(struct display_dev *device, char chr,
 
 	return device->controller_ops->print_char(device, chr, row, column);
 }
+
+/***************************************************************************//**
+ * @brief Sends the buffered changes to the screen, for the controllers keeping
+ *        the screen in a framebuffer. Does nothing for the other ones.
+ *
+ * @param device - The device structure.
+ * @return Returns 0 in case of success or negative error code otherwise.
+*******************************************************************************/
+int32_t display_flush(struct display_dev *device)
+{
+	if (!device)
+		return -EINVAL;
+
+	if (!device->controller_ops->flush)
+		return 0;
+
+	return device->controller_ops->flush(device);
+}
@@ -95,6 +95,8 @@ struct display_controller_ops {
 	/** Print character by ascii number */
 	int32_t (*print_char)(struct display_dev *, uint8_t, uint8_t,
 			      uint8_t);
+	/** Send the buffered changes to the screen, optional */
+	int32_t (*flush)(struct display_dev *);
 	/** Removes resources allocated by device */
 	int32_t (*remove)(struct display_dev *);
 };
@@ -131,4 +133,7 @@ int32_t display_print_string(struct display_dev *device, char *msg,
 int32_t display_print_char(struct display_dev *device, char chr,
 			   uint8_t row, uint8_t column);
 
+/** Sends the buffered changes to the screen. */
+int32_t display_flush(struct display_dev *device);
+
 #endif
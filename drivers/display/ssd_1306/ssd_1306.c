@@ -45,6 +45,7 @@
 #include "no_os_error.h"
 #include "no_os_spi.h"
 #include "no_os_delay.h"
+#include "no_os_alloc.h"
 #include <string.h>
 
 /******************************************************************************/
@@ -58,12 +59,15 @@
 #define SSD1306_DISP_ON    	0xAFU
 #define SSD1306_DISP_OFF   	0xAEU
 #define SSD1306_CHARSZ  	8U
+/* Dirty region start, above any column, for a clean framebuffer */
+#define SSD1306_CLEAN		0xFFU
 
 const struct display_controller_ops ssd1306_ops = {
 	.init = &ssd_1306_init,
 	.display_on_off = &ssd_1306_display_on_off,
 	.move_cursor = &ssd_1306_move_cursor,
 	.print_char = &ssd_1306_print_ascii,
+	.flush = &ssd_1306_flush,
 	.remove = &ssd_1306_remove
 };
 
@@ -73,6 +77,101 @@ extern const uint8_t no_os_chr_8x8[128][8];
 /************************** Functions Implementation **************************/
 /******************************************************************************/
 
+/***************************************************************************//**
+ * @brief Adds a region to the changed region of the framebuffer and, with a
+ *        flush delay, arms the deferred flush.
+ *
+ * @param device   - The device structure.
+ * @param page_min - First page.
+ * @param page_max - Last page.
+ * @param col_min  - First column.
+ * @param col_max  - Last column.
+*******************************************************************************/
+static void ssd_1306_mark_dirty(struct display_dev *device, uint8_t page_min,
+				uint8_t page_max, uint8_t col_min,
+				uint8_t col_max)
+{
+	ssd_1306_extra *extra = device->extra;
+
+	if (extra->dirty_col_min == SSD1306_CLEAN) {
+		extra->dirty_page_min = page_min;
+		extra->dirty_page_max = page_max;
+		extra->dirty_col_min = col_min;
+		extra->dirty_col_max = col_max;
+	} else {
+		if (page_min < extra->dirty_page_min)
+			extra->dirty_page_min = page_min;
+		if (page_max > extra->dirty_page_max)
+			extra->dirty_page_max = page_max;
+		if (col_min < extra->dirty_col_min)
+			extra->dirty_col_min = col_min;
+		if (col_max > extra->dirty_col_max)
+			extra->dirty_col_max = col_max;
+	}
+
+#ifdef NO_OS_SCHED
+	/* Later changes join the armed flush instead of pushing it back */
+	if (extra->flush_delay_ms && !extra->flush_armed &&
+	    !no_os_sched_timer_start(&extra->flush_work,
+				     extra->flush_delay_ms, 0))
+		extra->flush_armed = true;
+#endif
+}
+
+#ifdef NO_OS_SCHED
+/***************************************************************************//**
+ * @brief Deferred flush, run from the scheduler loop.
+ *
+ * @param ctx - The device structure.
+*******************************************************************************/
+static void ssd_1306_flush_work(void *ctx)
+{
+	struct display_dev *device = ctx;
+	ssd_1306_extra *extra = device->extra;
+
+	extra->flush_armed = false;
+	ssd_1306_flush(device);
+}
+#endif
+
+/***************************************************************************//**
+ * @brief Allocates the framebuffer, the whole screen being sent by the first
+ *        flush since the display RAM content is unknown after reset.
+ *
+ * @param device - The device structure.
+ * @return Returns 0 in case of success or negative error code otherwise.
+*******************************************************************************/
+static int32_t ssd_1306_fb_init(struct display_dev *device)
+{
+	ssd_1306_extra *extra = device->extra;
+#ifdef NO_OS_SCHED
+	int32_t ret;
+#endif
+
+	extra->fb = no_os_calloc(device->rows_nb * device->cols_nb,
+				 SSD1306_CHARSZ);
+	if (!extra->fb)
+		return -ENOMEM;
+	extra->dirty_col_min = SSD1306_CLEAN;
+
+#ifdef NO_OS_SCHED
+	extra->flush_armed = false;
+	if (extra->flush_delay_ms) {
+		ret = no_os_sched_work_add(&extra->flush_work,
+					   ssd_1306_flush_work, device);
+		if (ret != 0) {
+			no_os_free(extra->fb);
+			extra->fb = NULL;
+			return ret;
+		}
+	}
+#endif
+	ssd_1306_mark_dirty(device, 0, device->rows_nb - 1U, 0,
+			    device->cols_nb * SSD1306_CHARSZ - 1U);
+
+	return 0;
+}
+
 /***************************************************************************//**
  * @brief Initializes ssd_1306 for display screening.
  *
@@ -86,6 +185,12 @@ int32_t ssd_1306_init(struct display_dev *device)
 	ssd_1306_extra *extra;
 
 	extra = device->extra;
+	extra->fb = NULL;
+	if (extra->use_framebuffer &&
+	    (device->rows_nb > SSD1306_MAX_PAGES ||
+	     device->cols_nb * SSD1306_CHARSZ > SSD1306_CLEAN))
+		return -EINVAL;
+
 	ret = no_os_spi_init(&extra->spi_desc, extra->spi_ip);
 	if (ret != 0)
 		return -1;
@@ -157,7 +262,14 @@ int32_t ssd_1306_init(struct display_dev *device)
 		return -1;
 	command[0] = 0x20;	// memory addressing mode
 	command[1] = 0x00;	// horizontal addressing
-	return no_os_spi_write_and_read(extra->spi_desc, command, 2U);
+	ret = no_os_spi_write_and_read(extra->spi_desc, command, 2U);
+	if (ret != 0)
+		return -1;
+
+	if (!extra->use_framebuffer)
+		return 0;
+
+	return ssd_1306_fb_init(device);
 }
 
 /***************************************************************************//**
@@ -227,9 +339,26 @@ int32_t ssd_1306_print_ascii(struct display_dev *device, uint8_t ascii,
 	int32_t ret;
 	ssd_1306_extra *extra;
 	uint8_t ch[SSD1306_CHARSZ];
-	memcpy(ch, no_os_chr_8x8[ascii], SSD1306_CHARSZ);
+	uint8_t *cell;
 
 	extra = device->extra;
+	if (extra->fb) {
+		if (row >= device->rows_nb || column >= device->cols_nb)
+			return -EINVAL;
+
+		cell = extra->fb +
+		       (row * device->cols_nb + column) * SSD1306_CHARSZ;
+		if (!memcmp(cell, no_os_chr_8x8[ascii], SSD1306_CHARSZ))
+			return 0;
+
+		memcpy(cell, no_os_chr_8x8[ascii], SSD1306_CHARSZ);
+		ssd_1306_mark_dirty(device, row, row, column * SSD1306_CHARSZ,
+				    (column + 1U) * SSD1306_CHARSZ - 1U);
+
+		return 0;
+	}
+
+	memcpy(ch, no_os_chr_8x8[ascii], SSD1306_CHARSZ);
 	ret = ssd_1306_move_cursor(device, row, column);
 	if (ret != 0)
 		return -1;
@@ -239,6 +368,67 @@ int32_t ssd_1306_print_ascii(struct display_dev *device, uint8_t ascii,
 	return no_os_spi_write_and_read(extra->spi_desc, ch, SSD1306_CHARSZ);
 }
 
+/***************************************************************************//**
+ * @brief Sends the changed region of the framebuffer to the screen: the
+ *        addressing window is set to the region and its pages are sent in
+ *        one transfer, a single message when the region spans whole pages.
+ *
+ * @param device - The device structure.
+ * @return Returns 0 in case of success or negative error code otherwise.
+*******************************************************************************/
+int32_t ssd_1306_flush(struct display_dev *device)
+{
+	int32_t ret;
+	ssd_1306_extra *extra;
+	struct no_os_spi_msg msgs[SSD1306_MAX_PAGES] = {0};
+	uint8_t command[6];
+	uint32_t width, len, nb_msgs, i;
+
+	extra = device->extra;
+	if (!extra->fb || extra->dirty_col_min == SSD1306_CLEAN)
+		return 0;
+
+	ret = no_os_gpio_set_value(extra->dc_pin, SSD1306_DC_CMD);
+	if (ret != 0)
+		return -1;
+	command[0] = 0x21;
+	command[1] = extra->dirty_col_min;
+	command[2] = extra->dirty_col_max;
+	command[3] = 0x22;
+	command[4] = extra->dirty_page_min;
+	command[5] = extra->dirty_page_max;
+	ret = no_os_spi_write_and_read(extra->spi_desc, command, 6U);
+	if (ret != 0)
+		return -1;
+
+	ret = no_os_gpio_set_value(extra->dc_pin, SSD1306_DC_DATA);
+	if (ret != 0)
+		return -1;
+
+	width = device->cols_nb * SSD1306_CHARSZ;
+	len = extra->dirty_col_max - extra->dirty_col_min + 1U;
+	nb_msgs = extra->dirty_page_max - extra->dirty_page_min + 1U;
+	if (len == width) {
+		len *= nb_msgs;
+		nb_msgs = 1;
+	}
+	for (i = 0; i < nb_msgs; i++) {
+		msgs[i].tx_buff = extra->fb +
+				  (extra->dirty_page_min + i) * width +
+				  extra->dirty_col_min;
+		msgs[i].bytes_number = len;
+	}
+	msgs[nb_msgs - 1].cs_change = 1;
+
+	ret = no_os_spi_transfer(extra->spi_desc, msgs, nb_msgs);
+	if (ret != 0)
+		return -1;
+
+	extra->dirty_col_min = SSD1306_CLEAN;
+
+	return 0;
+}
+
 /***************************************************************************//**
  * @brief Removes resources allocated by device.
  *
@@ -251,6 +441,15 @@ int32_t ssd_1306_remove(struct display_dev *device)
 	ssd_1306_extra *extra;
 
 	extra = device->extra;
+	if (extra->fb) {
+#ifdef NO_OS_SCHED
+		if (extra->flush_delay_ms)
+			no_os_sched_work_remove(&extra->flush_work);
+#endif
+		no_os_free(extra->fb);
+		extra->fb = NULL;
+	}
+
 	ret = no_os_gpio_remove(extra->reset_pin);
 	if (ret != 0)
 		return -1;
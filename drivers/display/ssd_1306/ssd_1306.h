@@ -45,8 +45,16 @@
 /******************************************************************************/
 #include <stdint.h>
 #include <stdlib.h>
+#include <stdbool.h>
 #include "display.h"
 #include "no_os_gpio.h"
+#include "no_os_sched.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+/* Pages of 8 pixel rows of the largest panel, 128x64 */
+#define SSD1306_MAX_PAGES	8U
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -68,6 +76,33 @@ typedef struct ssd_1306_extra {
 	struct no_os_spi_init_param      *spi_ip;
 	/* SPI descriptor*/
 	struct no_os_spi_desc	           *spi_desc;
+	/**
+	 * Draw in a RAM framebuffer, sent to the screen by display_flush().
+	 * Only the changed region is sent, in one transfer.
+	 */
+	bool				   use_framebuffer;
+	/**
+	 * With NO_OS_SCHED, milliseconds from the first change of the
+	 * framebuffer to its flush from the scheduler loop. 0 to only flush
+	 * with display_flush().
+	 */
+	uint32_t			   flush_delay_ms;
+	/** Framebuffer, a byte of 8 vertical pixels per column and page */
+	uint8_t				   *fb;
+	/** First page of the changed region */
+	uint8_t				   dirty_page_min;
+	/** Last page of the changed region */
+	uint8_t				   dirty_page_max;
+	/** First column of the changed region, above the last one if none */
+	uint8_t				   dirty_col_min;
+	/** Last column of the changed region */
+	uint8_t				   dirty_col_max;
+#ifdef NO_OS_SCHED
+	/** Deferred flush */
+	struct no_os_sched_work		   flush_work;
+	/** Set while the deferred flush is armed */
+	bool				   flush_armed;
+#endif
 } ssd_1306_extra;
 
 extern const struct display_controller_ops ssd1306_ops;
@@ -89,6 +124,9 @@ int32_t ssd_1306_move_cursor(struct display_dev *device, uint8_t row,
 int32_t ssd_1306_print_ascii(struct display_dev *device, uint8_t ascii,
 			     uint8_t row, uint8_t column);
 
+/** Sends the changed region of the framebuffer to the screen. */
+int32_t ssd_1306_flush(struct display_dev *device);
+
 /** Removes resources allocated by device. */
 int32_t ssd_1306_remove(struct display_dev *device);
 
@@ -43,10 +43,49 @@
 /***************************** Include Files *********************************/
 /*****************************************************************************/
 #include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
 #include "no_os_error.h"
+#include "no_os_alloc.h"
+#include "no_os_util.h"
 #include "adas1000.h"
 #include "no_os_crc.h"
 
+/*****************************************************************************/
+/*************************** Types Declarations ******************************/
+/*****************************************************************************/
+
+/**
+ * @struct adas1000_stream
+ * @brief Frame streaming state. The SPI transfers fill the batches in turn,
+ * in interrupt context when they are asynchronous, and the reader releases
+ * them once consumed.
+ */
+struct adas1000_stream {
+	/** Frame batches */
+	uint8_t *buff[ADAS1000_STREAM_BUFFERS];
+	/** SPI message reading each batch */
+	struct no_os_spi_msg msg[ADAS1000_STREAM_BUFFERS];
+	/** Number of frames of a batch */
+	uint32_t batch_frames;
+	/** Number of batches filled */
+	atomic_uint head;
+	/** Number of batches released by the reader */
+	atomic_uint tail;
+	/** Set while a transfer is in progress */
+	atomic_bool busy;
+	/** Set when no more transfers must be started */
+	atomic_bool stop;
+	/** Error of the last failed transfer */
+	volatile int32_t error;
+	/** Set once the frames of the batch being read have been checked */
+	bool checked;
+	/** Valid frames of the batch being read, moved to its start */
+	uint32_t nb_valid;
+	/** Frames of the batch being read already consumed */
+	uint32_t pos;
+};
+
 /*****************************************************************************/
 /************************ Function Definitions *******************************/
 /*****************************************************************************/
@@ -108,6 +147,7 @@ int32_t adas1000_init(struct adas1000_dev **device,
 
 	/** store the selected frame rate */
 	dev->frame_rate = init_param->frame_rate;
+	dev->crc_ops = init_param->crc_ops;
 
 	/** Initialize the SPI controller. */
 	ret = no_os_spi_init(&dev->spi_desc, &init_param->spi_init);
@@ -261,6 +301,7 @@ int32_t adas1000_set_inactive_framewords(struct adas1000_dev *device,
 	if (ret != 0)
 		return ret;
 	/** compute the number of inactive words */
+	device->inactive_words = words_mask;
 	device->inactive_words_no = 0;
 	for(i = 0; i < 32; i++) {
 		if(words_mask & ADAS1000_WD_CNT_MASK)
@@ -273,6 +314,37 @@ int32_t adas1000_set_inactive_framewords(struct adas1000_dev *device,
 	return adas1000_compute_frame_size(device);
 }
 
+/**
+ * @brief Sets up the CRC engine for the polynomial of the frame rate. The
+ * engine is kept while the CRC width doesn't change.
+ * @param device - The device structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t adas1000_crc_setup(struct adas1000_dev *device)
+{
+	struct no_os_crc_init_param crc_param = {
+		.width = 24,
+		.polynomial = CRC_POLY_2KHZ_16KHZ,
+		.platform_ops = &no_os_crc_sw_ops,
+	};
+
+	if (device->frame_rate == ADAS1000_128KHZ_FRAME_RATE) {
+		crc_param.width = 16;
+		crc_param.polynomial = CRC_POLY_128KHZ;
+	}
+	if (device->crc_ops)
+		crc_param.platform_ops = device->crc_ops;
+
+	if (device->crc_desc) {
+		if (device->crc_desc->width == crc_param.width)
+			return 0;
+		no_os_crc_remove(device->crc_desc);
+		device->crc_desc = NULL;
+	}
+
+	return no_os_crc_init(&device->crc_desc, &crc_param);
+}
+
 /**
  * @brief Sets the frame rate.
  * @param device - The device structure.
@@ -299,6 +371,10 @@ int32_t adas1000_set_frame_rate(struct adas1000_dev *device, uint32_t rate)
 	if (ret != 0)
 		return ret;
 
+	ret = adas1000_crc_setup(device);
+	if (ret != 0)
+		return ret;
+
 	switch(device->frame_rate) {
 	case ADAS1000_16KHZ_FRAME_RATE:
 		frm_ctrl_regval |= ADAS1000_FRMCTL_FRMRATE_16KHZ;
@@ -402,20 +478,376 @@ int32_t adas1000_read_data(struct adas1000_dev *device, uint8_t *data_buff,
  * @brief Computes the CRC for a frame.
  * @param device - Device structure.
  * @param buff - Buffer holding the frame data.
- * @return Returns the CRC value for the given frame.
+ * @return Returns the CRC value for the given frame, 0 if the CRC engine
+ * failed.
  */
 uint32_t adas1000_compute_frame_crc(struct adas1000_dev * device, uint8_t *buff)
 {
 	uint32_t crc = 0xFFFFFFFFul;
+	int32_t ret;
+
+	/** The CRC engine holds the poly and word size of the frame rate. */
+	crc &= NO_OS_GENMASK(device->crc_desc->width - 1, 0);
+	ret = no_os_crc_compute(device->crc_desc, buff, device->frame_size, crc,
+				&crc);
+	if (ret != 0)
+		return 0;
+
+	return crc;
+}
+
+/**
+ * @brief Starts the transfer of the next free batch, unless a transfer is in
+ * progress or no batch is free. Called both by the reader and, possibly in
+ * interrupt context, when a transfer is done.
+ * @param device - Device structure.
+ */
+static void adas1000_stream_submit(struct adas1000_dev *device);
+
+/**
+ * @brief Completion callback of the batch transfers.
+ * @param ctx - Device structure.
+ * @param ret - Result of the transfer.
+ */
+static void adas1000_stream_done(void *ctx, int32_t ret)
+{
+	struct adas1000_dev *device = ctx;
+	struct adas1000_stream *stream = device->stream;
+
+	if (ret != 0)
+		stream->error = ret;
+	atomic_fetch_add(&stream->head, 1);
+	atomic_store(&stream->busy, false);
+
+	adas1000_stream_submit(device);
+}
+
+/**
+ * @brief Checks if a batch can be filled.
+ * @param stream - Streaming state.
+ * @return true if a batch is free and the streaming goes on.
+ */
+static bool adas1000_stream_can_submit(struct adas1000_stream *stream)
+{
+	return !atomic_load(&stream->stop) && !stream->error &&
+	       atomic_load(&stream->head) - atomic_load(&stream->tail) <
+	       ADAS1000_STREAM_BUFFERS;
+}
+
+static void adas1000_stream_submit(struct adas1000_dev *device)
+{
+	struct adas1000_stream *stream = device->stream;
+	struct no_os_spi_msg *msg;
+	bool idle;
+	int32_t ret;
+
+	do {
+		idle = false;
+		if (!atomic_compare_exchange_strong(&stream->busy, &idle, true))
+			return;
+
+		if (adas1000_stream_can_submit(stream)) {
+			msg = &stream->msg[atomic_load(&stream->head) %
+						       ADAS1000_STREAM_BUFFERS];
+			ret = no_os_spi_transfer_async(device->spi_desc, msg, 1,
+						       adas1000_stream_done,
+						       device);
+			if (ret == 0)
+				return;
+			stream->error = ret;
+		}
+
+		atomic_store(&stream->busy, false);
+		/** Catch a batch released after the check */
+	} while (adas1000_stream_can_submit(stream));
+}
+
+/**
+ * @brief Starts streaming the frames. The frames are read in batches, each one
+ * in a single SPI transfer, using DMA on the platforms implementing
+ * asynchronous transfers with it. A batch is read while the next one is
+ * transferred, so the SPI frequency must leave time to consume a batch in
+ * the transfer of the next one. Only the 2kHz and 16kHz frame rates are
+ * supported.
+ * @param device - Device structure.
+ * @param batch_frames - Number of frames of a batch.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t adas1000_stream_start(struct adas1000_dev *device,
+			      uint32_t batch_frames)
+{
+	struct adas1000_stream *stream;
+	uint32_t frm_ctrl_regval;
+	uint32_t i;
+	int32_t ret;
+
+	if (!device || !batch_frames || device->stream)
+		return -EINVAL;
+
+	if (device->frame_rate != ADAS1000_2KHZ_FRAME_RATE &&
+	    device->frame_rate != ADAS1000_16KHZ_FRAME_RATE)
+		return -EINVAL;
+
+	/** Send entire frames, so that a batch holds whole frames. */
+	ret = adas1000_read(device, ADAS1000_FRMCTL, &frm_ctrl_regval);
+	if (ret != 0)
+		return ret;
+	frm_ctrl_regval &= ~(ADAS1000_FRMCTL_RDYRPT |
+			     ADAS1000_FRMCTL_SKIP_MASK);
+	ret = adas1000_write(device, ADAS1000_FRMCTL, frm_ctrl_regval);
+	if (ret != 0)
+		return ret;
+
+	stream = no_os_calloc(1, sizeof(*stream));
+	if (!stream)
+		return -ENOMEM;
+
+	for (i = 0; i < ADAS1000_STREAM_BUFFERS; i++) {
+		stream->buff[i] = no_os_calloc(batch_frames,
+					       device->frame_size);
+		if (!stream->buff[i]) {
+			ret = -ENOMEM;
+			goto error;
+		}
+		/** NOP commands are sent to keep the frames coming. */
+		stream->msg[i].rx_buff = stream->buff[i];
+		stream->msg[i].bytes_number = batch_frames * device->frame_size;
+		stream->msg[i].cs_change = 1;
+	}
+	stream->batch_frames = batch_frames;
+	atomic_init(&stream->head, 0);
+	atomic_init(&stream->tail, 0);
+	atomic_init(&stream->busy, false);
+	atomic_init(&stream->stop, false);
+
+	device->frames_missed = 0;
+	device->crc_errors = 0;
+
+	/** Start the frames read sequence. */
+	ret = adas1000_write(device, ADAS1000_FRAMES, 0);
+	if (ret != 0)
+		goto error;
+
+	device->stream = stream;
+	adas1000_stream_submit(device);
+
+	return 0;
+
+error:
+	for (i = 0; i < ADAS1000_STREAM_BUFFERS; i++)
+		no_os_free(stream->buff[i]);
+	no_os_free(stream);
+
+	return ret;
+}
+
+/**
+ * @brief Checks a frame read while streaming and counts the frames missed
+ * before it.
+ * @param device - Device structure.
+ * @param frame - The frame.
+ * @return 1 for a frame with new data, 0 for a frame sent while the data was
+ * not ready, -EBADMSG for a frame with a wrong header or CRC.
+ */
+static int32_t adas1000_stream_check(struct adas1000_dev *device,
+				     uint8_t *frame)
+{
+	uint32_t header = no_os_get_unaligned_be32(frame);
+
+	if (!(header & ADAS1000_FRAMES_MARKER))
+		return -EBADMSG;
+
+	if (header & ADAS1000_FRAMES_READY_BIT)
+		return 0;
+
+	if (!(device->inactive_words & ADAS1000_FRMCTL_CRCDIS) &&
+	    adas1000_compute_frame_crc(device, frame) !=
+	    CRC_CHECK_CONST_2KHZ_16KHZ)
+		return -EBADMSG;
+
+	/** 3 stands for 3 or more frames missed. */
+	device->frames_missed += no_os_field_get(ADAS1000_FRAMES_OVERFLOW_MASK,
+				 header);
 
-	/** Select the CRC poly and word size based on the frame rate. */
-	if(device->frame_rate == ADAS1000_128KHZ_FRAME_RATE) {
-		NO_OS_DECLARE_CRC16_TABLE(adas1000_crc16);
-		no_os_crc16_populate_msb(adas1000_crc16, CRC_POLY_128KHZ);
-		return no_os_crc16(adas1000_crc16, buff, device->frame_size, (uint16_t)crc);
-	} else {
-		NO_OS_DECLARE_CRC24_TABLE(adas1000_crc24);
-		no_os_crc24_populate_msb(adas1000_crc24, CRC_POLY_2KHZ_16KHZ);
-		return no_os_crc24(adas1000_crc24, buff, device->frame_size, crc);
+	return 1;
+}
+
+/**
+ * @brief Gets the valid frames of the oldest batch not consumed yet. The
+ * frames of a batch are checked once, the frames with new data being moved
+ * to the start of the batch.
+ * @param device - Device structure.
+ * @param frames - Set to the first frame not consumed yet.
+ * @param nb_frames - Set to the number of frames not consumed yet, 0 if the
+ * batch has no valid frame, which must still be consumed.
+ * @return 0 in case of success, -EAGAIN if no batch is filled, negative error
+ * code of the transfers otherwise.
+ */
+int32_t adas1000_stream_get_frames(struct adas1000_dev *device,
+				   uint8_t **frames, uint32_t *nb_frames)
+{
+	struct adas1000_stream *stream;
+	uint32_t frame_size;
+	unsigned int tail;
+	uint8_t *buff, *frame;
+	uint32_t i;
+	int32_t ret;
+
+	if (!device || !device->stream || !frames || !nb_frames)
+		return -EINVAL;
+
+	stream = device->stream;
+	if (stream->error)
+		return stream->error;
+
+	tail = atomic_load(&stream->tail);
+	if (atomic_load(&stream->head) == tail)
+		return -EAGAIN;
+
+	frame_size = device->frame_size;
+	buff = stream->buff[tail % ADAS1000_STREAM_BUFFERS];
+	if (!stream->checked) {
+		stream->nb_valid = 0;
+		for (i = 0; i < stream->batch_frames; i++) {
+			frame = buff + i * frame_size;
+			ret = adas1000_stream_check(device, frame);
+			if (ret < 0)
+				device->crc_errors++;
+			if (ret <= 0)
+				continue;
+
+			if (stream->nb_valid != i)
+				memmove(buff + stream->nb_valid * frame_size,
+					frame, frame_size);
+			stream->nb_valid++;
+		}
+		stream->pos = 0;
+		stream->checked = true;
 	}
+
+	*frames = buff + stream->pos * frame_size;
+	*nb_frames = stream->nb_valid - stream->pos;
+
+	return 0;
+}
+
+/**
+ * @brief Marks frames returned by adas1000_stream_get_frames() as consumed.
+ * The batch is given back to the transfers once all its frames are consumed.
+ * @param device - Device structure.
+ * @param nb_frames - Number of frames consumed.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t adas1000_stream_consume(struct adas1000_dev *device,
+				uint32_t nb_frames)
+{
+	struct adas1000_stream *stream;
+
+	if (!device || !device->stream)
+		return -EINVAL;
+
+	stream = device->stream;
+	if (!stream->checked || nb_frames > stream->nb_valid - stream->pos)
+		return -EINVAL;
+
+	stream->pos += nb_frames;
+	if (stream->pos < stream->nb_valid)
+		return 0;
+
+	stream->checked = false;
+	atomic_fetch_add(&stream->tail, 1);
+	adas1000_stream_submit(device);
+
+	return 0;
+}
+
+/**
+ * @brief Stops streaming the frames, once the transfer in progress is done.
+ * @param device - Device structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t adas1000_stream_stop(struct adas1000_dev *device)
+{
+	struct adas1000_stream *stream;
+	uint32_t frm_ctrl_regval;
+	uint32_t i;
+
+	if (!device || !device->stream)
+		return -EINVAL;
+
+	stream = device->stream;
+	atomic_store(&stream->stop, true);
+	while (atomic_load(&stream->busy))
+		;
+
+	device->stream = NULL;
+	for (i = 0; i < ADAS1000_STREAM_BUFFERS; i++)
+		no_os_free(stream->buff[i]);
+	no_os_free(stream);
+
+	/** Reading a register stops the frames read sequence. */
+	return adas1000_read(device, ADAS1000_FRMCTL, &frm_ctrl_regval);
+}
+
+/**
+ * @brief Gets the lead data words of a frame, whatever the words excluded
+ * from the frame, by the address of each word.
+ * @param device - Device structure.
+ * @param frame - The frame.
+ * @param leads - Data of the LA, LL, RA, V1 and V2 words, in this order.
+ * @return Mask of the leads found in the frame.
+ */
+uint32_t adas1000_unpack_frame(struct adas1000_dev *device,
+			       uint8_t *frame, uint32_t *leads)
+{
+	uint32_t words = device->frame_size / 4;
+	uint32_t found = 0;
+	uint32_t word, lead;
+	uint32_t i;
+
+	/** Skip the header. */
+	for (i = 1; i < words; i++) {
+		word = no_os_get_unaligned_be32(frame + 4 * i);
+		lead = (word >> 24) - ADAS1000_LADATA;
+		if (lead >= ADAS1000_LEADS_NO)
+			continue;
+
+		leads[lead] = word & 0x00FFFFFFul;
+		found |= NO_OS_BIT(lead);
+	}
+
+	return found;
+}
+
+/**
+ * @brief Frees the resources allocated by adas1000_init().
+ * @param device - Device structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t adas1000_remove(struct adas1000_dev *device)
+{
+	int32_t ret;
+
+	if (!device)
+		return -EINVAL;
+
+	if (device->stream) {
+		ret = adas1000_stream_stop(device);
+		if (ret != 0)
+			return ret;
+	}
+
+	if (device->crc_desc) {
+		ret = no_os_crc_remove(device->crc_desc);
+		if (ret != 0)
+			return ret;
+	}
+
+	ret = no_os_spi_remove(device->spi_desc);
+	if (ret != 0)
+		return ret;
+
+	free(device);
+
+	return 0;
 }
@@ -49,6 +49,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "no_os_spi.h"
+#include "no_os_crc.h"
 
 /******************************************************************************/
 /* ADAS1000 SPI Registers Memory Map */
@@ -1005,6 +1006,7 @@
    10 = 2 frames missed
    11 = 3 or more frames missed */
 #define ADAS1000_FRAMES_OVERFLOW		            (1ul << 28)
+#define ADAS1000_FRAMES_OVERFLOW_MASK		      (0x00000003ul << 28)
 /* Internal device error detected.
    0 = normal operation
    1 = error condition	*/
@@ -1073,6 +1075,16 @@
 #define CRC_POLY_128KHZ				               0x00001021ul
 #define CRC_CHECK_CONST_128KHz			         0x00001D0Ful
 
+/******************************************************************************/
+/* ADAS1000 frame streaming */
+/******************************************************************************/
+/* Number of frame batches, one is read while the other one is transferred */
+#define ADAS1000_STREAM_BUFFERS			         2
+/* Number of lead data words, LA to V2 */
+#define ADAS1000_LEADS_NO			            5
+
+struct adas1000_stream;
+
 struct adas1000_dev {
 	/** SPI Descriptor */
 	struct no_os_spi_desc *spi_desc;
@@ -1082,6 +1094,18 @@ struct adas1000_dev {
 	uint32_t frame_rate;
 	/** Number of inactive words in a frame */
 	uint32_t inactive_words_no;
+	/** Words excluded from a frame, as set in the Frame Control Register */
+	uint32_t inactive_words;
+	/** CRC engine operations, NULL for the software engine */
+	const struct no_os_crc_platform_ops *crc_ops;
+	/** CRC engine for the polynomial of the frame rate */
+	struct no_os_crc_desc *crc_desc;
+	/** Frame streaming state, NULL when not streaming */
+	struct adas1000_stream *stream;
+	/** Frames missed while streaming, reported by the frame headers */
+	uint32_t frames_missed;
+	/** Frames discarded while streaming because of a wrong CRC */
+	uint32_t crc_errors;
 };
 
 struct adas1000_init_param {
@@ -1089,6 +1113,8 @@ struct adas1000_init_param {
 	struct no_os_spi_init_param spi_init;
 	/** ADAS1000 frame rate */
 	uint32_t frame_rate;
+	/** CRC engine operations, NULL for the software engine */
+	const struct no_os_crc_platform_ops *crc_ops;
 };
 
 struct read_param {
@@ -1146,4 +1172,26 @@ int32_t adas1000_read_data(struct adas1000_dev *device, uint8_t *data_buff,
 uint32_t adas1000_compute_frame_crc(struct adas1000_dev * device,
 				    uint8_t *buff);
 
+/* Starts streaming the frames in batches of batch_frames frames */
+int32_t adas1000_stream_start(struct adas1000_dev *device,
+			      uint32_t batch_frames);
+
+/* Gets the valid frames of the oldest batch not consumed yet */
+int32_t adas1000_stream_get_frames(struct adas1000_dev *device,
+				   uint8_t **frames, uint32_t *nb_frames);
+
+/* Marks frames returned by adas1000_stream_get_frames() as consumed */
+int32_t adas1000_stream_consume(struct adas1000_dev *device,
+				uint32_t nb_frames);
+
+/* Stops streaming the frames */
+int32_t adas1000_stream_stop(struct adas1000_dev *device);
+
+/* Gets the lead data words of a frame */
+uint32_t adas1000_unpack_frame(struct adas1000_dev *device,
+			       uint8_t *frame, uint32_t *leads);
+
+/* Frees the resources allocated by adas1000_init() */
+int32_t adas1000_remove(struct adas1000_dev *device);
+
 #endif /* _ADAS1000_H_ */
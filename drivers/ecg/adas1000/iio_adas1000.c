@@ -0,0 +1,278 @@
+/***************************************************************************//**
+ *   @file   iio_adas1000.c
+ *   @brief  Implementation of the ADAS1000 IIO driver.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <inttypes.h>
+#include "iio.h"
+#include "iio_adas1000.h"
+#include "adas1000.h"
+#include "no_os_util.h"
+#include "no_os_error.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Read the last data of a lead.
+ * @param device - Device driver descriptor.
+ * @param buf - Output buffer.
+ * @param len - Length of the output buffer.
+ * @param channel - IIO channel information.
+ * @param priv - Unused.
+ * @return Number of bytes printed in the output buffer, or negative error code.
+ */
+static int adas1000_iio_read_raw(void *device, char *buf, uint32_t len,
+				 const struct iio_ch_info *channel,
+				 intptr_t priv)
+{
+	struct adas1000_dev *dev = device;
+	uint32_t data;
+	int32_t ret;
+
+	/* The registers can't be read while the frames are streamed */
+	if (dev->stream)
+		return -EBUSY;
+
+	ret = adas1000_read(dev, ADAS1000_LADATA + channel->ch_num, &data);
+	if (ret != 0)
+		return ret;
+
+	return snprintf(buf, len, "%"PRIu32, data);
+}
+
+/**
+ * @brief Show the frame rate.
+ * @param device - Device driver descriptor.
+ * @param buf - Output buffer.
+ * @param len - Length of the output buffer.
+ * @param channel - Unused.
+ * @param priv - Unused.
+ * @return Number of bytes printed in the output buffer, or negative error code.
+ */
+static int adas1000_iio_get_sampling_freq(void *device, char *buf,
+		uint32_t len, const struct iio_ch_info *channel, intptr_t priv)
+{
+	struct adas1000_dev *dev = device;
+
+	if (dev->frame_rate == ADAS1000_31_25HZ_FRAME_RATE)
+		return snprintf(buf, len, "31.250000");
+
+	return snprintf(buf, len, "%"PRIu32, dev->frame_rate);
+}
+
+/**
+ * @brief Set the frame rate, to 2000, 16000 or 128000 Hz.
+ * @param device - Device driver descriptor.
+ * @param buf - Input buffer.
+ * @param len - Length of the input buffer.
+ * @param channel - Unused.
+ * @param priv - Unused.
+ * @return Length of the input buffer, or negative error code.
+ */
+static int adas1000_iio_set_sampling_freq(void *device, char *buf,
+		uint32_t len, const struct iio_ch_info *channel, intptr_t priv)
+{
+	struct adas1000_dev *dev = device;
+	uint32_t rate = no_os_str_to_uint32(buf);
+	int32_t ret;
+
+	if (dev->stream)
+		return -EBUSY;
+
+	if (rate != ADAS1000_2KHZ_FRAME_RATE &&
+	    rate != ADAS1000_16KHZ_FRAME_RATE &&
+	    rate != ADAS1000_128KHZ_FRAME_RATE)
+		return -EINVAL;
+
+	ret = adas1000_set_frame_rate(dev, rate);
+	if (ret != 0)
+		return ret;
+
+	return len;
+}
+
+/**
+ * @brief Show the streaming error counters: the frames missed, as reported by
+ * the frame headers, and the frames discarded because of a wrong CRC.
+ * @param device - Device driver descriptor.
+ * @param buf - Output buffer.
+ * @param len - Length of the output buffer.
+ * @param channel - Unused.
+ * @param priv - Unused.
+ * @return Number of bytes printed in the output buffer, or negative error code.
+ */
+static int adas1000_iio_get_stream_errors(void *device, char *buf,
+		uint32_t len, const struct iio_ch_info *channel, intptr_t priv)
+{
+	struct adas1000_dev *dev = device;
+
+	return snprintf(buf, len,
+			"frames_missed %"PRIu32"\ncrc_errors %"PRIu32,
+			dev->frames_missed, dev->crc_errors);
+}
+
+/**
+ * @brief Start streaming the frames.
+ * @param device - Device driver descriptor.
+ * @param mask - Mask of the active channels.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t adas1000_iio_pre_enable(void *device, uint32_t mask)
+{
+	return adas1000_stream_start(device, ADAS1000_IIO_BATCH_FRAMES);
+}
+
+/**
+ * @brief Stop streaming the frames.
+ * @param device - Device driver descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t adas1000_iio_post_disable(void *device)
+{
+	return adas1000_stream_stop(device);
+}
+
+/**
+ * @brief Fill the buffer with the lead data of the streamed frames.
+ * @param dev_data - IIO device data.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t adas1000_iio_submit(struct iio_device_data *dev_data)
+{
+	struct adas1000_dev *dev = dev_data->dev;
+	struct iio_buffer *buffer = dev_data->buffer;
+	uint32_t leads[ADAS1000_LEADS_NO] = {0};
+	uint32_t nb_scans = buffer->size / buffer->bytes_per_scan;
+	uint32_t nb_frames, i;
+	uint8_t *frames;
+	int32_t ret;
+
+	while (nb_scans) {
+		ret = adas1000_stream_get_frames(dev, &frames, &nb_frames);
+		if (ret == -EAGAIN)
+			continue;
+		if (ret != 0)
+			return ret;
+
+		nb_frames = no_os_min(nb_frames, nb_scans);
+		for (i = 0; i < nb_frames; i++) {
+			adas1000_unpack_frame(dev, frames + i * dev->frame_size,
+					      leads);
+			ret = iio_buffer_push_samples(buffer, leads,
+						      sizeof(*leads));
+			if (ret != 0)
+				return ret;
+		}
+
+		ret = adas1000_stream_consume(dev, nb_frames);
+		if (ret != 0)
+			return ret;
+
+		nb_scans -= nb_frames;
+	}
+
+	return 0;
+}
+
+/** IIO channel attributes */
+static struct iio_attribute adas1000_iio_channel_attributes[] = {
+	{
+		.name = "raw",
+		.show = adas1000_iio_read_raw,
+	},
+	END_ATTRIBUTES_ARRAY,
+};
+
+/** Lead data, 24 bits in the low bits of the frame words */
+static struct scan_type adas1000_iio_scan_type = {
+	.sign = 'u',
+	.realbits = 24,
+	.storagebits = 32,
+	.shift = 0,
+	.is_big_endian = false
+};
+
+#define ADAS1000_IIO_CHANN_DEF(nm, ch) \
+	{ \
+		.name = nm, \
+		.ch_type = IIO_VOLTAGE, \
+		.channel = ch, \
+		.scan_type = &adas1000_iio_scan_type, \
+		.scan_index = ch, \
+		.attributes = adas1000_iio_channel_attributes, \
+		.ch_out = false, \
+		.indexed = 1, \
+	}
+
+/** IIO channels, in the order of the lead data words */
+static struct iio_channel adas1000_iio_channels[] = {
+	ADAS1000_IIO_CHANN_DEF("la", 0),
+	ADAS1000_IIO_CHANN_DEF("ll", 1),
+	ADAS1000_IIO_CHANN_DEF("ra", 2),
+	ADAS1000_IIO_CHANN_DEF("v1", 3),
+	ADAS1000_IIO_CHANN_DEF("v2", 4),
+};
+
+/** IIO attributes */
+static struct iio_attribute adas1000_iio_attributes[] = {
+	{
+		.name = "sampling_frequency",
+		.show = adas1000_iio_get_sampling_freq,
+		.store = adas1000_iio_set_sampling_freq,
+	},
+	{
+		.name = "stream_errors",
+		.show = adas1000_iio_get_stream_errors,
+	},
+	END_ATTRIBUTES_ARRAY,
+};
+
+/** IIO Descriptor */
+struct iio_device const adas1000_iio_descriptor = {
+	.num_ch = NO_OS_ARRAY_SIZE(adas1000_iio_channels),
+	.channels = adas1000_iio_channels,
+	.attributes = adas1000_iio_attributes,
+	.pre_enable = adas1000_iio_pre_enable,
+	.post_disable = adas1000_iio_post_disable,
+	.submit = adas1000_iio_submit,
+};
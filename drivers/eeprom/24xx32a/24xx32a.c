@@ -87,6 +87,7 @@ int32_t eeprom_24xx32a_init(struct no_os_eeprom_desc **desc,
 	}
 
 	eeprom_init_param = param->extra;
+	eeprom_dev->write_back = eeprom_init_param->write_back;
 	ret = no_os_i2c_init(&eeprom_dev->i2c_desc, eeprom_init_param->i2c_init);
 	if (ret)
 		goto error_eeprom_init;
@@ -104,6 +105,119 @@ error_eeprom_dev:
 	return ret;
 }
 
+/**
+ * @brief Send a write transaction, polling the acknowledge of the device.
+ *
+ * The device does not acknowledge its address while it is busy with a write
+ * cycle, so instead of waiting the worst case write time after each write,
+ * the transaction is retried until it goes through.
+ * @param dev - 24XX32A device
+ * @param buff - Address bytes, followed by the data for a write
+ * @param bytes - Number of bytes in buff
+ * @param stop_bit - End the transaction, 0 to continue with a read
+ * @return 0 in case of success, negative error code otherwise
+ */
+static int32_t eeprom_24xx32a_send(struct eeprom_24xx32a_dev *dev,
+				   uint8_t *buff, uint8_t bytes,
+				   uint8_t stop_bit)
+{
+	uint32_t tries = EEPROM_24XX32A_WRITE_TIME_US / EEPROM_24XX32A_POLL_US;
+	int32_t ret;
+
+	while (1) {
+		ret = no_os_i2c_write(dev->i2c_desc, buff, bytes, stop_bit);
+		if (!ret || !tries--)
+			return ret;
+
+		no_os_udelay(EEPROM_24XX32A_POLL_US);
+	}
+}
+
+/**
+ * @brief Read the memory with a single sequential read.
+ * @param dev - 24XX32A device
+ * @param address - EEPROM address/location to read
+ * @param data - EEPROM data (pointer)
+ * @param bytes - Number of data bytes to read
+ * @return 0 in case of success, negative error code otherwise
+ */
+static int32_t eeprom_24xx32a_read_mem(struct eeprom_24xx32a_dev *dev,
+				       uint32_t address, uint8_t *data,
+				       uint16_t bytes)
+{
+	int32_t ret;
+	uint8_t buff[2];
+
+	no_os_put_unaligned_be16(address, buff);
+
+	ret = eeprom_24xx32a_send(dev, buff, sizeof(buff), 0);
+	if (ret)
+		return ret;
+
+	return no_os_i2c_read(dev->i2c_desc, data, bytes, 1);
+}
+
+/**
+ * @brief Write the cached page to the memory, if it was modified.
+ * @param dev - 24XX32A device
+ * @return 0 in case of success, negative error code otherwise
+ */
+static int32_t eeprom_24xx32a_cache_commit(struct eeprom_24xx32a_dev *dev)
+{
+	int32_t ret;
+
+	if (!dev->cache_dirty)
+		return 0;
+
+	no_os_put_unaligned_be16(dev->cache_page, dev->cache);
+	ret = eeprom_24xx32a_send(dev, dev->cache, sizeof(dev->cache), 1);
+	if (ret)
+		return ret;
+
+	dev->cache_dirty = false;
+
+	return 0;
+}
+
+/**
+ * @brief Update a part of a page in the write-back cache.
+ * @param dev - 24XX32A device
+ * @param address - EEPROM address/location to write
+ * @param data - EEPROM data (pointer)
+ * @param bytes - Number of bytes, not crossing the page boundary
+ * @return 0 in case of success, negative error code otherwise
+ */
+static int32_t eeprom_24xx32a_cache_write(struct eeprom_24xx32a_dev *dev,
+		uint32_t address, uint8_t *data, uint16_t bytes)
+{
+	uint32_t page = address & ~(EEPROM_24XX32A_PAGE_SIZE - 1);
+	int32_t ret;
+
+	if (!dev->cache_valid || dev->cache_page != page) {
+		ret = eeprom_24xx32a_cache_commit(dev);
+		if (ret)
+			return ret;
+
+		dev->cache_valid = false;
+
+		/* A full page is overwritten, no need to fetch it */
+		if (bytes != EEPROM_24XX32A_PAGE_SIZE) {
+			ret = eeprom_24xx32a_read_mem(dev, page, &dev->cache[2],
+						      EEPROM_24XX32A_PAGE_SIZE);
+			if (ret)
+				return ret;
+		}
+
+		dev->cache_page = page;
+		dev->cache_valid = true;
+	}
+
+	memcpy(&dev->cache[2 + address - page], data, bytes);
+	dev->cache_dirty = true;
+
+	return 0;
+}
+
 /**
  * @brief 	Read the 24XX32A EEPROM data
  * @param	desc - EEPROM descriptor
@@ -116,36 +230,45 @@ int32_t eeprom_24xx32a_read(struct no_os_eeprom_desc *desc, uint32_t address,
 			    uint8_t *data, uint16_t bytes)
 {
 	int32_t ret;
-	uint16_t indx;
-	uint8_t buff[2];
-	uint32_t curr_address = address;
+	uint32_t start, end;
 	struct eeprom_24xx32a_dev *eeprom_dev;
 
 	if (!desc || !desc->extra || !data)
 		return -EINVAL;
 
-	eeprom_dev = desc->extra;
+	if (address + bytes > EEPROM_24XX32A_SIZE)
+		return -EINVAL;
 
-	/* Perform byte by byte read */
-	for (indx = 0; indx < bytes; indx++) {
-		no_os_put_unaligned_be16(curr_address, buff);
+	if (!bytes)
+		return 0;
 
-		ret = no_os_i2c_write(eeprom_dev->i2c_desc, buff, sizeof(buff), 0);
-		if (ret)
-			return ret;
+	eeprom_dev = desc->extra;
 
-		ret = no_os_i2c_read(eeprom_dev->i2c_desc, &data[indx], 1, 1);
-		if (ret)
-			return ret;
+	ret = eeprom_24xx32a_read_mem(eeprom_dev, address, data, bytes);
+	if (ret)
+		return ret;
 
-		curr_address++;
-	}
+	if (!eeprom_dev->cache_valid)
+		return 0;
+
+	/* The cached page may be newer than the memory */
+	start = no_os_max(address, eeprom_dev->cache_page);
+	end = no_os_min(address + bytes,
+			eeprom_dev->cache_page + EEPROM_24XX32A_PAGE_SIZE);
+	if (start < end)
+		memcpy(&data[start - address],
+		       &eeprom_dev->cache[2 + start - eeprom_dev->cache_page],
+		       end - start);
 
 	return 0;
 }
 
 /**
  * @brief 	Write the 24XX32A EEPROM data
+ *
+ * The data is split on the page boundaries and each part is written in one
+ * page write. The function returns while the last write cycle is ongoing,
+ * the next access waits for it by acknowledge polling.
  * @param	desc - EEPROM descriptor
  * @param	address - EEPROM address/location to write
  * @param	data - EEPROM data (pointer)
@@ -156,34 +279,69 @@ int32_t eeprom_24xx32a_write(struct no_os_eeprom_desc *desc, uint32_t address,
 			     uint8_t *data, uint16_t bytes)
 {
 	int32_t ret;
-	uint16_t indx;
-	uint8_t buff[3];
-	uint32_t curr_address = address;
+	uint16_t len;
+	uint8_t buff[2 + EEPROM_24XX32A_PAGE_SIZE];
 	struct eeprom_24xx32a_dev *eeprom_dev;
 
 	if (!desc || !desc->extra || !data)
 		return -EINVAL;
 
-	eeprom_dev = desc->extra;
+	if (address + bytes > EEPROM_24XX32A_SIZE)
+		return -EINVAL;
 
-	/* Perform byte by byte write */
-	for (indx = 0; indx < bytes; indx++) {
-		no_os_put_unaligned_be16(curr_address, buff);
-		buff[2] = data[indx];
+	eeprom_dev = desc->extra;
 
-		ret = no_os_i2c_write(eeprom_dev->i2c_desc, buff, sizeof(buff), 1);
+	while (bytes) {
+		/* Up to the end of the page, the address wraps around on it */
+		len = EEPROM_24XX32A_PAGE_SIZE -
+		      (address & (EEPROM_24XX32A_PAGE_SIZE - 1));
+		if (len > bytes)
+			len = bytes;
+
+		if (eeprom_dev->write_back) {
+			ret = eeprom_24xx32a_cache_write(eeprom_dev, address,
+							 data, len);
+		} else {
+			no_os_put_unaligned_be16(address, buff);
+			memcpy(&buff[2], data, len);
+			ret = eeprom_24xx32a_send(eeprom_dev, buff, 2 + len, 1);
+		}
 		if (ret)
 			return ret;
 
-		/* Write cycle time (typ 5msec as per datasheet) */
-		no_os_mdelay(5);
-
-		curr_address++;
+		address += len;
+		data += len;
+		bytes -= len;
 	}
 
 	return 0;
 }
 
+/**
+ * @brief Write the data held in the cache and wait for the end of the write
+ * cycle, after which the device can be powered off.
+ * @param desc - EEPROM descriptor
+ * @return 0 in case of success, negative error code otherwise
+ */
+int32_t eeprom_24xx32a_flush(struct no_os_eeprom_desc *desc)
+{
+	struct eeprom_24xx32a_dev *eeprom_dev;
+	uint8_t buff[2] = {0};
+	int32_t ret;
+
+	if (!desc || !desc->extra)
+		return -EINVAL;
+
+	eeprom_dev = desc->extra;
+
+	ret = eeprom_24xx32a_cache_commit(eeprom_dev);
+	if (ret)
+		return ret;
+
+	/* Only sets the address pointer, once the device answers */
+	return eeprom_24xx32a_send(eeprom_dev, buff, sizeof(buff), 1);
+}
+
 /**
  * @brief Free the resources allocated by eeprom_24xx32a_init()
  * @param desc - EEPROM descriptor
@@ -199,6 +357,10 @@ int32_t eeprom_24xx32a_remove(struct no_os_eeprom_desc *desc)
 
 	eeprom_dev = desc->extra;
 
+	ret = eeprom_24xx32a_flush(desc);
+	if (ret)
+		return ret;
+
 	/* Free the I2C descriptor */
 	ret = no_os_i2c_remove(eeprom_dev->i2c_desc);
 	if (ret)
@@ -219,4 +381,5 @@ const struct no_os_eeprom_platform_ops eeprom_24xx32a_ops = {
 	.read = &eeprom_24xx32a_read,
 	.write = &eeprom_24xx32a_write,
 	.remove = &eeprom_24xx32a_remove,
+	.flush = &eeprom_24xx32a_flush,
 };
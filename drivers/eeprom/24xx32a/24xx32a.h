@@ -45,8 +45,22 @@
 /******************************************************************************/
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "no_os_i2c.h"
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Memory size and write page size, in bytes */
+#define EEPROM_24XX32A_SIZE		4096U
+#define EEPROM_24XX32A_PAGE_SIZE	32U
+
+/* Maximum write cycle time (5msec as per datasheet) */
+#define EEPROM_24XX32A_WRITE_TIME_US	5000U
+/* Interval between two polls of the device while it is busy writing */
+#define EEPROM_24XX32A_POLL_US		50U
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -58,6 +72,12 @@
 struct eeprom_24xx32a_init_param {
 	/** I2C initialization parameters */
 	struct no_os_i2c_init_param *i2c_init;
+	/**
+	 * Hold the writes in a one page RAM cache, written to the EEPROM when
+	 * another page is accessed or on no_os_eeprom_flush(). Small writes to
+	 * the same page then cost a single write cycle.
+	 */
+	bool write_back;
 };
 
 /**
@@ -67,6 +87,16 @@ struct eeprom_24xx32a_init_param {
 struct eeprom_24xx32a_dev {
 	/** I2C descriptor*/
 	struct no_os_i2c_desc *i2c_desc;
+	/** Write-back cache enabled */
+	bool write_back;
+	/** The cache holds the data of cache_page */
+	bool cache_valid;
+	/** The cache holds data not written to the EEPROM yet */
+	bool cache_dirty;
+	/** Address of the cached page */
+	uint32_t cache_page;
+	/** Address bytes followed by the cached page, sent as it is */
+	uint8_t cache[2 + EEPROM_24XX32A_PAGE_SIZE];
 };
 
 /**
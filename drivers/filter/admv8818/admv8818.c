@@ -41,6 +41,7 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <malloc.h>
+#include <stdlib.h>
 #include "admv8818.h"
 #include "no_os_error.h"
 
@@ -135,25 +136,25 @@ int admv8818_spi_update_bits(struct admv8818_dev *dev, uint8_t reg_addr,
 }
 
 /**
- * @brief Set the HPF Frequency.
- * @param dev - The device structure.
- * @param freq - The HPF Frequency to be set.
- * @return Returns 0 in case of success or negative error code.
+ * @brief Compute the closest HPF band and state for a frequency.
+ * @param freq - The HPF Frequency.
+ * @param band - The HPF band, 0 for bypass.
+ * @param state - The HPF state in the band.
  */
-int admv8818_hpf_select(struct admv8818_dev *dev, unsigned long long freq)
+static void admv8818_hpf_code(unsigned long long freq, unsigned int *band,
+			      unsigned int *state)
 {
 	unsigned int hpf_step = 0, hpf_band = 0, i, j;
 	unsigned long long freq_step;
-	int ret;
 
 	if (freq < freq_range_hpf[0][0])
-		goto hpf_write;
+		goto hpf_out;
 
 	if (freq > freq_range_hpf[3][1]) {
 		hpf_step = 15;
 		hpf_band = 4;
 
-		goto hpf_write;
+		goto hpf_out;
 	}
 
 	/* Find and compute the closest HPF band and state relative to the input frequency */
@@ -180,7 +181,24 @@ int admv8818_hpf_select(struct admv8818_dev *dev, unsigned long long freq)
 		hpf_step = 15;
 	}
 
-hpf_write:
+hpf_out:
+	*band = hpf_band;
+	*state = hpf_step;
+}
+
+/**
+ * @brief Set the HPF Frequency.
+ * @param dev - The device structure.
+ * @param freq - The HPF Frequency to be set.
+ * @return Returns 0 in case of success or negative error code.
+ */
+int admv8818_hpf_select(struct admv8818_dev *dev, unsigned long long freq)
+{
+	unsigned int hpf_step, hpf_band;
+	int ret;
+
+	admv8818_hpf_code(freq, &hpf_band, &hpf_step);
+
 	ret = admv8818_spi_update_bits(dev, ADMV8818_REG_WR0_SW,
 				       ADMV8818_SW_IN_SET_WR0_MSK |
 				       ADMV8818_SW_IN_WR0_MSK,
@@ -231,24 +249,24 @@ int admv8818_read_hpf_freq(struct admv8818_dev *dev, unsigned long long *freq)
 }
 
 /**
- * @brief Set the LPF Frequency.
- * @param dev - The device structure.
- * @param freq - The LPF Frequency to be set.
- * @return Returns 0 in case of success or negative error code.
+ * @brief Compute the closest LPF band and state for a frequency.
+ * @param freq - The LPF Frequency.
+ * @param band - The LPF band, 0 for bypass.
+ * @param state - The LPF state in the band.
  */
-int admv8818_lpf_select(struct admv8818_dev *dev, unsigned long long freq)
+static void admv8818_lpf_code(unsigned long long freq, unsigned int *band,
+			      unsigned int *state)
 {
 	unsigned int lpf_step = 0, lpf_band = 0, i, j;
 	unsigned long long freq_step;
-	int ret;
 
 	if (freq > freq_range_lpf[3][1])
-		goto lpf_write;
+		goto lpf_out;
 
 	if (freq < freq_range_lpf[0][0]) {
 		lpf_band = 1;
 
-		goto lpf_write;
+		goto lpf_out;
 	}
 
 	/* Find and compute the closest LPF band and state relative to the input frequency */
@@ -267,7 +285,24 @@ int admv8818_lpf_select(struct admv8818_dev *dev, unsigned long long freq)
 		}
 	}
 
-lpf_write:
+lpf_out:
+	*band = lpf_band;
+	*state = lpf_step;
+}
+
+/**
+ * @brief Set the LPF Frequency.
+ * @param dev - The device structure.
+ * @param freq - The LPF Frequency to be set.
+ * @return Returns 0 in case of success or negative error code.
+ */
+int admv8818_lpf_select(struct admv8818_dev *dev, unsigned long long freq)
+{
+	unsigned int lpf_step, lpf_band;
+	int ret;
+
+	admv8818_lpf_code(freq, &lpf_band, &lpf_step);
+
 	ret = admv8818_spi_update_bits(dev, ADMV8818_REG_WR0_SW,
 				       ADMV8818_SW_OUT_SET_WR0_MSK |
 				       ADMV8818_SW_OUT_WR0_MSK,
@@ -318,19 +353,196 @@ int admv8818_read_lpf_freq(struct admv8818_dev *dev, unsigned long long *freq)
 }
 
 /**
- * @brief Set the RF Input Band Select.
+ * @brief Compute the switch and filter registers for a frequency.
+ * @param freq - The RF Frequency.
+ * @param lut - The entry to fill, freq is not set.
+ */
+static void admv8818_lut_code(unsigned long long freq,
+			      struct admv8818_lut_entry *lut)
+{
+	unsigned int hpf_band, hpf_state, lpf_band, lpf_state;
+
+	admv8818_hpf_code(freq, &hpf_band, &hpf_state);
+	admv8818_lpf_code(freq, &lpf_band, &lpf_state);
+
+	lut->sw = no_os_field_prep(ADMV8818_SW_IN_SET_WR0_MSK, 1) |
+		  no_os_field_prep(ADMV8818_SW_OUT_SET_WR0_MSK, 1) |
+		  no_os_field_prep(ADMV8818_SW_IN_WR0_MSK, hpf_band) |
+		  no_os_field_prep(ADMV8818_SW_OUT_WR0_MSK, lpf_band);
+	lut->filter = no_os_field_prep(ADMV8818_HPF_WR0_MSK, hpf_state) |
+		      no_os_field_prep(ADMV8818_LPF_WR0_MSK, lpf_state);
+}
+
+/**
+ * @brief Compare two frequencies, for qsort.
+ */
+static int admv8818_freq_cmp(const void *a, const void *b)
+{
+	unsigned long long fa = *(const unsigned long long *)a;
+	unsigned long long fb = *(const unsigned long long *)b;
+
+	return (fa > fb) - (fa < fb);
+}
+
+/**
+ * @brief Add a threshold the band and state selection compares to, and the
+ * frequency right after it.
+ * @param points - The frequencies.
+ * @param n - Number of frequencies, updated.
+ * @param freq - The threshold.
+ */
+static void admv8818_lut_add(unsigned long long *points, unsigned int *n,
+			     unsigned long long freq)
+{
+	points[(*n)++] = freq;
+	points[(*n)++] = freq + 1;
+}
+
+/**
+ * @brief Build the table of the register values by frequency. The selection
+ * only changes at its thresholds, so evaluating it at each threshold and the
+ * frequency after it gives the values for any frequency up to the next one.
+ * Consecutive frequencies with the same values are merged.
  * @param dev - The device structure.
  * @return Returns 0 in case of success or negative error code.
  */
-int admv8818_rfin_select(struct admv8818_dev *dev)
+static int admv8818_lut_build(struct admv8818_dev *dev)
+{
+	struct admv8818_lut_entry entry;
+	unsigned long long freq_step;
+	unsigned long long *points;
+	unsigned int n = 0, i, j;
+
+	points = calloc(ADMV8818_LUT_MAX_POINTS, sizeof(*points));
+	if (!points)
+		return -ENOMEM;
+
+	points[n++] = 0;
+
+	admv8818_lut_add(points, &n, 12000000000);
+	admv8818_lut_add(points, &n, 12500000000);
+	admv8818_lut_add(points, &n, freq_range_hpf[3][1]);
+	admv8818_lut_add(points, &n, freq_range_lpf[3][1]);
+
+	for (i = 0; i < 4; i++) {
+		freq_step = (freq_range_hpf[i][1] - freq_range_hpf[i][0]) / 15;
+		admv8818_lut_add(points, &n, freq_range_hpf[i][1] + freq_step);
+		for (j = 0; j <= 16; j++)
+			admv8818_lut_add(points, &n,
+					 freq_range_hpf[i][0] + freq_step * j);
+
+		freq_step = (freq_range_lpf[i][1] - freq_range_lpf[i][0]) / 15;
+		admv8818_lut_add(points, &n, freq_range_lpf[i][1]);
+		for (j = 0; j <= 15; j++)
+			admv8818_lut_add(points, &n,
+					 freq_range_lpf[i][0] + freq_step * j);
+	}
+
+	qsort(points, n, sizeof(points[0]), admv8818_freq_cmp);
+
+	dev->lut = calloc(n, sizeof(*dev->lut));
+	if (!dev->lut) {
+		free(points);
+		return -ENOMEM;
+	}
+
+	dev->lut_size = 0;
+	for (i = 0; i < n; i++) {
+		admv8818_lut_code(points[i], &entry);
+		if (dev->lut_size &&
+		    dev->lut[dev->lut_size - 1].sw == entry.sw &&
+		    dev->lut[dev->lut_size - 1].filter == entry.filter)
+			continue;
+
+		entry.freq = points[i];
+		dev->lut[dev->lut_size++] = entry;
+	}
+
+	free(points);
+
+	return 0;
+}
+
+/**
+ * @brief Find the register values of a frequency in the table.
+ * @param dev - The device structure.
+ * @param freq - The RF Frequency.
+ * @return The entry holding the register values.
+ */
+static const struct admv8818_lut_entry *
+admv8818_lut_find(struct admv8818_dev *dev, unsigned long long freq)
 {
+	uint32_t lo = 0, hi = dev->lut_size - 1, mid;
+
+	/* Last entry starting at or below freq, the first one starts at 0 */
+	while (lo < hi) {
+		mid = (lo + hi + 1) / 2;
+		if (dev->lut[mid].freq <= freq)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+
+	return &dev->lut[lo];
+}
+
+/**
+ * @brief Set the HPF, LPF and switches for an RF frequency. The register
+ * values come from the table built at init and both registers are written in
+ * a single SPI transfer, without reading them back.
+ * @param dev - The device structure.
+ * @param freq - The RF Frequency.
+ * @return Returns 0 in case of success or negative error code.
+ */
+int admv8818_filter_select(struct admv8818_dev *dev, unsigned long long freq)
+{
+	const struct admv8818_lut_entry *lut;
+	struct admv8818_lut_entry code;
+	uint8_t sw[ADMV8818_BUFF_SIZE_BYTES];
+	uint8_t filter[ADMV8818_BUFF_SIZE_BYTES];
+	struct no_os_spi_msg msgs[] = {
+		{
+			.tx_buff = sw,
+			.bytes_number = ADMV8818_BUFF_SIZE_BYTES,
+			.cs_change = 1,
+		},
+		{
+			.tx_buff = filter,
+			.bytes_number = ADMV8818_BUFF_SIZE_BYTES,
+			.cs_change = 1,
+		},
+	};
 	int ret;
 
-	ret = admv8818_hpf_select(dev, dev->rf_in);
+	if (dev->lut) {
+		lut = admv8818_lut_find(dev, freq);
+	} else {
+		admv8818_lut_code(freq, &code);
+		lut = &code;
+	}
+
+	sw[0] = ADMV8818_REG_WR0_SW;
+	sw[1] = lut->sw;
+	filter[0] = ADMV8818_REG_WR0_FILTER;
+	filter[1] = lut->filter;
+
+	ret = no_os_spi_transfer(dev->spi_desc, msgs, NO_OS_ARRAY_SIZE(msgs));
 	if (ret)
 		return ret;
 
-	return admv8818_lpf_select(dev, dev->rf_in);
+	dev->rf_in = freq;
+
+	return 0;
+}
+
+/**
+ * @brief Set the RF Input Band Select.
+ * @param dev - The device structure.
+ * @return Returns 0 in case of success or negative error code.
+ */
+int admv8818_rfin_select(struct admv8818_dev *dev)
+{
+	return admv8818_filter_select(dev, dev->rf_in);
 }
 
 /**
@@ -354,10 +566,14 @@ int admv8818_init(struct admv8818_dev **device,
 	dev->mode = init_param->mode;
 
 	/* SPI */
-	ret = no_os_spi_init(&dev->spi_desc, init_param->spi_init);
+	ret = admv8818_lut_build(dev);
 	if (ret)
 		goto error_dev;
 
+	ret = no_os_spi_init(&dev->spi_desc, init_param->spi_init);
+	if (ret)
+		goto error_lut;
+
 	ret = admv8818_spi_update_bits(dev, ADMV8818_REG_SPI_CONFIG_A,
 				       ADMV8818_SOFTRESET_N_MSK |
 				       ADMV8818_SOFTRESET_MSK,
@@ -402,6 +618,8 @@ int admv8818_init(struct admv8818_dev **device,
 
 error_spi:
 	no_os_spi_remove(dev->spi_desc);
+error_lut:
+	free(dev->lut);
 error_dev:
 	free(dev);
 
@@ -421,6 +639,7 @@ int admv8818_remove(struct admv8818_dev *dev)
 	if (ret)
 		return ret;
 
+	free(dev->lut);
 	free(dev);
 
 	return 0;
@@ -108,6 +108,9 @@
 #define ADMV8818_CHIP_ID			NO_OS_BIT(0)
 #define ADMV8818_SPI_READ_CMD			NO_OS_BIT(7)
 
+/* Frequencies the register values table is built from */
+#define ADMV8818_LUT_MAX_POINTS			300
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -134,6 +137,19 @@ struct admv8818_init_param {
 	enum admv8818_filter_mode	mode;
 };
 
+/**
+ * @struct admv8818_lut_entry
+ * @brief Register values from freq up to the freq of the next entry.
+ */
+struct admv8818_lut_entry {
+	/** Lowest RF Frequency of the entry */
+	unsigned long long		freq;
+	/** ADMV8818_REG_WR0_SW value */
+	uint8_t				sw;
+	/** ADMV8818_REG_WR0_FILTER value */
+	uint8_t				filter;
+};
+
 /**
  * @struct admv8818_dev
  * @brief ADMV8818 Device Descriptor.
@@ -145,6 +161,10 @@ struct admv8818_dev {
 	unsigned long long		rf_in;
 	/* Filter Mode */
 	enum admv8818_filter_mode	mode;
+	/** Register values by frequency, sorted by frequency */
+	struct admv8818_lut_entry	*lut;
+	/** Number of entries in lut */
+	uint32_t			lut_size;
 };
 
 /** ADMV8818 SPI write */
@@ -171,6 +191,9 @@ int admv8818_lpf_select(struct admv8818_dev *dev, unsigned long long freq);
 /** Get the LPF Frequency */
 int admv8818_read_lpf_freq(struct admv8818_dev *dev, unsigned long long *freq);
 
+/** Set the HPF, LPF and switches for an RF Frequency */
+int admv8818_filter_select(struct admv8818_dev *dev, unsigned long long freq);
+
 /** Set the RF Input Band Select */
 int admv8818_rfin_select(struct admv8818_dev *dev);
 
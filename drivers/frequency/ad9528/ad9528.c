@@ -373,6 +373,8 @@ int32_t ad9528_setup(struct ad9528_dev **device,
 		return -1;
 
 	dev->pdata = init_param.pdata;
+	dev->staged_mask = 0;
+	dev->staged_sysref = false;
 
 	/* SPI */
 	ret = no_os_spi_init(&dev->spi_desc, &init_param.spi_init);
@@ -783,7 +785,10 @@ uint32_t ad9528_clk_round_rate(struct ad9528_dev *dev, uint32_t chan,
 }
 
 /***************************************************************************//**
- * @brief Set channel rate.
+ * @brief Stage a channel rate change. The new divider is only stored in the
+ *        platform data, ad9528_clk_commit() writes all the staged dividers at
+ *        once. A SYSREF sourced channel stages the SYSREF K divider, which is
+ *        shared by all the SYSREF sourced channels.
  *
  * @param dev - is a pointer to the ad9528_dev data structure.
  * @param chan - Channel number.
@@ -791,83 +796,144 @@ uint32_t ad9528_clk_round_rate(struct ad9528_dev *dev, uint32_t chan,
  *
  * @return 0 in case of success, negative error code otherwise.
  *******************************************************************************/
-int32_t ad9528_clk_set_rate(struct ad9528_dev *dev, uint32_t chan,
-			    uint32_t rate)
+int32_t ad9528_clk_stage_rate(struct ad9528_dev *dev, uint32_t chan,
+			      uint32_t rate)
 {
-	uint32_t div;
-	int32_t ret;
-	uint32_t reg;
 	uint32_t signal_source;
+	uint32_t freq;
+	uint32_t div;
 
 	if (chan >= dev->pdata->num_channels)
 		return -1;
 
 	signal_source = dev->pdata->channels[chan].signal_source;
 
-	// if the channel has VCO as source then operate on the channel divider
 	if (signal_source == AD9528_VCO) {
-		div = ad9528_calc_out_div(rate, dev->ad9528_st.vco_out_freq[signal_source]);
+		freq = dev->ad9528_st.vco_out_freq[signal_source];
+		div = ad9528_calc_out_div(rate, freq);
 		dev->pdata->channels[chan].channel_divider = div;
-
-		// make a copy of the channel control register.
-		ret = ad9528_spi_read_n(dev,
-					AD9528_CHANNEL_OUTPUT(chan),
-					&reg);
-
-		if (ret < 0)
-			return ret;
-
-		// set the divide ratio bits.
-		uint32_t divmask = AD9528_CLK_DIST_DIV(0xFF + 1);
-
-		// clear those bits in the channel register copy.
-		reg &= ~divmask;
-
-		// apply the new channel divider to the register copy.
-		reg |= AD9528_CLK_DIST_DIV(dev->pdata->channels[chan].channel_divider);
-
-		// apply the new channel divider to hardware.
-		ret = ad9528_spi_write_n(dev,
-					 AD9528_CHANNEL_OUTPUT(dev->pdata->channels[chan].channel_num),
-					 reg);
-		if (ret < 0)
-			return ret;
-	}
-	// if the channel has SYSREF as source then operate on the sysref K divider
-	// note that this affects all other SYSREF sourced channels
-	else if (signal_source == AD9528_SYSREF) {
+		dev->staged_mask |= NO_OS_BIT(chan);
+	} else if (signal_source == AD9528_SYSREF) {
 		// SYSREF Generator is sourced from VCXO with a fixed divider of 2 and a K divider
 		div = NO_OS_DIV_ROUND_CLOSEST(dev->ad9528_st.vco_out_freq[AD9528_VCXO] / 2,
 					      rate);
-
 		div = no_os_clamp_t(unsigned int,
 				    div,
 				    AD9528_SYSREF_K_DIV_MIN,
 				    AD9528_SYSREF_K_DIV_MAX);
-
-		// apply the new K divider to hardware.
-		reg = div;
-		ret = ad9528_spi_write_n(dev,
-					 AD9528_SYSREF_K_DIVIDER,
-					 reg);
-
-		if(ret < 0)
-			return ret;
-		else {
-			dev->pdata->sysref_k_div = div;
-			dev->ad9528_st.vco_out_freq[AD9528_SYSREF] =
-				dev->ad9528_st.vco_out_freq[AD9528_VCXO] / 2 / div;
-		}
+		dev->pdata->sysref_k_div = div;
+		dev->staged_sysref = true;
 	} else {
 		// oops, it seems channels were misconfigured.
 		return -2;
 	}
 
-	ret = ad9528_io_update(dev);
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Fill a single byte write frame.
+ *
+ * @param buf - The 3 bytes of the frame.
+ * @param addr - The register byte address.
+ * @param val - The register byte value.
+ *******************************************************************************/
+static void ad9528_write_frame(uint8_t *buf, uint32_t addr, uint8_t val)
+{
+	buf[0] = AD9528_WRITE | (addr >> 8);
+	buf[1] = addr & 0xFF;
+	buf[2] = val;
+}
+
+/***************************************************************************//**
+ * @brief Write all the staged dividers and the IO update in a single SPI
+ *        transfer, so the new dividers take effect at the same time.
+ *
+ * Only the divide ratio byte of the channel output registers is written, the
+ * other fields are left untouched without reading them back.
+ *
+ * @param dev - is a pointer to the ad9528_dev data structure.
+ * @param sync - Issue a channel SYNC after the update, realigning the outputs.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ *******************************************************************************/
+int32_t ad9528_clk_commit(struct ad9528_dev *dev, bool sync)
+{
+	/* One frame per channel, two for the K divider and the IO update */
+	struct no_os_spi_msg msgs[AD9528_NUM_CHAN + 3];
+	uint8_t buf[AD9528_NUM_CHAN + 3][3];
+	struct ad9528_channel_spec *chan;
+	uint32_t addr, div, i, n = 0;
+	uint16_t k_div;
+	int32_t ret;
+
+	if (!dev->staged_mask && !dev->staged_sysref)
+		return sync ? ad9528_sync(dev) : 0;
+
+	for (i = 0; i < dev->pdata->num_channels && n < AD9528_NUM_CHAN; i++) {
+		if (!(dev->staged_mask & NO_OS_BIT(i)))
+			continue;
+
+		chan = &dev->pdata->channels[i];
+		/* The divide ratio is the most significant byte, at the top */
+		addr = AD9528_ADDR(AD9528_CHANNEL_OUTPUT(chan->channel_num));
+		div = AD9528_CLK_DIST_DIV(chan->channel_divider) >> 16;
+		ad9528_write_frame(buf[n++], addr, div);
+	}
+
+	if (dev->staged_sysref) {
+		k_div = dev->pdata->sysref_k_div;
+		addr = AD9528_ADDR(AD9528_SYSREF_K_DIVIDER);
+		ad9528_write_frame(buf[n++], addr, k_div >> 8);
+		ad9528_write_frame(buf[n++], addr - 1, k_div & 0xFF);
+	}
+
+	ad9528_write_frame(buf[n++], AD9528_ADDR(AD9528_IO_UPDATE),
+			   AD9528_IO_UPDATE_EN);
+
+	for (i = 0; i < n; i++) {
+		msgs[i] = (struct no_os_spi_msg) {
+			.tx_buff = buf[i],
+			.rx_buff = buf[i],
+			.bytes_number = 3,
+			.cs_change = 1,
+		};
+	}
+
+	ret = no_os_spi_transfer(dev->spi_desc, msgs, n);
 	if (ret < 0)
 		return ret;
 
-	return ret;
+	if (dev->staged_sysref)
+		dev->ad9528_st.vco_out_freq[AD9528_SYSREF] =
+			dev->ad9528_st.vco_out_freq[AD9528_VCXO] / 2 /
+			dev->pdata->sysref_k_div;
+
+	dev->staged_mask = 0;
+	dev->staged_sysref = false;
+
+	return sync ? ad9528_sync(dev) : 0;
+}
+
+/***************************************************************************//**
+ * @brief Set channel rate.
+ *
+ * @param dev - is a pointer to the ad9528_dev data structure.
+ * @param chan - Channel number.
+ * @param rate - Channel rate in Hz.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ *******************************************************************************/
+int32_t ad9528_clk_set_rate(struct ad9528_dev *dev, uint32_t chan,
+			    uint32_t rate)
+{
+	int32_t ret;
+
+	ret = ad9528_clk_stage_rate(dev, chan, rate);
+	if (ret < 0)
+		return ret;
+
+	return ad9528_clk_commit(dev, false);
 }
 
 /***************************************************************************//**
@@ -485,6 +485,10 @@ struct ad9528_dev {
 	/* Device Settings */
 	struct ad9528_state ad9528_st;
 	struct ad9528_platform_data *pdata;
+	/* Channels (indexes in pdata->channels) with a staged divider */
+	uint32_t staged_mask;
+	/* A staged SYSREF K divider is waiting for ad9528_clk_commit() */
+	bool staged_sysref;
 };
 
 struct ad9528_init_param {
@@ -529,6 +533,9 @@ uint32_t ad9528_clk_round_rate(struct ad9528_dev *dev, uint32_t chan,
 			       uint32_t rate);
 int32_t ad9528_clk_set_rate(struct ad9528_dev *dev, uint32_t chan,
 			    uint32_t rate);
+int32_t ad9528_clk_stage_rate(struct ad9528_dev *dev, uint32_t chan,
+			      uint32_t rate);
+int32_t ad9528_clk_commit(struct ad9528_dev *dev, bool sync);
 int32_t ad9528_reset(struct ad9528_dev *dev);
 int32_t ad9528_remove(struct ad9528_dev *dev);
 
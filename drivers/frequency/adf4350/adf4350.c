@@ -43,6 +43,7 @@
 /******************************************************************************/
 #include <malloc.h>
 #include <stdio.h>
+#include <string.h>
 #include "adf4350.h"
 
 /***************************************************************************//**
@@ -148,7 +149,8 @@ uint32_t gcd(uint32_t x, uint32_t y)
 int64_t adf4350_set_freq(adf4350_dev *dev,
 			 uint64_t freq)
 {
-	uint64_t tmp;
+	struct adf4350_plan *plan;
+	uint64_t tmp, req_freq = freq;
 	uint32_t div_gcd, prescaler, chspc;
 	uint16_t mdiv, r_cnt = 0;
 	uint8_t band_sel_div;
@@ -157,6 +159,18 @@ int64_t adf4350_set_freq(adf4350_dev *dev,
 	if ((freq > ADF4350_MAX_OUT_FREQ) || (freq < ADF4350_MIN_OUT_FREQ))
 		return -1;
 
+	/* Stepping back to a recent frequency reuses its plan */
+	plan = no_os_pll_cache_find(&dev->plan_cache, freq, dev->chspc);
+	if (plan) {
+		dev->fpfd = plan->fpfd;
+		dev->r0_fract = plan->r0_fract;
+		dev->r0_int = plan->r0_int;
+		dev->r1_mod = plan->r1_mod;
+		dev->r4_rf_div_sel = plan->r4_rf_div_sel;
+		memcpy(dev->regs, plan->regs, sizeof(dev->regs));
+		goto sync;
+	}
+
 	if (freq > ADF4350_MAX_FREQ_45_PRESC) {
 		prescaler = ADF4350_REG1_PRESCALER;
 		mdiv = 75;
@@ -255,6 +269,16 @@ int64_t adf4350_set_freq(adf4350_dev *dev,
 
 	dev->regs[ADF4350_REG5] = ADF4350_REG5_LD_PIN_MODE_DIGITAL | 0x00180000;
 
+	plan = no_os_pll_cache_add(&dev->plan_cache, req_freq, dev->chspc);
+	plan->fpfd = dev->fpfd;
+	plan->r0_fract = dev->r0_fract;
+	plan->r0_int = dev->r0_int;
+	plan->r1_mod = dev->r1_mod;
+	plan->r4_rf_div_sel = dev->r4_rf_div_sel;
+	memcpy(plan->regs, dev->regs, sizeof(plan->regs));
+
+sync:
+	/* Only the registers that changed are written, usually R0 and R1 */
 	ret = adf4350_sync_config(dev);
 	if(ret < 0) {
 		return ret;
@@ -286,6 +310,9 @@ int32_t adf4350_setup(adf4350_dev **device,
 		return -1;
 	}
 
+	no_os_pll_cache_init(&dev->plan_cache, dev->plan_tags, dev->plans,
+			     sizeof(dev->plans[0]), ADF4350_PLAN_CACHE_SIZE);
+
 	/* SPI */
 	ret = no_os_spi_init(&dev->spi_desc, &init_param.spi_init);
 
@@ -404,8 +431,10 @@ int32_t adf4350_out_altvoltage0_frequency_resolution(adf4350_dev *dev,
 int64_t adf4350_out_altvoltage0_refin_frequency(adf4350_dev *dev,
 		int64_t Hz)
 {
-	if(Hz != INT32_MAX) {
+	if(Hz != INT32_MAX && Hz != dev->clkin) {
 		dev->clkin = Hz;
+		/* The cached plans were computed for the previous REFin */
+		no_os_pll_cache_invalidate(&dev->plan_cache);
 	}
 
 	return dev->clkin;
@@ -45,6 +45,7 @@
 /******************************************************************************/
 #include <stdint.h>
 #include "no_os_spi.h"
+#include "no_os_pll_cache.h"
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -126,6 +127,9 @@
 #define ADF4350_MAX_MODULUS			4095
 #define ADF4350_MAX_R_CNT			1023
 
+/* Number of frequency plans kept by adf4350_set_freq() */
+#define ADF4350_PLAN_CACHE_SIZE		8
+
 /******************************************************************************/
 /************************ Types Definitions ***********************************/
 /******************************************************************************/
@@ -180,6 +184,16 @@ typedef struct {
 	uint32_t	aux_output_power;
 } adf4350_init_param;
 
+/* Result of the computation done by adf4350_set_freq() for a frequency */
+struct adf4350_plan {
+	uint32_t	fpfd;
+	uint32_t	r0_fract;
+	uint32_t	r0_int;
+	uint32_t	r1_mod;
+	uint32_t	r4_rf_div_sel;
+	uint32_t	regs[6];
+};
+
 typedef struct {
 	struct no_os_spi_desc	*spi_desc;
 	struct adf4350_platform_data *pdata;
@@ -194,6 +208,10 @@ typedef struct {
 	uint32_t	regs[6];
 	uint32_t	regs_hw[6];
 	uint32_t 	val;
+	/* Recently used frequency plans, keyed by the channel spacing */
+	struct no_os_pll_cache		plan_cache;
+	struct no_os_pll_cache_tag	plan_tags[ADF4350_PLAN_CACHE_SIZE];
+	struct adf4350_plan		plans[ADF4350_PLAN_CACHE_SIZE];
 } adf4350_dev;
 
 /******************************************************************************/
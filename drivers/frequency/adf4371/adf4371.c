@@ -44,6 +44,7 @@
 #include <stdbool.h>
 #include <inttypes.h>
 #include <stdio.h>
+#include <string.h>
 #include "no_os_error.h"
 #include "no_os_util.h"
 #include "adf4371.h"
@@ -135,6 +136,8 @@
 /* MOD2 is the programmable, 14-bit auxiliary fractional modulus */
 #define ADF4371_MAX_MODULUS2		NO_OS_BIT(14)
 
+#define ADF4371_FREQ_REG_IDX(x)		((x) - ADF4371_FREQ_REG_FIRST)
+
 #define ADF4371_CHECK_RANGE(freq, range) \
 	((freq > ADF4371_MAX_ ## range) || (freq < ADF4371_MIN_ ## range))
 
@@ -328,6 +331,62 @@ static int32_t adf4371_update(struct adf4371_dev *dev,
 	return ret;
 }
 
+/**
+ * Write a frequency register if its value differs from the one in the device.
+ * @param dev - The device structure.
+ * @param reg - The register address, from 0x10 to 0x2B.
+ * @param val - The register data.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t adf4371_write_freq_reg(struct adf4371_dev *dev,
+				      uint16_t reg,
+				      uint8_t val)
+{
+	uint8_t *hw = &dev->freq_regs[ADF4371_FREQ_REG_IDX(reg)];
+	int32_t ret;
+
+	if (dev->freq_regs_valid && *hw == val)
+		return 0;
+
+	ret = adf4371_write(dev, reg, val);
+	if (ret < 0)
+		return ret;
+
+	*hw = val;
+
+	return 0;
+}
+
+/**
+ * Write the part of the 0x11 to 0x1A frequency word block that changed.
+ * @param dev - The device structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t adf4371_write_freq_words(struct adf4371_dev *dev)
+{
+	uint8_t *hw = &dev->freq_regs[ADF4371_FREQ_REG_IDX(ADF4371_REG(0x11))];
+	uint8_t first = 0, last = sizeof(dev->buf) - 1;
+	int32_t ret;
+
+	if (dev->freq_regs_valid) {
+		while (first <= last && dev->buf[first] == hw[first])
+			first++;
+		if (first > last)
+			return 0;
+		while (dev->buf[last] == hw[last])
+			last--;
+	}
+
+	ret = adf4371_write_bulk(dev, ADF4371_REG(0x11) + first,
+				 &dev->buf[first], last - first + 1);
+	if (ret < 0)
+		return ret;
+
+	memcpy(&hw[first], &dev->buf[first], last - first + 1);
+
+	return 0;
+}
+
 /**
  * Get the output frequency of one channel.
  * @param dev - The device structure.
@@ -413,8 +472,10 @@ static int32_t adf4371_set_freq(struct adf4371_dev *dev,
 				uint64_t freq,
 				uint32_t channel)
 {
+	struct adf4371_plan *plan;
 	uint32_t cp_bleed;
 	uint8_t int_mode = 0;
+	uint8_t reg24;
 	int32_t ret;
 
 	switch (channel) {
@@ -448,8 +509,24 @@ static int32_t adf4371_set_freq(struct adf4371_dev *dev,
 		return -1;
 	}
 
-	adf4371_pll_fract_n_compute(freq, dev->fpfd, &dev->integer, &dev->fract1,
-				    &dev->fract2, &dev->mod2);
+	/* Stepping back to a recent frequency skips the computation */
+	plan = no_os_pll_cache_find(&dev->plan_cache, freq, dev->fpfd);
+	if (plan) {
+		dev->integer = plan->integer;
+		dev->fract1 = plan->fract1;
+		dev->fract2 = plan->fract2;
+		dev->mod2 = plan->mod2;
+	} else {
+		adf4371_pll_fract_n_compute(freq, dev->fpfd, &dev->integer,
+					    &dev->fract1, &dev->fract2,
+					    &dev->mod2);
+
+		plan = no_os_pll_cache_add(&dev->plan_cache, freq, dev->fpfd);
+		plan->integer = dev->integer;
+		plan->fract1 = dev->fract1;
+		plan->fract2 = dev->fract2;
+		plan->mod2 = dev->mod2;
+	}
 
 	dev->buf[0] = dev->integer >> 8;
 	dev->buf[1] = 0x40; /* REG12 default */
@@ -463,20 +540,29 @@ static int32_t adf4371_set_freq(struct adf4371_dev *dev,
 	dev->buf[8] = dev->mod2 & 0xFF;
 	dev->buf[9] = ADF4371_MOD2WORD(dev->mod2 >> 8);
 
-	ret = adf4371_write_bulk(dev, ADF4371_REG(0x11), dev->buf, 10);
+	/* Only the registers that changed are written, REG10 always is */
+	ret = adf4371_write_freq_words(dev);
 	if (ret < 0)
 		return ret;
 	/*
 	 * The R counter allows the input reference frequency to be
 	 * divided down to produce the reference clock to the PFD
 	 */
-	ret = adf4371_write(dev, ADF4371_REG(0x1F), dev->ref_div_factor);
+	ret = adf4371_write_freq_reg(dev, ADF4371_REG(0x1F),
+				     dev->ref_div_factor);
 	if (ret < 0)
 		return ret;
 
-	ret = adf4371_update(dev, ADF4371_REG(0x24),
-			     ADF4371_RF_DIV_SEL_MSK,
-			     ADF4371_RF_DIV_SEL(dev->rf_div_sel));
+	if (!dev->freq_regs_valid) {
+		ret = adf4371_read(dev, ADF4371_REG(0x24), &reg24);
+		if (ret < 0)
+			return ret;
+	} else {
+		reg24 = dev->freq_regs[ADF4371_FREQ_REG_IDX(ADF4371_REG(0x24))];
+	}
+	reg24 &= ~ADF4371_RF_DIV_SEL_MSK;
+	reg24 |= ADF4371_RF_DIV_SEL(dev->rf_div_sel);
+	ret = adf4371_write_freq_reg(dev, ADF4371_REG(0x24), reg24);
 	if (ret < 0)
 		return ret;
 
@@ -486,7 +572,7 @@ static int32_t adf4371_set_freq(struct adf4371_dev *dev,
 	 */
 	cp_bleed = NO_OS_DIV_ROUND_UP(400 * dev->cp_settings.icp, dev->integer * 375);
 	cp_bleed = no_os_clamp(cp_bleed, 1U, 255U);
-	ret = adf4371_write(dev, ADF4371_REG(0x26), cp_bleed);
+	ret = adf4371_write_freq_reg(dev, ADF4371_REG(0x26), cp_bleed);
 	if (ret < 0)
 		return ret;
 	/*
@@ -496,11 +582,19 @@ static int32_t adf4371_set_freq(struct adf4371_dev *dev,
 	if (dev->fract1 == 0 && dev->fract2 == 0)
 		int_mode = 0x01;
 
-	ret = adf4371_write(dev, ADF4371_REG(0x2B), int_mode);
+	ret = adf4371_write_freq_reg(dev, ADF4371_REG(0x2B), int_mode);
 	if (ret < 0)
 		return ret;
 
-	return adf4371_write(dev, ADF4371_REG(0x10), dev->integer & 0xFF);
+	/* Writing REG10 loads the double buffered frequency registers */
+	ret = adf4371_write(dev, ADF4371_REG(0x10), dev->integer & 0xFF);
+	if (ret < 0)
+		return ret;
+
+	dev->freq_regs[0] = dev->integer & 0xFF;
+	dev->freq_regs_valid = true;
+
+	return 0;
 }
 
 /**
@@ -585,6 +679,7 @@ static int32_t adf4371_setup(struct adf4371_dev *dev)
 	ret = adf4371_write(dev, ADF4371_REG(0x0), ADF4371_RESET_CMD);
 	if (ret < 0)
 		return ret;
+	dev->freq_regs_valid = false;
 
 	if (dev->spi_3wire_en)
 		en = false;
@@ -754,6 +849,9 @@ int32_t adf4371_init(struct adf4371_dev **device,
 	if (!dev)
 		return -1;
 
+	no_os_pll_cache_init(&dev->plan_cache, dev->plan_tags, dev->plans,
+			     sizeof(dev->plans[0]), ADF4371_PLAN_CACHE_SIZE);
+
 	ret = no_os_spi_init(&dev->spi_desc, init_param->spi_init);
 	if (ret < 0)
 		return ret;
@@ -44,10 +44,17 @@
 /******************************************************************************/
 #include <stdint.h>
 #include "no_os_spi.h"
+#include "no_os_pll_cache.h"
 
 /******************************************************************************/
 /********************** Macros and Types Declarations *************************/
 /******************************************************************************/
+/* Number of fractional-N plans kept by the frequency changes */
+#define ADF4371_PLAN_CACHE_SIZE	8
+/* Frequency registers shadowed by the driver, 0x10 to 0x2B */
+#define ADF4371_FREQ_REG_FIRST	0x10
+#define ADF4371_FREQ_REG_NUM	0x1C
+
 struct adf4371_channel_config {
 	bool		enable;
 	uint64_t	freq;
@@ -63,6 +70,13 @@ struct adf4371_chan_spec {
 	uint64_t	power_up_frequency;
 };
 
+struct adf4371_plan {
+	uint32_t	integer;
+	uint32_t	fract1;
+	uint32_t	fract2;
+	uint32_t	mod2;
+};
+
 struct adf4371_dev {
 	struct no_os_spi_desc	*spi_desc;
 	bool		spi_3wire_en;
@@ -84,6 +98,13 @@ struct adf4371_dev {
 	uint32_t	mod2;
 	uint32_t	rf_div_sel;
 	uint8_t		buf[10];
+	/* Values of the frequency registers in the device, if valid */
+	bool		freq_regs_valid;
+	uint8_t		freq_regs[ADF4371_FREQ_REG_NUM];
+	/* Recently used plans, keyed by the VCO frequency and the PFD rate */
+	struct no_os_pll_cache		plan_cache;
+	struct no_os_pll_cache_tag	plan_tags[ADF4371_PLAN_CACHE_SIZE];
+	struct adf4371_plan		plans[ADF4371_PLAN_CACHE_SIZE];
 };
 
 struct adf4371_init_param {
@@ -118,6 +118,28 @@ static void adf5355_pll_fract_n_compute(uint64_t vco,
 	*fract2 /= gcd_div;
 }
 
+/**
+ * Write a register if its value differs from the one in the device.
+ * @param dev - The device structure.
+ * @param reg - The register number.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t adf5355_write_changed(struct adf5355_dev *dev, uint32_t reg)
+{
+	int32_t ret;
+
+	if (dev->regs_hw[reg] == dev->regs[reg])
+		return 0;
+
+	ret = adf5355_write(dev, ADF5355_REG(reg), dev->regs[reg]);
+	if (ret != 0)
+		return ret;
+
+	dev->regs_hw[reg] = dev->regs[reg];
+
+	return 0;
+}
+
 /**
  * ADF5355 Register configuration
  * @param dev - The device structure.
@@ -136,22 +158,28 @@ static int32_t adf5355_reg_config(struct adf5355_dev *dev, bool sync_all)
 			ret = adf5355_write(dev, ADF5355_REG(i), dev->regs[i]);
 			if (ret != 0)
 				return ret;
+			dev->regs_hw[i] = dev->regs[i];
 		}
 
 		dev->all_synced = true;
 
 	} else {
+		/*
+		 * Frequency update sequence. The double buffered registers are
+		 * only sent if they changed, the R4 counter reset and the R0
+		 * writes around it are always needed.
+		 */
 		if(dev->dev_id == ADF5356) {
-			ret = adf5355_write(dev, ADF5355_REG(13), dev->regs[ADF5355_REG(13)]);
+			ret = adf5355_write_changed(dev, ADF5355_REG(13));
 			if (ret != 0)
 				return ret;
 		}
 
-		ret = adf5355_write(dev, ADF5355_REG(10), dev->regs[ADF5355_REG(10)]);
+		ret = adf5355_write_changed(dev, ADF5355_REG(10));
 		if (ret != 0)
 			return ret;
 
-		ret = adf5355_write(dev, ADF5355_REG(6), dev->regs[ADF5355_REG(6)]);
+		ret = adf5355_write_changed(dev, ADF5355_REG(6));
 		if (ret != 0)
 			return ret;
 
@@ -160,11 +188,11 @@ static int32_t adf5355_reg_config(struct adf5355_dev *dev, bool sync_all)
 		if (ret != 0)
 			return ret;
 
-		ret = adf5355_write(dev, ADF5355_REG(2), dev->regs[ADF5355_REG(2)]);
+		ret = adf5355_write_changed(dev, ADF5355_REG(2));
 		if (ret != 0)
 			return ret;
 
-		ret = adf5355_write(dev, ADF5355_REG(1), dev->regs[ADF5355_REG(1)]);
+		ret = adf5355_write_changed(dev, ADF5355_REG(1));
 		if (ret != 0)
 			return ret;
 
@@ -176,11 +204,17 @@ static int32_t adf5355_reg_config(struct adf5355_dev *dev, bool sync_all)
 		ret = adf5355_write(dev, ADF5355_REG(4), dev->regs[ADF5355_REG(4)]);
 		if (ret != 0)
 			return ret;
+		dev->regs_hw[ADF5355_REG(4)] = dev->regs[ADF5355_REG(4)];
 	}
 
 	no_os_udelay(dev->delay_us);
 
-	return adf5355_write(dev, ADF5355_REG(0), dev->regs[0]);
+	ret = adf5355_write(dev, ADF5355_REG(0), dev->regs[0]);
+	if (ret != 0)
+		return ret;
+	dev->regs_hw[ADF5355_REG(0)] = dev->regs[ADF5355_REG(0)];
+
+	return 0;
 }
 
 /**
@@ -194,6 +228,7 @@ static int32_t adf5355_set_freq(struct adf5355_dev *dev,
 				uint64_t freq,
 				uint8_t chan)
 {
+	struct adf5355_plan *plan;
 	uint32_t cp_bleed;
 	bool prescaler, cp_neg_bleed_en;
 
@@ -224,9 +259,24 @@ static int32_t adf5355_set_freq(struct adf5355_dev *dev,
 		freq >>= 1;
 	}
 
-	adf5355_pll_fract_n_compute(freq, dev->fpfd, &dev->integer, &dev->fract1,
-				    &dev->fract2, &dev->mod2,
-				    (dev->dev_id == ADF5356) ? ADF5356_MAX_MODULUS2 : ADF5355_MAX_MODULUS2);
+	/* Stepping back to a recent frequency skips the computation */
+	plan = no_os_pll_cache_find(&dev->plan_cache, freq, dev->fpfd);
+	if (plan) {
+		dev->integer = plan->integer;
+		dev->fract1 = plan->fract1;
+		dev->fract2 = plan->fract2;
+		dev->mod2 = plan->mod2;
+	} else {
+		adf5355_pll_fract_n_compute(freq, dev->fpfd, &dev->integer, &dev->fract1,
+					    &dev->fract2, &dev->mod2,
+					    (dev->dev_id == ADF5356) ? ADF5356_MAX_MODULUS2 : ADF5355_MAX_MODULUS2);
+
+		plan = no_os_pll_cache_add(&dev->plan_cache, freq, dev->fpfd);
+		plan->integer = dev->integer;
+		plan->fract1 = dev->fract1;
+		plan->fract2 = dev->fract2;
+		plan->mod2 = dev->mod2;
+	}
 
 	prescaler = (dev->integer >= ADF5355_MIN_INT_PRESCALER_89);
 
@@ -273,7 +323,7 @@ static int32_t adf5355_set_freq(struct adf5355_dev *dev,
 
 	dev->freq_req = freq;
 
-	return adf5355_reg_config(dev, dev->all_synced);
+	return adf5355_reg_config(dev, false);
 }
 
 /**
@@ -447,6 +497,9 @@ int32_t adf5355_init(struct adf5355_dev **device,
 	if (!dev)
 		return -ENOMEM;
 
+	no_os_pll_cache_init(&dev->plan_cache, dev->plan_tags, dev->plans,
+			     sizeof(dev->plans[0]), ADF5355_PLAN_CACHE_SIZE);
+
 	/* SPI */
 	ret = no_os_spi_init(&dev->spi_desc, init_param->spi_init);
 	if (ret != 0)
@@ -167,11 +167,15 @@
 
 #define ADF5355_SPI_NO_BYTES                    4
 
+/* Number of fractional-N plans kept by the frequency changes */
+#define ADF5355_PLAN_CACHE_SIZE                 8
+
 /******************************************************************************/
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdint.h>
 #include "no_os_spi.h"
+#include "no_os_pll_cache.h"
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -203,6 +207,17 @@ enum adf5355_mux_out_sel {
 	ADF5355_MUXOUT_DIGITAL_LOCK_DETECT,
 };
 
+/**
+ * @struct adf5355_plan
+ * @brief  Fractional-N divider values computed for a VCO frequency.
+ */
+struct adf5355_plan {
+	uint32_t	integer;
+	uint32_t	fract1;
+	uint32_t	fract2;
+	uint32_t	mod2;
+};
+
 /**
  * @struct adf5355_dev
  * @brief  Device descriptor.
@@ -212,6 +227,8 @@ struct adf5355_dev {
 	enum adf5355_device_id      dev_id;
 	bool                        all_synced;
 	uint32_t                    regs[ADF5355_REG_NUM];
+	/* Register values last written to the device */
+	uint32_t                    regs_hw[ADF5355_REG_NUM];
 	uint64_t                    freq_req;
 	uint8_t                     freq_req_chan;
 	uint8_t                     num_channels;
@@ -242,6 +259,10 @@ struct adf5355_dev {
 	uint16_t                    ref_div_factor;
 	enum adf5355_mux_out_sel    mux_out_sel;
 	uint32_t                    delay_us;
+	/* Recently used plans, keyed by the VCO frequency and the PFD rate */
+	struct no_os_pll_cache      plan_cache;
+	struct no_os_pll_cache_tag  plan_tags[ADF5355_PLAN_CACHE_SIZE];
+	struct adf5355_plan         plans[ADF5355_PLAN_CACHE_SIZE];
 };
 
 /**
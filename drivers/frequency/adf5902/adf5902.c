@@ -685,6 +685,9 @@ int32_t adf5902_recalibrate(struct adf5902_dev *dev)
 	/* Store R/2 Div value before Recalibration Procedure */
 	uint8_t temp = dev->ref_div2_en;
 
+	/* Set again by adf5902_band_select() once the calibration is done */
+	dev->cal_band = NULL;
+
 	/* Compute VCO parameters for the calibration procedure */
 	ret = adf5902_vco_freq_param(dev);
 	if (ret != 0)
@@ -734,6 +737,239 @@ int32_t adf5902_recalibrate(struct adf5902_dev *dev)
 	return ret;
 }
 
+/**
+ * @brief Check the chirp parameters of a ramp profile.
+ * @param profile - The ramp profile.
+ * @return Returns 0 in case of success or negative error code.
+ */
+static int32_t adf5902_check_ramp_profile(struct adf5902_ramp_profile *profile)
+{
+	uint32_t i;
+
+	if (profile->delay_words_no > ADF5902_MAX_DELAY_WORD_NO ||
+	    profile->slopes_no > ADF5902_MAX_SLOPE_NO ||
+	    profile->clk2_div_no > ADF5902_MAX_CLK2_DIV_NO)
+		return -EINVAL;
+
+	for (i = 0; i < profile->delay_words_no; i++)
+		if (profile->delay_wd[i] > ADF5902_MAX_DELAY_START_WRD)
+			return -EINVAL;
+
+	for (i = 0; i < profile->slopes_no; i++)
+		if ((profile->slopes[i].step_word > ADF5902_MAX_STEP_WORD) ||
+		    (profile->slopes[i].dev_offset > ADF5902_MAX_DEV_OFFSET))
+			return -EINVAL;
+
+	for (i = 0; i < profile->clk2_div_no; i++)
+		if (profile->clk2_div[i] > ADF5902_MAX_CLK_DIV_2)
+			return -EINVAL;
+
+	if ((profile->ramp_delay_en != ADF5902_RAMP_DEL_DISABLE)
+	    && (profile->ramp_delay_en != ADF5902_RAMP_DEL_ENABLE))
+		return -EINVAL;
+
+	if ((profile->tx_trig_en != ADF5902_TX_DATA_TRIG_DISABLE)
+	    && (profile->tx_trig_en != ADF5902_TX_DATA_TRIG_ENABLE))
+		return -EINVAL;
+
+	if (profile->ramp_mode > ADF5902_SINGLE_RAMP_BURST)
+		return -EINVAL;
+
+	if (profile->clk1_div_ramp > ADF5902_MAX_CLK_DIVIDER)
+		return -EINVAL;
+
+	return 0;
+}
+
+/**
+ * @brief Compute the ramp register words of a profile, so that switching to
+ * it between frames costs only the SPI transfer.
+ * @param dev - The device structure.
+ * @param profile - The ramp profile, the register words are stored in it.
+ * @return Returns 0 in case of success or negative error code.
+ */
+int32_t adf5902_ramp_profile_build(struct adf5902_dev *dev,
+				   struct adf5902_ramp_profile *profile)
+{
+	struct slope *slope;
+	uint32_t *regs;
+	uint32_t i;
+	int32_t ret;
+
+	if (!dev || !profile)
+		return -EINVAL;
+
+	ret = adf5902_check_ramp_profile(profile);
+	if (ret)
+		return ret;
+
+	regs = profile->regs;
+
+	for (i = 0; i < profile->delay_words_no; i++)
+		*regs++ = ADF5902_REG16 | ADF5902_REG16_RESERVED |
+			  ADF5902_REG16_DEL_START_WORD(profile->delay_wd[i]) |
+			  ADF5902_REG16_RAMP_DEL(profile->ramp_delay_en) |
+			  ADF5902_REG16_TX_DATA_TRIG(profile->tx_trig_en) |
+			  ADF5902_REG16_DEL_SEL(i);
+
+	for (i = 0; i < profile->slopes_no; i++) {
+		slope = &profile->slopes[i];
+		*regs++ = ADF5902_REG15 | ADF5902_REG15_RESERVED |
+			  ADF5902_REG15_STEP_WORD(slope->step_word) |
+			  ADF5902_REG15_STEP_SEL(i);
+		*regs++ = ADF5902_REG14 | ADF5902_REG14_RESERVED |
+			  ADF5902_REG14_DEV_WORD(slope->dev_word) |
+			  ADF5902_REG14_DEV_OFFSET(slope->dev_offset) |
+			  ADF5902_REG14_DEV_SEL(i) |
+			  ADF5902_REG14_TX_RAMP_CLK(dev->tx_ramp_clk) |
+			  ADF5902_REG14_TX_DATA_INV(dev->tx_data_invert);
+	}
+
+	for (i = 0; i < profile->clk2_div_no; i++)
+		*regs++ = ADF5902_REG13 | ADF5902_REG13_RESERVED |
+			  ADF5902_REG13_CLK_DIV_2(profile->clk2_div[i]) |
+			  ADF5902_REG13_CLK_DIV_SEL(i) |
+			  ADF5902_REG13_CLK_DIV_MODE(dev->clk_div_mode) |
+			  ADF5902_REG13_LE_SEL(dev->le_sel);
+
+	*regs++ = ADF5902_REG11 | ADF5902_REG11_RESERVED |
+		  ADF5902_REG11_RAMP_MODE(profile->ramp_mode);
+
+	profile->nb_regs = regs - profile->regs;
+
+	return 0;
+}
+
+/**
+ * @brief Switch to a ramp profile built by adf5902_ramp_profile_build().
+ * The ramp is stopped, the ramp registers and CLK1 are written and the ramp
+ * is started again, all in a single SPI transfer. The VCO is not calibrated
+ * again, the profile sweeps from the current output frequency.
+ * @param dev - The device structure.
+ * @param profile - The ramp profile.
+ * @return Returns 0 in case of success or negative error code.
+ */
+int32_t adf5902_ramp_profile_load(struct adf5902_dev *dev,
+				  struct adf5902_ramp_profile *profile)
+{
+	struct no_os_spi_msg msgs[ADF5902_RAMP_IMAGE_SIZE + 3];
+	uint8_t buff[(ADF5902_RAMP_IMAGE_SIZE + 3) * ADF5902_BUFF_SIZE_BYTES];
+	uint32_t words[ADF5902_RAMP_IMAGE_SIZE + 3];
+	uint32_t reg5;
+	uint32_t n = 0;
+	uint32_t i;
+	int32_t ret;
+
+	if (!dev || !profile || !profile->nb_regs ||
+	    profile->nb_regs > ADF5902_RAMP_IMAGE_SIZE)
+		return -EINVAL;
+
+	reg5 = ADF5902_REG5 | ADF5902_REG5_RESERVED |
+	       ADF5902_REG5_FRAC_MSB_WORD(dev->frac_msb) |
+	       ADF5902_REG5_INTEGER_WORD(dev->int_div);
+
+	words[n++] = reg5 | ADF5902_REG5_RAMP_ON(ADF5902_RAMP_ON_DISABLED);
+	words[n++] = ADF5902_REG7 | ADF5902_REG7_RESERVED |
+		     ADF5902_REG7_R_DIVIDER(dev->ref_div_factor) |
+		     ADF5902_REG7_REF_DOUBLER(dev->ref_doubler_en) |
+		     ADF5902_REG7_R_DIV_2(ADF5902_R_DIV_2_DISABLE) |
+		     ADF5902_REG7_CLK_DIV(profile->clk1_div_ramp) |
+		     ADF5902_REG7_MASTER_RESET(ADF5902_MASTER_RESET_DISABLE);
+	for (i = 0; i < profile->nb_regs; i++)
+		words[n++] = profile->regs[i];
+	words[n++] = reg5 | ADF5902_REG5_RAMP_ON(ADF5902_RAMP_ON_ENABLED);
+
+	/* Each word is latched on its own chip select edge */
+	for (i = 0; i < n; i++) {
+		buff[i * 4] = words[i] >> 24;
+		buff[i * 4 + 1] = words[i] >> 16;
+		buff[i * 4 + 2] = words[i] >> 8;
+		buff[i * 4 + 3] = words[i];
+		msgs[i] = (struct no_os_spi_msg) {
+			.tx_buff = &buff[i * 4],
+			.rx_buff = &buff[i * 4],
+			.bytes_number = ADF5902_BUFF_SIZE_BYTES,
+			.cs_change = 1,
+		};
+	}
+
+	ret = no_os_spi_transfer(dev->spi_desc, msgs, n);
+	if (ret != 0)
+		return ret;
+
+	dev->ramp_mode = profile->ramp_mode;
+	dev->ramp_delay_en = profile->ramp_delay_en;
+	dev->tx_trig_en = profile->tx_trig_en;
+	dev->clk1_div_ramp = profile->clk1_div_ramp;
+	dev->profile = profile;
+
+	return 0;
+}
+
+/**
+ * @brief Tune the VCO to the start frequency of a band. The ADF5902 keeps the
+ * result of a single VCO calibration, so the calibration runs only when the
+ * VCO was last calibrated for another band, otherwise the PLL words cached in
+ * the band are written back.
+ * @param dev - The device structure.
+ * @param band - The band, its PLL words are cached in it.
+ * @return Returns 0 in case of success or negative error code.
+ */
+int32_t adf5902_band_select(struct adf5902_dev *dev,
+			    struct adf5902_band *band)
+{
+	int32_t ret;
+
+	if (!dev || !band)
+		return -EINVAL;
+
+	if ((band->rf_out > ADF5902_MAX_VCO_FREQ)
+	    || (band->rf_out < ADF5902_MIN_VCO_FREQ))
+		return -EINVAL;
+
+	if (dev->cal_band != band) {
+		dev->rf_out = band->rf_out;
+
+		ret = adf5902_recalibrate(dev);
+		if (ret != 0)
+			return ret;
+
+		band->f_pfd = dev->f_pfd;
+		band->ref_div_factor = dev->ref_div_factor;
+		band->int_div = dev->int_div;
+		band->frac_msb = dev->frac_msb;
+		band->frac_lsb = dev->frac_lsb;
+		dev->cal_band = band;
+
+		return 0;
+	}
+
+	dev->rf_out = band->rf_out;
+	dev->f_pfd = band->f_pfd;
+	dev->ref_div_factor = band->ref_div_factor;
+	dev->int_div = band->int_div;
+	dev->frac_msb = band->frac_msb;
+	dev->frac_lsb = band->frac_lsb;
+
+	ret = adf5902_write(dev, ADF5902_REG7, ADF5902_REG7_RESERVED |
+			    ADF5902_REG7_R_DIVIDER(dev->ref_div_factor) |
+			    ADF5902_REG7_REF_DOUBLER(dev->ref_doubler_en) |
+			    ADF5902_REG7_R_DIV_2(ADF5902_R_DIV_2_DISABLE) |
+			    ADF5902_REG7_CLK_DIV(dev->clk1_div_ramp) |
+			    ADF5902_REG7_MASTER_RESET(ADF5902_MASTER_RESET_DISABLE));
+	if (ret != 0)
+		return ret;
+
+	ret = adf5902_write(dev, ADF5902_REG6, ADF5902_REG6_RESERVED |
+			    ADF5902_REG6_FRAC_LSB_WORD(dev->frac_lsb));
+	if (ret != 0)
+		return ret;
+
+	return adf5902_write(dev, ADF5902_REG5, ADF5902_REG5_RESERVED |
+			     ADF5902_REG5_FRAC_MSB_WORD(dev->frac_msb) |
+			     ADF5902_REG5_INTEGER_WORD(dev->int_div));
+}
+
 /**
  * @brief Free resoulces allocated for ADF5902
  * @param dev - The device structure.
@@ -415,6 +415,10 @@
 #define ADF5902_BUFF_SIZE_BYTES		4
 #define ADF5902_FRAC_MSB_MSK		0xFFF
 #define ADF5902_FRAC_LSB_MSK		0x1FFF
+/* REG16, REG15/REG14 pairs, REG13 words of a ramp profile and its REG11 */
+#define ADF5902_RAMP_IMAGE_SIZE		(ADF5902_MAX_DELAY_WORD_NO + \
+					 2 * ADF5902_MAX_SLOPE_NO + \
+					 ADF5902_MAX_CLK2_DIV_NO + 1)
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -429,6 +433,57 @@ struct slope {
 	uint32_t step_word;
 };
 
+/**
+ * @struct adf5902_ramp_profile
+ * @brief Chirp description and the register words computed from it by
+ * adf5902_ramp_profile_build(), loaded with adf5902_ramp_profile_load().
+ */
+struct adf5902_ramp_profile {
+	/* Ramp Mode */
+	uint8_t			ramp_mode;
+	/* Ramp delay enable */
+	uint8_t			ramp_delay_en;
+	/* TX Data trigger */
+	uint8_t			tx_trig_en;
+	/* Delay words number */
+	uint8_t			delay_words_no;
+	/* Delay Words */
+	uint16_t		delay_wd[ADF5902_MAX_DELAY_WORD_NO];
+	/* Number of deviaton parameters */
+	uint8_t			slopes_no;
+	/* Slope structure */
+	struct slope		slopes[ADF5902_MAX_SLOPE_NO];
+	/* 12-bit Clock Divider number */
+	uint8_t			clk2_div_no;
+	/* 12-bit Clock Divider */
+	uint16_t		clk2_div[ADF5902_MAX_CLK2_DIV_NO];
+	/* Clock divider (CLK1) divider value in Ramp mode */
+	uint16_t		clk1_div_ramp;
+	/* Register words, in write order, filled by the build */
+	uint32_t		regs[ADF5902_RAMP_IMAGE_SIZE];
+	/* Number of register words */
+	uint8_t			nb_regs;
+};
+
+/**
+ * @struct adf5902_band
+ * @brief Start frequency and the PLL words computed by its VCO calibration.
+ */
+struct adf5902_band {
+	/* Output frequency of the internal VCO */
+	uint64_t		rf_out;
+	/* Phase Frequency Detector */
+	uint64_t		f_pfd;
+	/* Divide ration of the binary 5-bit reference counter */
+	uint8_t			ref_div_factor;
+	/* Register 5 Integer word */
+	uint16_t		int_div;
+	/* Register 5 MSB FRAC value */
+	uint16_t		frac_msb;
+	/* Register 6 LSB FRAC value */
+	uint16_t		frac_lsb;
+};
+
 struct adf5902_init_param {
 	/* SPI Initialization parameters */
 	struct no_os_spi_init_param	*spi_init;
@@ -549,6 +604,10 @@ struct adf5902_dev {
 	uint8_t			cp_tristate_en;
 	/* Ramp Mode */
 	uint8_t			ramp_mode;
+	/* Ramp profile loaded last, NULL for the one of the init */
+	struct adf5902_ramp_profile	*profile;
+	/* Band the VCO is calibrated for, NULL if unknown */
+	struct adf5902_band	*cal_band;
 };
 
 /******************************************************************************/
@@ -570,6 +629,18 @@ int32_t adf5902_init(struct adf5902_dev **device,
 /** ADF5902 Recalibration Procedure */
 int32_t adf5902_recalibrate(struct adf5902_dev *dev);
 
+/** ADF5902 Compute the register words of a ramp profile */
+int32_t adf5902_ramp_profile_build(struct adf5902_dev *dev,
+				   struct adf5902_ramp_profile *profile);
+
+/** ADF5902 Load a ramp profile and restart the ramp */
+int32_t adf5902_ramp_profile_load(struct adf5902_dev *dev,
+				  struct adf5902_ramp_profile *profile);
+
+/** ADF5902 Tune to a band, calibrating the VCO only when needed */
+int32_t adf5902_band_select(struct adf5902_dev *dev,
+			    struct adf5902_band *band);
+
 /** ADF5902 Read Temperature procedure */
 int32_t adf5902_read_temp(struct adf5902_dev *dev, float *temp);
 
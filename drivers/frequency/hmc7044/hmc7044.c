@@ -365,40 +365,113 @@ int32_t hmc7044_clk_round_rate(struct hmc7044_dev *dev, uint32_t rate,
 }
 
 /**
- * Set channel rate.
+ * Stage a channel rate change. The divider is only stored in the channel
+ * structure, hmc7044_clk_commit() writes all the staged dividers at once.
  * @param dev - The device structure.
  * @param chan_num - Channel number.
  * @param rate - Channel rate.
  * @return 0 in case of success, negative error code otherwise.
  */
-int32_t hmc7044_clk_set_rate(struct hmc7044_dev *dev, uint32_t chan_num,
-			     uint64_t rate)
+int32_t hmc7044_clk_stage_rate(struct hmc7044_dev *dev, uint32_t chan_num,
+			       uint64_t rate)
 {
-	uint32_t div;
-	int32_t ret;
-	int i;
-	struct hmc7044_chan_spec *chan = NULL;
+	uint32_t i;
 
 	/* Find the reqested channel number */
 	for (i = 0; i < dev->num_channels; i++) {
-		if (dev->channels[i].num == chan_num) {
-			chan = &dev->channels[i];
+		if (dev->channels[i].num == chan_num)
 			break;
+	}
+	if (i == dev->num_channels)
+		return -EINVAL;
+
+	dev->channels[i].divider = hmc7044_calc_out_div(rate, dev->pll2_freq);
+	dev->staged_mask |= NO_OS_BIT(i);
+
+	return 0;
+}
+
+/**
+ * Write the staged channel dividers in a single SPI transfer and, if
+ * requested, restart the dividers once so all the outputs realign together.
+ * @param dev - The device structure.
+ * @param restart - Restart the divider FSM after the update.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t hmc7044_clk_commit(struct hmc7044_dev *dev, bool restart)
+{
+	struct no_os_spi_msg msgs[2 * HMC7044_NUM_CHAN];
+	uint8_t buf[2 * HMC7044_NUM_CHAN][3];
+	struct hmc7044_chan_spec *chan;
+	uint16_t cmd, reg;
+	uint32_t i, n = 0;
+	uint8_t val;
+	int32_t ret;
+
+	for (i = 0; i < dev->num_channels && n < NO_OS_ARRAY_SIZE(msgs); i++) {
+		if (!(dev->staged_mask & NO_OS_BIT(i)))
+			continue;
+
+		chan = &dev->channels[i];
+		/* One frame per divider byte, CS toggling in between */
+		for (reg = HMC7044_REG_CH_OUT_CRTL_1(chan->num);
+		     reg <= HMC7044_REG_CH_OUT_CRTL_2(chan->num); reg++) {
+			cmd = HMC7044_WRITE | HMC7044_CNT(1) |
+			      HMC7044_ADDR(reg);
+			val = (reg == HMC7044_REG_CH_OUT_CRTL_2(chan->num)) ?
+			      HMC7044_DIV_MSB(chan->divider) :
+			      HMC7044_DIV_LSB(chan->divider);
+			buf[n][0] = cmd >> 8;
+			buf[n][1] = cmd & 0xFF;
+			buf[n][2] = val;
+			msgs[n] = (struct no_os_spi_msg) {
+				.tx_buff = buf[n],
+				.rx_buff = buf[n],
+				.bytes_number = 3,
+				.cs_change = 1,
+			};
+			n++;
 		}
 	}
-	if (chan == NULL )
-		return -1;
 
-	div = hmc7044_calc_out_div(rate, dev->pll2_freq);
-	chan->divider = div;
+	if (n) {
+		ret = no_os_spi_transfer(dev->spi_desc, msgs, n);
+		if (ret)
+			return ret;
+	}
+	dev->staged_mask = 0;
+
+	if (!restart)
+		return 0;
+
+	ret = hmc7044_write(dev, HMC7044_REG_REQ_MODE_0,
+			    HMC7044_RESTART_DIV_FSM);
+	if (ret)
+		return ret;
+	no_os_mdelay(1);
+
+	return hmc7044_write(dev, HMC7044_REG_REQ_MODE_0,
+			     (dev->high_performance_mode_clock_dist_en ?
+			      HMC7044_HIGH_PERF_DISTRIB_PATH : 0));
+}
+
+/**
+ * Set channel rate.
+ * @param dev - The device structure.
+ * @param chan_num - Channel number.
+ * @param rate - Channel rate.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t hmc7044_clk_set_rate(struct hmc7044_dev *dev, uint32_t chan_num,
+			     uint64_t rate)
+{
+	int32_t ret;
 
-	ret = hmc7044_write(dev, HMC7044_REG_CH_OUT_CRTL_1(chan->num),
-			    HMC7044_DIV_LSB(div));
-	if(ret < 0)
+	ret = hmc7044_clk_stage_rate(dev, chan_num, rate);
+	if (ret)
 		return ret;
 
-	return hmc7044_write(dev, HMC7044_REG_CH_OUT_CRTL_2(chan->num),
-			     HMC7044_DIV_MSB(div));
+	return hmc7044_clk_commit(dev, false);
 }
 
 /**
@@ -844,6 +917,7 @@ int32_t hmc7044_init(struct hmc7044_dev **device,
 	dev->gpo_ctrl[3] = init_param->gpo_ctrl[3];
 
 	dev->num_channels = init_param->num_channels;
+	dev->staged_mask = 0;
 	dev->channels = (struct hmc7044_chan_spec *)
 			malloc(sizeof(*dev->channels) * dev->num_channels);
 
@@ -88,6 +88,8 @@ struct hmc7044_dev {
 	uint32_t	gpo_ctrl[4];
 	uint32_t	num_channels;
 	struct hmc7044_chan_spec	*channels;
+	/* Channels (indexes in channels) with a staged, uncommitted divider */
+	uint32_t	staged_mask;
 };
 
 struct hmc7044_init_param {
@@ -129,5 +131,10 @@ int32_t hmc7044_clk_round_rate(struct hmc7044_dev *dev, uint32_t rate,
 			       uint64_t *rounded_rate);
 int32_t hmc7044_clk_set_rate(struct hmc7044_dev *dev, uint32_t chan_num,
 			     uint64_t rate);
+/* Stage a channel rate change, applied by hmc7044_clk_commit(). */
+int32_t hmc7044_clk_stage_rate(struct hmc7044_dev *dev, uint32_t chan_num,
+			       uint64_t rate);
+/* Write all the staged dividers at once, optionally restarting them. */
+int32_t hmc7044_clk_commit(struct hmc7044_dev *dev, bool restart);
 
 #endif // HMC7044_H_
@@ -41,7 +41,10 @@
 /***************************** Include Files *********************************/
 /*****************************************************************************/
 #include <stdlib.h>
+#include <string.h>
 #include "ad5933.h"
+#include "no_os_error.h"
+#include "no_os_util.h"
 #include <math.h>
 
 /******************************************************************************/
@@ -49,6 +52,18 @@
 /******************************************************************************/
 const int32_t pow_2_27 = 134217728ul;      // 2 to the power of 27
 
+/* Iterations of the CORDIC, enough for the 16-bit DFT results */
+#define AD5933_CORDIC_ITER	16
+
+/* 1 / CORDIC gain, Q16 */
+#define AD5933_CORDIC_INV_GAIN	39797
+
+/* atan(2^-i) in degrees, Q16 */
+static const int32_t ad5933_cordic_atan[AD5933_CORDIC_ITER] = {
+	2949120, 1740967, 919879, 466945, 234379, 117304, 58666, 29335,
+	14668, 7334, 3667, 1833, 917, 458, 229, 115
+};
+
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
@@ -81,6 +96,8 @@ int32_t ad5933_init(struct ad5933_dev **device,
 	dev->current_clock_source = init_param.current_clock_source;
 	dev->current_gain = init_param.current_gain;
 	dev->current_range = init_param.current_range;
+	dev->addr_pointer = AD5933_PTR_UNKNOWN;
+	dev->sweep_nb_points = 0;
 
 	status = no_os_i2c_init(&dev->i2c_desc, &init_param.i2c_init);
 
@@ -130,6 +147,7 @@ void ad5933_set_register_value(struct ad5933_dev *dev,
 		write_data[1] = (uint8_t)((register_value >> (byte * 8)) & 0xFF);
 		no_os_i2c_write(dev->i2c_desc, write_data, 2, 1);
 	}
+	dev->addr_pointer = AD5933_PTR_UNKNOWN;
 }
 
 /***************************************************************************//**
@@ -161,6 +179,7 @@ uint32_t ad5933_get_register_value(struct ad5933_dev *dev,
 		register_value = register_value << 8;
 		register_value += read_data[0];
 	}
+	dev->addr_pointer = register_address + bytes_number - 1;
 
 	return register_value;
 }
@@ -489,3 +508,291 @@ void ad5933_set_settling_time(struct ad5933_dev *dev,
 				  number_cycles | (multiplier << 9),
 				  2);
 }
+
+/***************************************************************************//**
+ * @brief Starts a function of the control register, with the current range
+ *        and gain.
+ *
+ * @param dev      - The device structure.
+ * @param function - AD5933_CONTROL_FUNCTION(x) option.
+ *
+ * @return None.
+*******************************************************************************/
+static void ad5933_set_function(struct ad5933_dev *dev, uint8_t function)
+{
+	ad5933_set_register_value(dev,
+				  AD5933_REG_CONTROL_HB,
+				  AD5933_CONTROL_FUNCTION(function) |
+				  AD5933_CONTROL_RANGE(dev->current_range) |
+				  AD5933_CONTROL_PGA_GAIN(dev->current_gain),
+				  1);
+}
+
+/***************************************************************************//**
+ * @brief Points the address pointer to a register, unless it already does.
+ *
+ * @param dev              - The device structure.
+ * @param register_address - Address of the register.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+static int32_t ad5933_set_pointer(struct ad5933_dev *dev,
+				  uint8_t register_address)
+{
+	uint8_t write_data[2] = {AD5933_ADDR_POINTER, register_address};
+	int32_t ret;
+
+	if (dev->addr_pointer == register_address)
+		return 0;
+
+	ret = no_os_i2c_write(dev->i2c_desc, write_data, 2, 1);
+	if (ret) {
+		dev->addr_pointer = AD5933_PTR_UNKNOWN;
+		return ret;
+	}
+	dev->addr_pointer = register_address;
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Writes consecutive registers with a single block write.
+ *
+ * @param dev              - The device structure.
+ * @param register_address - Address of the first register.
+ * @param data             - Register values, the first one at
+ *                           register_address.
+ * @param bytes_number     - Number of bytes. At most 8.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+static int32_t ad5933_block_write(struct ad5933_dev *dev,
+				  uint8_t register_address,
+				  const uint8_t *data,
+				  uint8_t bytes_number)
+{
+	uint8_t write_data[10];
+	int32_t ret;
+
+	ret = ad5933_set_pointer(dev, register_address);
+	if (ret)
+		return ret;
+
+	write_data[0] = AD5933_BLOCK_WRITE;
+	write_data[1] = bytes_number;
+	memcpy(&write_data[2], data, bytes_number);
+	dev->addr_pointer = AD5933_PTR_UNKNOWN;
+
+	return no_os_i2c_write(dev->i2c_desc, write_data, bytes_number + 2, 1);
+}
+
+/***************************************************************************//**
+ * @brief Reads consecutive registers with a single block read.
+ *
+ * @param dev              - The device structure.
+ * @param register_address - Address of the first register.
+ * @param data             - Register values, the first one at
+ *                           register_address.
+ * @param bytes_number     - Number of bytes.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+static int32_t ad5933_block_read(struct ad5933_dev *dev,
+				 uint8_t register_address,
+				 uint8_t *data,
+				 uint8_t bytes_number)
+{
+	uint8_t write_data[2] = {AD5933_BLOCK_READ, bytes_number};
+	int32_t ret;
+
+	ret = ad5933_set_pointer(dev, register_address);
+	if (ret)
+		return ret;
+
+	/* Repeated start between the command and the data */
+	ret = no_os_i2c_write(dev->i2c_desc, write_data, 2, 0);
+	if (ret)
+		return ret;
+
+	return no_os_i2c_read(dev->i2c_desc, data, bytes_number, 1);
+}
+
+/***************************************************************************//**
+ * @brief Computes the magnitude and phase of a DFT result with a fixed-point
+ *        CORDIC in vectoring mode.
+ *
+ * @param point - The point, real and imag being the inputs.
+ *
+ * @return None.
+*******************************************************************************/
+static void ad5933_cordic(struct ad5933_sweep_point *point)
+{
+	int32_t x = (int32_t)point->real * 256;
+	int32_t y = (int32_t)point->imag * 256;
+	int32_t angle = 0;
+	int32_t tmp;
+	uint8_t i;
+
+	/* Rotate to the right half plane, where the iterations converge */
+	if (x < 0) {
+		angle = y < 0 ? -(180 << 16) : 180 << 16;
+		x = -x;
+		y = -y;
+	}
+
+	for (i = 0; i < AD5933_CORDIC_ITER; i++) {
+		tmp = x;
+		if (y > 0) {
+			x += y >> i;
+			y -= tmp >> i;
+			angle += ad5933_cordic_atan[i];
+		} else {
+			x -= y >> i;
+			y += tmp >> i;
+			angle -= ad5933_cordic_atan[i];
+		}
+	}
+
+	point->magnitude = ((int64_t)x * AD5933_CORDIC_INV_GAIN) >> 16;
+	point->phase = ((int64_t)angle * 1000) >> 16;
+}
+
+/***************************************************************************//**
+ * @brief Programs the sweep parameters and starts a sweep. The registers of
+ *        the sweep are written in one block write, then each point is read by
+ *        ad5933_sweep_poll(), so the application does not wait for the
+ *        conversions. The settling time, range and gain are the current ones.
+ *
+ * @param dev        - The device structure.
+ * @param start_freq - Start frequency in Hz.
+ * @param inc_freq   - Frequency increment in Hz.
+ * @param inc_num    - Number of increments. Maximum value is 511(0x1FF).
+ * @param points     - Results of the inc_num + 1 points, preallocated.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+int32_t ad5933_sweep_start(struct ad5933_dev *dev,
+			   uint32_t start_freq,
+			   uint32_t inc_freq,
+			   uint16_t inc_num,
+			   struct ad5933_sweep_point *points)
+{
+	uint32_t start_freq_reg;
+	uint32_t inc_freq_reg;
+	uint8_t regs[8];
+	int32_t ret;
+
+	if (!dev || !points || inc_num > AD5933_MAX_INC_NUM)
+		return -EINVAL;
+
+	start_freq_reg = (uint32_t)((double)start_freq * 4 /
+				    dev->current_sys_clk * pow_2_27);
+	inc_freq_reg = (uint32_t)((double)inc_freq * 4 /
+				  dev->current_sys_clk * pow_2_27);
+
+	/* Start frequency, increment and number of increments are contiguous,
+	 * most significant byte first */
+	no_os_put_unaligned_be24(start_freq_reg, &regs[0]);
+	no_os_put_unaligned_be24(inc_freq_reg, &regs[3]);
+	no_os_put_unaligned_be16(inc_num, &regs[6]);
+	ret = ad5933_block_write(dev, AD5933_REG_FREQ_START, regs,
+				 sizeof(regs));
+	if (ret)
+		return ret;
+
+	ad5933_set_function(dev, AD5933_FUNCTION_STANDBY);
+	ad5933_reset(dev);
+	ad5933_set_function(dev, AD5933_FUNCTION_INIT_START_FREQ);
+	ad5933_set_function(dev, AD5933_FUNCTION_START_SWEEP);
+
+	dev->sweep_points = points;
+	dev->sweep_nb_points = inc_num + 1;
+	dev->sweep_idx = 0;
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Advances the sweep started by ad5933_sweep_start(). Checking the
+ *        status costs a single byte read, the address pointer being kept on
+ *        the status register while waiting. Once the point is converted, the
+ *        real and imaginary data are read in one block read and the next
+ *        frequency is started. Meant to be called periodically, for example
+ *        from a timer callback when the I2C driver allows it.
+ *
+ * @param dev - The device structure.
+ *
+ * @return -EAGAIN while the sweep is running, 0 once the last point is read,
+ *         other negative error code in case of failure or if no sweep was
+ *         started.
+*******************************************************************************/
+int32_t ad5933_sweep_poll(struct ad5933_dev *dev)
+{
+	struct ad5933_sweep_point *point;
+	uint8_t data[4];
+	uint8_t status;
+	int32_t ret;
+
+	if (!dev || !dev->sweep_nb_points)
+		return -EINVAL;
+
+	ret = ad5933_set_pointer(dev, AD5933_REG_STATUS);
+	if (ret)
+		return ret;
+
+	ret = no_os_i2c_read(dev->i2c_desc, &status, 1, 1);
+	if (ret)
+		return ret;
+
+	if (!(status & AD5933_STAT_DATA_VALID))
+		return -EAGAIN;
+
+	ret = ad5933_block_read(dev, AD5933_REG_REAL_DATA, data, sizeof(data));
+	if (ret)
+		return ret;
+
+	point = &dev->sweep_points[dev->sweep_idx++];
+	point->real = (int16_t)no_os_get_unaligned_be16(&data[0]);
+	point->imag = (int16_t)no_os_get_unaligned_be16(&data[2]);
+	ad5933_cordic(point);
+
+	if (dev->sweep_idx == dev->sweep_nb_points) {
+		dev->sweep_nb_points = 0;
+		return 0;
+	}
+
+	ad5933_set_function(dev, AD5933_FUNCTION_INC_FREQ);
+
+	return -EAGAIN;
+}
+
+/***************************************************************************//**
+ * @brief Runs a whole sweep, with ad5933_sweep_start() and
+ *        ad5933_sweep_poll().
+ *
+ * @param dev        - The device structure.
+ * @param start_freq - Start frequency in Hz.
+ * @param inc_freq   - Frequency increment in Hz.
+ * @param inc_num    - Number of increments. Maximum value is 511(0x1FF).
+ * @param points     - Results of the inc_num + 1 points, preallocated.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+int32_t ad5933_sweep(struct ad5933_dev *dev,
+		     uint32_t start_freq,
+		     uint32_t inc_freq,
+		     uint16_t inc_num,
+		     struct ad5933_sweep_point *points)
+{
+	int32_t ret;
+
+	ret = ad5933_sweep_start(dev, start_freq, inc_freq, inc_num, points);
+	if (ret)
+		return ret;
+
+	do {
+		ret = ad5933_sweep_poll(dev);
+	} while (ret == -EAGAIN);
+
+	return ret;
+}
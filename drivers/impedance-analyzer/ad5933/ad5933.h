@@ -116,10 +116,28 @@
 #define AD5933_INTERNAL_SYS_CLK     16000000ul      // 16MHz
 #define AD5933_MAX_INC_NUM          511             // Maximum increment number
 
+/* Address pointer state when unknown */
+#define AD5933_PTR_UNKNOWN          0xFF
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
 
+/**
+ * @struct ad5933_sweep_point
+ * @brief Result of a frequency point of a sweep.
+ */
+struct ad5933_sweep_point {
+	/** Real part of the DFT */
+	int16_t real;
+	/** Imaginary part of the DFT */
+	int16_t imag;
+	/** Magnitude of the DFT, in 1/256 of a code */
+	uint32_t magnitude;
+	/** Phase of the DFT, atan2(imag, real), in millidegrees */
+	int32_t phase;
+};
+
 struct ad5933_dev {
 	/* I2C */
 	struct no_os_i2c_desc	*i2c_desc;
@@ -128,6 +146,12 @@ struct ad5933_dev {
 	uint8_t current_clock_source;
 	uint8_t current_gain;
 	uint8_t current_range;
+	/* Register of the address pointer, or AD5933_PTR_UNKNOWN */
+	uint8_t addr_pointer;
+	/* Sweep in progress */
+	struct ad5933_sweep_point *sweep_points;
+	uint16_t sweep_nb_points;
+	uint16_t sweep_idx;
 };
 
 struct ad5933_init_param {
@@ -208,4 +232,21 @@ void ad5933_set_settling_time(struct ad5933_dev *dev,
 			      uint8_t mulitplier,
 			      uint16_t number_cycles);
 
+/*! Programs and starts a sweep, to be advanced by ad5933_sweep_poll(). */
+int32_t ad5933_sweep_start(struct ad5933_dev *dev,
+			   uint32_t start_freq,
+			   uint32_t inc_freq,
+			   uint16_t inc_num,
+			   struct ad5933_sweep_point *points);
+
+/*! Reads the result of the current point, if ready, and moves to the next. */
+int32_t ad5933_sweep_poll(struct ad5933_dev *dev);
+
+/*! Runs a whole sweep. */
+int32_t ad5933_sweep(struct ad5933_dev *dev,
+		     uint32_t start_freq,
+		     uint32_t inc_freq,
+		     uint16_t inc_num,
+		     struct ad5933_sweep_point *points);
+
 #endif /* __AD5933_H__ */
@@ -56,7 +56,8 @@
 const struct no_os_spi_platform_ops demux_spi_platform_ops = {
 	.init = demux_spi_init,
 	.remove = demux_spi_remove,
-	.write_and_read = demux_spi_write_and_read
+	.write_and_read = demux_spi_write_and_read,
+	.transfer = demux_spi_transfer
 };
 
 /**
@@ -71,7 +72,7 @@ int32_t demux_spi_init(struct no_os_spi_desc **desc,
 	int32_t ret;
 
 	struct no_os_spi_desc *descriptor;
-	struct no_os_spi_desc *spi_dev_desc;
+	struct demux_spi_desc *demux;
 	struct no_os_spi_init_param *spi_dev_param;
 
 	if (!param)
@@ -81,19 +82,27 @@ int32_t demux_spi_init(struct no_os_spi_desc **desc,
 	if (!descriptor)
 		return -1;
 
+	demux = (struct demux_spi_desc *)calloc(1, sizeof(*demux));
+	if (!demux) {
+		free(descriptor);
+		return -1;
+	}
+
 	descriptor->chip_select = param->chip_select;
 	descriptor->max_speed_hz = param->max_speed_hz;
 	descriptor->mode = param->mode;
 
 	spi_dev_param = param->extra;
 
-	ret = no_os_spi_init(&spi_dev_desc, spi_dev_param);
+	ret = no_os_spi_init(&demux->spi_dev, spi_dev_param);
 	if (ret != 0) {
+		free(demux);
 		free(descriptor);
 		return -1;
 	}
 
-	(descriptor->extra) = spi_dev_desc;
+	demux->select = CS_OFFSET | param->chip_select;
+	descriptor->extra = demux;
 
 	*desc = descriptor;
 
@@ -107,17 +116,142 @@ int32_t demux_spi_init(struct no_os_spi_desc **desc,
  */
 int32_t demux_spi_remove(struct no_os_spi_desc *desc)
 {
+	struct demux_spi_desc *demux;
+
 	if (!desc)
 		return -1;
 
-	if (no_os_spi_remove(desc->extra))
+	demux = desc->extra;
+	if (no_os_spi_remove(demux->spi_dev))
 		return -1;
 
+	free(demux->msgs);
+	free(demux);
 	free(desc);
 
 	return 0;
 }
 
+/**
+ * @brief Make room for nb messages to the bus.
+ * @param demux - The demux descriptor.
+ * @param nb - Number of messages.
+ * @return 0 in case of success, -ENOMEM otherwise.
+ */
+static int32_t demux_spi_reserve(struct demux_spi_desc *demux, uint32_t nb)
+{
+	struct no_os_spi_msg *msgs;
+
+	if (nb <= demux->nb_msgs)
+		return 0;
+
+	msgs = realloc(demux->msgs, nb * sizeof(*msgs));
+	if (!msgs)
+		return -ENOMEM;
+
+	demux->msgs = msgs;
+	demux->nb_msgs = nb;
+
+	return 0;
+}
+
+/**
+ * @brief Add the messages of a device to the messages for the bus, with a
+ * select byte at the start of each chip select frame. A frame left open by
+ * the previous transfer of the device is continued without a select byte.
+ * @param demux - The demux descriptor of the device.
+ * @param out - Messages for the bus.
+ * @param msgs - Messages of the device.
+ * @param len - Number of messages of the device.
+ * @return Number of messages added to out.
+ */
+static uint32_t demux_spi_frames(struct demux_spi_desc *demux,
+				 struct no_os_spi_msg *out,
+				 const struct no_os_spi_msg *msgs, uint32_t len)
+{
+	uint32_t i;
+	uint32_t n = 0;
+
+	for (i = 0; i < len; i++) {
+		if (!demux->frame_open) {
+			out[n++] = (struct no_os_spi_msg) {
+				.tx_buff = &demux->select,
+				.rx_buff = &demux->select_rx,
+				.bytes_number = 1,
+				.cs_delay_first = msgs[i].cs_delay_first,
+			};
+		}
+		out[n] = msgs[i];
+		if (!demux->frame_open)
+			out[n].cs_delay_first = 0;
+		demux->frame_open = !msgs[i].cs_change;
+		n++;
+	}
+
+	return n;
+}
+
+/**
+ * @brief Send the messages of a device, one chip select frame at a time, when
+ * the bus behind the demux can only do write_and_read.
+ * @param demux - The demux descriptor of the device.
+ * @param msgs - Messages of the device.
+ * @param len - Number of messages.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t demux_spi_transfer_frames(struct demux_spi_desc *demux,
+		struct no_os_spi_msg *msgs, uint32_t len)
+{
+	uint32_t first, last, i;
+	uint32_t size, pos;
+	uint8_t *buff;
+	int32_t ret;
+
+	for (first = 0; first < len; first = last + 1) {
+		/* The frame ends with the message releasing the chip select */
+		size = 1;
+		last = first;
+		while (last < len - 1 && !msgs[last].cs_change)
+			size += msgs[last++].bytes_number;
+		size += msgs[last].bytes_number;
+
+		if (size > UINT16_MAX)
+			return -EINVAL;
+
+		buff = malloc(size);
+		if (!buff)
+			return -ENOMEM;
+
+		buff[0] = demux->select;
+		pos = 1;
+		for (i = first; i <= last; i++) {
+			if (msgs[i].tx_buff)
+				memcpy(buff + pos, msgs[i].tx_buff,
+				       msgs[i].bytes_number);
+			else
+				memset(buff + pos, 0, msgs[i].bytes_number);
+			pos += msgs[i].bytes_number;
+		}
+
+		ret = no_os_spi_write_and_read(demux->spi_dev, buff, size);
+		if (!ret) {
+			pos = 1;
+			for (i = first; i <= last; i++) {
+				if (msgs[i].rx_buff)
+					memcpy(msgs[i].rx_buff, buff + pos,
+					       msgs[i].bytes_number);
+				pos += msgs[i].bytes_number;
+			}
+		}
+
+		free(buff);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
 /**
  * @brief Write and read data to/from SPI demux layer.
  * @param desc - The SPI descriptor.
@@ -128,31 +262,133 @@ int32_t demux_spi_remove(struct no_os_spi_desc *desc)
 int32_t demux_spi_write_and_read(struct no_os_spi_desc *desc, uint8_t *data,
 				 uint16_t bytes_number)
 {
+	struct no_os_spi_msg msg = {
+		.tx_buff = data,
+		.rx_buff = data,
+		.bytes_number = bytes_number,
+		.cs_change = 1,
+	};
+
+	return demux_spi_transfer(desc, &msg, 1);
+}
+
+/**
+ * @brief Send an array of messages to the device behind the demux. The select
+ * byte is sent once per chip select frame and the data is not copied when the
+ * bus behind the demux supports transfer.
+ * @param desc - The SPI descriptor.
+ * @param msgs - Array of messages.
+ * @param len - Number of messages in the array.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t demux_spi_transfer(struct no_os_spi_desc *desc,
+			   struct no_os_spi_msg *msgs, uint32_t len)
+{
+	struct demux_spi_desc *demux;
+	uint32_t n;
 	int32_t ret;
-	uint8_t cs;
-	uint8_t *buff;
 
-	struct no_os_spi_desc *spi_dev;
+	if (!desc || !msgs || !len)
+		return -EINVAL;
 
-	if (!desc)
-		return -1;
+	demux = desc->extra;
+	if (!demux->spi_dev->platform_ops->transfer)
+		return demux_spi_transfer_frames(demux, msgs, len);
 
-	buff = malloc(sizeof(*buff) * (bytes_number+1));
-	if (!buff)
-		return -1;
+	ret = demux_spi_reserve(demux, 2 * len);
+	if (ret)
+		return ret;
+
+	n = demux_spi_frames(demux, demux->msgs, msgs, len);
+	ret = no_os_spi_transfer(demux->spi_dev, demux->msgs, n);
+	if (ret)
+		demux->frame_open = false;
 
-	spi_dev = desc->extra;
-	cs = CS_OFFSET | desc->chip_select;
+	return ret;
+}
 
-	buff[0] = cs;
-	memcpy((buff+1), data, bytes_number);
+/**
+ * @brief Send the messages of several devices behind the same demux in a
+ * single transfer of the bus. The messages are grouped per device, in the
+ * order in which the devices first appear in batch, and keep their order
+ * for each device. A chip select frame still open at the end of the
+ * messages of a device is closed before switching to the next device.
+ * @param batch - Messages of the devices.
+ * @param nb_entries - Number of entries in batch.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t demux_spi_batch_transfer(struct demux_spi_batch *batch,
+				 uint32_t nb_entries)
+{
+	struct demux_spi_desc *demux, *first, *prev = NULL;
+	struct no_os_spi_desc *bus;
+	uint32_t i, j, k, n = 0;
+	uint32_t total = 0;
+	int32_t ret;
+
+	if (!batch || !nb_entries || !batch[0].desc)
+		return -EINVAL;
 
-	ret = no_os_spi_write_and_read(spi_dev, buff, bytes_number+1);
+	first = batch[0].desc->extra;
+	bus = first->spi_dev;
+	for (i = 0; i < nb_entries; i++) {
+		if (!batch[i].desc || !batch[i].msgs)
+			return -EINVAL;
+		demux = batch[i].desc->extra;
+		/* Behind the same demux */
+		if (demux->spi_dev->device_id != bus->device_id ||
+		    demux->spi_dev->platform_ops != bus->platform_ops)
+			return -EINVAL;
+		total += batch[i].len;
+	}
 
-	memcpy(data, buff+1, bytes_number);
+	if (!bus->platform_ops->transfer) {
+		for (i = 0; i < nb_entries; i++) {
+			demux = batch[i].desc->extra;
+			ret = demux_spi_transfer_frames(demux, batch[i].msgs,
+							batch[i].len);
+			if (ret)
+				return ret;
+		}
 
-	free(buff);
+		return 0;
+	}
+
+	ret = demux_spi_reserve(first, 2 * total);
+	if (ret)
+		return ret;
+
+	for (i = 0; i < nb_entries; i++) {
+		/* Skip the devices already grouped with a previous entry */
+		for (k = 0; k < i; k++)
+			if (batch[k].desc == batch[i].desc)
+				break;
+		if (k < i)
+			continue;
+
+		demux = batch[i].desc->extra;
+		if (prev) {
+			/* Release the chip select before the next device */
+			if (prev->frame_open && n)
+				first->msgs[n - 1].cs_change = 1;
+			prev->frame_open = false;
+			demux->frame_open = false;
+		}
+
+		for (j = i; j < nb_entries; j++)
+			if (batch[j].desc == batch[i].desc)
+				n += demux_spi_frames(demux, &first->msgs[n],
+						      batch[j].msgs,
+						      batch[j].len);
+		prev = demux;
+	}
+
+	if (!n)
+		return 0;
+
+	ret = no_os_spi_transfer(bus, first->msgs, n);
+	if (ret && prev)
+		prev->frame_open = false;
 
 	return ret;
 }
-
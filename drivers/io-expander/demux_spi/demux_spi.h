@@ -44,6 +44,7 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 
+#include <stdbool.h>
 #include "no_os_spi.h"
 
 /******************************************************************************/
@@ -56,6 +57,40 @@
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
 
+/**
+ * @struct demux_spi_desc
+ * @brief Demux specific SPI descriptor, the extra of the no_os_spi_desc.
+ * The demux routes a chip select frame to the device selected by the first
+ * byte of the frame.
+ */
+struct demux_spi_desc {
+	/** SPI descriptor of the bus behind the demux */
+	struct no_os_spi_desc *spi_dev;
+	/** Select byte of the device */
+	uint8_t select;
+	/** Receives the data clocked in during the select byte */
+	uint8_t select_rx;
+	/** The last transfer left the chip select asserted on the device */
+	bool frame_open;
+	/** Messages sent to the bus, reused by the transfers */
+	struct no_os_spi_msg *msgs;
+	/** Number of messages that fit in msgs */
+	uint32_t nb_msgs;
+};
+
+/**
+ * @struct demux_spi_batch
+ * @brief Messages for one of the devices behind a demux.
+ */
+struct demux_spi_batch {
+	/** SPI descriptor of the device, initialized with the demux ops */
+	struct no_os_spi_desc *desc;
+	/** Messages for the device */
+	struct no_os_spi_msg *msgs;
+	/** Number of messages */
+	uint32_t len;
+};
+
 /**
  * @struct no_os_spi_desc
  * @brief Structure initialization with the platform specific SPI functions
@@ -77,4 +112,12 @@ int32_t demux_spi_remove(struct no_os_spi_desc *desc);
 int32_t demux_spi_write_and_read(struct no_os_spi_desc *desc, uint8_t *data,
 				 uint16_t bytes_number);
 
+/* Send an array of messages to the device. */
+int32_t demux_spi_transfer(struct no_os_spi_desc *desc,
+			   struct no_os_spi_msg *msgs, uint32_t len);
+
+/* Send the messages of several devices behind the same demux at once. */
+int32_t demux_spi_batch_transfer(struct demux_spi_batch *batch,
+				 uint32_t nb_entries);
+
 #endif /* SRC_DEMUX_SPI_H_ */
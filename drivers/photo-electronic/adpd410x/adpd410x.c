@@ -495,59 +495,218 @@ int32_t adpd410x_get_fifo_bytecount(struct adpd410x_dev *dev, uint16_t *bytes)
 }
 
 /**
- * @brief Get a data packet containing data from all active time slots and
- *        channels. adpd410x_get_data() helper function.
+ * @brief Decode a sample read from the FIFO. The 32-bit samples are sent as
+ *        the low word followed by the high word, each word MSB first.
+ * @param buff - Bytes of the sample.
+ * @param width - Number of bytes of the sample.
+ * @return The sample, 0 for a sample of 0 bytes.
+ */
+static uint32_t adpd410x_fifo_sample(const uint8_t *buff, uint8_t width)
+{
+	switch (width) {
+	case 1:
+		return buff[0];
+	case 2:
+		return (buff[0] << 8) | buff[1];
+	case 3:
+		return (buff[0] << 8) | buff[1] | (buff[2] << 16);
+	case 4:
+		return (buff[0] << 8) | buff[1] | ((uint32_t)buff[2] << 24) |
+		       (buff[3] << 16);
+	default:
+		return 0;
+	}
+}
+
+/**
+ * @brief Compute the layout of the FIFO packets from the number of active time
+ *        slots, their channels and their sample sizes. Must be called again
+ *        when the time slot configuration changes.
  * @param dev - Device handler.
- * @param data - Pointer to the data container.
- * @param no_slots - Number of active time slots.
- * @param dual_chan - Mask showing which of the active time slots are dual
- *                    channeled and which are single channeled.
- * @return 0 in case of success, -1 otherwise.
+ * @return 0 in case of success, negative error code otherwise.
  */
-static int32_t adpd410x_get_data_packet(struct adpd410x_dev *dev,
-					uint32_t *data, uint8_t no_slots,
-					uint16_t dual_chan)
+int32_t adpd410x_update_fifo_layout(struct adpd410x_dev *dev)
 {
+	struct adpd410x_fifo_layout *layout = &dev->layout;
+	uint16_t opmode, ts_ctrl, data1;
+	uint16_t packet_size = 0;
+	uint8_t ts_no, width, nb_samples = 0;
 	int32_t ret;
-	uint16_t temp_data = 0;
-	uint16_t sample_index;
-	int8_t i, got_one = 0;
-	uint8_t *slot_bytecount_tab;
-
-	slot_bytecount_tab = (uint8_t *)calloc(no_slots,
-					       sizeof (*slot_bytecount_tab));
-	if (!slot_bytecount_tab)
-		return -ENOMEM;
-	for(i = 0; i < no_slots; i++) {
-		ret = adpd410x_reg_read(dev, ADPD410X_REG_DATA1(i), &temp_data);
-		if(ret != 0)
-			goto error_slot;
-		slot_bytecount_tab[i] = (temp_data & BITM_DATA1_A_SIGNAL_SIZE);
-	}
+	int8_t i;
+
+	ret = adpd410x_reg_read(dev, ADPD410X_REG_OPMODE, &opmode);
+	if (ret != 0)
+		return ret;
+	ts_no = ((opmode & BITM_OPMODE_TIMESLOT_EN) >>
+		 BITP_OPMODE_TIMESLOT_EN) + 1;
+	if (ts_no > ADPD410X_MAX_SLOT_NUMBER)
+		return -EINVAL;
 
-	i = 0;
-	sample_index = 0;
-	do {
-		ret = adpd410x_read_fifo(dev, data + sample_index, 1, slot_bytecount_tab[i]);
+	for (i = 0; i < ts_no; i++) {
+		ret = adpd410x_reg_read(dev, ADPD410X_REG_TS_CTRL(i), &ts_ctrl);
 		if (ret != 0)
-			goto error_slot;
-
-		sample_index++;
-		if(((dual_chan & (1 << i)) != 0) && (got_one == 0)) {
-			got_one = 1;
-		} else {
-			i++;
-			got_one = 0;
+			return ret;
+		ret = adpd410x_reg_read(dev, ADPD410X_REG_DATA1(i), &data1);
+		if (ret != 0)
+			return ret;
+
+		width = data1 & BITM_DATA1_A_SIGNAL_SIZE;
+		if (width > 4)
+			return -EINVAL;
+
+		layout->width[nb_samples] = width;
+		layout->offset[nb_samples++] = packet_size;
+		packet_size += width;
+		if (ts_ctrl & BITM_TS_CTRL_A_CH2_EN) {
+			layout->width[nb_samples] = width;
+			layout->offset[nb_samples++] = packet_size;
+			packet_size += width;
 		}
-	} while(i < no_slots);
+	}
+
+	layout->nb_samples = nb_samples;
+	layout->packet_size = packet_size;
+	dev->fifo_packets = 0;
 
-	free(slot_bytecount_tab);
 	return 0;
+}
+
+/**
+ * @brief Set the FIFO threshold interrupt on the INTX output. The interrupt is
+ *        cleared by reading the FIFO. Routing INTX to a GPIO is left to the
+ *        caller.
+ * @param dev - Device handler.
+ * @param nb_packets - Number of packets to fire the interrupt at, 0 to disable
+ *                     the interrupt.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t adpd410x_set_fifo_threshold(struct adpd410x_dev *dev,
+				    uint16_t nb_packets)
+{
+	uint32_t bytes = nb_packets * dev->layout.packet_size;
+	uint16_t th_int = BITM_INT_ENABLE_XD_INTX_EN_FIFO_TH;
+	int32_t ret;
 
-error_slot:
-	free(slot_bytecount_tab);
+	if (!nb_packets)
+		return adpd410x_reg_write_mask(dev, ADPD410X_REG_INT_ENABLE_XD,
+					       0, th_int);
 
-	return ret;
+	if (!bytes || bytes > ADPD410X_FIFO_DEPTH)
+		return -EINVAL;
+
+	/* The interrupt fires once the byte count exceeds the threshold */
+	ret = adpd410x_reg_write_mask(dev, ADPD410X_REG_FIFO_TH, bytes - 1,
+				      BITM_FIFO_CTL_FIFO_TH);
+	if (ret != 0)
+		return ret;
+
+	ret = adpd410x_reg_write_mask(dev, ADPD410X_REG_INT_ACLEAR, 1,
+				      BITM_INT_ACLEAR_INT_ACLEAR_FIFO);
+	if (ret != 0)
+		return ret;
+
+	return adpd410x_reg_write_mask(dev, ADPD410X_REG_INT_ENABLE_XD, 1,
+				       th_int);
+}
+
+/**
+ * @brief Read bytes from the FIFO into the FIFO buffer of the device, in one
+ *        transfer for SPI and in transfers of 255 bytes for I2C.
+ * @param dev - Device handler.
+ * @param nb_bytes - Number of bytes, at most ADPD410X_FIFO_DEPTH.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t adpd410x_fifo_burst(struct adpd410x_dev *dev, uint16_t nb_bytes)
+{
+	uint8_t *buff = dev->fifo_buff;
+	uint16_t bytes_read, size;
+	int32_t ret;
+
+	if (dev->dev_type == ADPD4100) {
+		buff[0] = no_os_field_get(ADPD410X_UPPDER_BYTE_SPI_MASK,
+					  ADPD410X_REG_FIFO_DATA);
+		buff[1] = (ADPD410X_REG_FIFO_DATA << 1) &
+			  ADPD410X_LOWER_BYTE_SPI_MASK;
+		memset(buff + 2, 0, nb_bytes);
+
+		return no_os_spi_write_and_read(dev->dev_ops.spi_phy_dev, buff,
+						nb_bytes + 2);
+	}
+
+	for (bytes_read = 0; bytes_read < nb_bytes; bytes_read += size) {
+		size = no_os_min(nb_bytes - bytes_read, 255);
+		ret = adpd410x_reg_read_bytes(dev, ADPD410X_REG_FIFO_DATA,
+					      buff + 2 + bytes_read, size);
+		if (ret != 0)
+			return ret;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Read all the complete packets of the FIFO in one burst. A packet
+ *        still being written is left in the FIFO. The packets are then split
+ *        with adpd410x_get_fifo_packet(), using the layout computed by
+ *        adpd410x_update_fifo_layout().
+ * @param dev - Device handler.
+ * @param nb_packets - Number of packets read.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t adpd410x_read_fifo_burst(struct adpd410x_dev *dev,
+				 uint16_t *nb_packets)
+{
+	uint16_t packet_size = dev->layout.packet_size;
+	uint16_t bytes, packets;
+	int32_t ret;
+
+	*nb_packets = 0;
+	dev->fifo_packets = 0;
+	if (!packet_size)
+		return -EINVAL;
+
+	ret = adpd410x_get_fifo_bytecount(dev, &bytes);
+	if (ret != 0)
+		return ret;
+
+	packets = no_os_min(bytes, ADPD410X_FIFO_DEPTH) / packet_size;
+	if (!packets)
+		return 0;
+
+	ret = adpd410x_fifo_burst(dev, packets * packet_size);
+	if (ret != 0)
+		return ret;
+
+	dev->fifo_packets = packets;
+	*nb_packets = packets;
+
+	return 0;
+}
+
+/**
+ * @brief Split a packet of the last FIFO burst into its samples, one for each
+ *        channel of the active time slots, in time slot order.
+ * @param dev - Device handler.
+ * @param index - Index of the packet in the burst.
+ * @param data - Samples container, of dev->layout.nb_samples elements.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t adpd410x_get_fifo_packet(struct adpd410x_dev *dev, uint16_t index,
+				 uint32_t *data)
+{
+	struct adpd410x_fifo_layout *layout = &dev->layout;
+	const uint8_t *packet;
+	uint8_t i;
+
+	if (index >= dev->fifo_packets)
+		return -EINVAL;
+
+	packet = dev->fifo_buff + 2 + index * layout->packet_size;
+	for (i = 0; i < layout->nb_samples; i++)
+		data[i] = adpd410x_fifo_sample(packet + layout->offset[i],
+					       layout->width[i]);
+
+	return 0;
 }
 
 /**
@@ -565,7 +724,8 @@ int32_t adpd410x_read_fifo(struct adpd410x_dev *dev, uint32_t *data,
 			   uint8_t datawidth)
 {
 	int32_t ret = 0;
-	uint8_t *data_byte_buff, i, j;
+	uint8_t *data_byte_buff;
+	uint16_t j;
 	uint16_t next_packet_size, bytes_read = 0,
 				   total_bytes = num_samples * datawidth;
 	if (datawidth > 4 || total_bytes > ADPD410X_FIFO_DEPTH || data == NULL)
@@ -589,31 +749,9 @@ int32_t adpd410x_read_fifo(struct adpd410x_dev *dev, uint32_t *data,
 		bytes_read += next_packet_size;
 	}
 
-	i = 0;
-	for (j = 0; j < num_samples; j++) {
-		switch(datawidth) {
-		case 0:
-			break;
-		case 1:
-			data[j] = data_byte_buff[i++];
-			break;
-		case 2:
-			data[j]  = data_byte_buff[i++] << 8;
-			data[j] |= data_byte_buff[i++];
-			break;
-		case 3:
-			data[j]  = data_byte_buff[i++] << 8;
-			data[j] |= data_byte_buff[i++];
-			data[j] |= data_byte_buff[i++] << 16;
-			break;
-		case 4:
-			data[j]  = data_byte_buff[i++] << 8;
-			data[j] |= data_byte_buff[i++];
-			data[j] |= data_byte_buff[i++] << 24;
-			data[j] |= data_byte_buff[i++] << 16;
-			break;
-		}
-	}
+	for (j = 0; j < num_samples; j++)
+		data[j] = adpd410x_fifo_sample(data_byte_buff + j * datawidth,
+					       datawidth);
 
 fifo_free_return:
 	free(data_byte_buff);
@@ -630,26 +768,19 @@ fifo_free_return:
 int32_t adpd410x_get_data(struct adpd410x_dev *dev, uint32_t *data)
 {
 	int32_t ret;
-	int8_t i;
-	uint16_t temp_data, dual_chan = 0;
-	uint8_t ts_no;
 
-	ret = adpd410x_reg_read(dev, ADPD410X_REG_OPMODE, &temp_data);
-	if(ret != 0)
+	ret = adpd410x_update_fifo_layout(dev);
+	if (ret != 0)
 		return ret;
-	ts_no = ((temp_data & BITM_OPMODE_TIMESLOT_EN) >>
-		 BITP_OPMODE_TIMESLOT_EN) + 1;
 
-	for(i = 0; i < ts_no; i++) {
-		ret = adpd410x_reg_read(dev, ADPD410X_REG_TS_CTRL(i),
-					&temp_data);
-		if(ret != 0)
+	if (dev->layout.packet_size) {
+		ret = adpd410x_fifo_burst(dev, dev->layout.packet_size);
+		if (ret != 0)
 			return ret;
-		if((temp_data & BITM_TS_CTRL_A_CH2_EN) != 0)
-			dual_chan |= (1 << i);
 	}
+	dev->fifo_packets = 1;
 
-	return adpd410x_get_data_packet(dev, data, ts_no, dual_chan);
+	return adpd410x_get_fifo_packet(dev, 0, data);
 }
 
 /**
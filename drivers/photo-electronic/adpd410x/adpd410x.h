@@ -876,6 +876,8 @@
 #define ADPD410X_MAX_PULSE_LENGTH           255
 #define ADPD410X_MAX_INTEG_OS               255
 #define ADPD410X_FIFO_DEPTH                 512
+/* One sample for each of the two channels of every time slot */
+#define ADPD410X_MAX_PACKET_SAMPLES		(2 * ADPD410X_MAX_SLOT_NUMBER)
 #define ADPD410X_MAX_SAMPLING_FREQ          9000
 
 #define ADPD410X_UPPDER_BYTE_SPI_MASK			0x7f80
@@ -1154,6 +1156,23 @@ enum adpd410x_clk_opt {
 	ADPD410X_GENLFO_EXTHFO
 };
 
+/**
+ * @struct adpd410x_fifo_layout
+ * @brief Layout of a FIFO packet: a sample for each channel of the active time
+ * slots, in time slot order. Computed by adpd410x_update_fifo_layout() so that
+ * the packets are split without reading the time slot configuration.
+ */
+struct adpd410x_fifo_layout {
+	/** Number of samples of a packet */
+	uint8_t nb_samples;
+	/** Size in bytes of each sample, 0 if the sample is not stored */
+	uint8_t width[ADPD410X_MAX_PACKET_SAMPLES];
+	/** Offset in bytes of each sample from the start of the packet */
+	uint8_t offset[ADPD410X_MAX_PACKET_SAMPLES];
+	/** Size of a packet in bytes */
+	uint16_t packet_size;
+};
+
 /**
  * @struct adpd410x_init_param
  * @brief Device driver initialization structure
@@ -1198,6 +1217,12 @@ struct adpd410x_dev {
 	struct no_os_gpio_desc *gpio3;
 	/** External low frequency oscillator frequency, if applicable */
 	uint32_t ext_lfo_freq;
+	/** Layout of the FIFO packets */
+	struct adpd410x_fifo_layout layout;
+	/** Packets of the last FIFO burst, after 2 bytes of SPI address */
+	uint8_t fifo_buff[ADPD410X_FIFO_DEPTH + 2];
+	/** Number of packets in fifo_buff */
+	uint16_t fifo_packets;
 };
 
 /******************************************************************************/
@@ -1260,6 +1285,21 @@ int32_t adpd410x_read_fifo(struct adpd410x_dev *dev, uint32_t *data,
 			   uint16_t num_samples,
 			   uint8_t datawidth);
 
+/** Compute the FIFO packet layout from the time slot configuration. */
+int32_t adpd410x_update_fifo_layout(struct adpd410x_dev *dev);
+
+/** Set the FIFO threshold interrupt, in packets, 0 to disable it. */
+int32_t adpd410x_set_fifo_threshold(struct adpd410x_dev *dev,
+				    uint16_t nb_packets);
+
+/** Read all the complete packets of the FIFO in one burst. */
+int32_t adpd410x_read_fifo_burst(struct adpd410x_dev *dev,
+				 uint16_t *nb_packets);
+
+/** Split a packet of the last FIFO burst into time slot samples. */
+int32_t adpd410x_get_fifo_packet(struct adpd410x_dev *dev, uint16_t index,
+				 uint32_t *data);
+
 /** Get a full data packet from the device containing data from all active time
  *  slots. */
 int32_t adpd410x_get_data(struct adpd410x_dev *dev, uint32_t *data);
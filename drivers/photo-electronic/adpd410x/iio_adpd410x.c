@@ -48,6 +48,7 @@
 #include "adpd410x.h"
 #include "no_os_util.h"
 #include "no_os_error.h"
+#include "iio.h"
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -125,6 +126,76 @@ static int32_t adpd410x_read_samples(void *device, uint32_t *buff,
 	return nb_samples;
 }
 
+/**
+ * @brief Prepare the FIFO streaming: compute the packet layout of the current
+ *        time slot configuration, clear the FIFO and start the conversions.
+ * @param device - Device driver descriptor.
+ * @param mask - Mask of the active channels.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t adpd410x_iio_pre_enable(void *device, uint32_t mask)
+{
+	struct adpd410x_dev *dev = (struct adpd410x_dev *)device;
+	int32_t ret;
+
+	ret = adpd410x_update_fifo_layout(dev);
+	if (ret != 0)
+		return ret;
+
+	/* Channels past the samples of a packet have no time slot behind */
+	if (mask >> dev->layout.nb_samples)
+		return -EINVAL;
+
+	ret = adpd410x_reg_write(dev, ADPD410X_REG_FIFO_STATUS,
+				 BITM_INT_STATUS_FIFO_CLEAR_FIFO);
+	if (ret != 0)
+		return ret;
+
+	return adpd410x_set_opmode(dev, ADPD410X_GOMODE);
+}
+
+/**
+ * @brief Stop the conversions started by adpd410x_iio_pre_enable().
+ * @param device - Device driver descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t adpd410x_iio_post_disable(void *device)
+{
+	return adpd410x_set_opmode(device, ADPD410X_STANDBY);
+}
+
+/**
+ * @brief Drain the FIFO in one burst and push a scan for each packet. Meant to
+ *        be triggered by the FIFO threshold interrupt, set with
+ *        adpd410x_set_fifo_threshold().
+ * @param dev_data - IIO device data.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t adpd410x_iio_trigger_handler(struct iio_device_data *dev_data)
+{
+	struct adpd410x_dev *dev = dev_data->dev;
+	uint32_t data[ADPD410X_MAX_PACKET_SAMPLES];
+	uint16_t nb_packets, i;
+	int32_t ret;
+
+	ret = adpd410x_read_fifo_burst(dev, &nb_packets);
+	if (ret != 0)
+		return ret;
+
+	for (i = 0; i < nb_packets; i++) {
+		ret = adpd410x_get_fifo_packet(dev, i, data);
+		if (ret != 0)
+			return ret;
+
+		ret = iio_buffer_push_samples(dev_data->buffer, data,
+					      sizeof(*data));
+		if (ret != 0)
+			return ret;
+	}
+
+	return 0;
+}
+
 /**
  * @brief Set device sampling frequency.
  * @param device - Device driver descriptor.
@@ -404,6 +475,9 @@ struct iio_device const adpd410x_iio_descriptor = {
 	.channels = adpd410x_iio_channels,
 	.attributes = adpd410x_iio_attributes,
 	.read_dev = (int32_t (*)())adpd410x_read_samples,
+	.pre_enable = adpd410x_iio_pre_enable,
+	.post_disable = adpd410x_iio_post_disable,
+	.trigger_handler = adpd410x_iio_trigger_handler,
 	.debug_reg_read = (int32_t (*)())adpd410x_reg_read,
 	.debug_reg_write = (int32_t (*)())adpd410x_reg_write,
 };
@@ -57,6 +57,14 @@ struct adc_desc {
 	ADI_ADC_HANDLE	dev;
 	/** Active channels. Each bit represents a channel */
 	uint32_t	ch_mask;
+	/** Halves of the stream buffer, submitted in turn */
+	ADI_ADC_BUFFER	stream_buff[2];
+	/** Called when a half of the stream buffer is filled */
+	aducm3029_adc_stream_cb	stream_cb;
+	/** Parameter of stream_cb */
+	void		*stream_ctx;
+	/** Set while the stream is running */
+	volatile bool	streaming;
 };
 
 /**
@@ -95,6 +103,9 @@ int32_t aducm3029_adc_read(struct adc_desc *desc, uint16_t *buff,
 	if (!desc)
 		return -EINVAL;
 
+	if (desc->streaming)
+		return -EBUSY;
+
 	for (i = 0; i < nb_samples; i++) {
 		adi_buff.nChannels = desc->ch_mask;
 		adi_buff.pDataBuffer = buff + i * no_os_hweight32(desc->ch_mask);
@@ -117,6 +128,123 @@ int32_t aducm3029_adc_read(struct adc_desc *desc, uint16_t *buff,
 	return 0;
 }
 
+/**
+ * @brief BSP callback, called by the ADC interrupt handler when the DMA wrote
+ * the last conversion of a submitted buffer. The buffer is given back to the
+ * driver right away, it becomes the next one after the half being filled.
+ * @param param - Adc descriptor
+ * @param event - ADC driver event
+ * @param arg - Processed buffer, for ADI_EVT_BUFFER_PROCESSED
+ */
+static void aducm3029_adc_callback(void *param, uint32_t event, void *arg)
+{
+	struct adc_desc *desc = param;
+	ADI_ADC_BUFFER *adi_buff = arg;
+
+	if (event != ADI_EVT_BUFFER_PROCESSED || !desc->streaming)
+		return;
+
+	desc->stream_cb(desc->stream_ctx, adi_buff->pDataBuffer,
+			adi_buff->nNumConversionPasses);
+
+	/* Stopped meanwhile by the callback */
+	if (!desc->streaming)
+		return;
+
+	adi_adc_SubmitBuffer(desc->dev, adi_buff);
+}
+
+/**
+ * @brief Convert the active channels continuously. The buffer is used as a
+ * ring split in two halves, each half being filled by DMA in turn while the
+ * other one is given to callback, so the core is free, or sleeping, between
+ * the DMA interrupts. aducm3029_adc_read can't be used until the stream is
+ * stopped.
+ * @param desc - Adc descriptor
+ * @param buff - Ring buffer, number of activated channels * nb_scans words.
+ * @param nb_scans - Number of scans of the ring, even.
+ * @param callback - Called from interrupt context for each filled half.
+ * @param ctx - Parameter of callback.
+ * @return 0 in case of success, negative value otherwise.
+ */
+int32_t aducm3029_adc_stream_start(struct adc_desc *desc, uint16_t *buff,
+				   uint32_t nb_scans,
+				   aducm3029_adc_stream_cb callback,
+				   void *ctx)
+{
+	uint32_t half_len;
+	uint32_t nb_ch;
+	int32_t ret;
+	uint32_t i;
+
+	if (!desc || !buff || !callback || !desc->ch_mask || !nb_scans ||
+	    nb_scans % 2)
+		return -EINVAL;
+
+	if (desc->streaming)
+		return -EBUSY;
+
+	nb_ch = no_os_hweight32(desc->ch_mask);
+	desc->stream_cb = callback;
+	desc->stream_ctx = ctx;
+
+	ret = adi_adc_RegisterCallback(desc->dev, aducm3029_adc_callback, desc);
+	if (ret != ADI_ADC_SUCCESS)
+		return -ret;
+
+	desc->streaming = true;
+	half_len = nb_ch * nb_scans / 2;
+	for (i = 0; i < 2; i++) {
+		desc->stream_buff[i].nChannels = desc->ch_mask;
+		desc->stream_buff[i].pDataBuffer = buff + i * half_len;
+		desc->stream_buff[i].nNumConversionPasses = nb_scans / 2;
+		desc->stream_buff[i].nBuffSize = half_len * sizeof(uint16_t);
+		ret = adi_adc_SubmitBuffer(desc->dev, &desc->stream_buff[i]);
+		if (ret != ADI_ADC_SUCCESS)
+			goto error;
+	}
+
+	ret = adi_adc_Enable(desc->dev, true);
+	if (ret != ADI_ADC_SUCCESS)
+		goto error;
+
+	return 0;
+
+error:
+	aducm3029_adc_stream_stop(desc);
+	return -ret;
+}
+
+/**
+ * @brief Stop the conversions started by aducm3029_adc_stream_start. The
+ * half being filled is dropped.
+ * @param desc - Adc descriptor
+ * @return 0 in case of success, negative value otherwise.
+ */
+int32_t aducm3029_adc_stream_stop(struct adc_desc *desc)
+{
+	int32_t ret;
+
+	if (!desc)
+		return -EINVAL;
+
+	if (!desc->streaming)
+		return 0;
+
+	desc->streaming = false;
+
+	ret = adi_adc_Enable(desc->dev, false);
+	if (ret != ADI_ADC_SUCCESS)
+		return -ret;
+
+	/* Back to blocking reads with adi_adc_GetBuffer */
+	ret = adi_adc_RegisterCallback(desc->dev, NULL, NULL);
+	if (ret != ADI_ADC_SUCCESS)
+		return -ret;
+
+	return 0;
+}
+
 /**
  * @brief Allocate adc_desc and initialize adc
  * @param desc - Adc descriptor
@@ -190,6 +318,7 @@ free_desc:
  */
 int32_t aducm3029_adc_remove(struct adc_desc *desc)
 {
+	aducm3029_adc_stream_stop(desc);
 	adi_adc_EnableADCSubSystem(desc->dev, false);
 	adi_adc_PowerUp(desc->dev, false);
 	adi_adc_Close(desc->dev);
@@ -48,6 +48,17 @@
 
 struct adc_desc;
 
+/**
+ * @brief Called from interrupt context when a half of the stream buffer was
+ * filled, while the other half is being filled.
+ * @param ctx - Parameter given to aducm3029_adc_stream_start.
+ * @param block - Scans of the half, the results of the active channels in
+ * increasing channel order for each scan.
+ * @param nb_scans - Number of scans of the half.
+ */
+typedef void (*aducm3029_adc_stream_cb)(void *ctx, uint16_t *block,
+					uint32_t nb_scans);
+
 /**
  * @struct adc_init_param
  * @brief This can be extended in the future, no utility for the moment.
@@ -65,6 +76,15 @@ int32_t aducm3029_adc_update_active_channels(struct adc_desc *desc,
 int32_t aducm3029_adc_read(struct adc_desc *desc, uint16_t *buff,
 			   uint32_t nb_samples);
 
+/* Start converting the active channels continuously, with DMA */
+int32_t aducm3029_adc_stream_start(struct adc_desc *desc, uint16_t *buff,
+				   uint32_t nb_scans,
+				   aducm3029_adc_stream_cb callback,
+				   void *ctx);
+
+/* Stop the conversions started by aducm3029_adc_stream_start */
+int32_t aducm3029_adc_stream_stop(struct adc_desc *desc);
+
 /* Initialize the ADC */
 int32_t aducm3029_adc_init(struct adc_desc **desc,
 			   struct adc_init_param *param);
@@ -41,6 +41,8 @@
 /************************* Include Files **************************************/
 /******************************************************************************/
 
+#include <sys/platform.h>
+#include <drivers/pwr/adi_pwr.h>
 #include "no_os_delay.h"
 #include "no_os_timer.h"
 #include "no_os_error.h"
@@ -136,3 +138,57 @@ void no_os_mdelay(uint32_t msecs)
 			return ;
 	start_and_wait(ms_timer, msecs);
 }
+
+/**
+ * @brief Get the monotonic time in nanoseconds, from the DWT cycle counter
+ * extended to 64 bits. It must be called at least once per counter wrap, every
+ * 2^32 / HCLK seconds, and assumes HCLK is not changed after the first call.
+ * @return Nanoseconds from the start of the cycle counter.
+ */
+uint64_t no_os_time_ns(void)
+{
+	static uint32_t high, last, ns_int, ns_frac;
+	uint32_t primask, now, freq;
+	uint64_t cycles;
+
+	if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)) {
+		CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+		DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	}
+
+	if (!ns_int && !ns_frac) {
+		if (adi_pwr_GetClockFrequency(ADI_CLOCK_HCLK, &freq) || !freq)
+			return 0;
+		/* Nanoseconds per cycle, as 32.32 fixed point */
+		ns_int = 1000000000U / freq;
+		ns_frac = ((uint64_t)(1000000000U % freq) << 32) / freq;
+	}
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	now = DWT->CYCCNT;
+	if (now < last)
+		high++;
+	last = now;
+	cycles = ((uint64_t)high << 32) | now;
+	__set_PRIMASK(primask);
+
+	return cycles * ns_int + (cycles >> 32) * ns_frac +
+	       (((cycles & 0xFFFFFFFF) * ns_frac) >> 32);
+}
+
+/**
+ * @brief Get current time.
+ * @return Current time structure from the start of the cycle counter (seconds,
+ * microseconds).
+ */
+struct no_os_time no_os_get_time(void)
+{
+	uint64_t us = no_os_time_ns() / 1000;
+	struct no_os_time t;
+
+	t.s = us / 1000000;
+	t.us = us % 1000000;
+
+	return t;
+}
@@ -277,6 +277,45 @@ int32_t no_os_flash_write(struct no_os_flash_dev *dev, uint32_t flash_addr,
 	return 0;
 }
 
+/**
+ * Program erased flash memory, without erasing it first. Unlike
+ * no_os_flash_write(), the rest of the page is kept and the update costs a
+ * single program operation, each location being programmed once per erase.
+ *
+ * @param [in] dev        - Pointer to the flash device handler.
+ * @param [in] flash_addr - Start address, aligned on 64 bits.
+ * @param [in] array      - Pointer to the data to be written.
+ * @param [in] array_size - Size of the written data in 32-bit words, even
+ *                          since the flash is programmed in 64-bit units.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_flash_program(struct no_os_flash_dev *dev, uint32_t flash_addr,
+			    uint32_t *array, uint32_t array_size)
+{
+	ADI_FEE_TRANSACTION transaction;
+	struct adicup_flash_dev *adicup_extra = dev->extra;
+	uint32_t fee_hw_error;
+	int32_t ret;
+
+	if ((flash_addr & 0x7) || (array_size & 0x1))
+		return -EINVAL;
+	if (flash_addr + array_size * sizeof(uint32_t) > dev->flash_size)
+		return -EINVAL;
+
+	transaction.bUseDma = false;
+	transaction.nSize = array_size * sizeof(uint32_t);
+	transaction.pWriteAddr = (uint32_t *)flash_addr;
+	transaction.pWriteData = array;
+
+	ret = adi_fee_Write(adicup_extra->instance, &transaction,
+			    &fee_hw_error);
+	if(ret != ADI_FEE_SUCCESS)
+		return -EIO;
+
+	return 0;
+}
+
 /**
  * Read data from the flash memory.
  *
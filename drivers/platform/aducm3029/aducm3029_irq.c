@@ -56,6 +56,10 @@
 #include "aducm3029_timer.h"
 #include "no_os_util.h"
 #include "no_os_list.h"
+#ifdef NO_OS_SCHED
+#include <drivers/pwr/adi_pwr.h>
+#include "no_os_sched.h"
+#endif
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -67,6 +71,9 @@
 /** Number of available external interrupts */
 #define NB_EXT_INTERRUPTS		4u
 
+/** Key unlocking the write of the PMG PWRMOD register */
+#define ADUCM_PMG_PWRKEY		0x4859u
+
 /** Number of interrupts controllers available */
 #define NB_INTERRUPT_CONTROLLERS	1u
 
@@ -550,6 +557,49 @@ static int32_t aducm3029_irq_set_priority(struct no_os_irq_ctrl_desc *desc,
 	return 0;
 }
 
+#ifdef NO_OS_SCHED
+/**
+ * @brief Sleep until the next interrupt if no work is pending, checked with the
+ * interrupts masked. When the scheduler allows it, enter hibernate, woken up
+ * by the external GPIO interrupts or by the RTC alarm of the next timer.
+ */
+void no_os_sched_idle(void)
+{
+	struct no_os_rtc_desc *rtc = no_os_sched_wakeup_rtc();
+	uint32_t sleep_ms, start, end, hz;
+
+	__disable_irq();
+	switch (no_os_sched_sleep_level(&sleep_ms)) {
+	case NO_OS_SCHED_SLEEP_WAIT:
+		__WFI();
+		break;
+	case NO_OS_SCHED_SLEEP_DEEP:
+		if (rtc) {
+			/* freq is the prescaler, AUDCM_32768HZ to AUDCM_1HZ */
+			hz = 32768 >> rtc->freq;
+			no_os_rtc_get_cnt(rtc, &start);
+			end = start + (uint64_t)sleep_ms * hz / 1000;
+			if (sleep_ms != NO_OS_SCHED_FOREVER)
+				no_os_rtc_set_irq_time(rtc, end);
+		}
+		pADI_PMG0->PWRKEY = ADUCM_PMG_PWRKEY;
+		pADI_PMG0->PWRMOD = ADI_PWR_MODE_HIBERNATE;
+		SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+		__WFI();
+		SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+		if (rtc) {
+			no_os_rtc_get_cnt(rtc, &end);
+			end -= start;
+			no_os_sched_time_skip((uint64_t)end * 1000 / hz);
+		}
+		break;
+	default:
+		break;
+	}
+	__enable_irq();
+}
+#endif
+
 /**
  * @brief Aducm3029 platform specific IRQ platform ops structure
  */
@@ -192,3 +192,26 @@ int32_t no_os_rtc_set_cnt(struct no_os_rtc_desc *dev, uint32_t tmr_cnt)
 
 	return adi_rtc_SetCount(adev->instance, tmr_cnt);
 }
+
+/**
+ * @brief Set the time at which an interrupt will occur.
+ * @param dev - The RTC descriptor.
+ * @param irq_time - Value of the counter generating the alarm interrupt.
+ * @return 0 in case of success, -1 otherwise.
+ */
+int32_t no_os_rtc_set_irq_time(struct no_os_rtc_desc *dev, uint32_t irq_time)
+{
+	struct aducm_rtc_desc *adev;
+
+	if (!dev)
+		return -1;
+	adev = dev->extra;
+
+	if (adi_rtc_SetAlarm(adev->instance, irq_time))
+		return -1;
+
+	if (adi_rtc_EnableInterrupts(adev->instance, ADI_RTC_ALARM_INT, true))
+		return -1;
+
+	return adi_rtc_EnableAlarm(adev->instance, true);
+}
@@ -73,6 +73,12 @@ struct no_os_trng_desc {
 	uint32_t	dev_mem[(ADI_RNG_MEMORY_SIZE + 3)/4];
 	/* DFP Hanler */
 	ADI_RNG_HANDLE	dev;
+	/* Callback of the background generation, NULL when stopped */
+	no_os_trng_callback	callback;
+	/* Parameter of callback */
+	void		*ctx;
+	/* Set when the generator got stuck during the background generation */
+	bool		stuck;
 };
 
 /******************************************************************************/
@@ -138,8 +144,11 @@ int32_t no_os_trng_init(struct no_os_trng_desc **desc,
 void no_os_trng_remove(struct no_os_trng_desc *desc)
 {
 	nb_references--;
-	if (nb_references == 0)
+	if (nb_references == 0) {
+		if (desc->callback)
+			no_os_trng_stop_async(desc);
 		no_os_gdesc_remove();
+	}
 }
 
 /**
@@ -158,6 +167,9 @@ int32_t no_os_trng_fill_buffer(struct no_os_trng_desc *desc, uint8_t *buff,
 	bool		ready;
 	bool		stuck;
 
+	if (desc->callback)
+		return -EBUSY;
+
 	for (i = 0; i < len; i++) {
 		ready = 0;
 		while (!ready)
@@ -175,3 +187,82 @@ int32_t no_os_trng_fill_buffer(struct no_os_trng_desc *desc, uint8_t *buff,
 
 	return 0;
 }
+
+/**
+ * @brief Stop the background generation
+ * @param desc - TRNG descriptor
+ */
+void no_os_trng_stop_async(struct no_os_trng_desc *desc)
+{
+	adi_rng_Enable(desc->dev, false);
+	adi_rng_RegisterCallback(desc->dev, NULL, NULL);
+	desc->callback = NULL;
+}
+
+/**
+ * @brief RNG interrupt callback, passing each generated byte to the
+ * background generation callback
+ * @param param - TRNG descriptor
+ * @param event - ADI_RNG_EVENT_READY or ADI_RNG_EVENT_STUCK
+ * @param arg - Unused
+ */
+static void no_os_trng_event(void *param, uint32_t event, void *arg)
+{
+	struct no_os_trng_desc	*desc = param;
+	uint32_t		data;
+	uint8_t			byte;
+
+	NO_OS_UNUSED_PARAM(arg);
+
+	if (!desc->callback)
+		return;
+
+	if (event == ADI_RNG_EVENT_STUCK) {
+		/* Cleared by the next no_os_trng_start_async() */
+		desc->stuck = true;
+		no_os_trng_stop_async(desc);
+		return;
+	}
+
+	adi_rng_GetRngData(desc->dev, &data);
+	byte = data & 0xFF;
+	if (!desc->callback(desc->ctx, &byte, 1))
+		no_os_trng_stop_async(desc);
+}
+
+/**
+ * @brief Generate random numbers in background, from the RNG interrupt. The
+ * blocking no_os_trng_fill_buffer() returns -EBUSY meanwhile.
+ * @param desc - TRNG descriptor
+ * @param callback - Called from interrupt context with each random byte
+ * @param ctx - Parameter of callback
+ * @return 0 in case of success, negative error code otherwise
+ */
+int32_t no_os_trng_start_async(struct no_os_trng_desc *desc,
+			       no_os_trng_callback callback, void *ctx)
+{
+	if (!desc || !callback)
+		return -EINVAL;
+
+	if (desc->callback)
+		return -EBUSY;
+
+	if (desc->stuck) {
+		/* This is needed in order to clear the stuck bit */
+		no_os_gdesc_remove();
+		no_os_gdesc_init();
+		desc->stuck = false;
+	}
+
+	desc->ctx = ctx;
+	desc->callback = callback;
+	if (adi_rng_RegisterCallback(desc->dev, no_os_trng_event,
+				     desc) != ADI_RNG_SUCCESS) {
+		desc->callback = NULL;
+		return -EIO;
+	}
+
+	adi_rng_Enable(desc->dev, true);
+
+	return 0;
+}
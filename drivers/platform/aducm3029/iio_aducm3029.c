@@ -44,6 +44,7 @@
 #include <sys/platform.h>
 #include "no_os_pwm.h"
 #include "no_os_gpio.h"
+#include "iio.h"
 #include "iio_aducm3029.h"
 #include "aducm3029_adc.h"
 #include "no_os_error.h"
@@ -183,6 +184,7 @@ int set_global_attr(void *device, char *buf, uint32_t len,
 							 &default_adc_init_param);
 			}
 		} else {
+			iio_aducm3029_adc_post_disable(desc);
 			ret = aducm3029_adc_remove(desc->adc);
 			desc->adc = NULL;
 		}
@@ -378,6 +380,67 @@ int32_t iio_aducm3029_adc_read(struct iio_aducm3029_desc *desc, uint16_t *buff,
 	return aducm3029_adc_read(desc->adc, buff, nb_samples);
 }
 
+/* Push the scans of a half of the ring, in interrupt context */
+static void iio_aducm3029_adc_block_done(void *ctx, uint16_t *block,
+		uint32_t nb_scans)
+{
+	struct iio_aducm3029_desc *desc = ctx;
+	uint8_t *scan = (uint8_t *)block;
+	uint32_t i;
+
+	/* The ADC writes the active channels of a scan next to each other */
+	for (i = 0; i < nb_scans; i++) {
+		if (iio_buffer_push_scan(desc->buffer, scan))
+			return;
+		scan += desc->buffer->bytes_per_scan;
+	}
+}
+
+/* Start streaming the active ADC channels to the iio buffer */
+int32_t iio_aducm3029_adc_submit(struct iio_device_data *dev_data)
+{
+	struct iio_aducm3029_desc *desc = dev_data->dev;
+	int32_t ret;
+
+	if (!desc->adc)
+		return -ENODEV;
+
+	/* Once started, the stream fills the buffer on its own */
+	if (desc->streaming)
+		return 0;
+
+	desc->buffer = dev_data->buffer;
+	ret = aducm3029_adc_stream_start(desc->adc, desc->ring,
+					 ADUCM3029_IIO_RING_SCANS,
+					 iio_aducm3029_adc_block_done, desc);
+	if (ret)
+		return ret;
+
+	desc->streaming = true;
+
+	return 0;
+}
+
+/* Stop the stream started by iio_aducm3029_adc_submit */
+int32_t iio_aducm3029_adc_post_disable(struct iio_aducm3029_desc *desc)
+{
+	int32_t ret;
+
+	if (!desc)
+		return -EINVAL;
+
+	if (!desc->streaming)
+		return 0;
+
+	ret = aducm3029_adc_stream_stop(desc->adc);
+	if (ret)
+		return ret;
+
+	desc->streaming = false;
+
+	return 0;
+}
+
 #define IIO_PWM_ATTR(_name, _priv) {\
 	.name = _name,\
 	.priv = _priv,\
@@ -385,7 +448,7 @@ int32_t iio_aducm3029_adc_read(struct iio_aducm3029_desc *desc, uint16_t *buff,
 	.store = set_pwm_attr\
 }
 
-static struct iio_attribute pwm_attributes[] = {
+static const struct iio_attribute pwm_attributes[] = {
 	IIO_PWM_ATTR("en", PWM_ENABLE),
 	IIO_PWM_ATTR("period", PWM_PERIOD),
 	IIO_PWM_ATTR("duty_cycle", PWM_DUTY_CYCLE),
@@ -400,7 +463,7 @@ static struct iio_attribute pwm_attributes[] = {
 	.store = set_gpio_attr\
 }
 
-static struct iio_attribute gpio_attributes[] = {
+static const struct iio_attribute gpio_attributes[] = {
 	IIO_GPIO_ATTR("en", GPIO_ENABLE),
 	IIO_GPIO_ATTR("value", GPIO_VALUE),
 	IIO_GPIO_ATTR("is_output", GPIO_DIRECTION_OUTPUT),
@@ -408,7 +471,7 @@ static struct iio_attribute gpio_attributes[] = {
 	END_ATTRIBUTES_ARRAY,
 };
 
-static struct scan_type adc_scan_type = {
+static const struct scan_type adc_scan_type = {
 	.realbits = 12,
 	.storagebits = 16,
 	.shift = 0,
@@ -440,7 +503,7 @@ static struct scan_type adc_scan_type = {
 	.attributes = gpio_attributes,\
 	.ch_out = true}
 
-static struct iio_channel aducm3029_channels[] = {
+static const struct iio_channel aducm3029_channels[] = {
 	ADCUM3029_ADC_CH(0),
 	ADCUM3029_ADC_CH(1),
 	ADCUM3029_ADC_CH(2),
@@ -460,7 +523,7 @@ static struct iio_channel aducm3029_channels[] = {
 	.store = set_global_attr\
 }
 
-static struct iio_attribute aducm3029_attributes[] = {
+static const struct iio_attribute aducm3029_attributes[] = {
 	GLOBAL_ATTR("pinmux_port0_cfg", PINMUX_PORT_0),
 	GLOBAL_ATTR("pinmux_port1_cfg", PINMUX_PORT_1),
 	GLOBAL_ATTR("pinmux_port2_cfg", PINMUX_PORT_2),
@@ -472,8 +535,10 @@ struct iio_device const iio_aducm3029_desc = {
 	.num_ch = NO_OS_ARRAY_SIZE(aducm3029_channels),
 	.channels = aducm3029_channels,
 	.attributes = aducm3029_attributes,
+	.lock_free_buffer = true,
 	.pre_enable = (int32_t (*)())iio_aducm3029_adc_set_mask,
-	.read_dev = (int32_t (*)())iio_aducm3029_adc_read,
+	.post_disable = (int32_t (*)())iio_aducm3029_adc_post_disable,
+	.submit = iio_aducm3029_adc_submit,
 };
 
 struct iio_aducm3029_desc g_aducm3029_desc;
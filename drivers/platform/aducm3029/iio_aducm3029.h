@@ -47,9 +47,17 @@
 
 #define ADUCM3029_TIMERS_NUMS	3
 #define ADUCM3029_GPIOS_NUMS	44
+/* Scans of the ring filled by the ADC stream, in two halves */
+#define ADUCM3029_IIO_RING_SCANS	128
 
 struct iio_aducm3029_desc {
 	struct adc_desc		*adc;
+	/* Buffer receiving the ADC scans while streaming */
+	struct iio_buffer	*buffer;
+	/* Set while the ADC stream is running */
+	bool			streaming;
+	uint16_t		ring[ADUCM3029_IIO_RING_SCANS *
+					     ADUCM3029_ADC_NUM_CH];
 	struct no_os_timer_desc	*timer[ADUCM3029_TIMERS_NUMS];
 	struct no_os_pwm_desc		*pwm[ADUCM3029_TIMERS_NUMS];
 	struct no_os_gpio_desc	*gpio[ADUCM3029_GPIOS_NUMS];
@@ -78,6 +86,8 @@ int32_t iio_aducm3029_adc_set_mask(struct iio_aducm3029_desc *desc,
 				   uint32_t mask);
 int32_t iio_aducm3029_adc_read(struct iio_aducm3029_desc *desc, uint16_t *buff,
 			       uint32_t nb_samples);
+int32_t iio_aducm3029_adc_submit(struct iio_device_data *dev_data);
+int32_t iio_aducm3029_adc_post_disable(struct iio_aducm3029_desc *desc);
 
 enum iio_pwm_attributes {
 	PWM_ENABLE,
@@ -50,30 +50,21 @@
 /******************************************************************************/
 
 /**
- * @brief AXI IO Altera specific read function.
+ * @brief AXI IO Altera specific buffer write function. The words bypass the
+ * data cache.
  * @param base - Base address
  * @param offset - Address offset
- * @param data - variable where returned data is stored
+ * @param data - Words to be written.
+ * @param nb_words - Number of words.
  * @return 0 in case of success, -1 otherwise.
  */
-int32_t no_os_axi_io_read(uint32_t base, uint32_t offset, uint32_t *data)
+int32_t no_os_axi_io_write_buf(uint32_t base, uint32_t offset,
+			       const uint32_t *data, uint32_t nb_words)
 {
-	*data = IORD_32DIRECT(base, offset);
+	uint32_t i;
 
-	return 0;
-}
-
-/**
- * @brief AXI IO Altera specific write function.
- * @param base - Base address
- * @param offset - Address offset
- * @param data - data to be written
- * @return 0 in case of success, -1 otherwise.
- */
-int32_t no_os_axi_io_write(uint32_t base, uint32_t offset, uint32_t data)
-{
-	IOWR_32DIRECT(base, offset, data);
+	for (i = 0; i < nb_words; i++)
+		IOWR_32DIRECT(base, offset + i * sizeof(*data), data[i]);
 
 	return 0;
 }
-
@@ -0,0 +1,300 @@
+/***************************************************************************//**
+ *   @file   altera/altera_msgdma.c
+ *   @brief  no_os_dma backend of the Altera Modular Scatter-Gather DMA.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <io.h>
+#include "no_os_error.h"
+#include "no_os_util.h"
+#include "altera_msgdma.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Dispatcher CSR registers */
+#define ALTERA_MSGDMA_CSR_STATUS		0x00
+#define ALTERA_MSGDMA_CSR_CONTROL		0x04
+
+#define ALTERA_MSGDMA_STATUS_BUSY		NO_OS_BIT(0)
+#define ALTERA_MSGDMA_STATUS_DESC_EMPTY		NO_OS_BIT(1)
+#define ALTERA_MSGDMA_STATUS_DESC_FULL		NO_OS_BIT(2)
+#define ALTERA_MSGDMA_STATUS_RESETTING		NO_OS_BIT(6)
+#define ALTERA_MSGDMA_STATUS_IRQ		NO_OS_BIT(9)
+
+#define ALTERA_MSGDMA_CONTROL_RESET		NO_OS_BIT(1)
+#define ALTERA_MSGDMA_CONTROL_GLOBAL_IRQ	NO_OS_BIT(4)
+
+/* Standard descriptor format */
+#define ALTERA_MSGDMA_DESC_READ_ADDR		0x00
+#define ALTERA_MSGDMA_DESC_WRITE_ADDR		0x04
+#define ALTERA_MSGDMA_DESC_LENGTH		0x08
+#define ALTERA_MSGDMA_DESC_CONTROL		0x0C
+
+#define ALTERA_MSGDMA_DESC_CONTROL_IRQ		NO_OS_BIT(14)
+#define ALTERA_MSGDMA_DESC_CONTROL_GO		NO_OS_BIT(31)
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Reset the dispatcher, dropping the queued descriptors and stopping
+ * the one running.
+ * @param mdesc - The mSGDMA descriptor.
+ */
+static void altera_msgdma_reset(struct altera_msgdma_desc *mdesc)
+{
+	IOWR_32DIRECT(mdesc->csr_base, ALTERA_MSGDMA_CSR_CONTROL,
+		      ALTERA_MSGDMA_CONTROL_RESET);
+	while (IORD_32DIRECT(mdesc->csr_base, ALTERA_MSGDMA_CSR_STATUS) &
+	       ALTERA_MSGDMA_STATUS_RESETTING) {}
+
+	IOWR_32DIRECT(mdesc->csr_base, ALTERA_MSGDMA_CSR_STATUS,
+		      ALTERA_MSGDMA_STATUS_IRQ);
+	IOWR_32DIRECT(mdesc->csr_base, ALTERA_MSGDMA_CSR_CONTROL,
+		      mdesc->irq ? ALTERA_MSGDMA_CONTROL_GLOBAL_IRQ : 0);
+	mdesc->remaining = 0;
+}
+
+/**
+ * @brief Queue the descriptors of the transfer while the dispatcher has room
+ * for them. The control word, written last, commits each descriptor.
+ * @param mdesc - The mSGDMA descriptor.
+ */
+static void altera_msgdma_refill(struct altera_msgdma_desc *mdesc)
+{
+	uint32_t len;
+
+	while (mdesc->remaining &&
+	       !(IORD_32DIRECT(mdesc->csr_base, ALTERA_MSGDMA_CSR_STATUS) &
+		 ALTERA_MSGDMA_STATUS_DESC_FULL)) {
+		len = no_os_min(mdesc->remaining, mdesc->max_length);
+
+		IOWR_32DIRECT(mdesc->desc_base, ALTERA_MSGDMA_DESC_READ_ADDR,
+			      mdesc->src);
+		IOWR_32DIRECT(mdesc->desc_base, ALTERA_MSGDMA_DESC_WRITE_ADDR,
+			      mdesc->dst);
+		IOWR_32DIRECT(mdesc->desc_base, ALTERA_MSGDMA_DESC_LENGTH, len);
+		IOWR_32DIRECT(mdesc->desc_base, ALTERA_MSGDMA_DESC_CONTROL,
+			      ALTERA_MSGDMA_DESC_CONTROL_GO |
+			      ALTERA_MSGDMA_DESC_CONTROL_IRQ);
+
+		/* The streaming side has no address */
+		if (mdesc->direction != NO_OS_DMA_DEV_TO_MEM)
+			mdesc->src += len;
+		if (mdesc->direction != NO_OS_DMA_MEM_TO_DEV)
+			mdesc->dst += len;
+		mdesc->remaining -= len;
+	}
+}
+
+/**
+ * @brief Queue the next descriptors and report the end of the transfer once
+ * all of them are done.
+ * @param ch - The DMA channel.
+ */
+static void altera_msgdma_update(struct no_os_dma_ch *ch)
+{
+	struct altera_msgdma_desc *mdesc = ch->desc->extra;
+	uint32_t status;
+
+	IOWR_32DIRECT(mdesc->csr_base, ALTERA_MSGDMA_CSR_STATUS,
+		      ALTERA_MSGDMA_STATUS_IRQ);
+	altera_msgdma_refill(mdesc);
+	if (mdesc->remaining)
+		return;
+
+	status = IORD_32DIRECT(mdesc->csr_base, ALTERA_MSGDMA_CSR_STATUS);
+	if (!(status & ALTERA_MSGDMA_STATUS_BUSY) &&
+	    (status & ALTERA_MSGDMA_STATUS_DESC_EMPTY))
+		no_os_dma_xfer_done(ch);
+}
+
+/**
+ * @brief mSGDMA interrupt handler, raised at the end of each descriptor.
+ * @param context - The no_os_dma controller.
+ */
+void altera_msgdma_irq_handler(void *context)
+{
+	struct no_os_dma_desc *desc = context;
+	struct altera_msgdma_desc *mdesc = desc->extra;
+
+	if (!desc->channels[0].busy) {
+		IOWR_32DIRECT(mdesc->csr_base, ALTERA_MSGDMA_CSR_STATUS,
+			      ALTERA_MSGDMA_STATUS_IRQ);
+		return;
+	}
+
+	altera_msgdma_update(&desc->channels[0]);
+}
+
+/**
+ * @brief Initialize a no_os_dma controller of one mSGDMA core, its only
+ * channel.
+ * @param desc - The DMA controller descriptor.
+ * @param param - Initialization parameters, extra being an
+ * altera_msgdma_init_param.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t altera_msgdma_init(struct no_os_dma_desc *desc,
+				  const struct no_os_dma_init_param *param)
+{
+	struct altera_msgdma_init_param *mparam = param->extra;
+	struct altera_msgdma_desc *mdesc;
+
+	if (!mparam || param->num_ch != 1 || !mparam->max_length)
+		return -EINVAL;
+
+	mdesc = calloc(1, sizeof(*mdesc));
+	if (!mdesc)
+		return -ENOMEM;
+
+	mdesc->csr_base = mparam->csr_base;
+	mdesc->desc_base = mparam->desc_base;
+	mdesc->direction = mparam->direction;
+	mdesc->max_length = mparam->max_length;
+	mdesc->irq = mparam->irq;
+	altera_msgdma_reset(mdesc);
+
+	desc->extra = mdesc;
+
+	return 0;
+}
+
+/**
+ * @brief Stop the core and free the resources of the controller.
+ * @param desc - The DMA controller descriptor.
+ * @return 0 in case of success.
+ */
+static int32_t altera_msgdma_remove(struct no_os_dma_desc *desc)
+{
+	struct altera_msgdma_desc *mdesc = desc->extra;
+
+	altera_msgdma_reset(mdesc);
+	IOWR_32DIRECT(mdesc->csr_base, ALTERA_MSGDMA_CSR_CONTROL, 0);
+	free(mdesc);
+
+	return 0;
+}
+
+/**
+ * @brief Program a transfer. The direction is fixed by the configuration of
+ * the core.
+ * @param ch - The DMA channel.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t altera_msgdma_config_xfer(struct no_os_dma_ch *ch)
+{
+	struct altera_msgdma_desc *mdesc = ch->desc->extra;
+	struct no_os_dma_xfer *xfer = ch->xfer;
+
+	if (xfer->xfer_type != mdesc->direction || !xfer->length)
+		return -EINVAL;
+
+	if (xfer->cyclic)
+		return -ENOTSUP;
+
+	mdesc->src = xfer->xfer_type == NO_OS_DMA_DEV_TO_MEM ? 0 :
+		     (uintptr_t)xfer->src;
+	mdesc->dst = xfer->xfer_type == NO_OS_DMA_MEM_TO_DEV ? 0 :
+		     (uintptr_t)xfer->dst;
+	mdesc->remaining = 0;
+
+	return 0;
+}
+
+/**
+ * @brief Start the programmed transfer, queueing its first descriptors.
+ * @param ch - The DMA channel.
+ * @return 0 in case of success.
+ */
+static int32_t altera_msgdma_xfer_start(struct no_os_dma_ch *ch)
+{
+	struct altera_msgdma_desc *mdesc = ch->desc->extra;
+
+	/* Keep the handler from queueing descriptors at the same time */
+	IOWR_32DIRECT(mdesc->csr_base, ALTERA_MSGDMA_CSR_CONTROL, 0);
+	mdesc->remaining = ch->xfer->length;
+	altera_msgdma_refill(mdesc);
+	if (mdesc->irq)
+		IOWR_32DIRECT(mdesc->csr_base, ALTERA_MSGDMA_CSR_CONTROL,
+			      ALTERA_MSGDMA_CONTROL_GLOBAL_IRQ);
+
+	return 0;
+}
+
+/**
+ * @brief Stop the transfer running on the channel.
+ * @param ch - The DMA channel.
+ * @return 0 in case of success.
+ */
+static int32_t altera_msgdma_xfer_abort(struct no_os_dma_ch *ch)
+{
+	altera_msgdma_reset(ch->desc->extra);
+
+	return 0;
+}
+
+/**
+ * @brief Follow a transfer of a core used without interrupt. With the
+ * interrupt, the handler does it and this does nothing.
+ * @param ch - The DMA channel.
+ */
+static void altera_msgdma_xfer_poll(struct no_os_dma_ch *ch)
+{
+	struct altera_msgdma_desc *mdesc = ch->desc->extra;
+
+	if (!mdesc->irq)
+		altera_msgdma_update(ch);
+}
+
+/**
+ * @brief Altera mSGDMA platform ops structure
+ */
+const struct no_os_dma_platform_ops altera_msgdma_ops = {
+	.init = &altera_msgdma_init,
+	.remove = &altera_msgdma_remove,
+	.config_xfer = &altera_msgdma_config_xfer,
+	.xfer_start = &altera_msgdma_xfer_start,
+	.xfer_abort = &altera_msgdma_xfer_abort,
+	.xfer_poll = &altera_msgdma_xfer_poll,
+};
@@ -0,0 +1,120 @@
+/***************************************************************************//**
+ *   @file   altera/altera_msgdma.h
+ *   @brief  Header file of the no_os_dma backend of the Altera mSGDMA.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef ALTERA_MSGDMA_H_
+#define ALTERA_MSGDMA_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "no_os_dma.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct altera_msgdma_init_param
+ * @brief Parameters of one mSGDMA core, the init_param.extra of a no_os_dma
+ * controller using altera_msgdma_ops. The controller has one channel.
+ */
+struct altera_msgdma_init_param {
+	/** Base address of the dispatcher CSR port */
+	uint32_t			csr_base;
+	/** Base address of the dispatcher descriptor port */
+	uint32_t			desc_base;
+	/**
+	 * DMA mode set in Platform Designer: NO_OS_DMA_MEM_TO_DEV for
+	 * memory-mapped to streaming, NO_OS_DMA_DEV_TO_MEM for streaming to
+	 * memory-mapped, NO_OS_DMA_MEM_TO_MEM for memory-mapped to
+	 * memory-mapped.
+	 */
+	enum no_os_dma_xfer_type	direction;
+	/** Maximum transfer length set in Platform Designer, in bytes */
+	uint32_t			max_length;
+	/**
+	 * Set if altera_msgdma_irq_handler is registered for the interrupt of
+	 * the core, otherwise the transfers are followed by polling.
+	 */
+	bool				irq;
+};
+
+/**
+ * @struct altera_msgdma_desc
+ * @brief Altera mSGDMA core and the transfer it runs.
+ */
+struct altera_msgdma_desc {
+	/** Base address of the dispatcher CSR port */
+	uint32_t			csr_base;
+	/** Base address of the dispatcher descriptor port */
+	uint32_t			desc_base;
+	/** DMA mode of the core */
+	enum no_os_dma_xfer_type	direction;
+	/** Maximum length of one descriptor */
+	uint32_t			max_length;
+	/** Transfers followed by the interrupt handler */
+	bool				irq;
+	/** Read address of the next descriptor */
+	uintptr_t			src;
+	/** Write address of the next descriptor */
+	uintptr_t			dst;
+	/** Bytes of the transfer not given to the dispatcher yet */
+	uint32_t			remaining;
+};
+
+/**
+ * @brief Altera mSGDMA platform ops structure. Transfers longer than
+ * max_length are split in descriptors, queued while the dispatcher has
+ * room for them. Cyclic transfers are not supported.
+ */
+extern const struct no_os_dma_platform_ops altera_msgdma_ops;
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/*
+ * mSGDMA interrupt handler, to be registered with alt_ic_isr_register() with
+ * the no_os_dma controller as context.
+ */
+void altera_msgdma_irq_handler(void *context);
+
+#endif /* ALTERA_MSGDMA_H_ */
@@ -42,14 +42,14 @@
 /******************************************************************************/
 
 #include <stdlib.h>
+#include <stdbool.h>
 #include <altera_avalon_spi_regs.h>
 #include "parameters.h"
 #include "no_os_error.h"
+#include "no_os_delay.h"
 #include "no_os_spi.h"
 #include "altera_spi.h"
 
-#warning SPI delays are not supported on the altera platform
-
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
@@ -86,6 +86,8 @@ int32_t altera_spi_init(struct no_os_spi_desc **desc,
 
 	altera_descriptor->type = altera_param->type;
 	altera_descriptor->base_address = altera_param->base_address;
+	altera_descriptor->fifo_depth = altera_param->fifo_depth ?
+					altera_param->fifo_depth : 1;
 
 	*desc = descriptor;
 
@@ -99,69 +101,168 @@ int32_t altera_spi_init(struct no_os_spi_desc **desc,
  */
 int32_t altera_spi_remove(struct no_os_spi_desc *desc)
 {
-	if (desc) {
-		// Unused variable - fix compiler warning
-	}
+	if (!desc)
+		return -1;
+
+	free(desc->extra);
+	free(desc);
 
 	return 0;
 }
 
 /**
- * @brief Write and read data to/from SPI.
+ * @brief Assert or deassert the slave select of the device. The core keeps
+ * it asserted between the words while SSO is set.
  * @param desc - The SPI descriptor.
- * @param data - The buffer with the transmitted/received data.
- * @param bytes_number - Number of bytes to write/read.
- * @return 0 in case of success, -1 otherwise.
+ * @param assert - true to select the device.
  */
+static void altera_spi_cs(struct no_os_spi_desc *desc, bool assert)
+{
+	struct altera_spi_desc *altera_desc = desc->extra;
+	uint32_t base = altera_desc->base_address;
 
-int32_t altera_spi_write_and_read(struct no_os_spi_desc *desc,
-				  uint8_t *data,
-				  uint16_t bytes_number)
+	if (assert) {
+		IOWR_32DIRECT(base, (ALTERA_AVALON_SPI_SLAVE_SEL_REG * 4),
+			      (0x1 << (desc->chip_select)));
+		IOWR_32DIRECT(base, (ALTERA_AVALON_SPI_CONTROL_REG * 4),
+			      ALTERA_AVALON_SPI_CONTROL_SSO_MSK);
+		return;
+	}
+
+	/* Let the last word leave the shift register */
+	while (!(IORD_32DIRECT(base, (ALTERA_AVALON_SPI_STATUS_REG * 4)) &
+		 ALTERA_AVALON_SPI_STATUS_TMT_MSK)) {}
+	IOWR_32DIRECT(base, (ALTERA_AVALON_SPI_SLAVE_SEL_REG * 4), 0x000);
+	IOWR_32DIRECT(base, (ALTERA_AVALON_SPI_CONTROL_REG * 4), 0x000);
+}
+
+/**
+ * @brief Shift the bytes of one message. Up to fifo_depth + 1 words are kept
+ * in flight, so the core starts each word as soon as the previous one is out,
+ * instead of idling while the CPU reads the received word and writes the
+ * next one.
+ * @param altera_desc - The Altera SPI descriptor.
+ * @param tx - Bytes to send, NULL to send zeros.
+ * @param rx - Where to store the received bytes, NULL to drop them.
+ * @param len - Number of bytes.
+ * @return 0 in case of success, -EIO if a received word was overwritten.
+ */
+static int32_t altera_spi_burst(struct altera_spi_desc *altera_desc,
+				const uint8_t *tx, uint8_t *rx, uint32_t len)
+{
+	uint32_t base = altera_desc->base_address;
+	uint32_t in_flight = altera_desc->fifo_depth + 1;
+	uint32_t tx_cnt = 0;
+	uint32_t rx_cnt = 0;
+	uint32_t status;
+	uint8_t word;
+
+	/* Drop a stale received word and clear the error flags */
+	IORD_32DIRECT(base, (ALTERA_AVALON_SPI_RXDATA_REG * 4));
+	IOWR_32DIRECT(base, (ALTERA_AVALON_SPI_STATUS_REG * 4), 0);
+
+	while (rx_cnt < len) {
+		status = IORD_32DIRECT(base,
+				       (ALTERA_AVALON_SPI_STATUS_REG * 4));
+		if (status & ALTERA_AVALON_SPI_STATUS_ROE_MSK)
+			return -EIO;
+
+		/* Read first, the receive side is the one that can overrun */
+		if (status & ALTERA_AVALON_SPI_STATUS_RRDY_MSK) {
+			word = IORD_32DIRECT(base,
+					     ALTERA_AVALON_SPI_RXDATA_REG * 4);
+			if (rx)
+				rx[rx_cnt] = word;
+			rx_cnt++;
+		}
+
+		if (tx_cnt < len && tx_cnt - rx_cnt < in_flight &&
+		    (status & ALTERA_AVALON_SPI_STATUS_TRDY_MSK)) {
+			IOWR_32DIRECT(base, (ALTERA_AVALON_SPI_TXDATA_REG * 4),
+				      tx ? tx[tx_cnt] : 0);
+			tx_cnt++;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Send a list of messages, the slave select being deasserted only
+ * after the messages with cs_change set.
+ * @param desc - The SPI descriptor.
+ * @param msgs - The messages.
+ * @param len - Number of messages.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t altera_spi_transfer(struct no_os_spi_desc *desc,
+			    struct no_os_spi_msg *msgs,
+			    uint32_t len)
 {
-	uint32_t i;
 	struct altera_spi_desc *altera_desc;
+	int32_t ret;
+	uint32_t i;
+
+	if (!desc || !desc->extra || (!msgs && len))
+		return -EINVAL;
 
 	altera_desc = desc->extra;
+	if (altera_desc->type != NIOS_II_SPI)
+		return -EINVAL;
 
-	switch(altera_desc->type) {
-	case NIOS_II_SPI:
-		IOWR_32DIRECT(altera_desc->base_address,
-			      (ALTERA_AVALON_SPI_CONTROL_REG * 4),
-			      ALTERA_AVALON_SPI_CONTROL_SSO_MSK);
-		IOWR_32DIRECT(altera_desc->base_address,
-			      (ALTERA_AVALON_SPI_SLAVE_SEL_REG * 4),
-			      (0x1 << (desc->chip_select)));
-		for (i = 0; i < bytes_number; i++) {
-			while ((IORD_32DIRECT(altera_desc->base_address,
-					      (ALTERA_AVALON_SPI_STATUS_REG * 4)) &
-				ALTERA_AVALON_SPI_STATUS_TRDY_MSK) == 0x00) {}
-			IOWR_32DIRECT(altera_desc->base_address,
-				      (ALTERA_AVALON_SPI_TXDATA_REG * 4),
-				      *(data + i));
-			while ((IORD_32DIRECT(altera_desc->base_address,
-					      (ALTERA_AVALON_SPI_STATUS_REG * 4)) &
-				ALTERA_AVALON_SPI_STATUS_RRDY_MSK) == 0x00) {}
-			*(data + i) = IORD_32DIRECT(altera_desc->base_address,
-						    (ALTERA_AVALON_SPI_RXDATA_REG * 4));
+	for (i = 0; i < len; i++) {
+		altera_spi_cs(desc, true);
+
+		if (msgs[i].cs_delay_first)
+			no_os_udelay(msgs[i].cs_delay_first);
+
+		ret = altera_spi_burst(altera_desc, msgs[i].tx_buff,
+				       msgs[i].rx_buff, msgs[i].bytes_number);
+		if (ret) {
+			altera_spi_cs(desc, false);
+			return ret;
 		}
-		IOWR_32DIRECT(altera_desc->base_address,
-			      (ALTERA_AVALON_SPI_SLAVE_SEL_REG * 4), 0x000);
-		IOWR_32DIRECT(altera_desc->base_address,
-			      (ALTERA_AVALON_SPI_CONTROL_REG * 4), 0x000);
 
-		break;
-	default:
-		return -1;
+		if (msgs[i].cs_delay_last)
+			no_os_udelay(msgs[i].cs_delay_last);
+
+		if (msgs[i].cs_change)
+			altera_spi_cs(desc, false);
+
+		if (msgs[i].cs_change_delay)
+			no_os_udelay(msgs[i].cs_change_delay);
 	}
 
 	return 0;
 }
 
+/**
+ * @brief Write and read data to/from SPI.
+ * @param desc - The SPI descriptor.
+ * @param data - The buffer with the transmitted/received data.
+ * @param bytes_number - Number of bytes to write/read.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t altera_spi_write_and_read(struct no_os_spi_desc *desc,
+				  uint8_t *data,
+				  uint16_t bytes_number)
+{
+	struct no_os_spi_msg msg = {
+		.tx_buff = data,
+		.rx_buff = data,
+		.bytes_number = bytes_number,
+		.cs_change = 1,
+	};
+
+	return altera_spi_transfer(desc, &msg, 1);
+}
+
 /**
  * @brief Altera platform specific SPI platform ops structure
  */
 const struct no_os_spi_platform_ops altera_spi_ops  = {
 	.init = &altera_spi_init,
 	.write_and_read = &altera_spi_write_and_read,
+	.transfer = &altera_spi_transfer,
 	.remove = &altera_spi_remove
 };
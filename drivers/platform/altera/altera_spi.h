@@ -64,6 +64,12 @@ struct altera_spi_init_param {
 	enum spi_type	type;
 	/** SPI base address */
 	uint32_t	base_address;
+	/**
+	 * Words the core buffers on each side besides the shift register: 1
+	 * for the standard core and its holding registers, 0 also meaning 1.
+	 * Set to the FIFO depth of a core with FIFOs to burst more words.
+	 */
+	uint32_t	fifo_depth;
 };
 
 /**
@@ -75,6 +81,8 @@ struct altera_spi_desc {
 	enum spi_type	type;
 	/** SPI base address */
 	uint32_t	base_address;
+	/** Words in flight besides the one being shifted */
+	uint32_t	fifo_depth;
 };
 
 /**
@@ -80,3 +80,22 @@ int32_t no_os_axi_io_write(uint32_t base, uint32_t offset, uint32_t data)
 
 	return 0;
 }
+
+/**
+ * @brief AXI IO generic buffer write function.
+ * @param base - Base address
+ * @param offset - Address offset
+ * @param data - Words to be written.
+ * @param nb_words - Number of words.
+ * @return 0 in case of success, -1 otherwise.
+ */
+int32_t no_os_axi_io_write_buf(uint32_t base, uint32_t offset,
+			       const uint32_t *data, uint32_t nb_words)
+{
+	NO_OS_UNUSED_PARAM(base);
+	NO_OS_UNUSED_PARAM(offset);
+	NO_OS_UNUSED_PARAM(data);
+	NO_OS_UNUSED_PARAM(nb_words);
+
+	return 0;
+}
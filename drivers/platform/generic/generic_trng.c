@@ -85,3 +85,20 @@ int32_t no_os_trng_fill_buffer(struct no_os_trng_desc *desc, uint8_t *buff,
 
 	return -1;
 }
+
+/* Generate random numbers in background */
+int32_t no_os_trng_start_async(struct no_os_trng_desc *desc,
+			       no_os_trng_callback callback, void *ctx)
+{
+	NO_OS_UNUSED_PARAM(desc);
+	NO_OS_UNUSED_PARAM(callback);
+	NO_OS_UNUSED_PARAM(ctx);
+
+	return -ENOSYS;
+}
+
+/* Stop the background generation */
+void no_os_trng_stop_async(struct no_os_trng_desc *desc)
+{
+	NO_OS_UNUSED_PARAM(desc);
+}
@@ -190,3 +190,27 @@ int32_t no_os_axi_io_write(uint32_t base, uint32_t offset, uint32_t data)
 	return uio_read_write(base, offset, NULL, &data);
 #endif
 }
+
+/**
+ * @brief AXI IO through UIO specific buffer write function.
+ * @param base - UIO index (/dev/uioX).
+ * @param offset - Address offset.
+ * @param data - Words to be written.
+ * @param nb_words - Number of words.
+ * @return 0 in case of success, -1 otherwise.
+ */
+int32_t no_os_axi_io_write_buf(uint32_t base, uint32_t offset,
+			       const uint32_t *data, uint32_t nb_words)
+{
+	int32_t ret;
+	uint32_t i;
+
+	for (i = 0; i < nb_words; i++) {
+		ret = no_os_axi_io_write(base, offset + i * sizeof(*data),
+					 data[i]);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
@@ -0,0 +1,597 @@
+/***************************************************************************//**
+ *   @file   linux/linux_gpio_irq.c
+ *   @brief  Implementation of Linux platform GPIO IRQ Driver.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "no_os_error.h"
+#include "no_os_irq.h"
+#include "no_os_list.h"
+#include "linux_gpio_irq.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct linux_gpio_irq_action
+ * @brief Callback registered for a GPIO
+ */
+struct linux_gpio_irq_action {
+	/** GPIO number */
+	uint32_t irq_id;
+	/** /sys/class/gpio/gpio"irq_id"/value file descriptor */
+	int value_fd;
+	/** Set while the GPIO is watched by epoll */
+	bool enabled;
+	void (*callback)(void *context);
+	void *ctx;
+};
+
+/**
+ * @struct linux_gpio_irq_desc
+ * @brief Linux platform specific GPIO IRQ controller descriptor
+ */
+struct linux_gpio_irq_desc {
+	int epoll_fd;
+	/** Used to stop the dispatch thread */
+	int event_fd;
+	pthread_t thread;
+	/** Protects actions, recursive so callbacks can use the controller */
+	pthread_mutex_t lock;
+	struct no_os_list_desc *actions;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+static int32_t linux_gpio_irq_action_cmp(void *data1, void *data2)
+{
+	return ((struct linux_gpio_irq_action *)data1)->irq_id -
+	       ((struct linux_gpio_irq_action *)data2)->irq_id;
+}
+
+/**
+ * @brief Find the action registered for a GPIO. Must be called with the
+ * lock taken.
+ * @param linux_desc - Linux GPIO IRQ descriptor.
+ * @param irq_id - GPIO number.
+ * @return The action or NULL if none is registered.
+ */
+static struct linux_gpio_irq_action *linux_gpio_irq_find(
+	struct linux_gpio_irq_desc *linux_desc, uint32_t irq_id)
+{
+	struct linux_gpio_irq_action key = {.irq_id = irq_id};
+	struct linux_gpio_irq_action *action;
+
+	if (no_os_list_read_find(linux_desc->actions, (void **)&action, &key))
+		return NULL;
+
+	return action;
+}
+
+/**
+ * @brief Consume the pending event of a GPIO. sysfs reports the edge as
+ * POLLPRI until the value file is read again from the start.
+ * @param action - The GPIO action.
+ */
+static void linux_gpio_irq_ack(struct linux_gpio_irq_action *action)
+{
+	char buf[4];
+
+	if (lseek(action->value_fd, 0, SEEK_SET) == 0)
+		(void)read(action->value_fd, buf, sizeof(buf));
+}
+
+/**
+ * @brief Dispatch thread. Waits for GPIO events and calls their callbacks.
+ * @param arg - Linux GPIO IRQ descriptor.
+ * @return NULL
+ */
+static void *linux_gpio_irq_thread(void *arg)
+{
+	struct linux_gpio_irq_desc *linux_desc = arg;
+	struct linux_gpio_irq_action *action;
+	struct epoll_event events[8];
+	int n;
+	int i;
+
+	while (true) {
+		n = epoll_wait(linux_desc->epoll_fd, events,
+			       sizeof(events) / sizeof(events[0]), -1);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+
+		for (i = 0; i < n; i++) {
+			/* The stop request */
+			if (!events[i].data.ptr)
+				return NULL;
+
+			pthread_mutex_lock(&linux_desc->lock);
+			action = events[i].data.ptr;
+			/* It may have been disabled by a previous callback */
+			if (action->enabled) {
+				linux_gpio_irq_ack(action);
+				if (action->callback)
+					action->callback(action->ctx);
+			}
+			pthread_mutex_unlock(&linux_desc->lock);
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Initialize the GPIO interrupt controller and start the dispatch
+ * thread.
+ * @param desc - Pointer where the configured instance is stored.
+ * @param param - Configuration information for the instance.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t linux_gpio_irq_ctrl_init(struct no_os_irq_ctrl_desc **desc,
+		const struct no_os_irq_init_param *param)
+{
+	struct epoll_event ev = {
+		.events = EPOLLIN,
+		.data.ptr = NULL,
+	};
+	struct linux_gpio_irq_desc *linux_desc;
+	struct no_os_irq_ctrl_desc *descriptor;
+	pthread_mutexattr_t attr;
+	int ret;
+
+	if (!desc || !param)
+		return -EINVAL;
+
+	descriptor = calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return -ENOMEM;
+
+	linux_desc = calloc(1, sizeof(*linux_desc));
+	if (!linux_desc) {
+		ret = -ENOMEM;
+		goto free_desc;
+	}
+
+	ret = no_os_list_init(&linux_desc->actions, NO_OS_LIST_PRIORITY_LIST,
+			      linux_gpio_irq_action_cmp);
+	if (ret)
+		goto free_linux_desc;
+
+	linux_desc->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if (linux_desc->epoll_fd < 0) {
+		ret = -errno;
+		goto free_list;
+	}
+
+	linux_desc->event_fd = eventfd(0, EFD_CLOEXEC);
+	if (linux_desc->event_fd < 0) {
+		ret = -errno;
+		goto close_epoll;
+	}
+
+	if (epoll_ctl(linux_desc->epoll_fd, EPOLL_CTL_ADD, linux_desc->event_fd,
+		      &ev)) {
+		ret = -errno;
+		goto close_event;
+	}
+
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&linux_desc->lock, &attr);
+	pthread_mutexattr_destroy(&attr);
+
+	ret = pthread_create(&linux_desc->thread, NULL, linux_gpio_irq_thread,
+			     linux_desc);
+	if (ret) {
+		printf("%s: Can't create the dispatch thread\n\r", __func__);
+		ret = -ret;
+		goto free_lock;
+	}
+
+	descriptor->irq_ctrl_id = param->irq_ctrl_id;
+	descriptor->extra = linux_desc;
+
+	*desc = descriptor;
+
+	return 0;
+
+free_lock:
+	pthread_mutex_destroy(&linux_desc->lock);
+close_event:
+	close(linux_desc->event_fd);
+close_epoll:
+	close(linux_desc->epoll_fd);
+free_list:
+	no_os_list_remove(linux_desc->actions);
+free_linux_desc:
+	free(linux_desc);
+free_desc:
+	free(descriptor);
+
+	return ret;
+}
+
+/**
+ * @brief Stop the dispatch thread and free the resources allocated by
+ * linux_gpio_irq_ctrl_init().
+ * @param desc - GPIO interrupt controller descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t linux_gpio_irq_ctrl_remove(struct no_os_irq_ctrl_desc *desc)
+{
+	struct linux_gpio_irq_desc *linux_desc;
+	struct linux_gpio_irq_action *action;
+	uint64_t stop = 1;
+
+	if (!desc || !desc->extra)
+		return -EINVAL;
+
+	linux_desc = desc->extra;
+
+	if (write(linux_desc->event_fd, &stop, sizeof(stop)) != sizeof(stop))
+		return -errno;
+	pthread_join(linux_desc->thread, NULL);
+
+	while (!no_os_list_get_first(linux_desc->actions, (void **)&action)) {
+		close(action->value_fd);
+		free(action);
+	}
+	no_os_list_remove(linux_desc->actions);
+
+	pthread_mutex_destroy(&linux_desc->lock);
+	close(linux_desc->event_fd);
+	close(linux_desc->epoll_fd);
+	free(linux_desc);
+	free(desc);
+
+	return 0;
+}
+
+/**
+ * @brief Register a callback for a GPIO. The GPIO is not watched until the
+ * interrupt is enabled.
+ * @param desc - GPIO interrupt controller descriptor.
+ * @param irq_id - GPIO number.
+ * @param cb - Descriptor of the callback.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t linux_gpio_irq_register_callback(struct no_os_irq_ctrl_desc
+		*desc,
+		uint32_t irq_id,
+		struct no_os_callback_desc *cb)
+{
+	struct linux_gpio_irq_desc *linux_desc;
+	struct linux_gpio_irq_action *action;
+	char path[64];
+	int ret = 0;
+
+	if (!desc || !desc->extra || !cb)
+		return -EINVAL;
+
+	linux_desc = desc->extra;
+
+	pthread_mutex_lock(&linux_desc->lock);
+
+	action = linux_gpio_irq_find(linux_desc, irq_id);
+	if (!action) {
+		action = calloc(1, sizeof(*action));
+		if (!action) {
+			ret = -ENOMEM;
+			goto unlock;
+		}
+
+		snprintf(path, sizeof(path), "/sys/class/gpio/gpio%d/value",
+			 irq_id);
+		action->value_fd = open(path, O_RDONLY | O_CLOEXEC);
+		if (action->value_fd < 0) {
+			printf("%s: Can't open %s\n\r", __func__, path);
+			ret = -errno;
+			free(action);
+			goto unlock;
+		}
+
+		action->irq_id = irq_id;
+		ret = no_os_list_add_last(linux_desc->actions, action);
+		if (ret) {
+			close(action->value_fd);
+			free(action);
+			goto unlock;
+		}
+	}
+
+	action->callback = cb->callback;
+	action->ctx = cb->ctx;
+
+unlock:
+	pthread_mutex_unlock(&linux_desc->lock);
+
+	return ret;
+}
+
+/**
+ * @brief Disable the interrupt of a GPIO. Must be called with the lock taken.
+ * @param linux_desc - Linux GPIO IRQ descriptor.
+ * @param action - The GPIO action.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t linux_gpio_irq_stop(struct linux_gpio_irq_desc *linux_desc,
+				   struct linux_gpio_irq_action *action)
+{
+	if (!action->enabled)
+		return 0;
+
+	if (epoll_ctl(linux_desc->epoll_fd, EPOLL_CTL_DEL, action->value_fd,
+		      NULL))
+		return -errno;
+
+	action->enabled = false;
+
+	return 0;
+}
+
+/**
+ * @brief Unregister the callback of a GPIO.
+ * @param desc - GPIO interrupt controller descriptor.
+ * @param irq_id - GPIO number.
+ * @param cb - Descriptor of the callback.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t linux_gpio_irq_unregister_callback(struct no_os_irq_ctrl_desc
+		*desc,
+		uint32_t irq_id,
+		struct no_os_callback_desc *cb)
+{
+	struct linux_gpio_irq_action key = {.irq_id = irq_id};
+	struct linux_gpio_irq_desc *linux_desc;
+	struct linux_gpio_irq_action *action;
+	int ret;
+
+	if (!desc || !desc->extra)
+		return -EINVAL;
+
+	linux_desc = desc->extra;
+
+	pthread_mutex_lock(&linux_desc->lock);
+
+	ret = no_os_list_get_find(linux_desc->actions, (void **)&action, &key);
+	if (ret) {
+		ret = -ENODEV;
+		goto unlock;
+	}
+
+	linux_gpio_irq_stop(linux_desc, action);
+	close(action->value_fd);
+	free(action);
+
+unlock:
+	pthread_mutex_unlock(&linux_desc->lock);
+
+	return ret;
+}
+
+/**
+ * @brief Set the edge a GPIO interrupt is triggered on. sysfs only reports
+ * edges, so the level triggers are not supported.
+ * @param desc - GPIO interrupt controller descriptor.
+ * @param irq_id - GPIO number.
+ * @param trig - The trigger condition.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t linux_gpio_irq_trigger_level_set(struct no_os_irq_ctrl_desc
+		*desc,
+		uint32_t irq_id,
+		enum no_os_irq_trig_level trig)
+{
+	const char *edge;
+	char path[64];
+	int ret;
+	int fd;
+
+	switch (trig) {
+	case NO_OS_IRQ_EDGE_FALLING:
+		edge = "falling";
+		break;
+	case NO_OS_IRQ_EDGE_RISING:
+		edge = "rising";
+		break;
+	case NO_OS_IRQ_EDGE_BOTH:
+		edge = "both";
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	snprintf(path, sizeof(path), "/sys/class/gpio/gpio%d/edge", irq_id);
+	fd = open(path, O_WRONLY);
+	if (fd < 0) {
+		printf("%s: Can't open %s\n\r", __func__, path);
+		return -errno;
+	}
+
+	ret = write(fd, edge, strlen(edge));
+	close(fd);
+	if (ret < 0)
+		return -errno;
+
+	return 0;
+}
+
+/**
+ * @brief Enable the interrupt of a GPIO. Events that happened before are
+ * discarded.
+ * @param desc - GPIO interrupt controller descriptor.
+ * @param irq_id - GPIO number.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t linux_gpio_irq_enable(struct no_os_irq_ctrl_desc *desc,
+				     uint32_t irq_id)
+{
+	struct linux_gpio_irq_desc *linux_desc;
+	struct linux_gpio_irq_action *action;
+	struct epoll_event ev = {
+		.events = EPOLLPRI | EPOLLERR,
+	};
+	int ret = 0;
+
+	if (!desc || !desc->extra)
+		return -EINVAL;
+
+	linux_desc = desc->extra;
+
+	pthread_mutex_lock(&linux_desc->lock);
+
+	action = linux_gpio_irq_find(linux_desc, irq_id);
+	if (!action) {
+		ret = -ENODEV;
+		goto unlock;
+	}
+
+	if (action->enabled)
+		goto unlock;
+
+	linux_gpio_irq_ack(action);
+
+	ev.data.ptr = action;
+	if (epoll_ctl(linux_desc->epoll_fd, EPOLL_CTL_ADD, action->value_fd,
+		      &ev)) {
+		ret = -errno;
+		goto unlock;
+	}
+
+	action->enabled = true;
+
+unlock:
+	pthread_mutex_unlock(&linux_desc->lock);
+
+	return ret;
+}
+
+/**
+ * @brief Disable the interrupt of a GPIO.
+ * @param desc - GPIO interrupt controller descriptor.
+ * @param irq_id - GPIO number.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t linux_gpio_irq_disable(struct no_os_irq_ctrl_desc *desc,
+				      uint32_t irq_id)
+{
+	struct linux_gpio_irq_desc *linux_desc;
+	struct linux_gpio_irq_action *action;
+	int ret;
+
+	if (!desc || !desc->extra)
+		return -EINVAL;
+
+	linux_desc = desc->extra;
+
+	pthread_mutex_lock(&linux_desc->lock);
+
+	action = linux_gpio_irq_find(linux_desc, irq_id);
+	ret = action ? linux_gpio_irq_stop(linux_desc, action) : -ENODEV;
+
+	pthread_mutex_unlock(&linux_desc->lock);
+
+	return ret;
+}
+
+/**
+ * @brief Block the dispatch of all the callbacks. Events are kept pending.
+ * @param desc - GPIO interrupt controller descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t linux_gpio_irq_global_disable(struct no_os_irq_ctrl_desc *desc)
+{
+	struct linux_gpio_irq_desc *linux_desc;
+
+	if (!desc || !desc->extra)
+		return -EINVAL;
+
+	linux_desc = desc->extra;
+
+	return -pthread_mutex_lock(&linux_desc->lock);
+}
+
+/**
+ * @brief Allow again the dispatch of the callbacks.
+ * @param desc - GPIO interrupt controller descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t linux_gpio_irq_global_enable(struct no_os_irq_ctrl_desc *desc)
+{
+	struct linux_gpio_irq_desc *linux_desc;
+
+	if (!desc || !desc->extra)
+		return -EINVAL;
+
+	linux_desc = desc->extra;
+
+	return -pthread_mutex_unlock(&linux_desc->lock);
+}
+
+/**
+ * @brief Linux platform specific GPIO IRQ platform ops structure
+ */
+const struct no_os_irq_platform_ops linux_gpio_irq_ops = {
+	.init = &linux_gpio_irq_ctrl_init,
+	.register_callback = &linux_gpio_irq_register_callback,
+	.unregister_callback = &linux_gpio_irq_unregister_callback,
+	.global_enable = &linux_gpio_irq_global_enable,
+	.global_disable = &linux_gpio_irq_global_disable,
+	.trigger_level_set = &linux_gpio_irq_trigger_level_set,
+	.enable = &linux_gpio_irq_enable,
+	.disable = &linux_gpio_irq_disable,
+	.remove = &linux_gpio_irq_ctrl_remove,
+};
@@ -45,11 +45,13 @@
 #include "no_os_i2c.h"
 #include "linux_i2c.h"
 
+#include <errno.h>
 #include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
+#include <linux/i2c.h>
 #include <linux/i2c-dev.h>
 
 /******************************************************************************/
@@ -221,9 +223,63 @@ int32_t linux_i2c_read(struct no_os_i2c_desc *desc,
 /**
  * @brief Linux platform specific I2C platform ops structure
  */
+/**
+ * @brief Send multiple messages to/from a slave device, with one I2C_RDWR
+ * ioctl, so the kernel separates them with repeated starts.
+ * @param desc - The I2C descriptor.
+ * @param msgs - Array of messages.
+ * @param len - Number of messages in the array.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_i2c_transfer(struct no_os_i2c_desc *desc,
+			   struct no_os_i2c_msg *msgs,
+			   uint32_t len)
+{
+	struct i2c_rdwr_ioctl_data rdwr;
+	struct linux_i2c_desc *linux_desc;
+	struct i2c_msg *i2c_msgs;
+	uint32_t i;
+	int ret;
+
+	if (!len)
+		return 0;
+
+	if (len > I2C_RDWR_IOCTL_MAX_MSGS)
+		return -EINVAL;
+
+	linux_desc = desc->extra;
+
+	i2c_msgs = calloc(len, sizeof(*i2c_msgs));
+	if (!i2c_msgs)
+		return -ENOMEM;
+
+	for (i = 0; i < len; i++) {
+		i2c_msgs[i].addr = desc->slave_address;
+		i2c_msgs[i].flags = msgs[i].read ? I2C_M_RD : 0;
+		i2c_msgs[i].len = msgs[i].bytes_number;
+		i2c_msgs[i].buf = msgs[i].data;
+	}
+
+	rdwr.msgs = i2c_msgs;
+	rdwr.nmsgs = len;
+
+	ret = ioctl(linux_desc->fd, I2C_RDWR, &rdwr);
+	if (ret < 0) {
+		printf("%s: Can't transfer i2c messages\n\r", __func__);
+		ret = -errno;
+	} else {
+		ret = 0;
+	}
+
+	free(i2c_msgs);
+
+	return ret;
+}
+
 const struct no_os_i2c_platform_ops linux_i2c_ops = {
 	.i2c_ops_init = &linux_i2c_init,
 	.i2c_ops_write = &linux_i2c_write,
 	.i2c_ops_read = &linux_i2c_read,
+	.i2c_ops_transfer = &linux_i2c_transfer,
 	.i2c_ops_remove = &linux_i2c_remove
 };
@@ -43,8 +43,10 @@
 
 #include "no_os_error.h"
 #include "no_os_spi.h"
+#include "no_os_util.h"
 #include "linux_spi.h"
 
+#include <errno.h>
 #include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -52,7 +54,13 @@
 #include <unistd.h>
 #include <linux/spi/spidev.h>
 
-#warning SPI delays are not supported on the linux platform
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/** Maximum number of transfers that fit in the size field of one ioctl */
+#define LINUX_SPI_MAX_TRANSFERS	((1 << _IOC_SIZEBITS) / \
+				 sizeof(struct spi_ioc_transfer))
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -65,6 +73,10 @@
 struct linux_spi_desc {
 	/** /dev/spidev"device_id"."chip_select" file descriptor */
 	int spidev_fd;
+	/** Transfer array of the ioctl, kept between calls */
+	struct spi_ioc_transfer *tr;
+	/** Number of elements allocated in tr */
+	uint32_t tr_size;
 };
 
 /******************************************************************************/
@@ -90,7 +102,7 @@ int32_t linux_spi_init(struct no_os_spi_desc **desc,
 	if (!descriptor)
 		return -1;
 
-	linux_desc = (struct linux_spi_desc*) malloc(sizeof(struct linux_spi_desc));
+	linux_desc = (struct linux_spi_desc*) calloc(1, sizeof(*linux_desc));
 	if (!linux_desc)
 		goto free_desc;
 
@@ -137,6 +149,86 @@ free_desc:
 	return -1;
 }
 
+/**
+ * @brief Write/read multiple messages to/from SPI with a single ioctl.
+ * @param desc - The SPI descriptor.
+ * @param msgs - The messages array.
+ * @param len - Number of messages.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t linux_spi_transfer(struct no_os_spi_desc *desc,
+				  struct no_os_spi_msg *msgs,
+				  uint32_t len)
+{
+	struct spi_ioc_transfer *tr;
+	struct linux_spi_desc	*linux_desc;
+	uint32_t		n = 0;
+	uint32_t		delay;
+	uint32_t		i;
+	int			ret;
+
+	if (!len)
+		return 0;
+
+	linux_desc = desc->extra;
+
+	/* A message with cs_delay_first may need an extra transfer */
+	if (2 * len > linux_desc->tr_size) {
+		tr = realloc(linux_desc->tr, 2 * len * sizeof(*tr));
+		if (!tr)
+			return -ENOMEM;
+		linux_desc->tr = tr;
+		linux_desc->tr_size = 2 * len;
+	}
+	tr = linux_desc->tr;
+
+	for (i = 0; i < len; i++) {
+		/*
+		 * spidev has no delay before the first clock edge, a transfer
+		 * without data asserts the CS and waits instead.
+		 */
+		if (msgs[i].cs_delay_first) {
+			tr[n] = (struct spi_ioc_transfer) {
+				.delay_usecs = msgs[i].cs_delay_first,
+			};
+			n++;
+		}
+
+		delay = msgs[i].cs_delay_last;
+		if (msgs[i].cs_change && i != len - 1)
+			delay += msgs[i].cs_change_delay;
+
+		tr[n] = (struct spi_ioc_transfer) {
+			.tx_buf = (unsigned long) msgs[i].tx_buff,
+			.rx_buf = (unsigned long) msgs[i].rx_buff,
+			.len = msgs[i].bytes_number,
+			.delay_usecs = no_os_min(delay, (uint32_t)UINT16_MAX),
+			/*
+			 * For the last transfer spidev keeps the CS asserted
+			 * when cs_change is set, the opposite of no_os.
+			 */
+			.cs_change = (i == len - 1) ? !msgs[i].cs_change :
+				     !!msgs[i].cs_change,
+		};
+		n++;
+	}
+
+	if (n > LINUX_SPI_MAX_TRANSFERS)
+		return -EINVAL;
+
+	ret = ioctl(linux_desc->spidev_fd, SPI_IOC_MESSAGE(n), tr);
+	if (ret < 0) {
+		printf("%s: Can't send spi message (%d)\n\r", __func__, errno);
+		return -errno;
+	}
+
+	/* The delay of the last message is waited after the CS deassert */
+	if (msgs[len - 1].cs_change_delay)
+		usleep(msgs[len - 1].cs_change_delay);
+
+	return 0;
+}
+
 /**
  * @brief Write and read data to/from SPI.
  * @param desc - The SPI descriptor.
@@ -148,23 +240,14 @@ int32_t linux_spi_write_and_read(struct no_os_spi_desc *desc,
 				 uint8_t *data,
 				 uint16_t bytes_number)
 {
-	struct spi_ioc_transfer tr = {
-		.tx_buf = (unsigned long)data,
-		.rx_buf = (unsigned long)data,
-		.len = bytes_number,
+	struct no_os_spi_msg msg = {
+		.tx_buff = data,
+		.rx_buff = data,
+		.bytes_number = bytes_number,
+		.cs_change = 1,
 	};
-	struct linux_spi_desc *linux_desc;
-	int ret;
 
-	linux_desc = desc->extra;
-
-	ret = ioctl(linux_desc->spidev_fd, SPI_IOC_MESSAGE(1), &tr);
-	if (ret == 1) {
-		printf("%s: Can't send spi message\n\r", __func__);
-		return -1;
-	}
-
-	return 0;
+	return linux_spi_transfer(desc, &msg, 1) ? -1 : 0;
 }
 
 /**
@@ -185,43 +268,13 @@ int32_t linux_spi_remove(struct no_os_spi_desc *desc)
 		return -1;
 	}
 
+	free(linux_desc->tr);
 	free(desc->extra);
 	free(desc);
 
 	return 0;
 }
 
-static int32_t linux_spi_transfer(struct no_os_spi_desc *desc,
-				  struct no_os_spi_msg *msgs,
-				  uint32_t len)
-
-{
-	struct spi_ioc_transfer *tr;
-	struct linux_spi_desc	*linux_desc;
-	int			ret;
-	uint32_t		i;
-
-	linux_desc = desc->extra;
-
-	tr = (struct spi_ioc_transfer *)calloc(len, sizeof(*tr));
-	if (!tr)
-		return -ENOMEM;
-
-	for (i = 0; i < len; i++) {
-		tr[i].tx_buf = (unsigned long) msgs[i].tx_buff;
-		tr[i].rx_buf = (unsigned long) msgs[i].rx_buff;
-		tr[i].len = msgs[i].bytes_number;
-		tr[i].cs_change = msgs[i].cs_change;
-	}
-
-	ret = ioctl(linux_desc->spidev_fd, SPI_IOC_MESSAGE(len), tr);
-	if (ret < 0)
-		printf("%s: Can't send spi message (%d)\n\r", __func__, errno);
-
-	free(tr);
-
-	return ret;
-}
 /**
  * @brief Linux platform specific SPI platform ops structure
  */
@@ -0,0 +1,272 @@
+/***************************************************************************//**
+ *   @file   maxim_dma.c
+ *   @brief  Implementation of the DMA driver for the maxim platform.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/************************* Include Files **************************************/
+/******************************************************************************/
+
+#include <errno.h>
+#include "no_os_alloc.h"
+#include "no_os_dma.h"
+#include "maxim_dma.h"
+#include "dma.h"
+#include "mxc_errors.h"
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+/* no_os_dma channel of each MSDK channel, for the callback */
+static struct no_os_dma_ch *max_dma_chs[MXC_DMA_CHANNELS];
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+void DMA0_IRQHandler(void)
+{
+	MXC_DMA_Handler();
+}
+
+void DMA1_IRQHandler(void)
+{
+	MXC_DMA_Handler();
+}
+
+void DMA2_IRQHandler(void)
+{
+	MXC_DMA_Handler();
+}
+
+void DMA3_IRQHandler(void)
+{
+	MXC_DMA_Handler();
+}
+
+/**
+ * @brief MSDK callback, at the count to zero of a channel.
+ * @param mxc_ch - MSDK channel.
+ * @param reason - E_NO_ERROR at the end of the transfer, error code otherwise.
+ */
+static void max_dma_callback(int mxc_ch, int reason)
+{
+	struct no_os_dma_ch *ch = max_dma_chs[mxc_ch];
+
+	if (!ch)
+		return;
+
+	if (reason != E_NO_ERROR) {
+		no_os_dma_xfer_error(ch, -EIO);
+		return;
+	}
+
+	no_os_dma_xfer_done(ch);
+}
+
+/**
+ * @brief Free the MSDK channels of the controller.
+ * @param desc - The DMA controller descriptor.
+ * @return 0 in case of success.
+ */
+static int32_t max_dma_remove(struct no_os_dma_desc *desc)
+{
+	int *mxc_ch = desc->extra;
+	uint32_t i;
+
+	for (i = 0; i < desc->num_ch; i++) {
+		if (mxc_ch[i] < 0)
+			continue;
+
+		NVIC_DisableIRQ(MXC_DMA_CH_GET_IRQ(mxc_ch[i]));
+		MXC_DMA_ReleaseChannel(mxc_ch[i]);
+		max_dma_chs[mxc_ch[i]] = NULL;
+	}
+
+	no_os_free(mxc_ch);
+
+	return 0;
+}
+
+/**
+ * @brief Initialize the DMA and acquire one MSDK channel for each channel.
+ * @param desc - The DMA controller descriptor.
+ * @param param - The structure that contains the DMA parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t max_dma_init(struct no_os_dma_desc *desc,
+			    const struct no_os_dma_init_param *param)
+{
+	int *mxc_ch;
+	uint32_t i;
+	int ret;
+
+	if (!desc->num_ch || desc->num_ch > MXC_DMA_CHANNELS)
+		return -EINVAL;
+
+	ret = MXC_DMA_Init();
+	if (ret != E_NO_ERROR && ret != E_BAD_STATE)
+		return -EIO;
+
+	mxc_ch = no_os_calloc(desc->num_ch, sizeof(*mxc_ch));
+	if (!mxc_ch)
+		return -ENOMEM;
+
+	for (i = 0; i < desc->num_ch; i++)
+		mxc_ch[i] = -1;
+	desc->extra = mxc_ch;
+
+	for (i = 0; i < desc->num_ch; i++) {
+		ret = MXC_DMA_AcquireChannel();
+		if (ret < 0) {
+			max_dma_remove(desc);
+			return -EBUSY;
+		}
+
+		mxc_ch[i] = ret;
+		max_dma_chs[ret] = &desc->channels[i];
+		desc->channels[i].extra = &mxc_ch[i];
+		MXC_DMA_SetCallback(ret, max_dma_callback);
+		MXC_DMA_EnableInt(ret);
+		NVIC_EnableIRQ(MXC_DMA_CH_GET_IRQ(ret));
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Program the transfer on the MSDK channel. Cyclic transfers use the
+ * reload registers, loaded with the same buffers.
+ * @param ch - The DMA channel.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t max_dma_config_xfer(struct no_os_dma_ch *ch)
+{
+	struct no_os_dma_xfer *xfer = ch->xfer;
+	mxc_dma_config_t config = {0};
+	mxc_dma_srcdst_t srcdst = {0};
+	int mxc_ch = *(int *)ch->extra;
+
+	switch (xfer->width) {
+	case 0:
+	case 1:
+		config.srcwd = MXC_DMA_WIDTH_BYTE;
+		break;
+	case 2:
+		config.srcwd = MXC_DMA_WIDTH_HALFWORD;
+		break;
+	case 4:
+		config.srcwd = MXC_DMA_WIDTH_WORD;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	config.ch = mxc_ch;
+	config.dstwd = config.srcwd;
+	switch (xfer->xfer_type) {
+	case NO_OS_DMA_MEM_TO_MEM:
+		config.reqsel = MXC_DMA_REQUEST_MEMTOMEM;
+		config.srcinc_en = 1;
+		config.dstinc_en = 1;
+		break;
+	case NO_OS_DMA_MEM_TO_DEV:
+		config.reqsel = xfer->periph_req;
+		config.srcinc_en = 1;
+		break;
+	case NO_OS_DMA_DEV_TO_MEM:
+		config.reqsel = xfer->periph_req;
+		config.dstinc_en = 1;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	srcdst.ch = mxc_ch;
+	srcdst.source = xfer->src;
+	srcdst.dest = xfer->dst;
+	srcdst.len = xfer->length;
+
+	if (MXC_DMA_ConfigChannel(config, srcdst) != E_NO_ERROR)
+		return -EINVAL;
+
+	if (xfer->cyclic && MXC_DMA_SetSrcReload(srcdst) != E_NO_ERROR)
+		return -EINVAL;
+
+	if (MXC_DMA_ChannelEnableInt(mxc_ch, MXC_F_DMA_CTRL_CTZ_IE) !=
+	    E_NO_ERROR)
+		return -EINVAL;
+
+	return 0;
+}
+
+/**
+ * @brief Start the transfer programmed on the channel.
+ * @param ch - The DMA channel.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t max_dma_xfer_start(struct no_os_dma_ch *ch)
+{
+	if (MXC_DMA_Start(*(int *)ch->extra) != E_NO_ERROR)
+		return -EIO;
+
+	return 0;
+}
+
+/**
+ * @brief Stop the transfer running on the channel.
+ * @param ch - The DMA channel.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t max_dma_xfer_abort(struct no_os_dma_ch *ch)
+{
+	if (MXC_DMA_Stop(*(int *)ch->extra) != E_NO_ERROR)
+		return -EIO;
+
+	return 0;
+}
+
+/**
+ * @brief maxim platform specific DMA platform ops structure
+ */
+const struct no_os_dma_platform_ops max_dma_ops = {
+	.init = &max_dma_init,
+	.remove = &max_dma_remove,
+	.config_xfer = &max_dma_config_xfer,
+	.xfer_start = &max_dma_xfer_start,
+	.xfer_abort = &max_dma_xfer_abort,
+};
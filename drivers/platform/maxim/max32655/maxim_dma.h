@@ -1,10 +1,8 @@
 /***************************************************************************//**
- *   @file   no_os_lf256fifo.h
- *   @brief  SPSC lock-free fifo of fixed size (256), specialized for UART.
- *   @author Darius Berghe (darius.berghe@analog.com)
+ *   @file   maxim_dma.h
+ *   @brief  Header file of the DMA driver for the maxim platform.
 ********************************************************************************
- *   @copyright
- * Copyright 2020(c) Analog Devices, Inc.
+ * Copyright 2023(c) Analog Devices, Inc.
  *
  * All rights reserved.
  *
@@ -38,22 +36,17 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *******************************************************************************/
 
-#ifndef __LFFIFO_H
-#define __LFFIFO_H
+#ifndef MAXIM_DMA_H_
+#define MAXIM_DMA_H_
 
-#include <stdlib.h>
 #include <stdint.h>
-#include <stdbool.h>
+#include "no_os_dma.h"
 
-struct lf256fifo;
-
-int lf256fifo_init(struct lf256fifo **);
-bool lf256fifo_is_full(struct lf256fifo *);
-bool lf256fifo_is_empty(struct lf256fifo *);
-int lf256fifo_read(struct lf256fifo *, uint8_t *);
-int lf256fifo_write(struct lf256fifo *, uint8_t);
-void lf256fifo_flush(struct lf256fifo *);
-void lf256fifo_remove(struct lf256fifo *fifo);
+/**
+ * @brief maxim platform specific DMA platform ops structure. periph_req of
+ * the transfers is a mxc_dma_reqsel_t (e.g. MXC_DMA_REQUEST_SPI1TX). The
+ * channels are acquired from the MSDK when the controller is initialized.
+ */
+extern const struct no_os_dma_platform_ops max_dma_ops;
 
 #endif
-
@@ -326,6 +326,57 @@ static int32_t max_i2c_read(struct no_os_i2c_desc *desc,
 	return ret;
 }
 
+/**
+ * @brief Send multiple messages to/from a slave device, separated by repeated
+ * starts. A write followed by a read is done in a single transaction.
+ * @param desc - Descriptor of the I2C device
+ * @param msgs - Array of messages.
+ * @param len - Number of messages in the array.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t max_i2c_transfer(struct no_os_i2c_desc *desc,
+				struct no_os_i2c_msg *msgs,
+				uint32_t len)
+{
+	mxc_i2c_req_t req;
+	uint32_t i = 0;
+	int32_t ret;
+
+	if (!desc || !desc->extra || !msgs)
+		return -EINVAL;
+
+	req.i2c = MXC_I2C_GET_I2C(desc->device_id);
+	req.addr = desc->slave_address;
+
+	while (i < len) {
+		req.tx_buf = NULL;
+		req.tx_len = 0;
+		req.rx_buf = NULL;
+		req.rx_len = 0;
+
+		if (!msgs[i].read) {
+			req.tx_buf = msgs[i].data;
+			req.tx_len = msgs[i].bytes_number;
+			i++;
+		}
+
+		if (i < len && msgs[i].read) {
+			req.rx_buf = msgs[i].data;
+			req.rx_len = msgs[i].bytes_number;
+			i++;
+		}
+
+		/* Keep the bus for the next transaction */
+		req.restart = (i < len);
+
+		ret = MXC_I2C_MasterTransaction(&req);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
 /**
  * @brief MAXIM platform specific I2C platform ops structure
  */
@@ -333,5 +384,6 @@ const struct no_os_i2c_platform_ops max_i2c_ops = {
 	.i2c_ops_init = &max_i2c_init,
 	.i2c_ops_write = &max_i2c_write,
 	.i2c_ops_read = &max_i2c_read,
+	.i2c_ops_transfer = &max_i2c_transfer,
 	.i2c_ops_remove = &max_i2c_remove
 };
@@ -56,6 +56,10 @@
 #include "no_os_uart.h"
 #include "no_os_rtc.h"
 #include "no_os_util.h"
+#ifdef NO_OS_SCHED
+#include "lp.h"
+#include "no_os_sched.h"
+#endif
 
 static struct event_list _events[] = {
 	[NO_OS_EVT_GPIO] = {.event = NO_OS_EVT_GPIO},
@@ -569,6 +573,48 @@ static int32_t max_irq_set_priority(struct no_os_irq_ctrl_desc *desc,
 	return 0;
 }
 
+#ifdef NO_OS_SCHED
+/**
+ * @brief Sleep until the next interrupt if no work is pending, checked with the
+ * interrupts masked. When the scheduler allows it, enter deep sleep, woken up
+ * by the GPIO wakeup sources set with MXC_LP_EnableGPIOWakeup or by the RTC
+ * alarm of the next timer. The RTC counts seconds, the time slept is measured
+ * with the same resolution.
+ */
+void no_os_sched_idle(void)
+{
+	struct no_os_rtc_desc *rtc = no_os_sched_wakeup_rtc();
+	uint32_t sleep_ms, start, end;
+
+	__disable_irq();
+	switch (no_os_sched_sleep_level(&sleep_ms)) {
+	case NO_OS_SCHED_SLEEP_WAIT:
+		__WFI();
+		break;
+	case NO_OS_SCHED_SLEEP_DEEP:
+		if (rtc) {
+			no_os_rtc_get_cnt(rtc, &start);
+			end = start + sleep_ms / 1000;
+			if (sleep_ms != NO_OS_SCHED_FOREVER) {
+				no_os_rtc_set_irq_time(rtc, end);
+				MXC_RTC_EnableInt(MXC_RTC_INT_EN_LONG);
+				NVIC_EnableIRQ(RTC_IRQn);
+				MXC_LP_EnableRTCAlarmWakeup();
+			}
+		}
+		MXC_LP_EnterDeepSleepMode();
+		if (rtc) {
+			no_os_rtc_get_cnt(rtc, &end);
+			no_os_sched_time_skip((end - start) * 1000);
+		}
+		break;
+	default:
+		break;
+	}
+	__enable_irq();
+}
+#endif
+
 /**
  * @brief maxim specific IRQ platform ops structure
  */
@@ -51,6 +51,7 @@
 #include "no_os_print_log.h"
 #include "no_os_spi.h"
 #include "no_os_util.h"
+#include "no_os_hot.h"
 #include "no_os_units.h"
 
 #define SPI_MASTER_MODE	1
@@ -59,6 +60,27 @@
 #define MAX_DELAY_SCLK	255
 #define NS_PER_US	1000
 
+/** Descriptor of the ongoing asynchronous transfer, for each instance */
+static struct no_os_spi_desc *async_desc[MXC_SPI_INSTANCES];
+
+/**
+ * @brief SPI0 interrupt handler.
+ * @return void
+ */
+void SPI0_IRQHandler(void)
+{
+	MXC_SPI_AsyncHandler(MXC_SPI0);
+}
+
+/**
+ * @brief SPI1 interrupt handler.
+ * @return void
+ */
+void SPI1_IRQHandler(void)
+{
+	MXC_SPI_AsyncHandler(MXC_SPI1);
+}
+
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
@@ -269,6 +291,30 @@ int32_t max_spi_remove(struct no_os_spi_desc *desc)
 	return 0;
 }
 
+/**
+ * @brief Configure the SPI peripheral, if it was last used for another slave.
+ * @param desc - The SPI descriptor.
+ * @return 0 in case of success, errno codes otherwise.
+ */
+static int32_t _max_spi_select(struct no_os_spi_desc *desc)
+{
+	static uint32_t last_slave_id[MXC_SPI_INSTANCES];
+	uint32_t slave_id;
+	int32_t ret;
+
+	slave_id = desc->chip_select;
+	if (slave_id == last_slave_id[desc->device_id])
+		return 0;
+
+	ret = _max_spi_config(desc);
+	if (ret)
+		return ret;
+
+	last_slave_id[desc->device_id] = slave_id;
+
+	return 0;
+}
+
 /**
  * @brief Write/read multiple messages to/from SPI.
  * @param desc - The SPI descriptor.
@@ -280,22 +326,20 @@ int32_t max_spi_transfer(struct no_os_spi_desc *desc,
 			 struct no_os_spi_msg *msgs,
 			 uint32_t len)
 {
-	static uint32_t last_slave_id[MXC_SPI_INSTANCES];
+	struct max_spi_state *st;
 	mxc_spi_req_t req;
-	uint32_t slave_id;
 	int32_t ret;
 
 	if (!desc || !msgs)
 		return -EINVAL;
 
-	slave_id = desc->chip_select;
-	if (slave_id != last_slave_id[desc->device_id]) {
-		ret = _max_spi_config(desc);
-		if (ret)
-			return ret;
+	st = desc->extra;
+	if (st->async_callback)
+		return -EBUSY;
 
-		last_slave_id[desc->device_id] = slave_id;
-	}
+	ret = _max_spi_select(desc);
+	if (ret)
+		return ret;
 
 	req.spi = MXC_SPI_GET_SPI(desc->device_id);
 	req.ssIdx = desc->chip_select;
@@ -321,6 +365,149 @@ int32_t max_spi_transfer(struct no_os_spi_desc *desc,
 	return 0;
 }
 
+static void _max_spi_async_done(void *req, int result);
+
+/**
+ * @brief Start the transaction of the current asynchronous transfer message.
+ * @param desc - The SPI descriptor.
+ * @return 0 in case of success, errno codes otherwise.
+ */
+static int32_t _max_spi_async_start(struct no_os_spi_desc *desc)
+{
+	struct max_spi_state *st = desc->extra;
+	struct no_os_spi_msg *msg = &st->async_msgs[st->async_idx];
+	mxc_spi_req_t *req = &st->async_req;
+	int32_t ret;
+
+	req->spi = MXC_SPI_GET_SPI(desc->device_id);
+	req->ssIdx = desc->chip_select;
+	req->txData = msg->tx_buff;
+	req->rxData = msg->rx_buff;
+	req->txCnt = 0;
+	req->rxCnt = 0;
+	req->ssDeassert = msg->cs_change;
+	req->txLen = req->txData ? msg->bytes_number : 0;
+	req->rxLen = req->rxData ? msg->bytes_number : 0;
+	req->completeCB = _max_spi_async_done;
+
+	_max_delay_config(desc, msg);
+	ret = MXC_SPI_MasterTransactionAsync(req);
+	if (ret == E_BAD_PARAM)
+		return -EINVAL;
+	if (ret == E_BAD_STATE)
+		return -EBUSY;
+
+	return 0;
+}
+
+/**
+ * @brief End the ongoing asynchronous transfer.
+ * @param desc - The SPI descriptor.
+ * @param ret - Result passed to the callback.
+ * @return void
+ */
+static void _max_spi_async_end(struct no_os_spi_desc *desc, int32_t ret)
+{
+	struct max_spi_state *st = desc->extra;
+	no_os_spi_callback callback = st->async_callback;
+
+	NVIC_DisableIRQ(MXC_SPI_GET_IRQ(desc->device_id));
+	async_desc[desc->device_id] = NULL;
+
+	/* Cleared first, so that the callback can start a new transfer */
+	st->async_callback = NULL;
+	callback(st->async_ctx, ret);
+}
+
+/**
+ * @brief Completion callback of an asynchronous transfer message, called from
+ * the SPI interrupt.
+ * @param req - The finished request.
+ * @param result - E_NO_ERROR or a MXC error code.
+ * @return void
+ */
+static void _max_spi_async_done(void *req, int result)
+{
+	struct no_os_spi_desc *desc;
+	struct max_spi_state *st;
+	int32_t ret;
+
+	desc = async_desc[MXC_SPI_GET_IDX(((mxc_spi_req_t *)req)->spi)];
+	if (!desc)
+		return;
+
+	st = desc->extra;
+	if (result != E_NO_ERROR) {
+		_max_spi_async_end(desc, -EIO);
+		return;
+	}
+
+	no_os_udelay(st->async_msgs[st->async_idx].cs_change_delay);
+
+	st->async_idx++;
+	if (st->async_idx == st->async_len) {
+		_max_spi_async_end(desc, 0);
+		return;
+	}
+
+	ret = _max_spi_async_start(desc);
+	if (ret)
+		_max_spi_async_end(desc, ret);
+}
+
+/**
+ * @brief Start sending multiple messages to/from SPI, using the SPI interrupt.
+ * The cs_change_delay of the messages is waited for in interrupt context.
+ * @param desc - The SPI descriptor.
+ * @param msgs - The messages array.
+ * @param len - Number of messages.
+ * @param callback - Called from interrupt context when the transfer is done.
+ * @param ctx - Parameter of callback.
+ * @return 0 in case of success, errno codes otherwise.
+ */
+int32_t max_spi_transfer_async(struct no_os_spi_desc *desc,
+			       struct no_os_spi_msg *msgs,
+			       uint32_t len,
+			       no_os_spi_callback callback,
+			       void *ctx)
+{
+	struct max_spi_state *st;
+	int32_t ret;
+
+	if (!desc || !msgs || !callback)
+		return -EINVAL;
+
+	st = desc->extra;
+	if (st->async_callback || async_desc[desc->device_id])
+		return -EBUSY;
+
+	if (!len) {
+		callback(ctx, 0);
+		return 0;
+	}
+
+	ret = _max_spi_select(desc);
+	if (ret)
+		return ret;
+
+	st->async_msgs = msgs;
+	st->async_len = len;
+	st->async_idx = 0;
+	st->async_ctx = ctx;
+	st->async_callback = callback;
+	async_desc[desc->device_id] = desc;
+
+	NVIC_EnableIRQ(MXC_SPI_GET_IRQ(desc->device_id));
+	ret = _max_spi_async_start(desc);
+	if (ret) {
+		NVIC_DisableIRQ(MXC_SPI_GET_IRQ(desc->device_id));
+		async_desc[desc->device_id] = NULL;
+		st->async_callback = NULL;
+	}
+
+	return ret;
+}
+
 /**
  * @brief Write and read data to/from SPI.
  * @param desc - The SPI descriptor.
@@ -328,9 +515,9 @@ int32_t max_spi_transfer(struct no_os_spi_desc *desc,
  * @param bytes_number - Number of bytes to write/read.
  * @return 0 in case of success, errno codes otherwise.
  */
-int32_t max_spi_write_and_read(struct no_os_spi_desc *desc,
-			       uint8_t *data,
-			       uint16_t bytes_number)
+NO_OS_HOT int32_t max_spi_write_and_read(struct no_os_spi_desc *desc,
+					 uint8_t *data,
+					 uint16_t bytes_number)
 {
 	struct no_os_spi_msg xfer = {
 		.rx_buff = data,
@@ -349,5 +536,6 @@ const struct no_os_spi_platform_ops max_spi_ops = {
 	.init = &max_spi_init,
 	.write_and_read = &max_spi_write_and_read,
 	.transfer = &max_spi_transfer,
+	.transfer_async = &max_spi_transfer_async,
 	.remove = &max_spi_remove
 };
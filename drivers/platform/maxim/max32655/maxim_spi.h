@@ -41,6 +41,8 @@
 #define MAXIM_SPI_H_
 
 #include <stdint.h>
+#include "spi.h"
+#include "no_os_spi.h"
 #include "max32655.h"
 
 /**
@@ -63,6 +65,18 @@ struct max_spi_state {
 	struct max_spi_init_param *init_param;
 	uint32_t cs_delay_first;
 	uint32_t cs_delay_last;
+	/** Request of the ongoing asynchronous transfer */
+	mxc_spi_req_t async_req;
+	/** Messages of the ongoing asynchronous transfer */
+	struct no_os_spi_msg *async_msgs;
+	/** Number of messages of the ongoing asynchronous transfer */
+	uint32_t async_len;
+	/** Index of the message being sent */
+	uint32_t async_idx;
+	/** Called when the asynchronous transfer is done. NULL when idle */
+	no_os_spi_callback async_callback;
+	/** Parameter of async_callback */
+	void *async_ctx;
 };
 
 #endif
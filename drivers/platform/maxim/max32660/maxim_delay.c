@@ -87,3 +87,39 @@ struct no_os_time no_os_get_time(void)
 
 	return t;
 }
+
+/**
+ * @brief Get the monotonic time in nanoseconds, from the DWT cycle counter
+ * extended to 64 bits. It must be called at least once per counter wrap, every
+ * 2^32 / SystemCoreClock seconds, and assumes the core clock is not changed.
+ * @return Nanoseconds from the start of the cycle counter.
+ */
+uint64_t no_os_time_ns(void)
+{
+	static uint32_t high, last, freq, ns_int, ns_frac;
+	uint32_t primask, now;
+	uint64_t cycles;
+
+	if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)) {
+		CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+		DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	}
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	now = DWT->CYCCNT;
+	if (now < last)
+		high++;
+	last = now;
+	cycles = ((uint64_t)high << 32) | now;
+	if (freq != SystemCoreClock) {
+		/* Nanoseconds per cycle, as 32.32 fixed point */
+		freq = SystemCoreClock;
+		ns_int = 1000000000U / freq;
+		ns_frac = ((uint64_t)(1000000000U % freq) << 32) / freq;
+	}
+	__set_PRIMASK(primask);
+
+	return cycles * ns_int + (cycles >> 32) * ns_frac +
+	       (((cycles & 0xFFFFFFFF) * ns_frac) >> 32);
+}
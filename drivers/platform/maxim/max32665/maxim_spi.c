@@ -51,6 +51,7 @@
 #include "no_os_print_log.h"
 #include "no_os_spi.h"
 #include "no_os_util.h"
+#include "no_os_hot.h"
 #include "no_os_units.h"
 
 #define SPI_MASTER_MODE	1
@@ -408,9 +409,9 @@ int32_t max_spi_transfer(struct no_os_spi_desc *desc,
  * @param bytes_number - Number of bytes to write/read.
  * @return 0 in case of success, errno codes otherwise.
  */
-int32_t max_spi_write_and_read(struct no_os_spi_desc *desc,
-			       uint8_t *data,
-			       uint16_t bytes_number)
+NO_OS_HOT int32_t max_spi_write_and_read(struct no_os_spi_desc *desc,
+					 uint8_t *data,
+					 uint16_t bytes_number)
 {
 	struct no_os_spi_msg xfer = {
 		.rx_buff = data,
@@ -328,6 +328,62 @@ int32_t max_gpio_get_value(struct no_os_gpio_desc *desc, uint8_t *value)
 	return 0;
 }
 
+/**
+ * @brief Set the values of several GPIOs of the port with a single write of the
+ * output register.
+ * @param desc - The GPIO descriptor of the first pin of the group.
+ * @param mask - Pins to be set, bit n being the pin desc->number + n.
+ * @param values - The values, in the same order as mask.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t max_gpio_set_multiple(struct no_os_gpio_desc *desc, uint32_t mask,
+			      uint32_t values)
+{
+	mxc_gpio_cfg_t *max_gpio_cfg;
+	mxc_gpio_regs_t *gpio_regs;
+
+	if (!desc || desc->number >= N_PINS ||
+	    ((mask << desc->number) >> desc->number) != mask)
+		return -EINVAL;
+
+	max_gpio_cfg = desc->extra;
+	gpio_regs = max_gpio_cfg->port;
+
+	set_enable(gpio_regs, mask << desc->number, true);
+	MXC_GPIO_OutPut(gpio_regs, mask << desc->number,
+			values << desc->number);
+
+	return 0;
+}
+
+/**
+ * @brief Get the values of several GPIOs of the port with a single read of the
+ * input register.
+ * @param desc - The GPIO descriptor of the first pin of the group.
+ * @param mask - Pins to be read, bit n being the pin desc->number + n.
+ * @param values - The values, in the same order as mask.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t max_gpio_get_multiple(struct no_os_gpio_desc *desc, uint32_t mask,
+			      uint32_t *values)
+{
+	mxc_gpio_cfg_t *max_gpio_cfg;
+	mxc_gpio_regs_t *gpio_regs;
+
+	if (!desc || !values || desc->number >= N_PINS ||
+	    ((mask << desc->number) >> desc->number) != mask)
+		return -EINVAL;
+
+	max_gpio_cfg = desc->extra;
+	gpio_regs = max_gpio_cfg->port;
+
+	set_enable(gpio_regs, mask << desc->number, true);
+	*values = MXC_GPIO_InGet(gpio_regs, mask << desc->number) >>
+		  desc->number;
+
+	return 0;
+}
+
 /**
  * @brief maxim platform specific GPIO platform ops structure
  */
@@ -339,5 +395,7 @@ const struct no_os_gpio_platform_ops max_gpio_ops = {
 	.gpio_ops_direction_output = &max_gpio_direction_output,
 	.gpio_ops_get_direction = &max_gpio_get_direction,
 	.gpio_ops_set_value = &max_gpio_set_value,
-	.gpio_ops_get_value = &max_gpio_get_value
+	.gpio_ops_get_value = &max_gpio_get_value,
+	.gpio_ops_set_multiple = &max_gpio_set_multiple,
+	.gpio_ops_get_multiple = &max_gpio_get_multiple
 };
@@ -152,6 +152,9 @@ int32_t mbed_i2c_write(struct no_os_i2c_desc *desc,
 	if (!desc  || !desc->extra || !data)
 		return -EINVAL;
 
+	if (((mbed_i2c_desc *)(desc->extra))->async_callback)
+		return -EBUSY;
+
 	i2c = (I2C *)(((mbed_i2c_desc *)(desc->extra))->i2c_port);
 
 	/**
@@ -186,6 +189,9 @@ int32_t mbed_i2c_read(struct no_os_i2c_desc *desc,
 	if (!desc  || !desc->extra || !data)
 		return -EINVAL;
 
+	if (((mbed_i2c_desc *)(desc->extra))->async_callback)
+		return -EBUSY;
+
 	i2c = (I2C *)(((mbed_i2c_desc *)(desc->extra))->i2c_port);
 
 	/**
@@ -200,6 +206,137 @@ int32_t mbed_i2c_read(struct no_os_i2c_desc *desc,
 	return 0;
 }
 
+#if DEVICE_I2C_ASYNCH
+/**
+ * @brief End the ongoing asynchronous transfer.
+ * @param mdesc[in] - The mbed I2C descriptor.
+ * @param ret[in] - Result passed to the callback.
+ */
+static void mbed_i2c_async_end(struct mbed_i2c_desc *mdesc, int32_t ret)
+{
+	no_os_i2c_callback callback = mdesc->async_callback;
+
+	/* Cleared first, so that the callback can start a new transfer */
+	mdesc->async_callback = NULL;
+	callback(mdesc->async_ctx, ret);
+}
+
+static void mbed_i2c_async_event(struct no_os_i2c_desc *desc, int event);
+
+/**
+ * @brief Start the mbed transfer of the current messages. A write message is
+ * merged with the read message following it. Only the last transfer ends with
+ * a stop condition.
+ * @param desc[in] - The I2C descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t mbed_i2c_async_start(struct no_os_i2c_desc *desc)
+{
+	struct mbed_i2c_desc *mdesc = (struct mbed_i2c_desc *)desc->extra;
+	mbed::I2C *i2c = (I2C *)mdesc->i2c_port;
+	struct no_os_i2c_msg *tx = NULL;
+	struct no_os_i2c_msg *rx = NULL;
+	struct no_os_i2c_msg *msg;
+	bool repeated;
+
+	if (mdesc->async_idx == mdesc->async_len) {
+		mbed_i2c_async_end(mdesc, 0);
+		return 0;
+	}
+
+	msg = &mdesc->async_msgs[mdesc->async_idx];
+	if (msg->read) {
+		rx = msg;
+	} else {
+		tx = msg;
+		if (mdesc->async_idx + 1 < mdesc->async_len && msg[1].read)
+			rx = &msg[1];
+	}
+
+	mdesc->async_step = (tx && rx) ? 2 : 1;
+	repeated = mdesc->async_idx + mdesc->async_step < mdesc->async_len;
+
+	if (i2c->transfer(desc->slave_address,
+			  tx ? (const char *)tx->data : NULL,
+			  tx ? tx->bytes_number : 0,
+			  rx ? (char *)rx->data : NULL,
+			  rx ? rx->bytes_number : 0,
+			  mbed::callback(mbed_i2c_async_event, desc),
+			  I2C_EVENT_ALL, repeated))
+		return -EBUSY;
+
+	return 0;
+}
+
+/**
+ * @brief Event handler of an asynchronous transfer, called from interrupt
+ * context.
+ * @param desc[in] - The I2C descriptor.
+ * @param event[in] - I2C_EVENT_* flags of the transfer.
+ */
+static void mbed_i2c_async_event(struct no_os_i2c_desc *desc, int event)
+{
+	struct mbed_i2c_desc *mdesc = (struct mbed_i2c_desc *)desc->extra;
+	int32_t ret;
+
+	if (event & (I2C_EVENT_ERROR | I2C_EVENT_ERROR_NO_SLAVE |
+		     I2C_EVENT_TRANSFER_EARLY_NACK)) {
+		mbed_i2c_async_end(mdesc, -EIO);
+		return;
+	}
+
+	mdesc->async_idx += mdesc->async_step;
+	ret = mbed_i2c_async_start(desc);
+	if (ret)
+		mbed_i2c_async_end(mdesc, ret);
+}
+#endif
+
+/**
+ * @brief Start sending messages to/from a slave device, using the mbed
+ * asynchronous I2C API, and return without waiting for them.
+ * @param desc[in] - The I2C descriptor.
+ * @param msgs[in, out] - Array of messages.
+ * @param len[in] - Number of messages.
+ * @param callback[in] - Called from interrupt context when the transfer is
+ * 			  done.
+ * @param ctx[in] - Parameter of callback.
+ * @return 0 in case of success, -ENOSYS if the target has no asynchronous I2C,
+ * 	   negative error code otherwise.
+ */
+int32_t mbed_i2c_transfer_async(struct no_os_i2c_desc *desc,
+				struct no_os_i2c_msg *msgs,
+				uint32_t len,
+				no_os_i2c_callback callback,
+				void *ctx)
+{
+#if DEVICE_I2C_ASYNCH
+	struct mbed_i2c_desc *mdesc;
+	int32_t ret;
+
+	if (!desc || !desc->extra || !msgs || !callback)
+		return -EINVAL;
+
+	mdesc = (struct mbed_i2c_desc *)desc->extra;
+	if (mdesc->async_callback)
+		return -EBUSY;
+
+	mdesc->async_msgs = msgs;
+	mdesc->async_len = len;
+	mdesc->async_idx = 0;
+	mdesc->async_ctx = ctx;
+	mdesc->async_callback = callback;
+
+	ret = mbed_i2c_async_start(desc);
+	if (ret)
+		mdesc->async_callback = NULL;
+
+	return ret;
+#else
+	return -ENOSYS;
+#endif
+}
+
 /**
 * @brief Mbed platform specific I2C platform ops structure
 */
@@ -207,6 +344,7 @@ const struct no_os_i2c_platform_ops mbed_i2c_ops = {
 	.i2c_ops_init = &mbed_i2c_init,
 	.i2c_ops_write = &mbed_i2c_write,
 	.i2c_ops_read = &mbed_i2c_read,
+	.i2c_ops_transfer_async = &mbed_i2c_transfer_async,
 	.i2c_ops_remove = &mbed_i2c_remove
 };
 
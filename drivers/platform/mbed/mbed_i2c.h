@@ -49,6 +49,7 @@ extern "C"
 /******************************************************************************/
 
 #include <stdio.h>
+#include "no_os_i2c.h"
 
 /******************************************************************************/
 /********************** Variables and User defined data types *****************/
@@ -77,6 +78,12 @@ struct mbed_i2c_init_param {
 */
 struct mbed_i2c_desc {
 	void *i2c_port;  		// I2C port instance (mbed::I2C)
+	struct no_os_i2c_msg *async_msgs;	// Async transfer messages
+	uint32_t async_len;		// Number of async messages
+	uint32_t async_idx;		// First message being sent
+	uint32_t async_step;		// Messages being sent
+	no_os_i2c_callback async_callback;	// NULL when no async transfer
+	void *async_ctx;		// Parameter of async_callback
 };
 
 /**
@@ -84,6 +91,13 @@ struct mbed_i2c_desc {
  */
 extern const struct no_os_i2c_platform_ops mbed_i2c_ops;
 
+/*
+ * Asynchronous transfers use I2C::transfer() and need a target with
+ * DEVICE_I2C_ASYNCH, the other targets fall back to blocking transfers. A
+ * write message followed by a read one is sent as a single mbed transfer,
+ * with a repeated start between them.
+ */
+
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
 /******************************************************************************/
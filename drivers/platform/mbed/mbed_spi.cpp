@@ -139,6 +139,10 @@ int32_t mbed_spi_init(struct no_os_spi_desc **desc,
 	spi->frequency(param->max_speed_hz);
 	spi->format(SPI_8_BIT_FRAME, param->mode);   // data write/read format
 	spi->set_default_write_value(0x00);          // code to write when reading back
+#if DEVICE_SPI_ASYNCH
+	spi->set_dma_usage((DMAUsage)((struct mbed_spi_init_param *)
+				      param->extra)->dma_usage);
+#endif
 
 	return 0;
 
@@ -200,6 +204,9 @@ int32_t mbed_spi_write_and_read(struct no_os_spi_desc *desc,
 	if (!desc || !desc->extra || !data)
 		return -EINVAL;
 
+	if (((struct mbed_spi_desc *)desc->extra)->async_callback)
+		return -EBUSY;
+
 	spi = (SPI *)(((struct mbed_spi_desc *)(desc->extra))->spi_port);
 
 	if (((struct mbed_spi_desc *)desc->extra)->use_sw_csb) {
@@ -237,6 +244,9 @@ int32_t mbed_spi_transfer(struct no_os_spi_desc *desc, struct no_os_spi_msg *msg
 	if (!((struct mbed_spi_desc *)desc->extra)->use_sw_csb)
 		return -EINVAL;
 
+	if (((struct mbed_spi_desc *)desc->extra)->async_callback)
+		return -EBUSY;
+
 	spi = (SPI *)(((struct mbed_spi_desc *)(desc->extra))->spi_port);
 	csb = (DigitalOut *)(((struct mbed_spi_desc *)(desc->extra))->csb_gpio);
 
@@ -260,6 +270,141 @@ int32_t mbed_spi_transfer(struct no_os_spi_desc *desc, struct no_os_spi_msg *msg
 	return 0;
 }
 
+#if DEVICE_SPI_ASYNCH
+/**
+ * @brief End the ongoing asynchronous transfer.
+ * @param mdesc[in] - The mbed SPI descriptor.
+ * @param ret[in] - Result passed to the callback.
+ */
+static void mbed_spi_async_end(struct mbed_spi_desc *mdesc, int32_t ret)
+{
+	no_os_spi_callback callback = mdesc->async_callback;
+
+	((DigitalOut *)mdesc->csb_gpio)->write(NO_OS_GPIO_HIGH);
+
+	/* Cleared first, so that the callback can start a new transfer */
+	mdesc->async_callback = NULL;
+	callback(mdesc->async_ctx, ret);
+}
+
+static void mbed_spi_async_event(struct mbed_spi_desc *mdesc, int event);
+
+/**
+ * @brief Start sending the current message of the asynchronous transfer.
+ * Messages without data are completed without starting the peripheral.
+ * @param mdesc[in] - The mbed SPI descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t mbed_spi_async_start(struct mbed_spi_desc *mdesc)
+{
+	mbed::SPI *spi = (SPI *)mdesc->spi_port;
+	mbed::DigitalOut *csb = (DigitalOut *)mdesc->csb_gpio;
+	struct no_os_spi_msg *msg = NULL;
+
+	for (; mdesc->async_idx < mdesc->async_len; mdesc->async_idx++) {
+		msg = &mdesc->async_msgs[mdesc->async_idx];
+		csb->write(NO_OS_GPIO_LOW);
+		if (msg->bytes_number && (msg->tx_buff || msg->rx_buff))
+			break;
+		if (msg->cs_change)
+			csb->write(NO_OS_GPIO_HIGH);
+	}
+
+	if (mdesc->async_idx == mdesc->async_len) {
+		mbed_spi_async_end(mdesc, 0);
+		return 0;
+	}
+
+	/* The default write value, 0x00, is sent when there is no tx buffer */
+	if (spi->transfer((const uint8_t *)msg->tx_buff,
+			  msg->tx_buff ? msg->bytes_number : 0,
+			  (uint8_t *)msg->rx_buff,
+			  msg->rx_buff ? msg->bytes_number : 0,
+			  mbed::callback(mbed_spi_async_event, mdesc),
+			  SPI_EVENT_ALL))
+		return -EBUSY;
+
+	return 0;
+}
+
+/**
+ * @brief Event handler of an asynchronous transfer message, called from
+ * interrupt context.
+ * @param mdesc[in] - The mbed SPI descriptor.
+ * @param event[in] - SPI_EVENT_* flags of the message.
+ */
+static void mbed_spi_async_event(struct mbed_spi_desc *mdesc, int event)
+{
+	struct no_os_spi_msg *msg;
+	int32_t ret;
+
+	if (event & SPI_EVENT_ERROR) {
+		mbed_spi_async_end(mdesc, -EIO);
+		return;
+	}
+
+	msg = &mdesc->async_msgs[mdesc->async_idx];
+	if (msg->cs_change)
+		((DigitalOut *)mdesc->csb_gpio)->write(NO_OS_GPIO_HIGH);
+
+	mdesc->async_idx++;
+	ret = mbed_spi_async_start(mdesc);
+	if (ret)
+		mbed_spi_async_end(mdesc, ret);
+}
+#endif
+
+/**
+ * @brief Start sending the number of SPI messages, using the mbed asynchronous
+ * SPI API, and return without waiting for them. Delays are not supported.
+ * @param desc[in] - The SPI descriptor.
+ * @param msgs[in, out] - Pointer to SPI messages.
+ * @param num_of_msgs[in] - Number of SPI messages.
+ * @param callback[in] - Called from interrupt context when the transfer is
+ * 			  done.
+ * @param ctx[in] - Parameter of callback.
+ * @return 0 in case of success, -ENOSYS if the target has no asynchronous SPI,
+ * 	   negative error code otherwise.
+ * @note Use of this function requires CSB pin to be software controlled.
+ */
+int32_t mbed_spi_transfer_async(struct no_os_spi_desc *desc,
+				struct no_os_spi_msg *msgs,
+				uint32_t num_of_msgs,
+				no_os_spi_callback callback,
+				void *ctx)
+{
+#if DEVICE_SPI_ASYNCH
+	struct mbed_spi_desc *mdesc;
+	int32_t ret;
+
+	if (!desc || !desc->extra || !msgs || !callback)
+		return -EINVAL;
+
+	mdesc = (struct mbed_spi_desc *)desc->extra;
+	if (!mdesc->use_sw_csb)
+		return -EINVAL;
+
+	if (mdesc->async_callback)
+		return -EBUSY;
+
+	mdesc->async_msgs = msgs;
+	mdesc->async_len = num_of_msgs;
+	mdesc->async_idx = 0;
+	mdesc->async_ctx = ctx;
+	mdesc->async_callback = callback;
+
+	ret = mbed_spi_async_start(mdesc);
+	if (ret) {
+		mdesc->async_callback = NULL;
+		((DigitalOut *)mdesc->csb_gpio)->write(NO_OS_GPIO_HIGH);
+	}
+
+	return ret;
+#else
+	return -ENOSYS;
+#endif
+}
+
 /**
 * @brief Mbed platform specific SPI platform ops structure
 */
@@ -267,6 +412,7 @@ const struct no_os_spi_platform_ops mbed_spi_ops = {
 	.init = &mbed_spi_init,
 	.write_and_read = &mbed_spi_write_and_read,
 	.transfer = &mbed_spi_transfer,
+	.transfer_async = &mbed_spi_transfer_async,
 	.remove = &mbed_spi_remove,
 };
 
@@ -49,6 +49,7 @@ extern "C"
 /******************************************************************************/
 #include <stdio.h>
 #include <stdbool.h>
+#include "no_os_spi.h"
 
 /******************************************************************************/
 /********************** Variables and User defined data types *****************/
@@ -71,6 +72,7 @@ struct mbed_spi_init_param {
 	uint16_t spi_mosi_pin;  	// SPI MOSI pin (PinName)
 	uint16_t spi_clk_pin;  		// SPI CLK pin (PinName)
 	bool use_sw_csb;			// Software/Hardware control of CSB pin
+	uint8_t dma_usage;			// Async DMA hint (DMAUsage)
 };
 
 /**
@@ -81,6 +83,11 @@ struct mbed_spi_desc {
 	void *spi_port; 			// SPI port instance (mbed::SPI)
 	void *csb_gpio;  			// SPI chip select gpio instance (DigitalOut)
 	bool use_sw_csb; 			// Software/Hardware control of CSB pin
+	struct no_os_spi_msg *async_msgs;	// Async transfer messages
+	uint32_t async_len;			// Number of async messages
+	uint32_t async_idx;			// Message being sent
+	no_os_spi_callback async_callback;	// NULL when no async transfer
+	void *async_ctx;			// Parameter of async_callback
 };
 
 /**
@@ -88,6 +95,13 @@ struct mbed_spi_desc {
 */
 extern const struct no_os_spi_platform_ops mbed_spi_ops;
 
+/*
+ * Asynchronous transfers use SPI::transfer() and need a target with
+ * DEVICE_SPI_ASYNCH, the other targets fall back to blocking transfers. The
+ * transfer events are handled in interrupt context and mbed keeps deep sleep
+ * locked until the transfer is done, so the caller can sleep meanwhile.
+ */
+
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
 /******************************************************************************/
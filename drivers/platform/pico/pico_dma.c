@@ -0,0 +1,269 @@
+/***************************************************************************//**
+ *   @file   pico_dma.c
+ *   @brief  Implementation of pico DMA driver.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/************************* Include Files **************************************/
+/******************************************************************************/
+
+#include "no_os_error.h"
+#include "no_os_alloc.h"
+#include "pico_dma.h"
+#include "hardware/irq.h"
+
+/******************************************************************************/
+/************************ Variable Declarations ******************************/
+/******************************************************************************/
+
+/* no_os_dma channel of each hardware channel, for the interrupt handler */
+static struct no_os_dma_ch *pico_dma_chs[NUM_DMA_CHANNELS];
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief DMA_IRQ_1 handler. A cyclic transfer is restarted from the beginning
+ * of its buffers before its user is notified.
+ */
+static void pico_dma_handler(void)
+{
+	struct no_os_dma_xfer *xfer;
+	struct no_os_dma_ch *ch;
+	struct pico_dma_ch *pch;
+	uint32_t i;
+
+	for (i = 0; i < NUM_DMA_CHANNELS; i++) {
+		ch = pico_dma_chs[i];
+		if (!ch || !dma_channel_get_irq1_status(i))
+			continue;
+
+		dma_channel_acknowledge_irq1(i);
+		pch = ch->extra;
+		xfer = ch->xfer;
+		if (ch->busy && xfer->cyclic)
+			dma_channel_configure(pch->dma, &pch->cfg, xfer->dst,
+					      xfer->src, pch->count, true);
+
+		no_os_dma_xfer_done(ch);
+	}
+}
+
+/**
+ * @brief Allocate the channels and install the interrupt handler.
+ * @param desc - The DMA controller descriptor.
+ * @param param - The structure that contains the DMA parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t pico_dma_init(struct no_os_dma_desc *desc,
+			     const struct no_os_dma_init_param *param)
+{
+	static bool handler_added;
+	struct pico_dma_ch *pch;
+	uint32_t i;
+
+	if (!desc->num_ch || desc->num_ch > NUM_DMA_CHANNELS)
+		return -EINVAL;
+
+	pch = no_os_calloc(desc->num_ch, sizeof(*pch));
+	if (!pch)
+		return -ENOMEM;
+
+	for (i = 0; i < desc->num_ch; i++) {
+		pch[i].dma = -1;
+		desc->channels[i].extra = &pch[i];
+	}
+	desc->extra = pch;
+
+	if (!handler_added) {
+		irq_add_shared_handler(DMA_IRQ_1, pico_dma_handler,
+			PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+		irq_set_enabled(DMA_IRQ_1, true);
+		handler_added = true;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Free the channels.
+ * @param desc - The DMA controller descriptor.
+ * @return 0 in case of success.
+ */
+static int32_t pico_dma_remove(struct no_os_dma_desc *desc)
+{
+	no_os_free(desc->extra);
+
+	return 0;
+}
+
+/**
+ * @brief Claim a hardware channel for the no_os_dma channel.
+ * @param ch - The DMA channel.
+ * @return 0 in case of success, -EBUSY if no hardware channel is left.
+ */
+static int32_t pico_dma_ch_acquire(struct no_os_dma_ch *ch)
+{
+	struct pico_dma_ch *pch = ch->extra;
+	int dma;
+
+	dma = dma_claim_unused_channel(false);
+	if (dma < 0)
+		return -EBUSY;
+
+	pch->dma = dma;
+	pico_dma_chs[dma] = ch;
+	dma_channel_set_irq1_enabled(dma, true);
+
+	return 0;
+}
+
+/**
+ * @brief Give the hardware channel back.
+ * @param ch - The DMA channel.
+ * @return 0 in case of success.
+ */
+static int32_t pico_dma_ch_release(struct no_os_dma_ch *ch)
+{
+	struct pico_dma_ch *pch = ch->extra;
+
+	dma_channel_set_irq1_enabled(pch->dma, false);
+	pico_dma_chs[pch->dma] = NULL;
+	dma_channel_unclaim(pch->dma);
+	pch->dma = -1;
+
+	return 0;
+}
+
+/**
+ * @brief Prepare the configuration of the transfer, written to the channel
+ * when it is started.
+ * @param ch - The DMA channel.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t pico_dma_config_xfer(struct no_os_dma_ch *ch)
+{
+	struct pico_dma_ch *pch = ch->extra;
+	struct no_os_dma_xfer *xfer = ch->xfer;
+	enum dma_channel_transfer_size size;
+	uint32_t width;
+
+	switch (xfer->width) {
+	case 0:
+	case 1:
+		size = DMA_SIZE_8;
+		width = 1;
+		break;
+	case 2:
+		size = DMA_SIZE_16;
+		width = 2;
+		break;
+	case 4:
+		size = DMA_SIZE_32;
+		width = 4;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	pch->cfg = dma_channel_get_default_config(pch->dma);
+	channel_config_set_transfer_data_size(&pch->cfg, size);
+	switch (xfer->xfer_type) {
+	case NO_OS_DMA_MEM_TO_MEM:
+		channel_config_set_dreq(&pch->cfg, DREQ_FORCE);
+		break;
+	case NO_OS_DMA_MEM_TO_DEV:
+		channel_config_set_write_increment(&pch->cfg, false);
+		channel_config_set_dreq(&pch->cfg, xfer->periph_req);
+		break;
+	case NO_OS_DMA_DEV_TO_MEM:
+		channel_config_set_read_increment(&pch->cfg, false);
+		channel_config_set_dreq(&pch->cfg, xfer->periph_req);
+		break;
+	default:
+		return -EINVAL;
+	}
+	pch->count = xfer->length / width;
+
+	return 0;
+}
+
+/**
+ * @brief Start the transfer programmed on the channel.
+ * @param ch - The DMA channel.
+ * @return 0 in case of success.
+ */
+static int32_t pico_dma_xfer_start(struct no_os_dma_ch *ch)
+{
+	struct pico_dma_ch *pch = ch->extra;
+
+	dma_channel_configure(pch->dma, &pch->cfg, ch->xfer->dst, ch->xfer->src,
+			      pch->count, true);
+
+	return 0;
+}
+
+/**
+ * @brief Stop the transfer running on the channel.
+ * @param ch - The DMA channel.
+ * @return 0 in case of success.
+ */
+static int32_t pico_dma_xfer_abort(struct no_os_dma_ch *ch)
+{
+	struct pico_dma_ch *pch = ch->extra;
+
+	/* The abort raises the interrupt of the channel, mask it meanwhile */
+	dma_channel_set_irq1_enabled(pch->dma, false);
+	dma_channel_abort(pch->dma);
+	dma_channel_acknowledge_irq1(pch->dma);
+	dma_channel_set_irq1_enabled(pch->dma, true);
+
+	return 0;
+}
+
+/**
+ * @brief pico platform specific DMA platform ops structure
+ */
+const struct no_os_dma_platform_ops pico_dma_ops = {
+	.init = &pico_dma_init,
+	.remove = &pico_dma_remove,
+	.ch_acquire = &pico_dma_ch_acquire,
+	.ch_release = &pico_dma_ch_release,
+	.config_xfer = &pico_dma_config_xfer,
+	.xfer_start = &pico_dma_xfer_start,
+	.xfer_abort = &pico_dma_xfer_abort,
+};
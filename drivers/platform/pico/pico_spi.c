@@ -48,6 +48,8 @@
 #include "pico/stdlib.h"
 #include "no_os_delay.h"
 #include "hardware/resets.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -58,6 +60,12 @@
 /************************ Variable Declarations ******************************/
 /******************************************************************************/
 static uint64_t last_slave_id[PICO_SPI_MAX_INSTANCES];
+/** Descriptor of the ongoing asynchronous transfer, for each instance */
+static struct no_os_spi_desc *async_desc[PICO_SPI_MAX_INSTANCES];
+/** Sent when a message has no tx buffer */
+static const uint8_t async_tx_zero;
+/** Written when a message has no rx buffer */
+static uint8_t async_rx_discard;
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
@@ -203,6 +211,12 @@ int32_t pico_spi_remove(struct no_os_spi_desc *desc)
 
 	pico_spi = desc->extra;
 
+	if (pico_spi->dma_claimed) {
+		dma_channel_set_irq0_enabled(pico_spi->rx_dma, false);
+		dma_channel_unclaim(pico_spi->tx_dma);
+		dma_channel_unclaim(pico_spi->rx_dma);
+	}
+
 	spi_deinit(pico_spi->spi_instance);
 
 	free(desc->extra);
@@ -229,6 +243,8 @@ int32_t pico_spi_transfer(struct no_os_spi_desc *desc,
 		return -EINVAL;
 
 	pico_spi = desc->extra;
+	if (pico_spi->async_callback)
+		return -EBUSY;
 
 	slave_id = desc->chip_select;
 	if (slave_id != last_slave_id[desc->device_id]) {
@@ -291,6 +307,205 @@ int32_t pico_spi_write_and_read(struct no_os_spi_desc *desc,
 	return pico_spi_transfer(desc, &msg, 1);
 }
 
+/**
+ * @brief Start the DMA transfer of the current asynchronous transfer message.
+ * @param desc - The SPI descriptor.
+ */
+static void pico_spi_async_start(struct no_os_spi_desc *desc)
+{
+	struct pico_spi_desc *pico_spi = desc->extra;
+	struct no_os_spi_msg *msg = &pico_spi->async_msgs[pico_spi->async_idx];
+	spi_inst_t *spi = pico_spi->spi_instance;
+	volatile void *dr = &spi_get_hw(spi)->dr;
+	dma_channel_config cfg;
+
+	/* Assert CS */
+	gpio_put(pico_spi->spi_cs_pin, 0);
+
+	if (msg->cs_delay_first)
+		no_os_udelay(msg->cs_delay_first);
+
+	cfg = dma_channel_get_default_config(pico_spi->tx_dma);
+	channel_config_set_transfer_data_size(&cfg, DMA_SIZE_8);
+	channel_config_set_dreq(&cfg, spi_get_dreq(spi, true));
+	channel_config_set_read_increment(&cfg, msg->tx_buff != NULL);
+	channel_config_set_write_increment(&cfg, false);
+	dma_channel_configure(pico_spi->tx_dma, &cfg, dr,
+			      msg->tx_buff ? msg->tx_buff : &async_tx_zero,
+			      msg->bytes_number, false);
+
+	cfg = dma_channel_get_default_config(pico_spi->rx_dma);
+	channel_config_set_transfer_data_size(&cfg, DMA_SIZE_8);
+	channel_config_set_dreq(&cfg, spi_get_dreq(spi, false));
+	channel_config_set_read_increment(&cfg, false);
+	channel_config_set_write_increment(&cfg, msg->rx_buff != NULL);
+	dma_channel_configure(pico_spi->rx_dma, &cfg,
+			      msg->rx_buff ? msg->rx_buff : &async_rx_discard,
+			      dr, msg->bytes_number, false);
+
+	/* Start both channels at once, so that no RX data is lost */
+	dma_start_channel_mask(NO_OS_BIT(pico_spi->tx_dma) |
+			       NO_OS_BIT(pico_spi->rx_dma));
+}
+
+/**
+ * @brief Finish the current message and start the next one, or end the
+ * asynchronous transfer.
+ * @param desc - The SPI descriptor.
+ */
+static void pico_spi_async_next(struct no_os_spi_desc *desc)
+{
+	struct pico_spi_desc *pico_spi = desc->extra;
+	struct no_os_spi_msg *msg;
+	no_os_spi_callback callback;
+
+	while (pico_spi->async_idx < pico_spi->async_len) {
+		msg = &pico_spi->async_msgs[pico_spi->async_idx];
+		if (msg->bytes_number) {
+			pico_spi_async_start(desc);
+			return;
+		}
+		pico_spi->async_idx++;
+	}
+
+	callback = pico_spi->async_callback;
+	async_desc[desc->device_id] = NULL;
+
+	/* Cleared first, so that the callback can start a new transfer */
+	pico_spi->async_callback = NULL;
+	callback(pico_spi->async_ctx, 0);
+}
+
+/**
+ * @brief DMA interrupt handler. Called when the RX channel of an asynchronous
+ * transfer received the whole message.
+ */
+static void pico_spi_dma_handler(void)
+{
+	struct pico_spi_desc *pico_spi;
+	struct no_os_spi_desc *desc;
+	struct no_os_spi_msg *msg;
+	uint32_t i;
+
+	for (i = 0; i < PICO_SPI_MAX_INSTANCES; i++) {
+		desc = async_desc[i];
+		if (!desc)
+			continue;
+
+		pico_spi = desc->extra;
+		if (!dma_channel_get_irq0_status(pico_spi->rx_dma))
+			continue;
+
+		dma_channel_acknowledge_irq0(pico_spi->rx_dma);
+
+		msg = &pico_spi->async_msgs[pico_spi->async_idx];
+		if (msg->cs_delay_last)
+			no_os_udelay(msg->cs_delay_last);
+
+		if (msg->cs_change)
+			/* De-assert CS */
+			gpio_put(pico_spi->spi_cs_pin, 1);
+
+		if (msg->cs_change_delay)
+			no_os_udelay(msg->cs_change_delay);
+
+		pico_spi->async_idx++;
+		pico_spi_async_next(desc);
+	}
+}
+
+/**
+ * @brief Claim the DMA channels used by asynchronous transfers.
+ * @param desc - The SPI descriptor.
+ * @return 0 in case of success, error code otherwise.
+ */
+static int pico_spi_dma_claim(struct no_os_spi_desc *desc)
+{
+	static bool handler_added;
+	struct pico_spi_desc *pico_spi = desc->extra;
+	int tx_dma;
+	int rx_dma;
+
+	if (pico_spi->dma_claimed)
+		return 0;
+
+	tx_dma = dma_claim_unused_channel(false);
+	if (tx_dma < 0)
+		return -EBUSY;
+
+	rx_dma = dma_claim_unused_channel(false);
+	if (rx_dma < 0) {
+		dma_channel_unclaim(tx_dma);
+		return -EBUSY;
+	}
+
+	if (!handler_added) {
+		irq_add_shared_handler(DMA_IRQ_0, pico_spi_dma_handler,
+			PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+		irq_set_enabled(DMA_IRQ_0, true);
+		handler_added = true;
+	}
+
+	pico_spi->tx_dma = tx_dma;
+	pico_spi->rx_dma = rx_dma;
+	pico_spi->dma_claimed = true;
+	dma_channel_set_irq0_enabled(rx_dma, true);
+
+	return 0;
+}
+
+/**
+ * @brief Start sending multiple messages to/from SPI, using DMA.
+ * The DMA channels are claimed at the first call and the message delays are
+ * waited for in interrupt context.
+ * @param desc - The SPI descriptor.
+ * @param msgs - The messages array.
+ * @param len - Number of messages.
+ * @param callback - Called from interrupt context when the transfer is done.
+ * @param ctx - Parameter of callback.
+ * @return 0 in case of success, errno codes otherwise.
+ */
+int32_t pico_spi_transfer_async(struct no_os_spi_desc *desc,
+				struct no_os_spi_msg *msgs,
+				uint32_t len,
+				no_os_spi_callback callback,
+				void *ctx)
+{
+	struct pico_spi_desc *pico_spi;
+	uint64_t slave_id;
+	int ret;
+
+	if (!desc || !desc->extra || !msgs || !callback)
+		return -EINVAL;
+
+	pico_spi = desc->extra;
+	if (pico_spi->async_callback || async_desc[desc->device_id])
+		return -EBUSY;
+
+	slave_id = desc->chip_select;
+	if (slave_id != last_slave_id[desc->device_id]) {
+		last_slave_id[desc->device_id] = slave_id;
+		ret = pico_spi_config(desc);
+		if (ret)
+			return ret;
+	}
+
+	ret = pico_spi_dma_claim(desc);
+	if (ret)
+		return ret;
+
+	pico_spi->async_msgs = msgs;
+	pico_spi->async_len = len;
+	pico_spi->async_idx = 0;
+	pico_spi->async_ctx = ctx;
+	pico_spi->async_callback = callback;
+	async_desc[desc->device_id] = desc;
+
+	pico_spi_async_next(desc);
+
+	return 0;
+}
+
 /**
  * @brief pico platform specific SPI platform ops structure
  */
@@ -298,5 +513,6 @@ const struct no_os_spi_platform_ops pico_spi_ops = {
 	.init = &pico_spi_init,
 	.write_and_read = &pico_spi_write_and_read,
 	.transfer = &pico_spi_transfer,
+	.transfer_async = &pico_spi_transfer_async,
 	.remove = &pico_spi_remove
 };
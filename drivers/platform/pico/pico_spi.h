@@ -43,6 +43,7 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 
+#include <stdbool.h>
 #include "no_os_spi.h"
 #include "hardware/spi.h"
 
@@ -117,6 +118,22 @@ struct pico_spi_desc {
 	enum spi_sck_gp spi_sck_pin;
 	/** SPI CS pin configuration */
 	enum spi_cs_gp spi_cs_pin;
+	/** Set when the asynchronous transfer DMA channels are claimed */
+	bool dma_claimed;
+	/** DMA channel writing the SPI data register */
+	uint32_t tx_dma;
+	/** DMA channel reading the SPI data register */
+	uint32_t rx_dma;
+	/** Messages of the ongoing asynchronous transfer */
+	struct no_os_spi_msg *async_msgs;
+	/** Number of messages of the ongoing asynchronous transfer */
+	uint32_t async_len;
+	/** Index of the message being sent */
+	uint32_t async_idx;
+	/** Called when the asynchronous transfer is done. NULL when idle */
+	no_os_spi_callback async_callback;
+	/** Parameter of async_callback */
+	void *async_ctx;
 };
 
 /**
@@ -0,0 +1,797 @@
+/***************************************************************************//**
+ *   @file   pico_spi_pio.c
+ *   @brief  Implementation of the PIO based SPI engine for the pico platform.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/************************* Include Files **************************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include "no_os_error.h"
+#include "no_os_util.h"
+#include "no_os_spi.h"
+#include "no_os_delay.h"
+#include "pico_spi_pio.h"
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "hardware/pio_instructions.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Programs use one mandatory side-set bit, driving SCK */
+#define PICO_SPI_PIO_SIDE(v)		pio_encode_sideset(1, v)
+/* Longest delay field with one side-set bit */
+#define PICO_SPI_PIO_MAX_DELAY		15U
+/* Longest loop counter loaded by a set instruction */
+#define PICO_SPI_PIO_MAX_SET		31U
+#define PICO_SPI_PIO_MAX_INSTANCES	NUM_PIOS
+
+/******************************************************************************/
+/************************ Variable Declarations ******************************/
+/******************************************************************************/
+
+/** Descriptor of the running stream, for each PIO block */
+static struct no_os_spi_desc *stream_desc[PICO_SPI_PIO_MAX_INSTANCES];
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Append an instruction to the program being built.
+ * @param pio_spi - The PIO SPI descriptor.
+ * @param instr - Encoded instruction.
+ * @return 0 in case of success, -ENOMEM if the instruction memory is full.
+ */
+static int pico_spi_pio_emit(struct pico_spi_pio_desc *pio_spi,
+			     uint16_t instr)
+{
+	if (pio_spi->program.length == NO_OS_ARRAY_SIZE(pio_spi->instr))
+		return -ENOMEM;
+
+	pio_spi->instr[pio_spi->program.length++] = instr;
+
+	return 0;
+}
+
+/**
+ * @brief Append instructions waiting for a number of PIO cycles, with SCK
+ * low. Each set/jmp pair loops on Y for up to 513 cycles.
+ * @param pio_spi - The PIO SPI descriptor.
+ * @param cycles - Number of cycles.
+ * @return 0 in case of success, -ENOMEM if the instruction memory is full.
+ */
+static int pico_spi_pio_emit_delay(struct pico_spi_pio_desc *pio_spi,
+				   uint32_t cycles)
+{
+	uint32_t loops;
+	uint32_t delay;
+	uint32_t addr;
+	int ret;
+
+	while (cycles > 1) {
+		/* The set instruction takes one cycle, the loop the rest */
+		cycles--;
+		delay = no_os_min(NO_OS_DIV_ROUND_UP(cycles,
+						     PICO_SPI_PIO_MAX_SET + 1),
+				  PICO_SPI_PIO_MAX_DELAY + 1);
+		loops = no_os_min(cycles / delay, PICO_SPI_PIO_MAX_SET + 1);
+
+		ret = pico_spi_pio_emit(pio_spi,
+					pio_encode_set(pio_y, loops - 1) |
+					PICO_SPI_PIO_SIDE(0));
+		if (ret)
+			return ret;
+
+		addr = pio_spi->program.length;
+		ret = pico_spi_pio_emit(pio_spi, pio_encode_jmp_y_dec(addr) |
+					PICO_SPI_PIO_SIDE(0) |
+					pio_encode_delay(delay - 1));
+		if (ret)
+			return ret;
+
+		cycles -= loops * delay;
+	}
+
+	if (cycles)
+		return pico_spi_pio_emit(pio_spi, pio_encode_nop() |
+					 PICO_SPI_PIO_SIDE(0));
+
+	return 0;
+}
+
+/**
+ * @brief Load the built program in the instruction memory of the PIO block.
+ * @param pio_spi - The PIO SPI descriptor.
+ * @return 0 in case of success, -ENOMEM if there is no room for it.
+ */
+static int pico_spi_pio_load(struct pico_spi_pio_desc *pio_spi)
+{
+	pio_spi->program.instructions = pio_spi->instr;
+	pio_spi->program.origin = -1;
+
+	if (!pio_can_add_program(pio_spi->pio, &pio_spi->program))
+		return -ENOMEM;
+
+	pio_spi->offset = pio_add_program(pio_spi->pio, &pio_spi->program);
+
+	return 0;
+}
+
+/**
+ * @brief Stop the state machine and free its instruction memory.
+ * @param pio_spi - The PIO SPI descriptor.
+ */
+static void pico_spi_pio_unload(struct pico_spi_pio_desc *pio_spi)
+{
+	pio_sm_set_enabled(pio_spi->pio, pio_spi->sm, false);
+	pio_sm_clear_fifos(pio_spi->pio, pio_spi->sm);
+	pio_remove_program(pio_spi->pio, &pio_spi->program, pio_spi->offset);
+	pio_spi->program.length = 0;
+}
+
+/**
+ * @brief Compute the clock divider of the state machine.
+ * @param hz - Wanted SCK frequency.
+ * @param cycles - PIO cycles per SCK period.
+ * @param div - Integer divider.
+ * @return 0 in case of success, -EINVAL if hz is out of range.
+ */
+static int pico_spi_pio_clkdiv(uint32_t hz, uint32_t cycles, uint32_t *div)
+{
+	if (!hz)
+		return -EINVAL;
+
+	*div = NO_OS_DIV_ROUND_UP(clock_get_hz(clk_sys), hz * cycles);
+	if (!*div)
+		*div = 1;
+	if (*div > UINT16_MAX)
+		return -EINVAL;
+
+	return 0;
+}
+
+/**
+ * @brief Load the register access program, a single lane SPI master running
+ * at 4 PIO cycles per bit. CPOL is handled by inverting the SCK pad.
+ * @param desc - The SPI descriptor.
+ * @return 0 in case of success, error code otherwise.
+ */
+static int pico_spi_pio_config(struct no_os_spi_desc *desc)
+{
+	struct pico_spi_pio_desc *pio_spi = desc->extra;
+	PIO pio = pio_spi->pio;
+	uint32_t sm = pio_spi->sm;
+	uint32_t out_mask;
+	pio_sm_config c;
+	uint32_t div;
+	int ret;
+
+	ret = pico_spi_pio_clkdiv(desc->max_speed_hz, 4, &div);
+	if (ret)
+		return ret;
+
+	pio_spi->program.length = 0;
+	if (desc->mode & NO_OS_SPI_CPHA) {
+		/* Data out on the leading edge, sampled on the trailing one */
+		pico_spi_pio_emit(pio_spi, pio_encode_out(pio_x, 1) |
+				  PICO_SPI_PIO_SIDE(0));
+		pico_spi_pio_emit(pio_spi, pio_encode_mov(pio_pins, pio_x) |
+				  PICO_SPI_PIO_SIDE(1) | pio_encode_delay(1));
+		pico_spi_pio_emit(pio_spi, pio_encode_in(pio_pins, 1) |
+				  PICO_SPI_PIO_SIDE(0));
+	} else {
+		/* Stalls on the empty FIFO with SCK idle */
+		pico_spi_pio_emit(pio_spi, pio_encode_out(pio_pins, 1) |
+				  PICO_SPI_PIO_SIDE(0) | pio_encode_delay(1));
+		pico_spi_pio_emit(pio_spi, pio_encode_in(pio_pins, 1) |
+				  PICO_SPI_PIO_SIDE(1) | pio_encode_delay(1));
+	}
+
+	ret = pico_spi_pio_load(pio_spi);
+	if (ret)
+		return ret;
+
+	c = pio_get_default_sm_config();
+	sm_config_set_wrap(&c, pio_spi->offset,
+			   pio_spi->offset + pio_spi->program.length - 1);
+	sm_config_set_sideset(&c, 1, false, false);
+	sm_config_set_sideset_pins(&c, pio_spi->sck_pin);
+	sm_config_set_out_pins(&c, pio_spi->tx_pin, 1);
+	sm_config_set_in_pins(&c, pio_spi->rx_pin);
+	sm_config_set_out_shift(&c, false, true, 8);
+	sm_config_set_in_shift(&c, false, true, 8);
+	sm_config_set_clkdiv_int_frac(&c, div, 0);
+
+	desc->max_speed_hz = clock_get_hz(clk_sys) / (div * 4);
+
+	out_mask = NO_OS_BIT(pio_spi->sck_pin) | NO_OS_BIT(pio_spi->tx_pin);
+	pio_sm_set_pins_with_mask(pio, sm, 0, out_mask);
+	pio_sm_set_pindirs_with_mask(pio, sm, out_mask,
+				     out_mask | NO_OS_BIT(pio_spi->rx_pin));
+	pio_gpio_init(pio, pio_spi->sck_pin);
+	pio_gpio_init(pio, pio_spi->tx_pin);
+	pio_gpio_init(pio, pio_spi->rx_pin);
+	gpio_set_outover(pio_spi->sck_pin, (desc->mode & NO_OS_SPI_CPOL) ?
+			 GPIO_OVERRIDE_INVERT : GPIO_OVERRIDE_NORMAL);
+
+	pio_sm_init(pio, sm, pio_spi->offset, &c);
+	pio_sm_set_enabled(pio, sm, true);
+
+	return 0;
+}
+
+/**
+ * @brief Initialize the PIO SPI engine.
+ * @param desc  - The SPI descriptor.
+ * @param param - The structure that contains the SPI parameters.
+ * @return 0 in case of success, error code otherwise.
+ */
+static int32_t pico_spi_pio_init(struct no_os_spi_desc **desc,
+				 const struct no_os_spi_init_param *param)
+{
+	struct pico_spi_pio_init_param *pio_spi_ip;
+	struct pico_spi_pio_desc *pio_spi;
+	struct no_os_spi_desc *descriptor;
+	int sm;
+	int32_t ret;
+
+	if (!desc || !param || !param->extra)
+		return -EINVAL;
+
+	pio_spi_ip = param->extra;
+	if (pio_spi_ip->pio_id >= NUM_PIOS || !pio_spi_ip->rx_lanes ||
+	    pio_spi_ip->rx_lanes > 8 ||
+	    (pio_spi_ip->rx_lanes & (pio_spi_ip->rx_lanes - 1)))
+		return -EINVAL;
+
+	descriptor = (struct no_os_spi_desc *)calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return -ENOMEM;
+
+	pio_spi = (struct pico_spi_pio_desc *)calloc(1, sizeof(*pio_spi));
+	if (!pio_spi) {
+		ret = -ENOMEM;
+		goto free_desc;
+	}
+
+	descriptor->device_id = param->device_id;
+	descriptor->extra = pio_spi;
+	descriptor->max_speed_hz = param->max_speed_hz;
+	descriptor->mode = param->mode;
+	descriptor->chip_select = pio_spi_ip->cs_pin;
+
+	/* Only MSB is supported */
+	descriptor->bit_order = NO_OS_SPI_BIT_ORDER_MSB_FIRST;
+
+	pio_spi->pio = pio_spi_ip->pio_id ? pio1 : pio0;
+	pio_spi->sck_pin = pio_spi_ip->sck_pin;
+	pio_spi->tx_pin = pio_spi_ip->tx_pin;
+	pio_spi->rx_pin = pio_spi_ip->rx_pin;
+	pio_spi->rx_lanes = pio_spi_ip->rx_lanes;
+	pio_spi->cs_pin = pio_spi_ip->cs_pin;
+	pio_spi->convst_pin = pio_spi_ip->convst_pin;
+	pio_spi->busy_pin = pio_spi_ip->busy_pin;
+
+	sm = pio_claim_unused_sm(pio_spi->pio, false);
+	if (sm < 0) {
+		ret = -EBUSY;
+		goto error;
+	}
+	pio_spi->sm = sm;
+
+	gpio_init(pio_spi->cs_pin);
+	gpio_set_dir(pio_spi->cs_pin, true);
+	gpio_put(pio_spi->cs_pin, 1);
+
+	ret = pico_spi_pio_config(descriptor);
+	if (ret)
+		goto unclaim;
+
+	*desc = descriptor;
+
+	return 0;
+
+unclaim:
+	pio_sm_unclaim(pio_spi->pio, pio_spi->sm);
+error:
+	free(pio_spi);
+free_desc:
+	free(descriptor);
+	return ret;
+}
+
+/**
+ * @brief Free the resources allocated by no_os_spi_init().
+ * @param desc - The SPI descriptor.
+ * @return 0 in case of success, error code otherwise.
+ */
+static int32_t pico_spi_pio_remove(struct no_os_spi_desc *desc)
+{
+	struct pico_spi_pio_desc *pio_spi;
+
+	if (!desc || !desc->extra)
+		return -EINVAL;
+
+	pio_spi = desc->extra;
+	if (pio_spi->streaming)
+		pico_spi_pio_stream_stop(desc);
+
+	pico_spi_pio_unload(pio_spi);
+	pio_sm_unclaim(pio_spi->pio, pio_spi->sm);
+
+	free(pio_spi);
+	free(desc);
+
+	return 0;
+}
+
+/**
+ * @brief Shift bytes through the register access program. The FIFOs are
+ * kept busy in both directions, the received bytes lagging the sent ones.
+ * @param pio_spi - The PIO SPI descriptor.
+ * @param tx - Bytes to send, NULL to send zeros.
+ * @param rx - Received bytes, NULL to discard them.
+ * @param len - Number of bytes.
+ */
+static void pico_spi_pio_shift(struct pico_spi_pio_desc *pio_spi,
+			       const uint8_t *tx, uint8_t *rx, uint32_t len)
+{
+	/* Byte accesses, the bus replicates the written byte on all lanes */
+	io_rw_8 *txfifo = (io_rw_8 *)&pio_spi->pio->txf[pio_spi->sm];
+	io_rw_8 *rxfifo = (io_rw_8 *)&pio_spi->pio->rxf[pio_spi->sm];
+	uint32_t tx_remain = len;
+	uint32_t rx_remain = len;
+	uint8_t data;
+
+	while (tx_remain || rx_remain) {
+		if (tx_remain && !pio_sm_is_tx_fifo_full(pio_spi->pio,
+				pio_spi->sm)) {
+			*txfifo = tx ? *tx++ : 0;
+			tx_remain--;
+		}
+		if (rx_remain && !pio_sm_is_rx_fifo_empty(pio_spi->pio,
+				pio_spi->sm)) {
+			data = *rxfifo;
+			if (rx)
+				*rx++ = data;
+			rx_remain--;
+		}
+	}
+}
+
+/**
+ * @brief Write/read multiple messages to/from SPI.
+ * @param desc - The SPI descriptor.
+ * @param msgs - The messages array.
+ * @param len - Number of messages.
+ * @return 0 in case of success, -EBUSY while a stream is running.
+ */
+static int32_t pico_spi_pio_transfer(struct no_os_spi_desc *desc,
+				     struct no_os_spi_msg *msgs,
+				     uint32_t len)
+{
+	struct pico_spi_pio_desc *pio_spi;
+	uint32_t i;
+
+	if (!desc || !desc->extra || !msgs)
+		return -EINVAL;
+
+	pio_spi = desc->extra;
+	if (pio_spi->streaming)
+		return -EBUSY;
+
+	for (i = 0; i < len; i++) {
+		/* Assert CS */
+		gpio_put(pio_spi->cs_pin, 0);
+
+		if (msgs[i].cs_delay_first)
+			no_os_udelay(msgs[i].cs_delay_first);
+
+		pico_spi_pio_shift(pio_spi, msgs[i].tx_buff, msgs[i].rx_buff,
+				   msgs[i].bytes_number);
+
+		if (msgs[i].cs_delay_last)
+			no_os_udelay(msgs[i].cs_delay_last);
+
+		if (msgs[i].cs_change)
+			/* De-assert CS */
+			gpio_put(pio_spi->cs_pin, 1);
+
+		if (msgs[i].cs_change_delay)
+			no_os_udelay(msgs[i].cs_change_delay);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Write and read data to/from SPI.
+ * @param desc - The SPI descriptor.
+ * @param data - The buffer with the transmitted/received data.
+ * @param bytes_number - Number of bytes to write/read.
+ * @return 0 in case of success, error code otherwise.
+ */
+static int32_t pico_spi_pio_write_and_read(struct no_os_spi_desc *desc,
+					   uint8_t *data,
+					   uint16_t bytes_number)
+{
+	struct no_os_spi_msg msg = {
+		.bytes_number = bytes_number,
+		.cs_change = true,
+		.rx_buff = data,
+		.tx_buff = data,
+	};
+
+	if (!desc || !desc->extra || !data)
+		return -EINVAL;
+
+	if (!bytes_number)
+		return 0;
+
+	return pico_spi_pio_transfer(desc, &msg, 1);
+}
+
+/**
+ * @brief DMA interrupt handler. Called when a channel filled its half of the
+ * stream buffer, the chained channel is already filling the other one.
+ */
+static void pico_spi_pio_dma_handler(void)
+{
+	struct pico_spi_pio_stream *stream;
+	struct pico_spi_pio_desc *pio_spi;
+	uint32_t half;
+	uint32_t *block;
+	uint32_t i;
+	uint32_t j;
+	int ch;
+
+	for (i = 0; i < PICO_SPI_PIO_MAX_INSTANCES; i++) {
+		if (!stream_desc[i])
+			continue;
+
+		pio_spi = stream_desc[i]->extra;
+		stream = &pio_spi->stream;
+		half = stream->nb_words / 2;
+		for (j = 0; j < 2; j++) {
+			ch = pio_spi->dma[j];
+			if (!dma_channel_get_irq0_status(ch))
+				continue;
+
+			dma_channel_acknowledge_irq0(ch);
+
+			/* Re-armed for its turn after the other channel */
+			block = stream->buf + j * half;
+			dma_channel_set_write_addr(ch, block, false);
+			dma_channel_set_trans_count(ch, half, false);
+
+			if (stream->callback)
+				stream->callback(stream->ctx, block, half);
+		}
+	}
+}
+
+/**
+ * @brief Claim and configure the two chained DMA channels of the stream.
+ * @param pio_spi - The PIO SPI descriptor.
+ * @return 0 in case of success, -EBUSY if there are no free channels.
+ */
+static int pico_spi_pio_dma_setup(struct pico_spi_pio_desc *pio_spi)
+{
+	static bool handler_added;
+	struct pico_spi_pio_stream *stream = &pio_spi->stream;
+	uint32_t half = stream->nb_words / 2;
+	dma_channel_config cfg;
+	uint32_t i;
+
+	pio_spi->dma[0] = dma_claim_unused_channel(false);
+	if (pio_spi->dma[0] < 0)
+		return -EBUSY;
+
+	pio_spi->dma[1] = dma_claim_unused_channel(false);
+	if (pio_spi->dma[1] < 0) {
+		dma_channel_unclaim(pio_spi->dma[0]);
+		return -EBUSY;
+	}
+
+	if (!handler_added) {
+		irq_add_shared_handler(DMA_IRQ_0, pico_spi_pio_dma_handler,
+			PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+		irq_set_enabled(DMA_IRQ_0, true);
+		handler_added = true;
+	}
+
+	/* The second channel first, it must be ready when the first ends */
+	for (i = 2; i-- > 0;) {
+		cfg = dma_channel_get_default_config(pio_spi->dma[i]);
+		channel_config_set_transfer_data_size(&cfg, DMA_SIZE_32);
+		channel_config_set_dreq(&cfg, pio_get_dreq(pio_spi->pio,
+					pio_spi->sm, false));
+		channel_config_set_read_increment(&cfg, false);
+		channel_config_set_write_increment(&cfg, true);
+		channel_config_set_chain_to(&cfg, pio_spi->dma[!i]);
+		dma_channel_set_irq0_enabled(pio_spi->dma[i], true);
+		dma_channel_configure(pio_spi->dma[i], &cfg,
+				      stream->buf + i * half,
+				      &pio_spi->pio->rxf[pio_spi->sm], half,
+				      i == 0);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Build and load the capture program. OSR holds the number of bits
+ * per lane minus one, pulled once before the frame loop:
+ * CONVST high, CONVST low, wait for BUSY low or the conversion time, shift
+ * the lanes in on the SCK rising edges, wait for the next frame.
+ * @param desc - The SPI descriptor.
+ * @return 0 in case of success, error code otherwise.
+ */
+static int pico_spi_pio_stream_config(struct no_os_spi_desc *desc)
+{
+	struct pico_spi_pio_desc *pio_spi = desc->extra;
+	struct pico_spi_pio_stream *stream = &pio_spi->stream;
+	bool convst = pio_spi->convst_pin != PICO_SPI_PIO_NO_PIN;
+	bool busy = pio_spi->busy_pin != PICO_SPI_PIO_NO_PIN;
+	uint32_t frame_bits = stream->bits_per_lane * pio_spi->rx_lanes;
+	PIO pio = pio_spi->pio;
+	uint32_t sm = pio_spi->sm;
+	uint32_t high_cycles;
+	uint32_t conv_cycles;
+	uint32_t frame_cycles;
+	uint32_t out_mask;
+	uint32_t pio_hz;
+	uint32_t bit_addr;
+	pio_sm_config c;
+	uint32_t div;
+	uint32_t i;
+	int ret;
+
+	ret = pico_spi_pio_clkdiv(desc->max_speed_hz, 2, &div);
+	if (ret)
+		return ret;
+
+	pio_hz = clock_get_hz(clk_sys) / div;
+	high_cycles = NO_OS_DIV_ROUND_UP((uint64_t)stream->convst_high_ns *
+					 pio_hz, 1000000000);
+	conv_cycles = NO_OS_DIV_ROUND_UP((uint64_t)stream->conv_time_ns *
+					 pio_hz, 1000000000);
+
+	pio_spi->program.length = 0;
+	pico_spi_pio_emit(pio_spi, pio_encode_pull(false, true) |
+			  PICO_SPI_PIO_SIDE(0));
+	pico_spi_pio_emit(pio_spi, pio_encode_mov(pio_x, pio_osr) |
+			  PICO_SPI_PIO_SIDE(0));
+	frame_cycles = 1;
+
+	if (convst) {
+		pico_spi_pio_emit(pio_spi, pio_encode_set(pio_pins, 1) |
+				  PICO_SPI_PIO_SIDE(0));
+		ret = pico_spi_pio_emit_delay(pio_spi, high_cycles ?
+					      high_cycles - 1 : 0);
+		if (ret)
+			return ret;
+		pico_spi_pio_emit(pio_spi, pio_encode_set(pio_pins, 0) |
+				  PICO_SPI_PIO_SIDE(0));
+		frame_cycles += no_os_max(high_cycles, 1) + 1;
+	}
+
+	if (busy)
+		ret = pico_spi_pio_emit(pio_spi,
+					pio_encode_wait_gpio(false,
+							pio_spi->busy_pin) |
+					PICO_SPI_PIO_SIDE(0));
+	else
+		ret = pico_spi_pio_emit_delay(pio_spi, conv_cycles);
+	if (ret)
+		return ret;
+	/* With a busy pin the pacing assumes the typical conversion time */
+	frame_cycles += conv_cycles;
+
+	bit_addr = pio_spi->program.length;
+	pico_spi_pio_emit(pio_spi, pio_encode_in(pio_pins, pio_spi->rx_lanes) |
+			  PICO_SPI_PIO_SIDE(1));
+	ret = pico_spi_pio_emit(pio_spi, pio_encode_jmp_x_dec(bit_addr) |
+				PICO_SPI_PIO_SIDE(0));
+	if (ret)
+		return ret;
+	frame_cycles += 2 * stream->bits_per_lane;
+
+	if (stream->sample_rate) {
+		if (pio_hz / stream->sample_rate < frame_cycles)
+			return -EINVAL;
+
+		ret = pico_spi_pio_emit_delay(pio_spi, pio_hz /
+					      stream->sample_rate -
+					      frame_cycles);
+		if (ret)
+			return ret;
+	}
+
+	ret = pico_spi_pio_load(pio_spi);
+	if (ret)
+		return ret;
+
+	c = pio_get_default_sm_config();
+	sm_config_set_wrap(&c, pio_spi->offset + 1,
+			   pio_spi->offset + pio_spi->program.length - 1);
+	sm_config_set_sideset(&c, 1, false, false);
+	sm_config_set_sideset_pins(&c, pio_spi->sck_pin);
+	sm_config_set_in_pins(&c, pio_spi->rx_pin);
+	if (convst)
+		sm_config_set_set_pins(&c, pio_spi->convst_pin, 1);
+	/* A frame fills one word, or a whole number of words */
+	sm_config_set_in_shift(&c, false, true, no_os_min(frame_bits, 32));
+	sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_RX);
+	sm_config_set_clkdiv_int_frac(&c, div, 0);
+
+	out_mask = NO_OS_BIT(pio_spi->sck_pin);
+	if (convst)
+		out_mask |= NO_OS_BIT(pio_spi->convst_pin);
+	pio_sm_set_pins_with_mask(pio, sm, 0, out_mask);
+	pio_sm_set_pindirs_with_mask(pio, sm, out_mask, out_mask);
+	pio_sm_set_consecutive_pindirs(pio, sm, pio_spi->rx_pin,
+				       pio_spi->rx_lanes, false);
+	for (i = 0; i < pio_spi->rx_lanes; i++)
+		pio_gpio_init(pio, pio_spi->rx_pin + i);
+	if (convst)
+		pio_gpio_init(pio, pio_spi->convst_pin);
+	gpio_set_outover(pio_spi->sck_pin, GPIO_OVERRIDE_NORMAL);
+
+	pio_sm_init(pio, sm, pio_spi->offset, &c);
+	pio_sm_put(pio, sm, stream->bits_per_lane - 1);
+
+	return 0;
+}
+
+/**
+ * @brief Start the continuous capture of conversion results. The register
+ * access program is replaced by the capture one until the stream is stopped,
+ * CS stays asserted meanwhile.
+ * @param desc - The SPI descriptor.
+ * @param stream - The capture parameters, copied.
+ * @return 0 in case of success, error code otherwise.
+ */
+int32_t pico_spi_pio_stream_start(struct no_os_spi_desc *desc,
+				  const struct pico_spi_pio_stream *stream)
+{
+	struct pico_spi_pio_desc *pio_spi;
+	uint32_t frame_bits;
+	uint32_t idx;
+	int32_t ret;
+
+	if (!desc || !desc->extra || !stream || !stream->buf ||
+	    !stream->nb_words || stream->nb_words % 2 ||
+	    !stream->bits_per_lane || stream->bits_per_lane > 32)
+		return -EINVAL;
+
+	pio_spi = desc->extra;
+	frame_bits = stream->bits_per_lane * pio_spi->rx_lanes;
+	if (frame_bits > 32 && frame_bits % 32)
+		return -EINVAL;
+
+	idx = pio_get_index(pio_spi->pio);
+	if (pio_spi->streaming || stream_desc[idx])
+		return -EBUSY;
+
+	pio_spi->stream = *stream;
+	pico_spi_pio_unload(pio_spi);
+
+	ret = pico_spi_pio_stream_config(desc);
+	if (ret)
+		goto restore;
+
+	ret = pico_spi_pio_dma_setup(pio_spi);
+	if (ret) {
+		pico_spi_pio_unload(pio_spi);
+		goto restore;
+	}
+
+	pio_spi->streaming = true;
+	stream_desc[idx] = desc;
+
+	if (pio_spi->cs_pin != pio_spi->convst_pin)
+		/* Assert CS */
+		gpio_put(pio_spi->cs_pin, 0);
+
+	pio_sm_set_enabled(pio_spi->pio, pio_spi->sm, true);
+
+	return 0;
+
+restore:
+	pico_spi_pio_config(desc);
+
+	return ret;
+}
+
+/**
+ * @brief Stop the capture and go back to register access.
+ * @param desc - The SPI descriptor.
+ * @return 0 in case of success, error code otherwise.
+ */
+int32_t pico_spi_pio_stream_stop(struct no_os_spi_desc *desc)
+{
+	struct pico_spi_pio_desc *pio_spi;
+	uint32_t mask;
+
+	if (!desc || !desc->extra)
+		return -EINVAL;
+
+	pio_spi = desc->extra;
+	if (!pio_spi->streaming)
+		return 0;
+
+	pio_sm_set_enabled(pio_spi->pio, pio_spi->sm, false);
+
+	/* Aborted together, so that none of them triggers the other */
+	mask = NO_OS_BIT(pio_spi->dma[0]) | NO_OS_BIT(pio_spi->dma[1]);
+	dma_channel_set_irq0_enabled(pio_spi->dma[0], false);
+	dma_channel_set_irq0_enabled(pio_spi->dma[1], false);
+	dma_hw->abort = mask;
+	while (dma_hw->abort & mask)
+		;
+	dma_hw->ints0 = mask;
+	dma_channel_unclaim(pio_spi->dma[0]);
+	dma_channel_unclaim(pio_spi->dma[1]);
+
+	stream_desc[pio_get_index(pio_spi->pio)] = NULL;
+	pio_spi->streaming = false;
+
+	/* De-assert CS, giving the pin back to the SIO if CONVST used it */
+	gpio_put(pio_spi->cs_pin, 1);
+	gpio_set_function(pio_spi->cs_pin, GPIO_FUNC_SIO);
+
+	pico_spi_pio_unload(pio_spi);
+
+	return pico_spi_pio_config(desc);
+}
+
+/**
+ * @brief pico platform specific PIO SPI platform ops structure
+ */
+const struct no_os_spi_platform_ops pico_spi_pio_ops = {
+	.init = &pico_spi_pio_init,
+	.write_and_read = &pico_spi_pio_write_and_read,
+	.transfer = &pico_spi_pio_transfer,
+	.remove = &pico_spi_pio_remove
+};
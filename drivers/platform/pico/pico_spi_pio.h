@@ -0,0 +1,173 @@
+/***************************************************************************//**
+ *   @file   pico_spi_pio.h
+ *   @brief  Header file of the PIO based SPI engine for the pico platform.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef _PICO_SPI_PIO_H_
+#define _PICO_SPI_PIO_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdbool.h>
+#include "no_os_spi.h"
+#include "hardware/pio.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Value of convst_pin and busy_pin when the pin is not used */
+#define PICO_SPI_PIO_NO_PIN	0xFFU
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Called from interrupt context each time half of the stream buffer
+ * was filled. The other half is being filled meanwhile, the block must be
+ * consumed before it is complete.
+ * @param ctx - Parameter given in the stream structure.
+ * @param block - First word of the block.
+ * @param nb_words - Number of words of the block.
+ */
+typedef void (*pico_spi_pio_block_cb)(void *ctx, uint32_t *block,
+				      uint32_t nb_words);
+
+/**
+ * @struct pico_spi_pio_stream
+ * @brief Continuous capture of conversion results. Each frame pulses CONVST,
+ * waits for the conversion and clocks bits_per_lane bits on every data lane,
+ * the lanes being sampled together on each SCK edge. The DMA channels are
+ * chained, the capture has no gap between the two halves of buf.
+ */
+struct pico_spi_pio_stream {
+	/** Buffer, 32 bit words filled MSB first, the lanes interleaved */
+	uint32_t *buf;
+	/** Number of words of buf, even */
+	uint32_t nb_words;
+	/** Bits clocked on each lane in a frame */
+	uint8_t bits_per_lane;
+	/** Frames per second, 0 to run as fast as the timings allow */
+	uint32_t sample_rate;
+	/** Time CONVST is kept high */
+	uint32_t convst_high_ns;
+	/** Time waited after CONVST went low, when there is no busy pin */
+	uint32_t conv_time_ns;
+	/** Called when a half of buf is filled */
+	pico_spi_pio_block_cb callback;
+	/** Parameter of callback */
+	void *ctx;
+};
+
+/**
+ * @struct pico_spi_pio_desc
+ * @brief pico platform specific PIO SPI descriptor
+ */
+struct pico_spi_pio_desc {
+	/** PIO block */
+	PIO pio;
+	/** State machine */
+	uint32_t sm;
+	/** Memory offset of the loaded program */
+	uint32_t offset;
+	/** Loaded program */
+	pio_program_t program;
+	/** Instructions of the loaded program */
+	uint16_t instr[32];
+	/** SCK pin */
+	uint8_t sck_pin;
+	/** Controller to device data pin */
+	uint8_t tx_pin;
+	/** First device to controller data pin */
+	uint8_t rx_pin;
+	/** Number of device to controller data lanes, on consecutive pins */
+	uint8_t rx_lanes;
+	/** CS pin */
+	uint8_t cs_pin;
+	/** CONVST pin, PICO_SPI_PIO_NO_PIN if not used */
+	uint8_t convst_pin;
+	/** BUSY pin, PICO_SPI_PIO_NO_PIN if not used */
+	uint8_t busy_pin;
+	/** Set while a stream is running */
+	bool streaming;
+	/** DMA channels filling the two halves of the stream buffer */
+	int dma[2];
+	/** Running stream */
+	struct pico_spi_pio_stream stream;
+};
+
+/**
+ * @struct pico_spi_pio_init_param
+ * @brief Additional PIO SPI config parameters
+ */
+struct pico_spi_pio_init_param {
+	/** PIO block, 0 or 1 */
+	uint8_t pio_id;
+	/** SCK pin */
+	uint8_t sck_pin;
+	/** Controller to device data pin */
+	uint8_t tx_pin;
+	/** First device to controller data pin */
+	uint8_t rx_pin;
+	/** Number of data lanes used by the stream, 1, 2, 4 or 8 */
+	uint8_t rx_lanes;
+	/** CS pin */
+	uint8_t cs_pin;
+	/** CONVST pin, PICO_SPI_PIO_NO_PIN if not used */
+	uint8_t convst_pin;
+	/** BUSY pin, PICO_SPI_PIO_NO_PIN if not used */
+	uint8_t busy_pin;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Start the continuous capture of conversion results. */
+int32_t pico_spi_pio_stream_start(struct no_os_spi_desc *desc,
+				  const struct pico_spi_pio_stream *stream);
+
+/* Stop the capture and go back to register access. */
+int32_t pico_spi_pio_stream_stop(struct no_os_spi_desc *desc);
+
+/**
+ * @brief pico specific PIO SPI platform ops structure
+ */
+extern const struct no_os_spi_platform_ops pico_spi_pio_ops;
+
+#endif // _PICO_SPI_PIO_H_
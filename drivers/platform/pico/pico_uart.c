@@ -43,7 +43,7 @@
 
 #include "no_os_error.h"
 #include "no_os_uart.h"
-#include "no_os_lf256fifo.h"
+#include "no_os_lffifo.h"
 #include "pico_uart.h"
 #include "pico_irq.h"
 #include "pico/stdlib.h"
@@ -63,7 +63,7 @@ void uart_rx_callback(void *context)
 	struct pico_uart_desc *pico_uart = d->extra;
 
 	uint8_t ch = uart_getc(pico_uart->uart_instance);
-	lf256fifo_write(d->rx_fifo, ch);
+	no_os_lffifo_write(d->rx_fifo, &ch, 1);
 }
 
 /**
@@ -159,7 +159,8 @@ static int32_t pico_uart_init(struct no_os_uart_desc **desc,
 	*desc = descriptor;
 
 	if(param->asynchronous_rx) {
-		ret = lf256fifo_init(&descriptor->rx_fifo);
+		ret = no_os_lffifo_init(&descriptor->rx_fifo, 1,
+					NO_OS_UART_RX_FIFO_SIZE);
 		if (ret)
 			goto error;
 
@@ -223,7 +224,7 @@ static int32_t pico_uart_remove(struct no_os_uart_desc *desc)
 
 	if (desc->rx_fifo) {
 		no_os_irq_disable(pico_uart->nvic, desc->irq_id);
-		lf256fifo_remove(desc->rx_fifo);
+		no_os_lffifo_remove(desc->rx_fifo);
 		desc->rx_fifo = NULL;
 		no_os_irq_unregister_callback(pico_uart->nvic, desc->irq_id,
 					      &pico_uart->rx_callback);
@@ -273,7 +274,6 @@ static int32_t pico_uart_read(struct no_os_uart_desc *desc, uint8_t *data,
 			      uint32_t bytes_number)
 {
 	struct pico_uart_desc *pico_uart;
-	int ret;
 	uint32_t i;
 
 	if (!desc || !desc->extra || !data)
@@ -285,12 +285,8 @@ static int32_t pico_uart_read(struct no_os_uart_desc *desc, uint8_t *data,
 	pico_uart = desc->extra;
 
 	if (desc->rx_fifo) {
-		for (i = 0; i < bytes_number; i++) {
-			ret = lf256fifo_read(desc->rx_fifo, &data[i]);
-			if (ret)
-				return i ? (int32_t)i : -EAGAIN;
-		}
-		return i;
+		i = no_os_lffifo_read(desc->rx_fifo, data, bytes_number);
+		return i ? (int32_t)i : -EAGAIN;
 	}
 
 	uart_read_blocking(pico_uart->uart_instance, data, bytes_number);
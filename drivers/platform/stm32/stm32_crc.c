@@ -0,0 +1,171 @@
+/***************************************************************************//**
+ *   @file   stm32/stm32_crc.c
+ *   @brief  Implementation of stm32 CRC engine functionality.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#include <errno.h>
+#include "no_os_alloc.h"
+#include "stm32_crc.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Initialize the CRC peripheral for the requested polynomial.
+ * @param desc - The CRC engine descriptor.
+ * @param param - The structure that contains the CRC engine parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t stm32_crc_init(struct no_os_crc_desc **desc,
+			      const struct no_os_crc_init_param *param)
+{
+#ifdef CRC_POLYLENGTH_8B
+	struct no_os_crc_desc *d;
+	struct stm32_crc_desc *sdesc;
+	uint32_t length;
+	int32_t ret;
+
+	switch (param->width) {
+	case 8:
+		length = CRC_POLYLENGTH_8B;
+		break;
+	case 16:
+		length = CRC_POLYLENGTH_16B;
+		break;
+	default:
+		return -ENOTSUP;
+	}
+
+	d = no_os_calloc(1, sizeof(*d));
+	if (!d)
+		return -ENOMEM;
+
+	sdesc = no_os_calloc(1, sizeof(*sdesc));
+	if (!sdesc) {
+		ret = -ENOMEM;
+		goto error_desc;
+	}
+
+	__HAL_RCC_CRC_CLK_ENABLE();
+
+	sdesc->hcrc.Instance = CRC;
+	sdesc->hcrc.Init.DefaultPolynomialUse = DEFAULT_POLYNOMIAL_DISABLE;
+	sdesc->hcrc.Init.GeneratingPolynomial = param->polynomial;
+	sdesc->hcrc.Init.CRCLength = length;
+	sdesc->hcrc.Init.DefaultInitValueUse = DEFAULT_INIT_VALUE_DISABLE;
+	sdesc->hcrc.Init.InitValue = 0;
+	sdesc->hcrc.Init.InputDataInversionMode = CRC_INPUTDATA_INVERSION_NONE;
+	sdesc->hcrc.Init.OutputDataInversionMode =
+		CRC_OUTPUTDATA_INVERSION_DISABLE;
+	sdesc->hcrc.InputDataFormat = CRC_INPUTDATA_FORMAT_BYTES;
+
+	if (HAL_CRC_Init(&sdesc->hcrc) != HAL_OK) {
+		ret = -EIO;
+		goto error_extra;
+	}
+
+	d->extra = sdesc;
+	*desc = d;
+
+	return 0;
+
+error_extra:
+	no_os_free(sdesc);
+error_desc:
+	no_os_free(d);
+
+	return ret;
+#else
+	/* The CRC peripheral of this family only computes CRC-32 */
+	return -ENOSYS;
+#endif
+}
+
+/**
+ * @brief Compute the CRC with the peripheral.
+ * @param desc - The CRC engine descriptor.
+ * @param data - Pointer to the data buffer.
+ * @param len - Number of bytes to compute the CRC over.
+ * @param init - Initial value.
+ * @param crc - Computed CRC value.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t stm32_crc_compute(struct no_os_crc_desc *desc,
+				 const uint8_t *data, size_t len,
+				 uint32_t init, uint32_t *crc)
+{
+#ifdef CRC_POLYLENGTH_8B
+	struct stm32_crc_desc *sdesc = desc->extra;
+
+	if (!len) {
+		*crc = init;
+		return 0;
+	}
+
+	/* HAL_CRC_Calculate() starts from the INIT register value */
+	__HAL_CRC_INITIALCRCVALUE_CONFIG(&sdesc->hcrc, init);
+	*crc = HAL_CRC_Calculate(&sdesc->hcrc, (uint32_t *)data, len);
+
+	return 0;
+#else
+	return -ENOSYS;
+#endif
+}
+
+/**
+ * @brief Free the resources allocated by stm32_crc_init().
+ * @param desc - The CRC engine descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t stm32_crc_remove(struct no_os_crc_desc *desc)
+{
+	struct stm32_crc_desc *sdesc = desc->extra;
+
+	HAL_CRC_DeInit(&sdesc->hcrc);
+	no_os_free(sdesc);
+	no_os_free(desc);
+
+	return 0;
+}
+
+/**
+ * @brief stm32 platform specific CRC engine platform ops structure
+ */
+const struct no_os_crc_platform_ops stm32_crc_ops = {
+	.init = &stm32_crc_init,
+	.compute = &stm32_crc_compute,
+	.remove = &stm32_crc_remove
+};
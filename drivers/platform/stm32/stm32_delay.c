@@ -39,26 +39,81 @@
 #include <stdbool.h>
 #include "stm32_hal.h"
 #include "no_os_delay.h"
+#include "no_os_trace.h"
 /**
  * @brief Generate microseconds delay.
  * @param usecs - Delay in microseconds.
  * @return None.
  */
 #if defined(DWT)
+/**
+ * @brief Start the DWT cycle counter, if not already running.
+ */
+static inline void stm32_dwt_enable(void)
+{
+	if (DWT->CTRL & 1)
+		return;
+
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+#ifdef STM32F7
+	DWT->LAR = 0xC5ACCE55;
+#endif
+	DWT->CTRL |= 1;
+}
+
+#if defined(NO_OS_TRACE) || defined(NO_OS_IRQ_POLICY)
+/**
+ * @brief Get the timestamp of the trace events.
+ * @return Value of the DWT cycle counter.
+ */
+uint32_t no_os_trace_timestamp(void)
+{
+	stm32_dwt_enable();
+
+	return DWT->CYCCNT;
+}
+#endif
+
+/**
+ * @brief Get the monotonic time in nanoseconds, from the DWT cycle counter
+ * extended to 64 bits. It must be called at least once per counter wrap, every
+ * 2^32 / SystemCoreClock seconds, and assumes the core clock is not changed.
+ * @return Nanoseconds from the start of the cycle counter.
+ */
+uint64_t no_os_time_ns(void)
+{
+	static uint32_t high, last, freq, ns_int, ns_frac;
+	uint32_t primask, now;
+	uint64_t cycles;
+
+	stm32_dwt_enable();
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	now = DWT->CYCCNT;
+	if (now < last)
+		high++;
+	last = now;
+	cycles = ((uint64_t)high << 32) | now;
+	if (freq != SystemCoreClock) {
+		/* Nanoseconds per cycle, as 32.32 fixed point */
+		freq = SystemCoreClock;
+		ns_int = 1000000000U / freq;
+		ns_frac = ((uint64_t)(1000000000U % freq) << 32) / freq;
+	}
+	__set_PRIMASK(primask);
+
+	return cycles * ns_int + (cycles >> 32) * ns_frac +
+	       (((cycles & 0xFFFFFFFF) * ns_frac) >> 32);
+}
+
 #pragma GCC push_options
 #pragma GCC optimize ("O3")
 void no_os_udelay(uint32_t usecs)
 {
-	static bool firstrun = true;
 	volatile uint32_t cycles = (SystemCoreClock / 1000000L) * usecs;
-	if (firstrun) {
-		CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
-#ifdef STM32F7
-		DWT->LAR = 0xC5ACCE55;
-#endif
-		DWT->CTRL |= 1;
-		firstrun = false;
-	}
+
+	stm32_dwt_enable();
 	volatile uint32_t start = DWT->CYCCNT;
 	while(DWT->CYCCNT - start < cycles);
 }
@@ -69,6 +124,16 @@ void no_os_udelay(uint32_t usecs)
 	/* Fallback to lowest possible HAL delay of 1ms. */
 	HAL_Delay(1);
 }
+
+/**
+ * @brief Get the monotonic time in nanoseconds, with the resolution of the HAL
+ * tick on cores without DWT.
+ * @return Nanoseconds from system start.
+ */
+uint64_t no_os_time_ns(void)
+{
+	return (uint64_t)HAL_GetTick() * 1000000ULL;
+}
 #endif
 
 /**
@@ -0,0 +1,284 @@
+/***************************************************************************//**
+ *   @file   stm32/stm32_dma.c
+ *   @brief  Implementation of stm32 DMA driver.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#include <errno.h>
+#include "no_os_alloc.h"
+#include "stm32_dma.h"
+
+#define STM32_DMA_DCACHE_LINE	((uintptr_t)32)
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Take the handles of the channels.
+ * @param desc - The DMA controller descriptor.
+ * @param param - The structure that contains the DMA parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t stm32_dma_init(struct no_os_dma_desc *desc,
+			      const struct no_os_dma_init_param *param)
+{
+	struct stm32_dma_init_param *sparam = param->extra;
+	uint32_t i;
+
+	if (!sparam || !sparam->hdma)
+		return -EINVAL;
+
+	for (i = 0; i < desc->num_ch; i++) {
+		if (!sparam->hdma[i])
+			return -EINVAL;
+
+		/* Parent leads the HAL callbacks back to the channel */
+		sparam->hdma[i]->Parent = &desc->channels[i];
+		desc->channels[i].extra = sparam->hdma[i];
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Stop the channels of the controller.
+ * @param desc - The DMA controller descriptor.
+ * @return 0 in case of success.
+ */
+static int32_t stm32_dma_remove(struct no_os_dma_desc *desc)
+{
+	DMA_HandleTypeDef *hdma;
+	uint32_t i;
+
+	for (i = 0; i < desc->num_ch; i++) {
+		hdma = desc->channels[i].extra;
+		HAL_DMA_DeInit(hdma);
+		hdma->Parent = NULL;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief HAL transfer complete callback, called at each end of the buffer
+ * in circular mode.
+ * @param hdma - The DMA handle.
+ */
+static void stm32_dma_xfer_cplt(DMA_HandleTypeDef *hdma)
+{
+	no_os_dma_xfer_done(hdma->Parent);
+}
+
+/**
+ * @brief HAL transfer error callback, the transfer ends with -EIO.
+ * @param hdma - The DMA handle.
+ */
+static void stm32_dma_xfer_error(DMA_HandleTypeDef *hdma)
+{
+	no_os_dma_xfer_error(hdma->Parent, -EIO);
+}
+
+/**
+ * @brief Program the handle of the channel for the transfer.
+ * @param ch - The DMA channel.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t stm32_dma_config_xfer(struct no_os_dma_ch *ch)
+{
+	DMA_HandleTypeDef *hdma = ch->extra;
+	struct no_os_dma_xfer *xfer = ch->xfer;
+
+	switch (xfer->width) {
+	case 0:
+	case 1:
+		hdma->Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+		hdma->Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+		break;
+	case 2:
+		hdma->Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+		hdma->Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+		break;
+	case 4:
+		hdma->Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+		hdma->Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	switch (xfer->xfer_type) {
+	case NO_OS_DMA_MEM_TO_MEM:
+		/* Memory to memory transfers can't be circular */
+		if (xfer->cyclic)
+			return -ENOTSUP;
+		hdma->Init.Direction = DMA_MEMORY_TO_MEMORY;
+		hdma->Init.PeriphInc = DMA_PINC_ENABLE;
+		break;
+	case NO_OS_DMA_MEM_TO_DEV:
+		hdma->Init.Direction = DMA_MEMORY_TO_PERIPH;
+		hdma->Init.PeriphInc = DMA_PINC_DISABLE;
+		break;
+	case NO_OS_DMA_DEV_TO_MEM:
+		hdma->Init.Direction = DMA_PERIPH_TO_MEMORY;
+		hdma->Init.PeriphInc = DMA_PINC_DISABLE;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	if (!xfer->src || !xfer->dst)
+		return -EINVAL;
+
+	hdma->Init.MemInc = DMA_MINC_ENABLE;
+	hdma->Init.Mode = xfer->cyclic ? DMA_CIRCULAR : DMA_NORMAL;
+#if defined(DMA_REQUEST_MEM2MEM)
+	hdma->Init.Request = xfer->xfer_type == NO_OS_DMA_MEM_TO_MEM ?
+			     DMA_REQUEST_MEM2MEM : xfer->periph_req;
+#elif defined(DMA_CHANNEL_0)
+	hdma->Init.Channel = xfer->periph_req;
+#else
+	hdma->Init.Request = xfer->periph_req;
+#endif
+
+	if (HAL_DMA_Init(hdma) != HAL_OK)
+		return -EIO;
+
+	hdma->XferCpltCallback = stm32_dma_xfer_cplt;
+	hdma->XferErrorCallback = stm32_dma_xfer_error;
+
+	return 0;
+}
+
+/**
+ * @brief Start the transfer programmed on the channel.
+ * @param ch - The DMA channel.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t stm32_dma_xfer_start(struct no_os_dma_ch *ch)
+{
+	struct no_os_dma_xfer *xfer = ch->xfer;
+	uint32_t width = xfer->width ? xfer->width : 1;
+
+	if (HAL_DMA_Start_IT(ch->extra, (uint32_t)xfer->src,
+			     (uint32_t)xfer->dst,
+			     xfer->length / width) != HAL_OK)
+		return -EBUSY;
+
+	return 0;
+}
+
+/**
+ * @brief Stop the transfer running on the channel.
+ * @param ch - The DMA channel.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t stm32_dma_xfer_abort(struct no_os_dma_ch *ch)
+{
+	DMA_HandleTypeDef *hdma = ch->extra;
+
+	if (hdma->State != HAL_DMA_STATE_BUSY)
+		return 0;
+
+	if (HAL_DMA_Abort(hdma) != HAL_OK)
+		return -EIO;
+
+	return 0;
+}
+
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+/*
+ * The cache maintenance of the stm32 drivers doing DMA, e.g. stm32_spi and
+ * stm32_tdm, so this file must be built with them on the cores with data
+ * cache. Nothing is done while the cache is disabled.
+ */
+
+/**
+ * @brief Write back the data cache lines of a range, used by
+ * no_os_dma_sync_for_device().
+ * @param addr - Start of the range.
+ * @param size - Size of the range.
+ */
+void no_os_dcache_clean_range(uintptr_t addr, size_t size)
+{
+	uintptr_t start = addr & ~(STM32_DMA_DCACHE_LINE - 1);
+
+	if (SCB->CCR & SCB_CCR_DC_Msk)
+		SCB_CleanDCache_by_Addr((void *)start, size + addr - start);
+}
+
+/**
+ * @brief Drop the data cache lines of a range, used by
+ * no_os_dma_sync_for_cpu() after the DMA wrote it.
+ * no_os_dcache_flush_range() must have been called before the DMA.
+ * @param addr - Start of the range.
+ * @param size - Size of the range.
+ */
+void no_os_dcache_invalidate_range(uintptr_t addr, size_t size)
+{
+	uintptr_t start = addr & ~(STM32_DMA_DCACHE_LINE - 1);
+
+	if (SCB->CCR & SCB_CCR_DC_Msk)
+		SCB_InvalidateDCache_by_Addr((void *)start,
+					     size + addr - start);
+}
+
+/**
+ * @brief Write back and drop the data cache lines of a range, used by
+ * no_os_dma_sync_for_device() before the DMA writes it. The lines shared
+ * with the data around the range are saved, so invalidating them after the
+ * DMA doesn't lose them, as long as that data isn't written meanwhile.
+ * @param addr - Start of the range.
+ * @param size - Size of the range.
+ */
+void no_os_dcache_flush_range(uintptr_t addr, size_t size)
+{
+	uintptr_t start = addr & ~(STM32_DMA_DCACHE_LINE - 1);
+
+	if (SCB->CCR & SCB_CCR_DC_Msk)
+		SCB_CleanInvalidateDCache_by_Addr((void *)start,
+						  size + addr - start);
+}
+#endif
+
+/**
+ * @brief stm32 platform specific DMA platform ops structure
+ */
+const struct no_os_dma_platform_ops stm32_dma_ops = {
+	.init = &stm32_dma_init,
+	.remove = &stm32_dma_remove,
+	.config_xfer = &stm32_dma_config_xfer,
+	.xfer_start = &stm32_dma_xfer_start,
+	.xfer_abort = &stm32_dma_xfer_abort,
+};
@@ -0,0 +1,67 @@
+/***************************************************************************//**
+ *   @file   stm32/stm32_dma.h
+ *   @brief  Header file of stm32 DMA driver.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef STM32_DMA_H_
+#define STM32_DMA_H_
+
+#include <stdint.h>
+#include "no_os_dma.h"
+#include "stm32_hal.h"
+
+/**
+ * @struct stm32_dma_init_param
+ * @brief stm32 platform specific DMA controller initialization parameters
+ */
+struct stm32_dma_init_param {
+	/**
+	 * One handle per channel, num_ch in total. Instance is set by Cube or
+	 * by the user, the rest of Init is programmed for each transfer. The
+	 * interrupt handler of the stream must call HAL_DMA_IRQHandler(). The
+	 * handles must not be linked to a HAL peripheral driver. BDMA channels
+	 * of the H7 are handled the same way.
+	 */
+	DMA_HandleTypeDef **hdma;
+};
+
+/**
+ * @brief stm32 platform specific DMA platform ops structure. periph_req of
+ * the transfers is the DMAMUX request (e.g. DMA_REQUEST_SPI1_TX) or, on
+ * the families without it, the channel selection (e.g. DMA_CHANNEL_3).
+ */
+extern const struct no_os_dma_platform_ops stm32_dma_ops;
+
+#endif
@@ -340,6 +340,60 @@ int32_t stm32_gpio_get_value(struct no_os_gpio_desc *desc,
 	return 0;
 }
 
+/**
+ * @brief Set the values of several GPIOs of the port through BSRR, in a single
+ * atomic write.
+ * @param desc - The GPIO descriptor of the first pin of the group.
+ * @param mask - Pins to be set, bit n being the pin desc->number + n.
+ * @param values - The values, in the same order as mask.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t stm32_gpio_set_multiple(struct no_os_gpio_desc *desc, uint32_t mask,
+				uint32_t values)
+{
+	struct stm32_gpio_desc *extra;
+
+	if (!desc || desc->number >= 16 || mask >> (16 - desc->number))
+		return -EINVAL;
+
+	if (!desc->extra)
+		return -EFAULT;
+
+	extra = desc->extra;
+
+	/* The upper half resets the pins, the lower half sets them */
+	extra->port->BSRR = ((values & mask) << desc->number) |
+			    ((~values & mask) << (desc->number + 16));
+
+	return 0;
+}
+
+/**
+ * @brief Get the values of several GPIOs of the port from IDR.
+ * @param desc - The GPIO descriptor of the first pin of the group.
+ * @param mask - Pins to be read, bit n being the pin desc->number + n.
+ * @param values - The values, in the same order as mask.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t stm32_gpio_get_multiple(struct no_os_gpio_desc *desc, uint32_t mask,
+				uint32_t *values)
+{
+	struct stm32_gpio_desc *extra;
+
+	if (!desc || !values || desc->number >= 16 ||
+	    mask >> (16 - desc->number))
+		return -EINVAL;
+
+	if (!desc->extra)
+		return -EFAULT;
+
+	extra = desc->extra;
+
+	*values = (extra->port->IDR >> desc->number) & mask;
+
+	return 0;
+}
+
 /**
  * @brief stm32 platform specific GPIO platform ops structure
  */
@@ -352,4 +406,6 @@ const struct no_os_gpio_platform_ops stm32_gpio_ops = {
 	.gpio_ops_get_direction = &stm32_gpio_get_direction,
 	.gpio_ops_set_value = &stm32_gpio_set_value,
 	.gpio_ops_get_value = &stm32_gpio_get_value,
+	.gpio_ops_set_multiple = &stm32_gpio_set_multiple,
+	.gpio_ops_get_multiple = &stm32_gpio_get_multiple,
 };
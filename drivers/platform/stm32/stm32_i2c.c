@@ -208,6 +208,73 @@ int32_t stm32_i2c_read(struct no_os_i2c_desc *desc,
 	return 0;
 }
 
+/**
+ * @brief Send multiple messages to/from a slave device.
+ * The polling HAL API has no repeated start between arbitrary messages, so
+ * the supported transfers are a single message, and a register address of at
+ * most 2 bytes followed by a read (with a repeated start) or a write. The
+ * others get -ENOSYS and are sent message by message by no_os_i2c_transfer().
+ * @param desc - The I2C descriptor.
+ * @param msgs - Array of messages.
+ * @param len - Number of messages in the array.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t stm32_i2c_transfer(struct no_os_i2c_desc *desc,
+			   struct no_os_i2c_msg *msgs,
+			   uint32_t len)
+{
+	struct stm32_i2c_desc *xdesc;
+	uint16_t mem_addr;
+	uint16_t mem_size;
+	int ret;
+
+	if (!desc || !desc->extra || !msgs)
+		return -EINVAL;
+
+	xdesc = desc->extra;
+
+	switch (len) {
+	case 0:
+		return 0;
+	case 1:
+		if (msgs[0].read)
+			return stm32_i2c_read(desc, msgs[0].data,
+					      msgs[0].bytes_number, 1);
+
+		return stm32_i2c_write(desc, msgs[0].data,
+				       msgs[0].bytes_number, 1);
+	case 2:
+		break;
+	default:
+		return -ENOSYS;
+	}
+
+	/* Sent by no_os_i2c_transfer() with plain reads and writes */
+	if (msgs[0].read || !msgs[0].bytes_number || msgs[0].bytes_number > 2)
+		return -ENOSYS;
+
+	if (msgs[0].bytes_number == 2) {
+		mem_addr = no_os_get_unaligned_be16(msgs[0].data);
+		mem_size = I2C_MEMADD_SIZE_16BIT;
+	} else {
+		mem_addr = msgs[0].data[0];
+		mem_size = I2C_MEMADD_SIZE_8BIT;
+	}
+
+	if (msgs[1].read)
+		ret = HAL_I2C_Mem_Read(&xdesc->hi2c, desc->slave_address << 1,
+				       mem_addr, mem_size, msgs[1].data,
+				       msgs[1].bytes_number, HAL_MAX_DELAY);
+	else
+		ret = HAL_I2C_Mem_Write(&xdesc->hi2c, desc->slave_address << 1,
+					mem_addr, mem_size, msgs[1].data,
+					msgs[1].bytes_number, HAL_MAX_DELAY);
+	if (ret != HAL_OK)
+		return -EIO;
+
+	return 0;
+}
+
 /**
  * @brief stm32 platform specific I2C platform ops structure
  */
@@ -215,5 +282,6 @@ const struct no_os_i2c_platform_ops stm32_i2c_ops = {
 	.i2c_ops_init = &stm32_i2c_init,
 	.i2c_ops_write = &stm32_i2c_write,
 	.i2c_ops_read = &stm32_i2c_read,
+	.i2c_ops_transfer = &stm32_i2c_transfer,
 	.i2c_ops_remove = &stm32_i2c_remove
 };
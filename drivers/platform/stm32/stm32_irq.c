@@ -48,6 +48,9 @@
 #include "no_os_irq.h"
 #include "no_os_util.h"
 #include "stm32_irq.h"
+#ifdef NO_OS_SCHED
+#include "no_os_sched.h"
+#endif
 
 struct irq_action {
 	void *handle;
@@ -422,6 +425,45 @@ static int32_t stm32_irq_set_priority(struct no_os_irq_ctrl_desc *desc,
 	return 0;
 }
 
+#ifdef NO_OS_SCHED
+/* Clock configuration of the project, lost in STOP mode */
+extern void SystemClock_Config(void) __attribute__((weak));
+
+/**
+ * @brief Sleep until the next interrupt if no work is pending. The check is
+ * done with the interrupts masked, a pending interrupt still wakes up WFI.
+ * With no timer armed and no deep sleep lock, the core enters STOP mode, left
+ * on the EXTI interrupts (GPIO, or the UART RX of the parts supporting it).
+ * There is no RTC wakeup, STOP is not entered while a timer is armed.
+ */
+void no_os_sched_idle(void)
+{
+	uint32_t sleep_ms;
+
+	__disable_irq();
+	switch (no_os_sched_sleep_level(&sleep_ms)) {
+	case NO_OS_SCHED_SLEEP_DEEP:
+		if (sleep_ms == NO_OS_SCHED_FOREVER) {
+			HAL_SuspendTick();
+			HAL_PWR_EnterSTOPMode(PWR_LOWPOWERREGULATOR_ON,
+					      PWR_STOPENTRY_WFI);
+			/* The system clock restarts from HSI */
+			if (SystemClock_Config)
+				SystemClock_Config();
+			HAL_ResumeTick();
+			break;
+		}
+	/* fallthrough */
+	case NO_OS_SCHED_SLEEP_WAIT:
+		__WFI();
+		break;
+	default:
+		break;
+	}
+	__enable_irq();
+}
+#endif
+
 /**
  * @brief stm32 specific IRQ platform ops structure
  */
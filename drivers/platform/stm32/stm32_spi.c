@@ -38,13 +38,21 @@
 *******************************************************************************/
 #include <stdlib.h>
 #include <errno.h>
+#include <stddef.h>
+#include <string.h>
 #include "no_os_util.h"
+#include "no_os_alloc.h"
+#include "no_os_hot.h"
+#include "no_os_delay.h"
 #include "no_os_gpio.h"
 #include "stm32_gpio.h"
 #include "no_os_spi.h"
 #include "stm32_spi.h"
 
-#warning SPI delays are not supported on the stm32 platform
+/* Maximum number of bytes of a HAL transfer */
+#define STM32_SPI_HAL_MAX_XFER	0xFFFF
+/* Time given to a DMA transfer of n bytes, for a bus of 64 kHz or more */
+#define STM32_SPI_DMA_TIMEOUT_MS(n)	(100 + (n) / 8)
 
 static int stm32_spi_config(struct no_os_spi_desc *desc)
 {
@@ -153,6 +161,155 @@ error:
 	return ret;
 }
 
+/**
+ * @brief Configure the SPI, if it was last used for another slave.
+ * @param desc - The SPI descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int stm32_spi_select(struct no_os_spi_desc *desc)
+{
+	static uint64_t last_slave_id;
+	uint64_t slave_id;
+	struct stm32_spi_desc *sdesc = desc->extra;
+
+	// Compute a slave ID based on SPI instance and chip select.
+	// If it did not change since last call, no need to reconfigure SPI.
+	// Otherwise, reconfigure it.
+	slave_id = ((uint64_t)(uintptr_t)sdesc->hspi.Instance << 32) |
+		   sdesc->chip_select->number;
+	if (slave_id == last_slave_id)
+		return 0;
+
+	last_slave_id = slave_id;
+
+	return stm32_spi_config(desc);
+}
+
+/**
+ * @brief Write and read data by polling the SPI registers.
+ * @param sdesc - The stm32 SPI descriptor.
+ * @param tx - Data to send. If NULL, 0x00 is sent.
+ * @param rx - Where to store received data. If NULL, it is discarded.
+ * @param len - Number of bytes.
+ */
+static void stm32_spi_poll(struct stm32_spi_desc *sdesc, const uint8_t *tx,
+			   uint8_t *rx, uint32_t len)
+{
+	SPI_TypeDef *SPIx = sdesc->hspi.Instance;
+	uint8_t byte;
+
+	__HAL_SPI_ENABLE(&sdesc->hspi);
+	while(len--) {
+		while(!(SPIx->SR & SPI_SR_TXE))
+			;
+		*(volatile uint8_t *)&SPIx->DR = tx ? *tx++ : 0;
+		while(!(SPIx->SR & SPI_SR_RXNE))
+			;
+		byte = *(volatile uint8_t *)&SPIx->DR;
+		if (rx)
+			*rx++ = byte;
+	}
+	__HAL_SPI_DISABLE(&sdesc->hspi);
+}
+
+/**
+ * @brief Start a HAL transfer of a message, using DMA if it is enabled or the
+ * SPI interrupt otherwise.
+ * @param sdesc - The stm32 SPI descriptor.
+ * @param msg - The message. When it has no tx buffer, the rx buffer is cleared
+ * 		and sent instead.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int stm32_spi_hal_start(struct stm32_spi_desc *sdesc,
+			       struct no_os_spi_msg *msg)
+{
+	HAL_StatusTypeDef ret;
+	uint8_t *tx;
+
+	if (msg->bytes_number > STM32_SPI_HAL_MAX_XFER)
+		return -EINVAL;
+
+	/* 0x00 is sent when there is no tx buffer */
+	tx = msg->tx_buff;
+	if (!tx) {
+		memset(msg->rx_buff, 0, msg->bytes_number);
+		tx = msg->rx_buff;
+	}
+
+	if (sdesc->dma) {
+		no_os_dma_sync_for_device(tx, msg->bytes_number,
+					  NO_OS_DMA_TO_DEVICE);
+		no_os_dma_sync_for_device(msg->rx_buff, msg->bytes_number,
+					  NO_OS_DMA_FROM_DEVICE);
+		if (!msg->rx_buff)
+			ret = HAL_SPI_Transmit_DMA(&sdesc->hspi, tx,
+						   msg->bytes_number);
+		else
+			ret = HAL_SPI_TransmitReceive_DMA(&sdesc->hspi, tx,
+							  msg->rx_buff,
+							  msg->bytes_number);
+	} else {
+		if (!msg->rx_buff)
+			ret = HAL_SPI_Transmit_IT(&sdesc->hspi, tx,
+						  msg->bytes_number);
+		else
+			ret = HAL_SPI_TransmitReceive_IT(&sdesc->hspi, tx,
+							 msg->rx_buff,
+							 msg->bytes_number);
+	}
+
+	if (ret == HAL_BUSY)
+		return -EBUSY;
+	if (ret != HAL_OK)
+		return -EIO;
+
+	return 0;
+}
+
+/**
+ * @brief Write and read a message using DMA, waiting for it to finish.
+ * @param sdesc - The stm32 SPI descriptor.
+ * @param msg - The message.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int stm32_spi_dma_transfer(struct stm32_spi_desc *sdesc,
+				  struct no_os_spi_msg *msg)
+{
+	struct no_os_spi_msg chunk = *msg;
+	uint32_t left = msg->bytes_number;
+	uint32_t start;
+	int ret;
+
+	while (left) {
+		chunk.bytes_number = no_os_min(left, STM32_SPI_HAL_MAX_XFER);
+		ret = stm32_spi_hal_start(sdesc, &chunk);
+		if (ret)
+			return ret;
+
+		start = HAL_GetTick();
+		while (HAL_SPI_GetState(&sdesc->hspi) != HAL_SPI_STATE_READY) {
+			if (HAL_GetTick() - start >
+			    STM32_SPI_DMA_TIMEOUT_MS(chunk.bytes_number)) {
+				HAL_SPI_Abort(&sdesc->hspi);
+				return -ETIMEDOUT;
+			}
+		}
+		if (sdesc->hspi.ErrorCode != HAL_SPI_ERROR_NONE)
+			return -EIO;
+
+		no_os_dma_sync_for_cpu(chunk.rx_buff, chunk.bytes_number,
+				       NO_OS_DMA_FROM_DEVICE);
+
+		if (chunk.tx_buff)
+			chunk.tx_buff += chunk.bytes_number;
+		if (chunk.rx_buff)
+			chunk.rx_buff += chunk.bytes_number;
+		left -= chunk.bytes_number;
+	}
+
+	return 0;
+}
+
 /**
  * @brief Initialize the SPI communication peripheral.
  * @param desc - The SPI descriptor.
@@ -210,6 +367,12 @@ int32_t stm32_spi_init(struct no_os_spi_desc **desc,
 	if (sinit->get_input_clock)
 		sdesc->input_clock = sinit->get_input_clock();
 
+	if (sinit->hdma_tx && sinit->hdma_rx) {
+		__HAL_LINKDMA(&sdesc->hspi, hdmatx, *sinit->hdma_tx);
+		__HAL_LINKDMA(&sdesc->hspi, hdmarx, *sinit->hdma_rx);
+		sdesc->dma = true;
+	}
+
 	ret = stm32_spi_config(spi_desc);
 	if (ret)
 		goto error;
@@ -243,6 +406,66 @@ int32_t stm32_spi_remove(struct no_os_spi_desc *desc)
 	return 0;
 }
 
+/**
+ * @brief Write/read multiple messages to/from SPI.
+ * @param desc - The SPI descriptor.
+ * @param msgs - The messages array.
+ * @param len - Number of messages.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t stm32_spi_transfer(struct no_os_spi_desc *desc,
+			   struct no_os_spi_msg *msgs,
+			   uint32_t len)
+{
+	int ret;
+	uint32_t i;
+	uint32_t cs_mask;
+	struct stm32_spi_desc *sdesc;
+	struct stm32_gpio_desc *gdesc;
+
+	if (!desc || !desc->extra || !msgs)
+		return -EINVAL;
+
+	sdesc = desc->extra;
+	gdesc = sdesc->chip_select->extra;
+	cs_mask = NO_OS_BIT(sdesc->chip_select->number);
+
+	if (sdesc->async_callback)
+		return -EBUSY;
+
+	ret = stm32_spi_select(desc);
+	if (ret)
+		return ret;
+
+	for (i = 0; i < len; i++) {
+		gdesc->port->BSRR = cs_mask << 16;
+
+		if (msgs[i].cs_delay_first)
+			no_os_udelay(msgs[i].cs_delay_first);
+
+		if (sdesc->dma && (msgs[i].tx_buff || msgs[i].rx_buff))
+			ret = stm32_spi_dma_transfer(sdesc, &msgs[i]);
+		else
+			stm32_spi_poll(sdesc, msgs[i].tx_buff, msgs[i].rx_buff,
+				       msgs[i].bytes_number);
+		if (ret) {
+			gdesc->port->BSRR = cs_mask;
+			return ret;
+		}
+
+		if (msgs[i].cs_delay_last)
+			no_os_udelay(msgs[i].cs_delay_last);
+
+		if (msgs[i].cs_change)
+			gdesc->port->BSRR = cs_mask;
+
+		if (msgs[i].cs_change_delay)
+			no_os_udelay(msgs[i].cs_change_delay);
+	}
+
+	return 0;
+}
+
 /**
  * @brief Write and read data to/from SPI.
  * @param desc - The SPI descriptor.
@@ -250,54 +473,191 @@ int32_t stm32_spi_remove(struct no_os_spi_desc *desc)
  * @param bytes_number - Number of bytes to write/read.
  * @return 0 in case of success, -1 otherwise.
  */
-int32_t stm32_spi_write_and_read(struct no_os_spi_desc *desc,
-				 uint8_t *data,
-				 uint16_t bytes_number)
+NO_OS_HOT int32_t stm32_spi_write_and_read(struct no_os_spi_desc *desc,
+					   uint8_t *data,
+					   uint16_t bytes_number)
 {
-	int ret;
-	static uint64_t last_slave_id;
-	uint64_t slave_id;
-	uint8_t *tx = data;
-	uint8_t *rx = data;
-	struct stm32_spi_desc *sdesc;
-	struct stm32_gpio_desc *gdesc;
-	SPI_TypeDef * SPIx;
+	struct no_os_spi_msg msg = {
+		.tx_buff = data,
+		.rx_buff = data,
+		.bytes_number = bytes_number,
+		.cs_change = 1,
+	};
+
 	if (!desc || !desc->extra || !data)
 		return -EINVAL;
 
 	if (!bytes_number)
 		return 0;
 
-	sdesc = desc->extra;
-	gdesc = sdesc->chip_select->extra;
-	SPIx = sdesc->hspi.Instance;
+	return stm32_spi_transfer(desc, &msg, 1);
+}
 
-	// Compute a slave ID based on SPI instance and chip select.
-	// If it did not change since last call to stm32_spi_write_and_read,
-	// no need to reconfigure SPI. Otherwise, reconfigure it.
-	slave_id = ((uint64_t)(uintptr_t)sdesc->hspi.Instance << 32) |
-		   sdesc->chip_select->number;
-	if (slave_id != last_slave_id) {
-		last_slave_id = slave_id;
-		ret = stm32_spi_config(desc);
-		if (ret)
-			return ret;
+#if (USE_HAL_SPI_REGISTER_CALLBACKS == 1)
+/**
+ * @brief Set the CS of an asynchronous transfer, from interrupt context.
+ * @param sdesc - The stm32 SPI descriptor.
+ * @param assert - true to drive the CS low, false to drive it high.
+ */
+static void stm32_spi_async_cs(struct stm32_spi_desc *sdesc, bool assert)
+{
+	struct stm32_gpio_desc *gdesc = sdesc->chip_select->extra;
+	uint32_t mask = NO_OS_BIT(sdesc->chip_select->number);
+
+	gdesc->port->BSRR = assert ? mask << 16 : mask;
+}
+
+/**
+ * @brief Get the stm32 SPI descriptor of a HAL SPI handle.
+ * @param hspi - The HAL SPI handle, member of a stm32_spi_desc.
+ * @return The stm32 SPI descriptor.
+ */
+static struct stm32_spi_desc *stm32_spi_from_hspi(SPI_HandleTypeDef *hspi)
+{
+	return (struct stm32_spi_desc *)((uint8_t *)hspi -
+					 offsetof(struct stm32_spi_desc, hspi));
+}
+
+/**
+ * @brief End the ongoing asynchronous transfer.
+ * @param sdesc - The stm32 SPI descriptor.
+ * @param ret - Result passed to the callback.
+ */
+static void stm32_spi_async_end(struct stm32_spi_desc *sdesc, int32_t ret)
+{
+	no_os_spi_callback callback = sdesc->async_callback;
+
+	stm32_spi_async_cs(sdesc, false);
+	HAL_SPI_UnRegisterCallback(&sdesc->hspi, HAL_SPI_TX_RX_COMPLETE_CB_ID);
+	HAL_SPI_UnRegisterCallback(&sdesc->hspi, HAL_SPI_TX_COMPLETE_CB_ID);
+	HAL_SPI_UnRegisterCallback(&sdesc->hspi, HAL_SPI_ERROR_CB_ID);
+
+	/* Cleared first, so that the callback can start a new transfer */
+	sdesc->async_callback = NULL;
+	callback(sdesc->async_ctx, ret);
+}
+
+/**
+ * @brief Start sending the current message of the asynchronous transfer.
+ * Messages without data are completed without starting the peripheral.
+ * @param sdesc - The stm32 SPI descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t stm32_spi_async_start(struct stm32_spi_desc *sdesc)
+{
+	struct no_os_spi_msg *msg = NULL;
+
+	for (; sdesc->async_idx < sdesc->async_len; sdesc->async_idx++) {
+		msg = &sdesc->async_msgs[sdesc->async_idx];
+		stm32_spi_async_cs(sdesc, true);
+		if (msg->bytes_number && (msg->tx_buff || msg->rx_buff))
+			break;
+		if (msg->cs_change)
+			stm32_spi_async_cs(sdesc, false);
 	}
 
-	gdesc->port->BSRR = NO_OS_BIT(sdesc->chip_select->number) << 16;
-	__HAL_SPI_ENABLE(&sdesc->hspi);
-	while(bytes_number--) {
-		while(!(SPIx->SR & SPI_SR_TXE))
-			;
-		*(volatile uint8_t *)&SPIx->DR = *tx++;
-		while(!(SPIx->SR & SPI_SR_RXNE))
-			;
-		*rx++ = *(volatile uint8_t *)&SPIx->DR;
+	if (sdesc->async_idx == sdesc->async_len) {
+		stm32_spi_async_end(sdesc, 0);
+		return 0;
 	}
-	__HAL_SPI_DISABLE(&sdesc->hspi);
-	gdesc->port->BSRR = NO_OS_BIT(sdesc->chip_select->number);
 
-	return 0;
+	return stm32_spi_hal_start(sdesc, msg);
+}
+
+/**
+ * @brief HAL completion callback of an asynchronous transfer message.
+ * @param hspi - The HAL SPI handle.
+ */
+static void stm32_spi_async_done(SPI_HandleTypeDef *hspi)
+{
+	struct stm32_spi_desc *sdesc = stm32_spi_from_hspi(hspi);
+	struct no_os_spi_msg *msg;
+	int32_t ret;
+
+	msg = &sdesc->async_msgs[sdesc->async_idx];
+	if (sdesc->dma)
+		no_os_dma_sync_for_cpu(msg->rx_buff, msg->bytes_number,
+				       NO_OS_DMA_FROM_DEVICE);
+	if (msg->cs_change)
+		stm32_spi_async_cs(sdesc, false);
+
+	sdesc->async_idx++;
+	ret = stm32_spi_async_start(sdesc);
+	if (ret)
+		stm32_spi_async_end(sdesc, ret);
+}
+
+/**
+ * @brief HAL error callback of an asynchronous transfer.
+ * @param hspi - The HAL SPI handle.
+ */
+static void stm32_spi_async_error(SPI_HandleTypeDef *hspi)
+{
+	stm32_spi_async_end(stm32_spi_from_hspi(hspi), -EIO);
+}
+#endif
+
+/**
+ * @brief Start sending multiple messages to/from SPI, using interrupts.
+ * Delays are not supported. The CS is deasserted after the last message.
+ * @param desc - The SPI descriptor.
+ * @param msgs - The messages array.
+ * @param len - Number of messages.
+ * @param callback - Called from interrupt context when the transfer is done.
+ * @param ctx - Parameter of callback.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t stm32_spi_transfer_async(struct no_os_spi_desc *desc,
+				 struct no_os_spi_msg *msgs,
+				 uint32_t len,
+				 no_os_spi_callback callback,
+				 void *ctx)
+{
+#if (USE_HAL_SPI_REGISTER_CALLBACKS == 1)
+	struct stm32_spi_desc *sdesc;
+	int32_t ret;
+
+	if (!desc || !desc->extra || !msgs || !callback)
+		return -EINVAL;
+
+	sdesc = desc->extra;
+	if (sdesc->async_callback)
+		return -EBUSY;
+
+	ret = stm32_spi_select(desc);
+	if (ret)
+		return ret;
+
+	ret = HAL_SPI_RegisterCallback(&sdesc->hspi,
+				       HAL_SPI_TX_RX_COMPLETE_CB_ID,
+				       stm32_spi_async_done);
+	if (ret != HAL_OK)
+		return -EIO;
+	ret = HAL_SPI_RegisterCallback(&sdesc->hspi, HAL_SPI_TX_COMPLETE_CB_ID,
+				       stm32_spi_async_done);
+	if (ret != HAL_OK)
+		return -EIO;
+	ret = HAL_SPI_RegisterCallback(&sdesc->hspi, HAL_SPI_ERROR_CB_ID,
+				       stm32_spi_async_error);
+	if (ret != HAL_OK)
+		return -EIO;
+
+	sdesc->async_msgs = msgs;
+	sdesc->async_len = len;
+	sdesc->async_idx = 0;
+	sdesc->async_ctx = ctx;
+	sdesc->async_callback = callback;
+
+	ret = stm32_spi_async_start(sdesc);
+	if (ret) {
+		sdesc->async_callback = NULL;
+		no_os_gpio_set_value(sdesc->chip_select, NO_OS_GPIO_HIGH);
+	}
+
+	return ret;
+#else
+	return -ENOSYS;
+#endif
 }
 
 /**
@@ -306,5 +666,7 @@ int32_t stm32_spi_write_and_read(struct no_os_spi_desc *desc,
 const struct no_os_spi_platform_ops stm32_spi_ops = {
 	.init = &stm32_spi_init,
 	.write_and_read = &stm32_spi_write_and_read,
+	.transfer = &stm32_spi_transfer,
+	.transfer_async = &stm32_spi_transfer_async,
 	.remove = &stm32_spi_remove
 };
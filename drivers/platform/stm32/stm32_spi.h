@@ -40,6 +40,7 @@
 #define STM32_SPI_H_
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "no_os_spi.h"
 #include "stm32_hal.h"
 
@@ -53,6 +54,15 @@ struct stm32_spi_init_param {
 	GPIO_TypeDef *chip_select_port;
 	/** Get perihperal source clock function */
 	uint32_t (*get_input_clock)(void);
+	/**
+	 * DMA handles initialized by the project for this SPI. Optional, the
+	 * transfers use DMA when both are set. The project must call
+	 * HAL_DMA_IRQHandler() from their stream interrupts and
+	 * HAL_SPI_IRQHandler() from the SPI interrupt. With data cache, rx
+	 * buffers should be aligned and sized to whole cache lines.
+	 */
+	DMA_HandleTypeDef *hdma_tx;
+	DMA_HandleTypeDef *hdma_rx;
 };
 
 /**
@@ -66,6 +76,21 @@ struct stm32_spi_desc {
 	uint32_t input_clock;
 	/** Chip select gpio descriptor */
 	struct no_os_gpio_desc *chip_select;
+	/**
+	 * Set when the transfers are done using DMA. With data cache,
+	 * stm32_dma.c must be built for the cache maintenance.
+	 */
+	bool dma;
+	/** Messages of the ongoing asynchronous transfer */
+	struct no_os_spi_msg *async_msgs;
+	/** Number of messages of the ongoing asynchronous transfer */
+	uint32_t async_len;
+	/** Index of the message being sent */
+	uint32_t async_idx;
+	/** Called when the asynchronous transfer is done. NULL when idle */
+	no_os_spi_callback async_callback;
+	/** Parameter of async_callback */
+	void *async_ctx;
 };
 
 /**
@@ -73,4 +98,11 @@ struct stm32_spi_desc {
  */
 extern const struct no_os_spi_platform_ops stm32_spi_ops;
 
+/*
+ * Asynchronous transfers use the HAL DMA API, or the interrupt one when DMA is
+ * not enabled, and need USE_HAL_SPI_REGISTER_CALLBACKS. The SPIx_IRQHandler
+ * of the project must call HAL_SPI_IRQHandler() with the hspi handle of the
+ * descriptor.
+ */
+
 #endif // STM32_SPI_H_
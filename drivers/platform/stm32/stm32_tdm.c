@@ -37,7 +37,9 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *******************************************************************************/
 #include <stdlib.h>
+#include <stddef.h>
 #include <errno.h>
+#include "no_os_alloc.h"
 #include "no_os_gpio.h"
 #include "stm32_gpio.h"
 #include "no_os_tdm.h"
@@ -50,7 +52,9 @@
 const struct no_os_tdm_platform_ops stm32_tdm_platform_ops = {
 	.tdm_ops_init = &stm32_tdm_init,
 	.tdm_ops_read = &stm32_tdm_read,
-	.tdm_ops_remove = &stm32_tdm_remove
+	.tdm_ops_remove = &stm32_tdm_remove,
+	.tdm_ops_read_start = &stm32_tdm_read_start,
+	.tdm_ops_stop = &stm32_tdm_stop
 };
 
 /**
@@ -130,6 +134,12 @@ int32_t stm32_tdm_init(struct no_os_tdm_desc **desc,
 		break;
 	};
 	tdesc->hsai.Init.DataSize = tmp;
+	if (param->data_size <= 8)
+		tdesc->sample_bytes = 1;
+	else if (param->data_size <= 16)
+		tdesc->sample_bytes = 2;
+	else
+		tdesc->sample_bytes = 4;
 	tdesc->hsai.Init.FirstBit = param->data_lsb_first ? SAI_FIRSTBIT_LSB :
 				    SAI_FIRSTBIT_MSB;
 	tdesc->hsai.Init.ClockStrobing = param->rising_edge_sampling ?
@@ -158,6 +168,9 @@ int32_t stm32_tdm_init(struct no_os_tdm_desc **desc,
 		goto error;
 	}
 
+	if (tinit->hdma_rx)
+		__HAL_LINKDMA(&tdesc->hsai, hdmarx, *tinit->hdma_rx);
+
 	*desc = tdm_desc;
 
 	return 0;
@@ -180,6 +193,7 @@ int32_t stm32_tdm_remove(struct no_os_tdm_desc *desc)
 		return -EINVAL;
 
 	tdesc = desc->extra;
+	stm32_tdm_stop(desc);
 	HAL_SAI_DeInit(&tdesc->hsai);
 	free(desc->extra);
 	free(desc);
@@ -219,3 +233,160 @@ int32_t stm32_tdm_read(struct no_os_tdm_desc *desc,
 
 	return ret;
 }
+
+#if (USE_HAL_SAI_REGISTER_CALLBACKS == 1)
+/**
+ * @brief Get the stm32 TDM descriptor of a HAL SAI handle.
+ * @param hsai - The HAL SAI handle, member of a stm32_tdm_desc.
+ * @return The stm32 TDM descriptor.
+ */
+static struct stm32_tdm_desc *stm32_tdm_from_hsai(SAI_HandleTypeDef *hsai)
+{
+	return (struct stm32_tdm_desc *)((uint8_t *)hsai -
+					 offsetof(struct stm32_tdm_desc, hsai));
+}
+
+/**
+ * @brief Pass a filled half of the circular buffer to the callback.
+ * @param tdesc - The stm32 TDM descriptor.
+ * @param half - 0 for the first half, 1 for the second one.
+ */
+static void stm32_tdm_circ_half(struct stm32_tdm_desc *tdesc, uint32_t half)
+{
+	uint32_t nb_samples = tdesc->circ_samples / 2;
+	uint8_t *data = tdesc->circ_buff + half * nb_samples *
+			tdesc->sample_bytes;
+
+	no_os_dma_sync_for_cpu(data, nb_samples * tdesc->sample_bytes,
+			       NO_OS_DMA_FROM_DEVICE);
+	tdesc->circ_callback(tdesc->circ_ctx, data, nb_samples);
+}
+
+/**
+ * @brief HAL callback of the first half of the circular buffer being filled.
+ * @param hsai - The HAL SAI handle.
+ */
+static void stm32_tdm_rx_half(SAI_HandleTypeDef *hsai)
+{
+	stm32_tdm_circ_half(stm32_tdm_from_hsai(hsai), 0);
+}
+
+/**
+ * @brief HAL callback of the second half of the circular buffer being filled,
+ * the DMA continuing with the first one.
+ * @param hsai - The HAL SAI handle.
+ */
+static void stm32_tdm_rx_cplt(SAI_HandleTypeDef *hsai)
+{
+	stm32_tdm_circ_half(stm32_tdm_from_hsai(hsai), 1);
+}
+
+/**
+ * @brief HAL error callback of the circular read, e.g. a SAI FIFO overrun.
+ * @param hsai - The HAL SAI handle.
+ */
+static void stm32_tdm_rx_error(SAI_HandleTypeDef *hsai)
+{
+	stm32_tdm_from_hsai(hsai)->circ_errors++;
+}
+#endif
+
+/**
+ * @brief Read continuously in a circular buffer using the DMA, restarted by
+ * the hardware at the end of the buffer so that no frame is lost.
+ * @param desc - The TDM descriptor.
+ * @param data - The circular buffer.
+ * @param nb_samples - Number of samples of the buffer, even, up to 65535.
+ * @param callback - Called from interrupt context with each filled half.
+ * @param ctx - Parameter of callback.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t stm32_tdm_read_start(struct no_os_tdm_desc *desc, void *data,
+			     uint32_t nb_samples, no_os_tdm_callback callback,
+			     void *ctx)
+{
+#if (USE_HAL_SAI_REGISTER_CALLBACKS == 1)
+	struct stm32_tdm_desc *tdesc;
+	int32_t ret;
+
+	if (!desc || !desc->extra || !data || !callback)
+		return -EINVAL;
+
+	if (!nb_samples || nb_samples % 2 || nb_samples > UINT16_MAX)
+		return -EINVAL;
+
+	tdesc = desc->extra;
+	if (!tdesc->hsai.hdmarx)
+		return -EINVAL;
+#ifdef DMA_CIRCULAR
+	if (tdesc->hsai.hdmarx->Init.Mode != DMA_CIRCULAR)
+		return -EINVAL;
+#endif
+	if (tdesc->circ_callback)
+		return -EBUSY;
+
+	ret = HAL_SAI_RegisterCallback(&tdesc->hsai,
+				       HAL_SAI_RX_HALFCOMPLETE_CB_ID,
+				       stm32_tdm_rx_half);
+	if (ret != HAL_OK)
+		return -EIO;
+	ret = HAL_SAI_RegisterCallback(&tdesc->hsai, HAL_SAI_RX_COMPLETE_CB_ID,
+				       stm32_tdm_rx_cplt);
+	if (ret != HAL_OK)
+		return -EIO;
+	ret = HAL_SAI_RegisterCallback(&tdesc->hsai, HAL_SAI_ERROR_CB_ID,
+				       stm32_tdm_rx_error);
+	if (ret != HAL_OK)
+		return -EIO;
+
+	tdesc->circ_buff = data;
+	tdesc->circ_samples = nb_samples;
+	tdesc->circ_ctx = ctx;
+	tdesc->circ_errors = 0;
+	tdesc->circ_callback = callback;
+
+	no_os_dma_sync_for_device(data, nb_samples * tdesc->sample_bytes,
+				  NO_OS_DMA_FROM_DEVICE);
+
+	ret = HAL_SAI_Receive_DMA(&tdesc->hsai, data, nb_samples);
+	if (ret != HAL_OK) {
+		tdesc->circ_callback = NULL;
+		return ret == HAL_BUSY ? -EBUSY : -EIO;
+	}
+
+	return 0;
+#else
+	return -ENOSYS;
+#endif
+}
+
+/**
+ * @brief Stop the read started by stm32_tdm_read_start().
+ * @param desc - The TDM descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t stm32_tdm_stop(struct no_os_tdm_desc *desc)
+{
+#if (USE_HAL_SAI_REGISTER_CALLBACKS == 1)
+	struct stm32_tdm_desc *tdesc;
+
+	if (!desc || !desc->extra)
+		return -EINVAL;
+
+	tdesc = desc->extra;
+	if (!tdesc->circ_callback)
+		return 0;
+
+	if (HAL_SAI_DMAStop(&tdesc->hsai) != HAL_OK)
+		return -EIO;
+
+	HAL_SAI_UnRegisterCallback(&tdesc->hsai, HAL_SAI_RX_HALFCOMPLETE_CB_ID);
+	HAL_SAI_UnRegisterCallback(&tdesc->hsai, HAL_SAI_RX_COMPLETE_CB_ID);
+	HAL_SAI_UnRegisterCallback(&tdesc->hsai, HAL_SAI_ERROR_CB_ID);
+	tdesc->circ_callback = NULL;
+
+	return 0;
+#else
+	return -ENOSYS;
+#endif
+}
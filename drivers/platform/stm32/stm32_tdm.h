@@ -51,6 +51,13 @@
 struct stm32_tdm_init_param {
 	/** Device ID */
 	SAI_Block_TypeDef *base;
+	/**
+	 * DMA handle initialized by the project in circular mode for this SAI
+	 * block. Optional, needed by no_os_tdm_read_start(). The project must
+	 * call HAL_DMA_IRQHandler() from the stream interrupt and
+	 * HAL_SAI_IRQHandler() from the SAI interrupt.
+	 */
+	DMA_HandleTypeDef *hdma_rx;
 };
 
 /**
@@ -60,6 +67,18 @@ struct stm32_tdm_init_param {
 struct stm32_tdm_desc {
 	/** TDM instance */
 	SAI_HandleTypeDef hsai;
+	/** Size of a sample in memory, in bytes */
+	uint8_t sample_bytes;
+	/** Buffer of the ongoing circular read */
+	uint8_t *circ_buff;
+	/** Number of samples of circ_buff */
+	uint32_t circ_samples;
+	/** Called for each filled half of circ_buff. NULL when idle */
+	no_os_tdm_callback circ_callback;
+	/** Parameter of circ_callback */
+	void *circ_ctx;
+	/** Number of errors reported by the HAL during the circular read */
+	uint32_t circ_errors;
 };
 
 /**
@@ -79,4 +98,18 @@ int32_t stm32_tdm_remove(struct no_os_tdm_desc *desc);
 int32_t stm32_tdm_read(struct no_os_tdm_desc *desc, void *data,
 		       uint16_t bytes_number);
 
+/* Read continuously in a circular buffer using DMA. */
+int32_t stm32_tdm_read_start(struct no_os_tdm_desc *desc, void *data,
+			     uint32_t nb_samples, no_os_tdm_callback callback,
+			     void *ctx);
+
+/* Stop the read started by stm32_tdm_read_start(). */
+int32_t stm32_tdm_stop(struct no_os_tdm_desc *desc);
+
+/*
+ * The circular read needs USE_HAL_SAI_REGISTER_CALLBACKS. With data cache,
+ * the buffer halves should be aligned and sized to whole cache lines, and
+ * stm32_dma.c must be built for the cache maintenance.
+ */
+
 #endif // STM32_TDM_H_
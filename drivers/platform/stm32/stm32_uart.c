@@ -40,20 +40,144 @@
 #include <stdlib.h>
 #include "no_os_uart.h"
 #include "no_os_irq.h"
-#include "no_os_lf256fifo.h"
+#include "no_os_lffifo.h"
 #include "stm32_irq.h"
 #include "stm32_uart.h"
 #include "stm32_hal.h"
 
 static uint8_t c;
 
+/* UARTs using the DMA reception, the HAL callbacks only get the handle */
+static struct no_os_uart_desc *stm32_uart_dma_descs[STM32_UART_DMA_MAX];
+
 void uart_rx_callback(void *context)
 {
 	struct no_os_uart_desc *d = context;
-	lf256fifo_write(d->rx_fifo, c);
+	no_os_lffifo_write(d->rx_fifo, &c, 1);
 	HAL_UART_Receive_IT(((struct stm32_uart_desc *)d->extra)->huart, &c, 1);
 }
 
+/**
+ * @brief Reception event of the DMA reception, on line idle and on half and
+ * full DMA buffer.
+ * @param huart - UART instance.
+ * @param pos - Offset in the DMA buffer after the last received byte.
+ */
+static void stm32_uart_rx_event(UART_HandleTypeDef *huart, uint16_t pos)
+{
+	struct stm32_uart_desc *sud;
+	uint32_t i;
+
+	for (i = 0; i < STM32_UART_DMA_MAX; i++) {
+		if (!stm32_uart_dma_descs[i])
+			continue;
+
+		sud = stm32_uart_dma_descs[i]->extra;
+		if (sud->huart == huart) {
+			no_os_uart_dma_rx_update(stm32_uart_dma_descs[i], pos);
+			return;
+		}
+	}
+}
+
+/**
+ * @brief Start the DMA reception, the DMA channel being in circular mode.
+ * @param desc - The UART descriptor.
+ * @return 0 in case of success, error code otherwise.
+ */
+static int32_t stm32_uart_dma_rx_start(struct no_os_uart_desc *desc)
+{
+	struct stm32_uart_desc *sud = desc->extra;
+
+	desc->rx_dma_pos = 0;
+	if (HAL_UARTEx_ReceiveToIdle_DMA(sud->huart, desc->rx_dma_buf,
+					 desc->rx_dma_size) != HAL_OK)
+		return -EIO;
+
+	return 0;
+}
+
+/**
+ * @brief Set up the DMA reception of an UART.
+ * @param desc - The UART descriptor.
+ * @param param - The structure that contains the UART parameters.
+ * @return 0 in case of success, error code otherwise.
+ */
+static int32_t stm32_uart_dma_rx_init(struct no_os_uart_desc *desc,
+				      struct no_os_uart_init_param *param)
+{
+	struct stm32_uart_desc *sud = desc->extra;
+	uint32_t i;
+	int32_t ret;
+
+	if (!sud->huart->hdmarx)
+		return -EINVAL;
+
+	for (i = 0; i < STM32_UART_DMA_MAX; i++)
+		if (!stm32_uart_dma_descs[i])
+			break;
+	if (i == STM32_UART_DMA_MAX)
+		return -ENOMEM;
+
+	ret = no_os_uart_dma_rx_init(desc, param);
+	if (ret)
+		return ret;
+
+	if (HAL_UART_RegisterRxEventCallback(sud->huart,
+					     stm32_uart_rx_event) != HAL_OK) {
+		ret = -EIO;
+		goto error;
+	}
+
+	stm32_uart_dma_descs[i] = desc;
+	ret = stm32_uart_dma_rx_start(desc);
+	if (ret) {
+		stm32_uart_dma_descs[i] = NULL;
+		HAL_UART_UnRegisterRxEventCallback(sud->huart);
+		goto error;
+	}
+
+	return 0;
+error:
+	no_os_uart_dma_rx_remove(desc);
+
+	return ret;
+}
+
+/**
+ * @brief Stop the DMA reception of an UART.
+ * @param desc - The UART descriptor.
+ */
+static void stm32_uart_dma_rx_remove(struct no_os_uart_desc *desc)
+{
+	struct stm32_uart_desc *sud = desc->extra;
+	uint32_t i;
+
+	HAL_UART_AbortReceive(sud->huart);
+	HAL_UART_UnRegisterRxEventCallback(sud->huart);
+	for (i = 0; i < STM32_UART_DMA_MAX; i++)
+		if (stm32_uart_dma_descs[i] == desc)
+			stm32_uart_dma_descs[i] = NULL;
+	no_os_uart_dma_rx_remove(desc);
+}
+
+/**
+ * @brief Wait for the end of a DMA transmission.
+ * @param sud - STM32 UART descriptor.
+ * @return 0 in case of success, -ETIMEDOUT otherwise.
+ */
+static int32_t stm32_uart_wait_tx(struct stm32_uart_desc *sud)
+{
+	uint32_t start = HAL_GetTick();
+
+	while (sud->huart->gState != HAL_UART_STATE_READY)
+		if (sud->timeout != HAL_MAX_DELAY &&
+		    HAL_GetTick() - start > sud->timeout)
+			return -ETIMEDOUT;
+
+	return 0;
+}
+
 /**
  * @brief Initialize the UART communication peripheral.
  * @param desc - The UART descriptor.
@@ -126,9 +250,32 @@ static int32_t stm32_uart_init(struct no_os_uart_desc **desc,
 
 	sud->timeout = suip->timeout ? suip->timeout : HAL_MAX_DELAY;
 
-	// nonblocking uart_read
-	if(param->asynchronous_rx) {
-		ret = lf256fifo_init(&descriptor->rx_fifo);
+	if (param->dma_rx) {
+		/* The UART interrupt signals the line idle events */
+		struct no_os_irq_init_param nvic_ip = {
+			.platform_ops = &stm32_irq_ops,
+			.extra = sud->huart,
+		};
+		ret = no_os_irq_ctrl_init(&sud->nvic, &nvic_ip);
+		if (ret < 0)
+			goto error;
+
+		ret = no_os_irq_enable(sud->nvic, descriptor->irq_id);
+		if (ret < 0) {
+			no_os_irq_ctrl_remove(sud->nvic);
+			goto error;
+		}
+
+		ret = stm32_uart_dma_rx_init(descriptor, param);
+		if (ret) {
+			no_os_irq_disable(sud->nvic, descriptor->irq_id);
+			no_os_irq_ctrl_remove(sud->nvic);
+			goto error;
+		}
+	} else if (param->asynchronous_rx) {
+		// nonblocking uart_read
+		ret = no_os_lffifo_init(&descriptor->rx_fifo, 1,
+					NO_OS_UART_RX_FIFO_SIZE);
 		if (ret < 0)
 			goto error;
 
@@ -191,10 +338,17 @@ static int32_t stm32_uart_remove(struct no_os_uart_desc *desc)
 		return -EINVAL;
 
 	sud = desc->extra;
+	if (desc->rx_cb) {
+		stm32_uart_dma_rx_remove(desc);
+		no_os_irq_disable(sud->nvic, desc->irq_id);
+		no_os_irq_ctrl_remove(sud->nvic);
+	}
+	if (sud->huart->hdmatx)
+		HAL_UART_AbortTransmit(sud->huart);
 	HAL_UART_DeInit(sud->huart);
 	if (desc->rx_fifo) {
 		no_os_irq_disable(sud->nvic, desc->irq_id);
-		lf256fifo_remove(desc->rx_fifo);
+		no_os_lffifo_remove(desc->rx_fifo);
 		desc->rx_fifo = NULL;
 		no_os_irq_unregister_callback(sud->nvic, desc->irq_id, &sud->rx_callback);
 		no_os_irq_ctrl_remove(sud->nvic);
@@ -226,6 +380,11 @@ static int32_t stm32_uart_write(struct no_os_uart_desc *desc,
 		return 0;
 
 	sud = desc->extra;
+	/* Keep the order of the data of a DMA transmission in progress */
+	ret = stm32_uart_wait_tx(sud);
+	if (ret)
+		return ret;
+
 	ret = HAL_UART_Transmit(sud->huart, (uint8_t *)data, bytes_number,
 				sud->timeout);
 
@@ -265,14 +424,20 @@ static int32_t stm32_uart_read(struct no_os_uart_desc *desc, uint8_t *data,
 
 	sud = desc->extra;
 
-	if (desc->rx_fifo) {
-		while(i < bytes_number) {
-			ret = lf256fifo_read(desc->rx_fifo, &data[i]);
-			if (ret < 0)
-				return i ? i : -EAGAIN;
-			i++;
+	if (desc->rx_cb) {
+		/* An UART error stops the reception, restart it */
+		if (sud->huart->RxState == HAL_UART_STATE_READY) {
+			ret = stm32_uart_dma_rx_start(desc);
+			if (ret)
+				return ret;
 		}
-		return i;
+
+		return no_os_uart_dma_rx_read(desc, data, bytes_number);
+	}
+
+	if (desc->rx_fifo) {
+		i = no_os_lffifo_read(desc->rx_fifo, data, bytes_number);
+		return i ? (int32_t)i : -EAGAIN;
 	} else {
 		ret = HAL_UART_Receive(sud->huart, (uint8_t *)data, bytes_number,
 				       sud->timeout);
@@ -292,6 +457,64 @@ static int32_t stm32_uart_read(struct no_os_uart_desc *desc, uint8_t *data,
 	return bytes_number;
 }
 
+/**
+ * @brief Write data to UART device by DMA. Non blocking function, data must
+ * not change until the transmission is done. A following write waits for it.
+ * @param desc - Instance of UART.
+ * @param data - Pointer to buffer containing data.
+ * @param bytes_number - Number of bytes to write.
+ * @return number of bytes queued in case of success, negative error code
+ * otherwise.
+ */
+static int32_t stm32_uart_write_nonblocking(struct no_os_uart_desc *desc,
+		const uint8_t *data,
+		uint32_t bytes_number)
+{
+	struct stm32_uart_desc *sud;
+	int32_t ret;
+
+	if (!desc || !desc->extra || !data)
+		return -EINVAL;
+
+	if (!bytes_number)
+		return 0;
+
+	sud = desc->extra;
+	if (!sud->huart->hdmatx)
+		return -ENOSYS;
+
+	ret = HAL_UART_Transmit_DMA(sud->huart, (uint8_t *)data, bytes_number);
+	switch (ret) {
+	case HAL_OK:
+		break;
+	case HAL_BUSY:
+		return -EBUSY;
+	default:
+		return -EIO;
+	};
+
+	return bytes_number;
+}
+
+/**
+ * @brief Get the number of received bytes dropped by the DMA reception, the
+ * software buffer being full.
+ * @param desc - Instance of UART.
+ * @return number of dropped bytes since the last call.
+ */
+static uint32_t stm32_uart_get_errors(struct no_os_uart_desc *desc)
+{
+	uint32_t dropped;
+
+	if (!desc)
+		return -EINVAL;
+
+	dropped = desc->rx_dropped;
+	desc->rx_dropped -= dropped;
+
+	return dropped;
+}
+
 /**
  * @brief STM32 platform specific UART platform ops structure
  */
@@ -299,5 +522,7 @@ const struct no_os_uart_platform_ops stm32_uart_ops = {
 	.init = &stm32_uart_init,
 	.read = &stm32_uart_read,
 	.write = &stm32_uart_write,
+	.write_nonblocking = &stm32_uart_write_nonblocking,
+	.get_errors = &stm32_uart_get_errors,
 	.remove = &stm32_uart_remove
 };
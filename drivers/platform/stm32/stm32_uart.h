@@ -71,6 +71,9 @@ struct stm32_uart_desc {
 	struct no_os_callback_desc rx_callback;
 };
 
+/* UARTs that can use the DMA reception at the same time */
+#define STM32_UART_DMA_MAX	8
+
 /**
  * @brief STM32 specific UART platform ops structure
  */
@@ -0,0 +1,98 @@
+/***************************************************************************//**
+*   @file   xilinx_amp.c
+*   @brief  Zynq-7000 asymmetric multiprocessing support.
+********************************************************************************
+* Copyright 2023(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <xparameters.h>
+#ifdef PLATFORM_ZYNQ
+#include <xil_io.h>
+#include <xil_mmu.h>
+#include <xpseudo_asm.h>
+#endif
+#include "xilinx_amp.h"
+#include "no_os_error.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Map the memory used by the two cores to communicate, for example a
+ * struct no_os_amp_link placed at XIL_AMP_OCM_BASE, as shareable and not
+ * cacheable. Both cores must call it before using the memory.
+ * @param addr - Address in the 1 MB section to be mapped.
+ * @return 0 in case of success, -ENOSYS if the CPU is not a Zynq-7000 A9.
+ */
+int32_t xil_amp_shared_init(uintptr_t addr)
+{
+#ifdef PLATFORM_ZYNQ
+	Xil_SetTlbAttributes(addr, XIL_AMP_SHARED_ATTR);
+	dsb();
+
+	return 0;
+#else
+	return -ENOSYS;
+#endif
+}
+
+/**
+ * @brief Start CPU1 from CPU0. The CPU1 application is built separately, with
+ * TARGET_CPU=1 and the USE_AMP BSP option, and loaded at entry before this is
+ * called. The interrupts used by CPU1 must be left untouched by the GIC setup
+ * of CPU0, and the reverse.
+ * @param entry - Entry point of the CPU1 application.
+ * @return 0 in case of success, -ENOSYS if the CPU is not a Zynq-7000 A9.
+ */
+int32_t xil_amp_cpu1_start(uintptr_t entry)
+{
+#ifdef PLATFORM_ZYNQ
+	if (!entry)
+		return -EINVAL;
+
+	Xil_Out32(XIL_AMP_CPU1_START_ADDR, entry);
+	dmb();
+	/* Wake up CPU1, which reads its entry point and jumps to it */
+	sev();
+
+	return 0;
+#else
+	return -ENOSYS;
+#endif
+}
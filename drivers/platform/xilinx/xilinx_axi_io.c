@@ -41,39 +41,64 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 
-#include <xil_io.h>
+#include <string.h>
+#include <xil_cache.h>
 #include "no_os_error.h"
 #include "no_os_axi_io.h"
+#include "no_os_alloc.h"
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
 
 /**
- * @brief AXI IO Xilinx specific read function.
+ * @brief AXI IO Xilinx specific buffer write function. The words are copied
+ * with the CPU and the cache lines are flushed once for the whole range.
  * @param base - Base address
  * @param offset - Address offset
- * @param data - variable where returned data is stored
+ * @param data - Words to be written.
+ * @param nb_words - Number of words.
  * @return 0 in case of success, -1 otherwise.
  */
-int32_t no_os_axi_io_read(uint32_t base, uint32_t offset, uint32_t *data)
+int32_t no_os_axi_io_write_buf(uint32_t base, uint32_t offset,
+			       const uint32_t *data, uint32_t nb_words)
 {
-	*data = Xil_In32(base + offset);
+	uintptr_t addr = (uintptr_t)base + offset;
+
+	memcpy((void *)addr, data, nb_words * sizeof(*data));
+	Xil_DCacheFlushRange(addr, nb_words * sizeof(*data));
 
 	return 0;
 }
 
 /**
- * @brief AXI IO Xilinx specific write function.
- * @param base - Base address
- * @param offset - Address offset
- * @param data - data to be written.
- * @return 0 in case of success, -1 otherwise.
+ * @brief Xilinx data cache clean, used by no_os_dma_sync_for_device. Lives
+ * here as every project doing DMA on the AXI cores builds this file.
+ * @param addr - Start of the range.
+ * @param size - Number of bytes.
  */
-int32_t no_os_axi_io_write(uint32_t base, uint32_t offset, uint32_t data)
+void no_os_dcache_clean_range(uintptr_t addr, size_t size)
 {
-	Xil_Out32(base + offset, data);
+	Xil_DCacheFlushRange(addr, size);
+}
 
-	return 0;
+/**
+ * @brief Xilinx data cache invalidate, used by the no_os_dma_sync functions.
+ * @param addr - Start of the range.
+ * @param size - Number of bytes.
+ */
+void no_os_dcache_invalidate_range(uintptr_t addr, size_t size)
+{
+	Xil_DCacheInvalidateRange(addr, size);
 }
 
+/**
+ * @brief Xilinx data cache flush, used by no_os_dma_sync_for_device for the
+ * buffers written by the DMA.
+ * @param addr - Start of the range.
+ * @param size - Number of bytes.
+ */
+void no_os_dcache_flush_range(uintptr_t addr, size_t size)
+{
+	Xil_DCacheFlushRange(addr, size);
+}
@@ -46,6 +46,7 @@
 #ifdef _XPARAMETERS_PS_H_
 #include "no_os_util.h"
 #include "xtime_l.h"
+#include "no_os_trace.h"
 #endif
 
 /******************************************************************************/
@@ -80,6 +81,22 @@ void no_os_mdelay(uint32_t msecs)
 #endif
 }
 
+#if (defined(NO_OS_TRACE) || defined(NO_OS_IRQ_POLICY)) && \
+	defined(_XPARAMETERS_PS_H_)
+/**
+ * @brief Get the timestamp of the trace events.
+ * @return Low 32 bits of the global timer.
+ */
+uint32_t no_os_trace_timestamp(void)
+{
+	XTime t;
+
+	XTime_GetTime(&t);
+
+	return (uint32_t)t;
+}
+#endif
+
 /**
  * @brief Get current time.
  * @return Current time structure from system start (seconds, microseconds).
@@ -98,3 +115,22 @@ struct no_os_time no_os_get_time(void)
 
 	return t;
 }
+
+/**
+ * @brief Get the monotonic time in nanoseconds, from the 64-bit global timer.
+ * @return Nanoseconds from system start, 0 if there is no global timer.
+ */
+uint64_t no_os_time_ns(void)
+{
+	uint64_t ns = 0;
+#ifdef _XPARAMETERS_PS_H_
+	XTime t;
+	uint32_t rem;
+
+	XTime_GetTime(&t);
+	ns = no_os_div_u64_rem(t, COUNTS_PER_SECOND, &rem) * 1000000000ULL;
+	ns += no_os_div_u64((uint64_t)rem * 1000000000ULL, COUNTS_PER_SECOND);
+#endif
+
+	return ns;
+}
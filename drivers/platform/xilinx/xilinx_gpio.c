@@ -449,6 +449,138 @@ int32_t xil_gpio_get_value(struct no_os_gpio_desc *desc,
 	return 0;
 }
 
+/**
+ * @brief Set the values of several GPIOs of the same channel (PL) or bank (PS)
+ * with a single register write. On PS, the pins must also be in the same half
+ * of the bank, which is written through its mask data register.
+ * @param desc - The GPIO descriptor of the first pin of the group.
+ * @param mask - Pins to be set, bit n being the pin desc->number + n.
+ * @param values - The values, in the same order as mask.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t xil_gpio_set_multiple(struct no_os_gpio_desc *desc, uint32_t mask,
+			      uint32_t values)
+{
+	struct xil_gpio_desc	*extra;
+	uint8_t pin;
+#ifdef XGPIO_H
+	uint8_t channel;
+	uint32_t reg_val;
+#endif
+#ifdef XGPIOPS_H
+	XGpioPs *ps;
+	uint8_t bank;
+	uint32_t offset;
+#endif
+
+	if (!desc)
+		return -EINVAL;
+
+	extra = desc->extra;
+	pin = desc->number;
+
+	switch (extra->type) {
+	case GPIO_PL:
+#ifdef XGPIO_H
+		if (pin >= 32) {
+			channel = 2;
+			pin -= 32;
+		} else
+			channel = 1;
+
+		if (((mask << pin) >> pin) != mask)
+			return -EINVAL;
+
+		reg_val = XGpio_DiscreteRead(extra->instance, channel);
+		reg_val &= ~(mask << pin);
+		reg_val |= (values & mask) << pin;
+		XGpio_DiscreteWrite(extra->instance, channel, reg_val);
+#endif
+		break;
+	case GPIO_PS:
+#ifdef XGPIOPS_H
+		ps = extra->instance;
+		XGpioPs_GetBankPin(desc->number, &bank, &pin);
+		offset = bank * XGPIOPS_DATA_MASK_OFFSET;
+		if (pin >= 16) {
+			offset += XGPIOPS_DATA_MSW_OFFSET;
+			pin -= 16;
+		}
+
+		if (mask >> (16 - pin))
+			return -EINVAL;
+
+		/* The upper half selects the pins left unchanged */
+		XGpioPs_WriteReg(ps->GpioConfig.BaseAddr, offset,
+				 (~(mask << pin) << 16) |
+				 ((values & mask) << pin));
+#endif
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Get the values of several GPIOs of the same channel (PL) or bank (PS)
+ * with a single register read.
+ * @param desc - The GPIO descriptor of the first pin of the group.
+ * @param mask - Pins to be read, bit n being the pin desc->number + n.
+ * @param values - The values, in the same order as mask.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t xil_gpio_get_multiple(struct no_os_gpio_desc *desc, uint32_t mask,
+			      uint32_t *values)
+{
+	struct xil_gpio_desc	*extra;
+	uint8_t pin;
+#ifdef XGPIO_H
+	uint8_t channel;
+#endif
+#ifdef XGPIOPS_H
+	uint8_t bank;
+#endif
+
+	if (!desc || !values)
+		return -EINVAL;
+
+	extra = desc->extra;
+	pin = desc->number;
+
+	switch (extra->type) {
+	case GPIO_PL:
+#ifdef XGPIO_H
+		if (pin >= 32) {
+			channel = 2;
+			pin -= 32;
+		} else
+			channel = 1;
+
+		if (((mask << pin) >> pin) != mask)
+			return -EINVAL;
+
+		*values = XGpio_DiscreteRead(extra->instance, channel);
+		*values = (*values >> pin) & mask;
+#endif
+		break;
+	case GPIO_PS:
+#ifdef XGPIOPS_H
+		XGpioPs_GetBankPin(desc->number, &bank, &pin);
+		if (((mask << pin) >> pin) != mask)
+			return -EINVAL;
+
+		*values = (XGpioPs_Read(extra->instance, bank) >> pin) & mask;
+#endif
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
 /**
  * @brief Xilinx platform specific GPIO platform ops structure
  */
@@ -461,4 +593,6 @@ const struct no_os_gpio_platform_ops xil_gpio_ops = {
 	.gpio_ops_get_direction = &xil_gpio_get_direction,
 	.gpio_ops_set_value = &xil_gpio_set_value,
 	.gpio_ops_get_value = &xil_gpio_get_value,
+	.gpio_ops_set_multiple = &xil_gpio_set_multiple,
+	.gpio_ops_get_multiple = &xil_gpio_get_multiple,
 };
@@ -42,6 +42,7 @@
 /******************************************************************************/
 
 #include <stdlib.h>
+#include <stdbool.h>
 
 #include <xparameters.h>
 #ifdef XPAR_XIIC_NUM_INSTANCES
@@ -93,6 +94,7 @@ const struct no_os_i2c_platform_ops xil_i2c_ops = {
 	.i2c_ops_init = &xil_i2c_init,
 	.i2c_ops_write = &xil_i2c_write,
 	.i2c_ops_read = &xil_i2c_read,
+	.i2c_ops_transfer = &xil_i2c_transfer,
 	.i2c_ops_remove = &xil_i2c_remove
 };
 
@@ -512,3 +514,114 @@ error:
 
 	return 0;
 }
+
+#ifdef XIIC_H
+/**
+ * @brief Send one message of a transfer on the PL I2C.
+ * @param desc - The I2C descriptor.
+ * @param msg - The message.
+ * @param last - Set for the last message of the transfer.
+ * @return 0 in case of success, -1 otherwise.
+ */
+static int32_t xil_i2c_pl_msg(struct no_os_i2c_desc *desc,
+			      struct no_os_i2c_msg *msg, bool last)
+{
+	struct xil_i2c_desc	*xdesc = desc->extra;
+	UINTPTR			base;
+	uint8_t			option;
+	unsigned		ret;
+
+	base = ((XIic*)xdesc->instance)->BaseAddress;
+	option = last ? XIIC_STOP : XIIC_REPEATED_START;
+
+	if (msg->read)
+		ret = XIic_Recv(base, desc->slave_address, msg->data,
+				msg->bytes_number, option);
+	else
+		ret = XIic_Send(base, desc->slave_address, msg->data,
+				msg->bytes_number, option);
+
+	return (ret == msg->bytes_number) ? 0 : -1;
+}
+#endif
+
+#ifdef XIICPS_H
+/**
+ * @brief Send one message of a transfer on the PS I2C.
+ * @param desc - The I2C descriptor.
+ * @param msg - The message.
+ * @param last - Set for the last message of the transfer.
+ * @return 0 in case of success, -1 otherwise.
+ */
+static int32_t xil_i2c_ps_msg(struct no_os_i2c_desc *desc,
+			      struct no_os_i2c_msg *msg, bool last)
+{
+	struct xil_i2c_desc	*xdesc = desc->extra;
+	int32_t			ret;
+
+	/* Only the last message ends with a stop condition */
+	if (last)
+		ret = XIicPs_ClearOptions(xdesc->instance,
+					  XIICPS_REP_START_OPTION);
+	else
+		ret = XIicPs_SetOptions(xdesc->instance,
+					XIICPS_REP_START_OPTION);
+	if (ret != 0)
+		return -1;
+
+	if (msg->read)
+		ret = XIicPs_MasterRecvPolled(xdesc->instance, msg->data,
+					      msg->bytes_number,
+					      desc->slave_address);
+	else
+		ret = XIicPs_MasterSendPolled(xdesc->instance, msg->data,
+					      msg->bytes_number,
+					      desc->slave_address);
+
+	return (ret == 0) ? 0 : -1;
+}
+#endif
+
+/**
+ * @brief Send multiple messages to/from a slave device, separated by repeated
+ * starts. The bus configuration is done once for the whole transfer.
+ * @param desc - The I2C descriptor.
+ * @param msgs - Array of messages.
+ * @param len - Number of messages in the array.
+ * @return 0 in case of success, -1 otherwise.
+ */
+int32_t xil_i2c_transfer(struct no_os_i2c_desc *desc,
+			 struct no_os_i2c_msg *msgs,
+			 uint32_t len)
+{
+	struct xil_i2c_desc	*xdesc;
+	int32_t			ret;
+	uint32_t		i;
+
+	xdesc = desc->extra;
+
+	ret = xil_i2c_set_transmission_config(desc);
+	if (ret != 0)
+		return -1;
+
+	for (i = 0; i < len; i++) {
+		switch (xdesc->type) {
+#ifdef XIIC_H
+		case IIC_PL:
+			ret = xil_i2c_pl_msg(desc, &msgs[i], i == len - 1);
+			break;
+#endif
+#ifdef XIICPS_H
+		case IIC_PS:
+			ret = xil_i2c_ps_msg(desc, &msgs[i], i == len - 1);
+			break;
+#endif
+		default:
+			return -1;
+		}
+		if (ret != 0)
+			return -1;
+	}
+
+	return 0;
+}
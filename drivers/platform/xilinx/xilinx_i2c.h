@@ -112,4 +112,8 @@ int32_t xil_i2c_write(struct no_os_i2c_desc *desc, uint8_t *data,
 int32_t xil_i2c_read(struct no_os_i2c_desc *desc, uint8_t *data,
 		     uint8_t bytes_number, uint8_t stop_bit);
 
+/* I2C combined transfer. */
+int32_t xil_i2c_transfer(struct no_os_i2c_desc *desc,
+			 struct no_os_i2c_msg *msgs, uint32_t len);
+
 #endif // XILINX_I2C_H_
@@ -42,6 +42,8 @@
 /******************************************************************************/
 
 #include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
 
 #include <xparameters.h>
 #ifdef XPAR_XSPI_NUM_INSTANCES
@@ -52,6 +54,8 @@
 #endif
 
 #include "no_os_error.h"
+#include "no_os_delay.h"
+#include "no_os_util.h"
 #include "no_os_spi.h"
 #include "xilinx_spi.h"
 
@@ -65,12 +69,334 @@
 #define SPI_NUM_INSTANCES	0
 #endif
 
-#warning SPI delays are not supported on the xilinx platform
-
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
 
+#ifdef XSPIPS_H
+/**
+ * @brief Set the options of the PS SPI for a transfer. The slave select is
+ * driven manually.
+ *
+ * @param desc The SPI descriptor
+ * @return int32_t -1 if the options couldn't be set
+ */
+static int32_t spi_ps_setup(struct no_os_spi_desc *desc)
+{
+	struct xil_spi_desc	*xdesc = desc->extra;
+	int32_t			ret;
+
+	ret = XSpiPs_SetOptions(xdesc->instance,
+				XSPIPS_MASTER_OPTION |
+				((xdesc->flags & SPI_CS_DECODE) ?
+				 XSPIPS_DECODE_SSELECT_OPTION : 0) |
+				XSPIPS_FORCE_SSELECT_OPTION |
+				((desc->mode & NO_OS_SPI_CPOL) ?
+				 XSPIPS_CLK_ACTIVE_LOW_OPTION : 0) |
+				((desc->mode & NO_OS_SPI_CPHA) ?
+				 XSPIPS_CLK_PHASE_1_OPTION : 0));
+	if (ret != 0)
+		return -1;
+
+	return 0;
+}
+
+/**
+ * @brief Write and read data by polling the PS SPI FIFOs
+ *
+ * Unlike XSpiPs_PolledTransfer(), the slave select is left unchanged, so
+ * that consecutive messages can share it.
+ *
+ * @param xdesc Platform specific SPI descriptor
+ * @param tx Data to send. If NULL, 0x00 is sent
+ * @param rx Where to store the received data. If NULL, it is discarded
+ * @param len Number of bytes
+ */
+static void spi_ps_poll(struct xil_spi_desc *xdesc, const uint8_t *tx,
+			uint8_t *rx, uint32_t len)
+{
+	XSpiPs		*inst = xdesc->instance;
+	uint32_t	base = inst->Config.BaseAddress;
+	uint32_t	sent = 0;
+	uint32_t	recv = 0;
+	uint8_t		byte;
+
+	XSpiPs_Enable(inst);
+
+	/* Discard stale data */
+	while (XSpiPs_ReadReg(base, XSPIPS_SR_OFFSET) &
+	       XSPIPS_IXR_RXNEMPTY_MASK)
+		XSpiPs_ReadReg(base, XSPIPS_RXD_OFFSET);
+
+	while (recv < len) {
+		/* Keep the TX FIFO filled, without overflowing the RX one */
+		while (sent < len && sent - recv < XSPIPS_FIFO_DEPTH) {
+			XSpiPs_WriteReg(base, XSPIPS_TXD_OFFSET,
+					tx ? tx[sent] : 0);
+			sent++;
+		}
+
+		while (!(XSpiPs_ReadReg(base, XSPIPS_SR_OFFSET) &
+			 XSPIPS_IXR_RXNEMPTY_MASK))
+			;
+		byte = XSpiPs_ReadReg(base, XSPIPS_RXD_OFFSET);
+		if (rx)
+			rx[recv] = byte;
+		recv++;
+	}
+
+	XSpiPs_Disable(inst);
+}
+
+/**
+ * @brief End the ongoing asynchronous transfer
+ *
+ * @param xdesc Platform specific SPI descriptor
+ * @param ret Result passed to the callback
+ */
+static void spi_ps_async_end(struct xil_spi_desc *xdesc, int32_t ret)
+{
+	no_os_spi_callback callback = xdesc->async_callback;
+
+	XSpiPs_SetSlaveSelect(xdesc->instance, SPI_DEASSERT_CURRENT_SS);
+
+	/* Cleared first, so that the callback can start a new transfer */
+	xdesc->async_callback = NULL;
+	callback(xdesc->async_ctx, ret);
+}
+
+/**
+ * @brief Start the interrupt driven transfer of the current message
+ *
+ * The driver deasserts the slave select at the end of each transfer, so every
+ * message is sent in its own CS frame. Messages without data are skipped.
+ *
+ * @param xdesc Platform specific SPI descriptor
+ * @return int32_t -1 if the transfer couldn't be started
+ */
+static int32_t spi_ps_async_start(struct xil_spi_desc *xdesc)
+{
+	struct no_os_spi_msg	*msg = NULL;
+	uint8_t			*tx;
+	int32_t			ret;
+
+	for (; xdesc->async_idx < xdesc->async_len; xdesc->async_idx++) {
+		msg = &xdesc->async_msgs[xdesc->async_idx];
+		if (msg->bytes_number && (msg->tx_buff || msg->rx_buff))
+			break;
+	}
+
+	if (xdesc->async_idx == xdesc->async_len) {
+		spi_ps_async_end(xdesc, 0);
+		return 0;
+	}
+
+	/* 0x00 is sent when there is no tx buffer */
+	tx = msg->tx_buff;
+	if (!tx) {
+		memset(msg->rx_buff, 0, msg->bytes_number);
+		tx = msg->rx_buff;
+	}
+
+	ret = XSpiPs_SetSlaveSelect(xdesc->instance, xdesc->chip_select);
+	if (ret != 0)
+		return -1;
+
+	ret = XSpiPs_Transfer(xdesc->instance, tx, msg->rx_buff,
+			      msg->bytes_number);
+	if (ret != 0)
+		return -1;
+
+	return 0;
+}
+
+/**
+ * @brief PS SPI status handler, called from the SPI interrupt
+ *
+ * @param ref Platform specific SPI descriptor
+ * @param event XST_SPI_TRANSFER_DONE or an error event
+ * @param bytes Number of bytes transferred
+ */
+static void spi_ps_async_handler(const void *ref, u32 event, u32 bytes)
+{
+	struct xil_spi_desc	*xdesc = (struct xil_spi_desc *)ref;
+	int32_t			ret;
+
+	if (!xdesc->async_callback)
+		return;
+
+	if (event != XST_SPI_TRANSFER_DONE) {
+		spi_ps_async_end(xdesc, -EIO);
+		return;
+	}
+
+	xdesc->async_idx++;
+	ret = spi_ps_async_start(xdesc);
+	if (ret)
+		spi_ps_async_end(xdesc, -EIO);
+}
+
+/**
+ * @brief Connect the PS SPI interrupt, if an interrupt controller is given
+ *
+ * @param xdesc Platform specific SPI descriptor
+ * @return int32_t negative error code if the interrupt couldn't be set
+ */
+static int32_t spi_ps_irq_init(struct xil_spi_desc *xdesc)
+{
+	struct no_os_callback_desc	callback_desc = { 0 };
+	int32_t				ret;
+
+	if (!xdesc->irq_desc)
+		return 0;
+
+	callback_desc.callback = (void (*)())XSpiPs_InterruptHandler;
+	callback_desc.ctx = xdesc->instance;
+	ret = no_os_irq_register_callback(xdesc->irq_desc, xdesc->irq_id,
+					  &callback_desc);
+	if (ret < 0)
+		return ret;
+
+	XSpiPs_SetStatusHandler(xdesc->instance, xdesc, spi_ps_async_handler);
+
+	return no_os_irq_enable(xdesc->irq_desc, xdesc->irq_id);
+}
+#endif // XSPIPS_H
+
+#ifdef XSPI_H
+/**
+ * @brief Set the options of the PL SPI for a transfer. The slave select is
+ * driven manually.
+ *
+ * @param desc The SPI descriptor
+ * @return int32_t -1 if the options couldn't be set
+ */
+static int32_t spi_pl_setup(struct no_os_spi_desc *desc)
+{
+	struct xil_spi_desc	*xdesc = desc->extra;
+	uint32_t		ctrl_reg;
+	int32_t			ret;
+
+	ret = XSpi_SetOptions(xdesc->instance,
+			      XSP_MASTER_OPTION |
+			      XSP_MANUAL_SSELECT_OPTION |
+			      ((desc->mode & NO_OS_SPI_CPOL) ?
+			       XSP_CLK_ACTIVE_LOW_OPTION : 0) |
+			      ((desc->mode & NO_OS_SPI_CPHA) ?
+			       XSP_CLK_PHASE_1_OPTION : 0));
+	if (ret != 0)
+		return -1;
+
+	ctrl_reg = XSpi_GetControlReg(((XSpi*)xdesc->instance));
+	if (desc->bit_order == NO_OS_SPI_BIT_ORDER_LSB_FIRST)
+		ctrl_reg |= XSP_CR_LSB_MSB_FIRST_MASK;
+	else
+		ctrl_reg &= ~ XSP_CR_LSB_MSB_FIRST_MASK;
+	XSpi_SetControlReg(((XSpi*)xdesc->instance), ctrl_reg);
+
+	return 0;
+}
+
+/**
+ * @brief Write and read data by polling the PL SPI registers, one byte at a
+ * time, so that cores configured without FIFOs are handled too
+ *
+ * @param xdesc Platform specific SPI descriptor
+ * @param tx Data to send. If NULL, 0x00 is sent
+ * @param rx Where to store the received data. If NULL, it is discarded
+ * @param len Number of bytes
+ */
+static void spi_pl_poll(struct xil_spi_desc *xdesc, const uint8_t *tx,
+			uint8_t *rx, uint32_t len)
+{
+	XSpi		*inst = xdesc->instance;
+	uint32_t	ctrl_reg;
+	uint8_t		byte;
+
+	/* Discard stale data */
+	while (!(XSpi_ReadReg(inst->BaseAddr, XSP_SR_OFFSET) &
+		 XSP_SR_RX_EMPTY_MASK))
+		XSpi_ReadReg(inst->BaseAddr, XSP_DRR_OFFSET);
+
+	ctrl_reg = XSpi_GetControlReg(inst);
+	XSpi_SetControlReg(inst, ctrl_reg & ~XSP_CR_TRANS_INHIBIT_MASK);
+
+	while (len--) {
+		XSpi_WriteReg(inst->BaseAddr, XSP_DTR_OFFSET, tx ? *tx++ : 0);
+		while (XSpi_ReadReg(inst->BaseAddr, XSP_SR_OFFSET) &
+		       XSP_SR_RX_EMPTY_MASK)
+			;
+		byte = XSpi_ReadReg(inst->BaseAddr, XSP_DRR_OFFSET);
+		if (rx)
+			*rx++ = byte;
+	}
+
+	XSpi_SetControlReg(inst, ctrl_reg | XSP_CR_TRANS_INHIBIT_MASK);
+}
+#endif // XSPI_H
+
+/**
+ * @brief Assert or deassert the slave select of a transfer
+ *
+ * @param desc The SPI descriptor
+ * @param assert true to select the slave, false to deselect it
+ */
+static void xil_spi_cs(struct no_os_spi_desc *desc, bool assert)
+{
+	struct xil_spi_desc	*xdesc = desc->extra;
+#ifdef XSPI_H
+	uint32_t		ss;
+#endif
+
+	switch (xdesc->type) {
+#ifdef XSPI_H
+	case SPI_PL:
+		/* The slave select register is active low */
+		ss = ((XSpi *)xdesc->instance)->SlaveSelectMask;
+		if (assert)
+			ss &= ~NO_OS_BIT(desc->chip_select);
+		XSpi_SetSlaveSelectReg((XSpi *)xdesc->instance, ss);
+		break;
+#endif
+#ifdef XSPIPS_H
+	case SPI_PS:
+		XSpiPs_SetSlaveSelect(xdesc->instance,
+				      assert ? desc->chip_select :
+				      SPI_DEASSERT_CURRENT_SS);
+		break;
+#endif
+	default:
+		break;
+	}
+}
+
+/**
+ * @brief Write and read the data of a message, leaving the slave select
+ * unchanged
+ *
+ * @param xdesc Platform specific SPI descriptor
+ * @param msg The message
+ */
+static void xil_spi_poll(struct xil_spi_desc *xdesc, struct no_os_spi_msg *msg)
+{
+	switch (xdesc->type) {
+#ifdef XSPI_H
+	case SPI_PL:
+		spi_pl_poll(xdesc, msg->tx_buff, msg->rx_buff,
+			    msg->bytes_number);
+		break;
+#endif
+#ifdef XSPIPS_H
+	case SPI_PS:
+		spi_ps_poll(xdesc, msg->tx_buff, msg->rx_buff,
+			    msg->bytes_number);
+		break;
+#endif
+	default:
+		break;
+	}
+}
+
 /**
  * @brief Initialize the hardware SPI peripherial
  *
@@ -171,6 +497,11 @@ static int32_t spi_init_ps(struct no_os_spi_desc *desc,
 	xdesc->type = xinit->type;
 	xdesc->flags = xinit->flags;
 
+	xdesc->irq_desc = xinit->irq_desc;
+	xdesc->irq_id = xinit->irq_id;
+	xdesc->chip_select = param->chip_select;
+	xdesc->async_callback = NULL;
+
 	xdesc->instance = (XSpiPs*)malloc(sizeof(XSpiPs));
 	if(!xdesc->instance)
 		goto ps_error;
@@ -236,6 +567,10 @@ static int32_t spi_init_ps(struct no_os_spi_desc *desc,
 	if(ret != 0)
 		goto ps_error;
 
+	ret = spi_ps_irq_init(xdesc);
+	if (ret != 0)
+		goto ps_error;
+
 	return 0;
 
 ps_error:
@@ -309,6 +644,9 @@ int32_t xil_spi_remove(struct no_os_spi_desc *desc)
 {
 #ifdef XSPI_H
 	int32_t				ret;
+#endif
+#ifdef XSPIPS_H
+	struct no_os_callback_desc	callback_desc = { 0 };
 #endif
 	struct xil_spi_desc	*xdesc = NULL;
 	enum xil_spi_type	*spi_type;
@@ -337,6 +675,16 @@ int32_t xil_spi_remove(struct no_os_spi_desc *desc)
 
 		if(!xdesc)
 			return -1;
+
+		if (xdesc->irq_desc) {
+			no_os_irq_disable(xdesc->irq_desc, xdesc->irq_id);
+			callback_desc.callback =
+				(void (*)())XSpiPs_InterruptHandler;
+			callback_desc.ctx = xdesc->instance;
+			no_os_irq_unregister_callback(xdesc->irq_desc,
+						      xdesc->irq_id,
+						      &callback_desc);
+		}
 #endif
 		break;
 
@@ -356,6 +704,67 @@ error:
 	return 0;
 }
 
+/**
+ * @brief Write/read multiple messages to/from SPI.
+ * @param desc - The SPI descriptor.
+ * @param msgs - The messages array.
+ * @param len - Number of messages.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t xil_spi_transfer(struct no_os_spi_desc *desc,
+			 struct no_os_spi_msg *msgs,
+			 uint32_t len)
+{
+	struct xil_spi_desc	*xdesc;
+	int32_t			ret;
+	uint32_t		i;
+
+	if (!desc || !desc->extra || !msgs)
+		return -EINVAL;
+
+	xdesc = desc->extra;
+
+	switch (xdesc->type) {
+#ifdef XSPI_H
+	case SPI_PL:
+		ret = spi_pl_setup(desc);
+		break;
+#endif
+#ifdef XSPIPS_H
+	case SPI_PS:
+		if (xdesc->async_callback)
+			return -EBUSY;
+
+		ret = spi_ps_setup(desc);
+		break;
+#endif
+	default:
+		return -1;
+	}
+	if (ret != 0)
+		return ret;
+
+	for (i = 0; i < len; i++) {
+		xil_spi_cs(desc, true);
+
+		if (msgs[i].cs_delay_first)
+			no_os_udelay(msgs[i].cs_delay_first);
+
+		xil_spi_poll(xdesc, &msgs[i]);
+
+		if (msgs[i].cs_delay_last)
+			no_os_udelay(msgs[i].cs_delay_last);
+
+		if (msgs[i].cs_change)
+			xil_spi_cs(desc, false);
+
+		if (msgs[i].cs_change_delay)
+			no_os_udelay(msgs[i].cs_change_delay);
+	}
+
+	return 0;
+}
+
 /**
  * @brief Write and read data to/from SPI.
  * @param desc - The SPI descriptor.
@@ -367,89 +776,68 @@ int32_t xil_spi_write_and_read(struct no_os_spi_desc *desc,
 			       uint8_t *data,
 			       uint16_t bytes_number)
 {
-	int32_t			ret;
-#ifdef XSPI_H
-	uint32_t		ctrl_reg;
-#endif
-	struct xil_spi_desc	*xdesc;
-	enum xil_spi_type	*spi_type;
+	struct no_os_spi_msg msg = {
+		.tx_buff = data,
+		.rx_buff = data,
+		.bytes_number = bytes_number,
+		.cs_change = 1,
+	};
 
-	ret = -1;
+	return xil_spi_transfer(desc, &msg, 1);
+}
 
-	spi_type = desc->extra;
+/**
+ * @brief Start sending multiple messages to/from SPI, using interrupts.
+ * Only supported on SPI_PS, initialized with an interrupt controller. Delays
+ * are not supported and the CS is deasserted after each message.
+ * @param desc - The SPI descriptor.
+ * @param msgs - The messages array.
+ * @param len - Number of messages.
+ * @param callback - Called from interrupt context when the transfer is done.
+ * @param ctx - Parameter of callback.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t xil_spi_transfer_async(struct no_os_spi_desc *desc,
+			       struct no_os_spi_msg *msgs,
+			       uint32_t len,
+			       no_os_spi_callback callback,
+			       void *ctx)
+{
+#ifdef XSPIPS_H
+	struct xil_spi_desc	*xdesc;
+	int32_t			ret;
 
-	if(!spi_type)
-		return -1;
+	if (!desc || !desc->extra || !msgs || !callback)
+		return -EINVAL;
 
 	xdesc = desc->extra;
+	if (xdesc->type != SPI_PS || !xdesc->irq_desc)
+		return -ENOSYS;
 
-	switch (*spi_type) {
-	case SPI_PL:
-#ifdef XSPI_H
-		ret = XSpi_SetOptions(xdesc->instance,
-				      XSP_MASTER_OPTION |
-				      ((desc->mode & NO_OS_SPI_CPOL) ?
-				       XSP_CLK_ACTIVE_LOW_OPTION : 0) |
-				      ((desc->mode & NO_OS_SPI_CPHA) ?
-				       XSP_CLK_PHASE_1_OPTION : 0));
-		if (ret != 0)
-			goto error;
+	if (xdesc->async_callback)
+		return -EBUSY;
 
-		ctrl_reg = XSpi_GetControlReg(((XSpi*)xdesc->instance));
-		if (desc->bit_order == NO_OS_SPI_BIT_ORDER_LSB_FIRST)
-			ctrl_reg |= XSP_CR_LSB_MSB_FIRST_MASK;
-		else
-			ctrl_reg &= ~ XSP_CR_LSB_MSB_FIRST_MASK;
-		XSpi_SetControlReg(((XSpi*)xdesc->instance), ctrl_reg);
+	ret = spi_ps_setup(desc);
+	if (ret != 0)
+		return -EIO;
 
-		ret = XSpi_SetSlaveSelect(xdesc->instance,
-					  0x01 << desc->chip_select);
-		if (ret != 0)
-			goto error;
+	xdesc->async_msgs = msgs;
+	xdesc->async_len = len;
+	xdesc->async_idx = 0;
+	xdesc->async_ctx = ctx;
+	xdesc->async_callback = callback;
 
-		ret = XSpi_Transfer(xdesc->instance,
-				    data,
-				    data,
-				    bytes_number);
-		if (ret != 0)
-			goto error;
-#endif
-		break;
-	case SPI_PS:
-#ifdef XSPIPS_H
-		ret = XSpiPs_SetOptions(xdesc->instance,
-					XSPIPS_MASTER_OPTION |
-					((xdesc->flags & SPI_CS_DECODE) ?
-					 XSPIPS_DECODE_SSELECT_OPTION : 0) |
-					XSPIPS_FORCE_SSELECT_OPTION |
-					((desc->mode & NO_OS_SPI_CPOL) ?
-					 XSPIPS_CLK_ACTIVE_LOW_OPTION : 0) |
-					((desc->mode & NO_OS_SPI_CPHA) ?
-					 XSPIPS_CLK_PHASE_1_OPTION : 0));
-		if (ret != 0)
-			goto error;
-
-		ret = XSpiPs_SetSlaveSelect(xdesc->instance,
-					    desc->chip_select);
-		if (ret != 0)
-			goto error;
-		ret = XSpiPs_PolledTransfer(xdesc->instance,
-					    data,
-					    data,
-					    bytes_number);
-		if (ret != 0)
-			goto error;
-		ret = XSpiPs_SetSlaveSelect(xdesc->instance, SPI_DEASSERT_CURRENT_SS);
-		if (ret != 0)
-			goto error;
-#endif
-		break;
-error:
-	default:
-		return -1;
+	ret = spi_ps_async_start(xdesc);
+	if (ret != 0) {
+		xdesc->async_callback = NULL;
+		XSpiPs_SetSlaveSelect(xdesc->instance, SPI_DEASSERT_CURRENT_SS);
+		return -EIO;
 	}
 
-	return ret;
+	return 0;
+#else
+	return -ENOSYS;
+#endif
 }
 
 /**
@@ -458,5 +846,7 @@ error:
 const struct no_os_spi_platform_ops xil_spi_ops = {
 	.init = &xil_spi_init,
 	.write_and_read = &xil_spi_write_and_read,
+	.transfer = &xil_spi_transfer,
+	.transfer_async = &xil_spi_transfer_async,
 	.remove = &xil_spi_remove
 };
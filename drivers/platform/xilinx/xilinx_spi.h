@@ -45,6 +45,7 @@
 
 #include <stdint.h>
 #include "no_os_spi.h"
+#include "no_os_irq.h"
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -80,6 +81,13 @@ struct xil_spi_init_param {
 	enum xil_spi_type	type;
 	/** SPI flags */
 	uint32_t		flags;
+	/**
+	 * Interrupt Request Descriptor. Optional, needed for asynchronous
+	 * transfers on SPI_PS
+	 */
+	struct no_os_irq_ctrl_desc *irq_desc;
+	/** Interrupt Request ID */
+	uint32_t		irq_id;
 };
 
 /**
@@ -95,6 +103,22 @@ struct xil_spi_desc {
 	void			*config;
 	/** SPI instance */
 	void			*instance;
+	/** Interrupt Request Descriptor */
+	struct no_os_irq_ctrl_desc *irq_desc;
+	/** Interrupt Request ID */
+	uint32_t		irq_id;
+	/** Chip select */
+	uint8_t			chip_select;
+	/** Messages of the ongoing asynchronous transfer */
+	struct no_os_spi_msg	*async_msgs;
+	/** Number of messages of the ongoing asynchronous transfer */
+	uint32_t		async_len;
+	/** Index of the message being sent */
+	uint32_t		async_idx;
+	/** Called when the asynchronous transfer is done. NULL when idle */
+	no_os_spi_callback	async_callback;
+	/** Parameter of async_callback */
+	void			*async_ctx;
 };
 
 /**
@@ -75,8 +75,8 @@ static int32_t uart_fifo_insert(struct no_os_uart_desc *desc)
 		ret = no_os_irq_disable(irq_desc, xil_uart_desc->irq_id);
 		if (ret < 0)
 			return ret;
-		ret = no_os_fifo_insert(&xil_uart_desc->fifo, xil_uart_desc->buff,
-					xil_uart_desc->bytes_received);
+		ret = no_os_fifo_push(xil_uart_desc->fifo, xil_uart_desc->buff,
+				      xil_uart_desc->bytes_received);
 		if (ret < 0)
 			return ret;
 		xil_uart_desc->bytes_received = 0;
@@ -114,25 +114,26 @@ static int32_t xil_uart_read_byte(struct no_os_uart_desc *desc, uint8_t *data)
 	XUartLite *instance = xil_uart_desc->instance;
 #endif
 #ifdef XUARTPS_H
+	struct no_os_fifo_element *element;
 	int32_t ret;
 #endif
 
 	switch(xil_uart_desc->type) {
 	case UART_PS:
 #ifdef XUARTPS_H
-		while (xil_uart_desc->fifo == NULL) {
+		while (!(element = no_os_fifo_peek(xil_uart_desc->fifo))) {
 			/* nothing in fifo, wait until something is received */
 			ret = uart_fifo_insert(desc);
 			if (ret < 0)
 				return ret;
 		}
 
-		*data = xil_uart_desc->fifo->data[xil_uart_desc->fifo_read_offset];
+		*data = element->data[xil_uart_desc->fifo_read_offset];
 		xil_uart_desc->fifo_read_offset++;
 
-		if (xil_uart_desc->fifo->len - xil_uart_desc->fifo_read_offset <= 0) {
+		if (element->len - xil_uart_desc->fifo_read_offset <= 0) {
 			xil_uart_desc->fifo_read_offset = 0;
-			xil_uart_desc->fifo = no_os_fifo_remove(xil_uart_desc->fifo);
+			no_os_fifo_pop(xil_uart_desc->fifo);
 		}
 #endif // XUARTPS_H
 		break;
@@ -337,6 +338,10 @@ static int32_t xil_uart_init(struct no_os_uart_desc **desc,
 	struct xil_uart_init_param *xil_uart_init_param;
 	struct xil_uart_desc *xil_uart_desc;
 #ifdef XUARTPS_H
+	struct no_os_fifo_pool_init_param fifo_param = {
+		.nb_blocks = UART_FIFO_BLOCKS,
+		.block_size = UART_BUFF_LENGTH,
+	};
 	XUartPs_Config *config;
 #endif // XUARTPS_H
 #ifdef XUARTLITE_H
@@ -396,6 +401,11 @@ static int32_t xil_uart_init(struct no_os_uart_desc **desc,
 		 */
 		XUartPs_SetRecvTimeout(xil_uart_desc->instance, 8);
 
+		status = no_os_fifo_pool_init(&xil_uart_desc->fifo,
+					      &fifo_param);
+		if (status)
+			goto error_free_instance;
+
 		status = uart_irq_init(descriptor);
 		if (status != XST_SUCCESS)
 			goto error_free_instance;
@@ -436,6 +446,7 @@ static int32_t xil_uart_init(struct no_os_uart_desc **desc,
 	return 0;
 
 error_free_instance:
+	no_os_fifo_pool_remove(xil_uart_desc->fifo);
 	free(xil_uart_desc->instance);
 error_free_xil_uart_desc:
 	free(xil_uart_desc);
@@ -453,6 +464,7 @@ error_free_descriptor:
 static int32_t xil_uart_remove(struct no_os_uart_desc *desc)
 {
 	struct xil_uart_desc *xil_uart_desc = desc->extra;
+	no_os_fifo_pool_remove(xil_uart_desc->fifo);
 	free(xil_uart_desc->instance);
 	free(xil_uart_desc);
 	free(desc);
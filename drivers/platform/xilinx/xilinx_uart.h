@@ -49,6 +49,7 @@
 /******************************************************************************/
 
 #define UART_BUFF_LENGTH 256
+#define UART_FIFO_BLOCKS 4
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -91,7 +92,7 @@ struct xil_uart_desc {
 	/** Interrupt Request Descriptor */
 	struct no_os_irq_ctrl_desc *irq_desc;
 	/** FIFO */
-	struct no_os_fifo_element	*fifo;
+	struct no_os_fifo_pool		*fifo;
 	/** FIFO read offset */
 	uint32_t 			fifo_read_offset;
 	/** UART Buffer */
@@ -49,6 +49,7 @@
 #include "no_os_spi.h"
 #include "no_os_gpio.h"
 #include "no_os_delay.h"
+#include "no_os_sched.h"
 #include "ad9361_util.h"
 #include "no_os_util.h"
 #include "app_config.h"
@@ -903,6 +904,93 @@ static int32_t ad9361_spi_writem(struct no_os_spi_desc *spi,
 	return 0;
 }
 
+#define AD9361_SPI_BATCH_MSGS	24
+
+/*
+ * Register writes queued to be sent with a single no_os_spi_transfer() call.
+ * Each message is a complete register transaction, CS is released after it.
+ */
+struct ad9361_spi_batch {
+	struct no_os_spi_desc *spi;
+	struct no_os_spi_msg msgs[AD9361_SPI_BATCH_MSGS];
+	uint8_t buf[AD9361_SPI_BATCH_MSGS][2 + MAX_MBYTE_SPI];
+	uint32_t nb_msgs;
+	int32_t ret;
+};
+
+/**
+ * Send the register writes queued in a batch.
+ * @param batch The batch.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad9361_spi_batch_flush(struct ad9361_spi_batch *batch)
+{
+	int32_t ret;
+
+	if (!batch->nb_msgs)
+		return batch->ret;
+
+	ret = no_os_spi_transfer(batch->spi, batch->msgs, batch->nb_msgs);
+	if (ret < 0) {
+		dev_err(&batch->spi->dev, "Write Error %"PRId32, ret);
+		if (!batch->ret)
+			batch->ret = ret;
+	}
+	batch->nb_msgs = 0;
+
+	return batch->ret;
+}
+
+/**
+ * Queue a write of num consecutive registers, from reg downwards, as one
+ * streaming transaction. The batch is sent when it is full.
+ * @param batch The batch.
+ * @param reg The register address.
+ * @param tbuf The data buffer, tbuf[0] goes to reg.
+ * @param num The number of bytes to write.
+ */
+static void ad9361_spi_batch_writem(struct ad9361_spi_batch *batch,
+				    uint32_t reg, const uint8_t *tbuf,
+				    uint32_t num)
+{
+	struct no_os_spi_msg *msg;
+	uint8_t *buf;
+	uint16_t cmd;
+
+	if (num > MAX_MBYTE_SPI) {
+		batch->ret = -EINVAL;
+		return;
+	}
+
+	if (batch->nb_msgs == AD9361_SPI_BATCH_MSGS)
+		ad9361_spi_batch_flush(batch);
+
+	buf = batch->buf[batch->nb_msgs];
+	cmd = AD_WRITE | AD_CNT(num) | AD_ADDR(reg);
+	buf[0] = cmd >> 8;
+	buf[1] = cmd & 0xFF;
+	memcpy(&buf[2], tbuf, num);
+
+	msg = &batch->msgs[batch->nb_msgs++];
+	memset(msg, 0, sizeof(*msg));
+	msg->tx_buff = buf;
+	msg->rx_buff = buf;
+	msg->bytes_number = num + 2;
+	msg->cs_change = 1;
+}
+
+/**
+ * Queue a single register write.
+ * @param batch The batch.
+ * @param reg The register address.
+ * @param val The value of the register.
+ */
+static void ad9361_spi_batch_write(struct ad9361_spi_batch *batch,
+				   uint32_t reg, uint8_t val)
+{
+	ad9361_spi_batch_writem(batch, reg, &val, 1);
+}
+
 /**
  * Validate RF BW frequency.
  * @param phy The AD9361 state structure.
@@ -1286,6 +1374,9 @@ static int32_t ad9361_check_cal_done(struct ad9361_rf_phy *phy, uint32_t reg,
 		if (state == done_state)
 			return 0;
 
+		/* Let the other works, e.g. a second PHY, use the wait */
+		no_os_sched_yield();
+
 		if (reg == REG_CALIBRATION_CTRL)
 			no_os_udelay(1200);
 		else
@@ -1387,6 +1478,15 @@ static int find_table_index(struct ad9361_rf_phy *phy, int gain)
 {
 	uint32_t i, nm1, n;
 
+	if (phy->gt_gain_idx_nb) {
+		if (gain >= phy->gt_gain_idx_min + (int32_t)phy->gt_gain_idx_nb)
+			return -EINVAL;
+		if (gain < phy->gt_gain_idx_min)
+			return 0;
+
+		return phy->gt_gain_idx[gain - phy->gt_gain_idx_min];
+	}
+
 	for (i = 0; i < phy->gt_info[ad9361_gt(phy)].max_index; i++) {
 		if (phy->gt_info[ad9361_gt(phy)].abs_gain_tbl[i] >= gain) {
 			nm1 = abs(phy->gt_info[ad9361_gt(phy)].abs_gain_tbl[
@@ -1403,6 +1503,37 @@ static int find_table_index(struct ad9361_rf_phy *phy, int gain)
 	return -EINVAL;
 }
 
+/**
+ * Build the gain to table index map of the current gain table, so
+ * find_table_index() does not search the table on each gain change.
+ * @param phy The AD9361 state structure.
+ * @return None.
+ */
+static void ad9361_gt_build_gain_idx(struct ad9361_rf_phy *phy)
+{
+	struct gain_table_info *gt = &phy->gt_info[ad9361_gt(phy)];
+	int32_t gain, max;
+	int ret;
+
+	phy->gt_gain_idx_nb = 0;
+	if (!gt->max_index)
+		return;
+
+	phy->gt_gain_idx_min = gt->abs_gain_tbl[0];
+	max = gt->abs_gain_tbl[gt->max_index - 1];
+	if (max < phy->gt_gain_idx_min)
+		return;
+
+	for (gain = phy->gt_gain_idx_min; gain <= max; gain++) {
+		ret = find_table_index(phy, gain);
+		if (ret < 0)
+			return;
+		phy->gt_gain_idx[gain - phy->gt_gain_idx_min] = ret;
+	}
+
+	phy->gt_gain_idx_nb = max - phy->gt_gain_idx_min + 1;
+}
+
 /**
  * Load the gain table for the selected frequency range and receiver.
  * @param phy The AD9361 state structure.
@@ -1414,7 +1545,9 @@ static int32_t ad9361_load_gt(struct ad9361_rf_phy *phy, uint64_t freq,
 			      uint32_t dest)
 {
 	struct no_os_spi_desc *spi = phy->spi;
+	struct ad9361_spi_batch batch = { 0 };
 	uint8_t (*tab)[3];
+	uint8_t buf[4];
 	uint32_t band, index_max, i, lna, lpf_tia_mask, set_gain;
 	int32_t ret, rx1_gain, rx2_gain;
 
@@ -1465,8 +1598,10 @@ static int32_t ad9361_load_gt(struct ad9361_rf_phy *phy, uint64_t freq,
 	lna = phy->pdata->elna_ctrl.elna_in_gaintable_all_index_en ?
 	      EXT_LNA_CTRL : 0;
 
-	ad9361_spi_write(spi, REG_GAIN_TABLE_CONFIG, START_GAIN_TABLE_CLOCK |
-			 RECEIVER_SELECT(dest)); /* Start Gain Table Clock */
+	batch.spi = spi;
+	ad9361_spi_batch_write(&batch, REG_GAIN_TABLE_CONFIG,
+			       START_GAIN_TABLE_CLOCK |
+			       RECEIVER_SELECT(dest)); /* Start Gain Table Clock */
 
 	/* TX QUAD Calibration */
 	if (phy->pdata->split_gt)
@@ -1477,36 +1612,41 @@ static int32_t ad9361_load_gt(struct ad9361_rf_phy *phy, uint64_t freq,
 	phy->tx_quad_lpf_tia_match = -EINVAL;
 
 	for (i = 0; i < index_max; i++) {
-		ad9361_spi_write(spi, REG_GAIN_TABLE_ADDRESS, i); /* Gain Table Index */
-		ad9361_spi_write(spi, REG_GAIN_TABLE_WRITE_DATA1,
-				 tab[i][0] | lna); /* Ext LNA, Int LNA, & Mixer Gain Word */
-		ad9361_spi_write(spi, REG_GAIN_TABLE_WRITE_DATA2,
-				 tab[i][1]); /* TIA & LPF Word */
-		ad9361_spi_write(spi, REG_GAIN_TABLE_WRITE_DATA3,
-				 tab[i][2]); /* DC Cal bit & Dig Gain Word */
-		ad9361_spi_write(spi, REG_GAIN_TABLE_CONFIG,
-				 START_GAIN_TABLE_CLOCK |
-				 WRITE_GAIN_TABLE |
-				 RECEIVER_SELECT(dest)); /* Gain Table Index */
-		ad9361_spi_write(spi, REG_GAIN_TABLE_READ_DATA1,
-				 0); /* Dummy Write to delay 3 ADCCLK/16 cycles */
-		ad9361_spi_write(spi, REG_GAIN_TABLE_READ_DATA1,
-				 0); /* Dummy Write to delay ~1u */
+		/* Data3 down to the Gain Table Index in one transaction */
+		buf[0] = tab[i][2]; /* DC Cal bit & Dig Gain Word */
+		buf[1] = tab[i][1]; /* TIA & LPF Word */
+		buf[2] = tab[i][0] | lna; /* Ext LNA, Int LNA, & Mixer Gain Word */
+		buf[3] = i; /* Gain Table Index */
+		ad9361_spi_batch_writem(&batch, REG_GAIN_TABLE_WRITE_DATA3, buf, 4);
+		ad9361_spi_batch_write(&batch, REG_GAIN_TABLE_CONFIG,
+				       START_GAIN_TABLE_CLOCK |
+				       WRITE_GAIN_TABLE |
+				       RECEIVER_SELECT(dest)); /* Gain Table Index */
+		ad9361_spi_batch_write(&batch, REG_GAIN_TABLE_READ_DATA1,
+				       0); /* Dummy Write to delay 3 ADCCLK/16 cycles */
+		ad9361_spi_batch_write(&batch, REG_GAIN_TABLE_READ_DATA1,
+				       0); /* Dummy Write to delay ~1u */
 
 		if ((tab[i][1] & lpf_tia_mask) == 0x20)
 			phy->tx_quad_lpf_tia_match = i;
 
 	}
 
-	ad9361_spi_write(spi, REG_GAIN_TABLE_CONFIG, START_GAIN_TABLE_CLOCK |
-			 RECEIVER_SELECT(dest)); /* Clear Write Bit */
-	ad9361_spi_write(spi, REG_GAIN_TABLE_READ_DATA1,
-			 0); /* Dummy Write to delay ~1u */
-	ad9361_spi_write(spi, REG_GAIN_TABLE_READ_DATA1,
-			 0); /* Dummy Write to delay ~1u */
-	ad9361_spi_write(spi, REG_GAIN_TABLE_CONFIG, 0); /* Stop Gain Table Clock */
+	ad9361_spi_batch_write(&batch, REG_GAIN_TABLE_CONFIG,
+			       START_GAIN_TABLE_CLOCK |
+			       RECEIVER_SELECT(dest)); /* Clear Write Bit */
+	ad9361_spi_batch_write(&batch, REG_GAIN_TABLE_READ_DATA1,
+			       0); /* Dummy Write to delay ~1u */
+	ad9361_spi_batch_write(&batch, REG_GAIN_TABLE_READ_DATA1,
+			       0); /* Dummy Write to delay ~1u */
+	ad9361_spi_batch_write(&batch, REG_GAIN_TABLE_CONFIG,
+			       0); /* Stop Gain Table Clock */
+	ret = ad9361_spi_batch_flush(&batch);
+	if (ret < 0)
+		return ret;
 
 	phy->current_table = band;
+	ad9361_gt_build_gain_idx(phy);
 
 	ret = find_table_index(phy, rx1_gain);
 	if (ret < 0)
@@ -1571,35 +1711,37 @@ static int32_t ad9361_clkout_control(struct ad9361_rf_phy *phy,
  */
 static int32_t ad9361_load_mixer_gm_subtable(struct ad9361_rf_phy *phy)
 {
+	struct ad9361_spi_batch batch = { 0 };
+	uint8_t buf[4];
 	int32_t i, addr;
 	dev_dbg(&phy->spi->dev, "%s", __func__);
 
-	ad9361_spi_write(phy->spi, REG_GM_SUB_TABLE_CONFIG,
-			 START_GM_SUB_TABLE_CLOCK); /* Start Clock */
+	batch.spi = phy->spi;
+	ad9361_spi_batch_write(&batch, REG_GM_SUB_TABLE_CONFIG,
+			       START_GM_SUB_TABLE_CLOCK); /* Start Clock */
 
 	for (i = 0, addr = NO_OS_ARRAY_SIZE(gm_st_ctrl);
 	     i < (int64_t)NO_OS_ARRAY_SIZE(gm_st_ctrl);
 	     i++) {
-		ad9361_spi_write(phy->spi, REG_GM_SUB_TABLE_ADDRESS,
-				 --addr); /* Gain Table Index */
-		ad9361_spi_write(phy->spi, REG_GM_SUB_TABLE_BIAS_WRITE, 0); /* Bias */
-		ad9361_spi_write(phy->spi, REG_GM_SUB_TABLE_GAIN_WRITE,
-				 gm_st_gain[i]); /* Gain */
-		ad9361_spi_write(phy->spi, REG_GM_SUB_TABLE_CTRL_WRITE,
-				 gm_st_ctrl[i]); /* Control */
-		ad9361_spi_write(phy->spi, REG_GM_SUB_TABLE_CONFIG,
-				 WRITE_GM_SUB_TABLE | START_GM_SUB_TABLE_CLOCK); /* Write Words */
-		ad9361_spi_write(phy->spi, REG_GM_SUB_TABLE_GAIN_READ, 0); /* Dummy Delay */
-		ad9361_spi_write(phy->spi, REG_GM_SUB_TABLE_GAIN_READ, 0); /* Dummy Delay */
-	}
-
-	ad9361_spi_write(phy->spi, REG_GM_SUB_TABLE_CONFIG,
-			 START_GM_SUB_TABLE_CLOCK); /* Clear Write */
-	ad9361_spi_write(phy->spi, REG_GM_SUB_TABLE_GAIN_READ, 0); /* Dummy Delay */
-	ad9361_spi_write(phy->spi, REG_GM_SUB_TABLE_GAIN_READ, 0); /* Dummy Delay */
-	ad9361_spi_write(phy->spi, REG_GM_SUB_TABLE_CONFIG, 0); /* Stop Clock */
+		/* Control down to the Gain Table Index in one transaction */
+		buf[0] = gm_st_ctrl[i]; /* Control */
+		buf[1] = 0; /* Bias */
+		buf[2] = gm_st_gain[i]; /* Gain */
+		buf[3] = --addr; /* Gain Table Index */
+		ad9361_spi_batch_writem(&batch, REG_GM_SUB_TABLE_CTRL_WRITE, buf, 4);
+		ad9361_spi_batch_write(&batch, REG_GM_SUB_TABLE_CONFIG,
+				       WRITE_GM_SUB_TABLE | START_GM_SUB_TABLE_CLOCK); /* Write Words */
+		ad9361_spi_batch_write(&batch, REG_GM_SUB_TABLE_GAIN_READ, 0); /* Dummy Delay */
+		ad9361_spi_batch_write(&batch, REG_GM_SUB_TABLE_GAIN_READ, 0); /* Dummy Delay */
+	}
 
-	return 0;
+	ad9361_spi_batch_write(&batch, REG_GM_SUB_TABLE_CONFIG,
+			       START_GM_SUB_TABLE_CLOCK); /* Clear Write */
+	ad9361_spi_batch_write(&batch, REG_GM_SUB_TABLE_GAIN_READ, 0); /* Dummy Delay */
+	ad9361_spi_batch_write(&batch, REG_GM_SUB_TABLE_GAIN_READ, 0); /* Dummy Delay */
+	ad9361_spi_batch_write(&batch, REG_GM_SUB_TABLE_CONFIG, 0); /* Stop Clock */
+
+	return ad9361_spi_batch_flush(&batch);
 }
 
 /**
@@ -2182,7 +2324,8 @@ static int32_t set_full_table_gain(struct ad9361_rf_phy *phy, uint32_t idx_reg,
 		goto out;
 	}
 
-	rc = ad9361_spi_writef(spi, idx_reg, RX_FULL_TBL_IDX_MASK, rc);
+	/* The index is the only field of the register, no need to read it */
+	rc = ad9361_spi_write(spi, idx_reg, FULL_TABLE_GAIN_INDEX(rc));
 out:
 	return rc;
 }
@@ -2452,6 +2595,45 @@ int32_t ad9361_read_rssi(struct ad9361_rf_phy *phy, struct rf_rssi *rssi)
 	return rc;
 }
 
+/**
+ * Read the RSSI, the gain index and the AGC state of both receivers, with
+ * two SPI transactions. Meant to be sampled periodically, for example from
+ * a timer interrupt.
+ * @param phy The AD9361 state structure.
+ * @param telemetry The sampled state.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_read_rx_telemetry(struct ad9361_rf_phy *phy,
+				 struct ad9361_rx_telemetry *telemetry)
+{
+	uint8_t buf[6];
+	int32_t rc;
+
+	/* REG_PREAMBLE_LSB down to REG_RX1_RSSI_SYMBOL */
+	rc = ad9361_spi_readm(phy->spi, REG_PREAMBLE_LSB, buf,
+			      NO_OS_ARRAY_SIZE(buf));
+	if (rc < 0)
+		return rc;
+
+	telemetry->rssi[0] = (buf[5] << RSSI_LSB_SHIFT) +
+			     (buf[1] & RSSI_LSB_MASK1);
+	telemetry->rssi[1] = (buf[3] << RSSI_LSB_SHIFT) +
+			     ((buf[1] & RSSI_LSB_MASK2) >> 1);
+
+	/* REG_GAIN_RX2 down to REG_GAIN_RX1 */
+	rc = ad9361_spi_readm(phy->spi, REG_GAIN_RX2, buf,
+			      NO_OS_ARRAY_SIZE(buf));
+	if (rc < 0)
+		return rc;
+
+	telemetry->gain_index[0] = buf[5] & FULL_TABLE_GAIN_INDEX(~0);
+	telemetry->gain_index[1] = buf[0] & FULL_TABLE_GAIN_INDEX(~0);
+	telemetry->slow_loop_state = buf[1];
+	telemetry->fast_attack_state = buf[2];
+
+	return 0;
+}
+
 /**
  * Setup the RX ADC.
  * @param phy The AD9361 state structure.
@@ -3278,6 +3460,164 @@ out_restore:
 	return ret;
 }
 
+/**
+ * Find the calibration cache entry for the current configuration.
+ * @param phy The AD9361 state structure.
+ * @param key The cache key of the current configuration.
+ * @return The entry, NULL if the configuration was not calibrated before.
+ */
+static struct ad9361_cal_cache_entry *ad9361_cal_cache_find(
+	struct ad9361_rf_phy *phy, struct ad9361_cal_cache_entry *key)
+{
+	struct ad9361_cal_cache_entry *e;
+	uint32_t i;
+
+	for (i = 0; i < AD9361_CAL_CACHE_SIZE; i++) {
+		e = &phy->cal_cache.entry[i];
+		if (e->valid && e->band == key->band &&
+		    e->rx_bw_Hz == key->rx_bw_Hz &&
+		    e->tx_bw_Hz == key->tx_bw_Hz &&
+		    e->tx_atten_mdB == key->tx_atten_mdB)
+			return e;
+	}
+
+	return NULL;
+}
+
+/**
+ * Save the quadrature correction words in the calibration cache, replacing
+ * the least recently used entry if the cache is full.
+ * @param phy The AD9361 state structure.
+ * @param key The cache key of the current configuration.
+ */
+static void ad9361_cal_cache_store(struct ad9361_rf_phy *phy,
+				   struct ad9361_cal_cache_entry *key)
+{
+	struct ad9361_cal_cache_entry *e = &phy->cal_cache.entry[0];
+	struct no_os_spi_desc *spi = phy->spi;
+	uint32_t i;
+
+	for (i = 0; i < AD9361_CAL_CACHE_SIZE; i++) {
+		if (!phy->cal_cache.entry[i].valid) {
+			e = &phy->cal_cache.entry[i];
+			break;
+		}
+		if (phy->cal_cache.entry[i].last_use < e->last_use)
+			e = &phy->cal_cache.entry[i];
+	}
+
+	*e = *key;
+	e->valid = true;
+	e->last_use = ++phy->cal_cache.use_count;
+	e->tx_quad_cal_phase = phy->last_tx_quad_cal_phase;
+
+	for (i = 0; i < AD9361_TX_QUAD_CORR_NUM; i++)
+		e->tx_quad_corr[i] = ad9361_spi_read(spi,
+						     REG_TX1_OUT_1_PHASE_CORR + i);
+	for (i = 0; i < AD9361_RX_QUAD_CORR_NUM; i++)
+		e->rx_quad_corr[i] = ad9361_spi_read(spi,
+						     REG_RX1_INPUT_A_PHASE_CORR + i);
+}
+
+/**
+ * Write back the quadrature correction words of a calibration cache entry.
+ * @param phy The AD9361 state structure.
+ * @param e The cache entry.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad9361_cal_cache_restore(struct ad9361_rf_phy *phy,
+					struct ad9361_cal_cache_entry *e)
+{
+	struct no_os_spi_desc *spi = phy->spi;
+	int32_t ret = 0;
+	uint32_t i;
+
+	for (i = 0; i < AD9361_TX_QUAD_CORR_NUM; i++)
+		ret |= ad9361_spi_write(spi, REG_TX1_OUT_1_PHASE_CORR + i,
+					e->tx_quad_corr[i]);
+	for (i = 0; i < AD9361_RX_QUAD_CORR_NUM; i++)
+		ret |= ad9361_spi_write(spi, REG_RX1_INPUT_A_PHASE_CORR + i,
+					e->rx_quad_corr[i]);
+
+	phy->last_tx_quad_cal_phase = e->tx_quad_cal_phase;
+	e->last_use = ++phy->cal_cache.use_count;
+
+	return ret;
+}
+
+/**
+ * Perform a TX quadrature calibration, or restore its results when the
+ * calibration cache is enabled and the configuration was calibrated before.
+ * The configuration is identified by the TX LO band, of cal_threshold_freq
+ * width, the bandwidths and the TX attenuation.
+ * @param phy The AD9361 state structure.
+ * @param bw_rx The RX bandwidth [Hz].
+ * @param bw_tx The TX bandwidth [Hz].
+ * @param rx_phase The optional RX phase value overwrite.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad9361_tx_quad_calib_cached(struct ad9361_rf_phy *phy,
+		uint32_t bw_rx, uint32_t bw_tx,
+		int32_t rx_phase)
+{
+	struct ad9361_cal_cache_entry key = { 0 }, *e;
+	int32_t atten, ret;
+	uint64_t lo;
+
+	/* Only automatic calibrations go through the cache */
+	if (!phy->cal_cache.enable || rx_phase != -1 ||
+	    !phy->cal_threshold_freq)
+		return ad9361_tx_quad_calib(phy, bw_rx, bw_tx, rx_phase);
+
+	atten = ad9361_get_tx_atten(phy, 1);
+	if (atten < 0)
+		return atten;
+
+	lo = ad9361_from_clk(clk_get_rate(phy, phy->ref_clk_scale[TX_RFPLL]));
+	key.band = no_os_div_u64(lo, phy->cal_threshold_freq);
+	key.rx_bw_Hz = bw_rx;
+	key.tx_bw_Hz = bw_tx;
+	key.tx_atten_mdB = atten;
+
+	e = ad9361_cal_cache_find(phy, &key);
+	if (e)
+		return ad9361_cal_cache_restore(phy, e);
+
+	ret = ad9361_tx_quad_calib(phy, bw_rx, bw_tx, rx_phase);
+	if (ret < 0)
+		return ret;
+
+	ad9361_cal_cache_store(phy, &key);
+
+	return 0;
+}
+
+/**
+ * Drop all the entries of the calibration cache, for example after a
+ * temperature change made them stale.
+ * @param phy The AD9361 state structure.
+ */
+void ad9361_cal_cache_flush(struct ad9361_rf_phy *phy)
+{
+	uint32_t i;
+
+	for (i = 0; i < AD9361_CAL_CACHE_SIZE; i++)
+		phy->cal_cache.entry[i].valid = false;
+}
+
+/**
+ * Drop all the entries of the digital interface tuning cache.
+ * @param phy The AD9361 state structure.
+ * @return None.
+ */
+void ad9361_dig_tune_cache_flush(struct ad9361_rf_phy *phy)
+{
+	uint32_t i;
+
+	for (i = 0; i < AD9361_DIG_TUNE_CACHE_SIZE; i++)
+		phy->dig_tune_cache.entry[i].valid = false;
+}
+
 /**
  * Setup RX tracking calibrations.
  * @param phy The AD9361 state structure.
@@ -4727,7 +5067,7 @@ int32_t ad9361_get_trx_clock_chain(struct ad9361_rf_phy *phy,
 }
 
 /**
- * Calculate the RX and TX path rates to obtain the desired sample rate.
+ * Search the RX and TX path rates to obtain the desired sample rate.
  * @param phy The AD9361 state structure.
  * @param tx_sample_rate The desired sample rate.
  * @param rate_gov The rate governor option.
@@ -4735,11 +5075,11 @@ int32_t ad9361_get_trx_clock_chain(struct ad9361_rf_phy *phy,
  * @param tx_path_clks TX path rates buffer.
  * @return 0 in case of success, negative error code otherwise.
  */
-int32_t ad9361_calculate_rf_clock_chain(struct ad9361_rf_phy *phy,
-					uint32_t tx_sample_rate,
-					uint32_t rate_gov,
-					uint32_t *rx_path_clks,
-					uint32_t *tx_path_clks)
+static int32_t __ad9361_calculate_rf_clock_chain(struct ad9361_rf_phy *phy,
+		uint32_t tx_sample_rate,
+		uint32_t rate_gov,
+		uint32_t *rx_path_clks,
+		uint32_t *tx_path_clks)
 {
 	uint32_t clktf, clkrf, adc_rate = 0, dac_rate = 0;
 	uint64_t bbpll_rate;
@@ -4815,8 +5155,8 @@ int32_t ad9361_calculate_rf_clock_chain(struct ad9361_rf_phy *phy,
 
 	if ((index_tx < 0 || index_tx > 6 || index_rx < 0 || index_rx > 6)
 	    && rate_gov < 7 && recursion) {
-		return ad9361_calculate_rf_clock_chain(phy, tx_sample_rate,
-						       ++rate_gov, rx_path_clks, tx_path_clks);
+		return __ad9361_calculate_rf_clock_chain(phy, tx_sample_rate,
+				++rate_gov, rx_path_clks, tx_path_clks);
 	} else if ((index_tx < 0 || index_tx > 6 || index_rx < 0 || index_rx > 6)) {
 		dev_err(&phy->spi->dev, "%s: Failed to find suitable dividers: %s",
 			__func__, (adc_rate < MIN_ADC_CLK) ? "ADC clock below limit" :
@@ -4851,6 +5191,282 @@ int32_t ad9361_calculate_rf_clock_chain(struct ad9361_rf_phy *phy,
 	return 0;
 }
 
+#ifdef AD9361_CLK_CHAIN_TABLE
+/*
+ * Clock chains of the LTE sample rates, as computed offline by
+ * __ad9361_calculate_rf_clock_chain(), for equal RX decimation and TX
+ * interpolation.
+ */
+static const struct ad9361_clk_chain_solution ad9361_clk_chain_table[] = {
+	{
+		3840000, 0, 1, 1, false,
+		{ 737280000, 46080000, 15360000, 7680000, 3840000, 3840000 },
+		{ 737280000, 46080000, 15360000, 7680000, 3840000, 3840000 }
+	},
+	{
+		7680000, 0, 1, 1, false,
+		{ 737280000, 92160000, 30720000, 15360000, 7680000, 7680000 },
+		{ 737280000, 92160000, 30720000, 15360000, 7680000, 7680000 }
+	},
+	{
+		15360000, 0, 1, 1, false,
+		{ 737280000, 184320000, 61440000, 30720000, 15360000, 15360000 },
+		{ 737280000, 184320000, 61440000, 30720000, 15360000, 15360000 }
+	},
+	{
+		23040000, 0, 1, 1, false,
+		{ 1105920000, 276480000, 92160000, 46080000, 23040000, 23040000 },
+		{ 1105920000, 276480000, 92160000, 46080000, 23040000, 23040000 }
+	},
+	{
+		30720000, 0, 1, 1, false,
+		{ 737280000, 368640000, 122880000, 61440000, 30720000, 30720000 },
+		{ 737280000, 184320000, 61440000, 61440000, 30720000, 30720000 }
+	},
+	{
+		61440000, 0, 1, 1, false,
+		{ 983040000, 491520000, 245760000, 122880000, 61440000, 61440000 },
+		{ 983040000, 245760000, 122880000, 61440000, 61440000, 61440000 }
+	},
+	{
+		1920000, 0, 2, 2, false,
+		{ 737280000, 46080000, 15360000, 7680000, 3840000, 1920000 },
+		{ 737280000, 46080000, 15360000, 7680000, 3840000, 1920000 }
+	},
+	{
+		3840000, 0, 2, 2, false,
+		{ 737280000, 92160000, 30720000, 15360000, 7680000, 3840000 },
+		{ 737280000, 92160000, 30720000, 15360000, 7680000, 3840000 }
+	},
+	{
+		7680000, 0, 2, 2, false,
+		{ 737280000, 184320000, 61440000, 30720000, 15360000, 7680000 },
+		{ 737280000, 184320000, 61440000, 30720000, 15360000, 7680000 }
+	},
+	{
+		15360000, 0, 2, 2, false,
+		{ 737280000, 368640000, 122880000, 61440000, 30720000, 15360000 },
+		{ 737280000, 184320000, 61440000, 61440000, 30720000, 15360000 }
+	},
+	{
+		23040000, 0, 2, 2, false,
+		{ 1105920000, 552960000, 184320000, 92160000, 46080000, 23040000 },
+		{ 1105920000, 276480000, 92160000, 92160000, 46080000, 23040000 }
+	},
+	{
+		30720000, 0, 2, 2, false,
+		{ 983040000, 491520000, 245760000, 122880000, 61440000, 30720000 },
+		{ 983040000, 245760000, 122880000, 61440000, 61440000, 30720000 }
+	},
+	{
+		61440000, 0, 2, 2, false,
+		{ 983040000, 491520000, 245760000, 122880000, 122880000, 61440000 },
+		{ 983040000, 245760000, 122880000, 122880000, 122880000, 61440000 }
+	},
+	{
+		1920000, 0, 4, 4, false,
+		{ 737280000, 92160000, 30720000, 15360000, 7680000, 1920000 },
+		{ 737280000, 92160000, 30720000, 15360000, 7680000, 1920000 }
+	},
+	{
+		3840000, 0, 4, 4, false,
+		{ 737280000, 184320000, 61440000, 30720000, 15360000, 3840000 },
+		{ 737280000, 184320000, 61440000, 30720000, 15360000, 3840000 }
+	},
+	{
+		7680000, 0, 4, 4, false,
+		{ 737280000, 368640000, 122880000, 61440000, 30720000, 7680000 },
+		{ 737280000, 184320000, 61440000, 61440000, 30720000, 7680000 }
+	},
+	{
+		15360000, 0, 4, 4, false,
+		{ 983040000, 491520000, 245760000, 122880000, 61440000, 15360000 },
+		{ 983040000, 245760000, 122880000, 61440000, 61440000, 15360000 }
+	},
+	{
+		23040000, 0, 4, 4, false,
+		{ 1105920000, 552960000, 184320000, 184320000, 92160000, 23040000 },
+		{ 1105920000, 276480000, 92160000, 92160000, 92160000, 23040000 }
+	},
+	{
+		30720000, 0, 4, 4, false,
+		{ 983040000, 491520000, 245760000, 122880000, 122880000, 30720000 },
+		{ 983040000, 245760000, 122880000, 122880000, 122880000, 30720000 }
+	},
+	{
+		61440000, 0, 4, 4, false,
+		{ 983040000, 491520000, 245760000, 245760000, 245760000, 61440000 },
+		{ 983040000, 245760000, 245760000, 245760000, 245760000, 61440000 }
+	},
+	{
+		3840000, 1, 1, 1, false,
+		{ 983040000, 30720000, 15360000, 7680000, 3840000, 3840000 },
+		{ 983040000, 30720000, 15360000, 7680000, 3840000, 3840000 }
+	},
+	{
+		7680000, 1, 1, 1, false,
+		{ 983040000, 61440000, 30720000, 15360000, 7680000, 7680000 },
+		{ 983040000, 61440000, 30720000, 15360000, 7680000, 7680000 }
+	},
+	{
+		15360000, 1, 1, 1, false,
+		{ 983040000, 122880000, 61440000, 30720000, 15360000, 15360000 },
+		{ 983040000, 122880000, 61440000, 30720000, 15360000, 15360000 }
+	},
+	{
+		23040000, 1, 1, 1, false,
+		{ 737280000, 184320000, 92160000, 46080000, 23040000, 23040000 },
+		{ 737280000, 184320000, 92160000, 46080000, 23040000, 23040000 }
+	},
+	{
+		30720000, 1, 1, 1, false,
+		{ 983040000, 245760000, 122880000, 61440000, 30720000, 30720000 },
+		{ 983040000, 245760000, 122880000, 61440000, 30720000, 30720000 }
+	},
+	{
+		61440000, 1, 1, 1, false,
+		{ 983040000, 491520000, 245760000, 122880000, 61440000, 61440000 },
+		{ 983040000, 245760000, 122880000, 61440000, 61440000, 61440000 }
+	},
+	{
+		1920000, 1, 2, 2, false,
+		{ 983040000, 30720000, 15360000, 7680000, 3840000, 1920000 },
+		{ 983040000, 30720000, 15360000, 7680000, 3840000, 1920000 }
+	},
+	{
+		3840000, 1, 2, 2, false,
+		{ 983040000, 61440000, 30720000, 15360000, 7680000, 3840000 },
+		{ 983040000, 61440000, 30720000, 15360000, 7680000, 3840000 }
+	},
+	{
+		7680000, 1, 2, 2, false,
+		{ 983040000, 122880000, 61440000, 30720000, 15360000, 7680000 },
+		{ 983040000, 122880000, 61440000, 30720000, 15360000, 7680000 }
+	},
+	{
+		15360000, 1, 2, 2, false,
+		{ 983040000, 245760000, 122880000, 61440000, 30720000, 15360000 },
+		{ 983040000, 245760000, 122880000, 61440000, 30720000, 15360000 }
+	},
+	{
+		23040000, 1, 2, 2, false,
+		{ 737280000, 368640000, 184320000, 92160000, 46080000, 23040000 },
+		{ 737280000, 184320000, 92160000, 46080000, 46080000, 23040000 }
+	},
+	{
+		30720000, 1, 2, 2, false,
+		{ 983040000, 491520000, 245760000, 122880000, 61440000, 30720000 },
+		{ 983040000, 245760000, 122880000, 61440000, 61440000, 30720000 }
+	},
+	{
+		61440000, 1, 2, 2, false,
+		{ 983040000, 491520000, 245760000, 122880000, 122880000, 61440000 },
+		{ 983040000, 245760000, 122880000, 122880000, 122880000, 61440000 }
+	},
+	{
+		1920000, 1, 4, 4, false,
+		{ 983040000, 61440000, 30720000, 15360000, 7680000, 1920000 },
+		{ 983040000, 61440000, 30720000, 15360000, 7680000, 1920000 }
+	},
+	{
+		3840000, 1, 4, 4, false,
+		{ 983040000, 122880000, 61440000, 30720000, 15360000, 3840000 },
+		{ 983040000, 122880000, 61440000, 30720000, 15360000, 3840000 }
+	},
+	{
+		7680000, 1, 4, 4, false,
+		{ 983040000, 245760000, 122880000, 61440000, 30720000, 7680000 },
+		{ 983040000, 245760000, 122880000, 61440000, 30720000, 7680000 }
+	},
+	{
+		15360000, 1, 4, 4, false,
+		{ 983040000, 491520000, 245760000, 122880000, 61440000, 15360000 },
+		{ 983040000, 245760000, 122880000, 61440000, 61440000, 15360000 }
+	},
+	{
+		23040000, 1, 4, 4, false,
+		{ 1105920000, 552960000, 184320000, 184320000, 92160000, 23040000 },
+		{ 1105920000, 276480000, 92160000, 92160000, 92160000, 23040000 }
+	},
+	{
+		30720000, 1, 4, 4, false,
+		{ 983040000, 491520000, 245760000, 122880000, 122880000, 30720000 },
+		{ 983040000, 245760000, 122880000, 122880000, 122880000, 30720000 }
+	},
+	{
+		61440000, 1, 4, 4, false,
+		{ 983040000, 491520000, 245760000, 245760000, 245760000, 61440000 },
+		{ 983040000, 245760000, 245760000, 245760000, 245760000, 61440000 }
+	},
+};
+#endif
+
+/**
+ * Calculate the RX and TX path rates to obtain the desired sample rate.
+ * The last solutions are kept in phy->clk_chain_cache, so switching back to
+ * a previously used rate does not search the divider space again.
+ * @param phy The AD9361 state structure.
+ * @param tx_sample_rate The desired sample rate.
+ * @param rate_gov The rate governor option.
+ * @param rx_path_clks RX path rates buffer.
+ * @param tx_path_clks TX path rates buffer.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_calculate_rf_clock_chain(struct ad9361_rf_phy *phy,
+					uint32_t tx_sample_rate,
+					uint32_t rate_gov,
+					uint32_t *rx_path_clks,
+					uint32_t *tx_path_clks)
+{
+	const struct ad9361_clk_chain_solution *sol;
+	struct ad9361_clk_chain_solution key = { 0 };
+	uint32_t i;
+	int32_t ret;
+
+	key.rate = tx_sample_rate;
+	key.rate_gov = rate_gov;
+	key.rx_intdec = phy->bypass_rx_fir ? 1 : phy->rx_fir_dec;
+	key.tx_intdec = phy->bypass_tx_fir ? 1 : phy->tx_fir_int;
+	key.rx_eq_2tx = phy->rx_eq_2tx;
+
+	/* Previously solved rates first, then the offline table, then search */
+	for (i = 0; i < AD9361_CLK_CHAIN_CACHE_SIZE; i++) {
+		sol = &phy->clk_chain_cache[i];
+		if (sol->rate == key.rate && sol->rate_gov == key.rate_gov &&
+		    sol->rx_intdec == key.rx_intdec &&
+		    sol->tx_intdec == key.tx_intdec &&
+		    sol->rx_eq_2tx == key.rx_eq_2tx)
+			goto found;
+	}
+
+#ifdef AD9361_CLK_CHAIN_TABLE
+	for (i = 0; i < NO_OS_ARRAY_SIZE(ad9361_clk_chain_table); i++) {
+		sol = &ad9361_clk_chain_table[i];
+		if (sol->rate == key.rate && sol->rate_gov == key.rate_gov &&
+		    sol->rx_intdec == key.rx_intdec &&
+		    sol->tx_intdec == key.tx_intdec &&
+		    sol->rx_eq_2tx == key.rx_eq_2tx)
+			goto found;
+	}
+#endif
+
+	ret = __ad9361_calculate_rf_clock_chain(phy, tx_sample_rate, rate_gov,
+						key.rx_path_clks,
+						key.tx_path_clks);
+	if (ret < 0)
+		return ret;
+
+	phy->clk_chain_cache[phy->clk_chain_cache_next] = key;
+	phy->clk_chain_cache_next = (phy->clk_chain_cache_next + 1) %
+				    AD9361_CLK_CHAIN_CACHE_SIZE;
+	sol = &key;
+found:
+	memcpy(rx_path_clks, sol->rx_path_clks, sizeof(sol->rx_path_clks));
+	memcpy(tx_path_clks, sol->tx_path_clks, sizeof(sol->tx_path_clks));
+
+	return 0;
+}
+
 /**
  * Set the desired sample rate.
  * @param phy The AD9361 state structure.
@@ -4867,6 +5483,13 @@ int32_t ad9361_set_trx_clock_chain_freq(struct ad9361_rf_phy *phy,
 					      phy->rate_governor, rx, tx);
 	if (ret < 0)
 		return ret;
+
+	/* Nothing to reprogram when the clock chain does not change */
+	if (!memcmp(rx, phy->current_rx_path_clks, sizeof(rx)) &&
+	    !memcmp(&tx[DAC_FREQ], &phy->current_tx_path_clks[DAC_FREQ],
+		    sizeof(tx) - sizeof(tx[BBPLL_FREQ])))
+		return 0;
+
 	return ad9361_set_trx_clock_chain(phy, rx, tx);
 }
 
@@ -5266,6 +5889,46 @@ int32_t ad9361_mcs(struct ad9361_rf_phy *phy, int32_t step)
 	return 0;
 }
 
+/**
+ * Wait for the end of a Multi Chip Sync (MCS) step, polling the PLL locks
+ * instead of sleeping a fixed time.
+ * @param phy The AD9361 state structure.
+ * @param step MCS step done with ad9361_mcs().
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_mcs_wait(struct ad9361_rf_phy *phy, int32_t step)
+{
+	int32_t ret;
+
+	switch (step) {
+	case 1:
+	case 3:
+		/* The BBPLL and the digital clocks are resynchronized */
+		return ad9361_check_cal_done(phy, REG_CH_1_OVERFLOW,
+					     BBPLL_LOCK, 1);
+	case 2:
+	case 4:
+		/* SYNC_IN is sampled on the next REF_CLK edges */
+		if (phy->gpio_desc_sync)
+			no_os_udelay(AD9361_MCS_SYNC_SETTLE_US);
+		return 0;
+	case 5:
+		ret = ad9361_check_cal_done(phy, REG_RX_CP_OVERRANGE_VCO_LOCK,
+					    VCO_LOCK, 1);
+		if (ret)
+			return ret;
+
+		/* In TDD the TX synthesizer may be powered down in ALERT */
+		if (!phy->pdata->fdd && !phy->pdata->tdd_use_dual_synth)
+			return 0;
+
+		return ad9361_check_cal_done(phy, REG_TX_CP_OVERRANGE_VCO_LOCK,
+					     VCO_LOCK, 1);
+	default:
+		return 0;
+	}
+}
+
 /**
  * Clear state.
  * @param phy The AD9361 state structure.
@@ -5274,6 +5937,7 @@ int32_t ad9361_mcs(struct ad9361_rf_phy *phy, int32_t step)
 void ad9361_clear_state(struct ad9361_rf_phy *phy)
 {
 	phy->current_table = NO_GAIN_TABLE;
+	phy->gt_gain_idx_nb = 0;
 	phy->bypass_tx_fir = true;
 	phy->bypass_rx_fir = true;
 	phy->rate_governor = 1;
@@ -5659,8 +6323,8 @@ int32_t ad9361_do_calib_run(struct ad9361_rf_phy *phy, uint32_t cal,
 
 	switch (cal) {
 	case TX_QUAD_CAL:
-		ret = ad9361_tx_quad_calib(phy, phy->current_rx_bw_Hz / 2,
-					   phy->current_tx_bw_Hz / 2, arg);
+		ret = ad9361_tx_quad_calib_cached(phy, phy->current_rx_bw_Hz / 2,
+						  phy->current_tx_bw_Hz / 2, arg);
 		break;
 	case RFDC_CAL:
 		ret = ad9361_rf_dc_offset_calib(phy,
@@ -5704,7 +6368,8 @@ int32_t ad9361_update_rf_bandwidth(struct ad9361_rf_phy *phy,
 	phy->current_tx_bw_Hz = rf_tx_bw;
 
 	if (phy->manual_tx_quad_cal_en == false) {
-		ret = ad9361_tx_quad_calib(phy, rf_rx_bw / 2, rf_tx_bw / 2, -1);
+		ret = ad9361_tx_quad_calib_cached(phy, rf_rx_bw / 2, rf_tx_bw / 2,
+						  -1);
 		if (ret < 0)
 			return ret;
 	}
@@ -5801,7 +6466,9 @@ int32_t ad9361_load_fir_filter_coef(struct ad9361_rf_phy *phy,
 				    uint32_t ntaps, int16_t *coef)
 {
 	struct no_os_spi_desc *spi = phy->spi;
+	struct ad9361_spi_batch batch = { 0 };
 	uint32_t val, offs = 0, fir_conf = 0, fir_enable = 0;
+	uint8_t buf[3];
 	int32_t ret;
 
 	dev_dbg(&phy->spi->dev, "%s: TAPS %"PRIu32", gain %"PRId32", dest %d",
@@ -5844,23 +6511,30 @@ int32_t ad9361_load_fir_filter_coef(struct ad9361_rf_phy *phy,
 
 	ad9361_spi_write(spi, REG_TX_FILTER_CONF + offs, fir_conf);
 
+	batch.spi = spi;
 	for (val = 0; val < ntaps; val++) {
-		ad9361_spi_write(spi, REG_TX_FILTER_COEF_ADDR + offs, val);
-		ad9361_spi_write(spi, REG_TX_FILTER_COEF_WRITE_DATA_1 + offs,
-				 coef[val] & 0xFF);
-		ad9361_spi_write(spi, REG_TX_FILTER_COEF_WRITE_DATA_2 + offs,
-				 coef[val] >> 8);
-		ad9361_spi_write(spi, REG_TX_FILTER_CONF + offs,
-				 fir_conf | FIR_WRITE);
-		ad9361_spi_write(spi, REG_TX_FILTER_COEF_READ_DATA_2 + offs, 0);
-		ad9361_spi_write(spi, REG_TX_FILTER_COEF_READ_DATA_2 + offs, 0);
-	}
-
-	ad9361_spi_write(spi, REG_TX_FILTER_CONF + offs, fir_conf);
+		/* Data 2, Data 1 and the coefficient address in one write */
+		buf[0] = coef[val] >> 8;
+		buf[1] = coef[val] & 0xFF;
+		buf[2] = val;
+		ad9361_spi_batch_writem(&batch,
+					REG_TX_FILTER_COEF_WRITE_DATA_2 + offs,
+					buf, 3);
+		ad9361_spi_batch_write(&batch, REG_TX_FILTER_CONF + offs,
+				       fir_conf | FIR_WRITE);
+		ad9361_spi_batch_write(&batch,
+				       REG_TX_FILTER_COEF_READ_DATA_2 + offs, 0);
+		ad9361_spi_batch_write(&batch,
+				       REG_TX_FILTER_COEF_READ_DATA_2 + offs, 0);
+	}
+
+	ad9361_spi_batch_write(&batch, REG_TX_FILTER_CONF + offs, fir_conf);
 	fir_conf &= ~FIR_START_CLK;
-	ad9361_spi_write(spi, REG_TX_FILTER_CONF + offs, fir_conf);
+	ad9361_spi_batch_write(&batch, REG_TX_FILTER_CONF + offs, fir_conf);
 
-	ret = ad9361_verify_fir_filter_coef(phy, dest, ntaps, coef);
+	ret = ad9361_spi_batch_flush(&batch);
+	if (!ret)
+		ret = ad9361_verify_fir_filter_coef(phy, dest, ntaps, coef);
 
 	if (dest & FIR_IS_RX)
 		ad9361_spi_writef(phy->spi, REG_RX_ENABLE_FILTER_CTRL,
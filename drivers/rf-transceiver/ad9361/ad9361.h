@@ -3240,6 +3240,14 @@ struct rf_rssi {
 	uint8_t duration;		/* Duration to be considered for measuring */
 };
 
+/* RX state sampled by ad9361_read_rx_telemetry() */
+struct ad9361_rx_telemetry {
+	uint16_t rssi[2];		/* RX1/RX2 RSSI, 0.25 dB/LSB */
+	uint8_t gain_index[2];		/* RX1/RX2 gain table index */
+	uint8_t fast_attack_state;	/* Fast attack AGC state */
+	uint8_t slow_loop_state;	/* Slow loop AGC state */
+};
+
 struct SynthLUT {
 	uint16_t VCO_MHz;
 	uint8_t VCO_Output_Level;
@@ -3310,6 +3318,55 @@ struct ad9361_fastlock {
 	struct ad9361_fastlock_entry entry[2][8];
 };
 
+#define AD9361_CAL_CACHE_SIZE		8
+#define AD9361_TX_QUAD_CORR_NUM		(REG_TX2_OUT_2_OFFSET_Q - \
+					 REG_TX1_OUT_1_PHASE_CORR + 1)
+#define AD9361_RX_QUAD_CORR_NUM		(REG_RX2_INPUT_BC_I_OFFSET - \
+					 REG_RX1_INPUT_A_PHASE_CORR + 1)
+
+struct ad9361_cal_cache_entry {
+	bool valid;
+	/* TX LO frequency / cal_threshold_freq */
+	uint32_t band;
+	uint32_t rx_bw_Hz;
+	uint32_t tx_bw_Hz;
+	uint32_t tx_atten_mdB;
+	uint32_t last_use;
+	uint32_t tx_quad_cal_phase;
+	uint8_t tx_quad_corr[AD9361_TX_QUAD_CORR_NUM];
+	uint8_t rx_quad_corr[AD9361_RX_QUAD_CORR_NUM];
+};
+
+struct ad9361_cal_cache {
+	bool enable;
+	uint32_t use_count;
+	struct ad9361_cal_cache_entry entry[AD9361_CAL_CACHE_SIZE];
+};
+
+#define AD9361_DIG_TUNE_CACHE_SIZE	8
+
+struct ad9361_dig_tune_cache_entry {
+	bool valid;
+	/* Clock configuration: BBPLL and RX/TX sample rates, FIR state */
+	uint32_t bbpll_freq;
+	uint32_t rx_sampl_freq;
+	uint32_t tx_sampl_freq;
+	bool fir_enabled;
+	uint32_t last_use;
+	/* Per direction, 0 for RX and 1 for TX */
+	bool tuned[2];
+	uint8_t clk_delay[2];
+	uint8_t data_delay[2];
+	/* Width of the passing window around the selected delay */
+	uint8_t margin[2];
+};
+
+struct ad9361_dig_tune_cache {
+	bool enable;
+	uint32_t use_count;
+	struct ad9361_dig_tune_cache_entry entry[AD9361_DIG_TUNE_CACHE_SIZE];
+};
+
 enum dig_tune_flags {
 	BE_VERBOSE = 1,
 	BE_MOREVERBOSE = 2,
@@ -3337,6 +3394,31 @@ enum dev_id {
 	ID_AD9363A
 };
 
+#define AD9361_CLK_CHAIN_CACHE_SIZE	4
+
+/*
+ * Build with -DAD9361_MCS_POLL to let ad9361_do_mcs() poll the PLL locks of
+ * each MCS step instead of sleeping 100 ms per step. A step that does not
+ * lock then fails the MCS. Without it the fixed delays are kept.
+ */
+
+/* Settle time after the MCS SYNC_IN pulses, a few REF_CLK periods */
+#define AD9361_MCS_SYNC_SETTLE_US	10
+
+/* Gains of the RX gain tables are int8_t [dB] */
+#define AD9361_GT_GAIN_IDX_SIZE		256
+
+/* Clock chain computed by ad9361_calculate_rf_clock_chain() for a rate */
+struct ad9361_clk_chain_solution {
+	uint32_t		rate;
+	uint8_t			rate_gov;
+	uint8_t			rx_intdec;
+	uint8_t			tx_intdec;
+	bool			rx_eq_2tx;
+	uint32_t		rx_path_clks[NUM_RX_CLOCKS];
+	uint32_t		tx_path_clks[NUM_TX_CLOCKS];
+};
+
 struct ad9361_rf_phy {
 	enum dev_id		dev_sel;
 	struct no_os_spi_desc 	*spi;
@@ -3365,6 +3447,10 @@ struct ad9361_rf_phy {
 	int32_t			tx_quad_lpf_tia_match;
 	uint32_t		current_table;
 	struct gain_table_info  *gt_info;
+	/* Gain table index of each gain [dB], from gt_gain_idx_min */
+	uint8_t			gt_gain_idx[AD9361_GT_GAIN_IDX_SIZE];
+	int32_t			gt_gain_idx_min;
+	uint32_t		gt_gain_idx_nb;
 	bool 			ensm_pin_ctl_en;
 
 	bool			auto_cal_en;
@@ -3377,6 +3463,8 @@ struct ad9361_rf_phy {
 	bool			current_rx_use_tdd_table;
 	uint32_t		current_rx_path_clks[NUM_RX_CLOCKS];
 	uint32_t		current_tx_path_clks[NUM_TX_CLOCKS];
+	struct ad9361_clk_chain_solution clk_chain_cache[AD9361_CLK_CHAIN_CACHE_SIZE];
+	uint8_t			clk_chain_cache_next;
 	uint32_t		flags;
 	uint32_t		cal_threshold_freq;
 	uint32_t			current_rx_bw_Hz;
@@ -3405,6 +3493,8 @@ struct ad9361_rf_phy {
 	uint32_t 			tx1_atten_cached;
 	uint32_t 			tx2_atten_cached;
 	struct ad9361_fastlock	fastlock;
+	struct ad9361_cal_cache	cal_cache;
+	struct ad9361_dig_tune_cache	dig_tune_cache;
 	struct axiadc_converter	*adc_conv;
 	struct axiadc_state		*adc_state;
 	int32_t					bist_loopback_mode;
@@ -3475,6 +3565,8 @@ int32_t ad9361_get_trx_clock_chain(struct ad9361_rf_phy *phy,
 uint32_t ad9361_to_clk(uint64_t freq);
 uint64_t ad9361_from_clk(uint32_t freq);
 int32_t ad9361_read_rssi(struct ad9361_rf_phy *phy, struct rf_rssi *rssi);
+int32_t ad9361_read_rx_telemetry(struct ad9361_rf_phy *phy,
+				 struct ad9361_rx_telemetry *telemetry);
 int32_t ad9361_set_gain_ctrl_mode(struct ad9361_rf_phy *phy,
 				  struct rf_gain_ctrl *gain_ctrl);
 int32_t ad9361_load_fir_filter_coef(struct ad9361_rf_phy *phy,
@@ -3527,8 +3619,11 @@ void ad9361_get_bist_tone(struct ad9361_rf_phy *phy,
 int32_t ad9361_rf_port_setup(struct ad9361_rf_phy *phy, bool is_out,
 			     uint32_t rx_inputs, uint32_t txb);
 int32_t ad9361_mcs(struct ad9361_rf_phy *phy, int32_t step);
+int32_t ad9361_mcs_wait(struct ad9361_rf_phy *phy, int32_t step);
 int32_t ad9361_do_calib_run(struct ad9361_rf_phy *phy, uint32_t cal,
 			    int32_t arg);
+void ad9361_cal_cache_flush(struct ad9361_rf_phy *phy);
+void ad9361_dig_tune_cache_flush(struct ad9361_rf_phy *phy);
 int32_t ad9361_fastlock_store(struct ad9361_rf_phy *phy, bool tx,
 			      uint32_t profile);
 int32_t ad9361_fastlock_recall(struct ad9361_rf_phy *phy, bool tx,
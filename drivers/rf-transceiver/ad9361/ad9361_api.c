@@ -47,6 +47,7 @@
 #include "no_os_util.h"
 #include "app_config.h"
 #include <string.h>
+#include <inttypes.h>
 #ifndef AXI_ADC_NOT_PRESENT
 #include "axi_adc_core.h"
 #include "axi_dac_core.h"
@@ -1995,7 +1996,8 @@ int32_t ad9361_set_no_ch_mode(struct ad9361_rf_phy *phy, uint8_t no_ch_mode)
 }
 
 /**
- * Do multi chip synchronization.
+ * Do multi chip synchronization. Each step is applied to both devices, then
+ * it waits 100 ms or, with AD9361_MCS_POLL, polls the locks of both.
  * @param phy_master The AD9361 Master state structure.
  * @param phy_slave The AD9361 Slave state structure.
  * @return 0 in case of success, negative error code otherwise.
@@ -2008,6 +2010,7 @@ int32_t ad9361_do_mcs(struct ad9361_rf_phy *phy_master,
 	uint32_t ensm_mode;
 	int32_t step;
 	int32_t reg;
+	int32_t ret = 0;
 
 	if ((phy_master->dev_sel == ID_AD9363A) ||
 	    (phy_slave->dev_sel == ID_AD9363A)) {
@@ -2028,13 +2031,24 @@ int32_t ad9361_do_mcs(struct ad9361_rf_phy *phy_master,
 	for (step = 0; step <= 5; step++) {
 		ad9361_mcs(phy_slave, step);
 		ad9361_mcs(phy_master, step);
+#ifndef AD9361_MCS_POLL
 		no_os_mdelay(100);
+#else
+		ret = ad9361_mcs_wait(phy_slave, step);
+		if (!ret)
+			ret = ad9361_mcs_wait(phy_master, step);
+		if (ret) {
+			printf("%s : MCS step %"PRId32" failed\n", __func__,
+			       step);
+			break;
+		}
+#endif
 	}
 
 	ad9361_set_en_state_machine_mode(phy_master, ensm_mode);
 	ad9361_set_en_state_machine_mode(phy_slave, ensm_mode);
 
-	return 0;
+	return ret;
 }
 
 /**
@@ -2217,3 +2231,220 @@ int32_t ad9361_get_temperature(struct ad9361_rf_phy *phy,
 
 	return 0;
 }
+
+/**
+ * Enable/disable the calibration cache. When enabled, the results of the
+ * automatic TX quadrature calibration are saved together with the RX
+ * quadrature correction words, keyed by TX LO band, RF bandwidths and TX
+ * attenuation. Returning to a known configuration restores the saved words
+ * instead of calibrating again. Disabling the cache drops its content.
+ * @param phy The AD9361 current state structure.
+ * @param en_dis The option (ENABLE, DISABLE).
+ * 				 Accepted values:
+ * 				  ENABLE (1)
+ * 				  DISABLE (0)
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_set_trx_cal_cache_en_dis(struct ad9361_rf_phy *phy,
+					uint8_t en_dis)
+{
+	phy->cal_cache.enable = en_dis;
+	if (!en_dis)
+		ad9361_cal_cache_flush(phy);
+
+	return 0;
+}
+
+/**
+ * Enable/disable the digital interface tuning cache. When enabled, the
+ * delays found by the tuning are saved for each clock configuration. When a
+ * sample rate change returns to a known configuration, only the saved delays
+ * are checked with the PRBS and the full delay sweep is done if they fail.
+ * Disabling the cache drops its content.
+ * @param phy The AD9361 current state structure.
+ * @param en_dis The option (ENABLE, DISABLE).
+ * 				 Accepted values:
+ * 				  ENABLE (1)
+ * 				  DISABLE (0)
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_set_dig_tune_cache_en_dis(struct ad9361_rf_phy *phy,
+		uint8_t en_dis)
+{
+	phy->dig_tune_cache.enable = en_dis;
+	if (!en_dis)
+		ad9361_dig_tune_cache_flush(phy);
+
+	return 0;
+}
+/**
+ * Calibrate the channels of a frequency hopping table and cache their
+ * fastlock profiles. The synthesizer is tuned, with VCO calibration, once for
+ * each channel and the first 8 channels are loaded in the fastlock slots.
+ * @param table The hopping table.
+ * @param phy The AD9361 current state structure.
+ * @param tx true for the TX synthesizer, false for the RX one.
+ * @param lo_freq_hz The LO frequency of each channel (Hz).
+ * @param nb_channels The number of channels.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_hop_table_init(struct ad9361_hop_table **table,
+			      struct ad9361_rf_phy *phy, bool tx,
+			      const uint64_t *lo_freq_hz, uint32_t nb_channels)
+{
+	struct ad9361_hop_table *t;
+	uint32_t i, slot;
+	int32_t ret;
+
+	if (!table || !phy || !lo_freq_hz || !nb_channels)
+		return -EINVAL;
+
+	t = calloc(1, sizeof(*t));
+	if (!t)
+		return -ENOMEM;
+
+	t->channels = calloc(nb_channels, sizeof(*t->channels));
+	if (!t->channels) {
+		ret = -ENOMEM;
+		goto error;
+	}
+
+	t->phy = phy;
+	t->tx = tx;
+	t->nb_channels = nb_channels;
+	for (i = 0; i < NO_OS_ARRAY_SIZE(t->slot_channel); i++)
+		t->slot_channel[i] = -1;
+
+	for (i = 0; i < nb_channels; i++) {
+		if (tx)
+			ret = ad9361_set_tx_lo_freq(phy, lo_freq_hz[i]);
+		else
+			ret = ad9361_set_rx_lo_freq(phy, lo_freq_hz[i]);
+		if (ret < 0)
+			goto error;
+
+		/* Read back the locked synthesizer settings via slot 0 */
+		ret = ad9361_fastlock_store(phy, tx, 0);
+		if (ret < 0)
+			goto error;
+
+		ret = ad9361_fastlock_save(phy, tx, 0, t->channels[i].values);
+		if (ret < 0)
+			goto error;
+
+		t->channels[i].lo_freq_hz = lo_freq_hz[i];
+		t->channels[i].slot = -1;
+	}
+
+	for (i = 0; i < nb_channels && i < NO_OS_ARRAY_SIZE(t->slot_channel);
+	     i++) {
+		ret = ad9361_hop_table_load(t, i, &slot);
+		if (ret < 0)
+			goto error;
+	}
+
+	*table = t;
+
+	return 0;
+error:
+	free(t->channels);
+	free(t);
+
+	return ret;
+}
+
+/**
+ * Free the resources allocated by ad9361_hop_table_init(). The synthesizer
+ * stays on the last channel until it is tuned again.
+ * @param table The hopping table.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_hop_table_remove(struct ad9361_hop_table *table)
+{
+	if (!table)
+		return -EINVAL;
+
+	free(table->channels);
+	free(table);
+
+	return 0;
+}
+
+/**
+ * Make sure a channel is loaded in a fastlock slot, replacing the least
+ * recently used channel if needed. The slot in use is never replaced.
+ * Loading the next channel ahead of time leaves only the profile switch for
+ * the hop. In fastlock pin select mode, the returned slot is the profile to
+ * select on the control pins, after a first ad9361_hop() enabled the mode.
+ * @param table The hopping table.
+ * @param channel The channel index.
+ * @param slot The fastlock slot holding the channel.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_hop_table_load(struct ad9361_hop_table *table,
+			      uint32_t channel, uint32_t *slot)
+{
+	struct ad9361_hop_channel *ch;
+	int32_t current, victim = -1;
+	uint32_t i, last_use, oldest = 0;
+	int32_t ret;
+
+	if (!table || !slot || channel >= table->nb_channels)
+		return -EINVAL;
+
+	ch = &table->channels[channel];
+	if (ch->slot >= 0) {
+		*slot = ch->slot;
+		return 0;
+	}
+
+	current = (int32_t)table->phy->fastlock.current_profile[table->tx] - 1;
+	for (i = 0; i < NO_OS_ARRAY_SIZE(table->slot_channel); i++) {
+		if (table->slot_channel[i] < 0) {
+			victim = i;
+			break;
+		}
+
+		if ((int32_t)i == current)
+			continue;
+
+		last_use = table->channels[table->slot_channel[i]].last_use;
+		if (victim < 0 || last_use < oldest) {
+			victim = i;
+			oldest = last_use;
+		}
+	}
+
+	ret = ad9361_fastlock_load(table->phy, table->tx, victim, ch->values);
+	if (ret < 0)
+		return ret;
+
+	if (table->slot_channel[victim] >= 0)
+		table->channels[table->slot_channel[victim]].slot = -1;
+	table->slot_channel[victim] = channel;
+	ch->slot = victim;
+	*slot = victim;
+
+	return 0;
+}
+
+/**
+ * Hop to a channel of the table using its fastlock profile, without VCO
+ * calibration. The channel is loaded first if it is not in a fastlock slot.
+ * @param table The hopping table.
+ * @param channel The channel index.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_hop(struct ad9361_hop_table *table, uint32_t channel)
+{
+	uint32_t slot;
+	int32_t ret;
+
+	ret = ad9361_hop_table_load(table, channel, &slot);
+	if (ret < 0)
+		return ret;
+
+	table->channels[channel].last_use = ++table->use_count;
+
+	return ad9361_fastlock_recall(table->phy, table->tx, slot);
+}
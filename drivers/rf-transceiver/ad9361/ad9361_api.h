@@ -328,6 +328,27 @@ enum ad9361_ensm_mode {
 	ENSM_MODE_PINCTRL_FDD_INDEP,
 };
 
+/* Fastlock profile of a frequency hopping channel */
+struct ad9361_hop_channel {
+	uint64_t	lo_freq_hz;
+	/* Synthesizer settings, as read by ad9361_fastlock_save() */
+	uint8_t		values[RX_FAST_LOCK_CONFIG_WORD_NUM];
+	/* Fastlock slot holding the channel, -1 if not loaded */
+	int8_t		slot;
+	uint32_t	last_use;
+};
+
+/* Frequency hopping table rotating N channels through the 8 fastlock slots */
+struct ad9361_hop_table {
+	struct ad9361_rf_phy		*phy;
+	bool				tx;
+	uint32_t			nb_channels;
+	struct ad9361_hop_channel	*channels;
+	/* Channel loaded in each fastlock slot, -1 if none */
+	int32_t				slot_channel[8];
+	uint32_t			use_count;
+};
+
 #define ENABLE		1
 #define DISABLE		0
 
@@ -552,4 +573,21 @@ int32_t ad9361_do_dcxo_tune_fine(struct ad9361_rf_phy *phy,
 /* Get the temperature. */
 int32_t ad9361_get_temperature(struct ad9361_rf_phy *phy,
 			       int32_t *temp);
+/* Enable/disable the calibration cache. */
+int32_t ad9361_set_trx_cal_cache_en_dis(struct ad9361_rf_phy *phy,
+					uint8_t en_dis);
+/* Enable/disable the digital interface tuning cache. */
+int32_t ad9361_set_dig_tune_cache_en_dis(struct ad9361_rf_phy *phy,
+		uint8_t en_dis);
+/* Calibrate the hopping channels and cache their fastlock profiles. */
+int32_t ad9361_hop_table_init(struct ad9361_hop_table **table,
+			      struct ad9361_rf_phy *phy, bool tx,
+			      const uint64_t *lo_freq_hz, uint32_t nb_channels);
+/* Free the resources allocated by ad9361_hop_table_init(). */
+int32_t ad9361_hop_table_remove(struct ad9361_hop_table *table);
+/* Make sure a channel is loaded in a fastlock slot. */
+int32_t ad9361_hop_table_load(struct ad9361_hop_table *table,
+			      uint32_t channel, uint32_t *slot);
+/* Hop to a channel of the table. */
+int32_t ad9361_hop(struct ad9361_hop_table *table, uint32_t channel);
 #endif
@@ -347,6 +347,52 @@ int32_t ad9361_dig_interface_timing_analysis(struct ad9361_rf_phy *phy,
 	return len;
 }
 
+/**
+ * Get the digital tuning cache entry of the current clock configuration,
+ * replacing the least recently used entry if it was not tuned before.
+ * @param phy The AD9361 state structure.
+ * @return The entry.
+ */
+static struct ad9361_dig_tune_cache_entry *ad9361_dig_tune_cache_get(
+	struct ad9361_rf_phy *phy)
+{
+	struct ad9361_dig_tune_cache *cache = &phy->dig_tune_cache;
+	struct ad9361_dig_tune_cache_entry key = { 0 }, *e;
+	uint32_t i;
+
+	key.bbpll_freq = phy->current_rx_path_clks[BBPLL_FREQ];
+	key.rx_sampl_freq = phy->current_rx_path_clks[RX_SAMPL_FREQ];
+	key.tx_sampl_freq = phy->current_tx_path_clks[RX_SAMPL_FREQ];
+	key.fir_enabled = !(phy->bypass_rx_fir && phy->bypass_tx_fir);
+
+	for (i = 0; i < AD9361_DIG_TUNE_CACHE_SIZE; i++) {
+		e = &cache->entry[i];
+		if (e->valid && e->bbpll_freq == key.bbpll_freq &&
+		    e->rx_sampl_freq == key.rx_sampl_freq &&
+		    e->tx_sampl_freq == key.tx_sampl_freq &&
+		    e->fir_enabled == key.fir_enabled) {
+			e->last_use = ++cache->use_count;
+			return e;
+		}
+	}
+
+	e = &cache->entry[0];
+	for (i = 0; i < AD9361_DIG_TUNE_CACHE_SIZE; i++) {
+		if (!cache->entry[i].valid) {
+			e = &cache->entry[i];
+			break;
+		}
+		if (cache->entry[i].last_use < e->last_use)
+			e = &cache->entry[i];
+	}
+
+	*e = key;
+	e->valid = true;
+	e->last_use = ++cache->use_count;
+
+	return e;
+}
+
 /**
  * Digital tune delay.
  * @param phy The AD9361 state structure.
@@ -359,11 +405,29 @@ static int32_t ad9361_dig_tune_delay(struct ad9361_rf_phy *phy,
 				     uint32_t max_freq, enum dig_tune_flags flags, bool tx)
 {
 	static const uint32_t rates[3] = {25000000U, 40000000U, 61440000U};
+	struct ad9361_dig_tune_cache_entry *e = NULL;
 	uint32_t s0, s1, c0, c1;
 	uint32_t i, j, r;
 	bool half_data_rate;
 	uint8_t field[2][16];
 
+	/* Retune after a rate change: first check the delays found before */
+	if (!max_freq && phy->dig_tune_cache.enable) {
+		e = ad9361_dig_tune_cache_get(phy);
+		if (e->tuned[tx]) {
+			ad9361_set_intf_delay(phy, tx, e->clk_delay[tx],
+					      e->data_delay[tx], true);
+			if (!ad9361_check_pn(phy, tx, 4)) {
+				dev_dbg(&phy->spi->dev,
+					"%s: %s cached delays ok, margin %d",
+					__func__, tx ? "TX" : "RX",
+					e->margin[tx]);
+				return 0;
+			}
+			e->tuned[tx] = false;
+		}
+	}
+
 	if (((phy->pdata->port_ctrl.pp_conf[2] & LVDS_MODE) ||
 	     !phy->pdata->rx2tx2))
 		half_data_rate = false;
@@ -413,6 +477,13 @@ static int32_t ad9361_dig_tune_delay(struct ad9361_rf_phy *phy,
 	else
 		ad9361_set_intf_delay(phy, tx, 0, s0 + c0 / 2, true);
 
+	if (e) {
+		e->tuned[tx] = true;
+		e->clk_delay[tx] = c1 > c0 ? s1 + c1 / 2 : 0;
+		e->data_delay[tx] = c1 > c0 ? 0 : s0 + c0 / 2;
+		e->margin[tx] = c1 > c0 ? c1 : c0;
+	}
+
 	return 0;
 }
 
@@ -1920,6 +1920,7 @@ struct iio_attribute voltage_output_attributes[] = {
 		.name = "sampling_frequency",
 		.show = get_sampling_frequency,
 		.store = set_sampling_frequency,
+		.cache_ms = IIO_ATTR_CACHE_UNTIL_WRITE,
 	},
 	{
 		.name = "rf_bandwidth_available",
@@ -1930,6 +1931,7 @@ struct iio_attribute voltage_output_attributes[] = {
 		.name = "rf_bandwidth",
 		.show = get_rf_bandwidth,
 		.store = set_rf_bandwidth,
+		.cache_ms = IIO_ATTR_CACHE_UNTIL_WRITE,
 	},
 	END_ATTRIBUTES_ARRAY
 };
@@ -1969,6 +1971,7 @@ struct iio_attribute voltage_input_attributes[] = {
 		.name = "rf_bandwidth",
 		.show = get_rf_bandwidth,
 		.store = set_rf_bandwidth,
+		.cache_ms = IIO_ATTR_CACHE_UNTIL_WRITE,
 	},
 	{
 		.name = "rf_dc_offset_tracking_en",
@@ -1989,6 +1992,7 @@ struct iio_attribute voltage_input_attributes[] = {
 		.name = "sampling_frequency",
 		.show = get_sampling_frequency,
 		.store = set_sampling_frequency,
+		.cache_ms = IIO_ATTR_CACHE_UNTIL_WRITE,
 	},
 	{
 		.name = "gain_control_mode_available",
@@ -2230,6 +2234,135 @@ static struct iio_channel iio_ad9361_channels[] = {
 	AD9361_OUT(),
 };
 
+static struct scan_type telemetry_scan_type = {
+	.sign = 'u',
+	.realbits = 16,
+	.storagebits = 16,
+	.shift = 0,
+	.is_big_endian = false,
+};
+
+#define AD9361_TELEMETRY(_idx, _name) {\
+	.name = _name,\
+	.ch_out = false,\
+	.scan_type = &telemetry_scan_type,\
+	.scan_index = _idx,\
+	.indexed = true,\
+	.channel = _idx,\
+	.ch_type = IIO_VOLTAGE,\
+}
+
+static struct iio_channel iio_ad9361_telemetry_channels[] = {
+	AD9361_TELEMETRY(0, "rssi0"),
+	AD9361_TELEMETRY(1, "rssi1"),
+	AD9361_TELEMETRY(2, "gain_index0"),
+	AD9361_TELEMETRY(3, "gain_index1"),
+	AD9361_TELEMETRY(4, "agc_state"),
+};
+
+/**
+ * @brief Sample the RX telemetry and push a scan of the enabled channels.
+ * @param dev_data - Device data, the instance is the ad9361_rf_phy.
+ * @return 0 in case of success, negative value otherwise.
+ */
+static int32_t iio_ad9361_telemetry_trigger_handler(struct iio_device_data
+		*dev_data)
+{
+	struct ad9361_rx_telemetry telemetry;
+	uint16_t scan[NO_OS_ARRAY_SIZE(iio_ad9361_telemetry_channels)];
+	uint16_t data[NO_OS_ARRAY_SIZE(iio_ad9361_telemetry_channels)];
+	uint32_t i, n = 0;
+	int32_t ret;
+
+	if (!dev_data || !dev_data->buffer)
+		return -EINVAL;
+
+	ret = ad9361_read_rx_telemetry(dev_data->dev, &telemetry);
+	if (ret < 0)
+		return ret;
+
+	data[0] = telemetry.rssi[0];
+	data[1] = telemetry.rssi[1];
+	data[2] = telemetry.gain_index[0];
+	data[3] = telemetry.gain_index[1];
+	data[4] = telemetry.fast_attack_state |
+		  (telemetry.slow_loop_state << 8);
+
+	for (i = 0; i < NO_OS_ARRAY_SIZE(data); i++)
+		if (dev_data->buffer->active_mask & NO_OS_BIT(i))
+			scan[n++] = data[i];
+
+	return iio_buffer_push_scan(dev_data->buffer, scan);
+}
+
+/**
+ * @brief Read a register, for direct_reg_access.
+ * @param device - Physical instance of a ad9361 device.
+ * @param reg - Register address.
+ * @param readval - Register value.
+ * @return 0 in case of success, negative value on failure.
+ */
+static int32_t iio_ad9361_reg_read(void *device, uint32_t reg,
+				   uint32_t *readval)
+{
+	struct ad9361_rf_phy *ad9361_phy = (struct ad9361_rf_phy *)device;
+	int32_t ret;
+
+	ret = ad9361_spi_read(ad9361_phy->spi, reg);
+	if (ret < 0)
+		return ret;
+
+	*readval = ret;
+
+	return 0;
+}
+
+/**
+ * @brief Write a register, for direct_reg_access.
+ * @param device - Physical instance of a ad9361 device.
+ * @param reg - Register address.
+ * @param writeval - Register value.
+ * @return 0 in case of success, negative value on failure.
+ */
+static int32_t iio_ad9361_reg_write(void *device, uint32_t reg,
+				    uint32_t writeval)
+{
+	struct ad9361_rf_phy *ad9361_phy = (struct ad9361_rf_phy *)device;
+
+	return ad9361_spi_write(ad9361_phy->spi, reg, writeval);
+}
+
+/**
+ * @brief Read consecutive registers, for direct_reg_bulk. The multibyte
+ * reads of the part go from the address sent down, up to MAX_MBYTE_SPI
+ * registers are read from the last one of each burst.
+ * @param device - Physical instance of a ad9361 device.
+ * @param reg - First register address.
+ * @param readval - Register values.
+ * @param nb_regs - Number of registers.
+ * @return 0 in case of success, negative value on failure.
+ */
+static int32_t iio_ad9361_reg_read_bulk(void *device, uint32_t reg,
+					uint32_t *readval, uint32_t nb_regs)
+{
+	struct ad9361_rf_phy *ad9361_phy = (struct ad9361_rf_phy *)device;
+	uint8_t buf[MAX_MBYTE_SPI];
+	uint32_t i, n;
+	int32_t ret;
+
+	for (; nb_regs; nb_regs -= n, reg += n, readval += n) {
+		n = no_os_min(nb_regs, MAX_MBYTE_SPI);
+		ret = ad9361_spi_readm(ad9361_phy->spi, reg + n - 1, buf, n);
+		if (ret < 0)
+			return ret;
+
+		for (i = 0; i < n; i++)
+			readval[i] = buf[n - 1 - i];
+	}
+
+	return 0;
+}
+
 /**
  * @brief Get iio device descriptor.
  * @param desc - Descriptor.
@@ -2241,6 +2374,17 @@ void iio_ad9361_get_dev_descriptor(struct iio_ad9361_desc *desc,
 	*dev_descriptor = &desc->dev_descriptor;
 }
 
+/**
+ * @brief Get the iio descriptor of the RX telemetry device.
+ * @param desc - Descriptor.
+ * @param dev_descriptor - iio device descriptor.
+ */
+void iio_ad9361_get_telemetry_descriptor(struct iio_ad9361_desc *desc,
+		struct iio_device **dev_descriptor)
+{
+	*dev_descriptor = &desc->telemetry_descriptor;
+}
+
 /**
  * @brief Init for reading/writing and parameterization of a
  * ad9361 device.
@@ -2263,6 +2407,18 @@ int32_t iio_ad9361_init(struct iio_ad9361_desc **desc,
 	iio_ad9361_inst->dev_descriptor.attributes = global_attributes;
 	iio_ad9361_inst->dev_descriptor.debug_attributes = NULL;
 	iio_ad9361_inst->dev_descriptor.buffer_attributes = NULL;
+	iio_ad9361_inst->dev_descriptor.debug_reg_read = iio_ad9361_reg_read;
+	iio_ad9361_inst->dev_descriptor.debug_reg_write = iio_ad9361_reg_write;
+	iio_ad9361_inst->dev_descriptor.debug_reg_read_bulk =
+		iio_ad9361_reg_read_bulk;
+
+	iio_ad9361_inst->telemetry_descriptor.num_ch =
+		NO_OS_ARRAY_SIZE(iio_ad9361_telemetry_channels);
+	iio_ad9361_inst->telemetry_descriptor.channels =
+		iio_ad9361_telemetry_channels;
+	iio_ad9361_inst->telemetry_descriptor.trigger_handler =
+		iio_ad9361_telemetry_trigger_handler;
+	iio_ad9361_inst->telemetry_descriptor.lock_free_buffer = true;
 	*desc = iio_ad9361_inst;
 
 	return 0;
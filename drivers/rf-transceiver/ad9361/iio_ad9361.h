@@ -68,6 +68,8 @@ struct iio_ad9361_init_param {
 struct iio_ad9361_desc {
 	/** iio device descriptor */
 	struct iio_device dev_descriptor;
+	/** iio descriptor of the RX telemetry device */
+	struct iio_device telemetry_descriptor;
 };
 
 /******************************************************************************/
@@ -80,6 +82,14 @@ int32_t iio_ad9361_init(struct iio_ad9361_desc **desc,
 /* Get desciptor. */
 void iio_ad9361_get_dev_descriptor(struct iio_ad9361_desc *desc,
 				   struct iio_device **dev_descriptor);
+/*
+ * Get the descriptor of the RX telemetry device, streaming RSSI, gain index
+ * and AGC state scans. Its instance is the ad9361_rf_phy. Scans are sampled
+ * on trigger, typically an iio_hw_trig on the interrupt of a periodic timer,
+ * and stored in a lock-free buffer read by iiod.
+ */
+void iio_ad9361_get_telemetry_descriptor(struct iio_ad9361_desc *desc,
+		struct iio_device **dev_descriptor);
 /* Free the resources allocated by iio_ad9361_init(). */
 int32_t iio_ad9361_remove(struct iio_ad9361_desc *desc);
 
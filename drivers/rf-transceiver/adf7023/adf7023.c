@@ -41,8 +41,10 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdlib.h>
+#include <string.h>
 #include "adf7023_config.h"
 #include "adf7023.h"
+#include "no_os_error.h"
 
 /******************************************************************************/
 /*************************** Macros Definitions *******************************/
@@ -52,6 +54,9 @@
 #define ADF7023_CS_DEASSERT no_os_gpio_set_value(dev->gpio_cs,  \
 			    NO_OS_GPIO_HIGH)
 
+/* Bytes sent per SPI transfer by adf7023_set_ram() */
+#define ADF7023_RAM_CHUNK   32
+
 /******************************************************************************/
 /************************ Variables Definitions *******************************/
 /******************************************************************************/
@@ -112,6 +117,12 @@ int32_t adf7023_init(struct adf7023_dev **device,
 	ret |= no_os_gpio_get(&dev->gpio_miso, &init_param.gpio_miso);
 
 	dev->adf7023_bbram_current = adf7023_bbram_default;
+	dev->irq_ctrl = init_param.irq_ctrl;
+	dev->irq_num = init_param.irq_num;
+	dev->rx_head = 0;
+	dev->rx_tail = 0;
+	dev->rx_overruns = 0;
+	dev->tx_busy = 0;
 
 	if (dev->gpio_cs)
 		ret |= no_os_gpio_direction_output(dev->gpio_cs,
@@ -238,13 +249,17 @@ void adf7023_get_ram(struct adf7023_dev *dev,
 		     uint32_t length,
 		     uint8_t* data)
 {
+	uint8_t cmd[3];
+
+	cmd[0] = SPI_MEM_RD | ((address & 0x700) >> 8);
+	cmd[1] = address & 0xFF;
+	cmd[2] = SPI_NOP;
+	/* The NOPs are clocked out of data, replaced by the RAM content */
+	memset(data, SPI_NOP, length);
+
 	ADF7023_CS_ASSERT;
-	adf7023_write_read_byte(dev, SPI_MEM_RD | ((address & 0x700) >> 8), 0);
-	adf7023_write_read_byte(dev, address & 0xFF, 0);
-	adf7023_write_read_byte(dev, SPI_NOP, 0);
-	while(length--) {
-		adf7023_write_read_byte(dev, SPI_NOP, data++);
-	}
+	no_os_spi_write_and_read(dev->spi_desc, cmd, sizeof(cmd));
+	no_os_spi_write_and_read(dev->spi_desc, data, length);
 	ADF7023_CS_DEASSERT;
 }
 
@@ -263,11 +278,21 @@ void adf7023_set_ram(struct adf7023_dev *dev,
 		     uint32_t length,
 		     uint8_t* data)
 {
+	uint8_t buf[ADF7023_RAM_CHUNK];
+	uint32_t chunk;
+
+	buf[0] = SPI_MEM_WR | ((address & 0x700) >> 8);
+	buf[1] = address & 0xFF;
+
 	ADF7023_CS_ASSERT;
-	adf7023_write_read_byte(dev, SPI_MEM_WR | ((address & 0x700) >> 8), 0);
-	adf7023_write_read_byte(dev, address & 0xFF, 0);
-	while(length--) {
-		adf7023_write_read_byte(dev, *(data++), 0);
+	no_os_spi_write_and_read(dev->spi_desc, buf, 2);
+	/* Copied, as the transfer overwrites the buffer with the read bytes */
+	while (length) {
+		chunk = length < ADF7023_RAM_CHUNK ? length : ADF7023_RAM_CHUNK;
+		memcpy(buf, data, chunk);
+		no_os_spi_write_and_read(dev->spi_desc, buf, chunk);
+		data += chunk;
+		length -= chunk;
 	}
 	ADF7023_CS_DEASSERT;
 }
@@ -392,3 +417,245 @@ void adf7023_set_frequency_deviation(struct adf7023_dev *dev,
 	adf7023_set_fw_state(dev, FW_STATE_PHY_OFF);
 	adf7023_set_command(dev, CMD_CONFIG_DEV);
 }
+
+/***************************************************************************//**
+ * @brief Reads a received packet from the RX area of the packet RAM in a
+ *        single SPI transfer, the payload length being taken from the first
+ *        byte as it is read.
+ *
+ * @param dev    - The device structure.
+ * @param packet - Where to store the length and payload.
+ *
+ * @return 0 in case of success, -EBADMSG if the length byte is invalid.
+*******************************************************************************/
+static int32_t adf7023_read_rx_packet(struct adf7023_dev *dev,
+				      struct adf7023_rx_packet *packet)
+{
+	uint8_t buf[3 + ADF7023_PKT_HDR_LEN];
+	int32_t ret = 0;
+	uint8_t length;
+
+	buf[0] = SPI_MEM_RD | ((ADF7023_PKT_RX_BASE_ADR & 0x700) >> 8);
+	buf[1] = ADF7023_PKT_RX_BASE_ADR & 0xFF;
+	buf[2] = SPI_NOP;
+	/* Length and address bytes */
+	buf[3] = SPI_NOP;
+	buf[4] = SPI_NOP;
+
+	ADF7023_CS_ASSERT;
+	no_os_spi_write_and_read(dev->spi_desc, buf, 3 + ADF7023_PKT_HDR_LEN);
+	length = buf[3];
+	if (length < ADF7023_PKT_HDR_LEN || length > ADF7023_PKT_MAX_LEN) {
+		ret = -EBADMSG;
+	} else {
+		packet->length = length - ADF7023_PKT_HDR_LEN;
+		memset(packet->data, SPI_NOP, packet->length);
+		no_os_spi_write_and_read(dev->spi_desc, packet->data,
+					 packet->length);
+	}
+	ADF7023_CS_DEASSERT;
+
+	return ret;
+}
+
+/***************************************************************************//**
+ * @brief IRQ_GP3 handler of the packet engine. A received packet is copied
+ *        to the RX queue and the radio goes back to receive at once, so the
+ *        next packet can arrive while the application processes this one.
+ *
+ * @param ctx - The device structure.
+ *
+ * @return None.
+*******************************************************************************/
+static void adf7023_irq_handler(void *ctx)
+{
+	struct adf7023_dev *dev = ctx;
+	uint8_t source[2];
+	uint8_t next;
+
+	/* Interrupt sources 0 and 1, cleared by writing them back */
+	adf7023_get_ram(dev, MCR_REG_INTERRUPT_SOURCE_0, 2, source);
+	adf7023_set_ram(dev, MCR_REG_INTERRUPT_SOURCE_0, 2, source);
+
+	if (source[0] & BBRAM_INTERRUPT_MASK_0_INTERRUPT_TX_EOF)
+		/* The radio turns around to PHY_RX by itself */
+		dev->tx_busy = 0;
+
+	if (!(source[0] & BBRAM_INTERRUPT_MASK_0_INTERRUPT_CRC_CORRECT))
+		return;
+
+	next = (dev->rx_head + 1) % ADF7023_RX_QUEUE_SIZE;
+	if (next == dev->rx_tail)
+		dev->rx_overruns++;
+	else if (!adf7023_read_rx_packet(dev, &dev->rx_queue[dev->rx_head]))
+		dev->rx_head = next;
+
+	adf7023_set_command(dev, CMD_PHY_RX);
+}
+
+/***************************************************************************//**
+ * @brief Starts the interrupt driven packet engine. The packet RAM is split
+ *        in a TX and an RX area, so a packet can be loaded for transmission
+ *        without waiting for the receiver, and the radio is left in PHY_RX.
+ *        The engine limits packets to ADF7023_PKT_MAX_PAYLOAD bytes of
+ *        payload.
+ *
+ * @param dev - The device structure, initialized with an irq_ctrl.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+int32_t adf7023_pkt_start(struct adf7023_dev *dev)
+{
+	struct adf7023_bbram *bbram;
+	int32_t ret;
+
+	if (!dev || !dev->irq_ctrl)
+		return -EINVAL;
+
+	bbram = &dev->adf7023_bbram_current;
+	bbram->interrupt_mask0 |= BBRAM_INTERRUPT_MASK_0_INTERRUPT_TX_EOF |
+				  BBRAM_INTERRUPT_MASK_0_INTERRUPT_CRC_CORRECT;
+	bbram->mode_control |= BBRAM_MODE_CONTROL_TX_TO_RX_AUTO_TURNAROUND;
+	bbram->tx_base_adr = ADF7023_PKT_TX_BASE_ADR;
+	bbram->rx_base_adr = ADF7023_PKT_RX_BASE_ADR;
+	bbram->packet_length_max = ADF7023_PKT_MAX_LEN;
+
+	adf7023_set_fw_state(dev, FW_STATE_PHY_OFF);
+	adf7023_set_ram(dev, 0x100, 64, (uint8_t*)bbram);
+	adf7023_set_command(dev, CMD_CONFIG_DEV);
+
+	dev->rx_head = 0;
+	dev->rx_tail = 0;
+	dev->rx_overruns = 0;
+	dev->tx_busy = 0;
+	dev->irq_cb = (struct no_os_callback_desc) {
+		.callback = adf7023_irq_handler,
+		.ctx = dev,
+		.event = NO_OS_EVT_GPIO,
+		.peripheral = NO_OS_GPIO_IRQ
+	};
+
+	ret = no_os_irq_register_callback(dev->irq_ctrl, dev->irq_num,
+					  &dev->irq_cb);
+	if (ret)
+		return ret;
+
+	ret = no_os_irq_trigger_level_set(dev->irq_ctrl, dev->irq_num,
+					  NO_OS_IRQ_EDGE_RISING);
+	if (ret)
+		goto error_irq;
+
+	ret = no_os_irq_enable(dev->irq_ctrl, dev->irq_num);
+	if (ret)
+		goto error_irq;
+
+	adf7023_set_fw_state(dev, FW_STATE_PHY_ON);
+	adf7023_set_fw_state(dev, FW_STATE_PHY_RX);
+
+	return 0;
+
+error_irq:
+	no_os_irq_unregister_callback(dev->irq_ctrl, dev->irq_num,
+				      &dev->irq_cb);
+
+	return ret;
+}
+
+/***************************************************************************//**
+ * @brief Stops the packet engine, the radio is left in PHY_ON.
+ *
+ * @param dev - The device structure.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+int32_t adf7023_pkt_stop(struct adf7023_dev *dev)
+{
+	int32_t ret;
+
+	if (!dev || !dev->irq_ctrl)
+		return -EINVAL;
+
+	ret = no_os_irq_disable(dev->irq_ctrl, dev->irq_num);
+	if (ret)
+		return ret;
+
+	ret = no_os_irq_unregister_callback(dev->irq_ctrl, dev->irq_num,
+					    &dev->irq_cb);
+	if (ret)
+		return ret;
+
+	adf7023_set_fw_state(dev, FW_STATE_PHY_ON);
+	dev->tx_busy = 0;
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Gets the oldest packet of the RX queue of the packet engine.
+ *
+ * @param dev    - The device structure.
+ * @param packet - Payload buffer, of ADF7023_PKT_MAX_PAYLOAD bytes.
+ * @param length - Payload length.
+ *
+ * @return 0 in case of success, -EAGAIN if no packet was received.
+*******************************************************************************/
+int32_t adf7023_pkt_receive(struct adf7023_dev *dev,
+			    uint8_t* packet,
+			    uint8_t* length)
+{
+	struct adf7023_rx_packet *rx;
+
+	if (dev->rx_tail == dev->rx_head)
+		return -EAGAIN;
+
+	rx = &dev->rx_queue[dev->rx_tail];
+	memcpy(packet, rx->data, rx->length);
+	*length = rx->length;
+	dev->rx_tail = (dev->rx_tail + 1) % ADF7023_RX_QUEUE_SIZE;
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Loads a packet in the TX area of the packet RAM and starts its
+ *        transmission, without waiting for it to end. The radio goes back
+ *        to receive after the packet is sent.
+ *
+ * @param dev    - The device structure.
+ * @param packet - Payload.
+ * @param length - Payload length, at most ADF7023_PKT_MAX_PAYLOAD.
+ *
+ * @return 0 in case of success, -EBUSY if the previous packet is still being
+ *         sent, other negative error code otherwise. The packet engine must
+ *         be started.
+*******************************************************************************/
+int32_t adf7023_pkt_transmit(struct adf7023_dev *dev,
+			     uint8_t* packet,
+			     uint8_t length)
+{
+	uint8_t header[ADF7023_PKT_HDR_LEN];
+	int32_t ret;
+
+	if (length > ADF7023_PKT_MAX_PAYLOAD)
+		return -EINVAL;
+
+	if (dev->tx_busy)
+		return -EBUSY;
+
+	/* The handler must not access the SPI in the middle of the load */
+	ret = no_os_irq_disable(dev->irq_ctrl, dev->irq_num);
+	if (ret)
+		return ret;
+
+	header[0] = ADF7023_PKT_HDR_LEN + length;
+	header[1] = dev->adf7023_bbram_current.address_match_offset;
+	adf7023_set_ram(dev, ADF7023_PKT_TX_BASE_ADR, ADF7023_PKT_HDR_LEN,
+			header);
+	adf7023_set_ram(dev, ADF7023_PKT_TX_BASE_ADR + ADF7023_PKT_HDR_LEN,
+			length, packet);
+
+	dev->tx_busy = 1;
+	adf7023_set_command(dev, CMD_PHY_TX);
+
+	return no_os_irq_enable(dev->irq_ctrl, dev->irq_num);
+}
@@ -45,6 +45,7 @@
 #include <stdint.h>
 #include "no_os_spi.h"
 #include "no_os_gpio.h"
+#include "no_os_irq.h"
 
 /* Status Word */
 #define STATUS_SPI_READY  (0x1 << 7)
@@ -369,18 +370,46 @@ struct adf7023_bbram {
 #define ADF7023_TX_BASE_ADR 0x10
 #define ADF7023_RX_BASE_ADR 0x10
 
+/* Packet RAM split between TX and RX by the packet engine */
+#define ADF7023_PKT_TX_BASE_ADR 0x10
+#define ADF7023_PKT_RX_BASE_ADR 0x88
+/* Size of each area, from its base address, header included */
+#define ADF7023_PKT_MAX_LEN     0x78
+/* Length and address bytes before the payload */
+#define ADF7023_PKT_HDR_LEN     2
+#define ADF7023_PKT_MAX_PAYLOAD (ADF7023_PKT_MAX_LEN - ADF7023_PKT_HDR_LEN)
+/* Packets received and not yet read by adf7023_pkt_receive() */
+#define ADF7023_RX_QUEUE_SIZE   4
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
 
+struct adf7023_rx_packet {
+	/* Payload length */
+	uint8_t length;
+	/* Payload */
+	uint8_t data[ADF7023_PKT_MAX_PAYLOAD];
+};
+
 struct adf7023_dev {
 	/* SPI */
 	struct no_os_spi_desc		*spi_desc;
 	/* GPIO */
 	struct no_os_gpio_desc	*gpio_cs;
 	struct no_os_gpio_desc	*gpio_miso;
+	/* IRQ */
+	struct no_os_irq_ctrl_desc	*irq_ctrl;
+	uint32_t			irq_num;
+	struct no_os_callback_desc	irq_cb;
 	/* Device Settings */
 	struct adf7023_bbram	adf7023_bbram_current;
+	/* Packet engine */
+	struct adf7023_rx_packet	rx_queue[ADF7023_RX_QUEUE_SIZE];
+	volatile uint8_t		rx_head;
+	volatile uint8_t		rx_tail;
+	uint32_t			rx_overruns;
+	volatile uint8_t		tx_busy;
 };
 
 struct adf7023_init_param {
@@ -389,6 +418,9 @@ struct adf7023_init_param {
 	/* GPIO */
 	struct no_os_gpio_init_param	gpio_cs;
 	struct no_os_gpio_init_param	gpio_miso;
+	/* IRQ controller and line of the IRQ_GP3 pin, for the packet engine */
+	struct no_os_irq_ctrl_desc	*irq_ctrl;
+	uint32_t			irq_num;
 };
 
 /******************************************************************************/
@@ -448,4 +480,20 @@ void adf7023_set_data_rate(struct adf7023_dev *dev,
 void adf7023_set_frequency_deviation(struct adf7023_dev *dev,
 				     uint32_t freq_dev);
 
+/* Starts the interrupt driven packet engine, in receive mode. */
+int32_t adf7023_pkt_start(struct adf7023_dev *dev);
+
+/* Stops the packet engine. */
+int32_t adf7023_pkt_stop(struct adf7023_dev *dev);
+
+/* Gets the oldest packet received by the packet engine. */
+int32_t adf7023_pkt_receive(struct adf7023_dev *dev,
+			    uint8_t* packet,
+			    uint8_t* length);
+
+/* Starts the transmission of a packet by the packet engine. */
+int32_t adf7023_pkt_transmit(struct adf7023_dev *dev,
+			     uint8_t* packet,
+			     uint8_t length);
+
 #endif // __ADF7023_H__
@@ -851,12 +851,122 @@ static int adrv9002_radio_init(struct adrv9002_rf_phy *phy)
 	return 0;
 }
 
+static int adrv9002_warmboot_save(struct adrv9002_rf_phy *phy)
+{
+	struct adi_adrv9001_Warmboot_CalNumbers cal_numbers = {0};
+	int ret;
+
+	if (!phy->warmboot_cals)
+		return 0;
+
+	ret = adi_adrv9001_cals_InitCals_WarmBoot_UniqueEnabledCals_Get(phy->adrv9001,
+			&cal_numbers,
+			phy->init_cals.chanInitCalMask[0],
+			phy->init_cals.chanInitCalMask[1]);
+	if (ret)
+		return adrv9002_dev_err(phy);
+
+	if (cal_numbers.warmbootMemoryNumBytes > phy->warmboot_size) {
+		pr_warning("Warmboot buffer too small (%u), %u bytes needed\n",
+			   phy->warmboot_size, cal_numbers.warmbootMemoryNumBytes);
+		return 0;
+	}
+
+	ret = adi_adrv9001_cals_InitCals_WarmBoot_Coefficients_UniqueArray_Get(phy->adrv9001,
+			phy->warmboot_cals,
+			phy->init_cals.chanInitCalMask[0],
+			phy->init_cals.chanInitCalMask[1]);
+	if (ret)
+		return adrv9002_dev_err(phy);
+
+	phy->warmboot_valid = true;
+
+	return 0;
+}
+
+static int adrv9002_init_cals_run(struct adrv9002_rf_phy *phy)
+{
+	uint8_t init_cals_error = 0;
+	int ret;
+
+	/* with warmboot enabled, the firmware uses the loaded coefficients */
+	if (phy->warmboot_valid) {
+		ret = adi_adrv9001_cals_InitCals_WarmBoot_Coefficients_UniqueArray_Set(
+			      phy->adrv9001, phy->warmboot_cals,
+			      phy->init_cals.chanInitCalMask[0],
+			      phy->init_cals.chanInitCalMask[1]);
+		if (ret)
+			return adrv9002_dev_err(phy);
+	}
+
+	if (phy->n_dps_profiles)
+		ret = adi_adrv9001_cals_Dynamic_profiles_calibrate(phy->adrv9001,
+				&phy->init_cals, 60000,
+				&init_cals_error,
+				phy->dps_profiles,
+				phy->n_dps_profiles);
+	else
+		ret = adi_adrv9001_cals_InitCals_Run(phy->adrv9001, &phy->init_cals,
+						     60000, &init_cals_error);
+	if (ret)
+		return adrv9002_dev_err(phy);
+
+	/* the calibrations leave the last dynamic profile loaded */
+	if (phy->n_dps_profiles)
+		phy->dps_idx = phy->n_dps_profiles - 1;
+
+	if (phy->warmboot_valid)
+		return 0;
+
+	return adrv9002_warmboot_save(phy);
+}
+
+int adrv9002_dps_switch(struct adrv9002_rf_phy *phy, const uint8_t idx)
+{
+	unsigned int c;
+	int ret;
+
+	if (idx >= phy->n_dps_profiles)
+		return -EINVAL;
+
+	if (idx == phy->dps_idx)
+		return 0;
+
+	/* the switch cannot be done with any of the channels in rf_enabled */
+	for (c = 0; c < NO_OS_ARRAY_SIZE(phy->channels); c++) {
+		ret = adrv9002_channel_to_state(phy, phy->channels[c],
+						ADI_ADRV9001_CHANNEL_CALIBRATED, true);
+		if (ret)
+			return ret;
+	}
+
+	ret = adi_adrv9001_arm_NextDynamicProfile_Set(phy->adrv9001,
+			&phy->dps_profiles[idx]);
+	if (ret)
+		return adrv9002_dev_err(phy);
+
+	ret = adi_adrv9001_arm_Profile_Switch(phy->adrv9001);
+	if (ret)
+		return adrv9002_dev_err(phy);
+
+	phy->dps_idx = idx;
+
+	for (c = 0; c < NO_OS_ARRAY_SIZE(phy->channels); c++) {
+		struct adrv9002_chan *chan = phy->channels[c];
+
+		ret = adrv9002_channel_to_state(phy, chan, chan->cached_state, false);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
 int adrv9002_setup(struct adrv9002_rf_phy *phy)
 {
 	struct adi_adrv9001_Device *adrv9001_device;
 	int ret;
 	unsigned int c;
-	uint8_t init_cals_error = 0;
 	adi_adrv9001_ChannelState_e init_state;
 	struct adrv9002_chan *chan;
 
@@ -904,6 +1014,15 @@ int adrv9002_setup(struct adrv9002_rf_phy *phy)
 
 	adrv9002_compute_init_cals(phy);
 
+	if (phy->n_dps_profiles > ADRV9002_DPS_PROFILES_MAX)
+		return -EINVAL;
+
+	/* 1 is the firmware value for no dynamic profiles */
+	phy->curr_profile->sysConfig.numDynamicProfiles =
+		phy->n_dps_profiles ? phy->n_dps_profiles :
+		ADI_ADRV9001_NUM_DYNAMIC_PROFILES_DISABLED;
+	phy->curr_profile->sysConfig.warmBootEnable = phy->warmboot_valid;
+
 	adrv9002_log_enable(&adrv9001_device->common);
 
 	ret = adi_adrv9001_InitAnalog(adrv9001_device, phy->curr_profile,
@@ -924,10 +1043,9 @@ int adrv9002_setup(struct adrv9002_rf_phy *phy)
 	if (ret)
 		return ret;
 
-	ret = adi_adrv9001_cals_InitCals_Run(adrv9001_device, &phy->init_cals,
-					     60000, &init_cals_error);
+	ret = adrv9002_init_cals_run(phy);
 	if (ret)
-		return adrv9002_dev_err(phy);
+		return ret;
 
 	ret = adrv9001_rx_path_config(phy, init_state);
 	if (ret)
@@ -45,6 +45,7 @@
 #include "adi_common_log.h"
 #include "adi_adrv9001_user.h"
 #include "adi_adrv9001_cals_types.h"
+#include "adi_adrv9001_dynamicProfile_types.h"
 #include "adi_adrv9001_fh_types.h"
 #include "adi_adrv9001_radio_types.h"
 #include "adi_adrv9001_rx_gaincontrol_types.h"
@@ -61,6 +62,8 @@
 #define ADRV9002_FH_HOP_SIGNALS_NR	2
 #define ADRV9002_FH_TABLES_NR		2
 #define ADRV9002_FH_BIN_ATTRS_CNT	(ADRV9002_FH_HOP_SIGNALS_NR * ADRV9002_FH_TABLES_NR)
+/* max number of dynamic profiles supported by the firmware */
+#define ADRV9002_DPS_PROFILES_MAX	6
 
 enum {
 	ADRV9002_CHANN_1,
@@ -206,6 +209,23 @@ struct adrv9002_rf_phy {
 	struct adi_adrv9001_Init	*curr_profile;
 	struct adi_adrv9001_Init	profile;
 	struct adi_adrv9001_InitCals	init_cals;
+	/*
+	 * Dynamic profiles to switch between at runtime with @adrv9002_dps_switch(). They
+	 * are all calibrated by @adrv9002_setup(). Must be set before it, leave
+	 * @n_dps_profiles at 0 to only use @curr_profile.
+	 */
+	adi_adrv9000_DynamicProfile_t	*dps_profiles;
+	uint8_t				n_dps_profiles;
+	uint8_t				dps_idx;
+	/*
+	 * Buffer provided by the user to keep the init calibrations coefficients. When
+	 * @warmboot_valid is not set, @adrv9002_setup() runs the calibrations and saves
+	 * them in here (if @warmboot_size is big enough). Next setups load them instead
+	 * of calibrating again. The buffer may also be restored from non volatile memory.
+	 */
+	char				*warmboot_cals;
+	uint32_t			warmboot_size;
+	uint8_t				warmboot_valid;
 	uint32_t			n_clks;
 	int				spi_device_id;
 	int				ngpios;
@@ -246,6 +266,8 @@ int adrv9002_channel_to_state(struct adrv9002_rf_phy *phy,
 			      const adi_adrv9001_ChannelState_e state, const bool cache_state);
 int adrv9002_init(struct adrv9002_rf_phy *phy,
 		  struct adi_adrv9001_Init *profile);
+/* Switch all channels to one of the dynamic profiles calibrated at setup */
+int adrv9002_dps_switch(struct adrv9002_rf_phy *phy, const uint8_t idx);
 int __adrv9002_dev_err(const struct adrv9002_rf_phy *phy, const char *function,
 		       const int line);
 #define adrv9002_dev_err(phy)	__adrv9002_dev_err(phy, __func__, __LINE__)
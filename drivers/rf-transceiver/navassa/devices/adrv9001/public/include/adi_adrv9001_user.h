@@ -37,9 +37,9 @@
 
 #define ADI_ADRV9001_MEM_DUMP_CHUNK_SIZE 256         /*Cache value: up to 1024, multiple of 4 */
 
-#define ADI_ADRV9001_STREAM_BINARY_IMAGE_LOAD_CHUNK_SIZE_BYTES (1024) /*Please ensure that the Stream bin size is perfectly divisible by the chunk size*/
+#define ADI_ADRV9001_STREAM_BINARY_IMAGE_LOAD_CHUNK_SIZE_BYTES (4096) /*Please ensure that the Stream bin size is perfectly divisible by the chunk size*/
 
-#define ADI_ADRV9001_ARM_BINARY_IMAGE_LOAD_CHUNK_SIZE_BYTES (1024) /*Please ensure that the ARM bin size is perfectly divisible by the chunk size*/
+#define ADI_ADRV9001_ARM_BINARY_IMAGE_LOAD_CHUNK_SIZE_BYTES (4096) /*Please ensure that the ARM bin size is perfectly divisible by the chunk size*/
 
 /* Theses values can be modified by the end user to adjust how active the SPI reads are
  * to help prevent over using the SPI resource */
@@ -903,7 +903,7 @@ int32_t adi_adrv9001_cals_InitCals_WarmBoot_Coefficients_UniqueArray_Get(adi_adr
 			if (((initMask & chInitMask) != 0) && ((profMask & device->devStateInfo.chProfEnMask[channel - 1]) != 0))
 			{
 				ADI_EXPECT(adi_adrv9001_arm_Memory_Read, device, addr, calVal, size, 0);
-				memcpy(calVal, memStartAddress, ADI_ADRV9001_WB_MAX_NUM_COEFF);
+				memcpy(memStartAddress, calVal, ADI_ADRV9001_WB_MAX_NUM_COEFF);
 				memStartAddress+= ADI_ADRV9001_WB_MAX_NUM_COEFF;
 			}
 		}
@@ -991,7 +991,7 @@ int32_t adi_adrv9001_cals_InitCals_WarmBoot_Coefficients_UniqueArray_Set(adi_adr
 				continue;
 			if (((initMask & chInitMask) != 0) && ((profMask & device->devStateInfo.chProfEnMask[channel - 1]) != 0))
 			{
-				memcpy(memStartAddress, calVal, ADI_ADRV9001_WB_MAX_NUM_COEFF);
+				memcpy(calVal, memStartAddress, ADI_ADRV9001_WB_MAX_NUM_COEFF);
 				ADI_EXPECT(adi_adrv9001_arm_Memory_Write, device, addr, calVal, size, 0);
 				memStartAddress += ADI_ADRV9001_WB_MAX_NUM_COEFF;
 			}
@@ -46,6 +46,8 @@
 #include "sd.h"
 #include "no_os_delay.h"
 #include "no_os_error.h"
+#include "no_os_util.h"
+#include "no_os_sched.h"
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -75,6 +77,7 @@
 #define STUFF_ARG			(0x00000000u)
 #define CMD8_ARG			(0x000001AAu)
 #define ACMD41_ARG			(0x40000000u)
+#define ACMD23_MAX_BLOCKS		(0x007FFFFFu)
 
 #define DATA_BLOCK_BITS			(9u)
 #define MASK_ADDR_IN_BLOCK		(DATA_BLOCK_LEN - 1u)
@@ -139,7 +142,7 @@ static int32_t wait_until_not_busy(struct sd_desc *sd_desc)
 			ret = 0;
 			break;
 		}
-		no_os_mdelay(1);
+		no_os_sched_delay_ms(1);
 	} while (not_timeout--);
 
 	return ret;
@@ -175,7 +178,7 @@ static int32_t send_command(struct sd_desc *sd_desc, struct cmd_desc *cmd_desc)
 		cmd_desc_local.response_len = R1_LEN;
 		if (0 != send_command(sd_desc, &cmd_desc_local))
 			return -1;
-		if (cmd_desc_local.response[0] != R1_IDLE_STATE) {
+		if (cmd_desc_local.response[0] & ~R1_IDLE_STATE) {
 			DEBUG_MSG("Not the expected response for CMD55\n");
 			return -1;
 		}
@@ -519,6 +522,261 @@ int32_t sd_write(struct sd_desc *sd_desc, uint8_t *data, uint64_t address,
 	return 0;
 }
 
+/**
+ * Check the data response token that follows a block sent for a write
+ * @param sd_desc	- Instance of the SD card
+ * @return 0 in case of success, -1 otherwise.
+ */
+static int32_t check_data_response(struct sd_desc *sd_desc)
+{
+	uint8_t		response;
+
+	if (0 != wait_for_response(sd_desc, &response))
+		return -1;
+	if ((response & MASK_RESPONSE_TOKEN) != 0x4) {
+		DEBUG_MSG("Block not accepted by the card\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * Called when the asynchronous transfer of a stream block is done
+ * @param ctx		- Stream the block belongs to
+ * @param ret		- Result of the transfer
+ */
+static void stream_sent(void *ctx, int32_t ret)
+{
+	struct sd_stream	*stream = ctx;
+
+	stream->state = ret ? SD_STREAM_ERROR : SD_STREAM_SENT;
+}
+
+/**
+ * Make progress with the block sent last, without blocking unless wait is set:
+ * check its data response once sent, then whether the card finished
+ * programming it.
+ * @param stream	- The stream
+ * @param wait		- If set, return only when the card is ready
+ * @return 0 in case of success, -1 otherwise.
+ */
+static int32_t stream_poll(struct sd_stream *stream, bool wait)
+{
+	uint8_t		data;
+
+	do {
+		switch (stream->state) {
+		case SD_STREAM_IDLE:
+			return 0;
+		case SD_STREAM_SENDING:
+			break;
+		case SD_STREAM_SENT:
+			if (0 != check_data_response(stream->sd)) {
+				stream->state = SD_STREAM_ERROR;
+				return -1;
+			}
+			stream->state = SD_STREAM_BUSY;
+			break;
+		case SD_STREAM_BUSY:
+			if (wait) {
+				if (0 != wait_until_not_busy(stream->sd)) {
+					stream->state = SD_STREAM_ERROR;
+					return -1;
+				}
+				stream->state = SD_STREAM_IDLE;
+				return 0;
+			}
+			/* The card holds the line low while it is busy */
+			data = 0xFF;
+			if (0 != no_os_spi_write_and_read(stream->sd->spi_desc,
+							  &data, 1)) {
+				stream->state = SD_STREAM_ERROR;
+				return -1;
+			}
+			if (data != 0x00)
+				stream->state = SD_STREAM_IDLE;
+			return 0;
+		default:
+			return -1;
+		}
+	} while (wait || stream->state != SD_STREAM_SENDING);
+
+	return 0;
+}
+
+/**
+ * Start sending the block being filled and switch to the other one. The
+ * block sent before must be programmed by the card first.
+ * @param stream	- The stream
+ * @return 0 in case of success, -1 otherwise.
+ */
+static int32_t stream_send_block(struct sd_stream *stream)
+{
+	uint8_t		*block;
+
+	if (0 != stream_poll(stream, true))
+		return -1;
+
+	block = stream->block[stream->fill];
+	block[0] = START_N_BLOCK_TOKEN;
+	block[DATA_BLOCK_LEN + 1] = 0xFF;
+	block[DATA_BLOCK_LEN + 2] = 0xFF;
+
+	stream->msg.tx_buff = block;
+	stream->msg.rx_buff = NULL;
+	stream->msg.bytes_number = DATA_BLOCK_LEN + 3;
+	stream->msg.cs_change = 1;
+	stream->state = SD_STREAM_SENDING;
+	if (0 != no_os_spi_transfer_async(stream->sd->spi_desc, &stream->msg,
+					  1, stream_sent, stream)) {
+		stream->state = SD_STREAM_ERROR;
+		return -1;
+	}
+
+	stream->blocks_left--;
+	stream->fill ^= 1;
+	stream->fill_len = 0;
+
+	return 0;
+}
+
+/**
+ * Open a multi-block write for continuous logging. The card is told with
+ * ACMD23 how many blocks are going to be written, so it can erase them
+ * beforehand, and the write command is kept open until sd_stream_close().
+ * No other SD card function can be used while the stream is open.
+ * @param sd_desc	- Instance of the SD card
+ * @param stream	- Address where to store the stream
+ * @param address	- Address of the first block, aligned to a block
+ * @param nb_blocks	- Maximum number of blocks that will be written
+ * @return 0 in case of success, -1 otherwise.
+ */
+int32_t sd_stream_open(struct sd_desc *sd_desc, struct sd_stream **stream,
+		       uint64_t address, uint32_t nb_blocks)
+{
+	struct sd_stream	*lstream;
+	struct cmd_desc		cmd_desc;
+
+	if (!sd_desc || !stream || !nb_blocks ||
+	    (address & MASK_ADDR_IN_BLOCK) ||
+	    address + ((uint64_t)nb_blocks << DATA_BLOCK_BITS) >
+	    sd_desc->memory_size)
+		return -1;
+
+	lstream = calloc(1, sizeof(*lstream));
+	if (!lstream)
+		return -1;
+	lstream->sd = sd_desc;
+	lstream->blocks_left = nb_blocks;
+	lstream->state = SD_STREAM_IDLE;
+
+	/* Pre-erase the blocks to be written */
+	cmd_desc.cmd = ACMD(23);
+	cmd_desc.arg = no_os_min(nb_blocks, ACMD23_MAX_BLOCKS);
+	cmd_desc.response_len = R1_LEN;
+	if (0 != send_command(sd_desc, &cmd_desc))
+		goto failure;
+	if (cmd_desc.response[0] != R1_READY_STATE) {
+		DEBUG_MSG("Failed to set the pre-erase block count\n");
+		goto failure;
+	}
+
+	cmd_desc.cmd = CMD(25);
+	cmd_desc.arg = address >> DATA_BLOCK_BITS;
+	cmd_desc.response_len = R1_LEN;
+	if (0 != send_command(sd_desc, &cmd_desc))
+		goto failure;
+	if (cmd_desc.response[0] != R1_READY_STATE) {
+		DEBUG_MSG("Failed to write Data command\n");
+		goto failure;
+	}
+
+	*stream = lstream;
+
+	return 0;
+failure:
+	free(lstream);
+	return -1;
+}
+
+/**
+ * Append data to an open stream. A block is sent as soon as it is full and
+ * the function returns while the card programs it, waiting only if the block
+ * sent before is not programmed yet.
+ * @param stream	- The stream
+ * @param data		- Data to write
+ * @param len		- Length of data in bytes
+ * @return 0 in case of success, -1 otherwise, also when more than the blocks
+ * given to sd_stream_open() would be written.
+ */
+int32_t sd_stream_write(struct sd_stream *stream, const uint8_t *data,
+			uint32_t len)
+{
+	uint32_t	n;
+
+	if (!stream || (!data && len))
+		return -1;
+
+	if (0 != stream_poll(stream, false))
+		return -1;
+
+	while (len) {
+		if (!stream->blocks_left)
+			return -1;
+
+		n = no_os_min(len, DATA_BLOCK_LEN - stream->fill_len);
+		memcpy(&stream->block[stream->fill][1 + stream->fill_len], data,
+		       n);
+		stream->fill_len += n;
+		data += n;
+		len -= n;
+
+		if (stream->fill_len == DATA_BLOCK_LEN &&
+		    0 != stream_send_block(stream))
+			return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * Write the last block, padded with zeros if it is not full, end the
+ * multi-block write and free the stream.
+ * @param stream	- The stream
+ * @return 0 in case of success, -1 otherwise.
+ */
+int32_t sd_stream_close(struct sd_stream *stream)
+{
+	struct sd_desc	*sd_desc;
+	int32_t		ret;
+
+	if (!stream)
+		return -1;
+
+	sd_desc = stream->sd;
+	ret = 0;
+	if (stream->fill_len && stream->blocks_left) {
+		memset(&stream->block[stream->fill][1 + stream->fill_len], 0,
+		       DATA_BLOCK_LEN - stream->fill_len);
+		ret = stream_send_block(stream);
+	}
+	if (0 != stream_poll(stream, true))
+		ret = -1;
+
+	/* Send stop transmission token */
+	sd_desc->buff[0] = STOP_TRANSMISSION_TOKEN;
+	sd_desc->buff[1] = 0xFF;
+	if (0 != no_os_spi_write_and_read(sd_desc->spi_desc, sd_desc->buff,
+					  2) ||
+	    0 != wait_until_not_busy(sd_desc))
+		ret = -1;
+
+	free(stream);
+
+	return ret;
+}
+
 /**
  * Initialize an instance of SD card and stores it to the parameter desc
  * @param sd_desc	- Pointer where to store the instance of the SD
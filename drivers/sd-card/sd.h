@@ -102,6 +102,36 @@ struct sd_desc {
 	uint8_t		buff[18];
 };
 
+/**
+ * @struct sd_stream
+ * @brief Multi-block write kept open by sd_stream_open() until
+ * sd_stream_close(). While a block is sent with an asynchronous SPI transfer
+ * and programmed by the card, the next one is filled.
+ */
+struct sd_stream {
+	/** Instance of the SD card */
+	struct sd_desc		*sd;
+	/** Token, data block and CRC of the two blocks, sent as they are */
+	uint8_t			block[2][DATA_BLOCK_LEN + 3]
+	__attribute__ ((aligned));
+	/** Message used to send a block */
+	struct no_os_spi_msg	msg;
+	/** Index of the block being filled */
+	uint32_t		fill;
+	/** Bytes already in the block being filled */
+	uint32_t		fill_len;
+	/** Number of blocks that can still be written */
+	uint32_t		blocks_left;
+	/** State of the block sent last */
+	volatile enum {
+		SD_STREAM_IDLE,
+		SD_STREAM_SENDING,
+		SD_STREAM_SENT,
+		SD_STREAM_BUSY,
+		SD_STREAM_ERROR
+	}			state;
+};
+
 /**
  * @struct cmd_desc
  * @brief Contains the elements needed to build a command
@@ -132,6 +162,11 @@ int32_t sd_write(struct sd_desc *desc,
 		 uint8_t *data,
 		 uint64_t address,
 		 uint64_t len);
+int32_t sd_stream_open(struct sd_desc *desc, struct sd_stream **stream,
+		       uint64_t address, uint32_t nb_blocks);
+int32_t sd_stream_write(struct sd_stream *stream, const uint8_t *data,
+			uint32_t len);
+int32_t sd_stream_close(struct sd_stream *stream);
 
 #endif /* __SD_H__ */
 
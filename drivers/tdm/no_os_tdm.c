@@ -99,3 +99,44 @@ int32_t  no_os_tdm_write(struct no_os_tdm_desc *desc,
 {
 	return desc->platform_ops->tdm_ops_write(desc, data, nb_samples);
 }
+
+/**
+ * @brief Read continuously in a circular buffer, without the gaps between
+ * calls of no_os_tdm_read(). The callback gets each half of the buffer once
+ * it is filled, while the other half is being received.
+ * @param desc - The TDM descriptor.
+ * @param data - The circular buffer.
+ * @param nb_samples - Number of samples of the buffer, even.
+ * @param callback - Called from interrupt context with each filled half.
+ * @param ctx - Parameter of callback.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_tdm_read_start(struct no_os_tdm_desc *desc, void *data,
+			     uint32_t nb_samples, no_os_tdm_callback callback,
+			     void *ctx)
+{
+	if (!desc || !desc->platform_ops || !data || !callback)
+		return -EINVAL;
+
+	if (!desc->platform_ops->tdm_ops_read_start)
+		return -ENOSYS;
+
+	return desc->platform_ops->tdm_ops_read_start(desc, data, nb_samples,
+			callback, ctx);
+}
+
+/**
+ * @brief Stop the read started by no_os_tdm_read_start().
+ * @param desc - The TDM descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_tdm_stop(struct no_os_tdm_desc *desc)
+{
+	if (!desc || !desc->platform_ops)
+		return -EINVAL;
+
+	if (!desc->platform_ops->tdm_ops_stop)
+		return -ENOSYS;
+
+	return desc->platform_ops->tdm_ops_stop(desc);
+}
@@ -49,11 +49,87 @@
 #include "no_os_spi.h"
 #include "no_os_util.h"
 
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+/**
+ * RTD resistance over R0, in units of 2^-16, from MAX31865_TEMP_MIN to
+ * MAX31865_TEMP_MAX in steps of MAX31865_TEMP_STEP. Computed with the
+ * Callendar-Van Dusen equation and the IEC 60751 coefficients, linear
+ * interpolation between the entries is accurate to 0.01 C.
+ */
+static const uint32_t max31865_cvd_table[] = {
+	12137, 14959, 17758, 20536, 23294, 26033, 28755, 31460, 34151, 36827,
+	39489, 42139, 44778, 47405, 50022, 52630, 55228, 57817, 60398, 62971,
+	65536, 68094, 70644, 73186, 75721, 78248, 80768, 83280, 85785, 88282,
+	90771, 93253, 95727, 98194, 100653, 103105, 105549, 107985, 110414,
+	112835, 115249, 117655, 120054, 122445, 124828, 127204, 129572, 131933,
+	134286, 136632, 138970, 141301, 143623, 145939, 148247, 150547, 152839,
+	155124, 157402, 159672, 161934, 164189, 166436, 168676, 170908, 173132,
+	175349, 177559, 179761, 181955, 184141, 186321, 188492, 190656, 192812,
+	194961, 197102, 199236, 201362, 203481, 205592, 207695, 209791, 211879,
+	213960, 216033, 218098, 220156, 222207, 224250, 226285, 228313, 230333,
+	232345, 234350, 236348, 238338, 240320, 242295, 244262, 246221, 248173,
+	250118, 252055, 253984, 255906
+};
+
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
 /******************************************************************************/
 
+/**
+ * @brief DRDY interrupt handler, flags the device for the next scan.
+ * @param ctx - MAX31865 descriptor
+ */
+static void max31865_drdy_handler(void *ctx)
+{
+	struct max31865_dev *device = ctx;
+
+	device->data_ready = true;
+}
+
+/**
+ * @brief Deliver the DRDY falling edges to max31865_drdy_handler().
+ * @param device - MAX31865 descriptor
+ * @return 0 in case of success, negative error code otherwise
+ */
+static int max31865_drdy_irq_setup(struct max31865_dev *device)
+{
+	int ret;
+
+	device->drdy_cb = (struct no_os_callback_desc) {
+		.callback = max31865_drdy_handler,
+		.ctx = device,
+		.event = NO_OS_EVT_GPIO,
+		.peripheral = NO_OS_GPIO_IRQ
+	};
+
+	ret = no_os_irq_register_callback(device->drdy_irq_ctrl,
+					  device->drdy_irq_num,
+					  &device->drdy_cb);
+	if (ret)
+		return ret;
+
+	ret = no_os_irq_trigger_level_set(device->drdy_irq_ctrl,
+					  device->drdy_irq_num,
+					  NO_OS_IRQ_EDGE_FALLING);
+	if (ret)
+		goto err;
+
+	ret = no_os_irq_enable(device->drdy_irq_ctrl, device->drdy_irq_num);
+	if (ret)
+		goto err;
+
+	return 0;
+
+err:
+	no_os_irq_unregister_callback(device->drdy_irq_ctrl,
+				      device->drdy_irq_num, &device->drdy_cb);
+
+	return ret;
+}
+
 /**
  * @brief Device and comm init function
  * @param device - MAX31865 descriptor to be initialized
@@ -77,10 +153,36 @@ int max31865_init(struct max31865_dev **device,
 	if (ret)
 		goto err;
 
+	ret = no_os_gpio_get_optional(&descriptor->drdy_desc,
+				      init_param->drdy_gpio_init);
+	if (ret)
+		goto err_spi;
+
+	if (descriptor->drdy_desc) {
+		ret = no_os_gpio_direction_input(descriptor->drdy_desc);
+		if (ret)
+			goto err_gpio;
+	}
+
+	descriptor->rref = init_param->rref;
+	descriptor->r0 = init_param->r0;
+
+	if (init_param->drdy_irq_ctrl) {
+		descriptor->drdy_irq_ctrl = init_param->drdy_irq_ctrl;
+		descriptor->drdy_irq_num = init_param->drdy_irq_num;
+		ret = max31865_drdy_irq_setup(descriptor);
+		if (ret)
+			goto err_gpio;
+	}
+
 	*device = descriptor;
 
 	return 0;
 
+err_gpio:
+	no_os_gpio_remove(descriptor->drdy_desc);
+err_spi:
+	no_os_spi_remove(descriptor->comm_desc);
 err:
 	free(descriptor);
 
@@ -99,6 +201,17 @@ int max31865_remove(struct max31865_dev *device)
 	if (!device)
 		return -EINVAL;
 
+	if (device->drdy_irq_ctrl) {
+		no_os_irq_disable(device->drdy_irq_ctrl, device->drdy_irq_num);
+		no_os_irq_unregister_callback(device->drdy_irq_ctrl,
+					      device->drdy_irq_num,
+					      &device->drdy_cb);
+	}
+
+	ret = no_os_gpio_remove(device->drdy_desc);
+	if (ret)
+		return ret;
+
 	ret = no_os_spi_remove(device->comm_desc);
 	if (ret)
 		return ret;
@@ -413,3 +526,153 @@ int max31865_read_rtd(struct max31865_dev *device, uint16_t *rtd_reg)
 
 	return max31865_enable_bias(device, false);
 }
+
+/**
+ * @brief Start the continuous conversions at the rate of the noise filter.
+ * The bias stays enabled, so the conversions don't wait for it to settle
+ * and DRDY goes low on each new result.
+ * @param device MAX31865 descriptor
+ * @return 0 in case of success, negative error code otherwise
+ */
+int max31865_start_auto_convert(struct max31865_dev *device)
+{
+	int ret;
+
+	ret = max31865_clear_fault(device);
+	if (ret)
+		return ret;
+
+	device->data_ready = false;
+
+	return max31865_reg_update(device, MAX31865_CONFIG_REG,
+				   MAX31865_CONFIG_BIAS |
+				   MAX31865_CONFIG_MODEAUTO, true);
+}
+
+/**
+ * @brief Read the last conversion in auto-convert mode. Both RTD registers
+ * are read in one transfer, the address auto-increments.
+ * @param device MAX31865 descriptor
+ * @param rtd_reg pointer to hold the 15-bit RTD code
+ * @param fault pointer to hold the fault bit, true if a fault was detected
+ * @return 0 in case of success, negative error code otherwise
+ */
+int max31865_read_rtd_auto(struct max31865_dev *device, uint16_t *rtd_reg,
+			   bool *fault)
+{
+	uint8_t raw_array[3] = {MAX31865_RTDMSB_REG};
+	struct no_os_spi_msg temp_xfer = {
+		.rx_buff = raw_array,
+		.tx_buff = raw_array,
+		.bytes_number = 3,
+		.cs_change = 1,
+	};
+	uint16_t val;
+	int ret;
+
+	ret = no_os_spi_transfer(device->comm_desc, &temp_xfer, 1);
+	if (ret)
+		return ret;
+
+	val = no_os_get_unaligned_be16(&raw_array[1]);
+	*fault = val & MAX31865_RTD_FAULT_MASK;
+	*rtd_reg = val >> 1;
+
+	return 0;
+}
+
+/**
+ * @brief Convert an RTD code to a temperature, with a lookup in the
+ * precomputed Callendar-Van Dusen table instead of solving the equation.
+ * @param device MAX31865 descriptor, holding the rref and r0 values
+ * @param rtd_reg the 15-bit RTD code
+ * @param temp pointer to hold the temperature in milli degrees Celsius
+ * @return 0 in case of success, -ERANGE if the resistance is outside of
+ * the table, negative error code otherwise
+ */
+int max31865_rtd_to_temp(struct max31865_dev *device, uint16_t rtd_reg,
+			 int32_t *temp)
+{
+	uint32_t lo = 0, hi = NO_OS_ARRAY_SIZE(max31865_cvd_table) - 1;
+	uint32_t ratio, mid;
+
+	if (!device || !temp || !device->r0)
+		return -EINVAL;
+
+	/* R / R0 = code * rref / (2^15 * r0), in units of 2^-16 */
+	ratio = ((uint64_t)rtd_reg * device->rref * 2) / device->r0;
+	if (ratio < max31865_cvd_table[lo] || ratio > max31865_cvd_table[hi])
+		return -ERANGE;
+
+	/* Find the entries around ratio */
+	while (hi - lo > 1) {
+		mid = (lo + hi) / 2;
+		if (ratio < max31865_cvd_table[mid])
+			hi = mid;
+		else
+			lo = mid;
+	}
+
+	*temp = MAX31865_TEMP_MIN + lo * MAX31865_TEMP_STEP +
+		(int32_t)(((uint64_t)(ratio - max31865_cvd_table[lo]) *
+			   MAX31865_TEMP_STEP) /
+			  (max31865_cvd_table[hi] - max31865_cvd_table[lo]));
+
+	return 0;
+}
+
+/**
+ * @brief Read the new conversions of devices in auto-convert mode, sharing
+ * a bus. A device is read when its DRDY interrupt fired, or when its DRDY
+ * pin is low; without DRDY it is read on every scan. Each read is a single
+ * transfer and the temperature is converted with max31865_rtd_to_temp().
+ * The results are stored in the descriptors.
+ * @param devices array of MAX31865 descriptors
+ * @param nb_devices number of descriptors
+ * @return number of devices updated in case of success, negative error code
+ * otherwise
+ */
+int max31865_scan(struct max31865_dev **devices, uint32_t nb_devices)
+{
+	struct max31865_dev *dev;
+	uint8_t drdy;
+	uint32_t i;
+	int updated = 0;
+	int ret;
+
+	if (!devices)
+		return -EINVAL;
+
+	for (i = 0; i < nb_devices; i++) {
+		dev = devices[i];
+
+		if (dev->drdy_irq_ctrl) {
+			if (!dev->data_ready)
+				continue;
+			dev->data_ready = false;
+		} else if (dev->drdy_desc) {
+			ret = no_os_gpio_get_value(dev->drdy_desc, &drdy);
+			if (ret)
+				return ret;
+			if (drdy == NO_OS_GPIO_HIGH)
+				continue;
+		}
+
+		ret = max31865_read_rtd_auto(dev, &dev->rtd, &dev->fault);
+		if (ret)
+			return ret;
+
+		if (!dev->fault && dev->r0) {
+			ret = max31865_rtd_to_temp(dev, dev->rtd,
+						   &dev->temperature);
+			if (ret == -ERANGE)
+				dev->fault = true;
+			else if (ret)
+				return ret;
+		}
+
+		updated++;
+	}
+
+	return updated;
+}
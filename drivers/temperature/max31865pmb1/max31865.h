@@ -47,6 +47,8 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "no_os_spi.h"
+#include "no_os_gpio.h"
+#include "no_os_irq.h"
 #include "no_os_util.h"
 
 /******************************************************************************/
@@ -75,12 +77,36 @@
 #define MAX31865_LFAULTLSB_REG 			0x06
 #define MAX31865_FAULTSTAT_REG 			0x07
 
+/** Fault bit of RTDLSB */
+#define MAX31865_RTD_FAULT_MASK			0x01
+
+/** Temperature range of the conversion table, in milli degrees Celsius */
+#define MAX31865_TEMP_MIN			-200000
+#define MAX31865_TEMP_MAX			850000
+#define MAX31865_TEMP_STEP			10000
+
 /**
  * @struct max31865_dev
  * @brief Structure holding max31865 descriptor.
  */
 struct max31865_dev {
 	struct no_os_spi_desc *comm_desc;
+	/** Optional DRDY pin, low while a new RTD value is available */
+	struct no_os_gpio_desc *drdy_desc;
+	/** Optional interrupt of the DRDY pin */
+	struct no_os_irq_ctrl_desc *drdy_irq_ctrl;
+	uint32_t drdy_irq_num;
+	struct no_os_callback_desc drdy_cb;
+	/** Set by the DRDY interrupt, cleared when the RTD is read */
+	volatile bool data_ready;
+	/** Reference resistor and RTD resistance at 0 C, in ohms */
+	uint32_t rref;
+	uint32_t r0;
+	/** Last values read by max31865_scan() */
+	uint16_t rtd;
+	bool fault;
+	/** Temperature in milli degrees Celsius */
+	int32_t temperature;
 };
 
 /**
@@ -89,6 +115,18 @@ struct max31865_dev {
  */
 struct max31865_init_param {
 	struct no_os_spi_init_param spi_init;
+	/** Optional DRDY pin, polled by max31865_scan() */
+	struct no_os_gpio_init_param *drdy_gpio_init;
+	/**
+	 * Optional controller of the DRDY interrupt, max31865_scan() then
+	 * reads the device only after a falling edge of DRDY.
+	 */
+	struct no_os_irq_ctrl_desc *drdy_irq_ctrl;
+	uint32_t drdy_irq_num;
+	/** Reference resistor, e.g. 430 for a PT100 */
+	uint32_t rref;
+	/** RTD resistance at 0 C, e.g. 100 for a PT100 */
+	uint32_t r0;
 };
 
 /** Device and comm init function */
@@ -136,4 +174,16 @@ int max31865_set_wires(struct max31865_dev *, bool);
 /** Read RTD **/
 int max31865_read_rtd(struct max31865_dev *, uint16_t *);
 
+/** Start the continuous conversions, the bias stays enabled **/
+int max31865_start_auto_convert(struct max31865_dev *);
+
+/** Read the last RTD conversion in auto-convert mode **/
+int max31865_read_rtd_auto(struct max31865_dev *, uint16_t *, bool *);
+
+/** Convert an RTD code to milli degrees Celsius **/
+int max31865_rtd_to_temp(struct max31865_dev *, uint16_t, int32_t *);
+
+/** Read the new conversions of a set of devices **/
+int max31865_scan(struct max31865_dev **, uint32_t);
+
 #endif // __MAX31855_H__
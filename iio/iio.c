@@ -49,12 +49,20 @@
 #include "iiod.h"
 #include "ctype.h"
 #include "no_os_util.h"
-#include "no_os_list.h"
 #include "no_os_error.h"
 #include "no_os_uart.h"
 #include "no_os_error.h"
 #include "no_os_circular_buffer.h"
+#include "no_os_alloc.h"
+#include "no_os_trace.h"
+#include "no_os_irq_policy.h"
+#include "no_os_sched.h"
+#include "no_os_hot.h"
+#if defined(IIO_STATS) || defined(IIO_ATTR_CACHE)
+#include "no_os_delay.h"
+#endif
 #include <inttypes.h>
+#include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -63,20 +71,331 @@
 #include "tcp_socket.h"
 #endif
 
+#ifdef IIO_RECORDER
+#include "ff.h"
+#endif
+
+#ifdef IIO_FREERTOS
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "stream_buffer.h"
+#endif
+
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
 /******************************************************************************/
 
 #define IIOD_PORT		30431
+/* Most blocks a client can ask for a device buffer with set_buffers_count */
+#ifndef IIO_MAX_BUFFER_BLOCKS
+#define IIO_MAX_BUFFER_BLOCKS	16
+#endif
+/*
+ * UDP port of USE_NETWORK_UDP. A client opens the buffer over TCP, then sends
+ * "STREAM <device>" from its UDP socket to get the buffer data in datagrams,
+ * until it sends "STOP <device>" or the buffer is closed. Each datagram starts
+ * with a big endian 32 bit sequence number, to find lost datagrams, and 32 bit
+ * flags, followed by whole scans, when a scan fits in a datagram.
+ */
+#define IIOD_UDP_PORT		30432
+/* Data lost by an overrun of the device buffer, before this datagram */
+#define IIO_UDP_FLAG_OVERRUN	NO_OS_BIT(0)
+#define IIO_UDP_HDR_SIZE	8
+/* Datagram fitting in an Ethernet frame without being fragmented */
+#define IIO_UDP_DGRAM_SIZE	1472
+#define IIO_UDP_MAX_STREAMS	4
+/* Datagrams of a stream sent in one iio_step, not to delay TCP traffic */
+#define IIO_UDP_STEP_DGRAMS	16
+/*
+ * Capture files of IIO_RECORDER, in little endian. The header is padded to a
+ * multiple of IIO_REC_SECTOR_SIZE bytes:
+ *   "IIOREC" magic, 16 bit version, 32 bit header size, 32 bit bytes per
+ *   scan, 32 bit number of channels, then strings of an 8 bit length and the
+ *   text: device name, sampling_frequency and for each enabled channel, in scan
+ *   order, the channel id, 5 bytes of scan type (sign, realbits, storagebits,
+ *   shift, is_big_endian) and its scale.
+ * Records of IIO_REC_RECORD_SIZE bytes follow: 32 bit tag, 32 bit length of
+ * the payload and the payload, padded with zeros. The raw scans are the
+ * concatenated payloads of the data records, a scan may be split across two
+ * records. After each IIO_REC_INDEX_INTERVAL data records, and when the capture
+ * is stopped, an index record holds the 64 bit number of data bytes written
+ * before it and 32 bit flags. With fixed size records a reader seeks by
+ * computing the offset of a record, and the file stays sector aligned so FatFs
+ * writes the records straight to the card.
+ */
+#define IIO_REC_VERSION		1
+#define IIO_REC_SECTOR_SIZE	512
+#ifndef IIO_REC_RECORD_SIZE
+#define IIO_REC_RECORD_SIZE	4096
+#endif
+#define IIO_REC_HDR_SIZE	8
+#define IIO_REC_PAYLOAD_SIZE	(IIO_REC_RECORD_SIZE - IIO_REC_HDR_SIZE)
+#define IIO_REC_TAG_DATA	0x41544144 /* "DATA" */
+#define IIO_REC_TAG_INDEX	0x58444e49 /* "INDX" */
+/* Data lost by an overrun of the device buffer, since the previous index */
+#define IIO_REC_FLAG_OVERRUN	NO_OS_BIT(0)
+/* Each index record is also a sync point of the file */
+#ifndef IIO_REC_INDEX_INTERVAL
+#define IIO_REC_INDEX_INTERVAL	16
+#endif
+#define IIO_REC_MAX_FILES	2
+/* Records of a capture written in one iio_step */
+#define IIO_REC_STEP_RECORDS	4
+/*
+ * Compressed READBUF data, enabled by a client for a device by writing
+ * IIO_COMP_DELTA to its IIO_COMP_ATTR buffer attribute. The data is a stream of
+ * blocks, split across READBUF responses as the client requests bytes. A block
+ * is an 8 bit type in the low nibble and the sample size in the high nibble,
+ * the 8 bit number of channels and the 16 bit little endian number of bytes of
+ * raw data it holds, followed by:
+ *   IIO_COMP_RAW: the raw data.
+ *   IIO_COMP_PACKED: the first sample of each channel, then groups of up to
+ *   IIO_COMP_GROUP deltas to the previous sample of the same channel, zigzag
+ *   encoded. A group is its 8 bit bit width and the deltas packed with that
+ *   many bits each, least significant bit first, padded to a byte.
+ * Blocks that don't get smaller are sent raw.
+ */
+#define IIO_COMP_ATTR		"compression"
+#define IIO_COMP_CNTX_ATTR	"buffer_compression"
+#define IIO_COMP_DELTA		"delta"
+#define IIO_COMP_NONE		"none"
+#define IIO_COMP_RAW		0
+#define IIO_COMP_PACKED		1
+#define IIO_COMP_HDR_SIZE	4
+#define IIO_COMP_GROUP		16
+/* Raw bytes of data compressed in a block */
+#ifndef IIO_COMP_BLOCK_SIZE
+#define IIO_COMP_BLOCK_SIZE	1024
+#endif
+/*
+ * Conversion of the READBUF data of a device, of buffer_conversion, selected
+ * by a client by writing one of iio_conv_formats to the IIO_CONV_ATTR buffer
+ * attribute. Samples of at most 32 realbits are shifted, masked and extended as
+ * their scan type says, then sent in little endian as:
+ *   s32: the value as an int32.
+ *   s16: the 16 most significant realbits as an int16, narrower samples are
+ *   extended.
+ *   q31: the value left justified in an int32. Unsigned samples are shifted by
+ *   one bit less, their range is [0, 1).
+ *   f32: the q31 value as a float in [-1, 1).
+ * Each sample is aligned to its new size in the scan, wider samples such as
+ * the timestamp are sent as they are. The context xml keeps the raw format and
+ * the compression can't be enabled at the same time.
+ */
+#define IIO_CONV_ATTR		"output_format"
+#define IIO_CONV_FORMATS_ATTR	"output_format_available"
+/* Samples converted at once by the kernels */
+#define IIO_CONV_CHUNK		32
+/* Converted bytes staged for READBUF requests smaller than a scan */
+#ifndef IIO_CONV_BLOCK_SIZE
+#define IIO_CONV_BLOCK_SIZE	1024
+#endif
+/*
+ * Decimation stage of buffer_decimation. Each output scan is computed, per
+ * active channel, from decimation_factor pushed scans: their average, the
+ * output of an IIO_DECIM_CIC_ORDER CIC filter scaled by its gain, their
+ * minimum, maximum or maximum absolute value. Samples are extended to 64 bits
+ * so the kernels can't overflow for realbits of at most 32.
+ */
+#define IIO_DECIM_MODE_ATTR	"decimation_mode"
+#define IIO_DECIM_MODES_ATTR	"decimation_mode_available"
+#define IIO_DECIM_FACTOR_ATTR	"decimation_factor"
+#ifndef IIO_DECIM_MAX_FACTOR
+#define IIO_DECIM_MAX_FACTOR	1024
+#endif
+#define IIO_DECIM_CIC_ORDER	3
+#define IIO_DECIM_MAX_SCAN	(IIO_MAX_SCAN_CH * 8)
 #define MAX_SOCKET_TO_HANDLE	10
 #define REG_ACCESS_ATTRIBUTE	"direct_reg_access"
+/*
+ * Debug attribute next to REG_ACCESS_ATTRIBUTE. Written with a list of
+ * "addr" or "first-last" ranges to dump and of "addr=value" registers to set,
+ * reading it gets the "addr=value" lines of the ranges, fit to be written back.
+ */
+#define REG_BULK_ATTRIBUTE	"direct_reg_bulk"
+#ifndef IIO_REG_BULK_RANGES
+#define IIO_REG_BULK_RANGES	16
+#endif
+/* Registers read at once from the device during a dump */
+#define IIO_REG_BULK_CHUNK	16
+/* Longest "addr=value" line of a dump */
+#define IIO_REG_BULK_LINE	sizeof("0x00000000=0x00000000\n")
+/* Value of the attributes of a device whose probe is not done yet */
+#define IIO_INITIALIZING	"initializing"
+/* Debug attribute of all devices, reading it gets the next no_os_trace lines */
+#define TRACE_ATTRIBUTE		"trace"
+/* Debug attribute of all devices with the IIO_STATS counters, reset on write */
+#define STATS_ATTRIBUTE		"stats"
+/* Debug attribute of all devices with the no_os_irq_policy latency counters */
+#define IRQ_LATENCY_ATTRIBUTE	"irq_latency"
+/* Debug attribute of all devices with the NO_OS_ALLOC_STATS counters */
+#define ALLOC_STATS_ATTRIBUTE	"alloc_stats"
 #define IIOD_CONN_BUFFER_SIZE	0x1000
 #define NO_TRIGGER				(uint32_t)-1
+/*
+ * Events of an asynchronous trigger served by one iio_step. Older events are
+ * dropped and counted in the overruns attribute of the trigger.
+ */
+#ifndef IIO_TRIG_MAX_PENDING
+#define IIO_TRIG_MAX_PENDING	32
+#endif
+#define IIO_TRIG_OVERRUNS_ATTR	"overruns"
+/* Bytes moved at once from the transmit stream buffer to the connection */
+#define IIO_RTOS_TX_CHUNK	256
+#define IIO_LOOKUP_FNV_OFFSET	2166136261u
+#define IIO_LOOKUP_FNV_PRIME	16777619u
+/* Maximum length of a formatted piece of the context xml */
+#define IIO_XML_TOKEN_SIZE	256
+/* Decimation buffer attributes, of iio_init_param.buffer_decimation */
+#define IIO_XML_DECIM		NO_OS_BIT(0)
+/* TRACE_ATTRIBUTE debug attribute, when NO_OS_TRACE is defined */
+#define IIO_XML_TRACE		NO_OS_BIT(1)
+/* STATS_ATTRIBUTE debug attribute, when IIO_STATS is defined */
+#define IIO_XML_STATS		NO_OS_BIT(2)
+/* IRQ_LATENCY_ATTRIBUTE debug attribute, when NO_OS_IRQ_POLICY is defined */
+#define IIO_XML_IRQ_LATENCY	NO_OS_BIT(3)
+/* ALLOC_STATS_ATTRIBUTE debug attribute, when NO_OS_ALLOC_STATS is defined */
+#define IIO_XML_ALLOC_STATS	NO_OS_BIT(4)
+/* Conversion buffer attributes, of iio_init_param.buffer_conversion */
+#define IIO_XML_CONV		NO_OS_BIT(5)
+#ifdef IIO_STATS
+#define IIO_STATS_ADD(dev, field, val)	((dev)->stats.field += (val))
+#else
+#define IIO_STATS_ADD(dev, field, val)	do {} while (0)
+#endif
+/* Values of the attributes with a cache_ms, the oldest entry is replaced */
+#ifndef IIO_ATTR_CACHE_ENTRIES
+#define IIO_ATTR_CACHE_ENTRIES	16
+#endif
+/* Longer values are not cached */
+#ifndef IIO_ATTR_CACHE_VAL_SIZE
+#define IIO_ATTR_CACHE_VAL_SIZE	32
+#endif
+/* Header, context attributes, devices, triggers and end of the context */
+#define IIO_XML_NB_SECTIONS(desc)	((desc)->nb_devs + (desc)->nb_trigs + 3)
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
 
+enum iio_decim_mode {
+	IIO_DECIM_NONE,
+	IIO_DECIM_AVERAGE,
+	IIO_DECIM_CIC,
+	IIO_DECIM_MIN,
+	IIO_DECIM_MAX,
+	IIO_DECIM_PEAK,
+	IIO_DECIM_NB_MODES
+};
+
+static const char * const iio_decim_modes[IIO_DECIM_NB_MODES] = {
+	[IIO_DECIM_NONE] = "none",
+	[IIO_DECIM_AVERAGE] = "average",
+	[IIO_DECIM_CIC] = "cic",
+	[IIO_DECIM_MIN] = "min",
+	[IIO_DECIM_MAX] = "max",
+	[IIO_DECIM_PEAK] = "peak",
+};
+
+/**
+ * @struct iio_reg_bulk
+ * @brief Ranges of registers dumped by REG_BULK_ATTRIBUTE. A dump longer than
+ * the attribute read continues on the next read, the read after the last
+ * register gets an empty value and restarts the dump.
+ */
+struct iio_reg_bulk {
+	/* First register of each range */
+	uint32_t	start[IIO_REG_BULK_RANGES];
+	/* Number of registers of each range */
+	uint32_t	count[IIO_REG_BULK_RANGES];
+	uint32_t	nb_ranges;
+	/* Range and register in the range of the next read */
+	uint32_t	range;
+	uint32_t	pos;
+};
+
+/**
+ * @struct iio_decimator
+ * @brief State of the decimation stage of a device buffer. Arrays are indexed
+ * by the position of the channel in the scan.
+ */
+struct iio_decimator {
+	enum iio_decim_mode	mode;
+	uint32_t		factor;
+	/** Channels of the device, to get the scan type of the samples */
+	const struct iio_channel	*channels;
+	/** Scans pushed since the last output scan */
+	uint32_t		count;
+	/** Gain of the CIC filter, factor ^ IIO_DECIM_CIC_ORDER */
+	int64_t			cic_gain;
+	/** Sum, minimum or maximum of the pushed samples */
+	int64_t			acc[IIO_MAX_SCAN_CH];
+	/** CIC integrators and comb delays, wrapping as the filter allows */
+	uint64_t		integ[IIO_MAX_SCAN_CH][IIO_DECIM_CIC_ORDER];
+	uint64_t		comb[IIO_MAX_SCAN_CH][IIO_DECIM_CIC_ORDER];
+	uint8_t			scan[IIO_DECIM_MAX_SCAN];
+};
+
+enum iio_conv_format {
+	IIO_CONV_RAW,
+	IIO_CONV_S32,
+	IIO_CONV_S16,
+	IIO_CONV_Q31,
+	IIO_CONV_F32,
+	IIO_CONV_NB_FORMATS
+};
+
+static const char * const iio_conv_formats[IIO_CONV_NB_FORMATS] = {
+	[IIO_CONV_RAW] = "raw",
+	[IIO_CONV_S32] = "s32",
+	[IIO_CONV_S16] = "s16",
+	[IIO_CONV_Q31] = "q31",
+	[IIO_CONV_F32] = "f32",
+};
+
+/**
+ * @struct iio_conv_ch
+ * @brief Position and scan type of a sample in the raw and converted scans.
+ */
+struct iio_conv_ch {
+	uint16_t	in_offset;
+	uint16_t	out_offset;
+	/** Storage bytes in the raw scan */
+	uint8_t		bytes;
+	uint8_t		shift;
+	uint8_t		realbits;
+	bool		is_signed;
+	bool		is_big_endian;
+	/** Set for the samples sent as they are */
+	bool		copy;
+};
+
+/**
+ * @struct iio_conv
+ * @brief Conversion of the READBUF data of a device buffer. Channels are
+ * indexed by their position in the scan.
+ */
+struct iio_conv {
+	enum iio_conv_format	format;
+	/** Set while the opened buffer is converted */
+	bool			active;
+	/** Set if all the samples have the same scan type */
+	bool			flat;
+	uint32_t		nb_ch;
+	/** Bytes of a raw and of a converted scan */
+	uint32_t		in_scan;
+	uint32_t		out_scan;
+	struct iio_conv_ch	ch[IIO_MAX_SCAN_CH];
+	/** Converted scans not sent yet, len bytes of which idx were sent */
+	uint8_t			buf[IIO_CONV_BLOCK_SIZE];
+	uint32_t		len;
+	uint32_t		idx;
+	/** Bytes of buf handed to iiod by iio_read_buffer_block */
+	uint32_t		pending;
+};
+
 static char uart_buff[IIOD_CONN_BUFFER_SIZE];
 
 static char header[] =
@@ -102,6 +421,14 @@ static char header[] =
 	"<context name=\"xml\" description=\"no-OS " NO_OS_VERSION "\" >";
 static char header_end[] = "</context>";
 
+const struct scan_type iio_timestamp_scan_type = {
+	.sign = 's',
+	.realbits = 64,
+	.storagebits = 64,
+	.shift = 0,
+	.is_big_endian = false
+};
+
 static const char * const iio_chan_type_string[] = {
 	[IIO_VOLTAGE] = "voltage",
 	[IIO_CURRENT] = "current",
@@ -114,7 +441,8 @@ static const char * const iio_chan_type_string[] = {
 	[IIO_MAGN] = "magn",
 	[IIO_INCLI] = "incli",
 	[IIO_VELOCITY] = "velocity",
-	[IIO_ANGL] = "angl"
+	[IIO_ANGL] = "angl",
+	[IIO_TIMESTAMP] = "timestamp"
 };
 
 static const char * const iio_modifier_names[] = {
@@ -124,6 +452,23 @@ static const char * const iio_modifier_names[] = {
 	[IIO_MOD_TEMP_AMBIENT] = "ambient"
 };
 
+#ifdef IIO_ATTR_CACHE
+/* Value returned by the show of an attribute, see iio_attribute.cache_ms */
+struct iio_attr_cache_entry {
+	/* Attribute, NULL if the entry is free */
+	const struct iio_attribute *attr;
+	/* Instance the show was called for */
+	void *dev_instance;
+	/* Channel the show was called for, from iio_attr_cache_ch */
+	uint32_t ch;
+	/* Time of the show in milliseconds */
+	uint32_t time_ms;
+	/* Length of val, as returned by show */
+	uint32_t len;
+	char val[IIO_ATTR_CACHE_VAL_SIZE];
+};
+#endif
+
 /* Parameters used in show and store functions */
 struct attr_fun_params {
 	void			*dev_instance;
@@ -143,10 +488,40 @@ struct iio_buffer_priv {
 	uint32_t		raw_buf_len;
 	/* Set when this devices has buffer */
 	bool			initalized;
-	/* Set when calloc was used to initalize cb.buf */
+	/* Set when no_os_dma_alloc was used to initalize cb.buf */
 	bool			allocated;
 };
 
+#ifdef IIO_STATS
+/**
+ * @struct iio_dev_stats
+ * @brief Buffer counters of a device, read on STATS_ATTRIBUTE
+ */
+struct iio_dev_stats {
+	/** Bytes sent to the clients, compressed if it is enabled */
+	uint64_t		bytes_read;
+	/** Bytes received from the clients */
+	uint64_t		bytes_written;
+	/** Number of read_buffer and read_buffer_block calls */
+	uint32_t		read_calls;
+	/** Number of write_buffer calls */
+	uint32_t		write_calls;
+	/** Times -NO_OS_EOVERRUN was found on the device buffer */
+	uint32_t		overruns;
+};
+
+/**
+ * @struct iio_step_stats
+ * @brief Duration of iio_step, in microseconds
+ */
+struct iio_step_stats {
+	uint32_t		count;
+	uint32_t		last_us;
+	uint32_t		max_us;
+	uint64_t		total_us;
+};
+#endif
+
 /**
  * @struct iio_cntx_attr_priv
  * @brief Context attributes private structure
@@ -172,13 +547,104 @@ struct iio_dev_priv {
 	struct iio_device_data  dev_data;
 	/** Used to read debug attributes */
 	uint32_t		active_reg_addr;
+	/* Registers of REG_BULK_ATTRIBUTE, NULL until it is written */
+	struct iio_reg_bulk	*reg_bulk;
 	/** Device descriptor(describes channels and attributes) */
-	struct iio_device	*dev_descriptor;
+	const struct iio_device	*dev_descriptor;
 	/* Structure storing buffer related fields */
 	struct iio_buffer_priv buffer;
 	/* Set to -1 when no trigger is set*/
 	uint32_t		trig_idx;
+#ifdef IIO_RECORDER
+	/* Buffer owned by a recorder, clients can't open or close it */
+	bool			recorded;
+#endif
+	/* Block of compressed READBUF data, NULL if compression is disabled */
+	uint8_t			*comp_buf;
+	/* Bytes in comp_buf */
+	uint32_t		comp_len;
+	/* Bytes of comp_buf already sent */
+	uint32_t		comp_idx;
+	/* Bytes of comp_buf handed to iiod by iio_read_buffer_block */
+	uint32_t		comp_pending;
+	/* Decimation settings, NULL until a decimation attribute is written */
+	struct iio_decimator	*decim;
+	/* READBUF data conversion, NULL until IIO_CONV_ATTR is written */
+	struct iio_conv		*conv;
+	/* Last events of dev_descriptor->events, read by the event streams */
+	struct iio_event	*ev_history;
+	/* Number of events moved to ev_history, wraps around */
+	uint32_t		ev_seq;
+	/* Creates dev_instance for the devices probed after iio_init */
+	int32_t			(*probe)(void *ctx, void **dev);
+	void			*probe_ctx;
+	/* 0 once probed, -EAGAIN while probing, error if probe failed */
+	int32_t			probe_ret;
+#ifdef IIO_STATS
+	struct iio_dev_stats	stats;
+#endif
+};
+
+#ifdef NO_OS_NETWORKING
+/**
+ * @struct iio_udp_stream
+ * @brief Buffer data of a device streamed to a UDP client
+ */
+struct iio_udp_stream {
+	/** Streamed device, NULL if the stream is not used */
+	struct iio_dev_priv	*dev;
+	/** Client, peer.addr points to addr */
+	struct socket_address	peer;
+	char			addr[SOCKET_ADDRSTRLEN];
+	/** Sequence number of the next datagram */
+	uint32_t		seq;
+	/** Flags of the next datagram */
+	uint32_t		flags;
+	/** Size of the datagram in dgram not yet sent, socket being busy */
+	uint32_t		pending;
+	uint8_t			dgram[IIO_UDP_DGRAM_SIZE];
+};
+#endif
+
+#ifdef IIO_USB
+/**
+ * @struct iio_usb_conn
+ * @brief Connection carried by a pipe of the USB device
+ */
+struct iio_usb_conn {
+	/** Pipe of the connection */
+	struct no_os_usb_pipe	*pipe;
+	/** Session of the pipe served, once reopened it is a new connection */
+	uint32_t		session;
+	/** Set between iiod_conn_add and iiod_conn_remove, with its id */
+	bool			connected;
+	uint32_t		conn_id;
+};
+#endif
+
+#ifdef IIO_RECORDER
+/**
+ * @struct iio_recorder
+ * @brief Buffer data of a device captured to a file
+ */
+struct iio_recorder {
+	/** Recorded device, NULL if the recorder is not used */
+	struct iio_dev_priv	*dev;
+	FIL			file;
+	/** Record being filled */
+	uint8_t			record[IIO_REC_RECORD_SIZE];
+	/** Bytes of payload in record */
+	uint32_t		fill;
+	/** Data records written since the last index record */
+	uint32_t		nb_records;
+	/** Data bytes written to the file */
+	uint64_t		data_bytes;
+	/** Flags of the next index record */
+	uint32_t		flags;
+	/** First error of the capture, returned by iio_recorder_stop */
+	int32_t			error;
 };
+#endif
 
 /**
  * @struct iio_trig_priv
@@ -193,9 +659,105 @@ struct iio_trig_priv {
 	/** Physical instance of a trigger */
 	void	*instance;
 	/** Trigger descriptor(describes type of trigger and its attributes) */
-	struct iio_trigger *descriptor;
-	/** Set to true when the triggering condition is met */
-	bool	triggered;
+	const struct iio_trigger *descriptor;
+	/**
+	 * Attributes of the trigger. For asynchronous triggers, a copy of the
+	 * descriptor ones followed by the overruns attribute.
+	 */
+	const struct iio_attribute	*attributes;
+	/** Events of an asynchronous trigger, counted in interrupt context */
+	volatile uint32_t	raised;
+	/** Events served by iio_step */
+	uint32_t		served;
+	/** Events dropped, more than IIO_TRIG_MAX_PENDING being pending */
+	uint32_t		overruns;
+	/** Events of an asynchronous trigger to wait for before serving them */
+	uint32_t		batch;
+	/**
+	 * Devices using the trigger, bound when the trigger of a device is
+	 * set, so processing the trigger doesn't search for them
+	 */
+	struct iio_dev_priv	**devs;
+	uint32_t		nb_devs;
+};
+
+/**
+ * @struct iio_xml_buf
+ * @brief Window of the context xml to be written by the xml generators
+ */
+struct iio_xml_buf {
+	/** Destination. If NULL, the xml length is only counted */
+	char		*buf;
+	/** Offset in the xml of buf[0] */
+	uint32_t	offset;
+	/** Size of buf */
+	uint32_t	len;
+	/** Offset in the xml of the next generated byte */
+	uint32_t	pos;
+	/** Set to a negative value if the generation failed */
+	int32_t		ret;
+};
+
+#ifdef IIO_FREERTOS
+/* Data of one send queued for the transmit task, stored in tx_data */
+struct iio_rtos_tx_msg {
+	void		*conn;
+	uint32_t	len;
+};
+
+/* Function deferred to the worker task */
+struct iio_rtos_job {
+	void		(*fn)(void *ctx);
+	void		*ctx;
+};
+
+/**
+ * @struct iio_rtos
+ * @brief Tasks of the IIO server. The command task runs iio_step, the
+ * transmit task writes the responses to the connections and the worker task
+ * runs the asynchronous triggers and the deferred jobs.
+ */
+struct iio_rtos {
+	TaskHandle_t		cmd_task;
+	TaskHandle_t		tx_task;
+	TaskHandle_t		worker_task;
+	/* Serializes iio_step and the worker jobs */
+	SemaphoreHandle_t	lock;
+	/* struct iio_rtos_tx_msg, in the order of their data in tx_data */
+	QueueHandle_t		tx_msgs;
+	StreamBufferHandle_t	tx_data;
+	/* Set while the transmit task sends a message */
+	volatile bool		tx_busy;
+	/* struct iio_rtos_job */
+	QueueHandle_t		jobs;
+	/* Milliseconds the command task sleeps when there is nothing to do */
+	uint32_t		poll_ms;
+	uint8_t			tx_chunk[IIO_RTOS_TX_CHUNK];
+};
+#endif
+
+/* Kind of object stored in an entry of the lookup table */
+enum iio_lookup_kind {
+	IIO_LOOKUP_DEV,
+	IIO_LOOKUP_TRIG,
+	IIO_LOOKUP_CH_IN,
+	IIO_LOOKUP_CH_OUT,
+	IIO_LOOKUP_ATTR,
+};
+
+/**
+ * @struct iio_lookup_entry
+ * @brief Entry of the hash table used to resolve names received from clients
+ */
+struct iio_lookup_entry {
+	/** Device, channel list or attribute list the name belongs to */
+	const void		*owner;
+	/** Resolved object. NULL for empty entries */
+	const void		*item;
+	/** Hash of owner, kind and name */
+	uint32_t		hash;
+	/** enum iio_lookup_kind */
+	uint8_t			kind;
 };
 
 struct iio_desc {
@@ -204,12 +766,28 @@ struct iio_desc {
 	void			*phy_desc;
 	char			*xml_desc;
 	uint32_t		xml_size;
+	/* Offsets of the xml sections, when the xml is streamed */
+	uint32_t		*xml_sections;
 	struct iio_cntx_attr_priv *cntx_attributes;
 	uint32_t nb_cntx_attr;
 	struct iio_dev_priv	*devs;
 	uint32_t		nb_devs;
+	/* Devices still waiting for their probe to complete */
+	uint32_t		nb_probing;
 	struct iio_trig_priv	*trigs;
 	uint32_t		nb_trigs;
+	/* Storage of the device lists of the triggers */
+	struct iio_dev_priv	**trig_devs;
+	/* Set if clients can enable the compression of READBUF data */
+	bool			buffer_compression;
+	/* Set if devices have the decimation buffer attributes */
+	bool			buffer_decimation;
+	/* Set if devices have the conversion buffer attributes */
+	bool			buffer_conversion;
+	/* Hash table with devices, triggers, channels and attributes */
+	struct iio_lookup_entry	*lookup;
+	/* Number of entries in lookup minus one. It is a power of 2 */
+	uint32_t		lookup_mask;
 	struct no_os_uart_desc	*uart_desc;
 	int (*recv)(void *conn, uint8_t *buf, uint32_t len);
 	int (*send)(void *conn, uint8_t *buf, uint32_t len);
@@ -219,6 +797,44 @@ struct iio_desc {
 	struct tcp_socket_desc	*current_sock;
 	/* Instance of server socket */
 	struct tcp_socket_desc	*server;
+	/* Network of the UDP socket, set only for USE_NETWORK_UDP */
+	struct network_interface	*udp_net;
+	uint32_t		udp_id;
+	struct iio_udp_stream	*udp_streams;
+#endif
+#ifdef IIO_USB
+	/* USB device of USE_USB and the connections of its pipes */
+	struct no_os_usb_desc	*usb_desc;
+	struct iio_usb_conn	usb_conns[NO_OS_USB_MAX_PIPES];
+#endif
+#ifdef IIO_RECORDER
+	struct iio_recorder	*recorders;
+#endif
+#ifdef IIO_STATS
+	struct iio_step_stats	step_stats;
+#endif
+#ifdef IIO_ATTR_CACHE
+	struct iio_attr_cache_entry attr_cache[IIO_ATTR_CACHE_ENTRIES];
+	/* Entry replaced when there is no free one */
+	uint32_t		attr_cache_next;
+#endif
+#ifdef IIO_FREERTOS
+	/* Set once iio_rtos_start created the server tasks */
+	struct iio_rtos		*rtos;
+#endif
+#ifdef NO_OS_SCHED
+	/* Scheduler work running iio_step, see iio_sched_start */
+	struct no_os_sched_work	step_work;
+	/* Milliseconds between two iio_step while there is nothing to do */
+	uint32_t		sched_poll_ms;
+	/* Polling period once idle, 0 to keep sched_poll_ms */
+	uint32_t		sched_idle_poll_ms;
+	/* Milliseconds without command before using sched_idle_poll_ms */
+	uint32_t		sched_idle_ms;
+	/* Milliseconds polled without command, reset by iio_sched_wake */
+	volatile uint32_t	sched_idle_time;
+	/* Set while a buffer is open and the deep sleep lock is held */
+	bool			sched_deep_locked;
 #endif
 };
 
@@ -259,14 +875,83 @@ static int iio_recv(struct iiod_ctx *ctx, uint8_t *buf, uint32_t len)
 	return desc->recv(ctx->conn, buf, len);
 }
 
+#ifdef IIO_FREERTOS
+/**
+ * @brief Queue data to be sent by the transmit task, without blocking.
+ * @param desc - IIO descriptor.
+ * @param conn - Connection.
+ * @param buf - Data.
+ * @param len - Length of data.
+ * @return the number of bytes queued, 0 if the transmit buffer is full.
+ */
+static int iio_rtos_send(struct iio_desc *desc, void *conn, uint8_t *buf,
+			 uint32_t len)
+{
+	struct iio_rtos_tx_msg msg;
+
+	if (!uxQueueSpacesAvailable(desc->rtos->tx_msgs))
+		return 0;
+
+	msg.conn = conn;
+	msg.len = xStreamBufferSend(desc->rtos->tx_data, buf, len, 0);
+	if (!msg.len)
+		return 0;
+
+	xQueueSend(desc->rtos->tx_msgs, &msg, 0);
+
+	return msg.len;
+}
+#endif
+
 static int iio_send(struct iiod_ctx *ctx, uint8_t *buf, uint32_t len)
 {
 	struct iio_desc *desc = ctx->instance;
 
+#ifdef IIO_FREERTOS
+	if (desc->rtos)
+		return iio_rtos_send(desc, ctx->conn, buf, len);
+#endif
+
 	return desc->send(ctx->conn, buf, len);
 }
 
-static inline void _print_ch_id(char *buff, struct iio_channel *ch)
+#ifdef NO_OS_NETWORKING
+static int iio_sendv(struct iiod_ctx *ctx, const struct iiod_iovec *iov,
+		     uint32_t iovcnt)
+{
+	struct socket_iovec vec[2];
+	uint32_t i;
+
+#ifdef IIO_FREERTOS
+	struct iio_desc *desc = ctx->instance;
+	int ret, sent = 0;
+
+	/* The order of the responses is kept by the transmit queue */
+	if (desc->rtos) {
+		for (i = 0; i < iovcnt; i++) {
+			ret = iio_rtos_send(desc, ctx->conn, iov[i].base,
+					    iov[i].len);
+			sent += ret;
+			if ((uint32_t)ret < iov[i].len)
+				break;
+		}
+
+		return sent;
+	}
+#endif
+
+	/* iiod gathers at most the response header and a chunk of data */
+	iovcnt = no_os_min(iovcnt, NO_OS_ARRAY_SIZE(vec));
+	for (i = 0; i < iovcnt; i++) {
+		vec[i].base = iov[i].base;
+		vec[i].len = iov[i].len;
+	}
+
+	return socket_sendv(ctx->conn, vec, iovcnt);
+}
+#endif
+
+static inline void _print_ch_id(char *buff, const struct iio_channel *ch)
 {
 	if(ch->modified) {
 		sprintf(buff, "%s_%s", iio_chan_type_string[ch->ch_type],
@@ -287,221 +972,462 @@ static inline void _print_ch_id(char *buff, struct iio_channel *ch)
 }
 
 /**
- * @brief Get channel ID from a list of channels.
- * @param channel - Channel name.
- * @param desc - Device descriptor
- * @param ch_out - If "true" is output channel, if "false" is input channel.
- * @return Channel ID, or negative value if attribute is not found.
+ * @brief Compute the lookup table hash of a name (FNV-1a).
+ * @param owner - Object the name belongs to.
+ * @param kind - Kind of the named object.
+ * @param name - Name of the object.
+ * @return Hash value.
  */
-static inline struct iio_channel *iio_get_channel(const char *channel,
-		struct iio_device *desc, bool ch_out)
+static uint32_t iio_lookup_hash(const void *owner, uint8_t kind,
+				const char *name)
 {
-	int16_t i = 0;
-	char	ch_id[MAX_CHN_ID];
+	uintptr_t key = (uintptr_t)owner;
+	uint32_t hash = IIO_LOOKUP_FNV_OFFSET;
+	uint32_t i;
 
-	while (i < desc->num_ch) {
-		_print_ch_id(ch_id, &desc->channels[i]);
-		if (!strcmp(channel, ch_id) &&
-		    (desc->channels[i].ch_out == ch_out))
-			return &desc->channels[i];
-		i++;
+	for (i = 0; i < sizeof(key); i++) {
+		hash = (hash ^ (uint8_t)key) * IIO_LOOKUP_FNV_PRIME;
+		key >>= 8;
 	}
+	hash = (hash ^ kind) * IIO_LOOKUP_FNV_PRIME;
+	while (*name)
+		hash = (hash ^ (uint8_t)*name++) * IIO_LOOKUP_FNV_PRIME;
 
-	return NULL;
+	return hash;
 }
 
 /**
- * @brief Find interface with "device_name".
- * @param device_name - Device name.
- * @param iio_dev_privs - List of interfaces.
- * @return Interface pointer if interface is found, NULL otherwise.
+ * @brief Check if an entry of the lookup table is the searched one.
+ * @param entry - Lookup table entry with matching hash.
+ * @param owner - Object the name belongs to.
+ * @param kind - Kind of the named object.
+ * @param name - Name of the object.
+ * @return true if entry matches, false otherwise.
  */
-static struct iio_dev_priv *get_iio_device(struct iio_desc *desc,
-		const char *device_name)
+static bool iio_lookup_match(struct iio_lookup_entry *entry, const void *owner,
+			     uint8_t kind, const char *name)
 {
-	uint32_t i;
+	const struct iio_attribute *attr;
+	char ch_id[MAX_CHN_ID];
+
+	if (entry->owner != owner || entry->kind != kind)
+		return false;
+
+	switch (kind) {
+	case IIO_LOOKUP_DEV:
+		return !strcmp(((struct iio_dev_priv *)entry->item)->dev_id,
+			       name);
+	case IIO_LOOKUP_TRIG:
+		return !strcmp(((struct iio_trig_priv *)entry->item)->id, name);
+	case IIO_LOOKUP_CH_IN:
+	case IIO_LOOKUP_CH_OUT:
+		_print_ch_id(ch_id, entry->item);
+		return !strcmp(ch_id, name);
+	case IIO_LOOKUP_ATTR:
+		attr = entry->item;
+		return !strcmp(attr->name, name);
+	default:
+		return false;
+	}
+}
 
-	for (i = 0; i < desc->nb_devs; i++) {
-		if (strcmp(desc->devs[i].dev_id, device_name) == 0)
-			return &desc->devs[i];
+/**
+ * @brief Search an object in the lookup table.
+ * @param desc - IIO descriptor.
+ * @param owner - Object the name belongs to.
+ * @param kind - Kind of the named object.
+ * @param name - Name of the object.
+ * @return Pointer to the object if found, NULL otherwise.
+ */
+static void *iio_lookup(struct iio_desc *desc, const void *owner, uint8_t kind,
+			const char *name)
+{
+	struct iio_lookup_entry *entry;
+	uint32_t hash, i;
+
+	if (!desc->lookup || !owner)
+		return NULL;
+
+	hash = iio_lookup_hash(owner, kind, name);
+	/* Linear probing. The table always has empty entries */
+	for (i = hash & desc->lookup_mask; desc->lookup[i].item;
+	     i = (i + 1) & desc->lookup_mask) {
+		entry = &desc->lookup[i];
+		/* Channels and attributes are only read by the callers */
+		if (entry->hash == hash &&
+		    iio_lookup_match(entry, owner, kind, name))
+			return (void *)entry->item;
 	}
 
 	return NULL;
 }
 
 /**
- * @brief Find interface with "trigger_id".
- * @param trigger_id - Trigger id (trigger0, trigger1, etc.).
- * @param iio_trig_privs - List of interfaces.
- * @return Interface pointer if interface is found, NULL otherwise.
+ * @brief Add an object in the lookup table.
+ * If the name was already added for the owner (e.g. attribute lists shared by
+ * several channels), the first one is kept, as a linear search would do.
+ * @param desc - IIO descriptor.
+ * @param owner - Object the name belongs to.
+ * @param kind - Kind of the named object.
+ * @param name - Name of the object.
+ * @param item - Object to be returned by iio_lookup.
  */
-static struct iio_trig_priv *get_iio_trig_device(struct iio_desc *desc,
-		const char *trigger_id)
+static void iio_lookup_add(struct iio_desc *desc, const void *owner,
+			   uint8_t kind, const char *name, const void *item)
 {
-	uint32_t i;
+	uint32_t hash, i;
 
-	for (i = 0; i < desc->nb_trigs; i++) {
-		if (strcmp(desc->trigs[i].id, trigger_id) == 0)
-			return &desc->trigs[i];
-	}
+	if (iio_lookup(desc, owner, kind, name))
+		return;
 
-	return NULL;
+	hash = iio_lookup_hash(owner, kind, name);
+	for (i = hash & desc->lookup_mask; desc->lookup[i].item;
+	     i = (i + 1) & desc->lookup_mask)
+		;
+
+	desc->lookup[i].owner = owner;
+	desc->lookup[i].item = item;
+	desc->lookup[i].hash = hash;
+	desc->lookup[i].kind = kind;
 }
 
 /**
- * @brief Read all attributes from an attribute list.
- * @param device - Physical instance of a device.
- * @param buf - Buffer where values are read.
- * @param len - Maximum length of value to be stored in buf.
- * @param channel - Channel properties.
- * @param attributes - List of attributes to be read.
- * @return Number of bytes read or negative value in case of error.
+ * @brief Add or count the attributes of a list in the lookup table.
+ * @param desc - IIO descriptor. If desc->lookup is NULL, only count.
+ * @param attributes - Array of attributes. Can be NULL.
+ * @return Number of attributes.
  */
-static int iio_read_all_attr(struct attr_fun_params *params,
-			     struct iio_attribute *attributes)
+static uint32_t iio_lookup_add_attrs(struct iio_desc *desc,
+				     const struct iio_attribute *attributes)
 {
-	/* TODO Not sure if working corectly */
-	return -EINVAL;
+	uint32_t i = 0;
 
-#if 0
-	int16_t i = 0, j = 0;
-	char local_buf[256];
-	int attr_length;
-	uint32_t *pattr_length;
-
-	while (attributes[i].name) {
-		attr_length = attributes[i].show(params->dev_instance,
-						 local_buf, params->len,
-						 params->ch_info,
-						 attributes[i].priv);
-		if (NO_OS_IS_ERR_VALUE(attr_length))
-			attr_length = snprintf(local_buf, params->len, "%d",
-					       attr_length);
-
-		attr_length += 1;//Add '\0' to the count
-		pattr_length = (uint32_t *)(params->buf + j);
-		if (j + 4 > params->len)
-			return -EINVAL;
-		*pattr_length = no_os_bswap_constant_32(attr_length);
-		j += 4;
-		if (attr_length >= 0) {
-			if (attr_length + j > params->len)
-				return -EINVAL;
-			sprintf(params->buf + j, "%s", local_buf);
-			if (attr_length & 0x3) /* multiple of 4 */
-				attr_length = ((attr_length >> 2) + 1) << 2;
-			j += attr_length;
-		}
-		i++;
-	}
-	if (j == 0)
-		return -ENOENT;
+	if (!attributes)
+		return 0;
 
-	return j;
-#endif
+	for (i = 0; attributes[i].name; i++)
+		if (desc->lookup)
+			iio_lookup_add(desc, attributes, IIO_LOOKUP_ATTR,
+				       attributes[i].name, &attributes[i]);
+
+	return i;
 }
 
 /**
- * @brief Write all attributes from an attribute list.
- * @param device - Physical instance of a device.
- * @param buf - Values to be written.
- * @param len - Length of buf.
- * @param channel - Channel properties.
- * @param attributes - List of attributes to be written.
- * @return Number of written bytes or negative value in case of error.
+ * @brief Add or count all objects accessed by name in the lookup table.
+ * @param desc - IIO descriptor. If desc->lookup is NULL, only count.
+ * @return Number of objects.
  */
-static int iio_write_all_attr(struct attr_fun_params *params,
-			      struct iio_attribute *attributes)
+static uint32_t iio_lookup_add_all(struct iio_desc *desc)
 {
-	/* TODO Not sure if working corectly */
-	return -EINVAL;
+	const struct iio_device *dev;
+	const struct iio_channel *ch;
+	char ch_id[MAX_CHN_ID];
+	uint32_t i, j, n = 0;
 
-#if 0
-	int16_t i = 0, j = 0;
-	int16_t attr_length;
+	for (i = 0; i < desc->nb_devs; i++) {
+		if (desc->lookup)
+			iio_lookup_add(desc, desc, IIO_LOOKUP_DEV,
+				       desc->devs[i].dev_id, &desc->devs[i]);
+		n++;
+
+		dev = desc->devs[i].dev_descriptor;
+		n += iio_lookup_add_attrs(desc, dev->attributes);
+		n += iio_lookup_add_attrs(desc, dev->debug_attributes);
+		n += iio_lookup_add_attrs(desc, dev->buffer_attributes);
+		if (!dev->channels)
+			continue;
 
-	while (attributes[i].name) {
-		attr_length = no_os_bswap_constant_32((uint32_t)(params->buf + j));
-		j += 4;
-		attributes[i].store(params->dev_instance, (params->buf + j),
-				    attr_length, params->ch_info,
-				    attributes[i].priv);
-		j += attr_length;
-		if (j & 0x3)
-			j = ((j >> 2) + 1) << 2;
-		i++;
+		for (j = 0; j < dev->num_ch; j++) {
+			ch = &dev->channels[j];
+			if (desc->lookup) {
+				_print_ch_id(ch_id, ch);
+				iio_lookup_add(desc, dev, ch->ch_out ?
+					       IIO_LOOKUP_CH_OUT :
+					       IIO_LOOKUP_CH_IN, ch_id, ch);
+			}
+			n++;
+			n += iio_lookup_add_attrs(desc, ch->attributes);
+		}
 	}
 
-	if (params->len == 0)
-		return -ENOENT;
+	for (i = 0; i < desc->nb_trigs; i++) {
+		if (desc->lookup)
+			iio_lookup_add(desc, desc, IIO_LOOKUP_TRIG,
+				       desc->trigs[i].id, &desc->trigs[i]);
+		n++;
+		n += iio_lookup_add_attrs(desc, desc->trigs[i].attributes);
+	}
 
-	return params->len;
-#endif
+	return n;
 }
 
 /**
- * @brief Read/write attribute.
- * @param params - Structure describing parameters for store and show functions
- * @param attributes - Array of attributes.
- * @param attr_name - Attribute name to be modified
- * @param is_write -If it has value "1", writes attribute, otherwise reads
- * 		attribute.
- * @return Length of chars written/read or negative value in case of error.
+ * @brief Build the lookup table used to resolve names in O(1).
+ * @param desc - IIO descriptor with initialized devices and triggers.
+ * @return 0 in case of success or negative value otherwise.
  */
-static int iio_rd_wr_attribute(struct attr_fun_params *params,
-			       struct iio_attribute *attributes,
-			       const char *attr_name,
-			       bool is_write)
+static int32_t iio_init_lookup(struct iio_desc *desc)
 {
-	int16_t i = 0;
+	uint32_t n, size;
 
-	/* Search attribute */
-	while (attributes[i].name) {
-		if (!strcmp(attr_name, attributes[i].name))
-			break;
-		i++;
-	}
+	/* Keep the load factor under 1/2 */
+	n = iio_lookup_add_all(desc);
+	size = 1;
+	while (size < 2 * n + 1)
+		size <<= 1;
 
-	if (!attributes[i].name)
-		return -ENOENT;
+	desc->lookup = (struct iio_lookup_entry *)no_os_calloc(size,
+			sizeof(*desc->lookup));
+	if (!desc->lookup)
+		return -ENOMEM;
 
-	if (is_write) {
-		if (!attributes[i].store)
-			return -ENOENT;
+	desc->lookup_mask = size - 1;
+	iio_lookup_add_all(desc);
 
-		return attributes[i].store(params->dev_instance, params->buf,
-					   params->len, params->ch_info,
-					   attributes[i].priv);
-	} else {
-		if (!attributes[i].show)
-			return -ENOENT;
-		return attributes[i].show(params->dev_instance, params->buf,
-					  params->len, params->ch_info,
-					  attributes[i].priv);
-	}
+	return 0;
 }
 
-/* Read a device register. The register address to read is set on
- * in desc->active_reg_addr in the function set_demo_reg_attr
+/**
+ * @brief Get channel ID from a list of channels.
+ * @param desc - IIO descriptor.
+ * @param channel - Channel name.
+ * @param dev - Device descriptor
+ * @param ch_out - If "true" is output channel, if "false" is input channel.
+ * @return Channel ID, or negative value if attribute is not found.
  */
-static int32_t debug_reg_read(struct iio_dev_priv *dev, char *buf, uint32_t len)
+static inline const struct iio_channel *iio_get_channel(struct iio_desc *desc,
+		const char *channel, const struct iio_device *dev, bool ch_out)
 {
-	uint32_t		value;
-	int32_t			ret;
-
-	value = 0;
-	ret = dev->dev_descriptor->debug_reg_read(dev->dev_instance,
-			dev->active_reg_addr,
-			&value);
-	if (NO_OS_IS_ERR_VALUE(ret))
-		return ret;
-
-	return snprintf(buf, len, "%"PRIu32"", value);
+	return iio_lookup(desc, dev, ch_out ? IIO_LOOKUP_CH_OUT :
+			  IIO_LOOKUP_CH_IN, channel);
 }
 
-/* Flow of reading and writing registers. This is how iio works for
- * direct_reg_access attribute:
- * Read register:
+/**
+ * @brief Find interface with "device_name".
+ * @param device_name - Device name.
+ * @param iio_dev_privs - List of interfaces.
+ * @return Interface pointer if interface is found, NULL otherwise.
+ */
+static struct iio_dev_priv *get_iio_device(struct iio_desc *desc,
+		const char *device_name)
+{
+	return iio_lookup(desc, desc, IIO_LOOKUP_DEV, device_name);
+}
+
+/**
+ * @brief Find interface with "trigger_id".
+ * @param trigger_id - Trigger id (trigger0, trigger1, etc.).
+ * @param iio_trig_privs - List of interfaces.
+ * @return Interface pointer if interface is found, NULL otherwise.
+ */
+static struct iio_trig_priv *get_iio_trig_device(struct iio_desc *desc,
+		const char *trigger_id)
+{
+	return iio_lookup(desc, desc, IIO_LOOKUP_TRIG, trigger_id);
+}
+
+/**
+ * @brief Call the show or store function of an attribute.
+ * @param params - Structure describing parameters for store and show functions
+ * @param attribute - Attribute to be read or written.
+ * @param is_write - If true, writes attribute, otherwise reads attribute.
+ * @return Length of chars written/read or negative value in case of error.
+ */
+static int iio_call_attribute(struct attr_fun_params *params,
+			      const struct iio_attribute *attribute,
+			      bool is_write)
+{
+	if (is_write) {
+		if (!attribute->store)
+			return -ENOENT;
+
+		return attribute->store(params->dev_instance, params->buf,
+					params->len, params->ch_info,
+					attribute->priv);
+	} else {
+		if (!attribute->show)
+			return -ENOENT;
+		return attribute->show(params->dev_instance, params->buf,
+				       params->len, params->ch_info,
+				       attribute->priv);
+	}
+}
+
+#ifdef IIO_ATTR_CACHE
+/**
+ * @brief Get the time of the attribute cache entries.
+ * @return Time in milliseconds, wrapping around.
+ */
+static uint32_t iio_attr_cache_time_ms(void)
+{
+	struct no_os_time t = no_os_get_time();
+
+	return t.s * 1000 + t.us / 1000;
+}
+
+/**
+ * @brief Get the channel key of a cache entry.
+ * @param ch_info - Channel of the attribute, NULL for other attributes.
+ * @return Key, unique for the channels of a device.
+ */
+static uint32_t iio_attr_cache_ch(const struct iio_ch_info *ch_info)
+{
+	if (!ch_info)
+		return 0;
+
+	return NO_OS_BIT(31) | (ch_info->ch_out ? NO_OS_BIT(30) : 0) |
+	       ((uint32_t)ch_info->type << 16) | (uint16_t)ch_info->ch_num;
+}
+
+/**
+ * @brief Call the show function of an attribute, unless its value was read
+ * less than attribute->cache_ms ago.
+ * @param desc - IIO descriptor.
+ * @param params - Structure describing parameters for the show function.
+ * @param attribute - Attribute to be read, with a cache_ms.
+ * @return Length of chars read or negative value in case of error.
+ */
+static int iio_attr_cache_show(struct iio_desc *desc,
+			       struct attr_fun_params *params,
+			       const struct iio_attribute *attribute)
+{
+	struct iio_attr_cache_entry *entry = NULL;
+	uint32_t ch = iio_attr_cache_ch(params->ch_info);
+	uint32_t now = iio_attr_cache_time_ms();
+	uint32_t i;
+	int ret;
+
+	for (i = 0; i < IIO_ATTR_CACHE_ENTRIES; i++) {
+		if (desc->attr_cache[i].attr == attribute &&
+		    desc->attr_cache[i].dev_instance == params->dev_instance &&
+		    desc->attr_cache[i].ch == ch) {
+			entry = &desc->attr_cache[i];
+			break;
+		}
+		if (!entry && !desc->attr_cache[i].attr)
+			entry = &desc->attr_cache[i];
+	}
+
+	if (entry && entry->attr && entry->len < params->len &&
+	    (attribute->cache_ms == IIO_ATTR_CACHE_UNTIL_WRITE ||
+	     now - entry->time_ms < attribute->cache_ms)) {
+		memcpy(params->buf, entry->val, entry->len);
+		params->buf[entry->len] = '\0';
+
+		return entry->len;
+	}
+
+	ret = iio_call_attribute(params, attribute, false);
+	if (ret < 0 || ret >= IIO_ATTR_CACHE_VAL_SIZE ||
+	    (uint32_t)ret > params->len)
+		return ret;
+
+	if (!entry) {
+		entry = &desc->attr_cache[desc->attr_cache_next];
+		desc->attr_cache_next = (desc->attr_cache_next + 1) %
+					IIO_ATTR_CACHE_ENTRIES;
+	}
+	entry->attr = attribute;
+	entry->dev_instance = params->dev_instance;
+	entry->ch = ch;
+	entry->time_ms = now;
+	entry->len = ret;
+	memcpy(entry->val, params->buf, ret);
+
+	return ret;
+}
+#endif
+
+/**
+ * @brief Drop the cached attribute values of a device, for example after
+ * changing its settings outside of IIO. Does nothing without IIO_ATTR_CACHE.
+ * @param desc - IIO descriptor.
+ * @param dev_instance - Instance of the device or trigger, NULL for all.
+ */
+void iio_attr_cache_invalidate(struct iio_desc *desc, void *dev_instance)
+{
+#ifdef IIO_ATTR_CACHE
+	uint32_t i;
+
+	if (!desc)
+		return;
+
+	for (i = 0; i < IIO_ATTR_CACHE_ENTRIES; i++)
+		if (!dev_instance ||
+		    desc->attr_cache[i].dev_instance == dev_instance)
+			desc->attr_cache[i].attr = NULL;
+#endif
+}
+
+/**
+ * @brief Read/write a single attribute, using the value cache for reads of
+ * attributes with a cache_ms.
+ * @param desc - IIO descriptor.
+ * @param params - Structure describing parameters for store and show functions
+ * @param attribute - Attribute to be read or written.
+ * @param is_write - If true, writes attribute, otherwise reads attribute.
+ * @return Length of chars written/read or negative value in case of error.
+ */
+static int iio_call_attribute_cached(struct iio_desc *desc,
+				     struct attr_fun_params *params,
+				     const struct iio_attribute *attribute,
+				     bool is_write)
+{
+#ifdef IIO_ATTR_CACHE
+	if (!is_write && attribute->cache_ms && attribute->show)
+		return iio_attr_cache_show(desc, params, attribute);
+#endif
+
+	return iio_call_attribute(params, attribute, is_write);
+}
+
+/**
+ * @brief Read/write attribute.
+ * @param desc - IIO descriptor.
+ * @param params - Structure describing parameters for store and show functions
+ * @param attributes - Array of attributes.
+ * @param attr_name - Attribute name to be modified
+ * @param is_write -If it has value "1", writes attribute, otherwise reads
+ * 		attribute.
+ * @return Length of chars written/read or negative value in case of error.
+ */
+static int iio_rd_wr_attribute(struct iio_desc *desc,
+			       struct attr_fun_params *params,
+			       const struct iio_attribute *attributes,
+			       const char *attr_name,
+			       bool is_write)
+{
+	const struct iio_attribute *attribute;
+
+	attribute = iio_lookup(desc, attributes, IIO_LOOKUP_ATTR, attr_name);
+	if (!attribute)
+		return -ENOENT;
+
+	return iio_call_attribute_cached(desc, params, attribute, is_write);
+}
+
+/* Read a device register. The register address to read is set on
+ * in desc->active_reg_addr in the function set_demo_reg_attr
+ */
+static int32_t debug_reg_read(struct iio_dev_priv *dev, char *buf, uint32_t len)
+{
+	uint32_t		value;
+	int32_t			ret;
+
+	value = 0;
+	ret = dev->dev_descriptor->debug_reg_read(dev->dev_instance,
+			dev->active_reg_addr,
+			&value);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	return snprintf(buf, len, "%"PRIu32"", value);
+}
+
+/* Flow of reading and writing registers. This is how iio works for
+ * direct_reg_access attribute:
+ * Read register:
  * 	   //Reg_addr in decimal
  * 	   reg_addr = "10";
  * 	1. debug_reg_write(dev, reg_addr, len);
@@ -538,1022 +1464,4773 @@ static int32_t debug_reg_write(struct iio_dev_priv *dev, const char *buf,
 	return len;
 }
 
-static int32_t __iio_str_parse(char *buf, int32_t *integer, int32_t *_fract,
-			       bool scale_db)
+/**
+ * @brief Read consecutive registers, in bursts when the driver supports them.
+ * @param dev - Device.
+ * @param reg - First register.
+ * @param vals - Values of the registers.
+ * @param nb_regs - Number of registers.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t iio_reg_bulk_read(struct iio_dev_priv *dev, uint32_t reg,
+				 uint32_t *vals, uint32_t nb_regs)
 {
-	char *p;
-
-	p = strtok(buf, ".");
-	if (p == NULL)
-		return -EINVAL;
-
-	*integer = strtol(p, NULL, 0);
+	const struct iio_device *d = dev->dev_descriptor;
+	uint32_t i;
+	int32_t ret;
 
-	if (scale_db) {
-		p = strtok(NULL, "db");
-		if (p == NULL)
-			p = strtok(NULL, " db");
-	} else
-		p = strtok(NULL, "\n");
+	if (d->debug_reg_read_bulk)
+		return d->debug_reg_read_bulk(dev->dev_instance, reg, vals,
+					      nb_regs);
 
-	if (p == NULL)
-		return -EINVAL;
+	if (!d->debug_reg_read)
+		return -ENOENT;
 
-	*_fract = strtol(p, NULL, 10);
+	for (i = 0; i < nb_regs; i++) {
+		ret = d->debug_reg_read(dev->dev_instance, reg + i, &vals[i]);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+	}
 
 	return 0;
 }
 
-static int32_t _iio_fract_interpret(int32_t fract, int32_t subunits)
+/**
+ * @brief Read the next part of the REG_BULK_ATTRIBUTE dump. Only the
+ * registers whose line fits in buf are read.
+ * @param dev - Device.
+ * @param buf - Where the "addr=value" lines are stored.
+ * @param len - Maximum length of buf.
+ * @return Length of the lines, 0 once the dump is done, negative error code
+ * otherwise.
+ */
+static int32_t iio_reg_bulk_show(struct iio_dev_priv *dev, char *buf,
+				 uint32_t len)
 {
-	int32_t temp = fract;
+	struct iio_reg_bulk *bulk = dev->reg_bulk;
+	uint32_t vals[IIO_REG_BULK_CHUNK];
+	uint32_t i, n, reg, j = 0;
+	int32_t ret;
 
-	while ((subunits != 0) || (temp != 0)) {
-		temp /= 10;
-		subunits /= 10;
-		if (!temp)
+	if (!bulk || !bulk->nb_ranges)
+		return -EINVAL;
+
+	if (!len)
+		return -ENOMEM;
+
+	if (bulk->range == bulk->nb_ranges) {
+		bulk->range = 0;
+		bulk->pos = 0;
+		buf[0] = '\0';
+		return 0;
+	}
+
+	while (bulk->range < bulk->nb_ranges) {
+		n = no_os_min(bulk->count[bulk->range] - bulk->pos,
+			      IIO_REG_BULK_CHUNK);
+		n = no_os_min(n, (len - j - 1) / (IIO_REG_BULK_LINE - 1));
+		if (!n)
 			break;
-		if (subunits <= 1)
-			fract /= 10;
+
+		reg = bulk->start[bulk->range] + bulk->pos;
+		ret = iio_reg_bulk_read(dev, reg, vals, n);
+		if (ret)
+			return ret;
+
+		for (i = 0; i < n; i++)
+			j += snprintf(buf + j, len - j,
+				      "0x%"PRIx32"=0x%"PRIx32"\n", reg + i,
+				      vals[i]);
+
+		bulk->pos += n;
+		if (bulk->pos == bulk->count[bulk->range]) {
+			bulk->range++;
+			bulk->pos = 0;
+		}
 	}
 
-	return fract * subunits;
+	if (!j)
+		return -ENOMEM;
+
+	return j;
 }
 
-int32_t iio_parse_value(char *buf, enum iio_val fmt, int32_t *val,
-			int32_t *val2)
+/**
+ * @brief Parse a REG_BULK_ATTRIBUTE value, writing the "addr=value" registers
+ * in their order and replacing the dumped ranges by the ones of the value,
+ * if any. Items are separated by spaces, commas or new lines.
+ * @param dev - Device.
+ * @param buf - Value.
+ * @param len - Length of the value.
+ * @return len in case of success, negative error code otherwise.
+ */
+static int32_t iio_reg_bulk_store(struct iio_dev_priv *dev, const char *buf,
+				  uint32_t len)
 {
-	int32_t ret = 0;
-	int32_t integer, _fract = 0;
-	char ch;
+	uint32_t start[IIO_REG_BULK_RANGES], count[IIO_REG_BULK_RANGES];
+	uint32_t addr, val, nb_ranges = 0;
+	const char *p = buf;
+	char *end;
+	int32_t ret;
 
-	switch (fmt) {
-	case IIO_VAL_INT:
-		integer = strtol(buf, NULL, 0);
-		break;
-	case IIO_VAL_INT_PLUS_MICRO_DB:
-		ret = __iio_str_parse(buf, &integer, &_fract, true);
-		if (ret < 0)
-			return ret;
-		_fract = _iio_fract_interpret(_fract, 1000000);
-		break;
-	case IIO_VAL_INT_PLUS_MICRO:
-		ret = __iio_str_parse(buf, &integer, &_fract, false);
-		if (ret < 0)
-			return ret;
-		_fract = _iio_fract_interpret(_fract, 1000000);
-		break;
-	case IIO_VAL_INT_PLUS_NANO:
-		ret = __iio_str_parse(buf, &integer, &_fract, false);
-		if (ret < 0)
-			return ret;
-		_fract = _iio_fract_interpret(_fract, 1000000000);
-		break;
-	case IIO_VAL_FRACTIONAL:
-		ret = __iio_str_parse(buf, &integer, &_fract, false);
-		if (ret < 0)
-			return ret;
-		break;
-	case IIO_VAL_CHAR:
-		if (sscanf(buf, "%c", &ch) != 1)
+	while (1) {
+		while (*p == ' ' || *p == ',' || *p == '\n' || *p == '\r' ||
+		       *p == '\t')
+			p++;
+		if (!*p)
+			break;
+
+		addr = strtoul(p, &end, 0);
+		if (end == p)
 			return -EINVAL;
-		integer = ch;
-		break;
-	default:
-		return -EINVAL;
-	}
+		p = end;
 
-	if (val)
-		*val = integer;
-	if (val2)
-		*val2 = _fract;
+		if (*p == '=') {
+			val = strtoul(++p, &end, 0);
+			if (end == p)
+				return -EINVAL;
+			p = end;
 
-	return ret;
-}
+			if (!dev->dev_descriptor->debug_reg_write)
+				return -ENOENT;
 
-int iio_format_value(char *buf, uint32_t len, enum iio_val fmt,
-		     int32_t size, int32_t *vals)
-{
-	uint64_t tmp;
-	int32_t integer, fractional;
-	bool dB = false;
-	int32_t i = 0;
-	uint32_t l = 0;
+			ret = dev->dev_descriptor->debug_reg_write(
+				      dev->dev_instance, addr, val);
+			if (NO_OS_IS_ERR_VALUE(ret))
+				return ret;
+			continue;
+		}
 
-	switch (fmt) {
-	case IIO_VAL_INT:
-		return snprintf(buf, len, "%"PRIi32"", vals[0]);
-	case IIO_VAL_INT_PLUS_MICRO_DB:
-		dB = true;
-	/* intentional fall through */
-	case IIO_VAL_INT_PLUS_MICRO:
-		return snprintf(buf, len, "%"PRIi32".%06"PRIu32"%s", vals[0],
-				(uint32_t)vals[1], dB ? " dB" : "");
-	case IIO_VAL_INT_PLUS_NANO:
-		return snprintf(buf, len, "%"PRIi32".%09"PRIu32"", vals[0],
-				(uint32_t)vals[1]);
-	case IIO_VAL_FRACTIONAL:
-		tmp = no_os_div_s64((int64_t)vals[0] * 1000000000LL, vals[1]);
-		fractional = vals[1];
-		integer = (int32_t)no_os_div_s64_rem(tmp, 1000000000, &fractional);
-		return snprintf(buf, len, "%"PRIi32".%09u", integer,
-				abs(fractional));
-	case IIO_VAL_FRACTIONAL_LOG2:
-		tmp = no_os_shift_right((int64_t)vals[0] * 1000000000LL, vals[1]);
-		integer = (int32_t)no_os_div_s64_rem(tmp, 1000000000LL, &fractional);
-		return snprintf(buf, len, "%"PRIi32".%09u", integer,
-				abs(fractional));
-	case IIO_VAL_INT_MULTIPLE: {
-		while (i < size) {
-			l += snprintf(&buf[l], len - l, "%"PRIi32" ", vals[i]);
-			if (l >= len)
-				break;
-			i++;
+		if (nb_ranges == IIO_REG_BULK_RANGES)
+			return -ENOSPC;
+
+		start[nb_ranges] = addr;
+		count[nb_ranges] = 1;
+		if (*p == '-') {
+			val = strtoul(++p, &end, 0);
+			if (end == p || val < addr)
+				return -EINVAL;
+			p = end;
+			count[nb_ranges] = val - addr + 1;
 		}
-		return l;
+		nb_ranges++;
 	}
-	case IIO_VAL_CHAR:
-		return snprintf(buf, len, "%c", (char)vals[0]);
-	default:
-		return 0;
+
+	if (!nb_ranges)
+		return len;
+
+	if (!dev->reg_bulk) {
+		dev->reg_bulk = no_os_calloc(1, sizeof(*dev->reg_bulk));
+		if (!dev->reg_bulk)
+			return -ENOMEM;
 	}
+
+	memcpy(dev->reg_bulk->start, start, nb_ranges * sizeof(*start));
+	memcpy(dev->reg_bulk->count, count, nb_ranges * sizeof(*count));
+	dev->reg_bulk->nb_ranges = nb_ranges;
+	dev->reg_bulk->range = 0;
+	dev->reg_bulk->pos = 0;
+
+	return len;
 }
 
-static struct iio_attribute *get_attributes(enum iio_attr_type type,
-		struct iio_dev_priv *dev,
-		struct iio_channel *ch)
+#ifdef IIO_STATS
+/**
+ * @brief Get the time used to measure the duration of iio_step.
+ * @return Time in microseconds, wrapping around.
+ */
+static uint32_t iio_stats_time_us(void)
 {
-	switch (type) {
-	case IIO_ATTR_TYPE_DEBUG:
-		return dev->dev_descriptor->debug_attributes;
-		break;
-	case IIO_ATTR_TYPE_DEVICE:
-		return dev->dev_descriptor->attributes;
-		break;
-	case IIO_ATTR_TYPE_BUFFER:
-		return dev->dev_descriptor->buffer_attributes;
-		break;
-	case IIO_ATTR_TYPE_CH_IN:
-	case IIO_ATTR_TYPE_CH_OUT:
-		return ch->attributes;
-	}
+	struct no_os_time t = no_os_get_time();
 
-	return NULL;
+	return t.s * 1000000 + t.us;
 }
 
 /**
- * @brief Returns trigger attributes.
- * @param type - Attribute type.
- * @param trig - Trigger instance.
- * @return Attributes pointer if attributes exist, NULL otherwise.
+ * @brief Read STATS_ATTRIBUTE: the counters of dev, the duration of iio_step
+ * and, for each kind of command received, the number of commands, the longest
+ * latency and the iiod_cmd_stats.hist latency histogram.
+ * @param desc - IIO descriptor.
+ * @param dev - Device.
+ * @param buf - Where to write the value.
+ * @param len - Size of buf.
+ * @return Number of bytes written in buf.
  */
-static struct iio_attribute *get_trig_attributes(enum iio_attr_type type,
-		struct iio_trig_priv *trig)
+static int iio_stats_show(struct iio_desc *desc, struct iio_dev_priv *dev,
+			  char *buf, uint32_t len)
 {
-	switch (type) {
-	/* Only device type attributes allowed for triggers */
-	case IIO_ATTR_TYPE_DEVICE:
-		return trig->descriptor->attributes;
-		break;
-	default:
-		break;
+	struct iio_step_stats *step = &desc->step_stats;
+	struct iiod_cmd_stats cmd;
+	const char *name;
+	uint32_t i, j, pos;
+
+	pos = snprintf(buf, len,
+		       "bytes_read %"PRIu64"\nbytes_written %"PRIu64"\n"
+		       "read_calls %"PRIu32"\nwrite_calls %"PRIu32"\n"
+		       "overruns %"PRIu32"\nunderruns %"PRIu32"\n"
+		       "step_count %"PRIu32"\nstep_last_us %"PRIu32"\n"
+		       "step_max_us %"PRIu32"\nstep_avg_us %"PRIu64"\n"
+		       "step_total_us %"PRIu64"\n",
+		       dev->stats.bytes_read, dev->stats.bytes_written,
+		       dev->stats.read_calls, dev->stats.write_calls,
+		       dev->stats.overruns, dev->buffer.public.underruns,
+		       step->count, step->last_us, step->max_us,
+		       step->count ? step->total_us / step->count : 0,
+		       step->total_us);
+
+	for (i = 0; pos < len &&
+	     !iiod_get_cmd_stats(desc->iiod, i, &name, &cmd); i++) {
+		if (!cmd.count)
+			continue;
+
+		pos += snprintf(buf + pos, len - pos,
+				"%s %"PRIu32" max_us %"PRIu32" hist", name,
+				cmd.count, cmd.max_us);
+		for (j = 0; pos < len && j < IIOD_LAT_BUCKETS; j++)
+			pos += snprintf(buf + pos, len - pos, " %"PRIu32,
+					cmd.hist[j]);
+		if (pos < len)
+			pos += snprintf(buf + pos, len - pos, "\n");
 	}
 
-	return NULL;
+	return no_os_min(pos, len - 1);
 }
 
 /**
- * @brief Read global attribute of a device.
- * @param ctx - IIO instance and conn instance
- * @param device - String containing device name.
- * @param attr - String containing attribute name.
- * @param buf - Buffer where value is read.
- * @param len - Maximum length of value to be stored in buf.
- * @return Number of bytes read.
+ * @brief Write STATS_ATTRIBUTE: clear all the counters, whatever the value.
+ * @param desc - IIO descriptor.
+ * @param dev - Device.
+ * @param len - Length of the value.
+ * @return len.
  */
-static int iio_read_attr(struct iiod_ctx *ctx, const char *device,
-			 struct iiod_attr *attr, char *buf, uint32_t len)
+static int iio_stats_reset(struct iio_desc *desc, struct iio_dev_priv *dev,
+			   uint32_t len)
 {
-	struct iio_dev_priv *dev;
-	struct iio_trig_priv *trig_dev;
-	struct iio_ch_info ch_info;
-	struct iio_channel *ch = NULL;
-	struct attr_fun_params params;
-	struct iio_attribute *attributes;
-	int8_t ch_out;
+	memset(&dev->stats, 0, sizeof(dev->stats));
+	dev->buffer.public.underruns = 0;
+	memset(&desc->step_stats, 0, sizeof(desc->step_stats));
+	iiod_reset_cmd_stats(desc->iiod);
 
-	dev = get_iio_device(ctx->instance, device);
+	return len;
+}
+#endif
 
-	/* If IIO device with given name is found, handle reading of attributes */
-	if (dev) {
-		if (attr->type == IIO_ATTR_TYPE_DEBUG &&
-		    strcmp(attr->name, REG_ACCESS_ATTRIBUTE) == 0) {
-			if (dev->dev_descriptor->debug_reg_read)
+#ifdef NO_OS_IRQ_POLICY
+/**
+ * @brief Write IRQ_LATENCY_ATTRIBUTE: clear the latency counters of the active
+ * interrupt policy, whatever the value.
+ * @param len - Length of the value.
+ * @return len.
+ */
+static int iio_irq_latency_reset(uint32_t len)
+{
+	no_os_irq_policy_reset_stats();
+
+	return len;
+}
+#endif
+
+#ifdef NO_OS_ALLOC_STATS
+/**
+ * @brief Write ALLOC_STATS_ATTRIBUTE: restart the allocation peak and clear the
+ * counters, whatever the value.
+ * @param len - Length of the value.
+ * @return len.
+ */
+static int iio_alloc_stats_reset(uint32_t len)
+{
+	no_os_alloc_reset_stats();
+
+	return len;
+}
+#endif
+
+/**
+ * @brief Access a debug attribute added by the IIO core after the ones of the
+ * device, by its index in the same order as in the xml.
+ * @param desc - IIO descriptor.
+ * @param dev - Device.
+ * @param idx - Index, 0 being the first attribute after the device ones.
+ * @param buf - Buffer where value is read or value to be written.
+ * @param len - Maximum length of buf or length of data to write.
+ * @param is_write - If true, writes attribute, otherwise reads attribute.
+ * @return Length of chars written/read or negative value in case of error.
+ */
+static int iio_rd_wr_core_dbg_attr(struct iio_desc *desc,
+				   struct iio_dev_priv *dev, uint32_t idx,
+				   char *buf, uint32_t len, bool is_write)
+{
+	if (dev->dev_descriptor->debug_reg_read ||
+	    dev->dev_descriptor->debug_reg_write) {
+		if (!idx) {
+			if (is_write && dev->dev_descriptor->debug_reg_write)
+				return debug_reg_write(dev, buf, len);
+			if (!is_write && dev->dev_descriptor->debug_reg_read)
 				return debug_reg_read(dev, buf, len);
 			return -ENOENT;
 		}
+		if (idx == 1)
+			return is_write ? iio_reg_bulk_store(dev, buf, len) :
+			       iio_reg_bulk_show(dev, buf, len);
+		idx -= 2;
+	}
+#ifdef NO_OS_TRACE
+	if (!idx)
+		return is_write ? -ENOENT : no_os_trace_print(buf, len);
+	idx--;
+#endif
+#ifdef IIO_STATS
+	if (!idx)
+		return is_write ? iio_stats_reset(desc, dev, len) :
+		       iio_stats_show(desc, dev, buf, len);
+	idx--;
+#endif
+#ifdef NO_OS_IRQ_POLICY
+	if (!idx)
+		return is_write ? iio_irq_latency_reset(len) :
+		       no_os_irq_policy_print(buf, len);
+	idx--;
+#endif
+#ifdef NO_OS_ALLOC_STATS
+	if (!idx)
+		return is_write ? iio_alloc_stats_reset(len) :
+		       no_os_alloc_stats_print(buf, len);
+#endif
 
-		if (attr->channel[0] != '\0') {
-			ch_out = attr->type == IIO_ATTR_TYPE_CH_OUT ? 1 : 0;
-			ch = iio_get_channel(attr->channel, dev->dev_descriptor,
-					     ch_out);
-			if (!ch)
-				return -ENOENT;
-			ch_info.ch_out = ch_out;
-			ch_info.ch_num = ch->channel;
-			ch_info.type = ch->ch_type;
-			ch_info.differential = ch->diferential;
-			ch_info.address = ch->address;
-			params.ch_info = &ch_info;
-		} else {
-			params.ch_info = NULL;
+	return -ENOENT;
+}
+
+/**
+ * @brief Get the number of attributes of an attribute list.
+ * @param attributes - Array of attributes. Can be NULL.
+ * @return Number of attributes.
+ */
+static uint32_t iio_count_attributes(const struct iio_attribute *attributes)
+{
+	uint32_t i = 0;
+
+	if (attributes)
+		while (attributes[i].name)
+			i++;
+
+	return i;
+}
+
+/**
+ * @brief Get the device whose direct_reg_access is part of a bulk transfer.
+ * @param attr - Attributes of the transfer.
+ * @param dev - Device of the attributes.
+ * @return dev for its debug attributes when it has register access, NULL
+ * otherwise.
+ */
+static struct iio_dev_priv *iio_reg_access_dev(struct iiod_attr *attr,
+		struct iio_dev_priv *dev)
+{
+	if (attr->type != IIO_ATTR_TYPE_DEBUG)
+		return NULL;
+
+	if (!dev->dev_descriptor->debug_reg_read &&
+	    !dev->dev_descriptor->debug_reg_write)
+		return NULL;
+
+	return dev;
+}
+
+/**
+ * @brief Read all attributes from an attribute list, in the bulk encoding of
+ * iiod: for each attribute a big endian 32 bit length, negative error code if
+ * the read failed, followed by the value and its '\0' terminator padded to a
+ * multiple of 4 bytes.
+ * @param params - Structure describing parameters for show functions.
+ * @param attributes - List of attributes to be read. Can be NULL.
+ * @param reg_dev - Device whose direct_reg_access follows the attributes, as
+ * in the context xml. NULL if there is none.
+ * @return Number of bytes read or negative value in case of error.
+ */
+static int iio_read_all_attr(struct attr_fun_params *params,
+			     const struct iio_attribute *attributes,
+			     struct iio_dev_priv *reg_dev)
+{
+	struct attr_fun_params attr_params = *params;
+	uint32_t i, nb_attr, j = 0;
+	uint32_t padded;
+	int32_t len;
+
+	nb_attr = iio_count_attributes(attributes);
+	if (reg_dev)
+		nb_attr++;
+
+	for (i = 0; i < nb_attr; i++) {
+		if (j + 4 > params->len)
+			return -ENOMEM;
+
+		attr_params.buf = params->buf + j + 4;
+		attr_params.len = params->len - j - 4;
+		if (attributes && attributes[i].name)
+			len = iio_call_attribute(&attr_params, &attributes[i],
+						 false);
+		else if (reg_dev->dev_descriptor->debug_reg_read)
+			len = debug_reg_read(reg_dev, attr_params.buf,
+					     attr_params.len);
+		else
+			len = -ENOENT;
+
+		if (len >= 0) {
+			/* A truncated value is reported as an error */
+			if ((uint32_t)len + 1 > attr_params.len) {
+				len = -ENOMEM;
+			} else {
+				attr_params.buf[len] = '\0';
+				len++;
+			}
 		}
 
-		params.buf = buf;
-		params.len = len;
-		params.dev_instance = dev->dev_instance;
-		attributes = get_attributes(attr->type, dev, ch);
-		if (!strcmp(attr->name, ""))
-			return iio_read_all_attr(&params, attributes);
-		return iio_rd_wr_attribute(&params, attributes, attr->name, 0);
+		no_os_put_unaligned_be32(len, (uint8_t *)params->buf + j);
+		j += 4;
+		if (len <= 0)
+			continue;
+
+		padded = no_os_round_up(len, 4) * 4;
+		if (j + padded > params->len)
+			return -ENOMEM;
+		memset(params->buf + j + len, 0, padded - len);
+		j += padded;
 	}
 
-	/* IIO device with given name is not found, verify if it corresponds to a trigger */
-	trig_dev = get_iio_trig_device(ctx->instance, device);
+	if (!j)
+		return -ENOENT;
 
-	/* If IIO trigger with given name is found, handle reading of attributes */
-	if(trig_dev) {
-		params.ch_info = NULL; /* Triggers cannot have channels */
-		params.buf = buf;
-		params.len = len;
-		params.dev_instance = trig_dev->instance;
-		attributes = get_trig_attributes(attr->type, trig_dev);
-		if (!strcmp(attr->name, ""))
-			return iio_read_all_attr(&params, attributes);
-		return iio_rd_wr_attribute(&params, attributes, attr->name, 0);
+	return j;
+}
+
+/**
+ * @brief Write all attributes from an attribute list, in the bulk encoding of
+ * iiod: for each attribute a big endian 32 bit length followed by the value
+ * padded to a multiple of 4 bytes. Attributes with a length of 0 or less are
+ * not written.
+ * @param params - Structure describing parameters for store functions.
+ * @param attributes - List of attributes to be written. Can be NULL.
+ * @param reg_dev - Device whose direct_reg_access follows the attributes, as
+ * in the context xml. NULL if there is none.
+ * @return Number of written bytes or negative value in case of error.
+ */
+static int iio_write_all_attr(struct attr_fun_params *params,
+			      const struct iio_attribute *attributes,
+			      struct iio_dev_priv *reg_dev)
+{
+	struct attr_fun_params attr_params = *params;
+	uint32_t i, nb_attr, j = 0;
+	int32_t len, ret;
+	char next;
+
+	nb_attr = iio_count_attributes(attributes);
+	if (reg_dev)
+		nb_attr++;
+	if (!nb_attr)
+		return -ENOENT;
+
+	for (i = 0; i < nb_attr && j < params->len; i++) {
+		if (j + 4 > params->len)
+			return -EINVAL;
+
+		len = (int32_t)no_os_get_unaligned_be32((uint8_t *)params->buf +
+							j);
+		j += 4;
+		if (len <= 0)
+			continue;
+
+		if ((uint32_t)len > params->len - j)
+			return -EINVAL;
+
+		/*
+		 * Values are parsed as strings, terminate this one in place.
+		 * The byte after the payload is always available, iiod
+		 * terminates it.
+		 */
+		attr_params.buf = params->buf + j;
+		attr_params.len = len;
+		next = attr_params.buf[len];
+		attr_params.buf[len] = '\0';
+		if (attributes && attributes[i].name)
+			ret = iio_call_attribute(&attr_params, &attributes[i],
+						 true);
+		else if (reg_dev->dev_descriptor->debug_reg_write)
+			ret = debug_reg_write(reg_dev, attr_params.buf, len);
+		else
+			ret = -ENOENT;
+		attr_params.buf[len] = next;
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		j += no_os_round_up(len, 4) * 4;
 	}
 
-	/* No device and no trigger with given name were found */
-	return -ENODEV;
+	return params->len;
 }
 
 /**
- * @brief Write global attribute of a device.
- * @param device - String containing device name.
- * @param ctx - IIO instance and conn instance
- * @param attr - String containing attribute name.
- * @param buf - Value to be written.
- * @param len - Length of data.
- * @return Number of written bytes.
+ * @struct iio_fmt_buf
+ * @brief Output of the value formatters. As with snprintf, the characters that
+ * don't fit are counted but not written and the string is always terminated.
  */
-static int iio_write_attr(struct iiod_ctx *ctx, const char *device,
-			  struct iiod_attr *attr, char *buf, uint32_t len)
+struct iio_fmt_buf {
+	char		*buf;
+	uint32_t	len;
+	/* Length of the whole formatted string */
+	uint32_t	pos;
+};
+
+static void iio_fmt_char(struct iio_fmt_buf *f, char c)
 {
-	struct iio_dev_priv	*dev;
-	struct iio_trig_priv *trig_dev;
-	struct attr_fun_params	params;
-	struct iio_attribute	*attributes;
-	struct iio_ch_info ch_info;
-	struct iio_channel *ch = NULL;
-	int8_t ch_out;
+	if (f->pos + 1 < f->len)
+		f->buf[f->pos] = c;
+	f->pos++;
+}
+
+static void iio_fmt_str(struct iio_fmt_buf *f, const char *str)
+{
+	while (*str)
+		iio_fmt_char(f, *str++);
+}
+
+/**
+ * @brief Write an unsigned value in decimal.
+ * @param f - Output.
+ * @param val - Value.
+ * @param width - Minimum number of digits, padded with zeros.
+ */
+static void iio_fmt_uint(struct iio_fmt_buf *f, uint32_t val, uint32_t width)
+{
+	char digits[10];
+	uint32_t n = 0;
+
+	do {
+		digits[n++] = '0' + val % 10;
+		val /= 10;
+	} while (val);
+
+	for (; width > n; width--)
+		iio_fmt_char(f, '0');
+	while (n)
+		iio_fmt_char(f, digits[--n]);
+}
+
+static void iio_fmt_int(struct iio_fmt_buf *f, int32_t val)
+{
+	if (val < 0) {
+		iio_fmt_char(f, '-');
+		iio_fmt_uint(f, 0u - (uint32_t)val, 0);
+	} else {
+		iio_fmt_uint(f, val, 0);
+	}
+}
+
+/**
+ * @brief Write integer.fract, fract being negative for values in (-1, 0).
+ * @param f - Output.
+ * @param integer - Integer part.
+ * @param fract - Fractional part in subunits.
+ * @param width - Number of digits of the fractional part.
+ */
+static void iio_fmt_fixed(struct iio_fmt_buf *f, int32_t integer, int32_t fract,
+			  uint32_t width)
+{
+	if (!integer && fract < 0)
+		iio_fmt_char(f, '-');
+	iio_fmt_int(f, integer);
+	iio_fmt_char(f, '.');
+	iio_fmt_uint(f, fract < 0 ? 0u - (uint32_t)fract : (uint32_t)fract,
+		     width);
+}
+
+static int iio_fmt_end(struct iio_fmt_buf *f)
+{
+	if (f->len)
+		f->buf[no_os_min(f->pos, f->len - 1)] = '\0';
+
+	return f->pos;
+}
+
+/**
+ * @brief Parse an integer as strtol with base 0: decimal, hexadecimal with the
+ * 0x prefix or octal with the 0 prefix, after optional white spaces and sign.
+ * @param str - String to be parsed.
+ * @param val - Parsed value. Values up to 0xffffffff keep their 32 bits.
+ * @param neg - Set if the value has a minus sign.
+ * @return Pointer to the first character after the value.
+ */
+static const char *iio_parse_int(const char *str, int32_t *val, bool *neg)
+{
+	uint32_t base = 10, digit, mag = 0;
+
+	while (*str == ' ' || (*str >= '\t' && *str <= '\r'))
+		str++;
+
+	*neg = *str == '-';
+	if (*str == '-' || *str == '+')
+		str++;
+
+	if (str[0] == '0' && (str[1] == 'x' || str[1] == 'X')) {
+		base = 16;
+		str += 2;
+	} else if (str[0] == '0') {
+		base = 8;
+	}
+
+	for (;; str++) {
+		if (*str >= '0' && *str <= '9')
+			digit = *str - '0';
+		else if ((*str | 0x20) >= 'a' && (*str | 0x20) <= 'f')
+			digit = (*str | 0x20) - 'a' + 10;
+		else
+			break;
+		if (digit >= base)
+			break;
+		mag = mag * base + digit;
+	}
+
+	*val = *neg ? (int32_t)(0u - mag) : (int32_t)mag;
+
+	return str;
+}
+
+/**
+ * @brief Parse the digits of a fractional part.
+ * @param str - Digits to be parsed, the ones beyond the precision are ignored.
+ * @param subunits - Subunits of the result, 0 for the raw value of the digits.
+ * @return Fractional part in subunits.
+ */
+static int32_t iio_parse_fract(const char *str, uint32_t subunits)
+{
+	uint32_t fract = 0;
+
+	for (; *str >= '0' && *str <= '9'; str++) {
+		if (!subunits) {
+			fract = fract * 10 + (*str - '0');
+		} else if (subunits > 1) {
+			subunits /= 10;
+			fract += (*str - '0') * subunits;
+		}
+	}
+
+	return fract;
+}
+
+/**
+ * @brief Parse a value written by a client, without modifying buf.
+ * The fixed point formats follow the Linux convention: the fractional part of
+ * values in (-1, 0) is negative, "-0.5" giving 0 and -500000. The digits of
+ * IIO_VAL_FRACTIONAL are returned raw in val2, "1.05" giving 1 and 5.
+ * @param buf - Value written by the client.
+ * @param fmt - Format of the value.
+ * @param val - Integer part of the value. Can be NULL.
+ * @param val2 - Fractional part of the value. Can be NULL.
+ * @return 0 in case of success, -EINVAL otherwise.
+ */
+int32_t iio_parse_value(char *buf, enum iio_val fmt, int32_t *val,
+			int32_t *val2)
+{
+	int32_t integer, _fract = 0;
+	uint32_t subunits;
+	const char *p;
+	bool neg;
+
+	switch (fmt) {
+	case IIO_VAL_INT:
+		iio_parse_int(buf, &integer, &neg);
+		break;
+	case IIO_VAL_INT_PLUS_MICRO_DB:
+	case IIO_VAL_INT_PLUS_MICRO:
+	case IIO_VAL_INT_PLUS_NANO:
+	case IIO_VAL_FRACTIONAL:
+		if (fmt == IIO_VAL_INT_PLUS_NANO)
+			subunits = 1000000000;
+		else if (fmt == IIO_VAL_FRACTIONAL)
+			subunits = 0;
+		else
+			subunits = 1000000;
+
+		p = iio_parse_int(buf, &integer, &neg);
+		if (*p == '.')
+			_fract = iio_parse_fract(p + 1, subunits);
+		if (neg && !integer && subunits)
+			_fract = -_fract;
+		break;
+	case IIO_VAL_CHAR:
+		if (!buf[0])
+			return -EINVAL;
+		integer = buf[0];
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	if (val)
+		*val = integer;
+	if (val2)
+		*val2 = _fract;
+
+	return 0;
+}
+
+/**
+ * @brief Format a value read from a device, with the snprintf semantics.
+ * @param buf - Where the value is written.
+ * @param len - Size of buf.
+ * @param fmt - Format of the value.
+ * @param size - Number of values of IIO_VAL_INT_MULTIPLE.
+ * @param vals - Values.
+ * @return Length of the formatted value, which was truncated if it is not
+ * smaller than len.
+ */
+int iio_format_value(char *buf, uint32_t len, enum iio_val fmt,
+		     int32_t size, int32_t *vals)
+{
+	struct iio_fmt_buf f = {
+		.buf = buf,
+		.len = len,
+	};
+	int64_t tmp;
+	int32_t integer, fractional;
+	int32_t i;
+
+	switch (fmt) {
+	case IIO_VAL_INT:
+		iio_fmt_int(&f, vals[0]);
+		break;
+	case IIO_VAL_INT_PLUS_MICRO_DB:
+	case IIO_VAL_INT_PLUS_MICRO:
+		iio_fmt_fixed(&f, vals[0], vals[1], 6);
+		if (fmt == IIO_VAL_INT_PLUS_MICRO_DB)
+			iio_fmt_str(&f, " dB");
+		break;
+	case IIO_VAL_INT_PLUS_NANO:
+		iio_fmt_fixed(&f, vals[0], vals[1], 9);
+		break;
+	case IIO_VAL_FRACTIONAL:
+	case IIO_VAL_FRACTIONAL_LOG2:
+		if (fmt == IIO_VAL_FRACTIONAL)
+			tmp = no_os_div_s64((int64_t)vals[0] * 1000000000LL,
+					    vals[1]);
+		else
+			tmp = no_os_shift_right((int64_t)vals[0] * 1000000000LL,
+						vals[1]);
+		integer = (int32_t)no_os_div_s64_rem(tmp, 1000000000,
+						     &fractional);
+		iio_fmt_fixed(&f, integer, integer ? abs(fractional) :
+			      fractional, 9);
+		break;
+	case IIO_VAL_INT_MULTIPLE:
+		for (i = 0; i < size && f.pos < len; i++) {
+			iio_fmt_int(&f, vals[i]);
+			iio_fmt_char(&f, ' ');
+		}
+		break;
+	case IIO_VAL_CHAR:
+		iio_fmt_char(&f, (char)vals[0]);
+		break;
+	default:
+		return 0;
+	}
+
+	return iio_fmt_end(&f);
+}
+
+static const struct iio_attribute *get_attributes(enum iio_attr_type type,
+		struct iio_dev_priv *dev,
+		const struct iio_channel *ch)
+{
+	switch (type) {
+	case IIO_ATTR_TYPE_DEBUG:
+		return dev->dev_descriptor->debug_attributes;
+		break;
+	case IIO_ATTR_TYPE_DEVICE:
+		return dev->dev_descriptor->attributes;
+		break;
+	case IIO_ATTR_TYPE_BUFFER:
+		return dev->dev_descriptor->buffer_attributes;
+		break;
+	case IIO_ATTR_TYPE_CH_IN:
+	case IIO_ATTR_TYPE_CH_OUT:
+		return ch->attributes;
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Returns trigger attributes.
+ * @param type - Attribute type.
+ * @param trig - Trigger instance.
+ * @return Attributes pointer if attributes exist, NULL otherwise.
+ */
+static const struct iio_attribute *get_trig_attributes(enum iio_attr_type type,
+		struct iio_trig_priv *trig)
+{
+	switch (type) {
+	/* Only device type attributes allowed for triggers */
+	case IIO_ATTR_TYPE_DEVICE:
+		return trig->attributes;
+		break;
+	default:
+		break;
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Check if an attribute is the buffer attribute selecting the
+ * compression of the READBUF data.
+ * @param desc - IIO descriptor.
+ * @param attr - Attribute.
+ * @return true if it is, false otherwise.
+ */
+static bool iio_is_comp_attr(struct iio_desc *desc, struct iiod_attr *attr)
+{
+	return desc->buffer_compression &&
+	       attr->type == IIO_ATTR_TYPE_BUFFER &&
+	       !strcmp(attr->name, IIO_COMP_ATTR);
+}
+
+/**
+ * @brief Enable or disable the compression of the READBUF data of a device.
+ * It can be changed only while the buffer is closed.
+ * @param dev - Device.
+ * @param buf - IIO_COMP_DELTA or IIO_COMP_NONE.
+ * @param len - Length of buf.
+ * @return len in case of success, negative value otherwise.
+ */
+static int iio_set_compression(struct iio_dev_priv *dev, char *buf,
+			       uint32_t len)
+{
+	if (dev->buffer.public.active_mask)
+		return -EBUSY;
+
+	if (!strncmp(buf, IIO_COMP_NONE, len)) {
+		no_os_free(dev->comp_buf);
+		dev->comp_buf = NULL;
+	} else if (!strncmp(buf, IIO_COMP_DELTA, len)) {
+		if (dev->conv && dev->conv->format != IIO_CONV_RAW)
+			return -EBUSY;
+		if (!dev->comp_buf) {
+			dev->comp_buf = no_os_calloc(IIO_COMP_HDR_SIZE +
+						     IIO_COMP_BLOCK_SIZE, 1);
+			if (!dev->comp_buf)
+				return -ENOMEM;
+		}
+	} else {
+		return -EINVAL;
+	}
+
+	return len;
+}
+
+/**
+ * @brief Check if an attribute is one of the decimation buffer attributes.
+ * @param desc - IIO descriptor.
+ * @param attr - Attribute.
+ * @return true if it is, false otherwise.
+ */
+static bool iio_is_decim_attr(struct iio_desc *desc, struct iiod_attr *attr)
+{
+	return desc->buffer_decimation &&
+	       attr->type == IIO_ATTR_TYPE_BUFFER &&
+	       (!strcmp(attr->name, IIO_DECIM_MODE_ATTR) ||
+		!strcmp(attr->name, IIO_DECIM_MODES_ATTR) ||
+		!strcmp(attr->name, IIO_DECIM_FACTOR_ATTR));
+}
+
+/**
+ * @brief Read a decimation buffer attribute.
+ * @param dev - Device.
+ * @param name - Name of the attribute.
+ * @param buf - Where to write the value.
+ * @param len - Size of buf.
+ * @return Length of the value.
+ */
+static int iio_decim_attr_show(struct iio_dev_priv *dev, const char *name,
+			       char *buf, uint32_t len)
+{
+	uint32_t i, l = 0;
+
+	if (!strcmp(name, IIO_DECIM_FACTOR_ATTR))
+		return snprintf(buf, len, "%"PRIu32,
+				dev->decim ? dev->decim->factor : 1);
+
+	if (!strcmp(name, IIO_DECIM_MODE_ATTR))
+		return snprintf(buf, len, "%s", iio_decim_modes[dev->decim ?
+				dev->decim->mode : IIO_DECIM_NONE]);
+
+	for (i = 0; i < IIO_DECIM_NB_MODES && l < len; i++)
+		l += snprintf(buf + l, len - l, i ? " %s" : "%s",
+			      iio_decim_modes[i]);
+
+	return no_os_min(l, len);
+}
+
+/**
+ * @brief Write a decimation buffer attribute. The settings can be changed only
+ * while the buffer is closed.
+ * @param dev - Device.
+ * @param name - Name of the attribute.
+ * @param buf - Value.
+ * @param len - Length of the value.
+ * @return len in case of success, negative value otherwise.
+ */
+static int iio_decim_attr_store(struct iio_dev_priv *dev, const char *name,
+				char *buf, uint32_t len)
+{
+	uint32_t i, factor;
+
+	if (!strcmp(name, IIO_DECIM_MODES_ATTR))
+		return -EACCES;
+
+	if (dev->buffer.public.active_mask)
+		return -EBUSY;
+
+	if (!dev->decim) {
+		dev->decim = no_os_calloc(1, sizeof(*dev->decim));
+		if (!dev->decim)
+			return -ENOMEM;
+		dev->decim->factor = 1;
+	}
+
+	if (!strcmp(name, IIO_DECIM_FACTOR_ATTR)) {
+		factor = strtoul(buf, NULL, 0);
+		if (!factor || factor > IIO_DECIM_MAX_FACTOR)
+			return -EINVAL;
+		dev->decim->factor = factor;
+
+		return len;
+	}
+
+	for (i = 0; i < IIO_DECIM_NB_MODES; i++) {
+		if (!strncmp(buf, iio_decim_modes[i], len) &&
+		    strlen(iio_decim_modes[i]) == strnlen(buf, len)) {
+			dev->decim->mode = i;
+			return len;
+		}
+	}
+
+	return -EINVAL;
+}
+
+/**
+ * @brief Check if an attribute is one of the conversion buffer attributes.
+ * @param desc - IIO descriptor.
+ * @param attr - Attribute.
+ * @return true if it is, false otherwise.
+ */
+static bool iio_is_conv_attr(struct iio_desc *desc, struct iiod_attr *attr)
+{
+	return desc->buffer_conversion &&
+	       attr->type == IIO_ATTR_TYPE_BUFFER &&
+	       (!strcmp(attr->name, IIO_CONV_ATTR) ||
+		!strcmp(attr->name, IIO_CONV_FORMATS_ATTR));
+}
+
+/**
+ * @brief Read a conversion buffer attribute.
+ * @param dev - Device.
+ * @param name - Name of the attribute.
+ * @param buf - Where to write the value.
+ * @param len - Size of buf.
+ * @return Length of the value.
+ */
+static int iio_conv_attr_show(struct iio_dev_priv *dev, const char *name,
+			      char *buf, uint32_t len)
+{
+	uint32_t i, l = 0;
+
+	if (!strcmp(name, IIO_CONV_ATTR))
+		return snprintf(buf, len, "%s", iio_conv_formats[dev->conv ?
+				dev->conv->format : IIO_CONV_RAW]);
+
+	for (i = 0; i < IIO_CONV_NB_FORMATS && l < len; i++)
+		l += snprintf(buf + l, len - l, i ? " %s" : "%s",
+			      iio_conv_formats[i]);
+
+	return no_os_min(l, len);
+}
+
+/**
+ * @brief Select the format of the READBUF data of a device. It can be changed
+ * only while the buffer is closed.
+ * @param dev - Device.
+ * @param name - Name of the attribute.
+ * @param buf - One of iio_conv_formats.
+ * @param len - Length of the value.
+ * @return len in case of success, negative value otherwise.
+ */
+static int iio_conv_attr_store(struct iio_dev_priv *dev, const char *name,
+			       char *buf, uint32_t len)
+{
+	uint32_t i;
+
+	if (!strcmp(name, IIO_CONV_FORMATS_ATTR))
+		return -EACCES;
+
+	if (dev->buffer.public.active_mask)
+		return -EBUSY;
+
+	for (i = 0; i < IIO_CONV_NB_FORMATS; i++)
+		if (!strncmp(buf, iio_conv_formats[i], len) &&
+		    strlen(iio_conv_formats[i]) == strnlen(buf, len))
+			break;
+	if (i == IIO_CONV_NB_FORMATS)
+		return -EINVAL;
+
+	if (i != IIO_CONV_RAW && dev->comp_buf)
+		return -EBUSY;
+
+	if (!dev->conv) {
+		dev->conv = no_os_calloc(1, sizeof(*dev->conv));
+		if (!dev->conv)
+			return -ENOMEM;
+	}
+	dev->conv->format = i;
+
+	return len;
+}
+
+/**
+ * @brief Run one step of the probe of a device not created yet.
+ * @param desc - IIO descriptor.
+ * @param dev - IIO device.
+ * @return 0 if the device is ready, -EAGAIN while it is initializing or the
+ * error returned by its probe.
+ */
+static int32_t iio_probe_dev(struct iio_desc *desc, struct iio_dev_priv *dev)
+{
+	void *instance = NULL;
+	int32_t ret;
+
+	if (dev->probe_ret != -EAGAIN)
+		return dev->probe_ret;
+
+	ret = dev->probe(dev->probe_ctx, &instance);
+	if (ret == -EAGAIN)
+		return ret;
+
+	if (!ret) {
+		dev->dev_instance = instance;
+		dev->dev_data.dev = instance;
+	}
+	dev->probe_ret = ret;
+	desc->nb_probing--;
+
+	return ret;
+}
+
+/**
+ * @brief Advance the probe of the first device still initializing, so the
+ * devices get ready in the background while the server runs.
+ * @param desc - IIO descriptor.
+ */
+static void iio_probe_step(struct iio_desc *desc)
+{
+	uint32_t i;
+
+	for (i = 0; i < desc->nb_devs; i++) {
+		if (desc->devs[i].probe_ret == -EAGAIN) {
+			iio_probe_dev(desc, &desc->devs[i]);
+			return;
+		}
+	}
+}
+
+/**
+ * @brief Read global attribute of a device.
+ * @param ctx - IIO instance and conn instance
+ * @param device - String containing device name.
+ * @param attr - String containing attribute name.
+ * @param buf - Buffer where value is read.
+ * @param len - Maximum length of value to be stored in buf.
+ * @return Number of bytes read.
+ */
+static int iio_read_attr(struct iiod_ctx *ctx, const char *device,
+			 struct iiod_attr *attr, char *buf, uint32_t len)
+{
+	struct iio_dev_priv *dev;
+	struct iio_trig_priv *trig_dev;
+	struct iio_ch_info ch_info;
+	const struct iio_channel *ch = NULL;
+	struct attr_fun_params params;
+	const struct iio_attribute *attributes;
+	int8_t ch_out;
+	int32_t ret;
+
+	dev = get_iio_device(ctx->instance, device);
+
+	/* If IIO device with given name is found, handle reading of attributes */
+	if (dev) {
+		if (iio_is_comp_attr(ctx->instance, attr))
+			return snprintf(buf, len, "%s", dev->comp_buf ?
+					IIO_COMP_DELTA : IIO_COMP_NONE);
+
+		if (iio_is_decim_attr(ctx->instance, attr))
+			return iio_decim_attr_show(dev, attr->name, buf, len);
+
+		if (iio_is_conv_attr(ctx->instance, attr))
+			return iio_conv_attr_show(dev, attr->name, buf, len);
+
+		ret = iio_probe_dev(ctx->instance, dev);
+		if (ret == -EAGAIN && strcmp(attr->name, ""))
+			return snprintf(buf, len, "%s", IIO_INITIALIZING);
+		if (ret)
+			return ret;
+
+		if (attr->type == IIO_ATTR_TYPE_DEBUG &&
+		    strcmp(attr->name, REG_ACCESS_ATTRIBUTE) == 0) {
+			if (dev->dev_descriptor->debug_reg_read)
+				return debug_reg_read(dev, buf, len);
+			return -ENOENT;
+		}
+
+		if (attr->type == IIO_ATTR_TYPE_DEBUG &&
+		    strcmp(attr->name, REG_BULK_ATTRIBUTE) == 0)
+			return iio_reg_bulk_show(dev, buf, len);
+
+#ifdef NO_OS_TRACE
+		if (attr->type == IIO_ATTR_TYPE_DEBUG &&
+		    strcmp(attr->name, TRACE_ATTRIBUTE) == 0)
+			return no_os_trace_print(buf, len);
+#endif
+#ifdef IIO_STATS
+		if (attr->type == IIO_ATTR_TYPE_DEBUG &&
+		    strcmp(attr->name, STATS_ATTRIBUTE) == 0)
+			return iio_stats_show(ctx->instance, dev, buf, len);
+#endif
+#ifdef NO_OS_IRQ_POLICY
+		if (attr->type == IIO_ATTR_TYPE_DEBUG &&
+		    strcmp(attr->name, IRQ_LATENCY_ATTRIBUTE) == 0)
+			return no_os_irq_policy_print(buf, len);
+#endif
+#ifdef NO_OS_ALLOC_STATS
+		if (attr->type == IIO_ATTR_TYPE_DEBUG &&
+		    strcmp(attr->name, ALLOC_STATS_ATTRIBUTE) == 0)
+			return no_os_alloc_stats_print(buf, len);
+#endif
+
+		if (attr->channel[0] != '\0') {
+			ch_out = attr->type == IIO_ATTR_TYPE_CH_OUT ? 1 : 0;
+			ch = iio_get_channel(ctx->instance, attr->channel,
+					     dev->dev_descriptor, ch_out);
+			if (!ch)
+				return -ENOENT;
+			ch_info.ch_out = ch_out;
+			ch_info.ch_num = ch->channel;
+			ch_info.type = ch->ch_type;
+			ch_info.differential = ch->diferential;
+			ch_info.address = ch->address;
+			params.ch_info = &ch_info;
+		} else {
+			params.ch_info = NULL;
+		}
+
+		params.buf = buf;
+		params.len = len;
+		params.dev_instance = dev->dev_instance;
+		attributes = get_attributes(attr->type, dev, ch);
+		if (!strcmp(attr->name, ""))
+			return iio_read_all_attr(&params, attributes,
+						 iio_reg_access_dev(attr, dev));
+		return iio_rd_wr_attribute(ctx->instance, &params, attributes,
+					   attr->name, 0);
+	}
+
+	/* IIO device with given name is not found, verify if it corresponds to a trigger */
+	trig_dev = get_iio_trig_device(ctx->instance, device);
+
+	/* If IIO trigger with given name is found, handle reading of attributes */
+	if(trig_dev) {
+		params.ch_info = NULL; /* Triggers cannot have channels */
+		params.buf = buf;
+		params.len = len;
+		params.dev_instance = trig_dev->instance;
+		attributes = get_trig_attributes(attr->type, trig_dev);
+		if (!strcmp(attr->name, ""))
+			return iio_read_all_attr(&params, attributes, NULL);
+		return iio_rd_wr_attribute(ctx->instance, &params, attributes,
+					   attr->name, 0);
+	}
+
+	/* No device and no trigger with given name were found */
+	return -ENODEV;
+}
+
+/**
+ * @brief Write global attribute of a device.
+ * @param device - String containing device name.
+ * @param ctx - IIO instance and conn instance
+ * @param attr - String containing attribute name.
+ * @param buf - Value to be written.
+ * @param len - Length of data.
+ * @return Number of written bytes.
+ */
+static int iio_write_attr(struct iiod_ctx *ctx, const char *device,
+			  struct iiod_attr *attr, char *buf, uint32_t len)
+{
+	struct iio_dev_priv	*dev;
+	struct iio_trig_priv *trig_dev;
+	struct attr_fun_params	params;
+	const struct iio_attribute	*attributes;
+	struct iio_ch_info ch_info;
+	const struct iio_channel *ch = NULL;
+	int8_t ch_out;
+	int32_t ret;
+
+	dev = get_iio_device(ctx->instance, device);
+
+	/* If IIO device with given name is found, handle writing of attributes */
+	if (dev) {
+		/* Any setting may change the values of the other attributes */
+		iio_attr_cache_invalidate(ctx->instance, dev->dev_instance);
+
+		if (iio_is_comp_attr(ctx->instance, attr))
+			return iio_set_compression(dev, buf, len);
+
+		if (iio_is_decim_attr(ctx->instance, attr))
+			return iio_decim_attr_store(dev, attr->name, buf, len);
+
+		if (iio_is_conv_attr(ctx->instance, attr))
+			return iio_conv_attr_store(dev, attr->name, buf, len);
+
+		ret = iio_probe_dev(ctx->instance, dev);
+		if (ret)
+			return ret;
+
+		if (attr->type == IIO_ATTR_TYPE_DEBUG &&
+		    strcmp(attr->name, REG_ACCESS_ATTRIBUTE) == 0) {
+			if (dev->dev_descriptor->debug_reg_write)
+				return debug_reg_write(dev, buf, len);
+			return -ENOENT;
+		}
+
+		if (attr->type == IIO_ATTR_TYPE_DEBUG &&
+		    strcmp(attr->name, REG_BULK_ATTRIBUTE) == 0)
+			return iio_reg_bulk_store(dev, buf, len);
+
+#ifdef IIO_STATS
+		if (attr->type == IIO_ATTR_TYPE_DEBUG &&
+		    strcmp(attr->name, STATS_ATTRIBUTE) == 0)
+			return iio_stats_reset(ctx->instance, dev, len);
+#endif
+#ifdef NO_OS_IRQ_POLICY
+		if (attr->type == IIO_ATTR_TYPE_DEBUG &&
+		    strcmp(attr->name, IRQ_LATENCY_ATTRIBUTE) == 0)
+			return iio_irq_latency_reset(len);
+#endif
+#ifdef NO_OS_ALLOC_STATS
+		if (attr->type == IIO_ATTR_TYPE_DEBUG &&
+		    strcmp(attr->name, ALLOC_STATS_ATTRIBUTE) == 0)
+			return iio_alloc_stats_reset(len);
+#endif
+
+		if (attr->channel[0] != '\0') {
+			ch_out = attr->type == IIO_ATTR_TYPE_CH_OUT ? 1 : 0;
+			ch = iio_get_channel(ctx->instance, attr->channel,
+					     dev->dev_descriptor, ch_out);
+			if (!ch)
+				return -ENOENT;
+
+			ch_info.ch_out = ch_out;
+			ch_info.ch_num = ch->channel;
+			ch_info.type = ch->ch_type;
+			ch_info.differential = ch->diferential;
+			ch_info.address = ch->address;
+			params.ch_info = &ch_info;
+		} else {
+			params.ch_info = NULL;
+		}
+
+		params.buf = (char *)buf;
+		params.len = len;
+		params.dev_instance = dev->dev_instance;
+		attributes = get_attributes(attr->type, dev, ch);
+		if (!strcmp(attr->name, ""))
+			return iio_write_all_attr(&params, attributes,
+						  iio_reg_access_dev(attr,
+								  dev));
+		return iio_rd_wr_attribute(ctx->instance, &params, attributes,
+					   attr->name, 1);
+	}
+
+	/* IIO device with given name is not found, verify if it corresponds to a trigger */
+	trig_dev = get_iio_trig_device(ctx->instance, device);
+
+	/* If IIO trigger with given name is found, handle writing of attributes */
+	if(trig_dev) {
+		iio_attr_cache_invalidate(ctx->instance, trig_dev->instance);
+		params.ch_info = NULL; /* Triggers cannot have channels */
+		params.buf = (char *)buf;
+		params.len = len;
+		params.dev_instance = trig_dev->instance;
+		attributes = get_trig_attributes(attr->type, trig_dev);
+		if (!strcmp(attr->name, ""))
+			return iio_write_all_attr(&params, attributes, NULL);
+		return iio_rd_wr_attribute(ctx->instance, &params, attributes,
+					   attr->name, 1);
+	}
+
+	/* No device and no trigger with given name were found */
+	return -ENODEV;
+}
+
+/**
+ * @brief Read/write attribute identified by its indexes in the context xml.
+ * @param desc - IIO descriptor.
+ * @param idx - Indexes of the device, channel and attribute.
+ * @param buf - Buffer where value is read or value to be written.
+ * @param len - Maximum length of buf or length of data to write.
+ * @param is_write - If true, writes attribute, otherwise reads attribute.
+ * @return Length of chars written/read or negative value in case of error.
+ */
+static int iio_rd_wr_attr_idx(struct iio_desc *desc, struct iiod_attr_idx *idx,
+			      char *buf, uint32_t len, bool is_write)
+{
+	const struct iio_attribute *attributes;
+	struct attr_fun_params params;
+	struct iio_ch_info ch_info;
+	const struct iio_channel *ch = NULL;
+	struct iio_dev_priv *dev;
+	struct iio_trig_priv *trig;
+	uint32_t nb_attrs;
+	int32_t ret;
+
+	params.buf = buf;
+	params.len = len;
+	params.ch_info = NULL;
+
+	/* Triggers are listed after the devices */
+	if (idx->dev >= desc->nb_devs) {
+		if (idx->dev - desc->nb_devs >= desc->nb_trigs)
+			return -ENODEV;
+
+		trig = &desc->trigs[idx->dev - desc->nb_devs];
+		params.dev_instance = trig->instance;
+		attributes = get_trig_attributes(idx->type, trig);
+		if (is_write)
+			iio_attr_cache_invalidate(desc, trig->instance);
+	} else {
+		dev = &desc->devs[idx->dev];
+		ret = iio_probe_dev(desc, dev);
+		if (ret == -EAGAIN && !is_write)
+			return snprintf(buf, len, "%s", IIO_INITIALIZING);
+		if (ret)
+			return ret;
+
+		if (idx->type == IIO_ATTR_TYPE_CH_IN ||
+		    idx->type == IIO_ATTR_TYPE_CH_OUT) {
+			if (!dev->dev_descriptor->channels ||
+			    idx->channel >= dev->dev_descriptor->num_ch)
+				return -ENOENT;
+
+			ch = &dev->dev_descriptor->channels[idx->channel];
+			ch_info.ch_out = ch->ch_out;
+			ch_info.ch_num = ch->channel;
+			ch_info.type = ch->ch_type;
+			ch_info.differential = ch->diferential;
+			ch_info.address = ch->address;
+			params.ch_info = &ch_info;
+		}
+		params.dev_instance = dev->dev_instance;
+		attributes = get_attributes(idx->type, dev, ch);
+		if (is_write)
+			iio_attr_cache_invalidate(desc, dev->dev_instance);
+
+		nb_attrs = iio_count_attributes(attributes);
+		if (idx->type == IIO_ATTR_TYPE_DEBUG && idx->attr >= nb_attrs)
+			return iio_rd_wr_core_dbg_attr(desc, dev,
+						       idx->attr - nb_attrs,
+						       buf, len, is_write);
+	}
+
+	if (idx->attr >= iio_count_attributes(attributes))
+		return -ENOENT;
+
+	return iio_call_attribute_cached(desc, &params, &attributes[idx->attr],
+					 is_write);
+}
+
+/**
+ * @brief Read attribute identified by indexes (binary protocol).
+ * @param ctx - IIO instance and conn instance
+ * @param attr - Indexes of the attribute.
+ * @param buf - Buffer where value is read.
+ * @param len - Maximum length of value to be stored in buf.
+ * @return Number of bytes read.
+ */
+static int iio_read_attr_idx(struct iiod_ctx *ctx, struct iiod_attr_idx *attr,
+			     char *buf, uint32_t len)
+{
+	return iio_rd_wr_attr_idx(ctx->instance, attr, buf, len, false);
+}
+
+/**
+ * @brief Write attribute identified by indexes (binary protocol).
+ * @param ctx - IIO instance and conn instance
+ * @param attr - Indexes of the attribute.
+ * @param buf - Value to be written.
+ * @param len - Length of data.
+ * @return Number of written bytes.
+ */
+static int iio_write_attr_idx(struct iiod_ctx *ctx, struct iiod_attr_idx *attr,
+			      char *buf, uint32_t len)
+{
+	return iio_rd_wr_attr_idx(ctx->instance, attr, buf, len, true);
+}
+
+/**
+ * @brief Searches for trigger id and returns trigger index.
+ * @param desc - IIO descriptor.
+ * @param id   - Trigger id (trigger0, trigger1, etc.).
+ * @return Trigger index. NO_TRIGGER in case trigger is not found.
+ */
+static uint32_t iio_get_trig_idx_by_id(struct iio_desc *desc, const char *id)
+{
+	uint32_t i;
+
+	if (!id)
+		return NO_TRIGGER;
+
+	for (i = 0; i < desc->nb_trigs; i++)
+		if (strcmp(desc->trigs[i].id, id) == 0)
+			return i;
+
+	return NO_TRIGGER;
+}
+
+/**
+ * @brief Searches for trigger name and returns trigger index.
+ * @param desc - IIO descriptor.
+ * @param name - Trigger name.
+ * @return Trigger index. NO_TRIGGER in case trigger is not found.
+ */
+static uint32_t iio_get_trig_idx_by_name(struct iio_desc *desc,
+		const char *name)
+{
+	uint32_t i;
+
+	if (!name)
+		return NO_TRIGGER;
+
+	for (i = 0; i < desc->nb_trigs; i++)
+		if (strcmp(desc->trigs[i].name, name) == 0)
+			return i;
+
+	return NO_TRIGGER;
+}
+
+/**
+ * @brief Rebuild the device list of a trigger.
+ * The trigger of a device is changed while its buffer is closed, so the
+ * trigger is not processed for it meanwhile.
+ * @param desc - IIO descriptor.
+ * @param trig_idx - Trigger index.
+ */
+static void iio_update_trig_devs(struct iio_desc *desc, uint32_t trig_idx)
+{
+	struct iio_trig_priv *trig = &desc->trigs[trig_idx];
+	uint32_t i, n = 0;
+
+	for (i = 0; i < desc->nb_devs; i++)
+		if (desc->devs[i].trig_idx == trig_idx)
+			trig->devs[n++] = &desc->devs[i];
+	trig->nb_devs = n;
+}
+
+/**
+ * @brief Set the trigger of a device and update the device lists of the
+ * triggers.
+ * @param desc - IIO descriptor.
+ * @param dev - Device.
+ * @param trig_idx - Trigger index, NO_TRIGGER to remove the trigger.
+ */
+static void iio_bind_trig(struct iio_desc *desc, struct iio_dev_priv *dev,
+			  uint32_t trig_idx)
+{
+	uint32_t old = dev->trig_idx;
+
+	dev->trig_idx = trig_idx;
+	if (old != NO_TRIGGER)
+		iio_update_trig_devs(desc, old);
+	if (trig_idx != NO_TRIGGER && trig_idx != old)
+		iio_update_trig_devs(desc, trig_idx);
+}
+
+/**
+ * @brief Searches for active trigger of the given device and returns trigger name.
+ * @param ctx     - IIO instance and conn instance.
+ * @param device  - String containing device name.
+ * @param trigger - Trigger name to be returned.
+ * @param len     - Maximum length of value to be stored in name.
+ * @return Number of bytes written in name.
+ */
+static int iio_get_trigger(struct iiod_ctx *ctx, const char *device,
+			   char *trigger, uint32_t len)
+{
+	struct iio_dev_priv *dev;
+	struct iio_desc *desc = ctx->instance;
+
+	dev = get_iio_device(desc, device);
+	if (!dev)
+		return -ENODEV;
+
+	if (dev->trig_idx == NO_TRIGGER) {
+		trigger[0] = '\0';
+
+		return 0;
+	}
+
+	return snprintf(trigger, len, "%s", desc->trigs[dev->trig_idx].name);
+}
+
+/**
+ * @brief Searches for given trigger id for the given device and if found, it
+ * sets the trigger.
+ * @param ctx     - IIO instance and conn instance.
+ * @param device  - String containing device name.
+ * @param trigger - Trigger id to be set.
+ * @param len     - Maximum length of value to be returned.
+ * @return Positive if index was set, negative if not.
+ */
+static int iio_set_trigger(struct iiod_ctx *ctx, const char *device,
+			   const char *trigger, uint32_t len)
+{
+	struct iio_dev_priv	*dev;
+	uint32_t i;
+
+	dev = get_iio_device(ctx->instance, device);
+	if (!dev)
+		return -ENODEV;
+
+	if (trigger[0] == '\0') {
+		iio_bind_trig(ctx->instance, dev, NO_TRIGGER);
+		return 0;
+	}
+
+	i = iio_get_trig_idx_by_id(ctx->instance, trigger);
+	if (i == NO_TRIGGER)
+		return -EINVAL;
+
+	iio_bind_trig(ctx->instance, dev, i);
+
+	return len;
+}
+
+/**
+ * @brief Get the trigger of a device, by indexes (binary protocol).
+ * @param ctx - IIO instance and conn instance.
+ * @param dev - Device index.
+ * @return Device index of the trigger, -ENOENT if no trigger is set.
+ */
+static int iio_get_trigger_idx(struct iiod_ctx *ctx, uint32_t dev)
+{
+	struct iio_desc *desc = ctx->instance;
+
+	if (dev >= desc->nb_devs)
+		return -ENODEV;
+
+	if (desc->devs[dev].trig_idx == NO_TRIGGER)
+		return -ENOENT;
+
+	return desc->nb_devs + desc->devs[dev].trig_idx;
+}
+
+/**
+ * @brief Set the trigger of a device, by indexes (binary protocol).
+ * @param ctx - IIO instance and conn instance.
+ * @param dev - Device index.
+ * @param trig - Device index of the trigger. Negative to remove the trigger.
+ * @return 0 in case of success, negative value otherwise.
+ */
+static int iio_set_trigger_idx(struct iiod_ctx *ctx, uint32_t dev,
+			       int32_t trig)
+{
+	struct iio_desc *desc = ctx->instance;
+
+	if (dev >= desc->nb_devs)
+		return -ENODEV;
+
+	if (trig < 0) {
+		iio_bind_trig(desc, &desc->devs[dev], NO_TRIGGER);
+		return 0;
+	}
+
+	if ((uint32_t)trig < desc->nb_devs ||
+	    (uint32_t)trig - desc->nb_devs >= desc->nb_trigs)
+		return -EINVAL;
+
+	iio_bind_trig(desc, &desc->devs[dev], trig - desc->nb_devs);
+
+	return 0;
+}
+
+/**
+ * @brief Move the events posted by the driver of a device to its history.
+ * @param dev - Device with an event queue.
+ */
+static void iio_drain_events(struct iio_dev_priv *dev)
+{
+	struct no_os_lffifo *fifo = dev->dev_descriptor->events->fifo;
+	struct iio_event *event;
+
+	do {
+		event = &dev->ev_history[dev->ev_seq & (fifo->depth - 1)];
+		if (!no_os_lffifo_read(fifo, event, 1))
+			break;
+		dev->ev_seq++;
+	} while (true);
+}
+
+/**
+ * @brief Open an event stream of a device (binary protocol).
+ * @param ctx - IIO instance and conn instance.
+ * @param dev - Device index.
+ * @param seq - Position of the next event posted by the device.
+ * @return 0 in case of success, -ENOENT if the device has no events.
+ */
+static int iio_open_evstream(struct iiod_ctx *ctx, uint32_t dev,
+			     uint32_t *seq)
+{
+	struct iio_desc *desc = ctx->instance;
+
+	if (dev >= desc->nb_devs)
+		return -ENODEV;
+
+	if (!desc->devs[dev].ev_history)
+		return -ENOENT;
+
+	iio_drain_events(&desc->devs[dev]);
+	*seq = desc->devs[dev].ev_seq;
+
+	return 0;
+}
+
+/**
+ * @brief Read the event of a device at a position of its history. All the
+ * event streams of the device get the same events.
+ * @param ctx - IIO instance and conn instance.
+ * @param dev - Device index.
+ * @param seq - Position of the event, advanced to the next one.
+ * @param event - Where to store the event.
+ * @return 0 in case of success, -EAGAIN if no event was posted yet.
+ */
+static int iio_read_event(struct iiod_ctx *ctx, uint32_t dev, uint32_t *seq,
+			  struct iiod_event *event)
+{
+	struct iio_desc *desc = ctx->instance;
+	struct iio_dev_priv *ldev;
+	struct iio_event *ev;
+	uint32_t depth;
+
+	if (dev >= desc->nb_devs || !desc->devs[dev].ev_history)
+		return -ENOENT;
+
+	ldev = &desc->devs[dev];
+	iio_drain_events(ldev);
+	if (*seq == ldev->ev_seq)
+		return -EAGAIN;
+
+	/* The stream was too slow, skip the events overwritten in history */
+	depth = ldev->dev_descriptor->events->fifo->depth;
+	if (ldev->ev_seq - *seq > depth)
+		*seq = ldev->ev_seq - depth;
+
+	ev = &ldev->ev_history[*seq & (depth - 1)];
+	event->id = ev->id;
+	event->timestamp = ev->timestamp;
+	(*seq)++;
+
+	return 0;
+}
+
+/**
+ * @brief Allocate the queue a driver posts the events of a device into.
+ * @param queue - Where to store the queue, to be set in iio_device.events.
+ * @param depth - Number of events, a power of 2.
+ * @return 0 in case of success, negative value otherwise.
+ */
+int iio_event_queue_init(struct iio_event_queue **queue, uint32_t depth)
+{
+	struct iio_event_queue *q;
+	int ret;
+
+	if (!queue)
+		return -EINVAL;
+
+	q = (struct iio_event_queue *)no_os_calloc(1, sizeof(*q));
+	if (!q)
+		return -ENOMEM;
+
+	ret = no_os_lffifo_init(&q->fifo, sizeof(struct iio_event), depth);
+	if (ret) {
+		no_os_free(q);
+		return ret;
+	}
+
+	*queue = q;
+
+	return 0;
+}
+
+/**
+ * @brief Free the resources allocated by iio_event_queue_init().
+ * @param queue - Event queue.
+ */
+void iio_event_queue_remove(struct iio_event_queue *queue)
+{
+	if (!queue)
+		return;
+
+	no_os_lffifo_remove(queue->fifo);
+	no_os_free(queue);
+}
+
+/**
+ * @brief Post an event of a device, for example from its interrupt handler.
+ * It doesn't block, the clients get it from the next iio_step. There must be
+ * a single context posting in a queue.
+ * @param queue - Event queue of the device.
+ * @param id - Event identifier, see IIO_EVENT_CODE.
+ * @param timestamp - Time of the event in nanoseconds, 0 if unknown.
+ * @return 0 in case of success, -ENOSPC if the queue is full.
+ */
+int iio_push_event(struct iio_event_queue *queue, uint64_t id,
+		   int64_t timestamp)
+{
+	struct iio_event event = {
+		.id = id,
+		.timestamp = timestamp,
+	};
+
+	if (!queue)
+		return -EINVAL;
+
+	if (!no_os_lffifo_write(queue->fifo, &event, 1)) {
+		queue->lost++;
+		return -ENOSPC;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Allocate the event history of the devices with an event queue.
+ * @param desc - IIO descriptor.
+ * @return 0 in case of success, negative value otherwise.
+ */
+static int iio_init_events(struct iio_desc *desc)
+{
+	const struct iio_device *dev;
+	uint32_t i;
+
+	for (i = 0; i < desc->nb_devs; i++) {
+		dev = desc->devs[i].dev_descriptor;
+		if (!dev->events)
+			continue;
+
+		desc->devs[i].ev_history = (struct iio_event *)no_os_calloc(
+						   dev->events->fifo->depth,
+						   sizeof(struct iio_event));
+		if (!desc->devs[i].ev_history)
+			return -ENOMEM;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Asynchronous trigger processing routine.
+ * @param desc - IIO descriptor.
+ */
+static void iio_process_async_triggers(struct iio_desc *desc)
+{
+	struct iio_trig_priv *trig;
+	struct iio_dev_priv *dev;
+	uint32_t i, j, k, pending;
+
+	for (i = 0; i < desc->nb_trigs; i++) {
+		trig = &desc->trigs[i];
+		pending = trig->raised - trig->served;
+		if (!pending || pending < trig->batch)
+			continue;
+
+		if (pending > IIO_TRIG_MAX_PENDING) {
+			trig->overruns += pending - IIO_TRIG_MAX_PENDING;
+			trig->served += pending - IIO_TRIG_MAX_PENDING;
+			pending = IIO_TRIG_MAX_PENDING;
+		}
+
+		for (j = 0; j < trig->nb_devs; j++) {
+			dev = trig->devs[j];
+			if (dev->dev_descriptor->trigger_handler_batch) {
+				dev->dev_descriptor->trigger_handler_batch(
+					&dev->dev_data, pending);
+				continue;
+			}
+			if (!dev->dev_descriptor->trigger_handler)
+				continue;
+
+			for (k = 0; k < pending; k++)
+				dev->dev_descriptor->trigger_handler(
+					&dev->dev_data);
+		}
+		trig->served += pending;
+	}
+}
+
+/**
+ * @brief Get the handle of a trigger, to process it with iio_process_trigger
+ * without searching for it by name.
+ * @param desc         - IIO descriptor.
+ * @param trigger_name - Trigger name.
+ * @param handle       - Where to store the handle.
+ * @return 0 in case of success, -EINVAL if the trigger is not found.
+ */
+int iio_get_trigger_handle(struct iio_desc *desc, const char *trigger_name,
+			   uint32_t *handle)
+{
+	uint32_t trig_id;
+
+	if (!desc || !handle)
+		return -EINVAL;
+
+	trig_id = iio_get_trig_idx_by_name(desc, trigger_name);
+	if (trig_id == NO_TRIGGER)
+		return -EINVAL;
+
+	*handle = trig_id;
+
+	return 0;
+}
+
+/**
+ * @brief Process a trigger based on its type (sync or async with the
+ * interrupt). Runs in constant time for the devices using the trigger, it can
+ * be called from the trigger interrupt.
+ * @param desc   - IIO descriptor.
+ * @param handle - Trigger handle, from iio_get_trigger_handle.
+ * @return ret - Result of the processing procedure.
+ */
+int iio_process_trigger(struct iio_desc *desc, uint32_t handle)
+{
+	struct iio_trig_priv *trig;
+	struct iio_dev_priv *dev;
+	uint32_t i;
+
+	if (!desc || handle >= desc->nb_trigs)
+		return -EINVAL;
+
+	trig = &desc->trigs[handle];
+	if (!trig->descriptor->is_synchronous) {
+		/* Only written here, iio_step keeps its own count */
+		trig->raised++;
+#ifdef IIO_FREERTOS
+		/* A full job queue only delays the events, they stay counted */
+		if (desc->rtos)
+			iio_rtos_defer(desc, (void (*)(void *))
+				       iio_process_async_triggers, desc);
+#endif
+#ifdef NO_OS_SCHED
+		no_os_sched_post(&desc->step_work);
+#endif
+		return 0;
+	}
+
+	for (i = 0; i < trig->nb_devs; i++) {
+		dev = trig->devs[i];
+		if (dev->dev_descriptor->trigger_handler)
+			dev->dev_descriptor->trigger_handler(&dev->dev_data);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Set the number of events an asynchronous trigger coalesces. iio_step
+ * serves the events once that many are pending, in one trigger_handler_batch
+ * call for the devices having one.
+ * @param desc     - IIO descriptor.
+ * @param handle   - Trigger handle, from iio_get_trigger_handle.
+ * @param nb_events - Events to coalesce, at most IIO_TRIG_MAX_PENDING. 0 or 1
+ * to serve each event at the next iio_step.
+ * @return 0 in case of success, -EINVAL otherwise.
+ */
+int iio_set_trigger_batch(struct iio_desc *desc, uint32_t handle,
+			  uint32_t nb_events)
+{
+	if (!desc || handle >= desc->nb_trigs ||
+	    nb_events > IIO_TRIG_MAX_PENDING)
+		return -EINVAL;
+
+	desc->trigs[handle].batch = nb_events;
+
+	return 0;
+}
+
+/**
+ * @brief Searches for trigger name and processes the trigger based on its
+ * type (sync or async with the interrupt).
+ * @param desc         - IIO descriptor.
+ * @param trigger_name - Trigger name.
+ *
+ * @return ret - Result of the processing procedure.
+ */
+int iio_process_trigger_type(struct iio_desc *desc, char *trigger_name)
+{
+	uint32_t handle;
+	int ret;
+
+	ret = iio_get_trigger_handle(desc, trigger_name, &handle);
+	if (ret)
+		return ret;
+
+	return iio_process_trigger(desc, handle);
+}
+
+/**
+ * @brief Compute the position of the active channels in a scan.
+ * Channels are stored in the order of their index, each one aligned to its
+ * storage size as libiio expects.
+ * @param layout - Layout of the scan.
+ * @param channels - Channels of the device.
+ * @param mask - Mask of the active channels.
+ * @return Number of bytes of a scan.
+ */
+static uint32_t iio_scan_layout_init(struct iio_scan_layout *layout,
+				     const struct iio_channel *channels,
+				     uint32_t mask)
+{
+	uint32_t i, n = 0, offset = 0, bytes;
+
+	layout->uniform_bytes = 0;
+	layout->timestamp = -1;
+	for (i = 0; i < IIO_MAX_SCAN_CH; i++) {
+		if (!(mask & NO_OS_BIT(i)))
+			continue;
+
+		bytes = channels[i].scan_type->storagebits / 8;
+		if (bytes && offset % bytes)
+			offset += bytes - offset % bytes;
+		if (channels[i].ch_type == IIO_TIMESTAMP)
+			layout->timestamp = n;
+		layout->ch[n] = i;
+		layout->bytes[n] = bytes;
+		layout->offset[n] = offset;
+		if (!n)
+			layout->uniform_bytes = bytes;
+		else if (layout->uniform_bytes != bytes)
+			layout->uniform_bytes = 0;
+		offset += bytes;
+		n++;
+	}
+	layout->nb_ch = n;
+	layout->contiguous = !(mask & (mask + 1));
+
+	return offset;
+}
+
+/**
+ * @brief Reset the decimation stage of a device being opened.
+ * @param dev - Device, with the layout of the scans of the opened buffer.
+ * @return 0 in case of success, -EINVAL if the scans can't be decimated.
+ */
+static int32_t iio_decim_open(struct iio_dev_priv *dev)
+{
+	struct iio_buffer *buffer = &dev->buffer.public;
+	struct iio_decimator *decim = dev->decim;
+	const struct iio_channel *ch;
+	uint32_t i;
+
+	buffer->decim = NULL;
+	if (!decim || decim->mode == IIO_DECIM_NONE)
+		return 0;
+
+	if (buffer->bytes_per_scan > IIO_DECIM_MAX_SCAN)
+		return -EINVAL;
+
+	for (i = 0; i < buffer->layout.nb_ch; i++) {
+		if ((int32_t)i == buffer->layout.timestamp)
+			continue;
+		ch = &dev->dev_descriptor->channels[buffer->layout.ch[i]];
+		if (!ch->scan_type->realbits || ch->scan_type->realbits > 32 ||
+		    buffer->layout.bytes[i] > 8)
+			return -EINVAL;
+	}
+
+	decim->channels = dev->dev_descriptor->channels;
+	decim->count = 0;
+	decim->cic_gain = 1;
+	for (i = 0; i < IIO_DECIM_CIC_ORDER; i++)
+		decim->cic_gain *= decim->factor;
+	memset(decim->acc, 0, sizeof(decim->acc));
+	memset(decim->integ, 0, sizeof(decim->integ));
+	memset(decim->comb, 0, sizeof(decim->comb));
+	memset(decim->scan, 0, sizeof(decim->scan));
+	buffer->decim = decim;
+
+	return 0;
+}
+
+/**
+ * @brief Compute the converted scans of a device being opened.
+ * Output buffers are not converted.
+ * @param dev - Device, with the layout of the scans of the opened buffer.
+ * @return 0 in case of success, -EINVAL if the scans are too big.
+ */
+static int32_t iio_conv_open(struct iio_dev_priv *dev)
+{
+	struct iio_scan_layout *layout = &dev->buffer.public.layout;
+	struct iio_conv *conv = dev->conv;
+	const struct iio_channel *ch;
+	struct iio_conv_ch *c;
+	uint32_t i, size, bytes, offset = 0;
+
+	if (!conv)
+		return 0;
+
+	conv->active = false;
+	conv->len = 0;
+	conv->idx = 0;
+	conv->pending = 0;
+	if (conv->format == IIO_CONV_RAW)
+		return 0;
+
+	size = conv->format == IIO_CONV_S16 ? 2 : 4;
+	conv->flat = true;
+	for (i = 0; i < layout->nb_ch; i++) {
+		ch = &dev->dev_descriptor->channels[layout->ch[i]];
+		if (ch->ch_out)
+			return 0;
+
+		c = &conv->ch[i];
+		c->in_offset = layout->offset[i];
+		c->bytes = layout->bytes[i];
+		c->shift = ch->scan_type->shift;
+		c->realbits = ch->scan_type->realbits;
+		c->is_signed = ch->scan_type->sign == 's';
+		c->is_big_endian = ch->scan_type->is_big_endian;
+		c->copy = !c->realbits || c->realbits > 32 || c->bytes > 4 ||
+			  c->shift >= 32;
+
+		bytes = c->copy ? c->bytes : size;
+		if (bytes && offset % bytes)
+			offset += bytes - offset % bytes;
+		c->out_offset = offset;
+		offset += bytes;
+
+		if (c->copy || c->bytes != conv->ch[0].bytes ||
+		    c->shift != conv->ch[0].shift ||
+		    c->realbits != conv->ch[0].realbits ||
+		    c->is_signed != conv->ch[0].is_signed ||
+		    c->is_big_endian != conv->ch[0].is_big_endian)
+			conv->flat = false;
+	}
+
+	if (dev->buffer.public.bytes_per_scan > IIO_DECIM_MAX_SCAN ||
+	    offset > IIO_CONV_BLOCK_SIZE)
+		return -EINVAL;
+
+	conv->nb_ch = layout->nb_ch;
+	conv->in_scan = dev->buffer.public.bytes_per_scan;
+	conv->out_scan = offset;
+	conv->active = true;
+
+	return 0;
+}
+
+/**
+ * @brief  Open device.
+ * @param ctx - IIO instance and conn instance
+ * @param device - String containing device name.
+ * @param sample_size - Sample size.
+ * @param mask - Channels to be opened.
+ * @return 0, negative value in case of failure.
+ */
+static int iio_open_dev(struct iiod_ctx *ctx, const char *device,
+			uint32_t samples, uint32_t mask, bool cyclic)
+{
+	struct iio_desc *desc;
+	struct iio_dev_priv *dev;
+	struct iio_trig_priv *trig;
+	uint32_t ch_mask;
+	int32_t ret;
+	int8_t *buf;
+	uint32_t buf_size;
+	uint32_t nb_blocks;
+
+	dev = get_iio_device(ctx->instance, device);
+	if (!dev)
+		return -ENODEV;
+
+	if (!dev->buffer.initalized)
+		return -EINVAL;
+
+#ifdef IIO_RECORDER
+	if (dev->recorded)
+		return -EBUSY;
+#endif
+
+	ret = iio_probe_dev(ctx->instance, dev);
+	if (ret)
+		return ret;
+
+	ch_mask = 0xFFFFFFFF >> (32 - dev->dev_descriptor->num_ch);
+	mask &= ch_mask;
+	if (!mask)
+		return -ENOENT;
+
+	dev->buffer.public.cyclic_info.is_cyclic = cyclic;
+	dev->buffer.public.cyclic_info.buff_index = 0;
+	dev->comp_len = 0;
+	dev->comp_idx = 0;
+
+	dev->buffer.public.active_mask = mask;
+	dev->buffer.public.bytes_per_scan =
+		iio_scan_layout_init(&dev->buffer.public.layout,
+				     dev->dev_descriptor->channels, mask);
+	if (!dev->buffer.public.bytes_per_scan ||
+	    samples > UINT32_MAX / dev->buffer.public.bytes_per_scan)
+		return -EINVAL;
+	dev->buffer.public.size = dev->buffer.public.bytes_per_scan * samples;
+	ret = iio_decim_open(dev);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	ret = iio_conv_open(dev);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	nb_blocks = dev->buffer.public.nb_blocks;
+	if (dev->buffer.public.size > UINT32_MAX / nb_blocks)
+		return -ENOMEM;
+
+	if (dev->buffer.raw_buf && dev->buffer.raw_buf_len) {
+		if (dev->buffer.raw_buf_len < dev->buffer.public.size * nb_blocks)
+			/* Need a bigger buffer or to allocate */
+			return -ENOMEM;
+
+		/*
+		 * Keep the circular buffer size a multiple of the block size
+		 * so iio_buffer_get_block() never has to wrap.
+		 */
+		if (nb_blocks > 1)
+			buf_size = dev->buffer.public.size * nb_blocks;
+		else
+			buf_size = dev->buffer.raw_buf_len;
+		buf = dev->buffer.raw_buf;
+	} else {
+		if (dev->buffer.allocated) {
+			/* Free in case iio_close_dev wasn't called to free it*/
+			no_os_dma_free(dev->buffer.cb.buff);
+			dev->buffer.allocated = 0;
+		}
+		buf_size = dev->buffer.public.size * nb_blocks;
+		/* The device may fill or empty the blocks by DMA */
+		buf = (int8_t *)no_os_dma_alloc(buf_size);
+		if (!buf)
+			return -ENOMEM;
+		dev->buffer.allocated = 1;
+	}
+
+	if (dev->dev_descriptor->lock_free_buffer)
+		ret = no_os_cb_spsc_cfg(&dev->buffer.cb, buf, buf_size);
+	else
+		ret = no_os_cb_cfg(&dev->buffer.cb, buf, buf_size);
+	if (NO_OS_IS_ERR_VALUE(ret)) {
+		if (dev->buffer.allocated) {
+			no_os_dma_free(dev->buffer.cb.buff);
+			dev->buffer.allocated = 0;
+		}
+
+		return ret;
+	}
+
+	if (dev->dev_descriptor->pre_enable) {
+		ret = dev->dev_descriptor->pre_enable(dev->dev_instance, mask);
+		if (NO_OS_IS_ERR_VALUE(ret) && dev->buffer.allocated) {
+			no_os_dma_free(dev->buffer.cb.buff);
+			dev->buffer.allocated = 0;
+			return ret;
+		}
+	}
+
+	desc = ctx->instance;
+	if (dev->trig_idx != NO_TRIGGER) {
+		trig = &desc->trigs[dev->trig_idx];
+		if (trig->descriptor->enable)
+			ret = trig->descriptor->enable(trig->instance);
+	}
+
+	return ret;
+}
+
+/**
+ * @brief Close device.
+ * @param ctx - IIO instance and conn instance
+ * @param device - String containing device name.
+ * @return 0, negative value in case of failure.
+ */
+static int iio_close_dev(struct iiod_ctx *ctx, const char *device)
+{
+	struct iio_desc *desc;
+	struct iio_dev_priv *dev;
+	struct iio_trig_priv *trig;
+	int ret = 0;
+
+	dev = get_iio_device(ctx->instance, device);
+	if (!dev)
+		return -1;
+
+	if (!dev->buffer.initalized)
+		return -EINVAL;
+
+#ifdef IIO_RECORDER
+	if (dev->recorded)
+		return -EBUSY;
+#endif
+
+	/* Device may still write in the buffer until disabled */
+	if (dev->dev_descriptor->post_disable) {
+		ret = dev->dev_descriptor->post_disable(dev->dev_instance);
+		if (ret)
+			return ret;
+	}
+
+	if (dev->buffer.allocated) {
+		/* Should something else be used to free internal strucutre */
+		no_os_dma_free(dev->buffer.cb.buff);
+		dev->buffer.allocated = 0;
+	}
+
+	dev->buffer.public.active_mask = 0;
+	dev->buffer.public.decim = NULL;
+	/* The count is set by the client for each opening */
+	dev->buffer.public.nb_blocks = 1;
+
+	desc = ctx->instance;
+	if(dev->trig_idx != NO_TRIGGER) {
+		trig = &desc->trigs[dev->trig_idx];
+		if (trig->descriptor->disable)
+			ret = trig->descriptor->disable(trig->instance);
+	}
+
+	return ret;
+}
+
+/**
+ * @brief Get what iiod needs for a buffer of the binary protocol.
+ * @param ctx - IIO instance and conn instance
+ * @param dev - Device index.
+ * @param mask - Channels of the buffer.
+ * @param device - Set to the device name used by the buffer operations.
+ * @param tx - Set if the channels of mask are output channels.
+ * @return Size in bytes of a scan of the channels of mask or negative value in
+ * case of failure.
+ */
+static int iio_get_buffer_info(struct iiod_ctx *ctx, uint32_t dev,
+			       uint32_t mask, const char **device, bool *tx)
+{
+	struct iio_desc *desc = ctx->instance;
+	const struct iio_channel *channels;
+	struct iio_scan_layout layout;
+	struct iio_dev_priv *priv;
+	uint32_t ch_mask;
+
+	if (dev >= desc->nb_devs)
+		return -ENODEV;
+
+	priv = &desc->devs[dev];
+	if (!priv->buffer.initalized)
+		return -EINVAL;
+
+	ch_mask = 0xFFFFFFFF >> (32 - priv->dev_descriptor->num_ch);
+	mask &= ch_mask;
+	if (!mask)
+		return -ENOENT;
+
+	channels = priv->dev_descriptor->channels;
+	*device = priv->dev_id;
+	*tx = channels[no_os_find_first_set_bit(mask)].ch_out;
+
+	return iio_scan_layout_init(&layout, channels, mask);
+}
+
+/**
+ * @brief Set the number of blocks the device buffer can store.
+ * @param ctx - IIO instance and conn instance
+ * @param device - String containing device name.
+ * @param buffers_count - Number of blocks of the size given at open.
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int iio_set_buffers_count(struct iiod_ctx *ctx, const char *device,
+				 uint32_t buffers_count)
+{
+	struct iio_dev_priv *dev;
+
+	dev = get_iio_device(ctx->instance, device);
+	if (!dev)
+		return -ENODEV;
+
+	if (!dev->buffer.initalized || !buffers_count ||
+	    buffers_count > IIO_MAX_BUFFER_BLOCKS)
+		return -EINVAL;
+
+	/* Can't be changed while the buffer is in use */
+	if (dev->buffer.public.active_mask)
+		return -EBUSY;
+
+	dev->buffer.public.nb_blocks = buffers_count;
+
+	return 0;
+}
+
+static int iio_call_submit(struct iiod_ctx *ctx, const char *device,
+			   enum iio_buffer_direction dir)
+{
+	struct iio_dev_priv *dev;
+
+	dev = get_iio_device(ctx->instance, device);
+	if (!dev || !dev->buffer.initalized)
+		return -EINVAL;
+
+	dev->buffer.public.dir = dir;
+	if (dev->dev_descriptor->submit && dev->trig_idx==NO_TRIGGER)
+		return dev->dev_descriptor->submit(&dev->dev_data);
+	else if ((dir == IIO_DIRECTION_INPUT && dev->dev_descriptor->read_dev
+		  && dev->trig_idx==NO_TRIGGER)
+		 || (dir == IIO_DIRECTION_OUTPUT &&
+		     dev->dev_descriptor->write_dev && dev->trig_idx==NO_TRIGGER)) {
+		/* Code used to don't break devices using read_dev */
+		int32_t ret;
+		uint32_t nb_scans;
+		void *buff;
+		struct iio_buffer *buffer = &dev->buffer.public;
+
+		ret = iio_buffer_get_block(buffer, &buff);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		nb_scans = buffer->size / buffer->bytes_per_scan;
+		if (dir == IIO_DIRECTION_INPUT)
+			ret = dev->dev_descriptor->read_dev(dev->dev_instance,
+							    buff, nb_scans);
+		else
+			ret = dev->dev_descriptor->write_dev(dev->dev_instance,
+							     buff, nb_scans);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		return iio_buffer_block_done(buffer);
+	}
+
+	return 0;
+}
+
+static int iio_push_buffer(struct iiod_ctx *ctx, const char *device)
+{
+	return iio_call_submit(ctx, device, IIO_DIRECTION_OUTPUT);
+}
+
+static int iio_refill_buffer(struct iiod_ctx *ctx, const char *device)
+{
+	return iio_call_submit(ctx, device, IIO_DIRECTION_INPUT);
+}
+
+/**
+ * @brief Load a little endian sample.
+ * @param buf - Address of the sample.
+ * @param size - Size of the sample in bytes, at most 4.
+ * @return Value of the sample.
+ */
+static uint32_t iio_comp_get(const uint8_t *buf, uint32_t size)
+{
+	uint32_t val = 0;
+
+	while (size--)
+		val = (val << 8) | buf[size];
+
+	return val;
+}
+
+/**
+ * @brief Compress raw data in an IIO_COMP_PACKED block.
+ * @param out - Where to write the block, of IIO_COMP_HDR_SIZE + len bytes.
+ * @param in - Raw data.
+ * @param len - Bytes of raw data, a multiple of size * nb_ch.
+ * @param size - Size of a sample in bytes, at most 4.
+ * @param nb_ch - Number of samples in a scan.
+ * @return Size of the block, 0 if it wouldn't be smaller than a raw block.
+ */
+static uint32_t iio_comp_pack(uint8_t *out, const uint8_t *in, uint32_t len,
+			      uint32_t size, uint32_t nb_ch)
+{
+	uint32_t zz[IIO_COMP_GROUP];
+	uint32_t shift = 32 - 8 * size;
+	uint32_t max = IIO_COMP_HDR_SIZE + len;
+	uint32_t nb = len / size;
+	uint32_t i, j, n, all, width, bits, pos, prev;
+	const uint8_t *cur;
+	int32_t delta;
+	uint64_t acc;
+
+	pos = IIO_COMP_HDR_SIZE + nb_ch * size;
+	if (pos >= max)
+		return 0;
+
+	out[0] = IIO_COMP_PACKED | (size << 4);
+	out[1] = nb_ch;
+	no_os_put_unaligned_le16(len, out + 2);
+	memcpy(out + IIO_COMP_HDR_SIZE, in, nb_ch * size);
+
+	for (i = nb_ch; i < nb; i += n) {
+		n = no_os_min(nb - i, IIO_COMP_GROUP);
+		all = 0;
+		for (j = 0; j < n; j++) {
+			cur = in + (i + j) * size;
+			prev = iio_comp_get(cur - nb_ch * size, size);
+			/* Difference modulo the sample size, sign extended */
+			delta = (int32_t)((iio_comp_get(cur, size) - prev)
+					  << shift) >> shift;
+			zz[j] = ((uint32_t)delta << 1) ^
+				(uint32_t)(delta >> 31);
+			all |= zz[j];
+		}
+
+		width = 0;
+		while (width < 32 && (all >> width))
+			width++;
+
+		if (pos + 1 + NO_OS_DIV_ROUND_UP(n * width, 8) >= max)
+			return 0;
+
+		out[pos++] = width;
+		acc = 0;
+		bits = 0;
+		for (j = 0; j < n; j++) {
+			acc |= (uint64_t)zz[j] << bits;
+			bits += width;
+			for (; bits >= 8; bits -= 8) {
+				out[pos++] = acc;
+				acc >>= 8;
+			}
+		}
+		if (bits)
+			out[pos++] = acc;
+	}
+
+	return pos;
+}
+
+/**
+ * @brief Compress the next data of the device buffer in comp_buf, once the
+ * previous block was sent.
+ * @param dev - Device with compression enabled.
+ * @return 0 if comp_buf has data to be sent, -EAGAIN if there is no data yet,
+ * negative value otherwise.
+ */
+static int32_t iio_comp_fill(struct iio_dev_priv *dev)
+{
+	struct iio_scan_layout *layout = &dev->buffer.public.layout;
+	struct no_os_cb_regions regions;
+	uint32_t scan, len;
+	int32_t ret;
+
+	if (dev->comp_idx < dev->comp_len)
+		return 0;
+
+	scan = layout->uniform_bytes * layout->nb_ch;
+	len = IIO_COMP_BLOCK_SIZE;
+	if (scan && len >= scan)
+		len -= len % scan;
+
+	ret = no_os_cb_peek_read(&dev->buffer.cb, len, &regions);
+	if (ret == -NO_OS_EOVERRUN)
+		IIO_STATS_ADD(dev, overruns, 1);
+#ifdef IIO_IGNORE_BUFF_OVERRUN_ERR
+	if (ret != -NO_OS_EOVERRUN)
+#endif
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+	len = regions.len[0] + regions.len[1];
+	if (!len)
+		return -EAGAIN;
+
+	dev->comp_len = 0;
+	if (scan && regions.len[0] >= scan) {
+		/* Whole scans, the rest is sent in the next block */
+		len = regions.len[0] - regions.len[0] % scan;
+		dev->comp_len = iio_comp_pack(dev->comp_buf,
+					      (uint8_t *)regions.buf[0], len,
+					      layout->uniform_bytes,
+					      layout->nb_ch);
+	}
+
+	if (!dev->comp_len) {
+		dev->comp_buf[0] = IIO_COMP_RAW;
+		dev->comp_buf[1] = 0;
+		no_os_put_unaligned_le16(len, dev->comp_buf + 2);
+		memcpy(dev->comp_buf + IIO_COMP_HDR_SIZE, regions.buf[0],
+		       no_os_min(len, regions.len[0]));
+		if (len > regions.len[0])
+			memcpy(dev->comp_buf + IIO_COMP_HDR_SIZE +
+			       regions.len[0], regions.buf[1],
+			       len - regions.len[0]);
+		dev->comp_len = IIO_COMP_HDR_SIZE + len;
+	}
+	dev->comp_idx = 0;
+
+	ret = no_os_cb_commit_read(&dev->buffer.cb, len);
+#ifdef IIO_IGNORE_BUFF_OVERRUN_ERR
+	if (ret == -NO_OS_EOVERRUN)
+		return 0;
+#endif
+
+	return ret;
+}
+
+/**
+ * @brief Load samples of the same scan type stored one after the other,
+ * shifted, masked and extended to 32 bits. The loops are kept simple so the
+ * compiler can work on whole words.
+ * @param c - Scan type of the samples.
+ * @param val - Where to store the values.
+ * @param in - Raw samples.
+ * @param n - Number of samples, at most IIO_CONV_CHUNK.
+ */
+static void iio_conv_load(const struct iio_conv_ch *c, int32_t *val,
+			  const uint8_t *in, uint32_t n)
+{
+	uint32_t ext = 32 - c->realbits;
+	uint32_t raw[IIO_CONV_CHUNK];
+	uint32_t i, j;
+
+	switch (c->bytes) {
+	case 1:
+		for (i = 0; i < n; i++)
+			raw[i] = in[i];
+		break;
+	case 2:
+		if (c->is_big_endian)
+			for (i = 0; i < n; i++)
+				raw[i] = (in[2 * i] << 8) | in[2 * i + 1];
+		else
+			for (i = 0; i < n; i++)
+				raw[i] = in[2 * i] | (in[2 * i + 1] << 8);
+		break;
+	case 4:
+		if (c->is_big_endian)
+			for (i = 0; i < n; i++)
+				raw[i] = ((uint32_t)in[4 * i] << 24) |
+					 (in[4 * i + 1] << 16) |
+					 (in[4 * i + 2] << 8) | in[4 * i + 3];
+		else
+			for (i = 0; i < n; i++)
+				raw[i] = in[4 * i] | (in[4 * i + 1] << 8) |
+					 (in[4 * i + 2] << 16) |
+					 ((uint32_t)in[4 * i + 3] << 24);
+		break;
+	default:
+		for (i = 0; i < n; i++, in += c->bytes) {
+			raw[i] = 0;
+			for (j = 0; j < c->bytes; j++)
+				raw[i] = (raw[i] << 8) | in[c->is_big_endian ?
+							   j : c->bytes - 1 - j];
+		}
+		break;
+	}
+
+	if (c->is_signed)
+		for (i = 0; i < n; i++)
+			val[i] = (int32_t)((raw[i] >> c->shift) << ext) >> ext;
+	else
+		for (i = 0; i < n; i++)
+			val[i] = ((raw[i] >> c->shift) << ext) >> ext;
+}
+
+/**
+ * @brief Store the loaded values in the converted format, little endian.
+ * @param format - Converted format.
+ * @param c - Scan type of the samples.
+ * @param out - Where to store the samples, one after the other.
+ * @param val - Values of the samples.
+ * @param n - Number of samples.
+ */
+static void iio_conv_store(enum iio_conv_format format,
+			   const struct iio_conv_ch *c, uint8_t *out,
+			   const int32_t *val, uint32_t n)
+{
+	uint32_t shift, i;
+	uint32_t w[IIO_CONV_CHUNK];
+	float f;
+
+	switch (format) {
+	case IIO_CONV_S16:
+		shift = c->realbits > 16 ? c->realbits - 16 : 0;
+		for (i = 0; i < n; i++) {
+			w[i] = c->is_signed ? (uint32_t)(val[i] >> shift) :
+			       (uint32_t)val[i] >> shift;
+			out[2 * i] = w[i];
+			out[2 * i + 1] = w[i] >> 8;
+		}
+		return;
+	case IIO_CONV_S32:
+		for (i = 0; i < n; i++)
+			w[i] = val[i];
+		break;
+	default:
+		if (c->is_signed) {
+			shift = 32 - c->realbits;
+			for (i = 0; i < n; i++)
+				w[i] = (uint32_t)val[i] << shift;
+		} else if (c->realbits == 32) {
+			for (i = 0; i < n; i++)
+				w[i] = (uint32_t)val[i] >> 1;
+		} else {
+			shift = 31 - c->realbits;
+			for (i = 0; i < n; i++)
+				w[i] = (uint32_t)val[i] << shift;
+		}
+		if (format == IIO_CONV_F32) {
+			for (i = 0; i < n; i++) {
+				f = (int32_t)w[i] * (1.0f / 2147483648.0f);
+				memcpy(&w[i], &f, sizeof(f));
+			}
+		}
+		break;
+	}
+
+	for (i = 0; i < n; i++) {
+		out[4 * i] = w[i];
+		out[4 * i + 1] = w[i] >> 8;
+		out[4 * i + 2] = w[i] >> 16;
+		out[4 * i + 3] = w[i] >> 24;
+	}
+}
+
+/**
+ * @brief Convert whole raw scans.
+ * @param conv - Conversion of the opened buffer.
+ * @param out - Where to store nb converted scans.
+ * @param in - Raw scans.
+ * @param nb - Number of scans.
+ */
+static void iio_conv_scans(struct iio_conv *conv, uint8_t *out,
+			   const uint8_t *in, uint32_t nb)
+{
+	uint32_t size = conv->format == IIO_CONV_S16 ? 2 : 4;
+	const struct iio_conv_ch *c = conv->ch;
+	int32_t val[IIO_CONV_CHUNK];
+	uint32_t i, k;
+
+	if (conv->flat) {
+		/* The scans are an array of samples of the same type */
+		for (nb *= conv->nb_ch; nb; nb -= k) {
+			k = no_os_min(nb, IIO_CONV_CHUNK);
+			iio_conv_load(c, val, in, k);
+			iio_conv_store(conv->format, c, out, val, k);
+			in += k * c->bytes;
+			out += k * size;
+		}
+		return;
+	}
+
+	for (; nb; nb--, in += conv->in_scan, out += conv->out_scan) {
+		memset(out, 0, conv->out_scan);
+		for (i = 0; i < conv->nb_ch; i++) {
+			c = &conv->ch[i];
+			if (c->copy) {
+				memcpy(out + c->out_offset, in + c->in_offset,
+				       c->bytes);
+				continue;
+			}
+			iio_conv_load(c, val, in + c->in_offset, 1);
+			iio_conv_store(conv->format, c, out + c->out_offset,
+				       val, 1);
+		}
+	}
+}
+
+/**
+ * @brief Convert the whole scans of the device buffer fitting in out, during
+ * the copy out of the buffer.
+ * @param dev - Device with an active conversion.
+ * @param out - Where to write the converted scans.
+ * @param size - Size of out, at least one converted scan.
+ * @return Number of bytes written in out, -EAGAIN if there is no whole scan
+ * yet, negative value otherwise.
+ */
+static int32_t iio_conv_read(struct iio_dev_priv *dev, uint8_t *out,
+			     uint32_t size)
+{
+	struct iio_conv *conv = dev->conv;
+	struct no_os_cb_regions regions;
+	uint8_t scan[IIO_DECIM_MAX_SCAN];
+	uint32_t nb, nb0, rem;
+	int32_t ret;
+
+	ret = no_os_cb_peek_read(&dev->buffer.cb,
+				 size / conv->out_scan * conv->in_scan,
+				 &regions);
+	if (ret == -NO_OS_EOVERRUN)
+		IIO_STATS_ADD(dev, overruns, 1);
+#ifdef IIO_IGNORE_BUFF_OVERRUN_ERR
+	if (ret != -NO_OS_EOVERRUN)
+#endif
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+	nb = (regions.len[0] + regions.len[1]) / conv->in_scan;
+	if (!nb)
+		return -EAGAIN;
+
+	nb0 = no_os_min(nb, regions.len[0] / conv->in_scan);
+	iio_conv_scans(conv, out, (uint8_t *)regions.buf[0], nb0);
+	if (nb > nb0) {
+		/* A scan split by the end of the buffer is joined first */
+		rem = regions.len[0] - nb0 * conv->in_scan;
+		if (rem) {
+			memcpy(scan, regions.buf[0] + nb0 * conv->in_scan, rem);
+			memcpy(scan + rem, regions.buf[1],
+			       conv->in_scan - rem);
+			iio_conv_scans(conv, out + nb0 * conv->out_scan, scan,
+				       1);
+			nb0++;
+		}
+		iio_conv_scans(conv, out + nb0 * conv->out_scan,
+			       (uint8_t *)regions.buf[1] +
+			       (nb0 * conv->in_scan - regions.len[0]),
+			       nb - nb0);
+	}
+
+	ret = no_os_cb_commit_read(&dev->buffer.cb, nb * conv->in_scan);
+#ifdef IIO_IGNORE_BUFF_OVERRUN_ERR
+	if (ret == -NO_OS_EOVERRUN)
+		ret = 0;
+#endif
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	return nb * conv->out_scan;
+}
+
+/**
+ * @brief Convert the next scans of the device buffer in conv->buf, once the
+ * previous ones were sent.
+ * @param dev - Device with an active conversion.
+ * @return 0 if conv->buf has data to be sent, -EAGAIN if there is no data yet,
+ * negative value otherwise.
+ */
+static int32_t iio_conv_fill(struct iio_dev_priv *dev)
+{
+	struct iio_conv *conv = dev->conv;
+	int32_t ret;
+
+	if (conv->idx < conv->len)
+		return 0;
+
+	ret = iio_conv_read(dev, conv->buf, sizeof(conv->buf));
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	conv->len = ret;
+	conv->idx = 0;
+
+	return 0;
+}
+
+/**
+ * @brief Read chunk of data from RAM to pbuf. Call
+ * "iio_transfer_dev_to_mem()" first.
+ * This function is probably called multiple times by libtinyiiod after a
+ * "iio_transfer_dev_to_mem" call, since we can only read "bytes_count" bytes.
+ * @param device - String containing device name.
+ * @param pbuf - Buffer where value is stored.
+ * @param offset - Offset to the remaining data after reading n chunks.
+ * @param bytes_count - Number of bytes to read.
+ * @return: Bytes_count or negative value in case of error.
+ */
+static int iio_read_buffer(struct iiod_ctx *ctx, const char *device, char *buf,
+			   uint32_t bytes)
+{
+	struct iio_dev_priv	*dev;
+	struct iio_conv		*conv;
+	int32_t			ret;
+	uint32_t		size;
+
+	dev = get_iio_device(ctx->instance, device);
+	if (!dev || !dev->buffer.initalized)
+		return -EINVAL;
+
+	IIO_STATS_ADD(dev, read_calls, 1);
+	if (dev->comp_buf) {
+		ret = iio_comp_fill(dev);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		bytes = no_os_min(bytes, dev->comp_len - dev->comp_idx);
+		memcpy(buf, dev->comp_buf + dev->comp_idx, bytes);
+		dev->comp_idx += bytes;
+		IIO_STATS_ADD(dev, bytes_read, bytes);
+
+		return bytes;
+	}
+
+	conv = dev->conv;
+	if (conv && conv->active) {
+		if (conv->idx == conv->len && bytes >= conv->out_scan) {
+			/* Converted straight into the response */
+			ret = iio_conv_read(dev, (uint8_t *)buf, bytes);
+			if (ret > 0)
+				IIO_STATS_ADD(dev, bytes_read, ret);
+
+			return ret;
+		}
+
+		ret = iio_conv_fill(dev);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		bytes = no_os_min(bytes, conv->len - conv->idx);
+		memcpy(buf, conv->buf + conv->idx, bytes);
+		conv->idx += bytes;
+		IIO_STATS_ADD(dev, bytes_read, bytes);
+
+		return bytes;
+	}
+
+	ret = no_os_cb_size(&dev->buffer.cb, &size);
+	if (ret == -NO_OS_EOVERRUN)
+		IIO_STATS_ADD(dev, overruns, 1);
+#ifdef IIO_IGNORE_BUFF_OVERRUN_ERR
+#warning Buffer overrun error checking is disabled.
+	if (ret != -NO_OS_EOVERRUN)
+#endif
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+	bytes = no_os_min(size, bytes);
+	if (!bytes)
+		return -EAGAIN;
+
+
+	ret = no_os_cb_read(&dev->buffer.cb, buf, bytes);
+#ifdef IIO_IGNORE_BUFF_OVERRUN_ERR
+	if (ret != -NO_OS_EOVERRUN)
+#endif
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+	IIO_STATS_ADD(dev, bytes_read, bytes);
+
+	return bytes;
+}
+
+/**
+ * @brief Get the address of a chunk of data from the device buffer so it can
+ * be sent without being copied. The DMA writes directly in the same memory
+ * when using iio_buffer_get_block().
+ * @param ctx - IIO instance and conn instance
+ * @param device - String containing device name.
+ * @param addr - Address where the data starts.
+ * @param bytes - Maximum number of bytes requested.
+ * @return Number of bytes available at addr or negative value in case of
+ * error.
+ */
+static int iio_read_buffer_block(struct iiod_ctx *ctx, const char *device,
+				 void **addr, uint32_t bytes)
+{
+	struct iio_dev_priv	*dev;
+	struct iio_conv		*conv;
+	int32_t			ret;
+	uint32_t		size;
+
+	dev = get_iio_device(ctx->instance, device);
+	if (!dev || !dev->buffer.initalized)
+		return -EINVAL;
+
+	IIO_STATS_ADD(dev, read_calls, 1);
+	if (dev->comp_buf) {
+		ret = iio_comp_fill(dev);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		*addr = dev->comp_buf + dev->comp_idx;
+		dev->comp_pending = no_os_min(bytes,
+					      dev->comp_len - dev->comp_idx);
+		IIO_STATS_ADD(dev, bytes_read, dev->comp_pending);
+
+		return dev->comp_pending;
+	}
+
+	conv = dev->conv;
+	if (conv && conv->active) {
+		ret = iio_conv_fill(dev);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		*addr = conv->buf + conv->idx;
+		conv->pending = no_os_min(bytes, conv->len - conv->idx);
+		IIO_STATS_ADD(dev, bytes_read, conv->pending);
+
+		return conv->pending;
+	}
+
+	ret = no_os_cb_size(&dev->buffer.cb, &size);
+	if (ret == -NO_OS_EOVERRUN)
+		IIO_STATS_ADD(dev, overruns, 1);
+#ifdef IIO_IGNORE_BUFF_OVERRUN_ERR
+	if (ret != -NO_OS_EOVERRUN)
+#endif
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+	bytes = no_os_min(size, bytes);
+	if (!bytes)
+		return -EAGAIN;
+
+	size = 0;
+	ret = no_os_cb_prepare_async_read(&dev->buffer.cb, bytes, addr, &size);
+#ifdef IIO_IGNORE_BUFF_OVERRUN_ERR
+	if (ret != -NO_OS_EOVERRUN)
+#endif
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+	if (!size)
+		return -EAGAIN;
+	IIO_STATS_ADD(dev, bytes_read, size);
+
+	return size;
+}
+
+/**
+ * @brief Release the chunk of data obtained with iio_read_buffer_block().
+ * @param ctx - IIO instance and conn instance
+ * @param device - String containing device name.
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int iio_read_buffer_block_done(struct iiod_ctx *ctx, const char *device)
+{
+	struct iio_dev_priv *dev;
+
+	dev = get_iio_device(ctx->instance, device);
+	if (!dev || !dev->buffer.initalized)
+		return -EINVAL;
+
+	if (dev->comp_buf) {
+		/* The data of the device buffer was released when compressed */
+		dev->comp_idx += dev->comp_pending;
+		dev->comp_pending = 0;
+
+		return 0;
+	}
+
+	if (dev->conv && dev->conv->active) {
+		/* The raw scans were released when converted */
+		dev->conv->idx += dev->conv->pending;
+		dev->conv->pending = 0;
+
+		return 0;
+	}
+
+	return no_os_cb_end_async_read(&dev->buffer.cb);
+}
+
+/**
+ * @brief Write chunk of data into RAM.
+ * This function is probably called multiple times by libtinyiiod before a
+ * "iio_transfer_mem_to_dev" call, since we can only write "bytes_count" bytes
+ * at a time.
+ * A non cyclic buffer of more than one block is used as a ring consumed by the
+ * device while the host writes the next blocks. When it is full, the number of
+ * bytes that fit is returned, -EAGAIN if none, and iiod tries again later.
+ * Otherwise the buffer holds a single block and the data that doesn't fit
+ * is dropped.
+ * @param device - String containing device name.
+ * @param buf - Values to write.
+ * @param offset - Offset in memory after the nth chunk of data.
+ * @param bytes_count - Number of bytes to write.
+ * @return Number of bytes consumed or negative value in case of error.
+ */
+static int iio_write_buffer(struct iiod_ctx *ctx, const char *device,
+			    const char *buf, uint32_t bytes)
+{
+	struct iio_dev_priv	*dev;
+	int32_t			ret;
+	uint32_t		available;
+	uint32_t		capacity;
+	uint32_t		size;
+	bool			ring;
+
+	dev = get_iio_device(ctx->instance, device);
+	if (!dev || !dev->buffer.initalized)
+		return -EINVAL;
+
+	ret = no_os_cb_size(&dev->buffer.cb, &size);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	ring = !dev->buffer.public.cyclic_info.is_cyclic &&
+	       dev->buffer.public.nb_blocks > 1;
+	capacity = dev->buffer.public.size;
+	if (ring)
+		capacity *= dev->buffer.public.nb_blocks;
+
+	available = capacity - no_os_min(capacity, size);
+	if (ring && !available)
+		return -EAGAIN;
+
+	ret = no_os_cb_write(&dev->buffer.cb, buf, no_os_min(available, bytes));
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+	IIO_STATS_ADD(dev, write_calls, 1);
+	IIO_STATS_ADD(dev, bytes_written, no_os_min(available, bytes));
+
+	return ring ? no_os_min(available, bytes) : bytes;
+}
+
+int iio_buffer_get_block(struct iio_buffer *buffer, void **addr)
+{
+	int32_t ret;
+	uint32_t size;
+
+	if (!buffer)
+		return -EINVAL;
+
+	if (buffer->dir == IIO_DIRECTION_INPUT)
+		ret = no_os_cb_prepare_async_write(buffer->buf, buffer->size, addr,
+						   &size);
+	else
+		ret = no_os_cb_prepare_async_read(buffer->buf, buffer->size, addr,
+						  &size);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		/* ToDo: Implement async cancel. And cancel transaction here.
+		 * Also cancel may be needed for a posible future abort callback
+		 * If this is not done, after the first error all future calls
+		 * to async will fail.
+		 * An other option will be to call cb_cfg but then data is lost
+		 */
+		return ret;
+
+	/* This function is exepected to be called for a DMA transaction of one
+	 * block. The circular buffer holds nb_blocks blocks so a block never
+	 * wraps unless a user provided raw_buf of a different size is used.
+	 */
+	if (size != buffer->size)
+		return -ENOMEM;
+
+	return 0;
+}
+
+int iio_buffer_block_done(struct iio_buffer *buffer)
+{
+	if (!buffer)
+		return -EINVAL;
+
+	if (buffer->dir == IIO_DIRECTION_INPUT)
+		return no_os_cb_end_async_write(buffer->buf);
+
+	return no_os_cb_end_async_read(buffer->buf);
+}
+
+/**
+ * @brief Load a sample from a scan, as a signed value.
+ * @param type - Scan type of the channel.
+ * @param buf - Storage bytes of the sample.
+ * @param bytes - Number of storage bytes, at most 8.
+ * @return Value of the sample.
+ */
+static int64_t iio_decim_get(const struct scan_type *type, const uint8_t *buf,
+			     uint32_t bytes)
+{
+	uint64_t mask = ((uint64_t)1 << type->realbits) - 1;
+	uint64_t raw = 0;
+	uint32_t i;
+
+	for (i = 0; i < bytes; i++)
+		raw = (raw << 8) | buf[type->is_big_endian ? i : bytes - 1 - i];
+
+	raw = (raw >> type->shift) & mask;
+	if (type->sign == 's' && (raw >> (type->realbits - 1)))
+		raw |= ~mask;
+
+	return (int64_t)raw;
+}
+
+/**
+ * @brief Store a sample in a scan, saturated to the range of the channel.
+ * @param type - Scan type of the channel.
+ * @param buf - Storage bytes of the sample.
+ * @param bytes - Number of storage bytes, at most 8.
+ * @param val - Value of the sample.
+ */
+static void iio_decim_put(const struct scan_type *type, uint8_t *buf,
+			  uint32_t bytes, int64_t val)
+{
+	uint64_t mask = ((uint64_t)1 << type->realbits) - 1;
+	int64_t max, min;
+	uint64_t raw;
+	uint32_t i;
+
+	if (type->sign == 's') {
+		max = (int64_t)(mask >> 1);
+		min = -max - 1;
+	} else {
+		max = (int64_t)mask;
+		min = 0;
+	}
+	val = no_os_clamp(val, min, max);
+
+	raw = ((uint64_t)val & mask) << type->shift;
+	for (i = 0; i < bytes; i++, raw >>= 8)
+		buf[type->is_big_endian ? bytes - 1 - i : i] = raw;
+}
+
+/**
+ * @brief Run the CIC comb stages on the integrated samples of a channel.
+ * @param decim - Decimation stage.
+ * @param i - Position of the channel in the scan.
+ * @return Output of the filter, scaled by its gain.
+ */
+static int64_t iio_decim_cic_comb(struct iio_decimator *decim, uint32_t i)
+{
+	uint64_t val = decim->integ[i][IIO_DECIM_CIC_ORDER - 1];
+	uint64_t prev;
+	uint32_t k;
+
+	for (k = 0; k < IIO_DECIM_CIC_ORDER; k++) {
+		prev = decim->comb[i][k];
+		decim->comb[i][k] = val;
+		val -= prev;
+	}
+
+	return (int64_t)val / decim->cic_gain;
+}
+
+/**
+ * @brief Feed a scan to the decimation stage and store an output scan in the
+ * buffer every decimation_factor scans.
+ * @param buffer - Opened buffer, with a decimation stage.
+ * @param data - Scan of iio_buffer.bytes_per_scan bytes.
+ * @return 0 in case of success, negative value otherwise.
+ */
+static int iio_decim_push(struct iio_buffer *buffer, const uint8_t *data)
+{
+	struct iio_scan_layout *layout = &buffer->layout;
+	struct iio_decimator *decim = buffer->decim;
+	const struct scan_type *type;
+	uint32_t i, k, bytes;
+	int64_t val;
+
+	for (i = 0; i < layout->nb_ch; i++) {
+		if ((int32_t)i == layout->timestamp)
+			continue;
+		type = decim->channels[layout->ch[i]].scan_type;
+		val = iio_decim_get(type, data + layout->offset[i],
+				    layout->bytes[i]);
+		switch (decim->mode) {
+		case IIO_DECIM_AVERAGE:
+			decim->acc[i] += val;
+			break;
+		case IIO_DECIM_CIC:
+			decim->integ[i][0] += val;
+			for (k = 1; k < IIO_DECIM_CIC_ORDER; k++)
+				decim->integ[i][k] += decim->integ[i][k - 1];
+			break;
+		case IIO_DECIM_PEAK:
+			val = val < 0 ? -val : val;
+		/* fallthrough */
+		case IIO_DECIM_MAX:
+			if (!decim->count || val > decim->acc[i])
+				decim->acc[i] = val;
+			break;
+		case IIO_DECIM_MIN:
+			if (!decim->count || val < decim->acc[i])
+				decim->acc[i] = val;
+			break;
+		default:
+			break;
+		}
+	}
+
+	if (++decim->count < decim->factor)
+		return 0;
+	decim->count = 0;
+
+	for (i = 0; i < layout->nb_ch; i++) {
+		if ((int32_t)i == layout->timestamp) {
+			/* Time of the last scan of the group */
+			memcpy(decim->scan + layout->offset[i],
+			       data + layout->offset[i], layout->bytes[i]);
+			continue;
+		}
+		type = decim->channels[layout->ch[i]].scan_type;
+		bytes = layout->bytes[i];
+		if (decim->mode == IIO_DECIM_CIC) {
+			val = iio_decim_cic_comb(decim, i);
+		} else if (decim->mode == IIO_DECIM_AVERAGE) {
+			val = decim->acc[i] / (int64_t)decim->factor;
+			decim->acc[i] = 0;
+		} else {
+			val = decim->acc[i];
+		}
+		iio_decim_put(type, decim->scan + layout->offset[i], bytes,
+			      val);
+	}
+
+	return no_os_cb_write(buffer->buf, decim->scan,
+			      buffer->bytes_per_scan);
+}
+
+/* Write to buffer iio_buffer.bytes_per_scan bytes from data */
+NO_OS_HOT int iio_buffer_push_scan(struct iio_buffer *buffer, void *data)
+{
+	if (!buffer)
+		return -EINVAL;
+
+	if (buffer->decim)
+		return iio_decim_push(buffer, data);
+
+	return no_os_cb_write(buffer->buf, data, buffer->bytes_per_scan);
+}
+
+/**
+ * @brief Write timestamp in the IIO_TIMESTAMP channel of a scan, if active, and
+ * push the scan to the buffer.
+ * @param buffer - Opened buffer.
+ * @param data - Scan of iio_buffer.bytes_per_scan bytes.
+ * @param timestamp - Time of the scan, usually no_os_time_ns() read when the
+ *                    data was ready.
+ * @return 0 in case of success, negative value otherwise.
+ */
+int iio_buffer_push_scan_ts(struct iio_buffer *buffer, void *data,
+			    int64_t timestamp)
+{
+	if (!buffer || !data)
+		return -EINVAL;
+
+	if (buffer->layout.timestamp >= 0)
+		memcpy((uint8_t *)data +
+		       buffer->layout.offset[buffer->layout.timestamp],
+		       &timestamp, sizeof(timestamp));
+
+	return iio_buffer_push_scan(buffer, data);
+}
+
+/* Read from buffer iio_buffer.bytes_per_scan bytes into data */
+int iio_buffer_pop_scan(struct iio_buffer *buffer, void *data)
+{
+	int ret;
+
+	if (!buffer)
+		return -EINVAL;
+
+	if(!buffer->cyclic_info.is_cyclic) {
+		ret = no_os_cb_read(buffer->buf, data, buffer->bytes_per_scan);
+		/* The clients didn't write the data in time */
+		if (NO_OS_IS_ERR_VALUE(ret) && ret != -NO_OS_EOVERRUN)
+			iio_buffer_underrun(buffer);
+
+		return ret;
+	}
+
+	memcpy(data,
+	       &buffer->buf->buff[buffer->cyclic_info.buff_index],
+	       buffer->bytes_per_scan);
+
+	buffer->cyclic_info.buff_index += buffer->bytes_per_scan;
+	if (buffer->size == buffer->cyclic_info.buff_index)
+		buffer->cyclic_info.buff_index = 0;
+
+	return 0;
+}
+
+/**
+ * @brief Count an underrun of an output buffer, to be called by the drivers
+ * when their DMA ran out of data. Read on the "stats" debug attribute.
+ * @param buffer - Opened buffer.
+ */
+void iio_buffer_underrun(struct iio_buffer *buffer)
+{
+#ifdef IIO_STATS
+	if (buffer)
+		buffer->underruns++;
+#endif
+}
+
+/**
+ * @brief Pack the samples of the active channels into a scan. The storage
+ * bytes of a channel are the first bytes of its sample, as on little endian
+ * targets.
+ * @param buffer - Opened buffer.
+ * @param scan - Where to write iio_buffer.bytes_per_scan bytes.
+ * @param samples - A sample for each channel of the device, by channel index.
+ * @param sample_size - Size of a sample in bytes, at least the storage size of
+ * the active channels.
+ */
+void iio_buffer_pack_scan(struct iio_buffer *buffer, void *scan,
+			  const void *samples, uint32_t sample_size)
+{
+	struct iio_scan_layout *layout = &buffer->layout;
+	const uint8_t *src = samples;
+	uint8_t *dst = scan;
+	uint32_t i;
+
+	/* The scan is the start of samples */
+	if (layout->contiguous && layout->uniform_bytes == sample_size) {
+		memcpy(dst, src, buffer->bytes_per_scan);
+		return;
+	}
+
+	if (layout->uniform_bytes == 2 && sample_size == 2) {
+		for (i = 0; i < layout->nb_ch; i++)
+			memcpy(dst + 2 * i, src + 2 * layout->ch[i], 2);
+		return;
+	}
+
+	for (i = 0; i < layout->nb_ch; i++)
+		memcpy(dst + layout->offset[i],
+		       src + sample_size * layout->ch[i], layout->bytes[i]);
+}
+
+/**
+ * @brief Unpack a scan into the samples of the active channels. The samples of
+ * the other channels are left unchanged.
+ * @param buffer - Opened buffer.
+ * @param scan - Scan of iio_buffer.bytes_per_scan bytes.
+ * @param samples - A sample for each channel of the device, by channel index.
+ * @param sample_size - Size of a sample in bytes, at least the storage size of
+ * the active channels. The bytes over the storage size are not written.
+ */
+void iio_buffer_unpack_scan(struct iio_buffer *buffer, const void *scan,
+			    void *samples, uint32_t sample_size)
+{
+	struct iio_scan_layout *layout = &buffer->layout;
+	const uint8_t *src = scan;
+	uint8_t *dst = samples;
+	uint32_t i;
+
+	if (layout->contiguous && layout->uniform_bytes == sample_size) {
+		memcpy(dst, src, buffer->bytes_per_scan);
+		return;
+	}
+
+	for (i = 0; i < layout->nb_ch; i++)
+		memcpy(dst + sample_size * layout->ch[i],
+		       src + layout->offset[i], layout->bytes[i]);
+}
+
+/**
+ * @brief Pack the samples of the active channels and write the scan to the
+ * buffer, directly in the buffer memory when the scan doesn't wrap.
+ * @param buffer - Opened buffer.
+ * @param samples - A sample for each channel of the device, by channel index.
+ * @param sample_size - Size of a sample in bytes.
+ * @return 0 in case of success, negative value otherwise.
+ */
+int iio_buffer_push_samples(struct iio_buffer *buffer, const void *samples,
+			    uint32_t sample_size)
+{
+	struct iio_scan_layout *layout;
+	struct no_os_cb_regions regions;
+	uint8_t scan[IIO_MAX_SCAN_CH * 8];
+	int32_t ret;
+
+	if (!buffer || !samples)
+		return -EINVAL;
+
+	layout = &buffer->layout;
+	if (buffer->decim) {
+		if (buffer->bytes_per_scan > sizeof(scan))
+			return -EINVAL;
+
+		iio_buffer_pack_scan(buffer, scan, samples, sample_size);
+
+		return iio_decim_push(buffer, scan);
+	}
+
+	if (layout->contiguous && layout->uniform_bytes == sample_size)
+		return no_os_cb_write(buffer->buf, samples,
+				      buffer->bytes_per_scan);
+
+	ret = no_os_cb_peek_write(buffer->buf, buffer->bytes_per_scan,
+				  &regions);
+	if (!ret && regions.len[0] == buffer->bytes_per_scan) {
+		iio_buffer_pack_scan(buffer, regions.buf[0], samples,
+				     sample_size);
+		return no_os_cb_commit_write(buffer->buf,
+					     buffer->bytes_per_scan);
+	}
+
+	if (buffer->bytes_per_scan > sizeof(scan))
+		return -EINVAL;
+
+	iio_buffer_pack_scan(buffer, scan, samples, sample_size);
+
+	return no_os_cb_write(buffer->buf, scan, buffer->bytes_per_scan);
+}
+
+/**
+ * @brief Split scans of 16 bit samples in an array per active channel.
+ * @param buffer - Opened buffer, all active channels having 16 bit storage.
+ * @param scans - nb_scans scans.
+ * @param nb_scans - Number of scans.
+ * @param ch_data - An array of nb_scans samples for each active channel, in
+ * scan order.
+ * @return 0 in case of success, -EINVAL otherwise.
+ */
+int iio_buffer_deinterleave16(struct iio_buffer *buffer, const void *scans,
+			      uint32_t nb_scans, int16_t **ch_data)
+{
+	struct iio_scan_layout *layout;
+	const uint32_t *words = scans;
+	const int16_t *src = scans;
+	uint32_t i, j, n, w;
+
+	if (!buffer || !scans || !ch_data)
+		return -EINVAL;
+
+	layout = &buffer->layout;
+	if (layout->uniform_bytes != 2)
+		return -EINVAL;
+
+	n = layout->nb_ch;
+	/* Two channels: one 32 bit load per scan, split in registers */
+	if (n == 2 && !((uintptr_t)scans & 3)) {
+		for (i = 0; i < nb_scans; i++) {
+			w = words[i];
+			ch_data[0][i] = (int16_t)(w & 0xFFFF);
+			ch_data[1][i] = (int16_t)(w >> 16);
+		}
+		return 0;
+	}
+
+	for (i = 0; i < nb_scans; i++, src += n)
+		for (j = 0; j < n; j++)
+			ch_data[j][i] = src[j];
+
+	return 0;
+}
+
+#ifdef NO_OS_NETWORKING
+
+static int32_t accept_network_clients(struct iio_desc *desc)
+{
+	struct tcp_socket_desc *sock;
+	struct iiod_conn_data data;
+	int32_t ret;
+	do {
+		uint32_t id;
+		ret = socket_accept(desc->server, &sock);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		data.conn = sock;
+		data.buf = no_os_calloc(1, IIOD_CONN_BUFFER_SIZE);
+		data.len = IIOD_CONN_BUFFER_SIZE;
+		data.weight = 1;
+
+		ret = iiod_conn_add(desc->iiod, &data, &id);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		ret = _push_conn(desc, id);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+	} while (true);
+
+	return 0;
+}
+
+/**
+ * @brief Open the UDP socket of USE_NETWORK_UDP.
+ * @param desc - IIO descriptor
+ * @param net - Network interface of the TCP server
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int32_t iio_udp_init(struct iio_desc *desc,
+			    struct network_interface *net)
+{
+	int32_t ret;
+
+	if (!net->socket_sendto || !net->socket_recvfrom)
+		return -ENOSYS;
+
+	desc->udp_streams = no_os_calloc(IIO_UDP_MAX_STREAMS,
+					 sizeof(*desc->udp_streams));
+	if (!desc->udp_streams)
+		return -ENOMEM;
+
+	ret = net->socket_open(net->net, &desc->udp_id, PROTOCOL_UDP, 0);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		goto free_streams;
+
+	ret = net->socket_bind(net->net, desc->udp_id, IIOD_UDP_PORT);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		goto close_socket;
+
+	desc->udp_net = net;
+
+	return 0;
+
+close_socket:
+	net->socket_close(net->net, desc->udp_id);
+free_streams:
+	no_os_free(desc->udp_streams);
+	desc->udp_streams = NULL;
+
+	return ret;
+}
+
+/**
+ * @brief Close the UDP socket of USE_NETWORK_UDP, if open.
+ * @param desc - IIO descriptor
+ */
+static void iio_udp_remove(struct iio_desc *desc)
+{
+	if (!desc->udp_net)
+		return;
+
+	desc->udp_net->socket_close(desc->udp_net->net, desc->udp_id);
+	no_os_free(desc->udp_streams);
+	desc->udp_net = NULL;
+}
+
+/**
+ * @brief Handle a "STREAM <device>" or "STOP <device>" request.
+ * @param desc - IIO descriptor
+ * @param cmd - Null terminated request, without the end of line.
+ * @param from - Client that sent the request.
+ */
+static void iio_udp_handle_cmd(struct iio_desc *desc, char *cmd,
+			       struct socket_address *from)
+{
+	struct iio_udp_stream *stream, *free_stream = NULL;
+	struct iio_dev_priv *dev;
+	bool start;
+	uint32_t i;
+
+	if (!strncmp(cmd, "STREAM ", 7))
+		start = true;
+	else if (!strncmp(cmd, "STOP ", 5))
+		start = false;
+	else
+		return;
+
+	dev = get_iio_device(desc, strchr(cmd, ' ') + 1);
+	if (!dev || !dev->buffer.initalized)
+		return;
+
+	for (i = 0; i < IIO_UDP_MAX_STREAMS; i++) {
+		stream = &desc->udp_streams[i];
+		if (!stream->dev) {
+			if (!free_stream)
+				free_stream = stream;
+			continue;
+		}
+		if (stream->dev == dev && stream->peer.port == from->port &&
+		    !strcmp(stream->addr, from->addr))
+			break;
+	}
+
+	if (i == IIO_UDP_MAX_STREAMS) {
+		/* No stream of this client, nothing to stop or no room */
+		if (!start || !free_stream)
+			return;
+		stream = free_stream;
+	}
+
+	if (!start) {
+		stream->dev = NULL;
+		return;
+	}
+
+	/* A new request of the same client restarts its stream */
+	stream->dev = dev;
+	strcpy(stream->addr, from->addr);
+	stream->peer.addr = stream->addr;
+	stream->peer.port = from->port;
+	stream->seq = 0;
+	stream->flags = 0;
+	stream->pending = 0;
+}
+
+/**
+ * @brief Read the requests received on the UDP socket.
+ * @param desc - IIO descriptor
+ */
+static void iio_udp_recv_cmds(struct iio_desc *desc)
+{
+	struct network_interface *net = desc->udp_net;
+	char addr[SOCKET_ADDRSTRLEN];
+	struct socket_address from;
+	char cmd[MAX_DEV_ID + 8];
+	int32_t ret;
+
+	do {
+		addr[0] = '\0';
+		from.addr = addr;
+		from.port = 0;
+		ret = net->socket_recvfrom(net->net, desc->udp_id, cmd,
+					   sizeof(cmd) - 1, &from);
+		if (ret <= 0)
+			return;
+
+		cmd[ret] = '\0';
+		cmd[strcspn(cmd, "\r\n")] = '\0';
+		iio_udp_handle_cmd(desc, cmd, &from);
+	} while (true);
+}
+
+/**
+ * @brief Put the next chunk of buffer data of a stream in its datagram.
+ * @param desc - IIO descriptor
+ * @param stream - UDP stream
+ * @return 0 in case of success, -EAGAIN if there is no data yet, negative
+ * value otherwise.
+ */
+static int32_t iio_udp_fill_dgram(struct iio_desc *desc,
+				  struct iio_udp_stream *stream)
+{
+	struct iio_dev_priv *dev = stream->dev;
+	struct iio_buffer *buffer = &dev->buffer.public;
+	struct iiod_ctx ctx = { .instance = desc };
+	uint32_t size, len;
+	int32_t ret;
+
+	/* Streamed only while a client keeps the buffer open */
+	if (!buffer->active_mask)
+		return -EAGAIN;
+
+	ret = no_os_cb_size(&dev->buffer.cb, &size);
+	if (ret == -NO_OS_EOVERRUN)
+		stream->flags |= IIO_UDP_FLAG_OVERRUN;
+	else if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	if (!size) {
+		/* Get the next block from the device, as a READBUF does */
+		ret = iio_call_submit(&ctx, dev->dev_id, IIO_DIRECTION_INPUT);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		ret = no_os_cb_size(&dev->buffer.cb, &size);
+		if (NO_OS_IS_ERR_VALUE(ret) && ret != -NO_OS_EOVERRUN)
+			return ret;
+		if (!size)
+			return -EAGAIN;
+	}
+
+	len = no_os_min(size, IIO_UDP_DGRAM_SIZE - IIO_UDP_HDR_SIZE);
+	if (buffer->bytes_per_scan && len >= buffer->bytes_per_scan)
+		len -= len % buffer->bytes_per_scan;
+
+	ret = no_os_cb_read(&dev->buffer.cb, stream->dgram + IIO_UDP_HDR_SIZE,
+			    len);
+	if (ret == -NO_OS_EOVERRUN)
+		stream->flags |= IIO_UDP_FLAG_OVERRUN;
+	else if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	no_os_put_unaligned_be32(stream->seq, stream->dgram);
+	no_os_put_unaligned_be32(stream->flags, stream->dgram + 4);
+	stream->seq++;
+	stream->flags = 0;
+	stream->pending = IIO_UDP_HDR_SIZE + len;
+
+	return 0;
+}
+
+/**
+ * @brief Handle the UDP requests and send the buffer data of the streams.
+ * @param desc - IIO descriptor
+ */
+static void iio_udp_step(struct iio_desc *desc)
+{
+	struct network_interface *net = desc->udp_net;
+	struct iio_udp_stream *stream;
+	uint32_t i, j;
+	int32_t ret;
+
+	iio_udp_recv_cmds(desc);
+
+	for (i = 0; i < IIO_UDP_MAX_STREAMS; i++) {
+		stream = &desc->udp_streams[i];
+		for (j = 0; stream->dev && j < IIO_UDP_STEP_DGRAMS; j++) {
+			if (!stream->pending &&
+			    iio_udp_fill_dgram(desc, stream))
+				break;
+
+			ret = net->socket_sendto(net->net, desc->udp_id,
+						 stream->dgram,
+						 stream->pending,
+						 &stream->peer);
+			/* Socket busy, send the same datagram next time */
+			if (ret == -EAGAIN)
+				break;
+
+			/* Sent or lost, datagrams are never resent */
+			stream->pending = 0;
+		}
+	}
+}
+#endif
+
+#ifdef IIO_RECORDER
+/**
+ * @brief Append a string, with its 8 bit length, to the capture file header.
+ * @param buf - Header
+ * @param pos - Offset in buf, updated with the string length
+ * @param str - String
+ * @return 0 in case of success, -ENOSPC if the header is full.
+ */
+static int32_t iio_rec_put_str(uint8_t *buf, uint32_t *pos, const char *str)
+{
+	uint32_t len = no_os_min(strlen(str), 255u);
+
+	if (*pos + 1 + len > IIO_REC_RECORD_SIZE)
+		return -ENOSPC;
+
+	buf[(*pos)++] = len;
+	memcpy(buf + *pos, str, len);
+	*pos += len;
+
+	return 0;
+}
+
+/**
+ * @brief Read an attribute stored in the capture file header.
+ * @param desc - IIO descriptor
+ * @param dev - Recorded device
+ * @param channel - Channel id, "" for a device attribute
+ * @param name - Attribute name
+ * @param val - Where to store the value, empty if the attribute is missing
+ * @param len - Size of val
+ */
+static void iio_rec_read_attr(struct iio_desc *desc, struct iio_dev_priv *dev,
+			      const char *channel, const char *name, char *val,
+			      uint32_t len)
+{
+	struct iiod_ctx ctx = { .instance = desc };
+	struct iiod_attr attr = {
+		.type = channel[0] ? IIO_ATTR_TYPE_CH_IN : IIO_ATTR_TYPE_DEVICE,
+		.name = name,
+		.channel = channel
+	};
+	int ret;
+
+	ret = iio_read_attr(&ctx, dev->dev_id, &attr, val, len - 1);
+	if (ret < 0)
+		ret = 0;
+	val[ret] = '\0';
+	val[strcspn(val, "\r\n")] = '\0';
+}
+
+/**
+ * @brief Write the header of a capture file, describing the scans.
+ * @param desc - IIO descriptor
+ * @param rec - Recorder
+ * @return 0 in case of success, negative value otherwise.
+ */
+static int32_t iio_rec_write_header(struct iio_desc *desc,
+				    struct iio_recorder *rec)
+{
+	struct iio_dev_priv *dev = rec->dev;
+	struct iio_buffer *buffer = &dev->buffer.public;
+	const struct iio_channel *ch;
+	char ch_id[MAX_CHN_ID];
+	char val[64];
+	uint8_t *buf = rec->record;
+	uint32_t pos, size, i, nb_ch;
+	int32_t ret;
+	UINT bw;
 
-	dev = get_iio_device(ctx->instance, device);
+	memset(buf, 0, IIO_REC_RECORD_SIZE);
+	memcpy(buf, "IIOREC", 6);
+	no_os_put_unaligned_le16(IIO_REC_VERSION, buf + 6);
+	no_os_put_unaligned_le32(buffer->bytes_per_scan, buf + 12);
+	pos = 20;
 
-	/* If IIO device with given name is found, handle writing of attributes */
-	if (dev) {
+	ret = iio_rec_put_str(buf, &pos, dev->name);
+	if (ret)
+		return ret;
 
-		if (attr->type == IIO_ATTR_TYPE_DEBUG &&
-		    strcmp(attr->name, REG_ACCESS_ATTRIBUTE) == 0) {
-			if (dev->dev_descriptor->debug_reg_write)
-				return debug_reg_write(dev, buf, len);
-			return -ENOENT;
-		}
+	iio_rec_read_attr(desc, dev, "", "sampling_frequency", val,
+			  sizeof(val));
+	ret = iio_rec_put_str(buf, &pos, val);
+	if (ret)
+		return ret;
 
-		if (attr->channel[0] != '\0') {
-			ch_out = attr->type == IIO_ATTR_TYPE_CH_OUT ? 1 : 0;
-			ch = iio_get_channel(attr->channel, dev->dev_descriptor,
-					     ch_out);
-			if (!ch)
-				return -ENOENT;
+	nb_ch = 0;
+	for (i = 0; i < dev->dev_descriptor->num_ch; i++) {
+		if (!(buffer->active_mask & NO_OS_BIT(i)))
+			continue;
 
-			ch_info.ch_out = ch_out;
-			ch_info.ch_num = ch->channel;
-			ch_info.type = ch->ch_type;
-			ch_info.differential = ch->diferential;
-			ch_info.address = ch->address;
-			params.ch_info = &ch_info;
-		} else {
-			params.ch_info = NULL;
-		}
+		ch = &dev->dev_descriptor->channels[i];
+		_print_ch_id(ch_id, ch);
+		ret = iio_rec_put_str(buf, &pos, ch_id);
+		if (ret)
+			return ret;
 
-		params.buf = (char *)buf;
-		params.len = len;
-		params.dev_instance = dev->dev_instance;
-		attributes = get_attributes(attr->type, dev, ch);
-		if (!strcmp(attr->name, ""))
-			return iio_write_all_attr(&params, attributes);
-		return iio_rd_wr_attribute(&params, attributes, attr->name, 1);
+		if (pos + 5 > IIO_REC_RECORD_SIZE)
+			return -ENOSPC;
+		buf[pos++] = ch->scan_type->sign;
+		buf[pos++] = ch->scan_type->realbits;
+		buf[pos++] = ch->scan_type->storagebits;
+		buf[pos++] = ch->scan_type->shift;
+		buf[pos++] = ch->scan_type->is_big_endian;
+
+		iio_rec_read_attr(desc, dev, ch_id, "scale", val, sizeof(val));
+		ret = iio_rec_put_str(buf, &pos, val);
+		if (ret)
+			return ret;
+		nb_ch++;
 	}
+	no_os_put_unaligned_le32(nb_ch, buf + 16);
 
-	/* IIO device with given name is not found, verify if it corresponds to a trigger */
-	trig_dev = get_iio_trig_device(ctx->instance, device);
+	size = (pos + IIO_REC_SECTOR_SIZE - 1) & ~(IIO_REC_SECTOR_SIZE - 1);
+	no_os_put_unaligned_le32(size, buf + 8);
 
-	/* If IIO trigger with given name is found, handle writing of attributes */
-	if(trig_dev) {
-		params.ch_info = NULL; /* Triggers cannot have channels */
-		params.buf = (char *)buf;
-		params.len = len;
-		params.dev_instance = trig_dev->instance;
-		attributes = get_trig_attributes(attr->type, trig_dev);
-		if (!strcmp(attr->name, ""))
-			return iio_read_all_attr(&params, attributes);
-		return iio_rd_wr_attribute(&params, attributes, attr->name, 1);
-	}
+	if (f_write(&rec->file, buf, size, &bw) != FR_OK || bw != size)
+		return -EIO;
 
-	/* No device and no trigger with given name were found */
-	return -ENODEV;
+	return 0;
 }
 
 /**
- * @brief Searches for trigger id and returns trigger index.
- * @param desc - IIO descriptor.
- * @param id   - Trigger id (trigger0, trigger1, etc.).
- * @return Trigger index. NO_TRIGGER in case trigger is not found.
+ * @brief Write the record being filled to the capture file.
+ * @param rec - Recorder
+ * @param tag - IIO_REC_TAG_DATA or IIO_REC_TAG_INDEX
+ * @param len - Bytes of payload
+ * @return 0 in case of success, -EIO otherwise.
  */
-static uint32_t iio_get_trig_idx_by_id(struct iio_desc *desc, const char *id)
+static int32_t iio_rec_write_record(struct iio_recorder *rec, uint32_t tag,
+				    uint32_t len)
 {
-	uint32_t i;
+	UINT bw;
 
-	if (!id)
-		return NO_TRIGGER;
+	no_os_put_unaligned_le32(tag, rec->record);
+	no_os_put_unaligned_le32(len, rec->record + 4);
+	memset(rec->record + IIO_REC_HDR_SIZE + len, 0,
+	       IIO_REC_PAYLOAD_SIZE - len);
 
-	for (i = 0; i < desc->nb_trigs; i++)
-		if (strcmp(desc->trigs[i].id, id) == 0)
-			return i;
+	if (f_write(&rec->file, rec->record, IIO_REC_RECORD_SIZE, &bw) != FR_OK
+	    || bw != IIO_REC_RECORD_SIZE)
+		return -EIO;
 
-	return NO_TRIGGER;
+	return 0;
 }
 
 /**
- * @brief Searches for trigger name and returns trigger index.
- * @param desc - IIO descriptor.
- * @param name - Trigger name.
- * @return Trigger index. NO_TRIGGER in case trigger is not found.
+ * @brief Write an index record and make the capture durable up to it.
+ * Must be called with no data pending in the record.
+ * @param rec - Recorder
+ * @return 0 in case of success, -EIO otherwise.
  */
-static uint32_t iio_get_trig_idx_by_name(struct iio_desc *desc,
-		const char *name)
+static int32_t iio_rec_write_index(struct iio_recorder *rec)
 {
-	uint32_t i;
+	uint8_t *payload = rec->record + IIO_REC_HDR_SIZE;
+	int32_t ret;
 
-	if (!name)
-		return NO_TRIGGER;
+	no_os_put_unaligned_le32(rec->data_bytes, payload);
+	no_os_put_unaligned_le32(rec->data_bytes >> 32, payload + 4);
+	no_os_put_unaligned_le32(rec->flags, payload + 8);
+	ret = iio_rec_write_record(rec, IIO_REC_TAG_INDEX, 12);
+	if (ret)
+		return ret;
 
-	for (i = 0; i < desc->nb_trigs; i++)
-		if (strcmp(desc->trigs[i].name, name) == 0)
-			return i;
+	rec->flags = 0;
+	rec->nb_records = 0;
+	if (f_sync(&rec->file) != FR_OK)
+		return -EIO;
 
-	return NO_TRIGGER;
+	return 0;
 }
 
 /**
- * @brief Searches for active trigger of the given device and returns trigger name.
- * @param ctx     - IIO instance and conn instance.
- * @param device  - String containing device name.
- * @param trigger - Trigger name to be returned.
- * @param len     - Maximum length of value to be stored in name.
- * @return Number of bytes written in name.
+ * @brief Move the buffer data of a device to the records of its capture.
+ * @param desc - IIO descriptor
+ * @param rec - Recorder
+ * @return 0 if a record was written or there is no data yet, negative value
+ * otherwise.
  */
-static int iio_get_trigger(struct iiod_ctx *ctx, const char *device,
-			   char *trigger, uint32_t len)
+static int32_t iio_rec_fill(struct iio_desc *desc, struct iio_recorder *rec)
 {
-	struct iio_dev_priv *dev;
-	struct iio_desc *desc = ctx->instance;
+	struct iio_dev_priv *dev = rec->dev;
+	struct iiod_ctx ctx = { .instance = desc };
+	uint32_t size, len;
+	int32_t ret;
 
-	dev = get_iio_device(desc, device);
-	if (!dev)
-		return -ENODEV;
+	while (rec->fill < IIO_REC_PAYLOAD_SIZE) {
+		ret = no_os_cb_size(&dev->buffer.cb, &size);
+		if (ret == -NO_OS_EOVERRUN)
+			rec->flags |= IIO_REC_FLAG_OVERRUN;
+		else if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
 
-	if (dev->trig_idx == NO_TRIGGER) {
-		trigger[0] = '\0';
+		if (!size) {
+			/* Get the next block from the device */
+			ret = iio_call_submit(&ctx, dev->dev_id,
+					      IIO_DIRECTION_INPUT);
+			if (NO_OS_IS_ERR_VALUE(ret))
+				return ret;
+
+			ret = no_os_cb_size(&dev->buffer.cb, &size);
+			if (NO_OS_IS_ERR_VALUE(ret) && ret != -NO_OS_EOVERRUN)
+				return ret;
+			if (!size)
+				return -EAGAIN;
+		}
 
-		return 0;
+		len = no_os_min(size, IIO_REC_PAYLOAD_SIZE - rec->fill);
+		ret = no_os_cb_read(&dev->buffer.cb,
+				    rec->record + IIO_REC_HDR_SIZE + rec->fill,
+				    len);
+		if (ret == -NO_OS_EOVERRUN)
+			rec->flags |= IIO_REC_FLAG_OVERRUN;
+		else if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+		rec->fill += len;
 	}
 
-	return snprintf(trigger, len, "%s", desc->trigs[dev->trig_idx].name);
+	ret = iio_rec_write_record(rec, IIO_REC_TAG_DATA, rec->fill);
+	if (ret)
+		return ret;
+
+	rec->data_bytes += rec->fill;
+	rec->fill = 0;
+	if (++rec->nb_records == IIO_REC_INDEX_INTERVAL)
+		return iio_rec_write_index(rec);
+
+	return 0;
 }
 
 /**
- * @brief Searches for given trigger id for the given device and if found, it
- * sets the trigger.
- * @param ctx     - IIO instance and conn instance.
- * @param device  - String containing device name.
- * @param trigger - Trigger id to be set.
- * @param len     - Maximum length of value to be returned.
- * @return Positive if index was set, negative if not.
+ * @brief Write the captures of the recorded devices.
+ * @param desc - IIO descriptor
  */
-static int iio_set_trigger(struct iiod_ctx *ctx, const char *device,
-			   const char *trigger, uint32_t len)
+static void iio_recorder_step(struct iio_desc *desc)
 {
-	struct iio_dev_priv	*dev;
-	uint32_t i;
-
-	dev = get_iio_device(ctx->instance, device);
-	if (!dev)
-		return -ENODEV;
+	struct iio_recorder *rec;
+	uint32_t i, j;
+	int32_t ret;
 
-	if (trigger[0] == '\0') {
-		dev->trig_idx = NO_TRIGGER;
-		return 0;
+	for (i = 0; i < IIO_REC_MAX_FILES; i++) {
+		rec = &desc->recorders[i];
+		for (j = 0; rec->dev && !rec->error &&
+		     j < IIO_REC_STEP_RECORDS; j++) {
+			ret = iio_rec_fill(desc, rec);
+			if (ret == -EAGAIN)
+				break;
+			/* Kept until iio_recorder_stop, the data is not read */
+			if (ret)
+				rec->error = ret;
+		}
 	}
+}
 
-	i = iio_get_trig_idx_by_id(ctx->instance, trigger);
-	if (i == NO_TRIGGER)
-		return -EINVAL;
+/**
+ * @brief Write the data left and close a capture.
+ * @param desc - IIO descriptor
+ * @param rec - Recorder
+ * @return The first error of the capture, 0 if there was none.
+ */
+static int32_t iio_rec_close(struct iio_desc *desc, struct iio_recorder *rec)
+{
+	struct iiod_ctx ctx = { .instance = desc };
+	struct iio_dev_priv *dev = rec->dev;
+	int32_t ret = rec->error;
+
+	if (!ret && rec->fill) {
+		ret = iio_rec_write_record(rec, IIO_REC_TAG_DATA, rec->fill);
+		rec->data_bytes += rec->fill;
+		rec->fill = 0;
+	}
+	if (!ret)
+		ret = iio_rec_write_index(rec);
+	if (f_close(&rec->file) != FR_OK && !ret)
+		ret = -EIO;
 
-	dev->trig_idx = i;
+	dev->recorded = false;
+	iio_close_dev(&ctx, dev->dev_id);
+	rec->dev = NULL;
 
-	return len;
+	return ret;
 }
 
 /**
- * @brief Asynchronous trigger processing routine.
- * @param desc - IIO descriptor.
+ * @brief Start capturing the buffer data of a device to a file, from iio_step.
+ * The file system holding path must be mounted. The buffer can't be used by
+ * clients until the capture is stopped.
+ * @param desc - IIO descriptor
+ * @param device - Device id (iio:device0, iio:device1, etc.)
+ * @param mask - Mask of the channels to capture
+ * @param samples - Samples of a buffer block
+ * @param path - File created for the capture, replaced if it exists
+ * @return 0 in case of success, negative value otherwise.
  */
-static void iio_process_async_triggers(struct iio_desc *desc)
+int iio_recorder_start(struct iio_desc *desc, const char *device,
+		       uint32_t mask, uint32_t samples, const char *path)
 {
+	struct iiod_ctx ctx = { .instance = desc };
+	struct iio_recorder *rec = NULL;
 	struct iio_dev_priv *dev;
 	uint32_t i;
+	int32_t ret;
 
-	for (i = 0; i < desc->nb_devs; i++) {
-		dev = desc->devs + i;
-		if (dev->trig_idx == NO_TRIGGER)
-			continue;
+	if (!desc || !device || !path)
+		return -EINVAL;
 
-		if (!desc->trigs[dev->trig_idx].triggered)
-			continue;
+	dev = get_iio_device(desc, device);
+	if (!dev)
+		return -ENODEV;
 
-		if (dev->dev_descriptor->trigger_handler) {
-			dev->dev_descriptor->trigger_handler(&dev->dev_data);
-			desc->trigs[i].triggered = 0;
-		}
+	if (!desc->recorders) {
+		desc->recorders = no_os_calloc(IIO_REC_MAX_FILES,
+					       sizeof(*desc->recorders));
+		if (!desc->recorders)
+			return -ENOMEM;
+	}
+
+	for (i = 0; i < IIO_REC_MAX_FILES; i++) {
+		if (desc->recorders[i].dev == dev)
+			return -EBUSY;
+		if (!rec && !desc->recorders[i].dev)
+			rec = &desc->recorders[i];
+	}
+	if (!rec)
+		return -ENOSPC;
+
+	ret = iio_open_dev(&ctx, device, samples, mask, false);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	if (f_open(&rec->file, path, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK) {
+		iio_close_dev(&ctx, device);
+		return -EIO;
+	}
+
+	rec->dev = dev;
+	rec->fill = 0;
+	rec->nb_records = 0;
+	rec->data_bytes = 0;
+	rec->flags = 0;
+	rec->error = 0;
+	ret = iio_rec_write_header(desc, rec);
+	if (ret) {
+		f_close(&rec->file);
+		iio_close_dev(&ctx, device);
+		rec->dev = NULL;
+		return ret;
 	}
+	dev->recorded = true;
+
+	return 0;
 }
 
 /**
- * @brief Searches for trigger name and processes the trigger based on its
- * type (sync or async with the interrupt).
- * @param desc         - IIO descriptor.
- * @param trigger_name - Trigger name.
- *
- * @return ret - Result of the processing procedure.
+ * @brief Stop the capture of a device and close its file.
+ * @param desc - IIO descriptor
+ * @param device - Device id
+ * @return 0 in case of success, -ENOENT if the device is not recorded, the
+ * first error of the capture otherwise.
  */
-int iio_process_trigger_type(struct iio_desc *desc, char *trigger_name)
+int iio_recorder_stop(struct iio_desc *desc, const char *device)
 {
+	struct iio_dev_priv *dev;
 	uint32_t i;
-	uint32_t trig_id;
-	struct iio_trig_priv *trig;
-
-	trig_id = iio_get_trig_idx_by_name(desc, trigger_name);
 
-	if (trig_id == NO_TRIGGER)
+	if (!desc || !device)
 		return -EINVAL;
 
-	struct iio_dev_priv *dev;
+	dev = get_iio_device(desc, device);
+	if (!dev || !desc->recorders)
+		return -ENOENT;
 
-	for (i = 0; i < desc->nb_devs; i++) {
-		dev = desc->devs + i;
-		if (dev->trig_idx == trig_id) {
-			trig = &desc->trigs[trig_id];
-			if (trig->descriptor->is_synchronous) {
-				if (dev->dev_descriptor->trigger_handler)
-					dev->dev_descriptor->trigger_handler(&dev->dev_data);
-			} else {
-				trig->triggered = 1;
-			}
-		}
-	}
+	for (i = 0; i < IIO_REC_MAX_FILES; i++)
+		if (desc->recorders[i].dev == dev)
+			return iio_rec_close(desc, &desc->recorders[i]);
 
-	return 0;
+	return -ENOENT;
 }
 
-static uint32_t bytes_per_scan(struct iio_channel *channels, uint32_t mask)
+/**
+ * @brief Stop the captures and free the recorders.
+ * @param desc - IIO descriptor
+ */
+static void iio_recorder_remove(struct iio_desc *desc)
 {
-	uint32_t cnt, i;
+	uint32_t i;
 
-	cnt = 0;
-	i = 0;
-	while (mask) {
-		if ((mask & 1))
-			cnt += channels[i].scan_type->storagebits / 8;
-		mask >>= 1;
-		++i;
-	}
+	if (!desc->recorders)
+		return;
+
+	for (i = 0; i < IIO_REC_MAX_FILES; i++)
+		if (desc->recorders[i].dev)
+			iio_rec_close(desc, &desc->recorders[i]);
 
-	return cnt;
+	no_os_free(desc->recorders);
+	desc->recorders = NULL;
 }
+#endif
 
+#ifdef IIO_FREERTOS
 /**
- * @brief  Open device.
- * @param ctx - IIO instance and conn instance
- * @param device - String containing device name.
- * @param sample_size - Sample size.
- * @param mask - Channels to be opened.
- * @return 0, negative value in case of failure.
+ * @brief Wait until the transmit task sent all the queued data.
+ * @param rtos - Server tasks.
  */
-static int iio_open_dev(struct iiod_ctx *ctx, const char *device,
-			uint32_t samples, uint32_t mask, bool cyclic)
+static void iio_rtos_tx_flush(struct iio_rtos *rtos)
 {
-	struct iio_desc *desc;
-	struct iio_dev_priv *dev;
-	struct iio_trig_priv *trig;
-	uint32_t ch_mask;
-	int32_t ret;
-	int8_t *buf;
-	uint32_t buf_size;
+	while (uxQueueMessagesWaiting(rtos->tx_msgs) || rtos->tx_busy)
+		vTaskDelay(1);
+}
+#endif
 
-	dev = get_iio_device(ctx->instance, device);
-	if (!dev)
-		return -ENODEV;
+#ifdef IIO_USB
+static int iio_usb_recv(void *conn, uint8_t *buf, uint32_t len)
+{
+	struct iio_usb_conn *usb = conn;
 
-	if (!dev->buffer.initalized)
-		return -EINVAL;
+	if (usb->pipe->session != usb->session)
+		return -ENOTCONN;
 
-	ch_mask = 0xFFFFFFFF >> (32 - dev->dev_descriptor->num_ch);
-	mask &= ch_mask;
-	if (!mask)
-		return -ENOENT;
+	return no_os_usb_read(usb->pipe, buf, len);
+}
 
-	dev->buffer.public.cyclic_info.is_cyclic = cyclic;
-	dev->buffer.public.cyclic_info.buff_index = 0;
+static int iio_usb_send(void *conn, uint8_t *buf, uint32_t len)
+{
+	struct iio_usb_conn *usb = conn;
 
-	dev->buffer.public.active_mask = mask;
-	dev->buffer.public.bytes_per_scan =
-		bytes_per_scan(dev->dev_descriptor->channels, mask);
-	dev->buffer.public.size = dev->buffer.public.bytes_per_scan * samples;
-	if (dev->buffer.raw_buf && dev->buffer.raw_buf_len) {
-		if (dev->buffer.raw_buf_len < dev->buffer.public.size)
-			/* Need a bigger buffer or to allocate */
-			return -ENOMEM;
+	if (usb->pipe->session != usb->session)
+		return -ENOTCONN;
 
-		buf_size = dev->buffer.raw_buf_len;
-		buf = dev->buffer.raw_buf;
-	} else {
-		if (dev->buffer.allocated) {
-			/* Free in case iio_close_dev wasn't called to free it*/
-			free(dev->buffer.cb.buff);
-			dev->buffer.allocated = 0;
-		}
-		buf_size = dev->buffer.public.size;
-		buf = (int8_t *)calloc(dev->buffer.public.size, sizeof(*buf));
-		if (!buf)
-			return -ENOMEM;
-		dev->buffer.allocated = 1;
-	}
+	return no_os_usb_write(usb->pipe, buf, len);
+}
 
-	ret = no_os_cb_cfg(&dev->buffer.cb, buf, buf_size);
-	if (NO_OS_IS_ERR_VALUE(ret)) {
-		if (dev->buffer.allocated) {
-			free(dev->buffer.cb.buff);
-			dev->buffer.allocated = 0;
-		}
+/**
+ * @brief Add a connection for each pipe opened by the host. A closed pipe
+ * is removed by iio_step, once its connection fails with -ENOTCONN.
+ * @param desc - IIO descriptor
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int32_t iio_usb_step(struct iio_desc *desc)
+{
+	struct iiod_conn_data data;
+	struct iio_usb_conn *usb;
+	uint32_t i, id;
+	int32_t ret;
 
-		return ret;
-	}
+	for (i = 0; i < desc->usb_desc->nb_pipes; i++) {
+		usb = &desc->usb_conns[i];
+		if (usb->connected || !usb->pipe->open)
+			continue;
 
-	if (dev->dev_descriptor->pre_enable) {
-		ret = dev->dev_descriptor->pre_enable(dev->dev_instance, mask);
-		if (NO_OS_IS_ERR_VALUE(ret) && dev->buffer.allocated) {
-			free(dev->buffer.cb.buff);
-			dev->buffer.allocated = 0;
+		data.conn = usb;
+		data.buf = no_os_calloc(1, IIOD_CONN_BUFFER_SIZE);
+		if (!data.buf)
+			return -ENOMEM;
+		data.len = IIOD_CONN_BUFFER_SIZE;
+		data.weight = 1;
+
+		ret = iiod_conn_add(desc->iiod, &data, &id);
+		if (NO_OS_IS_ERR_VALUE(ret)) {
+			no_os_free(data.buf);
 			return ret;
 		}
-	}
 
-	desc = ctx->instance;
-	if (dev->trig_idx != NO_TRIGGER) {
-		trig = &desc->trigs[dev->trig_idx];
-		if (trig->descriptor->enable)
-			ret = trig->descriptor->enable(trig->instance);
+		usb->session = usb->pipe->session;
+		usb->connected = true;
+		usb->conn_id = id;
+		_push_conn(desc, id);
 	}
 
-	return ret;
+	return 0;
 }
 
 /**
- * @brief Close device.
- * @param ctx - IIO instance and conn instance
- * @param device - String containing device name.
- * @return 0, negative value in case of failure.
+ * @brief Remove the connections of the USB pipes.
+ * @param desc - IIO descriptor
  */
-static int iio_close_dev(struct iiod_ctx *ctx, const char *device)
+static void iio_usb_remove(struct iio_desc *desc)
 {
-	struct iio_desc *desc;
-	struct iio_dev_priv *dev;
-	struct iio_trig_priv *trig;
-	int ret = 0;
+	struct iiod_conn_data data;
+	uint32_t i;
 
-	dev = get_iio_device(ctx->instance, device);
-	if (!dev)
-		return -1;
+	if (!desc->usb_desc)
+		return;
 
-	if (!dev->buffer.initalized)
-		return -EINVAL;
+	for (i = 0; i < desc->usb_desc->nb_pipes; i++) {
+		if (!desc->usb_conns[i].connected)
+			continue;
 
-	if (dev->buffer.allocated) {
-		/* Should something else be used to free internal strucutre */
-		free(dev->buffer.cb.buff);
-		dev->buffer.allocated = 0;
+		iiod_conn_remove(desc->iiod, desc->usb_conns[i].conn_id, &data);
+		no_os_free(data.buf);
+		desc->usb_conns[i].connected = false;
 	}
+}
+#endif
 
-	dev->buffer.public.active_mask = 0;
-	if (dev->dev_descriptor->post_disable) {
-		ret = dev->dev_descriptor->post_disable(dev->dev_instance);
-		if (ret)
-			return ret;
+/**
+ * @brief Execute an iio step
+ * @param desc - IIo descriptor
+ * @return 0 in case of success or negative value otherwise.
+ */
+int iio_step(struct iio_desc *desc)
+{
+	struct iiod_conn_data data;
+	uint32_t conn_id;
+	int32_t ret;
+#ifdef IIO_STATS
+	uint32_t start = iio_stats_time_us();
+#endif
+
+	NO_OS_TRACE_ENTER(NO_OS_TRACE_IIO_STEP);
+#ifdef IIO_FREERTOS
+	/* Served by the worker task once the server tasks are started */
+	if (!desc->rtos)
+#endif
+		iio_process_async_triggers(desc);
+
+#ifdef NO_OS_NETWORKING
+	if (desc->server) {
+		ret = accept_network_clients(desc);
+		if (NO_OS_IS_ERR_VALUE(ret) && ret != -EAGAIN)
+			goto out;
+	}
+	if (desc->udp_net)
+		iio_udp_step(desc);
+#endif
+#ifdef IIO_USB
+	if (desc->usb_desc) {
+		ret = iio_usb_step(desc);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			goto out;
 	}
+#endif
+#ifdef IIO_RECORDER
+	if (desc->recorders)
+		iio_recorder_step(desc);
+#endif
+	if (desc->nb_probing)
+		iio_probe_step(desc);
 
-	desc = ctx->instance;
-	if(dev->trig_idx != NO_TRIGGER) {
-		trig = &desc->trigs[dev->trig_idx];
-		if (trig->descriptor->disable)
-			ret = trig->descriptor->disable(trig->instance);
+	ret = _pop_conn(desc, &conn_id);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		goto out;
+
+	ret = iiod_conn_step(desc->iiod, conn_id);
+	if (ret == -ENOTCONN) {
+#ifdef NO_OS_NETWORKING
+		if (desc->server) {
+#ifdef IIO_FREERTOS
+			/* The transmit task may still use the socket */
+			if (desc->rtos)
+				iio_rtos_tx_flush(desc->rtos);
+#endif
+			iiod_conn_remove(desc->iiod, conn_id, &data);
+			socket_remove(data.conn);
+			no_os_free(data.buf);
+		}
+#endif
+#ifdef IIO_USB
+		if (desc->usb_desc) {
+			iiod_conn_remove(desc->iiod, conn_id, &data);
+			((struct iio_usb_conn *)data.conn)->connected = false;
+			no_os_free(data.buf);
+		}
+#endif
+	} else {
+		_push_conn(desc, conn_id);
 	}
+out:
+#ifdef IIO_STATS
+	desc->step_stats.last_us = iio_stats_time_us() - start;
+	desc->step_stats.total_us += desc->step_stats.last_us;
+	desc->step_stats.count++;
+	if (desc->step_stats.last_us > desc->step_stats.max_us)
+		desc->step_stats.max_us = desc->step_stats.last_us;
+#endif
+	NO_OS_TRACE_EXIT(NO_OS_TRACE_IIO_STEP);
 
 	return ret;
 }
 
-static int iio_call_submit(struct iiod_ctx *ctx, const char *device,
-			   enum iio_buffer_direction dir)
+/**
+ * @brief Sleep until a client sends data or timeout_ms elapse, when iio_step
+ * has nothing else to do. Returns at once while buffers are open, triggers
+ * are pending or a command is in progress.
+ * @param desc - IIO descriptor.
+ * @param timeout_ms - Longest time to sleep, for the devices polled by the
+ * application between the steps.
+ * @return 0 or the number of ready sockets in case of success, -ENOSYS if the
+ * transport can't wait, negative error code otherwise.
+ */
+int iio_wait(struct iio_desc *desc, uint32_t timeout_ms)
 {
-	struct iio_dev_priv *dev;
+#ifdef NO_OS_NETWORKING
+	uint32_t i;
 
-	dev = get_iio_device(ctx->instance, device);
-	if (!dev || !dev->buffer.initalized)
+	if (!desc)
 		return -EINVAL;
 
-	dev->buffer.public.dir = dir;
-	if (dev->dev_descriptor->submit && dev->trig_idx==NO_TRIGGER)
-		return dev->dev_descriptor->submit(&dev->dev_data);
-	else if ((dir == IIO_DIRECTION_INPUT && dev->dev_descriptor->read_dev
-		  && dev->trig_idx==NO_TRIGGER)
-		 || (dir == IIO_DIRECTION_OUTPUT &&
-		     dev->dev_descriptor->write_dev && dev->trig_idx==NO_TRIGGER)) {
-		/* Code used to don't break devices using read_dev */
-		int32_t ret;
-		uint32_t nb_scans;
-		void *buff;
-		struct iio_buffer *buffer = &dev->buffer.public;
+	if (!desc->server)
+		return -ENOSYS;
 
-		ret = iio_buffer_get_block(buffer, &buff);
-		if (NO_OS_IS_ERR_VALUE(ret))
-			return ret;
+	for (i = 0; i < desc->nb_devs; i++)
+		if (desc->devs[i].buffer.public.active_mask)
+			return 0;
 
-		nb_scans = buffer->size / buffer->bytes_per_scan;
-		if (dir == IIO_DIRECTION_INPUT)
-			ret = dev->dev_descriptor->read_dev(dev->dev_instance,
-							    buff, nb_scans);
-		else
-			ret = dev->dev_descriptor->write_dev(dev->dev_instance,
-							     buff, nb_scans);
-		if (NO_OS_IS_ERR_VALUE(ret))
-			return ret;
+	for (i = 0; i < desc->nb_trigs; i++)
+		if (desc->trigs[i].raised != desc->trigs[i].served)
+			return 0;
 
-		return iio_buffer_block_done(buffer);
-	}
+#ifdef IIO_RECORDER
+	if (desc->recorders)
+		return 0;
+#endif
+	if (!iiod_idle(desc->iiod))
+		return 0;
 
-	return 0;
+	return socket_wait(desc->server, timeout_ms);
+#else
+	return -ENOSYS;
+#endif
 }
 
-static int iio_push_buffer(struct iiod_ctx *ctx, const char *device)
+#ifdef NO_OS_SCHED
+/**
+ * @brief Scheduler work of the IIO descriptor. As long as iio_step completes
+ * commands it runs again on the next loop iteration, otherwise it waits
+ * sched_poll_ms or an asynchronous trigger.
+ * @param ctx - IIO descriptor.
+ */
+static void iio_sched_step(void *ctx)
 {
-	return iio_call_submit(ctx, device, IIO_DIRECTION_OUTPUT);
-}
+	struct iio_desc *desc = ctx;
+	uint32_t poll_ms = desc->sched_poll_ms;
+	bool open = false;
+	uint32_t i;
 
-static int iio_refill_buffer(struct iiod_ctx *ctx, const char *device)
-{
-	return iio_call_submit(ctx, device, IIO_DIRECTION_INPUT);
+	/* Open buffers stream from triggers or DMA, keep the clocks running */
+	for (i = 0; i < desc->nb_devs; i++)
+		open = open || desc->devs[i].buffer.public.active_mask;
+	if (open != desc->sched_deep_locked) {
+		desc->sched_deep_locked = open;
+		if (open)
+			no_os_sched_deep_lock();
+		else
+			no_os_sched_deep_unlock();
+	}
+
+	if (!iio_step(desc)) {
+		desc->sched_idle_time = 0;
+		no_os_sched_post(&desc->step_work);
+		return;
+	}
+
+	if (!open && desc->sched_idle_poll_ms) {
+		if (desc->sched_idle_time >= desc->sched_idle_ms)
+			poll_ms = desc->sched_idle_poll_ms;
+		else
+			desc->sched_idle_time += poll_ms;
+	}
+
+	no_os_sched_timer_start(&desc->step_work, poll_ms, 0);
 }
 
 /**
- * @brief Read chunk of data from RAM to pbuf. Call
- * "iio_transfer_dev_to_mem()" first.
- * This function is probably called multiple times by libtinyiiod after a
- * "iio_transfer_dev_to_mem" call, since we can only read "bytes_count" bytes.
- * @param device - String containing device name.
- * @param pbuf - Buffer where value is stored.
- * @param offset - Offset to the remaining data after reading n chunks.
- * @param bytes_count - Number of bytes to read.
- * @return: Bytes_count or negative value in case of error.
+ * @brief Slow down the polling of iio_step once the clients are idle, letting
+ * the CPU reach the deep sleep states between the polls. Data received while
+ * sleeping has to wake up the CPU, and the application to call iio_sched_wake:
+ * from the UART RX or GPIO interrupt, for example.
+ * @param desc - IIO descriptor, started with iio_sched_start.
+ * @param idle_ms - Milliseconds without command and without open buffer after
+ * which the clients are idle.
+ * @param idle_poll_ms - Milliseconds between two polls once idle, 0 to always
+ * poll with the period of iio_sched_start.
+ * @return 0 in case of success, negative error code otherwise.
  */
-static int iio_read_buffer(struct iiod_ctx *ctx, const char *device, char *buf,
-			   uint32_t bytes)
+int iio_sched_set_idle(struct iio_desc *desc, uint32_t idle_ms,
+		       uint32_t idle_poll_ms)
 {
-	struct iio_dev_priv	*dev;
-	int32_t			ret;
-	uint32_t		size;
-
-	dev = get_iio_device(ctx->instance, device);
-	if (!dev || !dev->buffer.initalized)
+	if (!desc)
 		return -EINVAL;
 
-	ret = no_os_cb_size(&dev->buffer.cb, &size);
-#ifdef IIO_IGNORE_BUFF_OVERRUN_ERR
-#warning Buffer overrun error checking is disabled.
-	if (ret != -NO_OS_EOVERRUN)
-#endif
-		if (NO_OS_IS_ERR_VALUE(ret))
-			return ret;
-
-	bytes = no_os_min(size, bytes);
-	if (!bytes)
-		return -EAGAIN;
+	desc->sched_idle_ms = idle_ms;
+	desc->sched_idle_poll_ms = idle_poll_ms;
+	desc->sched_idle_time = 0;
 
+	return 0;
+}
 
-	ret = no_os_cb_read(&dev->buffer.cb, buf, bytes);
-#ifdef IIO_IGNORE_BUFF_OVERRUN_ERR
-	if (ret != -NO_OS_EOVERRUN)
-#endif
-		if (NO_OS_IS_ERR_VALUE(ret))
-			return ret;
+/**
+ * @brief Leave the idle polling of iio_sched_set_idle and run iio_step on the
+ * next loop iteration. Safe from interrupts.
+ * @param desc - IIO descriptor, started with iio_sched_start.
+ */
+void iio_sched_wake(struct iio_desc *desc)
+{
+	if (!desc)
+		return;
 
-	return bytes;
+	desc->sched_idle_time = 0;
+	no_os_sched_post(&desc->step_work);
 }
 
-
 /**
- * @brief Write chunk of data into RAM.
- * This function is probably called multiple times by libtinyiiod before a
- * "iio_transfer_mem_to_dev" call, since we can only write "bytes_count" bytes
- * at a time.
- * @param device - String containing device name.
- * @param buf - Values to write.
- * @param offset - Offset in memory after the nth chunk of data.
- * @param bytes_count - Number of bytes to write.
- * @return Bytes_count or negative value in case of error.
+ * @brief Run iio_step from the cooperative scheduler instead of a spin loop.
+ * The CPU sleeps between the polls of an idle connection.
+ * @param desc - IIO descriptor.
+ * @param poll_ms - Milliseconds between two polls of an idle connection. It
+ * must be short enough for the UART or socket buffers not to overflow.
+ * @return 0 in case of success, negative error code otherwise.
  */
-static int iio_write_buffer(struct iiod_ctx *ctx, const char *device,
-			    const char *buf, uint32_t bytes)
+int iio_sched_start(struct iio_desc *desc, uint32_t poll_ms)
 {
-	struct iio_dev_priv	*dev;
-	int32_t			ret;
-	uint32_t		available;
-	uint32_t		size;
+	int ret;
 
-	dev = get_iio_device(ctx->instance, device);
-	if (!dev || !dev->buffer.initalized)
+	if (!desc)
 		return -EINVAL;
 
-	ret = no_os_cb_size(&dev->buffer.cb, &size);
-	if (NO_OS_IS_ERR_VALUE(ret))
+	desc->sched_poll_ms = poll_ms;
+	ret = no_os_sched_work_add(&desc->step_work, iio_sched_step, desc);
+	if (ret)
 		return ret;
 
-	available = dev->buffer.public.size - size;
-	bytes = no_os_min(available, bytes);
-	ret = no_os_cb_write(&dev->buffer.cb, buf, bytes);
-	if (NO_OS_IS_ERR_VALUE(ret))
-		return ret;
+	no_os_sched_post(&desc->step_work);
 
-	return bytes;
+	return 0;
 }
+#endif
 
-int iio_buffer_get_block(struct iio_buffer *buffer, void **addr)
+#ifdef IIO_FREERTOS
+/**
+ * @brief Command task: runs iio_step, sleeping poll_ms or until
+ * iio_rtos_kick when there is nothing to do.
+ * @param arg - IIO descriptor.
+ */
+static void iio_rtos_cmd_task(void *arg)
 {
-	int32_t ret;
-	uint32_t size;
+	struct iio_desc *desc = arg;
+	int ret;
 
-	if (!buffer)
-		return -EINVAL;
+	while (true) {
+		xSemaphoreTake(desc->rtos->lock, portMAX_DELAY);
+		ret = iio_step(desc);
+		xSemaphoreGive(desc->rtos->lock);
 
-	if (buffer->dir == IIO_DIRECTION_INPUT)
-		ret = no_os_cb_prepare_async_write(buffer->buf, buffer->size, addr,
-						   &size);
-	else
-		ret = no_os_cb_prepare_async_read(buffer->buf, buffer->size, addr,
-						  &size);
-	if (NO_OS_IS_ERR_VALUE(ret))
-		/* ToDo: Implement async cancel. And cancel transaction here.
-		 * Also cancel may be needed for a posible future abort callback
-		 * If this is not done, after the first error all future calls
-		 * to async will fail.
-		 * An other option will be to call cb_cfg but then data is lost
-		 */
-		return ret;
+		if (ret)
+			ulTaskNotifyTake(pdTRUE,
+					 pdMS_TO_TICKS(desc->rtos->poll_ms));
+	}
+}
 
-	/* This function is exepected to be called for a DMA transaction of the
-	 * full buffer. But if can't do in one transaction won't work.
-	 * This behavior is not expected anyway.
-	 */
-	if (size != buffer->size)
-		return -ENOMEM;
+/**
+ * @brief Transmit task: writes the queued data to the connections, blocking
+ * as long as needed without holding the command task. The data of a
+ * connection that fails is dropped.
+ * @param arg - IIO descriptor.
+ */
+static void iio_rtos_tx_task(void *arg)
+{
+	struct iio_desc *desc = arg;
+	struct iio_rtos *rtos = desc->rtos;
+	struct iio_rtos_tx_msg msg;
+	uint32_t n, i;
+	int ret;
+
+	while (true) {
+		xQueueReceive(rtos->tx_msgs, &msg, portMAX_DELAY);
+		rtos->tx_busy = true;
+
+		while (msg.len) {
+			n = xStreamBufferReceive(rtos->tx_data, rtos->tx_chunk,
+						 no_os_min(msg.len,
+							   IIO_RTOS_TX_CHUNK),
+						 portMAX_DELAY);
+			msg.len -= n;
+
+			for (i = 0; msg.conn && i < n; i += ret) {
+				ret = desc->send(msg.conn, rtos->tx_chunk + i,
+						 n - i);
+				if (ret == -EAGAIN || ret == 0) {
+					ret = 0;
+					vTaskDelay(1);
+				} else if (ret < 0) {
+					msg.conn = NULL;
+				}
+			}
+		}
 
-	return 0;
+		rtos->tx_busy = false;
+		/* Room was made for the responses of the command task */
+		xTaskNotifyGive(rtos->cmd_task);
+	}
 }
 
-int iio_buffer_block_done(struct iio_buffer *buffer)
+/**
+ * @brief Worker task: runs the asynchronous triggers and the deferred jobs,
+ * between two iio_step.
+ * @param arg - IIO descriptor.
+ */
+static void iio_rtos_worker_task(void *arg)
 {
-	if (!buffer)
-		return -EINVAL;
-
-	if (buffer->dir == IIO_DIRECTION_INPUT)
-		return no_os_cb_end_async_write(buffer->buf);
+	struct iio_desc *desc = arg;
+	struct iio_rtos_job job;
 
-	return no_os_cb_end_async_read(buffer->buf);
+	while (true) {
+		xQueueReceive(desc->rtos->jobs, &job, portMAX_DELAY);
+
+		xSemaphoreTake(desc->rtos->lock, portMAX_DELAY);
+		job.fn(job.ctx);
+		xSemaphoreGive(desc->rtos->lock);
+	}
 }
 
-/* Write to buffer iio_buffer.bytes_per_scan bytes from data */
-int iio_buffer_push_scan(struct iio_buffer *buffer, void *data)
+/**
+ * @brief Delete the server tasks and their queues.
+ * @param rtos - Server tasks, partially created or not.
+ */
+static void iio_rtos_free(struct iio_rtos *rtos)
 {
-	if (!buffer)
-		return -EINVAL;
-
-	return no_os_cb_write(buffer->buf, data, buffer->bytes_per_scan);
+	if (rtos->cmd_task)
+		vTaskDelete(rtos->cmd_task);
+	if (rtos->tx_task)
+		vTaskDelete(rtos->tx_task);
+	if (rtos->worker_task)
+		vTaskDelete(rtos->worker_task);
+	if (rtos->jobs)
+		vQueueDelete(rtos->jobs);
+	if (rtos->tx_data)
+		vStreamBufferDelete(rtos->tx_data);
+	if (rtos->tx_msgs)
+		vQueueDelete(rtos->tx_msgs);
+	if (rtos->lock)
+		vSemaphoreDelete(rtos->lock);
+	no_os_free(rtos);
 }
 
-/* Read from buffer iio_buffer.bytes_per_scan bytes into data */
-int iio_buffer_pop_scan(struct iio_buffer *buffer, void *data)
+/**
+ * @brief Serve the IIO clients from FreeRTOS tasks instead of iio_step
+ * calls. Responses are queued to a transmit task, so a slow connection does
+ * not hold the command execution, and the asynchronous triggers and deferred
+ * jobs run in a worker task.
+ * @param desc - IIO descriptor.
+ * @param param - Task parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int iio_rtos_start(struct iio_desc *desc, const struct iio_rtos_param *param)
 {
-	if (!buffer)
+	struct iio_rtos *rtos;
+	BaseType_t ret;
+
+	if (!desc || !param || !param->stack_words || !param->tx_buffer_size ||
+	    !param->nb_jobs || param->priority + 2 >= configMAX_PRIORITIES)
 		return -EINVAL;
 
-	if(!buffer->cyclic_info.is_cyclic)
-		return no_os_cb_read(buffer->buf, data, buffer->bytes_per_scan);
+	if (desc->rtos)
+		return -EBUSY;
 
-	memcpy(data,
-	       &buffer->buf->buff[buffer->cyclic_info.buff_index],
-	       buffer->bytes_per_scan);
+	rtos = no_os_calloc(1, sizeof(*rtos));
+	if (!rtos)
+		return -ENOMEM;
 
-	buffer->cyclic_info.buff_index += buffer->bytes_per_scan;
-	if (buffer->size == buffer->cyclic_info.buff_index)
-		buffer->cyclic_info.buff_index = 0;
+	rtos->poll_ms = param->poll_ms;
+	rtos->lock = xSemaphoreCreateMutex();
+	rtos->tx_msgs = xQueueCreate(param->nb_jobs,
+				     sizeof(struct iio_rtos_tx_msg));
+	rtos->tx_data = xStreamBufferCreate(param->tx_buffer_size, 1);
+	rtos->jobs = xQueueCreate(param->nb_jobs, sizeof(struct iio_rtos_job));
+	if (!rtos->lock || !rtos->tx_msgs || !rtos->tx_data || !rtos->jobs)
+		goto error;
+
+	/* The tasks use desc->rtos as soon as they are created */
+	desc->rtos = rtos;
+
+	/* Draining the responses and the jobs comes before new commands */
+	ret = xTaskCreate(iio_rtos_worker_task, "iio_worker",
+			  param->stack_words, desc, param->priority + 2,
+			  &rtos->worker_task);
+	if (ret != pdPASS)
+		goto error;
+
+	ret = xTaskCreate(iio_rtos_tx_task, "iio_tx", param->stack_words,
+			  desc, param->priority + 1, &rtos->tx_task);
+	if (ret != pdPASS)
+		goto error;
+
+	ret = xTaskCreate(iio_rtos_cmd_task, "iio_cmd", param->stack_words,
+			  desc, param->priority, &rtos->cmd_task);
+	if (ret != pdPASS)
+		goto error;
 
 	return 0;
-}
+error:
+	desc->rtos = NULL;
+	iio_rtos_free(rtos);
 
-#ifdef NO_OS_NETWORKING
+	return -ENOMEM;
+}
 
-static int32_t accept_network_clients(struct iio_desc *desc)
+/**
+ * @brief Run a function in the worker task, with the server locked. Safe
+ * from interrupts, for example to complete a DMA block out of the interrupt.
+ * @param desc - IIO descriptor.
+ * @param fn - Function.
+ * @param ctx - Parameter of fn.
+ * @return 0 in case of success, -ENOSPC if the job queue is full.
+ */
+int iio_rtos_defer(struct iio_desc *desc, void (*fn)(void *ctx), void *ctx)
 {
-	struct tcp_socket_desc *sock;
-	struct iiod_conn_data data;
-	int32_t ret;
-	do {
-		uint32_t id;
-		ret = socket_accept(desc->server, &sock);
-		if (NO_OS_IS_ERR_VALUE(ret))
-			return ret;
-
-		data.conn = sock;
-		data.buf = calloc(1, IIOD_CONN_BUFFER_SIZE);
-		data.len = IIOD_CONN_BUFFER_SIZE;
+	struct iio_rtos_job job = { .fn = fn, .ctx = ctx };
+	BaseType_t woken = pdFALSE;
+	BaseType_t ret;
 
-		ret = iiod_conn_add(desc->iiod, &data, &id);
-		if (NO_OS_IS_ERR_VALUE(ret))
-			return ret;
+	if (!desc || !desc->rtos || !fn)
+		return -EINVAL;
 
-		ret = _push_conn(desc, id);
-		if (NO_OS_IS_ERR_VALUE(ret))
-			return ret;
-	} while (true);
+	if (xPortIsInsideInterrupt()) {
+		ret = xQueueSendFromISR(desc->rtos->jobs, &job, &woken);
+		portYIELD_FROM_ISR(woken);
+	} else {
+		ret = xQueueSend(desc->rtos->jobs, &job, 0);
+	}
 
-	return 0;
+	return ret == pdPASS ? 0 : -ENOSPC;
 }
-#endif
 
 /**
- * @brief Execute an iio step
- * @param desc - IIo descriptor
- * @return 0 in case of success or negative value otherwise.
+ * @brief Wake up the command task, for example from the receive interrupt of
+ * the connection, instead of waiting for the end of the poll period.
+ * @param desc - IIO descriptor.
  */
-int iio_step(struct iio_desc *desc)
+void iio_rtos_kick(struct iio_desc *desc)
 {
-	struct iiod_conn_data data;
-	uint32_t conn_id;
-	int32_t ret;
+	BaseType_t woken = pdFALSE;
 
-	iio_process_async_triggers(desc);
+	if (!desc || !desc->rtos || !desc->rtos->cmd_task)
+		return;
 
-#ifdef NO_OS_NETWORKING
-	if (desc->server) {
-		ret = accept_network_clients(desc);
-		if (NO_OS_IS_ERR_VALUE(ret) && ret != -EAGAIN)
-			return ret;
+	if (xPortIsInsideInterrupt()) {
+		vTaskNotifyGiveFromISR(desc->rtos->cmd_task, &woken);
+		portYIELD_FROM_ISR(woken);
+	} else {
+		xTaskNotifyGive(desc->rtos->cmd_task);
 	}
+}
 #endif
 
-	ret = _pop_conn(desc, &conn_id);
-	if (NO_OS_IS_ERR_VALUE(ret))
-		return ret;
+/**
+ * @brief Add a string to the xml window.
+ * Only the part of the string that falls in the window is copied.
+ * @param xml - Xml window.
+ * @param str - String to be added.
+ * @param len - Length of str.
+ */
+static void iio_xml_write(struct iio_xml_buf *xml, const char *str,
+			  uint32_t len)
+{
+	uint32_t start, end;
+
+	if (xml->buf) {
+		start = no_os_max(xml->pos, xml->offset);
+		end = no_os_min(xml->pos + len, xml->offset + xml->len);
+		if (start < end)
+			memcpy(xml->buf + start - xml->offset,
+			       str + start - xml->pos, end - start);
+	}
+	xml->pos += len;
+}
 
-	ret = iiod_conn_step(desc->iiod, conn_id);
-	if (ret == -ENOTCONN) {
-#ifdef NO_OS_NETWORKING
-		if (desc->server) {
-			iiod_conn_remove(desc->iiod, conn_id, &data);
-			socket_remove(data.conn);
-			free(data.buf);
-		}
-#endif
-	} else {
-		_push_conn(desc, conn_id);
+/**
+ * @brief Add a formatted string to the xml window.
+ * @param xml - Xml window.
+ * @param fmt - Format, as for printf.
+ */
+static void iio_xml_print(struct iio_xml_buf *xml, const char *fmt, ...)
+{
+	char tmp[IIO_XML_TOKEN_SIZE];
+	va_list args;
+	int len;
+
+	va_start(args, fmt);
+	len = vsnprintf(tmp, sizeof(tmp), fmt, args);
+	va_end(args);
+	if (len < 0 || len >= (int)sizeof(tmp)) {
+		xml->ret = -EINVAL;
+		return;
 	}
 
-	return ret;
+	iio_xml_write(xml, tmp, len);
 }
 
 /**
  * @brief Add context attributes into xml string buffer.
  * @param desc - IIo descriptor.
- * @param buff - xml buffer.
- * @param buff_size - size of buffer
- * @return 0 in case of success or negative value otherwise.
+ * @param xml - Xml window.
  */
-static uint32_t iio_add_cntx_attr_in_xml(struct iio_desc *desc, char *buff,
-		uint32_t buff_size)
+static void iio_add_cntx_attr_in_xml(struct iio_desc *desc,
+				     struct iio_xml_buf *xml)
 {
 	struct iio_cntx_attr_priv *cntx_attr;
-	char dummy_buff[50];
-	int32_t i;
+	const char *value;
 	int32_t j;
-	int32_t n;
-
-	if ((int32_t)buff_size == -1)
-		n = 0;
-	else
-		n = buff_size;
-
-	if (buff == NULL)
-		/* Set dummy value for buff. It is used only for counting */
-		buff = dummy_buff;
 
-	i = 0;
+	if (desc->buffer_compression)
+		iio_xml_print(xml, "<context-attribute name=\"%s\" "
+			      "value=\"%s\" />", IIO_COMP_CNTX_ATTR,
+			      IIO_COMP_DELTA);
 
 	cntx_attr =  desc->cntx_attributes;
 	if (cntx_attr)
 		for (j = 0; j < (int32_t)desc->nb_cntx_attr; j++) {
-			i += snprintf(buff + i,
-				      no_os_max(n - i, 0),
-				      "<context-attribute name=\"%s\" ",
+			iio_xml_print(xml, "<context-attribute name=\"%s\" ",
 				      cntx_attr->attributes[j].name);
 
-			i += snprintf(buff + i,
-				      no_os_max(n - i, 0),
-				      "value=\"%s\" />",
-				      cntx_attr->attributes[j].value);
+			/* Values can be longer than a token */
+			value = cntx_attr->attributes[j].value;
+			iio_xml_print(xml, "value=\"");
+			iio_xml_write(xml, value, strlen(value));
+			iio_xml_print(xml, "\" />");
 		}
-
-	return i;
 }
 
 /*
- * Generate an xml describing a device and write it to buff.
- * Will return the size of the xml.
- * If buff_size is 0, no data will be written to buff, but size will be returned
+ * Generate an xml describing a device and add it to the xml window.
+ * The size of the xml is added to xml->pos. flags are IIO_XML_* attributes
+ * added by iio itself.
  */
-static uint32_t iio_generate_device_xml(struct iio_device *device, char *name,
-					char *id, char *buff,
-					uint32_t buff_size)
+static int32_t iio_generate_device_xml(const struct iio_device *device,
+				       char *name, char *id, uint32_t flags,
+				       struct iio_xml_buf *xml)
 {
-	struct iio_channel	*ch;
-	struct iio_attribute	*attr;
+	const struct iio_channel	*ch;
+	const struct iio_attribute	*attr;
 	char			ch_id[50];
-	int32_t			i;
 	int32_t			j;
 	int32_t			k;
-	int32_t			n;
-
-	if ((int32_t)buff_size == -1)
-		n = 0;
-	else
-		n = buff_size;
 
-	if (buff == NULL)
-		/* Set dummy value for buff. It is used only for counting */
-		buff = ch_id;
-
-	i = 0;
-
-	i += snprintf(buff + i, no_os_max(n - i, 0),
-		      "<device id=\"%s\" name=\"%s\">", id, name);
+	iio_xml_print(xml, "<device id=\"%s\" name=\"%s\">", id, name);
 
 	/* Write channels */
 	if (device->channels)
 		for (j = 0; j < device->num_ch; j++) {
 			ch = &device->channels[j];
 			_print_ch_id(ch_id, ch);
-			i += snprintf(buff + i, no_os_max(n - i, 0),
-				      "<channel id=\"%s\"",
+			iio_xml_print(xml, "<channel id=\"%s\"",
 				      ch_id);
 			if(ch->name)
-				i += snprintf(buff + i, no_os_max(n - i, 0),
-					      " name=\"%s\"",
+				iio_xml_print(xml, " name=\"%s\"",
 					      ch->name);
-			i += snprintf(buff + i, no_os_max(n - i, 0),
-				      " type=\"%s\" >",
+			iio_xml_print(xml, " type=\"%s\" >",
 				      ch->ch_out ? "output" : "input");
 
 			if (ch->scan_type)
-				i += snprintf(buff + i, no_os_max(n - i, 0),
-					      "<scan-element index=\"%d\""
+				iio_xml_print(xml, "<scan-element index=\"%d\""
 					      " format=\"%s:%c%d/%d>>%d\" />",
 					      ch->scan_index,
 					      ch->scan_type->is_big_endian ? "be" : "le",
@@ -1566,24 +6243,21 @@ static uint32_t iio_generate_device_xml(struct iio_device *device, char *name,
 			if (ch->attributes)
 				for (k = 0; ch->attributes[k].name; k++) {
 					attr = &ch->attributes[k];
-					i += snprintf(buff + i, no_os_max(n - i, 0), "<attribute name=\"%s\" ",
+					iio_xml_print(xml, "<attribute name=\"%s\" ",
 						      attr->name);
 					if (ch->diferential) {
 						switch (attr->shared) {
 						case IIO_SHARED_BY_ALL:
-							i += snprintf(buff + i, no_os_max(n - i, 0),
-								      "filename=\"%s\"",
+							iio_xml_print(xml, "filename=\"%s\"",
 								      attr->name);
 							break;
 						case IIO_SHARED_BY_DIR:
-							i += snprintf(buff + i, no_os_max(n - i, 0),
-								      "filename=\"%s_%s\"",
+							iio_xml_print(xml, "filename=\"%s_%s\"",
 								      ch->ch_out ? "out" : "in",
 								      attr->name);
 							break;
 						case IIO_SHARED_BY_TYPE:
-							i += snprintf(buff + i, no_os_max(n - i, 0),
-								      "filename=\"%s_%s-%s_%s\"",
+							iio_xml_print(xml, "filename=\"%s_%s-%s_%s\"",
 								      ch->ch_out ? "out" : "in",
 								      iio_chan_type_string[ch->ch_type],
 								      iio_chan_type_string[ch->ch_type],
@@ -1594,8 +6268,7 @@ static uint32_t iio_generate_device_xml(struct iio_device *device, char *name,
 								// Differential channels must be indexed!
 								return -EINVAL;
 							}
-							i += snprintf(buff + i, no_os_max(n - i, 0),
-								      "filename=\"%s_%s%d-%s%d_%s\"",
+							iio_xml_print(xml, "filename=\"%s_%s%d-%s%d_%s\"",
 								      ch->ch_out ? "out" : "in",
 								      iio_chan_type_string[ch->ch_type],
 								      ch->channel,
@@ -1607,123 +6280,242 @@ static uint32_t iio_generate_device_xml(struct iio_device *device, char *name,
 					} else {
 						switch (attr->shared) {
 						case IIO_SHARED_BY_ALL:
-							i += snprintf(buff + i, no_os_max(n - i, 0),
-								      "filename=\"%s\"",
+							iio_xml_print(xml, "filename=\"%s\"",
 								      attr->name);
 							break;
 						case IIO_SHARED_BY_DIR:
-							i += snprintf(buff + i, no_os_max(n - i, 0),
-								      "filename=\"%s_%s\"",
+							iio_xml_print(xml, "filename=\"%s_%s\"",
 								      ch->ch_out ? "out" : "in",
 								      attr->name);
 							break;
 						case IIO_SHARED_BY_TYPE:
-							i += snprintf(buff + i, no_os_max(n - i, 0),
-								      "filename=\"%s_%s_%s\"",
+							iio_xml_print(xml, "filename=\"%s_%s_%s\"",
 								      ch->ch_out ? "out" : "in",
 								      iio_chan_type_string[ch->ch_type],
 								      attr->name);
 							break;
 						case IIO_SEPARATE:
 							if (ch->indexed)
-								i += snprintf(buff + i, no_os_max(n - i, 0),
-									      "filename=\"%s_%s%d_%s\"",
+								iio_xml_print(xml, "filename=\"%s_%s%d_%s\"",
 									      ch->ch_out ? "out" : "in",
 									      iio_chan_type_string[ch->ch_type],
 									      ch->channel,
 									      attr->name);
 							else
-								i += snprintf(buff + i, no_os_max(n - i, 0),
-									      "filename=\"%s_%s_%s\"",
+								iio_xml_print(xml, "filename=\"%s_%s_%s\"",
 									      ch->ch_out ? "out" : "in",
 									      iio_chan_type_string[ch->ch_type],
 									      attr->name);
 							break;
 						}
 					}
-					i += snprintf(buff + i, no_os_max(n - i, 0), " />");
+					iio_xml_print(xml, " />");
 				}
 
-			i += snprintf(buff + i, no_os_max(n - i, 0), "</channel>");
+			iio_xml_print(xml, "</channel>");
 		}
 
 	/* Write device attributes */
 	if (device->attributes)
 		for (j = 0; device->attributes[j].name; j++)
-			i += snprintf(buff + i, no_os_max(n - i, 0),
-				      "<attribute name=\"%s\" />",
+			iio_xml_print(xml, "<attribute name=\"%s\" />",
 				      device->attributes[j].name);
 
 	/* Write debug attributes */
 	if (device->debug_attributes)
 		for (j = 0; device->debug_attributes[j].name; j++)
-			i += snprintf(buff + i, no_os_max(n - i, 0),
-				      "<debug-attribute name=\"%s\" />",
+			iio_xml_print(xml, "<debug-attribute name=\"%s\" />",
 				      device->debug_attributes[j].name);
-	if (device->debug_reg_read || device->debug_reg_write)
-		i += snprintf(buff + i, no_os_max(n - i, 0),
-			      "<debug-attribute name=\""REG_ACCESS_ATTRIBUTE"\" />");
+	if (device->debug_reg_read || device->debug_reg_write) {
+		iio_xml_print(xml, "<debug-attribute name=\""REG_ACCESS_ATTRIBUTE"\" />");
+		iio_xml_print(xml, "<debug-attribute name=\""
+			      REG_BULK_ATTRIBUTE "\" />");
+	}
+#ifdef NO_OS_TRACE
+	if (flags & IIO_XML_TRACE)
+		iio_xml_print(xml, "<debug-attribute name=\""
+			      TRACE_ATTRIBUTE "\" />");
+#endif
+#ifdef IIO_STATS
+	if (flags & IIO_XML_STATS)
+		iio_xml_print(xml, "<debug-attribute name=\""
+			      STATS_ATTRIBUTE "\" />");
+#endif
+#ifdef NO_OS_IRQ_POLICY
+	if (flags & IIO_XML_IRQ_LATENCY)
+		iio_xml_print(xml, "<debug-attribute name=\""
+			      IRQ_LATENCY_ATTRIBUTE "\" />");
+#endif
+#ifdef NO_OS_ALLOC_STATS
+	if (flags & IIO_XML_ALLOC_STATS)
+		iio_xml_print(xml, "<debug-attribute name=\""
+			      ALLOC_STATS_ATTRIBUTE "\" />");
+#endif
 
 	/* Write buffer attributes */
 	if (device->buffer_attributes)
 		for (j = 0; device->buffer_attributes[j].name; j++)
-			i += snprintf(buff + i, no_os_max(n - i, 0),
-				      "<buffer-attribute name=\"%s\" />",
+			iio_xml_print(xml, "<buffer-attribute name=\"%s\" />",
 				      device->buffer_attributes[j].name);
-
-	i += snprintf(buff + i, no_os_max(n - i, 0), "</device>");
-
-	return i;
+	if (flags & IIO_XML_DECIM)
+		iio_xml_print(xml, "<buffer-attribute name=\""
+			      IIO_DECIM_MODE_ATTR "\" /><buffer-attribute "
+			      "name=\"" IIO_DECIM_MODES_ATTR "\" />"
+			      "<buffer-attribute name=\""
+			      IIO_DECIM_FACTOR_ATTR "\" />");
+	if (flags & IIO_XML_CONV)
+		iio_xml_print(xml, "<buffer-attribute name=\""
+			      IIO_CONV_ATTR "\" /><buffer-attribute "
+			      "name=\"" IIO_CONV_FORMATS_ATTR "\" />");
+
+	iio_xml_print(xml, "</device>");
+
+	return xml->ret;
 }
 
-static int32_t iio_init_xml(struct iio_desc *desc)
+/**
+ * @brief Generate a section of the context xml.
+ * Sections are the header, the context attributes, each device, each trigger
+ * and the end of the context, in this order.
+ * @param desc - IIO descriptor.
+ * @param sect - Section index.
+ * @param xml - Xml window.
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int32_t iio_xml_section(struct iio_desc *desc, uint32_t sect,
+			       struct iio_xml_buf *xml)
 {
+	struct iio_device dummy = { 0 };
 	struct iio_dev_priv *dev;
 	struct iio_trig_priv *trig;
-	struct iio_device dummy = { 0 };
-	uint32_t i, size, of;
+	uint32_t flags;
 
-	/* -2 because of the 0 character */
-	size = sizeof(header) + sizeof(header_end) - 2;
-	size += iio_add_cntx_attr_in_xml(desc, NULL, -1);
-	for (i = 0; i < desc->nb_devs; i++) {
-		dev = desc->devs + i;
-		size += iio_generate_device_xml(dev->dev_descriptor,
-						(char *)dev->name,
-						dev->dev_id, NULL, -1);
+	if (sect == 0) {
+		iio_xml_write(xml, header, sizeof(header) - 1);
+		return 0;
 	}
-	for (i = 0; i < desc->nb_trigs; i++) {
-		trig = desc->trigs + i;
-		dummy.attributes = trig->descriptor->attributes;
-		size += iio_generate_device_xml(&dummy, trig->name, trig->id,
-						NULL, -1);
+	if (sect == 1) {
+		iio_add_cntx_attr_in_xml(desc, xml);
+		return xml->ret;
 	}
 
-	desc->xml_desc = (char *)calloc(size + 1, sizeof(*desc->xml_desc));
-	if (!desc->xml_desc)
-		return -ENOMEM;
+	sect -= 2;
+	if (sect < desc->nb_devs) {
+		dev = desc->devs + sect;
+		flags = IIO_XML_TRACE | IIO_XML_STATS | IIO_XML_IRQ_LATENCY |
+			IIO_XML_ALLOC_STATS;
+		if (desc->buffer_decimation && dev->buffer.initalized)
+			flags |= IIO_XML_DECIM;
+		if (desc->buffer_conversion && dev->buffer.initalized)
+			flags |= IIO_XML_CONV;
+		return iio_generate_device_xml(dev->dev_descriptor,
+					       (char *)dev->name, dev->dev_id,
+					       flags, xml);
+	}
 
-	desc->xml_size = size;
+	sect -= desc->nb_devs;
+	if (sect < desc->nb_trigs) {
+		trig = desc->trigs + sect;
+		dummy.attributes = trig->attributes;
+		return iio_generate_device_xml(&dummy, trig->name, trig->id,
+					       0, xml);
+	}
 
-	strcpy(desc->xml_desc, header);
-	of = sizeof(header) - 1;
-	of += iio_add_cntx_attr_in_xml(desc, desc->xml_desc + of, size - of);
-	for (i = 0; i < desc->nb_devs; i++) {
-		dev = desc->devs + i;
-		of += iio_generate_device_xml(dev->dev_descriptor,
-					      (char *)dev->name, dev->dev_id,
-					      desc->xml_desc + of, size - of);
+	iio_xml_write(xml, header_end, sizeof(header_end) - 1);
+
+	return 0;
+}
+
+/**
+ * @brief Compute the context xml size and generate it if not streamed.
+ * @param desc - IIO descriptor.
+ * @param stream - If true, only the offsets of the xml sections are kept and
+ * the xml is generated on request by iio_read_xml.
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int32_t iio_init_xml(struct iio_desc *desc, bool stream)
+{
+	struct iio_xml_buf xml = { 0 };
+	uint32_t i, nb = IIO_XML_NB_SECTIONS(desc);
+	int32_t ret;
+
+	if (stream) {
+		desc->xml_sections = (uint32_t *)no_os_calloc(nb + 1,
+							sizeof(*desc->xml_sections));
+		if (!desc->xml_sections)
+			return -ENOMEM;
 	}
-	for (i = 0; i < desc->nb_trigs; i++) {
-		trig = desc->trigs + i;
-		dummy.attributes = trig->descriptor->attributes;
-		of += iio_generate_device_xml(&dummy, trig->name, trig->id,
-					      desc->xml_desc + of, size - of);
+
+	/* Only count */
+	for (i = 0; i < nb; i++) {
+		if (stream)
+			desc->xml_sections[i] = xml.pos;
+		ret = iio_xml_section(desc, i, &xml);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			goto free_sections;
+	}
+	desc->xml_size = xml.pos;
+	if (stream) {
+		desc->xml_sections[nb] = xml.pos;
+		return 0;
 	}
 
-	strcpy(desc->xml_desc + of, header_end);
+	desc->xml_desc = (char *)no_os_calloc(desc->xml_size + 1,
+					sizeof(*desc->xml_desc));
+	if (!desc->xml_desc)
+		return -ENOMEM;
+
+	xml.buf = desc->xml_desc;
+	xml.len = desc->xml_size;
+	xml.pos = 0;
+	for (i = 0; i < nb; i++)
+		iio_xml_section(desc, i, &xml);
 
 	return 0;
+
+free_sections:
+	no_os_free(desc->xml_sections);
+	desc->xml_sections = NULL;
+
+	return ret;
+}
+
+/**
+ * @brief Generate a part of the context xml.
+ * Used when the xml is streamed instead of being stored in RAM. Only the
+ * sections overlapping the requested part are generated.
+ * @param ctx - IIO instance and conn instance.
+ * @param offset - Offset in the xml of the first byte to be generated.
+ * @param buf - Buffer where the xml is written.
+ * @param len - Maximum number of bytes to be written.
+ * @return Number of bytes written or negative value in case of error.
+ */
+static int iio_read_xml(struct iiod_ctx *ctx, uint32_t offset, char *buf,
+			uint32_t len)
+{
+	struct iio_desc *desc = ctx->instance;
+	struct iio_xml_buf xml = {
+		.buf = buf,
+		.offset = offset
+	};
+	uint32_t i, nb = IIO_XML_NB_SECTIONS(desc);
+	int32_t ret;
+
+	if (offset >= desc->xml_size)
+		return 0;
+
+	xml.len = no_os_min(len, desc->xml_size - offset);
+	for (i = 0; i < nb && desc->xml_sections[i] < offset + xml.len; i++) {
+		if (desc->xml_sections[i + 1] <= offset)
+			continue;
+
+		xml.pos = desc->xml_sections[i];
+		ret = iio_xml_section(desc, i, &xml);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	return xml.len;
 }
 
 /**
@@ -1741,8 +6533,8 @@ static int32_t iio_init_contxt_attrs(struct iio_desc *desc,
 	struct iio_cntx_attr_init *cntx_attr_init_iter;
 
 	desc->nb_cntx_attr = n;
-	desc->cntx_attributes = (struct iio_cntx_attr_priv *)calloc(desc->nb_cntx_attr,
-				sizeof(*desc->cntx_attributes));
+	desc->cntx_attributes = no_os_calloc(desc->nb_cntx_attr,
+					     sizeof(*desc->cntx_attributes));
 	if (!desc->cntx_attributes)
 		return -ENOMEM;
 
@@ -1763,7 +6555,7 @@ static int32_t iio_init_devs(struct iio_desc *desc,
 	struct iio_device_init *ndev;
 
 	desc->nb_devs = n;
-	desc->devs = (struct iio_dev_priv *)calloc(desc->nb_devs,
+	desc->devs = (struct iio_dev_priv *)no_os_calloc(desc->nb_devs,
 			sizeof(*desc->devs));
 	if (!desc->devs)
 		return -ENOMEM;
@@ -1778,6 +6570,12 @@ static int32_t iio_init_devs(struct iio_desc *desc,
 		ldev->dev_data.dev = ndev->dev;
 		ldev->dev_data.buffer = &ldev->buffer.public;
 		ldev->name = ndev->name;
+		if (ndev->probe) {
+			ldev->probe = ndev->probe;
+			ldev->probe_ctx = ndev->probe_ctx;
+			ldev->probe_ret = -EAGAIN;
+			desc->nb_probing++;
+		}
 		if (ndev->dev_descriptor->read_dev ||
 		    ndev->dev_descriptor->write_dev ||
 		    ndev->dev_descriptor->submit ||
@@ -1785,6 +6583,7 @@ static int32_t iio_init_devs(struct iio_desc *desc,
 			ldev->buffer.raw_buf = ndev->raw_buf;
 			ldev->buffer.raw_buf_len = ndev->raw_buf_len;
 			ldev->buffer.public.buf = &ldev->buffer.cb;
+			ldev->buffer.public.nb_blocks = 1;
 			ldev->buffer.initalized = 1;
 		} else {
 			ldev->buffer.initalized = 0;
@@ -1794,6 +6593,98 @@ static int32_t iio_init_devs(struct iio_desc *desc,
 	return 0;
 }
 
+/**
+ * @brief Show the number of dropped events of an asynchronous trigger.
+ * @param device - Trigger instance.
+ * @param buf - Buffer where the value is written.
+ * @param len - Size of buf.
+ * @param channel - Channel info, NULL for triggers.
+ * @param priv - Private trigger structure.
+ * @return Number of bytes written in buf.
+ */
+static int iio_trig_overruns_show(void *device, char *buf, uint32_t len,
+				  const struct iio_ch_info *channel,
+				  intptr_t priv)
+{
+	struct iio_trig_priv *trig = (struct iio_trig_priv *)priv;
+
+	return snprintf(buf, len, "%"PRIu32"", trig->overruns);
+}
+
+/**
+ * @brief Reset the number of dropped events of an asynchronous trigger.
+ * @param device - Trigger instance.
+ * @param buf - Value to be written, ignored.
+ * @param len - Length of buf.
+ * @param channel - Channel info, NULL for triggers.
+ * @param priv - Private trigger structure.
+ * @return len.
+ */
+static int iio_trig_overruns_store(void *device, char *buf, uint32_t len,
+				   const struct iio_ch_info *channel,
+				   intptr_t priv)
+{
+	struct iio_trig_priv *trig = (struct iio_trig_priv *)priv;
+
+	trig->overruns = 0;
+
+	return len;
+}
+
+/**
+ * @brief Set the attributes of a trigger. Asynchronous triggers get the
+ * overruns attribute after the ones of their descriptor.
+ * @param trig - Private trigger structure.
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int32_t iio_init_trig_attrs(struct iio_trig_priv *trig)
+{
+	struct iio_attribute *attributes;
+	uint32_t n;
+
+	if (trig->descriptor->is_synchronous) {
+		trig->attributes = trig->descriptor->attributes;
+		return 0;
+	}
+
+	n = iio_count_attributes(trig->descriptor->attributes);
+	attributes = no_os_calloc(n + 2, sizeof(*attributes));
+	if (!attributes)
+		return -ENOMEM;
+
+	if (n)
+		memcpy(attributes, trig->descriptor->attributes,
+		       n * sizeof(*attributes));
+	attributes[n].name = IIO_TRIG_OVERRUNS_ATTR;
+	attributes[n].priv = (intptr_t)trig;
+	attributes[n].show = iio_trig_overruns_show;
+	attributes[n].store = iio_trig_overruns_store;
+	trig->attributes = attributes;
+
+	return 0;
+}
+
+/**
+ * @brief Free the triggers and their attributes.
+ * @param desc - IIO descriptor.
+ */
+static void iio_remove_trigs(struct iio_desc *desc)
+{
+	uint32_t i;
+
+	if (!desc->trigs)
+		return;
+
+	/* Only the attributes of asynchronous triggers are allocated */
+	for (i = 0; i < desc->nb_trigs; i++)
+		if (desc->trigs[i].descriptor &&
+		    !desc->trigs[i].descriptor->is_synchronous)
+			no_os_free((void *)desc->trigs[i].attributes);
+
+	no_os_free(desc->trigs);
+	desc->trigs = NULL;
+}
+
 /**
  * @brief Initializes IIO triggers.
  * @param desc  - IIO descriptor.
@@ -1805,11 +6696,12 @@ static int32_t iio_init_trigs(struct iio_desc *desc,
 			      struct iio_trigger_init *trigs, uint32_t n)
 {
 	uint32_t i;
+	int32_t ret;
 	struct iio_trig_priv *trig_priv_iter;
 	struct iio_trigger_init *trig_init_iter;
 
 	desc->nb_trigs = n;
-	desc->trigs = (struct iio_trig_priv *)calloc(desc->nb_trigs,
+	desc->trigs = (struct iio_trig_priv *)no_os_calloc(desc->nb_trigs,
 			sizeof(*desc->trigs));
 	if (!desc->trigs)
 		return -ENOMEM;
@@ -1821,6 +6713,36 @@ static int32_t iio_init_trigs(struct iio_desc *desc,
 		trig_priv_iter->name = trig_init_iter->name;
 		trig_priv_iter->descriptor = trig_init_iter->descriptor;
 		sprintf(trig_priv_iter->id, "trigger%"PRIu32"", i);
+		ret = iio_init_trig_attrs(trig_priv_iter);
+		if (ret) {
+			iio_remove_trigs(desc);
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Bind the devices to the triggers set at initialization.
+ * @param desc - IIO descriptor.
+ * @return 0 in case of success or negative value otherwise.
+ */
+static int32_t iio_init_trig_devs(struct iio_desc *desc)
+{
+	uint32_t i;
+
+	if (!desc->nb_trigs || !desc->nb_devs)
+		return 0;
+
+	desc->trig_devs = no_os_calloc(desc->nb_trigs * desc->nb_devs,
+				       sizeof(*desc->trig_devs));
+	if (!desc->trig_devs)
+		return -ENOMEM;
+
+	for (i = 0; i < desc->nb_trigs; i++) {
+		desc->trigs[i].devs = desc->trig_devs + i * desc->nb_devs;
+		iio_update_trig_devs(desc, i);
 	}
 
 	return 0;
@@ -1840,14 +6762,22 @@ int iio_init(struct iio_desc **desc, struct iio_init_param *init_param)
 	struct iiod_ops		*ops;
 	struct iiod_init_param	iiod_param;
 	uint32_t		conn_id;
+	uint32_t		i;
+#ifdef NO_OS_NETWORKING
+	struct network_interface	*net;
+#endif
 
 	if (!desc || !init_param)
 		return -EINVAL;
 
-	ldesc = (struct iio_desc *)calloc(1, sizeof(*ldesc));
+	ldesc = (struct iio_desc *)no_os_calloc(1, sizeof(*ldesc));
 	if (!ldesc)
 		return -ENOMEM;
 
+	ldesc->buffer_compression = init_param->buffer_compression;
+	ldesc->buffer_decimation = init_param->buffer_decimation;
+	ldesc->buffer_conversion = init_param->buffer_conversion;
+
 	if (init_param->cntx_attrs && init_param->cntx_attrs->descriptor) {
 		ret = iio_init_contxt_attrs(ldesc, init_param->cntx_attrs,
 					    init_param->nb_cntx_attrs);
@@ -1863,39 +6793,79 @@ int iio_init(struct iio_desc **desc, struct iio_init_param *init_param)
 	if (NO_OS_IS_ERR_VALUE(ret))
 		goto free_desc;
 
-	ret = iio_init_xml(ldesc);
+	ret = iio_init_trig_devs(ldesc);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		goto free_trigs;
+
+	ret = iio_init_events(ldesc);
 	if (NO_OS_IS_ERR_VALUE(ret))
 		goto free_trigs;
 
+	if (init_param->xml) {
+		ldesc->xml_size = init_param->xml_len;
+	} else {
+		ret = iio_init_xml(ldesc, init_param->xml_stream);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			goto free_trigs;
+	}
+
+	ret = iio_init_lookup(ldesc);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		goto free_xml;
+
 	/* device operations */
 	ops = &ldesc->iiod_ops;
 	ops->read_attr = iio_read_attr;
 	ops->write_attr = iio_write_attr;
+	ops->read_attr_idx = iio_read_attr_idx;
+	ops->write_attr_idx = iio_write_attr_idx;
 	// Allow set trigger and get trigger operations only if trigger exists in application
 	if (init_param->nb_trigs && init_param->trigs) {
 		ops->get_trigger = iio_get_trigger;
 		ops->set_trigger = iio_set_trigger;
+		ops->get_trigger_idx = iio_get_trigger_idx;
+		ops->set_trigger_idx = iio_set_trigger_idx;
 	}
 	ops->read_buffer = iio_read_buffer;
+	ops->read_buffer_block = iio_read_buffer_block;
+	ops->read_buffer_block_done = iio_read_buffer_block_done;
 	ops->write_buffer = iio_write_buffer;
 	ops->refill_buffer = iio_refill_buffer;
 	ops->push_buffer = iio_push_buffer;
+	ops->set_buffers_count = iio_set_buffers_count;
+	ops->get_buffer_info = iio_get_buffer_info;
+	ops->open_evstream = iio_open_evstream;
+	ops->read_event = iio_read_event;
 	ops->open = iio_open_dev;
 	ops->close = iio_close_dev;
 	ops->send = iio_send;
 	ops->recv = iio_recv;
+#ifdef NO_OS_NETWORKING
+	if (init_param->phy_type == USE_NETWORK ||
+	    init_param->phy_type == USE_NETWORK_UDP)
+		ops->sendv = iio_sendv;
+#endif
+	if (ldesc->xml_sections)
+		ops->read_xml = iio_read_xml;
 
 	iiod_param.instance = ldesc;
 	iiod_param.ops = ops;
-	iiod_param.xml = ldesc->xml_desc;
+	if (init_param->xml)
+		iiod_param.xml = (char *)init_param->xml;
+	else
+		iiod_param.xml = ldesc->xml_desc;
 	iiod_param.xml_len = ldesc->xml_size;
+	iiod_param.step_quota = init_param->step_quota;
+	iiod_param.max_connections = init_param->max_connections ?
+				     init_param->max_connections :
+				     IIOD_MAX_CONNECTIONS;
 
 	ret = iiod_init(&ldesc->iiod, &iiod_param);
 	if (NO_OS_IS_ERR_VALUE(ret))
-		goto free_xml;
+		goto free_lookup;
 
-	ret = no_os_cb_init(&ldesc->conns,
-			    sizeof(uint32_t) * (IIOD_MAX_CONNECTIONS + 1));
+	ret = no_os_cb_init(&ldesc->conns, sizeof(uint32_t) *
+			    (iiod_param.max_connections + 1));
 	if (NO_OS_IS_ERR_VALUE(ret))
 		goto free_iiod;
 
@@ -1907,7 +6877,8 @@ int iio_init(struct iio_desc **desc, struct iio_init_param *init_param)
 		struct iiod_conn_data data = {
 			.conn = ldesc->uart_desc,
 			.buf = uart_buff,
-			.len = sizeof(uart_buff)
+			.len = sizeof(uart_buff),
+			.weight = 1
 		};
 		ret = iiod_conn_add(ldesc->iiod, &data, &conn_id);
 		if (NO_OS_IS_ERR_VALUE(ret))
@@ -1915,7 +6886,8 @@ int iio_init(struct iio_desc **desc, struct iio_init_param *init_param)
 		_push_conn(ldesc, conn_id);
 	}
 #ifdef NO_OS_NETWORKING
-	else if (init_param->phy_type == USE_NETWORK) {
+	else if (init_param->phy_type == USE_NETWORK ||
+		 init_param->phy_type == USE_NETWORK_UDP) {
 		ldesc->send = (int (*)())socket_send;
 		ldesc->recv = (int (*)())socket_recv;
 		ret = socket_init(&ldesc->server,
@@ -1928,6 +6900,26 @@ int iio_init(struct iio_desc **desc, struct iio_init_param *init_param)
 		ret = socket_listen(ldesc->server, MAX_BACKLOG);
 		if (NO_OS_IS_ERR_VALUE(ret))
 			goto free_pylink;
+		if (init_param->phy_type == USE_NETWORK_UDP) {
+			net = init_param->tcp_socket_init_param->net;
+			ret = iio_udp_init(ldesc, net);
+			if (NO_OS_IS_ERR_VALUE(ret))
+				goto free_pylink;
+		}
+	}
+#endif
+#ifdef IIO_USB
+	else if (init_param->phy_type == USE_USB) {
+		ldesc->usb_desc = init_param->usb_desc;
+		if (!ldesc->usb_desc ||
+		    ldesc->usb_desc->nb_pipes > iiod_param.max_connections) {
+			ret = -EINVAL;
+			goto free_conns;
+		}
+		ldesc->send = iio_usb_send;
+		ldesc->recv = iio_usb_recv;
+		for (i = 0; i < ldesc->usb_desc->nb_pipes; i++)
+			ldesc->usb_conns[i].pipe = &ldesc->usb_desc->pipes[i];
 	}
 #endif
 	else {
@@ -1947,14 +6939,20 @@ free_conns:
 	no_os_cb_remove(ldesc->conns);
 free_iiod:
 	iiod_remove(ldesc->iiod);
+free_lookup:
+	no_os_free(ldesc->lookup);
 free_xml:
-	free(ldesc->xml_desc);
+	no_os_free(ldesc->xml_sections);
+	no_os_free(ldesc->xml_desc);
 free_trigs:
-	free(ldesc->trigs);
+	no_os_free(ldesc->trig_devs);
+	iio_remove_trigs(ldesc);
 free_devs:
-	free(ldesc->devs);
+	for (i = 0; i < ldesc->nb_devs; i++)
+		no_os_free(ldesc->devs[i].ev_history);
+	no_os_free(ldesc->devs);
 free_desc:
-	free(ldesc);
+	no_os_free(ldesc);
 
 	return ret;
 }
@@ -1966,17 +6964,45 @@ free_desc:
  */
 int iio_remove(struct iio_desc *desc)
 {
+	uint32_t i;
+
 	if (!desc)
 		return -EINVAL;
 
 #ifdef NO_OS_NETWORKING
+	iio_udp_remove(desc);
 	socket_remove(desc->server);
+#endif
+#ifdef IIO_USB
+	iio_usb_remove(desc);
+#endif
+#ifdef IIO_RECORDER
+	iio_recorder_remove(desc);
+#endif
+#ifdef NO_OS_SCHED
+	if (desc->step_work.added)
+		no_os_sched_work_remove(&desc->step_work);
+#endif
+#ifdef IIO_FREERTOS
+	if (desc->rtos)
+		iio_rtos_free(desc->rtos);
 #endif
 	no_os_cb_remove(desc->conns);
 	iiod_remove(desc->iiod);
-	free(desc->devs);
-	free(desc->xml_desc);
-	free(desc);
+	no_os_free(desc->trig_devs);
+	iio_remove_trigs(desc);
+	for (i = 0; i < desc->nb_devs; i++) {
+		no_os_free(desc->devs[i].comp_buf);
+		no_os_free(desc->devs[i].decim);
+		no_os_free(desc->devs[i].conv);
+		no_os_free(desc->devs[i].reg_bulk);
+		no_os_free(desc->devs[i].ev_history);
+	}
+	no_os_free(desc->devs);
+	no_os_free(desc->lookup);
+	no_os_free(desc->xml_sections);
+	no_os_free(desc->xml_desc);
+	no_os_free(desc);
 
 	return 0;
 }
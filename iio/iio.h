@@ -50,6 +50,9 @@
 #ifdef NO_OS_NETWORKING
 #include "tcp_socket.h"
 #endif
+#ifdef IIO_USB
+#include "no_os_usb.h"
+#endif
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -58,7 +61,20 @@
 enum pysical_link_type {
 	USE_UART,
 #ifdef NO_OS_NETWORKING
-	USE_NETWORK
+	USE_NETWORK,
+	/*
+	 * As USE_NETWORK, with the buffer data of input devices also streamed
+	 * over UDP, to the clients that ask for it. The buffer is still opened
+	 * and closed over TCP. See IIOD_UDP_PORT in iio.c for the protocol.
+	 */
+	USE_NETWORK_UDP,
+#endif
+#ifdef IIO_USB
+	/*
+	 * Pipes of a USB device, as opened by the libiio USB backend. Each
+	 * pipe is a connection.
+	 */
+	USE_USB,
 #endif
 };
 
@@ -67,7 +83,7 @@ struct iio_desc;
 struct iio_device_init {
 	char *name;
 	void *dev;
-	struct iio_device *dev_descriptor;
+	const struct iio_device *dev_descriptor;
 	/*
 	 * IIO buffer implementation can use a user provided buffer in raw_buf.
 	 * If raw_buf is NULL and iio_device has buffer callback function set,
@@ -78,12 +94,21 @@ struct iio_device_init {
 	uint32_t raw_buf_len;
 	/* If set, trigger will be linked to this device */
 	char *trigger_id;
+	/*
+	 * If set, dev is created by probe(probe_ctx, &dev) after iio_init so
+	 * slow devices don't delay the server. probe is called by iio_step
+	 * and on the first access to the device until it returns 0, -EAGAIN
+	 * meaning that it must be called again. Until then the attributes
+	 * of the device read as "initializing".
+	 */
+	int32_t (*probe)(void *ctx, void **dev);
+	void *probe_ctx;
 };
 
 struct iio_trigger_init {
 	char *name;
 	void *trig;
-	struct iio_trigger *descriptor;
+	const struct iio_trigger *descriptor;
 };
 
 struct iio_cntx_attr_init {
@@ -96,6 +121,9 @@ struct iio_init_param {
 		struct no_os_uart_desc *uart_desc;
 #ifdef NO_OS_NETWORKING
 		struct tcp_socket_init_param *tcp_socket_init_param;
+#endif
+#ifdef IIO_USB
+		struct no_os_usb_desc *usb_desc;
 #endif
 	};
 	struct iio_cntx_attr_init *cntx_attrs;
@@ -104,8 +132,72 @@ struct iio_init_param {
 	uint32_t nb_devs;
 	struct iio_trigger_init *trigs;
 	uint32_t nb_trigs;
+	/*
+	 * Optional context xml generated at build time (e.g. placed in flash).
+	 * If set, it is used as it is instead of being generated in RAM. It
+	 * must describe exactly the devs and trigs above, in the same order.
+	 */
+	const char *xml;
+	/* Length of xml, without the '\0' terminator */
+	uint32_t xml_len;
+	/*
+	 * If set, the context xml is not stored in RAM. It is generated chunk by
+	 * chunk, only while being sent to a client.
+	 */
+	bool xml_stream;
+	/*
+	 * Maximum number of buffer bytes a connection transfers in one
+	 * iio_step, so a streaming client can't delay the others for long.
+	 * 0 means no limit.
+	 */
+	uint32_t step_quota;
+	/*
+	 * Maximum number of clients connected at the same time, only used with
+	 * the network. 0 for IIOD_MAX_CONNECTIONS.
+	 */
+	uint32_t max_connections;
+	/*
+	 * If set, the context advertises the "buffer_compression" attribute and
+	 * a client can get the READBUF data of a device compressed by writing
+	 * "delta" to its "compression" buffer attribute.
+	 */
+	bool buffer_compression;
+	/*
+	 * If set, devices get the decimation_mode and decimation_factor buffer
+	 * attributes, selecting how the scans pushed with iio_buffer_push_scan
+	 * are reduced before being stored in the buffer.
+	 */
+	bool buffer_decimation;
+	/*
+	 * If set, devices get the output_format buffer attribute, selecting
+	 * the format the READBUF samples are converted to: raw, s32, s16, q31
+	 * or f32.
+	 */
+	bool buffer_conversion;
 };
 
+#ifdef IIO_FREERTOS
+/**
+ * @struct iio_rtos_param
+ * @brief Parameters of the FreeRTOS server tasks.
+ */
+struct iio_rtos_param {
+	/**
+	 * Priority of the command task. The transmit task runs at priority + 1
+	 * and the worker task at priority + 2.
+	 */
+	uint32_t priority;
+	/** Stack depth of each task, in words */
+	uint32_t stack_words;
+	/** Bytes of responses queued to the transmit task */
+	uint32_t tx_buffer_size;
+	/** Entries of the transmit and job queues */
+	uint32_t nb_jobs;
+	/** Period at which the command task polls idle connections */
+	uint32_t poll_ms;
+};
+#endif
+
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
 /******************************************************************************/
@@ -117,12 +209,50 @@ int iio_init(struct iio_desc **desc, struct iio_init_param *init_param);
 int iio_remove(struct iio_desc *desc);
 /* Execut an iio step. */
 int iio_step(struct iio_desc *desc);
+/* Sleep until a client is ready, when iio_step has nothing else to do. */
+int iio_wait(struct iio_desc *desc, uint32_t timeout_ms);
+#ifdef NO_OS_SCHED
+/* Run iio_step from the no_os_sched loop, polling idle connections. */
+int iio_sched_start(struct iio_desc *desc, uint32_t poll_ms);
+/* Poll every idle_poll_ms after idle_ms without command, to sleep deeper. */
+int iio_sched_set_idle(struct iio_desc *desc, uint32_t idle_ms,
+		       uint32_t idle_poll_ms);
+/* Poll again at the iio_sched_start period, from any context. */
+void iio_sched_wake(struct iio_desc *desc);
+#endif
+#ifdef IIO_FREERTOS
+/* Serve the clients from FreeRTOS command, transmit and worker tasks. */
+int iio_rtos_start(struct iio_desc *desc, const struct iio_rtos_param *param);
+/* Run fn in the worker task, from any context. */
+int iio_rtos_defer(struct iio_desc *desc, void (*fn)(void *ctx), void *ctx);
+/* Wake up the command task, from any context. */
+void iio_rtos_kick(struct iio_desc *desc);
+#endif
 /* Signal iio that a trigger has been triggered.
  * This will be called in interrupt context. An application callback will be
    called in interrupt context if trigger is synchronous with the interrupt
    (is_synchronous = true) or will be called from iio_step if trigger is
    asynchronous (is_synchronous = false) */
 int iio_process_trigger_type(struct iio_desc *desc, char *trigger_name);
+/* Get the handle of a trigger, resolving its name once. */
+int iio_get_trigger_handle(struct iio_desc *desc, const char *trigger_name,
+			   uint32_t *handle);
+/* Same as iio_process_trigger_type, in constant time, for a trigger handle. */
+int iio_process_trigger(struct iio_desc *desc, uint32_t handle);
+/* Set the number of events an asynchronous trigger coalesces. */
+int iio_set_trigger_batch(struct iio_desc *desc, uint32_t handle,
+			  uint32_t nb_events);
+
+/* Allocate an event queue of depth events, for iio_device.events. */
+int iio_event_queue_init(struct iio_event_queue **queue, uint32_t depth);
+/* Free the resources allocated by iio_event_queue_init(). */
+void iio_event_queue_remove(struct iio_event_queue *queue);
+/* Post an event of a device, from a single context, without blocking. */
+int iio_push_event(struct iio_event_queue *queue, uint64_t id,
+		   int64_t timestamp);
+
+/* Drop the cached attribute values of a device, NULL for all devices. */
+void iio_attr_cache_invalidate(struct iio_desc *desc, void *dev_instance);
 
 int32_t iio_parse_value(char *buf, enum iio_val fmt,
 			int32_t *val, int32_t *val2);
@@ -135,10 +265,38 @@ int iio_buffer_get_block(struct iio_buffer *buffer, void **addr);
 /* To be called to mark last iio_buffer_read as done */
 int iio_buffer_block_done(struct iio_buffer *buffer);
 
+#ifdef IIO_RECORDER
+/* Start capturing the buffer of device to the file at path, from iio_step. */
+int iio_recorder_start(struct iio_desc *desc, const char *device,
+		       uint32_t mask, uint32_t samples, const char *path);
+/* Stop the capture of device and close its file. */
+int iio_recorder_stop(struct iio_desc *desc, const char *device);
+#endif
+
 /* Trigger buffer functions. */
 /* Write to buffer iio_buffer.bytes_per_scan bytes from data */
 int iio_buffer_push_scan(struct iio_buffer *buffer, void *data);
+/* Write timestamp in the timestamp channel of data, then push it */
+int iio_buffer_push_scan_ts(struct iio_buffer *buffer, void *data,
+			    int64_t timestamp);
 /* Read from buffer iio_buffer.bytes_per_scan bytes into data */
 int iio_buffer_pop_scan(struct iio_buffer *buffer, void *data);
+/* Count an underrun reported by the DMA of an output buffer */
+void iio_buffer_underrun(struct iio_buffer *buffer);
+
+/* Scan layout helpers. samples holds a sample of sample_size bytes for each
+ * channel of the device, by channel index. */
+/* Pack the samples of the active channels into a scan */
+void iio_buffer_pack_scan(struct iio_buffer *buffer, void *scan,
+			  const void *samples, uint32_t sample_size);
+/* Unpack a scan into the samples of the active channels */
+void iio_buffer_unpack_scan(struct iio_buffer *buffer, const void *scan,
+			    void *samples, uint32_t sample_size);
+/* Pack the samples of the active channels and write the scan to buffer */
+int iio_buffer_push_samples(struct iio_buffer *buffer, const void *samples,
+			    uint32_t sample_size);
+/* Split nb_scans scans of 16 bit samples in an array per active channel */
+int iio_buffer_deinterleave16(struct iio_buffer *buffer, const void *scans,
+			      uint32_t nb_scans, int16_t **ch_data);
 
 #endif /* IIO_H_ */
@@ -80,6 +80,9 @@
 #ifdef ADUCM3029_PLATFORM
 #include "wifi.h"
 #endif
+#ifdef NO_OS_LWIP_NETWORKING
+#include "lwip_socket.h"
+#endif
 #include "tcp_socket.h"
 #endif
 
@@ -93,6 +96,15 @@
 #include "no_os_error.h"
 #endif
 
+#ifdef NO_OS_SCHED
+#include "no_os_sched.h"
+#endif
+
+#ifdef IIO_FREERTOS
+#include "FreeRTOS.h"
+#include "task.h"
+#endif
+
 #ifdef ADUCM_PLATFORM
 #define UART_OPS &aducm_uart_ops
 #elif LINUX_PLATFORM
@@ -112,6 +124,46 @@
 // The default baudrate iio_app will use to print messages to console.
 #define UART_BAUDRATE_DEFAULT	115200
 
+#ifdef NO_OS_SCHED
+// Polling period of an idle client, short enough for the UART buffer.
+#ifndef IIO_APP_SCHED_POLL_MS
+#define IIO_APP_SCHED_POLL_MS	1
+#endif
+// Polling period once no client command came for IIO_APP_SCHED_IDLE_MS, long
+// enough for deep sleep. 0 keeps polling every IIO_APP_SCHED_POLL_MS.
+#ifndef IIO_APP_SCHED_IDLE_POLL_MS
+#define IIO_APP_SCHED_IDLE_POLL_MS	0
+#endif
+#ifndef IIO_APP_SCHED_IDLE_MS
+#define IIO_APP_SCHED_IDLE_MS	10000
+#endif
+#endif
+
+#ifdef LINUX_PLATFORM
+// Longest sleep on the sockets between two steps while no client is active.
+#ifndef IIO_APP_IDLE_WAIT_MS
+#define IIO_APP_IDLE_WAIT_MS	10
+#endif
+#endif
+
+#ifdef IIO_FREERTOS
+#ifndef IIO_APP_RTOS_PRIORITY
+#define IIO_APP_RTOS_PRIORITY	(tskIDLE_PRIORITY + 1)
+#endif
+#ifndef IIO_APP_RTOS_STACK_WORDS
+#define IIO_APP_RTOS_STACK_WORDS	1024
+#endif
+#ifndef IIO_APP_RTOS_TX_BUFFER_SIZE
+#define IIO_APP_RTOS_TX_BUFFER_SIZE	4096
+#endif
+#ifndef IIO_APP_RTOS_NB_JOBS
+#define IIO_APP_RTOS_NB_JOBS	16
+#endif
+#ifndef IIO_APP_RTOS_POLL_MS
+#define IIO_APP_RTOS_POLL_MS	1
+#endif
+#endif
+
 static inline uint32_t _calc_uart_xfer_time(uint32_t len, uint32_t baudrate)
 {
 	uint32_t ms = 1000ul * len * 8 / UART_BAUDRATE_DEFAULT;
@@ -224,9 +276,29 @@ static int32_t network_setup(struct iio_init_param *iio_init_param,
 
 	wifi_get_network_interface(wifi, &socket_param.net);
 #endif
+#ifdef NO_OS_LWIP_NETWORKING
+	int32_t ret;
+	static struct lwip_network_desc *lwip;
+	/* The netif is brought up by the project, polled through these */
+	struct lwip_network_init_param lwip_param = {
+		.poll = IIO_APP_LWIP_POLL,
+		.poll_ctx = IIO_APP_LWIP_POLL_CTX
+	};
+
+	ret = lwip_network_init(&lwip, &lwip_param);
+	if (ret)
+		return ret;
+
+	lwip_network_get_network_interface(lwip, &socket_param.net);
+#endif
 
 	socket_param.max_buff_size = 0;
+#ifdef IIO_APP_UDP_STREAM
+	/* Buffer data can also be streamed over UDP, see USE_NETWORK_UDP */
+	iio_init_param->phy_type = USE_NETWORK_UDP;
+#else
 	iio_init_param->phy_type = USE_NETWORK;
+#endif
 	iio_init_param->tcp_socket_init_param = &socket_param;
 
 	return 0;
@@ -338,7 +410,7 @@ int32_t iio_app_run_with_trigs(struct iio_app_device *devices, uint32_t nb_devs,
 			       void *irq_desc, struct iio_desc **iio_desc)
 {
 	int32_t			status;
-	struct iio_init_param	iio_init_param;
+	struct iio_init_param	iio_init_param = {0};
 	struct no_os_uart_desc	*uart_desc;
 	struct no_os_uart_init_param	*uart_init_par;
 	struct iio_device_init	*iio_init_devs;
@@ -397,6 +469,8 @@ int32_t iio_app_run_with_trigs(struct iio_app_device *devices, uint32_t nb_devs,
 		iio_init_devs[i].name = devices[i].name;
 		iio_init_devs[i].dev = devices[i].dev;
 		iio_init_devs[i].dev_descriptor = devices[i].dev_descriptor;
+		iio_init_devs[i].probe = devices[i].probe;
+		iio_init_devs[i].probe_ctx = devices[i].probe_ctx;
 		buff = devices[i].read_buff ? devices[i].read_buff :
 		       devices[i].write_buff;
 		if (buff) {
@@ -419,9 +493,44 @@ int32_t iio_app_run_with_trigs(struct iio_app_device *devices, uint32_t nb_devs,
 
 	free(iio_init_devs);
 
+#ifdef IIO_FREERTOS
+	struct iio_rtos_param rtos_param = {
+		.priority = IIO_APP_RTOS_PRIORITY,
+		.stack_words = IIO_APP_RTOS_STACK_WORDS,
+		.tx_buffer_size = IIO_APP_RTOS_TX_BUFFER_SIZE,
+		.nb_jobs = IIO_APP_RTOS_NB_JOBS,
+		.poll_ms = IIO_APP_RTOS_POLL_MS,
+	};
+
+	status = iio_rtos_start(*iio_desc, &rtos_param);
+	if (status)
+		goto error;
+
+	/* The application may already run from a task */
+	if (xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED)
+		vTaskStartScheduler();
+	else
+		vTaskSuspend(NULL);
+#elif defined(NO_OS_SCHED)
+	status = iio_sched_start(*iio_desc, IIO_APP_SCHED_POLL_MS);
+	if (status)
+		goto error;
+
+	status = iio_sched_set_idle(*iio_desc, IIO_APP_SCHED_IDLE_MS,
+				    IIO_APP_SCHED_IDLE_POLL_MS);
+	if (status)
+		goto error;
+
+	no_os_sched_run();
+#else
 	do {
 		status = iio_step(*iio_desc);
+#ifdef LINUX_PLATFORM
+		/* Sleep on the sockets instead of spinning while idle */
+		iio_wait(*iio_desc, IIO_APP_IDLE_WAIT_MS);
+#endif
 	} while (true);
+#endif
 error:
 	status = print_uart_error_message(&uart_desc, uart_init_par, status);
 	return status;
@@ -51,6 +51,20 @@
 	.write_buff = _write_buff\
 }
 
+/*
+ * Device created by _probe(_probe_ctx, &dev) once the server is running,
+ * see probe in iio_device_init.
+ */
+#define IIO_APP_LAZY_DEVICE(_name, _probe, _probe_ctx, _dev_descriptor, \
+			    _read_buff, _write_buff) {\
+	.name = _name,\
+	.dev_descriptor = _dev_descriptor,\
+	.read_buff = _read_buff,\
+	.write_buff = _write_buff,\
+	.probe = _probe,\
+	.probe_ctx = _probe_ctx\
+}
+
 #define IIO_APP_TRIGGER(_name, _trig, _trig_descriptor) {\
 	.name = _name,\
 	.trig = _trig,\
@@ -65,9 +79,12 @@ struct iio_data_buffer {
 struct iio_app_device {
 	char *name;
 	void *dev;
-	struct iio_device *dev_descriptor;
+	const struct iio_device *dev_descriptor;
 	struct iio_data_buffer *read_buff;
 	struct iio_data_buffer *write_buff;
+	/* If set, dev is created by probe after the server started */
+	int32_t (*probe)(void *ctx, void **dev);
+	void *probe_ctx;
 };
 
 /**
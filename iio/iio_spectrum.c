@@ -0,0 +1,347 @@
+/***************************************************************************//**
+ *   @file   iio_spectrum.c
+ *   @brief  IIO device streaming averaged spectra of captured blocks.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "no_os_error.h"
+#include "no_os_alloc.h"
+#include "no_os_util.h"
+#include "iio.h"
+#include "iio_spectrum.h"
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+static const char * const iio_spectrum_windows[] = {
+	[NO_OS_FFT_WINDOW_RECT] = "rect",
+	[NO_OS_FFT_WINDOW_HANN] = "hann",
+	[NO_OS_FFT_WINDOW_HAMMING] = "hamming",
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Allocate a spectrum device.
+ * @param desc - Where to store the device.
+ * @param param - The parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t iio_spectrum_init(struct iio_spectrum_desc **desc,
+			  struct iio_spectrum_init_param *param)
+{
+	struct iio_spectrum_desc *d;
+	int32_t ret;
+
+	if (!desc || !param ||
+	    param->window >= NO_OS_ARRAY_SIZE(iio_spectrum_windows))
+		return -EINVAL;
+
+	d = no_os_calloc(1, sizeof(*d));
+	if (!d)
+		return -ENOMEM;
+
+	ret = no_os_fft_init(&d->fft, param->fft_size, param->window,
+			     param->averages);
+	if (ret)
+		goto error;
+
+	d->bins = no_os_calloc(param->fft_size / 2, sizeof(*d->bins));
+	if (!d->bins) {
+		ret = -ENOMEM;
+		goto error_fft;
+	}
+
+	*desc = d;
+
+	return 0;
+
+error_fft:
+	no_os_fft_remove(d->fft);
+error:
+	no_os_free(d);
+
+	return ret;
+}
+
+/**
+ * @brief Free a spectrum device.
+ * @param desc - The device.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t iio_spectrum_remove(struct iio_spectrum_desc *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	no_os_free(desc->bins);
+	no_os_fft_remove(desc->fft);
+	no_os_free(desc);
+
+	return 0;
+}
+
+/**
+ * @brief Publish the average once complete, replacing a spectrum the clients
+ * didn't read in time.
+ * @param desc - The device.
+ * @param ret - Result of adding the block to the average.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t iio_spectrum_publish(struct iio_spectrum_desc *desc,
+				    int32_t ret)
+{
+	if (ret <= 0)
+		return ret;
+
+	if (desc->ready)
+		desc->dropped++;
+
+	ret = no_os_fft_get_magnitude(desc->fft, desc->bins);
+	if (ret)
+		return ret;
+
+	desc->ready = true;
+
+	return 0;
+}
+
+/**
+ * @brief Add a captured block of fft_size samples to the average. Called
+ * from the loop running iio_step(), not from an interrupt.
+ * @param desc - The device.
+ * @param samples - The block.
+ * @param stride - Distance between two samples, the number of channels of
+ * an interleaved capture.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t iio_spectrum_push_block(struct iio_spectrum_desc *desc,
+				const int16_t *samples, uint32_t stride)
+{
+	if (!desc)
+		return -EINVAL;
+
+	return iio_spectrum_publish(desc, no_os_fft_add_block(desc->fft,
+				    samples, stride));
+}
+
+/**
+ * @brief Add a captured block of samples wider than 16 bits, see
+ * no_os_fft_add_block_s32().
+ * @param desc - The device.
+ * @param samples - The block.
+ * @param stride - Distance between two samples.
+ * @param shift - Right shift bringing the samples to 16 bits.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t iio_spectrum_push_block_s32(struct iio_spectrum_desc *desc,
+				    const int32_t *samples, uint32_t stride,
+				    uint8_t shift)
+{
+	if (!desc)
+		return -EINVAL;
+
+	return iio_spectrum_publish(desc, no_os_fft_add_block_s32(desc->fft,
+				    samples, stride, shift));
+}
+
+/**
+ * @brief Start a buffer: the average restarts with the next block.
+ * @param dev - The device.
+ * @param mask - Active channels.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t iio_spectrum_pre_enable(void *dev, uint32_t mask)
+{
+	struct iio_spectrum_desc *desc = dev;
+
+	desc->ready = false;
+	desc->dropped = 0;
+
+	return no_os_fft_reset(desc->fft, desc->fft->nb_avg);
+}
+
+/**
+ * @brief Give the last spectrum to the clients, once it is ready. The
+ * buffer must be opened with fft_size / 2 samples.
+ * @param dev_data - The device data.
+ * @return 0 in case of success, -EAGAIN if no spectrum is ready yet,
+ * negative error code otherwise.
+ */
+static int32_t iio_spectrum_submit(struct iio_device_data *dev_data)
+{
+	struct iio_spectrum_desc *desc = dev_data->dev;
+	struct iio_buffer *buffer = dev_data->buffer;
+	uint32_t size = desc->fft->size / 2 * sizeof(*desc->bins);
+	void *block;
+	int ret;
+
+	if (buffer->size != size)
+		return -EINVAL;
+
+	if (!desc->ready)
+		return -EAGAIN;
+
+	ret = iio_buffer_get_block(buffer, &block);
+	if (ret)
+		return ret;
+
+	memcpy(block, desc->bins, size);
+	desc->ready = false;
+
+	return iio_buffer_block_done(buffer);
+}
+
+/**
+ * @brief Show a parameter of the spectrum.
+ * @param device - The device.
+ * @param buf - Where to write the value.
+ * @param len - Size of buf.
+ * @param channel - Unused.
+ * @param priv - Index of the attribute.
+ * @return length of the value, negative error code otherwise.
+ */
+static int iio_spectrum_attr_show(void *device, char *buf, uint32_t len,
+				  const struct iio_ch_info *channel,
+				  intptr_t priv)
+{
+	struct iio_spectrum_desc *desc = device;
+	int32_t val;
+
+	switch (priv) {
+	case 0:
+		val = desc->fft->size;
+		break;
+	case 1:
+		val = desc->fft->nb_avg;
+		break;
+	case 2:
+		return snprintf(buf, len, "%s",
+				iio_spectrum_windows[desc->fft->window]);
+	case 3:
+		val = desc->dropped;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return iio_format_value(buf, len, IIO_VAL_INT, 1, &val);
+}
+
+/**
+ * @brief Set the number of blocks of an average, restarting it.
+ * @param device - The device.
+ * @param buf - The value.
+ * @param len - Length of the value.
+ * @param channel - Unused.
+ * @param priv - Unused.
+ * @return len in case of success, negative error code otherwise.
+ */
+static int iio_spectrum_averages_store(void *device, char *buf, uint32_t len,
+				       const struct iio_ch_info *channel,
+				       intptr_t priv)
+{
+	struct iio_spectrum_desc *desc = device;
+	int32_t val, ret;
+
+	ret = iio_parse_value(buf, IIO_VAL_INT, &val, NULL);
+	if (ret < 0 || val < 1)
+		return -EINVAL;
+
+	ret = no_os_fft_reset(desc->fft, val);
+	if (ret)
+		return ret;
+
+	return len;
+}
+
+static struct iio_attribute iio_spectrum_attrs[] = {
+	{
+		.name = "fft_size",
+		.priv = 0,
+		.show = iio_spectrum_attr_show,
+	},
+	{
+		.name = "averages",
+		.priv = 1,
+		.show = iio_spectrum_attr_show,
+		.store = iio_spectrum_averages_store,
+	},
+	{
+		.name = "window",
+		.priv = 2,
+		.show = iio_spectrum_attr_show,
+	},
+	{
+		.name = "dropped_spectra",
+		.priv = 3,
+		.show = iio_spectrum_attr_show,
+	},
+	END_ATTRIBUTES_ARRAY
+};
+
+static struct scan_type iio_spectrum_scan_type = {
+	.sign = 'u',
+	.realbits = 16,
+	.storagebits = 16,
+};
+
+static struct iio_channel iio_spectrum_channels[] = {
+	{
+		.name = "magnitude",
+		.ch_type = IIO_VOLTAGE,
+		.channel = 0,
+		.scan_index = 0,
+		.scan_type = &iio_spectrum_scan_type,
+		.indexed = true,
+	},
+};
+
+struct iio_device iio_spectrum_descriptor = {
+	.num_ch = NO_OS_ARRAY_SIZE(iio_spectrum_channels),
+	.channels = iio_spectrum_channels,
+	.attributes = iio_spectrum_attrs,
+	.pre_enable = iio_spectrum_pre_enable,
+	.submit = iio_spectrum_submit,
+};
@@ -0,0 +1,106 @@
+/***************************************************************************//**
+ *   @file   iio_spectrum.h
+ *   @brief  IIO device streaming averaged spectra of captured blocks.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef _IIO_SPECTRUM_H_
+#define _IIO_SPECTRUM_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "iio_types.h"
+#include "no_os_fft.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct iio_spectrum_desc
+ * @brief Spectrum of the blocks captured by another device. The application
+ * gives each captured block to iio_spectrum_push_block(), and each average
+ * of the configured number of blocks is read by the clients as one IIO
+ * block of fft_size / 2 magnitude samples, from DC up.
+ */
+struct iio_spectrum_desc {
+	struct no_os_fft *fft;
+	/** Last averaged spectrum */
+	uint16_t *bins;
+	/** Set when bins holds a spectrum not read yet */
+	bool ready;
+	/** Spectra replaced by a newer one before being read */
+	uint32_t dropped;
+};
+
+/**
+ * @struct iio_spectrum_init_param
+ * @brief Parameters of the spectrum.
+ */
+struct iio_spectrum_init_param {
+	/** Points of the FFT, a power of 2 */
+	uint32_t fft_size;
+	/** Number of blocks of an average */
+	uint32_t averages;
+	enum no_os_fft_window window;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Allocate a spectrum device. */
+int32_t iio_spectrum_init(struct iio_spectrum_desc **desc,
+			  struct iio_spectrum_init_param *param);
+
+/* Free a spectrum device. */
+int32_t iio_spectrum_remove(struct iio_spectrum_desc *desc);
+
+/* Add a captured block of 16 bit samples. */
+int32_t iio_spectrum_push_block(struct iio_spectrum_desc *desc,
+				const int16_t *samples, uint32_t stride);
+
+/* Add a captured block of samples wider than 16 bits. */
+int32_t iio_spectrum_push_block_s32(struct iio_spectrum_desc *desc,
+				    const int32_t *samples, uint32_t stride,
+				    uint8_t shift);
+
+extern struct iio_device iio_spectrum_descriptor;
+
+#endif // _IIO_SPECTRUM_H_
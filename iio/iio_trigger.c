@@ -40,6 +40,8 @@
 /******************************************************************************/
 /***************************** Include Files **********************************/
 /******************************************************************************/
+#include <inttypes.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include "no_os_error.h"
@@ -114,11 +116,22 @@ error:
 */
 int iio_trig_enable(void *trig)
 {
+	int ret;
+
 	if(!trig)
 		return -EINVAL;
 
 	struct iio_hw_trig *desc = trig;
 
+	/* Resolve the trigger outside the interrupt, iio_desc is set by now */
+	if (!desc->has_handle) {
+		ret = iio_get_trigger_handle(*desc->iio_desc, desc->name,
+					     &desc->handle);
+		if (ret)
+			return ret;
+		desc->has_handle = true;
+	}
+
 	return no_os_irq_enable(desc->irq_ctrl, desc->irq_id);
 }
 
@@ -152,7 +165,10 @@ void iio_hw_trig_handler(void *trig)
 
 	struct iio_hw_trig *desc = trig;
 
-	iio_process_trigger_type(*desc->iio_desc, desc->name);
+	if (desc->has_handle)
+		iio_process_trigger(*desc->iio_desc, desc->handle);
+	else
+		iio_process_trigger_type(*desc->iio_desc, desc->name);
 }
 
 /**
@@ -169,6 +185,277 @@ int iio_hw_trig_remove(struct iio_hw_trig *trig)
 
 	return 0;
 }
+
+/**
+ * @brief Timer trigger interrupt handler, called every timer period.
+ *
+ * @param trig - Timer trigger structure which is linked to this handler.
+*/
+static void iio_timer_trig_handler(void *trig)
+{
+	struct iio_timer_trig *desc = trig;
+
+	if (!desc || !desc->has_handle)
+		return;
+
+	iio_process_trigger(*desc->iio_desc, desc->handle);
+}
+
+/**
+ * @brief Set the timer period for a trigger frequency.
+ *
+ * @param desc - Timer trigger structure.
+ * @param freq - Trigger frequency in Hz.
+ *
+ * @return ret - Result of the timer configuration.
+*/
+static int iio_timer_trig_set_freq(struct iio_timer_trig *desc, uint32_t freq)
+{
+	uint64_t clk;
+	int ret;
+
+	if (!freq)
+		return -EINVAL;
+
+	/* The timer interrupts every ticks_count ticks of its clock */
+	clk = (uint64_t)freq * desc->timer->ticks_count;
+	if (clk > UINT32_MAX)
+		return -EINVAL;
+
+	ret = no_os_timer_count_clk_set(desc->timer, clk);
+	if (ret)
+		return ret;
+
+	desc->sampling_frequency = freq;
+
+	return 0;
+}
+
+/**
+ * @brief Initialize a timer trigger. The timer is started when the trigger is
+ * enabled, by a buffer using it.
+ *
+ * @param iio_trig   - The iio timer trigger structure.
+ * @param init_param - The structure that contains the trigger initial params.
+ *
+ * @return ret       - Result of the initialization procedure.
+*/
+int iio_timer_trig_init(struct iio_timer_trig **iio_trig,
+			struct iio_timer_trig_init_param *init_param)
+{
+	struct iio_timer_trig *trig_desc;
+	int ret;
+
+	if (!init_param->iio_desc || !init_param->name || !init_param->timer ||
+	    !init_param->timer->ticks_count)
+		return -EINVAL;
+
+	trig_desc = (struct iio_timer_trig *)calloc(1, sizeof(*trig_desc));
+	if (!trig_desc)
+		return -ENOMEM;
+
+	trig_desc->iio_desc = init_param->iio_desc;
+	strncpy(trig_desc->name, init_param->name, TRIG_MAX_NAME_SIZE);
+	trig_desc->timer = init_param->timer;
+	trig_desc->irq_ctrl = init_param->irq_ctrl;
+	trig_desc->irq_id = init_param->irq_id;
+	trig_desc->batch = init_param->batch;
+	trig_desc->sampling_frequency = trig_desc->timer->freq_hz /
+					trig_desc->timer->ticks_count;
+
+	if (init_param->sampling_frequency) {
+		ret = iio_timer_trig_set_freq(trig_desc,
+					      init_param->sampling_frequency);
+		if (ret)
+			goto error;
+	}
+
+	trig_desc->irq_cb.callback = iio_timer_trig_handler;
+	trig_desc->irq_cb.ctx = trig_desc;
+	trig_desc->irq_cb.event = init_param->cb_info.event;
+	trig_desc->irq_cb.handle = init_param->cb_info.handle;
+	trig_desc->irq_cb.peripheral = init_param->cb_info.peripheral;
+
+	ret = no_os_irq_register_callback(trig_desc->irq_ctrl,
+					  trig_desc->irq_id,
+					  &trig_desc->irq_cb);
+	if (ret)
+		goto error;
+
+	*iio_trig = trig_desc;
+
+	return 0;
+error:
+	free(trig_desc);
+	return ret;
+}
+
+/**
+ * @brief Start the timer of a timer trigger.
+ *
+ * @param trig - Timer trigger structure.
+ *
+ * @return ret - Result of the enable procedure.
+*/
+static int iio_timer_trig_enable(void *trig)
+{
+	struct iio_timer_trig *desc = trig;
+	int ret;
+
+	if (!desc)
+		return -EINVAL;
+
+	if (!desc->has_handle) {
+		ret = iio_get_trigger_handle(*desc->iio_desc, desc->name,
+					     &desc->handle);
+		if (ret)
+			return ret;
+		desc->has_handle = true;
+	}
+
+	ret = iio_set_trigger_batch(*desc->iio_desc, desc->handle, desc->batch);
+	if (ret)
+		return ret;
+
+	ret = no_os_irq_enable(desc->irq_ctrl, desc->irq_id);
+	if (ret)
+		return ret;
+
+	return no_os_timer_start(desc->timer);
+}
+
+/**
+ * @brief Stop the timer of a timer trigger.
+ *
+ * @param trig - Timer trigger structure.
+ *
+ * @return ret - Result of the disable procedure.
+*/
+static int iio_timer_trig_disable(void *trig)
+{
+	struct iio_timer_trig *desc = trig;
+	int ret;
+
+	if (!desc)
+		return -EINVAL;
+
+	ret = no_os_timer_stop(desc->timer);
+	if (ret)
+		return ret;
+
+	return no_os_irq_disable(desc->irq_ctrl, desc->irq_id);
+}
+
+/**
+ * @brief Handles the read request for the sampling_frequency and batch
+ * attributes.
+ *
+ * @param trig    - The iio timer trigger structure.
+ * @param buf     - Command buffer to be filled with the data to be read.
+ * @param len     - Length of the command buffer in bytes.
+ * @param channel - Command channel info (is NULL).
+ * @param priv    - Command attribute id.
+ *
+ * @return ret    - Number of bytes written in buf.
+*/
+static int iio_timer_trig_attr_show(void *trig, char *buf, uint32_t len,
+				    const struct iio_ch_info *channel,
+				    intptr_t priv)
+{
+	struct iio_timer_trig *desc = trig;
+
+	if (!desc)
+		return -EINVAL;
+
+	return snprintf(buf, len, "%"PRIu32"", priv ? desc->batch :
+			desc->sampling_frequency);
+}
+
+/**
+ * @brief Handles the write request for the sampling_frequency and batch
+ * attributes.
+ *
+ * @param trig    - The iio timer trigger structure.
+ * @param buf     - Command buffer with the value to be written.
+ * @param len     - Length of the received command buffer in bytes.
+ * @param channel - Command channel info (is NULL).
+ * @param priv    - Command attribute id.
+ *
+ * @return ret    - Result of the write procedure.
+*/
+static int iio_timer_trig_attr_store(void *trig, char *buf, uint32_t len,
+				     const struct iio_ch_info *channel,
+				     intptr_t priv)
+{
+	struct iio_timer_trig *desc = trig;
+	uint32_t val;
+	int ret;
+
+	if (!desc)
+		return -EINVAL;
+
+	val = strtoul(buf, NULL, 0);
+	if (!priv) {
+		ret = iio_timer_trig_set_freq(desc, val);
+		return ret ? ret : (int)len;
+	}
+
+	if (desc->has_handle) {
+		ret = iio_set_trigger_batch(*desc->iio_desc, desc->handle, val);
+		if (ret)
+			return ret;
+	}
+	desc->batch = val;
+
+	return len;
+}
+
+static struct iio_attribute iio_timer_trig_attrs[] = {
+	{
+		.name = "sampling_frequency",
+		.priv = 0,
+		.show = iio_timer_trig_attr_show,
+		.store = iio_timer_trig_attr_store,
+	},
+	{
+		.name = "batch",
+		.priv = 1,
+		.show = iio_timer_trig_attr_show,
+		.store = iio_timer_trig_attr_store,
+	},
+	END_ATTRIBUTES_ARRAY
+};
+
+/**
+ * @brief Trigger descriptor of the timer triggers, events are served from
+ * iio_step.
+ */
+struct iio_trigger iio_timer_trig_desc = {
+	.is_synchronous = false,
+	.attributes = iio_timer_trig_attrs,
+	.enable = iio_timer_trig_enable,
+	.disable = iio_timer_trig_disable,
+};
+
+/**
+ * @brief Free the resources allocated by iio_timer_trig_init().
+ *
+ * @param trig - The timer trigger structure.
+ *
+ * @return ret - Result of the remove procedure.
+*/
+int iio_timer_trig_remove(struct iio_timer_trig *trig)
+{
+	if (!trig)
+		return -EINVAL;
+
+	no_os_timer_stop(trig->timer);
+	no_os_irq_unregister_callback(trig->irq_ctrl, trig->irq_id,
+				      &trig->irq_cb);
+	free(trig);
+
+	return 0;
+}
 #endif
 
 /**
@@ -46,6 +46,7 @@
 #include "iio.h"
 #include "iio_types.h"
 #include "no_os_irq.h"
+#include "no_os_timer.h"
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -70,6 +71,10 @@ struct iio_hw_trig {
 	enum no_os_irq_trig_level irq_trig_lvl;
 	/** Device trigger name */
 	char name[TRIG_MAX_NAME_SIZE + 1];
+	/** Trigger handle, resolved from name when it is enabled */
+	uint32_t handle;
+	/** Set once handle is resolved */
+	bool has_handle;
 };
 
 /**
@@ -104,6 +109,56 @@ struct iio_hw_trig_init_param {
 	const char *name;
 };
 
+/**
+ * @struct iio_timer_trig
+ * @brief IIO periodic trigger, raised by the interrupt of a timer
+ */
+struct iio_timer_trig {
+	/** IIO descriptor */
+	struct iio_desc **iio_desc;
+	/** Timer, counting ticks_count ticks per period */
+	struct no_os_timer_desc *timer;
+	/** Interrupt descriptor of the timer */
+	struct no_os_irq_ctrl_desc *irq_ctrl;
+	/** Interrupt id of the timer */
+	uint32_t irq_id;
+	/** Timer callback, kept to be unregistered */
+	struct no_os_callback_desc irq_cb;
+	/** Device trigger name */
+	char name[TRIG_MAX_NAME_SIZE + 1];
+	/** Trigger handle, resolved from name when it is enabled */
+	uint32_t handle;
+	/** Set once handle is resolved */
+	bool has_handle;
+	/** Trigger frequency in Hz */
+	uint32_t sampling_frequency;
+	/** Timer periods coalesced in one trigger_handler_batch call */
+	uint32_t batch;
+};
+
+/**
+ * @struct iio_timer_trig_init_param
+ * @brief IIO timer trigger initialization structure
+ */
+struct iio_timer_trig_init_param {
+	/** IIO descriptor */
+	struct iio_desc **iio_desc;
+	/** Initialized timer */
+	struct no_os_timer_desc *timer;
+	/** Interrupt descriptor of the timer */
+	struct no_os_irq_ctrl_desc *irq_ctrl;
+	/** Interrupt id of the timer */
+	uint32_t irq_id;
+	/** Timer interrupt callback information */
+	struct iio_hw_trig_cb_info cb_info;
+	/** Device trigger name */
+	const char *name;
+	/** Trigger frequency in Hz, 0 to keep the timer period */
+	uint32_t sampling_frequency;
+	/** Timer periods coalesced in one handler call, 0 or 1 for none */
+	uint32_t batch;
+};
+
 /**
  * @struct iio_sw_trig
  * @brief IIO software trigger structure
@@ -138,6 +193,14 @@ int iio_trig_disable(void *trig);
 void iio_hw_trig_handler(void *trig);
 /** API to remove a hardware trigger */
 int iio_hw_trig_remove(struct iio_hw_trig *trig);
+
+/** API to initialize a timer trigger */
+int iio_timer_trig_init(struct iio_timer_trig **iio_trig,
+			struct iio_timer_trig_init_param *init_param);
+/** API to remove a timer trigger */
+int iio_timer_trig_remove(struct iio_timer_trig *trig);
+/** Trigger descriptor of the timer triggers */
+extern struct iio_trigger iio_timer_trig_desc;
 #endif
 
 /** API to initialize a software trigger */
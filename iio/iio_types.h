@@ -46,6 +46,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include "no_os_circular_buffer.h"
+#include "no_os_lffifo.h"
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -79,7 +80,8 @@ enum iio_chan_type {
 	IIO_MAGN,
 	IIO_INCLI,
 	IIO_VELOCITY,
-	IIO_ANGL
+	IIO_ANGL,
+	IIO_TIMESTAMP
 };
 
 /**
@@ -94,6 +96,69 @@ enum iio_modifier {
 	IIO_MOD_TEMP_AMBIENT
 };
 
+/**
+ * @enum iio_event_type
+ * @brief Kind of an IIO event, same values as in Linux
+ */
+enum iio_event_type {
+	IIO_EV_TYPE_THRESH,
+	IIO_EV_TYPE_MAG,
+	IIO_EV_TYPE_ROC,
+	IIO_EV_TYPE_THRESH_ADAPTIVE,
+	IIO_EV_TYPE_MAG_ADAPTIVE,
+	IIO_EV_TYPE_CHANGE,
+};
+
+/**
+ * @enum iio_event_direction
+ * @brief Direction of an IIO event, same values as in Linux
+ */
+enum iio_event_direction {
+	IIO_EV_DIR_EITHER,
+	IIO_EV_DIR_RISING,
+	IIO_EV_DIR_FALLING,
+	IIO_EV_DIR_NONE,
+};
+
+/* 64 bit identifier of an event, in the Linux IIO format */
+#define IIO_EVENT_CODE(chan_type, diff, modifier, direction, type, chan, \
+		       chan1, chan2) \
+	(((uint64_t)(type) << 56) | ((uint64_t)(diff) << 55) | \
+	 ((uint64_t)(direction) << 48) | ((uint64_t)(modifier) << 40) | \
+	 ((uint64_t)(chan_type) << 32) | (((uint16_t)(chan2)) << 16) | \
+	 ((uint16_t)(chan1)))
+
+/* Event of the channel chan of an axis of a device, e.g. IIO_MOD_X */
+#define IIO_MOD_EVENT_CODE(chan_type, chan, modifier, type, direction) \
+	IIO_EVENT_CODE(chan_type, 0, modifier, direction, type, chan, 0, 0)
+
+/* Event of the channel chan, without modifier */
+#define IIO_UNMOD_EVENT_CODE(chan_type, chan, type, direction) \
+	IIO_EVENT_CODE(chan_type, 0, 0, direction, type, chan, 0, 0)
+
+/**
+ * @struct iio_event
+ * @brief Event posted by a driver with iio_push_event
+ */
+struct iio_event {
+	/** Identifier, built with IIO_EVENT_CODE */
+	uint64_t id;
+	/** Time of the event in nanoseconds, 0 if unknown */
+	int64_t timestamp;
+};
+
+/**
+ * @struct iio_event_queue
+ * @brief Events of a device waiting to be delivered to the clients. Created
+ * with iio_event_queue_init and set in iio_device.events.
+ */
+struct iio_event_queue {
+	/** Single producer, single consumer queue of struct iio_event */
+	struct no_os_lffifo *fifo;
+	/** Events dropped because the queue was full */
+	uint32_t lost;
+};
+
 /**
  * @struct iio_ch_info
  * @brief Structure holding channel attributess.
@@ -113,6 +178,9 @@ struct iio_ch_info {
 
 #define END_ATTRIBUTES_ARRAY {.name = NULL}
 
+/* iio_attribute.cache_ms keeping the value until the device is written */
+#define IIO_ATTR_CACHE_UNTIL_WRITE	UINT32_MAX
+
 enum iio_attribute_shared {
 	IIO_SEPARATE,
 	IIO_SHARED_BY_TYPE,
@@ -151,6 +219,13 @@ struct iio_attribute {
 	/** Store function pointer */
 	int (*store)(void *device, char *buf, uint32_t len,
 		     const struct iio_ch_info *channel, intptr_t priv);
+	/**
+	 * Milliseconds a value returned by show is reused for the following
+	 * reads, when built with IIO_ATTR_CACHE, or IIO_ATTR_CACHE_UNTIL_WRITE.
+	 * Any write to the device drops its cached values. 0 to always call
+	 * show, for values that change on their own.
+	 */
+	uint32_t cache_ms;
 };
 
 /**
@@ -190,9 +265,9 @@ struct iio_channel {
 	/** Index to give ordering in scans when read  from a buffer. */
 	int			scan_index;
 	/** */
-	struct scan_type	*scan_type;
+	const struct scan_type	*scan_type;
 	/** Array of attributes. Last one should have its name set to NULL */
-	struct iio_attribute	*attributes;
+	const struct iio_attribute	*attributes;
 	/** if true, the channel is an output channel */
 	bool			ch_out;
 	/** Set if channel has a modifier. Use channel2 property to
@@ -205,11 +280,53 @@ struct iio_channel {
 	bool			diferential;
 };
 
+/* Scan type of the channels declared with IIO_CHAN_SOFT_TIMESTAMP */
+extern const struct scan_type iio_timestamp_scan_type;
+
+/*
+ * Channel holding the time of each scan, filled from the timestamp given to
+ * iio_buffer_push_scan_ts. Must have the highest scan index of the device.
+ */
+#define IIO_CHAN_SOFT_TIMESTAMP(_si) {		\
+	.ch_type = IIO_TIMESTAMP,		\
+	.channel = -1,				\
+	.scan_index = _si,			\
+	.scan_type = &iio_timestamp_scan_type,	\
+}
+
 enum iio_buffer_direction {
 	IIO_DIRECTION_INPUT,
 	IIO_DIRECTION_OUTPUT
 };
 
+/* Channels of a scan, one bit per channel of the active mask */
+#define IIO_MAX_SCAN_CH		32
+
+/**
+ * @struct iio_scan_layout
+ * @brief Position of the active channels in a scan, computed when the buffer
+ * is opened
+ */
+struct iio_scan_layout {
+	/* Number of active channels */
+	uint32_t nb_ch;
+	/* Index of each active channel, in scan order */
+	uint8_t ch[IIO_MAX_SCAN_CH];
+	/* Storage bytes of each active channel */
+	uint8_t bytes[IIO_MAX_SCAN_CH];
+	/* Offset in the scan of each active channel */
+	uint16_t offset[IIO_MAX_SCAN_CH];
+	/* Storage bytes of all active channels if the same, 0 otherwise */
+	uint8_t uniform_bytes;
+	/* Set if the active channels are the first nb_ch channels */
+	bool contiguous;
+	/* Position in ch of the active IIO_TIMESTAMP channel, -1 if none */
+	int32_t timestamp;
+};
+
+/* Decimation stage between iio_buffer_push_scan and the buffer */
+struct iio_decimator;
+
 struct iio_cyclic_buffer_info {
 	bool is_cyclic;
 	uint32_t buff_index;
@@ -220,6 +337,8 @@ struct iio_buffer {
 	uint32_t active_mask;
 	/* Size in bytes */
 	uint32_t size;
+	/* Number of blocks of size bytes that can be stored in buf */
+	uint32_t nb_blocks;
 	/* Number of bytes per sample * number of active channels */
 	uint32_t bytes_per_scan;
 	/* Buffer direction */
@@ -228,6 +347,12 @@ struct iio_buffer {
 	struct no_os_circular_buffer *buf;
 	/* Stores cyclic buffer specific information */
 	struct iio_cyclic_buffer_info cyclic_info;
+	/* Layout of the scans for active_mask */
+	struct iio_scan_layout layout;
+	/* Set while the pushed scans are decimated before being stored */
+	struct iio_decimator *decim;
+	/* Scans missing when the device needed them, see iio_buffer_underrun */
+	uint32_t underruns;
 };
 
 struct iio_device_data {
@@ -240,7 +365,7 @@ struct iio_trigger {
 	 *  If false the handler will be called from iio_step */
 	bool is_synchronous;
 	/** Array of attributes. Last one should have its name set to NULL */
-	struct iio_attribute *attributes;
+	const struct iio_attribute *attributes;
 	/** Called when needs to be enabled */
 	int (*enable)(void *trig);
 	/** Called when needs to be disabled */
@@ -250,6 +375,9 @@ struct iio_trigger {
 /**
  * @struct iio_device
  * @brief Structure holding channels and attributes of a device.
+ * Only read by the IIO core, so it can be declared const together with its
+ * channels and attributes, and be kept in flash. The state of each instance is
+ * kept by the core.
  */
 struct iio_device {
 	/** Structure for existing initialized irq controllers. Has to be
@@ -258,13 +386,21 @@ struct iio_device {
 	/** Device number of channels */
 	uint16_t num_ch;
 	/** List of channels */
-	struct iio_channel *channels;
+	const struct iio_channel *channels;
 	/** Array of attributes. Last one should have its name set to NULL */
-	struct iio_attribute *attributes;
+	const struct iio_attribute *attributes;
 	/** Array of attributes. Last one should have its name set to NULL */
-	struct iio_attribute *debug_attributes;
+	const struct iio_attribute *debug_attributes;
 	/** Array of attributes. Last one should have its name set to NULL */
-	struct iio_attribute *buffer_attributes;
+	const struct iio_attribute *buffer_attributes;
+	/**
+	 * Use a lock-free single producer single consumer buffer, so that
+	 * iio_buffer_push_scan() can be called from interrupt context while
+	 * the data is sent. The buffer size (samples * bytes per scan *
+	 * nb_blocks) must be a power of 2, and scans that don't fit are
+	 * dropped instead of overwriting the oldest ones.
+	 */
+	bool lock_free_buffer;
 	/* Numbers of bytes will be:
 	 * samples * (storage_size_of_first_active_ch / 8) * nb_active_channels
 	 * DEPRECATED.
@@ -285,12 +421,32 @@ struct iio_device {
 	int32_t	(*submit)(struct iio_device_data *dev);
 	/** Called after a trigger signal has been received by iio */
 	int32_t (*trigger_handler)(struct iio_device_data *dev);
+	/**
+	 * Optional. Called instead of trigger_handler for the events of an
+	 * asynchronous trigger pending at an iio_step, to acquire nb_scans
+	 * scans in one call.
+	 */
+	int32_t (*trigger_handler_batch)(struct iio_device_data *dev,
+					 uint32_t nb_scans);
 
 	/* Read device register */
 	int32_t (*debug_reg_read)(void *dev, uint32_t reg, uint32_t *readval);
 	/* Write device register */
 	int32_t (*debug_reg_write)(void *dev, uint32_t reg, uint32_t writeval);
+	/**
+	 * Optional. Read nb_regs consecutive registers starting with reg, for
+	 * the direct_reg_bulk dumps. Drivers implement it with burst reads
+	 * where the part supports them, debug_reg_read is called for each
+	 * register otherwise.
+	 */
+	int32_t (*debug_reg_read_bulk)(void *dev, uint32_t reg,
+				       uint32_t *readval, uint32_t nb_regs);
 
+	/**
+	 * Optional. Events posted by the driver with iio_push_event, delivered
+	 * to the clients that opened an event stream of the device.
+	 */
+	struct iio_event_queue *events;
 };
 
 #endif /* IIO_TYPES_H_ */
@@ -49,8 +49,15 @@
 
 #include "no_os_error.h"
 #include "no_os_util.h"
+#include "no_os_alloc.h"
+#include "no_os_trace.h"
+#ifdef IIO_STATS
+#include "no_os_delay.h"
+#endif
 
 #define SET_DUMMY_IF_NULL(func, dummy) ((func) ? (func) : (dummy))
+/* iiod_conn_priv.stats_cmd when no command latency is measured */
+#define IIOD_STATS_NONE	UINT32_MAX
 
 static char delim[] = " \r\n";
 
@@ -76,7 +83,8 @@ static struct iiod_str cmds[] = {
 	[IIOD_CMD_WRITEBUF]	= IIOD_STR("WRITEBUF"),
 	[IIOD_CMD_GETTRIG]	= IIOD_STR("GETTRIG"),
 	[IIOD_CMD_SETTRIG]	= IIOD_STR("SETTRIG"),
-	[IIOD_CMD_SET]		= IIOD_STR("SET")
+	[IIOD_CMD_SET]		= IIOD_STR("SET"),
+	[IIOD_CMD_BINARY]	= IIOD_STR("BINARY")
 };
 static const uint32_t priority_array[] = {
 	/* Order not tested, just personal expectation. Function can
@@ -94,7 +102,8 @@ static const uint32_t priority_array[] = {
 	IIOD_CMD_GETTRIG,
 	IIOD_CMD_SETTRIG,
 	IIOD_CMD_HELP,
-	IIOD_CMD_SET
+	IIOD_CMD_SET,
+	IIOD_CMD_BINARY
 };
 
 static_assert(NO_OS_ARRAY_SIZE(cmds) == NO_OS_ARRAY_SIZE(priority_array),
@@ -200,7 +209,7 @@ static int32_t iiod_parse_rw_attr(const char *token, struct comand_desc *res,
 	    res->type == IIO_ATTR_TYPE_CH_OUT) {
 		if (!token)
 			return -EINVAL;
-		strncpy(res->channel, token, sizeof(res->channel));
+		res->channel = token;
 		token = strtok_r(NULL, delim, ctx);
 	}
 
@@ -209,12 +218,12 @@ static int32_t iiod_parse_rw_attr(const char *token, struct comand_desc *res,
 			return -EINVAL;
 
 		if (*token >= '0' && *token <= '9') {
-			memset(res->attr, 0, sizeof(res->attr));
+			res->attr = "";
 
 			return parse_num(token, &res->bytes_count, 10);
 		}
 
-		strncpy(res->attr, token, sizeof(res->attr));
+		res->attr = token;
 		token = strtok_r(NULL, delim, ctx);
 		if (!token)
 			return -EINVAL;
@@ -222,10 +231,8 @@ static int32_t iiod_parse_rw_attr(const char *token, struct comand_desc *res,
 		return parse_num(token, &res->bytes_count, 10);
 	}
 
-	if (token)
-		strncpy(res->attr, token, sizeof(res->attr));
-	else
-		memset(res->attr, 0, sizeof(res->attr));
+	/* All the attributes of the type */
+	res->attr = token ? token : "";
 
 	return 0;
 }
@@ -247,6 +254,7 @@ int32_t iiod_parse_line(char *buf, struct comand_desc *res, char **ctx)
 	case IIOD_CMD_EXIT:
 	case IIOD_CMD_PRINT:
 	case IIOD_CMD_VERSION:
+	case IIOD_CMD_BINARY:
 		return 0;
 	case IIOD_CMD_TIMEOUT:
 		return parse_num(token, &res->timeout, 10);
@@ -254,7 +262,10 @@ int32_t iiod_parse_line(char *buf, struct comand_desc *res, char **ctx)
 		break;
 	}
 
-	strncpy(res->device, token, sizeof(res->device));
+	if (!token)
+		return -EINVAL;
+
+	res->device = token;
 	token = strtok_r(NULL, delim, ctx);
 	switch (res->cmd) {
 	case IIOD_CMD_CLOSE:
@@ -269,14 +280,12 @@ int32_t iiod_parse_line(char *buf, struct comand_desc *res, char **ctx)
 	case IIOD_CMD_WRITEBUF:
 		return parse_num(token, &res->bytes_count, 10);
 	case IIOD_CMD_SETTRIG:
-		if (token)
-			strncpy(res->trigger, token, sizeof(res->trigger));
-		else
-			memset(res->trigger, 0, sizeof(res->trigger));
+		/* No trigger to remove it */
+		res->trigger = token ? token : "";
 
 		return 0;
 	case IIOD_CMD_SET:
-		return iiod_parse_set(buf, res, ctx);
+		return iiod_parse_set(token, res, ctx);
 	default:
 		break;
 	}
@@ -318,12 +327,53 @@ static int dummy_set_timeout(struct iiod_ctx *ctx, uint32_t timeout)
 	return -EINVAL;
 }
 
+static int dummy_rw_attr_idx(struct iiod_ctx *ctx, struct iiod_attr_idx *attr,
+			     char *buf, uint32_t len)
+{
+	return -EINVAL;
+}
+
+static int dummy_get_trigger_idx(struct iiod_ctx *ctx, uint32_t dev)
+{
+	return -EINVAL;
+}
+
+static int dummy_set_trigger_idx(struct iiod_ctx *ctx, uint32_t dev,
+				 int32_t trig)
+{
+	return -EINVAL;
+}
+
+static int dummy_read_xml(struct iiod_ctx *ctx, uint32_t offset, char *buf,
+			  uint32_t len)
+{
+	return -EINVAL;
+}
+
 static int dummy_set_buffers_count(struct iiod_ctx *ctx, const char *device,
 				   uint32_t buffers_count)
 {
 	return -EINVAL;
 }
 
+static int dummy_open_evstream(struct iiod_ctx *ctx, uint32_t dev,
+			       uint32_t *seq)
+{
+	return -ENOENT;
+}
+
+static int dummy_read_event(struct iiod_ctx *ctx, uint32_t dev, uint32_t *seq,
+			    struct iiod_event *event)
+{
+	return -EINVAL;
+}
+
+static int dummy_get_buffer_info(struct iiod_ctx *ctx, uint32_t dev,
+				 uint32_t mask, const char **device, bool *tx)
+{
+	return -EINVAL;
+}
+
 int32_t iiod_copy_ops(struct iiod_ops *ops, struct iiod_ops *new_ops)
 {
 	if (!new_ops->recv || !new_ops->send)
@@ -331,6 +381,7 @@ int32_t iiod_copy_ops(struct iiod_ops *ops, struct iiod_ops *new_ops)
 
 	ops->recv = new_ops->recv;
 	ops->send = new_ops->send;
+	ops->sendv = new_ops->sendv;
 
 	ops->open = SET_DUMMY_IF_NULL(new_ops->open, dummy_open);
 	ops->close = SET_DUMMY_IF_NULL(new_ops->close, dummy_close);
@@ -340,6 +391,15 @@ int32_t iiod_copy_ops(struct iiod_ops *ops, struct iiod_ops *new_ops)
 	ops->write_attr = SET_DUMMY_IF_NULL(new_ops->write_attr, dummy_rw_attr);
 	ops->get_trigger = SET_DUMMY_IF_NULL(new_ops->get_trigger, dummy_rd_data);
 	ops->set_trigger = SET_DUMMY_IF_NULL(new_ops->set_trigger, dummy_wr_data);
+	ops->read_attr_idx = SET_DUMMY_IF_NULL(new_ops->read_attr_idx,
+					       dummy_rw_attr_idx);
+	ops->write_attr_idx = SET_DUMMY_IF_NULL(new_ops->write_attr_idx,
+						dummy_rw_attr_idx);
+	ops->get_trigger_idx = SET_DUMMY_IF_NULL(new_ops->get_trigger_idx,
+			       dummy_get_trigger_idx);
+	ops->set_trigger_idx = SET_DUMMY_IF_NULL(new_ops->set_trigger_idx,
+			       dummy_set_trigger_idx);
+	ops->read_xml = SET_DUMMY_IF_NULL(new_ops->read_xml, dummy_read_xml);
 	ops->set_timeout = SET_DUMMY_IF_NULL(new_ops->set_timeout, dummy_set_timeout);
 	ops->set_buffers_count = SET_DUMMY_IF_NULL(new_ops->set_buffers_count,
 				 dummy_set_buffers_count);
@@ -347,6 +407,18 @@ int32_t iiod_copy_ops(struct iiod_ops *ops, struct iiod_ops *new_ops)
 					       dummy_close);
 	ops->push_buffer = SET_DUMMY_IF_NULL(new_ops->push_buffer,
 					     dummy_close);
+	ops->open_evstream = SET_DUMMY_IF_NULL(new_ops->open_evstream,
+					       dummy_open_evstream);
+	ops->read_event = SET_DUMMY_IF_NULL(new_ops->read_event,
+					    dummy_read_event);
+	ops->get_buffer_info = SET_DUMMY_IF_NULL(new_ops->get_buffer_info,
+			       dummy_get_buffer_info);
+
+	/* Zero-copy reads are used only when both ops are provided */
+	if (new_ops->read_buffer_block && new_ops->read_buffer_block_done) {
+		ops->read_buffer_block = new_ops->read_buffer_block;
+		ops->read_buffer_block_done = new_ops->read_buffer_block_done;
+	}
 
 	return 0;
 }
@@ -359,29 +431,45 @@ int32_t iiod_init(struct iiod_desc **desc, struct iiod_init_param *param)
 	if (!desc || !param || !param->ops)
 		return -EINVAL;
 
-	ldesc = (struct iiod_desc *)calloc(1, sizeof(*ldesc));
+	ldesc = (struct iiod_desc *)no_os_calloc(1, sizeof(*ldesc));
 	if (!ldesc)
 		return -ENOMEM;
 
 	ret = iiod_copy_ops(&ldesc->ops, param->ops);
-	if (NO_OS_IS_ERR_VALUE(ret)) {
-		free(ldesc);
-
-		return ret;
+	if (NO_OS_IS_ERR_VALUE(ret))
+		goto error;
+
+	ldesc->max_conns = param->max_connections ? param->max_connections :
+			   IIOD_MAX_CONNECTIONS;
+	ldesc->conns = no_os_calloc(ldesc->max_conns, sizeof(*ldesc->conns));
+	if (!ldesc->conns) {
+		ret = -ENOMEM;
+		goto error;
 	}
 
 	ldesc->xml = param->xml;
 	ldesc->xml_len = param->xml_len;
+	ldesc->step_quota = param->step_quota;
 	ldesc->app_instance = param->instance;
 
 	*desc = ldesc;
 
 	return 0;
+
+error:
+	no_os_free(ldesc);
+
+	return ret;
 }
 
 void iiod_remove(struct iiod_desc *desc)
 {
-	free(desc);
+	uint32_t i;
+
+	for (i = 0; i < desc->max_conns; i++)
+		no_os_free(desc->conns[i]);
+	no_os_free(desc->conns);
+	no_os_free(desc);
 }
 
 static void conn_clean_state(struct iiod_conn_priv *conn)
@@ -389,11 +477,18 @@ static void conn_clean_state(struct iiod_conn_priv *conn)
 	memset(&conn->cmd_data, 0, sizeof(conn->cmd_data));
 	memset(&conn->res, 0, sizeof(conn->res));
 	memset(&conn->nb_buf, 0, sizeof(conn->nb_buf));
+	memset(&conn->bin_cmd, 0, sizeof(conn->bin_cmd));
+	memset(&conn->bin_res, 0, sizeof(conn->bin_res));
 
 	conn->res.buf.buf = NULL;
 	conn->res.buf.idx = 0;
 	conn->parser_idx = 0;
-	conn->state = IIOD_READING_LINE;
+	conn->bin_len = 0;
+	conn->xml_idx = 0;
+	conn->state = conn->binary ? IIOD_BIN_READING_CMD : IIOD_READING_LINE;
+#ifdef IIO_STATS
+	conn->stats_cmd = IIOD_STATS_NONE;
+#endif
 }
 
 int32_t iiod_conn_add(struct iiod_desc *desc, struct iiod_conn_data *data,
@@ -405,11 +500,14 @@ int32_t iiod_conn_add(struct iiod_desc *desc, struct iiod_conn_data *data,
 	if (!desc || !new_conn_id)
 		return -EINVAL;
 
-	for (i = 0; i < IIOD_MAX_CONNECTIONS; ++i)
-		if (!desc->conns[i].used) {
-			conn = &desc->conns[i];
-			memset(conn, 0, sizeof(*conn));
-			conn->used = 1;
+	for (i = 0; i < desc->max_conns; ++i)
+		if (!desc->conns[i]) {
+			/* State only allocated while the connection exists */
+			conn = no_os_calloc(1, sizeof(*conn));
+			if (!conn)
+				return -ENOMEM;
+
+			desc->conns[i] = conn;
 			conn->conn = data->conn;
 			/*
 			 * TODO in future:
@@ -418,6 +516,10 @@ int32_t iiod_conn_add(struct iiod_desc *desc, struct iiod_conn_data *data,
 			 */
 			conn->payload_buf = data->buf;
 			conn->payload_buf_len = data->len;
+			conn->weight = data->weight ? data->weight : 1;
+#ifdef IIO_STATS
+			conn->stats_cmd = IIOD_STATS_NONE;
+#endif
 			*new_conn_id = i;
 
 			return 0;
@@ -426,18 +528,47 @@ int32_t iiod_conn_add(struct iiod_desc *desc, struct iiod_conn_data *data,
 	return -EBUSY;
 }
 
+/* Release the device block of a READBUF left pending by the client */
+static void iiod_read_block_release(struct iiod_desc *desc,
+				    struct iiod_conn_priv *conn)
+{
+	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
+
+	if (!conn->nb_buf_block)
+		return;
+
+	desc->ops.read_buffer_block_done(&ctx, conn->cmd_data.device);
+	conn->nb_buf_block = false;
+}
+
+/* Close the devices of the binary buffers left enabled by the client */
+static void iiod_bin_buffers_close(struct iiod_desc *desc,
+				   struct iiod_conn_priv *conn)
+{
+	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
+	uint32_t i;
+
+	for (i = 0; i < IIOD_MAX_BUFFERS; i++)
+		if (conn->buffers[i].used && conn->buffers[i].enabled)
+			desc->ops.close(&ctx, conn->buffers[i].device);
+}
+
 int32_t iiod_conn_remove(struct iiod_desc *desc, uint32_t conn_id,
 			 struct iiod_conn_data *data)
 {
-	if (!desc || conn_id > IIOD_MAX_CONNECTIONS ||
-	    !desc->conns[conn_id].used)
-		return -EINVAL;
 	struct iiod_conn_priv *conn;
-	conn = &desc->conns[conn_id];
+
+	if (!desc || conn_id >= desc->max_conns || !desc->conns[conn_id])
+		return -EINVAL;
+
+	conn = desc->conns[conn_id];
+	iiod_read_block_release(desc, conn);
+	iiod_bin_buffers_close(desc, conn);
 	data->conn = conn->conn;
 	data->len = conn->payload_buf_len;
 	data->buf = conn->payload_buf;
-	conn->used = 0;
+	no_os_free(conn);
+	desc->conns[conn_id] = NULL;
 
 	return 0;
 }
@@ -459,7 +590,7 @@ static int32_t call_op(struct iiod_ops *ops, struct comand_desc *data,
 		return ops->set_trigger(ctx, data->device, data->trigger,
 					strlen(data->trigger));
 	case IIOD_CMD_SET:
-		break;
+		return ops->set_buffers_count(ctx, data->device, data->count);
 	default:
 		break;
 	}
@@ -467,6 +598,79 @@ static int32_t call_op(struct iiod_ops *ops, struct comand_desc *data,
 	return -EINVAL;
 }
 
+/*
+ * Send what is left in tx_buf.
+ * Returns 0 once tx_buf is empty, -EAGAIN if the connection can't take it all
+ * now or a negative error code.
+ */
+static int32_t iiod_flush(struct iiod_desc *desc, struct iiod_conn_priv *conn)
+{
+	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
+	uint8_t *buf = (uint8_t *)conn->tx_buf;
+	int32_t ret;
+
+	while (conn->tx_idx < conn->tx_len) {
+		ret = desc->ops.send(&ctx, buf + conn->tx_idx,
+				     conn->tx_len - conn->tx_idx);
+		if (ret == -EAGAIN || ret == 0)
+			return -EAGAIN;
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		conn->tx_idx += ret;
+	}
+	conn->tx_idx = 0;
+	conn->tx_len = 0;
+
+	return 0;
+}
+
+/*
+ * Same as iiod_ops.send, but data fitting in tx_buf is only copied there, to
+ * be sent together with the other responses of the step. Bigger data is sent
+ * right away, after what is pending in tx_buf.
+ */
+static int32_t iiod_send(struct iiod_desc *desc, struct iiod_conn_priv *conn,
+			 uint8_t *buf, uint32_t len)
+{
+	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
+	int32_t ret;
+
+	if (len > sizeof(conn->tx_buf) - conn->tx_len) {
+		ret = iiod_flush(desc, conn);
+		if (ret == -EAGAIN)
+			return 0;
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		if (len > sizeof(conn->tx_buf))
+			return desc->ops.send(&ctx, buf, len);
+	}
+	memcpy(conn->tx_buf + conn->tx_len, buf, len);
+	conn->tx_len += len;
+
+	return len;
+}
+
+/*
+ * Same as iiod_ops.recv, but the data already read ahead in rx_buf by
+ * iiod_read_line is returned first.
+ */
+static int32_t iiod_recv(struct iiod_desc *desc, struct iiod_conn_priv *conn,
+			 uint8_t *buf, uint32_t len)
+{
+	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
+
+	if (conn->rx_idx == conn->rx_len)
+		return desc->ops.recv(&ctx, buf, len);
+
+	len = no_os_min(len, conn->rx_len - conn->rx_idx);
+	memcpy(buf, conn->rx_buf + conn->rx_idx, len);
+	conn->rx_idx += len;
+
+	return len;
+}
+
 /*
  * Unload data from buf without blocking.
  * When done will return 0, if there is still data to be sent it will return
@@ -475,7 +679,6 @@ static int32_t call_op(struct iiod_ops *ops, struct comand_desc *data,
 static int32_t rw_iiod_buff(struct iiod_desc *desc, struct iiod_conn_priv *conn,
 			    struct iiod_buff *buf, uint8_t flags)
 {
-	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
 	uint8_t *tmp_buf;
 	int32_t ret;
 	int32_t len;
@@ -484,9 +687,9 @@ static int32_t rw_iiod_buff(struct iiod_desc *desc, struct iiod_conn_priv *conn,
 	if (len) {
 		tmp_buf = (uint8_t *)buf->buf + buf->idx;
 		if (flags & IIOD_WR)
-			ret = desc->ops.send(&ctx, tmp_buf, len);
+			ret = iiod_send(desc, conn, tmp_buf, len);
 		else
-			ret = desc->ops.recv(&ctx, tmp_buf, len);
+			ret = iiod_recv(desc, conn, tmp_buf, len);
 		if (NO_OS_IS_ERR_VALUE(ret))
 			return ret;
 
@@ -496,7 +699,7 @@ static int32_t rw_iiod_buff(struct iiod_desc *desc, struct iiod_conn_priv *conn,
 	}
 
 	if (flags & IIOD_ENDL) {
-		ret = desc->ops.send(&ctx, (uint8_t *)"\n", 1);
+		ret = iiod_send(desc, conn, (uint8_t *)"\n", 1);
 		if (NO_OS_IS_ERR_VALUE(ret))
 			return ret;
 
@@ -507,27 +710,178 @@ static int32_t rw_iiod_buff(struct iiod_desc *desc, struct iiod_conn_priv *conn,
 	return 0;
 }
 
+/* Set the xml to be sent as the data of a command result */
+static void iiod_set_xml_result(struct iiod_desc *desc,
+				struct iiod_run_cmd_result *res)
+{
+	if (desc->xml) {
+		res->buf.buf = desc->xml;
+		res->buf.len = desc->xml_len;
+	} else {
+		res->stream_xml = true;
+	}
+}
+
+/*
+ * Send the xml obtained chunk by chunk from read_xml, through payload_buf.
+ * Same return values as rw_iiod_buff.
+ */
+static int32_t iiod_send_xml(struct iiod_desc *desc,
+			     struct iiod_conn_priv *conn, uint8_t flags)
+{
+	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
+	struct iiod_buff *buf = &conn->res.buf;
+	int32_t ret;
+
+	while (buf->idx < buf->len || conn->xml_idx < desc->xml_len) {
+		if (buf->idx == buf->len) {
+			ret = desc->ops.read_xml(&ctx, conn->xml_idx,
+						 conn->payload_buf,
+						 no_os_min(conn->payload_buf_len,
+							   desc->xml_len -
+							   conn->xml_idx));
+			if (NO_OS_IS_ERR_VALUE(ret))
+				return ret;
+			if (ret == 0)
+				return -EIO;
+
+			buf->buf = conn->payload_buf;
+			buf->len = ret;
+			buf->idx = 0;
+			conn->xml_idx += ret;
+		}
+		ret = rw_iiod_buff(desc, conn, buf, IIOD_WR);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	/* Only the end of line is left to be sent, if requested */
+	return rw_iiod_buff(desc, conn, buf, flags);
+}
+
+/*
+ * Same as rw_iiod_buff, but transfers at maximum the bytes left in the quota of
+ * the current step. Returns -EAGAIN when the quota is used before buf is done.
+ */
+static int32_t rw_iiod_buff_quota(struct iiod_desc *desc,
+				  struct iiod_conn_priv *conn,
+				  struct iiod_buff *buf, uint8_t flags)
+{
+	uint32_t len = buf->len;
+	uint32_t idx = buf->idx;
+	int32_t ret;
+
+	if (!desc->step_quota)
+		return rw_iiod_buff(desc, conn, buf, flags);
+
+	if (!conn->quota)
+		return -EAGAIN;
+
+	buf->len = no_os_min(len, idx + conn->quota);
+	ret = rw_iiod_buff(desc, conn, buf, flags);
+	conn->quota -= buf->idx - idx;
+	if (ret == 0 && buf->len < len)
+		ret = -EAGAIN;
+	buf->len = len;
+
+	return ret;
+}
+
+/*
+ * Send what is left of the READBUF response header and the data in nb_buf in
+ * one sendv call. Returns -EAGAIN until the header is sent, 0 once it is. The
+ * rest of the data, if any, is sent by rw_iiod_buff_quota.
+ */
+static int32_t iiod_sendv_hdr(struct iiod_desc *desc,
+			      struct iiod_conn_priv *conn)
+{
+	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
+	struct iiod_buff *hdr = &conn->hdr_buf;
+	struct iiod_buff *data = &conn->nb_buf;
+	struct iiod_iovec iov[2];
+	uint32_t hdr_len, len;
+	int32_t ret;
+
+	/* The responses gathered before go first */
+	ret = iiod_flush(desc, conn);
+	if (ret)
+		return ret;
+
+	hdr_len = hdr->len - hdr->idx;
+	len = data->len - data->idx;
+	if (desc->step_quota)
+		len = no_os_min(len, conn->quota);
+
+	iov[0].base = hdr->buf + hdr->idx;
+	iov[0].len = hdr_len;
+	iov[1].base = data->buf + data->idx;
+	iov[1].len = len;
+	ret = desc->ops.sendv(&ctx, iov, len ? 2 : 1);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	if ((uint32_t)ret < hdr_len) {
+		hdr->idx += ret;
+		return -EAGAIN;
+	}
+
+	hdr->idx = hdr->len;
+	ret -= hdr_len;
+	data->idx += ret;
+	if (desc->step_quota)
+		conn->quota -= ret;
+
+	return 0;
+}
+
 static int32_t do_read_buff(struct iiod_desc *desc, struct iiod_conn_priv *conn)
 {
 	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
+	bool zero_copy = desc->ops.read_buffer_block != NULL;
 	int32_t ret, len;
 
 	if (conn->nb_buf.len == 0) {
-		conn->nb_buf.buf = conn->payload_buf;
-		len = no_os_min(conn->payload_buf_len,
-				conn->cmd_data.bytes_count);
-		/* Read from dev */
-		ret = desc->ops.read_buffer(&ctx, conn->cmd_data.device,
-					    conn->nb_buf.buf, len);
+		if (zero_copy) {
+			/* Get data directly from the device buffer */
+			ret = desc->ops.read_buffer_block(&ctx,
+							  conn->cmd_data.device,
+							  (void **)&conn->nb_buf.buf,
+							  conn->cmd_data.bytes_count);
+		} else {
+			conn->nb_buf.buf = conn->payload_buf;
+			len = no_os_min(conn->payload_buf_len,
+					conn->cmd_data.bytes_count);
+			/* Read from dev */
+			ret = desc->ops.read_buffer(&ctx, conn->cmd_data.device,
+						    conn->nb_buf.buf, len);
+		}
 		if (NO_OS_IS_ERR_VALUE(ret))
 			return ret;
 		len = ret;
 		conn->nb_buf.len = len;
 		conn->nb_buf.idx = 0;
+		conn->nb_buf_block = zero_copy;
 	}
 	if (conn->nb_buf.idx < conn->nb_buf.len) {
+		if (conn->hdr_buf.idx < conn->hdr_buf.len) {
+			/* Header of the response and first data in one go */
+			ret = iiod_sendv_hdr(desc, conn);
+			if (ret == -EAGAIN)
+				return ret;
+		} else {
+			ret = 0;
+		}
 		/* Write on conn */
-		ret = rw_iiod_buff(desc, conn, &conn->nb_buf, IIOD_WR);
+		if (!NO_OS_IS_ERR_VALUE(ret) &&
+		    conn->nb_buf.idx < conn->nb_buf.len)
+			ret = rw_iiod_buff_quota(desc, conn, &conn->nb_buf,
+						 IIOD_WR);
+		if (zero_copy && ret != -EAGAIN) {
+			/* Data was sent or the connection failed */
+			desc->ops.read_buffer_block_done(&ctx,
+							 conn->cmd_data.device);
+			conn->nb_buf_block = false;
+		}
 		if (NO_OS_IS_ERR_VALUE(ret))
 			return ret;
 
@@ -555,7 +909,7 @@ static int32_t do_write_buff(struct iiod_desc *desc,
 	}
 	if (conn->nb_buf.idx < conn->nb_buf.len) {
 		/* Read from conn */
-		ret = rw_iiod_buff(desc, conn, &conn->nb_buf, IIOD_RD);
+		ret = rw_iiod_buff_quota(desc, conn, &conn->nb_buf, IIOD_RD);
 		if (NO_OS_IS_ERR_VALUE(ret))
 			return ret;
 	}
@@ -565,6 +919,16 @@ static int32_t do_write_buff(struct iiod_desc *desc,
 	if (NO_OS_IS_ERR_VALUE(ret))
 		return ret;
 
+	if ((uint32_t)ret < conn->nb_buf.len) {
+		/* Device buffer full, keep the rest for the next call */
+		conn->nb_buf.buf += ret;
+		conn->nb_buf.len -= ret;
+		conn->nb_buf.idx -= ret;
+		conn->cmd_data.bytes_count -= ret;
+
+		return -EAGAIN;
+	}
+
 	conn->cmd_data.bytes_count -= conn->nb_buf.len;
 	conn->nb_buf.len = 0;
 	if (conn->cmd_data.bytes_count)
@@ -611,13 +975,18 @@ static int32_t iiod_run_cmd(struct iiod_desc *desc,
 	case IIOD_CMD_PRINT:
 		conn->res.val = desc->xml_len;
 		conn->res.write_val = 1;
-		conn->res.buf.buf = desc->xml;
-		conn->res.buf.len = desc->xml_len;
+		iiod_set_xml_result(desc, &conn->res);
 		break;
 	case IIOD_CMD_VERSION:
 		conn->res.buf.buf = IIOD_VERSION;
 		conn->res.buf.len = IIOD_VERSION_LEN;
 		break;
+	case IIOD_CMD_BINARY:
+		/* Following commands will be binary, after this reply */
+		conn->binary = true;
+		conn->res.val = 0;
+		conn->res.write_val = 1;
+		break;
 	case IIOD_CMD_READ:
 	case IIOD_CMD_GETTRIG:
 		if (data->cmd == IIOD_CMD_READ)
@@ -647,6 +1016,9 @@ static int32_t iiod_run_cmd(struct iiod_desc *desc,
 	case IIOD_CMD_READBUF:
 		conn->res.write_val = 1;
 		ret = desc->ops.refill_buffer(&ctx, data->device);
+		if (ret == -EAGAIN)
+			/* Device still filling the buffer. Retry next step */
+			return ret;
 		if (NO_OS_IS_ERR_VALUE(ret)) {
 			conn->res.val = ret;
 			break;
@@ -667,97 +1039,587 @@ static int32_t iiod_run_cmd(struct iiod_desc *desc,
 	return 0;
 }
 
-static int32_t iiod_read_line(struct iiod_desc *desc,
-			      struct iiod_conn_priv *conn)
+static bool iiod_bin_is_write(uint8_t op)
 {
-	struct iiod_ctx ctx = {
-		.instance = desc->app_instance,
-		.conn = conn->conn
-	};
-	int32_t ret;
-	char *ch;
-
-	while (conn->parser_idx < IIOD_PARSER_MAX_BUF_SIZE - 1) {
-		ch = conn->parser_buf + conn->parser_idx;
-		ret = desc->ops.recv(&ctx,(uint8_t *)ch, 1);
-		if (ret == -EAGAIN || ret == 0)
-			return -EAGAIN;
+	switch (op) {
+	case IIOD_OP_CREATE_BUFFER:
+	case IIOD_OP_CREATE_BLOCK:
+	case IIOD_OP_TRANSFER_BLOCK:
+		return true;
+	default:
+		return op >= IIOD_OP_WRITE_ATTR && op <= IIOD_OP_WRITE_CHN_ATTR;
+	}
+}
 
-		if (NO_OS_IS_ERR_VALUE(ret))
-			goto end;
+/* Fill attr with the indexes of the attribute of a binary command */
+static void iiod_bin_get_attr(struct iiod_command *cmd,
+			      struct iiod_attr_idx *attr)
+{
+	attr->dev = cmd->dev;
+	attr->channel = 0;
+	attr->attr = cmd->code;
+
+	switch (cmd->op) {
+	case IIOD_OP_READ_DBG_ATTR:
+	case IIOD_OP_WRITE_DBG_ATTR:
+		attr->type = IIO_ATTR_TYPE_DEBUG;
+		break;
+	case IIOD_OP_READ_BUF_ATTR:
+	case IIOD_OP_WRITE_BUF_ATTR:
+		attr->type = IIO_ATTR_TYPE_BUFFER;
+		break;
+	case IIOD_OP_READ_CHN_ATTR:
+	case IIOD_OP_WRITE_CHN_ATTR:
+		attr->type = IIO_ATTR_TYPE_CH_IN;
+		attr->channel = (uint32_t)cmd->code >> 16;
+		attr->attr = cmd->code & 0xFFFF;
+		break;
+	default:
+		attr->type = IIO_ATTR_TYPE_DEVICE;
+		break;
+	}
+}
 
-		if (conn->parser_idx == 0 && (*ch == '\n' || *ch == '\r'))
-			continue ;
+/* Event stream of the client of cmd on its device, NULL if not open */
+static struct iiod_evstream *iiod_find_evstream(struct iiod_conn_priv *conn,
+		struct iiod_command *cmd)
+{
+	uint32_t i;
 
-		++conn->parser_idx;
-		if (*ch == '\n') {
-			conn->parser_buf[conn->parser_idx] = '\0';
-			ret = 0;
-			goto end;
-		}
-	}
+	for (i = 0; i < IIOD_MAX_EVSTREAMS; i++)
+		if (conn->evstreams[i].used &&
+		    conn->evstreams[i].client_id == cmd->client_id &&
+		    conn->evstreams[i].dev == cmd->dev)
+			return &conn->evstreams[i];
 
-	ret = -EIO;
-end:
-	conn->parser_idx = 0;
-	return ret;
+	return NULL;
 }
 
-/*
- * Function will return SUCCESS when a state was processed.
- * If a state is still in processing state, it will return -EAGAIN.
- * If other error occur. E.g. Connection errors, they are returned and
- * the connection must be cleaned up.
- */
-static int32_t iiod_run_state(struct iiod_desc *desc,
-			      struct iiod_conn_priv *conn)
+/* Handle CREATE_EVSTREAM, FREE_EVSTREAM and READ_EVENT */
+static int32_t iiod_run_evstream_cmd(struct iiod_desc *desc,
+				     struct iiod_conn_priv *conn)
 {
-	struct iiod_ctx ctx = {
-		.instance = desc->app_instance,
-		.conn = conn->conn
-	};
+	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
+	struct iiod_command *cmd = &conn->bin_cmd;
+	struct iiod_evstream *evstream;
 	int32_t ret;
+	uint32_t i;
 
-	switch (conn->state) {
-	case IIOD_READING_LINE:
-		/* Read input data until \n. I/O Calls */
-		ret = iiod_read_line(desc, conn);
+	evstream = iiod_find_evstream(conn, cmd);
+	switch (cmd->op) {
+	case IIOD_OP_CREATE_EVSTREAM:
+		if (evstream)
+			return -EBUSY;
+
+		for (i = 0; i < IIOD_MAX_EVSTREAMS; i++)
+			if (!conn->evstreams[i].used)
+				break;
+		if (i == IIOD_MAX_EVSTREAMS)
+			return -ENOSPC;
+
+		evstream = &conn->evstreams[i];
+		ret = desc->ops.open_evstream(&ctx, cmd->dev, &evstream->seq);
 		if (NO_OS_IS_ERR_VALUE(ret))
 			return ret;
 
-		/* Fill struct comand_desc with data from line. No I/O */
-		ret = iiod_parse_line(conn->parser_buf, &conn->cmd_data,
-				      &conn->strtok_ctx);
-		if (NO_OS_IS_ERR_VALUE(ret)) {
-			/* Parsing line failed */
-			conn->res.write_val = 1;
-			conn->res.val = ret;
-			conn->state = IIOD_WRITING_CMD_RESULT;
-		} else if (conn->cmd_data.cmd == IIOD_CMD_WRITE) {
-			/* Special case. Attribute needs to be read */
-			conn->nb_buf.buf = conn->payload_buf;
-			conn->nb_buf.len = conn->cmd_data.bytes_count;
-			conn->nb_buf.idx = 0;
-			conn->state = IIOD_READING_WRITE_DATA;
-		} else {
-			conn->state = IIOD_RUNNING_CMD;
-		}
+		evstream->used = true;
+		evstream->pending = false;
+		evstream->client_id = cmd->client_id;
+		evstream->dev = cmd->dev;
 
 		return 0;
-	case IIOD_RUNNING_CMD:
-		/* Execute or call necessary ops depending on cmd. No I/O */
-		ret = iiod_run_cmd(desc, conn);
-		if (NO_OS_IS_ERR_VALUE(ret))
-			return ret;
+	case IIOD_OP_FREE_EVSTREAM:
+		if (!evstream)
+			return -ENOENT;
 
-		conn->state = IIOD_WRITING_CMD_RESULT;
+		evstream->used = false;
 
 		return 0;
-	case IIOD_WRITING_CMD_RESULT:
-		/* Write result or the length of data to be sent*/
-		if (conn->res.write_val) {
-			if (conn->nb_buf.len == 0) {
-				conn->nb_buf.buf = conn->parser_buf;
+	default:
+		if (!evstream)
+			return -ENOENT;
+		if (evstream->pending)
+			return -EBUSY;
+
+		ret = desc->ops.read_event(&ctx, cmd->dev, &evstream->seq,
+					   &evstream->event);
+		if (ret == -EAGAIN) {
+			/* Answered by iiod_send_events once there is one */
+			evstream->pending = true;
+			conn->res.deferred = true;
+
+			return 0;
+		}
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		conn->res.buf.buf = (char *)&evstream->event;
+		conn->res.buf.len = sizeof(evstream->event);
+
+		return sizeof(evstream->event);
+	}
+}
+
+/* Binary buffer of the device and buffer index of cmd, NULL if not created */
+static struct iiod_bin_buffer *iiod_find_buffer(struct iiod_conn_priv *conn,
+		struct iiod_command *cmd)
+{
+	uint32_t i;
+
+	for (i = 0; i < IIOD_MAX_BUFFERS; i++)
+		if (conn->buffers[i].used &&
+		    conn->buffers[i].dev == cmd->dev &&
+		    conn->buffers[i].idx == (cmd->code & 0xFFFF))
+			return &conn->buffers[i];
+
+	return NULL;
+}
+
+/* Handle CREATE_BUFFER */
+static int32_t iiod_create_buffer(struct iiod_desc *desc,
+				  struct iiod_conn_priv *conn)
+{
+	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
+	struct iiod_command *cmd = &conn->bin_cmd;
+	struct iiod_bin_buffer *buf;
+	int32_t ret;
+	uint32_t i;
+
+	if (iiod_find_buffer(conn, cmd))
+		return -EBUSY;
+
+	for (i = 0; i < IIOD_MAX_BUFFERS; i++)
+		if (!conn->buffers[i].used)
+			break;
+	if (i == IIOD_MAX_BUFFERS)
+		return -ENOSPC;
+
+	/* Only the first 32 channels can be streamed */
+	if (conn->nb_buf.len < sizeof(buf->mask))
+		return -EINVAL;
+
+	buf = &conn->buffers[i];
+	memset(buf, 0, sizeof(*buf));
+	memcpy(&buf->mask, conn->payload_buf, sizeof(buf->mask));
+	ret = desc->ops.get_buffer_info(&ctx, cmd->dev, buf->mask,
+					&buf->device, &buf->tx);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+	if (!ret)
+		return -EINVAL;
+
+	buf->scan_size = ret;
+	buf->dev = cmd->dev;
+	buf->idx = cmd->code & 0xFFFF;
+	buf->used = true;
+
+	return 0;
+}
+
+/*
+ * Handle the buffer and block commands. The data of the blocks of output
+ * buffers is written in IIOD_BIN_WRITING_BLOCK, the blocks of input buffers are
+ * sent by iiod_send_blocks once their device filled them.
+ */
+static int32_t iiod_run_buffer_cmd(struct iiod_desc *desc,
+				   struct iiod_conn_priv *conn)
+{
+	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
+	struct iiod_command *cmd = &conn->bin_cmd;
+	struct iiod_bin_buffer *buf;
+	uint64_t size;
+	int32_t ret;
+
+	if (cmd->op == IIOD_OP_CREATE_BUFFER)
+		return iiod_create_buffer(desc, conn);
+
+	buf = iiod_find_buffer(conn, cmd);
+	if (!buf)
+		return -ENOENT;
+
+	switch (cmd->op) {
+	case IIOD_OP_FREE_BUFFER:
+	case IIOD_OP_DISABLE_BUFFER:
+		/* The block being sent can't be interrupted */
+		if (buf == conn->blk ||
+		    (buf->pending && cmd->op == IIOD_OP_FREE_BUFFER))
+			return -EBUSY;
+
+		if (buf->enabled) {
+			ret = desc->ops.close(&ctx, buf->device);
+			if (NO_OS_IS_ERR_VALUE(ret))
+				return ret;
+			buf->enabled = false;
+		}
+		/* The waiting transfer gets an error instead of the data */
+		buf->err = -EPIPE;
+		if (cmd->op == IIOD_OP_FREE_BUFFER)
+			buf->used = false;
+
+		return 0;
+	case IIOD_OP_ENABLE_BUFFER:
+		if (buf->enabled)
+			return -EBUSY;
+		if (!buf->nb_blocks)
+			return -EINVAL;
+
+		ret = desc->ops.set_buffers_count(&ctx, buf->device,
+						  buf->nb_blocks);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		ret = desc->ops.open(&ctx, buf->device,
+				     buf->block_size / buf->scan_size,
+				     buf->mask, false);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		buf->enabled = true;
+
+		return 0;
+	case IIOD_OP_CREATE_BLOCK:
+		if (buf->enabled)
+			return -EBUSY;
+		if (conn->nb_buf.len < sizeof(size))
+			return -EINVAL;
+
+		/* The device buffer holds blocks of the same size */
+		memcpy(&size, conn->payload_buf, sizeof(size));
+		if (!size || size > UINT32_MAX || size % buf->scan_size ||
+		    (buf->nb_blocks && size != buf->block_size))
+			return -EINVAL;
+
+		buf->block_size = size;
+		buf->nb_blocks++;
+
+		return 0;
+	case IIOD_OP_FREE_BLOCK:
+		if (buf->enabled)
+			return -EBUSY;
+		if (!buf->nb_blocks)
+			return -ENOENT;
+
+		buf->nb_blocks--;
+
+		return 0;
+	case IIOD_OP_TRANSFER_BLOCK:
+		if (buf->tx)
+			return -EINVAL;
+		if (!buf->enabled)
+			return -EPIPE;
+		if (buf->pending)
+			return -EBUSY;
+		if (!conn->bin_len || conn->bin_len > buf->block_size)
+			return -EINVAL;
+
+		buf->pending = true;
+		buf->refilled = false;
+		buf->err = 0;
+		buf->client_id = cmd->client_id;
+		buf->code = cmd->code;
+		buf->bytes = conn->bin_len;
+		conn->res.deferred = true;
+
+		return 0;
+	default:
+		return -EOPNOTSUPP;
+	}
+}
+
+/*
+ * Go on after the length of a TRANSFER_BLOCK. The data following it for an
+ * output buffer is written to the device, input buffers have no data.
+ */
+static void iiod_bin_start_transfer(struct iiod_conn_priv *conn)
+{
+	struct iiod_bin_buffer *buf = iiod_find_buffer(conn, &conn->bin_cmd);
+
+	if (!buf || !buf->tx) {
+		conn->state = IIOD_BIN_RUNNING_CMD;
+
+		return;
+	}
+
+	if (!buf->enabled)
+		conn->bin_res.code = -EPIPE;
+	else if (!conn->bin_len || conn->bin_len > buf->block_size)
+		conn->bin_res.code = -EINVAL;
+	if (conn->bin_res.code) {
+		/* Dropped in order to keep the stream in sync */
+		conn->state = IIOD_BIN_READING_DATA;
+
+		return;
+	}
+
+	conn->cmd_data.device = buf->device;
+	conn->cmd_data.bytes_count = conn->bin_len;
+	conn->state = IIOD_BIN_WRITING_BLOCK;
+}
+
+static int32_t iiod_run_bin_cmd(struct iiod_desc *desc,
+				struct iiod_conn_priv *conn)
+{
+	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
+	struct iiod_command *cmd = &conn->bin_cmd;
+	struct iiod_attr_idx attr;
+	int32_t ret;
+
+	/* Set when the write data didn't fit in payload_buf */
+	if (conn->bin_res.code)
+		return 0;
+
+	iiod_bin_get_attr(cmd, &attr);
+	switch (cmd->op) {
+	case IIOD_OP_PRINT:
+		ret = desc->xml_len;
+		iiod_set_xml_result(desc, &conn->res);
+		break;
+	case IIOD_OP_TIMEOUT:
+		ret = desc->ops.set_timeout(&ctx, cmd->code);
+		break;
+	case IIOD_OP_READ_ATTR:
+	case IIOD_OP_READ_DBG_ATTR:
+	case IIOD_OP_READ_BUF_ATTR:
+	case IIOD_OP_READ_CHN_ATTR:
+		ret = desc->ops.read_attr_idx(&ctx, &attr, conn->payload_buf,
+					      conn->payload_buf_len);
+		if (!NO_OS_IS_ERR_VALUE(ret)) {
+			conn->res.buf.buf = conn->payload_buf;
+			conn->res.buf.len = ret;
+		}
+		break;
+	case IIOD_OP_WRITE_ATTR:
+	case IIOD_OP_WRITE_DBG_ATTR:
+	case IIOD_OP_WRITE_BUF_ATTR:
+	case IIOD_OP_WRITE_CHN_ATTR:
+		conn->payload_buf[conn->nb_buf.len] = '\0';
+		ret = desc->ops.write_attr_idx(&ctx, &attr, conn->payload_buf,
+					       conn->nb_buf.len);
+		break;
+	case IIOD_OP_GETTRIG:
+		ret = desc->ops.get_trigger_idx(&ctx, cmd->dev);
+		break;
+	case IIOD_OP_SETTRIG:
+		ret = desc->ops.set_trigger_idx(&ctx, cmd->dev, cmd->code);
+		break;
+	case IIOD_OP_CREATE_EVSTREAM:
+	case IIOD_OP_FREE_EVSTREAM:
+	case IIOD_OP_READ_EVENT:
+		ret = iiod_run_evstream_cmd(desc, conn);
+		break;
+	case IIOD_OP_CREATE_BUFFER:
+	case IIOD_OP_FREE_BUFFER:
+	case IIOD_OP_ENABLE_BUFFER:
+	case IIOD_OP_DISABLE_BUFFER:
+	case IIOD_OP_CREATE_BLOCK:
+	case IIOD_OP_FREE_BLOCK:
+	case IIOD_OP_TRANSFER_BLOCK:
+		ret = iiod_run_buffer_cmd(desc, conn);
+		break;
+	default:
+		ret = -EOPNOTSUPP;
+		break;
+	}
+	conn->bin_res.code = ret;
+
+	return 0;
+}
+
+/*
+ * Read a line, ended by \n, in parser_buf. As much data as available is read
+ * ahead in rx_buf, the following commands are then parsed without I/O.
+ */
+static int32_t iiod_read_line(struct iiod_desc *desc,
+			      struct iiod_conn_priv *conn)
+{
+	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
+	int32_t ret;
+	char ch;
+
+	while (conn->parser_idx < IIOD_PARSER_MAX_BUF_SIZE - 1) {
+		if (conn->rx_idx == conn->rx_len) {
+			ret = desc->ops.recv(&ctx, (uint8_t *)conn->rx_buf,
+					     sizeof(conn->rx_buf));
+			if (ret == -EAGAIN || ret == 0)
+				return -EAGAIN;
+
+			if (NO_OS_IS_ERR_VALUE(ret))
+				goto end;
+
+			conn->rx_idx = 0;
+			conn->rx_len = ret;
+		}
+
+		ch = conn->rx_buf[conn->rx_idx++];
+		if (conn->parser_idx == 0 && (ch == '\n' || ch == '\r'))
+			continue ;
+
+		conn->parser_buf[conn->parser_idx++] = ch;
+		if (ch == '\n') {
+			conn->parser_buf[conn->parser_idx] = '\0';
+			ret = 0;
+			goto end;
+		}
+	}
+
+	ret = -EIO;
+end:
+	conn->parser_idx = 0;
+	return ret;
+}
+
+#ifdef IIO_STATS
+static uint32_t iiod_stats_time_us(void)
+{
+	struct no_os_time t = no_os_get_time();
+
+	return t.s * 1000000 + t.us;
+}
+
+/* Start measuring the latency of a command, cmd being an enum iiod_cmd */
+static void iiod_stats_start(struct iiod_conn_priv *conn, uint32_t cmd)
+{
+	conn->stats_cmd = cmd;
+	conn->stats_start = iiod_stats_time_us();
+}
+
+/* ASCII command accounting the latency of a binary opcode */
+static uint32_t iiod_stats_bin_cmd(uint8_t op)
+{
+	switch (op) {
+	case IIOD_OP_PRINT:
+		return IIOD_CMD_PRINT;
+	case IIOD_OP_TIMEOUT:
+		return IIOD_CMD_TIMEOUT;
+	case IIOD_OP_GETTRIG:
+		return IIOD_CMD_GETTRIG;
+	case IIOD_OP_SETTRIG:
+		return IIOD_CMD_SETTRIG;
+	case IIOD_OP_CREATE_BUFFER:
+	case IIOD_OP_ENABLE_BUFFER:
+		return IIOD_CMD_OPEN;
+	case IIOD_OP_FREE_BUFFER:
+	case IIOD_OP_DISABLE_BUFFER:
+		return IIOD_CMD_CLOSE;
+	default:
+		return iiod_bin_is_write(op) ? IIOD_CMD_WRITE : IIOD_CMD_READ;
+	}
+}
+
+/* Add the latency of the command that just ended to its histogram */
+static void iiod_stats_done(struct iiod_desc *desc,
+			    struct iiod_conn_priv *conn)
+{
+	struct iiod_cmd_stats *stats;
+	uint32_t us, limit, i;
+
+	if (conn->stats_cmd >= NO_OS_ARRAY_SIZE(desc->cmd_stats))
+		return;
+
+	stats = &desc->cmd_stats[conn->stats_cmd];
+	us = iiod_stats_time_us() - conn->stats_start;
+	stats->count++;
+	if (us > stats->max_us)
+		stats->max_us = us;
+
+	limit = 10;
+	for (i = 0; i < IIOD_LAT_BUCKETS - 1 && us >= limit; i++)
+		limit *= 10;
+	stats->hist[i]++;
+	conn->stats_cmd = IIOD_STATS_NONE;
+}
+#else
+#define iiod_stats_start(conn, cmd)	do {} while (0)
+#define iiod_stats_done(desc, conn)	do {} while (0)
+#endif
+
+/*
+ * Function will return SUCCESS when a state was processed.
+ * If a state is still in processing state, it will return -EAGAIN.
+ * If other error occur. E.g. Connection errors, they are returned and
+ * the connection must be cleaned up.
+ */
+/*
+ * Push the cyclic buffer until it is closed. The lines read meanwhile reuse
+ * parser_buf, so the device name is kept in payload_buf, unused until then.
+ */
+static void iiod_start_cyclic(struct iiod_conn_priv *conn)
+{
+	strncpy(conn->payload_buf, conn->cmd_data.device,
+		conn->payload_buf_len - 1);
+	conn->payload_buf[conn->payload_buf_len - 1] = '\0';
+	conn->cyclic_device = conn->payload_buf;
+	conn->parser_idx = 0;
+	conn->state = IIOD_PUSH_CYCLIC_BUFFER;
+}
+
+static int32_t iiod_run_state(struct iiod_desc *desc,
+			      struct iiod_conn_priv *conn)
+{
+	struct iiod_ctx ctx = {
+		.instance = desc->app_instance,
+		.conn = conn->conn
+	};
+	int32_t ret;
+
+	switch (conn->state) {
+	case IIOD_READING_LINE:
+		/* Read input data until \n. I/O Calls */
+		ret = iiod_read_line(desc, conn);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		/* Fill struct comand_desc with data from line. No I/O */
+		ret = iiod_parse_line(conn->parser_buf, &conn->cmd_data,
+				      &conn->strtok_ctx);
+		if (!NO_OS_IS_ERR_VALUE(ret))
+			iiod_stats_start(conn, conn->cmd_data.cmd);
+		if (NO_OS_IS_ERR_VALUE(ret)) {
+			/* Parsing line failed */
+			conn->res.write_val = 1;
+			conn->res.val = ret;
+			conn->state = IIOD_WRITING_CMD_RESULT;
+		} else if (conn->cmd_data.cmd == IIOD_CMD_WRITE) {
+			/* Special case. Attribute needs to be read */
+			conn->nb_buf.buf = conn->payload_buf;
+			conn->nb_buf.len = conn->cmd_data.bytes_count;
+			conn->nb_buf.idx = 0;
+			conn->state = IIOD_READING_WRITE_DATA;
+		} else {
+			conn->state = IIOD_RUNNING_CMD;
+		}
+
+		return 0;
+	case IIOD_RUNNING_CMD:
+		/* Execute or call necessary ops depending on cmd. No I/O */
+		ret = iiod_run_cmd(desc, conn);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		conn->state = IIOD_WRITING_CMD_RESULT;
+
+		return 0;
+	case IIOD_WRITING_CMD_RESULT:
+		if (conn->cmd_data.cmd == IIOD_CMD_READBUF &&
+		    conn->res.buf.buf && desc->ops.sendv &&
+		    conn->cmd_data.bytes_count) {
+			/* Sent by do_read_buff along with the first data */
+			ret = snprintf(conn->res_str, sizeof(conn->res_str),
+				       "%"PRIi32"\n%s\n", conn->res.val,
+				       conn->buf_mask);
+			conn->hdr_buf.buf = conn->res_str;
+			conn->hdr_buf.len = ret;
+			conn->hdr_buf.idx = 0;
+			memset(&conn->nb_buf, 0, sizeof(conn->nb_buf));
+			conn->state = IIOD_RW_BUF;
+
+			return 0;
+		}
+		/* Write result or the length of data to be sent*/
+		if (conn->res.write_val) {
+			if (conn->nb_buf.len == 0) {
+				/* The tokens of the line are still in use */
+				conn->nb_buf.buf = conn->res_str;
 				ret = sprintf(conn->nb_buf.buf, "%"PRIi32,
 					      conn->res.val);
 				conn->nb_buf.len = ret;
@@ -772,8 +1634,12 @@ static int32_t iiod_run_state(struct iiod_desc *desc,
 			}
 		}
 		/* Send buf from result. Non blocking */
-		if (conn->res.buf.buf &&
-		    conn->res.buf.idx < conn->res.buf.len) {
+		if (conn->res.stream_xml) {
+			ret = iiod_send_xml(desc, conn, IIOD_WR | IIOD_ENDL);
+			if (NO_OS_IS_ERR_VALUE(ret))
+				return ret;
+		} else if (conn->res.buf.buf &&
+			   conn->res.buf.idx < conn->res.buf.len) {
 			ret = rw_iiod_buff(desc, conn, &conn->res.buf,
 					   IIOD_WR | IIOD_ENDL);
 			if (NO_OS_IS_ERR_VALUE(ret))
@@ -783,7 +1649,7 @@ static int32_t iiod_run_state(struct iiod_desc *desc,
 		if (conn->cmd_data.cmd != IIOD_CMD_READBUF &&
 		    conn->cmd_data.cmd != IIOD_CMD_WRITEBUF) {
 			if (conn->is_cyclic_buffer && conn->cmd_data.cmd != IIOD_CMD_OPEN)
-				conn->state = IIOD_PUSH_CYCLIC_BUFFER;
+				iiod_start_cyclic(conn);
 			else
 				conn->state = IIOD_LINE_DONE;
 		} else {
@@ -832,15 +1698,136 @@ static int32_t iiod_run_state(struct iiod_desc *desc,
 
 		conn->state = IIOD_RUNNING_CMD;
 
+		return 0;
+	case IIOD_BIN_READING_CMD:
+		/* Read the fixed size header of a binary command */
+		if (conn->nb_buf.len == 0) {
+			conn->nb_buf.buf = (char *)&conn->bin_cmd;
+			conn->nb_buf.len = sizeof(conn->bin_cmd);
+			conn->nb_buf.idx = 0;
+		}
+		ret = rw_iiod_buff(desc, conn, &conn->nb_buf, IIOD_RD);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		iiod_stats_start(conn, iiod_stats_bin_cmd(conn->bin_cmd.op));
+		conn->bin_res.client_id = conn->bin_cmd.client_id;
+		conn->bin_res.op = IIOD_OP_RESPONSE;
+		conn->bin_res.dev = conn->bin_cmd.dev;
+		conn->nb_buf.len = 0;
+		if (iiod_bin_is_write(conn->bin_cmd.op)) {
+			conn->nb_buf.buf = (char *)&conn->bin_len;
+			conn->nb_buf.len = sizeof(conn->bin_len);
+			conn->nb_buf.idx = 0;
+			conn->state = IIOD_BIN_READING_LEN;
+		} else {
+			conn->state = IIOD_BIN_RUNNING_CMD;
+		}
+
+		return 0;
+	case IIOD_BIN_READING_LEN:
+		ret = rw_iiod_buff(desc, conn, &conn->nb_buf, IIOD_RD);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		conn->nb_buf.len = 0;
+		if (conn->bin_cmd.op == IIOD_OP_TRANSFER_BLOCK)
+			iiod_bin_start_transfer(conn);
+		else
+			conn->state = IIOD_BIN_READING_DATA;
+
+		return 0;
+	case IIOD_BIN_READING_DATA:
+		/*
+		 * Read the data of a write command. If it doesn't fit in
+		 * payload_buf (with the '\0' terminator), it is received and
+		 * dropped in order to keep the stream in sync.
+		 */
+		if (conn->nb_buf.len == 0 && conn->bin_len) {
+			conn->nb_buf.buf = conn->payload_buf;
+			conn->nb_buf.len = no_os_min(conn->bin_len,
+						     conn->payload_buf_len - 1);
+			conn->nb_buf.idx = 0;
+		}
+		ret = rw_iiod_buff(desc, conn, &conn->nb_buf, IIOD_RD);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		conn->bin_len -= conn->nb_buf.len;
+		if (conn->bin_len) {
+			if (!conn->bin_res.code)
+				conn->bin_res.code = -EFBIG;
+			conn->nb_buf.len = 0;
+
+			return 0;
+		}
+		conn->state = IIOD_BIN_RUNNING_CMD;
+
+		return 0;
+	case IIOD_BIN_RUNNING_CMD:
+		ret = iiod_run_bin_cmd(desc, conn);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		if (conn->res.deferred) {
+			conn->state = IIOD_LINE_DONE;
+
+			return 0;
+		}
+
+		conn->nb_buf.buf = (char *)&conn->bin_res;
+		conn->nb_buf.len = sizeof(conn->bin_res);
+		conn->nb_buf.idx = 0;
+		conn->state = IIOD_BIN_WRITING_RESULT;
+
+		return 0;
+	case IIOD_BIN_WRITING_RESULT:
+		/* Response header followed by the data, if any. Non blocking */
+		if (conn->nb_buf.idx < conn->nb_buf.len) {
+			ret = rw_iiod_buff(desc, conn, &conn->nb_buf, IIOD_WR);
+			if (NO_OS_IS_ERR_VALUE(ret))
+				return ret;
+		}
+		if (conn->res.stream_xml) {
+			ret = iiod_send_xml(desc, conn, IIOD_WR);
+			if (NO_OS_IS_ERR_VALUE(ret))
+				return ret;
+		} else if (conn->res.buf.buf &&
+			   conn->res.buf.idx < conn->res.buf.len) {
+			ret = rw_iiod_buff(desc, conn, &conn->res.buf, IIOD_WR);
+			if (NO_OS_IS_ERR_VALUE(ret))
+				return ret;
+		}
+		conn->state = IIOD_LINE_DONE;
+
+		return 0;
+	case IIOD_BIN_WRITING_BLOCK:
+		/* Data of the block straight to the device buffer */
+		if (conn->cmd_data.bytes_count) {
+			ret = do_write_buff(desc, conn);
+			if (NO_OS_IS_ERR_VALUE(ret))
+				return ret;
+		}
+
+		ret = desc->ops.push_buffer(&ctx, conn->cmd_data.device);
+		/* Nonzero, iiod_run_bin_cmd only sends it */
+		conn->bin_res.code = NO_OS_IS_ERR_VALUE(ret) ? ret :
+				     (int32_t)conn->bin_len;
+		conn->state = IIOD_BIN_RUNNING_CMD;
+
 		return 0;
 	case IIOD_PUSH_CYCLIC_BUFFER:
+		/* The step doesn't end in this state, send the last response */
+		ret = iiod_flush(desc, conn);
+		if (ret != -EAGAIN && NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
 		/* Push puffer to IIO application */
-		ret = desc->ops.push_buffer(&ctx,
-					    conn->cmd_data.device);
+		ret = desc->ops.push_buffer(&ctx, conn->cyclic_device);
 		/* If an error was encountered, close connection */
 		if (NO_OS_IS_ERR_VALUE(ret)) {
 			conn->res.val = ret;
-			desc->ops.close(&ctx, conn->cmd_data.device);
+			desc->ops.close(&ctx, conn->cyclic_device);
 			conn->state = IIOD_LINE_DONE;
 			conn->is_cyclic_buffer = false;
 			return 0;
@@ -858,9 +1845,13 @@ static int32_t iiod_run_state(struct iiod_desc *desc,
 			/* Exit this state only if a close command is received
 			   All other commands will be ignored.
 			*/
+			iiod_stats_start(conn, IIOD_CMD_CLOSE);
 			conn->nb_buf.len = 0;
 			conn->state = IIOD_RUNNING_CMD;
 			conn->is_cyclic_buffer = false;
+		} else {
+			/* The next line starts again at the beginning */
+			conn->parser_idx = 0;
 		}
 		return 0;
 
@@ -870,26 +1861,295 @@ static int32_t iiod_run_state(struct iiod_desc *desc,
 	}
 }
 
+/*
+ * Answer the READ_EVENT commands waiting for an event, if there is one now.
+ * Only called between commands, as the responses are not to be interleaved.
+ */
+static int32_t iiod_send_events(struct iiod_desc *desc,
+				struct iiod_conn_priv *conn)
+{
+	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
+	struct iiod_evstream *evstream;
+	struct {
+		struct iiod_command hdr;
+		struct iiod_event event;
+	} res;
+	uint32_t len;
+	int32_t ret;
+	uint32_t i;
+
+	for (i = 0; i < IIOD_MAX_EVSTREAMS; i++) {
+		evstream = &conn->evstreams[i];
+		if (!evstream->used || !evstream->pending)
+			continue;
+
+		/* The whole response must fit, to be sent in one piece */
+		if (sizeof(conn->tx_buf) - conn->tx_len < sizeof(res)) {
+			ret = iiod_flush(desc, conn);
+			if (ret)
+				return ret;
+		}
+
+		ret = desc->ops.read_event(&ctx, evstream->dev, &evstream->seq,
+					   &res.event);
+		if (ret == -EAGAIN)
+			continue;
+
+		res.hdr.client_id = evstream->client_id;
+		res.hdr.op = IIOD_OP_RESPONSE;
+		res.hdr.dev = evstream->dev;
+		if (NO_OS_IS_ERR_VALUE(ret)) {
+			res.hdr.code = ret;
+			len = sizeof(res.hdr);
+		} else {
+			res.hdr.code = sizeof(res.event);
+			len = sizeof(res);
+		}
+		ret = iiod_send(desc, conn, (uint8_t *)&res, len);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		evstream->pending = false;
+	}
+
+	return 0;
+}
+
+/*
+ * Pick the next input buffer whose device filled the block of its transfer,
+ * in turns starting after the last one served. The device of each waiting
+ * transfer is refilled, so they all fill while a block is being sent.
+ */
+static struct iiod_bin_buffer *iiod_next_block(struct iiod_desc *desc,
+		struct iiod_conn_priv *conn)
+{
+	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
+	struct iiod_bin_buffer *buf, *next = NULL;
+	uint32_t i, idx;
+	int32_t ret;
+
+	for (i = 0; i < IIOD_MAX_BUFFERS; i++) {
+		idx = (conn->blk_next + i) % IIOD_MAX_BUFFERS;
+		buf = &conn->buffers[idx];
+		if (!buf->used || !buf->pending)
+			continue;
+
+		if (!buf->err && !buf->refilled) {
+			ret = desc->ops.refill_buffer(&ctx, buf->device);
+			if (ret == -EAGAIN)
+				continue;
+			if (NO_OS_IS_ERR_VALUE(ret))
+				buf->err = ret;
+			else
+				buf->refilled = true;
+		}
+		if (!next) {
+			next = buf;
+			conn->blk_next = idx + 1;
+		}
+	}
+	if (!next)
+		return NULL;
+
+	if (next->err)
+		next->bytes = 0;
+	conn->blk_res.client_id = next->client_id;
+	conn->blk_res.op = IIOD_OP_RESPONSE;
+	conn->blk_res.dev = next->dev;
+	conn->blk_res.code = next->err ? next->err : (int32_t)next->bytes;
+	conn->blk_hdr.buf = (char *)&conn->blk_res;
+	conn->blk_hdr.len = sizeof(conn->blk_res);
+	conn->blk_hdr.idx = 0;
+	memset(&conn->blk_data, 0, sizeof(conn->blk_data));
+
+	return next;
+}
+
+/*
+ * Send the blocks of the input buffers as their devices fill them. Only called
+ * between commands, as the responses are not to be interleaved. Returns
+ * -EAGAIN while a block is not completely sent.
+ */
+static int32_t iiod_send_blocks(struct iiod_desc *desc,
+				struct iiod_conn_priv *conn)
+{
+	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
+	struct iiod_buff *data = &conn->blk_data;
+	struct iiod_bin_buffer *buf;
+	uint32_t len;
+	int32_t ret;
+
+	while (true) {
+		if (!conn->blk) {
+			conn->blk = iiod_next_block(desc, conn);
+			if (!conn->blk)
+				return 0;
+		}
+		buf = conn->blk;
+
+		ret = rw_iiod_buff(desc, conn, &conn->blk_hdr, IIOD_WR);
+		if (ret)
+			return ret;
+
+		while (data->idx < data->len || buf->bytes) {
+			if (data->idx == data->len) {
+				len = no_os_min(buf->bytes,
+						conn->payload_buf_len);
+				ret = desc->ops.read_buffer(&ctx, buf->device,
+							    conn->payload_buf,
+							    len);
+				if (NO_OS_IS_ERR_VALUE(ret))
+					return ret;
+
+				data->buf = conn->payload_buf;
+				data->len = ret;
+				data->idx = 0;
+				buf->bytes -= ret;
+			}
+			ret = rw_iiod_buff_quota(desc, conn, data, IIOD_WR);
+			if (ret)
+				return ret;
+		}
+
+		buf->pending = false;
+		conn->blk = NULL;
+	}
+}
+
 int32_t iiod_conn_step(struct iiod_desc *desc, uint32_t conn_id)
 {
 	struct iiod_conn_priv *conn;
-	int32_t ret;
+	int32_t ret, flush;
 
-	if (!desc || conn_id > IIOD_MAX_CONNECTIONS ||
-	    !desc->conns[conn_id].used)
+	if (!desc || conn_id >= desc->max_conns || !desc->conns[conn_id])
 		return -EINVAL;
 
-	conn = &desc->conns[conn_id];
+	NO_OS_TRACE_ENTER(NO_OS_TRACE_IIOD_CONN_STEP);
+	conn = desc->conns[conn_id];
+	conn->quota = desc->step_quota * conn->weight;
+	/* Responses left from the previous step go first */
+	ret = iiod_flush(desc, conn);
+	if (ret)
+		goto out;
+
+	/* No other response can go before the end of the block being sent */
+	if (conn->blk) {
+		ret = iiod_send_blocks(desc, conn);
+		if (ret)
+			goto out_flush;
+	}
+
 	do {
 		ret = iiod_run_state(desc, conn);
 		if (ret == -EAGAIN)
-			return ret;
-		if (NO_OS_IS_ERR_VALUE(ret) || conn->state == IIOD_LINE_DONE)
 			break;
+		if (NO_OS_IS_ERR_VALUE(ret)) {
+			conn_clean_state(conn);
+			goto out;
+		}
+		if (conn->state == IIOD_LINE_DONE) {
+			iiod_stats_done(desc, conn);
+			conn_clean_state(conn);
+			/* Go on while commands were already received */
+			if (conn->rx_idx == conn->rx_len)
+				break;
+		}
 		//The loop will continue because the state was changed.
 	} while (true);
 
-	conn_clean_state(conn);
+	/* Not in the middle of a response */
+	if (conn->binary && (conn->state == IIOD_BIN_READING_CMD ||
+			     conn->state == IIOD_BIN_READING_LEN ||
+			     conn->state == IIOD_BIN_READING_DATA)) {
+		flush = iiod_send_events(desc, conn);
+		if (flush != -EAGAIN && NO_OS_IS_ERR_VALUE(flush))
+			ret = flush;
+	}
+
+	/* payload_buf is not in use while the header or the length is read */
+	if (conn->binary && (conn->state == IIOD_BIN_READING_CMD ||
+			     conn->state == IIOD_BIN_READING_LEN)) {
+		flush = iiod_send_blocks(desc, conn);
+		if (flush != -EAGAIN && NO_OS_IS_ERR_VALUE(flush))
+			ret = flush;
+	}
+
+out_flush:
+	/* The responses of all the commands above in one transaction */
+	flush = iiod_flush(desc, conn);
+	if (flush != -EAGAIN && NO_OS_IS_ERR_VALUE(flush))
+		ret = flush;
+out:
+	NO_OS_TRACE_EXIT(NO_OS_TRACE_IIOD_CONN_STEP);
 
 	return ret;
 }
+
+/*
+ * A connection is idle when it waits for data from its client. Responses left
+ * in tx_buf don't count, they are only waiting for room in the socket.
+ */
+static bool iiod_conn_idle(struct iiod_conn_priv *conn)
+{
+	uint32_t i;
+
+	if (conn->rx_idx != conn->rx_len || conn->blk)
+		return false;
+
+	if (conn->state != IIOD_READING_LINE &&
+	    conn->state != IIOD_BIN_READING_CMD &&
+	    conn->state != IIOD_BIN_READING_LEN &&
+	    conn->state != IIOD_BIN_READING_DATA)
+		return false;
+
+	for (i = 0; i < IIOD_MAX_EVSTREAMS; i++)
+		if (conn->evstreams[i].used && conn->evstreams[i].pending)
+			return false;
+
+	for (i = 0; i < IIOD_MAX_BUFFERS; i++)
+		if (conn->buffers[i].used && conn->buffers[i].pending)
+			return false;
+
+	return true;
+}
+
+bool iiod_idle(struct iiod_desc *desc)
+{
+	uint32_t i;
+
+	if (!desc)
+		return false;
+
+	for (i = 0; i < desc->max_conns; i++)
+		if (desc->conns[i] && !iiod_conn_idle(desc->conns[i]))
+			return false;
+
+	return true;
+}
+
+int32_t iiod_get_cmd_stats(struct iiod_desc *desc, uint32_t idx,
+			   const char **name, struct iiod_cmd_stats *stats)
+{
+#ifdef IIO_STATS
+	if (!desc || !name || !stats)
+		return -EINVAL;
+
+	if (idx >= NO_OS_ARRAY_SIZE(desc->cmd_stats))
+		return -ENOENT;
+
+	*name = cmds[idx].str;
+	*stats = desc->cmd_stats[idx];
+
+	return 0;
+#else
+	return -ENOSYS;
+#endif
+}
+
+void iiod_reset_cmd_stats(struct iiod_desc *desc)
+{
+#ifdef IIO_STATS
+	if (desc)
+		memset(desc->cmd_stats, 0, sizeof(desc->cmd_stats));
+#endif
+}
@@ -43,7 +43,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 
-/* Maximum nomber of iiod connections to allocate simultaneously */
+/* Default maximum number of iiod connections at the same time */
 #define IIOD_MAX_CONNECTIONS	10
 #define IIOD_VERSION		"1.1.0000000"
 #define IIOD_VERSION_LEN	(sizeof(IIOD_VERSION) - 1)
@@ -72,6 +72,35 @@ struct iiod_attr {
 	const char *channel;
 };
 
+/*
+ * Attribute identification used by the binary protocol.
+ * Indexes follow the order of the context xml: devices are numbered first and
+ * triggers after them, channels and attributes in the order they are listed in
+ * their device. For channel attributes type is IIO_ATTR_TYPE_CH_IN, the
+ * direction is the one of the indexed channel. The direct register access
+ * attribute is the last debug attribute.
+ */
+struct iiod_attr_idx {
+	enum iio_attr_type type;
+	uint32_t dev;
+	uint32_t channel;
+	uint32_t attr;
+};
+
+/* Buffer of a sendv */
+struct iiod_iovec {
+	const void *base;
+	uint32_t len;
+};
+
+/* Event delivered to a binary client, as struct iio_event of libiio */
+struct iiod_event {
+	/* Identifier, in the Linux IIO format */
+	uint64_t id;
+	/* Time of the event in nanoseconds */
+	int64_t timestamp;
+};
+
 struct iiod_ctx {
 	/* Value specified in iiod_init_param.instance in iiod_init */
 	void *instance;
@@ -86,6 +115,11 @@ struct iiod_conn_data {
 	char *buf;
 	/* Size of the provided buffer. It must fit the max attribute size */
 	uint32_t len;
+	/*
+	 * Share of iiod_init_param.step_quota given to this connection in each
+	 * iiod_conn_step. 0 is handled as 1.
+	 */
+	uint32_t weight;
 };
 
 /* Functions should return a negative error code on failure */
@@ -101,6 +135,13 @@ struct iiod_ops {
 	 */
 	int (*send)(struct iiod_ctx *ctx, uint8_t *buf, uint32_t len);
 	int (*recv)(struct iiod_ctx *ctx, uint8_t *buf, uint32_t len);
+	/*
+	 * Optional. Same as send, for the iovcnt buffers of iov one after the
+	 * other. Used to send the READBUF response header together with the
+	 * data, without copying them in a single buffer.
+	 */
+	int (*sendv)(struct iiod_ctx *ctx, const struct iiod_iovec *iov,
+		     uint32_t iovcnt);
 
 	/*
 	 * This is the equivalent of libiio iio_device_create_buffer.
@@ -118,8 +159,23 @@ struct iiod_ops {
 	/* Read data from opened buffer */
 	int (*read_buffer)(struct iiod_ctx *ctx, const char *device, char *buf,
 			   uint32_t bytes);
-	/* Called to notify that buffer must be refiiled */
+	/*
+	 * Called to notify that buffer must be refiiled.
+	 * It can return -EAGAIN if the data is not ready yet, without
+	 * blocking. It will be called again until it returns something else.
+	 */
 	int (*refill_buffer)(struct iiod_ctx *ctx, const char *device);
+	/*
+	 * Optional zero-copy alternative to read_buffer.
+	 * Set in addr the address of at maximum bytes of data from the opened
+	 * buffer and return the number of bytes available there. iiod sends
+	 * the data directly from addr and then calls read_buffer_block_done
+	 * to release it. Both must be set in order to be used.
+	 */
+	int (*read_buffer_block)(struct iiod_ctx *ctx, const char *device,
+				 void **addr, uint32_t bytes);
+	/* Release the data obtained with read_buffer_block */
+	int (*read_buffer_block_done)(struct iiod_ctx *ctx, const char *device);
 
 	/* Write data to opened buffer */
 	int (*write_buffer)(struct iiod_ctx *ctx, const char *device,
@@ -146,10 +202,60 @@ struct iiod_ops {
 	int (*set_trigger)(struct iiod_ctx *ctx, const char *device,
 			   const char *trigger, uint32_t len);
 
+	/*
+	 * Binary protocol equivalents of read_attr and write_attr.
+	 * The attribute is identified by indexes instead of names.
+	 */
+	int (*read_attr_idx)(struct iiod_ctx *ctx, struct iiod_attr_idx *attr,
+			     char *buf, uint32_t len);
+	int (*write_attr_idx)(struct iiod_ctx *ctx, struct iiod_attr_idx *attr,
+			      char *buf, uint32_t len);
+	/*
+	 * Binary protocol. Return the device index of the trigger of dev or
+	 * -ENOENT if no trigger is set.
+	 */
+	int (*get_trigger_idx)(struct iiod_ctx *ctx, uint32_t dev);
+	/* Binary protocol. Set trigger of dev. If trig is negative, remove it */
+	int (*set_trigger_idx)(struct iiod_ctx *ctx, uint32_t dev, int32_t trig);
+
+	/*
+	 * Optional, binary protocol. Open an event stream of dev: set in seq
+	 * the position of the next event the device will post. Return -ENOENT
+	 * if the device has no events.
+	 */
+	int (*open_evstream)(struct iiod_ctx *ctx, uint32_t dev, uint32_t *seq);
+	/*
+	 * Optional, binary protocol. Fill event with the event of dev at
+	 * position seq and advance seq, skipping the events already dropped.
+	 * Return -EAGAIN, without blocking, if no event was posted there yet.
+	 */
+	int (*read_event)(struct iiod_ctx *ctx, uint32_t dev, uint32_t *seq,
+			  struct iiod_event *event);
+
+	/*
+	 * Optional, binary protocol. Needed by the buffer commands, that use
+	 * the ASCII buffer ops with the name of the device set here in device.
+	 * Set tx if the channels of mask are output channels and return the
+	 * size in bytes of a scan of them.
+	 */
+	int (*get_buffer_info)(struct iiod_ctx *ctx, uint32_t dev,
+			       uint32_t mask, const char **device, bool *tx);
+
+	/*
+	 * Used when iiod_init_param.xml is NULL. Write in buf at maximum len
+	 * bytes of the context xml, starting from offset, and return the
+	 * number of bytes written.
+	 */
+	int (*read_xml)(struct iiod_ctx *ctx, uint32_t offset, char *buf,
+			uint32_t len);
+
 	/* I don't know what this should be used for :) */
 	int (*set_timeout)(struct iiod_ctx *ctx, uint32_t timeout);
 
-	/* I don't know what this should be used for :) */
+	/*
+	 * Set the number of blocks of the buffer size (given at open) that
+	 * the device buffer must be able to hold. Called before open.
+	 */
 	int (*set_buffers_count)(struct iiod_ctx *ctx, const char *device,
 				 uint32_t buffers_count);
 };
@@ -160,6 +266,23 @@ struct iiod_ops {
  */
 struct iiod_desc;
 
+/* Number of buckets of iiod_cmd_stats.hist */
+#define IIOD_LAT_BUCKETS	7
+
+/*
+ * Latency of the commands of a kind, from the reception of their line, or
+ * binary header, to the end of their response. Collected when IIO_STATS is
+ * defined. Binary commands are counted with their ASCII equivalent.
+ */
+struct iiod_cmd_stats {
+	/* Number of completed commands */
+	uint32_t count;
+	/* Longest latency in microseconds */
+	uint32_t max_us;
+	/* Bucket i counts latencies under 10^(i + 1) us, the last the rest */
+	uint32_t hist[IIOD_LAT_BUCKETS];
+};
+
 /* Parameter to initialize iiod_desc */
 struct iiod_init_param {
 	struct iiod_ops *ops;
@@ -167,11 +290,25 @@ struct iiod_init_param {
 	void *instance;
 	/*
 	 * Xml description of the context and devices. It should exist until
-	 * iiod_remove is called
+	 * iiod_remove is called.
+	 * If NULL, the xml is obtained in chunks with read_xml when it is sent.
 	 */
 	char *xml;
 	/* Size of xml in bytes */
 	uint32_t xml_len;
+	/*
+	 * Maximum number of bytes of buffer data (READBUF and WRITEBUF) that a
+	 * connection transfers in one iiod_conn_step. When it is used, the
+	 * step returns -EAGAIN and the transfer continues in the next one, so
+	 * other connections are served in between. 0 means no limit.
+	 */
+	uint32_t step_quota;
+	/*
+	 * Maximum number of connections at the same time. The state of a
+	 * connection is only allocated between iiod_conn_add and
+	 * iiod_conn_remove. 0 for IIOD_MAX_CONNECTIONS.
+	 */
+	uint32_t max_connections;
 };
 
 /* Initialize desc. */
@@ -190,5 +327,19 @@ int32_t iiod_conn_remove(struct iiod_desc *desc, uint32_t conn_id,
 			 struct iiod_conn_data *data);
 /* Advance in the state machine of a connection. Will not block */
 int32_t iiod_conn_step(struct iiod_desc *desc, uint32_t conn_id);
+/*
+ * Check if no connection has work left without new data from its client, so
+ * the caller can sleep until the transport is ready.
+ */
+bool iiod_idle(struct iiod_desc *desc);
+
+/*
+ * Get the name and the latency statistics of the idx-th command kind. Returns
+ * -ENOENT after the last one and -ENOSYS without IIO_STATS.
+ */
+int32_t iiod_get_cmd_stats(struct iiod_desc *desc, uint32_t idx,
+			   const char **name, struct iiod_cmd_stats *stats);
+/* Clear the latency statistics of all the commands */
+void iiod_reset_cmd_stats(struct iiod_desc *desc);
 
 #endif //IIOD_H
@@ -43,7 +43,27 @@
 #define IIOD_WR				0x1
 #define IIOD_ENDL			0x2
 #define IIOD_RD				0x4
+#ifndef IIOD_PARSER_MAX_BUF_SIZE
 #define IIOD_PARSER_MAX_BUF_SIZE	128
+#endif
+/* Bytes read ahead from a connection, several commands can fit */
+#ifndef IIOD_RX_BUF_SIZE
+#define IIOD_RX_BUF_SIZE		256
+#endif
+/* Bytes of small responses gathered in a single send */
+#ifndef IIOD_TX_BUF_SIZE
+#define IIOD_TX_BUF_SIZE		256
+#endif
+
+/* Event streams a connection can have open at the same time */
+#ifndef IIOD_MAX_EVSTREAMS
+#define IIOD_MAX_EVSTREAMS		4
+#endif
+
+/* Buffers of the binary protocol a connection can stream at the same time */
+#ifndef IIOD_MAX_BUFFERS
+#define IIOD_MAX_BUFFERS		4
+#endif
 
 #define IIOD_STR(cmd) {(cmd), sizeof(cmd) - 1}
 
@@ -75,12 +95,70 @@ enum iiod_cmd {
 	IIOD_CMD_WRITEBUF,
 	IIOD_CMD_GETTRIG,
 	IIOD_CMD_SETTRIG,
-	IIOD_CMD_SET
+	IIOD_CMD_SET,
+	IIOD_CMD_BINARY
+};
+
+/*
+ * Opcodes of the binary protocol, the one used by libiio v1 after the BINARY
+ * command is sent. ENQUEUE_BLOCK_CYCLIC and RETRY_DEQUEUE_BLOCK are not
+ * handled, cyclic buffers are only available through the ASCII commands.
+ */
+enum iiod_opcode {
+	IIOD_OP_RESPONSE,
+	IIOD_OP_PRINT,
+	IIOD_OP_TIMEOUT,
+	IIOD_OP_READ_ATTR,
+	IIOD_OP_READ_DBG_ATTR,
+	IIOD_OP_READ_BUF_ATTR,
+	IIOD_OP_READ_CHN_ATTR,
+	IIOD_OP_WRITE_ATTR,
+	IIOD_OP_WRITE_DBG_ATTR,
+	IIOD_OP_WRITE_BUF_ATTR,
+	IIOD_OP_WRITE_CHN_ATTR,
+	IIOD_OP_GETTRIG,
+	IIOD_OP_SETTRIG,
+	/*
+	 * Buffers, identified by the device and the lower 16 bits of code.
+	 * The upper 16 bits are the block index in the block commands.
+	 */
+	IIOD_OP_CREATE_BUFFER,
+	IIOD_OP_FREE_BUFFER,
+	IIOD_OP_ENABLE_BUFFER,
+	IIOD_OP_DISABLE_BUFFER,
+	IIOD_OP_CREATE_BLOCK,
+	IIOD_OP_FREE_BLOCK,
+	IIOD_OP_TRANSFER_BLOCK,
+	IIOD_OP_ENQUEUE_BLOCK_CYCLIC,
+	IIOD_OP_RETRY_DEQUEUE_BLOCK,
+	/* Event streams, identified by the client_id of the commands */
+	IIOD_OP_CREATE_EVSTREAM,
+	IIOD_OP_FREE_EVSTREAM,
+	IIOD_OP_READ_EVENT,
+};
+
+/*
+ * Header of each binary command and response.
+ * Responses have IIOD_OP_RESPONSE as op and the client_id of the command, so
+ * a client can have several commands in flight. code is the attribute index
+ * (channel index in the upper 16 bits for channel attributes) in commands and
+ * the return value or the length of the data that follows in responses.
+ * Write commands are followed by a 64 bit length and the data: the channel
+ * mask for CREATE_BUFFER, the 64 bit size of the block for CREATE_BLOCK. For
+ * TRANSFER_BLOCK the length is the number of bytes to be transferred and the
+ * data only follows for output buffers.
+ */
+struct iiod_command {
+	uint16_t client_id;
+	uint8_t op;
+	uint8_t dev;
+	int32_t code;
 };
 
 /*
  * Structure to be filled after a command is parsed.
- * Depending of cmd some fields are set or not
+ * Depending of cmd some fields are set or not. The strings point in the parsed
+ * line, they are valid until the next line is read.
  */
 struct comand_desc {
 	enum iiod_cmd cmd;
@@ -90,10 +168,10 @@ struct comand_desc {
 	uint32_t bytes_count;
 	uint32_t count;
 	bool cyclic;
-	char device[MAX_DEV_ID];
-	char channel[MAX_CHN_ID];
-	char attr[MAX_ATTR_NAME];
-	char trigger[MAX_TRIG_ID];
+	const char *device;
+	const char *channel;
+	const char *attr;
+	const char *trigger;
 	enum iio_attr_type type;
 };
 
@@ -111,14 +189,74 @@ struct iiod_run_cmd_result {
 	bool write_val;
 	/* If buf.len != 0 buf has to be sent */
 	struct iiod_buff buf;
+	/* If set, the xml has to be sent in chunks obtained with read_xml */
+	bool stream_xml;
+	/* If set, there is no response now. Used by a waiting READ_EVENT */
+	bool deferred;
+};
+
+/*
+ * Event stream opened by a binary client. READ_EVENT is answered as soon as an
+ * event is posted, without blocking the other commands of the connection.
+ */
+struct iiod_evstream {
+	/* Set while the stream is open */
+	bool used;
+	/* Set while a READ_EVENT waits for an event */
+	bool pending;
+	/* client_id of the CREATE_EVSTREAM command */
+	uint16_t client_id;
+	/* Device of the stream */
+	uint8_t dev;
+	/* Position of the next event, see iiod_ops.read_event */
+	uint32_t seq;
+	/* Event being sent */
+	struct iiod_event event;
+};
+
+/*
+ * Buffer created by a binary client. Several ones can stream at the same time
+ * on a connection and the blocks of input buffers are sent as soon as their
+ * device filled them, in turns, without blocking the other commands.
+ */
+struct iiod_bin_buffer {
+	/* Set between CREATE_BUFFER and FREE_BUFFER */
+	bool used;
+	/* Set between ENABLE_BUFFER and DISABLE_BUFFER, the device is open */
+	bool enabled;
+	/* Set for a buffer of output channels */
+	bool tx;
+	/* Device of the buffer */
+	uint8_t dev;
+	/* Index of the buffer in the device */
+	uint16_t idx;
+	/* Name of the device in the iiod_ops buffer functions */
+	const char *device;
+	/* Active channels */
+	uint32_t mask;
+	/* Size in bytes of a scan of the active channels */
+	uint32_t scan_size;
+	/* Size of the blocks, given at CREATE_BLOCK */
+	uint32_t block_size;
+	/* Number of blocks created */
+	uint32_t nb_blocks;
+	/* Set while the TRANSFER_BLOCK of an input buffer waits for data */
+	bool pending;
+	/* Set once refill_buffer succeeded for the pending transfer */
+	bool refilled;
+	/* Error to be answered to the pending transfer instead of the data */
+	int32_t err;
+	/* client_id and code of the pending TRANSFER_BLOCK */
+	uint16_t client_id;
+	int32_t code;
+	/* Bytes of the pending transfer still to be sent */
+	uint32_t bytes;
 };
 
 /* Internal structure to handle a connection state */
 struct iiod_conn_priv {
 	/* User instance of the connection to be sent in iiod_ctx */
 	void *conn;
-	/* Unset when can be used from the connection pool */
-	bool used;
 
 	/* Command data after parsed */
 	struct comand_desc cmd_data;
@@ -140,33 +278,99 @@ struct iiod_conn_priv {
 		IIOD_LINE_DONE,
 		/* Pushing  cyclic buffer until IIO device is closed  */
 		IIOD_PUSH_CYCLIC_BUFFER,
+		/* Reading the header of a binary command */
+		IIOD_BIN_READING_CMD,
+		/* Reading the length of the data of a binary write command */
+		IIOD_BIN_READING_LEN,
+		/* Reading the data of a binary write command */
+		IIOD_BIN_READING_DATA,
+		/* Execute binary cmd without I/O operations */
+		IIOD_BIN_RUNNING_CMD,
+		/* Write response header and data of a binary cmd */
+		IIOD_BIN_WRITING_RESULT,
+		/* Transfer the data of a block of an output buffer */
+		IIOD_BIN_WRITING_BLOCK,
 	} state;
 
+	/* Set after the BINARY command. Commands are not lines anymore */
+	bool binary;
+	/* Binary command being processed */
+	struct iiod_command bin_cmd;
+	/* Response to bin_cmd */
+	struct iiod_command bin_res;
+	/* Bytes of write data still to be received */
+	uint64_t bin_len;
+	/* Offset in the xml of the next chunk to be sent */
+	uint32_t xml_idx;
+	/* Event streams of the binary protocol */
+	struct iiod_evstream evstreams[IIOD_MAX_EVSTREAMS];
+	/* Buffers of the binary protocol */
+	struct iiod_bin_buffer buffers[IIOD_MAX_BUFFERS];
+	/* Buffer whose block is being sent, NULL if none */
+	struct iiod_bin_buffer *blk;
+	/* Index in buffers of the first one checked for the next block */
+	uint32_t blk_next;
+	/* Response to the TRANSFER_BLOCK of blk and its data */
+	struct iiod_command blk_res;
+	struct iiod_buff blk_hdr;
+	struct iiod_buff blk_data;
+	/* Multiplier of iiod_desc.step_quota */
+	uint32_t weight;
+	/* Bytes of buffer data that can still be transferred in this step */
+	uint32_t quota;
+#ifdef IIO_STATS
+	/* Kind of the command being processed, IIOD_STATS_NONE if none */
+	uint32_t stats_cmd;
+	/* Time in microseconds at which the command was received */
+	uint32_t stats_start;
+#endif
+
 	/* Buffer to store received line */
 	char parser_buf[IIOD_PARSER_MAX_BUF_SIZE];
 	/* Index in parser_buf. For nonblocking operation */
 	uint32_t parser_idx;
+	/* Data received and not processed yet, from rx_idx to rx_len */
+	char rx_buf[IIOD_RX_BUF_SIZE];
+	uint32_t rx_idx;
+	uint32_t rx_len;
+	/* Responses not sent yet, from tx_idx to tx_len. Sent by iiod_flush */
+	char tx_buf[IIOD_TX_BUF_SIZE];
+	uint32_t tx_idx;
+	uint32_t tx_len;
 	/* Buffer to store raw data (attributes or buffer data).*/
 	char *payload_buf;
 	/* Length of payload_buf_len */
 	uint32_t payload_buf_len;
 	/* Used in nonbloking transfers to save indexes */
 	struct iiod_buff nb_buf;
+	/* Set while nb_buf holds a block obtained with read_buffer_block */
+	bool nb_buf_block;
 
 	/* Mask of current opened buffer */
 	uint32_t mask;
 	/* Buffer to store mask as a string */
 	char buf_mask[10];
+	/*
+	 * Result value as text. For READBUF, the response header sent with
+	 * sendv together with the data.
+	 */
+	char res_str[24];
+	/* Indexes in readbuf_hdr. Nothing to send if idx == len */
+	struct iiod_buff hdr_buf;
 	/* Context for strtok_r function */
 	char *strtok_ctx;
 	/* True if the device was open with cyclic buffer flag */
 	bool is_cyclic_buffer;
+	/* Device of the cyclic buffer being pushed */
+	const char *cyclic_device;
 };
 
 /* Private iiod information */
 struct iiod_desc {
-	/* Pool of iiod connections */
-	struct iiod_conn_priv conns[IIOD_MAX_CONNECTIONS];
+	/* State of the connections, NULL for the free slots */
+	struct iiod_conn_priv **conns;
+	/* Number of slots in conns */
+	uint32_t max_conns;
 	/* Application operations */
 	struct iiod_ops ops;
 	/* Application instance */
@@ -175,6 +379,15 @@ struct iiod_desc {
 	char *xml;
 	/* XML length in bytes */
 	uint32_t xml_len;
+	/* Bytes of buffer data per connection step. 0 for no limit */
+	uint32_t step_quota;
+#ifdef IIO_STATS
+	/* Latency statistics, by enum iiod_cmd */
+	struct iiod_cmd_stats cmd_stats[IIOD_CMD_BINARY + 1];
+#endif
 };
 
+/* Parse a line of the text protocol into res. buf is modified. */
+int32_t iiod_parse_line(char *buf, struct comand_desc *res, char **ctx);
+
 #endif //IIOD_PRIVATE_H
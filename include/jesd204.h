@@ -215,10 +215,15 @@ enum jesd204_dev_op {
 	__JESD204_MAX_OPS,
 };
 
+typedef void (*jesd204_poll_cb)(struct jesd204_dev *jdev);
+
 /**
  * @struct jesd204_dev_data
  * @brief JESD204 device initialization data
  * @param sysref_cb:		SYSREF callback, if this device/driver supports it
+ * @param poll_cb:		called while the FSM waits for the state ops of
+ *				this device that returned JESD204_STATE_CHANGE_DEFER,
+ *				if the device has no interrupt to complete them
  * @param sizeof_priv:		amount of data to allocate for private information
  * @param max_num_links:	maximum number of JESD204 links this device can support
  * @param num_retries:		number of retries in case of error (only for top-level device)
@@ -226,6 +231,7 @@ enum jesd204_dev_op {
  */
 struct jesd204_dev_data {
 	jesd204_sysref_cb			sysref_cb;
+	jesd204_poll_cb				poll_cb;
 	size_t					sizeof_priv;
 	unsigned int				max_num_links;
 	unsigned int				num_retries;
@@ -272,6 +278,13 @@ int jesd204_fsm_start(struct jesd204_topology *topology, unsigned int link_idx);
 /* no-OS specific */
 int jesd204_fsm_stop(struct jesd204_topology *topology, unsigned int link_idx);
 
+/* no-OS specific */
+int jesd204_fsm_invalidate(struct jesd204_topology *topology,
+			   unsigned int link_idx);
+
+/* no-OS specific */
+void jesd204_fsm_op_done(struct jesd204_dev *jdev, int ret);
+
 void *jesd204_dev_priv(struct jesd204_dev *jdev);
 
 int jesd204_link_get_lmfc_lemc_rate(struct jesd204_link *lnk,
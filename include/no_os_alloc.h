@@ -0,0 +1,226 @@
+/***************************************************************************//**
+ *   @file   no_os_alloc.h
+ *   @brief  Header file of the memory allocation API.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef _NO_OS_ALLOC_H_
+#define _NO_OS_ALLOC_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/*
+ * With NO_OS_STATIC_ALLOC defined, no_os_malloc/calloc are served from a
+ * static arena of NO_OS_ARENA_SIZE bytes instead of the heap.
+ */
+#ifndef NO_OS_ARENA_SIZE
+#define NO_OS_ARENA_SIZE	16384
+#endif
+
+/*
+ * Alignment and size granularity of no_os_dma_alloc, at least the data cache
+ * line size, so a DMA buffer never shares a line with other data.
+ */
+#ifndef NO_OS_DMA_ALIGN
+#define NO_OS_DMA_ALIGN		64
+#endif
+
+/*
+ * With NO_OS_ALLOC_STATS defined, the allocations are counted by call site, in
+ * up to NO_OS_ALLOC_STATS_SITES sites, the others sharing a last entry.
+ */
+#ifndef NO_OS_ALLOC_STATS_SITES
+#define NO_OS_ALLOC_STATS_SITES		16
+#endif
+
+/* Stacks registered with no_os_stack_register */
+#ifndef NO_OS_ALLOC_STATS_STACKS
+#define NO_OS_ALLOC_STATS_STACKS	4
+#endif
+
+/* Largest block tried by the heap probe of no_os_alloc_get_stats */
+#ifndef NO_OS_ALLOC_STATS_PROBE_MAX
+#define NO_OS_ALLOC_STATS_PROBE_MAX	131072
+#endif
+
+/* Length of the longest line written by no_os_alloc_stats_print, with '\0' */
+#define NO_OS_ALLOC_STATS_LINE_SIZE	64
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+struct no_os_uart_desc;
+
+/**
+ * @enum no_os_dma_dir
+ * @brief Direction of the data of a DMA buffer, picking the cache maintenance
+ * of no_os_dma_sync_for_device and no_os_dma_sync_for_cpu.
+ */
+enum no_os_dma_dir {
+	/** Written by the CPU, read by the device */
+	NO_OS_DMA_TO_DEVICE,
+	/** Written by the device, read by the CPU */
+	NO_OS_DMA_FROM_DEVICE,
+	/** Both */
+	NO_OS_DMA_BIDIRECTIONAL,
+};
+
+/**
+ * @struct no_os_arena_stats
+ * @brief Usage of the static arena.
+ */
+struct no_os_arena_stats {
+	/** Total size of the arena in bytes */
+	size_t size;
+	/** Bytes currently allocated */
+	size_t used;
+	/** Maximum number of bytes allocated at the same time */
+	size_t high_watermark;
+};
+
+/**
+ * @struct no_os_alloc_stats
+ * @brief Usage of no_os_malloc and no_os_calloc, with NO_OS_ALLOC_STATS.
+ */
+struct no_os_alloc_stats {
+	/** Bytes currently allocated, as requested by the callers */
+	size_t used;
+	/** Maximum number of bytes allocated at the same time */
+	size_t peak;
+	/** Size of the largest block that can still be allocated */
+	size_t largest_free;
+	/** Number of successful allocations */
+	uint32_t allocs;
+	/** Number of frees */
+	uint32_t frees;
+	/** Number of allocations that failed */
+	uint32_t failed;
+};
+
+/**
+ * @struct no_os_pool
+ * @brief Pool of fixed size blocks, for objects allocated and freed at
+ * runtime. The memory of the pool is obtained once, with no_os_calloc.
+ */
+struct no_os_pool {
+	/** Memory of all the blocks */
+	uint8_t *mem;
+	/** First free block, each free block stores the next one */
+	void *free_list;
+	/** Size of a block in bytes */
+	uint32_t block_size;
+	/** Number of blocks */
+	uint32_t nb_blocks;
+	/** Blocks currently allocated */
+	uint32_t in_use;
+	/** Maximum number of blocks allocated at the same time */
+	uint32_t high_watermark;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Allocate size bytes, from the heap or the static arena. */
+void *no_os_malloc(size_t size);
+
+/* Allocate nitems * size zeroed bytes, from the heap or the static arena. */
+void *no_os_calloc(size_t nitems, size_t size);
+
+/* Free memory obtained with no_os_malloc or no_os_calloc. */
+void no_os_free(void *ptr);
+
+/* Get the usage of the static arena. */
+int32_t no_os_arena_get_stats(struct no_os_arena_stats *stats);
+
+/* Get the allocation counters, -ENOSYS without NO_OS_ALLOC_STATS. */
+int32_t no_os_alloc_get_stats(struct no_os_alloc_stats *stats);
+
+/* Restart the peak and the counters, painting the current stack again. */
+void no_os_alloc_reset_stats(void);
+
+/* Format the counters, the call sites and the stacks, one per line. */
+int32_t no_os_alloc_stats_print(char *buf, uint32_t len);
+
+/* Write the lines of no_os_alloc_stats_print on a UART. */
+int32_t no_os_alloc_stats_dump(struct no_os_uart_desc *uart);
+
+/* Paint the unused part of a stack to measure its high water mark. */
+int32_t no_os_stack_register(const char *name, void *base, size_t size);
+
+/* Allocate the memory of a pool of nb_blocks blocks of block_size bytes. */
+int32_t no_os_pool_init(struct no_os_pool *pool, uint32_t block_size,
+			uint32_t nb_blocks);
+
+/* Free the memory of a pool. */
+void no_os_pool_remove(struct no_os_pool *pool);
+
+/* Get a zeroed block from the pool, NULL if all the blocks are used. */
+void *no_os_pool_alloc(struct no_os_pool *pool);
+
+/* Return a block to the pool. */
+void no_os_pool_free(struct no_os_pool *pool, void *ptr);
+
+/* Allocate size zeroed bytes aligned on NO_OS_DMA_ALIGN, for DMA. */
+void *no_os_dma_alloc(size_t size);
+
+/* Free memory obtained with no_os_dma_alloc. */
+void no_os_dma_free(void *ptr);
+
+/* Hand a DMA buffer over to the device, before the transfer is started. */
+void no_os_dma_sync_for_device(void *addr, size_t size,
+			       enum no_os_dma_dir dir);
+
+/* Hand a DMA buffer back to the CPU, after the transfer is done. */
+void no_os_dma_sync_for_cpu(void *addr, size_t size, enum no_os_dma_dir dir);
+
+/*
+ * Data cache maintenance of the platform, on whole lines. The defaults do
+ * nothing, for the platforms without data cache.
+ */
+void no_os_dcache_clean_range(uintptr_t addr, size_t size);
+void no_os_dcache_invalidate_range(uintptr_t addr, size_t size);
+void no_os_dcache_flush_range(uintptr_t addr, size_t size);
+
+#endif // _NO_OS_ALLOC_H_
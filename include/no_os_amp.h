@@ -0,0 +1,143 @@
+/***************************************************************************//**
+ *   @file   no_os_amp.h
+ *   @brief  Header file of the link between the cores of an AMP system.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef _NO_OS_AMP_H_
+#define _NO_OS_AMP_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include "no_os_lffifo.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Messages that fit in each direction of a link, must be a power of 2 */
+#ifndef NO_OS_AMP_RING_DEPTH
+#define NO_OS_AMP_RING_DEPTH	32
+#endif
+
+/* Written last by no_os_amp_link_init, once the rings can be used */
+#define NO_OS_AMP_MAGIC		0x414d5031
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @enum no_os_amp_cmd
+ * @brief Meaning of a message.
+ */
+enum no_os_amp_cmd {
+	/** Request: fill count blocks of size bytes from addr, in a loop */
+	NO_OS_AMP_CMD_START,
+	/** Request: stop filling the blocks */
+	NO_OS_AMP_CMD_STOP,
+	/** Response: the block at addr was filled */
+	NO_OS_AMP_CMD_BLOCK,
+	/** Response: the blocks are no longer filled */
+	NO_OS_AMP_CMD_STOPPED,
+	/** Response: the request failed with the error code in count */
+	NO_OS_AMP_CMD_ERROR,
+};
+
+/**
+ * @struct no_os_amp_msg
+ * @brief Descriptor exchanged between the cores.
+ */
+struct no_os_amp_msg {
+	/** One of enum no_os_amp_cmd */
+	uint32_t cmd;
+	/** Address of the memory, as seen by both cores */
+	uint32_t addr;
+	/** Size of a block in bytes */
+	uint32_t size;
+	/** Number of blocks */
+	uint32_t count;
+};
+
+/**
+ * @struct no_os_amp_link
+ * @brief Requests from the core running the application to the core owning a
+ * device, and responses back. It must be placed in memory shared by the
+ * cores, mapped at the same address and not cached, or coherent, on both.
+ * Each ring has a single producer and a single consumer, so no lock is
+ * needed between the cores.
+ */
+struct no_os_amp_link {
+	/** NO_OS_AMP_MAGIC once initialized */
+	volatile uint32_t magic;
+	/** Responses that did not fit in the response ring */
+	volatile uint32_t dropped;
+	/** Requests, written by the application core */
+	struct no_os_lffifo req;
+	/** Responses, written by the device core */
+	struct no_os_lffifo rsp;
+	struct no_os_amp_msg req_data[NO_OS_AMP_RING_DEPTH];
+	struct no_os_amp_msg rsp_data[NO_OS_AMP_RING_DEPTH];
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Initialize the link, before the other core is started. */
+int32_t no_os_amp_link_init(struct no_os_amp_link *link);
+
+/* Wait until the other core initialized the link. */
+int32_t no_os_amp_link_wait(struct no_os_amp_link *link, uint32_t timeout_ms);
+
+/* Send a request to the device core. */
+int32_t no_os_amp_request(struct no_os_amp_link *link,
+			  const struct no_os_amp_msg *msg);
+
+/* Get the next request, on the device core. */
+int32_t no_os_amp_get_request(struct no_os_amp_link *link,
+			      struct no_os_amp_msg *msg);
+
+/* Send a response to the application core. */
+int32_t no_os_amp_respond(struct no_os_amp_link *link,
+			  const struct no_os_amp_msg *msg);
+
+/* Get the next response, on the application core. */
+int32_t no_os_amp_get_response(struct no_os_amp_link *link,
+			       struct no_os_amp_msg *msg);
+
+#endif // _NO_OS_AMP_H_
@@ -45,15 +45,79 @@
 /******************************************************************************/
 
 #include <stdint.h>
+#if defined(ALTERA_PLATFORM)
+#include <io.h>
+#endif
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/*
+ * On Xilinx and Altera the register accesses are inline, the register loops
+ * of the AXI core drivers don't pay a call per access. The other platforms
+ * implement them in their axi_io.c.
+ */
+#if defined(XILINX_PLATFORM) || defined(ALTERA_PLATFORM)
+#define NO_OS_AXI_IO_INLINE
+#endif
 
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
 /******************************************************************************/
 
+#ifdef NO_OS_AXI_IO_INLINE
+/**
+ * @brief AXI IO read, a volatile 32-bit load. Nios II goes through the
+ * ldwio instruction of IORD_32DIRECT to bypass its data cache.
+ * @param base - Base address
+ * @param offset - Address offset
+ * @param data - variable where returned data is stored
+ * @return 0
+ */
+static inline int32_t no_os_axi_io_read(uint32_t base, uint32_t offset,
+					uint32_t *data)
+{
+#if defined(ALTERA_PLATFORM)
+	*data = IORD_32DIRECT(base, offset);
+#else
+	*data = *(volatile uint32_t *)((uintptr_t)base + offset);
+#endif
+
+	return 0;
+}
+
+/**
+ * @brief AXI IO write, a volatile 32-bit store.
+ * @param base - Base address
+ * @param offset - Address offset
+ * @param data - data to be written
+ * @return 0
+ */
+static inline int32_t no_os_axi_io_write(uint32_t base, uint32_t offset,
+					 uint32_t data)
+{
+#if defined(ALTERA_PLATFORM)
+	IOWR_32DIRECT(base, offset, data);
+#else
+	*(volatile uint32_t *)((uintptr_t)base + offset) = data;
+#endif
+
+	return 0;
+}
+#else
 /* AXI IO Read data */
 int32_t no_os_axi_io_read(uint32_t base, uint32_t offset, uint32_t *data);
 
 /* AXI IO Write data */
 int32_t no_os_axi_io_write(uint32_t base, uint32_t offset, uint32_t data);
+#endif
+
+/*
+ * Write nb_words consecutive words, for example a DMA buffer in DDR. The data
+ * is visible to the DMA when the function returns.
+ */
+int32_t no_os_axi_io_write_buf(uint32_t base, uint32_t offset,
+			       const uint32_t *data, uint32_t nb_words);
 
 #endif // _NO_OS_AXI_IO_H_
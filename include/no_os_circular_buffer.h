@@ -46,6 +46,7 @@
 /******************************************************************************/
 
 #include <stdint.h>
+#include <stdbool.h>
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -56,7 +57,10 @@
  * @brief Circular buffer pointer
  */
 struct no_os_cb_ptr {
-	/** Index of data in the buffer */
+	/**
+	 * Index of data in the buffer. In SPSC mode it is a free running byte
+	 * counter instead, the index being idx & (size - 1).
+	 */
 	uint32_t	idx;
 	/** Counts the number of times idx exceeds the liniar buffer */
 	uint32_t	spin_count;
@@ -79,6 +83,24 @@ struct no_os_circular_buffer {
 	struct no_os_cb_ptr	write;
 	/** Read pointer */
 	struct no_os_cb_ptr	read;
+	/**
+	 * Lock-free single producer single consumer mode. The writer and the
+	 * reader may run in different contexts (e.g. interrupt and main loop)
+	 * without a critical section. Writes never overwrite unread data.
+	 */
+	bool		spsc;
+};
+
+/**
+ * @struct no_os_cb_regions
+ * @brief Contiguous memory regions of a circular buffer. The second one
+ * continues from the start of the buffer, when the data wraps around.
+ */
+struct no_os_cb_regions {
+	/** Start of each region */
+	int8_t		*buf[2];
+	/** Size of each region in bytes, len[1] is 0 when there is no wrap */
+	uint32_t	len[2];
 };
 
 /******************************************************************************/
@@ -89,6 +111,10 @@ int32_t no_os_cb_init(struct no_os_circular_buffer **desc, uint32_t size);
 /* Configure cb structure with given parameters without memory allocation */
 int32_t no_os_cb_cfg(struct no_os_circular_buffer *desc, int8_t *buf,
 		     uint32_t size);
+/* no_os_cb_init/no_os_cb_cfg in SPSC mode. size must be a power of 2 */
+int32_t no_os_cb_spsc_init(struct no_os_circular_buffer **desc, uint32_t size);
+int32_t no_os_cb_spsc_cfg(struct no_os_circular_buffer *desc, int8_t *buf,
+			  uint32_t size);
 int32_t no_os_cb_remove(struct no_os_circular_buffer *desc);
 int32_t no_os_cb_size(struct no_os_circular_buffer *desc, uint32_t *size);
 
@@ -109,4 +135,14 @@ int32_t no_os_cb_prepare_async_read(struct no_os_circular_buffer *desc,
 				    uint32_t *raw_size_avilable);
 int32_t no_os_cb_end_async_read(struct no_os_circular_buffer *desc);
 
+/* Zero-copy access to the buffer memory, in at most two contiguous regions */
+int32_t no_os_cb_peek_write(struct no_os_circular_buffer *desc, uint32_t size,
+			    struct no_os_cb_regions *regions);
+int32_t no_os_cb_commit_write(struct no_os_circular_buffer *desc,
+			      uint32_t size);
+int32_t no_os_cb_peek_read(struct no_os_circular_buffer *desc, uint32_t size,
+			   struct no_os_cb_regions *regions);
+int32_t no_os_cb_commit_read(struct no_os_circular_buffer *desc,
+			     uint32_t size);
+
 #endif //_NO_OS_CIRCULAR_BUFFER_H_
@@ -43,6 +43,17 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdint.h>
+#include <stdbool.h>
+#include "no_os_util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+/*
+ * Ask the provider for the rate at each no_os_clk_recalc_rate(), for the
+ * clocks changed behind the back of the framework.
+ */
+#define NO_OS_CLK_GET_RATE_NOCACHE	NO_OS_BIT(0)
 
 /******************************************************************************/
 /************************* Structure Declarations *****************************/
@@ -56,6 +67,10 @@ struct no_os_clk_init_param {
 	const struct no_os_clk_platform_ops *platform_ops;
 	/**  CLK hardware device descriptor */
 	void		*dev_desc;
+	/** Clock feeding this one, NULL for a root of the tree */
+	struct no_os_clk_desc *parent;
+	/** NO_OS_CLK_* flags */
+	uint32_t	flags;
 };
 
 struct no_os_clk_hw {
@@ -87,8 +102,31 @@ typedef struct no_os_clk_desc {
 	const struct no_os_clk_platform_ops *platform_ops;
 	/**  CLK hardware device descriptor */
 	void		*dev_desc;
+	/** Clock feeding this one, NULL for a root of the tree */
+	struct no_os_clk_desc *parent;
+	/** First child, the others follow through next_sibling */
+	struct no_os_clk_desc *first_child;
+	struct no_os_clk_desc *next_sibling;
+	/** NO_OS_CLK_* flags */
+	uint32_t	flags;
+	/** Last rate read from the provider, valid while rate_valid is set */
+	uint64_t	rate;
+	bool		rate_valid;
+	/** Rate requested in a transaction, applied by its commit */
+	uint64_t	txn_rate;
+	bool		txn_pending;
+	struct no_os_clk_desc *txn_next;
 } no_os_clk_desc;
 
+/**
+ * @struct no_os_clk_txn
+ * @brief Set of rate changes applied together by no_os_clk_txn_commit().
+ */
+struct no_os_clk_txn {
+	/** Clocks with a pending rate, linked through txn_next */
+	struct no_os_clk_desc *head;
+};
+
 /**
  * @struct no_os_clk_platform_ops
  * @brief Structure holding CLK function pointers that point to the platform
@@ -141,4 +179,21 @@ int32_t no_os_clk_round_rate(struct no_os_clk_desc *desc,
 int32_t no_os_clk_set_rate(struct no_os_clk_desc *desc,
 			   uint64_t rate);
 
+/* Drop the cached rates of the clock and of the clocks it feeds. */
+void no_os_clk_invalidate(struct no_os_clk_desc *desc);
+
+/* Start an empty transaction. */
+void no_os_clk_txn_init(struct no_os_clk_txn *txn);
+
+/* Request a rate change, applied by no_os_clk_txn_commit(). */
+int32_t no_os_clk_txn_set_rate(struct no_os_clk_txn *txn,
+			       struct no_os_clk_desc *desc,
+			       uint64_t rate);
+
+/* Apply the rate changes of the transaction, parents first. */
+int32_t no_os_clk_txn_commit(struct no_os_clk_txn *txn);
+
+/* Drop the rate changes of the transaction. */
+void no_os_clk_txn_abort(struct no_os_clk_txn *txn);
+
 #endif // _NO_OS_CLK_H_
@@ -0,0 +1,90 @@
+/***************************************************************************//**
+ *   @file   no_os_conv.h
+ *   @brief  Raw to physical value conversion using precomputed multipliers.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef _NO_OS_CONV_H_
+#define _NO_OS_CONV_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct no_os_conv
+ * @brief Conversion of raw samples to (raw + offset) * num / den. The division
+ * is replaced by a multiplication with the reciprocal of den, computed once by
+ * no_os_conv_init.
+ */
+struct no_os_conv {
+	/** Offset added to the raw value before scaling */
+	int32_t offset;
+	/** Scale numerator */
+	int32_t num;
+	/** Scale denominator */
+	uint32_t den;
+	/** floor((2^64 - 1) / den) */
+	uint64_t recip;
+#ifdef NO_OS_CMSIS_DSP
+	/** num / den as q31_t fraction, for arm_scale_q31 */
+	int32_t q31_fract;
+	/** num / den = q31_fract * 2^q31_shift / 2^31 */
+	int8_t q31_shift;
+#endif
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Precompute the conversion to (raw + offset) * num / den. */
+int32_t no_os_conv_init(struct no_os_conv *conv, int32_t offset, int32_t num,
+			uint32_t den);
+
+/* Convert one sample, splitting the result in integer and fractional parts. */
+int64_t no_os_conv_frac(const struct no_os_conv *conv, int32_t raw,
+			int32_t *fractional);
+
+/* Convert nb samples, keeping the integer part of each result. */
+void no_os_conv_batch(const struct no_os_conv *conv, const int32_t *raw,
+		      int32_t *out, uint32_t nb);
+
+#endif // _NO_OS_CONV_H_
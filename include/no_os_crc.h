@@ -43,4 +43,64 @@
 #include "no_os_crc16.h"
 #include "no_os_crc24.h"
 
+/**
+ * @struct no_os_crc_init_param
+ * @brief Structure holding the parameters for CRC engine initialization.
+ */
+struct no_os_crc_init_param {
+	/** CRC width in bits, 8, 16 or 24 */
+	uint8_t width;
+	/** msb-first representation of the polynomial */
+	uint32_t polynomial;
+	/** CRC engine platform operations, no_os_crc_sw_ops for software */
+	const struct no_os_crc_platform_ops *platform_ops;
+	/** CRC engine extra parameters (platform specific) */
+	void *extra;
+};
+
+/**
+ * @struct no_os_crc_desc
+ * @brief Structure holding the CRC engine descriptor.
+ */
+struct no_os_crc_desc {
+	/** CRC width in bits */
+	uint8_t width;
+	/** msb-first representation of the polynomial */
+	uint32_t polynomial;
+	/** CRC engine platform operations */
+	const struct no_os_crc_platform_ops *platform_ops;
+	/** CRC engine extra parameters (platform specific) */
+	void *extra;
+};
+
+/**
+ * @struct no_os_crc_platform_ops
+ * @brief Structure holding CRC engine function pointers that point to the
+ * platform specific function.
+ */
+struct no_os_crc_platform_ops {
+	/** CRC engine initialization function pointer */
+	int32_t (*init)(struct no_os_crc_desc **,
+			const struct no_os_crc_init_param *);
+	/** CRC computation function pointer */
+	int32_t (*compute)(struct no_os_crc_desc *, const uint8_t *, size_t,
+			   uint32_t, uint32_t *);
+	/** CRC engine remove function pointer */
+	int32_t (*remove)(struct no_os_crc_desc *);
+};
+
+/* Software CRC engine, using the slicing-by-8 tables. */
+extern const struct no_os_crc_platform_ops no_os_crc_sw_ops;
+
+/* Initialize a CRC engine. */
+int32_t no_os_crc_init(struct no_os_crc_desc **desc,
+		       const struct no_os_crc_init_param *param);
+
+/* Compute the CRC over a buffer of data. */
+int32_t no_os_crc_compute(struct no_os_crc_desc *desc, const uint8_t *data,
+			  size_t len, uint32_t init, uint32_t *crc);
+
+/* Free the resources allocated by no_os_crc_init(). */
+int32_t no_os_crc_remove(struct no_os_crc_desc *desc);
+
 #endif // _NO_OS_CRC_H_
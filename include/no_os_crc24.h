@@ -44,12 +44,25 @@
 
 #define NO_OS_CRC24_TABLE_SIZE 256
 
+#ifndef NO_OS_CRC_SLICES
+/* Number of bytes processed at once by the slicing-by-8 functions */
+#define NO_OS_CRC_SLICES 8
+#endif
+
 #define NO_OS_DECLARE_CRC24_TABLE(_table) \
 	static uint32_t _table[NO_OS_CRC24_TABLE_SIZE]
 
+#define NO_OS_DECLARE_CRC24_SLICE_TABLE(_table) \
+	static uint32_t _table[NO_OS_CRC_SLICES][NO_OS_CRC24_TABLE_SIZE]
+
 void no_os_crc24_populate_msb(uint32_t * table, const uint32_t polynomial);
 uint32_t no_os_crc24(const uint32_t * table, const uint8_t *pdata,
 		     size_t nbytes,
 		     uint32_t crc);
 
+void no_os_crc24_populate_slice_msb(uint32_t table[][NO_OS_CRC24_TABLE_SIZE],
+				   const uint32_t polynomial);
+uint32_t no_os_crc24_slice8(const uint32_t table[][NO_OS_CRC24_TABLE_SIZE],
+			    const uint8_t *pdata, size_t nbytes, uint32_t crc);
+
 #endif // _NO_OS_CRC24_H_
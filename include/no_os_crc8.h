@@ -47,8 +47,23 @@
 #define NO_OS_DECLARE_CRC8_TABLE(_table) \
 	static uint8_t _table[NO_OS_CRC8_TABLE_SIZE]
 
+#ifndef NO_OS_CRC_SLICES
+/* Number of bytes processed at once by the slicing-by-8 functions */
+#define NO_OS_CRC_SLICES 8
+#endif
+
+#define NO_OS_DECLARE_CRC8_SLICE_TABLE(_table) \
+	static uint8_t _table[NO_OS_CRC_SLICES][NO_OS_CRC8_TABLE_SIZE]
+
+/* Precomputed table for polynomial 0x07 */
+extern const uint8_t no_os_crc8_table_07[NO_OS_CRC8_TABLE_SIZE];
+
 void no_os_crc8_populate_msb(uint8_t * table, const uint8_t polynomial);
 uint8_t no_os_crc8(const uint8_t * table, const uint8_t *pdata, size_t nbytes,
 		   uint8_t crc);
+void no_os_crc8_populate_slice_msb(uint8_t table[][NO_OS_CRC8_TABLE_SIZE],
+				   const uint8_t polynomial);
+uint8_t no_os_crc8_slice8(const uint8_t table[][NO_OS_CRC8_TABLE_SIZE],
+			  const uint8_t *pdata, size_t nbytes, uint8_t crc);
 
 #endif // _NO_OS_CRC8_H_
@@ -0,0 +1,130 @@
+/***************************************************************************//**
+ *   @file   no_os_dds.h
+ *   @brief  Header file of the fixed-point waveform synthesis.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef _NO_OS_DDS_H_
+#define _NO_OS_DDS_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define NO_OS_DDS_MAX_TONES	4
+
+/* Scale of a tone playing at full scale */
+#define NO_OS_DDS_FULL_SCALE	32768
+
+/* Phase word of an angle in degrees */
+#define NO_OS_DDS_PHASE_DEG(x)	((uint32_t)(((uint64_t)(x) << 32) / 360))
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @enum no_os_dds_format
+ * @brief Coding of the generated samples.
+ */
+enum no_os_dds_format {
+	NO_OS_DDS_TWOS_COMPLEMENT,
+	NO_OS_DDS_OFFSET_BINARY,
+};
+
+/**
+ * @struct no_os_dds_tone
+ * @brief Phase accumulator of a tone. A full turn is 2^32.
+ */
+struct no_os_dds_tone {
+	/** Phase increment per sample, see no_os_dds_ftw() */
+	uint32_t ftw;
+	/** Phase of the next sample */
+	uint32_t phase;
+	/** Amplitude, NO_OS_DDS_FULL_SCALE being the full scale */
+	uint16_t scale;
+};
+
+/**
+ * @struct no_os_dds
+ * @brief Sum of tones, generated for one output channel. The sum saturates
+ * at full scale.
+ */
+struct no_os_dds {
+	struct no_os_dds_tone tones[NO_OS_DDS_MAX_TONES];
+	/** Number of tones in use */
+	uint8_t nb_tones;
+	/** Resolution of the samples, up to 16 bits, right aligned */
+	uint8_t bits;
+	/** Coding of the samples */
+	enum no_os_dds_format format;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Phase increment of a tone of freq_hz sampled at fs_hz. */
+uint32_t no_os_dds_ftw(uint64_t freq_hz, uint64_t fs_hz);
+
+/* Phase increment of the closest tone with whole periods in nb_samples. */
+uint32_t no_os_dds_ftw_periodic(uint64_t freq_hz, uint64_t fs_hz,
+				uint32_t nb_samples);
+
+/* Initialize a generator without tones. */
+int32_t no_os_dds_init(struct no_os_dds *dds, uint8_t bits,
+		       enum no_os_dds_format format);
+
+/* Add a tone to the generator. */
+int32_t no_os_dds_add_tone(struct no_os_dds *dds, uint32_t ftw,
+			   uint32_t phase, uint16_t scale);
+
+/* Sine of a phase word, interpolated from no_os_sine_lut_16, in Q15. */
+int16_t no_os_dds_sin(uint32_t phase);
+
+/* Generate nb_samples samples, stride samples apart in buf. */
+void no_os_dds_generate(struct no_os_dds *dds, uint16_t *buf,
+			uint32_t nb_samples, uint32_t stride);
+
+/* Generate nb_samples scans of nb_ch interleaved channels, one dds each. */
+void no_os_dds_generate_interleaved(struct no_os_dds *dds, uint32_t nb_ch,
+				    uint16_t *buf, uint32_t nb_samples);
+
+#endif // _NO_OS_DDS_H_
@@ -67,4 +67,7 @@ void no_os_mdelay(uint32_t msecs);
 /* Get current time */
 struct no_os_time no_os_get_time(void);
 
+/* Get the monotonic time in nanoseconds, callable from interrupts. */
+uint64_t no_os_time_ns(void);
+
 #endif // _NO_OS_DELAY_H_
@@ -0,0 +1,231 @@
+/***************************************************************************//**
+ *   @file   no_os_dma.h
+ *   @brief  Header file of the platform independent DMA API.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef _NO_OS_DMA_H_
+#define _NO_OS_DMA_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @enum no_os_dma_xfer_type
+ * @brief Direction of a DMA transfer.
+ */
+enum no_os_dma_xfer_type {
+	/** Memory copy */
+	NO_OS_DMA_MEM_TO_MEM,
+	/** From memory to a peripheral register or stream */
+	NO_OS_DMA_MEM_TO_DEV,
+	/** From a peripheral register or stream to memory */
+	NO_OS_DMA_DEV_TO_MEM,
+};
+
+struct no_os_dma_ch;
+struct no_os_dma_desc;
+struct no_os_dma_platform_ops;
+
+/**
+ * @struct no_os_dma_xfer
+ * @brief DMA transfer, owned by the user until it is completed or aborted.
+ */
+struct no_os_dma_xfer {
+	/**
+	 * Source, the peripheral register for NO_OS_DMA_DEV_TO_MEM. NULL for
+	 * a stream without address, e.g. the AXI DMAC.
+	 */
+	void *src;
+	/** Destination, the peripheral register for NO_OS_DMA_MEM_TO_DEV */
+	void *dst;
+	/** Number of bytes */
+	uint32_t length;
+	/** Direction */
+	enum no_os_dma_xfer_type xfer_type;
+	/** Bytes moved by each access, 1, 2 or 4. 0 for 1 */
+	uint8_t width;
+	/**
+	 * Request line of the peripheral pacing the transfer (STM32 request,
+	 * MAX32 reqsel, pico DREQ). Not used by NO_OS_DMA_MEM_TO_MEM.
+	 */
+	uint32_t periph_req;
+	/**
+	 * Restart from the beginning of the buffers once the end is reached,
+	 * until no_os_dma_xfer_abort. xfer_complete_cb is called at each end.
+	 */
+	bool cyclic;
+	/**
+	 * Called from interrupt context when the transfer is done or failed,
+	 * optional
+	 */
+	void (*xfer_complete_cb)(struct no_os_dma_xfer *xfer, void *ctx);
+	void *ctx;
+	/**
+	 * Set by the core: 0 once the transfer is done, negative error code
+	 * if it failed. Valid in xfer_complete_cb and once the channel is not
+	 * busy.
+	 */
+	int32_t status;
+};
+
+/**
+ * @struct no_os_dma_ch
+ * @brief DMA channel, acquired by one user at a time.
+ */
+struct no_os_dma_ch {
+	/** Controller of the channel */
+	struct no_os_dma_desc *desc;
+	/** Index of the channel in the controller */
+	uint32_t id;
+	/** Set while the channel is acquired */
+	bool acquired;
+	/** Set from no_os_dma_xfer_start until the transfer is done */
+	volatile bool busy;
+	/** Transfer configured on the channel */
+	struct no_os_dma_xfer *xfer;
+	/** Channel extra parameters (platform specific) */
+	void *extra;
+};
+
+/**
+ * @struct no_os_dma_init_param
+ * @brief Structure holding the parameters for DMA controller initialization
+ */
+struct no_os_dma_init_param {
+	/** DMA controller ID */
+	uint32_t device_id;
+	/** Number of channels */
+	uint32_t num_ch;
+	const struct no_os_dma_platform_ops *platform_ops;
+	/** DMA extra parameters (platform specific) */
+	void *extra;
+};
+
+/**
+ * @struct no_os_dma_desc
+ * @brief Structure holding the DMA controller descriptor.
+ */
+struct no_os_dma_desc {
+	/** DMA controller ID */
+	uint32_t device_id;
+	/** Number of channels */
+	uint32_t num_ch;
+	/** Channels, allocated by no_os_dma_init */
+	struct no_os_dma_ch *channels;
+	const struct no_os_dma_platform_ops *platform_ops;
+	/** DMA extra parameters (platform specific) */
+	void *extra;
+};
+
+/**
+ * @struct no_os_dma_platform_ops
+ * @brief Structure holding DMA function pointers that point to the platform
+ * specific function. The driver calls no_os_dma_xfer_done() from its
+ * interrupt handler at the end of each transfer, or no_os_dma_xfer_error()
+ * if the transfer failed.
+ */
+struct no_os_dma_platform_ops {
+	/** DMA controller initialization, channels already allocated */
+	int32_t (*init)(struct no_os_dma_desc *,
+			const struct no_os_dma_init_param *);
+	/** DMA controller remove function pointer */
+	int32_t (*remove)(struct no_os_dma_desc *);
+	/** Optional, prepare the channel when it is acquired */
+	int32_t (*ch_acquire)(struct no_os_dma_ch *);
+	/** Optional, let the channel go when it is released */
+	int32_t (*ch_release)(struct no_os_dma_ch *);
+	/** Program ch->xfer on the channel, without starting it */
+	int32_t (*config_xfer)(struct no_os_dma_ch *);
+	/** Start the programmed transfer */
+	int32_t (*xfer_start)(struct no_os_dma_ch *);
+	/** Stop the transfer running on the channel */
+	int32_t (*xfer_abort)(struct no_os_dma_ch *);
+	/**
+	 * Optional, for channels used without interrupt: check the end of the
+	 * transfer and call no_os_dma_xfer_done() once it is there.
+	 */
+	void (*xfer_poll)(struct no_os_dma_ch *);
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Initialize a DMA controller and its channels. */
+int32_t no_os_dma_init(struct no_os_dma_desc **desc,
+		       const struct no_os_dma_init_param *param);
+
+/* Free the resources allocated by no_os_dma_init(). */
+int32_t no_os_dma_remove(struct no_os_dma_desc *desc);
+
+/* Get a free channel of the controller. */
+int32_t no_os_dma_acquire_ch(struct no_os_dma_desc *desc,
+			     struct no_os_dma_ch **ch);
+
+/* Give a channel back to the controller. */
+int32_t no_os_dma_release_ch(struct no_os_dma_ch *ch);
+
+/* Program a transfer on a channel. */
+int32_t no_os_dma_config_xfer(struct no_os_dma_ch *ch,
+			      struct no_os_dma_xfer *xfer);
+
+/* Start the transfer programmed on a channel. */
+int32_t no_os_dma_xfer_start(struct no_os_dma_ch *ch);
+
+/* Stop the transfer of a channel. */
+int32_t no_os_dma_xfer_abort(struct no_os_dma_ch *ch);
+
+/* Check if the transfer of a channel is done. */
+bool no_os_dma_is_completed(struct no_os_dma_ch *ch);
+
+/* Copy len bytes from src to dst with a free channel, waiting for the end. */
+int32_t no_os_dma_memcpy(struct no_os_dma_desc *desc, void *dst,
+			 const void *src, uint32_t len);
+
+/* End of transfer notification, called by the platform drivers. */
+void no_os_dma_xfer_done(struct no_os_dma_ch *ch);
+
+/* Transfer error notification, called by the platform drivers. */
+void no_os_dma_xfer_error(struct no_os_dma_ch *ch, int32_t err);
+
+#endif // _NO_OS_DMA_H_
@@ -96,6 +96,8 @@ struct no_os_eeprom_platform_ops {
 	int32_t (*read)(struct no_os_eeprom_desc *, uint32_t, uint8_t *, uint16_t);
 	/** EEPROM remove function pointer */
 	int32_t (*remove)(struct no_os_eeprom_desc *);
+	/** Optional, commit the writes held back by the driver */
+	int32_t (*flush)(struct no_os_eeprom_desc *);
 };
 
 /******************************************************************************/
@@ -114,6 +116,9 @@ int32_t no_os_eeprom_write(struct no_os_eeprom_desc *desc, uint32_t address,
 int32_t no_os_eeprom_read(struct no_os_eeprom_desc *desc, uint32_t address,
 			  uint8_t *data, uint16_t bytes);
 
+/* Commit the writes held back by the EEPROM driver */
+int32_t no_os_eeprom_flush(struct no_os_eeprom_desc *desc);
+
 /* Free the resources allocated by no_os_eeprom_init() */
 int32_t no_os_eeprom_remove(struct no_os_eeprom_desc *desc);
 
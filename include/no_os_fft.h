@@ -0,0 +1,125 @@
+/***************************************************************************//**
+ *   @file   no_os_fft.h
+ *   @brief  Fixed-point FFT and averaged spectrum.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef _NO_OS_FFT_H_
+#define _NO_OS_FFT_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#ifdef NO_OS_FFT_CMSIS_DSP
+#include "arm_math.h"
+#endif
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define NO_OS_FFT_MIN_SIZE	16
+#define NO_OS_FFT_MAX_SIZE	4096
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @enum no_os_fft_window
+ * @brief Window applied to the samples before the transform.
+ */
+enum no_os_fft_window {
+	NO_OS_FFT_WINDOW_RECT,
+	NO_OS_FFT_WINDOW_HANN,
+	NO_OS_FFT_WINDOW_HAMMING,
+};
+
+/**
+ * @struct no_os_fft
+ * @brief Averaged power spectrum of real blocks. The transform is a Q15
+ * radix-2 FFT scaled by 1/size, or the CMSIS-DSP one when built with
+ * NO_OS_FFT_CMSIS_DSP.
+ */
+struct no_os_fft {
+	/** Number of samples of a block, a power of 2 */
+	uint32_t size;
+	uint8_t log2_size;
+	enum no_os_fft_window window;
+	/** Window coefficients in Q15, NULL for the rectangular window */
+	int16_t *coef;
+	/** exp(-2 pi j k / size) for k below size / 2, in Q15 */
+	int16_t *twiddle;
+	/** Interleaved real and imaginary parts of the transform */
+	int16_t *work;
+	/** Power of each of the size / 2 bins, summed over the blocks */
+	uint64_t *acc;
+	/** Number of blocks of an average */
+	uint32_t nb_avg;
+	/** Number of blocks summed in acc */
+	uint32_t count;
+#ifdef NO_OS_FFT_CMSIS_DSP
+	arm_cfft_instance_q15 cfft;
+#endif
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Allocate a spectrum of size points averaging nb_avg blocks. */
+int32_t no_os_fft_init(struct no_os_fft **fft, uint32_t size,
+		       enum no_os_fft_window window, uint32_t nb_avg);
+
+/* Free the spectrum. */
+int32_t no_os_fft_remove(struct no_os_fft *fft);
+
+/* Restart the average, with nb_avg blocks. */
+int32_t no_os_fft_reset(struct no_os_fft *fft, uint32_t nb_avg);
+
+/* Add a block of 16 bit samples, stride samples apart, to the average. */
+int32_t no_os_fft_add_block(struct no_os_fft *fft, const int16_t *samples,
+			    uint32_t stride);
+
+/* Add a block of 32 bit samples, shifted right to 16 bits, to the average. */
+int32_t no_os_fft_add_block_s32(struct no_os_fft *fft, const int32_t *samples,
+				uint32_t stride, uint8_t shift);
+
+/* Get the size / 2 averaged magnitude bins and restart the average. */
+int32_t no_os_fft_get_magnitude(struct no_os_fft *fft, uint16_t *bins);
+
+#endif // _NO_OS_FFT_H_
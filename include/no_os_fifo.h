@@ -62,6 +62,37 @@ struct no_os_fifo_element {
 	uint32_t len;
 };
 
+/**
+ * @struct no_os_fifo_pool
+ * @brief Fifo of fixed size blocks taken from a pool allocated at init, so no
+ * heap is used by push and pop. Elements are appended through the tail.
+ */
+struct no_os_fifo_pool {
+	/** First element, the next one to be read */
+	struct no_os_fifo_element *head;
+	/** Last element, where data is appended */
+	struct no_os_fifo_element *tail;
+	/** Elements not in use */
+	struct no_os_fifo_element *free_list;
+	/** Elements of the pool */
+	struct no_os_fifo_element *elements;
+	/** Data storage of the elements */
+	char *storage;
+	/** Maximum length of the data of an element */
+	uint32_t block_size;
+};
+
+/**
+ * @struct no_os_fifo_pool_init_param
+ * @brief Structure holding the fifo pool initialization parameters.
+ */
+struct no_os_fifo_pool_init_param {
+	/** Number of elements of the pool */
+	uint32_t nb_blocks;
+	/** Maximum length of the data of an element */
+	uint32_t block_size;
+};
+
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
 /******************************************************************************/
@@ -73,4 +104,21 @@ int32_t no_os_fifo_insert(struct no_os_fifo_element **p_fifo, char *buff,
 /* Remove fifo head. */
 struct no_os_fifo_element *no_os_fifo_remove(struct no_os_fifo_element *p_fifo);
 
+/* Allocate a fifo pool. */
+int32_t no_os_fifo_pool_init(struct no_os_fifo_pool **pool,
+			     struct no_os_fifo_pool_init_param *param);
+
+/* Free the resources of a fifo pool. */
+void no_os_fifo_pool_remove(struct no_os_fifo_pool *pool);
+
+/* Copy data in a free element and append it to the fifo. */
+int32_t no_os_fifo_push(struct no_os_fifo_pool *pool, char *buff,
+			uint32_t len);
+
+/* Get the fifo head, NULL if the fifo is empty. */
+struct no_os_fifo_element *no_os_fifo_peek(struct no_os_fifo_pool *pool);
+
+/* Return the fifo head to the pool. */
+void no_os_fifo_pop(struct no_os_fifo_pool *pool);
+
 #endif // _NO_OS_FIFO_H_
@@ -106,6 +106,10 @@ int32_t flash_read_page(struct no_os_flash_dev *dev, int32_t page_no,
 int32_t no_os_flash_write(struct no_os_flash_dev *dev, uint32_t flash_addr,
 			  uint32_t *array, uint32_t array_size);
 
+/** Program erased flash memory, without erasing it first. */
+int32_t no_os_flash_program(struct no_os_flash_dev *dev, uint32_t flash_addr,
+			    uint32_t *array, uint32_t array_size);
+
 /** Read data from the flash memory. */
 int32_t no_os_flash_read(struct no_os_flash_dev *dev, uint32_t flash_addr,
 			 uint32_t *array,
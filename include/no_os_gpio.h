@@ -45,6 +45,9 @@
 /******************************************************************************/
 
 #include <stdint.h>
+#ifdef NO_OS_STATIC_OPS
+#include "no_os_static_ops.h"
+#endif
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -149,6 +152,12 @@ struct no_os_gpio_platform_ops {
 	int32_t (*gpio_ops_set_value)(struct no_os_gpio_desc *, uint8_t);
 	/** gpio get value function pointer */
 	int32_t (*gpio_ops_get_value)(struct no_os_gpio_desc *, uint8_t *);
+	/** gpio set multiple values function pointer */
+	int32_t (*gpio_ops_set_multiple)(struct no_os_gpio_desc *, uint32_t,
+					 uint32_t);
+	/** gpio get multiple values function pointer */
+	int32_t (*gpio_ops_get_multiple)(struct no_os_gpio_desc *, uint32_t,
+					 uint32_t *);
 };
 
 /******************************************************************************/
@@ -177,6 +186,15 @@ int32_t no_os_gpio_direction_output(struct no_os_gpio_desc *desc,
 int32_t no_os_gpio_get_direction(struct no_os_gpio_desc *desc,
 				 uint8_t *direction);
 
+/* Set the values of several GPIOs of the port of desc at once. */
+int32_t no_os_gpio_set_multiple(struct no_os_gpio_desc *desc, uint32_t mask,
+				uint32_t values);
+
+/* Get the values of several GPIOs of the port of desc at once. */
+int32_t no_os_gpio_get_multiple(struct no_os_gpio_desc *desc, uint32_t mask,
+				uint32_t *values);
+
+#ifndef NO_OS_STATIC_OPS
 /* Set the value of the specified GPIO. */
 int32_t no_os_gpio_set_value(struct no_os_gpio_desc *desc,
 			     uint8_t value);
@@ -184,5 +202,54 @@ int32_t no_os_gpio_set_value(struct no_os_gpio_desc *desc,
 /* Get the value of the specified GPIO. */
 int32_t no_os_gpio_get_value(struct no_os_gpio_desc *desc,
 			     uint8_t *value);
+#else
+/* Set the value of the specified GPIO through its platform_ops. */
+int32_t no_os_gpio_set_value_ops(struct no_os_gpio_desc *desc,
+				 uint8_t value);
+
+/* Get the value of the specified GPIO through its platform_ops. */
+int32_t no_os_gpio_get_value_ops(struct no_os_gpio_desc *desc,
+				 uint8_t *value);
+
+extern const struct no_os_gpio_platform_ops NO_OS_STATIC_GPIO_OPS;
+
+int32_t NO_OS_STATIC_GPIO_SET_VALUE(struct no_os_gpio_desc *desc,
+				    uint8_t value);
+
+int32_t NO_OS_STATIC_GPIO_GET_VALUE(struct no_os_gpio_desc *desc,
+				    uint8_t *value);
+
+/**
+ * @brief Set the value of the specified GPIO, calling the platform driver
+ * directly when desc uses NO_OS_STATIC_GPIO_OPS.
+ * @param desc - The GPIO descriptor, NULL for an optional GPIO not present.
+ * @param value - The value.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static inline int32_t no_os_gpio_set_value(struct no_os_gpio_desc *desc,
+		uint8_t value)
+{
+	if (desc && desc->platform_ops == &NO_OS_STATIC_GPIO_OPS)
+		return NO_OS_STATIC_GPIO_SET_VALUE(desc, value);
+
+	return no_os_gpio_set_value_ops(desc, value);
+}
+
+/**
+ * @brief Get the value of the specified GPIO, calling the platform driver
+ * directly when desc uses NO_OS_STATIC_GPIO_OPS.
+ * @param desc - The GPIO descriptor, NULL for an optional GPIO not present.
+ * @param value - The value.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static inline int32_t no_os_gpio_get_value(struct no_os_gpio_desc *desc,
+		uint8_t *value)
+{
+	if (desc && desc->platform_ops == &NO_OS_STATIC_GPIO_OPS)
+		return NO_OS_STATIC_GPIO_GET_VALUE(desc, value);
+
+	return no_os_gpio_get_value_ops(desc, value);
+}
+#endif
 
 #endif // _NO_OS_GPIO_H_
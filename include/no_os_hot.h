@@ -0,0 +1,69 @@
+/***************************************************************************//**
+ *   @file   no_os_hot.h
+ *   @brief  Placement of the hot paths in the fast memories.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef _NO_OS_HOT_H_
+#define _NO_OS_HOT_H_
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/*
+ * With HOT_SECTIONS=y the functions marked NO_OS_HOT are linked in the
+ * HOT_TEXT_REGION memory (e.g. the ITCM of a STM32H7) and the variables marked
+ * NO_OS_HOT_DATA/NO_OS_HOT_BSS in HOT_DATA_REGION (e.g. the DTCM), so they run
+ * without flash wait states. no_os_hot_init copies them there at startup.
+ * Without it the annotations expand to nothing.
+ */
+#ifdef NO_OS_HOT_SECTIONS
+#define NO_OS_HOT	__attribute__((section(".no_os_hot_text")))
+#define NO_OS_HOT_DATA	__attribute__((section(".no_os_hot_data")))
+#define NO_OS_HOT_BSS	__attribute__((section(".no_os_hot_bss")))
+#else
+#define NO_OS_HOT
+#define NO_OS_HOT_DATA
+#define NO_OS_HOT_BSS
+#endif
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Copy the hot code and data from flash, done before main. */
+void no_os_hot_init(void);
+
+#endif // _NO_OS_HOT_H_
@@ -57,6 +57,27 @@
  */
 struct no_os_i2c_platform_ops ;
 
+/**
+ * @struct no_os_i2c_msg
+ * @brief Message of a combined transfer. The messages of a transfer are
+ * separated by repeated starts and the last one ends with a stop condition.
+ */
+struct no_os_i2c_msg {
+	/** Buffer with the data to write or where to store the data read */
+	uint8_t		*data;
+	/** Number of bytes to write or read */
+	uint8_t		bytes_number;
+	/** If set, the data is read from the slave, otherwise it is written */
+	uint8_t		read;
+};
+
+/**
+ * @brief Callback called when an asynchronous transfer is done.
+ * @param ctx - Parameter given to no_os_i2c_transfer_async().
+ * @param ret - 0 if all the messages were sent, negative error code otherwise.
+ */
+typedef void (*no_os_i2c_callback)(void *ctx, int32_t ret);
+
 /**
  * @struct no_os_i2c_init_param
  * @brief Structure holding the parameters for I2C initialization.
@@ -104,6 +125,13 @@ struct no_os_i2c_platform_ops {
 	int32_t (*i2c_ops_write)(struct no_os_i2c_desc *, uint8_t *, uint8_t, uint8_t);
 	/** i2c write function pointer */
 	int32_t (*i2c_ops_read)(struct no_os_i2c_desc *, uint8_t *, uint8_t, uint8_t);
+	/** i2c combined transfer function pointer */
+	int32_t (*i2c_ops_transfer)(struct no_os_i2c_desc *,
+				    struct no_os_i2c_msg *, uint32_t);
+	/** Start a combined transfer and return, without waiting for it */
+	int32_t (*i2c_ops_transfer_async)(struct no_os_i2c_desc *,
+					  struct no_os_i2c_msg *, uint32_t,
+					  no_os_i2c_callback, void *);
 	/** i2c remove function pointer */
 	int32_t (*i2c_ops_remove)(struct no_os_i2c_desc *);
 };
@@ -131,4 +159,16 @@ int32_t no_os_i2c_read(struct no_os_i2c_desc *desc,
 		       uint8_t bytes_number,
 		       uint8_t stop_bit);
 
+/* Send multiple messages, separated by repeated starts. */
+int32_t no_os_i2c_transfer(struct no_os_i2c_desc *desc,
+			   struct no_os_i2c_msg *msgs,
+			   uint32_t len);
+
+/* Start sending the messages, callback is called when they are done. */
+int32_t no_os_i2c_transfer_async(struct no_os_i2c_desc *desc,
+				 struct no_os_i2c_msg *msgs,
+				 uint32_t len,
+				 no_os_i2c_callback callback,
+				 void *ctx);
+
 #endif // _NO_OS_I2C_H_
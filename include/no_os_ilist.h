@@ -0,0 +1,155 @@
+/***************************************************************************//**
+ *   @file   no_os_ilist.h
+ *   @brief  Header file of the intrusive list and heap.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef _NO_OS_ILIST_H_
+#define _NO_OS_ILIST_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Get the structure of type containing the member pointed by ptr */
+#define no_os_container_of(ptr, type, member) \
+	((type *)((char *)(ptr) - offsetof(type, member)))
+
+/* Iterate over the nodes of list. node must not be removed in the loop. */
+#define no_os_ilist_for_each(list, node) \
+	for ((node) = (list)->head.next; (node) != &(list)->head; \
+	     (node) = (node)->next)
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct no_os_ilist_node
+ * @brief Link to be embedded in the structure to be added to a list. Get the
+ * structure back from the node with no_os_container_of.
+ */
+struct no_os_ilist_node {
+	/** Previous node */
+	struct no_os_ilist_node *prev;
+	/** Next node */
+	struct no_os_ilist_node *next;
+};
+
+/**
+ * @struct no_os_ilist
+ * @brief Double linked list of nodes owned by the user, no allocation is done.
+ */
+struct no_os_ilist {
+	/** Sentinel, the first node is head.next and the last one head.prev */
+	struct no_os_ilist_node head;
+	/** Number of nodes in the list */
+	uint32_t nb_elements;
+};
+
+/**
+ * @brief Compare two heap elements.
+ * @return Negative value if data1 must come before data2, positive value if it
+ * must come after, 0 otherwise.
+ */
+typedef int32_t (*no_os_heap_cmp)(void *data1, void *data2);
+
+/**
+ * @struct no_os_heap
+ * @brief Binary heap keeping the smallest element, according to cmp, on top.
+ * Used as a priority queue, for example ordering timer events by deadline.
+ */
+struct no_os_heap {
+	/** Storage provided by the user for the element references */
+	void **elems;
+	/** Number of references that fit in elems */
+	uint32_t size;
+	/** Number of elements in the heap */
+	uint32_t nb_elements;
+	/** Function used to compare elements */
+	no_os_heap_cmp cmp;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Initialize an empty list. */
+void no_os_ilist_init(struct no_os_ilist *list);
+
+/* Check if list has no nodes. */
+bool no_os_ilist_is_empty(struct no_os_ilist *list);
+
+/* Add node at the start of list. */
+void no_os_ilist_add_first(struct no_os_ilist *list,
+			   struct no_os_ilist_node *node);
+
+/* Add node at the end of list. */
+void no_os_ilist_add_last(struct no_os_ilist *list,
+			  struct no_os_ilist_node *node);
+
+/* Remove node from list. */
+void no_os_ilist_del(struct no_os_ilist *list, struct no_os_ilist_node *node);
+
+/* Get the first node of list without removing it, NULL if list is empty. */
+struct no_os_ilist_node *no_os_ilist_first(struct no_os_ilist *list);
+
+/* Remove and return the first node of list, NULL if list is empty. */
+struct no_os_ilist_node *no_os_ilist_get_first(struct no_os_ilist *list);
+
+/* Initialize an empty heap using the storage in elems. */
+int32_t no_os_heap_init(struct no_os_heap *heap, void **elems, uint32_t size,
+			no_os_heap_cmp cmp);
+
+/* Insert an element in heap. */
+int32_t no_os_heap_push(struct no_os_heap *heap, void *data);
+
+/* Read the top element of heap without removing it. */
+int32_t no_os_heap_peek(struct no_os_heap *heap, void **data);
+
+/* Remove and return the top element of heap. */
+int32_t no_os_heap_pop(struct no_os_heap *heap, void **data);
+
+/* Remove an element from any position of heap. */
+int32_t no_os_heap_remove(struct no_os_heap *heap, void *data);
+
+#endif // _NO_OS_ILIST_H_
@@ -0,0 +1,180 @@
+/***************************************************************************//**
+ *   @file   no_os_irq_policy.h
+ *   @brief  Header file of the interrupt priority policy and latency test.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef _NO_OS_IRQ_POLICY_H_
+#define _NO_OS_IRQ_POLICY_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "no_os_irq.h"
+#include "no_os_gpio.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Length of the longest line written by no_os_irq_policy_print, with '\0' */
+#define NO_OS_IRQ_POLICY_LINE_SIZE	96
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @enum no_os_irq_class
+ * @brief Kind of interrupt source, from the one that must preempt all the
+ * others to the one that can wait the longest.
+ */
+enum no_os_irq_class {
+	/** Converter data ready or conversion start edges */
+	NO_OS_IRQ_CLASS_DATA_READY,
+	/** Timers pacing IIO triggers or DAC updates */
+	NO_OS_IRQ_CLASS_TRIGGER,
+	/** DMA transfer completion */
+	NO_OS_IRQ_CLASS_DMA,
+	/** SPI and I2C transfer completion */
+	NO_OS_IRQ_CLASS_SPI,
+	/** UART, including the IIOD link */
+	NO_OS_IRQ_CLASS_UART,
+	/** Everything that is not time critical */
+	NO_OS_IRQ_CLASS_BACKGROUND,
+	NO_OS_IRQ_CLASS_MAX
+};
+
+/**
+ * @struct no_os_irq_source
+ * @brief Interrupt source of the policy, with its latency counters. The
+ * counters are in the ticks of no_os_trace_timestamp().
+ */
+struct no_os_irq_source {
+	/** Name shown by no_os_irq_policy_print */
+	const char *name;
+	/** Interrupt controller of the source */
+	struct no_os_irq_ctrl_desc *irq_ctrl;
+	/** Interrupt id of the source */
+	uint32_t irq_id;
+	/** Kind of source, selecting its priority */
+	enum no_os_irq_class irq_class;
+	/** Expected ticks between two interrupts, 0 if not periodic */
+	uint32_t period_ticks;
+	/** Timestamp of the event armed with no_os_irq_latency_arm */
+	volatile uint32_t armed_at;
+	/** Set while an armed event waits for its interrupt */
+	volatile bool armed;
+	/** Timestamp of the last interrupt entry */
+	uint32_t last_entry;
+	/** Number of interrupt entries */
+	uint32_t nb_entries;
+	/** Number of measured entry latencies */
+	uint32_t nb_latencies;
+	/** Shortest entry latency */
+	uint32_t min_latency;
+	/** Longest entry latency */
+	uint32_t max_latency;
+	/** Sum of the entry latencies, for the average */
+	uint64_t sum_latency;
+	/** Armed events never served and periods without an entry */
+	uint32_t missed;
+};
+
+/**
+ * @struct no_os_irq_policy
+ * @brief Priorities of all the interrupt sources of a project.
+ */
+struct no_os_irq_policy {
+	/** Interrupt sources */
+	struct no_os_irq_source *sources;
+	/** Number of sources */
+	uint32_t nb_sources;
+	/**
+	 * Priority of each class, 0 being the highest. NULL for the default
+	 * table, which only uses the levels 0 to 3 supported by all platforms.
+	 */
+	const uint32_t *class_priority;
+};
+
+/**
+ * @struct no_os_irq_latency_test
+ * @brief Loopback entry latency test. gpio_out is wired to the input of a GPIO
+ * interrupt source, each toggle raising one interrupt.
+ */
+struct no_os_irq_latency_test {
+	/** GPIO interrupt source under test, with no callback registered */
+	struct no_os_irq_source *src;
+	/** Output driving the input of src */
+	struct no_os_gpio_desc *gpio_out;
+	/** Platform specific event of the source */
+	enum no_os_irq_event event;
+	/** Platform specific handle of the source */
+	void *handle;
+	/** Number of edges raised */
+	uint32_t nb_iter;
+	/** Time to wait for each interrupt, in microseconds */
+	uint32_t timeout_us;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Set the priorities of all the sources and make policy the active one. */
+int32_t no_os_irq_policy_apply(struct no_os_irq_policy *policy);
+
+/* Get the priority of a source according to its policy. */
+uint32_t no_os_irq_policy_priority(struct no_os_irq_policy *policy,
+				   struct no_os_irq_source *src);
+
+/* Record that the event of src happened, from the code raising it. */
+void no_os_irq_latency_arm(struct no_os_irq_source *src);
+
+/* Record the entry in the interrupt handler of src. */
+void no_os_irq_latency_mark(struct no_os_irq_source *src);
+
+/* Measure the entry latency of a GPIO source driven by a looped back GPIO. */
+int32_t no_os_irq_latency_test(struct no_os_irq_latency_test *test);
+
+/* Clear the latency counters of all the sources of the active policy. */
+void no_os_irq_policy_reset_stats(void);
+
+/* Format the priorities and latency counters of the active policy. */
+int32_t no_os_irq_policy_print(char *buf, uint32_t len);
+
+#endif // _NO_OS_IRQ_POLICY_H_
@@ -0,0 +1,146 @@
+/***************************************************************************//**
+ *   @file   no_os_kvstore.h
+ *   @brief  Header file of the key/value store kept in flash.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef _NO_OS_KVSTORE_H_
+#define _NO_OS_KVSTORE_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include "no_os_flash.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Records are programmed in units of NO_OS_KV_ALIGN bytes */
+#define NO_OS_KV_ALIGN		8U
+/* Reserved, marks the erased flash */
+#define NO_OS_KV_KEY_NONE	0xFFFFU
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct no_os_kv_entry
+ * @brief RAM index entry, the location of the last value of a key.
+ */
+struct no_os_kv_entry {
+	uint16_t key;
+	/** Value length in bytes */
+	uint16_t len;
+	/** Flash address of the record */
+	uint32_t addr;
+};
+
+/**
+ * @struct no_os_kv_init_param
+ * @brief Key/value store initialization parameters.
+ */
+struct no_os_kv_init_param {
+	/** Initialized flash device, with no_os_flash_program support */
+	struct no_os_flash_dev *flash;
+	/** First flash page of the store, page n being at n * page_size */
+	uint32_t start_page;
+	/** Number of pages of the store, at least 2 */
+	uint32_t nb_pages;
+	/** Maximum number of keys */
+	uint32_t max_keys;
+};
+
+/**
+ * @struct no_os_kv_desc
+ * @brief Log structured key/value store.
+ *
+ * The pages are used as a ring. Each update appends a record to the page in
+ * use, so it costs one program operation. When the page is full the next one
+ * is started and, when it was the last erased page, the values still current
+ * in the oldest page are moved to the new one before erasing it. All the
+ * pages are thus erased in turn. The index of the keys is rebuilt at
+ * initialization by replaying the pages from the oldest one, a record whose
+ * CRC does not match, e.g. after a power loss, ends the page. After a flash
+ * error the store is to be opened again, which completes the interrupted
+ * operations.
+ */
+struct no_os_kv_desc {
+	struct no_os_flash_dev *flash;
+	uint32_t start_page;
+	uint32_t nb_pages;
+	uint32_t page_size;
+	/** Index of the keys, nb_keys of max_keys used */
+	struct no_os_kv_entry *entries;
+	uint32_t max_keys;
+	uint32_t nb_keys;
+	/** Page being appended to and oldest page, relative to start_page */
+	uint32_t active;
+	uint32_t oldest;
+	/** Sequence number of the active page */
+	uint32_t seq;
+	/** Offset of the next record in the active page */
+	uint32_t offset;
+	/** Size of the current records, headers and padding included */
+	uint32_t live;
+	/** Page sized buffer, records are built and read in it */
+	uint32_t *buff;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Open the store, building the index from the flash content. */
+int32_t no_os_kv_init(struct no_os_kv_desc **desc,
+		      const struct no_os_kv_init_param *param);
+
+/* Store the value of key. */
+int32_t no_os_kv_set(struct no_os_kv_desc *desc, uint16_t key,
+		     const void *data, uint16_t len);
+
+/* Read the value of key, len being the buffer size then the value length. */
+int32_t no_os_kv_get(struct no_os_kv_desc *desc, uint16_t key, void *data,
+		     uint16_t *len);
+
+/* Delete key. */
+int32_t no_os_kv_delete(struct no_os_kv_desc *desc, uint16_t key);
+
+/* Free the resources allocated by no_os_kv_init(). */
+int32_t no_os_kv_remove(struct no_os_kv_desc *desc);
+
+#endif // _NO_OS_KVSTORE_H_
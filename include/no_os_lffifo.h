@@ -0,0 +1,100 @@
+/***************************************************************************//**
+ *   @file   no_os_lffifo.h
+ *   @brief  SPSC lock-free fifo of configurable element size and depth.
+********************************************************************************
+ *   @copyright
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef __NO_OS_LFFIFO_H
+#define __NO_OS_LFFIFO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Size of the data area of a fifo with nb elements of type. Fails to
+ * compile when nb is not a power of 2.
+ */
+#define NO_OS_LFFIFO_DATA_SIZE(type, nb) \
+	((((nb) & ((nb) - 1)) || !(nb)) ? -1 : (int)((nb) * sizeof(type)))
+
+/**
+ * @brief Statically allocate a fifo of nb elements of type, no init needed.
+ * The fifo is then accessed with &name.
+ */
+#define NO_OS_LFFIFO_DEFINE(name, type, nb) \
+	static uint8_t name##_data[NO_OS_LFFIFO_DATA_SIZE(type, nb)]; \
+	static struct no_os_lffifo name = { \
+		.data = name##_data, \
+		.elem_size = sizeof(type), \
+		.depth = (nb), \
+	}
+
+/**
+ * @struct no_os_lffifo
+ * @brief Single producer, single consumer fifo. The producer only writes the
+ * head and the consumer only writes the tail, so no locking is needed between
+ * an interrupt handler and the main loop.
+ */
+struct no_os_lffifo {
+	/** Memory area of depth * elem_size bytes */
+	uint8_t *data;
+	/** Size of an element in bytes */
+	uint32_t elem_size;
+	/** Number of elements, must be a power of 2 */
+	uint32_t depth;
+	/** Number of elements written since init, wraps around */
+	uint32_t head;
+	/** Number of elements read since init, wraps around */
+	uint32_t tail;
+	/** Set when the data was allocated by no_os_lffifo_init */
+	bool allocated;
+};
+
+int no_os_lffifo_init(struct no_os_lffifo **fifo, uint32_t elem_size,
+		      uint32_t depth);
+int no_os_lffifo_cfg(struct no_os_lffifo *fifo, void *data,
+		     uint32_t elem_size, uint32_t depth);
+void no_os_lffifo_remove(struct no_os_lffifo *fifo);
+uint32_t no_os_lffifo_count(struct no_os_lffifo *fifo);
+bool no_os_lffifo_is_full(struct no_os_lffifo *fifo);
+bool no_os_lffifo_is_empty(struct no_os_lffifo *fifo);
+uint32_t no_os_lffifo_write(struct no_os_lffifo *fifo, const void *elems,
+			    uint32_t nb_elems);
+uint32_t no_os_lffifo_read(struct no_os_lffifo *fifo, void *elems,
+			   uint32_t nb_elems);
+void no_os_lffifo_flush(struct no_os_lffifo *fifo);
+
+#endif
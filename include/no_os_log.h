@@ -0,0 +1,180 @@
+/***************************************************************************//**
+ *   @file   no_os_log.h
+ *   @brief  Header file of the deferred binary logger.
+********************************************************************************
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef _NO_OS_LOG_H_
+#define _NO_OS_LOG_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/*
+ * With NO_OS_LOG_DEFERRED defined, the pr_* macros record the address of their
+ * format string and the values of their arguments in a ring of
+ * NO_OS_LOG_DEPTH messages, a power of 2, instead of calling printf. The
+ * format strings are kept in the .no_os_log section, so
+ * tools/scripts/no_os_log_decode.py prints the messages using the elf file.
+ *
+ * no_os_log_flush sends the messages as frames of:
+ *   0xA5, the 8 bit length of the frame, the 32 bit address of the format
+ *   string and the 32 bit timestamp in microseconds, or 0, followed by the
+ *   arguments: 'w' and a 32 bit value, 'q' and a 64 bit value, 'd' and a
+ *   double, 's' the 8 bit length and the characters of a string. A '.' ends
+ *   the arguments of a truncated message.
+ * All values are little endian. Format address 0 is a message with the 32 bit
+ * number of messages lost because the ring was full. Pointers are sent as
+ * 32 bit values.
+ */
+#ifndef NO_OS_LOG_DEPTH
+#define NO_OS_LOG_DEPTH		64
+#endif
+#define NO_OS_LOG_MAGIC		0xA5
+#define NO_OS_LOG_HDR_SIZE	10
+/* Bytes of arguments of a message */
+#define NO_OS_LOG_DATA_SIZE	48
+
+#define NO_OS_LOG_ARG_WORD	'w'
+#define NO_OS_LOG_ARG_U64	'q'
+#define NO_OS_LOG_ARG_DOUBLE	'd'
+#define NO_OS_LOG_ARG_STR	's'
+#define NO_OS_LOG_ARG_TRUNC	'.'
+
+#define NO_OS_LOG_STR_(x)	#x
+#define NO_OS_LOG_STR(x)	NO_OS_LOG_STR_(x)
+
+/* Value of an argument, of the type taken by its NO_OS_LOG_PUT function */
+#define NO_OS_LOG_VAL(x) _Generic((x),					\
+	float: (x),							\
+	double: (x),							\
+	char *: (x),							\
+	const char *: (x),						\
+	long: (x),							\
+	unsigned long: (x),						\
+	long long: (x),							\
+	unsigned long long: (x),					\
+	default: (uintptr_t)(x))
+
+#define NO_OS_LOG_PUT(msg, x) _Generic((x),				\
+	float: no_os_log_put_double,					\
+	double: no_os_log_put_double,					\
+	char *: no_os_log_put_str,					\
+	const char *: no_os_log_put_str,				\
+	long: no_os_log_put_long,					\
+	unsigned long: no_os_log_put_long,				\
+	long long: no_os_log_put_u64,					\
+	unsigned long long: no_os_log_put_u64,				\
+	default: no_os_log_put_word)((msg), NO_OS_LOG_VAL(x));
+
+/* Apply m to each of up to 10 arguments */
+#define NO_OS_LOG_NB(_0, _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, n, ...) n
+#define NO_OS_LOG_CAT_(a, b)	a##b
+#define NO_OS_LOG_CAT(a, b)	NO_OS_LOG_CAT_(a, b)
+#define NO_OS_LOG_EACH_0(m, c)
+#define NO_OS_LOG_EACH_1(m, c, a)	m(c, a)
+#define NO_OS_LOG_EACH_2(m, c, a, b...)	m(c, a) NO_OS_LOG_EACH_1(m, c, b)
+#define NO_OS_LOG_EACH_3(m, c, a, b...)	m(c, a) NO_OS_LOG_EACH_2(m, c, b)
+#define NO_OS_LOG_EACH_4(m, c, a, b...)	m(c, a) NO_OS_LOG_EACH_3(m, c, b)
+#define NO_OS_LOG_EACH_5(m, c, a, b...)	m(c, a) NO_OS_LOG_EACH_4(m, c, b)
+#define NO_OS_LOG_EACH_6(m, c, a, b...)	m(c, a) NO_OS_LOG_EACH_5(m, c, b)
+#define NO_OS_LOG_EACH_7(m, c, a, b...)	m(c, a) NO_OS_LOG_EACH_6(m, c, b)
+#define NO_OS_LOG_EACH_8(m, c, a, b...)	m(c, a) NO_OS_LOG_EACH_7(m, c, b)
+#define NO_OS_LOG_EACH_9(m, c, a, b...)	m(c, a) NO_OS_LOG_EACH_8(m, c, b)
+#define NO_OS_LOG_EACH_10(m, c, a, b...) m(c, a) NO_OS_LOG_EACH_9(m, c, b)
+#define NO_OS_LOG_FOR_EACH(m, c, args...)				\
+	NO_OS_LOG_CAT(NO_OS_LOG_EACH_,					\
+		      NO_OS_LOG_NB(0, ##args, 10, 9, 8, 7, 6, 5, 4, 3, \
+				   2, 1, 0))(m, c, ##args)
+
+/* Record a message, fmt must be a string literal */
+#define no_os_log_record(fmt, args...) do {				\
+	static const char _no_os_log_fmt[]				\
+	__attribute__((section(".no_os_log"), used)) = fmt;		\
+	struct no_os_log_msg _no_os_log_msg;				\
+	no_os_log_start(&_no_os_log_msg, _no_os_log_fmt);		\
+	NO_OS_LOG_FOR_EACH(NO_OS_LOG_PUT, &_no_os_log_msg, ##args)	\
+	no_os_log_commit(&_no_os_log_msg);				\
+} while (0)
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct no_os_log_msg
+ * @brief Recorded message.
+ */
+struct no_os_log_msg {
+	/** Format string, in the .no_os_log section */
+	const char *fmt;
+	/** Microseconds since the system start, 0 without PRINT_TIME */
+	uint32_t timestamp;
+	/** Bytes used in data */
+	uint32_t len;
+	/** Encoded arguments */
+	uint8_t data[NO_OS_LOG_DATA_SIZE];
+};
+
+struct no_os_uart_desc;
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Start a message, used by no_os_log_record. */
+void no_os_log_start(struct no_os_log_msg *msg, const char *fmt);
+
+/* Add an argument to a message, used by no_os_log_record. */
+void no_os_log_put_word(struct no_os_log_msg *msg, uint32_t val);
+void no_os_log_put_long(struct no_os_log_msg *msg, unsigned long val);
+void no_os_log_put_u64(struct no_os_log_msg *msg, uint64_t val);
+void no_os_log_put_double(struct no_os_log_msg *msg, double val);
+void no_os_log_put_str(struct no_os_log_msg *msg, const char *str);
+
+/* Store a message in the ring, from any context. */
+void no_os_log_commit(struct no_os_log_msg *msg);
+
+/* Send the recorded messages, to be called when idle. */
+int32_t no_os_log_flush(struct no_os_uart_desc *uart);
+
+#endif // _NO_OS_LOG_H_
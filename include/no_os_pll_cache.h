@@ -0,0 +1,101 @@
+/***************************************************************************//**
+ *   @file   no_os_pll_cache.h
+ *   @brief  Header file of the PLL frequency plan cache.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef _NO_OS_PLL_CACHE_H_
+#define _NO_OS_PLL_CACHE_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct no_os_pll_cache_tag
+ * @brief Identification of a cached plan.
+ */
+struct no_os_pll_cache_tag {
+	/** Requested frequency the plan was computed for */
+	uint64_t freq;
+	/** Driver specific state the plan depends on, e.g. channel spacing */
+	uint32_t key;
+	/** Time of the last use, 0 if the entry is empty */
+	uint32_t stamp;
+};
+
+/**
+ * @struct no_os_pll_cache
+ * @brief Least recently used cache of PLL frequency plans: the divider values
+ * and register words computed for a frequency, so that returning to a recent
+ * frequency skips the computation. The storage is owned by the user.
+ */
+struct no_os_pll_cache {
+	/** nb_entries tags */
+	struct no_os_pll_cache_tag *tags;
+	/** nb_entries plans of plan_size bytes, in the layout of the driver */
+	uint8_t *plans;
+	uint32_t plan_size;
+	uint32_t nb_entries;
+	/** Incremented at each use */
+	uint32_t clock;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Initialize an empty cache using the storage in tags and plans. */
+int32_t no_os_pll_cache_init(struct no_os_pll_cache *cache,
+			     struct no_os_pll_cache_tag *tags, void *plans,
+			     uint32_t plan_size, uint32_t nb_entries);
+
+/* Get the plan for freq and key, NULL if it is not cached. */
+void *no_os_pll_cache_find(struct no_os_pll_cache *cache, uint64_t freq,
+			   uint32_t key);
+
+/* Get the storage where to compute the plan for freq and key. */
+void *no_os_pll_cache_add(struct no_os_pll_cache *cache, uint64_t freq,
+			  uint32_t key);
+
+/* Drop all the plans, e.g. after a reference frequency change. */
+void no_os_pll_cache_invalidate(struct no_os_pll_cache *cache);
+
+#endif // _NO_OS_PLL_CACHE_H_
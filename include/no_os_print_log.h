@@ -63,74 +63,72 @@
 #define pr_time			;
 #endif
 
-#if defined(NO_OS_LOG_LEVEL) && NO_OS_LOG_LEVEL >= NO_OS_LOG_EMERG && NO_OS_LOG_LEVEL <= NO_OS_LOG_DEBUG
-#define pr_emerg(fmt, args...) do {							\
-	pr_time										\
-	printf("EMERG: %s:%d:%s(): " fmt, __FILE__, __LINE__, __func__, ##args);	\
+#ifdef NO_OS_LOG_DEFERRED
+#include "no_os_log.h"
+/*
+ * Recorded with their arguments and printed later by no_os_log_flush, see
+ * no_os_log.h. The function name is replaced by the line of the call.
+ */
+#define no_os_pr_loc(prefix, fmt, args...)				\
+	no_os_log_record(prefix ": " __FILE__ ":"			\
+			 NO_OS_LOG_STR(__LINE__) ": " fmt, ##args)
+#define no_os_pr(prefix, fmt, args...)	no_os_log_record(prefix fmt, ##args)
+#else
+#define no_os_pr_loc(prefix, fmt, args...) do {				\
+	pr_time								\
+	printf(prefix ": %s:%d:%s(): " fmt, __FILE__, __LINE__,		\
+	       __func__, ##args);					\
+} while (0)
+#define no_os_pr(prefix, fmt, args...) do {				\
+	pr_time								\
+	printf(prefix fmt, ##args);					\
 } while (0)
+#endif
+
+#if defined(NO_OS_LOG_LEVEL) && NO_OS_LOG_LEVEL >= NO_OS_LOG_EMERG && NO_OS_LOG_LEVEL <= NO_OS_LOG_DEBUG
+#define pr_emerg(fmt, args...) no_os_pr_loc("EMERG", fmt, ##args)
 #else
 #define pr_emerg(fmt, args...)
 #endif
 
 #if defined(NO_OS_LOG_LEVEL) && NO_OS_LOG_LEVEL >= NO_OS_LOG_ALERT && NO_OS_LOG_LEVEL <= NO_OS_LOG_DEBUG
-#define pr_alert(fmt, args...) do {							\
-	pr_time										\
-	printf("ALERT: %s:%d:%s(): " fmt, __FILE__, __LINE__, __func__, ##args);	\
-} while (0)
+#define pr_alert(fmt, args...) no_os_pr_loc("ALERT", fmt, ##args)
 #else
 #define pr_alert(fmt, args...)
 #endif
 
 #if defined(NO_OS_LOG_LEVEL) && NO_OS_LOG_LEVEL >= NO_OS_LOG_CRIT && NO_OS_LOG_LEVEL <= NO_OS_LOG_DEBUG
-#define pr_crit(fmt, args...) do { 						\
-	pr_time									\
-	printf("CRIT: %s:%d:%s(): " fmt, __FILE__, __LINE__, __func__, ##args);	\
-} while (0)
+#define pr_crit(fmt, args...) no_os_pr_loc("CRIT", fmt, ##args)
 #else
 #define pr_crit(fmt, args...)
 #endif
 
 #if defined(NO_OS_LOG_LEVEL) && NO_OS_LOG_LEVEL >= NO_OS_LOG_ERR && NO_OS_LOG_LEVEL <= NO_OS_LOG_DEBUG
-#define pr_err(fmt, args...) do {						\
-	pr_time									\
-	printf("ERR: %s:%d:%s(): " fmt, __FILE__, __LINE__, __func__, ##args);	\
-} while (0)
+#define pr_err(fmt, args...) no_os_pr_loc("ERR", fmt, ##args)
 #else
 #define pr_err(fmt, args...)
 #endif
 
 #if defined(NO_OS_LOG_LEVEL) && NO_OS_LOG_LEVEL >= NO_OS_LOG_WARNING && NO_OS_LOG_LEVEL <= NO_OS_LOG_DEBUG
-#define pr_warning(fmt, args...) do {		\
-	pr_time					\
-	printf("WARNING: " fmt, ##args);	\
-} while (0)
+#define pr_warning(fmt, args...) no_os_pr("WARNING: ", fmt, ##args)
 #else
 #define pr_warning(fmt, args...)
 #endif
 
 #if defined(NO_OS_LOG_LEVEL) && NO_OS_LOG_LEVEL >= NO_OS_LOG_NOTICE && NO_OS_LOG_LEVEL <= NO_OS_LOG_DEBUG
-#define pr_notice(fmt, args...) do {	\
-	pr_time				\
-	printf("NOTICE: " fmt, ##args);	\
-} while (0)
+#define pr_notice(fmt, args...) no_os_pr("NOTICE: ", fmt, ##args)
 #else
 #define pr_notice(fmt, args...)
 #endif
 
 #if defined(NO_OS_LOG_LEVEL) && NO_OS_LOG_LEVEL >= NO_OS_LOG_INFO && NO_OS_LOG_LEVEL <= NO_OS_LOG_DEBUG
-#define pr_info(fmt, args...) do {	\
-	pr_time 			\
-	printf(fmt, ##args);		\
-} while(0)
+#define pr_info(fmt, args...) no_os_pr("", fmt, ##args)
 #else
 #define pr_info(fmt, args...)
 #endif
 
 #if defined(NO_OS_LOG_LEVEL) && NO_OS_LOG_LEVEL == NO_OS_LOG_DEBUG
-#define pr_debug(fmt, args...) do {	\
-	pr_time				\
-	printf("DEBUG: " fmt, ##args);	\
-} while(0)
+#define pr_debug(fmt, args...) no_os_pr("DEBUG: ", fmt, ##args)
 #else
 #define pr_debug(fmt, args...)
 #endif
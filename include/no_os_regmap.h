@@ -0,0 +1,130 @@
+/***************************************************************************//**
+ *   @file   no_os_regmap.h
+ *   @brief  Header file of the SPI register map helper
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+
+#ifndef _NO_OS_REGMAP_H_
+#define _NO_OS_REGMAP_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "no_os_spi.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct no_os_regmap_init_param
+ * @brief Parameters of a register map with 8-bit registers, accessed with an
+ * address phase followed by data in streaming mode
+ */
+struct no_os_regmap_init_param {
+	/** SPI descriptor of the device */
+	struct no_os_spi_desc	*spi;
+	/** Number of address bytes sent before the data, 1 or 2 */
+	uint8_t			addr_bytes;
+	/** OR-ed to the address of read transactions, e.g. 0x80 */
+	uint16_t		read_mask;
+	/** OR-ed to the address of write transactions */
+	uint16_t		write_mask;
+	/** Set if the address is decremented in streaming mode */
+	bool			addr_descending;
+	/** Number of registers cached, starting from address 0 */
+	uint16_t		nb_regs;
+	/** Maximum number of registers accessed in one burst. Must be set */
+	uint16_t		max_burst;
+};
+
+/**
+ * @struct no_os_regmap_desc
+ * @brief Register map descriptor
+ */
+struct no_os_regmap_desc {
+	struct no_os_spi_desc	*spi;
+	uint8_t			addr_bytes;
+	uint16_t		read_mask;
+	uint16_t		write_mask;
+	bool			addr_descending;
+	uint16_t		nb_regs;
+	uint16_t		max_burst;
+	/** If set, writes only update the cache until no_os_regmap_sync() */
+	bool			cache_only;
+	/** Cached register values */
+	uint8_t			*cache;
+	/** Bitmap of the cached registers holding a known value */
+	uint32_t		*valid;
+	/** Bitmap of the cached registers not written to the device yet */
+	uint32_t		*dirty;
+	/** Transfer buffer: address followed by max_burst data bytes */
+	uint8_t			*buf;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+int32_t no_os_regmap_init(struct no_os_regmap_desc **desc,
+			  const struct no_os_regmap_init_param *param);
+int32_t no_os_regmap_remove(struct no_os_regmap_desc *desc);
+
+int32_t no_os_regmap_read(struct no_os_regmap_desc *desc, uint16_t reg,
+			  uint8_t *val);
+int32_t no_os_regmap_write(struct no_os_regmap_desc *desc, uint16_t reg,
+			   uint8_t val);
+int32_t no_os_regmap_update_bits(struct no_os_regmap_desc *desc, uint16_t reg,
+				 uint8_t mask, uint8_t val);
+
+/* Access count consecutive registers with as few bursts as possible */
+int32_t no_os_regmap_bulk_read(struct no_os_regmap_desc *desc, uint16_t reg,
+			       uint8_t *vals, uint16_t count);
+int32_t no_os_regmap_bulk_write(struct no_os_regmap_desc *desc, uint16_t reg,
+				const uint8_t *vals, uint16_t count);
+
+/* Defer the writes to cached registers until no_os_regmap_sync() */
+void no_os_regmap_cache_only(struct no_os_regmap_desc *desc, bool enable);
+/* Forget the cached values, e.g. after a device reset */
+void no_os_regmap_cache_invalidate(struct no_os_regmap_desc *desc);
+/* Write the dirty registers, merging consecutive ones in bursts */
+int32_t no_os_regmap_sync(struct no_os_regmap_desc *desc);
+
+#endif // _NO_OS_REGMAP_H_
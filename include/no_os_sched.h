@@ -0,0 +1,205 @@
+/***************************************************************************//**
+ *   @file   no_os_sched.h
+ *   @brief  Header file of the cooperative scheduler.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef _NO_OS_SCHED_H_
+#define _NO_OS_SCHED_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "no_os_ilist.h"
+#include "no_os_delay.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Timers armed at the same time, with no_os_sched_timer_start */
+#ifndef NO_OS_SCHED_MAX_TIMERS
+#define NO_OS_SCHED_MAX_TIMERS	16
+#endif
+
+/* Shortest idle time, in ms, for which a deep sleep state is entered */
+#ifndef NO_OS_SCHED_DEEP_MIN_MS
+#define NO_OS_SCHED_DEEP_MIN_MS	1000
+#endif
+
+/* Idle time of no_os_sched_sleep_level when no timer is armed */
+#define NO_OS_SCHED_FOREVER	UINT32_MAX
+
+/*
+ * Waits of the drivers. With NO_OS_SCHED defined they run the other works
+ * while waiting, otherwise they keep their blocking behavior.
+ */
+#ifndef NO_OS_SCHED
+#define no_os_sched_yield()		do {} while (0)
+#define no_os_sched_delay_ms(ms)	no_os_mdelay(ms)
+#endif
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+struct no_os_rtc_desc;
+
+/**
+ * @enum no_os_sched_sleep
+ * @brief Sleep states of no_os_sched_idle, from the lightest one.
+ */
+enum no_os_sched_sleep {
+	/** A work is pending, the loop has to run again */
+	NO_OS_SCHED_SLEEP_NONE,
+	/** Wait for an interrupt, the clocks and peripherals running */
+	NO_OS_SCHED_SLEEP_WAIT,
+	/**
+	 * Deepest state of the platform, woken up by the GPIO and UART
+	 * interrupts kept by the platform or by the RTC alarm of the next timer
+	 */
+	NO_OS_SCHED_SLEEP_DEEP,
+};
+
+/**
+ * @struct no_os_sched_work
+ * @brief Function run by the scheduler loop once posted, from any context, or
+ * once its timer expires. Owned by the user, no allocation is done.
+ */
+struct no_os_sched_work {
+	/** Link in the list of works */
+	struct no_os_ilist_node node;
+	/** Function to run */
+	void (*fn)(void *ctx);
+	/** Parameter of fn */
+	void *ctx;
+	/** Set when posted, cleared right before fn runs */
+	volatile bool pending;
+	/** Set while fn runs, so yielding does not run it again */
+	bool running;
+	/** Set while the work is in the list */
+	bool added;
+	/** Set while the timer is armed */
+	bool timer_armed;
+	/** Time in ms the timer expires */
+	uint32_t deadline;
+	/** Timer period in ms, 0 for a one shot timer */
+	uint32_t period;
+};
+
+/**
+ * @struct no_os_sched_event
+ * @brief Event flags set from any context, each set posting the waiting work.
+ */
+struct no_os_sched_event {
+	/** Flags set and not taken yet */
+	atomic_uint flags;
+	/** Work posted when flags are set */
+	struct no_os_sched_work *waiter;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Add a work to the scheduler, from the loop context. */
+int32_t no_os_sched_work_add(struct no_os_sched_work *work,
+			     void (*fn)(void *ctx), void *ctx);
+
+/* Remove a work from the scheduler, from the loop context. */
+int32_t no_os_sched_work_remove(struct no_os_sched_work *work);
+
+/* Make a work run on the next loop iteration, from any context. */
+void no_os_sched_post(struct no_os_sched_work *work);
+
+/* Post a work after delay_ms, then every period_ms if not 0. */
+int32_t no_os_sched_timer_start(struct no_os_sched_work *work,
+				uint32_t delay_ms, uint32_t period_ms);
+
+/* Disarm the timer of a work. */
+int32_t no_os_sched_timer_stop(struct no_os_sched_work *work);
+
+/* Initialize event flags posting waiter when set. */
+void no_os_sched_event_init(struct no_os_sched_event *ev,
+			    struct no_os_sched_work *waiter);
+
+/* Set event flags, from any context. */
+void no_os_sched_event_set(struct no_os_sched_event *ev, uint32_t mask);
+
+/* Get and clear the event flags in mask. */
+uint32_t no_os_sched_event_take(struct no_os_sched_event *ev, uint32_t mask);
+
+/* Check if a work was posted and did not run yet. */
+bool no_os_sched_pending(void);
+
+/* Run the expired timers and the posted works once. */
+uint32_t no_os_sched_run_once(void);
+
+/* Run the scheduler loop, sleeping when there is nothing to do. */
+void no_os_sched_run(void);
+
+/* Sleep until an interrupt, if no work is pending. Platform specific. */
+void no_os_sched_idle(void);
+
+/* Prevent the deep sleep states, e.g. during a DMA transfer. */
+void no_os_sched_deep_lock(void);
+
+/* Allow the deep sleep states again, from any context. */
+void no_os_sched_deep_unlock(void);
+
+/* Set the RTC waking up the deep sleep states for the next timer. */
+void no_os_sched_set_wakeup_rtc(struct no_os_rtc_desc *rtc);
+
+/* Get the RTC set with no_os_sched_set_wakeup_rtc. */
+struct no_os_rtc_desc *no_os_sched_wakeup_rtc(void);
+
+/* Get the deepest sleep state allowed and for how long, in no_os_sched_idle. */
+enum no_os_sched_sleep no_os_sched_sleep_level(uint32_t *sleep_ms);
+
+/* Account for ms during which the time base was stopped by a deep sleep. */
+void no_os_sched_time_skip(uint32_t ms);
+
+#ifdef NO_OS_SCHED
+/* Run the other posted works and expired timers once. */
+void no_os_sched_yield(void);
+
+/* Wait ms milliseconds, running the other works meanwhile. */
+void no_os_sched_delay_ms(uint32_t ms);
+#endif
+
+#endif // _NO_OS_SCHED_H_
@@ -45,6 +45,9 @@
 /******************************************************************************/
 
 #include <stdint.h>
+#ifdef NO_OS_STATIC_OPS
+#include "no_os_static_ops.h"
+#endif
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -107,6 +110,13 @@ struct no_os_spi_msg {
 	uint32_t		cs_delay_last;
 };
 
+/**
+ * @brief Callback called when an asynchronous transfer is done.
+ * @param ctx - Parameter given to no_os_spi_transfer_async().
+ * @param ret - 0 if all the messages were sent, negative error code otherwise.
+ */
+typedef void (*no_os_spi_callback)(void *ctx, int32_t ret);
+
 /**
  * @struct no_os_spi_platform_ops
  * @brief Structure holding SPI function pointers that point to the platform
@@ -114,6 +124,28 @@ struct no_os_spi_msg {
  */
 struct no_os_spi_platform_ops ;
 
+/**
+ * @struct no_os_spi_bus_desc
+ * @brief Shared SPI bus. Serializes the transactions of all the descriptors
+ * attached to it, including the ones started from interrupt context. The
+ * context finding the bus idle sends the whole queue, an interrupt included.
+ */
+struct no_os_spi_bus_desc;
+
+/**
+ * @struct no_os_spi_bus_init_param
+ * @brief Structure holding the parameters for shared SPI bus initialization
+ */
+struct no_os_spi_bus_init_param {
+	/** Number of transactions that can be queued. Must be a power of 2 */
+	uint32_t	queue_size;
+	/**
+	 * Maximum number of messages sent in one transfer when back-to-back
+	 * transactions for the same device are merged. 0 disables merging.
+	 */
+	uint32_t	batch_size;
+};
+
 /**
  * @struct no_os_spi_init_param
  * @brief Structure holding the parameters for SPI initialization
@@ -134,6 +166,8 @@ struct no_os_spi_init_param {
 	void		*extra;
 	/** Parent of the device */
 	struct no_os_spi_desc *parent;
+	/** Shared bus of the device. If NULL, the bus is used directly */
+	struct no_os_spi_bus_desc *bus;
 };
 
 /**
@@ -156,6 +190,8 @@ struct no_os_spi_desc {
 	void		*extra;
 	/** Parent of the device */
 	struct no_os_spi_desc *parent;
+	/** Shared bus of the device. If NULL, the bus is used directly */
+	struct no_os_spi_bus_desc *bus;
 };
 
 /**
@@ -170,6 +206,9 @@ struct no_os_spi_platform_ops {
 	int32_t (*write_and_read)(struct no_os_spi_desc *, uint8_t *, uint16_t);
 	/** Iterate over the spi_msg array and send all messages at once */
 	int32_t (*transfer)(struct no_os_spi_desc *, struct no_os_spi_msg *, uint32_t);
+	/** Start sending the spi_msg array and return, without waiting for it */
+	int32_t (*transfer_async)(struct no_os_spi_desc *, struct no_os_spi_msg *,
+				  uint32_t, no_os_spi_callback, void *);
 	/** SPI remove function pointer */
 	int32_t (*remove)(struct no_os_spi_desc *);
 };
@@ -185,15 +224,65 @@ int32_t no_os_spi_init(struct no_os_spi_desc **desc,
 /* Free the resources allocated by no_os_spi_init(). */
 int32_t no_os_spi_remove(struct no_os_spi_desc *desc);
 
+#ifndef NO_OS_STATIC_OPS
 /* Write and read data to/from SPI. */
 int32_t no_os_spi_write_and_read(struct no_os_spi_desc *desc,
 				 uint8_t *data,
 				 uint16_t bytes_number);
+#endif
 
 /* Iterate over the spi_msg array and send all messages at once */
 int32_t no_os_spi_transfer(struct no_os_spi_desc *desc,
 			   struct no_os_spi_msg *msgs,
 			   uint32_t len);
 
+/* Start sending the spi_msg array, callback is called when it is done */
+int32_t no_os_spi_transfer_async(struct no_os_spi_desc *desc,
+				 struct no_os_spi_msg *msgs,
+				 uint32_t len,
+				 no_os_spi_callback callback,
+				 void *ctx);
+
+/* Initialize a shared SPI bus. */
+int32_t no_os_spi_bus_init(struct no_os_spi_bus_desc **bus,
+			   const struct no_os_spi_bus_init_param *param);
+
+/* Free the resources allocated by no_os_spi_bus_init(). */
+int32_t no_os_spi_bus_remove(struct no_os_spi_bus_desc *bus);
+
+/* Wait hook of the blocking transactions on a busy bus, weak. */
+void no_os_spi_bus_yield(void);
+
+#ifdef NO_OS_STATIC_OPS
+/* Write and read data to/from SPI through the platform_ops of desc. */
+int32_t no_os_spi_write_and_read_ops(struct no_os_spi_desc *desc,
+				     uint8_t *data,
+				     uint16_t bytes_number);
+
+extern const struct no_os_spi_platform_ops NO_OS_STATIC_SPI_OPS;
+
+int32_t NO_OS_STATIC_SPI_WRITE_AND_READ(struct no_os_spi_desc *desc,
+					uint8_t *data,
+					uint16_t bytes_number);
+
+/**
+ * @brief Write and read data to/from SPI, calling the platform driver directly
+ * when desc uses NO_OS_STATIC_SPI_OPS and is not on a shared bus.
+ * @param desc - The SPI descriptor.
+ * @param data - The buffer with the transmitted/received data.
+ * @param bytes_number - Number of bytes to write/read.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static inline int32_t no_os_spi_write_and_read(struct no_os_spi_desc *desc,
+		uint8_t *data,
+		uint16_t bytes_number)
+{
+	if (desc && desc->platform_ops == &NO_OS_STATIC_SPI_OPS && !desc->bus)
+		return NO_OS_STATIC_SPI_WRITE_AND_READ(desc, data,
+						       bytes_number);
+
+	return no_os_spi_write_and_read_ops(desc, data, bytes_number);
+}
+#endif
 
 #endif // _NO_OS_SPI_H_
@@ -0,0 +1,95 @@
+/***************************************************************************//**
+ *   @file   no_os_static_ops.h
+ *   @brief  Platform driver bound at compile time to the SPI and GPIO API.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef _NO_OS_STATIC_OPS_H_
+#define _NO_OS_STATIC_OPS_H_
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/*
+ * With NO_OS_STATIC_OPS (STATIC_OPS=y) no_os_spi_write_and_read,
+ * no_os_gpio_set_value and no_os_gpio_get_value are inline functions calling
+ * the driver of the platform directly for the descriptors using its ops. The
+ * other descriptors, SPI engines or GPIO expanders for example, still go
+ * through their platform_ops. The SPI and GPIO drivers of the platform must be
+ * part of the build.
+ */
+#if defined(STM32_PLATFORM)
+#define NO_OS_STATIC_SPI_OPS			stm32_spi_ops
+#define NO_OS_STATIC_SPI_WRITE_AND_READ		stm32_spi_write_and_read
+#define NO_OS_STATIC_GPIO_OPS			stm32_gpio_ops
+#define NO_OS_STATIC_GPIO_SET_VALUE		stm32_gpio_set_value
+#define NO_OS_STATIC_GPIO_GET_VALUE		stm32_gpio_get_value
+#elif defined(MAXIM_PLATFORM)
+#define NO_OS_STATIC_SPI_OPS			max_spi_ops
+#define NO_OS_STATIC_SPI_WRITE_AND_READ		max_spi_write_and_read
+#define NO_OS_STATIC_GPIO_OPS			max_gpio_ops
+#define NO_OS_STATIC_GPIO_SET_VALUE		max_gpio_set_value
+#define NO_OS_STATIC_GPIO_GET_VALUE		max_gpio_get_value
+#elif defined(ADUCM_PLATFORM)
+#define NO_OS_STATIC_SPI_OPS			aducm_spi_ops
+#define NO_OS_STATIC_SPI_WRITE_AND_READ		\
+	aducm3029_spi_write_and_read
+#define NO_OS_STATIC_GPIO_OPS			aducm_gpio_ops
+#define NO_OS_STATIC_GPIO_SET_VALUE		aducm3029_gpio_set_value
+#define NO_OS_STATIC_GPIO_GET_VALUE		aducm3029_gpio_get_value
+#elif defined(PICO_PLATFORM)
+#define NO_OS_STATIC_SPI_OPS			pico_spi_ops
+#define NO_OS_STATIC_SPI_WRITE_AND_READ		pico_spi_write_and_read
+#define NO_OS_STATIC_GPIO_OPS			pico_gpio_ops
+#define NO_OS_STATIC_GPIO_SET_VALUE		pico_gpio_set_value
+#define NO_OS_STATIC_GPIO_GET_VALUE		pico_gpio_get_value
+#elif defined(XILINX_PLATFORM)
+/* PS SPI, the PL SPI (xil_spi_pl_ops) goes through its platform_ops */
+#define NO_OS_STATIC_SPI_OPS			xil_spi_ops
+#define NO_OS_STATIC_SPI_WRITE_AND_READ		xil_spi_write_and_read
+#define NO_OS_STATIC_GPIO_OPS			xil_gpio_ops
+#define NO_OS_STATIC_GPIO_SET_VALUE		xil_gpio_set_value
+#define NO_OS_STATIC_GPIO_GET_VALUE		xil_gpio_get_value
+#elif defined(LINUX_PLATFORM)
+#define NO_OS_STATIC_SPI_OPS			linux_spi_ops
+#define NO_OS_STATIC_SPI_WRITE_AND_READ		linux_spi_write_and_read
+#define NO_OS_STATIC_GPIO_OPS			linux_gpio_ops
+#define NO_OS_STATIC_GPIO_SET_VALUE		linux_gpio_set_value
+#define NO_OS_STATIC_GPIO_GET_VALUE		linux_gpio_get_value
+#else
+#error "NO_OS_STATIC_OPS is not supported on this platform"
+#endif
+
+#endif // _NO_OS_STATIC_OPS_H_
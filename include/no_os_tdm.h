@@ -49,6 +49,15 @@
  */
 struct no_os_tdm_platform_ops;
 
+/**
+ * @brief Called from interrupt context during a circular read, each time a
+ * half of the buffer is filled.
+ * @param ctx - Parameter given to no_os_tdm_read_start().
+ * @param data - The filled half, to be processed before the next half is.
+ * @param nb_samples - Number of samples in data.
+ */
+typedef void (*no_os_tdm_callback)(void *ctx, void *data, uint32_t nb_samples);
+
 enum no_os_tdm_mode {
 	NO_OS_TDM_MASTER_TX,
 	NO_OS_TDM_MASTER_RX,
@@ -111,6 +120,11 @@ struct no_os_tdm_platform_ops {
 	int32_t (*tdm_ops_write)(struct no_os_tdm_desc *, void *, uint16_t);
 	/** TDM remove operation function pointer */
 	int32_t (*tdm_ops_remove)(struct no_os_tdm_desc *);
+	/** Start of a continuous read in a circular buffer, optional */
+	int32_t (*tdm_ops_read_start)(struct no_os_tdm_desc *, void *, uint32_t,
+				      no_os_tdm_callback, void *);
+	/** Stop of the continuous read */
+	int32_t (*tdm_ops_stop)(struct no_os_tdm_desc *);
 };
 
 /* Initialize the TDM communication peripheral. */
@@ -130,4 +144,12 @@ int32_t  no_os_tdm_write(struct no_os_tdm_desc *desc,
 			 void *data,
 			 uint16_t bytes_number);
 
+/* Read continuously in a circular buffer, callback getting each half. */
+int32_t no_os_tdm_read_start(struct no_os_tdm_desc *desc, void *data,
+			     uint32_t nb_samples, no_os_tdm_callback callback,
+			     void *ctx);
+
+/* Stop the read started by no_os_tdm_read_start(). */
+int32_t no_os_tdm_stop(struct no_os_tdm_desc *desc);
+
 #endif // _NO_OS_TDM_H_
@@ -0,0 +1,131 @@
+/***************************************************************************//**
+ *   @file   no_os_trace.h
+ *   @brief  Header file of the timestamped enter/exit event trace.
+********************************************************************************
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef _NO_OS_TRACE_H_
+#define _NO_OS_TRACE_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/*
+ * Events are recorded only when NO_OS_TRACE is defined, the macros compile to
+ * nothing otherwise. The last NO_OS_TRACE_DEPTH events are kept, it must be a
+ * power of 2.
+ */
+#ifndef NO_OS_TRACE_DEPTH
+#define NO_OS_TRACE_DEPTH	256
+#endif
+
+/* Length of the longest line written by no_os_trace_print, with the '\0' */
+#define NO_OS_TRACE_LINE_SIZE	24
+
+#ifdef NO_OS_TRACE
+#define NO_OS_TRACE_ENTER(id)	no_os_trace_event((id), NO_OS_TRACE_TYPE_ENTER)
+#define NO_OS_TRACE_EXIT(id)	no_os_trace_event((id), NO_OS_TRACE_TYPE_EXIT)
+#else
+#define NO_OS_TRACE_ENTER(id)	do {} while (0)
+#define NO_OS_TRACE_EXIT(id)	do {} while (0)
+#endif
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @enum no_os_trace_id
+ * @brief Instrumented code. Applications use ids from NO_OS_TRACE_USER on.
+ */
+enum no_os_trace_id {
+	NO_OS_TRACE_IIO_STEP,
+	NO_OS_TRACE_IIOD_CONN_STEP,
+	NO_OS_TRACE_AXI_DMAC_ISR,
+	NO_OS_TRACE_SPI_TRANSFER,
+	NO_OS_TRACE_USER = 0x100,
+};
+
+enum no_os_trace_type {
+	NO_OS_TRACE_TYPE_ENTER,
+	NO_OS_TRACE_TYPE_EXIT,
+};
+
+/**
+ * @struct no_os_trace_event
+ * @brief Recorded event.
+ */
+struct no_os_trace_event {
+	/** Value of the counter of no_os_trace_timestamp */
+	uint32_t timestamp;
+	/** enum no_os_trace_id */
+	uint16_t id;
+	/** enum no_os_trace_type */
+	uint16_t type;
+};
+
+struct no_os_uart_desc;
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Record an event, from any context. */
+void no_os_trace_event(uint16_t id, uint16_t type);
+
+/* Get and remove the oldest recorded events. */
+uint32_t no_os_trace_read(struct no_os_trace_event *events, uint32_t nb,
+			  uint32_t *lost);
+
+/* Get and remove the oldest events, formatted as text lines. */
+uint32_t no_os_trace_print(char *buf, uint32_t len);
+
+/* Write all the recorded events as text lines on a UART. */
+int32_t no_os_trace_dump(struct no_os_uart_desc *uart);
+
+/*
+ * Free running counter of the platform: CPU cycles on Cortex-M, global timer
+ * ticks on Zynq and microseconds elsewhere.
+ */
+uint32_t no_os_trace_timestamp(void);
+
+#endif // _NO_OS_TRACE_H_
@@ -46,6 +46,7 @@
 /******************************************************************************/
 
 #include <stdint.h>
+#include <stdbool.h>
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -68,6 +69,18 @@ struct no_os_trng_init_param {
 	void		*extra;
 };
 
+/**
+ * @brief Callback receiving the random bytes generated in background. Called
+ * from the TRNG interrupt.
+ * @param ctx - Parameter given to no_os_trng_start_async().
+ * @param data - Random bytes.
+ * @param len - Number of bytes.
+ * @return true to keep generating, false to stop until the next
+ * no_os_trng_start_async() call.
+ */
+typedef bool (*no_os_trng_callback)(void *ctx, const uint8_t *data,
+				    uint32_t len);
+
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
 /******************************************************************************/
@@ -83,4 +96,11 @@ void no_os_trng_remove(struct no_os_trng_desc *desc);
 int32_t no_os_trng_fill_buffer(struct no_os_trng_desc *desc, uint8_t *buff,
 			       uint32_t len);
 
+/* Generate random numbers in background, passing them to callback */
+int32_t no_os_trng_start_async(struct no_os_trng_desc *desc,
+			       no_os_trng_callback callback, void *ctx);
+
+/* Stop the background generation */
+void no_os_trng_stop_async(struct no_os_trng_desc *desc);
+
 #endif // _NO_OS_TRNG_H_
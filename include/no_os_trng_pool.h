@@ -0,0 +1,110 @@
+/***************************************************************************//**
+ *   @file   no_os_trng_pool.h
+ *   @brief  Header file of the entropy pool filled by the TRNG.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef _NO_OS_TRNG_POOL_H_
+#define _NO_OS_TRNG_POOL_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "no_os_trng.h"
+#include "no_os_lffifo.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct no_os_trng_pool
+ * @brief Random bytes generated ahead by the TRNG. The TRNG interrupt writes
+ * the pool and the users read it, without locking.
+ */
+struct no_os_trng_pool {
+	/** TRNG filling the pool */
+	struct no_os_trng_desc	*trng;
+	/** Random bytes, single producer and single consumer */
+	struct no_os_lffifo	*fifo;
+	/** The generation restarts when this many bytes or less are left */
+	uint32_t		low_watermark;
+	/** Set while the TRNG fills the pool */
+	volatile bool		running;
+	/** Set when the TRNG can't generate in background, the pool is then
+	 *  bypassed and the reads wait for the TRNG */
+	bool			blocking;
+};
+
+/**
+ * @struct no_os_trng_pool_init_param
+ * @brief Init parameter of the entropy pool
+ */
+struct no_os_trng_pool_init_param {
+	/** Init param of the TRNG, owned by the pool */
+	struct no_os_trng_init_param	*trng_init_param;
+	/** Size of the pool in bytes, must be a power of 2 */
+	uint32_t			size;
+	/** Refill threshold in bytes, 0 for half of the pool */
+	uint32_t			low_watermark;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Initialize the pool, which starts filling in background. */
+int32_t no_os_trng_pool_init(struct no_os_trng_pool **pool,
+			     struct no_os_trng_pool_init_param *param);
+
+/* Free the resources allocated by no_os_trng_pool_init(). */
+void no_os_trng_pool_remove(struct no_os_trng_pool *pool);
+
+/* Number of random bytes ready in the pool. */
+uint32_t no_os_trng_pool_count(struct no_os_trng_pool *pool);
+
+/* Fill buffer with random bytes, waiting for them if the pool is short. */
+int32_t no_os_trng_pool_fill_buffer(struct no_os_trng_pool *pool,
+				    uint8_t *buff, uint32_t len);
+
+/* Entropy source for mbedtls_entropy_add_source(), never waits. */
+int no_os_trng_pool_entropy(void *data, unsigned char *output, size_t len,
+			    size_t *olen);
+
+#endif // _NO_OS_TRNG_POOL_H_
@@ -45,7 +45,18 @@
 
 #include <stdint.h>
 #include <stdbool.h>
-#include "no_os_lf256fifo.h"
+#include "no_os_lffifo.h"
+#include "no_os_circular_buffer.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Default sizes of the DMA reception buffers */
+#define NO_OS_UART_RX_DMA_SIZE		256
+#define NO_OS_UART_RX_BUFF_SIZE		4096
+/* Size of the software fifo of the interrupt reception, a power of 2 */
+#define NO_OS_UART_RX_FIFO_SIZE		256
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -114,6 +125,16 @@ struct no_os_uart_init_param {
 	uint32_t irq_id;
 	/** If set, the reception is interrupt driven. */
 	bool asynchronous_rx;
+	/**
+	 * If set, the reception is done by DMA in a circular buffer of
+	 * rx_dma_size bytes. The received data is moved to a software buffer
+	 * of rx_buff_size bytes, a power of 2, on line idle and on half and
+	 * full DMA buffer, instead of an interrupt per byte. Sizes of 0 select
+	 * the defaults.
+	 */
+	bool dma_rx;
+	uint32_t rx_dma_size;
+	uint32_t rx_buff_size;
 	/** UART Baud Rate */
 	uint32_t        baud_rate;
 	/** UART number of data bits */
@@ -137,7 +158,16 @@ struct no_os_uart_desc {
 	/** UART Interrupt ID */
 	uint32_t	irq_id;
 	/** Software FIFO. */
-	struct lf256fifo *rx_fifo;
+	struct no_os_lffifo *rx_fifo;
+	/** Software buffer of the DMA reception */
+	struct no_os_circular_buffer *rx_cb;
+	/** Circular buffer written by the DMA */
+	uint8_t		*rx_dma_buf;
+	uint32_t	rx_dma_size;
+	/** Offset in rx_dma_buf of the next byte to be moved to rx_cb */
+	uint32_t	rx_dma_pos;
+	/** Received bytes dropped, rx_cb being full */
+	uint32_t	rx_dropped;
 	/** UART Baud Rate */
 	uint32_t 	baud_rate;
 	const struct no_os_uart_platform_ops *platform_ops;
@@ -202,4 +232,16 @@ uint32_t no_os_uart_get_errors(struct no_os_uart_desc *desc);
 /* Make stdio to use this UART. */
 void no_os_uart_stdio(struct no_os_uart_desc *desc);
 
+/* DMA reception helpers, used by the platform drivers. */
+/* Allocate the buffers of the DMA reception. */
+int32_t no_os_uart_dma_rx_init(struct no_os_uart_desc *desc,
+			       struct no_os_uart_init_param *param);
+/* Free the buffers of the DMA reception. */
+void no_os_uart_dma_rx_remove(struct no_os_uart_desc *desc);
+/* Move the bytes written by the DMA before pos to the software buffer. */
+void no_os_uart_dma_rx_update(struct no_os_uart_desc *desc, uint32_t pos);
+/* Read the received bytes from the software buffer. */
+int32_t no_os_uart_dma_rx_read(struct no_os_uart_desc *desc, uint8_t *data,
+			       uint32_t bytes_number);
+
 #endif // _NO_OS_UART_H_
@@ -0,0 +1,183 @@
+/***************************************************************************//**
+ *   @file   no_os_usb.h
+ *   @brief  Header file of the USB device bulk pipes.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef _NO_OS_USB_H_
+#define _NO_OS_USB_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Maximum number of pipes, a pipe being a pair of bulk IN and OUT endpoints */
+#define NO_OS_USB_MAX_PIPES	4
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @enum no_os_usb_pipe_cmd
+ * @brief Vendor requests of the libiio USB backend, sent on the control
+ * endpoint to the interface named "IIO". wValue is the pipe index.
+ */
+enum no_os_usb_pipe_cmd {
+	/** Close all the pipes, sent when libiio opens the context */
+	NO_OS_USB_CMD_RESET_PIPES,
+	/** Open the pipe of wValue */
+	NO_OS_USB_CMD_OPEN_PIPE,
+	/** Close the pipe of wValue */
+	NO_OS_USB_CMD_CLOSE_PIPE,
+};
+
+struct no_os_usb_desc;
+struct no_os_usb_platform_ops;
+
+/**
+ * @struct no_os_usb_pipe
+ * @brief Byte stream carried by a pair of bulk endpoints. It is opened and
+ * closed by the host, the data written while it is closed is dropped.
+ */
+struct no_os_usb_pipe {
+	/** USB device of the pipe */
+	struct no_os_usb_desc *desc;
+	/** Index of the pipe, from 0 */
+	uint32_t id;
+	/** Set while the host has the pipe open */
+	volatile bool open;
+	/** Incremented at each open, to tell a reopened pipe apart */
+	volatile uint32_t session;
+};
+
+/**
+ * @struct no_os_usb_init_param
+ * @brief Structure holding the parameters for USB device initialization
+ */
+struct no_os_usb_init_param {
+	/** USB controller ID */
+	uint32_t device_id;
+	/** Vendor and product IDs of the device descriptor */
+	uint16_t vendor_id;
+	uint16_t product_id;
+	/** Serial number string, the libiio URI is usb:<bus>.<address> */
+	const char *serial_number;
+	/** Number of pipes, up to NO_OS_USB_MAX_PIPES */
+	uint32_t nb_pipes;
+	/**
+	 * Bytes of each packet buffer. Each endpoint gets two, one being
+	 * filled or emptied by the controller while the other is processed.
+	 * 0 for the maximum packet size of the endpoints.
+	 */
+	uint32_t packet_size;
+	const struct no_os_usb_platform_ops *platform_ops;
+	/** USB extra parameters (device specific) */
+	void *extra;
+};
+
+/**
+ * @struct no_os_usb_desc
+ * @brief Structure holding the USB device descriptor.
+ */
+struct no_os_usb_desc {
+	/** USB controller ID */
+	uint32_t device_id;
+	/** Number of pipes */
+	uint32_t nb_pipes;
+	/** Pipes of the IIO interface */
+	struct no_os_usb_pipe pipes[NO_OS_USB_MAX_PIPES];
+	const struct no_os_usb_platform_ops *platform_ops;
+	/** USB extra parameters (device specific) */
+	void *extra;
+};
+
+/**
+ * @struct no_os_usb_platform_ops
+ * @brief Structure holding USB device function pointers that point to the
+ * platform specific function. The driver answers the vendor requests of
+ * enum no_os_usb_pipe_cmd with no_os_usb_pipe_ctrl().
+ */
+struct no_os_usb_platform_ops {
+	/** USB device initialization function pointer */
+	int32_t (*init)(struct no_os_usb_desc **,
+			const struct no_os_usb_init_param *);
+	/**
+	 * Copy the data received on the OUT endpoint of a pipe, without
+	 * waiting. Returns the number of bytes copied, -EAGAIN if none.
+	 */
+	int32_t (*read)(struct no_os_usb_desc *, uint32_t, uint8_t *, uint32_t);
+	/**
+	 * Queue data for the IN endpoint of a pipe, without waiting. Returns
+	 * the number of bytes queued, -EAGAIN while both packet buffers are
+	 * busy. A transfer ending with a full packet is followed by a zero
+	 * length packet.
+	 */
+	int32_t (*write)(struct no_os_usb_desc *, uint32_t, const uint8_t *,
+			 uint32_t);
+	/** USB device remove function pointer */
+	int32_t (*remove)(struct no_os_usb_desc *);
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Initialize the USB device and its pipes. */
+int32_t no_os_usb_init(struct no_os_usb_desc **desc,
+		       const struct no_os_usb_init_param *param);
+
+/* Free the resources allocated by no_os_usb_init(). */
+int32_t no_os_usb_remove(struct no_os_usb_desc *desc);
+
+/* Read the data received on pipe, without waiting. */
+int32_t no_os_usb_read(struct no_os_usb_pipe *pipe, uint8_t *data,
+		       uint32_t len);
+
+/* Send data on pipe, without waiting. */
+int32_t no_os_usb_write(struct no_os_usb_pipe *pipe, const uint8_t *data,
+			uint32_t len);
+
+/* Handle a vendor request opening or closing pipes, from the driver. */
+int32_t no_os_usb_pipe_ctrl(struct no_os_usb_desc *desc,
+			    enum no_os_usb_pipe_cmd cmd, uint32_t pipe);
+
+#endif // _NO_OS_USB_H_
@@ -149,6 +149,8 @@ unsigned int no_os_hweight8(uint8_t word);
 unsigned int no_os_hweight16(uint16_t word);
 /* Calculate the number of set bits (32-bit size). */
 unsigned int no_os_hweight32(uint32_t word);
+/* Unsigned 64bit divide with 32bit divisor, quotient in n, returns remainder */
+uint32_t no_os_div64_32(uint64_t *n, uint32_t base);
 /* Calculate the quotient and the remainder of an integer division. */
 uint64_t no_os_do_div(uint64_t* n,
 		      uint64_t base);
@@ -292,6 +292,66 @@ void jesd204_copy_link_params(struct jesd204_link *dst,
 	dst->sysref.lmfc_offset = src->sysref.lmfc_offset;
 }
 
+/* no-OS specific */
+static uint32_t jesd204_hash_add(uint32_t hash, uint32_t val)
+{
+	int i;
+
+	/* FNV-1a, one byte at a time */
+	for (i = 0; i < 4; i++) {
+		hash ^= val & 0xff;
+		hash *= 16777619u;
+		val >>= 8;
+	}
+
+	return hash;
+}
+
+/*
+ * no-OS specific
+ * Hash of the parameters copied by jesd204_copy_link_params() and of the
+ * rates, used by the FSM to find out that a link was reconfigured.
+ */
+uint32_t jesd204_link_params_hash(const struct jesd204_link *lnk)
+{
+	uint32_t hash = 2166136261u;
+	int i;
+
+	hash = jesd204_hash_add(hash, lnk->is_transmit);
+	hash = jesd204_hash_add(hash, lnk->num_lanes);
+	hash = jesd204_hash_add(hash, lnk->num_converters);
+	hash = jesd204_hash_add(hash, lnk->octets_per_frame);
+	hash = jesd204_hash_add(hash, lnk->frames_per_multiframe);
+	hash = jesd204_hash_add(hash, lnk->num_of_multiblocks_in_emb);
+	hash = jesd204_hash_add(hash, lnk->bits_per_sample);
+	hash = jesd204_hash_add(hash, lnk->converter_resolution);
+	hash = jesd204_hash_add(hash, lnk->jesd_version);
+	hash = jesd204_hash_add(hash, lnk->jesd_encoder);
+	hash = jesd204_hash_add(hash, lnk->subclass);
+	hash = jesd204_hash_add(hash, lnk->device_id);
+	hash = jesd204_hash_add(hash, lnk->bank_id);
+	hash = jesd204_hash_add(hash, lnk->scrambling);
+	hash = jesd204_hash_add(hash, lnk->high_density);
+	hash = jesd204_hash_add(hash, lnk->ctrl_words_per_frame_clk);
+	hash = jesd204_hash_add(hash, lnk->ctrl_bits_per_sample);
+	hash = jesd204_hash_add(hash, lnk->samples_per_conv_frame);
+	hash = jesd204_hash_add(hash, lnk->dac_adj_resolution_steps);
+	hash = jesd204_hash_add(hash, lnk->dac_adj_direction);
+	hash = jesd204_hash_add(hash, lnk->dac_phase_adj);
+	hash = jesd204_hash_add(hash, lnk->sysref.mode);
+	hash = jesd204_hash_add(hash, lnk->sysref.capture_falling_edge);
+	hash = jesd204_hash_add(hash, lnk->sysref.valid_falling_edge);
+	hash = jesd204_hash_add(hash, lnk->sysref.lmfc_offset);
+	hash = jesd204_hash_add(hash, (uint32_t)lnk->sample_rate);
+	hash = jesd204_hash_add(hash, (uint32_t)(lnk->sample_rate >> 32));
+	hash = jesd204_hash_add(hash, lnk->sample_rate_div);
+	if (lnk->lane_ids)
+		for (i = 0; i < lnk->num_lanes; i++)
+			hash = jesd204_hash_add(hash, lnk->lane_ids[i]);
+
+	return hash;
+}
+
 int jesd204_link_get_lmfc_lemc_rate(struct jesd204_link *lnk,
 				    unsigned long *rate_hz)
 {
@@ -5,53 +5,328 @@
  */
 
 #include "no_os_error.h"
+#include "no_os_delay.h"
+#include "no_os_print_log.h"
 #include "jesd204-priv.h"
 
 /* no-OS specific */
-int jesd204_fsm_start(struct jesd204_topology *topology, unsigned int link_idx)
+static int jesd204_fsm_op_result(struct jesd204_dev *jdev, int ret)
+{
+	if (ret == JESD204_STATE_CHANGE_DEFER) {
+		atomic_fetch_add(&jdev->ops_pending, 1);
+		return 0;
+	}
+
+	if (ret < 0)
+		return ret;
+
+	return 0;
+}
+
+/* no-OS specific */
+static int jesd204_fsm_per_device(struct jesd204_dev *jdev,
+				  enum jesd204_dev_op op,
+				  enum jesd204_state_op_reason reason)
+{
+	const struct jesd204_state_op *state_op = &jdev->dev_data->state_ops[op];
+
+	if (!state_op->per_device)
+		return 0;
+
+	return jesd204_fsm_op_result(jdev, state_op->per_device(jdev, reason));
+}
+
+/* no-OS specific */
+static int jesd204_fsm_per_link(struct jesd204_dev *jdev,
+				enum jesd204_dev_op op,
+				enum jesd204_state_op_reason reason,
+				struct jesd204_link *lnk)
+{
+	const struct jesd204_state_op *state_op = &jdev->dev_data->state_ops[op];
+
+	if (!state_op->per_link)
+		return 0;
+
+	return jesd204_fsm_op_result(jdev, state_op->per_link(jdev, reason,
+				     lnk));
+}
+
+/* no-OS specific */
+static int jesd204_fsm_dev_wait(struct jesd204_dev *jdev, unsigned int *ms)
+{
+	while (atomic_load(&jdev->ops_pending) > 0) {
+		if (jdev->dev_data->poll_cb)
+			jdev->dev_data->poll_cb(jdev);
+		if (atomic_load(&jdev->ops_pending) <= 0)
+			break;
+		if (*ms >= JESD204_FSM_DEFER_TIMEOUT_MS)
+			return -ETIMEDOUT;
+		no_os_mdelay(1);
+		(*ms)++;
+	}
+
+	return atomic_exchange(&jdev->ops_error, 0);
+}
+
+/*
+ * no-OS specific
+ * Barrier at the end of a state: wait for the deferred ops of all the
+ * devices, so the ops of all the links of a state run together.
+ */
+static int jesd204_fsm_wait(struct jesd204_topology *topology)
+{
+	unsigned int ms = 0;
+	int dev;
+	int ret;
+
+	ret = jesd204_fsm_dev_wait(topology->dev_top->jdev, &ms);
+	for (dev = 0; dev < topology->devs_number; dev++) {
+		if (ret)
+			break;
+		ret = jesd204_fsm_dev_wait(topology->devs[dev].jdev, &ms);
+	}
+
+	if (ret == -ETIMEDOUT)
+		pr_err("timeout waiting for deferred JESD204 state ops\n");
+
+	return ret;
+}
+
+/* no-OS specific */
+void jesd204_fsm_op_done(struct jesd204_dev *jdev, int ret)
+{
+	int expected = 0;
+
+	if (!jdev)
+		return;
+
+	if (ret < 0)
+		atomic_compare_exchange_strong(&jdev->ops_error, &expected, ret);
+
+	atomic_fetch_sub(&jdev->ops_pending, 1);
+}
+
+/*
+ * no-OS specific
+ * Get the range of active link indexes selected by link_idx, all the links
+ * for JESD204_LINKS_ALL.
+ */
+static int jesd204_fsm_link_range(struct jesd204_topology *topology,
+				  unsigned int link_idx, int *first, int *last)
+{
+	if (!topology || !topology->dev_top)
+		return -EINVAL;
+
+	if (link_idx == JESD204_LINKS_ALL) {
+		*first = 0;
+		*last = topology->dev_top->num_links - 1;
+		return 0;
+	}
+
+	if (link_idx >= topology->dev_top->num_links)
+		return -EINVAL;
+
+	*first = link_idx;
+	*last = link_idx;
+
+	return 0;
+}
+
+/*
+ * no-OS specific
+ * Run the state op op for the links lnk_first to lnk_last. The per device ops
+ * are only run when all the links are selected.
+ */
+static int jesd204_fsm_run_op(struct jesd204_topology *topology,
+			      enum jesd204_dev_op op, int lnk_first,
+			      int lnk_last, bool all_links)
 {
 	enum jesd204_state_op_reason reason = JESD204_STATE_OP_REASON_INIT;
 	struct jesd204_dev_top *jdev_top = topology->dev_top;
+	struct jesd204_dev *jdev;
 	bool per_device_op_done[16];
-	enum jesd204_dev_op op;
 	int lnk_dev;
 	int lnk_id;
 	int dev;
+	int ret;
 
-	for (op = 0; op < __JESD204_MAX_OPS; op++) {
-		for (dev = 0; dev < topology->devs_number; dev++)
-			per_device_op_done[dev] = false;
-
-		for (lnk_id = 0; lnk_id < jdev_top->num_links; lnk_id++) {
-			for (dev = 0; dev < topology->devs_number; dev++) {
-				for (lnk_dev = 0; lnk_dev < topology->devs[dev].links_number; lnk_dev++) {
-					if (topology->devs[dev].link_ids[lnk_dev] == jdev_top->link_ids[lnk_id]) {
-						if (topology->devs[dev].jdev->dev_data->state_ops[op].per_device
-						    && !per_device_op_done[dev]) {
-							topology->devs[dev].jdev->dev_data->state_ops[op].per_device(
-								topology->devs[dev].jdev, reason);
-							per_device_op_done[dev] = true;
-						}
-						if (topology->devs[dev].jdev->dev_data->state_ops[op].per_link)
-							topology->devs[dev].jdev->dev_data->state_ops[op].per_link(
-								topology->devs[dev].jdev, reason,
-								&jdev_top->active_links[lnk_id].link);
-					}
+	/* Per device ops act on all links, skip them for a single link */
+	for (dev = 0; dev < topology->devs_number; dev++)
+		per_device_op_done[dev] = !all_links;
+
+	for (lnk_id = lnk_first; lnk_id <= lnk_last; lnk_id++) {
+		for (dev = 0; dev < topology->devs_number; dev++) {
+			jdev = topology->devs[dev].jdev;
+			for (lnk_dev = 0; lnk_dev < topology->devs[dev].links_number; lnk_dev++) {
+				if (topology->devs[dev].link_ids[lnk_dev] != jdev_top->link_ids[lnk_id])
+					continue;
+				if (!per_device_op_done[dev]) {
+					ret = jesd204_fsm_per_device(jdev, op, reason);
+					if (ret)
+						return ret;
+					per_device_op_done[dev] = true;
 				}
-			}
-			if (jdev_top->jdev->dev_data->state_ops[op].per_link) {
-				jdev_top->jdev->dev_data->state_ops[op].per_link(jdev_top->jdev, reason,
-						&jdev_top->active_links[lnk_id].link);
-				if (jdev_top->jdev->dev_data->state_ops[op].post_state_sysref)
-					jesd204_sysref_async(jdev_top->jdev);
+				ret = jesd204_fsm_per_link(jdev, op, reason,
+							   &jdev_top->active_links[lnk_id].link);
+				if (ret)
+					return ret;
 			}
 		}
-		if (jdev_top->jdev->dev_data->state_ops[op].per_device) {
-			jdev_top->jdev->dev_data->state_ops[op].per_device(jdev_top->jdev, reason);
-			if (jdev_top->jdev->dev_data->state_ops[op].post_state_sysref)
+		if (jdev_top->jdev->dev_data->state_ops[op].per_link) {
+			ret = jesd204_fsm_per_link(jdev_top->jdev, op, reason,
+						   &jdev_top->active_links[lnk_id].link);
+			if (ret)
+				return ret;
+			if (jdev_top->jdev->dev_data->state_ops[op].post_state_sysref) {
+				ret = jesd204_fsm_wait(topology);
+				if (ret)
+					return ret;
 				jesd204_sysref_async(jdev_top->jdev);
+			}
 		}
 	}
+	if (all_links && jdev_top->jdev->dev_data->state_ops[op].per_device) {
+		ret = jesd204_fsm_per_device(jdev_top->jdev, op, reason);
+		if (ret)
+			return ret;
+		if (jdev_top->jdev->dev_data->state_ops[op].post_state_sysref) {
+			ret = jesd204_fsm_wait(topology);
+			if (ret)
+				return ret;
+			jesd204_sysref_async(jdev_top->jdev);
+		}
+	}
+
+	return jesd204_fsm_wait(topology);
+}
+
+/*
+ * no-OS specific
+ * Check if the links lnk_first to lnk_last still run with the settings they
+ * were brought up with. LINK_INIT only collects the link parameters from the
+ * drivers, so it is run again to compare them with the snapshot.
+ */
+static int jesd204_fsm_is_warm(struct jesd204_topology *topology,
+			       int lnk_first, int lnk_last, bool all_links,
+			       bool *warm)
+{
+	struct jesd204_link_opaque *ol;
+	int lnk_id;
+	int ret;
+
+	*warm = false;
+	for (lnk_id = lnk_first; lnk_id <= lnk_last; lnk_id++)
+		if (!topology->dev_top->active_links[lnk_id].warm)
+			return 0;
+
+	ret = jesd204_fsm_run_op(topology, JESD204_OP_LINK_INIT, lnk_first,
+				 lnk_last, all_links);
+	if (ret)
+		return ret;
+
+	for (lnk_id = lnk_first; lnk_id <= lnk_last; lnk_id++) {
+		ol = &topology->dev_top->active_links[lnk_id];
+		if (jesd204_link_params_hash(&ol->link) != ol->params_hash)
+			return 0;
+	}
+	*warm = true;
+
+	return 0;
+}
+
+/*
+ * no-OS specific
+ * Save or drop the snapshot of the links lnk_first to lnk_last.
+ */
+static void jesd204_fsm_snapshot(struct jesd204_topology *topology,
+				 int lnk_first, int lnk_last, bool warm)
+{
+	struct jesd204_link_opaque *ol;
+	int lnk_id;
+
+	for (lnk_id = lnk_first; lnk_id <= lnk_last; lnk_id++) {
+		ol = &topology->dev_top->active_links[lnk_id];
+		ol->params_hash = jesd204_link_params_hash(&ol->link);
+		ol->warm = warm;
+	}
+}
+
+/*
+ * no-OS specific
+ * link_idx is an index in the links of the top device, or JESD204_LINKS_ALL.
+ * For a single link only the per link ops are run, so a failing link can be
+ * restarted with jesd204_fsm_stop() and jesd204_fsm_start() without touching
+ * the other links.
+ * Starting links that are already running with unchanged parameters, after a
+ * soft reset of the link for example, only runs the states from LINK_ENABLE
+ * and issues a SYSREF, the clocks and the link setup are kept. Use
+ * jesd204_fsm_invalidate() when something the parameters don't describe, a
+ * clock, was changed.
+ */
+int jesd204_fsm_start(struct jesd204_topology *topology, unsigned int link_idx)
+{
+	struct jesd204_dev_top *jdev_top = topology->dev_top;
+	enum jesd204_dev_op op_first = 0;
+	enum jesd204_dev_op op;
+	bool all_links;
+	bool warm;
+	int lnk_first;
+	int lnk_last;
+	int dev;
+	int ret;
+
+	ret = jesd204_fsm_link_range(topology, link_idx, &lnk_first, &lnk_last);
+	if (ret)
+		return ret;
+	all_links = link_idx == JESD204_LINKS_ALL;
+
+	op = JESD204_OP_LINK_INIT;
+	ret = jesd204_fsm_is_warm(topology, lnk_first, lnk_last, all_links,
+				  &warm);
+	if (ret)
+		goto error;
+	if (warm)
+		op_first = JESD204_OP_LINK_ENABLE;
+
+	for (op = op_first; op < __JESD204_MAX_OPS; op++) {
+		ret = jesd204_fsm_run_op(topology, op, lnk_first, lnk_last,
+					 all_links);
+		if (ret)
+			goto error;
+
+		/* A cold start got its SYSREF from the clock sync states */
+		if (warm && op == JESD204_OP_LINK_ENABLE &&
+		    !jdev_top->jdev->dev_data->state_ops[op].post_state_sysref)
+			jesd204_sysref_async(jdev_top->jdev);
+	}
+
+	jesd204_fsm_snapshot(topology, lnk_first, lnk_last, true);
+
+	return 0;
+error:
+	pr_err("JESD204 state op %d failed (%d)\n", op, ret);
+	jesd204_fsm_snapshot(topology, lnk_first, lnk_last, false);
+	/* Drop the ops still pending, they belong to the failed bring-up */
+	atomic_store(&jdev_top->jdev->ops_pending, 0);
+	for (dev = 0; dev < topology->devs_number; dev++)
+		atomic_store(&topology->devs[dev].jdev->ops_pending, 0);
+
+	return ret;
+}
+
+/* no-OS specific */
+int jesd204_fsm_invalidate(struct jesd204_topology *topology,
+			   unsigned int link_idx)
+{
+	int lnk_first;
+	int lnk_last;
+	int ret;
+
+	ret = jesd204_fsm_link_range(topology, link_idx, &lnk_first, &lnk_last);
+	if (ret)
+		return ret;
+
+	jesd204_fsm_snapshot(topology, lnk_first, lnk_last, false);
 
 	return 0;
 }
@@ -61,40 +336,50 @@ int jesd204_fsm_stop(struct jesd204_topology *topology, unsigned int link_idx)
 {
 	enum jesd204_state_op_reason reason = JESD204_STATE_OP_REASON_UNINIT;
 	struct jesd204_dev_top *jdev_top = topology->dev_top;
+	struct jesd204_dev *jdev;
 	bool per_device_op_done[16];
+	bool all_links;
+	int lnk_first;
+	int lnk_last;
 	int lnk_dev;
 	int lnk_id;
 	int dev;
 	int op;
+	int ret;
+
+	ret = jesd204_fsm_link_range(topology, link_idx, &lnk_first, &lnk_last);
+	if (ret)
+		return ret;
+	all_links = link_idx == JESD204_LINKS_ALL;
+	jesd204_fsm_snapshot(topology, lnk_first, lnk_last, false);
 
+	/* Teardown goes on after errors, deferred ops are only waited for */
 	for (op = __JESD204_MAX_OPS - 1; op >= 0; op--) {
 		for (dev = topology->devs_number - 1; dev >= 0 ; dev--)
-			per_device_op_done[dev] = false;
+			per_device_op_done[dev] = !all_links;
 
-		if (jdev_top->jdev->dev_data->state_ops[op].per_device)
-			jdev_top->jdev->dev_data->state_ops[op].per_device(jdev_top->jdev, reason);
+		if (all_links)
+			jesd204_fsm_per_device(jdev_top->jdev, op, reason);
 
-		for (lnk_id = jdev_top->num_links - 1; lnk_id >= 0; lnk_id--) {
-			if (jdev_top->jdev->dev_data->state_ops[op].per_link)
-				jdev_top->jdev->dev_data->state_ops[op].per_link(jdev_top->jdev, reason,
-						&jdev_top->active_links[lnk_id].link);
+		for (lnk_id = lnk_last; lnk_id >= lnk_first; lnk_id--) {
+			jesd204_fsm_per_link(jdev_top->jdev, op, reason,
+					     &jdev_top->active_links[lnk_id].link);
 			for (dev = topology->devs_number - 1; dev >= 0; dev--) {
+				jdev = topology->devs[dev].jdev;
 				for (lnk_dev = topology->devs[dev].links_number - 1; lnk_dev >= 0; lnk_dev--) {
-					if (topology->devs[dev].link_ids[lnk_dev] == jdev_top->link_ids[lnk_id]) {
-						if (topology->devs[dev].jdev->dev_data->state_ops[op].per_device
-						    && !per_device_op_done[dev]) {
-							topology->devs[dev].jdev->dev_data->state_ops[op].per_device(
-								topology->devs[dev].jdev, reason);
-							per_device_op_done[dev] = true;
-						}
-						if (topology->devs[dev].jdev->dev_data->state_ops[op].per_link)
-							topology->devs[dev].jdev->dev_data->state_ops[op].per_link(
-								topology->devs[dev].jdev, reason,
-								&jdev_top->active_links[lnk_id].link);
+					if (topology->devs[dev].link_ids[lnk_dev] != jdev_top->link_ids[lnk_id])
+						continue;
+					if (!per_device_op_done[dev]) {
+						jesd204_fsm_per_device(jdev, op, reason);
+						per_device_op_done[dev] = true;
 					}
+					jesd204_fsm_per_link(jdev, op, reason,
+							     &jdev_top->active_links[lnk_id].link);
 				}
 			}
 		}
+
+		jesd204_fsm_wait(topology);
 	}
 
 	return 0;
@@ -7,10 +7,14 @@
 #ifndef _JESD204_PRIV_H_
 #define _JESD204_PRIV_H_
 
+#include <stdatomic.h>
 #include "jesd204.h"
 
 #define JESD204_MAX_LINKS	16
 
+/* no-OS specific */
+#define JESD204_FSM_DEFER_TIMEOUT_MS	1000
+
 /**
  * struct jesd204_dev - JESD204 device
  * @dev_data		ref to data provided by the driver registering with the framework
@@ -18,6 +22,9 @@
  * @is_top		true if this device is a top device in a topology of
  *			devices that make up a JESD204 link (typically the
  *			device that is the ADC, DAC, or transceiver)
+ * @ops_pending		number of state ops of this device that returned
+ *			JESD204_STATE_CHANGE_DEFER and are not done yet
+ * @ops_error		first error reported by jesd204_fsm_op_done()
  */
 struct jesd204_dev {
 	const struct jesd204_dev_data	*dev_data;
@@ -27,6 +34,8 @@ struct jesd204_dev {
 
 	/* no-OS specific */
 	struct jesd204_topology		*topology;
+	atomic_int			ops_pending;
+	atomic_int			ops_error;
 };
 
 /**
@@ -34,11 +43,18 @@ struct jesd204_dev {
  * @link		public link information
  * @jdev_top		JESD204 top level this links belongs to
  * @link_idx		Index in the array of JESD204 links in @jdev_top
+ * @params_hash		hash of the link parameters when the link got running
+ * @warm		true while the link runs with the @params_hash settings,
+ *			so a restart can skip the states before LINK_ENABLE
  */
 struct jesd204_link_opaque {
 	struct jesd204_link		link;
 	struct jesd204_dev_top		*jdev_top;
 	unsigned int			link_idx;
+
+	/* no-OS specific */
+	uint32_t			params_hash;
+	bool				warm;
 };
 
 /**
@@ -68,4 +84,7 @@ struct jesd204_dev_top {
 struct jesd204_dev_top *jesd204_dev_get_topology_top_dev(
 	struct jesd204_dev *jdev);
 
+/* no-OS specific */
+uint32_t jesd204_link_params_hash(const struct jesd204_link *lnk);
+
 #endif /* _JESD204_PRIV_H_ */
@@ -47,6 +47,7 @@
 #include "sd.h"
 #include "no_os_error.h"
 #include <stdio.h>
+#include <string.h>
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -57,9 +58,39 @@
 #define DEV_USB		2	/* Example: Map USB MSD to physical drive 2 */
 
 #define ERASE_SECTOR_SIZE	1u
+
+/*
+ * Number of single sector requests kept by the write-back cache. These are
+ * the FAT and directory accesses, the file data goes to the card directly.
+ */
+#ifndef SD_CACHE_SECTORS
+#define SD_CACHE_SECTORS	8u
+#endif
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+struct sd_cache_entry {
+	BYTE	data[DATA_BLOCK_LEN] __attribute__ ((aligned));
+	LBA_t	sector;
+	/* Value of sd_cache_time at the last access, for the LRU eviction */
+	DWORD	last_use;
+	bool	valid;
+	/* Newer than the card, written by the next flush */
+	bool	dirty;
+};
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
 uint8_t			sd_init_var = false;
 extern struct sd_desc	*sd_desc;
 
+static struct sd_cache_entry	sd_cache[SD_CACHE_SECTORS];
+static DWORD			sd_cache_time;
+
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
@@ -68,6 +99,7 @@ DSTATUS SD_disk_status();
 DSTATUS SD_disk_initialize();
 DRESULT SD_disk_read(BYTE *buff, LBA_t sector, UINT count);
 DRESULT SD_disk_write(BYTE *buff, LBA_t sector, UINT count);
+static DRESULT sd_cache_flush();
 
 /*-----------------------------------------------------------------------*/
 /* Get Drive Status                                                      */
@@ -168,7 +200,7 @@ DRESULT disk_ioctl (
 	switch(pdrv) {
 	case DEV_SD:
 		switch (cmd){
-		case CTRL_SYNC: return RES_OK;
+		case CTRL_SYNC: return sd_cache_flush();
 		case GET_SECTOR_COUNT:
 			*(LBA_t *)buff = sd_desc->memory_size / DATA_BLOCK_LEN;
 			return RES_OK;
@@ -193,6 +225,116 @@ DRESULT disk_ioctl (
 	return RES_PARERR;
 }
 
+/* Get the cache entry of a sector, NULL if it is not cached */
+static struct sd_cache_entry *sd_cache_find(LBA_t sector)
+{
+	UINT i;
+
+	for (i = 0; i < SD_CACHE_SECTORS; i++)
+		if (sd_cache[i].valid && sd_cache[i].sector == sector)
+			return &sd_cache[i];
+
+	return NULL;
+}
+
+/* Write count adjacent dirty sectors with a single command */
+static DRESULT sd_cache_write_run(struct sd_cache_entry **run, UINT count)
+{
+	struct sd_stream	*stream;
+	uint64_t		address;
+	UINT			i;
+
+	address = (uint64_t)run[0]->sector * DATA_BLOCK_LEN;
+	if (count == 1) {
+		if (0 != sd_write(sd_desc, run[0]->data, address,
+				  DATA_BLOCK_LEN))
+			return RES_ERROR;
+		return RES_OK;
+	}
+
+	if (0 != sd_stream_open(sd_desc, &stream, address, count))
+		return RES_ERROR;
+	for (i = 0; i < count; i++) {
+		if (0 != sd_stream_write(stream, run[i]->data,
+					 DATA_BLOCK_LEN)) {
+			sd_stream_close(stream);
+			return RES_ERROR;
+		}
+	}
+	if (0 != sd_stream_close(stream))
+		return RES_ERROR;
+
+	return RES_OK;
+}
+
+/* Write the dirty sectors, coalescing the adjacent ones */
+static DRESULT sd_cache_flush()
+{
+	struct sd_cache_entry	*dirty[SD_CACHE_SECTORS];
+	struct sd_cache_entry	*tmp;
+	UINT			nb_dirty;
+	UINT			i, j;
+
+	nb_dirty = 0;
+	for (i = 0; i < SD_CACHE_SECTORS; i++) {
+		if (!sd_cache[i].valid || !sd_cache[i].dirty)
+			continue;
+
+		/* Insert sorted by sector */
+		tmp = &sd_cache[i];
+		for (j = nb_dirty; j > 0 && dirty[j - 1]->sector > tmp->sector;
+		     j--)
+			dirty[j] = dirty[j - 1];
+		dirty[j] = tmp;
+		nb_dirty++;
+	}
+
+	for (i = 0; i < nb_dirty; i = j) {
+		for (j = i + 1; j < nb_dirty; j++)
+			if (dirty[j]->sector != dirty[j - 1]->sector + 1)
+				break;
+
+		if (RES_OK != sd_cache_write_run(&dirty[i], j - i))
+			return RES_ERROR;
+
+		for (; i < j; i++)
+			dirty[i]->dirty = false;
+	}
+
+	return RES_OK;
+}
+
+/* Get an entry for a new sector, evicting the least recently used one */
+static struct sd_cache_entry *sd_cache_alloc()
+{
+	struct sd_cache_entry	*lru;
+	UINT			i;
+
+	lru = NULL;
+	for (i = 0; i < SD_CACHE_SECTORS; i++) {
+		if (!sd_cache[i].valid)
+			return &sd_cache[i];
+		if (sd_cache[i].dirty)
+			continue;
+		if (!lru || sd_cache[i].last_use < lru->last_use)
+			lru = &sd_cache[i];
+	}
+
+	if (!lru) {
+		/* Only dirty entries, all of them are written at once */
+		if (RES_OK != sd_cache_flush())
+			return NULL;
+
+		lru = &sd_cache[0];
+		for (i = 1; i < SD_CACHE_SECTORS; i++)
+			if (sd_cache[i].last_use < lru->last_use)
+				lru = &sd_cache[i];
+	}
+	lru->valid = false;
+
+	return lru;
+}
+
 DSTATUS SD_disk_status()
 {
 	if (sd_init_var)
@@ -212,21 +354,85 @@ DSTATUS SD_disk_initialize()
 
 DRESULT SD_disk_read(BYTE *buff, LBA_t sector, UINT count)
 {
+	struct sd_cache_entry	*entry;
+	UINT			i;
+
 	if (!sd_init_var)
 		return RES_NOTRDY;
+
+	if (count == 1) {
+		entry = sd_cache_find(sector);
+		if (!entry) {
+			entry = sd_cache_alloc();
+			if (!entry)
+				return RES_ERROR;
+			if (0 != sd_read(sd_desc, entry->data,
+					 (uint64_t)sector * 512, 512))
+				return RES_ERROR;
+			entry->sector = sector;
+			entry->dirty = false;
+			entry->valid = true;
+		}
+		entry->last_use = ++sd_cache_time;
+		memcpy(buff, entry->data, DATA_BLOCK_LEN);
+
+		return RES_OK;
+	}
+
 	if (0 != sd_read(sd_desc, buff, (uint64_t)sector * 512, (uint64_t)count * 512))
 		return RES_ERROR;
 
+	/* The sectors not flushed yet are newer than the card */
+	for (i = 0; i < SD_CACHE_SECTORS; i++) {
+		entry = &sd_cache[i];
+		if (entry->valid && entry->dirty && entry->sector >= sector &&
+		    entry->sector - sector < count)
+			memcpy(buff + (entry->sector - sector) * DATA_BLOCK_LEN,
+			       entry->data, DATA_BLOCK_LEN);
+	}
+
 	return RES_OK;
 }
 
 DRESULT SD_disk_write(BYTE *buff, LBA_t sector, UINT count)
 {
+	struct sd_cache_entry	*entry;
+	UINT			i;
+
 	if (!sd_init_var)
 		return RES_NOTRDY;
+
+	if (count == 1) {
+		entry = sd_cache_find(sector);
+		if (!entry) {
+			entry = sd_cache_alloc();
+			if (!entry)
+				return RES_ERROR;
+			entry->sector = sector;
+			entry->valid = true;
+		}
+		entry->last_use = ++sd_cache_time;
+		memcpy(entry->data, buff, DATA_BLOCK_LEN);
+		entry->dirty = true;
+
+		return RES_OK;
+	}
+
 	if (0 != sd_write(sd_desc, buff, (uint64_t)sector * 512, (uint64_t)count * 512))
 		return RES_ERROR;
 
+	/* Keep the cached copies of the written sectors up to date */
+	for (i = 0; i < SD_CACHE_SECTORS; i++) {
+		entry = &sd_cache[i];
+		if (entry->valid && entry->sector >= sector &&
+		    entry->sector - sector < count) {
+			memcpy(entry->data,
+			       buff + (entry->sector - sector) * DATA_BLOCK_LEN,
+			       DATA_BLOCK_LEN);
+			entry->dirty = false;
+		}
+	}
+
 	return RES_OK;
 }
 
@@ -54,6 +54,13 @@
 struct mqtt_desc {
 	MQTTClient		mqtt_client[1];
 	Network			network;
+	/* Serialized publishes waiting to be sent */
+	uint8_t			*batch_buff;
+	uint32_t		batch_size;
+	uint32_t		batch_len;
+	/* Started when the first publish is queued */
+	Timer			batch_timer;
+	uint32_t		batch_timeout_ms;
 };
 
 /******************************************************************************/
@@ -118,6 +125,11 @@ int32_t mqtt_init(struct mqtt_desc **desc,
 		return -1;
 	}
 
+	ldesc->batch_buff = param->batch_buff;
+	ldesc->batch_size = param->batch_buff_size;
+	ldesc->batch_timeout_ms = param->batch_timeout_ms;
+	TimerInit(&ldesc->batch_timer);
+
 	ldesc->network.sock = param->sock;
 	ldesc->network.mqttread = mqtt_noos_read;
 	ldesc->network.mqttwrite = mqtt_noos_write;
@@ -202,6 +214,8 @@ int32_t mqtt_disconnect(struct mqtt_desc *desc)
 	if (!desc)
 		return -1;
 
+	mqtt_flush(desc);
+
 	return MQTTDisconnect(desc->mqtt_client);
 }
 
@@ -220,6 +234,11 @@ int32_t mqtt_publish(struct mqtt_desc *desc, const int8_t* topic,
 	if (!desc || !msg)
 		return -1;
 
+	/* Keep the order with the publishes queued before */
+	int32_t ret = mqtt_flush(desc);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
 	MQTTMessage message = { 0 };
 
 	message.payload = (void *)msg->payload;
@@ -230,6 +249,100 @@ int32_t mqtt_publish(struct mqtt_desc *desc, const int8_t* topic,
 	return MQTTPublish(desc->mqtt_client, (char *)topic, &message);
 }
 
+/**
+ * @brief Queue a publish to MQTT broker. QoS0 messages are serialized in the
+ * batch buffer and sent together, in a single socket send, when the buffer
+ * is full, when \ref mqtt_init_param.batch_timeout_ms elapsed since the first
+ * one was queued or when \ref mqtt_flush is called. They need no packet id
+ * and no acknowledge. The other messages are sent as by \ref mqtt_publish.
+ * @param desc - Reference to MQTT client
+ * @param topic - Topic name
+ * @param msg - Message to send
+ * @return
+ *  - 0 : On success
+ *  - -1 : Otherwise
+ */
+int32_t mqtt_publish_batch(struct mqtt_desc *desc, const int8_t *topic,
+			   const struct mqtt_message *msg)
+{
+	MQTTString	topic_name = MQTTString_initializer;
+	int32_t		len;
+	int32_t		ret;
+
+	if (!desc || !topic || !msg)
+		return -1;
+
+	if (!desc->batch_buff || msg->qos != MQTT_QOS0)
+		return mqtt_publish(desc, topic, msg);
+
+	topic_name.cstring = (char *)topic;
+	len = MQTTSerialize_publish(desc->batch_buff + desc->batch_len,
+				    desc->batch_size - desc->batch_len, 0, 0,
+				    msg->retained, 0, topic_name, msg->payload,
+				    msg->len);
+	if (len <= 0 && desc->batch_len) {
+		/* No room left, send the queued messages first */
+		ret = mqtt_flush(desc);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		len = MQTTSerialize_publish(desc->batch_buff, desc->batch_size,
+					    0, 0, msg->retained, 0, topic_name,
+					    msg->payload, msg->len);
+	}
+	if (len <= 0)
+		/* Bigger than the batch buffer */
+		return mqtt_publish(desc, topic, msg);
+
+	if (!desc->batch_len)
+		TimerCountdownMS(&desc->batch_timer, desc->batch_timeout_ms);
+	desc->batch_len += len;
+
+	if (TimerIsExpired(&desc->batch_timer))
+		return mqtt_flush(desc);
+
+	return 0;
+}
+
+/**
+ * @brief Send the publishes queued by \ref mqtt_publish_batch
+ * @param desc - Reference to MQTT client
+ * @return
+ *  - 0 : On success
+ *  - -1 : Otherwise
+ */
+int32_t mqtt_flush(struct mqtt_desc *desc)
+{
+	MQTTClient	*client;
+	uint32_t	sent;
+	int		rc;
+
+	if (!desc)
+		return -1;
+
+	if (!desc->batch_len)
+		return 0;
+
+	client = desc->mqtt_client;
+	for (sent = 0; sent < desc->batch_len; sent += rc) {
+		rc = desc->network.mqttwrite(&desc->network,
+					     desc->batch_buff + sent,
+					     desc->batch_len - sent,
+					     client->command_timeout_ms);
+		if (rc <= 0) {
+			/* The queued messages are dropped, as QoS0 allows */
+			desc->batch_len = 0;
+			return -1;
+		}
+	}
+	desc->batch_len = 0;
+
+	/* Same as for the client sends, no ping is needed before this */
+	TimerCountdown(&client->last_sent, client->keepAliveInterval);
+
+	return 0;
+}
+
 /**
  * @brief Send subscribe to MQTT broker
  * @param desc - Reference to MQTT client
@@ -291,5 +404,11 @@ int32_t mqtt_unsubscribe(struct mqtt_desc *desc, const int8_t* topic)
  */
 int32_t mqtt_yield(struct mqtt_desc *desc, uint32_t timeout_ms)
 {
+	if (!desc)
+		return -1;
+
+	if (desc->batch_len && TimerIsExpired(&desc->batch_timer))
+		mqtt_flush(desc);
+
 	return MQTTYield(desc->mqtt_client, timeout_ms);
 }
@@ -232,6 +232,18 @@ struct mqtt_init_param {
 	 * @param Message received from the broker.
 	 */
 	void			(*message_handler)(struct mqtt_message_data *);
+	/**
+	 * Buffer where \ref mqtt_publish_batch serializes QoS0 messages, to
+	 * send them at once. Can be NULL if the function is not used.
+	 */
+	uint8_t			*batch_buff;
+	/** Size of the batch buffer */
+	uint32_t		batch_buff_size;
+	/**
+	 * Maximum time a batched message waits before being sent, in
+	 * milliseconds. It is checked by the MQTT client functions.
+	 */
+	uint32_t		batch_timeout_ms;
 };
 
 /**
@@ -260,6 +272,11 @@ int32_t mqtt_disconnect(struct mqtt_desc *desc);
 /* Send publish to MQTT broker */
 int32_t mqtt_publish(struct mqtt_desc *desc, const int8_t* topic,
 		     const struct mqtt_message* msg);
+/* Queue a QoS0 publish, sent with the other queued ones */
+int32_t mqtt_publish_batch(struct mqtt_desc *desc, const int8_t *topic,
+			   const struct mqtt_message *msg);
+/* Send the queued publishes to MQTT broker */
+int32_t mqtt_flush(struct mqtt_desc *desc);
 /* Send subscribe to MQTT broker */
 int32_t mqtt_subscribe(struct mqtt_desc *desc, const int8_t *topic,
 		       enum mqtt_qos qos, enum mqtt_qos *granted_qos_optional);
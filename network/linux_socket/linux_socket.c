@@ -53,17 +53,72 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <arpa/inet.h>
 #include <netinet/tcp.h>
 #include <netinet/in.h>
 #include <netdb.h>
 #include <string.h>
 #include <fcntl.h>
+#include <sys/epoll.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Readiness always watched on the sockets, EPOLLOUT is added when needed */
+#define LINUX_SOCKET_EVENTS	(EPOLLIN | EPOLLRDHUP)
+/* Ready sockets handled by a single epoll_wait call */
+#define LINUX_SOCKET_MAX_EVENTS	32
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+/* epoll instance watching all the sockets, created with the first one */
+static int linux_socket_epfd = -1;
 
 /******************************************************************************/
 /*************************** FUnctions Declarations *******************************/
 /******************************************************************************/
 
+/* Add (EPOLL_CTL_ADD) or change (EPOLL_CTL_MOD) the events watched */
+static int32_t linux_socket_watch(uint32_t sock_id, int op, uint32_t events)
+{
+	struct epoll_event ev = {
+		.events = events,
+		.data.fd = sock_id
+	};
+
+	if (linux_socket_epfd < 0) {
+		linux_socket_epfd = epoll_create1(EPOLL_CLOEXEC);
+		if (linux_socket_epfd < 0)
+			return -errno;
+	}
+
+	if (epoll_ctl(linux_socket_epfd, op, sock_id, &ev))
+		return -errno;
+
+	return 0;
+}
+
+/*
+ * Return value of a send of size bytes. If the socket buffer couldn't take
+ * them all, the socket is also watched for room to send the rest.
+ */
+static int32_t linux_socket_sent(uint32_t sock_id, ssize_t ret, uint32_t size)
+{
+	if (ret < 0)
+		ret = -errno;
+
+	if (ret == -EAGAIN || ret == -EWOULDBLOCK ||
+	    (ret >= 0 && (uint32_t)ret < size))
+		linux_socket_watch(sock_id, EPOLL_CTL_MOD,
+				   LINUX_SOCKET_EVENTS | EPOLLOUT);
+
+	return ret;
+}
+
 /** @brief See \ref network_interface.socket_open */
 static int32_t linux_socket_open(void *desc, uint32_t *sock_id,
 				 enum socket_protocol prot, uint32_t buff_size)
@@ -71,7 +126,10 @@ static int32_t linux_socket_open(void *desc, uint32_t *sock_id,
 	int32_t flags;
 	int err;
 
-	err = socket(AF_INET,SOCK_STREAM,IPPROTO_TCP);
+	if (prot == PROTOCOL_UDP)
+		err = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	else
+		err = socket(AF_INET,SOCK_STREAM,IPPROTO_TCP);
 	if(err < 0)
 		return err;
 
@@ -79,6 +137,12 @@ static int32_t linux_socket_open(void *desc, uint32_t *sock_id,
 	flags = fcntl(*sock_id, F_GETFL);
 	fcntl(*sock_id, F_SETFL, flags | O_NONBLOCK);
 
+	err = linux_socket_watch(*sock_id, EPOLL_CTL_ADD, LINUX_SOCKET_EVENTS);
+	if (err) {
+		close(*sock_id);
+		return err;
+	}
+
 	return 0;
 }
 
@@ -87,6 +151,9 @@ static int32_t linux_socket_close(void *desc, uint32_t sock_id)
 {
 	int32_t ret;
 
+	if (linux_socket_epfd >= 0)
+		epoll_ctl(linux_socket_epfd, EPOLL_CTL_DEL, sock_id, NULL);
+
 	ret = close(sock_id);
 	if(ret < 0)
 		return -errno;
@@ -139,10 +206,31 @@ static int32_t linux_socket_send(void *desc, uint32_t sock_id,
 
 	ret = send(sock_id, data, size, 0);
 
-	if(ret < 0)
-		return -errno;
+	return linux_socket_sent(sock_id, ret, size);
+}
 
-	return size;
+/* Maximum number of buffers given to a single writev call */
+#define LINUX_SOCKET_MAX_IOV	16
+
+/** @brief See \ref network_interface.socket_sendv */
+static int32_t linux_socket_sendv(void *desc, uint32_t sock_id,
+				  const struct socket_iovec *iov,
+				  uint32_t iovcnt)
+{
+	struct iovec vec[LINUX_SOCKET_MAX_IOV];
+	uint32_t i, size = 0;
+	ssize_t ret;
+
+	iovcnt = no_os_min(iovcnt, LINUX_SOCKET_MAX_IOV);
+	for (i = 0; i < iovcnt; i++) {
+		vec[i].iov_base = (void *)iov[i].base;
+		vec[i].iov_len = iov[i].len;
+		size += iov[i].len;
+	}
+
+	ret = writev(sock_id, vec, iovcnt);
+
+	return linux_socket_sent(sock_id, ret, size);
 }
 
 /** @brief See \ref network_interface.socket_recv */
@@ -165,28 +253,46 @@ static int32_t linux_socket_recv(void *desc, uint32_t sock_id,
 	return ret;
 }
 
+/* Fill saddr with the address of a host, given by name or as a number */
+static int32_t linux_socket_get_addr(struct sockaddr_in *saddr,
+				     const struct socket_address *addr)
+{
+	struct hostent* hptr;
+
+	memset(saddr, 0, sizeof(*saddr));
+	saddr->sin_family = AF_INET;
+	saddr->sin_port = htons(addr->port);
+	/* Avoid a resolver call for each packet sent to a numeric address */
+	if (inet_pton(AF_INET, addr->addr, &saddr->sin_addr) == 1)
+		return 0;
+
+	hptr = gethostbyname(addr->addr);
+	if (!hptr)
+		return -EHOSTUNREACH;
+
+	saddr->sin_addr.s_addr = ((struct in_addr*) hptr->h_addr_list[0])->s_addr;
+
+	return 0;
+}
+
 /** @brief See \ref network_interface.socket_sendto */
 static int32_t linux_socket_sendto(void *desc, uint32_t sock_id,
 				   const void *data, uint32_t size,
 				   const struct socket_address* to)
 {
 	int32_t ret;
-	struct sockaddr_in saddr_to = {0};
-	socklen_t len;
-	struct hostent* hptr;
+	struct sockaddr_in saddr_to;
 
-	saddr_to.sin_family = AF_INET;
-	saddr_to.sin_port = htons(to->port);
-	hptr = gethostbyname(to->addr);
-	saddr_to.sin_addr.s_addr = ((struct in_addr*) hptr->h_addr_list[0])->s_addr;
-	len = sizeof(saddr_to);
-
-	ret = sendto(sock_id, data, size, 0, (struct sockaddr*) &saddr_to, len);
-
-	if(ret != 0)
+	ret = linux_socket_get_addr(&saddr_to, to);
+	if (ret)
 		return ret;
 
-	return 0;
+	ret = sendto(sock_id, data, size, 0, (struct sockaddr*) &saddr_to,
+		     sizeof(saddr_to));
+	if(ret < 0)
+		return -errno;
+
+	return ret;
 }
 
 /** @brief See \ref network_interface.socket_recvfrom */
@@ -196,22 +302,21 @@ static int32_t linux_socket_recvfrom(void *desc, uint32_t sock_id,
 {
 	int32_t ret;
 	struct sockaddr_in saddr_from = {0};
-	socklen_t len;
-	struct hostent* hptr;
-
-	saddr_from.sin_family = AF_INET;
-	saddr_from.sin_port = htons(from->port);
-	hptr = gethostbyname(from->addr);
-	saddr_from.sin_addr.s_addr = ((struct in_addr*) hptr->h_addr_list[0])->s_addr;
-	len = sizeof(saddr_from);
+	socklen_t len = sizeof(saddr_from);
 
-	ret = recvfrom(sock_id, data, size, MSG_DONTWAIT,(struct sockaddr*) &saddr_from,
-		       &len);
+	ret = recvfrom(sock_id, data, size, MSG_DONTWAIT,
+		       (struct sockaddr*) &saddr_from, &len);
+	if(ret < 0)
+		return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -errno;
 
-	if(ret != 0)
-		return ret;
+	if (from) {
+		from->port = ntohs(saddr_from.sin_port);
+		if (from->addr)
+			inet_ntop(AF_INET, &saddr_from.sin_addr, from->addr,
+				  SOCKET_ADDRSTRLEN);
+	}
 
-	return 0;
+	return ret;
 }
 
 /** @brief See \ref network_interface.socket_bind */
@@ -262,9 +367,39 @@ static int32_t linux_socket_accept(void *desc, uint32_t sock_id,
 
 	*client_socket_id = ret;
 
+	ret = linux_socket_watch(*client_socket_id, EPOLL_CTL_ADD,
+				 LINUX_SOCKET_EVENTS);
+	if (ret) {
+		close(*client_socket_id);
+		return ret;
+	}
+
 	return 0;
 }
 
+/** @brief See \ref network_interface.socket_wait */
+static int32_t linux_socket_wait(void *desc, uint32_t timeout_ms)
+{
+	struct epoll_event events[LINUX_SOCKET_MAX_EVENTS];
+	int32_t ret, i;
+
+	if (linux_socket_epfd < 0)
+		return -ENOENT;
+
+	ret = epoll_wait(linux_socket_epfd, events, LINUX_SOCKET_MAX_EVENTS,
+			 timeout_ms);
+	if (ret < 0)
+		return errno == EINTR ? 0 : -errno;
+
+	/* Room to send is only waited for until the next send */
+	for (i = 0; i < ret; i++)
+		if (events[i].events & EPOLLOUT)
+			linux_socket_watch(events[i].data.fd, EPOLL_CTL_MOD,
+					   LINUX_SOCKET_EVENTS);
+
+	return ret;
+}
+
 struct network_interface linux_net = {
 	.socket_open = (int32_t (*)(void *, uint32_t *, enum socket_protocol,
 				    uint32_t)) linux_socket_open,
@@ -272,12 +407,14 @@ struct network_interface linux_net = {
 	.socket_connect = (int32_t (*)(void *, uint32_t,struct socket_address *))linux_socket_connect,
 	.socket_disconnect = (int32_t (*)(void *, uint32_t))linux_socket_disconnect,
 	.socket_send = (int32_t (*)(void *, uint32_t, const void *, uint32_t))linux_socket_send,
+	.socket_sendv = (int32_t (*)(void *, uint32_t, const struct socket_iovec *, uint32_t))linux_socket_sendv,
 	.socket_recv = (int32_t (*)(void *, uint32_t, void *, uint32_t))linux_socket_recv,
 	.socket_sendto = (int32_t (*)(void *, uint32_t, const void *, uint32_t, const struct socket_address* to))linux_socket_sendto,
 	.socket_recvfrom = (int32_t (*)(void *, uint32_t, void *, uint32_t, struct socket_address* from))linux_socket_recvfrom,
 	.socket_bind = (int32_t (*)(void *, uint32_t, uint16_t))linux_socket_bind,
 	.socket_listen = (int32_t (*)(void *, uint32_t, uint32_t))linux_socket_listen,
-	.socket_accept= (int32_t (*)(void *, uint32_t, uint32_t*))linux_socket_accept
+	.socket_accept= (int32_t (*)(void *, uint32_t, uint32_t*))linux_socket_accept,
+	.socket_wait = linux_socket_wait
 };
 
 #endif
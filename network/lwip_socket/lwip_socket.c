@@ -0,0 +1,672 @@
+/***************************************************************************//**
+ *   @file   lwip_socket.c
+ *   @brief  Implementation of the network interface over the lwIP raw API.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#ifdef NO_OS_LWIP_NETWORKING
+
+#include <stdbool.h>
+#include <string.h>
+#include "lwip_socket.h"
+#include "no_os_alloc.h"
+#include "no_os_error.h"
+#include "no_os_util.h"
+#include "lwip/tcp.h"
+#include "lwip/pbuf.h"
+#include "lwip/ip_addr.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+enum lwip_socket_state {
+	LWIP_SOCKET_FREE,
+	/* Opened, not yet connected or listening */
+	LWIP_SOCKET_OPEN,
+	LWIP_SOCKET_LISTENING,
+	LWIP_SOCKET_CONNECTING,
+	LWIP_SOCKET_CONNECTED,
+	/* Closed by the peer or by an error, only received data is left */
+	LWIP_SOCKET_CLOSED
+};
+
+struct lwip_socket {
+	struct lwip_network_desc	*desc;
+	enum lwip_socket_state		state;
+	/* NULL once lwIP freed it, after an error */
+	struct tcp_pcb			*pcb;
+	/* Received data not yet read */
+	struct pbuf			*rx;
+	/* Ids of the accepted connections, for a listening socket */
+	uint32_t			backlog[LWIP_SOCKET_BACKLOG];
+	uint32_t			backlog_head;
+	uint32_t			backlog_len;
+	/* Bytes queued and acknowledged since the socket was opened */
+	uint32_t			snd_queued;
+	uint32_t			snd_acked;
+	/* First byte queued by reference that was not reported as sent */
+	const uint8_t			*ref_base;
+	/* Value of snd_queued when ref_base was queued */
+	uint32_t			ref_seq;
+	/* Bytes from ref_base queued by reference */
+	uint32_t			ref_len;
+};
+
+/**
+ * @struct lwip_network_desc
+ * @brief lwIP network descriptor
+ */
+struct lwip_network_desc {
+	/** Network interface given to the tcp_socket layer */
+	struct network_interface	interface;
+	/** See lwip_network_init_param.poll */
+	void				(*poll)(void *ctx);
+	/** Parameter of poll */
+	void				*poll_ctx;
+	/** Socket table, indexed by the socket ids */
+	struct lwip_socket		sockets[LWIP_SOCKET_MAX_SOCKETS];
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+static inline void lwip_socket_poll(struct lwip_network_desc *desc)
+{
+	desc->poll(desc->poll_ctx);
+}
+
+static struct lwip_socket *lwip_socket_get(struct lwip_network_desc *desc,
+		uint32_t sock_id)
+{
+	if (sock_id >= LWIP_SOCKET_MAX_SOCKETS ||
+	    desc->sockets[sock_id].state == LWIP_SOCKET_FREE)
+		return NULL;
+
+	return &desc->sockets[sock_id];
+}
+
+static int32_t lwip_socket_alloc(struct lwip_network_desc *desc,
+				 uint32_t *sock_id)
+{
+	uint32_t i;
+
+	for (i = 0; i < LWIP_SOCKET_MAX_SOCKETS; i++) {
+		if (desc->sockets[i].state != LWIP_SOCKET_FREE)
+			continue;
+
+		memset(&desc->sockets[i], 0, sizeof(desc->sockets[i]));
+		desc->sockets[i].desc = desc;
+		desc->sockets[i].state = LWIP_SOCKET_OPEN;
+		*sock_id = i;
+
+		return 0;
+	}
+
+	return -ENOMEM;
+}
+
+/* lwIP callback: data, or the end of the stream if p is NULL, was received */
+static err_t lwip_socket_recv_cb(void *arg, struct tcp_pcb *pcb,
+				 struct pbuf *p, err_t err)
+{
+	struct lwip_socket *sock = arg;
+
+	if (!p) {
+		sock->state = LWIP_SOCKET_CLOSED;
+		return ERR_OK;
+	}
+
+	if (sock->rx)
+		pbuf_cat(sock->rx, p);
+	else
+		sock->rx = p;
+
+	return ERR_OK;
+}
+
+/* lwIP callback: len bytes were acknowledged by the peer */
+static err_t lwip_socket_sent_cb(void *arg, struct tcp_pcb *pcb, u16_t len)
+{
+	struct lwip_socket *sock = arg;
+
+	sock->snd_acked += len;
+
+	return ERR_OK;
+}
+
+/* lwIP callback: the connection was aborted and the pcb already freed */
+static void lwip_socket_err_cb(void *arg, err_t err)
+{
+	struct lwip_socket *sock = arg;
+
+	sock->pcb = NULL;
+	sock->state = LWIP_SOCKET_CLOSED;
+}
+
+/* lwIP callback: the connection started by socket_connect is established */
+static err_t lwip_socket_connected_cb(void *arg, struct tcp_pcb *pcb,
+				      err_t err)
+{
+	struct lwip_socket *sock = arg;
+
+	sock->state = LWIP_SOCKET_CONNECTED;
+
+	return ERR_OK;
+}
+
+static void lwip_socket_set_pcb(struct lwip_socket *sock,
+				struct tcp_pcb *pcb)
+{
+	sock->pcb = pcb;
+	tcp_arg(pcb, sock);
+	tcp_recv(pcb, lwip_socket_recv_cb);
+	tcp_sent(pcb, lwip_socket_sent_cb);
+	tcp_err(pcb, lwip_socket_err_cb);
+	/*
+	 * The data queued by reference is released only once acknowledged,
+	 * don't let its last segment wait for the ack of the previous ones.
+	 */
+	tcp_nagle_disable(pcb);
+}
+
+/* lwIP callback: a connection arrived on a listening socket */
+static err_t lwip_socket_accept_cb(void *arg, struct tcp_pcb *newpcb,
+				   err_t err)
+{
+	struct lwip_socket *server = arg;
+	uint32_t id, idx;
+
+	if (err != ERR_OK || !newpcb)
+		return ERR_VAL;
+
+	if (server->backlog_len == LWIP_SOCKET_BACKLOG ||
+	    lwip_socket_alloc(server->desc, &id)) {
+		tcp_abort(newpcb);
+		return ERR_ABRT;
+	}
+
+	lwip_socket_set_pcb(&server->desc->sockets[id], newpcb);
+	server->desc->sockets[id].state = LWIP_SOCKET_CONNECTED;
+
+	idx = (server->backlog_head + server->backlog_len) %
+	      LWIP_SOCKET_BACKLOG;
+	server->backlog[idx] = id;
+	server->backlog_len++;
+
+	return ERR_OK;
+}
+
+/** @brief See \ref network_interface.socket_open */
+static int32_t lwip_socket_open(struct lwip_network_desc *desc,
+				uint32_t *sock_id, enum socket_protocol proto,
+				uint32_t buff_size)
+{
+	struct tcp_pcb *pcb;
+	int32_t ret;
+
+	/* The receive buffering is done by lwIP, within the TCP window */
+	if (proto != PROTOCOL_TCP)
+		return -EPROTONOSUPPORT;
+
+	ret = lwip_socket_alloc(desc, sock_id);
+	if (ret)
+		return ret;
+
+	pcb = tcp_new();
+	if (!pcb) {
+		desc->sockets[*sock_id].state = LWIP_SOCKET_FREE;
+		return -ENOMEM;
+	}
+
+	lwip_socket_set_pcb(&desc->sockets[*sock_id], pcb);
+
+	return 0;
+}
+
+/** @brief See \ref network_interface.socket_close */
+static int32_t lwip_socket_close(struct lwip_network_desc *desc,
+				 uint32_t sock_id)
+{
+	struct lwip_socket *sock = lwip_socket_get(desc, sock_id);
+	struct tcp_pcb *pcb;
+
+	if (!sock)
+		return -EINVAL;
+
+	/* Accepted connections not yet taken are closed with the server */
+	while (sock->backlog_len) {
+		lwip_socket_close(desc, sock->backlog[sock->backlog_head]);
+		sock->backlog_head = (sock->backlog_head + 1) %
+				     LWIP_SOCKET_BACKLOG;
+		sock->backlog_len--;
+	}
+
+	pcb = sock->pcb;
+	if (pcb) {
+		tcp_arg(pcb, NULL);
+		if (sock->state == LWIP_SOCKET_LISTENING) {
+			tcp_accept(pcb, NULL);
+		} else {
+			tcp_recv(pcb, NULL);
+			tcp_sent(pcb, NULL);
+			tcp_err(pcb, NULL);
+		}
+		/*
+		 * A graceful close still sends the queued data, which may
+		 * reference memory the caller reuses once the socket is closed.
+		 */
+		if (sock->ref_len || tcp_close(pcb) != ERR_OK)
+			tcp_abort(pcb);
+	}
+
+	if (sock->rx)
+		pbuf_free(sock->rx);
+
+	sock->state = LWIP_SOCKET_FREE;
+
+	return 0;
+}
+
+/** @brief See \ref network_interface.socket_connect */
+static int32_t lwip_socket_connect(struct lwip_network_desc *desc,
+				   uint32_t sock_id,
+				   struct socket_address *addr)
+{
+	struct lwip_socket *sock = lwip_socket_get(desc, sock_id);
+	ip_addr_t ip;
+
+	if (!sock || !sock->pcb || !addr)
+		return -EINVAL;
+
+	/* No DNS, addr must be a numeric address */
+	if (!ipaddr_aton(addr->addr, &ip))
+		return -EINVAL;
+
+	sock->state = LWIP_SOCKET_CONNECTING;
+	if (tcp_connect(sock->pcb, &ip, addr->port,
+			lwip_socket_connected_cb) != ERR_OK) {
+		sock->state = LWIP_SOCKET_OPEN;
+		return -EIO;
+	}
+
+	/* Blocking, until the connection is established or refused */
+	while (sock->state == LWIP_SOCKET_CONNECTING)
+		lwip_socket_poll(desc);
+
+	if (sock->state != LWIP_SOCKET_CONNECTED)
+		return -ECONNREFUSED;
+
+	return 0;
+}
+
+/** @brief See \ref network_interface.socket_disconnect */
+static int32_t lwip_socket_disconnect(struct lwip_network_desc *desc,
+				      uint32_t sock_id)
+{
+	return lwip_socket_close(desc, sock_id);
+}
+
+/*
+ * Queue data, without calling tcp_output, and return how many bytes of it
+ * count as sent. Data smaller than LWIP_SOCKET_REF_MIN is copied by lwIP and is
+ * sent once queued. Bigger data is queued by reference, lwIP reads it from the
+ * caller's memory until acknowledged, so only the acknowledged bytes count as
+ * sent. The caller, which keeps its memory until sent, calls again with the
+ * rest and what was already queued is not queued twice.
+ */
+static int32_t lwip_socket_write(struct lwip_socket *sock, const uint8_t *buf,
+				 uint32_t size, bool more)
+{
+	uint32_t queued, len, sent;
+	int32_t acked;
+	bool by_ref;
+	uint8_t flags;
+	err_t err;
+
+	if (sock->state != LWIP_SOCKET_CONNECTED || !sock->pcb)
+		return -ENOTCONN;
+
+	/* Referenced data is not acknowledged yet, it is still in use */
+	if (sock->ref_len && buf != sock->ref_base)
+		return -EBUSY;
+
+	by_ref = sock->ref_len || size >= LWIP_SOCKET_REF_MIN;
+	if (by_ref && !sock->ref_len) {
+		sock->ref_base = buf;
+		sock->ref_seq = sock->snd_queued;
+	}
+
+	queued = by_ref ? sock->ref_len : 0;
+	while (queued < size) {
+		len = no_os_min(size - queued, tcp_sndbuf(sock->pcb));
+		len = no_os_min(len, UINT16_MAX);
+		if (!len)
+			break;
+
+		flags = by_ref ? 0 : TCP_WRITE_FLAG_COPY;
+		if (more || queued + len < size)
+			flags |= TCP_WRITE_FLAG_MORE;
+
+		err = tcp_write(sock->pcb, buf + queued, len, flags);
+		/* Out of segments, the rest is queued by a later call */
+		if (err == ERR_MEM)
+			break;
+		if (err != ERR_OK)
+			return -EIO;
+
+		queued += len;
+		sock->snd_queued += len;
+	}
+
+	if (!by_ref)
+		return queued;
+
+	sock->ref_len = queued;
+
+	/* Acks come in order, the ones past ref_seq are of ref_base */
+	acked = sock->snd_acked - sock->ref_seq;
+	if (acked <= 0)
+		return 0;
+
+	sent = no_os_min((uint32_t)acked, no_os_min(sock->ref_len, size));
+	sock->ref_base += sent;
+	sock->ref_seq += sent;
+	sock->ref_len -= sent;
+
+	return sent;
+}
+
+/** @brief See \ref network_interface.socket_send */
+static int32_t lwip_socket_send(struct lwip_network_desc *desc,
+				uint32_t sock_id, const void *data,
+				uint32_t size)
+{
+	struct lwip_socket *sock = lwip_socket_get(desc, sock_id);
+	int32_t ret;
+
+	if (!sock)
+		return -EINVAL;
+
+	lwip_socket_poll(desc);
+
+	ret = lwip_socket_write(sock, data, size, false);
+	if (sock->pcb)
+		tcp_output(sock->pcb);
+
+	return ret;
+}
+
+/** @brief See \ref network_interface.socket_sendv */
+static int32_t lwip_socket_sendv(struct lwip_network_desc *desc,
+				 uint32_t sock_id,
+				 const struct socket_iovec *iov,
+				 uint32_t iovcnt)
+{
+	struct lwip_socket *sock = lwip_socket_get(desc, sock_id);
+	uint32_t i, sent = 0;
+	int32_t ret = 0;
+
+	if (!sock)
+		return -EINVAL;
+
+	lwip_socket_poll(desc);
+
+	/* Everything is queued before the output, to fill the segments */
+	for (i = 0; i < iovcnt; i++) {
+		ret = lwip_socket_write(sock, iov[i].base, iov[i].len,
+					i + 1 < iovcnt);
+		if (ret < 0)
+			break;
+
+		sent += ret;
+		if ((uint32_t)ret < iov[i].len)
+			break;
+	}
+
+	if (sock->pcb)
+		tcp_output(sock->pcb);
+
+	if (ret < 0 && !sent)
+		return ret;
+
+	return sent;
+}
+
+/** @brief See \ref network_interface.socket_recv */
+static int32_t lwip_socket_recv(struct lwip_network_desc *desc,
+				uint32_t sock_id, void *data, uint32_t size)
+{
+	struct lwip_socket *sock = lwip_socket_get(desc, sock_id);
+	uint16_t len;
+
+	if (!sock)
+		return -EINVAL;
+
+	if (!size)
+		return 0;
+
+	lwip_socket_poll(desc);
+
+	if (!sock->rx) {
+		if (sock->state != LWIP_SOCKET_CONNECTED)
+			return -ENOTCONN;
+
+		return -EAGAIN;
+	}
+
+	len = pbuf_copy_partial(sock->rx, data,
+				no_os_min(size, sock->rx->tot_len), 0);
+	sock->rx = pbuf_free_header(sock->rx, len);
+	/* Open the receive window again */
+	if (sock->pcb)
+		tcp_recved(sock->pcb, len);
+
+	return len;
+}
+
+/** @brief See \ref network_interface.socket_bind */
+static int32_t lwip_socket_bind(struct lwip_network_desc *desc,
+				uint32_t sock_id, uint16_t port)
+{
+	struct lwip_socket *sock = lwip_socket_get(desc, sock_id);
+	err_t err;
+
+	if (!sock || !sock->pcb)
+		return -EINVAL;
+
+	err = tcp_bind(sock->pcb, IP_ANY_TYPE, port);
+	if (err == ERR_USE)
+		return -EADDRINUSE;
+	if (err != ERR_OK)
+		return -EIO;
+
+	return 0;
+}
+
+/** @brief See \ref network_interface.socket_listen */
+static int32_t lwip_socket_listen(struct lwip_network_desc *desc,
+				  uint32_t sock_id, uint32_t back_log)
+{
+	struct lwip_socket *sock = lwip_socket_get(desc, sock_id);
+	struct tcp_pcb *lpcb;
+
+	if (!sock || !sock->pcb || sock->state != LWIP_SOCKET_OPEN)
+		return -EINVAL;
+
+	back_log = no_os_clamp(back_log, 1, LWIP_SOCKET_BACKLOG);
+	/* lwIP frees the pcb and gives a smaller one, only for listening */
+	lpcb = tcp_listen_with_backlog(sock->pcb, back_log);
+	if (!lpcb)
+		return -ENOMEM;
+
+	sock->pcb = lpcb;
+	sock->state = LWIP_SOCKET_LISTENING;
+	tcp_arg(lpcb, sock);
+	tcp_accept(lpcb, lwip_socket_accept_cb);
+
+	return 0;
+}
+
+/** @brief See \ref network_interface.socket_accept */
+static int32_t lwip_socket_accept(struct lwip_network_desc *desc,
+				  uint32_t sock_id, uint32_t *client_socket_id)
+{
+	struct lwip_socket *sock = lwip_socket_get(desc, sock_id);
+
+	if (!sock || sock->state != LWIP_SOCKET_LISTENING)
+		return -EINVAL;
+
+	lwip_socket_poll(desc);
+
+	if (!sock->backlog_len)
+		return -EAGAIN;
+
+	*client_socket_id = sock->backlog[sock->backlog_head];
+	sock->backlog_head = (sock->backlog_head + 1) % LWIP_SOCKET_BACKLOG;
+	sock->backlog_len--;
+
+	return 0;
+}
+
+/* Connect internal functions to the network interface. UDP is not supported. */
+static void lwip_network_init_interface(struct lwip_network_desc *desc)
+{
+	desc->interface.net = desc;
+	desc->interface.socket_open =
+		(int32_t (*)(void *, uint32_t *, enum socket_protocol,
+			     uint32_t))
+		lwip_socket_open;
+	desc->interface.socket_close =
+		(int32_t (*)(void *, uint32_t))
+		lwip_socket_close;
+	desc->interface.socket_connect =
+		(int32_t (*)(void *, uint32_t, struct socket_address *))
+		lwip_socket_connect;
+	desc->interface.socket_disconnect =
+		(int32_t (*)(void *, uint32_t))
+		lwip_socket_disconnect;
+	desc->interface.socket_send =
+		(int32_t (*)(void *, uint32_t, const void *, uint32_t))
+		lwip_socket_send;
+	desc->interface.socket_sendv =
+		(int32_t (*)(void *, uint32_t, const struct socket_iovec *,
+			     uint32_t))
+		lwip_socket_sendv;
+	desc->interface.socket_recv =
+		(int32_t (*)(void *, uint32_t, void *, uint32_t))
+		lwip_socket_recv;
+	desc->interface.socket_bind =
+		(int32_t (*)(void *, uint32_t, uint16_t))
+		lwip_socket_bind;
+	desc->interface.socket_listen =
+		(int32_t (*)(void *, uint32_t, uint32_t))
+		lwip_socket_listen;
+	desc->interface.socket_accept =
+		(int32_t (*)(void *, uint32_t, uint32_t*))
+		lwip_socket_accept;
+}
+
+/**
+ * @brief Initialize the lwIP network backend.
+ * @param desc - Address where to store the lwIP network descriptor.
+ * @param param - Initialization parameter.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t lwip_network_init(struct lwip_network_desc **desc,
+			  struct lwip_network_init_param *param)
+{
+	struct lwip_network_desc *ldesc;
+
+	if (!desc || !param || !param->poll)
+		return -EINVAL;
+
+	ldesc = (struct lwip_network_desc *)no_os_calloc(1, sizeof(*ldesc));
+	if (!ldesc)
+		return -ENOMEM;
+
+	ldesc->poll = param->poll;
+	ldesc->poll_ctx = param->poll_ctx;
+	lwip_network_init_interface(ldesc);
+
+	*desc = ldesc;
+
+	return 0;
+}
+
+/**
+ * @brief Close the sockets left open and free the lwIP network descriptor.
+ * @param desc - lwIP network descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t lwip_network_remove(struct lwip_network_desc *desc)
+{
+	uint32_t i;
+
+	if (!desc)
+		return -EINVAL;
+
+	for (i = 0; i < LWIP_SOCKET_MAX_SOCKETS; i++)
+		if (desc->sockets[i].state != LWIP_SOCKET_FREE)
+			lwip_socket_close(desc, i);
+
+	no_os_free(desc);
+
+	return 0;
+}
+
+/**
+ * @brief Get the network interface of the lwIP backend.
+ * @param desc - lwIP network descriptor.
+ * @param net - Address where to store the network interface.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t lwip_network_get_network_interface(struct lwip_network_desc *desc,
+		struct network_interface **net)
+{
+	if (!desc || !net)
+		return -EINVAL;
+
+	*net = &desc->interface;
+
+	return 0;
+}
+
+#endif /* NO_OS_LWIP_NETWORKING */
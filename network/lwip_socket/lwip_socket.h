@@ -0,0 +1,110 @@
+/***************************************************************************//**
+ *   @file   lwip_socket.h
+ *   @brief  lwIP raw API network backend.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef LWIP_SOCKET_H_
+#define LWIP_SOCKET_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include "network_interface.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Number of sockets, listening and connected ones, handled at the same time */
+#ifndef LWIP_SOCKET_MAX_SOCKETS
+#define LWIP_SOCKET_MAX_SOCKETS		8
+#endif
+
+/* Connections accepted by lwIP and not yet taken with socket_accept */
+#ifndef LWIP_SOCKET_BACKLOG
+#define LWIP_SOCKET_BACKLOG		4
+#endif
+
+/*
+ * Sends of at least this many bytes are queued by reference instead of being
+ * copied in the lwIP segments. See lwip_socket_send.
+ */
+#ifndef LWIP_SOCKET_REF_MIN
+#define LWIP_SOCKET_REF_MIN		256
+#endif
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct lwip_network_desc
+ * @brief lwIP network descriptor
+ */
+struct lwip_network_desc;
+
+/**
+ * @struct lwip_network_init_param
+ * @brief Parameter to initialize the lwIP network backend. lwIP and the
+ * network interface (netif) must be initialized and up before.
+ */
+struct lwip_network_init_param {
+	/**
+	 * Process the received frames and the lwIP timers, for example
+	 * xemacif_input() on Xilinx. Called whenever the backend waits for
+	 * the stack, from the same context as the socket calls.
+	 */
+	void	(*poll)(void *ctx);
+	/** Parameter of poll */
+	void	*poll_ctx;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* lwIP network init */
+int32_t lwip_network_init(struct lwip_network_desc **desc,
+			  struct lwip_network_init_param *param);
+/* lwIP network remove */
+int32_t lwip_network_remove(struct lwip_network_desc *desc);
+/* lwIP network get network interface */
+int32_t lwip_network_get_network_interface(struct lwip_network_desc *desc,
+		struct network_interface **net);
+
+#endif /* LWIP_SOCKET_H_ */
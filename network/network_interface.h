@@ -47,6 +47,13 @@
 
 #include <stdint.h>
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Size of a buffer holding an IPv4 address string, with the terminator */
+#define SOCKET_ADDRSTRLEN	16
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -73,6 +80,17 @@ struct socket_address {
 	uint16_t	port;
 };
 
+/**
+ * @struct socket_iovec
+ * @brief Buffer of a scatter/gather send.
+ */
+struct socket_iovec {
+	/** Start of the buffer */
+	const void	*base;
+	/** Size of the buffer in bytes */
+	uint32_t	len;
+};
+
 /**
  * @struct network_interface
  * @brief Interface that connect the data layer with the transport layer
@@ -133,6 +151,20 @@ struct network_interface {
 	 */
 	int32_t (*socket_send)(void *net, uint32_t sock_id,
 			       const void *data, uint32_t size);
+	/**
+	 * @brief Send the buffers of iov, one after the other, over a TCP
+	 * socket, without first copying them together. Optional.
+	 * @param net - Network interface
+	 * @param sock_id - Socket id
+	 * @param iov - Buffers of data to send to the host
+	 * @param iovcnt - Number of buffers in iov
+	 * @return
+	 *  - Number of sent bytes, can be less than the total : On success
+	 *  - Negative error code : Otherwise
+	 */
+	int32_t (*socket_sendv)(void *net, uint32_t sock_id,
+				const struct socket_iovec *iov,
+				uint32_t iovcnt);
 	/**
 	 * @brief Receive data over a TCP socket.
 	 *
@@ -168,10 +200,11 @@ struct network_interface {
 	 * @param sock_id - Socket id
 	 * @param data - Destination buffer for received data
 	 * @param size - Maximum data to read
-	 * @param from - Destination for the source address or NULL
+	 * @param from - Destination for the source address or NULL. If set,
+	 * from->addr must point to SOCKET_ADDRSTRLEN bytes.
 	 * @return
-	 *  - Number of sent bytes : On success
-	 *  - -1 : Otherwise
+	 *  - Number of received bytes, 0 if there is no packet : On success
+	 *  - Negative error code : Otherwise
 	 */
 	int32_t (*socket_recvfrom)(void *net, uint32_t sock_id,
 				   void *data, uint32_t size,
@@ -218,6 +251,19 @@ struct network_interface {
 	 */
 	int32_t (*socket_accept)(void *net, uint32_t sock_id,
 				 uint32_t *client_socket_id);
+
+	/**
+	 * @brief Optional. Wait, without polling, until one of the sockets of
+	 * the network is ready: data was received, a connection is waiting to
+	 * be accepted or there is room to send again after a send didn't take
+	 * all the data.
+	 * @param net - Network interface
+	 * @param timeout_ms - Maximum time to wait
+	 * @return
+	 *  - Number of ready sockets, 0 if the timeout expired
+	 *  - \ref Negative error code on failure
+	 */
+	int32_t (*socket_wait)(void *net, uint32_t timeout_ms);
 };
 
 #endif
@@ -0,0 +1,333 @@
+/***************************************************************************//**
+ *   @file   noos_mbedtls_aes_alt.c
+ *   @brief  mbedtls AES over the AES engine of the platform (MBEDTLS_AES_ALT).
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#ifndef DISABLE_SECURE_SOCKET
+
+#include "noos_mbedtls_config.h"
+
+#ifdef MBEDTLS_AES_ALT
+
+#include <stdbool.h>
+#include <string.h>
+#include "mbedtls/aes.h"
+#include "mbedtls/platform_util.h"
+#include "no_os_util.h"
+
+#if defined(MAXIM_PLATFORM)
+#include "aes.h"
+#include "mxc_errors.h"
+#elif defined(STM32_PLATFORM)
+#include "stm32_hal.h"
+#endif
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#if defined(MBEDTLS_CIPHER_MODE_CFB) || defined(MBEDTLS_CIPHER_MODE_OFB) || \
+	defined(MBEDTLS_CIPHER_MODE_CTR) || defined(MBEDTLS_CIPHER_MODE_XTS)
+#error "Only the ECB and CBC modes are implemented over the AES engine"
+#endif
+
+#ifndef MBEDTLS_ERR_AES_HW_ACCEL_FAILED
+#define MBEDTLS_ERR_AES_HW_ACCEL_FAILED		-0x0025
+#endif
+
+#define AES_ALT_BLOCK_SIZE			16
+/* Timeout of an engine operation, in milliseconds */
+#define AES_ALT_TIMEOUT_MS			10
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+/* Source of mbedtls_aes_context.key_id */
+static uint32_t aes_alt_key_id;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+#if defined(MAXIM_PLATFORM) && defined(MXC_AES)
+
+/*
+ * One block with the MAX32 AES engine, the key is given as an external key.
+ * The engine keeps the key, it is loaded again only when another one is used.
+ */
+static int aes_alt_hw_crypt(const mbedtls_aes_context *ctx, int mode,
+			    const unsigned char input[16],
+			    unsigned char output[16])
+{
+	static uint32_t loaded_key_id;
+	static bool initialized;
+	uint32_t in[4], out[4];
+	mxc_aes_req_t req;
+	int ret;
+
+	if (!initialized) {
+		if (MXC_AES_Init() != E_NO_ERROR)
+			return MBEDTLS_ERR_AES_HW_ACCEL_FAILED;
+		initialized = true;
+	}
+
+	switch (ctx->keybits) {
+	case 128:
+		req.keySize = MXC_AES_128BITS;
+		break;
+	case 192:
+		req.keySize = MXC_AES_192BITS;
+		break;
+	default:
+		req.keySize = MXC_AES_256BITS;
+		break;
+	}
+
+	if (loaded_key_id != ctx->key_id) {
+		MXC_AES_SetExtKey(ctx->key, req.keySize);
+		loaded_key_id = ctx->key_id;
+	}
+
+	memcpy(in, input, sizeof(in));
+	req.length = NO_OS_ARRAY_SIZE(in);
+	req.inputData = in;
+	req.resultData = out;
+	req.callback = NULL;
+	if (mode == MBEDTLS_AES_ENCRYPT) {
+		req.encryption = MXC_AES_ENCRYPT_EXT_KEY;
+		ret = MXC_AES_Encrypt(&req);
+	} else {
+		req.encryption = MXC_AES_DECRYPT_EXT_KEY;
+		ret = MXC_AES_Decrypt(&req);
+	}
+	if (ret != E_NO_ERROR)
+		return MBEDTLS_ERR_AES_HW_ACCEL_FAILED;
+
+	memcpy(output, out, sizeof(out));
+
+	return 0;
+}
+
+#elif defined(STM32_PLATFORM) && defined(HAL_CRYP_MODULE_ENABLED)
+
+/*
+ * One block with the STM32 CRYP/AES peripheral in ECB mode. The peripheral is
+ * configured again only when the key or the direction changes, a decryption
+ * key schedule costs as much as a few blocks.
+ */
+static int aes_alt_hw_crypt(const mbedtls_aes_context *ctx, int mode,
+			    const unsigned char input[16],
+			    unsigned char output[16])
+{
+	static CRYP_HandleTypeDef hcryp;
+	static uint32_t key[8];
+	static uint32_t loaded_key_id;
+	static int loaded_mode = -1;
+	uint32_t in[4], out[4];
+	HAL_StatusTypeDef ret;
+	uint32_t i;
+
+	if (loaded_key_id != ctx->key_id || loaded_mode != mode) {
+		/* The peripheral takes the key as big endian words */
+		for (i = 0; i < ctx->keybits / 32; i++)
+			key[i] = no_os_get_unaligned_be32((uint8_t *)
+							  &ctx->key[4 * i]);
+
+#ifdef CRYP
+		__HAL_RCC_CRYP_CLK_ENABLE();
+		hcryp.Instance = CRYP;
+#else
+		__HAL_RCC_AES_CLK_ENABLE();
+		hcryp.Instance = AES;
+#endif
+		hcryp.Init.DataType = CRYP_DATATYPE_8B;
+		hcryp.Init.KeySize = ctx->keybits == 128 ? CRYP_KEYSIZE_128B :
+				     CRYP_KEYSIZE_256B;
+		hcryp.Init.pKey = key;
+		hcryp.Init.Algorithm = CRYP_AES_ECB;
+		if (hcryp.State == HAL_CRYP_STATE_RESET)
+			ret = HAL_CRYP_Init(&hcryp);
+		else
+			ret = HAL_CRYP_SetConfig(&hcryp, &hcryp.Init);
+		if (ret != HAL_OK) {
+			loaded_mode = -1;
+			return MBEDTLS_ERR_AES_HW_ACCEL_FAILED;
+		}
+
+		loaded_key_id = ctx->key_id;
+		loaded_mode = mode;
+	}
+
+	memcpy(in, input, sizeof(in));
+	if (mode == MBEDTLS_AES_ENCRYPT)
+		ret = HAL_CRYP_Encrypt(&hcryp, in, NO_OS_ARRAY_SIZE(in), out,
+				       AES_ALT_TIMEOUT_MS);
+	else
+		ret = HAL_CRYP_Decrypt(&hcryp, in, NO_OS_ARRAY_SIZE(in), out,
+				       AES_ALT_TIMEOUT_MS);
+	if (ret != HAL_OK)
+		return MBEDTLS_ERR_AES_HW_ACCEL_FAILED;
+
+	memcpy(output, out, sizeof(out));
+
+	return 0;
+}
+
+#else
+#error "ENABLE_HW_AES needs a MAX32 or STM32 part with an AES engine"
+#endif
+
+void mbedtls_aes_init(mbedtls_aes_context *ctx)
+{
+	memset(ctx, 0, sizeof(*ctx));
+}
+
+void mbedtls_aes_free(mbedtls_aes_context *ctx)
+{
+	if (!ctx)
+		return;
+
+	mbedtls_platform_zeroize(ctx, sizeof(*ctx));
+}
+
+int mbedtls_aes_setkey_enc(mbedtls_aes_context *ctx, const unsigned char *key,
+			   unsigned int keybits)
+{
+	switch (keybits) {
+	case 128:
+	case 256:
+		break;
+#if defined(MAXIM_PLATFORM)
+	case 192:
+		break;
+#endif
+	default:
+		return MBEDTLS_ERR_AES_INVALID_KEY_LENGTH;
+	}
+
+	memcpy(ctx->key, key, keybits / 8);
+	ctx->keybits = keybits;
+	/* 0 is never used, it is the value of the engines before any key */
+	if (!++aes_alt_key_id)
+		aes_alt_key_id++;
+	ctx->key_id = aes_alt_key_id;
+
+	return 0;
+}
+
+int mbedtls_aes_setkey_dec(mbedtls_aes_context *ctx, const unsigned char *key,
+			   unsigned int keybits)
+{
+	/* The engines derive the decryption key schedule themselves */
+	return mbedtls_aes_setkey_enc(ctx, key, keybits);
+}
+
+int mbedtls_internal_aes_encrypt(mbedtls_aes_context *ctx,
+				 const unsigned char input[16],
+				 unsigned char output[16])
+{
+	return aes_alt_hw_crypt(ctx, MBEDTLS_AES_ENCRYPT, input, output);
+}
+
+int mbedtls_internal_aes_decrypt(mbedtls_aes_context *ctx,
+				 const unsigned char input[16],
+				 unsigned char output[16])
+{
+	return aes_alt_hw_crypt(ctx, MBEDTLS_AES_DECRYPT, input, output);
+}
+
+int mbedtls_aes_crypt_ecb(mbedtls_aes_context *ctx, int mode,
+			  const unsigned char input[16],
+			  unsigned char output[16])
+{
+	if (mode != MBEDTLS_AES_ENCRYPT && mode != MBEDTLS_AES_DECRYPT)
+		return MBEDTLS_ERR_AES_BAD_INPUT_DATA;
+
+	return aes_alt_hw_crypt(ctx, mode, input, output);
+}
+
+#ifdef MBEDTLS_CIPHER_MODE_CBC
+/* The chaining is done here, the engine only does ECB blocks */
+int mbedtls_aes_crypt_cbc(mbedtls_aes_context *ctx, int mode, size_t length,
+			  unsigned char iv[16], const unsigned char *input,
+			  unsigned char *output)
+{
+	unsigned char block[AES_ALT_BLOCK_SIZE];
+	uint32_t i;
+	int ret;
+
+	if (mode != MBEDTLS_AES_ENCRYPT && mode != MBEDTLS_AES_DECRYPT)
+		return MBEDTLS_ERR_AES_BAD_INPUT_DATA;
+
+	if (length % AES_ALT_BLOCK_SIZE)
+		return MBEDTLS_ERR_AES_INVALID_INPUT_LENGTH;
+
+	while (length) {
+		if (mode == MBEDTLS_AES_ENCRYPT) {
+			for (i = 0; i < AES_ALT_BLOCK_SIZE; i++)
+				block[i] = input[i] ^ iv[i];
+			ret = aes_alt_hw_crypt(ctx, mode, block, output);
+			if (ret)
+				return ret;
+			memcpy(iv, output, AES_ALT_BLOCK_SIZE);
+		} else {
+			/* Input and output may be the same buffer */
+			memcpy(block, input, AES_ALT_BLOCK_SIZE);
+			ret = aes_alt_hw_crypt(ctx, mode, block, output);
+			if (ret)
+				return ret;
+			for (i = 0; i < AES_ALT_BLOCK_SIZE; i++)
+				output[i] ^= iv[i];
+			memcpy(iv, block, AES_ALT_BLOCK_SIZE);
+		}
+
+		input += AES_ALT_BLOCK_SIZE;
+		output += AES_ALT_BLOCK_SIZE;
+		length -= AES_ALT_BLOCK_SIZE;
+	}
+
+	return 0;
+}
+#endif /* MBEDTLS_CIPHER_MODE_CBC */
+
+#endif /* MBEDTLS_AES_ALT */
+
+#endif /* DISABLE_SECURE_SOCKET */
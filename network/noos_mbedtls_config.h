@@ -99,6 +99,22 @@
  */
 #define ENABLE_MEMORY_OPTIMIZATIONS
 
+/*
+ * Accept session tickets from the server (RFC 5077). With a session cache set
+ * in secure_init_param, a reconnection then resumes the session without the
+ * key exchange and the certificate checks. Servers without tickets can still
+ * resume by session id.
+ */
+#define ENABLE_SESSION_TICKETS
+
+/*
+ * Do the AES block operations with the AES engine of the platform (MAX32655
+ * and STM32 parts with a CRYP or AES peripheral), see noos_mbedtls_aes_alt.c.
+ * The hashes stay in software: the handshake clones the running SHA-256
+ * state, which these engines can't save and restore.
+ */
+//#define ENABLE_HW_AES
+
 /******************************************************************************/
 /********************* Minimal tls client requirements ************************/
 /******************************************************************************/
@@ -161,6 +177,15 @@
 
 #endif /* ENABLE_PEM_CERT */
 
+#ifdef ENABLE_SESSION_TICKETS
+#define MBEDTLS_SSL_SESSION_TICKETS
+#endif /* ENABLE_SESSION_TICKETS */
+
+#ifdef ENABLE_HW_AES
+/* aes_alt.h replaces the software AES */
+#define MBEDTLS_AES_ALT
+#endif /* ENABLE_HW_AES */
+
 /******************************************************************************/
 /**************** Solve dependencies needed by modules ************************/
 /******************************************************************************/
@@ -43,6 +43,7 @@
 /******************************************************************************/
 
 #include <stdlib.h>
+#include <stdbool.h>
 #include "no_os_error.h"
 #include "tcp_socket.h"
 #include "no_os_util.h"
@@ -51,6 +52,7 @@
 #include "mbedtls/ssl.h"
 #include "noos_mbedtls_config.h"
 #include "no_os_trng.h"
+#include "no_os_trng_pool.h"
 #endif /* DISABLE_SECURE_SOCKET */
 
 /******************************************************************************/
@@ -78,6 +80,17 @@
 /******************************************************************************/
 
 #ifndef DISABLE_SECURE_SOCKET
+/**
+ * @struct secure_session
+ * @brief Session of the last connection, to be resumed by the next one
+ */
+struct secure_session {
+	/** Session parameters, with the session ticket if there is one */
+	mbedtls_ssl_session	session;
+	/** Set when session can be resumed */
+	bool			valid;
+};
+
 /**
  * @struct secure_socket_desc
  * @brief Fields used by secure socket
@@ -85,6 +98,8 @@
 struct secure_socket_desc {
 	/** True random number generator reference */
 	struct no_os_trng_desc	*trng;
+	/** Entropy pool, used instead of trng if set */
+	struct no_os_trng_pool	*trng_pool;
 	/* Mbed structures */
 	/** CA certificate */
 	mbedtls_x509_crt	cacert;
@@ -96,6 +111,8 @@ struct secure_socket_desc {
 	mbedtls_ssl_config	conf;
 	/** Mbedtls tls context */
 	mbedtls_ssl_context	ssl;
+	/** Session cache given at init, NULL if not used */
+	struct secure_session	*session;
 };
 #endif /* DISABLE_SECURE_SOCKET */
 
@@ -143,7 +160,9 @@ static void stcp_socket_remove(struct secure_socket_desc *desc)
 	mbedtls_x509_crt_free(&desc->clicert);
 	mbedtls_x509_crt_free(&desc->cacert);
 	mbedtls_ssl_config_free(&desc->conf);
-	if (desc->trng)
+	if (desc->trng_pool)
+		no_os_trng_pool_remove(desc->trng_pool);
+	else if (desc->trng)
 		no_os_trng_remove(desc->trng);
 
 	free(desc);
@@ -154,8 +173,9 @@ static int32_t stcp_socket_init(struct secure_socket_desc **desc,
 				struct tcp_socket_desc *sock,
 				struct secure_init_param *param)
 {
-	struct secure_socket_desc	*ldesc;
-	int32_t				ret;
+	struct no_os_trng_pool_init_param	pool_param;
+	struct secure_socket_desc		*ldesc;
+	int32_t					ret;
 
 	if (!desc || !param)
 		return -1;
@@ -170,10 +190,21 @@ static int32_t stcp_socket_init(struct secure_socket_desc **desc,
 	mbedtls_x509_crt_init(&ldesc->clicert);
 	mbedtls_pk_init(&ldesc->pkey);
 
-	ret = no_os_trng_init(&ldesc->trng, param->trng_init_param);
-	if (NO_OS_IS_ERR_VALUE(ret)) {
-		ldesc->trng = NULL;
-		goto exit;
+	if (param->trng_pool_size) {
+		pool_param.trng_init_param = param->trng_init_param;
+		pool_param.size = param->trng_pool_size;
+		pool_param.low_watermark = 0;
+		ret = no_os_trng_pool_init(&ldesc->trng_pool, &pool_param);
+		if (NO_OS_IS_ERR_VALUE(ret)) {
+			ldesc->trng_pool = NULL;
+			goto exit;
+		}
+	} else {
+		ret = no_os_trng_init(&ldesc->trng, param->trng_init_param);
+		if (NO_OS_IS_ERR_VALUE(ret)) {
+			ldesc->trng = NULL;
+			goto exit;
+		}
 	}
 
 	/* Set default configuration: TLS client socket */
@@ -232,10 +263,16 @@ static int32_t stcp_socket_init(struct secure_socket_desc **desc,
 	}
 
 	/* Config Random number generator */
-	mbedtls_ssl_conf_rng(&ldesc->conf,
-			     (int (*)(void *, unsigned char *, size_t))
-			     no_os_trng_fill_buffer,
-			     (void *)ldesc->trng);
+	if (ldesc->trng_pool)
+		mbedtls_ssl_conf_rng(&ldesc->conf,
+				     (int (*)(void *, unsigned char *, size_t))
+				     no_os_trng_pool_fill_buffer,
+				     (void *)ldesc->trng_pool);
+	else
+		mbedtls_ssl_conf_rng(&ldesc->conf,
+				     (int (*)(void *, unsigned char *, size_t))
+				     no_os_trng_fill_buffer,
+				     (void *)ldesc->trng);
 
 	/* Set the resulting protocol configuration */
 	ret = mbedtls_ssl_setup(&ldesc->ssl, &ldesc->conf);
@@ -247,6 +284,7 @@ static int32_t stcp_socket_init(struct secure_socket_desc **desc,
 			    (mbedtls_ssl_send_t *)tls_net_send,
 			    (mbedtls_ssl_recv_t *)tls_net_recv, NULL);
 
+	ldesc->session = param->session;
 	*desc = ldesc;
 
 	return 0;
@@ -256,6 +294,78 @@ exit:
 
 	return ret;
 }
+
+/* Do the TLS handshake, resuming the cached session if there is one */
+static int32_t stcp_socket_handshake(struct secure_socket_desc *desc)
+{
+	struct secure_session *cache = desc->session;
+	int32_t ret;
+
+	/* The context may still hold the state of a previous connection */
+	ret = mbedtls_ssl_session_reset(&desc->ssl);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	/* If the server forgot the session, a full handshake is done */
+	if (cache && cache->valid) {
+		ret = mbedtls_ssl_set_session(&desc->ssl, &cache->session);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	do {
+		ret = mbedtls_ssl_handshake(&desc->ssl);
+	} while (ret == MBEDTLS_ERR_SSL_WANT_READ);
+	if (NO_OS_IS_ERR_VALUE(ret)) {
+		if (cache)
+			cache->valid = false;
+		return ret;
+	}
+
+	/* Keep the new session, its ticket may have been renewed */
+	if (cache)
+		cache->valid = !mbedtls_ssl_get_session(&desc->ssl,
+							&cache->session);
+
+	return 0;
+}
+
+/**
+ * @brief Allocate a TLS session cache, to be set in secure_init_param.
+ * @param session - Address where to store the session cache
+ * @return
+ *  - 0 : On success
+ *  - Negative error code : Otherwise
+ */
+int32_t secure_session_init(struct secure_session **session)
+{
+	struct secure_session *lsession;
+
+	if (!session)
+		return -EINVAL;
+
+	lsession = (typeof(lsession))calloc(1, sizeof(*lsession));
+	if (!lsession)
+		return -ENOMEM;
+
+	mbedtls_ssl_session_init(&lsession->session);
+	*session = lsession;
+
+	return 0;
+}
+
+/**
+ * @brief Free a TLS session cache. The sockets using it must be removed first.
+ * @param session - Session cache
+ */
+void secure_session_remove(struct secure_session *session)
+{
+	if (!session)
+		return;
+
+	mbedtls_ssl_session_free(&session->session);
+	free(session);
+}
 #endif /* DISABLE_SECURE_SOCKET */
 
 /**
@@ -355,9 +465,7 @@ int32_t socket_connect(struct tcp_socket_desc *desc,
 
 #ifndef DISABLE_SECURE_SOCKET
 	if (desc->secure) {
-		do {
-			ret = mbedtls_ssl_handshake(&desc->secure->ssl);
-		} while (ret == MBEDTLS_ERR_SSL_WANT_READ);
+		ret = stcp_socket_handshake(desc->secure);
 		if (NO_OS_IS_ERR_VALUE(ret))
 			return ret;
 	}
@@ -397,6 +505,38 @@ int32_t socket_send(struct tcp_socket_desc *desc, const void *data,
 				      data, len);
 }
 
+/** @brief See \ref network_interface.socket_sendv */
+int32_t socket_sendv(struct tcp_socket_desc *desc,
+		     const struct socket_iovec *iov, uint32_t iovcnt)
+{
+	uint32_t i, sent = 0;
+	int32_t ret;
+
+	if (!desc || (!iov && iovcnt))
+		return -1;
+
+#ifndef DISABLE_SECURE_SOCKET
+	if (!desc->secure && desc->net->socket_sendv)
+#else
+	if (desc->net->socket_sendv)
+#endif /* DISABLE_SECURE_SOCKET */
+		return desc->net->socket_sendv(desc->net->net, desc->id,
+					       iov, iovcnt);
+
+	/* Send the buffers one by one, until one is not sent entirely */
+	for (i = 0; i < iovcnt; i++) {
+		ret = socket_send(desc, iov[i].base, iov[i].len);
+		if (ret < 0)
+			return sent ? (int32_t)sent : ret;
+
+		sent += ret;
+		if ((uint32_t)ret < iov[i].len)
+			break;
+	}
+
+	return sent;
+}
+
 /** @brief See \ref network_interface.socket_recv */
 int32_t socket_recv(struct tcp_socket_desc *desc, void *data, uint32_t len)
 {
@@ -468,3 +608,15 @@ int32_t socket_accept(struct tcp_socket_desc *desc,
 	return 0;
 }
 
+/** @brief See \ref network_interface.socket_wait */
+int32_t socket_wait(struct tcp_socket_desc *desc, uint32_t timeout_ms)
+{
+	if (!desc)
+		return -EINVAL;
+
+	if (!desc->net->socket_wait)
+		return -ENOSYS;
+
+	return desc->net->socket_wait(desc->net->net, timeout_ms);
+}
+
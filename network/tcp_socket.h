@@ -60,6 +60,13 @@
 struct tcp_socket_desc;
 
 #ifndef DISABLE_SECURE_SOCKET
+/**
+ * @struct secure_session
+ * @brief TLS session kept between connections, to resume it instead of doing
+ * a full handshake
+ */
+struct secure_session;
+
 /**
  * @struct stcp_socket_init_param
  * @brief Parameter to initialize a TCP Socket
@@ -67,6 +74,12 @@ struct tcp_socket_desc;
 struct secure_init_param {
 	/** Init param for true random number generator */
 	struct no_os_trng_init_param	*trng_init_param;
+	/**
+	 * Size in bytes of the entropy pool, a power of 2. If set, the TRNG
+	 * fills the pool in background from the socket init, so the handshake
+	 * doesn't wait for the random bytes. If 0, the TRNG is read on demand.
+	 */
+	uint32_t			trng_pool_size;
 	/**
 	  * Certificate authority certificate.
 	  * If set, server identity will be verified, otherwise not.
@@ -90,6 +103,13 @@ struct secure_init_param {
 	uint8_t			*cli_pk;
 	/** cli_pk length */
 	uint32_t		cli_pk_len;
+	/**
+	 * Session cache from secure_session_init, optional. The session of
+	 * each connection is saved in it and the next connection using it,
+	 * from this socket or from a new one, resumes it with an abbreviated
+	 * handshake if the server agrees. Keep it across the reconnects.
+	 */
+	struct secure_session	*session;
 };
 
 #endif /* DISABLE_SECURE_SOCKET */
@@ -138,6 +158,10 @@ int32_t socket_disconnect(struct tcp_socket_desc *desc);
 int32_t socket_send(struct tcp_socket_desc *desc, const void *data,
 		    uint32_t len);
 
+/* Socket send from several buffers */
+int32_t socket_sendv(struct tcp_socket_desc *desc,
+		     const struct socket_iovec *iov, uint32_t iovcnt);
+
 /* Socket recv */
 int32_t socket_recv(struct tcp_socket_desc *desc, void *data, uint32_t len);
 
@@ -151,4 +175,15 @@ int32_t socket_listen(struct tcp_socket_desc *desc, uint32_t back_log);
 int32_t socket_accept(struct tcp_socket_desc *desc,
 		      struct tcp_socket_desc **new_client);
 
+/* Wait for one of the sockets of the network of desc to be ready */
+int32_t socket_wait(struct tcp_socket_desc *desc, uint32_t timeout_ms);
+
+#ifndef DISABLE_SECURE_SOCKET
+/* Allocate a TLS session cache */
+int32_t secure_session_init(struct secure_session **session);
+
+/* Free a TLS session cache */
+void secure_session_remove(struct secure_session *session);
+#endif /* DISABLE_SECURE_SOCKET */
+
 #endif
@@ -71,6 +71,8 @@
 #define PUI8(X)			((uint8_t *)(X))
 /* Timeout waiting for module response. (20 seconds) */
 #define MODULE_TIMEOUT		20000
+/* Bytes read at once from the uart when the reception is polled */
+#define RX_CHUNK_LEN		256u
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -127,6 +129,8 @@ struct at_desc {
 	struct no_os_irq_ctrl_desc	*irq_desc;
 	/* Uart irq id */
 	uint32_t		uart_irq_id;
+	/* Data is read in chunks by at_poll instead of by the irq callback */
+	bool			polled_rx;
 
 	/* - Connection related fields */
 	/* Structures storing connections status */
@@ -142,6 +146,7 @@ struct at_desc {
 		uint8_t	result_buff[RESULT_BUFF_LEN];
 		uint8_t	app_result_buff[RESULT_BUFF_LEN];
 		uint8_t	cmd_buff[CMD_BUFF_LEN];
+		uint8_t	rx_buff[RX_CHUNK_LEN];
 	} 			buffers;
 	/* Stores data received from the module */
 	volatile struct at_buff	result;
@@ -155,6 +160,8 @@ struct at_desc {
 	uint32_t errors;
 	/* Store the wifi status */
 	bool is_wifi_connected;
+	/* The SEND OK of the last AT_SEND was not received yet */
+	bool send_pending;
 	/* State of the callback */
 	volatile enum {
 		/* Normal mode. Read each char and interpret the result */
@@ -365,17 +372,14 @@ static inline void end_conn_read(struct at_desc *desc)
 	no_os_cb_end_async_write(conn->cbuff);
 }
 
-/* Start new read operation */
-static inline void start_conn_read(struct at_desc *desc, bool is_new_message)
+/* Ask the application for a buffer if the payload opens a new connection */
+static void open_conn(struct at_desc *desc)
 {
 	struct connection_desc	*conn;
-	uint8_t			*buff;
-	uint32_t		available_len;
-	uint32_t		ret;
 
 	conn = &desc->conn[desc->current_conn];
 
-	if (is_new_message && !conn->active) {
+	if (!conn->active) {
 		/*
 		 * Notify that a new connection has started. Application needs
 		 * to set a cbuff for the connection where data will be written.
@@ -393,6 +397,20 @@ static inline void start_conn_read(struct at_desc *desc, bool is_new_message)
 		 * no_os_uart_write_nonblocking
 		 */
 	}
+}
+
+/* Start new read operation */
+static inline void start_conn_read(struct at_desc *desc, bool is_new_message)
+{
+	struct connection_desc	*conn;
+	uint8_t			*buff;
+	uint32_t		available_len;
+	uint32_t		ret;
+
+	conn = &desc->conn[desc->current_conn];
+
+	if (is_new_message)
+		open_conn(desc);
 
 	if (!conn->cbuff)
 		/* There is no buffer set for this connection */
@@ -416,39 +434,157 @@ dummy_read:
 	conn->to_read -= 1;
 }
 
-/* Handle the uart events */
-static void at_callback(struct at_desc *desc, uint32_t event, uint8_t *data)
+/* Leave the payload state once all the payload bytes were received */
+static inline void consume_payload(struct at_desc *desc, uint32_t len)
+{
+	struct connection_desc	*conn;
+
+	conn = &desc->conn[desc->current_conn];
+	conn->to_read -= len;
+	if (!conn->to_read) {
+		desc->callback_operation = READING_RESPONSES;
+		desc->current_conn = -1;
+	}
+}
+
+/* Copy the payload bytes at the start of data in the connection buffer */
+static uint32_t write_payload(struct at_desc *desc, const uint8_t *data,
+			      uint32_t len)
+{
+	struct connection_desc	*conn;
+
+	conn = &desc->conn[desc->current_conn];
+	len = no_os_min(len, conn->to_read);
+	/* Data is discarded if there is no buffer set for this connection */
+	if (conn->cbuff)
+		no_os_cb_write(conn->cbuff, data, len);
+	consume_payload(desc, len);
+
+	return len;
+}
+
+/* Update the match of the message sent by the module when it is reset */
+static inline bool is_ready_message(struct at_desc *desc, uint8_t ch)
 {
 	static const struct at_buff ready_msg = {PUI8("ready\r\n"), 7};
 
+	return match_message(&ready_msg, &desc->ready_idx, ch);
+}
+
+/*
+ * Interpret a character received outside of a payload. Return true if it is
+ * the end of a payload header.
+ */
+static bool process_ch(struct at_desc *desc, uint8_t ch)
+{
+	if (is_payload_message(desc, ch))
+		return true;
+
+	if (ch == '>' && desc->callback_operation == WAITING_SEND) {
+		desc->callback_operation = READING_RESPONSES;
+	} else if (desc->result.len >= RESULT_BUFF_LEN) {
+		desc->errors |= AT_ERROR_INTERNAL_BUFFER_OVERFLOW;
+		desc->result.len = 0;
+	} else if (!is_async_messages(desc, ch)) {
+		/* Add received character to result buffer */
+		desc->result.buff[desc->result.len++] = ch;
+	}
+
+	return false;
+}
+
+/*
+ * Number of characters at the start of data that can be added to the result
+ * buffer as they are: no message is partially matched and none of them can
+ * start the payload header, an asynchronous message or the send prompt.
+ */
+static uint32_t skip_len(struct at_desc *desc, const uint8_t *data,
+			 uint32_t len)
+{
+	static const bool can_start[256] = {
+		['\r'] = true, ['>'] = true, ['C'] = true, ['W'] = true
+	};
+	uint32_t	i;
+
+	if (desc->ipd_idx)
+		return 0;
+	for (i = 0; i < NB_ASYNC_MESSAGES; i++)
+		if (desc->async_idx[i])
+			return 0;
+
+	for (i = 0; i < len && !can_start[data[i]]; i++)
+		;
+
+	return i;
+}
+
+/* Add characters to the result buffer at once */
+static inline void add_to_result(struct at_desc *desc, const uint8_t *data,
+				 uint32_t len)
+{
+	if (len > RESULT_BUFF_LEN - desc->result.len) {
+		desc->errors |= AT_ERROR_INTERNAL_BUFFER_OVERFLOW;
+		desc->result.len = 0;
+		return;
+	}
+
+	memcpy(desc->result.buff + desc->result.len, data, len);
+	desc->result.len += len;
+}
+
+/* Interpret a chunk of data received from the module */
+static void parse_rx(struct at_desc *desc, const uint8_t *data, uint32_t len)
+{
+	uint32_t	n;
+
+	while (len) {
+		switch (desc->callback_operation) {
+		case READING_PAYLOAD:
+			n = write_payload(desc, data, len);
+			break;
+		case RESETTING_MODULE:
+			n = 1;
+			if (is_ready_message(desc, *data))
+				desc->callback_operation = READING_RESPONSES;
+			break;
+		default:
+			n = skip_len(desc, data, len);
+			if (n) {
+				add_to_result(desc, data, n);
+				break;
+			}
+
+			n = 1;
+			if (process_ch(desc, *data)) {
+				/* New payload received */
+				desc->callback_operation = READING_PAYLOAD;
+				open_conn(desc);
+			}
+			break;
+		}
+		data += n;
+		len -= n;
+	}
+}
+
+/* Handle the uart events */
+static void at_callback(struct at_desc *desc, uint32_t event, uint8_t *data)
+{
 	switch (event) {
 	case NO_OS_IRQ_READ_DONE:
 		switch (desc->callback_operation) {
 		case RESETTING_MODULE:
-			if (match_message(&ready_msg, &desc->ready_idx,
-					  desc->read_ch))
+			if (is_ready_message(desc, desc->read_ch))
 				desc->callback_operation = READING_RESPONSES;
 			break;
 		case WAITING_SEND:
 		case READING_RESPONSES:
-			if (is_payload_message(desc, desc->read_ch)) {
+			if (process_ch(desc, desc->read_ch)) {
 				/* New payload received */
 				desc->callback_operation = READING_PAYLOAD;
 				start_conn_read(desc, true);
 				return ;
 			}
-
-			if (desc->read_ch == '>' && desc->callback_operation ==
-			    WAITING_SEND) {
-				desc->callback_operation = READING_RESPONSES;
-			} else if (desc->result.len >= RESULT_BUFF_LEN) {
-				desc->errors |=
-					AT_ERROR_INTERNAL_BUFFER_OVERFLOW;
-				desc->result.len = 0;
-			} else if (!is_async_messages(desc, desc->read_ch))
-				/* Add received character to result buffer */
-				desc->result.buff[desc->result.len++] =
-					desc->read_ch;
 			break;
 		case READING_PAYLOAD:
 			/* Receiving payload from connection */
@@ -494,7 +630,9 @@ static int32_t wait_for_response(struct at_desc *desc)
 	timeout = MODULE_TIMEOUT;
 	result = -1;
 	do {
-		if (i < desc->result.len) {
+		at_poll(desc);
+		/* Check everything received before waiting again */
+		while (i < desc->result.len) {
 			for (j = 0; j < NB_RESPONSE_MESSAGES; j++)
 				if (match_message(&responses[j],
 						  &desc->resp_idx[j],
@@ -527,6 +665,25 @@ end:
 	return result;
 }
 
+/*
+ * Wait for the SEND OK of the last AT_SEND. Its data is transmitted by the
+ * module while the next data is prepared, the result is collected here before
+ * the next command is written.
+ */
+static int32_t wait_send_done(struct at_desc *desc)
+{
+	int32_t	ret;
+
+	if (!desc->send_pending)
+		return 0;
+
+	desc->send_pending = false;
+	ret = wait_for_response(desc);
+	desc->result.len = 0;
+
+	return ret;
+}
+
 /* Send what is in desc->cmd over the UART and handle special case of AT_SEND */
 static int32_t send_cmd(struct at_desc *desc, enum at_cmd cmd,
 			union in_param *in_param)
@@ -541,6 +698,7 @@ static int32_t send_cmd(struct at_desc *desc, enum at_cmd cmd,
 			return -1;
 		/* Wait until '>' is received */
 		while (timeout--) {
+			at_poll(desc);
 			if (WAITING_SEND != desc->callback_operation)
 				break;
 			no_os_mdelay(1);
@@ -550,10 +708,15 @@ static int32_t send_cmd(struct at_desc *desc, enum at_cmd cmd,
 		/* Write payload */
 		no_os_uart_write(desc->uart_desc, in_param->send_data.data.buff,
 				 in_param->send_data.data.len);
+		/* SEND OK is waited for by the next command */
+		desc->send_pending = true;
+
+		return 0;
 	} else if (cmd == AT_DISCONNECT_NETWORK) {
 		if (desc->is_wifi_connected) {
 			/* Wait for WIFI_DISCONNECT */
 			do {
+				at_poll(desc);
 				if (desc->is_wifi_connected == 0)
 					break;
 				no_os_mdelay(1);
@@ -797,6 +960,7 @@ static int32_t handle_special(struct at_desc *desc, enum at_cmd cmd)
 		no_os_uart_write(desc->uart_desc, desc->cmd.buff, desc->cmd.len);
 		timeout = MODULE_TIMEOUT;
 		do {
+			at_poll(desc);
 			/* Wait for "ready" message */
 			if (desc->callback_operation != RESETTING_MODULE)
 				break;
@@ -805,7 +969,7 @@ static int32_t handle_special(struct at_desc *desc, enum at_cmd cmd)
 		if (!timeout)
 			return -1;
 
-		desc->callback_operation = READING_PAYLOAD;
+		desc->callback_operation = READING_RESPONSES;
 		desc->result.len = 0;
 		if (0 != stop_echo(desc))
 			return -1;
@@ -858,6 +1022,10 @@ int32_t at_run_cmd(struct at_desc *desc, enum at_cmd cmd, enum cmd_operation op,
 	if (!(g_map[cmd].type & op))
 		return -1;
 
+	ret = wait_send_done(desc);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
 	build_cmd(desc, cmd, op, param);
 
 	if (cmd == AT_DEEP_SLEEP || cmd == AT_RESET)
@@ -925,6 +1093,10 @@ int32_t at_init(struct at_desc **desc, const struct at_init_param *param)
 	ldesc->uart_desc = param->uart_desc;
 	ldesc->irq_desc = param->irq_desc;
 	ldesc->uart_irq_id = param->uart_irq_id;
+	ldesc->polled_rx = param->polled_rx;
+	if (ldesc->polled_rx)
+		goto link_buffers;
+
 	callback_desc.legacy_callback =
 		(void (*)(void*, uint32_t, void*))at_callback;
 	callback_desc.ctx = ldesc;
@@ -940,6 +1112,7 @@ int32_t at_init(struct at_desc **desc, const struct at_init_param *param)
 	/* The read will be handled by the callback */
 	no_os_uart_read_nonblocking(ldesc->uart_desc, &ldesc->read_ch, 1);
 
+link_buffers:
 	/* Link buffer structure with static buffers */
 	ldesc->result.buff = ldesc->buffers.result_buff;
 	ldesc->result.len = 0;
@@ -973,13 +1146,69 @@ int32_t at_init(struct at_desc **desc, const struct at_init_param *param)
 	return 0;
 
 free_irq:
-	no_os_irq_unregister_callback(ldesc->irq_desc, ldesc->uart_irq_id, NULL);
+	if (!ldesc->polled_rx)
+		no_os_irq_unregister_callback(ldesc->irq_desc,
+					      ldesc->uart_irq_id, NULL);
 free_desc:
 	free(ldesc);
 	*desc = NULL;
 	return -1;
 }
 
+/**
+ * @brief Read and interpret the data received from the module, when the
+ * parser was initialized with polled_rx. The uart is read in chunks and the
+ * payloads are read straight in the connection buffers. It is called while
+ * waiting for command responses and must be called periodically otherwise.
+ * @param desc - AT parser reference
+ * @return 0 on success, negative error code otherwise
+ */
+int32_t at_poll(struct at_desc *desc)
+{
+	struct connection_desc	*conn;
+	struct no_os_cb_regions	regions;
+	uint32_t		len;
+	int32_t			ret;
+
+	if (!desc)
+		return -EINVAL;
+
+	if (!desc->polled_rx)
+		return 0;
+
+	while (true) {
+		conn = NULL;
+		if (desc->callback_operation == READING_PAYLOAD)
+			conn = &desc->conn[desc->current_conn];
+
+		/* Read the payload straight in the connection buffer */
+		if (conn && conn->cbuff &&
+		    !no_os_cb_peek_write(conn->cbuff, conn->to_read,
+					 &regions) && regions.len[0]) {
+			ret = no_os_uart_read(desc->uart_desc,
+					      (uint8_t *)regions.buf[0],
+					      regions.len[0]);
+			if (ret > 0) {
+				no_os_cb_commit_write(conn->cbuff, ret);
+				consume_payload(desc, ret);
+			}
+		} else {
+			len = RX_CHUNK_LEN;
+			if (conn)
+				len = no_os_min(len, conn->to_read);
+			ret = no_os_uart_read(desc->uart_desc,
+					      desc->buffers.rx_buff, len);
+			if (ret > 0)
+				parse_rx(desc, desc->buffers.rx_buff, ret);
+		}
+
+		if (ret == -EAGAIN || ret == 0)
+			return 0;
+		if (ret < 0)
+			return ret;
+	}
+}
+
 /**
  * @brief Free resources allocated at \ref at_init
  * @param desc - AT parser reference
@@ -992,7 +1221,9 @@ int32_t at_remove(struct at_desc *desc)
 	if (!desc)
 		return -1;
 
-	no_os_irq_unregister_callback(desc->irq_desc, desc->uart_irq_id, NULL);
+	if (!desc->polled_rx)
+		no_os_irq_unregister_callback(desc->irq_desc, desc->uart_irq_id,
+					      NULL);
 	free(desc);
 
 	return 0;
@@ -183,6 +183,8 @@ enum at_cmd {
 	/**
 	 * Send data over connection
 	 * Use \ref in_param.send_data as set parameter
+	 * Returns once the data is written to the module. Its SEND OK is
+	 * waited for by the next command, which fails if the send failed.
 	 */
 	AT_SEND,			// "+CIPSEND"
 	/**
@@ -319,6 +321,12 @@ struct at_init_param {
 	void			*uart_irq_conf;
 	/* Context that will be passed to the callback */
 	void			*callback_ctx;
+	/*
+	 * If set, the uart irq callback is not used. The data is read in
+	 * chunks by at_poll from uart_desc, which must be initialized with
+	 * asynchronous_rx (or a DMA receive filling the uart read buffer).
+	 */
+	bool			polled_rx;
 	/*
 	 * Will be called when a new connection is created or deleted.
 	 * When an AT_NEW_CONNECTION event is received, user can save in cb a
@@ -346,6 +354,9 @@ int32_t at_init(struct at_desc **desc,const struct at_init_param *param);
 /* Free resources used by parser */
 int32_t at_remove(struct at_desc *desc);
 
+/* Read and interpret the data received from the module, for polled_rx */
+int32_t at_poll(struct at_desc *desc);
+
 /* Execute an AT command */
 int32_t at_run_cmd(struct at_desc *desc, enum at_cmd cmd, enum cmd_operation op,
 		   union in_out_param *param);
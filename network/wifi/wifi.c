@@ -109,6 +109,8 @@ struct wifi_desc {
 	struct network_interface	interface;
 	/* Will be used in callback */
 	int32_t				conn_id_to_sock_id[MAX_CONNECTIONS];
+	/* Buffers of a sendv gathered in one AT send */
+	uint8_t				sendv_buf[MAX_CIPSEND_DATA];
 };
 
 /******************************************************************************/
@@ -123,6 +125,9 @@ static int32_t wifi_socket_connect(struct wifi_desc *desc, uint32_t sock_id,
 static int32_t wifi_socket_disconnect(struct wifi_desc *desc, uint32_t sock_id);
 static int32_t wifi_socket_send(struct wifi_desc *desc, uint32_t sock_id,
 				const void *data, uint32_t size);
+static int32_t wifi_socket_sendv(struct wifi_desc *desc, uint32_t sock_id,
+				 const struct socket_iovec *iov,
+				 uint32_t iovcnt);
 static int32_t wifi_socket_recv(struct wifi_desc *desc, uint32_t sock_id,
 				void *data, uint32_t size);
 static int32_t wifi_socket_sendto(struct wifi_desc *desc, uint32_t sock_id,
@@ -216,6 +221,10 @@ static void wifi_init_interface(struct wifi_desc *desc)
 	desc->interface.socket_send =
 		(int32_t (*)(void *, uint32_t, const void *, uint32_t))
 		wifi_socket_send;
+	desc->interface.socket_sendv =
+		(int32_t (*)(void *, uint32_t, const struct socket_iovec *,
+			     uint32_t))
+		wifi_socket_sendv;
 	desc->interface.socket_recv =
 		(int32_t (*)(void *, uint32_t, void *, uint32_t))
 		wifi_socket_recv;
@@ -321,6 +330,7 @@ int32_t wifi_init(struct wifi_desc **desc, struct wifi_init_param *param)
 	at_param.uart_desc = param->uart_desc;
 	at_param.uart_irq_conf = param->uart_irq_conf;
 	at_param.uart_irq_id = param->uart_irq_id;
+	at_param.polled_rx = param->polled_rx;
 	at_param.connection_callback = _wifi_connection_callback;
 	at_param.callback_ctx = ldesc;
 
@@ -666,6 +676,55 @@ static int32_t wifi_socket_send(struct wifi_desc *desc, uint32_t sock_id,
 	return (int32_t)size;
 }
 
+/** @brief See \ref network_interface.socket_sendv */
+static int32_t wifi_socket_sendv(struct wifi_desc *desc, uint32_t sock_id,
+				 const struct socket_iovec *iov,
+				 uint32_t iovcnt)
+{
+	uint32_t	i, len, total, off;
+	int32_t		ret;
+
+	if (!desc || (!iov && iovcnt))
+		return -EINVAL;
+
+	/*
+	 * Gather the buffers in as few AT sends as possible, each send being
+	 * a command exchange with the module.
+	 */
+	total = 0;
+	len = 0;
+	for (i = 0; i < iovcnt; i++) {
+		off = 0;
+		while (off < iov[i].len) {
+			if (len == MAX_CIPSEND_DATA) {
+				ret = wifi_socket_send(desc, sock_id,
+						       desc->sendv_buf, len);
+				if (NO_OS_IS_ERR_VALUE(ret))
+					return total ? (int32_t)total : ret;
+
+				total += len;
+				len = 0;
+			}
+			ret = no_os_min(iov[i].len - off,
+					MAX_CIPSEND_DATA - len);
+			memcpy(desc->sendv_buf + len,
+			       (const uint8_t *)iov[i].base + off, ret);
+			len += ret;
+			off += ret;
+		}
+	}
+
+	if (len) {
+		ret = wifi_socket_send(desc, sock_id, desc->sendv_buf, len);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return total ? (int32_t)total : ret;
+
+		total += len;
+	}
+
+	return total;
+}
+
 /** @brief See \ref network_interface.socket_recv */
 static int32_t wifi_socket_recv(struct wifi_desc *desc, uint32_t sock_id,
 				void *data, uint32_t size)
@@ -678,6 +737,10 @@ static int32_t wifi_socket_recv(struct wifi_desc *desc, uint32_t sock_id,
 	    desc->server.id == sock_id)
 		return -EINVAL;
 
+	ret = at_poll(desc->at);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
 	/* TODO read data even if disconnected ? */
 	sock = &desc->sockets[sock_id];
 	if (sock->state != SOCKET_CONNECTED)
@@ -817,6 +880,7 @@ static int32_t wifi_socket_accept(struct wifi_desc *desc, uint32_t sock_id,
 				  uint32_t *client_socket_id)
 {
 	uint32_t		i;
+	int32_t			ret;
 
 	if (!desc || !client_socket_id || desc->server.id != sock_id)
 		return -EINVAL;
@@ -825,6 +889,10 @@ static int32_t wifi_socket_accept(struct wifi_desc *desc, uint32_t sock_id,
 	if (desc->sockets[desc->server.id].state != SOCKET_LISTENING)
 		return -ENOTCONN;
 
+	ret = at_poll(desc->at);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
 	for (i = 0; i < NB_SOCKETS; i++)
 		if (desc->sockets[i].state == SOCKET_WAITING_ACCEPT) {
 			desc->sockets[i].state = SOCKET_CONNECTED;
@@ -73,6 +73,12 @@ struct wifi_init_param {
 	uint32_t		uart_irq_id;
 	/** Configuration param for registering uart callback */
 	void			*uart_irq_conf;
+	/**
+	 * Read the uart in chunks when the sockets are used instead of one
+	 * character at a time from the uart irq. The uart must be initialized
+	 * with asynchronous_rx.
+	 */
+	bool			polled_rx;
 };
 
 /******************************************************************************/
@@ -50,6 +50,7 @@
 #include "no_os_gpio.h"
 #include "no_os_util.h"
 #include "no_os_delay.h"
+#include "no_os_dds.h"
 #include "xilinx_spi.h"
 #include "xilinx_gpio.h"
 #include "ad3552r.h"
@@ -124,20 +125,33 @@ void set_power_up_success_led()
 	no_os_gpio_remove(gpio);
 }
 
-extern const uint16_t no_os_sine_lut_16[512];
+/* Samples in a period of the generated sines */
+#define EXAMPLE_PERIOD_SAMPLES	512
 
 int32_t run_example(struct ad3552r_desc *dac)
 {
 	const uint32_t time_between_samples_us = 100;
-	uint32_t nb_samples, i;
+	struct no_os_dds dds[2];
+	uint32_t ftw, i;
 	uint16_t samples[2];
 	int32_t err;
 
-	nb_samples = NO_OS_ARRAY_SIZE(no_os_sine_lut_16);
-	i = 0;
+	/* Full scale sines in opposite phase on the two channels */
+	ftw = (uint32_t)((1ull << 32) / EXAMPLE_PERIOD_SAMPLES);
+	for (i = 0; i < NO_OS_ARRAY_SIZE(dds); i++) {
+		err = no_os_dds_init(&dds[i], 16, NO_OS_DDS_OFFSET_BINARY);
+		if (NO_OS_IS_ERR_VALUE(err))
+			return err;
+		err = no_os_dds_add_tone(&dds[i], ftw,
+					 NO_OS_DDS_PHASE_DEG(180 * i),
+					 NO_OS_DDS_FULL_SCALE - 1);
+		if (NO_OS_IS_ERR_VALUE(err))
+			return err;
+	}
+
 	do {
-		samples[0] = no_os_sine_lut_16[i];
-		samples[1] = no_os_sine_lut_16[(i + nb_samples / 2) % nb_samples];
+		no_os_dds_generate_interleaved(dds, NO_OS_ARRAY_SIZE(dds),
+					       samples, 1);
 		err = ad3552r_write_samples(dac, samples, 1,
 					    AD3552R_MASK_ALL_CH,
 					    AD3552R_WRITE_INPUT_REGS);
@@ -146,7 +160,6 @@ int32_t run_example(struct ad3552r_desc *dac)
 
 		no_os_udelay(time_between_samples_us);
 
-		i = (i + 1) % nb_samples;
 		err = ad3552r_ldac_trigger(dac, AD3552R_MASK_ALL_CH);
 	} while (!NO_OS_IS_ERR_VALUE(err));
 
@@ -289,6 +289,7 @@ int main()
 		.spi_eng_desc = spi_eng_desc,
 		.spi_engine_offload_message = &spi_engine_offload_message,
 		.dcache_invalidate_range = (void (*)(uint32_t, uint32_t))Xil_DCacheInvalidateRange,
+		.odr_pwm = axi_pwm,
 	};
 
 	ret = iio_dual_ad713x_init(&iio_ad713x, &iio_ad713x_init_par);
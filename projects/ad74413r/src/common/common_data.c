@@ -68,7 +68,7 @@ struct no_os_spi_init_param ad74413r_spi_ip = {
 };
 
 #ifdef IIO_TRIGGER_EXAMPLE
-/* GPIO trigger */
+/* GPIO trigger, wired to the active low ADC_RDY pin */
 struct no_os_irq_init_param ad74413r_gpio_irq_ip = {
 	.irq_ctrl_id = GPIO_IRQ_ID,
 	.platform_ops = GPIO_IRQ_OPS,
@@ -83,7 +83,7 @@ const struct iio_hw_trig_cb_info gpio_cb_info = {
 
 struct iio_hw_trig_init_param ad74413r_gpio_trig_ip = {
 	.irq_id = AD74413R_GPIO_TRIG_IRQ_ID,
-	.irq_trig_lvl = NO_OS_IRQ_EDGE_RISING,
+	.irq_trig_lvl = NO_OS_IRQ_EDGE_FALLING,
 	.cb_info = gpio_cb_info,
 	.name = AD74413R_GPIO_TRIG_NAME,
 };
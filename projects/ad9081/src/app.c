@@ -63,6 +63,7 @@
 #include "iio_app.h"
 #include "iio_axi_adc.h"
 #include "iio_axi_dac.h"
+#include "iio_ad9081.h"
 #endif
 
 #ifdef IIO_SUPPORT
@@ -344,7 +345,8 @@ int main(void)
 
 	struct iio_app_device devices[] = {
 		IIO_APP_DEVICE("axi_adc", iio_axi_adc_desc, adc_dev_desc, &read_buff, NULL),
-		IIO_APP_DEVICE("axi_dac", iio_axi_dac_desc, dac_dev_desc, NULL, &write_buff)
+		IIO_APP_DEVICE("axi_dac", iio_axi_dac_desc, dac_dev_desc, NULL, &write_buff),
+		IIO_APP_DEVICE("ad9081", phy[0], &ad9081_iio_descriptor, NULL, NULL)
 	};
 
 	iio_app_run(devices, NO_OS_ARRAY_SIZE(devices));
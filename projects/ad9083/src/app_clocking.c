@@ -202,17 +202,17 @@ int32_t app_clocking_init(struct app_clocking **app,
 	dev_ref_clk = ad9528_clk_round_rate(app_clocking->clkchip_device, ADC_REF_CLK,
 					    clk_hz[0]);
 
-	ret = ad9528_clk_set_rate(app_clocking->clkchip_device, FPGA_GLBL_CLK,
-				  fpga_glb_clk);
+	ret = ad9528_clk_stage_rate(app_clocking->clkchip_device, FPGA_GLBL_CLK,
+				    fpga_glb_clk);
 	if(ret < 0)
 		goto error_1;
 
-	ret = ad9528_clk_set_rate(app_clocking->clkchip_device, FPGA_REF_CLK,
-				  fpga_ref_clk);
+	ret = ad9528_clk_stage_rate(app_clocking->clkchip_device, FPGA_REF_CLK,
+				    fpga_ref_clk);
 	if(ret < 0)
 		goto error_1;
-	ret = ad9528_clk_set_rate(app_clocking->clkchip_device, ADC_REF_CLK,
-				  dev_ref_clk);
+	ret = ad9528_clk_stage_rate(app_clocking->clkchip_device, ADC_REF_CLK,
+				    dev_ref_clk);
 	if(ret < 0)
 		goto error_1;
 
@@ -231,13 +231,18 @@ int32_t app_clocking_init(struct app_clocking **app,
 		}
 	}
 
-	ret = ad9528_clk_set_rate(app_clocking->clkchip_device, FPGA_SYSREF_CLK,
-				  sys_ref_rate);
+	ret = ad9528_clk_stage_rate(app_clocking->clkchip_device, FPGA_SYSREF_CLK,
+				    sys_ref_rate);
 	if(ret < 0)
 		goto error_1;
 
-	ret = ad9528_clk_set_rate(app_clocking->clkchip_device, ADC_SYSREF_CLK,
-				  sys_ref_rate);
+	ret = ad9528_clk_stage_rate(app_clocking->clkchip_device, ADC_SYSREF_CLK,
+				    sys_ref_rate);
+	if(ret < 0)
+		goto error_1;
+
+	/* Apply all the new dividers with a single IO update */
+	ret = ad9528_clk_commit(app_clocking->clkchip_device, false);
 	if(ret < 0)
 		goto error_1;
 	*app = app_clocking;
@@ -65,6 +65,7 @@
 #ifdef IIO_SUPPORT
 #include "iio_app.h"
 #include "iio_axi_dac.h"
+#include "iio_ad9172.h"
 #endif
 
 int main(void)
@@ -348,6 +349,8 @@ int main(void)
 	struct iio_app_device devices[] = {
 		IIO_APP_DEVICE("axi_dac", iio_axi_dac_desc, dac_dev_desc,
 			       &write_buff, NULL),
+		IIO_APP_DEVICE("ad9172", ad9172_device, &ad9172_iio_descriptor,
+			       NULL, NULL),
 	};
 
 	return iio_app_run(devices, NO_OS_ARRAY_SIZE(devices));
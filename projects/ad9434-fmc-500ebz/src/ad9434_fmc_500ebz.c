@@ -133,10 +133,11 @@ int main(void)
 		return -1;
 	}
 
-	status = axi_adc_delay_calibrate(ad9434_core, nr_of_lanes + over_range_signal,
-					 AXI_ADC_PN9);
+	status = axi_adc_delay_calibrate_fast(ad9434_core,
+					      nr_of_lanes + over_range_signal,
+					      AXI_ADC_PN9, NULL);
 	if (status != 0) {
-		pr_info("axi_adc_delay_calibrate() failed!");
+		pr_info("axi_adc_delay_calibrate_fast() failed!");
 		return -1;
 	}
 
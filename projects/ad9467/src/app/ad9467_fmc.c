@@ -225,7 +225,7 @@ int main()
 	axi_adc_write(ad9467_core, AXI_ADC_REG_DELAY_CNTRL, 0x20F1F);
 
 	no_os_mdelay(10);
-	if (axi_adc_delay_calibrate(ad9467_core, 8, 1)) {
+	if (axi_adc_delay_calibrate_fast(ad9467_core, 8, 1, NULL)) {
 		ad9467_read(ad9467_device, 0x16, &ret_val);
 		printf("AD9467[0x016]: %02x\n\r", ret_val);
 		ad9467_write(ad9467_device, AD9467_REG_OUT_PHASE, 0x80);
@@ -234,7 +234,7 @@ int main()
 		ad9467_read(ad9467_device, 0x16, &ret_val);
 		printf("AD9467[0x016]: %02x\n\r", ret_val);
 		no_os_mdelay(10);
-		if (axi_adc_delay_calibrate(ad9467_core, 16, 1)) {
+		if (axi_adc_delay_calibrate_fast(ad9467_core, 16, 1, NULL)) {
 			printf("adc_setup: can not set a zero error delay!\n\r");
 		}
 	}
@@ -27,6 +27,8 @@ SRCS += $(PROJECT)/src/app/headless.c \
 	$(PROJECT)/src/app/app_jesd.c \
 	$(PROJECT)/src/app/app_transceiver.c \
 	$(PROJECT)/src/app/app_talise.c \
+	$(PROJECT)/src/app/app_talise_cal.c \
+	$(PROJECT)/src/app/app_talise_gain.c \
 	$(DRIVERS)/frequency/ad9528/ad9528.c \
 	$(PROJECT)/src/devices/adi_hal/no_os_hal.c \
 	$(DRIVERS)/frequency/hmc7044/hmc7044.c \
@@ -50,6 +52,8 @@ SRCS += $(DRIVERS)/axi_core/axi_adc_core/axi_adc_core.c \
 	$(DRIVERS)/axi_core/jesd204/axi_jesd204_tx.c \
 	$(DRIVERS)/api/no_os_spi.c \
 	$(DRIVERS)/api/no_os_gpio.c \
+	$(DRIVERS)/api/no_os_eeprom.c \
+	$(NO-OS)/util/no_os_crc16.c \
 	$(NO-OS)/jesd204/jesd204-core.c \
 	$(NO-OS)/jesd204/jesd204-fsm.c
 ifeq (y,$(strip $(TINYIIOD)))
@@ -62,7 +66,7 @@ SRCS += $(NO-OS)/util/no_os_fifo.c \
 	$(DRIVERS)/api/no_os_irq.c \
 	$(DRIVERS)/api/no_os_uart.c \
 	$(PLATFORM_DRIVERS)/$(PLATFORM)_uart.c \
-	$(NO-OS)/util/no_os_lf256fifo.c \
+	$(NO-OS)/util/no_os_lffifo.c \
 	$(PLATFORM_DRIVERS)/$(PLATFORM)_irq.c
 endif
 SRCS +=	$(NO-OS)/util/no_os_util.c
@@ -89,6 +93,8 @@ INCS +=	$(PROJECT)/src/app/app_config.h \
 	$(PROJECT)/src/app/app_jesd.h \
 	$(PROJECT)/src/app/app_transceiver.h \
 	$(PROJECT)/src/app/app_talise.h \
+	$(PROJECT)/src/app/app_talise_cal.h \
+	$(PROJECT)/src/app/app_talise_gain.h \
 	$(DRIVERS)/frequency/ad9528/ad9528.h \
 	$(PROJECT)/src/devices/adi_hal/adi_hal.h \
 	$(PROJECT)/src/devices/adi_hal/common.h \
@@ -142,6 +148,8 @@ INCS +=	$(PLATFORM_DRIVERS)/$(PLATFORM)_spi.h \
 INCS +=	$(INCLUDE)/no_os_axi_io.h \
 	$(INCLUDE)/no_os_spi.h \
 	$(INCLUDE)/no_os_gpio.h \
+	$(INCLUDE)/no_os_eeprom.h \
+	$(INCLUDE)/no_os_crc16.h \
 	$(INCLUDE)/no_os_error.h \
 	$(INCLUDE)/no_os_delay.h \
 	$(INCLUDE)/no_os_util.h \
@@ -153,7 +161,7 @@ ifeq (y,$(strip $(TINYIIOD)))
 INCS +=	$(INCLUDE)/no_os_fifo.h \
 	$(INCLUDE)/no_os_irq.h \
 	$(INCLUDE)/no_os_uart.h \
-	$(INCLUDE)/no_os_lf256fifo.h \
+	$(INCLUDE)/no_os_lffifo.h \
 	$(INCLUDE)/no_os_list.h \
 	$(PLATFORM_DRIVERS)/$(PLATFORM)_irq.h \
 	$(PLATFORM_DRIVERS)/$(PLATFORM)_uart.h \
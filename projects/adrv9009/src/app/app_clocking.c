@@ -486,29 +486,39 @@ adiHalErr_t clocking_init(uint32_t rx_div40_rate_hz,
 	if (dev_clk > 0 && fmc_clk > 0 && fmc_clk == dev_clk &&
 	    (dev_clk / 1000) == device_clock_khz) {
 #if defined(ZU11EG) || defined(FMCOMMS8_ZCU102)
-		ret = hmc7044_clk_set_rate(clkchip_device, DEV_REFCLK_A, dev_clk);
+		ret = hmc7044_clk_stage_rate(clkchip_device, DEV_REFCLK_A, dev_clk);
 		if (ret != 0) {
-			printf("hmc7044_clk_set_rate() error: %d\n", status);
+			printf("hmc7044_clk_stage_rate() error: %d\n", status);
 			goto error_1;
 		}
-		ret = hmc7044_clk_set_rate(clkchip_device, DEV_REFCLK_B, dev_clk);
+		ret = hmc7044_clk_stage_rate(clkchip_device, DEV_REFCLK_B, dev_clk);
 		if (ret != 0) {
-			printf("hmc7044_clk_set_rate() error: %d\n", status);
+			printf("hmc7044_clk_stage_rate() error: %d\n", status);
 			goto error_1;
 		}
-		ret = hmc7044_clk_set_rate(clkchip_device, JESD_REFCLK_TX_OBS_AB, fmc_clk);
+		ret = hmc7044_clk_stage_rate(clkchip_device, JESD_REFCLK_TX_OBS_AB, fmc_clk);
 		if (ret != 0) {
-			printf("hmc7044_clk_set_rate() error: %d\n", status);
+			printf("hmc7044_clk_stage_rate() error: %d\n", status);
 			goto error_1;
 		}
-		ret = hmc7044_clk_set_rate(clkchip_device, JESD_REFCLK_RX_AB, fmc_clk);
+		ret = hmc7044_clk_stage_rate(clkchip_device, JESD_REFCLK_RX_AB, fmc_clk);
 		if (ret != 0) {
-			printf("hmc7044_clk_set_rate() error: %d\n", status);
+			printf("hmc7044_clk_stage_rate() error: %d\n", status);
+			goto error_1;
+		}
+		ret = hmc7044_clk_commit(clkchip_device, false);
+		if (ret != 0) {
+			printf("hmc7044_clk_commit() error: %d\n", ret);
 			goto error_1;
 		}
 #else
-		ad9528_clk_set_rate(clkchip_device, DEV_CLK, dev_clk);
-		ad9528_clk_set_rate(clkchip_device, FMC_CLK, fmc_clk);
+		ad9528_clk_stage_rate(clkchip_device, DEV_CLK, dev_clk);
+		ad9528_clk_stage_rate(clkchip_device, FMC_CLK, fmc_clk);
+		ret = ad9528_clk_commit(clkchip_device, false);
+		if (ret != 0) {
+			printf("ad9528_clk_commit() error: %d\n", ret);
+			goto error_1;
+		}
 #endif
 	} else {
 		printf("Requesting device clock %u failed got %u\n",
@@ -541,36 +551,45 @@ adiHalErr_t clocking_init(uint32_t rx_div40_rate_hz,
 		}
 
 #if defined(ZU11EG) || defined(FMCOMMS8_ZCU102)
-		ret = hmc7044_clk_set_rate(clkchip_device, JESD_REFCLK_TX_OBS_AB, rate_fmc);
+		ret = hmc7044_clk_stage_rate(clkchip_device, JESD_REFCLK_TX_OBS_AB, rate_fmc);
 		if (ret)
 			printf("Failed to set JESD_REFCLK_TX_OBS_AB rate to %u Hz: %d\n",
 			       rate_fmc, ret);
-		ret = hmc7044_clk_set_rate(clkchip_device, JESD_REFCLK_RX_AB, rate_fmc);
+		ret = hmc7044_clk_stage_rate(clkchip_device, JESD_REFCLK_RX_AB, rate_fmc);
 		if (ret)
 			printf("Failed to set JESD_REFCLK_RX_AB rate to %u Hz: %d\n",
 			       rate_fmc, ret);
 #else
-		ret = ad9528_clk_set_rate(clkchip_device, FMC_SYSREF, rate_fmc);
+		ret = ad9528_clk_stage_rate(clkchip_device, FMC_SYSREF, rate_fmc);
 		if (ret)
 			printf("Failed to set FMC SYSREF rate to %u Hz: %d\n",
 			       rate_fmc, ret);
 #endif
 
 #if defined(ZU11EG) || defined(FMCOMMS8_ZCU102)
-		ret = hmc7044_clk_set_rate(clkchip_device, DEV_SYSREF_A, rate_dev);
+		ret = hmc7044_clk_stage_rate(clkchip_device, DEV_SYSREF_A, rate_dev);
 		if (ret)
 			printf("Failed to set DEV SYSREF A rate to %u Hz: %d\n",
 			       rate_dev, ret);
-		ret = hmc7044_clk_set_rate(clkchip_device, DEV_SYSREF_B, rate_dev);
+		ret = hmc7044_clk_stage_rate(clkchip_device, DEV_SYSREF_B, rate_dev);
 		if (ret)
 			printf("Failed to set DEV SYSREF B rate to %u Hz: %d\n",
 			       rate_dev, ret);
 #else
-		ret = ad9528_clk_set_rate(clkchip_device, DEV_SYSREF, rate_dev);
+		ret = ad9528_clk_stage_rate(clkchip_device, DEV_SYSREF, rate_dev);
 		if (ret)
 			printf("Failed to set DEV SYSREF rate to %u Hz: %d\n",
 			       rate_fmc, ret);
 #endif
+
+		/* Apply the new SYSREF dividers together */
+#if defined(ZU11EG) || defined(FMCOMMS8_ZCU102)
+		ret = hmc7044_clk_commit(clkchip_device, false);
+#else
+		ret = ad9528_clk_commit(clkchip_device, false);
+#endif
+		if (ret)
+			printf("Failed to update the SYSREF rates: %d\n", ret);
 	}
 
 #ifdef ALTERA_PLATFORM
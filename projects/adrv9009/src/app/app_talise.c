@@ -70,6 +70,7 @@
 
 // header
 #include "app_talise.h"
+#include "app_talise_cal.h"
 #include "app_jesd.h"
 
 
@@ -118,6 +119,7 @@ adiHalErr_t talise_setup(taliseDevice_t * const pd, taliseInit_t * const pi)
 
 	uint32_t api_vers[4];
 	uint8_t rev;
+	int ret;
 
 	/*******************************/
 	/**** Talise Initialization ***/
@@ -269,6 +271,16 @@ adiHalErr_t talise_setup(taliseDevice_t * const pd, taliseInit_t * const pi)
 	/****************************************************/
 	/**** Run Talise ARM Initialization Calibrations ***/
 	/****************************************************/
+	/* reuse the calibrations of the last boot, if nothing changed since */
+	ret = talise_cal_restore(pd, pi, initCalMask);
+	if (!ret) {
+		printf("talise: Calibrations restored\n");
+		goto cals_done;
+	} else if (ret != -ENOENT) {
+		printf("error: talise_cal_restore() failed\n");
+		goto error_11;
+	}
+
 	talAction = TALISE_runInitCals(pd, initCalMask);
 	if (talAction != TALACT_NO_ACTION) {
 		/*** < User: decide what to do based on Talise recovery action returned > ***/
@@ -292,6 +304,12 @@ adiHalErr_t talise_setup(taliseDevice_t * const pd, taliseInit_t * const pi)
 		printf("talise: Calibrations completed successfully\n");
 	}
 
+	ret = talise_cal_save(pd, pi, initCalMask);
+	if (ret)
+		printf("warning: talise_cal_save() failed\n");
+
+cals_done:
+
 	/***************************************************/
 	/**** Enable  Talise JESD204B Framer ***/
 	/***************************************************/
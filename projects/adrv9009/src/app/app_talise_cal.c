@@ -0,0 +1,249 @@
+/***************************************************************************//**
+ *   @file   app_talise_cal.c
+ *   @brief  Talise init calibrations snapshot in non volatile memory.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include "no_os_error.h"
+#include "no_os_crc16.h"
+#include "no_os_eeprom.h"
+#include "talise.h"
+#include "talise_arm.h"
+#include "talise_gpio.h"
+#include "talise_error.h"
+#include "adi_hal.h"
+#include "app_talise_cal.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+#define TALISE_CAL_CHUNK_SIZE		256
+#define TALISE_CAL_CRC16_POLY		0x1021
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+NO_OS_DECLARE_CRC16_TABLE(talise_cal_crc_table);
+static uint8_t talise_cal_crc_ready;
+static uint8_t talise_cal_chunk[TALISE_CAL_CHUNK_SIZE];
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Compute the crc of the configuration the calibrations depend on.
+ * @param pd - The Talise device.
+ * @param pi - The Talise init structure.
+ * @param cal_mask - The init calibrations mask.
+ * @param crc - The computed crc.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int talise_cal_config_crc(taliseDevice_t *pd, taliseInit_t *pi,
+				 uint32_t cal_mask, uint16_t *crc)
+{
+	taliseArmVersionInfo_t arm_version;
+	uint32_t talAction;
+
+	if (!talise_cal_crc_ready) {
+		no_os_crc16_populate_msb(talise_cal_crc_table,
+					 TALISE_CAL_CRC16_POLY);
+		talise_cal_crc_ready = 1;
+	}
+
+	talAction = TALISE_getArmVersion_v2(pd, &arm_version);
+	if (talAction != TALACT_NO_ACTION)
+		return -EIO;
+
+	*crc = no_os_crc16(talise_cal_crc_table, (uint8_t *)pi, sizeof(*pi),
+			   0xFFFF);
+	*crc = no_os_crc16(talise_cal_crc_table, (uint8_t *)&cal_mask,
+			   sizeof(cal_mask), *crc);
+	*crc = no_os_crc16(talise_cal_crc_table, (uint8_t *)&arm_version,
+			   sizeof(arm_version), *crc);
+
+	return 0;
+}
+
+/**
+ * @brief Save the init calibrations results in the EEPROM of the device HAL.
+ *
+ * The whole ARM data memory is saved, together with the configuration crc and
+ * the temperature. Nothing is done if the HAL has no EEPROM.
+ * @param pd - The Talise device, with the init calibrations completed.
+ * @param pi - The Talise init structure.
+ * @param cal_mask - The init calibrations mask that was run.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int talise_cal_save(taliseDevice_t *pd, taliseInit_t *pi, uint32_t cal_mask)
+{
+	struct adi_hal *hal = pd->devHalInfo;
+	struct talise_cal_hdr hdr = {0};
+	uint32_t talAction;
+	uint32_t addr, off;
+	int ret;
+
+	if (!hal->cal_eeprom)
+		return 0;
+
+	ret = talise_cal_config_crc(pd, pi, cal_mask, &hdr.config_crc);
+	if (ret)
+		return ret;
+
+	talAction = TALISE_getTemperature(pd, &hdr.temperature);
+	if (talAction != TALACT_NO_ACTION)
+		return -EIO;
+
+	addr = hal->cal_eeprom_addr + sizeof(hdr);
+	hdr.data_crc = 0xFFFF;
+	for (off = 0; off < TALISE_CAL_MEM_SIZE; off += TALISE_CAL_CHUNK_SIZE) {
+		talAction = TALISE_readArmMem(pd, TALISE_CAL_MEM_ADDR + off,
+					      talise_cal_chunk,
+					      TALISE_CAL_CHUNK_SIZE, 1);
+		if (talAction != TALACT_NO_ACTION)
+			return -EIO;
+
+		ret = no_os_eeprom_write(hal->cal_eeprom, addr + off,
+					 talise_cal_chunk,
+					 TALISE_CAL_CHUNK_SIZE);
+		if (ret)
+			return ret;
+
+		hdr.data_crc = no_os_crc16(talise_cal_crc_table,
+					   talise_cal_chunk,
+					   TALISE_CAL_CHUNK_SIZE,
+					   hdr.data_crc);
+	}
+
+	/* the header goes last so that an interrupted save is never valid */
+	hdr.magic = TALISE_CAL_MAGIC;
+	hdr.size = TALISE_CAL_MEM_SIZE;
+
+	ret = no_os_eeprom_write(hal->cal_eeprom, hal->cal_eeprom_addr,
+				 (uint8_t *)&hdr, sizeof(hdr));
+	if (ret)
+		return ret;
+
+	return no_os_eeprom_flush(hal->cal_eeprom);
+}
+
+/**
+ * @brief Restore the init calibrations results from the EEPROM of the device
+ * HAL, instead of running TALISE_runInitCals().
+ *
+ * The snapshot is only used if it is intact, the configuration and the ARM
+ * firmware match and the temperature did not change more than
+ * TALISE_CAL_MAX_TEMP_DELTA. Must be called with the ARM loaded and idle.
+ * @param pd - The Talise device.
+ * @param pi - The Talise init structure.
+ * @param cal_mask - The init calibrations mask that would be run.
+ * @return 0 if the calibrations were restored, -ENOENT if there is no valid
+ * snapshot and the calibrations have to be run, other negative error code
+ * otherwise.
+ */
+int talise_cal_restore(taliseDevice_t *pd, taliseInit_t *pi, uint32_t cal_mask)
+{
+	struct adi_hal *hal = pd->devHalInfo;
+	struct talise_cal_hdr hdr;
+	uint16_t config_crc, data_crc;
+	int16_t temperature;
+	uint32_t talAction;
+	uint32_t addr, off;
+	int ret;
+
+	if (!hal->cal_eeprom)
+		return -ENOENT;
+
+	ret = no_os_eeprom_read(hal->cal_eeprom, hal->cal_eeprom_addr,
+				(uint8_t *)&hdr, sizeof(hdr));
+	if (ret)
+		return ret;
+
+	if (hdr.magic != TALISE_CAL_MAGIC || hdr.size != TALISE_CAL_MEM_SIZE)
+		return -ENOENT;
+
+	ret = talise_cal_config_crc(pd, pi, cal_mask, &config_crc);
+	if (ret)
+		return ret;
+
+	if (config_crc != hdr.config_crc)
+		return -ENOENT;
+
+	talAction = TALISE_getTemperature(pd, &temperature);
+	if (talAction != TALACT_NO_ACTION)
+		return -EIO;
+
+	if (abs(temperature - hdr.temperature) > TALISE_CAL_MAX_TEMP_DELTA)
+		return -ENOENT;
+
+	addr = hal->cal_eeprom_addr + sizeof(hdr);
+
+	/* check the whole snapshot before touching the ARM memory */
+	data_crc = 0xFFFF;
+	for (off = 0; off < TALISE_CAL_MEM_SIZE; off += TALISE_CAL_CHUNK_SIZE) {
+		ret = no_os_eeprom_read(hal->cal_eeprom, addr + off,
+					talise_cal_chunk,
+					TALISE_CAL_CHUNK_SIZE);
+		if (ret)
+			return ret;
+
+		data_crc = no_os_crc16(talise_cal_crc_table, talise_cal_chunk,
+				       TALISE_CAL_CHUNK_SIZE, data_crc);
+	}
+
+	if (data_crc != hdr.data_crc)
+		return -ENOENT;
+
+	for (off = 0; off < TALISE_CAL_MEM_SIZE; off += TALISE_CAL_CHUNK_SIZE) {
+		ret = no_os_eeprom_read(hal->cal_eeprom, addr + off,
+					talise_cal_chunk,
+					TALISE_CAL_CHUNK_SIZE);
+		if (ret)
+			return ret;
+
+		talAction = TALISE_writeArmMem(pd, TALISE_CAL_MEM_ADDR + off,
+					       talise_cal_chunk,
+					       TALISE_CAL_CHUNK_SIZE);
+		if (talAction != TALACT_NO_ACTION)
+			return -EIO;
+	}
+
+	return 0;
+}
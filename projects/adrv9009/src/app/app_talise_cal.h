@@ -0,0 +1,72 @@
+/***************************************************************************//**
+ *   @file   app_talise_cal.h
+ *   @brief  Talise init calibrations snapshot in non volatile memory.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef __APP_TALISE_CAL_H
+#define __APP_TALISE_CAL_H
+
+#include <stdint.h>
+#include "talise_types.h"
+
+/* "TCAL", marks a valid snapshot */
+#define TALISE_CAL_MAGIC		0x5443414C
+/* max temperature difference (degC) to reuse a snapshot */
+#define TALISE_CAL_MAX_TEMP_DELTA	10
+/* the ARM data memory holds the init calibrations results */
+#define TALISE_CAL_MEM_ADDR		0x20000000
+#define TALISE_CAL_MEM_SIZE		0x14000
+
+/*
+ * Header of a snapshot in the EEPROM, followed by the ARM data memory. Both
+ * the configuration and the firmware have to match for the data to be valid.
+ */
+struct talise_cal_hdr {
+	uint32_t	magic;
+	uint32_t	size;
+	/* crc of the init structure, the init cals mask and the arm version */
+	uint16_t	config_crc;
+	uint16_t	data_crc;
+	/* temperature when the calibrations were run */
+	int16_t		temperature;
+	uint16_t	reserved;
+};
+
+/* Save the init calibrations results, done after TALISE_waitInitCals() */
+int talise_cal_save(taliseDevice_t *pd, taliseInit_t *pi, uint32_t cal_mask);
+/* Load the init calibrations results instead of running them */
+int talise_cal_restore(taliseDevice_t *pd, taliseInit_t *pi, uint32_t cal_mask);
+
+#endif /* __APP_TALISE_CAL_H */
@@ -0,0 +1,292 @@
+/***************************************************************************//**
+ *   @file   app_talise_gain.c
+ *   @brief  Talise Rx gain and Tx attenuation steps driven by GPIO pulses.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdlib.h>
+#include "no_os_error.h"
+#include "no_os_delay.h"
+#include "talise_rx.h"
+#include "talise_tx.h"
+#include "app_talise_gain.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Get the increment and decrement pins of a channel.
+ * @param inc_param - The increment pin init param.
+ * @param dec_param - The decrement pin init param.
+ * @param pin - The pins, left NULL if the params are NULL.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int talise_gain_pin_get(struct no_os_gpio_init_param *inc_param,
+			       struct no_os_gpio_init_param *dec_param,
+			       struct talise_gain_pin *pin)
+{
+	int ret;
+
+	if (!inc_param || !dec_param)
+		return 0;
+
+	ret = no_os_gpio_get(&pin->inc, inc_param);
+	if (ret)
+		return ret;
+
+	ret = no_os_gpio_direction_output(pin->inc, NO_OS_GPIO_LOW);
+	if (ret)
+		return ret;
+
+	ret = no_os_gpio_get(&pin->dec, dec_param);
+	if (ret)
+		return ret;
+
+	return no_os_gpio_direction_output(pin->dec, NO_OS_GPIO_LOW);
+}
+
+/**
+ * @brief Send a train of pulses on a pin.
+ * @param desc - The gain descriptor.
+ * @param gpio - The pin.
+ * @param pulses - The number of pulses.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int talise_gain_pulse(struct talise_gain_desc *desc,
+			     struct no_os_gpio_desc *gpio, uint32_t pulses)
+{
+	int ret;
+
+	while (pulses--) {
+		ret = no_os_gpio_set_value(gpio, NO_OS_GPIO_HIGH);
+		if (ret)
+			return ret;
+		if (desc->pulse_us)
+			no_os_udelay(desc->pulse_us);
+
+		ret = no_os_gpio_set_value(gpio, NO_OS_GPIO_LOW);
+		if (ret)
+			return ret;
+		if (desc->pulse_us)
+			no_os_udelay(desc->pulse_us);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Pulse the increment or the decrement pin of a channel.
+ * @param desc - The gain descriptor.
+ * @param pin - The pins of the channel.
+ * @param steps - Positive to increment, negative to decrement.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int talise_gain_step(struct talise_gain_desc *desc,
+			    struct talise_gain_pin *pin, int32_t steps)
+{
+	if (!pin->inc || !pin->dec)
+		return -ENODEV;
+
+	if (steps >= 0)
+		return talise_gain_pulse(desc, pin->inc, steps);
+
+	return talise_gain_pulse(desc, pin->dec, -steps);
+}
+
+/**
+ * @brief Put the channels with pins in pin control. The Rx channels are
+ * switched to manual gain control, the gain then only changes on the pulses.
+ * @param desc - The gain descriptor.
+ * @param pd - The Talise device, initialized.
+ * @param param - The pins of the channels.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int talise_gain_init(struct talise_gain_desc **desc, taliseDevice_t *pd,
+		     struct talise_gain_init_param *param)
+{
+	struct talise_gain_desc *d;
+	uint32_t talAction;
+	bool rx_pins = false;
+	int ret;
+	int i;
+
+	if (!desc || !pd || !param)
+		return -EINVAL;
+
+	d = calloc(1, sizeof(*d));
+	if (!d)
+		return -ENOMEM;
+
+	d->pd = pd;
+	d->pulse_us = param->pulse_us;
+
+	for (i = 0; i < TALISE_NUM_CHAIN_CHANNELS; i++) {
+		ret = talise_gain_pin_get(param->rx[i].inc_gpio,
+					  param->rx[i].dec_gpio, &d->rx[i]);
+		if (ret)
+			goto error;
+		if (d->rx[i].inc)
+			rx_pins = true;
+
+		ret = talise_gain_pin_get(param->tx[i].inc_gpio,
+					  param->tx[i].dec_gpio, &d->tx[i]);
+		if (ret)
+			goto error;
+	}
+
+	if (rx_pins) {
+		talAction = TALISE_setRxGainControlMode(pd, TAL_MGC);
+		if (talAction != TALACT_NO_ACTION) {
+			ret = -EIO;
+			goto error;
+		}
+	}
+
+	for (i = 0; i < TALISE_NUM_CHAIN_CHANNELS; i++) {
+		if (d->rx[i].inc) {
+			d->rx_cfg[i] = param->rx[i].cfg;
+			d->rx_cfg[i].enable = 1;
+			talAction = TALISE_setRxGainCtrlPin(pd, TAL_RX1 + i,
+							    &d->rx_cfg[i]);
+			if (talAction != TALACT_NO_ACTION) {
+				d->rx_cfg[i].enable = 0;
+				ret = -EIO;
+				goto error;
+			}
+		}
+
+		if (d->tx[i].inc) {
+			d->tx_cfg[i] = param->tx[i].cfg;
+			d->tx_cfg[i].enable = 1;
+			talAction = TALISE_setTxAttenCtrlPin(pd, TAL_TX1 + i,
+							     &d->tx_cfg[i]);
+			if (talAction != TALACT_NO_ACTION) {
+				d->tx_cfg[i].enable = 0;
+				ret = -EIO;
+				goto error;
+			}
+		}
+	}
+
+	*desc = d;
+
+	return 0;
+error:
+	talise_gain_remove(d);
+
+	return ret;
+}
+
+/**
+ * @brief Disable the pin control of the channels and free the pins.
+ * @param desc - The gain descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int talise_gain_remove(struct talise_gain_desc *desc)
+{
+	uint32_t talAction;
+	int ret = 0;
+	int i;
+
+	if (!desc)
+		return -EINVAL;
+
+	for (i = 0; i < TALISE_NUM_CHAIN_CHANNELS; i++) {
+		if (desc->rx_cfg[i].enable) {
+			desc->rx_cfg[i].enable = 0;
+			talAction = TALISE_setRxGainCtrlPin(desc->pd,
+							    TAL_RX1 + i,
+							    &desc->rx_cfg[i]);
+			if (talAction != TALACT_NO_ACTION)
+				ret = -EIO;
+		}
+
+		if (desc->tx_cfg[i].enable) {
+			desc->tx_cfg[i].enable = 0;
+			talAction = TALISE_setTxAttenCtrlPin(desc->pd,
+							     TAL_TX1 + i,
+							     &desc->tx_cfg[i]);
+			if (talAction != TALACT_NO_ACTION)
+				ret = -EIO;
+		}
+
+		no_os_gpio_remove(desc->rx[i].inc);
+		no_os_gpio_remove(desc->rx[i].dec);
+		no_os_gpio_remove(desc->tx[i].inc);
+		no_os_gpio_remove(desc->tx[i].dec);
+	}
+
+	free(desc);
+
+	return ret;
+}
+
+/**
+ * @brief Step the gain of an Rx channel with a train of pulses, no SPI access
+ * is done. The gain index saturates at the limits of the gain table.
+ * @param desc - The gain descriptor.
+ * @param channel - TAL_RX1 or TAL_RX2.
+ * @param steps - Number of pulses, positive to increment the gain.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int talise_gain_rx_step(struct talise_gain_desc *desc,
+			taliseRxChannels_t channel, int32_t steps)
+{
+	if (!desc || (channel != TAL_RX1 && channel != TAL_RX2))
+		return -EINVAL;
+
+	return talise_gain_step(desc, &desc->rx[channel - TAL_RX1], steps);
+}
+
+/**
+ * @brief Step the attenuation of a Tx channel with a train of pulses, no SPI
+ * access is done.
+ * @param desc - The gain descriptor.
+ * @param channel - TAL_TX1 or TAL_TX2.
+ * @param steps - Number of pulses, positive to increment the attenuation.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int talise_gain_tx_step(struct talise_gain_desc *desc,
+			taliseTxChannels_t channel, int32_t steps)
+{
+	if (!desc || (channel != TAL_TX1 && channel != TAL_TX2))
+		return -EINVAL;
+
+	return talise_gain_step(desc, &desc->tx[channel - TAL_TX1], steps);
+}
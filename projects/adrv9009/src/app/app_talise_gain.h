@@ -0,0 +1,100 @@
+/***************************************************************************//**
+ *   @file   app_talise_gain.h
+ *   @brief  Talise Rx gain and Tx attenuation steps driven by GPIO pulses.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef __APP_TALISE_GAIN_H
+#define __APP_TALISE_GAIN_H
+
+#include <stdint.h>
+#include "talise_types.h"
+#include "no_os_gpio.h"
+#include "app_talise.h"
+
+/*
+ * Pins of the FPGA wired to the increment and decrement Talise GPIOs of a
+ * channel. A channel without gpio init params is not pin controlled. The
+ * Talise pins and steps are in cfg, enable is set by talise_gain_init().
+ */
+struct talise_gain_rx_init {
+	taliseRxGainCtrlPin_t		cfg;
+	struct no_os_gpio_init_param	*inc_gpio;
+	struct no_os_gpio_init_param	*dec_gpio;
+};
+
+struct talise_gain_tx_init {
+	taliseTxAttenCtrlPin_t		cfg;
+	struct no_os_gpio_init_param	*inc_gpio;
+	struct no_os_gpio_init_param	*dec_gpio;
+};
+
+struct talise_gain_init_param {
+	struct talise_gain_rx_init	rx[TALISE_NUM_CHAIN_CHANNELS];
+	struct talise_gain_tx_init	tx[TALISE_NUM_CHAIN_CHANNELS];
+	/* high and low time of a pulse, 0 to toggle as fast as the GPIO does */
+	uint32_t			pulse_us;
+};
+
+struct talise_gain_pin {
+	struct no_os_gpio_desc		*inc;
+	struct no_os_gpio_desc		*dec;
+};
+
+struct talise_gain_desc {
+	taliseDevice_t			*pd;
+	struct talise_gain_pin		rx[TALISE_NUM_CHAIN_CHANNELS];
+	struct talise_gain_pin		tx[TALISE_NUM_CHAIN_CHANNELS];
+	/* pin configurations, kept to disable the pin control on remove */
+	taliseRxGainCtrlPin_t		rx_cfg[TALISE_NUM_CHAIN_CHANNELS];
+	taliseTxAttenCtrlPin_t		tx_cfg[TALISE_NUM_CHAIN_CHANNELS];
+	uint32_t			pulse_us;
+};
+
+/* Put the channels in pin control, the Rx ones in manual gain control */
+int talise_gain_init(struct talise_gain_desc **desc, taliseDevice_t *pd,
+		     struct talise_gain_init_param *param);
+/* Give the gain control back to SPI and free the pins */
+int talise_gain_remove(struct talise_gain_desc *desc);
+/*
+ * Pulse the increment (steps > 0) or decrement (steps < 0) pin |steps| times,
+ * each pulse moving the gain index by the incStep or decStep of the channel.
+ */
+int talise_gain_rx_step(struct talise_gain_desc *desc,
+			taliseRxChannels_t channel, int32_t steps);
+/* Same for the Tx attenuation, each pulse moving it by stepSize * 0.05 dB */
+int talise_gain_tx_step(struct talise_gain_desc *desc,
+			taliseTxChannels_t channel, int32_t steps);
+
+#endif /* __APP_TALISE_GAIN_H */
@@ -13,6 +13,7 @@
 #include <stdint.h>
 #include <stddef.h>
 #include "no_os_util.h"
+#include "no_os_eeprom.h"
 
 #define u16 			uint16_t
 #define DIV_U64(x, y) no_os_div_u64(x, y)
@@ -33,6 +34,9 @@ struct adi_hal {
 	uint8_t			spi_adrv_csn;
 	void 			*extra_gpio;
 	uint8_t			gpio_adrv_resetb_num;
+	/* optional, where the init calibrations are saved (see app_talise_cal.h) */
+	struct no_os_eeprom_desc	*cal_eeprom;
+	uint32_t		cal_eeprom_addr;
 };
 
 /**
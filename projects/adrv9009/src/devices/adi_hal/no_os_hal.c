@@ -41,6 +41,7 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdio.h>
+#include <stdbool.h>
 #include "adi_hal.h"
 #include "parameters.h"
 #include "no_os_spi.h"
@@ -55,6 +56,30 @@
 #include "altera_gpio.h"
 #endif
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+/* SPI frames (2 address bytes, 1 data byte) sent with one transfer */
+#define ADIHAL_SPI_BATCH_SIZE	64
+#define ADIHAL_SPI_FRAME_SIZE	3
+#define ADIHAL_SPI_BATCH_BYTES	(ADIHAL_SPI_BATCH_SIZE * ADIHAL_SPI_FRAME_SIZE)
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+struct adihal_spi_batch {
+	struct no_os_spi_msg	msgs[ADIHAL_SPI_BATCH_SIZE];
+	uint8_t			buf[ADIHAL_SPI_BATCH_BYTES];
+	volatile bool		busy;
+	int32_t			ret;
+};
+
+/*
+ * Two batches, one is filled while the other one is sent. Only used by the
+ * blocking HAL calls, so they can be shared by all the devices.
+ */
+static struct adihal_spi_batch adihal_spi_batch[2];
+
 /******************************************************************************/
 /************************** Functions Implementation **************************/
 /******************************************************************************/
@@ -184,19 +209,92 @@ adiHalErr_t ADIHAL_spiWriteByte(void *devHalInfo,
 		return ADIHAL_OK;
 }
 
-adiHalErr_t ADIHAL_spiWriteBytes(void *devHalInfo,
-				 uint16_t *addr, uint8_t *data, uint32_t count)
+static void adihal_spi_batch_done(void *ctx, int32_t ret)
 {
-	adiHalErr_t errVal;
+	struct adihal_spi_batch *batch = ctx;
+
+	batch->ret = ret;
+	batch->busy = false;
+}
+
+static int32_t adihal_spi_batch_wait(struct adihal_spi_batch *batch)
+{
+	while (batch->busy)
+		;
+
+	return batch->ret;
+}
+
+/*
+ * Fill a batch with count frames, each one is a separate SPI transaction.
+ * Reads keep the returned data in place of the frames.
+ */
+static void adihal_spi_batch_fill(struct adihal_spi_batch *batch,
+				  uint16_t *addr, uint8_t *data, uint32_t count,
+				  bool read)
+{
+	uint8_t *buf;
 	uint32_t i;
 
 	for (i = 0; i < count; i++) {
-		errVal = ADIHAL_spiWriteByte(devHalInfo, addr[i], data[i]);
-		if (errVal)
-			return errVal;
+		buf = &batch->buf[i * ADIHAL_SPI_FRAME_SIZE];
+		buf[0] = (read ? 0x80 : 0x00) | ((addr[i] >> 8) & 0x7F);
+		buf[1] = addr[i] & 0xFF;
+		buf[2] = read ? 0x00 : data[i];
+
+		batch->msgs[i].tx_buff = buf;
+		batch->msgs[i].rx_buff = buf;
+		batch->msgs[i].bytes_number = ADIHAL_SPI_FRAME_SIZE;
+		batch->msgs[i].cs_change = 1;
 	}
+}
 
-	return ADIHAL_OK;
+adiHalErr_t ADIHAL_spiWriteBytes(void *devHalInfo,
+				 uint16_t *addr, uint8_t *data, uint32_t count)
+{
+	struct adi_hal *devHalData = (struct adi_hal *)devHalInfo;
+	struct adihal_spi_batch *batch;
+	uint32_t i, n, cur = 0;
+	int32_t status = 0;
+	int32_t ret;
+
+	/*
+	 * The ARM and stream images are written through here. Send the frames
+	 * in batches, preparing the next one while the previous one is sent.
+	 */
+	for (i = 0; i < count; i += n) {
+		n = no_os_min(count - i, ADIHAL_SPI_BATCH_SIZE);
+		batch = &adihal_spi_batch[cur];
+
+		status = adihal_spi_batch_wait(batch);
+		if (status)
+			break;
+
+		adihal_spi_batch_fill(batch, &addr[i], &data[i], n, false);
+		batch->busy = true;
+		status = no_os_spi_transfer_async(devHalData->spi_adrv_desc,
+						  batch->msgs, n,
+						  adihal_spi_batch_done, batch);
+		if (status) {
+			batch->busy = false;
+			break;
+		}
+
+		cur ^= 1;
+	}
+
+	/* both batches must be done before returning, whatever the result */
+	for (i = 0; i < NO_OS_ARRAY_SIZE(adihal_spi_batch); i++) {
+		ret = adihal_spi_batch_wait(&adihal_spi_batch[i]);
+		if (ret && !status)
+			status = ret;
+		adihal_spi_batch[i].ret = 0;
+	}
+
+	if (status != 0)
+		return ADIHAL_SPI_FAIL;
+	else
+		return ADIHAL_OK;
 }
 
 adiHalErr_t ADIHAL_spiReadByte(void *devHalInfo,
@@ -223,13 +321,24 @@ adiHalErr_t ADIHAL_spiReadByte(void *devHalInfo,
 adiHalErr_t ADIHAL_spiReadBytes(void *devHalInfo,
 				uint16_t *addr, uint8_t *readdata, uint32_t count)
 {
-	adiHalErr_t errVal;
-	uint32_t i;
+	struct adi_hal *devHalData = (struct adi_hal *)devHalInfo;
+	struct adihal_spi_batch *batch = &adihal_spi_batch[0];
+	uint32_t i, j, n;
+	int32_t status;
 
-	for (i = 0; i < count; i++) {
-		errVal = ADIHAL_spiReadByte(devHalInfo, addr[i], &readdata[i]);
-		if (errVal)
-			return errVal;
+	for (i = 0; i < count; i += n) {
+		n = no_os_min(count - i, ADIHAL_SPI_BATCH_SIZE);
+
+		adihal_spi_batch_fill(batch, &addr[i], NULL, n, true);
+		status = no_os_spi_transfer(devHalData->spi_adrv_desc,
+					    batch->msgs, n);
+		if (status != 0)
+			return ADIHAL_SPI_FAIL;
+
+		/* the data byte is the last one of each frame */
+		for (j = 0; j < n; j++)
+			readdata[i + j] =
+				batch->buf[(j + 1) * ADIHAL_SPI_FRAME_SIZE - 1];
 	}
 
 	return ADIHAL_OK;
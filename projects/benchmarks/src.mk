@@ -0,0 +1,40 @@
+SRCS += $(PROJECT)/src/main.c \
+	$(PROJECT)/src/bench.c \
+	$(PROJECT)/src/bench_mock.c \
+	$(PROJECT)/src/bench_util.c \
+	$(PROJECT)/src/bench_iio.c
+
+INCS += $(PROJECT)/src/bench.h \
+	$(PROJECT)/src/bench_mock.h
+
+SRCS += $(DRIVERS)/api/no_os_spi.c \
+	$(DRIVERS)/api/no_os_i2c.c \
+	$(DRIVERS)/api/no_os_uart.c \
+	$(DRIVERS)/platform/linux/linux_delay.c \
+	$(NO-OS)/util/no_os_alloc.c \
+	$(NO-OS)/util/no_os_crc8.c \
+	$(NO-OS)/util/no_os_crc16.c \
+	$(NO-OS)/util/no_os_crc24.c \
+	$(NO-OS)/util/no_os_unpack.c \
+	$(NO-OS)/util/no_os_circular_buffer.c \
+	$(NO-OS)/util/no_os_fifo.c \
+	$(NO-OS)/util/no_os_list.c \
+	$(NO-OS)/util/no_os_util.c
+
+INCS += $(INCLUDE)/no_os_alloc.h \
+	$(INCLUDE)/no_os_circular_buffer.h \
+	$(INCLUDE)/no_os_crc8.h \
+	$(INCLUDE)/no_os_crc16.h \
+	$(INCLUDE)/no_os_crc24.h \
+	$(INCLUDE)/no_os_delay.h \
+	$(INCLUDE)/no_os_error.h \
+	$(INCLUDE)/no_os_fifo.h \
+	$(INCLUDE)/no_os_gpio.h \
+	$(INCLUDE)/no_os_i2c.h \
+	$(INCLUDE)/no_os_irq.h \
+	$(INCLUDE)/no_os_lffifo.h \
+	$(INCLUDE)/no_os_list.h \
+	$(INCLUDE)/no_os_spi.h \
+	$(INCLUDE)/no_os_uart.h \
+	$(INCLUDE)/no_os_unpack.h \
+	$(INCLUDE)/no_os_util.h
@@ -0,0 +1,175 @@
+/***************************************************************************//**
+ *   @file   bench.c
+ *   @brief  Host benchmark harness of the benchmarks project.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <inttypes.h>
+#include "no_os_error.h"
+#include "bench.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Get a monotonic timestamp.
+ * @return the time in nanoseconds.
+ */
+static uint64_t bench_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * @brief Time iters operations of a case.
+ * @param bc - The case.
+ * @param ctx - State of the case.
+ * @param iters - Number of operations.
+ * @param ns - Where to store the duration.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bench_time(const struct bench_case *bc, void *ctx,
+			  uint32_t iters, uint64_t *ns)
+{
+	uint64_t start;
+	int32_t ret;
+
+	start = bench_now_ns();
+	ret = bc->run(ctx, iters);
+	*ns = bench_now_ns() - start;
+
+	return ret;
+}
+
+/**
+ * @brief Measure a case and print its JSON result. The number of iterations
+ * is doubled until a run takes BENCH_MIN_RUN_NS, then the fastest of
+ * BENCH_RUNS runs is kept.
+ * @param bc - The case.
+ * @param first - Whether this is the first result of the array.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bench_run_case(const struct bench_case *bc, bool first)
+{
+	uint64_t ns, best = UINT64_MAX;
+	uint32_t iters = 1;
+	void *ctx = NULL;
+	double ns_per_op;
+	int32_t ret;
+	int i;
+
+	if (bc->setup) {
+		ret = bc->setup(&ctx);
+		if (ret)
+			return ret;
+	}
+
+	do {
+		ret = bench_time(bc, ctx, iters, &ns);
+		if (ret)
+			goto out;
+		if (ns >= BENCH_MIN_RUN_NS)
+			break;
+		iters *= 2;
+	} while (iters < UINT32_MAX / 2);
+
+	for (i = 0; i < BENCH_RUNS; i++) {
+		ret = bench_time(bc, ctx, iters, &ns);
+		if (ret)
+			goto out;
+		if (ns < best)
+			best = ns;
+	}
+
+	ns_per_op = (double)best / iters;
+	printf("%s\n    {\"name\": \"%s\", \"iterations\": %"PRIu32
+	       ", \"ns_per_op\": %.2f", first ? "" : ",", bc->name, iters,
+	       ns_per_op);
+	if (bc->bytes_per_op)
+		printf(", \"mb_per_s\": %.2f",
+		       bc->bytes_per_op * 1000.0 / ns_per_op);
+	printf("}");
+out:
+	if (bc->teardown)
+		bc->teardown(ctx);
+
+	return ret;
+}
+
+/**
+ * @brief Run the cases whose name contains filter and print the results as a
+ * JSON object. A failing case is reported on stderr and skipped.
+ * @param cases - Array of cases.
+ * @param nb_cases - Number of cases.
+ * @param filter - Substring of the names to run, NULL runs all.
+ * @return 0 if all the cases passed, the error of the last failing one
+ * otherwise.
+ */
+int32_t bench_run_all(const struct bench_case *cases, uint32_t nb_cases,
+		      const char *filter)
+{
+	static bool first = true;
+	int32_t ret = 0, err;
+	uint32_t i;
+
+	for (i = 0; i < nb_cases; i++) {
+		if (filter && !strstr(cases[i].name, filter))
+			continue;
+
+		err = bench_run_case(&cases[i], first);
+		if (err) {
+			fprintf(stderr, "%s failed: %"PRIi32"\n", cases[i].name,
+				err);
+			ret = err;
+			continue;
+		}
+		first = false;
+	}
+
+	return ret;
+}
@@ -0,0 +1,94 @@
+/***************************************************************************//**
+ *   @file   bench.h
+ *   @brief  Host benchmark harness of the benchmarks project.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Minimum duration of a measured run, iterations are scaled up to reach it */
+#define BENCH_MIN_RUN_NS	100000000ULL
+/* Runs of each case, the fastest one is reported */
+#define BENCH_RUNS		5
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct bench_case
+ * @brief A microbenchmark. run() does iters operations on the state prepared
+ * by setup(), the time of setup() and teardown() is not measured.
+ */
+struct bench_case {
+	/** Name, stable between versions so results can be compared */
+	const char *name;
+	/** Bytes processed by one operation, 0 if not relevant */
+	uint32_t bytes_per_op;
+	/** Prepare the state of the case, optional */
+	int32_t (*setup)(void **ctx);
+	/** Do iters operations, returns negative error code on failure */
+	int32_t (*run)(void *ctx, uint32_t iters);
+	/** Free the state of the case, optional */
+	void (*teardown)(void *ctx);
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Run the cases whose name contains filter, all if NULL, printing JSON. */
+int32_t bench_run_all(const struct bench_case *cases, uint32_t nb_cases,
+		      const char *filter);
+
+/* Cases of the no-OS utilities and of the SPI/I2C APIs. */
+extern const struct bench_case bench_util_cases[];
+extern const uint32_t bench_util_nb_cases;
+
+/* Cases of the IIO server. */
+extern const struct bench_case bench_iio_cases[];
+extern const uint32_t bench_iio_nb_cases;
+
+#endif // _BENCH_H_
@@ -0,0 +1,482 @@
+/***************************************************************************//**
+ *   @file   bench_iio.c
+ *   @brief  Benchmarks of the IIO server.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include "no_os_error.h"
+#include "no_os_alloc.h"
+#include "no_os_util.h"
+#include "no_os_uart.h"
+#include "iio.h"
+#include "iio_types.h"
+#include "iiod.h"
+#include "iiod_private.h"
+#include "bench.h"
+#include "bench_mock.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Devices of the context, the commands address the last one */
+#define BENCH_IIO_NB_DEVS	16
+#define BENCH_IIO_NB_CH		4
+#define BENCH_IIO_CMD		"READ iio:device15 INPUT voltage3 raw\n"
+#define BENCH_IIO_RESPONSE	"4\n1234\n"
+/* Steps after which a command without response is a failure */
+#define BENCH_IIO_MAX_STEPS	64
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/* State of the iio server cases */
+struct bench_iio {
+	struct bench_mock_uart uart;
+	struct no_os_uart_desc *uart_desc;
+	struct iio_device_init devs[BENCH_IIO_NB_DEVS];
+	char names[BENCH_IIO_NB_DEVS][8];
+	struct iio_desc *iio;
+};
+
+/* State of the value formatting cases */
+struct bench_fmt {
+	char buf[64];
+	/* Keeps the results alive */
+	volatile int32_t sink;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+static int bench_iio_raw_show(void *device, char *buf, uint32_t len,
+			      const struct iio_ch_info *channel,
+			      intptr_t priv);
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+static struct scan_type bench_iio_scan_type = {
+	.sign = 's',
+	.realbits = 16,
+	.storagebits = 16,
+};
+
+static struct iio_attribute bench_iio_ch_attrs[] = {
+	{
+		.name = "raw",
+		.show = bench_iio_raw_show,
+	},
+	{
+		.name = "scale",
+		.shared = IIO_SHARED_BY_TYPE,
+		.show = bench_iio_raw_show,
+	},
+	END_ATTRIBUTES_ARRAY
+};
+
+static struct iio_attribute bench_iio_dev_attrs[] = {
+	{
+		.name = "sampling_frequency",
+		.show = bench_iio_raw_show,
+	},
+	END_ATTRIBUTES_ARRAY
+};
+
+#define BENCH_IIO_CH(_idx) {				\
+	.name = "voltage" #_idx,			\
+	.ch_type = IIO_VOLTAGE,				\
+	.channel = _idx,				\
+	.scan_index = _idx,				\
+	.scan_type = &bench_iio_scan_type,		\
+	.attributes = bench_iio_ch_attrs,		\
+	.indexed = true,				\
+}
+
+static struct iio_channel bench_iio_channels[BENCH_IIO_NB_CH] = {
+	BENCH_IIO_CH(0),
+	BENCH_IIO_CH(1),
+	BENCH_IIO_CH(2),
+	BENCH_IIO_CH(3),
+};
+
+static struct iio_device bench_iio_device = {
+	.num_ch = BENCH_IIO_NB_CH,
+	.channels = bench_iio_channels,
+	.attributes = bench_iio_dev_attrs,
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Show a constant attribute value.
+ * @param device - Unused.
+ * @param buf - Where to store the value.
+ * @param len - Size of buf.
+ * @param channel - Unused.
+ * @param priv - Unused.
+ * @return length of the value, negative error code otherwise.
+ */
+static int bench_iio_raw_show(void *device, char *buf, uint32_t len,
+			      const struct iio_ch_info *channel,
+			      intptr_t priv)
+{
+	int32_t val = 1234;
+
+	return iio_format_value(buf, len, IIO_VAL_INT, 1, &val);
+}
+
+/**
+ * @brief Allocate the state of the IIO cases, with the UART mock and the
+ * device descriptions. The IIO server is not initialized.
+ * @param ctx - Where to store the state.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bench_iio_alloc(void **ctx)
+{
+	struct no_os_uart_init_param uart_ip = {
+		.platform_ops = &bench_mock_uart_ops,
+	};
+	struct bench_iio *b;
+	uint32_t i;
+	int32_t ret;
+
+	b = no_os_calloc(1, sizeof(*b));
+	if (!b)
+		return -ENOMEM;
+
+	uart_ip.extra = &b->uart;
+	ret = no_os_uart_init(&b->uart_desc, &uart_ip);
+	if (ret) {
+		no_os_free(b);
+		return ret;
+	}
+
+	for (i = 0; i < BENCH_IIO_NB_DEVS; i++) {
+		snprintf(b->names[i], sizeof(b->names[i]), "dev%"PRIu32, i);
+		b->devs[i].name = b->names[i];
+		b->devs[i].dev = b;
+		b->devs[i].dev_descriptor = &bench_iio_device;
+	}
+	*ctx = b;
+
+	return 0;
+}
+
+/**
+ * @brief Initialize the IIO server on the UART mock.
+ * @param b - The state.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bench_iio_server_init(struct bench_iio *b)
+{
+	struct iio_init_param ip = {
+		.phy_type = USE_UART,
+		.uart_desc = b->uart_desc,
+		.devs = b->devs,
+		.nb_devs = BENCH_IIO_NB_DEVS,
+	};
+
+	return iio_init(&b->iio, &ip);
+}
+
+/**
+ * @brief Send a command and step the server until its response is written.
+ * @param b - The state.
+ * @param cmd - The command line.
+ * @return 0 in case of success, -ETIMEDOUT if the response is not complete.
+ */
+static int32_t bench_iio_cmd(struct bench_iio *b, const char *cmd)
+{
+	uint32_t i, j, nl = 0;
+
+	bench_mock_uart_feed(&b->uart, cmd);
+	b->uart.tx_len = 0;
+
+	/* The response of READ is the length and the value, each on a line */
+	for (i = 0; i < BENCH_IIO_MAX_STEPS; i++) {
+		j = b->uart.tx_len;
+		iio_step(b->iio);
+		for (; j < b->uart.tx_len; j++)
+			if (b->uart.tx[j] == '\n')
+				nl++;
+		if (nl == 2)
+			return 0;
+	}
+
+	return -ETIMEDOUT;
+}
+
+/**
+ * @brief Free the state of the IIO cases.
+ * @param ctx - The state.
+ */
+static void bench_iio_teardown(void *ctx)
+{
+	struct bench_iio *b = ctx;
+
+	if (b->iio)
+		iio_remove(b->iio);
+	no_os_uart_remove(b->uart_desc);
+	no_os_free(b);
+}
+
+/**
+ * @brief Initialize the IIO server and check the response to the command.
+ * @param ctx - Where to store the state.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bench_iio_cmd_setup(void **ctx)
+{
+	struct bench_iio *b;
+	int32_t ret;
+
+	ret = bench_iio_alloc(ctx);
+	if (ret)
+		return ret;
+
+	b = *ctx;
+	ret = bench_iio_server_init(b);
+	if (ret)
+		goto err;
+
+	ret = bench_iio_cmd(b, BENCH_IIO_CMD);
+	if (ret)
+		goto err;
+
+	if (b->uart.tx_len != strlen(BENCH_IIO_RESPONSE) ||
+	    memcmp(b->uart.tx, BENCH_IIO_RESPONSE, b->uart.tx_len)) {
+		ret = -EBADMSG;
+		goto err;
+	}
+
+	return 0;
+err:
+	bench_iio_teardown(b);
+
+	return ret;
+}
+
+/**
+ * @brief Read a channel attribute of the last device through the server.
+ * @param ctx - The state.
+ * @param iters - Number of commands.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bench_iio_cmd_run(void *ctx, uint32_t iters)
+{
+	int32_t ret;
+
+	while (iters--) {
+		ret = bench_iio_cmd(ctx, BENCH_IIO_CMD);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Initialize and remove the IIO server, mostly the context xml
+ * generation.
+ * @param ctx - The state.
+ * @param iters - Number of initializations.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bench_iio_init_run(void *ctx, uint32_t iters)
+{
+	struct bench_iio *b = ctx;
+	int32_t ret;
+
+	while (iters--) {
+		ret = bench_iio_server_init(b);
+		if (ret)
+			return ret;
+
+		ret = iio_remove(b->iio);
+		b->iio = NULL;
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Parse a command line. The line is copied first, as parsing
+ * modifies it.
+ * @param ctx - Unused.
+ * @param iters - Number of lines.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bench_parse_line_run(void *ctx, uint32_t iters)
+{
+	char line[sizeof(BENCH_IIO_CMD)];
+	struct comand_desc cmd;
+	char *strtok_ctx;
+	int32_t ret;
+
+	while (iters--) {
+		memcpy(line, BENCH_IIO_CMD, sizeof(line));
+		ret = iiod_parse_line(line, &cmd, &strtok_ctx);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Allocate the state of the value formatting cases.
+ * @param ctx - Where to store the state.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bench_fmt_setup(void **ctx)
+{
+	*ctx = no_os_calloc(1, sizeof(struct bench_fmt));
+	if (!*ctx)
+		return -ENOMEM;
+
+	return 0;
+}
+
+static int32_t bench_fmt_int_run(void *ctx, uint32_t iters)
+{
+	struct bench_fmt *f = ctx;
+	int32_t val = -123456;
+
+	while (iters--)
+		f->sink = iio_format_value(f->buf, sizeof(f->buf),
+					   IIO_VAL_INT, 1, &val);
+
+	return 0;
+}
+
+static int32_t bench_fmt_micro_run(void *ctx, uint32_t iters)
+{
+	struct bench_fmt *f = ctx;
+	int32_t vals[2] = {12, 345678};
+
+	while (iters--)
+		f->sink = iio_format_value(f->buf, sizeof(f->buf),
+					   IIO_VAL_INT_PLUS_MICRO, 2, vals);
+
+	return 0;
+}
+
+static int32_t bench_fmt_fractional_run(void *ctx, uint32_t iters)
+{
+	struct bench_fmt *f = ctx;
+	int32_t vals[2] = {2500, 65536};
+
+	while (iters--)
+		f->sink = iio_format_value(f->buf, sizeof(f->buf),
+					   IIO_VAL_FRACTIONAL, 2, vals);
+
+	return 0;
+}
+
+static int32_t bench_parse_value_run(void *ctx, uint32_t iters)
+{
+	struct bench_fmt *f = ctx;
+	int32_t val, val2;
+	int32_t ret;
+
+	/* The value is copied each time, as parsing modifies it */
+	while (iters--) {
+		strcpy(f->buf, "-12.345678");
+		ret = iio_parse_value(f->buf, IIO_VAL_INT_PLUS_MICRO, &val,
+				      &val2);
+		if (ret < 0)
+			return ret;
+		f->sink = val + val2;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Free the state of the value formatting cases.
+ * @param ctx - The state.
+ */
+static void bench_fmt_teardown(void *ctx)
+{
+	no_os_free(ctx);
+}
+
+const struct bench_case bench_iio_cases[] = {
+	{
+		"iio_format_int", 0,
+		bench_fmt_setup, bench_fmt_int_run, bench_fmt_teardown
+	},
+	{
+		"iio_format_int_plus_micro", 0,
+		bench_fmt_setup, bench_fmt_micro_run, bench_fmt_teardown
+	},
+	{
+		"iio_format_fractional", 0,
+		bench_fmt_setup, bench_fmt_fractional_run, bench_fmt_teardown
+	},
+	{
+		"iio_parse_int_plus_micro", 0,
+		bench_fmt_setup, bench_parse_value_run, bench_fmt_teardown
+	},
+	{
+		"iiod_parse_line_read", sizeof(BENCH_IIO_CMD) - 1,
+		NULL, bench_parse_line_run, NULL
+	},
+	{
+		"iio_read_attr_16_devs", 0,
+		bench_iio_cmd_setup, bench_iio_cmd_run, bench_iio_teardown
+	},
+	{
+		"iio_init_remove_16_devs", 0,
+		bench_iio_alloc, bench_iio_init_run, bench_iio_teardown
+	},
+};
+
+const uint32_t bench_iio_nb_cases = NO_OS_ARRAY_SIZE(bench_iio_cases);
@@ -0,0 +1,311 @@
+/***************************************************************************//**
+ *   @file   bench_mock.c
+ *   @brief  Mock SPI, I2C and UART backends of the benchmarks project.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <string.h>
+#include "no_os_error.h"
+#include "no_os_alloc.h"
+#include "bench_mock.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Initialize the SPI mock.
+ * @param desc - Where to store the SPI descriptor.
+ * @param param - Initialization parameters, extra is a bench_mock_regs.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bench_mock_spi_init(struct no_os_spi_desc **desc,
+				   const struct no_os_spi_init_param *param)
+{
+	struct no_os_spi_desc *d;
+
+	if (!param->extra)
+		return -EINVAL;
+
+	d = no_os_calloc(1, sizeof(*d));
+	if (!d)
+		return -ENOMEM;
+
+	d->extra = param->extra;
+	*desc = d;
+
+	return 0;
+}
+
+/**
+ * @brief Transfer with the emulated register file.
+ * @param desc - The SPI descriptor.
+ * @param data - Address byte followed by the register data, replaced by the
+ * register values for a read.
+ * @param bytes_number - Number of bytes of data.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bench_mock_spi_write_and_read(struct no_os_spi_desc *desc,
+		uint8_t *data, uint16_t bytes_number)
+{
+	struct bench_mock_regs *regs = desc->extra;
+	uint8_t addr;
+	uint16_t i;
+
+	if (!bytes_number)
+		return -EINVAL;
+
+	addr = data[0] & ~BENCH_MOCK_SPI_READ;
+	for (i = 1; i < bytes_number; i++, addr++) {
+		if (data[0] & BENCH_MOCK_SPI_READ)
+			data[i] = regs->regs[addr];
+		else
+			regs->regs[addr] = data[i];
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Free the SPI mock.
+ * @param desc - The SPI descriptor.
+ * @return 0
+ */
+static int32_t bench_mock_spi_remove(struct no_os_spi_desc *desc)
+{
+	no_os_free(desc);
+
+	return 0;
+}
+
+/**
+ * @brief Initialize the I2C mock.
+ * @param desc - Where to store the I2C descriptor.
+ * @param param - Initialization parameters, extra is a bench_mock_regs.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bench_mock_i2c_init(struct no_os_i2c_desc **desc,
+				   const struct no_os_i2c_init_param *param)
+{
+	struct no_os_i2c_desc *d;
+
+	if (!param->extra)
+		return -EINVAL;
+
+	d = no_os_calloc(1, sizeof(*d));
+	if (!d)
+		return -ENOMEM;
+
+	d->slave_address = param->slave_address;
+	d->extra = param->extra;
+	*desc = d;
+
+	return 0;
+}
+
+/**
+ * @brief Write the register address, followed by register data if any.
+ * @param desc - The I2C descriptor.
+ * @param data - Address byte followed by the register data.
+ * @param bytes_number - Number of bytes of data.
+ * @param stop_bit - Unused.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bench_mock_i2c_write(struct no_os_i2c_desc *desc,
+				    uint8_t *data, uint8_t bytes_number,
+				    uint8_t stop_bit)
+{
+	struct bench_mock_regs *regs = desc->extra;
+	uint8_t i;
+
+	if (!bytes_number)
+		return -EINVAL;
+
+	regs->addr = data[0];
+	for (i = 1; i < bytes_number; i++)
+		regs->regs[regs->addr++] = data[i];
+
+	return 0;
+}
+
+/**
+ * @brief Read the registers from the last written address.
+ * @param desc - The I2C descriptor.
+ * @param data - Where to store the register values.
+ * @param bytes_number - Number of bytes to read.
+ * @param stop_bit - Unused.
+ * @return 0
+ */
+static int32_t bench_mock_i2c_read(struct no_os_i2c_desc *desc,
+				   uint8_t *data, uint8_t bytes_number,
+				   uint8_t stop_bit)
+{
+	struct bench_mock_regs *regs = desc->extra;
+	uint8_t i;
+
+	for (i = 0; i < bytes_number; i++)
+		data[i] = regs->regs[regs->addr++];
+
+	return 0;
+}
+
+/**
+ * @brief Free the I2C mock.
+ * @param desc - The I2C descriptor.
+ * @return 0
+ */
+static int32_t bench_mock_i2c_remove(struct no_os_i2c_desc *desc)
+{
+	no_os_free(desc);
+
+	return 0;
+}
+
+/**
+ * @brief Make the next UART reads return line.
+ * @param uart - The UART mock.
+ * @param line - Data to be read, must stay valid until read.
+ */
+void bench_mock_uart_feed(struct bench_mock_uart *uart, const char *line)
+{
+	uart->rx = line;
+	uart->rx_len = strlen(line);
+	uart->rx_idx = 0;
+}
+
+/**
+ * @brief Initialize the UART mock.
+ * @param desc - Where to store the UART descriptor.
+ * @param param - Initialization parameters, extra is a bench_mock_uart.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bench_mock_uart_init(struct no_os_uart_desc **desc,
+				    struct no_os_uart_init_param *param)
+{
+	struct no_os_uart_desc *d;
+
+	if (!param->extra)
+		return -EINVAL;
+
+	d = no_os_calloc(1, sizeof(*d));
+	if (!d)
+		return -ENOMEM;
+
+	d->extra = param->extra;
+	*desc = d;
+
+	return 0;
+}
+
+/**
+ * @brief Read the fed data.
+ * @param desc - The UART descriptor.
+ * @param data - Where to store the data.
+ * @param bytes_number - Maximum number of bytes.
+ * @return number of bytes read, 0 once the fed data is consumed.
+ */
+static int32_t bench_mock_uart_read(struct no_os_uart_desc *desc,
+				    uint8_t *data, uint32_t bytes_number)
+{
+	struct bench_mock_uart *uart = desc->extra;
+	uint32_t len = uart->rx_len - uart->rx_idx;
+
+	if (len > bytes_number)
+		len = bytes_number;
+	memcpy(data, uart->rx + uart->rx_idx, len);
+	uart->rx_idx += len;
+
+	return len;
+}
+
+/**
+ * @brief Store the written data.
+ * @param desc - The UART descriptor.
+ * @param data - The data.
+ * @param bytes_number - Number of bytes.
+ * @return number of bytes written.
+ */
+static int32_t bench_mock_uart_write(struct no_os_uart_desc *desc,
+				     const uint8_t *data,
+				     uint32_t bytes_number)
+{
+	struct bench_mock_uart *uart = desc->extra;
+	uint32_t len = bytes_number;
+
+	if (len > BENCH_MOCK_UART_TX_SIZE)
+		len = BENCH_MOCK_UART_TX_SIZE;
+	if (uart->tx_len + len > BENCH_MOCK_UART_TX_SIZE)
+		uart->tx_len = 0;
+	memcpy(uart->tx + uart->tx_len, data, len);
+	uart->tx_len += len;
+
+	return bytes_number;
+}
+
+/**
+ * @brief Free the UART mock.
+ * @param desc - The UART descriptor.
+ * @return 0
+ */
+static int32_t bench_mock_uart_remove(struct no_os_uart_desc *desc)
+{
+	no_os_free(desc);
+
+	return 0;
+}
+
+const struct no_os_spi_platform_ops bench_mock_spi_ops = {
+	.init = bench_mock_spi_init,
+	.write_and_read = bench_mock_spi_write_and_read,
+	.remove = bench_mock_spi_remove
+};
+
+const struct no_os_i2c_platform_ops bench_mock_i2c_ops = {
+	.i2c_ops_init = bench_mock_i2c_init,
+	.i2c_ops_write = bench_mock_i2c_write,
+	.i2c_ops_read = bench_mock_i2c_read,
+	.i2c_ops_remove = bench_mock_i2c_remove
+};
+
+const struct no_os_uart_platform_ops bench_mock_uart_ops = {
+	.init = bench_mock_uart_init,
+	.read = bench_mock_uart_read,
+	.write = bench_mock_uart_write,
+	.remove = bench_mock_uart_remove
+};
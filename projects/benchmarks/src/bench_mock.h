@@ -0,0 +1,108 @@
+/***************************************************************************//**
+ *   @file   bench_mock.h
+ *   @brief  Mock SPI, I2C and UART backends of the benchmarks project.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef _BENCH_MOCK_H_
+#define _BENCH_MOCK_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include "no_os_spi.h"
+#include "no_os_i2c.h"
+#include "no_os_uart.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Bit of the first SPI byte selecting a register read */
+#define BENCH_MOCK_SPI_READ	0x80
+#define BENCH_MOCK_NB_REGS	256
+#define BENCH_MOCK_UART_TX_SIZE	4096
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct bench_mock_regs
+ * @brief Register file emulated by the SPI and I2C mocks. The first byte of a
+ * transfer is the register address, the next ones the data of the
+ * consecutive registers.
+ */
+struct bench_mock_regs {
+	/** Register values */
+	uint8_t regs[BENCH_MOCK_NB_REGS];
+	/** Register addressed by the last I2C write */
+	uint8_t addr;
+};
+
+/**
+ * @struct bench_mock_uart
+ * @brief Loopback of the UART mock. Reads return the bytes of rx, writes are
+ * stored in tx.
+ */
+struct bench_mock_uart {
+	/** Data returned by the reads */
+	const char *rx;
+	/** Length of rx */
+	uint32_t rx_len;
+	/** Bytes of rx already read */
+	uint32_t rx_idx;
+	/** Written data, wrapping to the start when full */
+	uint8_t tx[BENCH_MOCK_UART_TX_SIZE];
+	/** Bytes written to tx */
+	uint32_t tx_len;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Make the next UART reads return line. */
+void bench_mock_uart_feed(struct bench_mock_uart *uart, const char *line);
+
+/* SPI platform ops serving a bench_mock_regs passed as extra. */
+extern const struct no_os_spi_platform_ops bench_mock_spi_ops;
+/* I2C platform ops serving a bench_mock_regs passed as extra. */
+extern const struct no_os_i2c_platform_ops bench_mock_i2c_ops;
+/* UART platform ops serving a bench_mock_uart passed as extra. */
+extern const struct no_os_uart_platform_ops bench_mock_uart_ops;
+
+#endif // _BENCH_MOCK_H_
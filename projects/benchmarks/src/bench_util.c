@@ -0,0 +1,516 @@
+/***************************************************************************//**
+ *   @file   bench_util.c
+ *   @brief  Benchmarks of the no-OS utilities and of the SPI/I2C APIs.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <string.h>
+#include "no_os_error.h"
+#include "no_os_alloc.h"
+#include "no_os_util.h"
+#include "no_os_circular_buffer.h"
+#include "no_os_crc8.h"
+#include "no_os_crc16.h"
+#include "no_os_crc24.h"
+#include "no_os_unpack.h"
+#include "bench.h"
+#include "bench_mock.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define BENCH_CB_SIZE		4096
+#define BENCH_CB_CHUNK		256
+#define BENCH_CRC_LEN		1024
+#define BENCH_UNPACK_SAMPLES	1024
+/* Register transfer of the SPI and I2C cases: address and 4 data bytes */
+#define BENCH_XFER_LEN		5
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/* State of the CRC cases */
+struct bench_crc {
+	uint8_t data[BENCH_CRC_LEN];
+	uint8_t crc8[NO_OS_CRC8_TABLE_SIZE];
+	uint16_t crc16[NO_OS_CRC16_TABLE_SIZE];
+	uint32_t crc24[NO_OS_CRC24_TABLE_SIZE];
+	uint8_t crc8_slice[NO_OS_CRC_SLICES][NO_OS_CRC8_TABLE_SIZE];
+	uint16_t crc16_slice[NO_OS_CRC_SLICES][NO_OS_CRC16_TABLE_SIZE];
+	uint32_t crc24_slice[NO_OS_CRC_SLICES][NO_OS_CRC24_TABLE_SIZE];
+	/* Keeps the results alive */
+	volatile uint32_t sink;
+};
+
+/* State of the circular buffer cases */
+struct bench_cb {
+	struct no_os_circular_buffer *cb;
+	uint8_t chunk[BENCH_CB_CHUNK];
+};
+
+/* State of the unpack cases */
+struct bench_unpack {
+	uint8_t src[BENCH_UNPACK_SAMPLES * 4];
+	int32_t dst[BENCH_UNPACK_SAMPLES];
+};
+
+/* State of the SPI and I2C cases */
+struct bench_bus {
+	struct bench_mock_regs regs;
+	struct no_os_spi_desc *spi;
+	struct no_os_i2c_desc *i2c;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Allocate a 4 KB circular buffer.
+ * @param ctx - Where to store the state.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bench_cb_setup(void **ctx)
+{
+	struct bench_cb *b;
+	int32_t ret;
+
+	b = no_os_calloc(1, sizeof(*b));
+	if (!b)
+		return -ENOMEM;
+
+	ret = no_os_cb_init(&b->cb, BENCH_CB_SIZE);
+	if (ret) {
+		no_os_free(b);
+		return ret;
+	}
+	memset(b->chunk, 0x5a, sizeof(b->chunk));
+	*ctx = b;
+
+	return 0;
+}
+
+/**
+ * @brief Free the circular buffer.
+ * @param ctx - The state.
+ */
+static void bench_cb_teardown(void *ctx)
+{
+	struct bench_cb *b = ctx;
+
+	no_os_cb_remove(b->cb);
+	no_os_free(b);
+}
+
+/**
+ * @brief Write and read back a chunk with copies.
+ * @param ctx - The state.
+ * @param iters - Number of chunks.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bench_cb_copy_run(void *ctx, uint32_t iters)
+{
+	struct bench_cb *b = ctx;
+	int32_t ret;
+
+	while (iters--) {
+		ret = no_os_cb_write(b->cb, b->chunk, BENCH_CB_CHUNK);
+		if (ret)
+			return ret;
+		ret = no_os_cb_read(b->cb, b->chunk, BENCH_CB_CHUNK);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Write and read back a chunk in place, with peek and commit.
+ * @param ctx - The state.
+ * @param iters - Number of chunks.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bench_cb_peek_run(void *ctx, uint32_t iters)
+{
+	struct no_os_cb_regions regions;
+	struct bench_cb *b = ctx;
+	int32_t ret;
+
+	while (iters--) {
+		ret = no_os_cb_peek_write(b->cb, BENCH_CB_CHUNK, &regions);
+		if (ret)
+			return ret;
+		memset(regions.buf[0], 0x5a, regions.len[0]);
+		memset(regions.buf[1], 0x5a, regions.len[1]);
+		ret = no_os_cb_commit_write(b->cb, BENCH_CB_CHUNK);
+		if (ret)
+			return ret;
+
+		ret = no_os_cb_peek_read(b->cb, BENCH_CB_CHUNK, &regions);
+		if (ret)
+			return ret;
+		ret = no_os_cb_commit_read(b->cb, BENCH_CB_CHUNK);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Prepare the CRC tables and the data.
+ * @param ctx - Where to store the state.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bench_crc_setup(void **ctx)
+{
+	struct bench_crc *c;
+	uint32_t i;
+
+	c = no_os_calloc(1, sizeof(*c));
+	if (!c)
+		return -ENOMEM;
+
+	for (i = 0; i < BENCH_CRC_LEN; i++)
+		c->data[i] = i * 31 + 7;
+
+	no_os_crc8_populate_msb(c->crc8, 0x07);
+	no_os_crc16_populate_msb(c->crc16, 0x1021);
+	no_os_crc24_populate_msb(c->crc24, 0x864cfb);
+	no_os_crc8_populate_slice_msb(c->crc8_slice, 0x07);
+	no_os_crc16_populate_slice_msb(c->crc16_slice, 0x1021);
+	no_os_crc24_populate_slice_msb(c->crc24_slice, 0x864cfb);
+	*ctx = c;
+
+	return 0;
+}
+
+/**
+ * @brief Free the CRC state.
+ * @param ctx - The state.
+ */
+static void bench_free_teardown(void *ctx)
+{
+	no_os_free(ctx);
+}
+
+static int32_t bench_crc8_run(void *ctx, uint32_t iters)
+{
+	struct bench_crc *c = ctx;
+
+	while (iters--)
+		c->sink = no_os_crc8(c->crc8, c->data, BENCH_CRC_LEN, 0);
+
+	return 0;
+}
+
+static int32_t bench_crc8_slice8_run(void *ctx, uint32_t iters)
+{
+	struct bench_crc *c = ctx;
+
+	while (iters--)
+		c->sink = no_os_crc8_slice8(c->crc8_slice, c->data,
+					    BENCH_CRC_LEN, 0);
+
+	return 0;
+}
+
+static int32_t bench_crc16_run(void *ctx, uint32_t iters)
+{
+	struct bench_crc *c = ctx;
+
+	while (iters--)
+		c->sink = no_os_crc16(c->crc16, c->data, BENCH_CRC_LEN, 0);
+
+	return 0;
+}
+
+static int32_t bench_crc16_slice8_run(void *ctx, uint32_t iters)
+{
+	struct bench_crc *c = ctx;
+
+	while (iters--)
+		c->sink = no_os_crc16_slice8(c->crc16_slice, c->data,
+					     BENCH_CRC_LEN, 0);
+
+	return 0;
+}
+
+static int32_t bench_crc24_run(void *ctx, uint32_t iters)
+{
+	struct bench_crc *c = ctx;
+
+	while (iters--)
+		c->sink = no_os_crc24(c->crc24, c->data, BENCH_CRC_LEN, 0);
+
+	return 0;
+}
+
+static int32_t bench_crc24_slice8_run(void *ctx, uint32_t iters)
+{
+	struct bench_crc *c = ctx;
+
+	while (iters--)
+		c->sink = no_os_crc24_slice8(c->crc24_slice, c->data,
+					     BENCH_CRC_LEN, 0);
+
+	return 0;
+}
+
+/**
+ * @brief Prepare the packed samples.
+ * @param ctx - Where to store the state.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bench_unpack_setup(void **ctx)
+{
+	struct bench_unpack *u;
+	uint32_t i;
+
+	u = no_os_calloc(1, sizeof(*u));
+	if (!u)
+		return -ENOMEM;
+
+	for (i = 0; i < sizeof(u->src); i++)
+		u->src[i] = i * 13 + 1;
+	*ctx = u;
+
+	return 0;
+}
+
+static int32_t bench_unpack12_run(void *ctx, uint32_t iters)
+{
+	struct bench_unpack *u = ctx;
+	int32_t ret;
+
+	while (iters--) {
+		ret = no_os_unpack_be(u->src, BENCH_UNPACK_SAMPLES, 12, true,
+				      u->dst);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+static int32_t bench_unpack14_run(void *ctx, uint32_t iters)
+{
+	struct bench_unpack *u = ctx;
+	int32_t ret;
+
+	while (iters--) {
+		ret = no_os_unpack_be(u->src, BENCH_UNPACK_SAMPLES, 14, true,
+				      u->dst);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Initialize the SPI and I2C APIs on the register file mock.
+ * @param ctx - Where to store the state.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bench_bus_setup(void **ctx)
+{
+	struct no_os_spi_init_param spi_ip = {
+		.platform_ops = &bench_mock_spi_ops,
+	};
+	struct no_os_i2c_init_param i2c_ip = {
+		.slave_address = 0x48,
+		.platform_ops = &bench_mock_i2c_ops,
+	};
+	struct bench_bus *b;
+	int32_t ret;
+
+	b = no_os_calloc(1, sizeof(*b));
+	if (!b)
+		return -ENOMEM;
+
+	spi_ip.extra = &b->regs;
+	i2c_ip.extra = &b->regs;
+
+	ret = no_os_spi_init(&b->spi, &spi_ip);
+	if (ret)
+		goto free_b;
+
+	ret = no_os_i2c_init(&b->i2c, &i2c_ip);
+	if (ret)
+		goto free_spi;
+
+	*ctx = b;
+
+	return 0;
+
+free_spi:
+	no_os_spi_remove(b->spi);
+free_b:
+	no_os_free(b);
+
+	return ret;
+}
+
+/**
+ * @brief Free the SPI and I2C descriptors.
+ * @param ctx - The state.
+ */
+static void bench_bus_teardown(void *ctx)
+{
+	struct bench_bus *b = ctx;
+
+	no_os_i2c_remove(b->i2c);
+	no_os_spi_remove(b->spi);
+	no_os_free(b);
+}
+
+/**
+ * @brief Write then read back 4 registers over SPI.
+ * @param ctx - The state.
+ * @param iters - Number of write and read pairs.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bench_spi_run(void *ctx, uint32_t iters)
+{
+	uint8_t buf[BENCH_XFER_LEN];
+	struct bench_bus *b = ctx;
+	int32_t ret;
+
+	while (iters--) {
+		buf[0] = 0x10;
+		memset(&buf[1], iters, BENCH_XFER_LEN - 1);
+		ret = no_os_spi_write_and_read(b->spi, buf, BENCH_XFER_LEN);
+		if (ret)
+			return ret;
+
+		buf[0] = 0x10 | BENCH_MOCK_SPI_READ;
+		ret = no_os_spi_write_and_read(b->spi, buf, BENCH_XFER_LEN);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Write then read back 4 registers over I2C.
+ * @param ctx - The state.
+ * @param iters - Number of write and read pairs.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bench_i2c_run(void *ctx, uint32_t iters)
+{
+	uint8_t buf[BENCH_XFER_LEN];
+	struct bench_bus *b = ctx;
+	int32_t ret;
+
+	while (iters--) {
+		buf[0] = 0x10;
+		memset(&buf[1], iters, BENCH_XFER_LEN - 1);
+		ret = no_os_i2c_write(b->i2c, buf, BENCH_XFER_LEN, 1);
+		if (ret)
+			return ret;
+
+		ret = no_os_i2c_write(b->i2c, buf, 1, 0);
+		if (ret)
+			return ret;
+		ret = no_os_i2c_read(b->i2c, &buf[1], BENCH_XFER_LEN - 1, 1);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+const struct bench_case bench_util_cases[] = {
+	{
+		"cb_write_read_256", BENCH_CB_CHUNK,
+		bench_cb_setup, bench_cb_copy_run, bench_cb_teardown
+	},
+	{
+		"cb_peek_commit_256", BENCH_CB_CHUNK,
+		bench_cb_setup, bench_cb_peek_run, bench_cb_teardown
+	},
+	{
+		"crc8_table_1k", BENCH_CRC_LEN,
+		bench_crc_setup, bench_crc8_run, bench_free_teardown
+	},
+	{
+		"crc8_slice8_1k", BENCH_CRC_LEN,
+		bench_crc_setup, bench_crc8_slice8_run, bench_free_teardown
+	},
+	{
+		"crc16_table_1k", BENCH_CRC_LEN,
+		bench_crc_setup, bench_crc16_run, bench_free_teardown
+	},
+	{
+		"crc16_slice8_1k", BENCH_CRC_LEN,
+		bench_crc_setup, bench_crc16_slice8_run, bench_free_teardown
+	},
+	{
+		"crc24_table_1k", BENCH_CRC_LEN,
+		bench_crc_setup, bench_crc24_run, bench_free_teardown
+	},
+	{
+		"crc24_slice8_1k", BENCH_CRC_LEN,
+		bench_crc_setup, bench_crc24_slice8_run, bench_free_teardown
+	},
+	{
+		"unpack_be_12bit_1024", BENCH_UNPACK_SAMPLES * 12 / 8,
+		bench_unpack_setup, bench_unpack12_run, bench_free_teardown
+	},
+	{
+		"unpack_be_14bit_1024", BENCH_UNPACK_SAMPLES * 14 / 8,
+		bench_unpack_setup, bench_unpack14_run, bench_free_teardown
+	},
+	{
+		"spi_reg_write_read_4", 2 * (BENCH_XFER_LEN - 1),
+		bench_bus_setup, bench_spi_run, bench_bus_teardown
+	},
+	{
+		"i2c_reg_write_read_4", 2 * (BENCH_XFER_LEN - 1),
+		bench_bus_setup, bench_i2c_run, bench_bus_teardown
+	},
+};
+
+const uint32_t bench_util_nb_cases = NO_OS_ARRAY_SIZE(bench_util_cases);
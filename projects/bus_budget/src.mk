@@ -0,0 +1,36 @@
+SRCS += $(PROJECT)/src/main.c \
+	$(PROJECT)/src/budget.c \
+	$(PROJECT)/src/bus_rec.c \
+	$(PROJECT)/src/budget_adxl355.c \
+	$(PROJECT)/src/budget_ad7124.c
+
+INCS += $(PROJECT)/src/budget.h \
+	$(PROJECT)/src/bus_rec.h
+
+SRCS += $(DRIVERS)/accel/adxl355/adxl355.c \
+	$(DRIVERS)/adc/ad7124/ad7124.c \
+	$(DRIVERS)/adc/ad7124/ad7124_regs.c
+
+INCS += $(DRIVERS)/accel/adxl355/adxl355.h \
+	$(DRIVERS)/adc/ad7124/ad7124.h \
+	$(DRIVERS)/adc/ad7124/ad7124_regs.h
+
+SRCS += $(DRIVERS)/api/no_os_spi.c \
+	$(DRIVERS)/api/no_os_i2c.c \
+	$(DRIVERS)/platform/linux/linux_delay.c \
+	$(NO-OS)/util/no_os_alloc.c \
+	$(NO-OS)/util/no_os_conv.c \
+	$(NO-OS)/util/no_os_sd_odr.c \
+	$(NO-OS)/util/no_os_util.c
+
+INCS += $(INCLUDE)/no_os_alloc.h \
+	$(INCLUDE)/no_os_conv.h \
+	$(INCLUDE)/no_os_delay.h \
+	$(INCLUDE)/no_os_error.h \
+	$(INCLUDE)/no_os_gpio.h \
+	$(INCLUDE)/no_os_i2c.h \
+	$(INCLUDE)/no_os_irq.h \
+	$(INCLUDE)/no_os_sched.h \
+	$(INCLUDE)/no_os_sd_odr.h \
+	$(INCLUDE)/no_os_spi.h \
+	$(INCLUDE)/no_os_util.h
@@ -0,0 +1,148 @@
+/***************************************************************************//**
+ *   @file   budget.c
+ *   @brief  Runner of the bus usage budgets.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include "no_os_error.h"
+#include "budget.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+static const char *const budget_op_names[] = {
+	[BUS_REC_SPI] = "spi",
+	[BUS_REC_SPI_MSG] = "spi_msg",
+	[BUS_REC_I2C_WR] = "i2c_wr",
+	[BUS_REC_I2C_RD] = "i2c_rd",
+};
+
+/**
+ * @brief Print the recorded call sequence as a JSON array.
+ * @param rec - The recorder.
+ */
+static void budget_print_sequence(const struct bus_rec *rec)
+{
+	uint32_t i;
+
+	printf(", \"sequence\": [");
+	for (i = 0; i < rec->nb_entries; i++)
+		printf("%s\"%s 0x%02x %"PRIu32"\"", i ? ", " : "",
+		       budget_op_names[rec->log[i].op], rec->log[i].cmd,
+		       rec->log[i].bytes);
+	if (rec->xfers > rec->nb_entries)
+		printf(", \"...\"");
+	printf("]");
+}
+
+/**
+ * @brief Record a case and print its JSON result.
+ * @param bc - The case.
+ * @param first - Whether this is the first result of the array.
+ * @param sequence - Print the transactions.
+ * @return 0 if the operation succeeded within its budget, negative error code
+ * otherwise.
+ */
+static int32_t budget_run_case(const struct budget_case *bc, bool first,
+			       bool sequence)
+{
+	struct bus_rec rec;
+	void *ctx = NULL;
+	int32_t ret;
+	bool pass;
+
+	ret = bc->setup(&ctx, &rec);
+	if (ret)
+		return ret;
+
+	bus_rec_reset(&rec);
+	ret = bc->run(ctx);
+	pass = !ret && rec.xfers <= bc->max_xfers &&
+	       rec.bytes <= bc->max_bytes;
+
+	printf("%s\n    {\"name\": \"%s\", \"calls\": %"PRIu32", \"xfers\": %"
+	       PRIu32", \"max_xfers\": %"PRIu32", \"bytes\": %"PRIu32
+	       ", \"max_bytes\": %"PRIu32", \"pass\": %s", first ? "" : ",",
+	       bc->name, rec.calls, rec.xfers, bc->max_xfers, rec.bytes,
+	       bc->max_bytes, pass ? "true" : "false");
+	if (ret)
+		printf(", \"error\": %"PRId32, ret);
+	if (sequence)
+		budget_print_sequence(&rec);
+	printf("}");
+
+	if (bc->teardown)
+		bc->teardown(ctx);
+
+	if (ret)
+		return ret;
+
+	return pass ? 0 : -EFBIG;
+}
+
+/**
+ * @brief Run the cases whose name contains filter and print the results.
+ * @param cases - The cases.
+ * @param nb_cases - Number of cases.
+ * @param filter - Substring of the names of the cases to run, NULL for all.
+ * @param sequence - Print the transactions of each case.
+ * @return 0 if all the cases passed, negative error code otherwise.
+ */
+int32_t budget_run_all(const struct budget_case *cases, uint32_t nb_cases,
+		       const char *filter, bool sequence)
+{
+	static bool first = true;
+	int32_t ret = 0;
+	uint32_t i;
+
+	for (i = 0; i < nb_cases; i++) {
+		if (filter && !strstr(cases[i].name, filter))
+			continue;
+
+		if (budget_run_case(&cases[i], first, sequence))
+			ret = -EFBIG;
+		first = false;
+	}
+
+	return ret;
+}
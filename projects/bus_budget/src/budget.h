@@ -0,0 +1,89 @@
+/***************************************************************************//**
+ *   @file   budget.h
+ *   @brief  Bus usage budgets of the driver operations.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef _BUDGET_H_
+#define _BUDGET_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "bus_rec.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct budget_case
+ * @brief A driver operation and the most bus traffic it may cause. Only the
+ * transactions done by run() are recorded, on the bus_rec given to setup().
+ */
+struct budget_case {
+	/** Name, stable between versions so results can be compared */
+	const char *name;
+	/** Prepare the device and the mock bus, recording on rec */
+	int32_t (*setup)(void **ctx, struct bus_rec *rec);
+	/** The operation, returns negative error code on failure */
+	int32_t (*run)(void *ctx);
+	/** Free the state of the case, optional */
+	void (*teardown)(void *ctx);
+	/** Most chip select frames or I2C transactions */
+	uint32_t max_xfers;
+	/** Most bytes on the bus */
+	uint32_t max_bytes;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Run the cases whose name contains filter, all if NULL, printing JSON. */
+int32_t budget_run_all(const struct budget_case *cases, uint32_t nb_cases,
+		       const char *filter, bool sequence);
+
+/* Cases of the ADXL355 driver, on SPI and on I2C. */
+extern const struct budget_case budget_adxl355_cases[];
+extern const uint32_t budget_adxl355_nb_cases;
+
+/* Cases of the AD7124 driver. */
+extern const struct budget_case budget_ad7124_cases[];
+extern const uint32_t budget_ad7124_nb_cases;
+
+#endif // _BUDGET_H_
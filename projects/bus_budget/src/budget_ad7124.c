@@ -0,0 +1,205 @@
+/***************************************************************************//**
+ *   @file   budget_ad7124.c
+ *   @brief  Bus usage budgets of the AD7124 driver.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <string.h>
+#include "no_os_error.h"
+#include "no_os_alloc.h"
+#include "no_os_util.h"
+#include "ad7124.h"
+#include "ad7124_regs.h"
+#include "budget.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define BUDGET_AD7124_POLL_CNT		25000
+/* Output data rate set by the retune case, 50 Hz */
+#define BUDGET_AD7124_ODR_MHZ		50000
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct budget_ad7124
+ * @brief State of the AD7124 cases.
+ */
+struct budget_ad7124 {
+	struct bus_rec_dev bus;
+	struct no_os_spi_init_param spi_ip;
+	struct ad7124_init_param ip;
+	struct ad7124_st_reg regs[AD7124_REG_NO];
+	struct ad7124_dev *dev;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Set up the mock bus. Its registers read as 0, a device out of reset
+ * and ready, with no error and a conversion available.
+ * @param ctx - Where to store the state.
+ * @param rec - Where to record the transactions.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t budget_ad7124_bus(void **ctx, struct bus_rec *rec)
+{
+	struct budget_ad7124 *b;
+
+	b = no_os_calloc(1, sizeof(*b));
+	if (!b)
+		return -ENOMEM;
+
+	b->bus.rec = rec;
+	b->bus.addr_mask = 0x3F;
+	b->bus.read_bit = AD7124_COMM_REG_RD;
+	b->bus.read_only = true;
+
+	b->spi_ip.max_speed_hz = 1000000;
+	b->spi_ip.mode = NO_OS_SPI_MODE_3;
+	b->spi_ip.platform_ops = &bus_rec_spi_ops;
+	b->spi_ip.extra = &b->bus;
+
+	memcpy(b->regs, ad7124_regs, sizeof(b->regs));
+	b->ip.spi_init = &b->spi_ip;
+	b->ip.regs = b->regs;
+	b->ip.spi_rdy_poll_cnt = BUDGET_AD7124_POLL_CNT;
+
+	*ctx = b;
+
+	return 0;
+}
+
+/**
+ * @brief Set up the mock bus and initialize the device on it.
+ * @param ctx - Where to store the state.
+ * @param rec - Where to record the transactions.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t budget_ad7124_dev(void **ctx, struct bus_rec *rec)
+{
+	struct budget_ad7124 *b;
+	int32_t ret;
+
+	ret = budget_ad7124_bus(ctx, rec);
+	if (ret)
+		return ret;
+
+	b = *ctx;
+	ret = ad7124_setup(&b->dev, &b->ip);
+	if (ret) {
+		no_os_free(b);
+		return ret;
+	}
+
+	return 0;
+}
+
+static int32_t budget_ad7124_init(void *ctx)
+{
+	struct budget_ad7124 *b = ctx;
+
+	return ad7124_setup(&b->dev, &b->ip);
+}
+
+static int32_t budget_ad7124_set_odr(void *ctx)
+{
+	struct budget_ad7124 *b = ctx;
+
+	return ad7124_set_odr_mhz(b->dev, BUDGET_AD7124_ODR_MHZ, 0);
+}
+
+static int32_t budget_ad7124_single_read(void *ctx)
+{
+	struct budget_ad7124 *b = ctx;
+	int32_t data, ret;
+
+	ret = ad7124_wait_for_conv_ready(b->dev, BUDGET_AD7124_POLL_CNT);
+	if (ret)
+		return ret;
+
+	return ad7124_read_data(b->dev, &data);
+}
+
+/**
+ * @brief Remove the device, if initialized, and free the state.
+ * @param ctx - The state.
+ */
+static void budget_ad7124_teardown(void *ctx)
+{
+	struct budget_ad7124 *b = ctx;
+
+	if (b->dev)
+		ad7124_remove(b->dev);
+	no_os_free(b);
+}
+
+const struct budget_case budget_ad7124_cases[] = {
+	{
+		.name = "ad7124_init",
+		.setup = budget_ad7124_bus,
+		.run = budget_ad7124_init,
+		.teardown = budget_ad7124_teardown,
+		.max_xfers = 74,
+		.max_bytes = 272,
+	},
+	{
+		.name = "ad7124_set_odr",
+		.setup = budget_ad7124_dev,
+		.run = budget_ad7124_set_odr,
+		.teardown = budget_ad7124_teardown,
+		.max_xfers = 10,
+		.max_bytes = 38,
+	},
+	{
+		.name = "ad7124_single_read",
+		.setup = budget_ad7124_dev,
+		.run = budget_ad7124_single_read,
+		.teardown = budget_ad7124_teardown,
+		.max_xfers = 4,
+		.max_bytes = 14,
+	},
+};
+
+const uint32_t budget_ad7124_nb_cases = NO_OS_ARRAY_SIZE(budget_ad7124_cases);
@@ -0,0 +1,276 @@
+/***************************************************************************//**
+ *   @file   budget_adxl355.c
+ *   @brief  Bus usage budgets of the ADXL355 driver.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "no_os_error.h"
+#include "no_os_alloc.h"
+#include "no_os_util.h"
+#include "adxl355.h"
+#include "budget.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define BUDGET_ADXL355_I2C_ADDR		0x1D
+/* FIFO entries reported by the mock, 20 x, y, z sets */
+#define BUDGET_ADXL355_FIFO_ENTRIES	60
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct budget_adxl355
+ * @brief State of the ADXL355 cases.
+ */
+struct budget_adxl355 {
+	struct bus_rec_dev bus;
+	struct adxl355_init_param ip;
+	struct adxl355_dev *dev;
+	uint32_t x[32];
+	uint32_t y[32];
+	uint32_t z[32];
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Set up the mock bus with the identification and FIFO registers.
+ * @param ctx - Where to store the state.
+ * @param rec - Where to record the transactions.
+ * @param comm_type - SPI or I2C.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t budget_adxl355_bus(void **ctx, struct bus_rec *rec,
+				  enum adxl355_comm_type comm_type)
+{
+	struct budget_adxl355 *b;
+
+	b = no_os_calloc(1, sizeof(*b));
+	if (!b)
+		return -ENOMEM;
+
+	b->bus.rec = rec;
+	/* Command is the register address followed by the read bit */
+	b->bus.addr_shift = 1;
+	b->bus.addr_mask = 0x7F;
+	b->bus.read_bit = ADXL355_SPI_READ;
+	b->bus.regs[ADXL355_ADDR(ADXL355_DEVID_AD)] =
+		GET_ADXL355_RESET_VAL(ADXL355_DEVID_AD);
+	b->bus.regs[ADXL355_ADDR(ADXL355_DEVID_MST)] =
+		GET_ADXL355_RESET_VAL(ADXL355_DEVID_MST);
+	b->bus.regs[ADXL355_ADDR(ADXL355_PARTID)] =
+		GET_ADXL355_RESET_VAL(ADXL355_PARTID);
+	b->bus.regs[ADXL355_ADDR(ADXL355_FIFO_ENTRIES)] =
+		BUDGET_ADXL355_FIFO_ENTRIES;
+
+	b->ip.comm_type = comm_type;
+	b->ip.dev_type = ID_ADXL355;
+	if (comm_type == ADXL355_SPI_COMM) {
+		b->ip.comm_init.spi_init.max_speed_hz = 1000000;
+		b->ip.comm_init.spi_init.mode = NO_OS_SPI_MODE_0;
+		b->ip.comm_init.spi_init.platform_ops = &bus_rec_spi_ops;
+		b->ip.comm_init.spi_init.extra = &b->bus;
+	} else {
+		b->ip.comm_init.i2c_init.max_speed_hz = 400000;
+		b->ip.comm_init.i2c_init.slave_address =
+			BUDGET_ADXL355_I2C_ADDR;
+		b->ip.comm_init.i2c_init.platform_ops = &bus_rec_i2c_ops;
+		b->ip.comm_init.i2c_init.extra = &b->bus;
+	}
+
+	*ctx = b;
+
+	return 0;
+}
+
+static int32_t budget_adxl355_spi_bus(void **ctx, struct bus_rec *rec)
+{
+	return budget_adxl355_bus(ctx, rec, ADXL355_SPI_COMM);
+}
+
+static int32_t budget_adxl355_i2c_bus(void **ctx, struct bus_rec *rec)
+{
+	return budget_adxl355_bus(ctx, rec, ADXL355_I2C_COMM);
+}
+
+/**
+ * @brief Set up the mock bus and initialize the device on it.
+ * @param ctx - Where to store the state.
+ * @param rec - Where to record the transactions.
+ * @param comm_type - SPI or I2C.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t budget_adxl355_dev(void **ctx, struct bus_rec *rec,
+				  enum adxl355_comm_type comm_type)
+{
+	struct budget_adxl355 *b;
+	int32_t ret;
+
+	ret = budget_adxl355_bus(ctx, rec, comm_type);
+	if (ret)
+		return ret;
+
+	b = *ctx;
+	ret = adxl355_init(&b->dev, b->ip);
+	if (ret) {
+		no_os_free(b);
+		return ret;
+	}
+
+	return 0;
+}
+
+static int32_t budget_adxl355_spi_dev(void **ctx, struct bus_rec *rec)
+{
+	return budget_adxl355_dev(ctx, rec, ADXL355_SPI_COMM);
+}
+
+static int32_t budget_adxl355_i2c_dev(void **ctx, struct bus_rec *rec)
+{
+	return budget_adxl355_dev(ctx, rec, ADXL355_I2C_COMM);
+}
+
+static int32_t budget_adxl355_init(void *ctx)
+{
+	struct budget_adxl355 *b = ctx;
+
+	return adxl355_init(&b->dev, b->ip);
+}
+
+static int32_t budget_adxl355_set_odr(void *ctx)
+{
+	struct budget_adxl355 *b = ctx;
+
+	return adxl355_set_odr_lpf(b->dev, ADXL355_ODR_1000HZ);
+}
+
+static int32_t budget_adxl355_read_xyz(void *ctx)
+{
+	struct budget_adxl355 *b = ctx;
+
+	return adxl355_get_raw_xyz(b->dev, b->x, b->y, b->z);
+}
+
+static int32_t budget_adxl355_fifo_drain(void *ctx)
+{
+	struct budget_adxl355 *b = ctx;
+	uint8_t entries;
+
+	return adxl355_get_raw_fifo_data(b->dev, &entries, b->x, b->y, b->z);
+}
+
+/**
+ * @brief Remove the device, if initialized, and free the state.
+ * @param ctx - The state.
+ */
+static void budget_adxl355_teardown(void *ctx)
+{
+	struct budget_adxl355 *b = ctx;
+
+	if (b->dev)
+		adxl355_remove(b->dev);
+	no_os_free(b);
+}
+
+const struct budget_case budget_adxl355_cases[] = {
+	{
+		.name = "adxl355_spi_init",
+		.setup = budget_adxl355_spi_bus,
+		.run = budget_adxl355_init,
+		.teardown = budget_adxl355_teardown,
+		.max_xfers = 4,
+		.max_bytes = 12,
+	},
+	{
+		.name = "adxl355_spi_set_odr",
+		.setup = budget_adxl355_spi_dev,
+		.run = budget_adxl355_set_odr,
+		.teardown = budget_adxl355_teardown,
+		.max_xfers = 3,
+		.max_bytes = 6,
+	},
+	{
+		.name = "adxl355_spi_read_xyz",
+		.setup = budget_adxl355_spi_dev,
+		.run = budget_adxl355_read_xyz,
+		.teardown = budget_adxl355_teardown,
+		.max_xfers = 3,
+		.max_bytes = 12,
+	},
+	{
+		.name = "adxl355_spi_fifo_drain",
+		.setup = budget_adxl355_spi_dev,
+		.run = budget_adxl355_fifo_drain,
+		.teardown = budget_adxl355_teardown,
+		.max_xfers = 2,
+		.max_bytes = 183,
+	},
+	{
+		.name = "adxl355_i2c_init",
+		.setup = budget_adxl355_i2c_bus,
+		.run = budget_adxl355_init,
+		.teardown = budget_adxl355_teardown,
+		.max_xfers = 8,
+		.max_bytes = 12,
+	},
+	{
+		.name = "adxl355_i2c_read_xyz",
+		.setup = budget_adxl355_i2c_dev,
+		.run = budget_adxl355_read_xyz,
+		.teardown = budget_adxl355_teardown,
+		.max_xfers = 6,
+		.max_bytes = 12,
+	},
+	{
+		.name = "adxl355_i2c_fifo_drain",
+		.setup = budget_adxl355_i2c_dev,
+		.run = budget_adxl355_fifo_drain,
+		.teardown = budget_adxl355_teardown,
+		.max_xfers = 4,
+		.max_bytes = 183,
+	},
+};
+
+const uint32_t budget_adxl355_nb_cases = NO_OS_ARRAY_SIZE(budget_adxl355_cases);
@@ -0,0 +1,306 @@
+/***************************************************************************//**
+ *   @file   bus_rec.c
+ *   @brief  Recording mock SPI and I2C buses of the bus_budget project.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <string.h>
+#include "no_os_error.h"
+#include "no_os_alloc.h"
+#include "bus_rec.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Clear the counters and the call sequence.
+ * @param rec - The recorder.
+ */
+void bus_rec_reset(struct bus_rec *rec)
+{
+	memset(rec, 0, sizeof(*rec));
+}
+
+/**
+ * @brief Count a transaction and add it to the call sequence.
+ * @param rec - The recorder, can be NULL.
+ * @param op - Kind of transaction.
+ * @param cmd - First byte sent.
+ * @param bytes - Number of bytes.
+ */
+static void bus_rec_add(struct bus_rec *rec, enum bus_rec_op op, uint8_t cmd,
+			uint32_t bytes)
+{
+	struct bus_rec_entry *e;
+
+	if (!rec)
+		return;
+
+	rec->xfers++;
+	rec->bytes += bytes;
+	if (rec->nb_entries == BUS_REC_LOG_SIZE)
+		return;
+
+	e = &rec->log[rec->nb_entries++];
+	e->op = op;
+	e->cmd = cmd;
+	e->bytes = bytes;
+}
+
+/**
+ * @brief Initialize the SPI mock.
+ * @param desc - Where to store the SPI descriptor.
+ * @param param - Initialization parameters, extra is a bus_rec_dev.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bus_rec_spi_init(struct no_os_spi_desc **desc,
+				const struct no_os_spi_init_param *param)
+{
+	struct no_os_spi_desc *d;
+
+	if (!param->extra)
+		return -EINVAL;
+
+	d = no_os_calloc(1, sizeof(*d));
+	if (!d)
+		return -ENOMEM;
+
+	d->extra = param->extra;
+	*desc = d;
+
+	return 0;
+}
+
+/**
+ * @brief Serve a chip select frame with the register file.
+ * @param dev - The register file.
+ * @param op - Kind of transaction, for the recorder.
+ * @param tx - Data sent, NULL for zeros.
+ * @param rx - Where to store the data received, can be NULL or tx.
+ * @param len - Number of bytes of the frame.
+ */
+static void bus_rec_spi_frame(struct bus_rec_dev *dev, enum bus_rec_op op,
+			      const uint8_t *tx, uint8_t *rx, uint32_t len)
+{
+	uint8_t cmd = tx ? tx[0] : 0;
+	uint8_t addr;
+	uint32_t i;
+
+	bus_rec_add(dev->rec, op, cmd, len);
+
+	addr = (cmd >> dev->addr_shift) & dev->addr_mask;
+	for (i = 1; i < len; i++, addr++) {
+		if (cmd & dev->read_bit) {
+			if (rx)
+				rx[i] = dev->regs[addr];
+		} else if (!dev->read_only) {
+			dev->regs[addr] = tx ? tx[i] : 0;
+		}
+	}
+}
+
+/**
+ * @brief Transfer a single frame.
+ * @param desc - The SPI descriptor.
+ * @param data - Command byte followed by the register data, replaced by the
+ * register values for a read.
+ * @param bytes_number - Number of bytes of data.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bus_rec_spi_write_and_read(struct no_os_spi_desc *desc,
+		uint8_t *data, uint16_t bytes_number)
+{
+	struct bus_rec_dev *dev = desc->extra;
+
+	if (!bytes_number)
+		return -EINVAL;
+
+	if (dev->rec)
+		dev->rec->calls++;
+	bus_rec_spi_frame(dev, BUS_REC_SPI, data, data, bytes_number);
+
+	return 0;
+}
+
+/**
+ * @brief Transfer a list of messages, each of them a chip select frame.
+ * @param desc - The SPI descriptor.
+ * @param msgs - The messages.
+ * @param len - Number of messages.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bus_rec_spi_transfer(struct no_os_spi_desc *desc,
+				    struct no_os_spi_msg *msgs, uint32_t len)
+{
+	struct bus_rec_dev *dev = desc->extra;
+	uint32_t i;
+
+	if (dev->rec)
+		dev->rec->calls++;
+	for (i = 0; i < len; i++) {
+		if (!msgs[i].bytes_number)
+			return -EINVAL;
+		bus_rec_spi_frame(dev, BUS_REC_SPI_MSG, msgs[i].tx_buff,
+				  msgs[i].rx_buff, msgs[i].bytes_number);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Free the SPI mock.
+ * @param desc - The SPI descriptor.
+ * @return 0
+ */
+static int32_t bus_rec_spi_remove(struct no_os_spi_desc *desc)
+{
+	no_os_free(desc);
+
+	return 0;
+}
+
+/**
+ * @brief Initialize the I2C mock.
+ * @param desc - Where to store the I2C descriptor.
+ * @param param - Initialization parameters, extra is a bus_rec_dev.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bus_rec_i2c_init(struct no_os_i2c_desc **desc,
+				const struct no_os_i2c_init_param *param)
+{
+	struct no_os_i2c_desc *d;
+
+	if (!param->extra)
+		return -EINVAL;
+
+	d = no_os_calloc(1, sizeof(*d));
+	if (!d)
+		return -ENOMEM;
+
+	d->slave_address = param->slave_address;
+	d->extra = param->extra;
+	*desc = d;
+
+	return 0;
+}
+
+/**
+ * @brief Write the register address, followed by register data if any.
+ * @param desc - The I2C descriptor.
+ * @param data - Address byte followed by the register data.
+ * @param bytes_number - Number of bytes of data.
+ * @param stop_bit - Unused.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bus_rec_i2c_write(struct no_os_i2c_desc *desc,
+				 uint8_t *data, uint8_t bytes_number,
+				 uint8_t stop_bit)
+{
+	struct bus_rec_dev *dev = desc->extra;
+	uint8_t i;
+
+	if (!bytes_number)
+		return -EINVAL;
+
+	if (dev->rec)
+		dev->rec->calls++;
+	bus_rec_add(dev->rec, BUS_REC_I2C_WR, data[0], bytes_number);
+
+	dev->addr = data[0];
+	for (i = 1; i < bytes_number; i++, dev->addr++)
+		if (!dev->read_only)
+			dev->regs[dev->addr] = data[i];
+
+	return 0;
+}
+
+/**
+ * @brief Read the registers from the last written address.
+ * @param desc - The I2C descriptor.
+ * @param data - Where to store the register values.
+ * @param bytes_number - Number of bytes to read.
+ * @param stop_bit - Unused.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t bus_rec_i2c_read(struct no_os_i2c_desc *desc,
+				uint8_t *data, uint8_t bytes_number,
+				uint8_t stop_bit)
+{
+	struct bus_rec_dev *dev = desc->extra;
+	uint8_t i;
+
+	if (!bytes_number)
+		return -EINVAL;
+
+	if (dev->rec)
+		dev->rec->calls++;
+	bus_rec_add(dev->rec, BUS_REC_I2C_RD, 0, bytes_number);
+
+	for (i = 0; i < bytes_number; i++)
+		data[i] = dev->regs[dev->addr++];
+
+	return 0;
+}
+
+/**
+ * @brief Free the I2C mock.
+ * @param desc - The I2C descriptor.
+ * @return 0
+ */
+static int32_t bus_rec_i2c_remove(struct no_os_i2c_desc *desc)
+{
+	no_os_free(desc);
+
+	return 0;
+}
+
+const struct no_os_spi_platform_ops bus_rec_spi_ops = {
+	.init = bus_rec_spi_init,
+	.write_and_read = bus_rec_spi_write_and_read,
+	.transfer = bus_rec_spi_transfer,
+	.remove = bus_rec_spi_remove
+};
+
+const struct no_os_i2c_platform_ops bus_rec_i2c_ops = {
+	.i2c_ops_init = bus_rec_i2c_init,
+	.i2c_ops_write = bus_rec_i2c_write,
+	.i2c_ops_read = bus_rec_i2c_read,
+	.i2c_ops_remove = bus_rec_i2c_remove
+};
@@ -0,0 +1,144 @@
+/***************************************************************************//**
+ *   @file   bus_rec.h
+ *   @brief  Recording mock SPI and I2C buses of the bus_budget project.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef _BUS_REC_H_
+#define _BUS_REC_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "no_os_spi.h"
+#include "no_os_i2c.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define BUS_REC_NB_REGS		256
+/* Transactions kept in the call sequence, the next ones are only counted */
+#define BUS_REC_LOG_SIZE	64
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @enum bus_rec_op
+ * @brief Kind of a recorded transaction.
+ */
+enum bus_rec_op {
+	/** no_os_spi_write_and_read, one chip select frame */
+	BUS_REC_SPI,
+	/** Message of a no_os_spi_transfer, one chip select frame */
+	BUS_REC_SPI_MSG,
+	/** I2C write */
+	BUS_REC_I2C_WR,
+	/** I2C read */
+	BUS_REC_I2C_RD,
+};
+
+/**
+ * @struct bus_rec_entry
+ * @brief Transaction of the call sequence.
+ */
+struct bus_rec_entry {
+	/** Kind of transaction */
+	enum bus_rec_op op;
+	/** First byte sent, the command or register address. 0 for reads */
+	uint8_t cmd;
+	/** Number of bytes */
+	uint32_t bytes;
+};
+
+/**
+ * @struct bus_rec
+ * @brief Bus usage recorded by the mocks since the last bus_rec_reset.
+ */
+struct bus_rec {
+	/** Calls of the platform ops, a no_os_spi_transfer being one call */
+	uint32_t calls;
+	/** Transactions, chip select frames for SPI */
+	uint32_t xfers;
+	/** Bytes sent or received */
+	uint32_t bytes;
+	/** Transactions in log */
+	uint32_t nb_entries;
+	/** First transactions, in order */
+	struct bus_rec_entry log[BUS_REC_LOG_SIZE];
+};
+
+/**
+ * @struct bus_rec_dev
+ * @brief Register file behind a mock bus, passed as the extra of the init
+ * parameters. The command byte of SPI transactions is decoded as
+ * (cmd >> addr_shift) & addr_mask, being a read if cmd & read_bit is not 0,
+ * the data bytes following it go to or come from consecutive registers.
+ * For I2C the first byte written is the register address.
+ */
+struct bus_rec_dev {
+	/** Where the transactions are recorded, can be NULL */
+	struct bus_rec *rec;
+	/** Register values */
+	uint8_t regs[BUS_REC_NB_REGS];
+	/** Position of the register address in the SPI command */
+	uint8_t addr_shift;
+	/** Mask of the register address, after the shift */
+	uint8_t addr_mask;
+	/** Bit of the SPI command selecting a read */
+	uint8_t read_bit;
+	/** Drop the written values, reads always get the regs set up */
+	bool read_only;
+	/** Register addressed by the last I2C write */
+	uint8_t addr;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Clear the counters and the call sequence. */
+void bus_rec_reset(struct bus_rec *rec);
+
+/* SPI platform ops serving a bus_rec_dev passed as extra. */
+extern const struct no_os_spi_platform_ops bus_rec_spi_ops;
+/* I2C platform ops serving a bus_rec_dev passed as extra. */
+extern const struct no_os_i2c_platform_ops bus_rec_i2c_ops;
+
+#endif // _BUS_REC_H_
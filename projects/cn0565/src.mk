@@ -2,7 +2,7 @@ SRC_DIRS += $(PROJECT)/src/app
 SRC_DIRS += $(PROJECT)/src/mux_board
 
 INCS +=	$(INCLUDE)/no_os_uart.h \
-	$(INCLUDE)/no_os_lf256fifo.h \
+	$(INCLUDE)/no_os_lffifo.h \
 	$(INCLUDE)/no_os_list.h \
 	$(INCLUDE)/no_os_i2c.h \
 	$(INCLUDE)/no_os_spi.h \
@@ -20,7 +20,7 @@ SRCS += $(DRIVERS)/api/no_os_spi.c \
 	$(DRIVERS)/api/no_os_i2c.c \
 	$(DRIVERS)/api/no_os_irq.c \
 	$(DRIVERS)/api/no_os_uart.c \
-	$(NO-OS)/util/no_os_lf256fifo.c \
+	$(NO-OS)/util/no_os_lffifo.c \
 	$(NO-OS)/util/no_os_list.c \
 	$(NO-OS)/util/no_os_util.c \
 	$(DRIVERS)/afe/ad5940/bia_measurement.c \
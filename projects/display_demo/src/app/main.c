@@ -109,7 +109,8 @@ int main(void)
 	struct ssd_1306_extra ssd1306_extra = {
 		.dc_pin_ip = &dc_pin,
 		.reset_pin_ip = &reset_pin,
-		.spi_ip = &ssd_1306_spi_init_param
+		.spi_ip = &ssd_1306_spi_init_param,
+		.use_framebuffer = true
 	};
 
 	struct display_init_param display_ip = {
@@ -153,10 +154,17 @@ int main(void)
 	if (ret != 0)
 		return -1;
 
+	ret = display_print_string(dev, msg, 0, 0);
+	if (ret != 0)
+		return -1;
+
+	/* Send the screen drawn in the framebuffer in one transfer */
+	ret = display_flush(dev);
+
 	/* Disable the instruction cache. */
 	Xil_ICacheDisable();
 	/* Disable the data cache. */
 	Xil_DCacheDisable();
 
-	return display_print_string(dev, msg, 0, 0);
+	return ret;
 }
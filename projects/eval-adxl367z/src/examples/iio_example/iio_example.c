@@ -68,7 +68,7 @@ int iio_example_main()
 {
 	int ret;
 	struct adxl367_iio_dev *adxl367_iio_desc;
-	struct adxl367_iio_init_param adxl367_iio_ip;
+	struct adxl367_iio_init_param adxl367_iio_ip = { 0 };
 	struct iio_data_buffer accel_buff = {
 		.buff = (void *)iio_data_buffer,
 		.size = DATA_BUFFER_SIZE*4*sizeof(int16_t)
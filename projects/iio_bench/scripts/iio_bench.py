@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+"""
+Measure the throughput of the iio_bench firmware with libiio.
+
+The bench_source device of the firmware generates a 16-bit ramp. The script
+reads it for a while and reports the throughput seen by the host, the time of
+each refill, the blocks lost by the firmware (overruns), the samples broken in
+the transfer and the share of the time the firmware spent in iio_step. The
+ramp continues over the lost blocks, a break means the transport corrupted or
+dropped data.
+
+Examples:
+	python iio_bench.py ip:192.168.1.10
+	python iio_bench.py serial:/dev/ttyUSB0,921600 -samples 1024 -time 5
+	python iio_bench.py ip:localhost -frequency 1000000 -json
+"""
+
+import argparse
+import array
+import json
+import sys
+import time
+
+import iio
+
+DEVICE = 'bench_source'
+
+def parse_stats(text):
+	"""Parse the "name value" lines of the bench_stats and stats attributes"""
+	stats = {}
+	for line in text.splitlines():
+		words = line.split()
+		if len(words) != 2:
+			continue
+		try:
+			stats[words[0]] = float(words[1])
+		except ValueError:
+			pass
+	return stats
+
+def ramp_breaks(data, prev):
+	"""Count the samples not following the ramp, prev being the last one read"""
+	samples = array.array('H')
+	samples.frombytes(data)
+	breaks = 0
+	for s in samples:
+		if prev is not None and s != (prev + 1) & 0xffff:
+			breaks += 1
+		prev = s
+	return breaks, prev
+
+def run(args):
+	ctx = iio.Context(args.uri)
+	dev = ctx.find_device(DEVICE)
+	if dev is None:
+		sys.exit('%s not found on %s' % (DEVICE, args.uri))
+
+	dev.attrs['sampling_frequency'].value = str(args.frequency)
+	channels = dev.channels[:args.channels]
+	for ch in channels:
+		ch.enabled = True
+
+	# Cleared now, the source statistics are cleared when the buffer starts
+	if 'stats' in dev.debug_attrs:
+		dev.debug_attrs['stats'].value = '0'
+
+	buf = iio.Buffer(dev, args.samples)
+	refills = []
+	nbytes = 0
+	breaks = 0
+	prev = None
+	start = time.monotonic()
+	while time.monotonic() - start < args.time:
+		t = time.monotonic()
+		buf.refill()
+		data = buf.read()
+		refills.append(time.monotonic() - t)
+		nbytes += len(data)
+		if args.check:
+			n, prev = ramp_breaks(data, prev)
+			breaks += n
+	elapsed = time.monotonic() - start
+
+	source = parse_stats(dev.attrs['bench_stats'].value)
+	server = {}
+	if 'stats' in dev.debug_attrs:
+		server = parse_stats(dev.debug_attrs['stats'].value)
+	del buf
+
+	result = {
+		'uri': args.uri,
+		'channels': len(channels),
+		'samples': args.samples,
+		'sampling_frequency': args.frequency,
+		'host_mb_per_s': nbytes / elapsed / 1e6,
+		'refills': len(refills),
+		'refill_avg_ms': sum(refills) / len(refills) * 1e3,
+		'refill_max_ms': max(refills) * 1e3,
+		'device_mb_per_s': source.get('mb_per_s'),
+		'overruns': source.get('overruns'),
+		'block_latency_avg_us': source.get('latency_avg_us'),
+		'block_latency_max_us': source.get('latency_max_us'),
+		'fill_load_pct': source.get('load_pct'),
+	}
+	if args.check:
+		result['ramp_breaks'] = breaks
+	if source.get('elapsed_us') and 'step_total_us' in server:
+		# Time in iio_step, the rest is spent between the steps
+		result['cpu_load_pct'] = (server['step_total_us'] * 100 /
+					  source['elapsed_us'])
+	return result
+
+def main():
+	parser = argparse.ArgumentParser(
+		description='Measure the throughput of the iio_bench firmware')
+	parser.add_argument('uri', help='libiio context, e.g. ip:192.168.1.10')
+	parser.add_argument('-samples', type=int, default=65536,
+			    help='samples per refill (default 65536)')
+	parser.add_argument('-channels', type=int, default=4,
+			    help='channels to enable (default 4)')
+	parser.add_argument('-frequency', type=int, default=0,
+			    help='sampling frequency, 0 for free running')
+	parser.add_argument('-time', type=float, default=10,
+			    help='seconds of streaming (default 10)')
+	parser.add_argument('-check', action='store_true',
+			    help='check that the data follows the ramp')
+	parser.add_argument('-json', action='store_true',
+			    help='print the results as JSON')
+	args = parser.parse_args()
+
+	result = run(args)
+	if args.json:
+		print(json.dumps(result, indent=2))
+		return
+
+	for key, val in result.items():
+		if isinstance(val, float):
+			val = '%.2f' % val
+		print('%-22s %s' % (key, val))
+
+if __name__ == '__main__':
+	main()
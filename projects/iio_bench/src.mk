@@ -0,0 +1,24 @@
+TINYIIOD = y
+
+SRC_DIRS += $(NO-OS)/iio/iio_app
+
+SRCS += $(PROJECT)/src/common/iio_bench.c \
+	$(PROJECT)/src/common/iio_bench_source.c
+
+INCS += $(PROJECT)/src/common/iio_bench.h \
+	$(PROJECT)/src/common/iio_bench_source.h
+
+SRCS += $(DRIVERS)/api/no_os_uart.c \
+	$(NO-OS)/util/no_os_fifo.c \
+	$(NO-OS)/util/no_os_list.c \
+	$(NO-OS)/util/no_os_util.c
+
+INCS += $(INCLUDE)/no_os_delay.h \
+	$(INCLUDE)/no_os_error.h \
+	$(INCLUDE)/no_os_fifo.h \
+	$(INCLUDE)/no_os_irq.h \
+	$(INCLUDE)/no_os_lffifo.h \
+	$(INCLUDE)/no_os_list.h \
+	$(INCLUDE)/no_os_timer.h \
+	$(INCLUDE)/no_os_uart.h \
+	$(INCLUDE)/no_os_util.h
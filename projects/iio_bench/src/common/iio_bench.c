@@ -0,0 +1,90 @@
+/***************************************************************************//**
+ *   @file   iio_bench.c
+ *   @brief  Application of the iio_bench project.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "iio_app.h"
+#include "iio_bench.h"
+#include "iio_bench_source.h"
+#include "parameters.h"
+#include "no_os_util.h"
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+/* Blocks of the device buffer, IIO_BENCH_BUFFER_SIZE is set per platform */
+static uint8_t iio_bench_buffer[IIO_BENCH_BUFFER_SIZE] __attribute__((aligned));
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Serve the synthetic source over the transport selected at build
+ * time: TCP with NETWORKING=y or on linux, UART otherwise.
+ * @return Result of iio_app_run, which doesn't return if working correctly.
+ */
+int iio_bench_main(void)
+{
+	struct iio_bench_source_init_param source_ip = {
+		.sampling_frequency = IIO_BENCH_SAMPLING_FREQ,
+	};
+	struct iio_data_buffer buff = {
+		.buff = iio_bench_buffer,
+		.size = sizeof(iio_bench_buffer),
+	};
+	struct iio_bench_source *source;
+	int32_t ret;
+
+	ret = iio_bench_source_init(&source, &source_ip);
+	if (ret)
+		return ret;
+
+	struct iio_app_device devices[] = {
+		IIO_APP_DEVICE("bench_source", source,
+			       &iio_bench_source_descriptor, &buff, NULL),
+	};
+
+	ret = iio_app_run(devices, NO_OS_ARRAY_SIZE(devices));
+	iio_bench_source_remove(source);
+
+	return ret;
+}
@@ -0,0 +1,352 @@
+/***************************************************************************//**
+ *   @file   iio_bench_source.c
+ *   @brief  Synthetic IIO source of the iio_bench project.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <string.h>
+#include "no_os_error.h"
+#include "no_os_alloc.h"
+#include "no_os_delay.h"
+#include "no_os_util.h"
+#include "iio.h"
+#include "iio_bench_source.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Get the current time.
+ * @return time in microseconds.
+ */
+static uint64_t iio_bench_source_now_us(void)
+{
+	struct no_os_time t = no_os_get_time();
+
+	return (uint64_t)t.s * 1000000 + t.us;
+}
+
+/**
+ * @brief Clear the statistics, the next block starts a new measurement.
+ * @param desc - The source.
+ */
+static void iio_bench_source_reset(struct iio_bench_source *desc)
+{
+	desc->start_us = iio_bench_source_now_us();
+	desc->due_us = 0;
+	desc->blocks = 0;
+	desc->bytes = 0;
+	desc->overruns = 0;
+	desc->latency_last_us = 0;
+	desc->latency_max_us = 0;
+	desc->latency_total_us = 0;
+	desc->fill_us = 0;
+}
+
+/**
+ * @brief Allocate a synthetic source.
+ * @param desc - Where to store the source.
+ * @param param - Initialization parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t iio_bench_source_init(struct iio_bench_source **desc,
+			      struct iio_bench_source_init_param *param)
+{
+	struct iio_bench_source *d;
+
+	if (!desc || !param)
+		return -EINVAL;
+
+	d = no_os_calloc(1, sizeof(*d));
+	if (!d)
+		return -ENOMEM;
+
+	d->sampling_frequency = param->sampling_frequency;
+	iio_bench_source_reset(d);
+	*desc = d;
+
+	return 0;
+}
+
+/**
+ * @brief Free a synthetic source.
+ * @param desc - The source.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t iio_bench_source_remove(struct iio_bench_source *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	no_os_free(desc);
+
+	return 0;
+}
+
+/**
+ * @brief Start a buffer: the statistics are cleared.
+ * @param dev - The source.
+ * @param mask - Active channels.
+ * @return 0
+ */
+static int32_t iio_bench_source_pre_enable(void *dev, uint32_t mask)
+{
+	struct iio_bench_source *desc = dev;
+
+	desc->mask = mask;
+	iio_bench_source_reset(desc);
+
+	return 0;
+}
+
+/**
+ * @brief Generate a block of the ramp, once it is ready.
+ * @param dev_data - The device data.
+ * @return 0 in case of success, -EAGAIN if the block is not ready yet,
+ * negative error code otherwise.
+ */
+static int32_t iio_bench_source_submit(struct iio_device_data *dev_data)
+{
+	struct iio_bench_source *desc = dev_data->dev;
+	struct iio_buffer *buffer = dev_data->buffer;
+	uint64_t now, period = 0, latency, lost;
+	uint16_t *samples;
+	uint32_t i, n;
+	void *block;
+	int ret;
+
+	now = iio_bench_source_now_us();
+	if (desc->sampling_frequency)
+		period = (uint64_t)buffer->size / buffer->bytes_per_scan *
+			 1000000 / desc->sampling_frequency;
+
+	if (!desc->due_us) {
+		/* The first block is acquired from now on */
+		desc->due_us = now + period;
+		desc->start_us = now;
+	}
+
+	if (now < desc->due_us)
+		return -EAGAIN;
+
+	latency = now - desc->due_us;
+	if (period) {
+		/* The blocks ready while this one was waiting are lost */
+		lost = latency / period;
+		desc->overruns += lost;
+		desc->due_us += (lost + 1) * period;
+		latency -= lost * period;
+	} else {
+		latency = desc->blocks ? latency : 0;
+		desc->due_us = now;
+	}
+
+	ret = iio_buffer_get_block(buffer, &block);
+	if (ret)
+		return ret;
+
+	samples = block;
+	n = buffer->size / sizeof(*samples);
+	for (i = 0; i < n; i++)
+		samples[i] = desc->sample++;
+
+	ret = iio_buffer_block_done(buffer);
+	if (ret)
+		return ret;
+
+	desc->fill_us += iio_bench_source_now_us() - now;
+	desc->blocks++;
+	desc->bytes += buffer->size;
+	desc->latency_last_us = latency;
+	desc->latency_total_us += latency;
+	if (latency > desc->latency_max_us)
+		desc->latency_max_us = latency;
+
+	return 0;
+}
+
+/**
+ * @brief Show the sampling frequency.
+ * @param device - The source.
+ * @param buf - Where to write the value.
+ * @param len - Size of buf.
+ * @param channel - Unused.
+ * @param priv - Unused.
+ * @return length of the value, negative error code otherwise.
+ */
+static int iio_bench_source_freq_show(void *device, char *buf, uint32_t len,
+				      const struct iio_ch_info *channel,
+				      intptr_t priv)
+{
+	struct iio_bench_source *desc = device;
+	int32_t val = desc->sampling_frequency;
+
+	return iio_format_value(buf, len, IIO_VAL_INT, 1, &val);
+}
+
+/**
+ * @brief Set the sampling frequency, 0 for free running.
+ * @param device - The source.
+ * @param buf - The value.
+ * @param len - Length of the value.
+ * @param channel - Unused.
+ * @param priv - Unused.
+ * @return len in case of success, negative error code otherwise.
+ */
+static int iio_bench_source_freq_store(void *device, char *buf, uint32_t len,
+				       const struct iio_ch_info *channel,
+				       intptr_t priv)
+{
+	struct iio_bench_source *desc = device;
+	int32_t val, ret;
+
+	ret = iio_parse_value(buf, IIO_VAL_INT, &val, NULL);
+	if (ret < 0 || val < 0)
+		return -EINVAL;
+
+	desc->sampling_frequency = val;
+	iio_bench_source_reset(desc);
+
+	return len;
+}
+
+/**
+ * @brief Show the statistics since the buffer was started or the statistics
+ * reset, one "name value" pair per line. mb_per_s is the rate of the
+ * generated data and load_pct the share of the time spent generating it.
+ * @param device - The source.
+ * @param buf - Where to write the value.
+ * @param len - Size of buf.
+ * @param channel - Unused.
+ * @param priv - Unused.
+ * @return length of the value, negative error code otherwise.
+ */
+static int iio_bench_source_stats_show(void *device, char *buf, uint32_t len,
+				       const struct iio_ch_info *channel,
+				       intptr_t priv)
+{
+	struct iio_bench_source *desc = device;
+	uint64_t elapsed, rate, load;
+	int ret;
+
+	elapsed = iio_bench_source_now_us() - desc->start_us;
+	/* Bytes per microsecond are MB/s, kept with 2 decimals */
+	rate = elapsed ? desc->bytes * 100 / elapsed : 0;
+	load = elapsed ? desc->fill_us * 100 / elapsed : 0;
+
+	ret = snprintf(buf, len,
+		       "elapsed_us %"PRIu64"\nblocks %"PRIu32"\n"
+		       "bytes %"PRIu64"\nmb_per_s %"PRIu64".%02"PRIu64"\n"
+		       "overruns %"PRIu32"\nlatency_last_us %"PRIu32"\n"
+		       "latency_max_us %"PRIu32"\nlatency_avg_us %"PRIu64"\n"
+		       "fill_us %"PRIu64"\nload_pct %"PRIu64"\n",
+		       elapsed, desc->blocks, desc->bytes, rate / 100,
+		       rate % 100, desc->overruns, desc->latency_last_us,
+		       desc->latency_max_us,
+		       desc->blocks ? desc->latency_total_us / desc->blocks : 0,
+		       desc->fill_us, load);
+	if (ret < 0)
+		return ret;
+
+	return no_os_min((uint32_t)ret, len - 1);
+}
+
+/**
+ * @brief Clear the statistics, whatever the value.
+ * @param device - The source.
+ * @param buf - Unused.
+ * @param len - Length of the value.
+ * @param channel - Unused.
+ * @param priv - Unused.
+ * @return len.
+ */
+static int iio_bench_source_stats_store(void *device, char *buf, uint32_t len,
+					const struct iio_ch_info *channel,
+					intptr_t priv)
+{
+	iio_bench_source_reset(device);
+
+	return len;
+}
+
+static struct iio_attribute iio_bench_source_attrs[] = {
+	{
+		.name = "sampling_frequency",
+		.show = iio_bench_source_freq_show,
+		.store = iio_bench_source_freq_store,
+	},
+	{
+		.name = "bench_stats",
+		.show = iio_bench_source_stats_show,
+		.store = iio_bench_source_stats_store,
+	},
+	END_ATTRIBUTES_ARRAY
+};
+
+static struct scan_type iio_bench_source_scan_type = {
+	.sign = 'u',
+	.realbits = 16,
+	.storagebits = 16,
+};
+
+#define IIO_BENCH_SOURCE_CH(_idx) {			\
+	.ch_type = IIO_VOLTAGE,				\
+	.channel = _idx,				\
+	.scan_index = _idx,				\
+	.scan_type = &iio_bench_source_scan_type,	\
+	.indexed = true,				\
+}
+
+static struct iio_channel iio_bench_source_channels[IIO_BENCH_SOURCE_NB_CH] = {
+	IIO_BENCH_SOURCE_CH(0),
+	IIO_BENCH_SOURCE_CH(1),
+	IIO_BENCH_SOURCE_CH(2),
+	IIO_BENCH_SOURCE_CH(3),
+};
+
+struct iio_device iio_bench_source_descriptor = {
+	.num_ch = NO_OS_ARRAY_SIZE(iio_bench_source_channels),
+	.channels = iio_bench_source_channels,
+	.attributes = iio_bench_source_attrs,
+	.pre_enable = iio_bench_source_pre_enable,
+	.submit = iio_bench_source_submit,
+};
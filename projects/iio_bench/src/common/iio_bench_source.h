@@ -0,0 +1,117 @@
+/***************************************************************************//**
+ *   @file   iio_bench_source.h
+ *   @brief  Synthetic IIO source of the iio_bench project.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef _IIO_BENCH_SOURCE_H_
+#define _IIO_BENCH_SOURCE_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include "iio_types.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* 16-bit channels of the source */
+#define IIO_BENCH_SOURCE_NB_CH	4
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct iio_bench_source
+ * @brief Source of a 16-bit ramp, each sample being the previous one + 1.
+ * With a sampling frequency, blocks become ready at that rate, as with a
+ * DMA holding a single block: a block not read before the next one is ready
+ * is lost and counted as an overrun. With a sampling frequency of 0 the
+ * blocks are generated as fast as they are read.
+ */
+struct iio_bench_source {
+	/** Samples per second of each channel, 0 for free running */
+	uint32_t sampling_frequency;
+	/** Active channels */
+	uint32_t mask;
+	/** Next sample of the ramp */
+	uint16_t sample;
+	/** Time in microseconds of the reset of the statistics */
+	uint64_t start_us;
+	/** Time at which the next block is ready, 0 before the first one */
+	uint64_t due_us;
+	/** Blocks generated */
+	uint32_t blocks;
+	/** Bytes generated */
+	uint64_t bytes;
+	/** Blocks lost because they weren't read in time */
+	uint32_t overruns;
+	/**
+	 * Delay between a block being ready and being read, or between two
+	 * blocks when free running
+	 */
+	uint32_t latency_last_us;
+	uint32_t latency_max_us;
+	uint64_t latency_total_us;
+	/** Time spent generating the data */
+	uint64_t fill_us;
+};
+
+/**
+ * @struct iio_bench_source_init_param
+ * @brief Parameters of the synthetic source.
+ */
+struct iio_bench_source_init_param {
+	/** Initial sampling frequency, 0 for free running */
+	uint32_t sampling_frequency;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Allocate a synthetic source. */
+int32_t iio_bench_source_init(struct iio_bench_source **desc,
+			      struct iio_bench_source_init_param *param);
+
+/* Free a synthetic source. */
+int32_t iio_bench_source_remove(struct iio_bench_source *desc);
+
+extern struct iio_device iio_bench_source_descriptor;
+
+#endif // _IIO_BENCH_SOURCE_H_
@@ -0,0 +1,10 @@
+SRCS += $(PLATFORM_DRIVERS)/maxim_delay.c \
+	$(PLATFORM_DRIVERS)/maxim_irq.c \
+	$(PLATFORM_DRIVERS)/maxim_uart.c \
+	$(DRIVERS)/api/no_os_irq.c \
+	$(NO-OS)/util/no_os_lffifo.c
+
+INCS += $(PLATFORM_DRIVERS)/maxim_irq.h \
+	$(PLATFORM_DRIVERS)/maxim_uart.h \
+	$(INCLUDE)/no_os_irq.h \
+	$(INCLUDE)/no_os_rtc.h
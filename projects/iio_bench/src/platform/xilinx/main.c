@@ -0,0 +1,141 @@
+/***************************************************************************//**
+ *   @file   main.c
+ *   @brief  Main file of the iio_bench project for the xilinx platform.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "parameters.h"
+#include "iio_bench.h"
+#include "no_os_error.h"
+
+#ifdef NO_OS_LWIP_NETWORKING
+#include "no_os_delay.h"
+#include "lwip/init.h"
+#include "lwip/ip_addr.h"
+#include "lwip/tcp.h"
+#include "netif/xadapter.h"
+#endif
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+#ifdef NO_OS_LWIP_NETWORKING
+struct netif iio_bench_netif;
+#endif
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+#ifdef NO_OS_LWIP_NETWORKING
+/**
+ * @brief Process the received frames and run the TCP timers, every 250 ms
+ * for the fast one and 500 ms for the slow one.
+ * @param ctx - The netif.
+ */
+void iio_bench_lwip_poll(void *ctx)
+{
+	static uint32_t fast_ms, slow_ms;
+	struct no_os_time t = no_os_get_time();
+	uint32_t now = t.s * 1000 + t.us / 1000;
+
+	xemacif_input(ctx);
+
+	if (now - fast_ms >= 250) {
+		fast_ms = now;
+		tcp_fasttmr();
+	}
+	if (now - slow_ms >= 500) {
+		slow_ms = now;
+		tcp_slowtmr();
+	}
+}
+
+/**
+ * @brief Bring up lwIP and the Ethernet interface.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int iio_bench_lwip_setup(void)
+{
+	uint8_t mac[6] = IIO_BENCH_MAC;
+	ip_addr_t ip, mask, gw;
+
+	if (!ipaddr_aton(IIO_BENCH_IP, &ip) ||
+	    !ipaddr_aton(IIO_BENCH_NETMASK, &mask) ||
+	    !ipaddr_aton(IIO_BENCH_GATEWAY, &gw))
+		return -EINVAL;
+
+	lwip_init();
+	if (!xemac_add(&iio_bench_netif, &ip, &mask, &gw, mac,
+		       IIO_BENCH_EMAC_BASEADDR))
+		return -ENODEV;
+
+	netif_set_default(&iio_bench_netif);
+	netif_set_up(&iio_bench_netif);
+
+	return 0;
+}
+#endif
+
+/**
+ * @brief Main function execution for the xilinx platform, serving over UART,
+ * or over TCP with lwIP when built with NETWORKING=y LWIP_NETWORKING=y.
+ * @return Result of the application, which doesn't return if working
+ * correctly.
+ */
+int main()
+{
+	int ret;
+
+	/* Enable the instruction cache. */
+	Xil_ICacheEnable();
+	/* Enable the data cache. */
+	Xil_DCacheEnable();
+
+#ifdef NO_OS_LWIP_NETWORKING
+	ret = iio_bench_lwip_setup();
+	if (ret)
+		return ret;
+#endif
+
+	ret = iio_bench_main();
+
+	return ret;
+}
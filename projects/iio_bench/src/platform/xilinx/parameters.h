@@ -0,0 +1,83 @@
+/***************************************************************************//**
+ *   @file   parameters.h
+ *   @brief  Parameters of the iio_bench project for the xilinx platform.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef __PARAMETERS_H__
+#define __PARAMETERS_H__
+
+#include <xparameters.h>
+#include <xil_cache.h>
+
+#ifdef _XPARAMETERS_PS_H_
+#define UART_DEVICE_ID		XPAR_XUARTPS_0_DEVICE_ID
+#define INTC_DEVICE_ID		XPAR_SCUGIC_SINGLE_DEVICE_ID
+
+#ifdef XPS_BOARD_ZCU102
+#define UART_IRQ_ID		XPAR_XUARTPS_0_INTR
+#else
+#define UART_IRQ_ID		XPAR_XUARTPS_1_INTR
+#endif
+
+#else // _XPARAMETERS_PS_H_
+#define UART_DEVICE_ID	XPAR_AXI_UART_DEVICE_ID
+#define INTC_DEVICE_ID	XPAR_INTC_SINGLE_DEVICE_ID
+#define UART_IRQ_ID		XPAR_AXI_INTC_AXI_UART_INTERRUPT_INTR
+#endif // _XPARAMETERS_PS_H_
+
+#define UART_BAUDRATE		921600
+
+/* Memory of the device buffer, in DDR */
+#define IIO_BENCH_BUFFER_SIZE	(1024 * 1024)
+/* Initial sampling frequency, 0 generates the data as fast as it is read */
+#define IIO_BENCH_SAMPLING_FREQ	0
+
+#ifdef NO_OS_LWIP_NETWORKING
+#define IIO_BENCH_EMAC_BASEADDR	XPAR_XEMACPS_0_BASEADDR
+#define IIO_BENCH_MAC		{0x00, 0x0a, 0x35, 0x00, 0x01, 0x02}
+#define IIO_BENCH_IP		"192.168.1.10"
+#define IIO_BENCH_NETMASK	"255.255.255.0"
+#define IIO_BENCH_GATEWAY	"192.168.1.1"
+
+/* The netif is brought up in main and polled by the lwIP backend */
+struct netif;
+extern struct netif iio_bench_netif;
+void iio_bench_lwip_poll(void *ctx);
+
+#define IIO_APP_LWIP_POLL	iio_bench_lwip_poll
+#define IIO_APP_LWIP_POLL_CTX	&iio_bench_netif
+#endif
+
+#endif /* __PARAMETERS_H__ */
@@ -0,0 +1,24 @@
+SRCS += $(PLATFORM_DRIVERS)/$(PLATFORM)_delay.c \
+	$(PLATFORM_DRIVERS)/$(PLATFORM)_uart.c \
+	$(PLATFORM_DRIVERS)/$(PLATFORM)_irq.c \
+	$(DRIVERS)/api/no_os_irq.c \
+	$(NO-OS)/util/no_os_lffifo.c
+
+INCS += $(PLATFORM_DRIVERS)/$(PLATFORM)_irq.h \
+	$(PLATFORM_DRIVERS)/$(PLATFORM)_uart.h \
+	$(INCLUDE)/no_os_irq.h \
+	$(INCLUDE)/no_os_gpio.h \
+	$(INCLUDE)/no_os_rtc.h
+
+# TCP over the lwIP raw API, lwIP comes from the BSP
+ifeq (y,$(strip $(LWIP_NETWORKING)))
+CFLAGS += -DDISABLE_SECURE_SOCKET
+
+SRCS += $(NO-OS)/network/lwip_socket/lwip_socket.c \
+	$(NO-OS)/network/tcp_socket.c
+
+INCS += $(NO-OS)/network/lwip_socket/lwip_socket.h \
+	$(NO-OS)/network/tcp_socket.h \
+	$(NO-OS)/network/network_interface.h \
+	$(NO-OS)/network/noos_mbedtls_config.h
+endif
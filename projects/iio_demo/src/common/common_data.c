@@ -47,6 +47,35 @@
 /******************************************************************************/
 #ifdef ENABLE_LOOPBACK
 static uint16_t loopback_buffs[DEMO_CHANNELS][SAMPLES_PER_CHANNEL];
+
+/* 4 periods of full scale and half scale sines, in quadrature */
+#define DAC_DDS_FTW	(uint32_t)((4ull << 32) / SAMPLES_PER_CHANNEL)
+
+static struct no_os_dds dac_dds[] = {
+	{
+		.tones = {
+			{
+				.ftw = DAC_DDS_FTW,
+				.scale = NO_OS_DDS_FULL_SCALE - 1,
+			},
+		},
+		.nb_tones = 1,
+		.bits = 16,
+		.format = NO_OS_DDS_TWOS_COMPLEMENT,
+	},
+	{
+		.tones = {
+			{
+				.ftw = DAC_DDS_FTW,
+				.phase = NO_OS_DDS_PHASE_DEG(90),
+				.scale = NO_OS_DDS_FULL_SCALE / 2,
+			},
+		},
+		.nb_tones = 1,
+		.bits = 16,
+		.format = NO_OS_DDS_TWOS_COMPLEMENT,
+	},
+};
 #endif
 
 struct adc_demo_init_param adc_init_par = {
@@ -62,6 +91,10 @@ struct adc_demo_init_param adc_init_par = {
 struct dac_demo_init_param dac_init_par = {
 	.loopback_buffer_len = SAMPLES_PER_CHANNEL,
 	.loopback_buffers = (uint16_t **)loopback_buffs,
+#ifdef ENABLE_LOOPBACK
+	.dds = dac_dds,
+	.dds_nb_ch = NO_OS_ARRAY_SIZE(dac_dds),
+#endif
 	.dev_global_attr = 4444,
 	.dev_ch_attr = {
 		1111, 1112, 1113, 1114, 1115, 1116, 1117, 1118,
@@ -18,4 +18,4 @@ INCS += $(INCLUDE)/no_os_irq.h
 SRCS += $(DRIVERS)/api/no_os_irq.c
 SRCS += $(DRIVERS)/api/no_os_timer.c
 
-SRCS += $(NO-OS)/util/no_os_lf256fifo.c
+SRCS += $(NO-OS)/util/no_os_lffifo.c
@@ -13,6 +13,6 @@ SRCS += $(PLATFORM_DRIVERS)/stm32_delay.c     \
 
 ICNS += $(INCLUDE)/no_os_irq.h
 
-SRCS += $(NO-OS)/util/no_os_lf256fifo.c \
+SRCS += $(NO-OS)/util/no_os_lffifo.c \
         $(DRIVERS)/api/no_os_timer.c    \
         $(DRIVERS)/api/no_os_irq.c
@@ -24,12 +24,12 @@ INCS += $(INCLUDE)/no_os_delay.h        \
         $(INCLUDE)/no_os_list.h         \
         $(INCLUDE)/no_os_uart.h         \
         $(INCLUDE)/no_os_timer.h        \
-        $(INCLUDE)/no_os_lf256fifo.h    \
+        $(INCLUDE)/no_os_lffifo.h    \
         $(INCLUDE)/no_os_util.h         \
         $(INCLUDE)/no_os_units.h
 
 SRCS += $(DRIVERS)/api/no_os_gpio.c     \
-        $(NO-OS)/util/no_os_lf256fifo.c \
+        $(NO-OS)/util/no_os_lffifo.c \
         $(DRIVERS)/api/no_os_irq.c      \
         $(DRIVERS)/api/no_os_timer.c    \
         $(DRIVERS)/api/no_os_spi.c      \
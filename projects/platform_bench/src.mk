@@ -0,0 +1,29 @@
+SRCS += $(PROJECT)/src/common/common_data.c \
+	$(PROJECT)/src/common/platform_bench.c
+
+INCS += $(PROJECT)/src/common/bench_counter.h \
+	$(PROJECT)/src/common/common_data.h \
+	$(PROJECT)/src/common/platform_bench.h
+
+SRCS += $(DRIVERS)/api/no_os_gpio.c \
+	$(DRIVERS)/api/no_os_i2c.c \
+	$(DRIVERS)/api/no_os_irq.c \
+	$(DRIVERS)/api/no_os_spi.c \
+	$(DRIVERS)/api/no_os_uart.c \
+	$(NO-OS)/util/no_os_fifo.c \
+	$(NO-OS)/util/no_os_list.c \
+	$(NO-OS)/util/no_os_lffifo.c \
+	$(NO-OS)/util/no_os_util.c
+
+INCS += $(INCLUDE)/no_os_delay.h \
+	$(INCLUDE)/no_os_error.h \
+	$(INCLUDE)/no_os_fifo.h \
+	$(INCLUDE)/no_os_gpio.h \
+	$(INCLUDE)/no_os_i2c.h \
+	$(INCLUDE)/no_os_irq.h \
+	$(INCLUDE)/no_os_lffifo.h \
+	$(INCLUDE)/no_os_list.h \
+	$(INCLUDE)/no_os_spi.h \
+	$(INCLUDE)/no_os_trace.h \
+	$(INCLUDE)/no_os_uart.h \
+	$(INCLUDE)/no_os_util.h
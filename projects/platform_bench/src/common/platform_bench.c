@@ -0,0 +1,486 @@
+/***************************************************************************//**
+ *   @file   platform_bench.c
+ *   @brief  Cycle count benchmarks of the platform drivers.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include "no_os_error.h"
+#include "no_os_delay.h"
+#include "no_os_util.h"
+#include "common_data.h"
+#include "bench_counter.h"
+#include "platform_bench.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/* Counter ticks of the calls of a result */
+struct platform_bench_stats {
+	uint32_t min;
+	uint32_t max;
+	uint64_t total;
+};
+
+/* Peripherals and buffers of the benchmarks */
+struct platform_bench_desc {
+	struct no_os_spi_desc *spi;
+	struct no_os_i2c_desc *i2c;
+	struct no_os_gpio_desc *gpio_out;
+	struct no_os_gpio_desc *gpio_in;
+	struct no_os_irq_ctrl_desc *gpio_irq;
+	uint8_t tx[PLATFORM_BENCH_MAX_LEN];
+	uint8_t rx[PLATFORM_BENCH_MAX_LEN];
+	/* Value last written by the GPIO case */
+	uint8_t gpio_value;
+	/* Ticks of a measurement of an empty call, subtracted from results */
+	uint32_t overhead;
+	uint32_t cpu_hz;
+	uint32_t counter_hz;
+	/* Set until the first result is printed */
+	bool first;
+	/* Counter value read by the interrupt callback */
+	volatile uint32_t irq_stamp;
+	volatile bool irq_done;
+};
+
+/* Call measured, len being the number of bytes transferred */
+typedef int32_t (*platform_bench_op)(struct platform_bench_desc *desc,
+				     uint32_t len);
+
+/* A function measured across transfer sizes */
+struct platform_bench_case {
+	const char *name;
+	platform_bench_op op;
+	const uint32_t *lens;
+	uint32_t nb_lens;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Empty call, measured to remove the cost of the measurement.
+ * @param desc - The benchmark descriptor.
+ * @param len - Not used.
+ * @return 0.
+ */
+static int32_t platform_bench_nop(struct platform_bench_desc *desc,
+				  uint32_t len)
+{
+	return 0;
+}
+
+/**
+ * @brief Full duplex SPI transfer in place.
+ * @param desc - The benchmark descriptor.
+ * @param len - Number of bytes.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t platform_bench_spi_write_and_read(struct platform_bench_desc
+		*desc, uint32_t len)
+{
+	return no_os_spi_write_and_read(desc->spi, desc->tx, len);
+}
+
+/**
+ * @brief SPI transfer of a single message with separate buffers.
+ * @param desc - The benchmark descriptor.
+ * @param len - Number of bytes.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t platform_bench_spi_transfer(struct platform_bench_desc *desc,
+		uint32_t len)
+{
+	struct no_os_spi_msg msg = {
+		.tx_buff = desc->tx,
+		.rx_buff = desc->rx,
+		.bytes_number = len,
+		.cs_change = 1,
+	};
+
+	return no_os_spi_transfer(desc->spi, &msg, 1);
+}
+
+/**
+ * @brief I2C write ended by a stop condition.
+ * @param desc - The benchmark descriptor.
+ * @param len - Number of bytes.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t platform_bench_i2c_write(struct platform_bench_desc *desc,
+					uint32_t len)
+{
+	return no_os_i2c_write(desc->i2c, desc->tx, len, 1);
+}
+
+/**
+ * @brief Toggle the GPIO output.
+ * @param desc - The benchmark descriptor.
+ * @param len - Not used.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t platform_bench_gpio_set_value(struct platform_bench_desc *desc,
+		uint32_t len)
+{
+	desc->gpio_value ^= 1;
+
+	return no_os_gpio_set_value(desc->gpio_out, desc->gpio_value);
+}
+
+/**
+ * @brief Add a measurement to the statistics of a result.
+ * @param stats - The statistics.
+ * @param ticks - Duration of the call.
+ */
+static void platform_bench_add(struct platform_bench_stats *stats,
+			       uint32_t ticks)
+{
+	stats->min = no_os_min(stats->min, ticks);
+	stats->max = no_os_max(stats->max, ticks);
+	stats->total += ticks;
+}
+
+/**
+ * @brief Measure PLATFORM_BENCH_CALLS calls of op, each one on its own so the
+ * counter doesn't wrap during a measurement.
+ * @param desc - The benchmark descriptor.
+ * @param op - The call.
+ * @param len - Number of bytes of each call.
+ * @param stats - Where to store the durations.
+ * @return 0 in case of success, the error of the call otherwise.
+ */
+static int32_t platform_bench_measure(struct platform_bench_desc *desc,
+				      platform_bench_op op, uint32_t len,
+				      struct platform_bench_stats *stats)
+{
+	uint32_t i, start, ticks;
+	int32_t ret;
+
+	stats->min = UINT32_MAX;
+	stats->max = 0;
+	stats->total = 0;
+	for (i = 0; i < PLATFORM_BENCH_CALLS; i++) {
+		start = bench_counter_read();
+		ret = op(desc, len);
+		ticks = (bench_counter_read() - start) & BENCH_COUNTER_MASK;
+		if (ret)
+			return ret;
+
+		ticks = ticks > desc->overhead ? ticks - desc->overhead : 0;
+		platform_bench_add(stats, ticks);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Convert counter ticks to CPU cycles.
+ * @param desc - The benchmark descriptor.
+ * @param ticks - Counter ticks.
+ * @return the number of CPU cycles.
+ */
+static uint32_t platform_bench_cycles(struct platform_bench_desc *desc,
+				      uint64_t ticks)
+{
+	return no_os_div_u64(ticks * desc->cpu_hz, desc->counter_hz);
+}
+
+/**
+ * @brief Print a result as an element of the JSON results array.
+ * @param desc - The benchmark descriptor.
+ * @param name - Name of the function measured.
+ * @param len - Number of bytes of each call.
+ * @param stats - Durations of the calls.
+ * @param err - Error of the measurement, stats is not used if set.
+ */
+static void platform_bench_print(struct platform_bench_desc *desc,
+				 const char *name, uint32_t len,
+				 struct platform_bench_stats *stats,
+				 int32_t err)
+{
+	uint64_t total = stats->total;
+	uint64_t bytes = (uint64_t)len * PLATFORM_BENCH_CALLS;
+
+	printf("%s\n    {\"name\": \"%s\", \"bytes\": %"PRIu32,
+	       desc->first ? "" : ",", name, len);
+	desc->first = false;
+
+	if (err) {
+		printf(", \"error\": %"PRIi32"}", err);
+		return;
+	}
+
+	printf(", \"cycles_min\": %"PRIu32", \"cycles_avg\": %"PRIu32
+	       ", \"cycles_max\": %"PRIu32,
+	       platform_bench_cycles(desc, stats->min),
+	       platform_bench_cycles(desc, total / PLATFORM_BENCH_CALLS),
+	       platform_bench_cycles(desc, stats->max));
+	if (len && total)
+		printf(", \"bytes_per_s\": %"PRIu32,
+		       (uint32_t)(bytes * desc->counter_hz / total));
+	printf("}");
+}
+
+/**
+ * @brief Interrupt callback, taking the timestamp of the entry.
+ * @param ctx - The benchmark descriptor.
+ */
+static void platform_bench_irq_cb(void *ctx)
+{
+	struct platform_bench_desc *desc = ctx;
+
+	desc->irq_stamp = bench_counter_read();
+	desc->irq_done = true;
+}
+
+/**
+ * @brief Interrupt callback of the platforms using the legacy callbacks.
+ * @param ctx - The benchmark descriptor.
+ * @param event - Not used.
+ * @param extra - Not used.
+ */
+static void platform_bench_irq_legacy_cb(void *ctx, uint32_t event,
+		void *extra)
+{
+	platform_bench_irq_cb(ctx);
+}
+
+/**
+ * @brief Measure the interrupt entry: from raising the GPIO output, wired to
+ * the interrupt input, to the no-OS callback. The no_os_gpio_set_value call is
+ * part of the measurement.
+ * @param desc - The benchmark descriptor.
+ * @param stats - Where to store the durations.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t platform_bench_irq(struct platform_bench_desc *desc,
+				  struct platform_bench_stats *stats)
+{
+	uint32_t i, start, timeout;
+	uint32_t mask = BENCH_COUNTER_MASK;
+	int32_t ret;
+
+	timeout = desc->counter_hz / 1000 * PLATFORM_BENCH_IRQ_TIMEOUT_MS;
+	stats->min = UINT32_MAX;
+	stats->max = 0;
+	stats->total = 0;
+	for (i = 0; i < PLATFORM_BENCH_CALLS; i++) {
+		ret = no_os_gpio_set_value(desc->gpio_out, NO_OS_GPIO_LOW);
+		if (ret)
+			return ret;
+		no_os_udelay(100);
+
+		desc->irq_done = false;
+		start = bench_counter_read();
+		ret = no_os_gpio_set_value(desc->gpio_out, NO_OS_GPIO_HIGH);
+		if (ret)
+			return ret;
+
+		while (!desc->irq_done)
+			if (((bench_counter_read() - start) & mask) > timeout)
+				return -ETIMEDOUT;
+
+		platform_bench_add(stats, (desc->irq_stamp - start) & mask);
+	}
+	desc->gpio_value = NO_OS_GPIO_HIGH;
+
+	return 0;
+}
+
+/**
+ * @brief Configure the interrupt on the rising edges of the GPIO input.
+ * @param desc - The benchmark descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t platform_bench_irq_init(struct platform_bench_desc *desc)
+{
+	struct no_os_callback_desc cb = {
+		.callback = platform_bench_irq_cb,
+		.legacy_callback = platform_bench_irq_legacy_cb,
+		.ctx = desc,
+		.event = NO_OS_EVT_GPIO,
+		.peripheral = NO_OS_GPIO_IRQ,
+		.handle = GPIO_IRQ_CB_HANDLE,
+	};
+	int32_t ret;
+
+	ret = no_os_irq_ctrl_init(&desc->gpio_irq, &bench_gpio_irq_ip);
+	if (ret)
+		return ret;
+
+	/* Some platforms apply the trigger level when registering */
+	ret = no_os_irq_trigger_level_set(desc->gpio_irq, GPIO_IRQ_ID,
+					  NO_OS_IRQ_EDGE_RISING);
+	if (ret)
+		return ret;
+
+	ret = no_os_irq_register_callback(desc->gpio_irq, GPIO_IRQ_ID, &cb);
+	if (ret)
+		return ret;
+
+	return no_os_irq_enable(desc->gpio_irq, GPIO_IRQ_ID);
+}
+
+/**
+ * @brief Run the benchmarks and print the results as JSON. The SPI transfers
+ * need no device, the I2C ones need a device acknowledging I2C_ADDR and the
+ * interrupt one the output wired to the input. A failing result is printed
+ * with its error and the next ones are still measured.
+ * @return 0 if all the results were measured, the last error otherwise.
+ */
+int platform_bench_main(void)
+{
+	static const uint32_t spi_lens[] = {
+		1, 2, 4, 8, 16, 64, 256, 1024, PLATFORM_BENCH_MAX_LEN
+	};
+	static const uint32_t i2c_lens[] = {1, 2, 4, 8, 16, 64, 255};
+	static const uint32_t gpio_lens[] = {0};
+	static const struct platform_bench_case cases[] = {
+		{
+			"spi_write_and_read", platform_bench_spi_write_and_read,
+			spi_lens, NO_OS_ARRAY_SIZE(spi_lens)
+		},
+		{
+			"spi_transfer", platform_bench_spi_transfer,
+			spi_lens, NO_OS_ARRAY_SIZE(spi_lens)
+		},
+		{
+			"i2c_write", platform_bench_i2c_write,
+			i2c_lens, NO_OS_ARRAY_SIZE(i2c_lens)
+		},
+		{
+			"gpio_set_value", platform_bench_gpio_set_value,
+			gpio_lens, NO_OS_ARRAY_SIZE(gpio_lens)
+		},
+	};
+	static struct platform_bench_desc desc;
+	struct platform_bench_stats stats;
+	int32_t ret, err = 0;
+	uint32_t i, j, len;
+
+	ret = bench_counter_init();
+	if (ret)
+		return ret;
+
+	desc.cpu_hz = bench_cpu_freq();
+	desc.counter_hz = bench_counter_freq();
+	desc.first = true;
+	for (i = 0; i < PLATFORM_BENCH_MAX_LEN; i++)
+		desc.tx[i] = i;
+
+	ret = no_os_spi_init(&desc.spi, &bench_spi_ip);
+	if (ret)
+		return ret;
+
+	ret = no_os_i2c_init(&desc.i2c, &bench_i2c_ip);
+	if (ret)
+		goto remove_spi;
+
+	ret = no_os_gpio_get(&desc.gpio_out, &bench_gpio_out_ip);
+	if (ret)
+		goto remove_i2c;
+
+	ret = no_os_gpio_direction_output(desc.gpio_out, NO_OS_GPIO_LOW);
+	if (ret)
+		goto remove_gpio_out;
+
+	ret = no_os_gpio_get(&desc.gpio_in, &bench_gpio_in_ip);
+	if (ret)
+		goto remove_gpio_out;
+
+	ret = no_os_gpio_direction_input(desc.gpio_in);
+	if (ret)
+		goto remove_gpio_in;
+
+	ret = platform_bench_irq_init(&desc);
+	if (ret)
+		goto remove_irq;
+
+	ret = platform_bench_measure(&desc, platform_bench_nop, 0, &stats);
+	if (ret)
+		goto remove_irq;
+	desc.overhead = stats.min;
+
+	printf("{\"platform\": \"%s\", \"cpu_hz\": %"PRIu32
+	       ", \"counter_hz\": %"PRIu32", \"calls\": %d"
+	       ", \"overhead_cycles\": %"PRIu32", \"results\": [",
+	       BENCH_PLATFORM, desc.cpu_hz, desc.counter_hz,
+	       PLATFORM_BENCH_CALLS,
+	       platform_bench_cycles(&desc, desc.overhead));
+
+	for (i = 0; i < NO_OS_ARRAY_SIZE(cases); i++) {
+		for (j = 0; j < cases[i].nb_lens; j++) {
+			len = cases[i].lens[j];
+			ret = platform_bench_measure(&desc, cases[i].op, len,
+						     &stats);
+			platform_bench_print(&desc, cases[i].name, len, &stats,
+					     ret);
+			if (ret)
+				err = ret;
+		}
+	}
+
+	ret = platform_bench_irq(&desc, &stats);
+	platform_bench_print(&desc, "gpio_irq_latency", 0, &stats, ret);
+	if (ret)
+		err = ret;
+	printf("\n]}\n");
+	ret = err;
+
+remove_irq:
+	if (desc.gpio_irq) {
+		no_os_irq_disable(desc.gpio_irq, GPIO_IRQ_ID);
+		no_os_irq_ctrl_remove(desc.gpio_irq);
+	}
+remove_gpio_in:
+	no_os_gpio_remove(desc.gpio_in);
+remove_gpio_out:
+	no_os_gpio_remove(desc.gpio_out);
+remove_i2c:
+	no_os_i2c_remove(desc.i2c);
+remove_spi:
+	no_os_spi_remove(desc.spi);
+
+	return ret;
+}
@@ -0,0 +1,7 @@
+SRC_DIRS += $(PLATFORM_DRIVERS)
+SRC_DIRS += $(INCLUDE)
+
+SRCS += $(PROJECT)/src/platform/$(PLATFORM)/bench_counter.c \
+	$(DRIVERS)/api/no_os_timer.c
+
+INCS += $(INCLUDE)/no_os_timer.h
@@ -0,0 +1,103 @@
+/***************************************************************************//**
+ *   @file   parameters.h
+ *   @brief  Parameters of platform_bench for the maxim platform.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef __PARAMETERS_H__
+#define __PARAMETERS_H__
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "maxim_irq.h"
+#include "maxim_spi.h"
+#include "maxim_i2c.h"
+#include "maxim_gpio.h"
+#include "maxim_gpio_irq.h"
+#include "maxim_uart.h"
+#include "maxim_uart_stdio.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#if (TARGET_NUM != 32655)
+#error PIN and PORT configuration have to be adapted for the used target.
+#endif
+
+#define BENCH_PLATFORM		"maxim"
+/* DWT cycle counter */
+#define BENCH_COUNTER_MASK	0xffffffff
+
+#define UART_DEVICE_ID		0
+#define UART_IRQ_ID		UART0_IRQn
+#define UART_BAUDRATE		115200
+
+#define SPI_DEVICE_ID		0
+#define SPI_BAUDRATE		10000000
+#define SPI_CS			0
+#define SPI_OPS			&max_spi_ops
+#define SPI_EXTRA		&bench_spi_extra_ip
+
+#define I2C_DEVICE_ID		1
+#define I2C_BAUDRATE		400000
+/* Device acknowledging the writes of the i2c_write results */
+#define I2C_ADDR		0x48
+#define I2C_OPS			&max_i2c_ops
+#define I2C_EXTRA		&bench_i2c_extra_ip
+
+/* P1.8 drives P1.9, connect them for gpio_irq_latency */
+#define GPIO_OPS		&max_gpio_ops
+#define GPIO_OUT_PORT		1
+#define GPIO_OUT_PIN		8
+#define GPIO_OUT_EXTRA		&bench_gpio_extra_ip
+#define GPIO_IN_PORT		1
+#define GPIO_IN_PIN		9
+#define GPIO_IN_EXTRA		&bench_gpio_extra_ip
+
+/* One controller per port, the interrupts are selected by the pin number */
+#define NVIC_GPIO_IRQ		GPIO1_IRQn
+#define GPIO_IRQ_CTRL_ID	GPIO_IN_PORT
+#define GPIO_IRQ_ID		GPIO_IN_PIN
+#define GPIO_IRQ_OPS		&max_gpio_irq_ops
+#define GPIO_IRQ_EXTRA		&bench_gpio_extra_ip
+#define GPIO_IRQ_CB_HANDLE	MXC_GPIO_GET_GPIO(GPIO_IN_PORT)
+
+extern struct max_spi_init_param bench_spi_extra_ip;
+extern struct max_i2c_init_param bench_i2c_extra_ip;
+extern struct max_gpio_init_param bench_gpio_extra_ip;
+
+#endif /* __PARAMETERS_H__ */
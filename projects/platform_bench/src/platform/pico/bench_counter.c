@@ -0,0 +1,93 @@
+/***************************************************************************//**
+ *   @file   bench_counter.c
+ *   @brief  Benchmark counter of the pico platform.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "hardware/clocks.h"
+#include "hardware/structs/systick.h"
+#include "parameters.h"
+#include "bench_counter.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Start SysTick free running on the processor clock, without
+ * interrupt. It wraps every 2^24 cycles, 134 ms at 125 MHz.
+ * @return 0.
+ */
+int32_t bench_counter_init(void)
+{
+	systick_hw->csr = 0;
+	systick_hw->rvr = BENCH_COUNTER_MASK;
+	systick_hw->cvr = 0;
+	/* CLKSOURCE and ENABLE */
+	systick_hw->csr = 0x5;
+
+	return 0;
+}
+
+/**
+ * @brief Read SysTick, which counts down.
+ * @return the number of CPU cycles since bench_counter_init(), modulo 2^24.
+ */
+uint32_t bench_counter_read(void)
+{
+	return ~systick_hw->cvr & BENCH_COUNTER_MASK;
+}
+
+/**
+ * @brief Get the frequency of the counter, the processor clock.
+ * @return the frequency in Hz.
+ */
+uint32_t bench_counter_freq(void)
+{
+	return clock_get_hz(clk_sys);
+}
+
+/**
+ * @brief Get the frequency of the CPU.
+ * @return the frequency in Hz.
+ */
+uint32_t bench_cpu_freq(void)
+{
+	return clock_get_hz(clk_sys);
+}
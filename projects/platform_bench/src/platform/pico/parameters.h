@@ -0,0 +1,96 @@
+/***************************************************************************//**
+ *   @file   parameters.h
+ *   @brief  Parameters of platform_bench for the pico platform.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef __PARAMETERS_H__
+#define __PARAMETERS_H__
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "pico_uart.h"
+#include "pico_spi.h"
+#include "pico_i2c.h"
+#include "pico_gpio.h"
+#include "pico_gpio_irq.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define BENCH_PLATFORM		"pico"
+/* SysTick, the Cortex-M0+ has no cycle counter */
+#define BENCH_COUNTER_MASK	0xffffff
+
+#define UART_DEVICE_ID		0
+#define UART_IRQ_ID		20
+#define UART_BAUDRATE		115200
+#define UART_TX_PIN		UART0_TX_GP0
+#define UART_RX_PIN		UART0_RX_GP1
+
+#define SPI_DEVICE_ID		0
+#define SPI_BAUDRATE		10000000
+#define SPI_CS			SPI0_CS_GP17
+#define SPI_OPS			&pico_spi_ops
+#define SPI_EXTRA		&bench_spi_extra_ip
+
+#define I2C_DEVICE_ID		0
+#define I2C_BAUDRATE		400000
+/* Device acknowledging the writes of the i2c_write results */
+#define I2C_ADDR		0x48
+#define I2C_OPS			&pico_i2c_ops
+#define I2C_EXTRA		&bench_i2c_extra_ip
+
+/* GP20 drives GP21, connect them for gpio_irq_latency */
+#define GPIO_OPS		&pico_gpio_ops
+#define GPIO_OUT_PORT		0 /* Not used for pico platform */
+#define GPIO_OUT_PIN		20
+#define GPIO_OUT_EXTRA		NULL /* Not used for pico platform */
+#define GPIO_IN_PORT		0 /* Not used for pico platform */
+#define GPIO_IN_PIN		21
+#define GPIO_IN_EXTRA		NULL /* Not used for pico platform */
+
+#define GPIO_IRQ_CTRL_ID	0
+#define GPIO_IRQ_ID		GPIO_IN_PIN
+#define GPIO_IRQ_OPS		&pico_gpio_irq_ops
+#define GPIO_IRQ_EXTRA		NULL /* Not used for pico platform */
+#define GPIO_IRQ_CB_HANDLE	NULL /* Not used for pico platform */
+
+extern struct pico_spi_init_param bench_spi_extra_ip;
+extern struct pico_i2c_init_param bench_i2c_extra_ip;
+
+#endif /* __PARAMETERS_H__ */
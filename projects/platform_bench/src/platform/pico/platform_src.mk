@@ -0,0 +1,15 @@
+SRCS += $(PROJECT)/src/platform/$(PLATFORM)/bench_counter.c \
+	$(PLATFORM_DRIVERS)/pico_delay.c \
+	$(PLATFORM_DRIVERS)/pico_gpio.c \
+	$(PLATFORM_DRIVERS)/pico_gpio_irq.c \
+	$(PLATFORM_DRIVERS)/pico_i2c.c \
+	$(PLATFORM_DRIVERS)/pico_irq.c \
+	$(PLATFORM_DRIVERS)/pico_spi.c \
+	$(PLATFORM_DRIVERS)/pico_uart.c
+
+INCS += $(PLATFORM_DRIVERS)/pico_gpio.h \
+	$(PLATFORM_DRIVERS)/pico_gpio_irq.h \
+	$(PLATFORM_DRIVERS)/pico_i2c.h \
+	$(PLATFORM_DRIVERS)/pico_irq.h \
+	$(PLATFORM_DRIVERS)/pico_spi.h \
+	$(PLATFORM_DRIVERS)/pico_uart.h
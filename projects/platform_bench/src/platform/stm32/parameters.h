@@ -0,0 +1,102 @@
+/***************************************************************************//**
+ *   @file   parameters.h
+ *   @brief  Parameters of platform_bench for the stm32 platform.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef __PARAMETERS_H__
+#define __PARAMETERS_H__
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "stm32_hal.h"
+#include "stm32_spi.h"
+#include "stm32_i2c.h"
+#include "stm32_gpio.h"
+#include "stm32_gpio_irq.h"
+#include "stm32_uart.h"
+#include "stm32_uart_stdio.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define BENCH_PLATFORM		"stm32"
+/* DWT cycle counter */
+#define BENCH_COUNTER_MASK	0xffffffff
+
+/* Pins configured by sdp-ck1z.ioc */
+extern UART_HandleTypeDef huart5;
+#define UART_DEVICE_ID		5
+#define UART_IRQ_ID		UART5_IRQn
+#define UART_BAUDRATE		115200
+
+#define SPI_DEVICE_ID		1
+#define SPI_BAUDRATE		10000000
+#define SPI_CS			15
+#define SPI_CS_PORT		GPIOA
+#define SPI_OPS			&stm32_spi_ops
+#define SPI_EXTRA		&bench_spi_extra_ip
+
+#define I2C_DEVICE_ID		1
+#define I2C_BAUDRATE		400000
+/* Device acknowledging the writes of the i2c_write results */
+#define I2C_ADDR		0x48
+#define I2C_OPS			&stm32_i2c_ops
+#define I2C_EXTRA		NULL
+
+/* PD12 drives PG7, connect them for gpio_irq_latency */
+#define GPIO_OPS		&stm32_gpio_ops
+#define GPIO_OUT_PORT		3
+#define GPIO_OUT_PIN		12
+#define GPIO_OUT_EXTRA		&bench_gpio_out_extra_ip
+#define GPIO_IN_PORT		6
+#define GPIO_IN_PIN		7
+#define GPIO_IN_EXTRA		&bench_gpio_in_extra_ip
+
+/* The EXTI line is selected by the pin number */
+#define GPIO_IRQ_CTRL_ID	GPIO_IN_PIN
+#define GPIO_IRQ_ID		0
+#define GPIO_IRQ_OPS		&stm32_gpio_irq_ops
+#define GPIO_IRQ_EXTRA		&bench_gpio_irq_extra_ip
+#define GPIO_IRQ_CB_HANDLE	NULL
+
+extern struct stm32_spi_init_param bench_spi_extra_ip;
+extern struct stm32_gpio_init_param bench_gpio_out_extra_ip;
+extern struct stm32_gpio_init_param bench_gpio_in_extra_ip;
+extern struct stm32_gpio_irq_init_param bench_gpio_irq_extra_ip;
+
+#endif /* __PARAMETERS_H__ */
@@ -0,0 +1,16 @@
+SRCS += $(PROJECT)/src/platform/$(PLATFORM)/bench_counter.c \
+	$(PLATFORM_DRIVERS)/stm32_delay.c \
+	$(PLATFORM_DRIVERS)/stm32_gpio.c \
+	$(PLATFORM_DRIVERS)/stm32_gpio_irq.c \
+	$(PLATFORM_DRIVERS)/stm32_i2c.c \
+	$(PLATFORM_DRIVERS)/stm32_spi.c \
+	$(PLATFORM_DRIVERS)/stm32_uart.c \
+	$(PLATFORM_DRIVERS)/stm32_uart_stdio.c
+
+INCS += $(PLATFORM_DRIVERS)/stm32_gpio.h \
+	$(PLATFORM_DRIVERS)/stm32_gpio_irq.h \
+	$(PLATFORM_DRIVERS)/stm32_hal.h \
+	$(PLATFORM_DRIVERS)/stm32_i2c.h \
+	$(PLATFORM_DRIVERS)/stm32_spi.h \
+	$(PLATFORM_DRIVERS)/stm32_uart.h \
+	$(PLATFORM_DRIVERS)/stm32_uart_stdio.h
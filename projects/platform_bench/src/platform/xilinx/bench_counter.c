@@ -0,0 +1,110 @@
+/***************************************************************************//**
+ *   @file   bench_counter.c
+ *   @brief  Benchmark counter of the xilinx platform.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "xparameters.h"
+#ifdef _XPARAMETERS_PS_H_
+#include "xtime_l.h"
+#endif
+#include "no_os_error.h"
+#include "bench_counter.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Check that the global timer is available, it runs since the boot.
+ * @return 0 in case of success, -ENOSYS on MicroBlaze.
+ */
+int32_t bench_counter_init(void)
+{
+#ifdef _XPARAMETERS_PS_H_
+	return 0;
+#else
+	return -ENOSYS;
+#endif
+}
+
+/**
+ * @brief Read the global timer.
+ * @return the low 32 bits of the timer.
+ */
+uint32_t bench_counter_read(void)
+{
+#ifdef _XPARAMETERS_PS_H_
+	XTime t;
+
+	XTime_GetTime(&t);
+
+	return (uint32_t)t;
+#else
+	return 0;
+#endif
+}
+
+/**
+ * @brief Get the frequency of the global timer, half the CPU clock on Zynq.
+ * @return the frequency in Hz.
+ */
+uint32_t bench_counter_freq(void)
+{
+#ifdef _XPARAMETERS_PS_H_
+	return COUNTS_PER_SECOND;
+#else
+	return 1;
+#endif
+}
+
+/**
+ * @brief Get the frequency of the CPU.
+ * @return the frequency in Hz.
+ */
+uint32_t bench_cpu_freq(void)
+{
+#if defined(XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ)
+	return XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ;
+#elif defined(XPAR_CPU_CORTEXA53_0_CPU_CLK_FREQ_HZ)
+	return XPAR_CPU_CORTEXA53_0_CPU_CLK_FREQ_HZ;
+#else
+	return bench_counter_freq();
+#endif
+}
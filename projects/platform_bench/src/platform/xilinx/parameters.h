@@ -0,0 +1,98 @@
+/***************************************************************************//**
+ *   @file   parameters.h
+ *   @brief  Parameters of platform_bench for the xilinx platform.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef __PARAMETERS_H__
+#define __PARAMETERS_H__
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "xparameters.h"
+#include "xilinx_spi.h"
+#include "xilinx_i2c.h"
+#include "xilinx_gpio.h"
+#include "xilinx_gpio_irq.h"
+#include "xilinx_irq.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define BENCH_PLATFORM		"xilinx"
+/* Low 32 bits of the global timer */
+#define BENCH_COUNTER_MASK	0xffffffff
+
+#define INTC_DEVICE_ID		XPAR_SCUGIC_SINGLE_DEVICE_ID
+
+#define SPI_DEVICE_ID		XPAR_PS7_SPI_0_DEVICE_ID
+#define SPI_BAUDRATE		10000000
+#define SPI_CS			0
+#define SPI_OPS			&xil_spi_ops
+#define SPI_EXTRA		&bench_spi_extra_ip
+
+#define I2C_DEVICE_ID		XPAR_AXI_IIC_MAIN_DEVICE_ID
+#define I2C_BAUDRATE		400000
+/* ADV7511 of the ZedBoard, acknowledging the i2c_write results */
+#define I2C_ADDR		0x39
+#define I2C_OPS			&xil_i2c_ops
+#define I2C_EXTRA		&bench_i2c_extra_ip
+
+/* EMIO 32 drives EMIO 33, connect them for gpio_irq_latency */
+#define GPIO_OFFSET		54
+#define GPIO_OPS		&xil_gpio_ops
+#define GPIO_OUT_PORT		0
+#define GPIO_OUT_PIN		(GPIO_OFFSET + 32)
+#define GPIO_OUT_EXTRA		&bench_gpio_extra_ip
+#define GPIO_IN_PORT		0
+#define GPIO_IN_PIN		(GPIO_OFFSET + 33)
+#define GPIO_IN_EXTRA		&bench_gpio_extra_ip
+
+/* Interrupt of the PS GPIO on the GIC, the pins are selected by number */
+#define GPIO_IRQ_CTRL_ID	XPAR_XGPIOPS_0_INTR
+#define GPIO_IRQ_ID		GPIO_IN_PIN
+#define GPIO_IRQ_OPS		&xil_gpio_irq_ops
+#define GPIO_IRQ_EXTRA		&bench_gpio_irq_extra_ip
+#define GPIO_IRQ_CB_HANDLE	NULL
+
+extern struct xil_spi_init_param bench_spi_extra_ip;
+extern struct xil_i2c_init_param bench_i2c_extra_ip;
+extern struct xil_gpio_init_param bench_gpio_extra_ip;
+/* parent_desc is set by main, once the GIC is initialized */
+extern struct xil_gpio_irq_init_param bench_gpio_irq_extra_ip;
+
+#endif /* __PARAMETERS_H__ */
@@ -0,0 +1,13 @@
+SRCS += $(PROJECT)/src/platform/$(PLATFORM)/bench_counter.c \
+	$(PLATFORM_DRIVERS)/$(PLATFORM)_delay.c \
+	$(PLATFORM_DRIVERS)/$(PLATFORM)_gpio.c \
+	$(PLATFORM_DRIVERS)/$(PLATFORM)_gpio_irq.c \
+	$(PLATFORM_DRIVERS)/$(PLATFORM)_i2c.c \
+	$(PLATFORM_DRIVERS)/$(PLATFORM)_irq.c \
+	$(PLATFORM_DRIVERS)/$(PLATFORM)_spi.c
+
+INCS += $(PLATFORM_DRIVERS)/$(PLATFORM)_gpio.h \
+	$(PLATFORM_DRIVERS)/$(PLATFORM)_gpio_irq.h \
+	$(PLATFORM_DRIVERS)/$(PLATFORM)_i2c.h \
+	$(PLATFORM_DRIVERS)/$(PLATFORM)_irq.h \
+	$(PLATFORM_DRIVERS)/$(PLATFORM)_spi.h
@@ -221,10 +221,135 @@ relative_to_project = $(addprefix $(PROJECT_BUILD)/,$(call get_relative_path,$1)
 
 include $(NO-OS)/tools/scripts/libraries.mk
 
+# Memory allocation API used by the no-OS core. With STATIC_ALLOC=y the
+# allocations are served from a static arena of STATIC_ALLOC_SIZE bytes.
+SRCS += $(NO-OS)/util/no_os_alloc.c
+INCS += $(INCLUDE)/no_os_alloc.h
+ifeq (y,$(strip $(STATIC_ALLOC)))
+STATIC_ALLOC_SIZE ?= 16384
+CFLAGS += -DNO_OS_STATIC_ALLOC -DNO_OS_ARENA_SIZE=$(STATIC_ALLOC_SIZE)
+endif
+
+# Current and peak bytes of no_os_malloc/calloc, counts per call site, largest
+# free block and high water marks of the stacks given to no_os_stack_register.
+# Read on the "alloc_stats" IIO debug attribute or with no_os_alloc_stats_dump.
+ifeq (y,$(strip $(ALLOC_STATS)))
+CFLAGS += -DNO_OS_ALLOC_STATS
+endif
+
+# Functions and variables marked NO_OS_HOT run from HOT_TEXT_REGION and
+# HOT_DATA_REGION of the linker script, loaded from HOT_LOAD_REGION. The
+# platform makefiles give the defaults.
+INCS += $(INCLUDE)/no_os_hot.h
+ifeq (y,$(strip $(HOT_SECTIONS)))
+ifeq ($(strip $(HOT_TEXT_REGION)),)
+$(error "HOT_SECTIONS=y is not supported on $(PLATFORM), set HOT_TEXT_REGION")
+endif
+SRCS += $(NO-OS)/util/no_os_hot.c
+CFLAGS += -DNO_OS_HOT_SECTIONS
+endif
+# DMA buffers coherent with the caches (e.g. accessed through the ACP of a
+# Zynq), the no_os_dma_sync functions do nothing.
+ifeq (y,$(strip $(DMA_COHERENT)))
+CFLAGS += -DNO_OS_DMA_COHERENT
+endif
+
 ifeq (y,$(strip $(NETWORKING)))
 CFLAGS += -DNO_OS_NETWORKING
 endif
 
+# lwIP raw API backend, the lwIP stack itself comes from the platform (BSP)
+ifeq (y,$(strip $(LWIP_NETWORKING)))
+CFLAGS += -DNO_OS_LWIP_NETWORKING
+endif
+
+# Enter/exit events of the NO_OS_TRACE_* macros, the last TRACE_DEPTH being
+# kept. Read on the "trace" IIO debug attribute or with no_os_trace_dump.
+INCS += $(INCLUDE)/no_os_trace.h
+ifeq (y,$(strip $(TRACE)))
+TRACE_DEPTH ?= 256
+SRCS += $(NO-OS)/util/no_os_trace.c
+CFLAGS += -DNO_OS_TRACE -DNO_OS_TRACE_DEPTH=$(TRACE_DEPTH)
+endif
+
+# pr_* messages recorded in binary form and sent by no_os_log_flush, printed
+# on the host with tools/scripts/no_os_log_decode.py and the elf file.
+INCS += $(INCLUDE)/no_os_log.h
+ifeq (y,$(strip $(DEFERRED_LOG)))
+DEFERRED_LOG_DEPTH ?= 64
+SRCS += $(NO-OS)/util/no_os_log.c
+CFLAGS += -DNO_OS_LOG_DEFERRED -DNO_OS_LOG_DEPTH=$(DEFERRED_LOG_DEPTH)
+endif
+
+# IIO over the bulk pipes of a USB device (USE_USB), for the libiio USB
+# backend. The controller driver comes from the platform.
+ifeq (y,$(strip $(IIO_USB)))
+SRCS += $(DRIVERS)/api/no_os_usb.c
+INCS += $(INCLUDE)/no_os_usb.h
+CFLAGS += -DIIO_USB
+endif
+
+# Capture of IIO buffers to FatFs files, iio_recorder_start/stop
+ifeq (y,$(strip $(IIO_RECORDER)))
+CFLAGS += -DIIO_RECORDER
+endif
+
+# Buffer counters, iio_step duration and command latencies, read on the
+# "stats" IIO debug attribute of each device
+ifeq (y,$(strip $(IIO_STATS)))
+CFLAGS += -DIIO_STATS
+endif
+
+# Values of the IIO attributes declaring a cache_ms reused instead of calling
+# their show, until they expire or the device is written
+ifeq (y,$(strip $(IIO_ATTR_CACHE)))
+CFLAGS += -DIIO_ATTR_CACHE
+endif
+
+# Cooperative scheduler: timers, event flags and deferred works run by
+# no_os_sched_run, sleeping when idle. iio_app runs iio_step from it.
+INCS += $(INCLUDE)/no_os_sched.h $(INCLUDE)/no_os_ilist.h
+ifeq (y,$(strip $(SCHED)))
+SRCS += $(NO-OS)/util/no_os_sched.c $(NO-OS)/util/no_os_ilist.c
+CFLAGS += -DNO_OS_SCHED
+endif
+
+# IIO server run from FreeRTOS command, transmit and worker tasks instead of
+# the iio_step loop. The FreeRTOS kernel comes with the platform SDK.
+ifeq (y,$(strip $(IIO_FREERTOS)))
+CFLAGS += -DIIO_FREERTOS
+endif
+
+# Asymmetric multiprocessing: requests and responses exchanged by two cores
+# through a no_os_amp_link in shared memory, for example the application core
+# running IIO over the network and the other core owning the DMA.
+INCS += $(INCLUDE)/no_os_amp.h $(INCLUDE)/no_os_lffifo.h
+ifeq (y,$(strip $(AMP)))
+SRCS += $(NO-OS)/util/no_os_amp.c $(NO-OS)/util/no_os_lffifo.c
+CFLAGS += -DNO_OS_AMP
+ifeq 'xilinx' '$(PLATFORM)'
+SRCS += $(PLATFORM_DRIVERS)/xilinx_amp.c
+INCS += $(PLATFORM_DRIVERS)/xilinx_amp.h
+endif
+endif
+
+# Interrupt priorities set per source class with no_os_irq_policy_apply and
+# entry latency counters, read on the "irq_latency" IIO debug attribute
+INCS += $(INCLUDE)/no_os_irq_policy.h
+ifeq (y,$(strip $(IRQ_POLICY)))
+SRCS += $(NO-OS)/util/no_os_irq_policy.c
+CFLAGS += -DNO_OS_IRQ_POLICY
+endif
+
+# no_os_spi_write_and_read and no_os_gpio_set/get_value calling the driver of
+# $(PLATFORM) directly, without the platform_ops indirection, see
+# no_os_static_ops.h. Descriptors using other ops are still supported, the
+# SPI and GPIO drivers of $(PLATFORM) must be built.
+INCS += $(INCLUDE)/no_os_static_ops.h
+ifeq (y,$(strip $(STATIC_OPS)))
+CFLAGS += -DNO_OS_STATIC_OPS
+endif
+
 ifeq (y,$(strip $(DISABLE_SECURE_SOCKET)))
 CFLAGS += -DDISABLE_SECURE_SOCKET
 endif
@@ -330,8 +455,24 @@ $(OBJECTS_DIR)/%.o: $$(call get_full_path, %).S | $$(@D)/.
 	$(MUTE) $(AS) -c $(ASFLAGS) $< -o $@
 
 ifneq ($(strip $(LSCRIPT)),)
+ifeq (y,$(strip $(HOT_SECTIONS)))
+# The linker script of the platform extended with the NO_OS_HOT sections
+HOT_LSCRIPT = $(BUILD_DIR)/no_os_hot_lscript.ld
+LSCRIPT_FLAG = -T$(HOT_LSCRIPT)
+
+$(BINARY): $(HOT_LSCRIPT)
+
+$(HOT_LSCRIPT): $(LSCRIPT) $(NO-OS)/tools/scripts/no_os_hot.ld | $(OBJECTS_DIR)/.
+	@$(call print,[GEN] $(notdir $@))
+	$(MUTE) echo 'INCLUDE $(LSCRIPT)' > $@
+	$(MUTE) echo 'REGION_ALIAS("NO_OS_HOT_TEXT", $(HOT_TEXT_REGION));' >> $@
+	$(MUTE) echo 'REGION_ALIAS("NO_OS_HOT_DATA", $(HOT_DATA_REGION));' >> $@
+	$(MUTE) echo 'REGION_ALIAS("NO_OS_HOT_LOAD", $(HOT_LOAD_REGION));' >> $@
+	$(MUTE) echo 'INCLUDE $(NO-OS)/tools/scripts/no_os_hot.ld' >> $@
+else
 LSCRIPT_FLAG = -T$(LSCRIPT)
 endif
+endif
 
 $(BINARY): $(LIB_TARGETS) $(OBJS) $(ASM_OBJS) $(LSCRIPT) $(BOOTOBJ)
 	@$(call print,[LD] $(notdir $(OBJS)))
@@ -28,6 +28,11 @@ MBEDTLS_LIBS				= $(addprefix $(MBEDTLS_LIB_DIR)/,$(MBEDTLS_LIB_NAMES))
 EXTRA_LIBS					+= $(MBEDTLS_LIBS)
 EXTRA_LIBS_PATHS			+= $(MBEDTLS_LIB_DIR)
 EXTRA_INC_PATHS		+= $(MBEDTLS_DIR)/include
+# Entropy pool feeding the secure sockets
+SRCS		+= $(NO-OS)/util/no_os_trng_pool.c \
+			$(NO-OS)/util/no_os_lffifo.c
+INCS		+= $(NO-OS)/include/no_os_trng_pool.h \
+			$(NO-OS)/include/no_os_lffifo.h
 
 #Rules
 MBED_TLS_CONFIG_FILE = $(NO-OS)/network/noos_mbedtls_config.h
@@ -0,0 +1,173 @@
+#!/usr/bin/env python3
+"""
+Print the messages of the no-OS deferred logger (NO_OS_LOG_DEFERRED).
+
+The firmware sends frames with the address of the format string of each
+message and its arguments, see include/no_os_log.h. The format strings are
+read from the .no_os_log section of the elf file of the same build.
+
+Examples:
+	python no_os_log_decode.py build/project.elf capture.bin
+	python no_os_log_decode.py build/project.elf /dev/ttyACM0 -baud 115200
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+from elftools.elf.elffile import ELFFile
+
+LOG_MAGIC = 0xA5
+LOG_HDR_SIZE = 10
+LOG_SECTION = '.no_os_log'
+
+# printf conversion: flags, width, precision, length and specifier
+CONV = re.compile(r'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|j|z|t|L)?'
+		  r'([diouxXeEfFgGcspn%])')
+
+def load_formats(elf_path):
+	with open(elf_path, 'rb') as f:
+		elf = ELFFile(f)
+		sect = elf.get_section_by_name(LOG_SECTION)
+		if sect is None:
+			sys.exit('%s has no %s section' % (elf_path, LOG_SECTION))
+		return sect['sh_addr'], sect.data()
+
+def get_format(formats, addr):
+	base, data = formats
+	off = addr - base
+	if off < 0 or off >= len(data):
+		return None
+	end = data.find(b'\0', off)
+	return data[off:end].decode('utf-8', 'replace')
+
+def parse_args(data):
+	args = []
+	i = 0
+	while i < len(data):
+		t = chr(data[i])
+		i += 1
+		if t == 'w':
+			args.append(struct.unpack_from('<I', data, i)[0])
+			i += 4
+		elif t == 'q':
+			args.append(struct.unpack_from('<Q', data, i)[0])
+			i += 8
+		elif t == 'd':
+			args.append(struct.unpack_from('<d', data, i)[0])
+			i += 8
+		elif t == 's':
+			n = data[i]
+			args.append(data[i + 1:i + 1 + n].decode('utf-8',
+								  'replace'))
+			i += 1 + n
+		elif t == '.':
+			return args, True
+		else:
+			break
+	return args, False
+
+def to_signed(val, length):
+	bits = 64 if length in ('ll', 'j') or val > 0xffffffff else 32
+	if val >= 1 << (bits - 1):
+		val -= 1 << bits
+	return val
+
+def format_message(fmt, args, truncated):
+	out = []
+	pos = 0
+	it = iter(args)
+	for m in CONV.finditer(fmt):
+		out.append(fmt[pos:m.start()])
+		pos = m.end()
+		flags, width, prec, length, spec = m.groups()
+		if spec == '%':
+			out.append('%')
+			continue
+		try:
+			if width == '*':
+				width = str(to_signed(next(it), None))
+			if prec == '*':
+				prec = str(next(it))
+			val = next(it)
+		except StopIteration:
+			out.append('<?>' if truncated else m.group(0))
+			continue
+		spec_py = '%' + flags + (width or '') + \
+			  ('.' + prec if prec is not None else '')
+		if spec in 'di':
+			out.append((spec_py + 'd') % to_signed(val, length))
+		elif spec == 'u':
+			out.append((spec_py + 'd') % val)
+		elif spec == 'p':
+			out.append('0x%x' % val)
+		elif spec == 's' and not isinstance(val, str):
+			out.append('<str@0x%x>' % val)
+		elif spec == 'c' and not isinstance(val, str):
+			out.append((spec_py + 'c') % chr(val & 0xff))
+		elif spec == 'n':
+			continue
+		else:
+			out.append((spec_py + spec) % val)
+	out.append(fmt[pos:])
+	if truncated:
+		out.append(' <truncated>\n')
+	return ''.join(out)
+
+def open_input(path, baud):
+	if path == '-':
+		return sys.stdin.buffer
+	if baud:
+		import serial
+		return serial.Serial(path, baud)
+	return open(path, 'rb')
+
+def decode(formats, stream):
+	buf = b''
+	while True:
+		chunk = stream.read(1) if hasattr(stream, 'in_waiting') else \
+			stream.read(4096)
+		if not chunk:
+			break
+		buf += chunk
+		while len(buf) >= LOG_HDR_SIZE:
+			if buf[0] != LOG_MAGIC or buf[1] < LOG_HDR_SIZE:
+				buf = buf[1:]
+				continue
+			length = buf[1]
+			if len(buf) < length:
+				break
+			addr, ts = struct.unpack_from('<II', buf, 2)
+			args, truncated = parse_args(buf[LOG_HDR_SIZE:length])
+			if addr == 0:
+				msg = '<%d messages lost>\n' % (args[0] if args
+								else 0)
+			else:
+				fmt = get_format(formats, addr)
+				if fmt is None:
+					# Not a frame, resynchronize
+					buf = buf[1:]
+					continue
+				msg = format_message(fmt, args, truncated)
+			if ts:
+				msg = '[%5d.%06d] ' % (ts // 1000000,
+						       ts % 1000000) + msg
+			sys.stdout.write(msg)
+			sys.stdout.flush()
+			buf = buf[length:]
+
+def main():
+	parser = argparse.ArgumentParser(description=__doc__,
+		formatter_class=argparse.RawDescriptionHelpFormatter)
+	parser.add_argument('elf', help='elf file of the firmware')
+	parser.add_argument('input', help='capture file, serial port or - '
+			    'for stdin')
+	parser.add_argument('-baud', type=int, default=0,
+			    help='open input as a serial port (needs pyserial)')
+	args = parser.parse_args()
+
+	decode(load_formats(args.elf), open_input(args.input, args.baud))
+
+if __name__ == '__main__':
+	main()
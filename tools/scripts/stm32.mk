@@ -65,6 +65,12 @@ endif
 # Get the path of the linker script
 LSCRIPT=$(wildcard $(PROJECT_BUILDROOT)/*FLASH.ld)
 
+# Memory regions of the NO_OS_HOT code and data with HOT_SECTIONS=y. On the
+# STM32H7 set HOT_TEXT_REGION=ITCMRAM and HOT_DATA_REGION=DTCMRAM.
+HOT_TEXT_REGION ?= RAM
+HOT_DATA_REGION ?= RAM
+HOT_LOAD_REGION ?= FLASH
+
 # Get the extra flags that need to be added into the .cproject file
 CPROJECTFLAGS = $(sort $(subst -D,,$(filter -D%, $(CFLAGS))))
 
@@ -0,0 +1,888 @@
+/***************************************************************************//**
+ *   @file   no_os_alloc.c
+ *   @brief  Implementation of the memory allocation API.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "no_os_alloc.h"
+#include "no_os_error.h"
+#ifdef NO_OS_ALLOC_STATS
+#include "no_os_uart.h"
+#endif
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#ifdef NO_OS_STATIC_ALLOC
+
+/* Alignment of the arena blocks, enough for any standard type */
+#define NO_OS_ARENA_ALIGN	sizeof(long long)
+#define NO_OS_ARENA_ROUND(x)	\
+	(((x) + NO_OS_ARENA_ALIGN - 1) & ~(NO_OS_ARENA_ALIGN - 1))
+
+/*
+ * Each block is preceded by a header linking it to the block below. Freeing
+ * the last allocated block gives its memory back, together with the freed
+ * blocks below it. The memory of the other freed blocks is given back once
+ * all the blocks allocated after them are freed.
+ */
+struct no_os_arena_hdr {
+	/* Offset of the header of the block below, NO_OS_ARENA_NONE if none */
+	size_t prev;
+	/* Set once the block was freed */
+	size_t freed;
+};
+
+#define NO_OS_ARENA_NONE	((size_t)-1)
+#define NO_OS_ARENA_HDR_SIZE	\
+	NO_OS_ARENA_ROUND(sizeof(struct no_os_arena_hdr))
+
+#endif // NO_OS_STATIC_ALLOC
+
+#ifdef NO_OS_ALLOC_STATS
+
+/* Alignment of the blocks returned to the callers */
+#define NO_OS_ALLOC_ALIGN	sizeof(long long)
+
+/* Header of each allocation, for no_os_free to know what to account */
+struct no_os_alloc_hdr {
+	/* Size requested by the caller */
+	size_t size;
+	/* Index in no_os_alloc_sites */
+	size_t site;
+};
+
+#define NO_OS_ALLOC_HDR_SIZE	\
+	((sizeof(struct no_os_alloc_hdr) + NO_OS_ALLOC_ALIGN - 1) & \
+	 ~(NO_OS_ALLOC_ALIGN - 1))
+
+/* Value of the unused stack words */
+#define NO_OS_STACK_PAINT		0xA5A5A5A5
+/* Bytes left unpainted below the frame painting the current stack */
+#define NO_OS_STACK_PAINT_MARGIN	256
+
+/* Allocations made from the same return address */
+struct no_os_alloc_site {
+	/* Return address of the no_os_malloc/calloc call, 0 for the others */
+	uintptr_t addr;
+	uint32_t allocs;
+	size_t used;
+};
+
+struct no_os_alloc_stack {
+	const char *name;
+	uint32_t *base;
+	size_t size;
+};
+
+#endif // NO_OS_ALLOC_STATS
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+#ifdef NO_OS_STATIC_ALLOC
+
+static long long no_os_arena[NO_OS_ARENA_ROUND(NO_OS_ARENA_SIZE) /
+					    sizeof(long long)];
+/* Offset of the first unused byte of the arena */
+static size_t no_os_arena_top;
+/* Offset of the header of the last allocated block */
+static size_t no_os_arena_last = NO_OS_ARENA_NONE;
+static size_t no_os_arena_high;
+
+#endif // NO_OS_STATIC_ALLOC
+
+#ifdef NO_OS_ALLOC_STATS
+
+static struct no_os_alloc_stats no_os_alloc_stats;
+/* The last entry counts the allocations of the sites not fitting the table */
+static struct no_os_alloc_site no_os_alloc_sites[NO_OS_ALLOC_STATS_SITES + 1];
+static uint32_t no_os_alloc_nb_sites;
+static struct no_os_alloc_stack no_os_alloc_stacks[NO_OS_ALLOC_STATS_STACKS];
+static uint32_t no_os_alloc_nb_stacks;
+
+#endif // NO_OS_ALLOC_STATS
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+#ifdef NO_OS_STATIC_ALLOC
+
+/**
+ * @brief Bump allocate a block from the static arena.
+ * @param size - Number of bytes.
+ * @return pointer to the block, NULL if the arena is exhausted.
+ */
+static void *no_os_arena_alloc(size_t size)
+{
+	struct no_os_arena_hdr *hdr;
+	size_t needed;
+
+	if (!size)
+		return NULL;
+
+	needed = NO_OS_ARENA_HDR_SIZE + NO_OS_ARENA_ROUND(size);
+	if (needed < size || needed > sizeof(no_os_arena) - no_os_arena_top)
+		return NULL;
+
+	hdr = (struct no_os_arena_hdr *)((uint8_t *)no_os_arena +
+					 no_os_arena_top);
+	hdr->prev = no_os_arena_last;
+	hdr->freed = 0;
+
+	no_os_arena_last = no_os_arena_top;
+	no_os_arena_top += needed;
+	if (no_os_arena_top > no_os_arena_high)
+		no_os_arena_high = no_os_arena_top;
+
+	return (uint8_t *)hdr + NO_OS_ARENA_HDR_SIZE;
+}
+
+/**
+ * @brief Free a block of the static arena.
+ * @param ptr - Pointer to the block.
+ */
+static void no_os_arena_free(void *ptr)
+{
+	struct no_os_arena_hdr *hdr;
+
+	hdr = (struct no_os_arena_hdr *)((uint8_t *)ptr - NO_OS_ARENA_HDR_SIZE);
+	hdr->freed = 1;
+
+	/* Give back the freed blocks from the top of the arena */
+	while (no_os_arena_last != NO_OS_ARENA_NONE) {
+		hdr = (struct no_os_arena_hdr *)((uint8_t *)no_os_arena +
+						 no_os_arena_last);
+		if (!hdr->freed)
+			break;
+
+		no_os_arena_top = no_os_arena_last;
+		no_os_arena_last = hdr->prev;
+	}
+}
+
+#endif // NO_OS_STATIC_ALLOC
+
+/**
+ * @brief Allocate memory from the backend: the static arena when
+ * NO_OS_STATIC_ALLOC is defined and the heap otherwise.
+ * @param size - Number of bytes.
+ * @return pointer to the memory, NULL in case of failure.
+ */
+static void *no_os_mem_alloc(size_t size)
+{
+#ifdef NO_OS_STATIC_ALLOC
+	return no_os_arena_alloc(size);
+#else
+	return malloc(size);
+#endif
+}
+
+/**
+ * @brief Free memory obtained with no_os_mem_alloc.
+ * @param ptr - Pointer to the memory.
+ */
+static void no_os_mem_free(void *ptr)
+{
+#ifdef NO_OS_STATIC_ALLOC
+	no_os_arena_free(ptr);
+#else
+	free(ptr);
+#endif
+}
+
+#ifdef NO_OS_ALLOC_STATS
+
+/**
+ * @brief Get the entry of a call site, adding it if it is a new one.
+ * @param addr - Return address of the allocation call.
+ * @return index in no_os_alloc_sites.
+ */
+static size_t no_os_alloc_site(uintptr_t addr)
+{
+	uint32_t i;
+
+	for (i = 0; i < no_os_alloc_nb_sites; i++)
+		if (no_os_alloc_sites[i].addr == addr)
+			return i;
+
+	if (no_os_alloc_nb_sites == NO_OS_ALLOC_STATS_SITES)
+		return NO_OS_ALLOC_STATS_SITES;
+
+	no_os_alloc_sites[i].addr = addr;
+
+	return no_os_alloc_nb_sites++;
+}
+
+/**
+ * @brief Allocate memory with a header recording its size and call site.
+ * @param size - Number of bytes.
+ * @param caller - Return address of the no_os_malloc/calloc call.
+ * @return pointer to the memory, NULL in case of failure.
+ */
+static void *no_os_alloc_stats_alloc(size_t size, void *caller)
+{
+	struct no_os_alloc_hdr *hdr = NULL;
+	size_t site;
+
+	if (!size)
+		return NULL;
+
+	if (size <= (size_t)-1 - NO_OS_ALLOC_HDR_SIZE)
+		hdr = no_os_mem_alloc(NO_OS_ALLOC_HDR_SIZE + size);
+	if (!hdr) {
+		no_os_alloc_stats.failed++;
+		return NULL;
+	}
+
+	site = no_os_alloc_site((uintptr_t)caller);
+	hdr->size = size;
+	hdr->site = site;
+
+	no_os_alloc_stats.allocs++;
+	no_os_alloc_stats.used += size;
+	if (no_os_alloc_stats.used > no_os_alloc_stats.peak)
+		no_os_alloc_stats.peak = no_os_alloc_stats.used;
+	no_os_alloc_sites[site].allocs++;
+	no_os_alloc_sites[site].used += size;
+
+	return (uint8_t *)hdr + NO_OS_ALLOC_HDR_SIZE;
+}
+
+/**
+ * @brief Account a free.
+ * @param ptr - Pointer returned by no_os_alloc_stats_alloc.
+ * @return the block to give back to the backend.
+ */
+static void *no_os_alloc_stats_free(void *ptr)
+{
+	struct no_os_alloc_hdr *hdr;
+
+	hdr = (struct no_os_alloc_hdr *)((uint8_t *)ptr - NO_OS_ALLOC_HDR_SIZE);
+
+	no_os_alloc_stats.frees++;
+	no_os_alloc_stats.used -= hdr->size;
+	no_os_alloc_sites[hdr->site].used -= hdr->size;
+
+	return hdr;
+}
+
+#endif // NO_OS_ALLOC_STATS
+
+/**
+ * @brief Allocate memory, from the static arena when NO_OS_STATIC_ALLOC is
+ * defined and from the heap otherwise. With NO_OS_ALLOC_STATS, the memory must
+ * only be freed with no_os_free.
+ * @param size - Number of bytes.
+ * @return pointer to the memory, NULL in case of failure.
+ */
+void *no_os_malloc(size_t size)
+{
+#ifdef NO_OS_ALLOC_STATS
+	return no_os_alloc_stats_alloc(size, __builtin_return_address(0));
+#else
+	return no_os_mem_alloc(size);
+#endif
+}
+
+/**
+ * @brief Allocate zeroed memory for an array, from the static arena when
+ * NO_OS_STATIC_ALLOC is defined and from the heap otherwise.
+ * @param nitems - Number of elements.
+ * @param size - Size of an element in bytes.
+ * @return pointer to the memory, NULL in case of failure.
+ */
+void *no_os_calloc(size_t nitems, size_t size)
+{
+#if defined(NO_OS_STATIC_ALLOC) || defined(NO_OS_ALLOC_STATS)
+	void *ptr;
+
+	if (size && nitems > (size_t)-1 / size)
+		return NULL;
+
+#ifdef NO_OS_ALLOC_STATS
+	ptr = no_os_alloc_stats_alloc(nitems * size,
+				      __builtin_return_address(0));
+#else
+	ptr = no_os_arena_alloc(nitems * size);
+#endif
+	if (ptr)
+		memset(ptr, 0, nitems * size);
+
+	return ptr;
+#else
+	return calloc(nitems, size);
+#endif
+}
+
+/**
+ * @brief Free memory obtained with no_os_malloc or no_os_calloc.
+ * @param ptr - Pointer to the memory. NULL is ignored.
+ */
+void no_os_free(void *ptr)
+{
+	if (!ptr)
+		return;
+
+#ifdef NO_OS_ALLOC_STATS
+	ptr = no_os_alloc_stats_free(ptr);
+#endif
+	no_os_mem_free(ptr);
+}
+
+/**
+ * @brief Get the usage of the static arena.
+ * @param stats - Where to store the usage.
+ * @return 0 in case of success, -ENOSYS if NO_OS_STATIC_ALLOC is not defined,
+ * -EINVAL for wrong parameters.
+ */
+int32_t no_os_arena_get_stats(struct no_os_arena_stats *stats)
+{
+	if (!stats)
+		return -EINVAL;
+
+#ifdef NO_OS_STATIC_ALLOC
+	stats->size = sizeof(no_os_arena);
+	stats->used = no_os_arena_top;
+	stats->high_watermark = no_os_arena_high;
+
+	return 0;
+#else
+	return -ENOSYS;
+#endif
+}
+
+#ifdef NO_OS_ALLOC_STATS
+
+/**
+ * @brief Estimate the largest block the backend can still allocate. Only the
+ * top of the static arena can be reused. The heap is probed by allocating
+ * blocks, the size being found by bisection up to NO_OS_ALLOC_STATS_PROBE_MAX.
+ * @return number of bytes.
+ */
+static size_t no_os_alloc_largest_free(void)
+{
+#ifdef NO_OS_STATIC_ALLOC
+	size_t free_bytes = sizeof(no_os_arena) - no_os_arena_top;
+	size_t overhead = NO_OS_ARENA_HDR_SIZE + NO_OS_ALLOC_HDR_SIZE;
+
+	return free_bytes > overhead ? free_bytes - overhead : 0;
+#else
+	size_t lo = 0, hi = NO_OS_ALLOC_STATS_PROBE_MAX, mid;
+	void *ptr;
+
+	/* lo can be allocated, hi + 1 could not be */
+	while (lo < hi) {
+		mid = lo + (hi - lo + 1) / 2;
+		ptr = malloc(NO_OS_ALLOC_HDR_SIZE + mid);
+		if (ptr) {
+			free(ptr);
+			lo = mid;
+		} else {
+			hi = mid - 1;
+		}
+	}
+
+	return lo;
+#endif
+}
+
+/**
+ * @brief Paint a stack from its base up to the frame of the caller, if the
+ * stack is the current one, or entirely otherwise.
+ * @param stack - The stack.
+ */
+static void no_os_stack_paint(struct no_os_alloc_stack *stack)
+{
+	uintptr_t frame = (uintptr_t)__builtin_frame_address(0);
+	uintptr_t start = (uintptr_t)stack->base;
+	volatile uint32_t *word = stack->base;
+	uintptr_t end = start + stack->size;
+
+	if (frame >= start && frame < end) {
+		if (frame - start <= NO_OS_STACK_PAINT_MARGIN)
+			return;
+		end = frame - NO_OS_STACK_PAINT_MARGIN;
+	}
+
+	while ((uintptr_t)word + sizeof(*word) <= end)
+		*word++ = NO_OS_STACK_PAINT;
+}
+
+/**
+ * @brief Get the high water mark of a stack, the stacks growing down.
+ * @param stack - The stack.
+ * @return number of bytes used at least once since the stack was painted.
+ */
+static size_t no_os_stack_used(struct no_os_alloc_stack *stack)
+{
+	volatile uint32_t *word = stack->base;
+	size_t untouched = 0;
+
+	while (untouched < stack->size && *word++ == NO_OS_STACK_PAINT)
+		untouched += sizeof(*word);
+
+	return stack->size - untouched;
+}
+
+/**
+ * @brief Format a line of no_os_alloc_stats_print.
+ * @param idx - Line number.
+ * @param buf - Where to write the line.
+ * @param len - Size of buf, at least NO_OS_ALLOC_STATS_LINE_SIZE.
+ * @return the number of characters written, 0 after the last line.
+ */
+static uint32_t no_os_alloc_stats_line(uint32_t idx, char *buf, uint32_t len)
+{
+	struct no_os_alloc_stats stats;
+	struct no_os_alloc_site *site;
+	struct no_os_alloc_stack *stack;
+
+	if (!idx) {
+		no_os_alloc_get_stats(&stats);
+		return snprintf(buf, len,
+				"used %lu peak %lu largest_free %lu\n",
+				(unsigned long)stats.used,
+				(unsigned long)stats.peak,
+				(unsigned long)stats.largest_free);
+	}
+
+	if (idx == 1)
+		return snprintf(buf, len, "allocs %lu frees %lu failed %lu\n",
+				(unsigned long)no_os_alloc_stats.allocs,
+				(unsigned long)no_os_alloc_stats.frees,
+				(unsigned long)no_os_alloc_stats.failed);
+	idx -= 2;
+
+	if (idx <= no_os_alloc_nb_sites) {
+		if (idx == no_os_alloc_nb_sites)
+			site = &no_os_alloc_sites[NO_OS_ALLOC_STATS_SITES];
+		else
+			site = &no_os_alloc_sites[idx];
+		return snprintf(buf, len, "site 0x%08lx allocs %lu used %lu\n",
+				(unsigned long)site->addr,
+				(unsigned long)site->allocs,
+				(unsigned long)site->used);
+	}
+	idx -= no_os_alloc_nb_sites + 1;
+
+	if (idx < no_os_alloc_nb_stacks) {
+		stack = &no_os_alloc_stacks[idx];
+		return snprintf(buf, len, "stack %.16s size %lu used %lu\n",
+				stack->name ? stack->name : "-",
+				(unsigned long)stack->size,
+				(unsigned long)no_os_stack_used(stack));
+	}
+
+	return 0;
+}
+
+#endif // NO_OS_ALLOC_STATS
+
+/**
+ * @brief Get the allocation counters.
+ * @param stats - Where to store the counters.
+ * @return 0 in case of success, -ENOSYS if NO_OS_ALLOC_STATS is not defined,
+ * -EINVAL for wrong parameters.
+ */
+int32_t no_os_alloc_get_stats(struct no_os_alloc_stats *stats)
+{
+	if (!stats)
+		return -EINVAL;
+
+#ifdef NO_OS_ALLOC_STATS
+	*stats = no_os_alloc_stats;
+	stats->largest_free = no_os_alloc_largest_free();
+
+	return 0;
+#else
+	return -ENOSYS;
+#endif
+}
+
+/**
+ * @brief Restart the peak from the current usage and clear the counters. The
+ * registered stack holding the frame of the caller is painted again, the
+ * others keep their high water mark.
+ */
+void no_os_alloc_reset_stats(void)
+{
+#ifdef NO_OS_ALLOC_STATS
+	uintptr_t frame = (uintptr_t)__builtin_frame_address(0);
+	struct no_os_alloc_stack *stack;
+	uint32_t i;
+
+	no_os_alloc_stats.peak = no_os_alloc_stats.used;
+	no_os_alloc_stats.allocs = 0;
+	no_os_alloc_stats.frees = 0;
+	no_os_alloc_stats.failed = 0;
+	for (i = 0; i <= NO_OS_ALLOC_STATS_SITES; i++)
+		no_os_alloc_sites[i].allocs = 0;
+
+	for (i = 0; i < no_os_alloc_nb_stacks; i++) {
+		stack = &no_os_alloc_stacks[i];
+		if (frame >= (uintptr_t)stack->base &&
+		    frame < (uintptr_t)stack->base + stack->size)
+			no_os_stack_paint(stack);
+	}
+#endif
+}
+
+/**
+ * @brief Format the allocation counters, then one line per call site with its
+ * return address to look up with addr2line, the number of allocations and the
+ * bytes still allocated, "site 0x00000000" gathering the sites not fitting the
+ * table, then one line per registered stack with its high water mark.
+ * @param buf - Where to write the lines.
+ * @param len - Size of buf.
+ * @return the number of characters written, negative error code otherwise.
+ */
+int32_t no_os_alloc_stats_print(char *buf, uint32_t len)
+{
+#ifdef NO_OS_ALLOC_STATS
+	uint32_t i, n, l = 0;
+
+	if (!buf)
+		return -EINVAL;
+
+	for (i = 0; ; i++) {
+		if (len - l < NO_OS_ALLOC_STATS_LINE_SIZE)
+			return -ENOBUFS;
+
+		n = no_os_alloc_stats_line(i, buf + l, len - l);
+		if (!n)
+			return l;
+		l += n;
+	}
+#else
+	return -ENOSYS;
+#endif
+}
+
+/**
+ * @brief Write the lines of no_os_alloc_stats_print on a UART, one at a time
+ * so the whole text does not have to fit a buffer.
+ * @param uart - UART descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_alloc_stats_dump(struct no_os_uart_desc *uart)
+{
+#ifdef NO_OS_ALLOC_STATS
+	char line[NO_OS_ALLOC_STATS_LINE_SIZE];
+	uint32_t i, n;
+	int32_t ret;
+
+	if (!uart)
+		return -EINVAL;
+
+	for (i = 0; (n = no_os_alloc_stats_line(i, line, sizeof(line))); i++) {
+		ret = no_os_uart_write(uart, (uint8_t *)line, n);
+		if (ret < 0)
+			return ret;
+	}
+
+	return 0;
+#else
+	return -ENOSYS;
+#endif
+}
+
+/**
+ * @brief Register a stack and paint its unused part, for its high water mark
+ * to be reported. A stack not holding the frame of the caller is painted
+ * entirely, so it must not be in use yet, e.g. the stack of a task not started.
+ * The stacks are assumed to grow down.
+ * @param name - Name of the stack, e.g. "main".
+ * @param base - Lowest address of the stack, e.g. the _stack_end or
+ * __StackLimit linker symbol for the main stack.
+ * @param size - Size of the stack in bytes.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_stack_register(const char *name, void *base, size_t size)
+{
+#ifdef NO_OS_ALLOC_STATS
+	struct no_os_alloc_stack *stack;
+	uintptr_t start;
+
+	if (!base || !size)
+		return -EINVAL;
+
+	if (no_os_alloc_nb_stacks == NO_OS_ALLOC_STATS_STACKS)
+		return -ENOSPC;
+
+	/* Whole words only */
+	start = ((uintptr_t)base + sizeof(uint32_t) - 1) &
+		~(uintptr_t)(sizeof(uint32_t) - 1);
+	if (start - (uintptr_t)base >= size)
+		return -EINVAL;
+	size = (size - (start - (uintptr_t)base)) & ~(sizeof(uint32_t) - 1);
+
+	stack = &no_os_alloc_stacks[no_os_alloc_nb_stacks++];
+	stack->name = name;
+	stack->base = (uint32_t *)start;
+	stack->size = size;
+	no_os_stack_paint(stack);
+
+	return 0;
+#else
+	return -ENOSYS;
+#endif
+}
+
+/**
+ * @brief Allocate the memory of a pool. It is the only allocation of the pool,
+ * no_os_pool_alloc and no_os_pool_free do not allocate.
+ * @param pool - The pool.
+ * @param block_size - Size of a block in bytes.
+ * @param nb_blocks - Number of blocks.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_pool_init(struct no_os_pool *pool, uint32_t block_size,
+			uint32_t nb_blocks)
+{
+	uint32_t i;
+
+	if (!pool || !block_size || !nb_blocks)
+		return -EINVAL;
+
+	/* Free blocks store a pointer to the next free block */
+	if (block_size < sizeof(void *))
+		block_size = sizeof(void *);
+	block_size = (block_size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+
+	pool->mem = no_os_calloc(nb_blocks, block_size);
+	if (!pool->mem)
+		return -ENOMEM;
+
+	pool->block_size = block_size;
+	pool->nb_blocks = nb_blocks;
+	pool->in_use = 0;
+	pool->high_watermark = 0;
+	pool->free_list = NULL;
+	for (i = nb_blocks; i > 0; i--) {
+		*(void **)(pool->mem + (i - 1) * block_size) = pool->free_list;
+		pool->free_list = pool->mem + (i - 1) * block_size;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Free the memory of a pool.
+ * @param pool - The pool.
+ */
+void no_os_pool_remove(struct no_os_pool *pool)
+{
+	if (!pool)
+		return;
+
+	no_os_free(pool->mem);
+	pool->mem = NULL;
+	pool->free_list = NULL;
+	pool->nb_blocks = 0;
+	pool->in_use = 0;
+}
+
+/**
+ * @brief Get a block from the pool.
+ * @param pool - The pool.
+ * @return zeroed block, NULL if all the blocks are used.
+ */
+void *no_os_pool_alloc(struct no_os_pool *pool)
+{
+	void *ptr;
+
+	if (!pool || !pool->free_list)
+		return NULL;
+
+	ptr = pool->free_list;
+	pool->free_list = *(void **)ptr;
+	memset(ptr, 0, pool->block_size);
+
+	pool->in_use++;
+	if (pool->in_use > pool->high_watermark)
+		pool->high_watermark = pool->in_use;
+
+	return ptr;
+}
+
+/**
+ * @brief Return a block to the pool.
+ * @param pool - The pool.
+ * @param ptr - Block obtained with no_os_pool_alloc. NULL is ignored.
+ */
+void no_os_pool_free(struct no_os_pool *pool, void *ptr)
+{
+	if (!pool || !ptr)
+		return;
+
+	*(void **)ptr = pool->free_list;
+	pool->free_list = ptr;
+	pool->in_use--;
+}
+
+/**
+ * @brief Allocate a DMA buffer. It starts on a NO_OS_DMA_ALIGN boundary and
+ * its size is rounded up to it, so the cache maintenance of the buffer never
+ * touches other data. The address of the underlying no_os_malloc block is
+ * stored right before the buffer.
+ * @param size - Number of bytes.
+ * @return pointer to the zeroed buffer, NULL in case of failure.
+ */
+void *no_os_dma_alloc(size_t size)
+{
+	size_t needed;
+	uintptr_t addr;
+	void *mem;
+
+	if (!size)
+		return NULL;
+
+	size = (size + NO_OS_DMA_ALIGN - 1) & ~((size_t)NO_OS_DMA_ALIGN - 1);
+	needed = size + NO_OS_DMA_ALIGN + sizeof(void *);
+	if (!size || needed < size)
+		return NULL;
+
+	mem = no_os_malloc(needed);
+	if (!mem)
+		return NULL;
+
+	addr = ((uintptr_t)mem + sizeof(void *) + NO_OS_DMA_ALIGN - 1) &
+	       ~((uintptr_t)NO_OS_DMA_ALIGN - 1);
+	((void **)addr)[-1] = mem;
+	memset((void *)addr, 0, size);
+
+	return (void *)addr;
+}
+
+/**
+ * @brief Free a DMA buffer.
+ * @param ptr - Buffer obtained with no_os_dma_alloc. NULL is ignored.
+ */
+void no_os_dma_free(void *ptr)
+{
+	if (!ptr)
+		return;
+
+	no_os_free(((void **)ptr)[-1]);
+}
+
+/**
+ * @brief Make a DMA buffer coherent for the device. Data written by the CPU
+ * is cleaned to memory. For data coming from the device, the lines are
+ * cleaned and invalidated, so no dirty line is evicted over the data during
+ * the transfer and the dirty data sharing the first and last lines is kept.
+ * Nothing is done with NO_OS_DMA_COHERENT, e.g. for buffers accessed by the
+ * DMA through the ACP of a Zynq.
+ * @param addr - Start of the buffer.
+ * @param size - Number of bytes.
+ * @param dir - Direction of the transfer.
+ */
+void no_os_dma_sync_for_device(void *addr, size_t size,
+			       enum no_os_dma_dir dir)
+{
+#ifndef NO_OS_DMA_COHERENT
+	if (!addr || !size)
+		return;
+
+	if (dir == NO_OS_DMA_FROM_DEVICE)
+		no_os_dcache_flush_range((uintptr_t)addr, size);
+	else
+		no_os_dcache_clean_range((uintptr_t)addr, size);
+#endif
+}
+
+/**
+ * @brief Make a DMA buffer coherent for the CPU. The lines of data written by
+ * the device are invalidated, as they may have been fetched again during the
+ * transfer. Nothing is done with NO_OS_DMA_COHERENT.
+ * @param addr - Start of the buffer.
+ * @param size - Number of bytes.
+ * @param dir - Direction of the transfer.
+ */
+void no_os_dma_sync_for_cpu(void *addr, size_t size, enum no_os_dma_dir dir)
+{
+#ifndef NO_OS_DMA_COHERENT
+	if (!addr || !size || dir == NO_OS_DMA_TO_DEVICE)
+		return;
+
+	no_os_dcache_invalidate_range((uintptr_t)addr, size);
+#endif
+}
+
+/**
+ * @brief Write the dirty data cache lines of a range to memory. Replaced by
+ * the platforms with a data cache.
+ * @param addr - Start of the range.
+ * @param size - Number of bytes.
+ */
+void __attribute__((weak)) no_os_dcache_clean_range(uintptr_t addr,
+		size_t size)
+{
+}
+
+/**
+ * @brief Discard the data cache lines of a range. Replaced by the platforms
+ * with a data cache.
+ * @param addr - Start of the range.
+ * @param size - Number of bytes.
+ */
+void __attribute__((weak)) no_os_dcache_invalidate_range(uintptr_t addr,
+		size_t size)
+{
+}
+
+/**
+ * @brief Write the dirty data cache lines of a range to memory and discard
+ * them. Replaced by the platforms having a single operation for it.
+ * @param addr - Start of the range.
+ * @param size - Number of bytes.
+ */
+void __attribute__((weak)) no_os_dcache_flush_range(uintptr_t addr,
+		size_t size)
+{
+	no_os_dcache_clean_range(addr, size);
+	no_os_dcache_invalidate_range(addr, size);
+}
@@ -0,0 +1,209 @@
+/***************************************************************************//**
+ *   @file   no_os_amp.c
+ *   @brief  Implementation of the link between the cores of an AMP system.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdatomic.h>
+#include "no_os_amp.h"
+#include "no_os_delay.h"
+#include "no_os_error.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Initialize the link. Must be called by the application core before
+ * starting the device core, which waits for it with no_os_amp_link_wait.
+ * @param link - Link, in shared memory.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_amp_link_init(struct no_os_amp_link *link)
+{
+	int32_t ret;
+
+	if (!link)
+		return -EINVAL;
+
+	link->magic = 0;
+	link->dropped = 0;
+
+	ret = no_os_lffifo_cfg(&link->req, link->req_data,
+			       sizeof(struct no_os_amp_msg),
+			       NO_OS_AMP_RING_DEPTH);
+	if (ret)
+		return ret;
+
+	ret = no_os_lffifo_cfg(&link->rsp, link->rsp_data,
+			       sizeof(struct no_os_amp_msg),
+			       NO_OS_AMP_RING_DEPTH);
+	if (ret)
+		return ret;
+
+	/* The rings must be visible to the other core before the magic */
+	atomic_thread_fence(memory_order_release);
+	link->magic = NO_OS_AMP_MAGIC;
+
+	return 0;
+}
+
+/**
+ * @brief Wait until the application core initialized the link.
+ * @param link - Link, in shared memory.
+ * @param timeout_ms - Maximum time to wait, 0 to wait forever.
+ * @return 0 in case of success, -ETIMEDOUT if the link was not initialized.
+ */
+int32_t no_os_amp_link_wait(struct no_os_amp_link *link, uint32_t timeout_ms)
+{
+	uint32_t elapsed = 0;
+
+	if (!link)
+		return -EINVAL;
+
+	while (link->magic != NO_OS_AMP_MAGIC) {
+		if (timeout_ms && elapsed++ >= timeout_ms)
+			return -ETIMEDOUT;
+		no_os_mdelay(1);
+	}
+	atomic_thread_fence(memory_order_acquire);
+
+	return 0;
+}
+
+/**
+ * @brief Write a message to a ring of the link.
+ * @param link - Link.
+ * @param ring - Ring written only by the calling core.
+ * @param msg - Message.
+ * @return 0 in case of success, -ENOSPC if the ring is full.
+ */
+static int32_t no_os_amp_put(struct no_os_amp_link *link,
+			     struct no_os_lffifo *ring,
+			     const struct no_os_amp_msg *msg)
+{
+	if (!msg || link->magic != NO_OS_AMP_MAGIC)
+		return -EINVAL;
+
+	return no_os_lffifo_write(ring, msg, 1) ? 0 : -ENOSPC;
+}
+
+/**
+ * @brief Read a message from a ring of the link.
+ * @param link - Link.
+ * @param ring - Ring read only by the calling core.
+ * @param msg - Where to store the message.
+ * @return 0 in case of success, -EAGAIN if the ring is empty.
+ */
+static int32_t no_os_amp_get(struct no_os_amp_link *link,
+			     struct no_os_lffifo *ring,
+			     struct no_os_amp_msg *msg)
+{
+	if (!msg || link->magic != NO_OS_AMP_MAGIC)
+		return -EINVAL;
+
+	return no_os_lffifo_read(ring, msg, 1) ? 0 : -EAGAIN;
+}
+
+/**
+ * @brief Send a request to the device core.
+ * @param link - Link.
+ * @param msg - Request.
+ * @return 0 in case of success, -ENOSPC if the request ring is full.
+ */
+int32_t no_os_amp_request(struct no_os_amp_link *link,
+			  const struct no_os_amp_msg *msg)
+{
+	if (!link)
+		return -EINVAL;
+
+	return no_os_amp_put(link, &link->req, msg);
+}
+
+/**
+ * @brief Get the next request, on the device core.
+ * @param link - Link.
+ * @param msg - Where to store the request.
+ * @return 0 in case of success, -EAGAIN if there is no request.
+ */
+int32_t no_os_amp_get_request(struct no_os_amp_link *link,
+			      struct no_os_amp_msg *msg)
+{
+	if (!link)
+		return -EINVAL;
+
+	return no_os_amp_get(link, &link->req, msg);
+}
+
+/**
+ * @brief Send a response to the application core. A response that does not
+ * fit is counted in link->dropped.
+ * @param link - Link.
+ * @param msg - Response.
+ * @return 0 in case of success, -ENOSPC if the response ring is full.
+ */
+int32_t no_os_amp_respond(struct no_os_amp_link *link,
+			  const struct no_os_amp_msg *msg)
+{
+	int32_t ret;
+
+	if (!link)
+		return -EINVAL;
+
+	ret = no_os_amp_put(link, &link->rsp, msg);
+	if (ret == -ENOSPC)
+		link->dropped++;
+
+	return ret;
+}
+
+/**
+ * @brief Get the next response, on the application core.
+ * @param link - Link.
+ * @param msg - Where to store the response.
+ * @return 0 in case of success, -EAGAIN if there is no response.
+ */
+int32_t no_os_amp_get_response(struct no_os_amp_link *link,
+			       struct no_os_amp_msg *msg)
+{
+	if (!link)
+		return -EINVAL;
+
+	return no_os_amp_get(link, &link->rsp, msg);
+}
@@ -45,14 +45,37 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdatomic.h>
 #include "no_os_circular_buffer.h"
 #include "no_os_error.h"
 #include "no_os_util.h"
+#include "no_os_hot.h"
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
 
+/*
+ * In SPSC mode each counter has a single writer, so plain 32-bit accesses are
+ * enough. The fences order them with the accesses to the buffer data: a side
+ * sees the data of the other one only after loading its counter, and publishes
+ * its counter only after its own data accesses are done.
+ */
+static uint32_t no_os_cb_spsc_load(const uint32_t *cnt)
+{
+	uint32_t val = *(const volatile uint32_t *)cnt;
+
+	atomic_thread_fence(memory_order_acquire);
+
+	return val;
+}
+
+static void no_os_cb_spsc_store(uint32_t *cnt, uint32_t val)
+{
+	atomic_thread_fence(memory_order_release);
+	*(volatile uint32_t *)cnt = val;
+}
+
 int32_t no_os_cb_cfg(struct no_os_circular_buffer *desc, int8_t *buff,
 		     uint32_t size)
 {
@@ -104,6 +127,56 @@ int32_t no_os_cb_init(struct no_os_circular_buffer **desc, uint32_t buff_size)
 	return 0;
 }
 
+/**
+ * @brief Configure a circular buffer in lock-free SPSC mode, without memory
+ * allocation.
+ * @param desc - Circular buffer reference
+ * @param buff - Memory of the buffer
+ * @param size - Buffer size, must be a power of 2
+ * @return 0 in case of success, -EINVAL otherwise
+ */
+int32_t no_os_cb_spsc_cfg(struct no_os_circular_buffer *desc, int8_t *buff,
+			  uint32_t size)
+{
+	int32_t ret;
+
+	if (!size || (size & (size - 1)))
+		return -EINVAL;
+
+	ret = no_os_cb_cfg(desc, buff, size);
+	if (ret)
+		return ret;
+
+	desc->spsc = true;
+
+	return 0;
+}
+
+/**
+ * @brief Create a circular buffer structure in lock-free SPSC mode.
+ * One writer and one reader can use it from different contexts, including
+ * interrupts, without a critical section.
+ * @param desc - Where to store the circular buffer reference
+ * @param buff_size - Buffer size, must be a power of 2
+ * @return 0 in case of success, negative error code otherwise
+ */
+int32_t no_os_cb_spsc_init(struct no_os_circular_buffer **desc,
+			   uint32_t buff_size)
+{
+	int32_t ret;
+
+	if (!buff_size || (buff_size & (buff_size - 1)))
+		return -EINVAL;
+
+	ret = no_os_cb_init(desc, buff_size);
+	if (ret)
+		return ret;
+
+	(*desc)->spsc = true;
+
+	return 0;
+}
+
 /**
  * @brief Free the resources allocated for the circular buffer structure.
  * @param desc - Circular buffer reference
@@ -139,6 +212,12 @@ int32_t no_os_cb_size(struct no_os_circular_buffer *desc, uint32_t *size)
 	if (!desc || !size)
 		return -EINVAL;
 
+	if (desc->spsc) {
+		*size = no_os_cb_spsc_load(&desc->write.idx) -
+			no_os_cb_spsc_load(&desc->read.idx);
+		return 0;
+	}
+
 	if (desc->write.spin_count > desc->read.spin_count)
 		nb_spins = desc->write.spin_count - desc->read.spin_count;
 	else
@@ -159,6 +238,83 @@ int32_t no_os_cb_size(struct no_os_circular_buffer *desc, uint32_t *size)
 	return 0;
 }
 
+/*
+ * Get the number of bytes that can be read, or written, at this moment. In the
+ * default mode the writer may overwrite unread data, so it gets the whole
+ * buffer.
+ */
+static int32_t no_os_cb_available(struct no_os_circular_buffer *desc,
+				  bool is_read, uint32_t *available)
+{
+	int32_t ret;
+
+	if (desc->spsc) {
+		if (is_read)
+			*available = no_os_cb_spsc_load(&desc->write.idx) -
+				     desc->read.idx;
+		else
+			*available = desc->size -
+				     (desc->write.idx -
+				      no_os_cb_spsc_load(&desc->read.idx));
+
+		return 0;
+	}
+
+	if (!is_read) {
+		*available = desc->size;
+		return 0;
+	}
+
+	ret = no_os_cb_size(desc, available);
+	if (ret == -NO_OS_EOVERRUN) {
+		/* Update read index */
+		desc->read.spin_count = desc->write.spin_count - 1;
+#ifndef IIO_IGNORE_BUFF_OVERRUN_ERR
+		desc->read.idx = desc->write.idx;
+#endif
+	}
+
+	return ret;
+}
+
+/*
+ * Split the next size bytes of ptr in the region up to the end of the buffer
+ * and the one continuing from its start.
+ */
+static void no_os_cb_get_regions(struct no_os_circular_buffer *desc,
+				 struct no_os_cb_ptr *ptr, uint32_t size,
+				 struct no_os_cb_regions *regions)
+{
+	uint32_t offset;
+
+	offset = desc->spsc ? ptr->idx & (desc->size - 1) : ptr->idx;
+
+	regions->len[0] = no_os_min(size, desc->size - offset);
+	regions->buf[0] = desc->buff + offset;
+	regions->len[1] = size - regions->len[0];
+	regions->buf[1] = desc->buff;
+}
+
+/* Move ptr size bytes ahead, size being at most the buffer size */
+static void no_os_cb_advance(struct no_os_circular_buffer *desc,
+			     struct no_os_cb_ptr *ptr, uint32_t size)
+{
+	uint32_t new_val = ptr->idx + size;
+
+	if (desc->spsc) {
+		/* Publish the data, or the space, to the other side */
+		no_os_cb_spsc_store(&ptr->idx, new_val);
+		return;
+	}
+
+	/* The index wraps at most once, no modulo needed */
+	if (new_val >= desc->size) {
+		ptr->spin_count++;
+		new_val -= desc->size;
+	}
+	ptr->idx = new_val;
+}
+
 /*
  * Functionality described at no_os_cb_prepare_async_write/read having the is_read
  * parameter to specifiy if it is a read or write operation.
@@ -170,6 +326,7 @@ static int32_t no_os_cb_prepare_async_operation(struct no_os_circular_buffer
 		uint32_t *raw_size_available,
 		bool is_read)
 {
+	struct no_os_cb_regions	regions;
 	struct no_os_cb_ptr	*ptr;
 	uint32_t	available_size;
 	int32_t		ret;
@@ -177,7 +334,6 @@ static int32_t no_os_cb_prepare_async_operation(struct no_os_circular_buffer
 	if (!desc || !buff || !raw_size_available)
 		return -EINVAL;
 
-	ret = 0;
 	/* Select if read or write index will be updated */
 	ptr = is_read ? &desc->read : &desc->write;
 
@@ -185,32 +341,29 @@ static int32_t no_os_cb_prepare_async_operation(struct no_os_circular_buffer
 	if (ptr->async_started)
 		return -EBUSY;
 
-	if (is_read) {
-		ret = no_os_cb_size(desc, &available_size);
-		if (ret == -NO_OS_EOVERRUN) {
-			/* Update read index */
-			desc->read.spin_count = desc->write.spin_count - 1;
-#ifndef IIO_IGNORE_BUFF_OVERRUN_ERR
-			desc->read.idx = desc->write.idx;
-#endif
-		}
-		if (!available_size)
-			/* No data to read */
-			return 0;
+	*raw_size_available = 0;
 
-		/* We can only read available data */
-		requested_size = no_os_min(requested_size, available_size);
-		if (!requested_size)
-			return -EAGAIN;
+	ret = no_os_cb_available(desc, is_read, &available_size);
+	if (!available_size) {
+		/* In SPSC mode the writer doesn't overwrite unread data */
+		if (desc->spsc)
+			return is_read ? -EAGAIN : -ENOSPC;
+
+		/* No data to read */
+		return ret;
 	}
 
+	/* We can only read available data */
+	requested_size = no_os_min(requested_size, available_size);
+	if (!requested_size)
+		return -EAGAIN;
+
 	/* Size to end of buffer */
-	ptr->async_size = no_os_min(requested_size, desc->size - ptr->idx);
+	no_os_cb_get_regions(desc, ptr, requested_size, &regions);
+	ptr->async_size = regions.len[0];
 
 	*raw_size_available = ptr->async_size;
-
-	/* Convert index to address in the buffer */
-	*buff = (void *)(desc->buff + ptr->idx);
+	*buff = (void *)regions.buf[0];
 
 	ptr->async_started = true;
 
@@ -225,8 +378,6 @@ static int32_t no_os_cb_end_async_operation(struct no_os_circular_buffer *desc,
 		bool is_read)
 {
 	struct no_os_cb_ptr	*ptr;
-	uint32_t	new_val;
-
 
 	if (!desc)
 		return -EINVAL;
@@ -238,13 +389,7 @@ static int32_t no_os_cb_end_async_operation(struct no_os_circular_buffer *desc,
 	if (!ptr->async_started)
 		return -1;
 
-	/* Update pointer value */
-	new_val = ptr->idx + ptr->async_size;
-	if (new_val >= desc->size) {
-		ptr->spin_count++;
-		new_val %= desc->size;
-	}
-	ptr->idx = new_val;
+	no_os_cb_advance(desc, ptr, ptr->async_size);
 	ptr->async_size = 0;
 	ptr->async_started = false;
 
@@ -254,13 +399,17 @@ static int32_t no_os_cb_end_async_operation(struct no_os_circular_buffer *desc,
 /*
  * Functionality described at cb_write/read having the is_read
  * parameter to specifiy if it is a read or write operation.
+ * The data is copied with at most two memcpy calls per buffer lap.
  */
-static int32_t no_os_cb_operation(struct no_os_circular_buffer *desc,
-				  void *data, uint32_t size,
-				  bool is_read)
+NO_OS_HOT static int32_t no_os_cb_operation(struct no_os_circular_buffer *desc,
+					    void *data, uint32_t size,
+					    bool is_read)
 {
-	uint8_t		*buff;
-	uint32_t	available_size = 0;
+	struct no_os_cb_regions	regions;
+	struct no_os_cb_ptr	*ptr;
+	uint8_t		*user = data;
+	uint32_t	available_size;
+	uint32_t	chunk;
 	int32_t		ret;
 	uint32_t	i;
 	bool		sticky_overrun;
@@ -268,30 +417,38 @@ static int32_t no_os_cb_operation(struct no_os_circular_buffer *desc,
 	if (!desc || !data || !size)
 		return -EINVAL;
 
-	sticky_overrun = 0;
-	i = 0;
-	while (i < size) {
-		do {
-			ret = no_os_cb_prepare_async_operation(desc, size - i,
-							       (void **)&buff,
-							       &available_size,
-							       is_read);
-		} while (ret == -EBUSY || ret == -EAGAIN);
+	ptr = is_read ? &desc->read : &desc->write;
+
+	/* Wait for an asynchronous transaction of the same side to end */
+	while (*(volatile bool *)&ptr->async_started)
+		;
+
+	sticky_overrun = false;
+	while (size) {
+		ret = no_os_cb_available(desc, is_read, &available_size);
 		if (ret == -NO_OS_EOVERRUN)
 			sticky_overrun = true;
 
+		/* SPSC mode is non blocking, all the data is copied or none */
+		if (desc->spsc && available_size < size)
+			return is_read ? -EAGAIN : -ENOSPC;
+
 		/* If no data is available return error */
-		if(!available_size)
+		if (!available_size)
 			return -1;
 
-		if (is_read)
-			memcpy((uint8_t *)data + i, buff, available_size);
-		else
-			memcpy(buff, (uint8_t *)data + i, available_size);
-
-		no_os_cb_end_async_operation(desc, is_read);
+		chunk = no_os_min(size, available_size);
+		no_os_cb_get_regions(desc, ptr, chunk, &regions);
+		for (i = 0; i < 2 && regions.len[i]; i++) {
+			if (is_read)
+				memcpy(user, regions.buf[i], regions.len[i]);
+			else
+				memcpy(regions.buf[i], user, regions.len[i]);
+			user += regions.len[i];
+		}
+		no_os_cb_advance(desc, ptr, chunk);
 
-		i += available_size;
+		size -= chunk;
 	}
 
 	if (sticky_overrun)
@@ -300,6 +457,59 @@ static int32_t no_os_cb_operation(struct no_os_circular_buffer *desc,
 	return 0;
 }
 
+/*
+ * Functionality described at no_os_cb_peek_write/read having the is_read
+ * parameter to specifiy if it is a read or write operation.
+ */
+static int32_t no_os_cb_peek(struct no_os_circular_buffer *desc,
+			     uint32_t size, struct no_os_cb_regions *regions,
+			     bool is_read)
+{
+	struct no_os_cb_ptr	*ptr;
+	uint32_t	available_size;
+	int32_t		ret;
+
+	if (!desc || !regions)
+		return -EINVAL;
+
+	ptr = is_read ? &desc->read : &desc->write;
+	if (ptr->async_started)
+		return -EBUSY;
+
+	ret = no_os_cb_available(desc, is_read, &available_size);
+	no_os_cb_get_regions(desc, ptr, no_os_min(size, available_size),
+			     regions);
+
+	return ret;
+}
+
+/*
+ * Functionality described at no_os_cb_commit_write/read having the is_read
+ * parameter to specifiy if it is a read or write operation.
+ */
+static int32_t no_os_cb_commit(struct no_os_circular_buffer *desc,
+			       uint32_t size, bool is_read)
+{
+	struct no_os_cb_ptr	*ptr;
+	uint32_t	available_size;
+	int32_t		ret;
+
+	if (!desc)
+		return -EINVAL;
+
+	ptr = is_read ? &desc->read : &desc->write;
+	if (ptr->async_started)
+		return -EBUSY;
+
+	ret = no_os_cb_available(desc, is_read, &available_size);
+	if (size > available_size)
+		return -EINVAL;
+
+	no_os_cb_advance(desc, ptr, size);
+
+	return ret;
+}
+
 /**
  * @brief Prepare asynchronous write.
  *
@@ -380,8 +590,8 @@ int32_t no_os_cb_end_async_read(struct no_os_circular_buffer *desc)
  *  - 0 - No errors
  *  - -EINVAL      - Wrong parameters used
  */
-int32_t no_os_cb_write(struct no_os_circular_buffer *desc, const void *data,
-		       uint32_t size)
+NO_OS_HOT int32_t no_os_cb_write(struct no_os_circular_buffer *desc,
+				 const void *data, uint32_t size)
 {
 	return no_os_cb_operation(desc, (void *)data, size, 0);
 }
@@ -401,3 +611,47 @@ int32_t no_os_cb_read(struct no_os_circular_buffer *desc, void *data,
 {
 	return no_os_cb_operation(desc, data, size, 1);
 }
+
+/**
+ * \defgroup peek_commit_group Zero-copy access
+ * @brief Get the contiguous regions where the next data is to be written to,
+ * or read from, and then commit the number of bytes actually used.
+ *
+ * Peek returns regions summing up to no_os_min(size, available bytes). The
+ * second region is only used when the data wraps at the end of the buffer.
+ * Commit must not exceed what was returned by the last peek.
+ *
+ * @param desc - Circular buffer reference
+ * @param size - Number of bytes requested, or used
+ * @param regions - Where to store the regions
+ * @return
+ *  - 0   - No errors
+ *  - -EINVAL   - Wrong parameters used
+ *  - -EBUSY    - Asynchronous transaction already started
+ *  - -NO_OS_EOVERRUN - An overrun occurred and some data have been overwritten
+ * @{
+ */
+int32_t no_os_cb_peek_write(struct no_os_circular_buffer *desc, uint32_t size,
+			    struct no_os_cb_regions *regions)
+{
+	return no_os_cb_peek(desc, size, regions, 0);
+}
+
+int32_t no_os_cb_commit_write(struct no_os_circular_buffer *desc,
+			      uint32_t size)
+{
+	return no_os_cb_commit(desc, size, 0);
+}
+
+int32_t no_os_cb_peek_read(struct no_os_circular_buffer *desc, uint32_t size,
+			   struct no_os_cb_regions *regions)
+{
+	return no_os_cb_peek(desc, size, regions, 1);
+}
+
+int32_t no_os_cb_commit_read(struct no_os_circular_buffer *desc,
+			     uint32_t size)
+{
+	return no_os_cb_commit(desc, size, 1);
+}
+/** @} */
@@ -46,6 +46,46 @@
 /******************************************************************************/
 /************************** Functions Implementation **************************/
 /******************************************************************************/
+/**
+ * Remove a clock from the children of its parent.
+ * @param desc - CLK descriptor.
+ */
+static void no_os_clk_unlink(struct no_os_clk_desc *desc)
+{
+	struct no_os_clk_desc **link;
+
+	if (!desc->parent)
+		return;
+
+	for (link = &desc->parent->first_child; *link;
+	     link = &(*link)->next_sibling) {
+		if (*link == desc) {
+			*link = desc->next_sibling;
+			break;
+		}
+	}
+
+	desc->parent = NULL;
+	desc->next_sibling = NULL;
+}
+
+/**
+ * Number of clocks between a clock and the root of its tree.
+ * @param desc - CLK descriptor.
+ * @return the depth, 0 for a root.
+ */
+static uint32_t no_os_clk_depth(struct no_os_clk_desc *desc)
+{
+	uint32_t depth = 0;
+
+	while (desc->parent) {
+		desc = desc->parent;
+		depth++;
+	}
+
+	return depth;
+}
+
 /**
  * Initialize clock.
  * @param desc - CLK descriptor.
@@ -68,12 +108,25 @@ int32_t no_os_clk_init(struct no_os_clk_desc **desc,
 		return -EINVAL;
 
 	(*desc)->platform_ops = param->platform_ops;
+	(*desc)->flags = param->flags;
+	(*desc)->rate_valid = false;
+	(*desc)->txn_pending = false;
+	(*desc)->txn_next = NULL;
+	(*desc)->first_child = NULL;
+	(*desc)->parent = param->parent;
+	if (param->parent) {
+		(*desc)->next_sibling = param->parent->first_child;
+		param->parent->first_child = *desc;
+	} else {
+		(*desc)->next_sibling = NULL;
+	}
 
 	return 0;
 }
 
 /**
- * @brief Free the resources allocated by no_os_clk_init().
+ * @brief Free the resources allocated by no_os_clk_init(). The clocks fed by
+ * this one must be removed first.
  * @param desc - The clock descriptor.
  * @return 0 in case of success, -1 otherwise.
  */
@@ -85,6 +138,11 @@ int32_t no_os_clk_remove(struct no_os_clk_desc *desc)
 	if (!desc->platform_ops->remove)
 		return -ENOSYS;
 
+	if (desc->first_child || desc->txn_pending)
+		return -EBUSY;
+
+	no_os_clk_unlink(desc);
+
 	return desc->platform_ops->remove(desc);
 }
 
@@ -121,7 +179,8 @@ int32_t no_os_clk_disable(struct no_os_clk_desc *desc)
 }
 
 /**
- * Get the current frequency of the clock.
+ * Get the current frequency of the clock. The provider is only asked once,
+ * until the rate of the clock or of one of its parents is changed.
  * @param clk - The clock descriptor.
  * @param rate - The current frequency.
  * @return 0 in case of success, negative error code otherwise.
@@ -129,13 +188,27 @@ int32_t no_os_clk_disable(struct no_os_clk_desc *desc)
 int32_t no_os_clk_recalc_rate(struct no_os_clk_desc *desc,
 			      uint64_t *rate)
 {
+	int32_t ret;
+
 	if (!desc || !desc->platform_ops || !rate)
 		return -EINVAL;
 
+	if (desc->rate_valid && !(desc->flags & NO_OS_CLK_GET_RATE_NOCACHE)) {
+		*rate = desc->rate;
+		return 0;
+	}
+
 	if (!desc->platform_ops->clk_recalc_rate)
 		return -ENOSYS;
 
-	return desc->platform_ops->clk_recalc_rate(desc, rate);
+	ret = desc->platform_ops->clk_recalc_rate(desc, rate);
+	if (ret)
+		return ret;
+
+	desc->rate = *rate;
+	desc->rate_valid = true;
+
+	return 0;
 }
 
 /**
@@ -159,7 +232,8 @@ int32_t no_os_clk_round_rate(struct no_os_clk_desc *desc,
 }
 
 /**
- * Change the frequency of the clock.
+ * Change the frequency of the clock. The cached rates of the clock and of
+ * the clocks it feeds are dropped, they are read again when requested.
  * @param clk - The clock descriptor.
  * @param rate - The desired frequency.
  * @return 0 in case of success, negative error code otherwise.
@@ -167,11 +241,144 @@ int32_t no_os_clk_round_rate(struct no_os_clk_desc *desc,
 int32_t no_os_clk_set_rate(struct no_os_clk_desc *desc,
 			   uint64_t rate)
 {
+	int32_t ret;
+
 	if (!desc || !desc->platform_ops)
 		return -EINVAL;
 
 	if (!desc->platform_ops->clk_set_rate)
 		return -ENOSYS;
 
-	return desc->platform_ops->clk_set_rate(desc, rate);
+	ret = desc->platform_ops->clk_set_rate(desc, rate);
+	/* Even a failed change may have touched the hardware */
+	no_os_clk_invalidate(desc);
+
+	return ret;
+}
+
+/**
+ * Drop the cached rates of the clock and of the clocks it feeds, for example
+ * after reprogramming the provider directly.
+ * @param desc - The clock descriptor.
+ */
+void no_os_clk_invalidate(struct no_os_clk_desc *desc)
+{
+	struct no_os_clk_desc *child;
+
+	if (!desc)
+		return;
+
+	desc->rate_valid = false;
+	for (child = desc->first_child; child; child = child->next_sibling)
+		no_os_clk_invalidate(child);
+}
+
+/**
+ * Start an empty transaction.
+ * @param txn - The transaction.
+ */
+void no_os_clk_txn_init(struct no_os_clk_txn *txn)
+{
+	txn->head = NULL;
+}
+
+/**
+ * Request a rate change in a transaction. Nothing is written to the provider
+ * before no_os_clk_txn_commit(), a second request for the same clock replaces
+ * the first one.
+ * @param txn - The transaction.
+ * @param desc - The clock descriptor.
+ * @param rate - The desired frequency.
+ * @return 0 in case of success, -EBUSY if the clock is part of another
+ * transaction, negative error code otherwise.
+ */
+int32_t no_os_clk_txn_set_rate(struct no_os_clk_txn *txn,
+			       struct no_os_clk_desc *desc,
+			       uint64_t rate)
+{
+	struct no_os_clk_desc *clk;
+
+	if (!txn || !desc || !desc->platform_ops)
+		return -EINVAL;
+
+	if (!desc->platform_ops->clk_set_rate)
+		return -ENOSYS;
+
+	if (desc->txn_pending) {
+		for (clk = txn->head; clk && clk != desc; clk = clk->txn_next)
+			;
+		if (!clk)
+			return -EBUSY;
+	} else {
+		desc->txn_pending = true;
+		desc->txn_next = txn->head;
+		txn->head = desc;
+	}
+
+	desc->txn_rate = rate;
+
+	return 0;
+}
+
+/**
+ * Apply the rate changes of a transaction. The parents are changed before
+ * the clocks they feed and the cached rates are dropped once all the changes
+ * are done. The transaction is empty when the function returns, the changes
+ * following a failing one are not applied.
+ * @param txn - The transaction.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_clk_txn_commit(struct no_os_clk_txn *txn)
+{
+	struct no_os_clk_desc *clk;
+	uint32_t max_depth = 0;
+	uint32_t depth;
+	uint32_t d;
+	int32_t ret = 0;
+
+	if (!txn)
+		return -EINVAL;
+
+	for (clk = txn->head; clk; clk = clk->txn_next) {
+		depth = no_os_clk_depth(clk);
+		if (depth > max_depth)
+			max_depth = depth;
+	}
+
+	for (d = 0; d <= max_depth && !ret; d++) {
+		for (clk = txn->head; clk; clk = clk->txn_next) {
+			if (no_os_clk_depth(clk) != d)
+				continue;
+
+			ret = clk->platform_ops->clk_set_rate(clk,
+							      clk->txn_rate);
+			if (ret)
+				break;
+		}
+	}
+
+	for (clk = txn->head; clk; clk = clk->txn_next)
+		no_os_clk_invalidate(clk);
+	no_os_clk_txn_abort(txn);
+
+	return ret;
+}
+
+/**
+ * Drop the rate changes of a transaction, the clocks are left untouched.
+ * @param txn - The transaction.
+ */
+void no_os_clk_txn_abort(struct no_os_clk_txn *txn)
+{
+	struct no_os_clk_desc *clk;
+
+	if (!txn)
+		return;
+
+	while (txn->head) {
+		clk = txn->head;
+		txn->head = clk->txn_next;
+		clk->txn_next = NULL;
+		clk->txn_pending = false;
+	}
 }
@@ -0,0 +1,229 @@
+/***************************************************************************//**
+ *   @file   no_os_conv.c
+ *   @brief  Raw to physical value conversion using precomputed multipliers.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "no_os_conv.h"
+#include "no_os_error.h"
+#ifdef NO_OS_CMSIS_DSP
+#include "arm_math.h"
+#endif
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Get the high 64 bits of the 128-bit product of a and b, using only
+ * 32x32 bit multiplications.
+ * @param a - First operand.
+ * @param b - Second operand.
+ * @return (a * b) >> 64
+ */
+static uint64_t no_os_conv_mulhi(uint64_t a, uint64_t b)
+{
+	uint64_t lo_lo = (uint64_t)(uint32_t)a * (uint32_t)b;
+	uint64_t hi_lo = (a >> 32) * (uint32_t)b;
+	uint64_t lo_hi = (uint64_t)(uint32_t)a * (b >> 32);
+	uint64_t hi_hi = (a >> 32) * (b >> 32);
+	uint64_t cross = (lo_lo >> 32) + (uint32_t)hi_lo + lo_hi;
+
+	return hi_hi + (hi_lo >> 32) + (cross >> 32);
+}
+
+/**
+ * @brief Compute (raw + offset) * num / den, rounded toward zero.
+ * @param conv - The conversion.
+ * @param raw - Raw sample.
+ * @param rem - Remainder of the division, with the sign of the dividend.
+ * @return The quotient.
+ */
+static int64_t no_os_conv_div(const struct no_os_conv *conv, int32_t raw,
+			      int32_t *rem)
+{
+	int64_t val = ((int64_t)raw + conv->offset) * conv->num;
+	uint64_t mag = val < 0 ? -(uint64_t)val : (uint64_t)val;
+	uint64_t q;
+	uint64_t r;
+
+	/* The reciprocal underestimates the quotient by at most 2 */
+	q = no_os_conv_mulhi(mag, conv->recip);
+	r = mag - q * conv->den;
+	while (r >= conv->den) {
+		r -= conv->den;
+		q++;
+	}
+
+	if (val < 0) {
+		*rem = -(int32_t)r;
+		return -(int64_t)q;
+	}
+
+	*rem = r;
+
+	return q;
+}
+
+#ifdef NO_OS_CMSIS_DSP
+/**
+ * @brief Express num / den as a q31_t fraction in [0.5, 1) and a power of 2.
+ * @param conv - The conversion.
+ */
+static void no_os_conv_init_q31(struct no_os_conv *conv)
+{
+	uint64_t mag = conv->num < 0 ? -(int64_t)conv->num : conv->num;
+	uint64_t d = conv->den;
+	int8_t shift = 0;
+	uint32_t fract = 0;
+	int i;
+
+	conv->q31_fract = 0;
+	conv->q31_shift = 0;
+	if (!mag)
+		return;
+
+	/* Normalize so that 1/2 <= mag / d < 1 */
+	while (mag >= d) {
+		d <<= 1;
+		shift++;
+	}
+	while (mag < d - mag) {
+		if (shift == -31)
+			return;
+		mag <<= 1;
+		shift--;
+	}
+
+	/* Long division for the 31 fractional bits */
+	for (i = 0; i < 31; i++) {
+		fract <<= 1;
+		if (mag >= d - mag) {
+			mag -= d - mag;
+			fract |= 1;
+		} else {
+			mag <<= 1;
+		}
+	}
+
+	conv->q31_fract = conv->num < 0 ? -(int32_t)fract : (int32_t)fract;
+	conv->q31_shift = shift;
+}
+#endif
+
+/**
+ * @brief Precompute the conversion of raw samples to
+ * (raw + offset) * num / den.
+ * This is the only place where a division is done.
+ * @param conv - The conversion.
+ * @param offset - Offset added to the raw value before scaling.
+ * @param num - Scale numerator.
+ * @param den - Scale denominator, at most INT32_MAX, for example the unit of
+ * the fractional part.
+ * @return 0 in case of success, -EINVAL for wrong parameters.
+ */
+int32_t no_os_conv_init(struct no_os_conv *conv, int32_t offset, int32_t num,
+			uint32_t den)
+{
+	if (!conv || !den || den > INT32_MAX)
+		return -EINVAL;
+
+	conv->offset = offset;
+	conv->num = num;
+	conv->den = den;
+	conv->recip = UINT64_MAX / den;
+#ifdef NO_OS_CMSIS_DSP
+	no_os_conv_init_q31(conv);
+#endif
+
+	return 0;
+}
+
+/**
+ * @brief Convert one sample. The result matches no_os_div_s64_rem applied to
+ * (raw + offset) * num and den.
+ * @param conv - The conversion.
+ * @param raw - Raw sample.
+ * @param fractional - Fractional part, in 1 / den units. May be NULL.
+ * @return The integer part of the result.
+ */
+int64_t no_os_conv_frac(const struct no_os_conv *conv, int32_t raw,
+			int32_t *fractional)
+{
+	int32_t rem;
+	int64_t q;
+
+	q = no_os_conv_div(conv, raw, &rem);
+	if (fractional)
+		*fractional = rem;
+
+	return q;
+}
+
+/**
+ * @brief Convert a buffer of samples, keeping the integer part of each result,
+ * saturated to the int32_t range. With NO_OS_CMSIS_DSP defined the CMSIS-DSP
+ * q31 functions are used instead. They keep 31 bits of the scale and round
+ * toward minus infinity, so the result is not exact in the last bits.
+ * @param conv - The conversion.
+ * @param raw - Raw samples.
+ * @param out - Converted samples. May be the same buffer as raw.
+ * @param nb - Number of samples.
+ */
+void no_os_conv_batch(const struct no_os_conv *conv, const int32_t *raw,
+		      int32_t *out, uint32_t nb)
+{
+#ifdef NO_OS_CMSIS_DSP
+	arm_offset_q31((q31_t *)raw, conv->offset, out, nb);
+	arm_scale_q31(out, conv->q31_fract, conv->q31_shift, out, nb);
+#else
+	int32_t rem;
+	int64_t q;
+	uint32_t i;
+
+	for (i = 0; i < nb; i++) {
+		q = no_os_conv_div(conv, raw[i], &rem);
+		if (q > INT32_MAX)
+			q = INT32_MAX;
+		else if (q < INT32_MIN)
+			q = INT32_MIN;
+		out[i] = q;
+	}
+#endif
+}
@@ -101,3 +101,65 @@ uint16_t no_os_crc16(const uint16_t * table, const uint8_t *pdata,
 
 	return crc;
 }
+
+/***************************************************************************//**
+ * @brief Creates the slicing-by-8 lookup tables for a given polynomial.
+ *
+ * table[0] is the table created by no_os_crc16_populate_msb() and table[k]
+ * gives the CRC of a byte followed by k zero bytes.
+ *
+ * @param table      - CRC-16 slicing tables to write to.
+ * @param polynomial - msb-first representation of desired polynomial.
+ *
+ * @return None.
+*******************************************************************************/
+void no_os_crc16_populate_slice_msb(uint16_t table[][NO_OS_CRC16_TABLE_SIZE],
+				   const uint16_t polynomial)
+{
+	uint16_t prev;
+
+	if (!table)
+		return;
+
+	no_os_crc16_populate_msb(table[0], polynomial);
+	for (int16_t n = 0; n < NO_OS_CRC16_TABLE_SIZE; n++) {
+		for (uint8_t k = 1; k < NO_OS_CRC_SLICES; k++) {
+			prev = table[k - 1][n];
+			table[k][n] = ((prev << 8) ^ table[0][prev >> 8]) &
+				      0xffff;
+		}
+	}
+}
+
+/***************************************************************************//**
+ * @brief Computes the CRC-16 over a buffer of data, 8 bytes at a time.
+ *
+ * Gives the same result as no_os_crc16() with less work per byte, for long
+ * buffers.
+ *
+ * @param table     - CRC-16 slicing tables created by
+ *                    no_os_crc16_populate_slice_msb().
+ * @param pdata     - Pointer to data buffer.
+ * @param nbytes    - Number of bytes to compute the CRC-16 over.
+ * @param crc       - Initial value for the CRC-16 computation.
+ *
+ * @return crc      - Computed CRC-16 value.
+*******************************************************************************/
+uint16_t no_os_crc16_slice8(const uint16_t table[][NO_OS_CRC16_TABLE_SIZE],
+			    const uint8_t *pdata, size_t nbytes, uint16_t crc)
+{
+	while (nbytes >= NO_OS_CRC_SLICES) {
+		crc = table[7][pdata[0] ^ ((crc >> 8) & 0xff)] ^
+		      table[6][pdata[1] ^ (crc & 0xff)] ^
+		      table[5][pdata[2]] ^
+		      table[4][pdata[3]] ^
+		      table[3][pdata[4]] ^
+		      table[2][pdata[5]] ^
+		      table[1][pdata[6]] ^
+		      table[0][pdata[7]];
+		pdata += NO_OS_CRC_SLICES;
+		nbytes -= NO_OS_CRC_SLICES;
+	}
+
+	return no_os_crc16(table[0], pdata, nbytes, crc);
+}
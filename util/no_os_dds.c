@@ -0,0 +1,248 @@
+/***************************************************************************//**
+ *   @file   no_os_dds.c
+ *   @brief  Fixed-point waveform synthesis using a phase accumulator.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "no_os_dds.h"
+#include "no_os_error.h"
+#include "no_os_util.h"
+#if defined(__ARM_FEATURE_SAT)
+#include <arm_acle.h>
+#endif
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* no_os_sine_lut_16 holds 2^9 points of an offset binary sine period */
+#define NO_OS_DDS_LUT_BITS	9
+
+extern const uint16_t no_os_sine_lut_16[1 << NO_OS_DDS_LUT_BITS];
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Saturate a sum of tones to 16 bits, in one instruction on the cores
+ * having the saturation ones.
+ * @param val - Sum of tones.
+ * @return Saturated value.
+ */
+static inline int32_t no_os_dds_sat16(int32_t val)
+{
+#if defined(__ARM_FEATURE_SAT)
+	return __ssat(val, 16);
+#else
+	return no_os_clamp(val, INT16_MIN, INT16_MAX);
+#endif
+}
+
+/**
+ * @brief Look up the sine, interpolating linearly between the table points
+ * with the next 16 bits of the phase.
+ * @param phase - Phase word.
+ * @return Sine in Q15.
+ */
+static inline int32_t no_os_dds_lut(uint32_t phase)
+{
+	uint32_t idx = phase >> (32 - NO_OS_DDS_LUT_BITS);
+	uint32_t frac = (phase >> (16 - NO_OS_DDS_LUT_BITS)) & 0xFFFF;
+	int32_t a, b;
+
+	a = (int32_t)no_os_sine_lut_16[idx] - 0x8000;
+	idx = (idx + 1) & ((1 << NO_OS_DDS_LUT_BITS) - 1);
+	b = (int32_t)no_os_sine_lut_16[idx] - 0x8000;
+
+	return a + (((b - a) * (int32_t)frac) >> 16);
+}
+
+/**
+ * @brief Compute the phase increment of a tone.
+ * @param freq_hz - Frequency of the tone, below fs_hz.
+ * @param fs_hz - Sampling frequency.
+ * @return Phase increment, 0 for a null sampling frequency.
+ */
+uint32_t no_os_dds_ftw(uint64_t freq_hz, uint64_t fs_hz)
+{
+	if (!fs_hz)
+		return 0;
+
+	return (uint32_t)(((freq_hz << 32) + fs_hz / 2) / fs_hz);
+}
+
+/**
+ * @brief Compute the phase increment of the tone closest to freq_hz with a
+ * whole number of periods in nb_samples, so a buffer of nb_samples can be
+ * played cyclically without a phase jump. Exact when nb_samples is a power
+ * of 2.
+ * @param freq_hz - Frequency of the tone, below fs_hz.
+ * @param fs_hz - Sampling frequency.
+ * @param nb_samples - Number of samples of the buffer.
+ * @return Phase increment, 0 for a null sampling frequency or nb_samples.
+ */
+uint32_t no_os_dds_ftw_periodic(uint64_t freq_hz, uint64_t fs_hz,
+				uint32_t nb_samples)
+{
+	uint64_t periods;
+
+	if (!fs_hz || !nb_samples)
+		return 0;
+
+	periods = (freq_hz * nb_samples + fs_hz / 2) / fs_hz;
+
+	return (uint32_t)((periods << 32) / nb_samples);
+}
+
+/**
+ * @brief Initialize a generator without tones.
+ * @param dds - The generator.
+ * @param bits - Resolution of the samples, from 1 to 16.
+ * @param format - Coding of the samples.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_dds_init(struct no_os_dds *dds, uint8_t bits,
+		       enum no_os_dds_format format)
+{
+	if (!dds || !bits || bits > 16)
+		return -EINVAL;
+
+	dds->nb_tones = 0;
+	dds->bits = bits;
+	dds->format = format;
+
+	return 0;
+}
+
+/**
+ * @brief Add a tone to the generator.
+ * @param dds - The generator.
+ * @param ftw - Phase increment, see no_os_dds_ftw().
+ * @param phase - Initial phase, see NO_OS_DDS_PHASE_DEG().
+ * @param scale - Amplitude, up to NO_OS_DDS_FULL_SCALE.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_dds_add_tone(struct no_os_dds *dds, uint32_t ftw,
+			   uint32_t phase, uint16_t scale)
+{
+	struct no_os_dds_tone *tone;
+
+	if (!dds || scale > NO_OS_DDS_FULL_SCALE)
+		return -EINVAL;
+
+	if (dds->nb_tones == NO_OS_DDS_MAX_TONES)
+		return -ENOSPC;
+
+	tone = &dds->tones[dds->nb_tones++];
+	tone->ftw = ftw;
+	tone->phase = phase;
+	tone->scale = scale;
+
+	return 0;
+}
+
+/**
+ * @brief Sine of a phase word.
+ * @param phase - Phase word, a full turn being 2^32.
+ * @return Sine in Q15.
+ */
+int16_t no_os_dds_sin(uint32_t phase)
+{
+	return no_os_dds_lut(phase);
+}
+
+/**
+ * @brief Generate the next samples. The phase of the tones is kept, so the
+ * waveform continues over successive blocks.
+ * @param dds - The generator.
+ * @param buf - Where to write the samples.
+ * @param nb_samples - Number of samples.
+ * @param stride - Distance between samples in buf, in samples.
+ * @return None.
+ */
+void no_os_dds_generate(struct no_os_dds *dds, uint16_t *buf,
+			uint32_t nb_samples, uint32_t stride)
+{
+	uint32_t phase[NO_OS_DDS_MAX_TONES];
+	uint32_t shift = 16 - dds->bits;
+	uint32_t mask = NO_OS_GENMASK(dds->bits - 1, 0);
+	uint32_t sign = 0;
+	uint32_t i, t;
+	int32_t acc;
+
+	if (dds->format == NO_OS_DDS_OFFSET_BINARY)
+		sign = NO_OS_BIT(dds->bits - 1);
+
+	for (t = 0; t < dds->nb_tones; t++)
+		phase[t] = dds->tones[t].phase;
+
+	for (i = 0; i < nb_samples; i++) {
+		acc = 0;
+		for (t = 0; t < dds->nb_tones; t++) {
+			acc += (no_os_dds_lut(phase[t]) *
+				(int32_t)dds->tones[t].scale) >> 15;
+			phase[t] += dds->tones[t].ftw;
+		}
+
+		acc = no_os_dds_sat16(acc) >> shift;
+		buf[i * stride] = ((uint32_t)acc ^ sign) & mask;
+	}
+
+	for (t = 0; t < dds->nb_tones; t++)
+		dds->tones[t].phase = phase[t];
+}
+
+/**
+ * @brief Generate the next scans of interleaved channels, as expected by the
+ * DMA of the multichannel DACs.
+ * @param dds - Array of nb_ch generators, one for each channel of a scan.
+ * @param nb_ch - Number of channels.
+ * @param buf - Where to write the scans.
+ * @param nb_samples - Number of scans.
+ * @return None.
+ */
+void no_os_dds_generate_interleaved(struct no_os_dds *dds, uint32_t nb_ch,
+				    uint16_t *buf, uint32_t nb_samples)
+{
+	uint32_t ch;
+
+	for (ch = 0; ch < nb_ch; ch++)
+		no_os_dds_generate(&dds[ch], buf + ch, nb_samples, nb_ch);
+}
@@ -0,0 +1,397 @@
+/***************************************************************************//**
+ *   @file   no_os_fft.c
+ *   @brief  Fixed-point FFT and averaged spectrum.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "no_os_fft.h"
+#include "no_os_dds.h"
+#include "no_os_alloc.h"
+#include "no_os_error.h"
+#include "no_os_util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Phase word of a quarter turn, turning a sine into a cosine */
+#define NO_OS_FFT_QUARTER	0x40000000u
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Cosine of a phase word, in Q15.
+ * @param phase - Phase word, a full turn is 2^32.
+ * @return Cosine.
+ */
+static int16_t no_os_fft_cos(uint32_t phase)
+{
+	return no_os_dds_sin(phase + NO_OS_FFT_QUARTER);
+}
+
+/**
+ * @brief Compute the window coefficients.
+ * @param fft - The spectrum.
+ */
+static void no_os_fft_window_init(struct no_os_fft *fft)
+{
+	uint32_t i, phase;
+	int32_t c;
+
+	for (i = 0; i < fft->size; i++) {
+		phase = (uint32_t)(((uint64_t)i << 32) >> fft->log2_size);
+		c = no_os_fft_cos(phase);
+		if (fft->window == NO_OS_FFT_WINDOW_HANN)
+			/* 0.5 - 0.5 cos */
+			fft->coef[i] = (32767 - c) >> 1;
+		else
+			/* 0.54 - 0.46 cos, 0.46 being 15073 in Q15 */
+			fft->coef[i] = 17694 - ((c * 15073) >> 15);
+	}
+}
+
+/**
+ * @brief In place radix-2 decimation in time FFT of fft->work. Each stage
+ * halves the values, so the result is the transform scaled by 1/size and
+ * never overflows.
+ * @param fft - The spectrum.
+ */
+static void no_os_fft_transform(struct no_os_fft *fft)
+{
+#ifdef NO_OS_FFT_CMSIS_DSP
+	arm_cfft_q15(&fft->cfft, fft->work, 0, 1);
+#else
+	int16_t *x = fft->work;
+	uint32_t n = fft->size;
+	uint32_t i, j, k, len, half, step;
+	int32_t wr, wi, tr, ti, ar, ai;
+	int16_t tmp;
+
+	/* Bit reversed order */
+	for (i = 1, j = 0; i < n; i++) {
+		k = n >> 1;
+		while (j & k) {
+			j ^= k;
+			k >>= 1;
+		}
+		j |= k;
+		if (i < j) {
+			tmp = x[2 * i];
+			x[2 * i] = x[2 * j];
+			x[2 * j] = tmp;
+			tmp = x[2 * i + 1];
+			x[2 * i + 1] = x[2 * j + 1];
+			x[2 * j + 1] = tmp;
+		}
+	}
+
+	for (len = 2; len <= n; len <<= 1) {
+		half = len >> 1;
+		step = n / len;
+		for (i = 0; i < n; i += len) {
+			for (j = 0; j < half; j++) {
+				wr = fft->twiddle[2 * j * step];
+				wi = fft->twiddle[2 * j * step + 1];
+				k = 2 * (i + j + half);
+				tr = (x[k] * wr - x[k + 1] * wi) >> 15;
+				ti = (x[k] * wi + x[k + 1] * wr) >> 15;
+				ar = x[2 * (i + j)];
+				ai = x[2 * (i + j) + 1];
+				x[k] = (ar - tr) >> 1;
+				x[k + 1] = (ai - ti) >> 1;
+				x[2 * (i + j)] = (ar + tr) >> 1;
+				x[2 * (i + j) + 1] = (ai + ti) >> 1;
+			}
+		}
+	}
+#endif
+}
+
+/**
+ * @brief Transform the block loaded in fft->work and add its power to the
+ * average.
+ * @param fft - The spectrum.
+ * @return 1 if the average is complete, 0 otherwise.
+ */
+static int32_t no_os_fft_accumulate(struct no_os_fft *fft)
+{
+	int32_t re, im;
+	uint32_t i;
+
+	no_os_fft_transform(fft);
+
+	/* The input is real, the upper half mirrors the lower one */
+	for (i = 0; i < fft->size / 2; i++) {
+		re = fft->work[2 * i];
+		im = fft->work[2 * i + 1];
+		fft->acc[i] += (uint32_t)(re * re) + (uint32_t)(im * im);
+	}
+
+	if (fft->count < fft->nb_avg)
+		fft->count++;
+
+	return fft->count == fft->nb_avg;
+}
+
+/**
+ * @brief Integer square root.
+ * @param x - Value.
+ * @return floor(sqrt(x)).
+ */
+static uint32_t no_os_fft_isqrt(uint64_t x)
+{
+	uint64_t res = 0;
+	uint64_t bit = 1ull << 62;
+
+	while (bit > x)
+		bit >>= 2;
+
+	while (bit) {
+		if (x >= res + bit) {
+			x -= res + bit;
+			res = (res >> 1) + bit;
+		} else {
+			res >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return res;
+}
+
+/**
+ * @brief Allocate a spectrum and precompute the window and the twiddle
+ * factors.
+ * @param fft - Where to store the spectrum.
+ * @param size - Points of the FFT, a power of 2 from NO_OS_FFT_MIN_SIZE to
+ * NO_OS_FFT_MAX_SIZE.
+ * @param window - Window applied to the blocks.
+ * @param nb_avg - Number of blocks of an average, at least 1.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_fft_init(struct no_os_fft **fft, uint32_t size,
+		       enum no_os_fft_window window, uint32_t nb_avg)
+{
+	struct no_os_fft *f;
+	uint32_t i, phase;
+
+	if (!fft || !nb_avg || size < NO_OS_FFT_MIN_SIZE ||
+	    size > NO_OS_FFT_MAX_SIZE || (size & (size - 1)))
+		return -EINVAL;
+
+	f = no_os_calloc(1, sizeof(*f));
+	if (!f)
+		return -ENOMEM;
+
+	f->size = size;
+	f->log2_size = no_os_find_first_set_bit(size);
+	f->window = window;
+	f->nb_avg = nb_avg;
+
+	f->twiddle = no_os_calloc(size, sizeof(*f->twiddle));
+	f->work = no_os_calloc(2 * size, sizeof(*f->work));
+	f->acc = no_os_calloc(size / 2, sizeof(*f->acc));
+	if (!f->twiddle || !f->work || !f->acc)
+		goto error;
+
+	if (window != NO_OS_FFT_WINDOW_RECT) {
+		f->coef = no_os_calloc(size, sizeof(*f->coef));
+		if (!f->coef)
+			goto error;
+		no_os_fft_window_init(f);
+	}
+
+	for (i = 0; i < size / 2; i++) {
+		phase = (uint32_t)(((uint64_t)i << 32) >> f->log2_size);
+		f->twiddle[2 * i] = no_os_fft_cos(phase);
+		f->twiddle[2 * i + 1] = -no_os_dds_sin(phase);
+	}
+
+#ifdef NO_OS_FFT_CMSIS_DSP
+	if (arm_cfft_init_q15(&f->cfft, size) != ARM_MATH_SUCCESS)
+		goto error;
+#endif
+
+	*fft = f;
+
+	return 0;
+
+error:
+	no_os_fft_remove(f);
+
+	return -ENOMEM;
+}
+
+/**
+ * @brief Free a spectrum.
+ * @param fft - The spectrum.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_fft_remove(struct no_os_fft *fft)
+{
+	if (!fft)
+		return -EINVAL;
+
+	no_os_free(fft->acc);
+	no_os_free(fft->work);
+	no_os_free(fft->twiddle);
+	no_os_free(fft->coef);
+	no_os_free(fft);
+
+	return 0;
+}
+
+/**
+ * @brief Drop the blocks summed so far and set the length of the average.
+ * @param fft - The spectrum.
+ * @param nb_avg - Number of blocks of an average, at least 1.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_fft_reset(struct no_os_fft *fft, uint32_t nb_avg)
+{
+	uint32_t i;
+
+	if (!fft || !nb_avg)
+		return -EINVAL;
+
+	for (i = 0; i < fft->size / 2; i++)
+		fft->acc[i] = 0;
+	fft->count = 0;
+	fft->nb_avg = nb_avg;
+
+	return 0;
+}
+
+/**
+ * @brief Window and transform a block of fft->size samples and add its
+ * power to the average. Once the average is complete the new blocks are
+ * ignored until no_os_fft_get_magnitude() is called.
+ * @param fft - The spectrum.
+ * @param samples - The block, e.g. one channel of an interleaved capture.
+ * @param stride - Distance between two samples of the block, 1 if they are
+ * contiguous.
+ * @return 1 if the average is complete, 0 if more blocks are needed,
+ * negative error code otherwise.
+ */
+int32_t no_os_fft_add_block(struct no_os_fft *fft, const int16_t *samples,
+			    uint32_t stride)
+{
+	uint32_t i;
+
+	if (!fft || !samples || !stride)
+		return -EINVAL;
+
+	if (fft->count == fft->nb_avg)
+		return 1;
+
+	for (i = 0; i < fft->size; i++) {
+		fft->work[2 * i] = fft->coef ?
+				   (samples[i * stride] * fft->coef[i]) >> 15 :
+				   samples[i * stride];
+		fft->work[2 * i + 1] = 0;
+	}
+
+	return no_os_fft_accumulate(fft);
+}
+
+/**
+ * @brief Same as no_os_fft_add_block(), for samples wider than 16 bits,
+ * e.g. 24 bit conversions sign extended in 32 bits.
+ * @param fft - The spectrum.
+ * @param samples - The block.
+ * @param stride - Distance between two samples of the block.
+ * @param shift - Right shift bringing the samples to 16 bits, 8 for 24 bit
+ * samples.
+ * @return 1 if the average is complete, 0 if more blocks are needed,
+ * negative error code otherwise.
+ */
+int32_t no_os_fft_add_block_s32(struct no_os_fft *fft, const int32_t *samples,
+				uint32_t stride, uint8_t shift)
+{
+	int32_t val;
+	uint32_t i;
+
+	if (!fft || !samples || !stride || shift > 31)
+		return -EINVAL;
+
+	if (fft->count == fft->nb_avg)
+		return 1;
+
+	for (i = 0; i < fft->size; i++) {
+		val = no_os_clamp(samples[i * stride] >> shift, INT16_MIN,
+				  INT16_MAX);
+		fft->work[2 * i] = fft->coef ? (val * fft->coef[i]) >> 15 :
+				   val;
+		fft->work[2 * i + 1] = 0;
+	}
+
+	return no_os_fft_accumulate(fft);
+}
+
+/**
+ * @brief Get the averaged magnitude of the size / 2 bins from DC up to the
+ * Nyquist frequency excluded, then restart the average. The bins are the
+ * root mean square of |X[k]| over the blocks, X being the transform
+ * scaled by 1/size.
+ * @param fft - The spectrum.
+ * @param bins - Where to store the size / 2 bins.
+ * @return 0 in case of success, -EAGAIN if no block was added, negative
+ * error code otherwise.
+ */
+int32_t no_os_fft_get_magnitude(struct no_os_fft *fft, uint16_t *bins)
+{
+	uint32_t i;
+
+	if (!fft || !bins)
+		return -EINVAL;
+
+	if (!fft->count)
+		return -EAGAIN;
+
+	for (i = 0; i < fft->size / 2; i++) {
+		bins[i] = no_os_min(no_os_fft_isqrt(fft->acc[i] / fft->count),
+				    (uint32_t)UINT16_MAX);
+		fft->acc[i] = 0;
+	}
+	fft->count = 0;
+
+	return 0;
+}
@@ -136,3 +136,130 @@ struct no_os_fifo_element * no_os_fifo_remove(struct no_os_fifo_element *p_fifo)
 
 	return p_fifo;
 }
+
+/**
+ * @brief Allocate a fifo pool. This is the only heap allocation of the pool.
+ * @param pool - Pointer to the pool pointer.
+ * @param param - Initialization parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_fifo_pool_init(struct no_os_fifo_pool **pool,
+			     struct no_os_fifo_pool_init_param *param)
+{
+	struct no_os_fifo_pool *p;
+	uint32_t i;
+
+	if (!pool || !param || !param->nb_blocks || !param->block_size)
+		return -EINVAL;
+
+	p = calloc(1, sizeof(*p));
+	if (!p)
+		return -ENOMEM;
+
+	p->elements = calloc(param->nb_blocks, sizeof(*p->elements));
+	if (!p->elements)
+		goto error_pool;
+
+	p->storage = calloc(param->nb_blocks, param->block_size);
+	if (!p->storage)
+		goto error_elements;
+
+	p->block_size = param->block_size;
+	for (i = 0; i < param->nb_blocks; i++) {
+		p->elements[i].data = p->storage + i * param->block_size;
+		p->elements[i].next = p->free_list;
+		p->free_list = &p->elements[i];
+	}
+
+	*pool = p;
+
+	return 0;
+
+error_elements:
+	free(p->elements);
+error_pool:
+	free(p);
+
+	return -ENOMEM;
+}
+
+/**
+ * @brief Free the resources of a fifo pool.
+ * @param pool - Pointer to the pool.
+ */
+void no_os_fifo_pool_remove(struct no_os_fifo_pool *pool)
+{
+	if (!pool)
+		return;
+
+	free(pool->storage);
+	free(pool->elements);
+	free(pool);
+}
+
+/**
+ * @brief Copy data in a free element and append it to the fifo.
+ * @param pool - Pointer to the pool.
+ * @param buff - Data to be saved in fifo.
+ * @param len - Length of the data, at most the block size.
+ * @return 0 in case of success, -ENOMEM if no element is free, -EINVAL for
+ * wrong parameters.
+ */
+int32_t no_os_fifo_push(struct no_os_fifo_pool *pool, char *buff,
+			uint32_t len)
+{
+	struct no_os_fifo_element *q;
+
+	if (!pool || !buff || !len || len > pool->block_size)
+		return -EINVAL;
+
+	q = pool->free_list;
+	if (!q)
+		return -ENOMEM;
+	pool->free_list = q->next;
+
+	memcpy(q->data, buff, len);
+	q->len = len;
+	q->next = NULL;
+
+	if (pool->tail)
+		pool->tail->next = q;
+	else
+		pool->head = q;
+	pool->tail = q;
+
+	return 0;
+}
+
+/**
+ * @brief Get the fifo head.
+ * @param pool - Pointer to the pool.
+ * @return fifo head if exists, NULL otherwise.
+ */
+struct no_os_fifo_element *no_os_fifo_peek(struct no_os_fifo_pool *pool)
+{
+	if (!pool)
+		return NULL;
+
+	return pool->head;
+}
+
+/**
+ * @brief Return the fifo head to the pool.
+ * @param pool - Pointer to the pool.
+ */
+void no_os_fifo_pop(struct no_os_fifo_pool *pool)
+{
+	struct no_os_fifo_element *p;
+
+	if (!pool || !pool->head)
+		return;
+
+	p = pool->head;
+	pool->head = p->next;
+	if (!pool->head)
+		pool->tail = NULL;
+
+	p->next = pool->free_list;
+	pool->free_list = p;
+}
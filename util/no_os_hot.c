@@ -0,0 +1,90 @@
+/***************************************************************************//**
+ *   @file   no_os_hot.c
+ *   @brief  Startup copy of the hot sections.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include "no_os_hot.h"
+
+#ifdef NO_OS_HOT_SECTIONS
+
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+
+/* Defined by tools/scripts/no_os_hot.ld */
+extern uint8_t __no_os_hot_text_start[], __no_os_hot_text_end[];
+extern uint8_t __no_os_hot_text_load[];
+extern uint8_t __no_os_hot_data_start[], __no_os_hot_data_end[];
+extern uint8_t __no_os_hot_data_load[];
+extern uint8_t __no_os_hot_bss_start[], __no_os_hot_bss_end[];
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Copy the hot code and data to their execution regions and clear the
+ * hot bss. Runs as a constructor, before main and before any interrupt is
+ * enabled, so no NO_OS_HOT function may be called earlier.
+ */
+__attribute__((constructor(101))) void no_os_hot_init(void)
+{
+	size_t size;
+
+	size = __no_os_hot_text_end - __no_os_hot_text_start;
+	if (size)
+		memcpy(__no_os_hot_text_start, __no_os_hot_text_load, size);
+
+	size = __no_os_hot_data_end - __no_os_hot_data_start;
+	if (size)
+		memcpy(__no_os_hot_data_start, __no_os_hot_data_load, size);
+
+	memset(__no_os_hot_bss_start, 0,
+	       __no_os_hot_bss_end - __no_os_hot_bss_start);
+
+#ifdef __arm__
+	/* The copied code must be visible to the instruction fetch */
+	__asm__ volatile("dsb\n\tisb" ::: "memory");
+#endif
+}
+
+#endif /* NO_OS_HOT_SECTIONS */
@@ -0,0 +1,321 @@
+/***************************************************************************//**
+ *   @file   no_os_ilist.c
+ *   @brief  Implementation of the intrusive list and heap.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "no_os_ilist.h"
+#include "no_os_error.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Initialize an empty list.
+ * @param list - The list.
+ */
+void no_os_ilist_init(struct no_os_ilist *list)
+{
+	list->head.next = &list->head;
+	list->head.prev = &list->head;
+	list->nb_elements = 0;
+}
+
+/**
+ * @brief Check if a list has no nodes.
+ * @param list - The list.
+ * @return true if the list is empty, false otherwise.
+ */
+bool no_os_ilist_is_empty(struct no_os_ilist *list)
+{
+	return list->head.next == &list->head;
+}
+
+/**
+ * @brief Link node between prev and next.
+ * @param node - Node to be linked.
+ * @param prev - Node that will come before node.
+ * @param next - Node that will come after node.
+ */
+static void no_os_ilist_link(struct no_os_ilist_node *node,
+			     struct no_os_ilist_node *prev,
+			     struct no_os_ilist_node *next)
+{
+	node->prev = prev;
+	node->next = next;
+	prev->next = node;
+	next->prev = node;
+}
+
+/**
+ * @brief Add a node at the start of the list.
+ * @param list - The list.
+ * @param node - Node not part of any list.
+ */
+void no_os_ilist_add_first(struct no_os_ilist *list,
+			   struct no_os_ilist_node *node)
+{
+	no_os_ilist_link(node, &list->head, list->head.next);
+	list->nb_elements++;
+}
+
+/**
+ * @brief Add a node at the end of the list.
+ * @param list - The list.
+ * @param node - Node not part of any list.
+ */
+void no_os_ilist_add_last(struct no_os_ilist *list,
+			  struct no_os_ilist_node *node)
+{
+	no_os_ilist_link(node, list->head.prev, &list->head);
+	list->nb_elements++;
+}
+
+/**
+ * @brief Remove a node from the list.
+ * @param list - The list.
+ * @param node - Node of the list.
+ */
+void no_os_ilist_del(struct no_os_ilist *list, struct no_os_ilist_node *node)
+{
+	node->prev->next = node->next;
+	node->next->prev = node->prev;
+	node->prev = NULL;
+	node->next = NULL;
+	list->nb_elements--;
+}
+
+/**
+ * @brief Get the first node of the list without removing it.
+ * @param list - The list.
+ * @return the first node, NULL if the list is empty.
+ */
+struct no_os_ilist_node *no_os_ilist_first(struct no_os_ilist *list)
+{
+	if (no_os_ilist_is_empty(list))
+		return NULL;
+
+	return list->head.next;
+}
+
+/**
+ * @brief Remove and return the first node of the list.
+ * @param list - The list.
+ * @return the first node, NULL if the list is empty.
+ */
+struct no_os_ilist_node *no_os_ilist_get_first(struct no_os_ilist *list)
+{
+	struct no_os_ilist_node *node = no_os_ilist_first(list);
+
+	if (node)
+		no_os_ilist_del(list, node);
+
+	return node;
+}
+
+/**
+ * @brief Move the element at idx up while it is smaller than its parent.
+ * @param heap - The heap.
+ * @param idx - Index of the element.
+ */
+static void no_os_heap_sift_up(struct no_os_heap *heap, uint32_t idx)
+{
+	void *data = heap->elems[idx];
+	uint32_t parent;
+
+	while (idx) {
+		parent = (idx - 1) / 2;
+		if (heap->cmp(data, heap->elems[parent]) >= 0)
+			break;
+		heap->elems[idx] = heap->elems[parent];
+		idx = parent;
+	}
+	heap->elems[idx] = data;
+}
+
+/**
+ * @brief Move the element at idx down while it is bigger than a child.
+ * @param heap - The heap.
+ * @param idx - Index of the element.
+ */
+static void no_os_heap_sift_down(struct no_os_heap *heap, uint32_t idx)
+{
+	void *data = heap->elems[idx];
+	uint32_t child;
+
+	while (1) {
+		child = 2 * idx + 1;
+		if (child >= heap->nb_elements)
+			break;
+		if (child + 1 < heap->nb_elements &&
+		    heap->cmp(heap->elems[child + 1], heap->elems[child]) < 0)
+			child++;
+		if (heap->cmp(heap->elems[child], data) >= 0)
+			break;
+		heap->elems[idx] = heap->elems[child];
+		idx = child;
+	}
+	heap->elems[idx] = data;
+}
+
+/**
+ * @brief Initialize an empty heap.
+ * @param heap - The heap.
+ * @param elems - Storage for size element references, owned by the user.
+ * @param size - Maximum number of elements.
+ * @param cmp - Function used to order the elements.
+ * @return 0 in case of success, -EINVAL for wrong parameters.
+ */
+int32_t no_os_heap_init(struct no_os_heap *heap, void **elems, uint32_t size,
+			no_os_heap_cmp cmp)
+{
+	if (!heap || !elems || !size || !cmp)
+		return -EINVAL;
+
+	heap->elems = elems;
+	heap->size = size;
+	heap->nb_elements = 0;
+	heap->cmp = cmp;
+
+	return 0;
+}
+
+/**
+ * @brief Insert an element in the heap, in O(log n).
+ * @param heap - The heap.
+ * @param data - The element.
+ * @return 0 in case of success, -ENOSPC if the heap is full.
+ */
+int32_t no_os_heap_push(struct no_os_heap *heap, void *data)
+{
+	if (!heap)
+		return -EINVAL;
+
+	if (heap->nb_elements == heap->size)
+		return -ENOSPC;
+
+	heap->elems[heap->nb_elements] = data;
+	no_os_heap_sift_up(heap, heap->nb_elements);
+	heap->nb_elements++;
+
+	return 0;
+}
+
+/**
+ * @brief Read the top element of the heap without removing it.
+ * @param heap - The heap.
+ * @param data - Where to store the element.
+ * @return 0 in case of success, -ENOENT if the heap is empty.
+ */
+int32_t no_os_heap_peek(struct no_os_heap *heap, void **data)
+{
+	if (!heap || !data)
+		return -EINVAL;
+
+	if (!heap->nb_elements)
+		return -ENOENT;
+
+	*data = heap->elems[0];
+
+	return 0;
+}
+
+/**
+ * @brief Remove the element at idx.
+ * @param heap - The heap.
+ * @param idx - Index of the element.
+ */
+static void no_os_heap_remove_idx(struct no_os_heap *heap, uint32_t idx)
+{
+	heap->nb_elements--;
+	if (idx == heap->nb_elements)
+		return;
+
+	/* Fill the gap with the last element and restore the order */
+	heap->elems[idx] = heap->elems[heap->nb_elements];
+	if (idx && heap->cmp(heap->elems[idx],
+			     heap->elems[(idx - 1) / 2]) < 0)
+		no_os_heap_sift_up(heap, idx);
+	else
+		no_os_heap_sift_down(heap, idx);
+}
+
+/**
+ * @brief Remove and return the top element of the heap, in O(log n).
+ * @param heap - The heap.
+ * @param data - Where to store the element.
+ * @return 0 in case of success, -ENOENT if the heap is empty.
+ */
+int32_t no_os_heap_pop(struct no_os_heap *heap, void **data)
+{
+	int32_t ret;
+
+	ret = no_os_heap_peek(heap, data);
+	if (ret)
+		return ret;
+
+	no_os_heap_remove_idx(heap, 0);
+
+	return 0;
+}
+
+/**
+ * @brief Remove an element from any position of the heap, for example a
+ * canceled event. Finding the element is O(n).
+ * @param heap - The heap.
+ * @param data - The element.
+ * @return 0 in case of success, -ENOENT if the element is not in the heap.
+ */
+int32_t no_os_heap_remove(struct no_os_heap *heap, void *data)
+{
+	uint32_t i;
+
+	if (!heap)
+		return -EINVAL;
+
+	for (i = 0; i < heap->nb_elements; i++) {
+		if (heap->elems[i] == data) {
+			no_os_heap_remove_idx(heap, i);
+			return 0;
+		}
+	}
+
+	return -ENOENT;
+}
@@ -0,0 +1,336 @@
+/***************************************************************************//**
+ *   @file   no_os_irq_policy.c
+ *   @brief  Implementation of the interrupt priority policy and latency test.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdio.h>
+#include "no_os_irq_policy.h"
+#include "no_os_trace.h"
+#include "no_os_delay.h"
+#include "no_os_util.h"
+#include "no_os_error.h"
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+/* Preemption order of the classes, in the levels 0 to 3 of all platforms */
+static const uint32_t no_os_irq_default_priority[NO_OS_IRQ_CLASS_MAX] = {
+	[NO_OS_IRQ_CLASS_DATA_READY] = 0,
+	[NO_OS_IRQ_CLASS_TRIGGER] = 1,
+	[NO_OS_IRQ_CLASS_DMA] = 1,
+	[NO_OS_IRQ_CLASS_SPI] = 2,
+	[NO_OS_IRQ_CLASS_UART] = 3,
+	[NO_OS_IRQ_CLASS_BACKGROUND] = 3,
+};
+
+static const char * const no_os_irq_class_name[NO_OS_IRQ_CLASS_MAX] = {
+	[NO_OS_IRQ_CLASS_DATA_READY] = "data_ready",
+	[NO_OS_IRQ_CLASS_TRIGGER] = "trigger",
+	[NO_OS_IRQ_CLASS_DMA] = "dma",
+	[NO_OS_IRQ_CLASS_SPI] = "spi",
+	[NO_OS_IRQ_CLASS_UART] = "uart",
+	[NO_OS_IRQ_CLASS_BACKGROUND] = "background",
+};
+
+/* Policy shown on the irq_latency IIO debug attribute */
+static struct no_os_irq_policy *no_os_irq_active_policy;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+#ifndef NO_OS_TRACE
+/**
+ * @brief Default counter, for platforms without a cycle counter. Defined by
+ * no_os_trace.c when the trace is built.
+ * @return Microseconds since the system start.
+ */
+uint32_t __attribute__((weak)) no_os_trace_timestamp(void)
+{
+	struct no_os_time t = no_os_get_time();
+
+	return t.s * 1000000 + t.us;
+}
+#endif
+
+/**
+ * @brief Get the priority of a source according to its policy.
+ * @param policy - The policy.
+ * @param src - Source of the policy.
+ * @return the priority level, 0 being the highest.
+ */
+uint32_t no_os_irq_policy_priority(struct no_os_irq_policy *policy,
+				   struct no_os_irq_source *src)
+{
+	const uint32_t *table = no_os_irq_default_priority;
+
+	if (policy && policy->class_priority)
+		table = policy->class_priority;
+
+	return table[src->irq_class];
+}
+
+/**
+ * @brief Set the priority of all the sources of the policy and make it the
+ * active one. The sources of the controllers without priority support are
+ * skipped.
+ * @param policy - The policy, it must stay valid while it is active.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_irq_policy_apply(struct no_os_irq_policy *policy)
+{
+	struct no_os_irq_source *src;
+	int32_t ret;
+	uint32_t i;
+
+	if (!policy || (!policy->sources && policy->nb_sources))
+		return -EINVAL;
+
+	for (i = 0; i < policy->nb_sources; i++) {
+		src = &policy->sources[i];
+		if (!src->irq_ctrl || src->irq_class >= NO_OS_IRQ_CLASS_MAX)
+			return -EINVAL;
+
+		ret = no_os_irq_set_priority(src->irq_ctrl, src->irq_id,
+					     no_os_irq_policy_priority(policy,
+							     src));
+		if (ret && ret != -ENOSYS)
+			return ret;
+	}
+
+	no_os_irq_active_policy = policy;
+
+	return 0;
+}
+
+/**
+ * @brief Record that the event of src happened, for example right before
+ * raising it in software or by a GPIO. The next no_os_irq_latency_mark
+ * measures the entry latency. An event armed again before its interrupt is
+ * counted as missed.
+ * @param src - Interrupt source.
+ */
+void no_os_irq_latency_arm(struct no_os_irq_source *src)
+{
+	if (src->armed)
+		src->missed++;
+
+	src->armed_at = no_os_trace_timestamp();
+	src->armed = true;
+}
+
+/**
+ * @brief Record the entry in the interrupt handler of src, to be called first
+ * in the handler. For periodic sources, the periods without an entry are
+ * counted as missed.
+ * @param src - Interrupt source.
+ */
+void no_os_irq_latency_mark(struct no_os_irq_source *src)
+{
+	uint32_t now = no_os_trace_timestamp();
+	uint32_t latency, gap;
+
+	if (src->nb_entries && src->period_ticks) {
+		gap = now - src->last_entry;
+		if (gap > src->period_ticks + src->period_ticks / 2)
+			src->missed += (gap + src->period_ticks / 2) /
+				       src->period_ticks - 1;
+	}
+	src->last_entry = now;
+	src->nb_entries++;
+
+	if (!src->armed)
+		return;
+
+	latency = now - src->armed_at;
+	src->armed = false;
+
+	if (!src->nb_latencies || latency < src->min_latency)
+		src->min_latency = latency;
+	if (latency > src->max_latency)
+		src->max_latency = latency;
+	src->sum_latency += latency;
+	src->nb_latencies++;
+}
+
+/**
+ * @brief Interrupt handler of the loopback test.
+ * @param ctx - Interrupt source under test.
+ */
+static void no_os_irq_latency_test_cb(void *ctx)
+{
+	no_os_irq_latency_mark(ctx);
+}
+
+/**
+ * @brief Measure the entry latency of a GPIO interrupt source, toggling a GPIO
+ * wired to its input. The measured latency includes the GPIO write. Run it
+ * before the driver using the source registers its callback.
+ * @param test - Test parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_irq_latency_test(struct no_os_irq_latency_test *test)
+{
+	struct no_os_callback_desc cb = {0};
+	struct no_os_irq_source *src;
+	uint8_t value = NO_OS_GPIO_LOW;
+	uint32_t i, t;
+	int32_t ret, ret2;
+
+	if (!test || !test->src || !test->src->irq_ctrl || !test->gpio_out ||
+	    !test->nb_iter)
+		return -EINVAL;
+
+	src = test->src;
+	cb.callback = no_os_irq_latency_test_cb;
+	cb.ctx = src;
+	cb.event = test->event;
+	cb.peripheral = NO_OS_GPIO_IRQ;
+	cb.handle = test->handle;
+
+	ret = no_os_gpio_set_value(test->gpio_out, value);
+	if (ret)
+		return ret;
+
+	ret = no_os_irq_register_callback(src->irq_ctrl, src->irq_id, &cb);
+	if (ret)
+		return ret;
+
+	ret = no_os_irq_trigger_level_set(src->irq_ctrl, src->irq_id,
+					  NO_OS_IRQ_EDGE_BOTH);
+	if (ret)
+		goto out;
+
+	ret = no_os_irq_enable(src->irq_ctrl, src->irq_id);
+	if (ret)
+		goto out;
+
+	for (i = 0; i < test->nb_iter; i++) {
+		value = value == NO_OS_GPIO_LOW ? NO_OS_GPIO_HIGH :
+			NO_OS_GPIO_LOW;
+
+		no_os_irq_latency_arm(src);
+		ret = no_os_gpio_set_value(test->gpio_out, value);
+		if (ret)
+			break;
+
+		for (t = 0; src->armed && t < test->timeout_us; t++)
+			no_os_udelay(1);
+
+		if (src->armed) {
+			src->armed = false;
+			src->missed++;
+		}
+	}
+
+	ret2 = no_os_irq_disable(src->irq_ctrl, src->irq_id);
+	if (!ret)
+		ret = ret2;
+out:
+	ret2 = no_os_irq_unregister_callback(src->irq_ctrl, src->irq_id, &cb);
+
+	return ret ? ret : ret2;
+}
+
+/**
+ * @brief Clear the latency counters of all the sources of the active policy.
+ */
+void no_os_irq_policy_reset_stats(void)
+{
+	struct no_os_irq_source *src;
+	uint32_t i;
+
+	if (!no_os_irq_active_policy)
+		return;
+
+	for (i = 0; i < no_os_irq_active_policy->nb_sources; i++) {
+		src = &no_os_irq_active_policy->sources[i];
+		src->armed = false;
+		src->nb_entries = 0;
+		src->nb_latencies = 0;
+		src->min_latency = 0;
+		src->max_latency = 0;
+		src->sum_latency = 0;
+		src->missed = 0;
+	}
+}
+
+/**
+ * @brief Format the priorities and latency counters of the active policy, one
+ * line per source: name, class, priority, entries, minimum, average and
+ * maximum entry latency in no_os_trace_timestamp() ticks, missed events.
+ * @param buf - Where to write the lines.
+ * @param len - Size of buf.
+ * @return the number of characters written, negative error code otherwise.
+ */
+int32_t no_os_irq_policy_print(char *buf, uint32_t len)
+{
+	struct no_os_irq_policy *policy = no_os_irq_active_policy;
+	struct no_os_irq_source *src;
+	uint32_t i, avg, l = 0;
+
+	if (!buf)
+		return -EINVAL;
+
+	if (!policy)
+		return -ENOENT;
+
+	for (i = 0; i < policy->nb_sources; i++) {
+		if (len - l < NO_OS_IRQ_POLICY_LINE_SIZE)
+			return -ENOBUFS;
+
+		src = &policy->sources[i];
+		avg = src->nb_latencies ?
+		      (uint32_t)no_os_div_u64(src->sum_latency,
+					      src->nb_latencies) : 0;
+		l += snprintf(buf + l, len - l,
+			      "%.16s %s %"PRIu32" %"PRIu32" %"PRIu32" %"PRIu32
+			      " %"PRIu32" %"PRIu32"\n",
+			      src->name ? src->name : "-",
+			      no_os_irq_class_name[src->irq_class],
+			      no_os_irq_policy_priority(policy, src),
+			      src->nb_entries, src->min_latency, avg,
+			      src->max_latency, src->missed);
+	}
+
+	return l;
+}
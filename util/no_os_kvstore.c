@@ -0,0 +1,694 @@
+/***************************************************************************//**
+ *   @file   no_os_kvstore.c
+ *   @brief  Implementation of the key/value store kept in flash.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdbool.h>
+#include <string.h>
+#include "no_os_kvstore.h"
+#include "no_os_crc16.h"
+#include "no_os_alloc.h"
+#include "no_os_error.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define NO_OS_KV_PAGE_MAGIC	0x564B4F4EU
+#define NO_OS_KV_REC_MAGIC	0xA55AU
+/* CRC-16-CCITT */
+#define NO_OS_KV_CRC_POLY	0x1021U
+#define NO_OS_KV_CRC_INIT	0xFFFFU
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/* Start of each page */
+struct no_os_kv_page_hdr {
+	/* Incremented for each started page, the highest one is in use */
+	uint32_t seq;
+	/* seq ^ NO_OS_KV_PAGE_MAGIC, not matching if partly programmed */
+	uint32_t check;
+};
+
+/* Start of each record, followed by the value and padded to NO_OS_KV_ALIGN */
+struct no_os_kv_rec_hdr {
+	uint16_t magic;
+	uint16_t key;
+	/* 0 for a deleted key */
+	uint16_t len;
+	/* Of key, len and the value */
+	uint16_t crc;
+};
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+NO_OS_DECLARE_CRC16_TABLE(no_os_kv_crc_table);
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Get the flash space taken by a record.
+ * @param len - Value length in bytes.
+ * @return the record size in bytes.
+ */
+static uint32_t no_os_kv_rec_size(uint32_t len)
+{
+	return (sizeof(struct no_os_kv_rec_hdr) + len + NO_OS_KV_ALIGN - 1) &
+	       ~(NO_OS_KV_ALIGN - 1);
+}
+
+/**
+ * @brief Get the flash address of a page of the store.
+ * @param desc - The store.
+ * @param page - Page index, relative to the first page of the store.
+ * @return the address.
+ */
+static uint32_t no_os_kv_page_addr(struct no_os_kv_desc *desc, uint32_t page)
+{
+	return (desc->start_page + page) * desc->page_size;
+}
+
+/**
+ * @brief Compute the CRC of a record.
+ * @param hdr - Record header.
+ * @param data - Value, hdr->len bytes.
+ * @return the CRC.
+ */
+static uint16_t no_os_kv_rec_crc(struct no_os_kv_rec_hdr *hdr,
+				 const uint8_t *data)
+{
+	uint16_t crc;
+
+	crc = no_os_crc16(no_os_kv_crc_table, (uint8_t *)&hdr->key,
+			  sizeof(hdr->key) + sizeof(hdr->len),
+			  NO_OS_KV_CRC_INIT);
+
+	return no_os_crc16(no_os_kv_crc_table, data, hdr->len, crc);
+}
+
+/**
+ * @brief Find the index entry of a key.
+ * @param desc - The store.
+ * @param key - The key.
+ * @return the entry, NULL if the key is not stored.
+ */
+static struct no_os_kv_entry *no_os_kv_find(struct no_os_kv_desc *desc,
+		uint16_t key)
+{
+	uint32_t i;
+
+	for (i = 0; i < desc->nb_keys; i++)
+		if (desc->entries[i].key == key)
+			return &desc->entries[i];
+
+	return NULL;
+}
+
+/**
+ * @brief Update the index with a record.
+ * @param desc - The store.
+ * @param hdr - Record header, a length of 0 deletes the key.
+ * @param addr - Flash address of the record.
+ * @return 0 in case of success, -ENOSPC if there are too many keys.
+ */
+static int32_t no_os_kv_index(struct no_os_kv_desc *desc,
+			      struct no_os_kv_rec_hdr *hdr, uint32_t addr)
+{
+	struct no_os_kv_entry *entry = no_os_kv_find(desc, hdr->key);
+
+	if (entry)
+		desc->live -= no_os_kv_rec_size(entry->len);
+
+	if (!hdr->len) {
+		/* Fill the hole with the last entry */
+		if (entry)
+			*entry = desc->entries[--desc->nb_keys];
+		return 0;
+	}
+
+	if (!entry) {
+		if (desc->nb_keys == desc->max_keys)
+			return -ENOSPC;
+		entry = &desc->entries[desc->nb_keys++];
+		entry->key = hdr->key;
+	}
+
+	entry->len = hdr->len;
+	entry->addr = addr;
+	desc->live += no_os_kv_rec_size(hdr->len);
+
+	return 0;
+}
+
+/**
+ * @brief Read a record in the buffer of the store.
+ * @param desc - The store.
+ * @param addr - Flash address of the record.
+ * @param size - Record size in bytes.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t no_os_kv_read(struct no_os_kv_desc *desc, uint32_t addr,
+			     uint32_t size)
+{
+	return no_os_flash_read(desc->flash, addr, desc->buff,
+				size / sizeof(uint32_t));
+}
+
+/**
+ * @brief Program a record of the buffer of the store at the end of the active
+ * page, the space being available.
+ * @param desc - The store.
+ * @param size - Record size in bytes.
+ * @param addr - Flash address of the record.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t no_os_kv_append(struct no_os_kv_desc *desc, uint32_t size,
+			       uint32_t *addr)
+{
+	int32_t ret;
+
+	*addr = no_os_kv_page_addr(desc, desc->active) + desc->offset;
+
+	ret = no_os_flash_program(desc->flash, *addr, desc->buff,
+				  size / sizeof(uint32_t));
+	if (ret) {
+		/* The location may be partly programmed, do not reuse it */
+		desc->offset = desc->page_size;
+		return ret;
+	}
+
+	desc->offset += size;
+
+	return 0;
+}
+
+/**
+ * @brief Move the current values of the oldest page to the active one, then
+ * erase it. They fit in a just started page, but may not when resuming an
+ * interrupted collection.
+ * @param desc - The store.
+ * @return 0 in case of success, -ENOSPC if the values do not fit, negative
+ * error code otherwise.
+ */
+static int32_t no_os_kv_collect(struct no_os_kv_desc *desc)
+{
+	struct no_os_kv_entry *entry;
+	uint32_t start, end, size, i;
+	int32_t ret;
+
+	start = no_os_kv_page_addr(desc, desc->oldest);
+	end = start + desc->page_size;
+	size = 0;
+	for (i = 0; i < desc->nb_keys; i++) {
+		entry = &desc->entries[i];
+		if (entry->addr >= start && entry->addr < end)
+			size += no_os_kv_rec_size(entry->len);
+	}
+	if (desc->offset + size > desc->page_size)
+		return -ENOSPC;
+
+	for (i = 0; i < desc->nb_keys; i++) {
+		entry = &desc->entries[i];
+		if (entry->addr < start || entry->addr >= end)
+			continue;
+
+		size = no_os_kv_rec_size(entry->len);
+		ret = no_os_kv_read(desc, entry->addr, size);
+		if (ret)
+			return ret;
+
+		ret = no_os_kv_append(desc, size, &entry->addr);
+		if (ret)
+			return ret;
+	}
+
+	ret = no_os_flash_clear_page(desc->flash,
+				     desc->start_page + desc->oldest);
+	if (ret)
+		return ret;
+
+	desc->oldest = (desc->oldest + 1) % desc->nb_pages;
+
+	return 0;
+}
+
+/**
+ * @brief Erase a page unless it is already erased. The erase of a free page
+ * may have been interrupted.
+ * @param desc - The store.
+ * @param page - Page index, relative to the first page of the store.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t no_os_kv_prepare(struct no_os_kv_desc *desc, uint32_t page)
+{
+	uint32_t i;
+	int32_t ret;
+
+	ret = no_os_kv_read(desc, no_os_kv_page_addr(desc, page),
+			    desc->page_size);
+	if (ret)
+		return ret;
+
+	for (i = 0; i < desc->page_size / sizeof(uint32_t); i++)
+		if (desc->buff[i] != 0xFFFFFFFFU)
+			return no_os_flash_clear_page(desc->flash,
+						      desc->start_page + page);
+
+	return 0;
+}
+
+/**
+ * @brief Start a page, the one after the active page or the first page of an
+ * empty store, and keep one page erased.
+ * @param desc - The store.
+ * @param page - Page index, relative to the first page of the store.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t no_os_kv_start_page(struct no_os_kv_desc *desc, uint32_t page)
+{
+	struct no_os_kv_page_hdr *hdr = (struct no_os_kv_page_hdr *)desc->buff;
+	int32_t ret;
+
+	ret = no_os_kv_prepare(desc, page);
+	if (ret)
+		return ret;
+
+	hdr->seq = desc->seq + 1;
+	hdr->check = hdr->seq ^ NO_OS_KV_PAGE_MAGIC;
+
+	ret = no_os_flash_program(desc->flash, no_os_kv_page_addr(desc, page),
+				  desc->buff, sizeof(*hdr) / sizeof(uint32_t));
+	if (ret)
+		return ret;
+
+	desc->active = page;
+	desc->seq++;
+	desc->offset = NO_OS_KV_ALIGN;
+
+	if ((page + 1) % desc->nb_pages != desc->oldest)
+		return 0;
+
+	return no_os_kv_collect(desc);
+}
+
+/**
+ * @brief Make room for a record in the active page.
+ * @param desc - The store.
+ * @param size - Record size in bytes.
+ * @return 0 in case of success, -ENOSPC if the pages are too fragmented.
+ */
+static int32_t no_os_kv_reserve(struct no_os_kv_desc *desc, uint32_t size)
+{
+	uint32_t tries = desc->nb_pages;
+	uint32_t next;
+	int32_t ret;
+
+	while (desc->offset + size > desc->page_size) {
+		next = (desc->active + 1) % desc->nb_pages;
+		/* No erased page left, the collection could not be completed */
+		if (!tries-- || next == desc->oldest)
+			return -ENOSPC;
+
+		ret = no_os_kv_start_page(desc, next);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Replay the records of a page in the index.
+ * @param desc - The store.
+ * @param page - Page index, relative to the first page of the store.
+ * @param end - Offset after the last record, the page size if a record
+ * header is corrupted.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t no_os_kv_scan(struct no_os_kv_desc *desc, uint32_t page,
+			     uint32_t *end)
+{
+	struct no_os_kv_rec_hdr *hdr = (struct no_os_kv_rec_hdr *)desc->buff;
+	uint32_t addr = no_os_kv_page_addr(desc, page);
+	uint32_t offset = NO_OS_KV_ALIGN;
+	uint32_t size;
+	int32_t ret;
+
+	while (offset < desc->page_size) {
+		ret = no_os_kv_read(desc, addr + offset, sizeof(*hdr));
+		if (ret)
+			return ret;
+
+		if (hdr->magic == 0xFFFF && hdr->key == NO_OS_KV_KEY_NONE)
+			break;
+
+		size = no_os_kv_rec_size(hdr->len);
+		if (hdr->magic != NO_OS_KV_REC_MAGIC ||
+		    size > desc->page_size - offset) {
+			offset = desc->page_size;
+			break;
+		}
+
+		ret = no_os_kv_read(desc, addr + offset, size);
+		if (ret)
+			return ret;
+
+		/* Interrupted write, skipped since its header is intact */
+		if (no_os_kv_rec_crc(hdr, (uint8_t *)(hdr + 1)) == hdr->crc) {
+			ret = no_os_kv_index(desc, hdr, addr + offset);
+			if (ret)
+				return ret;
+		}
+
+		offset += size;
+	}
+
+	*end = offset;
+
+	return 0;
+}
+
+/**
+ * @brief Find the pages in use and build the index of the keys.
+ * @param desc - The store.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t no_os_kv_mount(struct no_os_kv_desc *desc)
+{
+	struct no_os_kv_page_hdr *hdr = (struct no_os_kv_page_hdr *)desc->buff;
+	uint32_t min_seq = 0, max_seq = 0;
+	uint32_t end = desc->page_size;
+	bool found = false;
+	uint32_t i, page;
+	int32_t ret;
+
+	for (i = 0; i < desc->nb_pages; i++) {
+		ret = no_os_kv_read(desc, no_os_kv_page_addr(desc, i),
+				    sizeof(*hdr));
+		if (ret)
+			return ret;
+
+		if (hdr->check != (hdr->seq ^ NO_OS_KV_PAGE_MAGIC))
+			continue;
+
+		if (!found || hdr->seq < min_seq) {
+			min_seq = hdr->seq;
+			desc->oldest = i;
+		}
+		if (!found || hdr->seq > max_seq) {
+			max_seq = hdr->seq;
+			desc->active = i;
+		}
+		found = true;
+	}
+
+	if (!found) {
+		desc->oldest = 0;
+		return no_os_kv_start_page(desc, 0);
+	}
+
+	desc->seq = max_seq;
+	page = desc->oldest;
+	while (1) {
+		ret = no_os_kv_read(desc, no_os_kv_page_addr(desc, page),
+				    sizeof(*hdr));
+		if (ret)
+			return ret;
+
+		if (hdr->check == (hdr->seq ^ NO_OS_KV_PAGE_MAGIC)) {
+			ret = no_os_kv_scan(desc, page, &end);
+			if (ret)
+				return ret;
+		}
+
+		if (page == desc->active)
+			break;
+		page = (page + 1) % desc->nb_pages;
+	}
+	desc->offset = end;
+
+	if (desc->active == desc->oldest ||
+	    (desc->active + 1) % desc->nb_pages != desc->oldest)
+		return 0;
+
+	/*
+	 * Finish a collection interrupted before erasing the oldest page. If
+	 * the values do not fit anymore the store can still be read, the writes
+	 * fail with -ENOSPC.
+	 */
+	ret = no_os_kv_collect(desc);
+	if (ret == -ENOSPC)
+		return 0;
+
+	return ret;
+}
+
+/**
+ * @brief Open the store, building the index from the flash content. An empty
+ * or unformatted region is formatted.
+ * @param desc - The store.
+ * @param param - Initialization parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_kv_init(struct no_os_kv_desc **desc,
+		      const struct no_os_kv_init_param *param)
+{
+	struct no_os_kv_desc *d;
+	int32_t ret;
+
+	if (!desc || !param || !param->flash || param->nb_pages < 2 ||
+	    !param->max_keys)
+		return -EINVAL;
+
+	if (param->flash->page_size % NO_OS_KV_ALIGN ||
+	    (param->start_page + param->nb_pages) * param->flash->page_size >
+	    param->flash->flash_size)
+		return -EINVAL;
+
+	d = no_os_calloc(1, sizeof(*d));
+	if (!d)
+		return -ENOMEM;
+
+	d->flash = param->flash;
+	d->start_page = param->start_page;
+	d->nb_pages = param->nb_pages;
+	d->page_size = param->flash->page_size;
+	d->max_keys = param->max_keys;
+
+	d->entries = no_os_calloc(d->max_keys, sizeof(*d->entries));
+	if (!d->entries) {
+		ret = -ENOMEM;
+		goto error_desc;
+	}
+
+	d->buff = no_os_calloc(1, d->page_size);
+	if (!d->buff) {
+		ret = -ENOMEM;
+		goto error_entries;
+	}
+
+	no_os_crc16_populate_msb(no_os_kv_crc_table, NO_OS_KV_CRC_POLY);
+
+	ret = no_os_kv_mount(d);
+	if (ret)
+		goto error_buff;
+
+	*desc = d;
+
+	return 0;
+
+error_buff:
+	no_os_free(d->buff);
+error_entries:
+	no_os_free(d->entries);
+error_desc:
+	no_os_free(d);
+
+	return ret;
+}
+
+/**
+ * @brief Write a record, after making room for it.
+ * @param desc - The store.
+ * @param key - The key.
+ * @param data - The value.
+ * @param len - Value length in bytes, 0 to delete the key.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t no_os_kv_write(struct no_os_kv_desc *desc, uint16_t key,
+			      const void *data, uint16_t len)
+{
+	struct no_os_kv_rec_hdr *hdr = (struct no_os_kv_rec_hdr *)desc->buff;
+	uint32_t size = no_os_kv_rec_size(len);
+	uint32_t addr;
+	int32_t ret;
+
+	ret = no_os_kv_reserve(desc, size);
+	if (ret)
+		return ret;
+
+	memset(desc->buff, 0xFF, size);
+	hdr->magic = NO_OS_KV_REC_MAGIC;
+	hdr->key = key;
+	hdr->len = len;
+	if (len)
+		memcpy(hdr + 1, data, len);
+	hdr->crc = no_os_kv_rec_crc(hdr, (uint8_t *)(hdr + 1));
+
+	ret = no_os_kv_append(desc, size, &addr);
+	if (ret)
+		return ret;
+
+	return no_os_kv_index(desc, hdr, addr);
+}
+
+/**
+ * @brief Store the value of a key, in one program operation unless the
+ * active page is full.
+ * @param desc - The store.
+ * @param key - The key, not NO_OS_KV_KEY_NONE.
+ * @param data - The value.
+ * @param len - Value length in bytes, not 0.
+ * @return 0 in case of success, -ENOSPC if the store is full and negative
+ * error code otherwise.
+ */
+int32_t no_os_kv_set(struct no_os_kv_desc *desc, uint16_t key,
+		     const void *data, uint16_t len)
+{
+	struct no_os_kv_entry *entry;
+	uint32_t live, size;
+
+	if (!desc || !data || !len || key == NO_OS_KV_KEY_NONE)
+		return -EINVAL;
+
+	size = no_os_kv_rec_size(len);
+	if (size > desc->page_size - NO_OS_KV_ALIGN)
+		return -EINVAL;
+
+	/* The current values must fit in the pages but the erased one */
+	entry = no_os_kv_find(desc, key);
+	live = desc->live + size;
+	if (entry)
+		live -= no_os_kv_rec_size(entry->len);
+	else if (desc->nb_keys == desc->max_keys)
+		return -ENOSPC;
+	if (live > (desc->nb_pages - 1) * (desc->page_size - NO_OS_KV_ALIGN))
+		return -ENOSPC;
+
+	return no_os_kv_write(desc, key, data, len);
+}
+
+/**
+ * @brief Read the value of a key.
+ * @param desc - The store.
+ * @param key - The key.
+ * @param data - Buffer for the value.
+ * @param len - Buffer size in bytes, set to the value length.
+ * @return 0 in case of success, -ENOENT if the key is not stored, -ENOBUFS if
+ * the buffer is too small and negative error code otherwise.
+ */
+int32_t no_os_kv_get(struct no_os_kv_desc *desc, uint16_t key, void *data,
+		     uint16_t *len)
+{
+	struct no_os_kv_entry *entry;
+	uint16_t size;
+	int32_t ret;
+
+	if (!desc || !data || !len)
+		return -EINVAL;
+
+	entry = no_os_kv_find(desc, key);
+	if (!entry)
+		return -ENOENT;
+
+	size = *len;
+	*len = entry->len;
+	if (size < entry->len)
+		return -ENOBUFS;
+
+	ret = no_os_kv_read(desc, entry->addr, no_os_kv_rec_size(entry->len));
+	if (ret)
+		return ret;
+
+	memcpy(data, (struct no_os_kv_rec_hdr *)desc->buff + 1, entry->len);
+
+	return 0;
+}
+
+/**
+ * @brief Delete a key.
+ * @param desc - The store.
+ * @param key - The key.
+ * @return 0 in case of success, -ENOENT if the key is not stored and negative
+ * error code otherwise.
+ */
+int32_t no_os_kv_delete(struct no_os_kv_desc *desc, uint16_t key)
+{
+	if (!desc)
+		return -EINVAL;
+
+	if (!no_os_kv_find(desc, key))
+		return -ENOENT;
+
+	return no_os_kv_write(desc, key, NULL, 0);
+}
+
+/**
+ * @brief Free the resources allocated by no_os_kv_init().
+ * @param desc - The store.
+ * @return 0 in case of success, -EINVAL for wrong parameters.
+ */
+int32_t no_os_kv_remove(struct no_os_kv_desc *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	no_os_free(desc->buff);
+	no_os_free(desc->entries);
+	no_os_free(desc);
+
+	return 0;
+}
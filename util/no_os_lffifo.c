@@ -0,0 +1,247 @@
+/***************************************************************************//**
+ *   @file   no_os_lffifo.c
+ *   @brief  SPSC lock-free fifo of configurable element size and depth.
+********************************************************************************
+ *   @copyright
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "no_os_lffifo.h"
+#include "no_os_util.h"
+
+/*
+ * Each counter has a single writer. The fences make the element accesses of
+ * one side visible to the other before the counter that covers them.
+ */
+static uint32_t no_os_lffifo_load(const uint32_t *cnt)
+{
+	uint32_t val = *(const volatile uint32_t *)cnt;
+
+	atomic_thread_fence(memory_order_acquire);
+
+	return val;
+}
+
+static void no_os_lffifo_store(uint32_t *cnt, uint32_t val)
+{
+	atomic_thread_fence(memory_order_release);
+	*(volatile uint32_t *)cnt = val;
+}
+
+/*
+ * Copy nb elements between the fifo, starting at element idx, and buf. Done in
+ * two parts when the elements wrap at the end of the fifo.
+ */
+static void no_os_lffifo_copy(struct no_os_lffifo *fifo, uint32_t idx,
+			      uint8_t *buf, uint32_t nb, bool to_fifo)
+{
+	uint32_t offset = (idx & (fifo->depth - 1)) * fifo->elem_size;
+	uint32_t len = nb * fifo->elem_size;
+	uint32_t first = no_os_min(len, fifo->depth * fifo->elem_size - offset);
+
+	if (to_fifo) {
+		memcpy(fifo->data + offset, buf, first);
+		memcpy(fifo->data, buf + first, len - first);
+	} else {
+		memcpy(buf, fifo->data + offset, first);
+		memcpy(buf + first, fifo->data, len - first);
+	}
+}
+
+/**
+ * @brief Configure a fifo in the memory provided by the caller.
+ * @param fifo - pointer to fifo descriptor.
+ * @param data - memory area of depth * elem_size bytes.
+ * @param elem_size - size of an element in bytes.
+ * @param depth - number of elements, must be a power of 2.
+ * @return 0 if successful, negative error code otherwise.
+ */
+int no_os_lffifo_cfg(struct no_os_lffifo *fifo, void *data,
+		     uint32_t elem_size, uint32_t depth)
+{
+	if (!fifo || !data || !elem_size || !depth || (depth & (depth - 1)))
+		return -EINVAL;
+
+	fifo->data = data;
+	fifo->elem_size = elem_size;
+	fifo->depth = depth;
+	fifo->head = 0;
+	fifo->tail = 0;
+	fifo->allocated = false;
+
+	return 0;
+}
+
+/**
+ * @brief Initialize and allocate a lock-free fifo.
+ * @param fifo - pointer to a fifo descriptor pointer.
+ * @param elem_size - size of an element in bytes.
+ * @param depth - number of elements, must be a power of 2.
+ * @return 0 if successful, negative error code otherwise.
+ */
+int no_os_lffifo_init(struct no_os_lffifo **fifo, uint32_t elem_size,
+		      uint32_t depth)
+{
+	struct no_os_lffifo *b;
+	void *data;
+	int ret;
+
+	if (!fifo || !elem_size || !depth || (depth & (depth - 1)))
+		return -EINVAL;
+
+	b = calloc(1, sizeof(*b));
+	if (!b)
+		return -ENOMEM;
+
+	data = calloc(depth, elem_size);
+	if (!data) {
+		free(b);
+		return -ENOMEM;
+	}
+
+	ret = no_os_lffifo_cfg(b, data, elem_size, depth);
+	if (ret) {
+		free(data);
+		free(b);
+		return ret;
+	}
+	b->allocated = true;
+
+	*fifo = b;
+
+	return 0;
+}
+
+/**
+ * @brief Remove a fifo allocated by no_os_lffifo_init.
+ * @param fifo - pointer to fifo descriptor.
+ * @return void
+ */
+void no_os_lffifo_remove(struct no_os_lffifo *fifo)
+{
+	if (!fifo || !fifo->allocated)
+		return;
+
+	free(fifo->data);
+	free(fifo);
+}
+
+/**
+ * @brief Get the number of elements in the fifo.
+ * @param fifo - pointer to fifo descriptor.
+ * @return number of elements that can be read.
+ */
+uint32_t no_os_lffifo_count(struct no_os_lffifo *fifo)
+{
+	return no_os_lffifo_load(&fifo->head) - no_os_lffifo_load(&fifo->tail);
+}
+
+/**
+ * @brief Test whether fifo is full.
+ * @param fifo - pointer to fifo descriptor.
+ * @return true if fifo is full, false if not full.
+ */
+bool no_os_lffifo_is_full(struct no_os_lffifo *fifo)
+{
+	return no_os_lffifo_count(fifo) == fifo->depth;
+}
+
+/**
+ * @brief Test whether fifo is empty.
+ * @param fifo - pointer to fifo descriptor.
+ * @return true if fifo is empty, false if not empty.
+ */
+bool no_os_lffifo_is_empty(struct no_os_lffifo *fifo)
+{
+	return !no_os_lffifo_count(fifo);
+}
+
+/**
+ * @brief Write elements to the fifo. Only to be called by the producer.
+ * @param fifo - pointer to fifo descriptor.
+ * @param elems - elements to write.
+ * @param nb_elems - number of elements to write.
+ * @return number of elements written, less than nb_elems if fifo got full.
+ */
+uint32_t no_os_lffifo_write(struct no_os_lffifo *fifo, const void *elems,
+			    uint32_t nb_elems)
+{
+	uint32_t head = fifo->head;
+	uint32_t space = fifo->depth - (head - no_os_lffifo_load(&fifo->tail));
+
+	nb_elems = no_os_min(nb_elems, space);
+	if (!nb_elems)
+		return 0;
+
+	no_os_lffifo_copy(fifo, head, (uint8_t *)elems, nb_elems, true);
+	no_os_lffifo_store(&fifo->head, head + nb_elems);
+
+	return nb_elems;
+}
+
+/**
+ * @brief Read elements from the fifo. Only to be called by the consumer.
+ * @param fifo - pointer to fifo descriptor.
+ * @param elems - where to store the elements.
+ * @param nb_elems - number of elements to read.
+ * @return number of elements read, less than nb_elems if fifo got empty.
+ */
+uint32_t no_os_lffifo_read(struct no_os_lffifo *fifo, void *elems,
+			   uint32_t nb_elems)
+{
+	uint32_t tail = fifo->tail;
+	uint32_t count = no_os_lffifo_load(&fifo->head) - tail;
+
+	nb_elems = no_os_min(nb_elems, count);
+	if (!nb_elems)
+		return 0;
+
+	no_os_lffifo_copy(fifo, tail, elems, nb_elems, false);
+	no_os_lffifo_store(&fifo->tail, tail + nb_elems);
+
+	return nb_elems;
+}
+
+/**
+ * @brief Drop all the elements of the fifo. Only to be called by the consumer.
+ * @param fifo - pointer to fifo descriptor.
+ * @return void
+ */
+void no_os_lffifo_flush(struct no_os_lffifo *fifo)
+{
+	no_os_lffifo_store(&fifo->tail, no_os_lffifo_load(&fifo->head));
+}
@@ -43,8 +43,20 @@
 
 #include "no_os_list.h"
 #include "no_os_error.h"
+#include "no_os_alloc.h"
 #include <stdlib.h>
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#ifdef NO_OS_STATIC_ALLOC
+/* Elements shared by all the lists, they come and go at runtime */
+#ifndef NO_OS_LIST_ELEM_POOL_SIZE
+#define NO_OS_LIST_ELEM_POOL_SIZE	64
+#endif
+#endif
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -92,6 +104,51 @@ struct _list_desc {
 	struct no_os_iterator		l_it;
 };
 
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+#ifdef NO_OS_STATIC_ALLOC
+static struct no_os_pool no_os_list_elem_pool;
+#endif
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Allocate a list element. With NO_OS_STATIC_ALLOC it is taken from a
+ * pool, so adding and removing elements doesn't use up the static arena.
+ * @return zeroed element, NULL if allocation fails.
+ */
+static struct no_os_list_elem *no_os_list_elem_alloc(void)
+{
+#ifdef NO_OS_STATIC_ALLOC
+	if (!no_os_list_elem_pool.mem &&
+	    no_os_pool_init(&no_os_list_elem_pool,
+			    sizeof(struct no_os_list_elem),
+			    NO_OS_LIST_ELEM_POOL_SIZE))
+		return NULL;
+
+	return no_os_pool_alloc(&no_os_list_elem_pool);
+#else
+	return no_os_calloc(1, sizeof(struct no_os_list_elem));
+#endif
+}
+
+/**
+ * @brief Free a list element.
+ * @param elem - Element obtained with no_os_list_elem_alloc.
+ */
+static void no_os_list_elem_free(struct no_os_list_elem *elem)
+{
+#ifdef NO_OS_STATIC_ALLOC
+	no_os_pool_free(&no_os_list_elem_pool, elem);
+#else
+	no_os_free(elem);
+#endif
+}
+
 /** @brief Default function used to compare element in the list ( \ref f_cmp) */
 static int32_t no_os_default_comparator(void *data1, void *data2)
 {
@@ -111,7 +168,7 @@ static inline struct no_os_list_elem *create_element(void *data,
 {
 	struct no_os_list_elem *elem;
 
-	elem = (struct no_os_list_elem *)calloc(1, sizeof(*elem));
+	elem = no_os_list_elem_alloc();
 	if (!elem)
 		return NULL;
 	elem->data = data;
@@ -217,12 +274,12 @@ int32_t no_os_list_init(struct no_os_list_desc **list_desc,
 
 	if (!list_desc)
 		return -1;
-	l_desc = (struct no_os_list_desc *)calloc(1, sizeof(*l_desc));
+	l_desc = (struct no_os_list_desc *)no_os_calloc(1, sizeof(*l_desc));
 	if (!l_desc)
 		return -1;
-	list = (struct _list_desc *)calloc(1, sizeof(*list));
+	list = (struct _list_desc *)no_os_calloc(1, sizeof(*list));
 	if (!list) {
-		free(l_desc);
+		no_os_free(l_desc);
 		return -1;
 	}
 
@@ -262,8 +319,8 @@ int32_t no_os_list_remove(struct no_os_list_desc *list_desc)
 	/* Remove all the elements */
 	while (0 == no_os_list_get_first(list_desc, &data))
 		;
-	free(list_desc->priv_desc);
-	free(list_desc);
+	no_os_free(list_desc->priv_desc);
+	no_os_free(list_desc);
 
 	return 0;
 }
@@ -565,7 +622,7 @@ int32_t no_os_list_get_first(struct no_os_list_desc *list_desc, void **data)
 	list->nb_elements--;
 
 	*data = elem->data;
-	free(elem);
+	no_os_list_elem_free(elem);
 
 	return 0;
 }
@@ -595,7 +652,7 @@ int32_t no_os_list_get_last(struct no_os_list_desc *list_desc, void **data)
 	list->nb_elements--;
 
 	*data = elem->data;
-	free(elem);
+	no_os_list_elem_free(elem);
 
 	return 0;
 }
@@ -658,7 +715,7 @@ int32_t no_os_iterator_init(struct no_os_iterator **iter,
 	if (!list_desc)
 		return -1;
 
-	it = (struct no_os_iterator *)calloc(1, sizeof(*it));
+	it = (struct no_os_iterator *)no_os_calloc(1, sizeof(*it));
 	if (!it)
 		return -1;
 	it->list = list_desc->priv_desc;
@@ -684,7 +741,7 @@ int32_t no_os_iterator_remove(struct no_os_iterator *iter)
 		return -1;
 
 	it->list->nb_iterators--;
-	free(it);
+	no_os_free(it);
 
 	return 0;
 }
@@ -825,7 +882,7 @@ int32_t no_os_iterator_get(struct no_os_iterator *iter, void **data)
 		next = it->elem->prev;
 	else
 		next = it->elem->next;
-	free(it->elem);
+	no_os_list_elem_free(it->elem);
 	it->elem = next;
 
 	return 0;
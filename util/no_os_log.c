@@ -0,0 +1,320 @@
+/***************************************************************************//**
+ *   @file   no_os_log.c
+ *   @brief  Implementation of the deferred binary logger.
+********************************************************************************
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "no_os_log.h"
+#include "no_os_delay.h"
+#include "no_os_uart.h"
+#include "no_os_util.h"
+#include "no_os_error.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/*
+ * Slot of the ring. seq is the index of the message plus one once it is
+ * written and 0 while it is being written.
+ */
+struct no_os_log_slot {
+	atomic_uint seq;
+	struct no_os_log_msg msg;
+};
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+static struct no_os_log_slot no_os_log_ring[NO_OS_LOG_DEPTH];
+/* Number of messages recorded, wraps around */
+static atomic_uint no_os_log_head;
+/* Index of the next message to be sent */
+static uint32_t no_os_log_tail;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Start a message.
+ * @param msg - Message.
+ * @param fmt - Format string.
+ */
+void no_os_log_start(struct no_os_log_msg *msg, const char *fmt)
+{
+#if defined(PRINT_TIME)
+	struct no_os_time t = no_os_get_time();
+
+	msg->timestamp = t.s * 1000000 + t.us;
+#else
+	msg->timestamp = 0;
+#endif
+	msg->fmt = fmt;
+	msg->len = 0;
+}
+
+/**
+ * @brief Add an encoded argument to a message. Once an argument doesn't fit,
+ * the message is marked as truncated and the next arguments are ignored.
+ * @param msg - Message.
+ * @param type - NO_OS_LOG_ARG_* type of the argument.
+ * @param val - Value, in little endian.
+ * @param len - Size of val.
+ */
+static void no_os_log_put(struct no_os_log_msg *msg, uint8_t type,
+			  const void *val, uint32_t len)
+{
+	if (msg->len && msg->data[msg->len - 1] == NO_OS_LOG_ARG_TRUNC)
+		return;
+
+	if (msg->len + 1 + len > NO_OS_LOG_DATA_SIZE - 1) {
+		msg->data[msg->len++] = NO_OS_LOG_ARG_TRUNC;
+		return;
+	}
+
+	msg->data[msg->len++] = type;
+	memcpy(msg->data + msg->len, val, len);
+	msg->len += len;
+}
+
+/**
+ * @brief Add an integer or pointer argument to a message.
+ * @param msg - Message.
+ * @param val - Value.
+ */
+void no_os_log_put_word(struct no_os_log_msg *msg, uint32_t val)
+{
+	uint8_t buf[4];
+
+	no_os_put_unaligned_le32(val, buf);
+	no_os_log_put(msg, NO_OS_LOG_ARG_WORD, buf, sizeof(buf));
+}
+
+/**
+ * @brief Add a 64 bit integer argument to a message.
+ * @param msg - Message.
+ * @param val - Value.
+ */
+void no_os_log_put_u64(struct no_os_log_msg *msg, uint64_t val)
+{
+	uint8_t buf[8];
+
+	no_os_put_unaligned_le32(val, buf);
+	no_os_put_unaligned_le32(val >> 32, buf + 4);
+	no_os_log_put(msg, NO_OS_LOG_ARG_U64, buf, sizeof(buf));
+}
+
+/**
+ * @brief Add a long argument to a message, sent as a 64 bit value where long is
+ * 64 bits wide.
+ * @param msg - Message.
+ * @param val - Value.
+ */
+void no_os_log_put_long(struct no_os_log_msg *msg, unsigned long val)
+{
+	if (sizeof(val) > sizeof(uint32_t))
+		no_os_log_put_u64(msg, val);
+	else
+		no_os_log_put_word(msg, val);
+}
+
+/**
+ * @brief Add a floating point argument to a message.
+ * @param msg - Message.
+ * @param val - Value.
+ */
+void no_os_log_put_double(struct no_os_log_msg *msg, double val)
+{
+	uint64_t bits;
+	uint8_t buf[8];
+
+	memcpy(&bits, &val, sizeof(bits));
+	no_os_put_unaligned_le32(bits, buf);
+	no_os_put_unaligned_le32(bits >> 32, buf + 4);
+	no_os_log_put(msg, NO_OS_LOG_ARG_DOUBLE, buf, sizeof(buf));
+}
+
+/**
+ * @brief Add a string argument to a message. The characters are copied, as the
+ * string may not exist anymore when the message is sent. Long strings are cut
+ * to the room left in the message.
+ * @param msg - Message.
+ * @param str - String.
+ */
+void no_os_log_put_str(struct no_os_log_msg *msg, const char *str)
+{
+	uint8_t buf[NO_OS_LOG_DATA_SIZE];
+	uint32_t len;
+
+	if (!str)
+		str = "(null)";
+
+	/* Type, length and the truncation mark of the message */
+	len = NO_OS_LOG_DATA_SIZE - no_os_min(msg->len + 3,
+					      NO_OS_LOG_DATA_SIZE);
+	len = strnlen(str, len);
+	buf[0] = len;
+	memcpy(buf + 1, str, len);
+	no_os_log_put(msg, NO_OS_LOG_ARG_STR, buf, len + 1);
+}
+
+/**
+ * @brief Store a message in the ring. Lock-free, it can interrupt or be
+ * interrupted by another no_os_log_commit. The oldest message is overwritten
+ * if the ring is full.
+ * @param msg - Message.
+ */
+void no_os_log_commit(struct no_os_log_msg *msg)
+{
+	struct no_os_log_slot *slot;
+	uint32_t idx;
+
+	idx = atomic_fetch_add_explicit(&no_os_log_head, 1,
+					memory_order_relaxed);
+	slot = &no_os_log_ring[idx & (NO_OS_LOG_DEPTH - 1)];
+
+	atomic_store_explicit(&slot->seq, 0, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	memcpy(&slot->msg, msg, offsetof(struct no_os_log_msg, data) +
+	       msg->len);
+	atomic_store_explicit(&slot->seq, idx + 1, memory_order_release);
+}
+
+/**
+ * @brief Get and remove the oldest message. There must be only one reader at
+ * a time.
+ * @param msg - Where to store the message.
+ * @param lost - Incremented with the number of messages overwritten before
+ * being read.
+ * @return 1 if a message was stored in msg, 0 otherwise.
+ */
+static uint32_t no_os_log_read(struct no_os_log_msg *msg, uint32_t *lost)
+{
+	struct no_os_log_slot *slot;
+	uint32_t head, seq;
+
+	head = atomic_load_explicit(&no_os_log_head, memory_order_acquire);
+	if (head - no_os_log_tail > NO_OS_LOG_DEPTH) {
+		*lost += head - NO_OS_LOG_DEPTH - no_os_log_tail;
+		no_os_log_tail = head - NO_OS_LOG_DEPTH;
+	}
+
+	while (no_os_log_tail != head) {
+		slot = &no_os_log_ring[no_os_log_tail & (NO_OS_LOG_DEPTH - 1)];
+		seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+		if (seq != no_os_log_tail + 1 &&
+		    (int32_t)(seq - no_os_log_tail - 1) <= 0)
+			/* Still being written */
+			return 0;
+
+		*msg = slot->msg;
+		atomic_thread_fence(memory_order_acquire);
+		no_os_log_tail++;
+		if (seq == no_os_log_tail &&
+		    atomic_load_explicit(&slot->seq,
+					 memory_order_relaxed) == seq &&
+		    msg->len <= NO_OS_LOG_DATA_SIZE)
+			return 1;
+		(*lost)++;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Send a message as a frame.
+ * @param uart - UART descriptor, NULL for stdout.
+ * @param msg - Message.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t no_os_log_send(struct no_os_uart_desc *uart,
+			      struct no_os_log_msg *msg)
+{
+	uint8_t frame[NO_OS_LOG_HDR_SIZE + NO_OS_LOG_DATA_SIZE];
+	uint32_t len = NO_OS_LOG_HDR_SIZE + msg->len;
+	int32_t ret;
+
+	frame[0] = NO_OS_LOG_MAGIC;
+	frame[1] = len;
+	no_os_put_unaligned_le32((uintptr_t)msg->fmt, frame + 2);
+	no_os_put_unaligned_le32(msg->timestamp, frame + 6);
+	memcpy(frame + NO_OS_LOG_HDR_SIZE, msg->data, msg->len);
+
+	if (!uart)
+		return fwrite(frame, 1, len, stdout) == len ? 0 : -EIO;
+
+	ret = no_os_uart_write(uart, frame, len);
+
+	return ret < 0 ? ret : 0;
+}
+
+/**
+ * @brief Send the recorded messages as frames, followed by a message with the
+ * number of lost messages if any. To be called when idle, like in the main
+ * loop, as sending may block.
+ * @param uart - UART descriptor, NULL for stdout.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_log_flush(struct no_os_uart_desc *uart)
+{
+	struct no_os_log_msg msg;
+	uint32_t lost = 0;
+	int32_t ret = 0;
+
+	while (!ret && no_os_log_read(&msg, &lost))
+		ret = no_os_log_send(uart, &msg);
+
+	if (!ret && lost) {
+		no_os_log_start(&msg, NULL);
+		no_os_log_put_word(&msg, lost);
+		ret = no_os_log_send(uart, &msg);
+	}
+
+	if (!uart)
+		fflush(stdout);
+
+	return ret;
+}
@@ -0,0 +1,155 @@
+/***************************************************************************//**
+ *   @file   no_os_pll_cache.c
+ *   @brief  Implementation of the PLL frequency plan cache.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stddef.h>
+#include "no_os_pll_cache.h"
+#include "no_os_error.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Initialize an empty cache.
+ * @param cache - The cache.
+ * @param tags - Storage for nb_entries tags, owned by the user.
+ * @param plans - Storage for nb_entries plans, owned by the user.
+ * @param plan_size - Size of a plan in bytes.
+ * @param nb_entries - Number of plans kept.
+ * @return 0 in case of success, -EINVAL for wrong parameters.
+ */
+int32_t no_os_pll_cache_init(struct no_os_pll_cache *cache,
+			     struct no_os_pll_cache_tag *tags, void *plans,
+			     uint32_t plan_size, uint32_t nb_entries)
+{
+	if (!cache || !tags || !plans || !plan_size || !nb_entries)
+		return -EINVAL;
+
+	cache->tags = tags;
+	cache->plans = plans;
+	cache->plan_size = plan_size;
+	cache->nb_entries = nb_entries;
+	no_os_pll_cache_invalidate(cache);
+
+	return 0;
+}
+
+/**
+ * @brief Mark an entry as the most recently used one.
+ * @param cache - The cache.
+ * @param idx - Index of the entry.
+ */
+static void no_os_pll_cache_touch(struct no_os_pll_cache *cache, uint32_t idx)
+{
+	uint32_t i;
+
+	if (++cache->clock == 0) {
+		/* Wrapped around, restart the ages keeping the entries */
+		for (i = 0; i < cache->nb_entries; i++)
+			if (cache->tags[i].stamp)
+				cache->tags[i].stamp = 1;
+		cache->clock = 2;
+	}
+
+	cache->tags[idx].stamp = cache->clock;
+}
+
+/**
+ * @brief Look up the plan of a frequency.
+ * @param cache - The cache.
+ * @param freq - Requested frequency.
+ * @param key - Driver state the plan depends on.
+ * @return the plan, NULL if it is not cached.
+ */
+void *no_os_pll_cache_find(struct no_os_pll_cache *cache, uint64_t freq,
+			   uint32_t key)
+{
+	struct no_os_pll_cache_tag *tag;
+	uint32_t i;
+
+	for (i = 0; i < cache->nb_entries; i++) {
+		tag = &cache->tags[i];
+		if (tag->stamp && tag->freq == freq && tag->key == key) {
+			no_os_pll_cache_touch(cache, i);
+			return cache->plans + i * cache->plan_size;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Reserve the entry of a new plan, replacing the least recently used
+ * one. The caller fills the returned storage.
+ * @param cache - The cache.
+ * @param freq - Requested frequency.
+ * @param key - Driver state the plan depends on.
+ * @return storage of plan_size bytes for the plan.
+ */
+void *no_os_pll_cache_add(struct no_os_pll_cache *cache, uint64_t freq,
+			  uint32_t key)
+{
+	uint32_t i, lru = 0;
+
+	for (i = 1; i < cache->nb_entries; i++)
+		if (cache->tags[i].stamp < cache->tags[lru].stamp)
+			lru = i;
+
+	cache->tags[lru].freq = freq;
+	cache->tags[lru].key = key;
+	no_os_pll_cache_touch(cache, lru);
+
+	return cache->plans + lru * cache->plan_size;
+}
+
+/**
+ * @brief Drop all the plans.
+ * @param cache - The cache.
+ */
+void no_os_pll_cache_invalidate(struct no_os_pll_cache *cache)
+{
+	uint32_t i;
+
+	for (i = 0; i < cache->nb_entries; i++)
+		cache->tags[i].stamp = 0;
+	cache->clock = 0;
+}
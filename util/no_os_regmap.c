@@ -0,0 +1,414 @@
+/***************************************************************************//**
+ *   @file   no_os_regmap.c
+ *   @brief  SPI register map helper with write cache and burst access
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "no_os_regmap.h"
+#include "no_os_error.h"
+#include "no_os_util.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Test a bit of a register bitmap.
+ * @param map - The bitmap.
+ * @param reg - Register address.
+ * @return true if the bit is set.
+ */
+static bool no_os_regmap_test(const uint32_t *map, uint16_t reg)
+{
+	return map[reg / 32] & ((uint32_t)1 << (reg % 32));
+}
+
+/**
+ * @brief Set or clear a bit of a register bitmap.
+ * @param map - The bitmap.
+ * @param reg - Register address.
+ * @param set - New value of the bit.
+ */
+static void no_os_regmap_assign(uint32_t *map, uint16_t reg, bool set)
+{
+	if (set)
+		map[reg / 32] |= ((uint32_t)1 << (reg % 32));
+	else
+		map[reg / 32] &= ~((uint32_t)1 << (reg % 32));
+}
+
+/**
+ * @brief Access consecutive registers of the device, splitting the access in
+ * bursts of at most max_burst registers.
+ * @param desc - The register map.
+ * @param reg - First register address.
+ * @param vals - Register values, in ascending address order.
+ * @param count - Number of registers.
+ * @param read - Set for reading, clear for writing.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t no_os_regmap_burst(struct no_os_regmap_desc *desc,
+				  uint16_t reg, uint8_t *vals, uint16_t count,
+				  bool read)
+{
+	uint8_t *data = desc->buf + desc->addr_bytes;
+	uint16_t addr;
+	uint16_t n;
+	uint16_t i;
+	int32_t ret;
+
+	while (count) {
+		n = no_os_min(count, desc->max_burst);
+
+		/* The burst starts from its highest register when descending */
+		addr = desc->addr_descending ? reg + n - 1 : reg;
+		addr |= read ? desc->read_mask : desc->write_mask;
+		if (desc->addr_bytes == 2) {
+			desc->buf[0] = addr >> 8;
+			desc->buf[1] = addr & 0xFF;
+		} else {
+			desc->buf[0] = addr & 0xFF;
+		}
+
+		for (i = 0; i < n; i++)
+			data[i] = read ? 0 :
+				  vals[desc->addr_descending ? n - 1 - i : i];
+
+		ret = no_os_spi_write_and_read(desc->spi, desc->buf,
+					       desc->addr_bytes + n);
+		if (ret)
+			return ret;
+
+		if (read)
+			for (i = 0; i < n; i++)
+				vals[desc->addr_descending ? n - 1 - i : i] =
+					data[i];
+
+		reg += n;
+		vals += n;
+		count -= n;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Initialize a register map.
+ * @param desc - The register map.
+ * @param param - The structure that contains the register map parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_regmap_init(struct no_os_regmap_desc **desc,
+			  const struct no_os_regmap_init_param *param)
+{
+	struct no_os_regmap_desc *d;
+	uint32_t words;
+
+	if (!desc || !param || !param->spi || !param->max_burst ||
+	    (param->addr_bytes != 1 && param->addr_bytes != 2))
+		return -EINVAL;
+
+	d = calloc(1, sizeof(*d));
+	if (!d)
+		return -ENOMEM;
+
+	words = NO_OS_DIV_ROUND_UP(param->nb_regs, 32);
+	d->cache = calloc(param->nb_regs ? param->nb_regs : 1,
+			  sizeof(*d->cache));
+	d->valid = calloc(words ? words : 1, sizeof(*d->valid));
+	d->dirty = calloc(words ? words : 1, sizeof(*d->dirty));
+	d->buf = calloc(param->addr_bytes + param->max_burst, sizeof(*d->buf));
+	if (!d->cache || !d->valid || !d->dirty || !d->buf) {
+		no_os_regmap_remove(d);
+		return -ENOMEM;
+	}
+
+	d->spi = param->spi;
+	d->addr_bytes = param->addr_bytes;
+	d->read_mask = param->read_mask;
+	d->write_mask = param->write_mask;
+	d->addr_descending = param->addr_descending;
+	d->nb_regs = param->nb_regs;
+	d->max_burst = param->max_burst;
+
+	*desc = d;
+
+	return 0;
+}
+
+/**
+ * @brief Free the resources allocated by no_os_regmap_init().
+ * Dirty registers are not written.
+ * @param desc - The register map.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_regmap_remove(struct no_os_regmap_desc *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	free(desc->buf);
+	free(desc->dirty);
+	free(desc->valid);
+	free(desc->cache);
+	free(desc);
+
+	return 0;
+}
+
+/**
+ * @brief Read consecutive registers. The cache is updated with the values
+ * read, except for the dirty registers, whose cached value is returned.
+ * @param desc - The register map.
+ * @param reg - First register address.
+ * @param vals - Where to store the values.
+ * @param count - Number of registers.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_regmap_bulk_read(struct no_os_regmap_desc *desc, uint16_t reg,
+			       uint8_t *vals, uint16_t count)
+{
+	uint32_t r;
+	uint16_t i;
+	int32_t ret;
+
+	if (!desc || !vals)
+		return -EINVAL;
+
+	ret = no_os_regmap_burst(desc, reg, vals, count, true);
+	if (ret)
+		return ret;
+
+	for (i = 0; i < count; i++) {
+		r = reg + i;
+		if (r >= desc->nb_regs)
+			break;
+		if (no_os_regmap_test(desc->dirty, r)) {
+			vals[i] = desc->cache[r];
+		} else {
+			desc->cache[r] = vals[i];
+			no_os_regmap_assign(desc->valid, r, true);
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Write consecutive registers. In cache only mode, the cached
+ * registers are only marked dirty.
+ * @param desc - The register map.
+ * @param reg - First register address.
+ * @param vals - Values to write.
+ * @param count - Number of registers.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_regmap_bulk_write(struct no_os_regmap_desc *desc, uint16_t reg,
+				const uint8_t *vals, uint16_t count)
+{
+	uint32_t r;
+	uint16_t i;
+	int32_t ret;
+
+	if (!desc || !vals)
+		return -EINVAL;
+
+	if (desc->cache_only && (uint32_t)reg + count <= desc->nb_regs) {
+		for (i = 0; i < count; i++) {
+			desc->cache[reg + i] = vals[i];
+			no_os_regmap_assign(desc->valid, reg + i, true);
+			no_os_regmap_assign(desc->dirty, reg + i, true);
+		}
+
+		return 0;
+	}
+
+	ret = no_os_regmap_burst(desc, reg, (uint8_t *)vals, count, false);
+	if (ret)
+		return ret;
+
+	for (i = 0; i < count; i++) {
+		r = reg + i;
+		if (r >= desc->nb_regs)
+			break;
+		desc->cache[r] = vals[i];
+		no_os_regmap_assign(desc->valid, r, true);
+		no_os_regmap_assign(desc->dirty, r, false);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Read a register. In cache only mode, the cached value is returned
+ * if known.
+ * @param desc - The register map.
+ * @param reg - Register address.
+ * @param val - Where to store the value.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_regmap_read(struct no_os_regmap_desc *desc, uint16_t reg,
+			  uint8_t *val)
+{
+	if (!desc || !val)
+		return -EINVAL;
+
+	if (desc->cache_only && reg < desc->nb_regs &&
+	    no_os_regmap_test(desc->valid, reg)) {
+		*val = desc->cache[reg];
+		return 0;
+	}
+
+	return no_os_regmap_bulk_read(desc, reg, val, 1);
+}
+
+/**
+ * @brief Write a register.
+ * @param desc - The register map.
+ * @param reg - Register address.
+ * @param val - Value to write.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_regmap_write(struct no_os_regmap_desc *desc, uint16_t reg,
+			   uint8_t val)
+{
+	return no_os_regmap_bulk_write(desc, reg, &val, 1);
+}
+
+/**
+ * @brief Update some bits of a register. The device is only read if the
+ * register value is not cached.
+ * @param desc - The register map.
+ * @param reg - Register address.
+ * @param mask - Bits to update.
+ * @param val - New value of the bits.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_regmap_update_bits(struct no_os_regmap_desc *desc, uint16_t reg,
+				 uint8_t mask, uint8_t val)
+{
+	uint8_t cur;
+	int32_t ret;
+
+	if (!desc)
+		return -EINVAL;
+
+	if (reg < desc->nb_regs && no_os_regmap_test(desc->valid, reg)) {
+		cur = desc->cache[reg];
+	} else {
+		ret = no_os_regmap_bulk_read(desc, reg, &cur, 1);
+		if (ret)
+			return ret;
+	}
+
+	return no_os_regmap_write(desc, reg, (cur & ~mask) | (val & mask));
+}
+
+/**
+ * @brief Enable or disable the cache only mode.
+ * Disabling it does not write the dirty registers, no_os_regmap_sync() does.
+ * @param desc - The register map.
+ * @param enable - New state of the mode.
+ */
+void no_os_regmap_cache_only(struct no_os_regmap_desc *desc, bool enable)
+{
+	desc->cache_only = enable;
+}
+
+/**
+ * @brief Drop all the cached values, including the dirty ones.
+ * @param desc - The register map.
+ */
+void no_os_regmap_cache_invalidate(struct no_os_regmap_desc *desc)
+{
+	uint32_t words = NO_OS_DIV_ROUND_UP(desc->nb_regs, 32);
+
+	memset(desc->valid, 0, words * sizeof(*desc->valid));
+	memset(desc->dirty, 0, words * sizeof(*desc->dirty));
+}
+
+/**
+ * @brief Write all the dirty registers to the device. Each run of consecutive
+ * dirty registers is written in bursts.
+ * @param desc - The register map.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_regmap_sync(struct no_os_regmap_desc *desc)
+{
+	uint16_t start;
+	uint16_t reg;
+	uint16_t i;
+	int32_t ret;
+
+	if (!desc)
+		return -EINVAL;
+
+	reg = 0;
+	while (reg < desc->nb_regs) {
+		/* Skip a whole bitmap word when nothing in it is dirty */
+		if (!(reg % 32) && !desc->dirty[reg / 32]) {
+			reg += 32;
+			continue;
+		}
+
+		if (!no_os_regmap_test(desc->dirty, reg)) {
+			reg++;
+			continue;
+		}
+
+		start = reg;
+		while (reg < desc->nb_regs &&
+		       no_os_regmap_test(desc->dirty, reg))
+			reg++;
+
+		ret = no_os_regmap_burst(desc, start, &desc->cache[start],
+					 reg - start, false);
+		if (ret)
+			return ret;
+
+		for (i = start; i < reg; i++)
+			no_os_regmap_assign(desc->dirty, i, false);
+	}
+
+	return 0;
+}
@@ -0,0 +1,457 @@
+/***************************************************************************//**
+ *   @file   no_os_sched.c
+ *   @brief  Implementation of the cooperative scheduler.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "no_os_sched.h"
+#include "no_os_error.h"
+
+#ifdef NO_OS_SCHED
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+/* Works added to the scheduler, run in the order they were added */
+static struct no_os_ilist no_os_sched_works = {
+	.head = {
+		.prev = &no_os_sched_works.head,
+		.next = &no_os_sched_works.head,
+	},
+};
+
+static int32_t no_os_sched_cmp(void *data1, void *data2);
+
+/* Armed timers, the one expiring first on top */
+static void *no_os_sched_timer_elems[NO_OS_SCHED_MAX_TIMERS];
+static struct no_os_heap no_os_sched_timers = {
+	.elems = no_os_sched_timer_elems,
+	.size = NO_OS_SCHED_MAX_TIMERS,
+	.cmp = no_os_sched_cmp,
+};
+
+/* Set by no_os_sched_post, cleared when the loop starts looking for works */
+static volatile bool no_os_sched_kick;
+
+/* Users needing the clocks, see no_os_sched_deep_lock */
+static atomic_uint no_os_sched_deep_locks;
+
+/* Waking up the deep sleep states when a timer is armed */
+static struct no_os_rtc_desc *no_os_sched_rtc;
+
+/* Time the time base was stopped by the deep sleep states, in ms */
+static uint32_t no_os_sched_skipped;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Get the time base of the timers.
+ * @return Milliseconds since the system start, wrapping around.
+ */
+static uint32_t no_os_sched_now(void)
+{
+	struct no_os_time t = no_os_get_time();
+
+	return t.s * 1000 + t.us / 1000 + no_os_sched_skipped;
+}
+
+/**
+ * @brief Order the timers by deadline, the comparison being correct across
+ * the wrap around of the time base.
+ * @param data1 - Work.
+ * @param data2 - Work.
+ * @return Negative value if data1 expires first, positive if data2 does.
+ */
+static int32_t no_os_sched_cmp(void *data1, void *data2)
+{
+	struct no_os_sched_work *w1 = data1;
+	struct no_os_sched_work *w2 = data2;
+
+	return (int32_t)(w1->deadline - w2->deadline);
+}
+
+/**
+ * @brief Add a work to the scheduler. Works are run from the loop, never
+ * from an interrupt.
+ * @param work - The work, owned by the user.
+ * @param fn - Function to run.
+ * @param ctx - Parameter of fn.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_sched_work_add(struct no_os_sched_work *work,
+			     void (*fn)(void *ctx), void *ctx)
+{
+	if (!work || !fn)
+		return -EINVAL;
+
+	if (work->added)
+		return -EBUSY;
+
+	work->fn = fn;
+	work->ctx = ctx;
+	work->pending = false;
+	work->running = false;
+	work->timer_armed = false;
+	work->added = true;
+	no_os_ilist_add_last(&no_os_sched_works, &work->node);
+
+	return 0;
+}
+
+/**
+ * @brief Remove a work from the scheduler, disarming its timer. Works can be
+ * removed while any work runs, including the removed one.
+ * @param work - The work.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_sched_work_remove(struct no_os_sched_work *work)
+{
+	if (!work || !work->added)
+		return -EINVAL;
+
+	no_os_sched_timer_stop(work);
+	no_os_ilist_del(&no_os_sched_works, &work->node);
+	work->added = false;
+	work->pending = false;
+
+	return 0;
+}
+
+/**
+ * @brief Make a work run on the next loop iteration. Safe from interrupts,
+ * posting a work already pending runs it once.
+ * @param work - The work.
+ */
+void no_os_sched_post(struct no_os_sched_work *work)
+{
+	if (!work)
+		return;
+
+	work->pending = true;
+	no_os_sched_kick = true;
+}
+
+/**
+ * @brief Arm the timer of a work, rearming it if already armed.
+ * @param work - Work added to the scheduler.
+ * @param delay_ms - Milliseconds until the first post.
+ * @param period_ms - Milliseconds between the next posts, 0 for one post.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_sched_timer_start(struct no_os_sched_work *work,
+				uint32_t delay_ms, uint32_t period_ms)
+{
+	int32_t ret;
+
+	if (!work || !work->added)
+		return -EINVAL;
+
+	no_os_sched_timer_stop(work);
+
+	work->deadline = no_os_sched_now() + delay_ms;
+	work->period = period_ms;
+	ret = no_os_heap_push(&no_os_sched_timers, work);
+	if (ret)
+		return ret;
+
+	work->timer_armed = true;
+
+	return 0;
+}
+
+/**
+ * @brief Disarm the timer of a work. A post already done is not canceled.
+ * @param work - The work.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_sched_timer_stop(struct no_os_sched_work *work)
+{
+	if (!work)
+		return -EINVAL;
+
+	if (!work->timer_armed)
+		return 0;
+
+	work->timer_armed = false;
+
+	return no_os_heap_remove(&no_os_sched_timers, work);
+}
+
+/**
+ * @brief Post the works of the expired timers and rearm the periodic ones.
+ * A periodic timer late by more than one period is not posted several times.
+ */
+static void no_os_sched_run_timers(void)
+{
+	struct no_os_sched_work *work;
+	uint32_t now = no_os_sched_now();
+	void *data;
+
+	while (!no_os_heap_peek(&no_os_sched_timers, &data)) {
+		work = data;
+		if ((int32_t)(now - work->deadline) < 0)
+			break;
+
+		no_os_heap_pop(&no_os_sched_timers, &data);
+		if (work->period) {
+			work->deadline += work->period;
+			if ((int32_t)(now - work->deadline) >= 0)
+				work->deadline = now + work->period;
+			no_os_heap_push(&no_os_sched_timers, work);
+		} else {
+			work->timer_armed = false;
+		}
+
+		no_os_sched_post(work);
+	}
+}
+
+/**
+ * @brief Initialize event flags.
+ * @param ev - The event flags.
+ * @param waiter - Work posted each time flags are set, can be NULL.
+ */
+void no_os_sched_event_init(struct no_os_sched_event *ev,
+			    struct no_os_sched_work *waiter)
+{
+	atomic_init(&ev->flags, 0);
+	ev->waiter = waiter;
+}
+
+/**
+ * @brief Set event flags and post the waiting work. Safe from interrupts.
+ * @param ev - The event flags.
+ * @param mask - Flags to set.
+ */
+void no_os_sched_event_set(struct no_os_sched_event *ev, uint32_t mask)
+{
+	atomic_fetch_or(&ev->flags, mask);
+	no_os_sched_post(ev->waiter);
+}
+
+/**
+ * @brief Get and clear event flags, usually from the waiting work.
+ * @param ev - The event flags.
+ * @param mask - Flags to take.
+ * @return the flags of mask that were set.
+ */
+uint32_t no_os_sched_event_take(struct no_os_sched_event *ev, uint32_t mask)
+{
+	return atomic_fetch_and(&ev->flags, ~mask) & mask;
+}
+
+/**
+ * @brief Check if a work was posted and did not run yet. Called by
+ * no_os_sched_idle with the interrupts masked, before sleeping.
+ * @return true if the loop has to run again.
+ */
+bool no_os_sched_pending(void)
+{
+	return no_os_sched_kick;
+}
+
+/**
+ * @brief Run the expired timers and the posted works once, in the order they
+ * were added. The works currently running, from which no_os_sched_yield was
+ * called, stay pending.
+ * @return the number of works run.
+ */
+uint32_t no_os_sched_run_once(void)
+{
+	struct no_os_ilist_node *node, *next;
+	struct no_os_sched_work *work;
+	uint32_t nb = 0;
+
+	no_os_sched_kick = false;
+	no_os_sched_run_timers();
+
+	for (node = no_os_sched_works.head.next;
+	     node != &no_os_sched_works.head; node = next) {
+		next = node->next;
+		work = no_os_container_of(node, struct no_os_sched_work, node);
+		if (!work->pending)
+			continue;
+
+		if (work->running) {
+			no_os_sched_kick = true;
+			continue;
+		}
+
+		work->pending = false;
+		work->running = true;
+		work->fn(work->ctx);
+		work->running = false;
+		nb++;
+
+		/* fn may have removed works, node is valid while added */
+		next = work->added ? node->next : no_os_sched_works.head.next;
+	}
+
+	return nb;
+}
+
+/**
+ * @brief Run the scheduler loop, never returns. When no work is pending the
+ * CPU sleeps in no_os_sched_idle until the next interrupt.
+ */
+void no_os_sched_run(void)
+{
+	while (true)
+		if (!no_os_sched_run_once() && !no_os_sched_pending())
+			no_os_sched_idle();
+}
+
+/**
+ * @brief Run the other posted works and expired timers once, from a driver
+ * polling the hardware. The works sharing a device with the caller must
+ * tolerate running in the middle of its operations.
+ */
+void no_os_sched_yield(void)
+{
+	no_os_sched_run_once();
+}
+
+/**
+ * @brief Wait at least ms milliseconds, running the other works and sleeping
+ * meanwhile, instead of spinning in no_os_mdelay.
+ * @param ms - Milliseconds.
+ */
+void no_os_sched_delay_ms(uint32_t ms)
+{
+	uint32_t start = no_os_sched_now();
+
+	/* The time base has a 1 ms resolution, the first tick may come early */
+	while (no_os_sched_now() - start <= ms)
+		if (!no_os_sched_run_once() && !no_os_sched_pending())
+			no_os_sched_idle();
+}
+
+/**
+ * @brief Prevent the deep sleep states until no_os_sched_deep_unlock, for
+ * the users needing the clocks while the loop is idle: DMA transfers, open
+ * IIO buffers. Calls are counted, safe from interrupts.
+ */
+void no_os_sched_deep_lock(void)
+{
+	atomic_fetch_add(&no_os_sched_deep_locks, 1);
+}
+
+/**
+ * @brief Release a no_os_sched_deep_lock. Safe from interrupts, e.g. from
+ * the DMA completion callback.
+ */
+void no_os_sched_deep_unlock(void)
+{
+	atomic_fetch_sub(&no_os_sched_deep_locks, 1);
+}
+
+/**
+ * @brief Set the RTC used by no_os_sched_idle to wake up from the deep sleep
+ * states when a timer expires. Without it, the deep sleep states are only
+ * entered when no timer is armed.
+ * @param rtc - Started RTC, NULL to stop using it.
+ */
+void no_os_sched_set_wakeup_rtc(struct no_os_rtc_desc *rtc)
+{
+	no_os_sched_rtc = rtc;
+}
+
+/**
+ * @brief Get the RTC waking up the deep sleep states.
+ * @return the RTC of no_os_sched_set_wakeup_rtc, NULL if not set.
+ */
+struct no_os_rtc_desc *no_os_sched_wakeup_rtc(void)
+{
+	return no_os_sched_rtc;
+}
+
+/**
+ * @brief Choose the deepest sleep state allowed, called by no_os_sched_idle
+ * with the interrupts masked. The deep sleep states need no lock taken, no
+ * timer expiring in less than NO_OS_SCHED_DEEP_MIN_MS and, if a timer is
+ * armed, the wakeup RTC.
+ * @param sleep_ms - Time until the next timer, NO_OS_SCHED_FOREVER if none.
+ * @return the sleep state.
+ */
+enum no_os_sched_sleep no_os_sched_sleep_level(uint32_t *sleep_ms)
+{
+	struct no_os_sched_work *work;
+	int32_t left;
+	void *data;
+
+	*sleep_ms = NO_OS_SCHED_FOREVER;
+	if (no_os_sched_kick)
+		return NO_OS_SCHED_SLEEP_NONE;
+
+	if (!no_os_heap_peek(&no_os_sched_timers, &data)) {
+		work = data;
+		left = (int32_t)(work->deadline - no_os_sched_now());
+		*sleep_ms = left > 0 ? left : 0;
+	}
+
+	if (atomic_load(&no_os_sched_deep_locks) ||
+	    *sleep_ms < NO_OS_SCHED_DEEP_MIN_MS ||
+	    (*sleep_ms != NO_OS_SCHED_FOREVER && !no_os_sched_rtc))
+		return NO_OS_SCHED_SLEEP_WAIT;
+
+	return NO_OS_SCHED_SLEEP_DEEP;
+}
+
+/**
+ * @brief Advance the time base of the timers after a deep sleep state that
+ * stopped the system tick, the slept time being measured by the platform.
+ * @param ms - Milliseconds slept.
+ */
+void no_os_sched_time_skip(uint32_t ms)
+{
+	no_os_sched_skipped += ms;
+}
+
+/**
+ * @brief Default idle, for platforms without a sleep instruction: return and
+ * let the loop poll again.
+ */
+void __attribute__((weak)) no_os_sched_idle(void)
+{
+}
+
+#endif /* NO_OS_SCHED */
@@ -0,0 +1,143 @@
+/***************************************************************************//**
+ *   @file   no_os_sd_odr.c
+ *   @brief  Integer output data rate planner of sigma-delta ADCs.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "no_os_sd_odr.h"
+#include "no_os_error.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Get the distance between two rates.
+ * @param a - Rate.
+ * @param b - Rate.
+ * @return |a - b|
+ */
+static uint32_t no_os_sd_odr_dist(uint32_t a, uint32_t b)
+{
+	return a > b ? a - b : b - a;
+}
+
+/**
+ * @brief Compute the output data rate of a filter decimating its clock, such
+ * as the FS divider of the AD7124 or the SINC3 decimation of the AD7768-1.
+ * @param clk_hz - Modulator clock in Hz.
+ * @param div - Fixed decimation of the filter.
+ * @param n - Programmable decimation of the filter.
+ * @return Rate in mHz, rounded to the nearest, 0 if div or n is 0.
+ */
+uint32_t no_os_sd_odr_div(uint32_t clk_hz, uint32_t div, uint32_t n)
+{
+	uint64_t d = (uint64_t)div * n;
+
+	if (!d)
+		return 0;
+
+	return ((uint64_t)clk_hz * 1000 + d / 2) / d;
+}
+
+/**
+ * @brief Find the programmable decimation of a filter giving the rate closest
+ * to the one requested. Rates out of the range of the filter get its fastest or
+ * slowest rate.
+ * @param clk_hz - Modulator clock in Hz.
+ * @param div - Fixed decimation of the filter.
+ * @param n_min - Smallest programmable decimation.
+ * @param n_max - Biggest programmable decimation.
+ * @param odr_mhz - Requested rate in mHz.
+ * @param n - Decimation found.
+ * @return 0 in case of success, -EINVAL for wrong parameters.
+ */
+int32_t no_os_sd_odr_div_plan(uint32_t clk_hz, uint32_t div, uint32_t n_min,
+			      uint32_t n_max, uint32_t odr_mhz, uint32_t *n)
+{
+	uint64_t best;
+
+	if (!div || !n_min || n_min > n_max || !odr_mhz || !n)
+		return -EINVAL;
+
+	/* The rate of best is above odr_mhz and the one of best + 1 below */
+	best = (uint64_t)clk_hz * 1000 / ((uint64_t)div * odr_mhz);
+	if (best < n_min) {
+		*n = n_min;
+		return 0;
+	}
+	if (best >= n_max) {
+		*n = n_max;
+		return 0;
+	}
+
+	if (no_os_sd_odr_dist(no_os_sd_odr_div(clk_hz, div, best + 1),
+			      odr_mhz) <
+	    no_os_sd_odr_dist(no_os_sd_odr_div(clk_hz, div, best), odr_mhz))
+		best++;
+	*n = best;
+
+	return 0;
+}
+
+/**
+ * @brief Find the closest rate in a table, for the filters with a fixed set of
+ * rates selected by a register code, the index in the table.
+ * @param table - Rates in mHz, in any order. The first of equal rates is found.
+ * @param size - Number of entries of the table.
+ * @param odr_mhz - Requested rate in mHz.
+ * @param idx - Index of the closest rate.
+ * @return 0 in case of success, -EINVAL for wrong parameters.
+ */
+int32_t no_os_sd_odr_table_find(const uint32_t *table, uint32_t size,
+				uint32_t odr_mhz, uint32_t *idx)
+{
+	uint32_t i, best = 0;
+
+	if (!table || !size || !idx)
+		return -EINVAL;
+
+	for (i = 1; i < size; i++)
+		if (no_os_sd_odr_dist(table[i], odr_mhz) <
+		    no_os_sd_odr_dist(table[best], odr_mhz))
+			best = i;
+	*idx = best;
+
+	return 0;
+}
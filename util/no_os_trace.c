@@ -0,0 +1,214 @@
+/***************************************************************************//**
+ *   @file   no_os_trace.c
+ *   @brief  Implementation of the timestamped enter/exit event trace.
+********************************************************************************
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include "no_os_trace.h"
+#include "no_os_delay.h"
+#include "no_os_uart.h"
+#include "no_os_error.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/*
+ * Slot of the ring. seq is the index of the event plus one once it is written
+ * and 0 while it is being written, so the reader detects the slots overwritten
+ * while it copies them.
+ */
+struct no_os_trace_slot {
+	atomic_uint seq;
+	struct no_os_trace_event event;
+};
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+static struct no_os_trace_slot no_os_trace_ring[NO_OS_TRACE_DEPTH];
+/* Number of events recorded, wraps around */
+static atomic_uint no_os_trace_head;
+/* Index of the next event to be read */
+static uint32_t no_os_trace_tail;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Default counter, for platforms without a cycle counter.
+ * @return Microseconds since the system start.
+ */
+uint32_t __attribute__((weak)) no_os_trace_timestamp(void)
+{
+	struct no_os_time t = no_os_get_time();
+
+	return t.s * 1000000 + t.us;
+}
+
+/**
+ * @brief Record an event. Lock-free, it can interrupt or be interrupted by
+ * another no_os_trace_event. The oldest event is overwritten if the trace is
+ * full.
+ * @param id - enum no_os_trace_id.
+ * @param type - enum no_os_trace_type.
+ */
+void no_os_trace_event(uint16_t id, uint16_t type)
+{
+	struct no_os_trace_slot *slot;
+	uint32_t idx;
+
+	idx = atomic_fetch_add_explicit(&no_os_trace_head, 1,
+					memory_order_relaxed);
+	slot = &no_os_trace_ring[idx & (NO_OS_TRACE_DEPTH - 1)];
+
+	atomic_store_explicit(&slot->seq, 0, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	slot->event.timestamp = no_os_trace_timestamp();
+	slot->event.id = id;
+	slot->event.type = type;
+	atomic_store_explicit(&slot->seq, idx + 1, memory_order_release);
+}
+
+/**
+ * @brief Get and remove the oldest recorded events. There must be only one
+ * reader at a time.
+ * @param events - Where to store the events.
+ * @param nb - Maximum number of events.
+ * @param lost - If not NULL, where to store the number of events overwritten
+ * before being read.
+ * @return Number of events stored in events.
+ */
+uint32_t no_os_trace_read(struct no_os_trace_event *events, uint32_t nb,
+			  uint32_t *lost)
+{
+	struct no_os_trace_slot *slot;
+	uint32_t head, seq, n = 0, nb_lost = 0;
+
+	head = atomic_load_explicit(&no_os_trace_head, memory_order_acquire);
+	if (head - no_os_trace_tail > NO_OS_TRACE_DEPTH) {
+		nb_lost = head - NO_OS_TRACE_DEPTH - no_os_trace_tail;
+		no_os_trace_tail = head - NO_OS_TRACE_DEPTH;
+	}
+
+	while (n < nb && no_os_trace_tail != head) {
+		slot = &no_os_trace_ring[no_os_trace_tail &
+						     (NO_OS_TRACE_DEPTH - 1)];
+		seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+		if (seq != no_os_trace_tail + 1 &&
+		    (int32_t)(seq - no_os_trace_tail - 1) <= 0)
+			/* Still being written */
+			break;
+
+		events[n] = slot->event;
+		atomic_thread_fence(memory_order_acquire);
+		if (seq == no_os_trace_tail + 1 &&
+		    atomic_load_explicit(&slot->seq, memory_order_relaxed) == seq)
+			n++;
+		else
+			nb_lost++;
+		no_os_trace_tail++;
+	}
+
+	if (lost)
+		*lost = nb_lost;
+
+	return n;
+}
+
+/**
+ * @brief Get and remove the oldest events, formatted as lines of the hex
+ * timestamp, the id and E for enter or X for exit. Lost events are reported in
+ * a line starting with '#'.
+ * @param buf - Where to write the lines.
+ * @param len - Size of buf, nothing is written if it is smaller than
+ * 2 * NO_OS_TRACE_LINE_SIZE.
+ * @return Number of characters written, without the '\0'.
+ */
+uint32_t no_os_trace_print(char *buf, uint32_t len)
+{
+	struct no_os_trace_event ev;
+	uint32_t n, lost, l = 0;
+
+	/* Room for a lost line and an event line */
+	while (len - l >= 2 * NO_OS_TRACE_LINE_SIZE) {
+		n = no_os_trace_read(&ev, 1, &lost);
+		if (lost)
+			l += snprintf(buf + l, len - l, "# lost %"PRIu32"\n",
+				      lost);
+		if (!n)
+			break;
+
+		l += snprintf(buf + l, len - l, "%08"PRIx32" %u %c\n",
+			      ev.timestamp, ev.id,
+			      ev.type == NO_OS_TRACE_TYPE_ENTER ? 'E' : 'X');
+	}
+
+	return l;
+}
+
+/**
+ * @brief Write all the recorded events as text lines on a UART, as formatted
+ * by no_os_trace_print.
+ * @param uart - UART descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_trace_dump(struct no_os_uart_desc *uart)
+{
+	char buf[8 * NO_OS_TRACE_LINE_SIZE];
+	uint32_t len;
+	int32_t ret;
+
+	if (!uart)
+		return -EINVAL;
+
+	while ((len = no_os_trace_print(buf, sizeof(buf)))) {
+		ret = no_os_uart_write(uart, (uint8_t *)buf, len);
+		if (ret < 0)
+			return ret;
+	}
+
+	return 0;
+}
@@ -0,0 +1,232 @@
+/***************************************************************************//**
+ *   @file   no_os_trng_pool.c
+ *   @brief  Entropy pool filled by the TRNG in background.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include "no_os_trng_pool.h"
+#include "no_os_error.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief TRNG callback, storing the generated bytes. Called from interrupt
+ * context.
+ * @param ctx - The pool.
+ * @param data - Random bytes.
+ * @param len - Number of bytes.
+ * @return false to stop the TRNG once the pool is full.
+ */
+static bool no_os_trng_pool_push(void *ctx, const uint8_t *data, uint32_t len)
+{
+	struct no_os_trng_pool *pool = ctx;
+
+	no_os_lffifo_write(pool->fifo, data, len);
+	if (!no_os_lffifo_is_full(pool->fifo))
+		return true;
+
+	pool->running = false;
+
+	return false;
+}
+
+/**
+ * @brief Restart the background generation if the pool is low.
+ * @param pool - The pool.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t no_os_trng_pool_refill(struct no_os_trng_pool *pool)
+{
+	int32_t ret;
+
+	if (pool->running ||
+	    no_os_lffifo_count(pool->fifo) > pool->low_watermark)
+		return 0;
+
+	pool->running = true;
+	ret = no_os_trng_start_async(pool->trng, no_os_trng_pool_push, pool);
+	if (ret)
+		pool->running = false;
+
+	return ret;
+}
+
+/**
+ * @brief Initialize the pool and start filling it in background. On platforms
+ * without background generation, the pool reads wait for the TRNG.
+ * @param pool - Where to store the pool.
+ * @param param - Init parameter.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_trng_pool_init(struct no_os_trng_pool **pool,
+			     struct no_os_trng_pool_init_param *param)
+{
+	struct no_os_trng_pool *p;
+	int32_t ret;
+
+	if (!pool || !param || param->low_watermark >= param->size)
+		return -EINVAL;
+
+	p = calloc(1, sizeof(*p));
+	if (!p)
+		return -ENOMEM;
+
+	ret = no_os_lffifo_init(&p->fifo, 1, param->size);
+	if (ret)
+		goto error_fifo;
+
+	ret = no_os_trng_init(&p->trng, param->trng_init_param);
+	if (ret)
+		goto error_trng;
+
+	p->low_watermark = param->low_watermark ? param->low_watermark :
+			   param->size / 2;
+
+	ret = no_os_trng_pool_refill(p);
+	if (ret == -ENOSYS) {
+		p->blocking = true;
+	} else if (ret) {
+		no_os_trng_remove(p->trng);
+		goto error_trng;
+	}
+
+	*pool = p;
+
+	return 0;
+
+error_trng:
+	no_os_lffifo_remove(p->fifo);
+error_fifo:
+	free(p);
+
+	return ret;
+}
+
+/**
+ * @brief Free the resources allocated by no_os_trng_pool_init().
+ * @param pool - The pool.
+ */
+void no_os_trng_pool_remove(struct no_os_trng_pool *pool)
+{
+	if (!pool)
+		return;
+
+	if (pool->running)
+		no_os_trng_stop_async(pool->trng);
+	no_os_trng_remove(pool->trng);
+	no_os_lffifo_remove(pool->fifo);
+	free(pool);
+}
+
+/**
+ * @brief Get the number of random bytes ready in the pool.
+ * @param pool - The pool.
+ * @return the number of bytes.
+ */
+uint32_t no_os_trng_pool_count(struct no_os_trng_pool *pool)
+{
+	return no_os_lffifo_count(pool->fifo);
+}
+
+/**
+ * @brief Fill buffer with random bytes from the pool. When the pool has less
+ * than len bytes, waits for the TRNG to generate the missing ones.
+ * The signature matches the f_rng of mbedtls_ssl_conf_rng().
+ * @param pool - The pool.
+ * @param buff - Buffer to be filled.
+ * @param len - Size of the buffer.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_trng_pool_fill_buffer(struct no_os_trng_pool *pool,
+				    uint8_t *buff, uint32_t len)
+{
+	uint32_t n;
+	int32_t ret;
+
+	if (!pool || (!buff && len))
+		return -EINVAL;
+
+	if (pool->blocking)
+		return no_os_trng_fill_buffer(pool->trng, buff, len);
+
+	do {
+		n = no_os_lffifo_read(pool->fifo, buff, len);
+		buff += n;
+		len -= n;
+
+		ret = no_os_trng_pool_refill(pool);
+		if (ret)
+			return ret;
+	} while (len);
+
+	return 0;
+}
+
+/**
+ * @brief Entropy source callback for mbedtls_entropy_add_source(). Returns
+ * the bytes ready in the pool, possibly less than len, without waiting.
+ * @param data - The pool.
+ * @param output - Buffer to be filled.
+ * @param len - Size of the buffer.
+ * @param olen - Number of bytes written in output.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int no_os_trng_pool_entropy(void *data, unsigned char *output, size_t len,
+			    size_t *olen)
+{
+	struct no_os_trng_pool *pool = data;
+	int32_t ret;
+
+	if (!pool || !output || !olen)
+		return -EINVAL;
+
+	if (pool->blocking) {
+		ret = no_os_trng_fill_buffer(pool->trng, output, len);
+		*olen = ret ? 0 : len;
+
+		return ret;
+	}
+
+	*olen = no_os_lffifo_read(pool->fifo, output, len);
+
+	return no_os_trng_pool_refill(pool);
+}
@@ -0,0 +1,274 @@
+/***************************************************************************//**
+ *   @file   no_os_unpack.c
+ *   @brief  Unpacking of packed big-endian sample streams.
+********************************************************************************
+ * Copyright 2023(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "no_os_unpack.h"
+#include "no_os_error.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/* Extend the sign of the low bits of val, or keep them as they are */
+static inline int32_t no_os_unpack_ext(uint32_t val, uint8_t shift,
+				       bool sign_extend)
+{
+	if (sign_extend)
+		return (int32_t)(val << shift) >> shift;
+
+	return (int32_t)val;
+}
+
+/**
+ * @brief Unpack samples of any width up to 32 bits. The bits are kept in a
+ * 64-bit reservoir refilled 32 bits at a time, so most samples cost a shift
+ * and a mask. The last bytes are refilled one at a time in order not to read
+ * past the end of src.
+ * @param src - Packed samples.
+ * @param nb_samples - Number of samples.
+ * @param bits - Width of a sample.
+ * @param sign_extend - Whether the samples are two's complement.
+ * @param dst - Where to store the samples.
+ */
+static void no_os_unpack_be_any(const uint8_t *src, uint32_t nb_samples,
+				uint8_t bits, bool sign_extend, int32_t *dst)
+{
+	const uint8_t *end = src + no_os_unpack_size(nb_samples, bits);
+	uint32_t mask = 0xFFFFFFFF >> (32 - bits);
+	uint8_t shift = 32 - bits;
+	uint64_t acc = 0;
+	uint32_t nbits = 0;
+	uint32_t i;
+
+	for (i = 0; i < nb_samples; i++) {
+		if (nbits < bits) {
+			if (end - src >= 4) {
+				acc = (acc << 32) | ((uint32_t)src[0] << 24) |
+				      ((uint32_t)src[1] << 16) |
+				      ((uint32_t)src[2] << 8) | src[3];
+				src += 4;
+				nbits += 32;
+			} else {
+				while (nbits < bits) {
+					acc = (acc << 8) | *src++;
+					nbits += 8;
+				}
+			}
+		}
+
+		nbits -= bits;
+		dst[i] = no_os_unpack_ext((uint32_t)(acc >> nbits) & mask,
+					  shift, sign_extend);
+	}
+}
+
+/*
+ * Unrolled kernels for the common widths. Each iteration unpacks a group of
+ * samples ending on a byte boundary, the remaining samples are left to
+ * no_os_unpack_be_any.
+ */
+static uint32_t no_os_unpack_be12(const uint8_t *src, uint32_t nb_samples,
+				  bool sign_extend, int32_t *dst)
+{
+	uint32_t v;
+	uint32_t i;
+
+	for (i = 0; i + 2 <= nb_samples; i += 2, src += 3) {
+		v = ((uint32_t)src[0] << 4) | (src[1] >> 4);
+		dst[i] = no_os_unpack_ext(v, 20, sign_extend);
+
+		v = ((uint32_t)(src[1] & 0x0f) << 8) | src[2];
+		dst[i + 1] = no_os_unpack_ext(v, 20, sign_extend);
+	}
+
+	return i;
+}
+
+static uint32_t no_os_unpack_be18(const uint8_t *src, uint32_t nb_samples,
+				  bool sign_extend, int32_t *dst)
+{
+	uint32_t v;
+	uint32_t i;
+
+	for (i = 0; i + 4 <= nb_samples; i += 4, src += 9) {
+		v = ((uint32_t)src[0] << 10) | ((uint32_t)src[1] << 2) |
+		    (src[2] >> 6);
+		dst[i] = no_os_unpack_ext(v, 14, sign_extend);
+
+		v = ((uint32_t)(src[2] & 0x3f) << 12) |
+		    ((uint32_t)src[3] << 4) | (src[4] >> 4);
+		dst[i + 1] = no_os_unpack_ext(v, 14, sign_extend);
+
+		v = ((uint32_t)(src[4] & 0x0f) << 14) |
+		    ((uint32_t)src[5] << 6) | (src[6] >> 2);
+		dst[i + 2] = no_os_unpack_ext(v, 14, sign_extend);
+
+		v = ((uint32_t)(src[6] & 0x03) << 16) |
+		    ((uint32_t)src[7] << 8) | src[8];
+		dst[i + 3] = no_os_unpack_ext(v, 14, sign_extend);
+	}
+
+	return i;
+}
+
+static uint32_t no_os_unpack_be20(const uint8_t *src, uint32_t nb_samples,
+				  bool sign_extend, int32_t *dst)
+{
+	uint32_t v;
+	uint32_t i;
+
+	for (i = 0; i + 2 <= nb_samples; i += 2, src += 5) {
+		v = ((uint32_t)src[0] << 12) | ((uint32_t)src[1] << 4) |
+		    (src[2] >> 4);
+		dst[i] = no_os_unpack_ext(v, 12, sign_extend);
+
+		v = ((uint32_t)(src[2] & 0x0f) << 16) |
+		    ((uint32_t)src[3] << 8) | src[4];
+		dst[i + 1] = no_os_unpack_ext(v, 12, sign_extend);
+	}
+
+	return i;
+}
+
+static uint32_t no_os_unpack_be26(const uint8_t *src, uint32_t nb_samples,
+				  bool sign_extend, int32_t *dst)
+{
+	uint32_t v;
+	uint32_t i;
+
+	for (i = 0; i + 4 <= nb_samples; i += 4, src += 13) {
+		v = ((uint32_t)src[0] << 18) | ((uint32_t)src[1] << 10) |
+		    ((uint32_t)src[2] << 2) | (src[3] >> 6);
+		dst[i] = no_os_unpack_ext(v, 6, sign_extend);
+
+		v = ((uint32_t)(src[3] & 0x3f) << 20) |
+		    ((uint32_t)src[4] << 12) | ((uint32_t)src[5] << 4) |
+		    (src[6] >> 4);
+		dst[i + 1] = no_os_unpack_ext(v, 6, sign_extend);
+
+		v = ((uint32_t)(src[6] & 0x0f) << 22) |
+		    ((uint32_t)src[7] << 14) | ((uint32_t)src[8] << 6) |
+		    (src[9] >> 2);
+		dst[i + 2] = no_os_unpack_ext(v, 6, sign_extend);
+
+		v = ((uint32_t)(src[9] & 0x03) << 24) |
+		    ((uint32_t)src[10] << 16) | ((uint32_t)src[11] << 8) |
+		    src[12];
+		dst[i + 3] = no_os_unpack_ext(v, 6, sign_extend);
+	}
+
+	return i;
+}
+
+/**
+ * @brief Get the number of bytes holding packed samples.
+ * @param nb_samples - Number of samples.
+ * @param bits - Width of a sample.
+ * @return Number of bytes, the last one may be partially used.
+ */
+uint32_t no_os_unpack_size(uint32_t nb_samples, uint8_t bits)
+{
+	return (uint32_t)(((uint64_t)nb_samples * bits + 7) / 8);
+}
+
+/**
+ * @brief Unpack big-endian samples packed without padding, msb first, to 32
+ * bits. For example 4 samples of 18 bits take 9 bytes. The byte aligned
+ * widths (16, 24 and 32) and 12, 18, 20 and 26 bits use dedicated loops.
+ * @param src - Packed samples.
+ * @param nb_samples - Number of samples.
+ * @param bits - Width of a sample, 1 to 32.
+ * @param sign_extend - Whether the samples are two's complement.
+ * @param dst - Where to store the samples.
+ * @return 0 in case of success, -EINVAL for wrong parameters.
+ */
+int32_t no_os_unpack_be(const uint8_t *src, uint32_t nb_samples,
+			uint8_t bits, bool sign_extend, int32_t *dst)
+{
+	uint8_t shift = 32 - bits;
+	uint32_t done = nb_samples;
+	uint32_t i;
+
+	if (!src || !dst || !bits || bits > 32)
+		return -EINVAL;
+
+	switch (bits) {
+	case 16:
+		for (i = 0; i < nb_samples; i++, src += 2)
+			dst[i] = no_os_unpack_ext(((uint32_t)src[0] << 8) |
+						  src[1], shift, sign_extend);
+		break;
+	case 24:
+		for (i = 0; i < nb_samples; i++, src += 3)
+			dst[i] = no_os_unpack_ext(((uint32_t)src[0] << 16) |
+						  ((uint32_t)src[1] << 8) |
+						  src[2], shift, sign_extend);
+		break;
+	case 32:
+		for (i = 0; i < nb_samples; i++, src += 4)
+			dst[i] = (int32_t)(((uint32_t)src[0] << 24) |
+					   ((uint32_t)src[1] << 16) |
+					   ((uint32_t)src[2] << 8) | src[3]);
+		break;
+	case 12:
+		done = no_os_unpack_be12(src, nb_samples, sign_extend, dst);
+		break;
+	case 18:
+		done = no_os_unpack_be18(src, nb_samples, sign_extend, dst);
+		break;
+	case 20:
+		done = no_os_unpack_be20(src, nb_samples, sign_extend, dst);
+		break;
+	case 26:
+		done = no_os_unpack_be26(src, nb_samples, sign_extend, dst);
+		break;
+	default:
+		done = 0;
+		break;
+	}
+
+	/* Samples not handled by a dedicated loop, the groups end on a byte */
+	if (done < nb_samples)
+		no_os_unpack_be_any(src + done * bits / 8, nb_samples - done,
+				    bits, sign_extend, dst + done);
+
+	return 0;
+}
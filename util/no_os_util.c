@@ -205,6 +205,107 @@ unsigned int no_os_hweight32(uint32_t word)
 	       no_os_hweight16(word);
 }
 
+/**
+ * Reciprocals, floor((2^64 - 1) / divisor), of the divisors used for unit
+ * conversions, so that dividing by them needs no division.
+ */
+static const struct {
+	uint32_t divisor;
+	uint64_t recip;
+} no_os_div_recip[] = {
+	{ 1000, 18446744073709551ULL },
+	{ 1000000, 18446744073709ULL },
+	{ 1000000000, 18446744073ULL },
+};
+
+/**
+ * Get the high 64 bits of the 128-bit product of a and b.
+ */
+static uint64_t no_os_mul_u64_u64_hi(uint64_t a, uint64_t b)
+{
+	uint64_t lo_lo = no_os_mul_u32_u32(a, b);
+	uint64_t hi_lo = no_os_mul_u32_u32(a >> 32, b);
+	uint64_t lo_hi = no_os_mul_u32_u32(a, b >> 32);
+	uint64_t hi_hi = no_os_mul_u32_u32(a >> 32, b >> 32);
+	uint64_t cross = (lo_lo >> 32) + (uint32_t)hi_lo + lo_hi;
+
+	return hi_hi + (hi_lo >> 32) + (cross >> 32);
+}
+
+/**
+ * Unsigned 64bit divide with 32bit divisor, without calling the compiler's
+ * 64-bit division routine, which is slow on 32-bit cores.
+ * The quotient is stored in n and the remainder is returned.
+ */
+uint32_t no_os_div64_32(uint64_t *n, uint32_t base)
+{
+	uint64_t rem = *n;
+	uint64_t b = base;
+	uint64_t res = 0;
+	uint64_t d = 1;
+	uint32_t high = rem >> 32;
+	uint32_t i;
+
+#if UINTPTR_MAX > UINT32_MAX
+	/* 64-bit cores divide in hardware */
+	*n = rem / base;
+
+	return rem % base;
+#endif
+
+	/* 32-bit division, done in hardware by most cores */
+	if (!high) {
+		*n = (uint32_t)rem / base;
+		return (uint32_t)rem % base;
+	}
+
+	if (!(base & (base - 1))) {
+		*n = rem >> no_os_find_first_set_bit(base);
+		return rem & (base - 1);
+	}
+
+	for (i = 0; i < NO_OS_ARRAY_SIZE(no_os_div_recip); i++) {
+		if (base != no_os_div_recip[i].divisor)
+			continue;
+
+		/* The reciprocal underestimates the quotient by at most 2 */
+		res = no_os_mul_u64_u64_hi(rem, no_os_div_recip[i].recip);
+		rem -= res * base;
+		while (rem >= base) {
+			rem -= base;
+			res++;
+		}
+		*n = res;
+
+		return rem;
+	}
+
+	/* Shift and subtract */
+	if (high >= base) {
+		high /= base;
+		res = (uint64_t)high << 32;
+		rem -= (uint64_t)(high * base) << 32;
+	}
+
+	while ((int64_t)b > 0 && b < rem) {
+		b <<= 1;
+		d <<= 1;
+	}
+
+	do {
+		if (rem >= b) {
+			rem -= b;
+			res += d;
+		}
+		b >>= 1;
+		d >>= 1;
+	} while (d);
+
+	*n = res;
+
+	return rem;
+}
+
 /**
  * Calculate the quotient and the remainder of an integer division.
  */
@@ -213,6 +314,9 @@ uint64_t no_os_do_div(uint64_t* n,
 {
 	uint64_t mod = 0;
 
+	if (!(base >> 32))
+		return no_os_div64_32(n, base);
+
 	mod = *n % base;
 	*n = *n / base;
 
@@ -225,9 +329,9 @@ uint64_t no_os_do_div(uint64_t* n,
 uint64_t no_os_div64_u64_rem(uint64_t dividend, uint64_t divisor,
 			     uint64_t *remainder)
 {
-	*remainder = dividend % divisor;
+	*remainder = no_os_do_div(&dividend, divisor);
 
-	return dividend / divisor;
+	return dividend;
 }
 
 /**
@@ -236,7 +340,7 @@ uint64_t no_os_div64_u64_rem(uint64_t dividend, uint64_t divisor,
 uint64_t no_os_div_u64_rem(uint64_t dividend, uint32_t divisor,
 			   uint32_t *remainder)
 {
-	*remainder = no_os_do_div(&dividend, divisor);
+	*remainder = no_os_div64_32(&dividend, divisor);
 
 	return dividend;
 }